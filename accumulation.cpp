@@ -0,0 +1,118 @@
+// ============== PROGRESSIVE ACCUMULATION ==============
+// Sample counting and the pausable animation clock behind --accumulate
+// (see accumulation.h). The sums themselves live in the renderers.
+
+#include "accumulation.h"
+
+UINT g_accumTargetSpp = 0;
+
+extern LARGE_INTEGER g_startTime;
+extern LARGE_INTEGER g_perfFreq;
+
+static bool s_paused = false;
+static LONGLONG s_pauseStartQpc = 0;   // 0 = paused since g_startTime
+static LONGLONG s_pausedQpc = 0;       // Total ticks spent paused before s_pauseStartQpc
+
+static UINT s_frames = 0;              // Frames in the current sum
+static UINT s_samples = 0;             // Samples per pixel in the current sum
+static float s_sumTime = 0.0f;         // Animation time the sum belongs to
+static UINT s_sumWidth = 0, s_sumHeight = 0;
+static LONGLONG s_sumStartQpc = 0;
+static double s_convergeSec = -1.0;    // Time to g_accumTargetSpp, < 0 until reached
+static UINT s_restarts = 0;
+
+// ============== ANIMATION CLOCK ==============
+float AnimationTime() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    LONGLONG end = now.QuadPart;
+    if (s_paused) end = s_pauseStartQpc ? s_pauseStartQpc : g_startTime.QuadPart;
+    if (!g_perfFreq.QuadPart) return 0.0f;
+    return (float)((double)(end - g_startTime.QuadPart - s_pausedQpc) / g_perfFreq.QuadPart);
+}
+
+void AnimationReset() {
+    s_paused = g_accumTargetSpp > 0;
+    s_pauseStartQpc = 0;
+    s_pausedQpc = 0;
+}
+
+void AnimationTogglePause() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    if (s_paused) s_pausedQpc += now.QuadPart - (s_pauseStartQpc ? s_pauseStartQpc : g_startTime.QuadPart);
+    else s_pauseStartQpc = now.QuadPart;
+    s_paused = !s_paused;
+    Log("[INFO] Animation %s\n", s_paused ? "paused" : "resumed");
+}
+
+bool AnimationPaused() { return s_paused; }
+
+// ============== SAMPLE SUM ==============
+void AccumReset() {
+    s_frames = 0;
+    s_samples = 0;
+    s_convergeSec = -1.0;
+    s_restarts = 0;
+}
+
+void AccumRestart() {
+    if (s_frames) s_restarts++;
+    s_frames = 0;
+    s_samples = 0;
+}
+
+static double AccumElapsedSec() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return g_perfFreq.QuadPart ? (double)(now.QuadPart - s_sumStartQpc) / g_perfFreq.QuadPart : 0.0;
+}
+
+static double AccumSamplesPerSec() {
+    double sec = AccumElapsedSec();
+    return sec > 0.0 ? (double)s_samples * s_sumWidth * s_sumHeight / sec : 0.0;
+}
+
+UINT AccumFrameBegin(float animTime, UINT width, UINT height, UINT samplesPerFrame) {
+    if (!g_accumTargetSpp) return 0;
+
+    if (s_frames == 0 || animTime != s_sumTime || width != s_sumWidth || height != s_sumHeight) {
+        if (s_frames) s_restarts++;
+        s_frames = 0;
+        s_samples = 0;
+        s_sumTime = animTime;
+        s_sumWidth = width;
+        s_sumHeight = height;
+        s_convergeSec = -1.0;
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        s_sumStartQpc = now.QuadPart;
+    }
+
+    s_frames++;
+    s_samples += samplesPerFrame ? samplesPerFrame : 1;
+    if (s_samples >= g_accumTargetSpp && s_convergeSec < 0.0) {
+        s_convergeSec = AccumElapsedSec();
+        Log("[INFO] Accumulation: %u SPP at %ux%u in %.2f s (%.1f Msamples/s)\n",
+            s_samples, width, height, s_convergeSec, AccumSamplesPerSec() / 1e6);
+    }
+    return s_frames;
+}
+
+void AccumFormat(char* buf, size_t size) {
+    if (!buf || size == 0) return;
+    buf[0] = 0;
+    if (!g_accumTargetSpp) return;
+    if (s_convergeSec >= 0.0)
+        _snprintf_s(buf, size, _TRUNCATE, "Accum: %u SPP | %.1f Msamples/s | %u SPP in %.2f s",
+                    s_samples, AccumSamplesPerSec() / 1e6, g_accumTargetSpp, s_convergeSec);
+    else
+        _snprintf_s(buf, size, _TRUNCATE, "Accum: %u/%u SPP | %.1f Msamples/s%s",
+                    s_samples, g_accumTargetSpp, AccumSamplesPerSec() / 1e6, s_paused ? "" : " (P to freeze)");
+}
+
+void AccumWriteJson(FILE* f) {
+    if (!g_accumTargetSpp) return;
+    fprintf(f, "  \"accumulation\": { \"targetSpp\": %u, \"spp\": %u, \"msamplesPerSec\": %.3f, \"convergeSeconds\": %.4f, \"restarts\": %u },\n",
+        g_accumTargetSpp, s_samples, AccumSamplesPerSec() / 1e6, s_convergeSec, s_restarts);
+}
@@ -0,0 +1,36 @@
+#pragma once
+// ============== PROGRESSIVE ACCUMULATION ==============
+// --accumulate[=N] (D3D12 PT, Vulkan RQ): every frame's 1 SPP trace is added
+// to a running FP32 sum per pixel (the .w channel counts samples) and sum / n
+// is shown. The sum restarts whenever the animation time or the resolution
+// changes, so it only grows while the scene is static: with --accumulate the
+// animation starts frozen and P toggles it.
+//
+// Reported throughput is pixel samples per second since the last restart,
+// i.e. traced paths rather than presented frames. N is the reference sample
+// count: time-to-converge is the wall time from the restart until every pixel
+// holds N samples (default 1024).
+
+#include "common.h"
+
+#define ACCUM_DEFAULT_TARGET_SPP 1024
+
+extern UINT g_accumTargetSpp;   // --accumulate[=N], 0 = off
+
+// ============== ANIMATION CLOCK ==============
+// Seconds since g_startTime, not counting paused intervals. Used by the
+// accumulating renderers for cube transforms and shader time.
+float AnimationTime();
+void AnimationReset();          // InitRenderer: frozen at t=0 with --accumulate, running otherwise
+void AnimationTogglePause();    // P key
+bool AnimationPaused();
+
+// ============== SAMPLE SUM ==============
+void AccumReset();              // InitRenderer: new run, clears the restart count and convergence time
+void AccumRestart();            // Renderer recreated its sum (resize): the next frame starts a new one
+// Frame index within the current sum: 1 = first frame (overwrite the sum),
+// n = add to n-1 frames. 0 when accumulation is off. samplesPerFrame is the
+// paths per pixel each frame adds (D3D12 PT --spp, nominal with --adaptive).
+UINT AccumFrameBegin(float animTime, UINT width, UINT height, UINT samplesPerFrame = 1);
+void AccumFormat(char* buf, size_t size);   // e.g. "Accum: 240/1024 SPP | 73.7 Msamples/s", empty when off
+void AccumWriteJson(FILE* f);               // Benchmark report "accumulation" block (incl. trailing comma)
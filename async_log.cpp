@@ -0,0 +1,261 @@
+// ============== ASYNC LOG ==============
+// Log() formats on the calling thread into a bounded multi-producer ring of
+// fixed-size slots; a writer thread drains it to the log file and flushes
+// once per batch, so the render thread never waits on the disk. A message
+// longer than a slot claims consecutive slots in one step, which keeps it in
+// one piece and in order. When the ring is full the message is dropped and
+// counted (never blocks); info and debug lines also leave the last quarter
+// of the ring to warnings and errors. Before LogStartWriter, with --log-sync
+// and after CloseLog, Log() writes and flushes synchronously as before.
+//
+// Severity comes from the tag at the start of the format string ([ERROR],
+// [VkRT] ERROR:, [WARN], Warning:, [DEBUG], ...), so filtered lines are
+// rejected before they are formatted.
+
+#include "common.h"
+
+#define LOG_SLOT_COUNT 8192                     // Power of two
+#define LOG_SLOT_TEXT 248
+#define LOG_MAX_MESSAGE 16384
+#define LOG_INFO_HEADROOM (LOG_SLOT_COUNT / 4)  // Slots info / debug lines leave free
+#define LOG_WAKE_SLOTS (LOG_SLOT_COUNT / 4)     // Producers wake the writer every this many slots
+#define LOG_WRITER_PERIOD_MS 20
+#define LOG_FLUSH_TIMEOUT_MS 1000
+
+struct LogSlot {
+    volatile LONG sequence;     // == position: free; position + 1: published
+    USHORT length;
+    char text[LOG_SLOT_TEXT];
+};
+
+static FILE* g_logFile = nullptr;
+static wchar_t g_logPath[MAX_PATH] = {0};
+
+static LogSlot s_slots[LOG_SLOT_COUNT];
+static volatile LONG s_head = 0;                // Next position producers claim
+static LONG s_tail = 0;                         // Next position to write (writer thread only)
+static volatile LONG s_flushed = 0;             // Everything before this position is on disk
+static volatile LONG s_writerRunning = 0;
+static volatile LONG s_writerQuit = 0;
+static volatile LONG s_droppedPending = 0;      // Reported by the writer with its next batch
+static volatile LONG s_droppedTotal = 0;
+static HANDLE s_writerThread = nullptr;
+static HANDLE s_writerWake = nullptr;
+static LPTOP_LEVEL_EXCEPTION_FILTER s_prevCrashFilter = nullptr;
+
+// ============== LOG FILE ==============
+void InitLog()
+{
+    wchar_t exePath[MAX_PATH];
+    GetModuleFileNameW(nullptr, exePath, MAX_PATH);
+    wcscpy_s(g_logPath, exePath);
+    wchar_t* dot = wcsrchr(g_logPath, L'.');
+    if (dot) wcscpy_s(dot, 20, L"_error.log");
+    else wcscat_s(g_logPath, L"_error.log");
+
+    for (LONG i = 0; i < LOG_SLOT_COUNT; i++) s_slots[i].sequence = s_head + i;
+    s_tail = s_head;
+    s_flushed = s_head;
+}
+
+// <exe>_error_<tag>.log, so concurrent --all-gpus children don't share a file
+void SetLogInstance(const char* tag)
+{
+    CloseLog();
+    InitLog();
+    wchar_t suffix[48];
+    swprintf_s(suffix, L"_error_%hs.log", tag);
+    wchar_t* ext = wcsstr(g_logPath, L"_error.log");
+    if (ext) *ext = 0;
+    wcscat_s(g_logPath, suffix);
+}
+
+static bool OpenLogFile()
+{
+    if (g_logFile) return true;
+    _wfopen_s(&g_logFile, g_logPath, L"a");
+    if (!g_logFile) return false;
+    time_t now = time(nullptr);
+    tm t; localtime_s(&t, &now);
+    fprintf(g_logFile, "\n========== %04d-%02d-%02d %02d:%02d:%02d ==========\n",
+        t.tm_year+1900, t.tm_mon+1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+    return true;
+}
+
+// ============== SEVERITY ==============
+const char* LogLevelName(LogLevel level)
+{
+    switch (level) {
+    case LOG_LEVEL_ERROR: return "error";
+    case LOG_LEVEL_WARN: return "warn";
+    case LOG_LEVEL_INFO: return "info";
+    default: return "debug";
+    }
+}
+
+static LogLevel LogLevelOf(const char* fmt)
+{
+    char head[32];
+    strncpy_s(head, fmt, _TRUNCATE);
+    if (strstr(head, "ERROR") || strstr(head, "FATAL") || strstr(head, "Error") || strstr(head, "Failed"))
+        return LOG_LEVEL_ERROR;
+    if (strstr(head, "WARN") || strstr(head, "Warning")) return LOG_LEVEL_WARN;
+    if (strstr(head, "DEBUG")) return LOG_LEVEL_DEBUG;
+    return LOG_LEVEL_INFO;
+}
+
+// ============== RING ==============
+static void LogEnqueue(const char* text, int len, LogLevel level)
+{
+    LONG count = (len + LOG_SLOT_TEXT - 1) / LOG_SLOT_TEXT;
+    if (count == 0) return;
+    LONG reserve = level >= LOG_LEVEL_INFO ? LOG_INFO_HEADROOM : 0;
+
+    LONG pos;
+    for (;;) {
+        pos = s_head;
+        // The writer frees slots in order, so if the last slot needed (plus the
+        // headroom) is free for this lap, every slot before it is too
+        LONG last = pos + count - 1 + reserve;
+        LONG diff = s_slots[last & (LOG_SLOT_COUNT - 1)].sequence - last;
+        if (diff < 0) {
+            InterlockedIncrement(&s_droppedPending);
+            InterlockedIncrement(&s_droppedTotal);
+            return;
+        }
+        if (diff == 0 && InterlockedCompareExchange(&s_head, pos + count, pos) == pos) break;
+    }
+
+    for (LONG i = 0; i < count; i++) {
+        LogSlot& slot = s_slots[(pos + i) & (LOG_SLOT_COUNT - 1)];
+        int n = min(len - (int)i * LOG_SLOT_TEXT, LOG_SLOT_TEXT);
+        memcpy(slot.text, text + i * LOG_SLOT_TEXT, n);
+        slot.length = (USHORT)n;
+        InterlockedExchange(&slot.sequence, pos + i + 1);
+    }
+
+    // Errors go out right away; everything else with the writer's next period
+    // unless the ring is filling up
+    if (level <= LOG_LEVEL_WARN || pos / LOG_WAKE_SLOTS != (pos + count) / LOG_WAKE_SLOTS)
+        SetEvent(s_writerWake);
+}
+
+static void LogDrain()
+{
+    bool wrote = false;
+    for (;;) {
+        LogSlot& slot = s_slots[s_tail & (LOG_SLOT_COUNT - 1)];
+        if (slot.sequence != s_tail + 1) break;
+        if (OpenLogFile()) fwrite(slot.text, 1, slot.length, g_logFile);
+        InterlockedExchange(&slot.sequence, s_tail + LOG_SLOT_COUNT);
+        s_tail++;
+        wrote = true;
+    }
+    LONG dropped = InterlockedExchange(&s_droppedPending, 0);
+    if (dropped && OpenLogFile()) {
+        fprintf(g_logFile, "[WARN] Log: %ld messages dropped, the log ring was full\n", dropped);
+        wrote = true;
+    }
+    if (wrote && g_logFile) fflush(g_logFile);
+    InterlockedExchange(&s_flushed, s_tail);
+}
+
+static DWORD WINAPI LogWriterProc(LPVOID)
+{
+    while (!s_writerQuit) {
+        WaitForSingleObject(s_writerWake, LOG_WRITER_PERIOD_MS);
+        LogDrain();
+    }
+    LogDrain();
+    return 0;
+}
+
+// Get whatever is still in the ring onto the disk before the process goes down
+static LONG WINAPI LogCrashFilter(EXCEPTION_POINTERS* info)
+{
+    LogFlush();
+    return s_prevCrashFilter ? s_prevCrashFilter(info) : EXCEPTION_CONTINUE_SEARCH;
+}
+
+void LogStartWriter()
+{
+    if (s_writerRunning || g_logSync) return;
+    s_writerWake = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    s_writerQuit = 0;
+    s_writerThread = s_writerWake ? CreateThread(nullptr, 0, LogWriterProc, nullptr, 0, nullptr) : nullptr;
+    if (!s_writerThread) {
+        if (s_writerWake) { CloseHandle(s_writerWake); s_writerWake = nullptr; }
+        Log("[WARN] Log: writer thread unavailable (error %lu), logging synchronously\n", GetLastError());
+        return;
+    }
+    SetThreadPriority(s_writerThread, THREAD_PRIORITY_BELOW_NORMAL);
+    s_prevCrashFilter = SetUnhandledExceptionFilter(LogCrashFilter);
+    InterlockedExchange(&s_writerRunning, 1);
+}
+
+void LogFlush()
+{
+    if (!s_writerRunning) return;
+    if (GetCurrentThreadId() == GetThreadId(s_writerThread)) return;
+    LONG target = s_head;
+    SetEvent(s_writerWake);
+    // Sleep(1) lasts up to a timer tick (15.6 ms by default): time the wait, don't count sleeps
+    ULONGLONG start = GetTickCount64();
+    while (s_flushed - target < 0 && GetTickCount64() - start < LOG_FLUSH_TIMEOUT_MS) Sleep(1);
+}
+
+UINT LogDroppedCount()
+{
+    return (UINT)s_droppedTotal;
+}
+
+// ============== LOGGING ==============
+void Log(const char* fmt, ...)
+{
+    LogLevel level = LogLevelOf(fmt);
+    if (level > g_logLevel) return;
+
+    va_list args;
+    va_start(args, fmt);
+    if (!s_writerRunning) {
+        if (OpenLogFile()) {
+            vfprintf(g_logFile, fmt, args);
+            fflush(g_logFile);
+        }
+        va_end(args);
+        return;
+    }
+    char text[LOG_MAX_MESSAGE];
+    int len = _vsnprintf_s(text, sizeof(text), _TRUNCATE, fmt, args);
+    va_end(args);
+    if (len < 0) {
+        static const char marker[] = " (truncated)\n";
+        len = (int)sizeof(text) - 1;
+        memcpy(text + len - (sizeof(marker) - 1), marker, sizeof(marker) - 1);
+    }
+    LogEnqueue(text, len, level);
+}
+
+void LogHR(const char* operation, HRESULT hr)
+{
+    char msg[256];
+    FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM, nullptr, hr, 0, msg, sizeof(msg), nullptr);
+    Log("[ERROR] %s failed: 0x%08X - %s\n", operation, hr, msg);
+}
+
+void CloseLog()
+{
+    if (s_writerRunning) {
+        InterlockedExchange(&s_writerRunning, 0);
+        InterlockedExchange(&s_writerQuit, 1);
+        SetEvent(s_writerWake);
+        WaitForSingleObject(s_writerThread, INFINITE);
+        CloseHandle(s_writerThread);
+        CloseHandle(s_writerWake);
+        s_writerThread = nullptr;
+        s_writerWake = nullptr;
+        SetUnhandledExceptionFilter(s_prevCrashFilter);
+        s_prevCrashFilter = nullptr;
+    }
+    if (g_logFile) { fclose(g_logFile); g_logFile = nullptr; }
+}
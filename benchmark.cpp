@@ -0,0 +1,525 @@
+// ============== BENCHMARK MODE ==============
+// Records per-frame CPU wall-clock times (QPC) in the main loop and writes
+// a JSON summary plus a per-frame CSV when the measurement window ends.
+
+#include "benchmark.h"
+#include "gpu_profiler.h"
+#include "startup_profiler.h"
+#include "frame_capture.h"
+#include "frame_latency.h"
+#include "offscreen.h"
+#include "vram_budget.h"
+#include "group_tune.h"
+#include "accumulation.h"
+#include "tlas_policy.h"
+#include "rt_geometry.h"
+#include "rt_sampling.h"
+#include "ray_stats.h"
+#include "ray_reorder.h"
+#include "pt_lights.h"
+#include "mesh_file.h"
+#include "d3d12/d3d12_shared.h"
+#include "d3d12/renderer_d3d12.h"
+#include "d3d11/renderer_d3d11.h"
+#include "vulkan/vk_video_record.h"
+#include <algorithm>
+
+BenchmarkConfig g_benchConfig;
+
+static std::vector<double> s_frameTimesMs;
+static std::vector<double> s_cpuRecordMs;   // Only filled by renderers that time their recording
+static std::vector<double> s_latencyMs;     // CPU-to-present, resolved a few frames late
+static std::vector<double> s_pacingWaitMs;  // Only filled by renderers that pace with their own fences
+static UINT s_warmupRemaining = 0;
+static LARGE_INTEGER s_measureStart = {};
+static LARGE_INTEGER s_measureEnd = {};
+static LARGE_INTEGER s_benchFreq = {};
+
+// ============== RENDERER IDS ==============
+// Matches the primary names accepted by --renderer
+const char* GetRendererId(RendererType type) {
+    switch (type) {
+    case RENDERER_D3D11: return "d3d11";
+    case RENDERER_D3D12: return "d3d12";
+    case RENDERER_D3D12_DXR10: return "d3d12_dxr10";
+    case RENDERER_D3D12_RT: return "d3d12_rt";
+    case RENDERER_D3D12_PT: return "d3d12_pt";
+    case RENDERER_D3D12_PT_DLSS: return "d3d12_pt_dlss";
+    case RENDERER_OPENGL: return "opengl";
+    case RENDERER_VULKAN: return "vulkan";
+    case RENDERER_VULKAN_RT: return "vulkan_rt";
+    case RENDERER_VULKAN_RQ: return "vulkan_rq";
+    }
+    return "unknown";
+}
+
+// ============== FRAME RECORDING ==============
+void BenchmarkBegin() {
+    s_frameTimesMs.clear();
+    s_frameTimesMs.reserve(g_benchConfig.frames ? g_benchConfig.frames : 8192);
+    s_cpuRecordMs.clear();
+    s_latencyMs.clear();
+    s_pacingWaitMs.clear();
+    s_warmupRemaining = g_benchConfig.warmupFrames;
+    QueryPerformanceFrequency(&s_benchFreq);
+    QueryPerformanceCounter(&s_measureStart);
+    s_measureEnd = s_measureStart;
+    Log("[INFO] Benchmark: warmup=%u frames=%u seconds=%.1f\n",
+        g_benchConfig.warmupFrames, g_benchConfig.frames, g_benchConfig.seconds);
+}
+
+bool BenchmarkIsMeasuring() {
+    return s_warmupRemaining == 0;
+}
+
+void BenchmarkCpuRecordSample(double ms) {
+    if (g_benchConfig.enabled && s_warmupRemaining == 0) s_cpuRecordMs.push_back(ms);
+}
+
+void BenchmarkLatencySample(double ms) {
+    if (g_benchConfig.enabled && s_warmupRemaining == 0) s_latencyMs.push_back(ms);
+}
+
+void BenchmarkPacingWaitSample(double ms) {
+    if (g_benchConfig.enabled && s_warmupRemaining == 0) s_pacingWaitMs.push_back(ms);
+}
+
+bool BenchmarkFrame(double frameMs) {
+    if (s_warmupRemaining > 0) {
+        // --group-size=auto: the last warm-up frame waits until every dispatched kernel is tuned
+        if (s_warmupRemaining == 1 && GroupTuneBusy()) return false;
+        // Restart the measurement clock (and GPU pass totals) when the last warm-up frame completes
+        if (--s_warmupRemaining == 0) {
+            QueryPerformanceCounter(&s_measureStart);
+            GpuProfilerReset();
+            RayStatsReset();
+        }
+        return false;
+    }
+
+    s_frameTimesMs.push_back(frameMs);
+    QueryPerformanceCounter(&s_measureEnd);
+
+    if (g_benchConfig.frames > 0)
+        return s_frameTimesMs.size() >= g_benchConfig.frames;
+
+    double elapsed = (double)(s_measureEnd.QuadPart - s_measureStart.QuadPart) / s_benchFreq.QuadPart;
+    return elapsed >= g_benchConfig.seconds;
+}
+
+// ============== STATISTICS ==============
+// Nearest-rank percentile on an ascending sorted array
+static double Percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+    if (rank < 1) rank = 1;
+    if (rank > sorted.size()) rank = sorted.size();
+    return sorted[rank - 1];
+}
+
+bool BenchmarkStatsFromFrames(const std::vector<double>& frameTimesMs, BenchmarkStats& out) {
+    memset(&out, 0, sizeof(out));
+    if (frameTimesMs.empty()) return false;
+
+    std::vector<double> sorted = frameTimesMs;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+
+    double sum = 0.0;
+    for (double t : sorted) sum += t;
+
+    // 1% low = average of the slowest 1% of frames (at least one frame)
+    size_t lowCount = std::max<size_t>(1, n / 100);
+    double lowSum = 0.0;
+    for (size_t i = n - lowCount; i < n; i++) lowSum += sorted[i];
+
+    out.frameCount = (UINT)n;
+    out.totalSeconds = sum / 1000.0;
+    out.meanMs = sum / n;
+    out.avgFps = out.meanMs > 0.0 ? 1000.0 / out.meanMs : 0.0;
+    out.medianMs = (n % 2) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    out.p95Ms = Percentile(sorted, 95.0);
+    out.p99Ms = Percentile(sorted, 99.0);
+    out.low1Ms = lowSum / lowCount;
+    out.low1Fps = out.low1Ms > 0.0 ? 1000.0 / out.low1Ms : 0.0;
+    out.minMs = sorted.front();
+    out.maxMs = sorted.back();
+    return true;
+}
+
+bool BenchmarkComputeStats(BenchmarkStats& out) {
+    if (!BenchmarkStatsFromFrames(s_frameTimesMs, out)) return false;
+
+    if (!s_latencyMs.empty()) {
+        std::vector<double> lat = s_latencyMs;
+        std::sort(lat.begin(), lat.end());
+        double latSum = 0.0;
+        for (double t : lat) latSum += t;
+        out.latencySamples = (UINT)lat.size();
+        out.latencyMeanMs = latSum / lat.size();
+        out.latencyP95Ms = Percentile(lat, 95.0);
+    }
+    return true;
+}
+
+// ============== REPORT OUTPUT ==============
+static void GetReportBasePath(char* out, size_t size) {
+    if (g_benchConfig.reportPath[0]) {
+        // Sweep writes one report per renderer next to the given base path
+        if (g_benchConfig.sweep)
+            sprintf_s(out, size, "%s_%s", g_benchConfig.reportPath, GetRendererId(g_settings.renderer));
+        else
+            strcpy_s(out, size, g_benchConfig.reportPath);
+        return;
+    }
+    // Default: <exe>_benchmark_<renderer> next to the executable (like the error log)
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+    char* dot = strrchr(exePath, '.');
+    if (dot) *dot = 0;
+    sprintf_s(out, size, "%s_benchmark_%s", exePath, GetRendererId(g_settings.renderer));
+}
+
+static void GetSweepReportPath(char* out, size_t size) {
+    if (g_benchConfig.reportPath[0]) {
+        sprintf_s(out, size, "%s_sweep.csv", g_benchConfig.reportPath);
+        return;
+    }
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+    char* dot = strrchr(exePath, '.');
+    if (dot) *dot = 0;
+    sprintf_s(out, size, "%s_sweep.csv", exePath);
+}
+
+// Write a JSON string with the minimal escaping needed for adapter names
+static void WriteJsonString(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void WriteFeaturesJson(FILE* f, const BenchmarkStats& stats) {
+    switch (g_settings.renderer) {
+    case RENDERER_D3D12_RT: {
+        const DXRFeatures& d = g_dxrFeatures;
+        fprintf(f, "  \"features\": {\n");
+        fprintf(f, "    \"useRayQuery\": %s,\n", d.useRayQuery ? "true" : "false");
+        fprintf(f, "    \"rtLighting\": %s,\n", d.rtLighting ? "true" : "false");
+        fprintf(f, "    \"rtShadows\": %s,\n", d.rtShadows ? "true" : "false");
+        fprintf(f, "    \"rtSoftShadows\": %s,\n", d.rtSoftShadows ? "true" : "false");
+        fprintf(f, "    \"rtReflections\": %s,\n", d.rtReflections ? "true" : "false");
+        fprintf(f, "    \"rtAO\": %s,\n", d.rtAO ? "true" : "false");
+        fprintf(f, "    \"rtGI\": %s,\n", d.rtGI ? "true" : "false");
+        fprintf(f, "    \"softShadowSamples\": %d,\n", d.softShadowSamples);
+        fprintf(f, "    \"shadowSoftness\": %.3f,\n", d.shadowSoftness);
+        fprintf(f, "    \"reflectionStrength\": %.3f,\n", d.reflectionStrength);
+        fprintf(f, "    \"roughness\": %.3f,\n", d.roughness);
+        fprintf(f, "    \"aoSamples\": %d,\n", d.aoSamples);
+        fprintf(f, "    \"aoRadius\": %.3f,\n", d.aoRadius);
+        fprintf(f, "    \"aoStrength\": %.3f,\n", d.aoStrength);
+        fprintf(f, "    \"giBounces\": %d,\n", d.giBounces);
+        fprintf(f, "    \"giStrength\": %.3f,\n", d.giStrength);
+        fprintf(f, "    \"debugMode\": %d,\n", d.debugMode);
+        fprintf(f, "    \"enableTemporalDenoise\": %s,\n", d.enableTemporalDenoise ? "true" : "false");
+        fprintf(f, "    \"denoiseBlendFactor\": %.3f,\n", d.denoiseBlendFactor);
+        fprintf(f, "    \"indirectRate\": \"%s\",\n", D3D12RTIndirectRateName());
+        fprintf(f, "    \"depthPrepass\": %s,\n", g_rtDepthPrepass ? "true" : "false");
+        fprintf(f, "    \"vrs\": %s,\n", D3D12RTVrsTileSize() ? "true" : "false");
+        fprintf(f, "    \"vrsTileSize\": %u,\n", D3D12RTVrsTileSize());
+        fprintf(f, "    \"vrsThreshold\": %.5f\n", g_rtVrsThreshold);
+        fprintf(f, "  },\n");
+        break;
+    }
+    case RENDERER_D3D12_DXR10:
+    case RENDERER_VULKAN_RT:
+    case RENDERER_VULKAN_RQ: {
+        // DXR10Features and VulkanRTFeatures share the same layout
+        bool dxr10 = g_settings.renderer == RENDERER_D3D12_DXR10;
+        const DXR10Features& x = g_dxr10Features;
+        const VulkanRTFeatures& v = g_vulkanRTFeatures;
+        fprintf(f, "  \"features\": {\n");
+        fprintf(f, "    \"spotlight\": %s,\n", (dxr10 ? x.spotlight : v.spotlight) ? "true" : "false");
+        fprintf(f, "    \"softShadows\": %s,\n", (dxr10 ? x.softShadows : v.softShadows) ? "true" : "false");
+        fprintf(f, "    \"ambientOcclusion\": %s,\n", (dxr10 ? x.ambientOcclusion : v.ambientOcclusion) ? "true" : "false");
+        fprintf(f, "    \"globalIllum\": %s,\n", (dxr10 ? x.globalIllum : v.globalIllum) ? "true" : "false");
+        fprintf(f, "    \"reflections\": %s,\n", (dxr10 ? x.reflections : v.reflections) ? "true" : "false");
+        fprintf(f, "    \"glassRefraction\": %s,\n", (dxr10 ? x.glassRefraction : v.glassRefraction) ? "true" : "false");
+        fprintf(f, "    \"shadowSamples\": %d,\n", dxr10 ? x.shadowSamples : v.shadowSamples);
+        fprintf(f, "    \"aoSamples\": %d,\n", dxr10 ? x.aoSamples : v.aoSamples);
+        fprintf(f, "    \"aoRadius\": %.3f,\n", dxr10 ? x.aoRadius : v.aoRadius);
+        if (g_settings.renderer == RENDERER_VULKAN_RQ) {
+            // --render-scale here is a vkCmdBlitImage, not D3D12 PT's upscale + sharpen
+            fprintf(f, "    \"renderScale\": %u,\n", g_renderScalePct);
+            fprintf(f, "    \"upscale\": \"%s\",\n", g_renderScalePct < 100 ? "bilinear_blit" : "none");
+        }
+        fprintf(f, "    \"lightRadius\": %.3f\n", dxr10 ? x.lightRadius : v.lightRadius);
+        fprintf(f, "  },\n");
+        break;
+    }
+    case RENDERER_D3D12_PT:
+        // avgSpp is what to compare GPUs on at equal quality with --adaptive
+        fprintf(f, "  \"features\": {\n");
+        fprintf(f, "    \"spp\": %u,\n", g_ptSpp);
+        fprintf(f, "    \"renderScale\": %u,\n", g_renderScalePct);
+        fprintf(f, "    \"upscale\": \"%s\",\n", g_renderScalePct < 100 ? "edge_adaptive_sharpen" : "none");
+        fprintf(f, "    \"maxBounces\": %u,\n", g_ptMaxBounces);
+        fprintf(f, "    \"adaptiveMaxSpp\": %u,\n", g_ptAdaptiveMaxSpp);
+        fprintf(f, "    \"adaptiveTarget\": %.4f,\n", g_ptAdaptiveTarget);
+        fprintf(f, "    \"avgSpp\": %.3f,\n", D3D12PTAverageSpp());
+        fprintf(f, "    \"wavefront\": %s,\n", g_ptWavefront ? "true" : "false");
+        fprintf(f, "    \"lights\": %u,\n", g_ptLights);
+        fprintf(f, "    \"lightSampling\": \"%s\",\n", PtLightSamplingName());
+        fprintf(f, "    \"splitGpu\": %d,\n", D3D12PTSplitGpu());
+        fprintf(f, "    \"splitShare\": %.4f,\n", D3D12PTSplitShare());
+        fprintf(f, "    \"splitSecondaryMs\": %.4f,\n", D3D12PTSplitSecondaryMs());
+        fprintf(f, "    \"denoise\": \"%s\"\n", g_denoiseMode == DENOISE_TEMPORAL ? "temporal" :
+                                                   g_denoiseMode == DENOISE_ATROUS ? "atrous" : "off");
+        fprintf(f, "  },\n");
+        break;
+    case RENDERER_D3D12_PT_DLSS:
+        fprintf(f, "  \"features\": {\n");
+        fprintf(f, "    \"dlssMode\": \"%s\",\n", D3D12DlssModeName());
+        fprintf(f, "    \"targetMs\": %.3f,\n", g_dlssTargetMs);
+        fprintf(f, "    \"avgInputScale\": %.4f,\n", D3D12DlssAverageInputScale());
+        // stats.avgFps counts rendered frames; interpolated ones are presented in between.
+        // presentedFps is measured from the frame statistics (null without them)
+        fprintf(f, "    \"frameInterp\": %s,\n", D3D12DlssInterpolatedFrameRatio() > 0.0f ? "true" : "false");
+        fprintf(f, "    \"renderedFps\": %.2f,\n", stats.avgFps);
+        fprintf(f, "    \"interpolatedFps\": %.2f,\n", stats.avgFps * D3D12DlssInterpolatedFrameRatio());
+        if (D3D12DlssSubmittedPresentFps() >= 0.0f)
+            fprintf(f, "    \"submittedPresentFps\": %.2f,\n", D3D12DlssSubmittedPresentFps());
+        else
+            fprintf(f, "    \"submittedPresentFps\": null,\n");
+        if (D3D12DlssPresentedFps() >= 0.0f)
+            fprintf(f, "    \"presentedFps\": %.2f\n", D3D12DlssPresentedFps());
+        else
+            fprintf(f, "    \"presentedFps\": null\n");
+        fprintf(f, "  },\n");
+        break;
+    default:
+        fprintf(f, "  \"features\": {},\n");
+        break;
+    }
+}
+
+bool BenchmarkWriteReport() {
+    BenchmarkStats stats;
+    if (!BenchmarkComputeStats(stats)) {
+        Log("[WARN] Benchmark: no frames recorded, report not written\n");
+        return false;
+    }
+
+    char basePath[MAX_PATH];
+    GetReportBasePath(basePath, sizeof(basePath));
+
+    char gpuNameA[256] = "unknown";
+    if (g_settings.selectedGPU >= 0 && g_settings.selectedGPU < (int)g_gpuList.size()) {
+        size_t conv = 0;
+        wcstombs_s(&conv, gpuNameA, sizeof(gpuNameA), g_gpuList[g_settings.selectedGPU].name.c_str(), _TRUNCATE);
+    }
+
+    // ---- JSON summary ----
+    char jsonPath[MAX_PATH];
+    sprintf_s(jsonPath, "%s.json", basePath);
+    FILE* f = nullptr;
+    if (fopen_s(&f, jsonPath, "w") != 0 || !f) {
+        Log("[ERROR] Benchmark: cannot write %s\n", jsonPath);
+        return false;
+    }
+
+    time_t now = time(nullptr);
+    struct tm t;
+    localtime_s(&t, &now);
+    char dateStr[32];
+    strftime(dateStr, sizeof(dateStr), "%Y-%m-%dT%H:%M:%S", &t);
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"date\": \"%s\",\n", dateStr);
+    fprintf(f, "  \"gpu\": "); WriteJsonString(f, gpuNameA); fprintf(f, ",\n");
+    fprintf(f, "  \"gpuIndex\": %d,\n", g_settings.selectedGPU);
+    if (g_benchConfig.instanceTag[0]) {
+        // Part of an --all-gpus run: the other adapters were rendering at the same time
+        fprintf(f, "  \"instance\": "); WriteJsonString(f, g_benchConfig.instanceTag); fprintf(f, ",\n");
+    }
+    fprintf(f, "  \"renderer\": \"%s\",\n", GetRendererId(g_settings.renderer));
+    fprintf(f, "  \"rendererType\": %d,\n", (int)g_settings.renderer);
+    fprintf(f, "  \"width\": %u,\n", W);
+    fprintf(f, "  \"height\": %u,\n", H);
+    fprintf(f, "  \"cubes\": %u,\n", g_cubeCount);
+    fprintf(f, "  \"mesh\": "); WriteJsonString(f, MeshLoaded() ? g_meshPath.c_str() : ""); fprintf(f, ",\n");
+    fprintf(f, "  \"meshTriangles\": %u,\n", MeshLoaded() ? g_mesh.indexCount / 3 : 0u);
+    fprintf(f, "  \"gpuCulling\": %s,\n", g_gpuCulling ? "true" : "false");
+    fprintf(f, "  \"meshShaders\": %s,\n", g_meshShaders ? "true" : "false");
+    fprintf(f, "  \"glCore\": %s,\n", g_glCore ? "true" : "false");
+    fprintf(f, "  \"asyncCompute\": %s,\n", g_asyncCompute ? "true" : "false");
+    fprintf(f, "  \"zeroCopy\": %s,\n", g_zeroCopyPresent ? "true" : "false");
+    fprintf(f, "  \"prerecord\": %s,\n", g_vkPrerecord ? "true" : "false");
+    fprintf(f, "  \"bundles\": %s,\n", g_bundles ? "true" : "false");
+    fprintf(f, "  \"offscreen\": %s,\n", g_offscreen ? "true" : "false");
+    fprintf(f, "  \"offscreenEmptySubmits\": %u,\n", g_offscreen ? OffscreenEmptySubmitsPerFrame(g_settings.renderer) : 0u);
+    fprintf(f, "  \"compactVerts\": %s,\n", g_compactVerts ? "true" : "false");
+    fprintf(f, "  \"sampler\": \"%s\",\n", RtSamplerName());
+    fprintf(f, "  \"rayStats\": %s,\n", g_rayStats ? "true" : "false");
+    fprintf(f, "  \"warmupFrames\": %u,\n", g_benchConfig.warmupFrames);
+    WriteFeaturesJson(f, stats);
+    AccumWriteJson(f);
+    TlasWriteJson(f);
+    RayStatsWriteJson(f);
+    fprintf(f, "  \"stats\": {\n");
+    fprintf(f, "    \"frames\": %u,\n", stats.frameCount);
+    fprintf(f, "    \"seconds\": %.3f,\n", stats.totalSeconds);
+    fprintf(f, "    \"avgFps\": %.2f,\n", stats.avgFps);
+    fprintf(f, "    \"meanMs\": %.4f,\n", stats.meanMs);
+    fprintf(f, "    \"medianMs\": %.4f,\n", stats.medianMs);
+    fprintf(f, "    \"p95Ms\": %.4f,\n", stats.p95Ms);
+    fprintf(f, "    \"p99Ms\": %.4f,\n", stats.p99Ms);
+    fprintf(f, "    \"low1Ms\": %.4f,\n", stats.low1Ms);
+    fprintf(f, "    \"low1Fps\": %.2f,\n", stats.low1Fps);
+    fprintf(f, "    \"minMs\": %.4f,\n", stats.minMs);
+    fprintf(f, "    \"maxMs\": %.4f\n", stats.maxMs);
+    fprintf(f, "  },\n");
+
+    // CPU frame start -> displayed (mode/source describe how it was paced and measured)
+    fprintf(f, "  \"presentLatency\": { \"maxFrameLatency\": %u, \"presentMode\": \"%s\", \"source\": \"%s\", \"meanMs\": %.4f, \"p95Ms\": %.4f, \"samples\": %u },\n",
+        g_maxFrameLatency, PresentModeName(g_presentMode), LatencySourceName(),
+        stats.latencyMeanMs, stats.latencyP95Ms, stats.latencySamples);
+
+    // CPU time blocked on the frame fence N presents back (OpenGL --max-latency)
+    {
+        std::vector<double> sorted = s_pacingWaitMs;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double t : sorted) sum += t;
+        fprintf(f, "  \"pacingWait\": { \"meanMs\": %.4f, \"p95Ms\": %.4f, \"samples\": %zu },\n",
+            sorted.empty() ? 0.0 : sum / sorted.size(), sorted.empty() ? 0.0 : Percentile(sorted, 95.0), sorted.size());
+    }
+
+    // CPU time spent recording + submitting command lists (--record-threads: D3D12 lists,
+    // D3D11 deferred contexts; d3d11CommandLists says whether the driver or the runtime runs them).
+    // null for renderers that don't time their recording, rather than zeros that read as measured
+    if (s_cpuRecordMs.empty()) {
+        fprintf(f, "  \"cpuRecord\": null,\n");
+    } else {
+        std::vector<double> sorted = s_cpuRecordMs;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double t : sorted) sum += t;
+        double mean = sum / sorted.size();
+        double median = sorted[sorted.size() / 2];
+        fprintf(f, "  \"cpuRecord\": { \"threads\": %u, \"d3d11CommandLists\": \"%s\", \"meanMs\": %.4f, \"medianMs\": %.4f, \"p95Ms\": %.4f, \"samples\": %zu },\n",
+            g_recordThreads, g_settings.renderer == RENDERER_D3D11 ? D3D11CommandListSupport() : "off",
+            mean, median, Percentile(sorted, 95.0), sorted.size());
+    }
+
+    fprintf(f, "  \"capture\": { \"every\": %u, \"written\": %u, \"skipped\": %u, \"failed\": %u },\n",
+        g_captureEvery, CaptureWrittenCount(), CaptureSkippedCount(), CaptureFailedCount());
+    {
+        UINT recordFrames = 0, recordDropped = 0;
+        UINT64 recordBytes = 0;
+        VkRecordStats(recordFrames, recordDropped, recordBytes);
+        fprintf(f, "  \"record\": { \"enabled\": %s, \"mbps\": %u, \"frames\": %u, \"dropped\": %u, \"bytes\": %llu },\n",
+            g_recordPath[0] ? "true" : "false", g_recordMbps, recordFrames, recordDropped, recordBytes);
+    }
+    VramWriteJson(f);
+    GroupTuneWriteJson(f);
+    SerWriteJson(f);
+    fprintf(f, "  \"log\": { \"level\": \"%s\", \"async\": %s, \"dropped\": %u },\n",
+        LogLevelName(g_logLevel), g_logSync ? "false" : "true", LogDroppedCount());
+
+    // Startup breakdown of this renderer (from process creation when coldStart, else from
+    // the renderer switch); phases are in start order, parent before child
+    {
+        UINT phaseCount = StartupPhaseCount();
+        const StartupPhase* root = StartupGetPhase(0);
+        fprintf(f, "  \"startup\": { \"coldStart\": %s, \"totalMs\": %.3f, \"phases\": [",
+            StartupColdStart() ? "true" : "false", root ? root->cpuMs : 0.0);
+        for (UINT i = 0; i < phaseCount; i++) {
+            const StartupPhase* p = StartupGetPhase(i);
+            fprintf(f, "%s\n    { \"name\": ", i ? "," : "");
+            WriteJsonString(f, p->name);
+            fprintf(f, ", \"depth\": %d, \"gpu\": %s, \"startMs\": %.3f, \"cpuMs\": %.3f, \"selfMs\": %.3f, \"gpuMs\": %.3f }",
+                p->depth, p->gpu ? "true" : "false", p->startMs, p->cpuMs, p->selfMs, p->gpuMs);
+        }
+        fprintf(f, "%s] },\n", phaseCount ? "\n  " : "");
+    }
+
+    // Mean GPU time per pass over the measurement window (empty if the backend has no timestamps)
+    fprintf(f, "  \"gpuPasses\": [");
+    UINT passCount = GpuProfilerPassCount();
+    for (UINT i = 0; i < passCount; i++) {
+        const GpuPassStats* p = GpuProfilerGetPass(i);
+        double meanMs = p->totalSamples ? p->totalSumMs / p->totalSamples : 0.0;
+        fprintf(f, "%s\n    { \"name\": ", i ? "," : "");
+        WriteJsonString(f, p->name ? p->name : "");
+        fprintf(f, ", \"meanMs\": %.4f, \"samples\": %u }", meanMs, p->totalSamples);
+    }
+    fprintf(f, "%s]\n", passCount ? "\n  " : "");
+    fprintf(f, "}\n");
+    fclose(f);
+
+    // ---- Per-frame CSV ----
+    char csvPath[MAX_PATH];
+    sprintf_s(csvPath, "%s.csv", basePath);
+    if (fopen_s(&f, csvPath, "w") != 0 || !f) {
+        Log("[ERROR] Benchmark: cannot write %s\n", csvPath);
+        return false;
+    }
+    fprintf(f, "frame,ms\n");
+    for (size_t i = 0; i < s_frameTimesMs.size(); i++)
+        fprintf(f, "%zu,%.4f\n", i, s_frameTimesMs[i]);
+    fclose(f);
+
+    Log("[INFO] Benchmark %s: %u frames, avg %.2f FPS, mean %.3f ms, median %.3f ms, p95 %.3f ms, p99 %.3f ms, 1%% low %.2f FPS\n",
+        GetRendererId(g_settings.renderer), stats.frameCount, stats.avgFps, stats.meanMs,
+        stats.medianMs, stats.p95Ms, stats.p99Ms, stats.low1Fps);
+    if (stats.latencySamples)
+        Log("[INFO] Benchmark %s: present latency mean %.3f ms, p95 %.3f ms (%s, %u samples)\n",
+            GetRendererId(g_settings.renderer), stats.latencyMeanMs, stats.latencyP95Ms, LatencySourceName(), stats.latencySamples);
+    Log("[INFO] Benchmark report: %s\n", jsonPath);
+    return true;
+}
+
+// ============== SWEEP REPORT ==============
+bool BenchmarkWriteSweepReport(const std::vector<SweepResult>& results) {
+    char gpuNameA[256] = "unknown";
+    if (g_settings.selectedGPU >= 0 && g_settings.selectedGPU < (int)g_gpuList.size()) {
+        size_t conv = 0;
+        wcstombs_s(&conv, gpuNameA, sizeof(gpuNameA), g_gpuList[g_settings.selectedGPU].name.c_str(), _TRUNCATE);
+    }
+
+    Log("[INFO] ===== Sweep results: %s =====\n", gpuNameA);
+    Log("[INFO] %-14s %-8s %8s %9s %9s %9s %9s %9s %9s\n",
+        "renderer", "status", "avg fps", "mean ms", "median", "p95", "p99", "1% low", "latency");
+    for (const SweepResult& r : results) {
+        const char* status = !r.initOK ? "no init" : r.completed ? "ok" : "aborted";
+        if (r.completed) {
+            Log("[INFO] %-14s %-8s %8.1f %9.3f %9.3f %9.3f %9.3f %9.1f %9.3f\n",
+                GetRendererId(r.renderer), status, r.stats.avgFps, r.stats.meanMs,
+                r.stats.medianMs, r.stats.p95Ms, r.stats.p99Ms, r.stats.low1Fps, r.stats.latencyMeanMs);
+        } else {
+            Log("[INFO] %-14s %-8s\n", GetRendererId(r.renderer), status);
+        }
+    }
+
+    char csvPath[MAX_PATH];
+    GetSweepReportPath(csvPath, sizeof(csvPath));
+    FILE* f = nullptr;
+    if (fopen_s(&f, csvPath, "w") != 0 || !f) {
+        Log("[ERROR] Sweep: cannot write %s\n", csvPath);
+        return false;
+    }
+    fprintf(f, "gpu,renderer,status,frames,avg_fps,mean_ms,median_ms,p95_ms,p99_ms,low1_ms,low1_fps,latency_mean_ms,latency_p95_ms\n");
+    for (const SweepResult& r : results) {
+        const char* status = !r.initOK ? "no_init" : r.completed ? "ok" : "aborted";
+        fprintf(f, "\"%s\",%s,%s,%u,%.2f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%.4f,%.4f\n",
+            gpuNameA, GetRendererId(r.renderer), status, r.stats.frameCount, r.stats.avgFps,
+            r.stats.meanMs, r.stats.medianMs, r.stats.p95Ms, r.stats.p99Ms, r.stats.low1Ms, r.stats.low1Fps,
+            r.stats.latencyMeanMs, r.stats.latencyP95Ms);
+    }
+    fclose(f);
+    Log("[INFO] Sweep report: %s\n", csvPath);
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+// ============== BENCHMARK MODE ==============
+// Headless frame-time capture for automated regression runs.
+// Enabled with --benchmark; records every frame after warm-up and
+// writes <report>.json (summary + features) and <report>.csv (per-frame).
+
+#include "common.h"
+
+// ============== BENCHMARK CONFIG ==============
+struct BenchmarkConfig {
+    bool enabled = false;
+    bool sweep = false;          // --sweep: benchmark every RendererType in turn
+    UINT warmupFrames = 100;     // Frames discarded before measuring
+    UINT frames = 0;             // Measured frames (0 = use seconds)
+    double seconds = 10.0;       // Measurement window if frames == 0
+    char reportPath[MAX_PATH] = {0};  // Base path without extension (empty = next to exe)
+    bool allGpus = false;        // --all-gpus: one concurrent child benchmark per adapter (multi_gpu_bench.h)
+    char instanceTag[32] = {0};  // --instance=<tag>: child of an --all-gpus run, suffixes the log file
+};
+
+// ============== BENCHMARK RESULTS ==============
+struct BenchmarkStats {
+    UINT frameCount;
+    double totalSeconds;
+    double avgFps;
+    double meanMs;
+    double medianMs;
+    double p95Ms;
+    double p99Ms;
+    double low1Ms;       // Mean of the slowest 1% of frames
+    double low1Fps;      // 1000 / low1Ms
+    double minMs;
+    double maxMs;
+    UINT latencySamples;     // CPU-to-present latency (frame_latency.h), 0 if the backend has no feedback
+    double latencyMeanMs;
+    double latencyP95Ms;
+};
+
+// One row of the --sweep comparison table
+struct SweepResult {
+    RendererType renderer;
+    bool initOK;
+    bool completed;
+    BenchmarkStats stats;
+};
+
+extern BenchmarkConfig g_benchConfig;
+
+// ============== BENCHMARK API ==============
+void BenchmarkBegin();                       // Call after renderer init, before the first frame
+bool BenchmarkFrame(double frameMs);         // Returns true when the measurement window is complete
+bool BenchmarkIsMeasuring();                 // False during warm-up
+void BenchmarkCpuRecordSample(double ms);    // Renderer-side CPU command recording time for this frame
+void BenchmarkLatencySample(double ms);      // CPU frame start -> displayed, one per resolved frame
+void BenchmarkPacingWaitSample(double ms);   // CPU time blocked on the frames-in-flight bound (OpenGL fences)
+bool BenchmarkComputeStats(BenchmarkStats& out);
+bool BenchmarkStatsFromFrames(const std::vector<double>& frameTimesMs, BenchmarkStats& out);  // Frame-time fields only
+bool BenchmarkWriteReport();                 // Writes JSON + CSV, returns false on I/O error
+bool BenchmarkWriteSweepReport(const std::vector<SweepResult>& results);  // <base>_sweep.csv + log table
+const char* GetRendererId(RendererType type);   // Command-line id, e.g. "d3d12_pt"
@@ -43,6 +43,12 @@ struct VulkanRTFeatures {
     float aoRadius;         // 0.1 - 1.0
     float lightRadius;      // For soft shadows, 0.05 - 0.3
 
+    // FEATURE_* bit mask of the Vulkan RT / RQ shaders (specialization constant)
+    uint32_t Bits() const {
+        return (spotlight ? 1u << 0 : 0u) | (softShadows ? 1u << 1 : 0u) | (ambientOcclusion ? 1u << 2 : 0u) |
+               (globalIllum ? 1u << 3 : 0u) | (reflections ? 1u << 4 : 0u) | (glassRefraction ? 1u << 5 : 0u);
+    }
+
     // Initialize with defaults - most features ON
     void SetDefaults() {
         spotlight = true;
@@ -85,8 +91,117 @@ struct Settings {
 };
 
 // ============== WINDOW SIZE ==============
-extern const UINT W;
-extern const UINT H;
+// Current render/backbuffer size. Set from --width/--height at startup and
+// updated by the main loop before a renderer's Resize* function is called.
+extern UINT W;
+extern UINT H;
+
+// ============== CUBE INSTANCING (--cubes=N) ==============
+// 0 keeps the classic baked 8-cube scene. N > 0 makes the raster renderers
+// (D3D11, D3D12, OpenGL, Vulkan) draw one rounded-cube mesh N times on a grid,
+// with per-instance offset/scale/color, in a single instanced draw.
+#define MAX_CUBE_INSTANCES 1000000
+
+struct CubeInstance {
+    float offset[3];
+    float scale;        // Uniform scale of the 0.95-unit mesh
+    float color[4];
+};
+
+extern UINT g_cubeCount;
+extern bool g_gpuCulling;   // --gpu-culling: D3D12 culls the instances on the GPU + ExecuteIndirect
+extern UINT g_recordThreads; // --record-threads=T: one draw per cube, recorded by T worker threads (D3D12, D3D11; 0 = off)
+extern bool g_meshShaders;  // --mesh-shaders: D3D12 generates the cubes in amplification + mesh shaders
+extern bool g_glCore;       // --gl-core: OpenGL 4.5 core context, DSA buffers, GLSL, multi-draw indirect
+
+#define MAX_RECORD_THREADS 64
+void BuildCubeInstances(UINT count, std::vector<CubeInstance>& out);
+
+// ============== PATH TRACER SAMPLING ==============
+// D3D12 PT kernel limits (PathTraceCBData). --adaptive traces at least 2 paths
+// per pixel, then doubles the count of every 8x8 tile whose worst pixel error
+// (standard error of the tone mapped luminance mean) is above the target.
+extern UINT g_ptSpp;                // --spp=N: paths per pixel per frame (default 1)
+extern UINT g_ptMaxBounces;         // --bounces=N: path length limit (default 4)
+extern UINT g_ptAdaptiveMaxSpp;     // --adaptive-max-spp=N: per-tile budget, 0 = adaptive off
+extern float g_ptAdaptiveTarget;    // --adaptive[=E]: error target (default 0.01)
+extern bool g_ptWavefront;          // --wavefront: staged kernels + material queues instead of the megakernel
+// --split-gpu[=N]: adapter N (default: the first one not rendering) traces the
+// lower band of every frame; --split-ratio=F fixes its share of the rows,
+// otherwise it follows the measured trace times of both GPUs
+extern int g_ptSplitGpu;            // PT_SPLIT_GPU_OFF, PT_SPLIT_GPU_AUTO or an adapter index
+extern float g_ptSplitRatio;        // 0 = dynamic
+
+#define PT_MAX_SPP 256
+#define PT_MAX_BOUNCES 16
+#define PT_ADAPTIVE_DEFAULT_TARGET 0.01f
+#define PT_ADAPTIVE_DEFAULT_MAX_SPP 16
+#define PT_SPLIT_GPU_OFF -1
+#define PT_SPLIT_GPU_AUTO -2
+
+// ============== RENDER SCALE ==============
+// --render-scale=P (D3D12 PT, Vulkan RQ): trace at P% of the window size per
+// axis and scale up before presenting. D3D12 PT runs an edge-adaptive upscale
+// and a contrast adaptive sharpen pass (d3d12_upscale_shaders.h), Vulkan RQ
+// only a linear vkCmdBlitImage (warned at init, "upscale" in the report).
+// 50 / 67 / 77 match the DLSS performance / balanced / quality input sizes.
+extern UINT g_renderScalePct;       // 100 = native
+#define RENDER_SCALE_MIN_PCT 25
+#define RENDER_SCALED(size) ((size) * g_renderScalePct / 100 > 0 ? (size) * g_renderScalePct / 100 : 1)
+
+// ============== DXR 1.1 AO/GI RATE ==============
+// --rt-indirect=<rate> (D3D12 DXR 1.1): AO and GI rays are traced in their own
+// pass into an RGBA16F buffer (GI radiance + AO visibility) with a normal /
+// view distance guide next to it. The lighting pass rebuilds full resolution
+// with a joint bilateral upsample, and the temporal denoise history blend
+// (when enabled) smooths what is left. Checkerboard traces half the
+// pixels each frame at full resolution and fills the other half from the
+// new neighbours plus the pixel's value from the previous frame.
+enum RtIndirectRate {
+    RT_INDIRECT_FULL,               // In the lighting pixel shader (default)
+    RT_INDIRECT_HALF,               // 1/2 x 1/2 (1/4 of the rays)
+    RT_INDIRECT_QUARTER,            // 1/4 x 1/4 (1/16 of the rays)
+    RT_INDIRECT_CHECKER,            // Full size, alternating half of the pixels
+    RT_INDIRECT_COUNT
+};
+extern RtIndirectRate g_rtIndirectRate;
+
+// --depth-prepass (DXR 1.1): the raster pass fires its RayQueries from the
+// pixel shader, so every overdrawn fragment pays for its rays before the
+// depth test throws it away. The prepass draws the scene depth-only with the
+// same vertex shader, then the lighting (and --rt-indirect) pass tests EQUAL
+// without writing depth: one shaded fragment and one set of rays per pixel.
+extern bool g_rtDepthPrepass;
+
+// --vrs[=T] (DXR 1.1, VRS Tier 2): a compute pass turns last frame's colour
+// into a shading rate image, tiles with a luminance variance below T shade
+// once per 2x2 pixels. Smooth walls fire a quarter of the pixel shader's
+// RayQueries; edges and noisy regions stay at full rate.
+#define RT_VRS_DEFAULT_THRESHOLD 0.0005f
+extern bool g_rtVrs;
+extern float g_rtVrsThreshold;
+
+// ============== DLSS RAY RECONSTRUCTION ==============
+// --dlss=<mode> picks the DLSS-RR input size for the window (NGX optimal
+// settings, fixed ratios if NGX doesn't report them); the G-buffer is traced
+// at that size with Halton camera jitter and DLSS-RR upscales to the window.
+// --dlss-target-ms=T: dynamic resolution - the input size follows the GPU
+// frame time every frame, between the mode's size and NGX's dynamic minimum.
+enum DlssQualityMode {
+    DLSS_MODE_DLAA,                 // Input = output (default)
+    DLSS_MODE_QUALITY,
+    DLSS_MODE_BALANCED,
+    DLSS_MODE_PERFORMANCE,
+    DLSS_MODE_ULTRA_PERFORMANCE,
+    DLSS_MODE_COUNT
+};
+extern DlssQualityMode g_dlssMode;
+extern float g_dlssTargetMs;        // 0 = fixed input size
+// --frame-interp: in-house frame interpolation after DLSS-RR (not NVIDIA
+// DLSS Frame Generation) - one extra frame per rendered frame, interpolated
+// from the last two DLSS-RR outputs along the G-buffer motion vectors
+// (depth-dilated) and presented half a frame interval before the rendered one.
+extern bool g_frameInterp;
 
 // ============== GLOBALS ==============
 extern HWND g_hMainWnd;
@@ -98,13 +213,44 @@ extern HINSTANCE g_hInstance;
 extern bool g_tearingSupported;
 extern std::wstring gpuName;
 extern int fps;
+extern bool g_shaderCacheEnabled;   // D3D12 DXIL/PSO + Vulkan pipeline disk cache, off with --no-shader-cache
+extern bool g_asyncCompute;         // --async-compute: Vulkan RQ traces on the async compute queue
+extern bool g_zeroCopyPresent;      // --zero-copy: D3D12 PT / Vulkan RT write the swap chain image directly
+extern bool g_vkPrerecord;          // --prerecord: Vulkan raster replays command buffers recorded once per swapchain image
+extern bool g_bundles;              // --bundles: D3D12 replays the static scene / overlay draws from pre-recorded bundles
+extern UINT g_captureEvery;         // --capture=N: D3D12 PT / Vulkan RT write every Nth frame as PNG (0 = off)
+extern char g_captureDir[MAX_PATH]; // --capture-dir=<dir>, empty = <exe dir>\captures
+extern char g_recordPath[MAX_PATH]; // --record=<file.h264>: Vulkan RT encodes its frames to H.264 (empty = off)
+extern UINT g_recordMbps;           // --record-mbps=N: target bitrate of --record
 
 // ============== LOGGING ==============
+// Defined in async_log.cpp: after LogStartWriter, Log() queues the formatted
+// line for a background writer thread instead of writing + flushing it
+enum LogLevel {
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+};
+extern LogLevel g_logLevel;             // --log-level: lines above it are dropped unformatted
+extern bool g_logSync;                  // --log-sync: write + flush on the calling thread
+
 void InitLog();
+void SetLogInstance(const char* tag);   // --instance=<tag>: log to <exe>_error_<tag>.log
+void LogStartWriter();                  // After the command line is parsed
 void Log(const char* fmt, ...);
 void LogHR(const char* operation, HRESULT hr);
+void LogFlush();                        // Wait (bounded) until everything logged so far is on disk
+UINT LogDroppedCount();                 // Lines lost to a full ring
+const char* LogLevelName(LogLevel level);
 void CloseLog();
 
+// ============== COMMAND LINE ==============
+// Defined in main.cpp. strtok_s over a writable copy of the command line
+// (str on the first call, nullptr after), splitting on spaces outside double
+// quotes and removing the quotes: --report="C:\My Runs\x" is one argument.
+char* CommandArgToken(char* str, char** context);
+
 // ============== GPU ENUMERATION ==============
 void EnumerateGPUs();
 void FreeGPUList();
@@ -0,0 +1,486 @@
+// ============== ROUNDED CUBE GEOMETRY ==============
+// SSE2 face grids, welding and index reordering for the raster renderers'
+// rounded cubes (see cube_geometry.h)
+
+#include "cube_geometry.h"
+#include <emmintrin.h>
+#include <cstring>
+#include <algorithm>
+
+#define CUBE_FORSYTH_CACHE 32       // LRU size of the reorder's cache model
+#define CUBE_FIFO_CACHE 16          // FIFO size of the ACMR / cluster model
+#define CUBE_WELD_POS_EPS 1e-5f
+#define CUBE_WELD_NORMAL_EPS 1e-3f
+
+static const float s_faceN[6][3] = {{0,0,1},{0,0,-1},{1,0,0},{-1,0,0},{0,1,0},{0,-1,0}};
+static const float s_faceU[6][3] = {{-1,0,0},{1,0,0},{0,0,1},{0,0,-1},{1,0,0},{1,0,0}};
+static const float s_faceV[6][3] = {{0,1,0},{0,1,0},{0,1,0},{0,1,0},{0,0,1},{0,0,-1}};
+
+// Per build: vertex / triangle counts before and after welding, FIFO misses
+// before and after the reorder
+struct CubeBuildStats {
+    uint32_t rawVerts = 0, rawTris = 0;
+    uint32_t verts = 0, tris = 0;
+    uint32_t missesBefore = 0, missesAfter = 0;
+};
+
+// ============== FACE GRID (SSE2) ==============
+
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 Abs(__m128 v)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+// One face as a (seg+1)^2 grid. edgeRadius: +u, -u, +v, -v edges, negative =
+// rounded inward (hidden edge of the baked scene). Four columns of a row per
+// iteration; the row's v terms are scalars broadcast across the lanes.
+static void GenRoundedFace(float size, int seg, const float offset[3], int faceIdx, const float edgeRadius[4],
+                           uint32_t cubeID, std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds)
+{
+    uint32_t base = (uint32_t)verts.size();
+    float h = size / 2;
+    const float* fn = s_faceN[faceIdx];
+    const float* fu = s_faceU[faceIdx];
+    const float* fv = s_faceV[faceIdx];
+
+    int rowLen = seg + 1;
+    int rowPad = (rowLen + 3) & ~3;
+    std::vector<float> col(rowPad * 4);     // u * h, |rU|, outer U (0/1), sign of u
+    float* colPx = col.data();
+    float* colRU = colPx + rowPad;
+    float* colOuterU = colRU + rowPad;
+    float* colSgnU = colOuterU + rowPad;
+    for (int i = 0; i < rowPad; i++) {
+        float u = (float)std::min<int>(i, seg) / seg * 2 - 1;
+        float rURaw = (u > 0) ? edgeRadius[0] : edgeRadius[1];
+        colPx[i] = u * h;
+        colRU[i] = fabsf(rURaw);
+        colOuterU[i] = rURaw > 0 ? 1.0f : 0.0f;
+        colSgnU[i] = u > 0 ? 1.0f : -1.0f;
+    }
+
+    alignas(16) float out[6][4];
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), hv = _mm_set1_ps(h);
+
+    for (int j = 0; j <= seg; j++) {
+        float vv = (float)j / seg * 2 - 1;
+        float rVRaw = (vv > 0) ? edgeRadius[2] : edgeRadius[3];
+        float rVs = fabsf(rVRaw), innerVs = h - rVs, py0 = vv * h;
+        float dys = (rVs > 0) ? fmaxf(0, fabsf(py0) - innerVs) : 0;
+
+        const __m128 rV = _mm_set1_ps(rVs), innerV = _mm_set1_ps(innerVs), dy = _mm_set1_ps(dys);
+        const __m128 sgnV = _mm_set1_ps(vv > 0 ? 1.0f : -1.0f);
+        const __m128 outerV = rVRaw > 0 ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+        const __m128 hasDy = _mm_cmpgt_ps(dy, zero);
+        const __m128 rVSafe = Select(_mm_cmpgt_ps(rV, zero), rV, one);
+
+        for (int i = 0; i < rowLen; i += 4) {
+            __m128 px0 = _mm_loadu_ps(colPx + i);
+            __m128 rU = _mm_loadu_ps(colRU + i);
+            __m128 outerU = _mm_cmpgt_ps(_mm_loadu_ps(colOuterU + i), zero);
+            __m128 sgnU = _mm_loadu_ps(colSgnU + i);
+            __m128 innerU = _mm_sub_ps(hv, rU);
+            __m128 rUSafe = Select(_mm_cmpgt_ps(rU, zero), rU, one);
+
+            __m128 dx = _mm_and_ps(_mm_cmpgt_ps(rU, zero), _mm_max_ps(zero, _mm_sub_ps(Abs(px0), innerU)));
+            __m128 hasDx = _mm_cmpgt_ps(dx, zero);
+            __m128 innerOnly = _mm_andnot_ps(_mm_or_ps(outerU, outerV), _mm_and_ps(hasDx, hasDy));
+
+            // Inward corner (no neighbour face on either side): cylinder of the
+            // side that reaches further in
+            __m128 useU = _mm_and_ps(innerOnly, _mm_cmpge_ps(dx, dy));
+            __m128 useV = _mm_andnot_ps(useU, innerOnly);
+            __m128 uCz = _mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(_mm_mul_ps(rU, rU), _mm_mul_ps(dx, dx))));
+            __m128 vCz = _mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(_mm_mul_ps(rV, rV), _mm_mul_ps(dy, dy))));
+            __m128 cPx = Select(useU, _mm_mul_ps(sgnU, _mm_add_ps(innerU, dx)), px0);
+            __m128 cPy = Select(useV, _mm_mul_ps(sgnV, _mm_add_ps(innerV, dy)), _mm_set1_ps(py0));
+            __m128 cPz = Select(useU, _mm_add_ps(innerU, uCz), _mm_add_ps(innerV, vCz));
+            __m128 cNx = _mm_and_ps(useU, _mm_div_ps(_mm_mul_ps(sgnU, dx), rUSafe));
+            __m128 cNy = _mm_and_ps(useV, _mm_div_ps(_mm_mul_ps(sgnV, dy), rVSafe));
+            __m128 cNz = Select(useU, _mm_div_ps(uCz, rUSafe), _mm_div_ps(vCz, rVSafe));
+
+            // Everything else: direction from the inner box (centre c), pos =
+            // c + r * dir. An inward side (no neighbour) sweeps its full 90
+            // degrees on this face; an outward one stops at 45 degrees, where
+            // the neighbour face's grid computes the same point, so the seams
+            // weld. With only outward sides this is the rounded box projection.
+            __m128 r = _mm_max_ps(_mm_and_ps(hasDx, rU), _mm_and_ps(hasDy, rV));
+            __m128 rounded = _mm_cmpgt_ps(r, zero);
+            __m128 rSafe = Select(rounded, r, one);
+            __m128 inU = _mm_andnot_ps(outerU, hasDx), inV = _mm_andnot_ps(outerV, hasDy);
+            __m128 s2 = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(rSafe, rSafe), _mm_and_ps(inU, _mm_mul_ps(dx, dx))),
+                                   _mm_and_ps(inV, _mm_mul_ps(dy, dy)));
+            __m128 sz = _mm_sqrt_ps(_mm_max_ps(zero, s2));
+            __m128 au = Select(outerU, _mm_div_ps(_mm_mul_ps(dx, sz), rSafe), dx);
+            __m128 av = Select(outerV, _mm_div_ps(_mm_mul_ps(dy, sz), rSafe), dy);
+            __m128 alen = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(au, au), _mm_mul_ps(av, av)), _mm_mul_ps(sz, sz)));
+            alen = Select(_mm_cmpgt_ps(alen, zero), alen, one);
+            __m128 du = _mm_div_ps(au, alen), dv = _mm_div_ps(av, alen), dz = _mm_div_ps(sz, alen);
+            __m128 centre = _mm_sub_ps(hv, rSafe);
+            __m128 rPx = Select(hasDx, _mm_mul_ps(sgnU, _mm_add_ps(centre, _mm_mul_ps(rSafe, du))), px0);
+            __m128 rPy = Select(hasDy, _mm_mul_ps(sgnV, _mm_add_ps(centre, _mm_mul_ps(rSafe, dv))), _mm_set1_ps(py0));
+            __m128 rPz = _mm_add_ps(centre, _mm_mul_ps(rSafe, dz));
+
+            __m128 px = Select(innerOnly, cPx, Select(rounded, rPx, px0));
+            __m128 py = Select(innerOnly, cPy, Select(rounded, rPy, _mm_set1_ps(py0)));
+            __m128 pz = Select(innerOnly, cPz, Select(rounded, rPz, hv));
+            __m128 nx = Select(innerOnly, cNx, _mm_and_ps(rounded, _mm_mul_ps(sgnU, du)));
+            __m128 ny = Select(innerOnly, cNy, _mm_and_ps(rounded, _mm_mul_ps(sgnV, dv)));
+            __m128 nz = Select(innerOnly, cNz, Select(rounded, dz, one));
+
+            // Face space -> object space, normalized normal
+            __m128 n[3];
+            for (int a = 0; a < 3; a++) {
+                __m128 p = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_set1_ps(offset[a]), _mm_mul_ps(px, _mm_set1_ps(fu[a]))),
+                                                 _mm_mul_ps(py, _mm_set1_ps(fv[a]))), _mm_mul_ps(pz, _mm_set1_ps(fn[a])));
+                _mm_store_ps(out[a], p);
+                n[a] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps(fu[a])), _mm_mul_ps(ny, _mm_set1_ps(fv[a]))),
+                                  _mm_mul_ps(nz, _mm_set1_ps(fn[a])));
+            }
+            __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], n[0]), _mm_mul_ps(n[1], n[1])),
+                                                _mm_mul_ps(n[2], n[2])));
+            len = Select(_mm_cmplt_ps(len, _mm_set1_ps(0.001f)), one, len);
+            for (int a = 0; a < 3; a++) _mm_store_ps(out[3 + a], _mm_div_ps(n[a], len));
+
+            for (int k = 0; k < 4 && i + k < rowLen; k++) {
+                CubeVertex v;
+                v.pos[0] = out[0][k]; v.pos[1] = out[1][k]; v.pos[2] = out[2][k];
+                v.normal[0] = out[3][k]; v.normal[1] = out[4][k]; v.normal[2] = out[5][k];
+                v.cubeID = cubeID;
+                verts.push_back(v);
+            }
+        }
+    }
+
+    for (int j = 0; j < seg; j++) {
+        for (int i = 0; i < seg; i++) {
+            uint32_t idx = base + j * (seg + 1) + i;
+            inds.push_back(idx); inds.push_back(idx + seg + 1); inds.push_back(idx + 1);
+            inds.push_back(idx + 1); inds.push_back(idx + seg + 1); inds.push_back(idx + seg + 2);
+        }
+    }
+}
+
+// ============== WELDING ==============
+
+static bool WeldNear(const CubeVertex& a, const CubeVertex& b)
+{
+    for (int k = 0; k < 3; k++) {
+        if (fabsf(a.pos[k] - b.pos[k]) > CUBE_WELD_POS_EPS) return false;
+        if (fabsf(a.normal[k] - b.normal[k]) > CUBE_WELD_NORMAL_EPS) return false;
+    }
+    return a.cubeID == b.cubeID;
+}
+
+// Merges vertices closer than the epsilons (face borders meet up to rounding)
+// and drops the triangles that lost an edge. Sweep along a skew axis, so the
+// axis-aligned face grids don't pile up in one window.
+static void WeldMesh(std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds)
+{
+    uint32_t n = (uint32_t)verts.size();
+    std::vector<float> key(n);
+    std::vector<uint32_t> order(n), remap(n, UINT32_MAX);
+    for (uint32_t i = 0; i < n; i++) {
+        key[i] = verts[i].pos[0] + 1.618034f * verts[i].pos[1] + 2.718282f * verts[i].pos[2];
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+
+    const float window = CUBE_WELD_POS_EPS * (1.0f + 1.618034f + 2.718282f);
+    std::vector<CubeVertex> welded;
+    welded.reserve(n);
+    for (uint32_t s = 0; s < n; s++) {
+        uint32_t a = order[s];
+        if (remap[a] != UINT32_MAX) continue;
+        remap[a] = (uint32_t)welded.size();
+        welded.push_back(verts[a]);
+        for (uint32_t t = s + 1; t < n && key[order[t]] - key[a] <= window; t++) {
+            uint32_t b = order[t];
+            if (remap[b] == UINT32_MAX && WeldNear(verts[a], verts[b])) remap[b] = remap[a];
+        }
+    }
+
+    size_t out = 0;
+    for (size_t t = 0; t + 2 < inds.size(); t += 3) {
+        uint32_t i0 = remap[inds[t]], i1 = remap[inds[t + 1]], i2 = remap[inds[t + 2]];
+        if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+        inds[out++] = i0; inds[out++] = i1; inds[out++] = i2;
+    }
+    inds.resize(out);
+    verts.swap(welded);
+}
+
+// ============== CACHE / OVERDRAW ORDER ==============
+
+// Vertex shader runs with a FIFO post-transform cache
+static uint32_t FifoMisses(const std::vector<uint32_t>& inds, uint32_t vertexCount)
+{
+    std::vector<uint32_t> stamp(vertexCount, 0);
+    uint32_t misses = 0, time = CUBE_FIFO_CACHE + 1;
+    for (uint32_t idx : inds) {
+        if (time - stamp[idx] > CUBE_FIFO_CACHE) { stamp[idx] = time++; misses++; }
+    }
+    return misses;
+}
+
+#define CUBE_FORSYTH_MAX_VALENCE 32
+
+// Score tables by cache position (last entry = not cached) and live triangle count
+struct ForsythTables {
+    float cache[CUBE_FORSYTH_CACHE + 1];
+    float valence[CUBE_FORSYTH_MAX_VALENCE];
+    ForsythTables() {
+        for (int p = 0; p < CUBE_FORSYTH_CACHE; p++)   // Last triangle's vertices fixed, so it isn't reused at once
+            cache[p] = p < 3 ? 0.75f : powf(1.0f - (float)(p - 3) / (CUBE_FORSYTH_CACHE - 3), 1.5f);
+        cache[CUBE_FORSYTH_CACHE] = 0.0f;
+        valence[0] = 0.0f;
+        for (int v = 1; v < CUBE_FORSYTH_MAX_VALENCE; v++) valence[v] = 2.0f / sqrtf((float)v);
+    }
+};
+static const ForsythTables s_forsyth;
+
+static float ForsythVertexScore(int cachePos, uint32_t liveTris)
+{
+    if (liveTris == 0) return -1.0f;
+    return s_forsyth.cache[cachePos >= 0 ? cachePos : CUBE_FORSYTH_CACHE] +
+           s_forsyth.valence[std::min<uint32_t>(liveTris, CUBE_FORSYTH_MAX_VALENCE - 1)];
+}
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+static void OptimizeVertexCache(std::vector<uint32_t>& inds, uint32_t vertexCount)
+{
+    uint32_t triCount = (uint32_t)inds.size() / 3;
+    if (triCount == 0) return;
+
+    std::vector<uint32_t> liveTris(vertexCount, 0), adjOffset(vertexCount + 1, 0), adj(inds.size());
+    for (uint32_t idx : inds) liveTris[idx]++;
+    for (uint32_t v = 0; v < vertexCount; v++) adjOffset[v + 1] = adjOffset[v] + liveTris[v];
+    std::vector<uint32_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+    for (uint32_t t = 0; t < triCount; t++)
+        for (int k = 0; k < 3; k++) adj[fill[inds[t * 3 + k]]++] = t;
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vertScore(vertexCount), triScore(triCount, 0.0f);
+    std::vector<bool> emitted(triCount, false);
+    for (uint32_t v = 0; v < vertexCount; v++) vertScore[v] = ForsythVertexScore(-1, liveTris[v]);
+    for (uint32_t t = 0; t < triCount; t++)
+        triScore[t] = vertScore[inds[t * 3]] + vertScore[inds[t * 3 + 1]] + vertScore[inds[t * 3 + 2]];
+
+    std::vector<uint32_t> result;
+    result.reserve(inds.size());
+    uint32_t cache[CUBE_FORSYTH_CACHE + 3], cacheSize = 0;
+    int64_t best = 0;
+    for (uint32_t t = 1; t < triCount; t++) if (triScore[t] > triScore[best]) best = t;
+
+    while (best >= 0) {
+        uint32_t t = (uint32_t)best;
+        emitted[t] = true;
+        uint32_t newCache[CUBE_FORSYTH_CACHE + 3], newSize = 0;
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = inds[t * 3 + k];
+            result.push_back(v);
+            newCache[newSize++] = v;
+            // Drop t from v's live triangles
+            uint32_t* list = &adj[adjOffset[v]];
+            for (uint32_t e = 0; e < liveTris[v]; e++)
+                if (list[e] == t) { list[e] = list[liveTris[v] - 1]; break; }
+            liveTris[v]--;
+        }
+        for (uint32_t c = 0; c < cacheSize; c++) {
+            uint32_t v = cache[c];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2]) newCache[newSize++] = v;
+        }
+
+        // Rescore everything that entered, moved in or fell out of the cache
+        best = -1;
+        for (uint32_t c = 0; c < newSize; c++) {
+            uint32_t v = newCache[c];
+            cachePos[v] = c < CUBE_FORSYTH_CACHE ? (int)c : -1;
+            vertScore[v] = ForsythVertexScore(cachePos[v], liveTris[v]);
+        }
+        for (uint32_t c = 0; c < newSize; c++) {
+            uint32_t v = newCache[c];
+            const uint32_t* list = &adj[adjOffset[v]];
+            for (uint32_t e = 0; e < liveTris[v]; e++) {
+                uint32_t tt = list[e];
+                triScore[tt] = vertScore[inds[tt * 3]] + vertScore[inds[tt * 3 + 1]] + vertScore[inds[tt * 3 + 2]];
+                if (best < 0 || triScore[tt] > triScore[best]) best = tt;
+            }
+        }
+        cacheSize = std::min<uint32_t>(newSize, CUBE_FORSYTH_CACHE);
+        memcpy(cache, newCache, cacheSize * sizeof(uint32_t));
+
+        // Nothing left around the cache: restart at the best remaining triangle
+        if (best < 0) {
+            for (uint32_t tt = 0; tt < triCount; tt++)
+                if (!emitted[tt] && (best < 0 || triScore[tt] > triScore[best])) best = tt;
+        }
+    }
+    inds.swap(result);
+}
+
+// Cuts the cache-ordered list where a triangle misses with all 3 vertices
+// (the cache starts over there anyway) and draws the clusters facing away
+// from the mesh centre first, so they occlude the rest early.
+static void OptimizeOverdraw(std::vector<uint32_t>& inds, const std::vector<CubeVertex>& verts)
+{
+    uint32_t triCount = (uint32_t)inds.size() / 3;
+    if (triCount == 0) return;
+
+    float centre[3] = {0, 0, 0};
+    for (const CubeVertex& v : verts)
+        for (int k = 0; k < 3; k++) centre[k] += v.pos[k];
+    for (int k = 0; k < 3; k++) centre[k] /= (float)verts.size();
+
+    std::vector<uint32_t> clusterStart;
+    std::vector<uint32_t> stamp(verts.size(), 0);
+    uint32_t time = CUBE_FIFO_CACHE + 1;
+    for (uint32_t t = 0; t < triCount; t++) {
+        uint32_t misses = 0;
+        for (int k = 0; k < 3; k++) {
+            uint32_t idx = inds[t * 3 + k];
+            if (time - stamp[idx] > CUBE_FIFO_CACHE) { stamp[idx] = time++; misses++; }
+        }
+        if (t == 0 || misses == 3) clusterStart.push_back(t);
+    }
+    clusterStart.push_back(triCount);
+
+    uint32_t clusterCount = (uint32_t)clusterStart.size() - 1;
+    std::vector<float> facing(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; c++) {
+        float pos[3] = {0, 0, 0}, nrm[3] = {0, 0, 0};
+        for (uint32_t i = clusterStart[c] * 3; i < clusterStart[c + 1] * 3; i++) {
+            const CubeVertex& v = verts[inds[i]];
+            for (int k = 0; k < 3; k++) { pos[k] += v.pos[k]; nrm[k] += v.normal[k]; }
+        }
+        float count = (float)((clusterStart[c + 1] - clusterStart[c]) * 3);
+        float len = sqrtf(nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2]);
+        if (len < 1e-6f) len = 1;
+        facing[c] = 0;
+        for (int k = 0; k < 3; k++) facing[c] += (pos[k] / count - centre[k]) * nrm[k] / len;
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; c++) order[c] = c;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return facing[a] > facing[b]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(inds.size());
+    for (uint32_t c : order)
+        result.insert(result.end(), inds.begin() + clusterStart[c] * 3, inds.begin() + clusterStart[c + 1] * 3);
+    inds.swap(result);
+}
+
+// Renumbers the vertices in the order the index buffer first uses them
+static void OptimizeVertexFetch(std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds)
+{
+    std::vector<uint32_t> remap(verts.size(), UINT32_MAX);
+    std::vector<CubeVertex> ordered;
+    ordered.reserve(verts.size());
+    for (uint32_t& idx : inds) {
+        if (remap[idx] == UINT32_MAX) { remap[idx] = (uint32_t)ordered.size(); ordered.push_back(verts[idx]); }
+        idx = remap[idx];
+    }
+    verts.swap(ordered);
+}
+
+// ============== CUBES ==============
+
+// Faces of one cube, welded and reordered, appended to verts / inds
+static void BuildCube(const float offset[3], const bool renderFace[6], const float edgeRadius[6][4], uint32_t cubeID,
+                      std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds, CubeBuildStats& stats)
+{
+    const int seg = CUBE_GEOMETRY_SEGMENTS;
+    int faces = 0;
+    for (int f = 0; f < 6; f++) faces += renderFace[f] ? 1 : 0;
+
+    std::vector<CubeVertex> cubeVerts;
+    std::vector<uint32_t> cubeInds;
+    cubeVerts.reserve((size_t)faces * (seg + 1) * (seg + 1));
+    cubeInds.reserve((size_t)faces * seg * seg * 6);
+    for (int f = 0; f < 6; f++)
+        if (renderFace[f]) GenRoundedFace(CUBE_GEOMETRY_SIZE, seg, offset, f, edgeRadius[f], cubeID, cubeVerts, cubeInds);
+
+    stats.rawVerts += (uint32_t)cubeVerts.size();
+    stats.rawTris += (uint32_t)cubeInds.size() / 3;
+    stats.missesBefore += FifoMisses(cubeInds, (uint32_t)cubeVerts.size());
+
+    WeldMesh(cubeVerts, cubeInds);
+    OptimizeVertexCache(cubeInds, (uint32_t)cubeVerts.size());
+    OptimizeOverdraw(cubeInds, cubeVerts);
+    OptimizeVertexFetch(cubeVerts, cubeInds);
+
+    stats.verts += (uint32_t)cubeVerts.size();
+    stats.tris += (uint32_t)cubeInds.size() / 3;
+    stats.missesAfter += FifoMisses(cubeInds, (uint32_t)cubeVerts.size());
+
+    uint32_t base = (uint32_t)verts.size();
+    verts.insert(verts.end(), cubeVerts.begin(), cubeVerts.end());
+    inds.reserve(inds.size() + cubeInds.size());
+    for (uint32_t idx : cubeInds) inds.push_back(base + idx);
+}
+
+static void LogCubeStats(const char* what, const CubeBuildStats& s)
+{
+    Log("[INFO] %s geometry: %u -> %u vertices (welded), %u -> %u triangles, ACMR %.3f -> %.3f\n",
+        what, s.rawVerts, s.verts, s.rawTris, s.tris,
+        s.rawTris ? (double)s.missesBefore / s.rawTris : 0.0, s.tris ? (double)s.missesAfter / s.tris : 0.0);
+}
+
+static void BuildSceneCubeInternal(int cubeID, std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds,
+                                   CubeBuildStats& stats)
+{
+    static const int coords[8][3] = {
+        {-1, +1, +1}, {+1, +1, +1}, {-1, -1, +1}, {+1, -1, +1},
+        {-1, +1, -1}, {+1, +1, -1}, {-1, -1, -1}, {+1, -1, -1},
+    };
+    const float outerR = CUBE_GEOMETRY_RADIUS, innerR = -CUBE_GEOMETRY_RADIUS;
+    const float half = CUBE_GEOMETRY_SIZE / 2;
+
+    int cx = coords[cubeID][0], cy = coords[cubeID][1], cz = coords[cubeID][2];
+    float offset[3] = {cx * half, cy * half, cz * half};
+    bool renderFace[6] = {(cz > 0), (cz < 0), (cx > 0), (cx < 0), (cy > 0), (cy < 0)};
+
+    // Edges on the outside of the 2x2x2 block round outward, the ones facing
+    // a neighbour inward
+    float er[6][4] = {
+        {(cx < 0) ? outerR : innerR, (cx > 0) ? outerR : innerR, (cy > 0) ? outerR : innerR, (cy < 0) ? outerR : innerR},
+        {(cx > 0) ? outerR : innerR, (cx < 0) ? outerR : innerR, (cy > 0) ? outerR : innerR, (cy < 0) ? outerR : innerR},
+        {(cz > 0) ? outerR : innerR, (cz < 0) ? outerR : innerR, (cy > 0) ? outerR : innerR, (cy < 0) ? outerR : innerR},
+        {(cz < 0) ? outerR : innerR, (cz > 0) ? outerR : innerR, (cy > 0) ? outerR : innerR, (cy < 0) ? outerR : innerR},
+        {(cx > 0) ? outerR : innerR, (cx < 0) ? outerR : innerR, (cz > 0) ? outerR : innerR, (cz < 0) ? outerR : innerR},
+        {(cx > 0) ? outerR : innerR, (cx < 0) ? outerR : innerR, (cz < 0) ? outerR : innerR, (cz > 0) ? outerR : innerR},
+    };
+    BuildCube(offset, renderFace, er, (uint32_t)cubeID, verts, inds, stats);
+}
+
+void BuildSceneCube(int cubeID, std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds)
+{
+    CubeBuildStats stats;
+    BuildSceneCubeInternal(cubeID, verts, inds, stats);
+}
+
+void BuildSceneCubes(std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds)
+{
+    CubeBuildStats stats;
+    for (int c = 0; c < 8; c++) BuildSceneCubeInternal(c, verts, inds, stats);
+    LogCubeStats("Cube scene", stats);
+}
+
+void BuildInstanceCube(std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds)
+{
+    const float offset[3] = {0, 0, 0};
+    const bool renderFace[6] = {true, true, true, true, true, true};
+    float er[6][4];
+    for (int f = 0; f < 6; f++)
+        for (int e = 0; e < 4; e++) er[f][e] = CUBE_GEOMETRY_RADIUS;
+
+    CubeBuildStats stats;
+    BuildCube(offset, renderFace, er, 0, verts, inds, stats);
+    LogCubeStats("Instance cube", stats);
+}
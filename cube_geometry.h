@@ -0,0 +1,39 @@
+#pragma once
+// ============== ROUNDED CUBE GEOMETRY ==============
+// The raster renderers' rounded cubes (D3D11, D3D12, OpenGL, Vulkan), built
+// once here instead of per backend. Each face is a (seg+1)^2 grid evaluated
+// four vertices at a time with SSE2. An edge shared with another drawn face
+// is split at 45 degrees (rounded box projection) so both grids end on the
+// same points; the faces are then welded (position + normal within an
+// epsilon, same cube), triangles that lost an edge are dropped, and the index
+// buffer is reordered per cube:
+//   - vertex cache: Forsyth's linear-speed optimizer (32-entry LRU model)
+//   - overdraw: the optimized order is cut into clusters where the cache
+//     runs cold and the clusters are sorted outward-facing first
+//   - vertex fetch: vertices renumbered in first-use order
+// The log lists the vertex count before / after welding and the ACMR
+// (vertex shader runs per triangle, 16-entry FIFO model) before / after.
+
+#include "common.h"
+#include <cstdint>
+
+#define CUBE_GEOMETRY_SIZE 0.95f        // Edge length of one rounded cube
+#define CUBE_GEOMETRY_RADIUS 0.12f      // Edge rounding radius
+#define CUBE_GEOMETRY_SEGMENTS 20       // Grid cells per face side
+
+// Vertex layout of the D3D11 / D3D12 raster input layout (28 bytes); GL and
+// Vulkan read the position and normal at offsets 0 and 12.
+struct CubeVertex {
+    float pos[3];
+    float normal[3];
+    uint32_t cubeID;    // 0-7 in the baked scene, 0 for the instanced mesh
+};
+static_assert(sizeof(CubeVertex) == 28, "CubeVertex must be 28 bytes");
+
+// One of the 8 cubes of the classic scene (outward faces only), appended to
+// verts / inds with its indices rebased.
+void BuildSceneCube(int cubeID, std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds);
+// All 8 cubes, cube c's triangles before cube c+1's
+void BuildSceneCubes(std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds);
+// The --cubes=N instance mesh: one cube at the origin, every edge rounded outward
+void BuildInstanceCube(std::vector<CubeVertex>& verts, std::vector<uint32_t>& inds);
@@ -12,21 +12,26 @@
 
 #include "../common.h"
 #include "../shaders/d3d11_shaders.h"
+#include "../benchmark.h"
+#include "../gpu_profiler.h"
+#include "../frame_latency.h"
+#include "../mesh_file.h"
+#include "../cube_geometry.h"
+#include "../text_overlay.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "../offscreen.h"
+#include "renderer_d3d11.h"
 
 using namespace DirectX;
 
 // ============== LOCAL TYPES ==============
 
-// Vertex with cube ID for GPU color lookup
-struct Vert {
-    XMFLOAT3 p, n;
-    UINT cubeID;
-};
-
 // Constant buffer - ONLY dynamic data (everything else in shader)
 struct CB {
     float time;
-    float _pad[3];
+    float aspect;   // W / H, corrects the projection for non-4:3 backbuffers
+    float _pad[2];
 };
 
 // ============== D3D11 GLOBALS ==============
@@ -36,217 +41,85 @@ static ID3D11DeviceContext* ctx = nullptr;
 static IDXGISwapChain* swap = nullptr;
 static ID3D11RenderTargetView* rtv = nullptr;
 static ID3D11DepthStencilView* dsv = nullptr;
+static UINT swapFlags = 0;   // Creation flags, ResizeBuffers must pass the same ones
+static HANDLE swapWaitable = nullptr;   // --max-latency
 static ID3D11VertexShader* vs = nullptr;
 static ID3D11PixelShader* ps = nullptr;
 static ID3D11InputLayout* il = nullptr;
 static ID3D11Buffer* vb = nullptr, *ib = nullptr, *cbuf = nullptr;
+static ID3D11Buffer* instVB = nullptr;   // CubeInstance per instance (--cubes=N only)
 static UINT totalIndices = 0;
 static UINT totalVertices = 0;
+static UINT instanceCount = 1;
+static UINT vbStride = sizeof(CubeVertex);     // sizeof(MeshVertex) with --mesh
 
-// GPU text rendering (D3D11)
+// GPU text rendering (D3D11): instanced glyphs, see text_overlay.h
 static ID3D11VertexShader* textVS = nullptr;
 static ID3D11PixelShader* textPS = nullptr;
 static ID3D11InputLayout* textIL = nullptr;
-static ID3D11Buffer* textVB = nullptr;
-static ID3D11Texture2D* fontTex = nullptr;
-static ID3D11ShaderResourceView* fontSRV = nullptr;
-static ID3D11SamplerState* fontSampler = nullptr;
+static ID3D11Buffer* textVB = nullptr;      // GlyphInstance, rewritten only when the overlay changes
+static ID3D11Buffer* textCB = nullptr;      // 1 / width, 1 / height
 static ID3D11BlendState* textBlend = nullptr;
+static TextOverlay overlay;
+static UINT textVBVersion = 0;
+static UINT textCBWidth = 0, textCBHeight = 0;
+static char overlayGpuName[128] = {};   // gpuName as ASCII, converted once in InitGPUText
+
+// --record-threads=T: per-cube draws recorded into deferred contexts by worker
+// threads, the command lists executed in order on the immediate context
+struct DeferredWorker {
+    HANDLE thread;
+    HANDLE startEvent;      // Auto-reset, set by RenderD3D11
+    HANDLE doneEvent;       // Auto-reset, set by the worker
+    ID3D11DeviceContext* deferred;
+    ID3D11CommandList* list;    // Recorded this frame, released after ExecuteCommandList
+    UINT firstInstance;
+    UINT instanceCount;
+};
+static DeferredWorker workers[MAX_RECORD_THREADS] = {};
+static HANDLE workerDone[MAX_RECORD_THREADS] = {};
+static UINT workerCount = 0;
+static volatile LONG workersQuit = 0;
+static D3D11_FEATURE_DATA_THREADING threadingCaps = {};
+static double cpuRecordMs = 0.0;
 
 // ============== FORWARD DECLARATIONS ==============
+// GPU timestamp queries (ring of frames so GetData never waits)
+#define TIMER_FRAMES 4
+#define TIMER_STAMPS 3   // frame start, after scene, after text
+static ID3D11Query* timerDisjoint[TIMER_FRAMES] = {};
+static ID3D11Query* timerStamps[TIMER_FRAMES][TIMER_STAMPS] = {};
+static bool timerIssued[TIMER_FRAMES] = {};
+static UINT timerFrame = 0;
+static const char* timerPassNames[TIMER_STAMPS] = { nullptr, "Scene", "Text" };
+
 static bool InitShaders();
 static bool InitGPUText();
+static bool CreateSizeDependentResources();
 
-// ============== GEOMETRY GENERATION ==============
-
-static void GenRoundedFace(float size, int seg, XMFLOAT3 offset, int faceIdx,
-    float edgeRadius[4], UINT cubeID, std::vector<Vert>& verts, std::vector<UINT>& inds)
-{
-    UINT base = (UINT)verts.size();
-    float h = size / 2;
-
-    XMFLOAT3 faceN[6] = {{0,0,1},{0,0,-1},{1,0,0},{-1,0,0},{0,1,0},{0,-1,0}};
-    XMFLOAT3 faceU[6] = {{-1,0,0},{1,0,0},{0,0,1},{0,0,-1},{1,0,0},{1,0,0}};
-    XMFLOAT3 faceV[6] = {{0,1,0},{0,1,0},{0,1,0},{0,1,0},{0,0,1},{0,0,-1}};
-
-    XMFLOAT3 fn = faceN[faceIdx], fu = faceU[faceIdx], fv = faceV[faceIdx];
-
-    for (int j = 0; j <= seg; j++) {
-        for (int i = 0; i <= seg; i++) {
-            float u = (float)i / seg * 2 - 1;
-            float vv = (float)j / seg * 2 - 1;
-
-            float px = u * h, py = vv * h;
-            float pz = h;
-            float nx = 0, ny = 0, nz = 1;
-
-            float rU_raw = (u > 0) ? edgeRadius[0] : edgeRadius[1];
-            float rV_raw = (vv > 0) ? edgeRadius[2] : edgeRadius[3];
-            float rU = fabsf(rU_raw), rV = fabsf(rV_raw);
-            bool outerU = (rU_raw > 0), outerV = (rV_raw > 0);
-
-            if (rU > 0 || rV > 0) {
-                float innerU = h - rU, innerV = h - rV;
-                float dx = (rU > 0) ? fmaxf(0, fabsf(px) - innerU) : 0;
-                float dy = (rV > 0) ? fmaxf(0, fabsf(py) - innerV) : 0;
-
-                if (dx > 0 || dy > 0) {
-                    bool isCorner = (dx > 0 && dy > 0);
-                    bool sphericalCorner = isCorner && (outerU || outerV);
-
-                    if (sphericalCorner) {
-                        float r = fmaxf(rU, rV);
-                        float dist = sqrtf(dx*dx + dy*dy);
-                        if (dist > r) { dx = dx * r / dist; dy = dy * r / dist; }
-                        float curveZ = sqrtf(fmaxf(0, r*r - dx*dx - dy*dy));
-                        pz = (h - r) + curveZ;
-                        px = (u > 0 ? 1 : -1) * (innerU + dx);
-                        py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                        nx = (u > 0 ? 1 : -1) * dx / r;
-                        ny = (vv > 0 ? 1 : -1) * dy / r;
-                        nz = curveZ / r;
-                    } else if (isCorner) {
-                        if (dx >= dy) {
-                            float curveZ = sqrtf(fmaxf(0, rU*rU - dx*dx));
-                            pz = (h - rU) + curveZ;
-                            px = (u > 0 ? 1 : -1) * (innerU + dx);
-                            nx = (u > 0 ? 1 : -1) * dx / rU;
-                            nz = curveZ / rU;
-                        } else {
-                            float curveZ = sqrtf(fmaxf(0, rV*rV - dy*dy));
-                            pz = (h - rV) + curveZ;
-                            py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                            ny = (vv > 0 ? 1 : -1) * dy / rV;
-                            nz = curveZ / rV;
-                        }
-                    } else {
-                        float r = (dx > 0) ? rU : rV;
-                        float d = (dx > 0) ? dx : dy;
-                        float curveZ = sqrtf(fmaxf(0, r*r - d*d));
-                        pz = (h - r) + curveZ;
-                        if (dx > 0) { px = (u > 0 ? 1 : -1) * (innerU + dx); nx = (u > 0 ? 1 : -1) * dx / r; }
-                        else { py = (vv > 0 ? 1 : -1) * (innerV + dy); ny = (vv > 0 ? 1 : -1) * dy / r; }
-                        nz = curveZ / r;
-                    }
-                }
-            }
-
-            Vert vert;
-            vert.p.x = offset.x + px*fu.x + py*fv.x + pz*fn.x;
-            vert.p.y = offset.y + px*fu.y + py*fv.y + pz*fn.y;
-            vert.p.z = offset.z + px*fu.z + py*fv.z + pz*fn.z;
-
-            float nnx = nx*fu.x + ny*fv.x + nz*fn.x;
-            float nny = nx*fu.y + ny*fv.y + nz*fn.y;
-            float nnz = nx*fu.z + ny*fv.z + nz*fn.z;
-            float len = sqrtf(nnx*nnx + nny*nny + nnz*nnz);
-            if (len < 0.001f) len = 1;
-            vert.n = {nnx/len, nny/len, nnz/len};
-            vert.cubeID = cubeID;
-            verts.push_back(vert);
-        }
-    }
-
-    for (int j = 0; j < seg; j++) {
-        for (int i = 0; i < seg; i++) {
-            UINT idx = base + j * (seg + 1) + i;
-            inds.push_back(idx); inds.push_back(idx + seg + 1); inds.push_back(idx + 1);
-            inds.push_back(idx + 1); inds.push_back(idx + seg + 1); inds.push_back(idx + seg + 2);
-        }
-    }
-}
-
-static void BuildAllGeometry(std::vector<Vert>& verts, std::vector<UINT>& inds)
+// ============== TEXT RENDERING ==============
+// The instance buffer and constants are only touched when the string or the
+// back buffer size changes; every other frame is one DrawInstanced.
+static void DrawOverlay(const char* text)
 {
-    float cubeSize = 0.95f;
-    float outerR = 0.12f, innerR = -0.12f;
-    float half = cubeSize / 2;
-    int seg = 20;
-
-    int coords[8][3] = {
-        {-1, +1, +1}, {+1, +1, +1}, {-1, -1, +1}, {+1, -1, +1},
-        {-1, +1, -1}, {+1, +1, -1}, {-1, -1, -1}, {+1, -1, -1},
-    };
-
-    for (int c = 0; c < 8; c++) {
-        int cx = coords[c][0], cy = coords[c][1], cz = coords[c][2];
-        XMFLOAT3 pos = {cx * half, cy * half, cz * half};
-
-        bool renderFace[6] = {(cz > 0), (cz < 0), (cx > 0), (cx < 0), (cy > 0), (cy < 0)};
-
-        for (int f = 0; f < 6; f++) {
-            if (!renderFace[f]) continue;
-
-            float er[4];
-            switch (f) {
-                case 0: er[0] = (cx < 0) ? outerR : innerR; er[1] = (cx > 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 1: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 2: er[0] = (cz > 0) ? outerR : innerR; er[1] = (cz < 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 3: er[0] = (cz < 0) ? outerR : innerR; er[1] = (cz > 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 4: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                        er[2] = (cz > 0) ? outerR : innerR; er[3] = (cz < 0) ? outerR : innerR; break;
-                case 5: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                        er[2] = (cz < 0) ? outerR : innerR; er[3] = (cz > 0) ? outerR : innerR; break;
-            }
-            GenRoundedFace(cubeSize, seg, pos, f, er, c, verts, inds);
+    OverlaySetText(overlay, text);
+    UINT count = OverlayInstanceCount(overlay);
+    if (!textVS || !textVB || !textCB || count == 0) return;
+
+    if (textVBVersion != overlay.version) {
+        D3D11_MAPPED_SUBRESOURCE m;
+        if (SUCCEEDED(ctx->Map(textVB, 0, D3D11_MAP_WRITE_DISCARD, 0, &m))) {
+            memcpy(m.pData, overlay.instances, OverlayInstanceBytes(overlay));
+            ctx->Unmap(textVB, 0);
+            textVBVersion = overlay.version;
         }
     }
-}
-
-// ============== TEXT RENDERING ==============
-
-static void DrawTextRaw(const char* text, float x, float y, float r, float g, float b, float a, float scale, std::vector<TextVert>& verts)
-{
-    const int FONT_COLS = 16;
-    const float CHAR_W = 8.0f * scale, CHAR_H = 8.0f * scale;
-    const float LINE_H = CHAR_H * 1.4f;  // 40% extra line spacing
-    const float TEX_W = 128.0f, TEX_H = 48.0f;
-
-    float cx = x, cy = y;
-
-    for (const char* p = text; *p; p++) {
-        if (*p == '\n') { cx = x; cy += LINE_H; continue; }
-        if (*p < 32 || *p > 127) continue;
-
-        int idx = *p - 32;
-        int col = idx % FONT_COLS, row = idx / FONT_COLS;
-        float u0 = col * 8.0f / TEX_W, v0 = row * 8.0f / TEX_H;
-        float u1 = u0 + 8.0f / TEX_W, v1 = v0 + 8.0f / TEX_H;
-
-        // Two triangles per character
-        verts.push_back({cx, cy, u0, v0, r, g, b, a});
-        verts.push_back({cx + CHAR_W, cy, u1, v0, r, g, b, a});
-        verts.push_back({cx, cy + CHAR_H, u0, v1, r, g, b, a});
-        verts.push_back({cx + CHAR_W, cy, u1, v0, r, g, b, a});
-        verts.push_back({cx + CHAR_W, cy + CHAR_H, u1, v1, r, g, b, a});
-        verts.push_back({cx, cy + CHAR_H, u0, v1, r, g, b, a});
-
-        cx += CHAR_W;
+    if (textCBWidth != W || textCBHeight != H) {
+        float invScreen[4] = { 1.0f / W, 1.0f / H, 0.0f, 0.0f };
+        ctx->UpdateSubresource(textCB, 0, nullptr, invScreen, 0, 0);
+        textCBWidth = W;
+        textCBHeight = H;
     }
-}
-
-static void DrawTextWithShadow(const char* text, float x, float y, float r, float g, float b, float scale = 2.0f)
-{
-    std::vector<TextVert> verts;
-
-    // Shadow (dark, offset)
-    float shadowOff = scale * 1.5f;
-    DrawTextRaw(text, x + shadowOff, y + shadowOff, 0.0f, 0.0f, 0.0f, 0.8f, scale, verts);
-
-    // Main text
-    DrawTextRaw(text, x, y, r, g, b, 1.0f, scale, verts);
-
-    if (verts.empty()) return;
-
-    // Update vertex buffer
-    D3D11_MAPPED_SUBRESOURCE m;
-    ctx->Map(textVB, 0, D3D11_MAP_WRITE_DISCARD, 0, &m);
-    memcpy(m.pData, verts.data(), verts.size() * sizeof(TextVert));
-    ctx->Unmap(textVB, 0);
 
     // Save state
     ID3D11BlendState* oldBlend = nullptr;
@@ -256,26 +129,120 @@ static void DrawTextWithShadow(const char* text, float x, float y, float r, floa
     // Set text rendering state
     ctx->OMSetBlendState(textBlend, nullptr, 0xFFFFFFFF);
     ctx->IASetInputLayout(textIL);
-    UINT stride = sizeof(TextVert), offset = 0;
+    UINT stride = sizeof(GlyphInstance), offset = 0;
     ctx->IASetVertexBuffers(0, 1, &textVB, &stride, &offset);
-    ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
     ctx->VSSetShader(textVS, nullptr, 0);
+    ctx->VSSetConstantBuffers(0, 1, &textCB);
     ctx->PSSetShader(textPS, nullptr, 0);
-    ctx->PSSetShaderResources(0, 1, &fontSRV);
-    ctx->PSSetSamplers(0, 1, &fontSampler);
 
-    ctx->Draw((UINT)verts.size(), 0);
+    // 4-vertex strip per glyph, shadow range first
+    ctx->DrawInstanced(4, count, 0, 0);
 
     // Restore state
     ctx->OMSetBlendState(oldBlend, oldFactor, oldMask);
     if (oldBlend) oldBlend->Release();
 }
 
+// ============== DEFERRED CONTEXT RECORDING ==============
+// A deferred context starts from default state every time, so each worker
+// binds the full pipeline before its slice of DrawIndexedInstanced calls.
+static void RecordDeferredDraws(DeferredWorker& w)
+{
+    ID3D11DeviceContext* dc = w.deferred;
+    dc->OMSetRenderTargets(1, &rtv, dsv);
+    D3D11_VIEWPORT vp = {0, 0, (float)W, (float)H, 0, 1};
+    dc->RSSetViewports(1, &vp);
+    dc->IASetInputLayout(il);
+    ID3D11Buffer* vbs[2] = { vb, instVB };
+    UINT strides[2] = { vbStride, sizeof(CubeInstance) }, offs[2] = { 0, 0 };
+    dc->IASetVertexBuffers(0, 2, vbs, strides, offs);
+    dc->IASetIndexBuffer(ib, DXGI_FORMAT_R32_UINT, 0);
+    dc->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    dc->VSSetShader(vs, 0, 0); dc->PSSetShader(ps, 0, 0);
+    dc->VSSetConstantBuffers(0, 1, &cbuf);
+    for (UINT i = 0; i < w.instanceCount; i++) {
+        dc->DrawIndexedInstanced(totalIndices, 1, 0, 0, w.firstInstance + i);
+    }
+    HRESULT hr = dc->FinishCommandList(FALSE, &w.list);
+    if (FAILED(hr)) w.list = nullptr;
+}
+
+static DWORD WINAPI DeferredWorkerThread(LPVOID param)
+{
+    DeferredWorker& w = *(DeferredWorker*)param;
+    for (;;) {
+        WaitForSingleObject(w.startEvent, INFINITE);
+        if (workersQuit) break;
+        RecordDeferredDraws(w);
+        SetEvent(w.doneEvent);
+    }
+    return 0;
+}
+
+static void StopDeferredWorkers()
+{
+    InterlockedExchange(&workersQuit, 1);
+    for (UINT i = 0; i < workerCount; i++) {
+        DeferredWorker& w = workers[i];
+        if (w.thread) {
+            SetEvent(w.startEvent);
+            WaitForSingleObject(w.thread, INFINITE);
+            CloseHandle(w.thread);
+        }
+        if (w.startEvent) CloseHandle(w.startEvent);
+        if (w.doneEvent) CloseHandle(w.doneEvent);
+        if (w.list) w.list->Release();
+        if (w.deferred) w.deferred->Release();
+        w = {};
+        workerDone[i] = nullptr;
+    }
+    workerCount = 0;
+    InterlockedExchange(&workersQuit, 0);
+}
+
+static bool StartDeferredWorkers(UINT threads, UINT instances)
+{
+    // Without driver command lists the runtime emulates them (records + replays on the immediate context)
+    dev->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threadingCaps, sizeof(threadingCaps));
+    Log("[INFO] D3D11 threading: DriverCommandLists=%d DriverConcurrentCreates=%d\n",
+        threadingCaps.DriverCommandLists, threadingCaps.DriverConcurrentCreates);
+
+    if (threads > instances) threads = instances;
+    UINT first = 0;
+    for (UINT i = 0; i < threads; i++) {
+        DeferredWorker& w = workers[i];
+        w.firstInstance = first;
+        w.instanceCount = instances / threads + (i < instances % threads ? 1 : 0);
+        first += w.instanceCount;
+
+        HRESULT hr = dev->CreateDeferredContext(0, &w.deferred);
+        if (FAILED(hr)) { LogHR("CreateDeferredContext", hr); return false; }
+
+        w.startEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        w.doneEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        workerDone[i] = w.doneEvent;
+        workerCount = i + 1;
+        w.thread = CreateThread(nullptr, 0, DeferredWorkerThread, &w, 0, nullptr);
+        if (!w.thread) { Log("[ERROR] CreateThread failed for deferred context worker %u\n", i); return false; }
+    }
+    Log("[INFO] D3D11 deferred contexts: %u threads, %u draws (%s command lists)\n", workerCount, instances,
+        threadingCaps.DriverCommandLists ? "driver" : "runtime-emulated");
+    return true;
+}
+
+const char* D3D11CommandListSupport()
+{
+    if (workerCount == 0) return "off";
+    return threadingCaps.DriverCommandLists ? "driver" : "emulated";
+}
+
 // ============== INITIALIZATION ==============
 
 bool InitD3D11(HWND hwnd)
 {
     Log("[INFO] Initializing Direct3D 11...\n");
+    StartupStep("Device");
 
     // Use GPU selected from settings dialog
     IDXGIAdapter1* selectedAdapter = nullptr;
@@ -345,6 +312,7 @@ bool InitD3D11(HWND hwnd)
     }
 
     // Create swap chain using FLIP model (better for hybrid GPU)
+    StartupStep("Swap chain + targets");
     DXGI_SWAP_CHAIN_DESC1 sd = {};
     sd.Width = W;
     sd.Height = H;
@@ -353,15 +321,15 @@ bool InitD3D11(HWND hwnd)
     sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
     sd.BufferCount = 2;  // Flip model requires at least 2
     sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;  // Modern flip model
-    sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    sd.Flags = DxgiSwapChainFlags(true);
 
     IDXGISwapChain1* swap1 = nullptr;
-    hr = factory2->CreateSwapChainForHwnd(dev, hwnd, &sd, nullptr, nullptr, &swap1);
+    hr = DxgiCreateSwapChain(factory2, dev, hwnd, sd, &swap1);
     factory2->Release();
 
     if (FAILED(hr)) {
         // Fallback: try without tearing flag
-        sd.Flags = 0;
+        sd.Flags = DxgiSwapChainFlags(false);
         IDXGIFactory2* factory2b = nullptr;
         IDXGIDevice* dxgiDev2 = nullptr;
         dev->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgiDev2);
@@ -375,7 +343,7 @@ bool InitD3D11(HWND hwnd)
             dxgiDev2->Release();
         }
         if (factory2b) {
-            hr = factory2b->CreateSwapChainForHwnd(dev, hwnd, &sd, nullptr, nullptr, &swap1);
+            hr = DxgiCreateSwapChain(factory2b, dev, hwnd, sd, &swap1);
             factory2b->Release();
         }
 
@@ -390,6 +358,8 @@ bool InitD3D11(HWND hwnd)
 
     swap1->QueryInterface(__uuidof(IDXGISwapChain), (void**)&swap);
     swap1->Release();
+    swapFlags = sd.Flags;
+    swapWaitable = DxgiInitFrameLatency(swap, "D3D11");
 
     // Check if tearing (no VSync) is supported
     IDXGIFactory5* factory5 = nullptr;
@@ -412,26 +382,64 @@ bool InitD3D11(HWND hwnd)
         factory5->Release();
     }
 
-    ID3D11Texture2D* bb; swap->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&bb);
-    dev->CreateRenderTargetView(bb, 0, &rtv); bb->Release();
-
-    D3D11_TEXTURE2D_DESC td = {}; td.Width = W; td.Height = H; td.MipLevels = 1; td.ArraySize = 1;
-    td.Format = DXGI_FORMAT_D24_UNORM_S8_UINT; td.SampleDesc.Count = 1;
-    td.Usage = D3D11_USAGE_DEFAULT; td.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-    ID3D11Texture2D* ds; dev->CreateTexture2D(&td, 0, &ds);
-    dev->CreateDepthStencilView(ds, 0, &dsv); ds->Release();
-
-    ctx->OMSetRenderTargets(1, &rtv, dsv);
-    D3D11_VIEWPORT vp = {0, 0, (float)W, (float)H, 0, 1};
-    ctx->RSSetViewports(1, &vp);
+    if (!CreateSizeDependentResources()) return false;
 
     // Initialize shaders
+    StartupStep("Shaders + scene");
     if (!InitShaders()) return false;
+    StartupStep("Overlay");
     if (!InitGPUText()) return false;
 
+    if (g_recordThreads) {
+        StartupStep("Record threads");
+        if (instVB) {
+            if (!StartDeferredWorkers(g_recordThreads, instanceCount)) return false;
+        } else {
+            Log("[WARN] --record-threads needs --cubes (or --mesh), recording on the immediate context\n");
+        }
+    }
+
+    // GPU pass timings (optional)
+    GpuProfilerReset();
+    D3D11_QUERY_DESC qd = {};
+    for (UINT i = 0; i < TIMER_FRAMES; i++) {
+        qd.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        dev->CreateQuery(&qd, &timerDisjoint[i]);
+        qd.Query = D3D11_QUERY_TIMESTAMP;
+        for (UINT j = 0; j < TIMER_STAMPS; j++) dev->CreateQuery(&qd, &timerStamps[i][j]);
+    }
+
     return true;
 }
 
+// ============== GPU TIMESTAMPS ==============
+// Read the oldest slot without flushing; skip it if the GPU isn't done yet
+static void CollectGpuTimers()
+{
+    UINT slot = timerFrame % TIMER_FRAMES;
+    if (!timerIssued[slot]) return;
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT dj;
+    if (ctx->GetData(timerDisjoint[slot], &dj, sizeof(dj), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) return;
+    UINT64 stamps[TIMER_STAMPS];
+    for (UINT j = 0; j < TIMER_STAMPS; j++) {
+        if (ctx->GetData(timerStamps[slot][j], &stamps[j], sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) return;
+    }
+    timerIssued[slot] = false;
+    if (dj.Disjoint || dj.Frequency == 0) return;
+
+    for (UINT j = 1; j < TIMER_STAMPS; j++) {
+        if (stamps[j] < stamps[j - 1]) continue;
+        GpuProfilerAddSample(j - 1, timerPassNames[j], (double)(stamps[j] - stamps[j - 1]) * 1000.0 / dj.Frequency);
+    }
+}
+
+static void GpuStamp(UINT index)
+{
+    ID3D11Query* q = timerStamps[timerFrame % TIMER_FRAMES][index];
+    if (q) ctx->End(q);
+}
+
 static bool InitShaders()
 {
     ID3DBlob* vsB = nullptr, *psB = nullptr, *err = nullptr;
@@ -439,8 +447,11 @@ static bool InitShaders()
     size_t shaderLen = strlen(g_d3d11ShaderCode);
     HRESULT hr;
 
-    Log("[INFO] Compiling vertex shader VS...\n");
-    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, "VS", "vs_5_0", flags, 0, &vsB, &err);
+    bool instanced = g_cubeCount > 0 || MeshLoaded();   // --mesh is drawn as the instanced mesh
+    const char* vsEntry = instanced ? "VSInstanced" : "VS";
+
+    Log("[INFO] Compiling vertex shader %s...\n", vsEntry);
+    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, vsEntry, "vs_5_0", flags, 0, &vsB, &err);
     if (FAILED(hr)) {
         LogHR("D3DCompile VS", hr);
         if (err) { Log("[SHADER ERROR] %s\n", (char*)err->GetBufferPointer()); err->Release(); }
@@ -464,21 +475,50 @@ static bool InitShaders()
         {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
         {"CUBEID", 0, DXGI_FORMAT_R32_UINT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0},
     };
-    dev->CreateInputLayout(layout, 3, vsB->GetBufferPointer(), vsB->GetBufferSize(), &il);
+    D3D11_INPUT_ELEMENT_DESC instLayout[] = {
+        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"INSTANCE", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+        {"INSTCOLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    };
+    if (instanced) dev->CreateInputLayout(instLayout, 4, vsB->GetBufferPointer(), vsB->GetBufferSize(), &il);
+    else dev->CreateInputLayout(layout, 3, vsB->GetBufferPointer(), vsB->GetBufferSize(), &il);
     vsB->Release(); psB->Release();
 
-    std::vector<Vert> verts;
+    // --mesh: the immutable buffers are initialized straight from the file mapping (mesh_file.h)
+    std::vector<CubeVertex> verts;
     std::vector<UINT> inds;
-    BuildAllGeometry(verts, inds);
-    totalIndices = (UINT)inds.size();
+    if (!MeshLoaded()) {
+        if (instanced) BuildInstanceCube(verts, inds);
+        else BuildSceneCubes(verts, inds);
+    }
+    totalIndices = MeshLoaded() ? g_mesh.indexCount : (UINT)inds.size();
+    totalVertices = MeshLoaded() ? g_mesh.vertexCount : (UINT)verts.size();
+    vbStride = MeshLoaded() ? (UINT)sizeof(MeshVertex) : (UINT)sizeof(CubeVertex);
 
     D3D11_BUFFER_DESC bd = {}; bd.Usage = D3D11_USAGE_IMMUTABLE;
-    bd.ByteWidth = (UINT)(verts.size() * sizeof(Vert)); bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-    D3D11_SUBRESOURCE_DATA init = {verts.data()};
-    dev->CreateBuffer(&bd, &init, &vb);
-
-    bd.ByteWidth = (UINT)(inds.size() * sizeof(UINT)); bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-    init.pSysMem = inds.data(); dev->CreateBuffer(&bd, &init, &ib);
+    bd.ByteWidth = totalVertices * vbStride; bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    D3D11_SUBRESOURCE_DATA init = {MeshLoaded() ? (const void*)g_mesh.vertices : verts.data()};
+    hr = dev->CreateBuffer(&bd, &init, &vb);
+    if (FAILED(hr)) { LogHR("CreateBuffer (vertices)", hr); return false; }
+
+    bd.ByteWidth = totalIndices * (UINT)sizeof(UINT); bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+    init.pSysMem = MeshLoaded() ? (const void*)g_mesh.indices : inds.data();
+    hr = dev->CreateBuffer(&bd, &init, &ib);
+    if (FAILED(hr)) { LogHR("CreateBuffer (indices)", hr); return false; }
+
+    instanceCount = 1;
+    if (instanced) {
+        std::vector<CubeInstance> instances;
+        BuildCubeInstances(max(g_cubeCount, 1u), instances);
+        bd.ByteWidth = (UINT)(instances.size() * sizeof(CubeInstance)); bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        init.pSysMem = instances.data();
+        hr = dev->CreateBuffer(&bd, &init, &instVB);
+        if (FAILED(hr)) { LogHR("CreateBuffer (instances)", hr); return false; }
+        instanceCount = (UINT)instances.size();
+        Log("[INFO] Instanced scene: %u %s, %u triangles each\n", instanceCount,
+            MeshLoaded() ? "meshes" : "cubes", totalIndices / 3);
+    }
 
     bd.ByteWidth = sizeof(CB); bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
     bd.Usage = D3D11_USAGE_DYNAMIC; bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
@@ -491,21 +531,21 @@ static bool InitGPUText()
 {
     ID3DBlob* vsB = nullptr, *psB = nullptr, *err = nullptr;
     UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
-    size_t shaderLen = strlen(g_d3d11ShaderCode);
+    std::string source = OverlayShaderHLSL();
     HRESULT hr;
 
-    Log("[INFO] Compiling text vertex shader TextVS...\n");
-    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, "TextVS", "vs_5_0", flags, 0, &vsB, &err);
+    Log("[INFO] Compiling overlay vertex shader GlyphVS...\n");
+    hr = D3DCompile(source.c_str(), source.size(), "overlay", nullptr, nullptr, "GlyphVS", "vs_5_0", flags, 0, &vsB, &err);
     if (FAILED(hr)) {
-        LogHR("D3DCompile TextVS", hr);
+        LogHR("D3DCompile GlyphVS", hr);
         if (err) { Log("[SHADER ERROR] %s\n", (char*)err->GetBufferPointer()); err->Release(); }
         return false;
     }
 
-    Log("[INFO] Compiling text pixel shader TextPS...\n");
-    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, "TextPS", "ps_5_0", flags, 0, &psB, &err);
+    Log("[INFO] Compiling overlay pixel shader GlyphPS...\n");
+    hr = D3DCompile(source.c_str(), source.size(), "overlay", nullptr, nullptr, "GlyphPS", "ps_5_0", flags, 0, &psB, &err);
     if (FAILED(hr)) {
-        LogHR("D3DCompile TextPS", hr);
+        LogHR("D3DCompile GlyphPS", hr);
         if (err) { Log("[SHADER ERROR] %s\n", (char*)err->GetBufferPointer()); err->Release(); }
         vsB->Release();
         return false;
@@ -514,46 +554,15 @@ static bool InitGPUText()
     dev->CreateVertexShader(vsB->GetBufferPointer(), vsB->GetBufferSize(), 0, &textVS);
     dev->CreatePixelShader(psB->GetBufferPointer(), psB->GetBufferSize(), 0, &textPS);
 
+    // One GlyphInstance per glyph, the quad corners come from SV_VertexID
     D3D11_INPUT_ELEMENT_DESC textLayout[] = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"GLYPHPOS", 0, DXGI_FORMAT_R16G16_UINT, 0, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+        {"GLYPHCODE", 0, DXGI_FORMAT_R8G8_UINT, 0, 4, D3D11_INPUT_PER_INSTANCE_DATA, 1},
     };
-    dev->CreateInputLayout(textLayout, 3, vsB->GetBufferPointer(), vsB->GetBufferSize(), &textIL);
+    dev->CreateInputLayout(textLayout, 2, vsB->GetBufferPointer(), vsB->GetBufferSize(), &textIL);
     vsB->Release(); psB->Release();
 
-    // Create font texture (16x6 characters = 128x48 pixels for ASCII 32-127)
-    const int FONT_COLS = 16, FONT_ROWS = 6;
-    const int TEX_W = FONT_COLS * 8, TEX_H = FONT_ROWS * 8;
-    unsigned char texData[TEX_W * TEX_H];
-    memset(texData, 0, sizeof(texData));
-
-    for (int c = 0; c < 96; c++) {
-        int col = c % FONT_COLS, row = c / FONT_COLS;
-        for (int y = 0; y < 8; y++) {
-            unsigned char bits = g_font8x8[c][y];
-            for (int x = 0; x < 8; x++) {
-                int px = col * 8 + x, py = row * 8 + y;
-                texData[py * TEX_W + px] = (bits & (0x80 >> x)) ? 255 : 0;
-            }
-        }
-    }
-
-    D3D11_TEXTURE2D_DESC td = {};
-    td.Width = TEX_W; td.Height = TEX_H; td.MipLevels = 1; td.ArraySize = 1;
-    td.Format = DXGI_FORMAT_R8_UNORM; td.SampleDesc.Count = 1;
-    td.Usage = D3D11_USAGE_IMMUTABLE; td.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-    D3D11_SUBRESOURCE_DATA initData = {texData, TEX_W, 0};
-    dev->CreateTexture2D(&td, &initData, &fontTex);
-    dev->CreateShaderResourceView(fontTex, nullptr, &fontSRV);
-
-    // Sampler
-    D3D11_SAMPLER_DESC sampDesc = {};
-    sampDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
-    sampDesc.AddressU = sampDesc.AddressV = sampDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
-    dev->CreateSamplerState(&sampDesc, &fontSampler);
-
-    // Blend state for text
+    // Blend state for text (translucent shadow)
     D3D11_BLEND_DESC blendDesc = {};
     blendDesc.RenderTarget[0].BlendEnable = TRUE;
     blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
@@ -565,14 +574,25 @@ static bool InitGPUText()
     blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
     dev->CreateBlendState(&blendDesc, &textBlend);
 
-    // Dynamic vertex buffer for text (max 1000 characters = 6000 vertices)
+    // Dynamic instance buffer (shadow + text, 8 bytes per glyph)
     D3D11_BUFFER_DESC vbd = {};
-    vbd.ByteWidth = 6000 * sizeof(TextVert);
+    vbd.ByteWidth = OVERLAY_MAX_INSTANCES * sizeof(GlyphInstance);
     vbd.Usage = D3D11_USAGE_DYNAMIC;
     vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
     vbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
     dev->CreateBuffer(&vbd, nullptr, &textVB);
 
+    D3D11_BUFFER_DESC cbd = {};
+    cbd.ByteWidth = 16;
+    cbd.Usage = D3D11_USAGE_DEFAULT;
+    cbd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    dev->CreateBuffer(&cbd, nullptr, &textCB);
+
+    size_t converted;
+    wcstombs_s(&converted, overlayGpuName, sizeof(overlayGpuName), gpuName.c_str(), _TRUNCATE);
+    OverlayInvalidate(overlay);
+    textVBVersion = 0;
+    textCBWidth = textCBHeight = 0;
     return true;
 }
 
@@ -580,6 +600,13 @@ static bool InitGPUText()
 
 void RenderD3D11()
 {
+    DxgiWaitFrameLatency(swapWaitable);
+    CollectGpuTimers();
+    // Slot still pending (GPU more than TIMER_FRAMES behind) - skip timing this frame
+    UINT timerSlot = timerFrame % TIMER_FRAMES;
+    bool timing = timerDisjoint[timerSlot] && !timerIssued[timerSlot];
+    if (timing) { ctx->Begin(timerDisjoint[timerSlot]); GpuStamp(0); }
+
     ctx->OMSetRenderTargets(1, &rtv, dsv);
 
     float gray[] = {0.5f, 0.5f, 0.5f, 1};
@@ -587,8 +614,9 @@ void RenderD3D11()
     ctx->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH, 1, 0);
 
     ctx->IASetInputLayout(il);
-    UINT stride = sizeof(Vert), off = 0;
-    ctx->IASetVertexBuffers(0, 1, &vb, &stride, &off);
+    ID3D11Buffer* vbs[2] = { vb, instVB };
+    UINT strides[2] = { vbStride, sizeof(CubeInstance) }, offs[2] = { 0, 0 };
+    ctx->IASetVertexBuffers(0, instVB ? 2 : 1, vbs, strides, offs);
     ctx->IASetIndexBuffer(ib, DXGI_FORMAT_R32_UINT, 0);
     ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     ctx->VSSetShader(vs, 0, 0); ctx->PSSetShader(ps, 0, 0);
@@ -601,53 +629,146 @@ void RenderD3D11()
     D3D11_MAPPED_SUBRESOURCE m;
     ctx->Map(cbuf, 0, D3D11_MAP_WRITE_DISCARD, 0, &m);
     ((CB*)m.pData)->time = t;
+    ((CB*)m.pData)->aspect = (float)W / (float)H;
     ctx->Unmap(cbuf, 0);
 
-    ctx->DrawIndexed(totalIndices, 0, 0);
+    if (workerCount > 0) {
+        // Workers record while the immediate context waits; lists execute in slice order
+        LARGE_INTEGER recordStart, recordEnd;
+        QueryPerformanceCounter(&recordStart);
+        for (UINT i = 0; i < workerCount; i++) SetEvent(workers[i].startEvent);
+        WaitForMultipleObjects(workerCount, workerDone, TRUE, INFINITE);
+        for (UINT i = 0; i < workerCount; i++) {
+            if (!workers[i].list) continue;
+            ctx->ExecuteCommandList(workers[i].list, FALSE);
+            workers[i].list->Release();
+            workers[i].list = nullptr;
+        }
+        QueryPerformanceCounter(&recordEnd);
+        cpuRecordMs = (double)(recordEnd.QuadPart - recordStart.QuadPart) * 1000.0 / g_perfFreq.QuadPart;
+        BenchmarkCpuRecordSample(cpuRecordMs);
+
+        // ExecuteCommandList(FALSE) leaves the immediate context in default state
+        D3D11_VIEWPORT vp = {0, 0, (float)W, (float)H, 0, 1};
+        ctx->RSSetViewports(1, &vp);
+    }
+    else if (instVB) ctx->DrawIndexedInstanced(totalIndices, instanceCount, 0, 0, 0);
+    else ctx->DrawIndexed(totalIndices, 0, 0);
+    if (timing) GpuStamp(1);
 
     // GPU-based text rendering (no CPU-GPU sync issues)
     ctx->OMSetRenderTargets(1, &rtv, nullptr); // Disable depth for text
 
-    // Convert GPU name to ASCII
-    char gpuNameA[128];
-    size_t converted;
-    wcstombs_s(&converted, gpuNameA, sizeof(gpuNameA), gpuName.c_str(), _TRUNCATE);
+
+    char gpuTimes[160];
+    GpuProfilerFormat(gpuTimes, sizeof(gpuTimes));
+    char latency[64];
+    LatencyFormat(latency, sizeof(latency));
+    char vram[192];
+    VramFormat(vram, sizeof(vram));
+    char record[96] = "";
+    if (workerCount > 0)
+        sprintf_s(record, "\nCPU record: %.2f ms (%u deferred contexts, %s command lists)", cpuRecordMs, workerCount,
+            threadingCaps.DriverCommandLists ? "driver" : "emulated");
 
     // Build info text
-    char infoText[512];
+    char infoText[768];
     sprintf_s(infoText,
         "API: Direct3D 11\n"
         "GPU: %s\n"
         "FPS: %d\n"
-        "Triangles: %u\n"
-        "Resolution: %ux%u",
-        gpuNameA, fps, totalIndices / 3, W, H);
+        "Triangles: %llu\n"
+        "Resolution: %ux%u\n"
+        "%s%s%s%s%s%s",
+        overlayGpuName, fps, (unsigned long long)totalIndices / 3 * instanceCount, W, H,
+        gpuTimes, record, latency[0] ? "\n" : "", latency, vram[0] ? "\n" : "", vram);
+
+    // White text with shadow; glyph instances are only rebuilt when the string changes
+    DrawOverlay(infoText);
+
+    if (timing) {
+        GpuStamp(2);
+        ctx->End(timerDisjoint[timerSlot]);
+        timerIssued[timerSlot] = true;
+        timerFrame++;
+    }
 
-    // White text with shadow for better readability
-    DrawTextWithShadow(infoText, 10, 10, 1.0f, 1.0f, 1.0f, 1.5f);
+    // Present with tearing (no VSync) if supported, or per --present-mode
+    DxgiPresent(swap, g_tearingSupported);
+}
+
+// ============== RESIZE ==============
+
+// Backbuffer RTV, depth buffer and viewport for the current W x H
+static bool CreateSizeDependentResources()
+{
+    ID3D11Texture2D* bb = nullptr;
+    HRESULT hr = swap->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&bb);
+    if (FAILED(hr)) { LogHR("GetBuffer", hr); return false; }
+    hr = dev->CreateRenderTargetView(bb, 0, &rtv); bb->Release();
+    if (FAILED(hr)) { LogHR("CreateRenderTargetView", hr); return false; }
 
-    // Present with tearing (no VSync) if supported
-    UINT presentFlags = g_tearingSupported ? DXGI_PRESENT_ALLOW_TEARING : 0;
-    swap->Present(0, presentFlags);
+    D3D11_TEXTURE2D_DESC td = {}; td.Width = W; td.Height = H; td.MipLevels = 1; td.ArraySize = 1;
+    td.Format = DXGI_FORMAT_D24_UNORM_S8_UINT; td.SampleDesc.Count = 1;
+    td.Usage = D3D11_USAGE_DEFAULT; td.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+    ID3D11Texture2D* ds = nullptr;
+    hr = dev->CreateTexture2D(&td, 0, &ds);
+    if (FAILED(hr)) { LogHR("CreateTexture2D (depth)", hr); return false; }
+    hr = dev->CreateDepthStencilView(ds, 0, &dsv); ds->Release();
+    if (FAILED(hr)) { LogHR("CreateDepthStencilView", hr); return false; }
+
+    ctx->OMSetRenderTargets(1, &rtv, dsv);
+    D3D11_VIEWPORT vp = {0, 0, (float)W, (float)H, 0, 1};
+    ctx->RSSetViewports(1, &vp);
+    return true;
+}
+
+bool ResizeD3D11()
+{
+    if (!swap) return false;
+
+    // All references to the backbuffer must be gone before ResizeBuffers
+    ctx->OMSetRenderTargets(0, nullptr, nullptr);
+    if (dsv) { dsv->Release(); dsv = nullptr; }
+    if (rtv) { rtv->Release(); rtv = nullptr; }
+    ctx->Flush();
+
+    HRESULT hr = swap->ResizeBuffers(0, W, H, DXGI_FORMAT_UNKNOWN, swapFlags);
+    if (FAILED(hr)) { LogHR("ResizeBuffers", hr); return false; }
+
+    if (!CreateSizeDependentResources()) return false;
+    Log("[INFO] D3D11 resized to %ux%u\n", W, H);
+    return true;
 }
 
 // ============== CLEANUP ==============
 
 void CleanupD3D11()
 {
+    StopDeferredWorkers();
+
+    // GPU timer queries
+    for (UINT i = 0; i < TIMER_FRAMES; i++) {
+        if (timerDisjoint[i]) { timerDisjoint[i]->Release(); timerDisjoint[i] = nullptr; }
+        for (UINT j = 0; j < TIMER_STAMPS; j++)
+            if (timerStamps[i][j]) { timerStamps[i][j]->Release(); timerStamps[i][j] = nullptr; }
+        timerIssued[i] = false;
+    }
+
     // GPU text resources
-    if (textBlend) textBlend->Release();
-    if (fontSampler) fontSampler->Release();
-    if (fontSRV) fontSRV->Release();
-    if (fontTex) fontTex->Release();
-    if (textVB) textVB->Release();
-    if (textIL) textIL->Release();
-    if (textPS) textPS->Release();
-    if (textVS) textVS->Release();
+    if (textBlend) { textBlend->Release(); textBlend = nullptr; }
+    if (textCB) { textCB->Release(); textCB = nullptr; }
+    if (textVB) { textVB->Release(); textVB = nullptr; }
+    if (textIL) { textIL->Release(); textIL = nullptr; }
+    if (textPS) { textPS->Release(); textPS = nullptr; }
+    if (textVS) { textVS->Release(); textVS = nullptr; }
 
     // Main resources
-    if (cbuf) cbuf->Release(); if (ib) ib->Release(); if (vb) vb->Release();
-    if (il) il->Release(); if (ps) ps->Release(); if (vs) vs->Release();
-    if (dsv) dsv->Release(); if (rtv) rtv->Release();
-    if (swap) swap->Release(); if (ctx) ctx->Release(); if (dev) dev->Release();
+    if (instVB) { instVB->Release(); instVB = nullptr; }
+    instanceCount = 1;
+    if (cbuf) { cbuf->Release(); cbuf = nullptr; } if (ib) { ib->Release(); ib = nullptr; } if (vb) { vb->Release(); vb = nullptr; }
+    if (il) { il->Release(); il = nullptr; } if (ps) { ps->Release(); ps = nullptr; } if (vs) { vs->Release(); vs = nullptr; }
+    if (dsv) { dsv->Release(); dsv = nullptr; } if (rtv) { rtv->Release(); rtv = nullptr; }
+    if (swapWaitable) { CloseHandle(swapWaitable); swapWaitable = nullptr; }
+    if (swap) { swap->Release(); swap = nullptr; } if (ctx) { ctx->Release(); ctx = nullptr; } if (dev) { dev->Release(); dev = nullptr; }
 }
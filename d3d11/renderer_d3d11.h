@@ -7,3 +7,7 @@
 bool InitD3D11(HWND hwnd);
 void RenderD3D11();
 void CleanupD3D11();
+bool ResizeD3D11();   // Recreate backbuffer-sized resources for the current W x H
+
+// --record-threads: "driver" / "emulated" (D3D11_FEATURE_THREADING.DriverCommandLists), "off" when not in use
+const char* D3D11CommandListSupport();
@@ -0,0 +1,146 @@
+// ============== D3D12 BLAS COMPACTION ==============
+// Init-time compaction of the static BLASes (PT, PT + DLSS, DXR 1.1, DXR 1.0).
+// The builds emit nothing themselves: once they are recorded the caller's list
+// is executed, EmitRaytracingAccelerationStructurePostbuildInfo reports each
+// BLAS's compacted size, and CopyRaytracingAccelerationStructure(COMPACT)
+// moves it into a right-sized buffer before the uncompacted one is released.
+// Instance descs must be written after this, with the new addresses.
+
+#include "../common.h"
+#include "../startup_profiler.h"
+#include "d3d12_shared.h"
+
+static bool ExecuteAndWait(ID3D12CommandQueue* queue, ID3D12GraphicsCommandList4* cl,
+                           ID3D12Fence* fence, HANDLE event, UINT64& fenceValue)
+{
+    HRESULT hr = cl->Close();
+    if (FAILED(hr)) { LogHR("BLAS compaction Close", hr); return false; }
+    ID3D12CommandList* lists[] = { cl };
+    queue->ExecuteCommandLists(1, lists);
+    queue->Signal(fence, ++fenceValue);
+    if (fence->GetCompletedValue() < fenceValue) {
+        fence->SetEventOnCompletion(fenceValue, event);
+        WaitForSingleObject(event, INFINITE);
+    }
+    return true;
+}
+
+bool CompactBLAS12(ID3D12Device5* device, ID3D12CommandQueue* queue, ID3D12CommandAllocator* alloc,
+                   ID3D12GraphicsCommandList4* cl, ID3D12Resource** blas[], UINT count, const char* tag)
+{
+    StartupScope scope("BLAS build wait + compaction");
+    ID3D12Fence* fence = nullptr;
+    HANDLE event = nullptr;
+    ID3D12Resource* postbuild = nullptr;
+    ID3D12Resource* readback = nullptr;
+    UINT64 fenceValue = 0;
+    UINT64 sizeBefore = 0, sizeAfter = 0;
+    std::vector<ID3D12Resource*> compacted(count, nullptr);
+    std::vector<D3D12_GPU_VIRTUAL_ADDRESS> sources(count);
+    bool ok = false;
+
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_HEAP_PROPERTIES readbackHeap = { D3D12_HEAP_TYPE_READBACK };
+    D3D12_RESOURCE_DESC bufDesc = {};
+    bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    bufDesc.Width = count * sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC);
+    bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
+    bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    HRESULT hr = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
+    if (FAILED(hr)) { LogHR("BLAS compaction CreateFence", hr); fence = nullptr; }
+    event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (fence) {
+        bufDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hr = device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&postbuild));
+        if (FAILED(hr)) { LogHR("BLAS compaction postbuild buffer", hr); postbuild = nullptr; }
+        bufDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hr = device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readback));
+        if (FAILED(hr)) { LogHR("BLAS compaction readback buffer", hr); readback = nullptr; }
+    }
+    if (!fence || !event) {
+        // Can't wait on our own fence - leave the list open for the caller
+        Log("[WARN] BLAS compaction (%s) skipped\n", tag);
+        if (fence) fence->Release();
+        if (event) CloseHandle(event);
+        return false;
+    }
+
+    // ===== COMPACTED SIZES =====
+    // The caller's UAV barriers after the builds order this after them
+    if (postbuild && readback) {
+        for (UINT i = 0; i < count; i++) {
+            sources[i] = (*blas[i])->GetGPUVirtualAddress();
+            sizeBefore += (*blas[i])->GetDesc().Width;
+        }
+        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC info = {};
+        info.DestBuffer = postbuild->GetGPUVirtualAddress();
+        info.InfoType = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE;
+        cl->EmitRaytracingAccelerationStructurePostbuildInfo(&info, count, sources.data());
+
+        D3D12_RESOURCE_BARRIER barrier = {};
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Transition.pResource = postbuild;
+        barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        cl->ResourceBarrier(1, &barrier);
+        cl->CopyBufferRegion(readback, 0, postbuild, 0, bufDesc.Width);
+    }
+    // Always executed: the builds (and their scratch) are finished on return
+    bool executed = ExecuteAndWait(queue, cl, fence, event, fenceValue);
+    ok = executed && postbuild && readback;
+    alloc->Reset();
+    cl->Reset(alloc, nullptr);
+
+    // ===== COMPACT COPIES =====
+    UINT copies = 0;
+    if (ok) {
+        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC* sizes = nullptr;
+        D3D12_RANGE readRange = { 0, (SIZE_T)bufDesc.Width };
+        readback->Map(0, &readRange, (void**)&sizes);
+        bufDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        for (UINT i = 0; i < count && sizes; i++) {
+            UINT64 size = sizes[i].CompactedSizeInBytes;
+            if (size == 0 || size >= (*blas[i])->GetDesc().Width) continue;
+            bufDesc.Width = size;
+            hr = device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
+                D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE, nullptr, IID_PPV_ARGS(&compacted[i]));
+            if (FAILED(hr)) { LogHR("BLAS compaction CreateCommittedResource", hr); compacted[i] = nullptr; continue; }
+            cl->CopyRaytracingAccelerationStructure(compacted[i]->GetGPUVirtualAddress(), sources[i],
+                D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_COMPACT);
+            copies++;
+        }
+        D3D12_RANGE noWrite = { 0, 0 };
+        if (sizes) readback->Unmap(0, &noWrite);
+    }
+    if (copies) {
+        ok = ExecuteAndWait(queue, cl, fence, event, fenceValue);
+        alloc->Reset();
+        cl->Reset(alloc, nullptr);
+    }
+
+    // ===== SWAP =====
+    for (UINT i = 0; i < count; i++) {
+        if (compacted[i] && ok) {
+            (*blas[i])->Release();
+            *blas[i] = compacted[i];
+        }
+        else if (compacted[i]) {
+            compacted[i]->Release();
+        }
+        sizeAfter += (*blas[i])->GetDesc().Width;
+    }
+    if (ok && copies)
+        Log("[INFO] BLAS compaction (%s): %u BLAS, %llu KB -> %llu KB\n", tag, count, sizeBefore / 1024, sizeAfter / 1024);
+    else
+        Log("[WARN] BLAS compaction (%s): not compacted, %llu KB\n", tag, sizeAfter / 1024);
+
+    if (postbuild) postbuild->Release();
+    if (readback) readback->Release();
+    fence->Release();
+    CloseHandle(event);
+    return executed;
+}
@@ -0,0 +1,105 @@
+// ============== D3D12 FRAME CAPTURE ==============
+// D3D12 half of --capture (frame_capture.h) for D3D12 PT. CAPTURE_SLOTS
+// readback-heap buffers laid out with the image's copyable footprint, created
+// with the first due frame and mapped once for their lifetime; the CPU reads a
+// buffer only after Capture12Collect has seen its frame's fence pass.
+
+#include "../common.h"
+#include "d3d12_shared.h"
+#include "../frame_capture.h"
+
+static CaptureRing s_ring = {};
+static ID3D12Resource* s_readback[CAPTURE_SLOTS] = {};
+static D3D12_PLACED_SUBRESOURCE_FOOTPRINT s_footprint = {};
+static bool s_failed = false;                   // Unsupported format or creation failed, until cleanup
+
+static bool CreateCaptureBuffers(ID3D12Resource* image)
+{
+    D3D12_RESOURCE_DESC imageDesc = image->GetDesc();
+    bool bgra = imageDesc.Format == DXGI_FORMAT_B8G8R8A8_UNORM || imageDesc.Format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+    bool rgba = imageDesc.Format == DXGI_FORMAT_R8G8B8A8_UNORM || imageDesc.Format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    if (!bgra && !rgba) {
+        Log("[WARN] Capture: image format %d is not 8-bit RGBA/BGRA, --capture disabled for this renderer\n", imageDesc.Format);
+        s_failed = true;
+        return false;
+    }
+
+    ID3D12Device* device = nullptr;
+    if (FAILED(image->GetDevice(IID_PPV_ARGS(&device)))) { s_failed = true; return false; }
+    UINT64 totalBytes = 0;
+    device->GetCopyableFootprints(&imageDesc, 0, 1, 0, &s_footprint, nullptr, nullptr, &totalBytes);
+
+    D3D12_HEAP_PROPERTIES readbackHeap = { D3D12_HEAP_TYPE_READBACK };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = totalBytes;
+    desc.Height = 1; desc.DepthOrArraySize = 1; desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    bool ok = true;
+    for (UINT i = 0; i < CAPTURE_SLOTS && ok; i++) {
+        HRESULT hr = device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &desc,
+            D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&s_readback[i]));
+        void* mapped = nullptr;
+        if (SUCCEEDED(hr)) hr = s_readback[i]->Map(0, nullptr, &mapped);
+        if (FAILED(hr)) { LogHR("Capture readback buffer", hr); ok = false; break; }
+        s_ring.slots[i].pixels = (const BYTE*)mapped + s_footprint.Offset;
+        s_ring.slots[i].rowPitch = s_footprint.Footprint.RowPitch;
+        s_ring.slots[i].state = CAPTURE_FREE;
+    }
+    device->Release();
+    if (!ok) { CleanupCapture12(); s_failed = true; return false; }
+
+    s_ring.width = (UINT)imageDesc.Width;
+    s_ring.height = imageDesc.Height;
+    s_ring.bgra = bgra;
+    return true;
+}
+
+void Capture12Record(ID3D12GraphicsCommandList* cl, ID3D12Resource* image, D3D12_RESOURCE_STATES state,
+                     UINT frame, UINT frameNumber, const char* tag)
+{
+    if (!CaptureDue(frameNumber) || s_failed) return;
+    if (!s_readback[0] && !CreateCaptureBuffers(image)) return;
+    int slot = CaptureAcquire(s_ring);
+    if (slot < 0) return;
+    s_ring.tag = tag;
+
+    D3D12_RESOURCE_BARRIER barrier = {};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barrier.Transition.pResource = image;
+    barrier.Transition.StateBefore = state;
+    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    if (state != D3D12_RESOURCE_STATE_COPY_SOURCE) cl->ResourceBarrier(1, &barrier);
+
+    D3D12_TEXTURE_COPY_LOCATION dst = {};
+    dst.pResource = s_readback[slot];
+    dst.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    dst.PlacedFootprint = s_footprint;
+    D3D12_TEXTURE_COPY_LOCATION src = {};
+    src.pResource = image;
+    src.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    src.SubresourceIndex = 0;
+    cl->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+
+    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    barrier.Transition.StateAfter = state;
+    if (state != D3D12_RESOURCE_STATE_COPY_SOURCE) cl->ResourceBarrier(1, &barrier);
+    CaptureSubmitted(s_ring, slot, frame, frameNumber);
+}
+
+void Capture12Collect(UINT frame)
+{
+    if (s_readback[0]) CaptureRetire(s_ring, frame);
+}
+
+void CleanupCapture12()
+{
+    if (s_readback[0]) CaptureDrain(s_ring);
+    for (UINT i = 0; i < CAPTURE_SLOTS; i++) {
+        if (s_readback[i]) { s_readback[i]->Release(); s_readback[i] = nullptr; }
+    }
+    s_ring = {};
+    s_failed = false;
+}
@@ -0,0 +1,108 @@
+// ============== D3D12 PER-FRAME UPLOAD RING ==============
+// Linear allocator over one persistently mapped upload-heap buffer for data
+// that changes every frame (constant buffers). Allocations are
+// tagged with the fence value of the frame that used them and the space is
+// only handed out again once that fence has completed, so the CPU never
+// overwrites memory a frame still in flight is reading.
+//
+// head/tail are monotonically increasing byte counters; the buffer offset is
+// counter % size. An allocation that would straddle the end of the buffer
+// skips to the start of the next lap.
+
+#include "../common.h"
+#include "d3d12_shared.h"
+
+static UINT64 AlignUp(UINT64 v, UINT64 align) { return (v + align - 1) & ~(align - 1); }  // align: power of two
+
+bool InitFrameRing12(FrameRing12& ring, ID3D12Device* device, ID3D12Fence* fence, UINT64 size, const char* tag)
+{
+    CleanupFrameRing12(ring);
+
+    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = size; desc.Height = 1; desc.DepthOrArraySize = 1; desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    HRESULT hr = device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&ring.buffer));
+    if (FAILED(hr)) { Log("[ERROR] Frame ring (%s): ", tag); LogHR("CreateCommittedResource", hr); return false; }
+
+    D3D12_RANGE noRead = { 0, 0 };
+    ring.buffer->Map(0, &noRead, (void**)&ring.cpu);  // Persistent map - never unmap
+    ring.gpu = ring.buffer->GetGPUVirtualAddress();
+    ring.size = size;
+    ring.fence = fence;
+    ring.event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    ring.tag = tag;
+    Log("[INFO] Frame ring (%s): %llu KB upload heap\n", tag, size / 1024);
+    return true;
+}
+
+void CleanupFrameRing12(FrameRing12& ring)
+{
+    if (ring.buffer) { ring.buffer->Release(); }
+    if (ring.event) { CloseHandle(ring.event); }
+    ring = FrameRing12();
+}
+
+void FrameRingRetire12(FrameRing12& ring, UINT64 fenceValue)
+{
+    if (!ring.buffer) return;
+    if (ring.pendingCount == FRAME_RING_MAX_PENDING) {
+        // More frames in flight than slots - fold into the newest entry (retires later, never early)
+        UINT last = (ring.pendingFirst + ring.pendingCount - 1) % FRAME_RING_MAX_PENDING;
+        ring.pending[last].fenceValue = fenceValue;
+        ring.pending[last].head = ring.head;
+        return;
+    }
+    UINT slot = (ring.pendingFirst + ring.pendingCount) % FRAME_RING_MAX_PENDING;
+    ring.pending[slot].fenceValue = fenceValue;
+    ring.pending[slot].head = ring.head;
+    ring.pendingCount++;
+}
+
+void FrameRingReclaim12(FrameRing12& ring, UINT64 completedValue)
+{
+    while (ring.pendingCount > 0 && ring.pending[ring.pendingFirst].fenceValue <= completedValue) {
+        ring.tail = ring.pending[ring.pendingFirst].head;
+        ring.pendingFirst = (ring.pendingFirst + 1) % FRAME_RING_MAX_PENDING;
+        ring.pendingCount--;
+    }
+}
+
+bool FrameRingAlloc12(FrameRing12& ring, UINT64 size, UINT64 align, FrameAlloc12& out)
+{
+    if (!ring.buffer || size > ring.size) return false;
+
+    for (;;) {
+        UINT64 offset = AlignUp(ring.head, align);
+        if ((offset % ring.size) + size > ring.size) offset = (offset / ring.size + 1) * ring.size;  // Next lap
+        if (offset + size - ring.tail <= ring.size) {
+            ring.head = offset + size;
+            out.cpu = ring.cpu + (offset % ring.size);
+            out.gpu = ring.gpu + (offset % ring.size);
+            return true;
+        }
+
+        // Full: block on the oldest frame still holding space
+        if (ring.pendingCount == 0) {
+            if (!ring.warnedFull) Log("[WARN] Frame ring (%s) overflow: %llu bytes in one frame\n", ring.tag, ring.head - ring.tail + size);
+            ring.warnedFull = true;
+            return false;
+        }
+        UINT64 waitValue = ring.pending[ring.pendingFirst].fenceValue;
+        if (ring.fence->GetCompletedValue() < waitValue) {
+            ring.fence->SetEventOnCompletion(waitValue, ring.event);
+            WaitForSingleObject(ring.event, INFINITE);
+        }
+        FrameRingReclaim12(ring, ring.fence->GetCompletedValue());
+    }
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS FrameRingPush12(FrameRing12& ring, const void* data, UINT64 size, UINT64 align)
+{
+    FrameAlloc12 a;
+    if (!FrameRingAlloc12(ring, size, align, a)) return 0;
+    memcpy(a.cpu, data, (size_t)size);
+    return a.gpu;
+}
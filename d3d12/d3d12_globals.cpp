@@ -16,7 +16,7 @@
 #include "nvsdk_ngx.h"
 #endif
 
-// FRAME_COUNT and MAX_TEXT_VERTS are #defined in d3d12_shared.h
+// FRAME_COUNT is #defined in d3d12_shared.h
 
 // ============== D3D12 BASE GLOBALS ==============
 bool g_tearingSupported12 = false;
@@ -26,20 +26,15 @@ ID3D12CommandQueue* cmdQueue = nullptr;
 ID3D12CommandAllocator* cmdAlloc[3] = {};
 ID3D12GraphicsCommandList* cmdList = nullptr;
 IDXGISwapChain3* swap12 = nullptr;
+HANDLE swapWaitable12 = nullptr;
 ID3D12DescriptorHeap* rtvHeap12 = nullptr;
 ID3D12DescriptorHeap* dsvHeap12 = nullptr;
-ID3D12DescriptorHeap* srvHeap12 = nullptr;
 ID3D12Resource* renderTargets12[3] = {};
 ID3D12Resource* depthStencil12 = nullptr;
 ID3D12RootSignature* rootSig = nullptr;
 ID3D12PipelineState* pso = nullptr;
-ID3D12PipelineState* textPso = nullptr;
 ID3D12Resource* vb12 = nullptr;
 ID3D12Resource* ib12 = nullptr;
-ID3D12Resource* cbUpload12 = nullptr;
-ID3D12Resource* fontTex12 = nullptr;
-ID3D12Resource* textVB12 = nullptr;
-ID3D12RootSignature* textRootSig12 = nullptr;
 
 // Synchronization
 ID3D12Fence* fence = nullptr;
@@ -51,15 +46,16 @@ UINT rtvDescSize = 0;
 // Buffer views
 D3D12_VERTEX_BUFFER_VIEW vbView12 = {};
 D3D12_INDEX_BUFFER_VIEW ibView12 = {};
-D3D12_VERTEX_BUFFER_VIEW textVbView12 = {};
-
-// Persistent mapped pointers
-void* cbMapped12 = nullptr;
-void* textVbMapped12 = nullptr;
 
 // Geometry counts
 UINT totalIndices12 = 0;
 UINT totalVertices12 = 0;
+UINT vbStride12 = 0;
+bool ib16Bit12 = false;
+ID3D12Resource* blueNoise12 = nullptr;
+
+// Per-frame upload ring (CBs, text vertices) - see d3d12_frame_ring.cpp
+FrameRing12 g_frameRing12;
 
 // ============== DXR FEATURE FLAGS ==============
 DXRFeatures g_dxrFeatures = {};
@@ -87,10 +83,6 @@ ID3D12PipelineState* pathTracePSO = nullptr;
 ID3D12RootSignature* denoiseRootSig = nullptr;
 ID3D12PipelineState* denoisePSO = nullptr;
 ID3D12DescriptorHeap* pathTraceSrvUavHeap = nullptr;
-ID3D12Resource* pathTraceCB = nullptr;
-ID3D12Resource* denoiseCB = nullptr;
-void* pathTraceCBMapped = nullptr;
-void* denoiseCBMapped = nullptr;
 UINT g_frameCount = 0;
 
 // Denoise modes (enum defined in d3d12_shared.h)
@@ -111,13 +103,15 @@ ID3D12Resource* g_gbufferDepth = nullptr;
 ID3D12Resource* g_dlssOutput = nullptr;
 ID3D12DescriptorHeap* g_gbufferHeap = nullptr;
 
-// ============== TEXT RENDERING ==============
-// MAX_TEXT_VERTS is #defined in d3d12_shared.h as 6000
-TextVert g_textVerts[MAX_TEXT_VERTS];
-UINT g_textVertCount = 0;
+// ============== TEXT OVERLAY ==============
+Overlay12 g_overlay12;
 int g_cachedFps = -1;
 bool g_textNeedsRebuild = true;
 
+// ============== GPU TIMESTAMP PROFILER ==============
+ID3D12QueryHeap* g_timerQueryHeap12 = nullptr;
+ID3D12Resource* g_timerReadback12 = nullptr;
+
 // ============== DXC SHADER COMPILER ==============
 typedef HRESULT(WINAPI* DxcCreateInstanceProc)(REFCLSID, REFIID, LPVOID*);
 HMODULE g_dxcModule = nullptr;
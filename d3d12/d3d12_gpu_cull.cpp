@@ -0,0 +1,404 @@
+// ============== D3D12 GPU-DRIVEN CULLING ==============
+// --gpu-culling path for the D3D12 base renderer's --cubes=N scene.
+// Two-phase occlusion culling, fully on the GPU:
+//   phase 0: instances visible last frame that pass the frustum test are
+//            compacted and drawn with ExecuteIndirect
+//   Hi-Z:    the resulting depth is max-reduced into a mip pyramid
+//   phase 1: every instance is tested against frustum + Hi-Z; newly visible
+//            ones are compacted and drawn, and the visibility bits are updated
+// The CPU records the same handful of commands whatever the instance count.
+
+#include "../common.h"
+#include "d3d12_shared.h"
+#include "../shaders/d3d12_cull_shaders.h"
+
+#include <d3d12.h>
+#include <d3dcompiler.h>
+
+// ============== CULL GLOBALS ==============
+#define HIZ_MAX_MIPS 16
+
+// Descriptor heap layout (shader visible)
+enum {
+    CULL_SRV_DEPTH = 0,
+    CULL_SRV_HIZ,
+    CULL_UAV_HIZ_MIP0,                                 // HIZ_MAX_MIPS + 1 slots, unused ones are null
+    CULL_HEAP_SIZE = CULL_UAV_HIZ_MIP0 + HIZ_MAX_MIPS + 1
+};
+
+// Root parameters
+enum {
+    CULL_RP_CONSTANTS = 0,  // b0, 8 dwords
+    CULL_RP_SRV_TABLE,      // t0
+    CULL_RP_UAV_TABLE,      // u0, u1
+    CULL_RP_INSTANCES,      // t1
+    CULL_RP_VISIBILITY,     // u2
+    CULL_RP_COMPACTED,      // u3
+    CULL_RP_ARGS,           // u4
+    CULL_RP_COUNT
+};
+
+struct CullConstants {
+    float time;
+    float aspect;
+    UINT instanceCount;
+    UINT phase;
+    UINT hizWidth, hizHeight;
+    UINT hizMips;
+    UINT pad;
+};
+
+static ID3D12RootSignature* s_cullRootSig = nullptr;
+static ID3D12PipelineState* s_cullPSO = nullptr;
+static ID3D12PipelineState* s_hizCopyPSO = nullptr;
+static ID3D12PipelineState* s_hizDownPSO = nullptr;
+static ID3D12CommandSignature* s_drawSig = nullptr;
+static ID3D12DescriptorHeap* s_cullHeap = nullptr;
+static UINT s_cullDescSize = 0;
+
+static ID3D12Resource* s_instances = nullptr;        // Source instances (DEFAULT heap, owned by renderer_d3d12.cpp)
+static ID3D12Resource* s_visibility = nullptr;       // uint per instance
+static ID3D12Resource* s_compacted[2] = {};          // Per-phase surviving instances, bound as VB slot 1
+static ID3D12Resource* s_args = nullptr;             // 2 x D3D12_DRAW_INDEXED_ARGUMENTS
+static ID3D12Resource* s_argsReset = nullptr;        // Upload copy of the zero-instance args
+static ID3D12Resource* s_argsReadback = nullptr;     // FRAME_COUNT copies of s_args for the overlay
+static D3D12_DRAW_INDEXED_ARGUMENTS* s_argsReadbackMapped = nullptr;
+static ID3D12Resource* s_hiz = nullptr;
+static UINT s_hizMips = 0;
+static UINT s_instanceCount = 0;
+static UINT s_visibleCount = 0;
+
+static const UINT ARGS_SIZE = 2 * sizeof(D3D12_DRAW_INDEXED_ARGUMENTS);
+
+// ============== HELPERS ==============
+static D3D12_CPU_DESCRIPTOR_HANDLE CullCpuHandle(UINT slot)
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE h = s_cullHeap->GetCPUDescriptorHandleForHeapStart();
+    h.ptr += (SIZE_T)slot * s_cullDescSize;
+    return h;
+}
+
+static D3D12_GPU_DESCRIPTOR_HANDLE CullGpuHandle(UINT slot)
+{
+    D3D12_GPU_DESCRIPTOR_HANDLE h = s_cullHeap->GetGPUDescriptorHandleForHeapStart();
+    h.ptr += (UINT64)slot * s_cullDescSize;
+    return h;
+}
+
+static ID3D12Resource* CreateCullBuffer(UINT64 size, D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_FLAGS flags, D3D12_RESOURCE_STATES state)
+{
+    D3D12_HEAP_PROPERTIES heap = { heapType };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = size; desc.Height = 1; desc.DepthOrArraySize = 1; desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags = flags;
+    ID3D12Resource* res = nullptr;
+    HRESULT hr = dev12->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, state, nullptr, IID_PPV_ARGS(&res));
+    if (FAILED(hr)) { LogHR("CreateCullBuffer", hr); return nullptr; }
+    return res;
+}
+
+static void Transition(ID3D12GraphicsCommandList* cl, ID3D12Resource* res, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, D3D12_RESOURCE_BARRIER* out, UINT& n)
+{
+    D3D12_RESOURCE_BARRIER& b = out[n++];
+    b = {};
+    b.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    b.Transition.pResource = res;
+    b.Transition.StateBefore = before;
+    b.Transition.StateAfter = after;
+    b.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+}
+
+static bool CompileCullCS(const char* entry, ID3DBlob** blob)
+{
+    ID3DBlob* errBlob = nullptr;
+    HRESULT hr = D3DCompile(g_d3d12CullShaderCode, strlen(g_d3d12CullShaderCode), "cull", nullptr, nullptr,
+                            entry, "cs_5_0", D3DCOMPILE_ENABLE_STRICTNESS, 0, blob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[SHADER ERROR] %s: %s\n", entry, (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        return false;
+    }
+    return true;
+}
+
+static bool CreateCullPSO(const char* entry, ID3D12PipelineState** pso)
+{
+    ID3DBlob* cs = nullptr;
+    if (!CompileCullCS(entry, &cs)) return false;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
+    desc.pRootSignature = s_cullRootSig;
+    desc.CS = { cs->GetBufferPointer(), cs->GetBufferSize() };
+    HRESULT hr = dev12->CreateComputePipelineState(&desc, IID_PPV_ARGS(pso));
+    cs->Release();
+    if (FAILED(hr)) { LogHR(entry, hr); return false; }
+    return true;
+}
+
+// Hi-Z pyramid + its views for the current W x H; depthStencil12 must exist
+static bool CreateHiZ()
+{
+    if (s_hiz) { s_hiz->Release(); s_hiz = nullptr; }
+
+    s_hizMips = 1;
+    while (s_hizMips < HIZ_MAX_MIPS && ((W | H) >> s_hizMips) != 0) s_hizMips++;
+
+    D3D12_HEAP_PROPERTIES heap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    desc.Width = W; desc.Height = H; desc.DepthOrArraySize = 1;
+    desc.MipLevels = (UINT16)s_hizMips; desc.Format = DXGI_FORMAT_R32_FLOAT;
+    desc.SampleDesc.Count = 1;
+    desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    HRESULT hr = dev12->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_hiz));
+    if (FAILED(hr)) { LogHR("CreateHiZ", hr); return false; }
+
+    // Depth is read through its typeless R24G8 resource
+    D3D12_SHADER_RESOURCE_VIEW_DESC srv = {};
+    srv.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+    srv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srv.Texture2D.MipLevels = 1;
+    dev12->CreateShaderResourceView(depthStencil12, &srv, CullCpuHandle(CULL_SRV_DEPTH));
+
+    srv.Format = DXGI_FORMAT_R32_FLOAT;
+    srv.Texture2D.MipLevels = s_hizMips;
+    dev12->CreateShaderResourceView(s_hiz, &srv, CullCpuHandle(CULL_SRV_HIZ));
+
+    for (UINT m = 0; m <= HIZ_MAX_MIPS; m++) {
+        D3D12_UNORDERED_ACCESS_VIEW_DESC uav = {};
+        uav.Format = DXGI_FORMAT_R32_FLOAT;
+        uav.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+        uav.Texture2D.MipSlice = (m < s_hizMips) ? m : 0;
+        dev12->CreateUnorderedAccessView(m < s_hizMips ? s_hiz : nullptr, nullptr, &uav, CullCpuHandle(CULL_UAV_HIZ_MIP0 + m));
+    }
+    return true;
+}
+
+// ============== INIT / RESIZE / CLEANUP ==============
+bool InitGpuCull12(ID3D12Resource* instances, UINT instanceCount, UINT indexCount)
+{
+    Log("[INFO] Initializing GPU culling (%u instances)...\n", instanceCount);
+    s_instances = instances;
+    s_instanceCount = instanceCount;
+    HRESULT hr;
+
+    // Root signature: constants + SRV/UAV tables for Hi-Z + root views for buffers
+    D3D12_DESCRIPTOR_RANGE srvRange = { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, 0 };
+    D3D12_DESCRIPTOR_RANGE uavRange = { D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 2, 0, 0, 0 };
+    D3D12_ROOT_PARAMETER params[CULL_RP_COUNT] = {};
+    params[CULL_RP_CONSTANTS].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    params[CULL_RP_CONSTANTS].Constants.Num32BitValues = sizeof(CullConstants) / 4;
+    params[CULL_RP_SRV_TABLE].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    params[CULL_RP_SRV_TABLE].DescriptorTable = { 1, &srvRange };
+    params[CULL_RP_UAV_TABLE].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    params[CULL_RP_UAV_TABLE].DescriptorTable = { 1, &uavRange };
+    params[CULL_RP_INSTANCES].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    params[CULL_RP_INSTANCES].Descriptor.ShaderRegister = 1;
+    params[CULL_RP_VISIBILITY].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    params[CULL_RP_VISIBILITY].Descriptor.ShaderRegister = 2;
+    params[CULL_RP_COMPACTED].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    params[CULL_RP_COMPACTED].Descriptor.ShaderRegister = 3;
+    params[CULL_RP_ARGS].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    params[CULL_RP_ARGS].Descriptor.ShaderRegister = 4;
+
+    D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
+    rsDesc.NumParameters = CULL_RP_COUNT;
+    rsDesc.pParameters = params;
+
+    ID3DBlob* sigBlob = nullptr, *errBlob = nullptr;
+    hr = D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[ERROR] Cull root sig: %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        return false;
+    }
+    hr = dev12->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&s_cullRootSig));
+    sigBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateRootSignature (cull)", hr); return false; }
+
+    if (!CreateCullPSO("CSCull", &s_cullPSO) ||
+        !CreateCullPSO("CSHiZCopy", &s_hizCopyPSO) ||
+        !CreateCullPSO("CSHiZDownsample", &s_hizDownPSO)) return false;
+
+    // Command signature: one DrawIndexedInstanced per argument record
+    D3D12_INDIRECT_ARGUMENT_DESC argDesc = {};
+    argDesc.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+    D3D12_COMMAND_SIGNATURE_DESC sigDesc = {};
+    sigDesc.ByteStride = sizeof(D3D12_DRAW_INDEXED_ARGUMENTS);
+    sigDesc.NumArgumentDescs = 1;
+    sigDesc.pArgumentDescs = &argDesc;
+    hr = dev12->CreateCommandSignature(&sigDesc, nullptr, IID_PPV_ARGS(&s_drawSig));
+    if (FAILED(hr)) { LogHR("CreateCommandSignature", hr); return false; }
+
+    // Buffers. Buffers decay to COMMON after every ExecuteCommandLists, so each
+    // frame starts from COMMON
+    UINT64 instBytes = (UINT64)instanceCount * sizeof(CubeInstance);
+    s_visibility = CreateCullBuffer((UINT64)instanceCount * 4, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+    s_compacted[0] = CreateCullBuffer(instBytes, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+    s_compacted[1] = CreateCullBuffer(instBytes, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+    s_args = CreateCullBuffer(ARGS_SIZE, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+    s_argsReset = CreateCullBuffer(ARGS_SIZE, D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ);
+    s_argsReadback = CreateCullBuffer(ARGS_SIZE * FRAME_COUNT, D3D12_HEAP_TYPE_READBACK, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST);
+    if (!s_visibility || !s_compacted[0] || !s_compacted[1] || !s_args || !s_argsReset || !s_argsReadback) return false;
+
+    D3D12_DRAW_INDEXED_ARGUMENTS reset[2] = {};
+    reset[0].IndexCountPerInstance = reset[1].IndexCountPerInstance = indexCount;
+    void* mapped = nullptr;
+    s_argsReset->Map(0, nullptr, &mapped);
+    memcpy(mapped, reset, sizeof(reset));
+    s_argsReset->Unmap(0, nullptr);
+    s_argsReadback->Map(0, nullptr, (void**)&s_argsReadbackMapped);
+    memset(s_argsReadbackMapped, 0, ARGS_SIZE * FRAME_COUNT);
+
+    // Descriptor heap + Hi-Z
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+    heapDesc.NumDescriptors = CULL_HEAP_SIZE;
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    hr = dev12->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&s_cullHeap));
+    if (FAILED(hr)) { LogHR("CreateDescriptorHeap (cull)", hr); return false; }
+    s_cullDescSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    if (!CreateHiZ()) return false;
+
+    Log("[INFO] GPU culling ready (Hi-Z %ux%u, %u mips)\n", W, H, s_hizMips);
+    return true;
+}
+
+bool ResizeGpuCull12()
+{
+    if (!s_cullHeap) return true;
+    return CreateHiZ();
+}
+
+void CleanupGpuCull12()
+{
+    if (s_hiz) { s_hiz->Release(); s_hiz = nullptr; }
+    if (s_cullHeap) { s_cullHeap->Release(); s_cullHeap = nullptr; }
+    if (s_argsReadback) { s_argsReadback->Release(); s_argsReadback = nullptr; }
+    s_argsReadbackMapped = nullptr;
+    if (s_argsReset) { s_argsReset->Release(); s_argsReset = nullptr; }
+    if (s_args) { s_args->Release(); s_args = nullptr; }
+    for (int i = 0; i < 2; i++) {
+        if (s_compacted[i]) { s_compacted[i]->Release(); s_compacted[i] = nullptr; }
+    }
+    if (s_visibility) { s_visibility->Release(); s_visibility = nullptr; }
+    if (s_drawSig) { s_drawSig->Release(); s_drawSig = nullptr; }
+    if (s_hizDownPSO) { s_hizDownPSO->Release(); s_hizDownPSO = nullptr; }
+    if (s_hizCopyPSO) { s_hizCopyPSO->Release(); s_hizCopyPSO = nullptr; }
+    if (s_cullPSO) { s_cullPSO->Release(); s_cullPSO = nullptr; }
+    if (s_cullRootSig) { s_cullRootSig->Release(); s_cullRootSig = nullptr; }
+    s_instances = nullptr;
+    s_instanceCount = 0;
+    s_visibleCount = 0;
+    s_hizMips = 0;
+}
+
+// ============== PER-FRAME ==============
+static void BindCull(ID3D12GraphicsCommandList* cl, ID3D12PipelineState* pso, const CullConstants& cc)
+{
+    ID3D12DescriptorHeap* heaps[] = { s_cullHeap };
+    cl->SetDescriptorHeaps(1, heaps);
+    cl->SetComputeRootSignature(s_cullRootSig);
+    cl->SetPipelineState(pso);
+    cl->SetComputeRoot32BitConstants(CULL_RP_CONSTANTS, sizeof(cc) / 4, &cc, 0);
+    cl->SetComputeRootShaderResourceView(CULL_RP_INSTANCES, s_instances->GetGPUVirtualAddress());
+    cl->SetComputeRootUnorderedAccessView(CULL_RP_VISIBILITY, s_visibility->GetGPUVirtualAddress());
+    cl->SetComputeRootUnorderedAccessView(CULL_RP_ARGS, s_args->GetGPUVirtualAddress());
+}
+
+static void Cull(ID3D12GraphicsCommandList* cl, CullConstants cc, UINT phase)
+{
+    cc.phase = phase;
+    BindCull(cl, s_cullPSO, cc);
+    cl->SetComputeRootDescriptorTable(CULL_RP_SRV_TABLE, CullGpuHandle(CULL_SRV_HIZ));
+    cl->SetComputeRootDescriptorTable(CULL_RP_UAV_TABLE, CullGpuHandle(CULL_UAV_HIZ_MIP0));
+    cl->SetComputeRootUnorderedAccessView(CULL_RP_COMPACTED, s_compacted[phase]->GetGPUVirtualAddress());
+    cl->Dispatch((s_instanceCount + 63) / 64, 1, 1);
+}
+
+static void DrawPhase(ID3D12GraphicsCommandList* cl, UINT phase)
+{
+    D3D12_VERTEX_BUFFER_VIEW inst = {};
+    inst.BufferLocation = s_compacted[phase]->GetGPUVirtualAddress();
+    inst.SizeInBytes = s_instanceCount * sizeof(CubeInstance);
+    inst.StrideInBytes = sizeof(CubeInstance);
+    cl->IASetVertexBuffers(1, 1, &inst);
+    cl->ExecuteIndirect(s_drawSig, 1, s_args, phase * sizeof(D3D12_DRAW_INDEXED_ARGUMENTS), nullptr, 0);
+}
+
+UINT GpuCullVisibleCount12()
+{
+    return s_visibleCount;
+}
+
+// Records cull + draw for the whole frame. Render targets, viewport, graphics
+// root signature, slot 0 VB and IB must already be set; PSO is left as scenePso.
+void GpuCullRender12(ID3D12GraphicsCommandList* cl, ID3D12PipelineState* scenePso, float time, float aspect)
+{
+    // Readback slot for this frame was last written FRAME_COUNT frames ago and
+    // MoveToNextFrame has waited on it
+    const D3D12_DRAW_INDEXED_ARGUMENTS* rb = s_argsReadbackMapped + frameIndex * 2;
+    s_visibleCount = rb[0].InstanceCount + rb[1].InstanceCount;
+
+    CullConstants cc = { time, aspect, s_instanceCount, 0, W, H, s_hizMips, 0 };
+    D3D12_RESOURCE_BARRIER b[6];
+    UINT n = 0;
+
+    // Reset both arg records to instanceCount = 0
+    Transition(cl, s_args, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST, b, n);
+    cl->ResourceBarrier(n, b); n = 0;
+    cl->CopyBufferRegion(s_args, 0, s_argsReset, 0, ARGS_SIZE);
+    Transition(cl, s_args, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, b, n);
+    Transition(cl, s_compacted[0], D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, b, n);
+    Transition(cl, s_compacted[1], D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, b, n);
+    Transition(cl, s_visibility, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, b, n);
+    cl->ResourceBarrier(n, b); n = 0;
+
+    // Phase 0: last frame's visible set
+    Cull(cl, cc, 0);
+    Transition(cl, s_args, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, b, n);
+    Transition(cl, s_compacted[0], D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, b, n);
+    cl->ResourceBarrier(n, b); n = 0;
+    cl->SetPipelineState(scenePso);
+    DrawPhase(cl, 0);
+
+    // Hi-Z from the phase 0 depth
+    Transition(cl, depthStencil12, D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, b, n);
+    cl->ResourceBarrier(n, b); n = 0;
+    BindCull(cl, s_hizCopyPSO, cc);
+    cl->SetComputeRootDescriptorTable(CULL_RP_SRV_TABLE, CullGpuHandle(CULL_SRV_DEPTH));
+    cl->SetComputeRootDescriptorTable(CULL_RP_UAV_TABLE, CullGpuHandle(CULL_UAV_HIZ_MIP0));
+    cl->SetComputeRootUnorderedAccessView(CULL_RP_COMPACTED, s_compacted[1]->GetGPUVirtualAddress());
+    cl->Dispatch((W + 7) / 8, (H + 7) / 8, 1);
+
+    D3D12_RESOURCE_BARRIER uav = {};
+    uav.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    uav.UAV.pResource = s_hiz;
+    cl->SetPipelineState(s_hizDownPSO);
+    for (UINT m = 0; m + 1 < s_hizMips; m++) {
+        cl->ResourceBarrier(1, &uav);
+        cc.phase = m;
+        cl->SetComputeRoot32BitConstants(CULL_RP_CONSTANTS, sizeof(cc) / 4, &cc, 0);
+        cl->SetComputeRootDescriptorTable(CULL_RP_UAV_TABLE, CullGpuHandle(CULL_UAV_HIZ_MIP0 + m));
+        UINT dw = max(W >> (m + 1), 1u), dh = max(H >> (m + 1), 1u);
+        cl->Dispatch((dw + 7) / 8, (dh + 7) / 8, 1);
+    }
+
+    // Phase 1: occlusion test everything against the new pyramid
+    Transition(cl, s_hiz, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, b, n);
+    Transition(cl, s_args, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, b, n);
+    Transition(cl, depthStencil12, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_DEPTH_WRITE, b, n);
+    cl->ResourceBarrier(n, b); n = 0;
+    Cull(cl, cc, 1);
+    Transition(cl, s_hiz, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, b, n);
+    Transition(cl, s_args, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, b, n);
+    Transition(cl, s_compacted[1], D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, b, n);
+    cl->ResourceBarrier(n, b); n = 0;
+    cl->SetPipelineState(scenePso);
+    DrawPhase(cl, 1);
+
+    // Visible counts for the overlay, read back FRAME_COUNT frames later
+    Transition(cl, s_args, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_RESOURCE_STATE_COPY_SOURCE, b, n);
+    cl->ResourceBarrier(n, b); n = 0;
+    cl->CopyBufferRegion(s_argsReadback, frameIndex * ARGS_SIZE, s_args, 0, ARGS_SIZE);
+}
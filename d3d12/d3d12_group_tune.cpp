@@ -0,0 +1,87 @@
+// ============== D3D12 GROUP SHAPE VARIANTS ==============
+// Per-variant PSOs of the --group-size kernels (group_tune.h). Each variant is
+// the kernel's runtime source compiled with the GROUP_X / GROUP_Y / WAVE_SIZE
+// defines of shaders/group_shape_shaders.h, so it gets its own DXIL cache
+// entry and pipeline library PSO and warm starts compile nothing.
+
+#include "../common.h"
+#include "d3d12_shared.h"
+#include "../group_tune.h"
+
+#include <d3d12.h>
+
+#define GROUP_MAX_ARGS 24
+
+UINT GroupTuneBegin12(ID3D12Device* device, GroupKernel kernel) {
+    // [WaveSize] needs SM 6.6; the lane counts the device can run come from OPTIONS1
+    UINT waveMin = 0, waveMax = 0;
+    D3D12_FEATURE_DATA_SHADER_MODEL sm = { D3D_SHADER_MODEL_6_6 };
+    D3D12_FEATURE_DATA_D3D12_OPTIONS1 options1 = {};
+    if (device && SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_SHADER_MODEL, &sm, sizeof(sm))) &&
+        sm.HighestShaderModel >= D3D_SHADER_MODEL_6_6 &&
+        SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS1, &options1, sizeof(options1))) &&
+        options1.WaveOps) {
+        waveMin = options1.WaveLaneCountMin;
+        waveMax = options1.WaveLaneCountMax;
+    }
+    return GroupTuneBegin(kernel, waveMin, waveMax);
+}
+
+void GroupCreateVariants12(ID3D12Device* device, GroupKernel kernel, UINT mask, const char* source,
+                           const wchar_t** args, UINT argCount, ID3D12RootSignature* rootSig,
+                           ID3D12PipelineState* defaultPSO, ID3D12PipelineState** psos) {
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) psos[v] = nullptr;
+    psos[GROUP_VARIANT_DEFAULT] = defaultPSO;
+    if (argCount + 6 > GROUP_MAX_ARGS) return;
+
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) {
+        if (v == GROUP_VARIANT_DEFAULT || !(mask & (1u << v))) continue;
+        const GroupShape& shape = GroupVariant(v);
+        wchar_t defX[32], defY[32], defWave[32];
+        swprintf_s(defX, L"GROUP_X=%u", shape.x);
+        swprintf_s(defY, L"GROUP_Y=%u", shape.y);
+        swprintf_s(defWave, L"WAVE_SIZE=%u", shape.wave);
+
+        const wchar_t* variantArgs[GROUP_MAX_ARGS];
+        UINT n = 0;
+        for (UINT i = 0; i < argCount; i++) {
+            variantArgs[n++] = args[i];
+            if (shape.wave && wcscmp(args[i], L"-T") == 0 && i + 1 < argCount) {
+                variantArgs[n++] = L"cs_6_6";
+                i++;
+            }
+        }
+        variantArgs[n++] = L"-D"; variantArgs[n++] = defX;
+        variantArgs[n++] = L"-D"; variantArgs[n++] = defY;
+        if (shape.wave) { variantArgs[n++] = L"-D"; variantArgs[n++] = defWave; }
+
+        char tag[64];
+        sprintf_s(tag, "%s %s", GroupKernelName(kernel), shape.name);
+        wchar_t label[64];
+        swprintf_s(label, L"%S_%S", GroupKernelName(kernel), shape.name);
+
+        ID3DBlob* blob = nullptr;
+        if (!CompileDXC(source, variantArgs, n, &blob, tag)) {
+            Log("[WARN] Group size %s: compile failed, variant skipped\n", tag);
+            GroupTuneDrop(kernel, v);
+            continue;
+        }
+        D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
+        desc.pRootSignature = rootSig;
+        desc.CS = { blob->GetBufferPointer(), blob->GetBufferSize() };
+        HRESULT hr = PipelineCacheCreateCompute(device, label, desc, &psos[v]);
+        blob->Release();
+        if (FAILED(hr)) {
+            LogHR(tag, hr);
+            psos[v] = nullptr;
+            GroupTuneDrop(kernel, v);
+        }
+    }
+}
+
+void GroupReleaseVariants12(ID3D12PipelineState** psos) {
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) {
+        if (v != GROUP_VARIANT_DEFAULT && psos[v]) psos[v]->Release();
+        psos[v] = nullptr;
+    }
+}
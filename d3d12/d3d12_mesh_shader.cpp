@@ -0,0 +1,356 @@
+// ============== D3D12 MESH SHADER PATH ==============
+// --mesh-shaders for the D3D12 base renderer: the rounded cubes of the classic
+// scene or of --cubes=N are generated on the GPU by amplification + mesh
+// shaders (shaders/d3d12_mesh_shaders.h), next to the VB/IB and instanced
+// vertex pipeline paths. The only geometry in memory is one 48-byte MeshCube
+// per cube. Each cube is 6 faces x 9 meshlets; an amplification group tests
+// 32 meshlets (frustum + normal cone) and launches a mesh group per survivor.
+// The surviving meshlet / triangle counts are read back for the overlay.
+
+#include "../common.h"
+#include "d3d12_shared.h"
+#include "../cube_geometry.h"
+#include "../shaders/d3d12_mesh_shaders.h"
+
+#include <d3d12.h>
+#include <vector>
+
+// ============== MESH SHADER GLOBALS ==============
+// Must match the constants at the top of g_d3d12MeshShaderCode
+#define MESHLET_CELLS 7
+#define MESHLET_TILES ((CUBE_GEOMETRY_SEGMENTS + MESHLET_CELLS - 1) / MESHLET_CELLS)
+#define MESHLETS_PER_CUBE (6 * MESHLET_TILES * MESHLET_TILES)
+#define MESH_AS_GROUP_SIZE 32
+#define MESH_MAX_GROUPS_X 65535             // Per-dimension DispatchMesh limit
+#define MESH_MAX_GROUPS (1u << 22)          // X * Y * Z DispatchMesh limit
+
+struct MeshCube {
+    float offset[3];
+    float scale;
+    float color[4];
+    UINT faceMask;
+    UINT outerEdges;
+    UINT _pad[2];
+};
+static_assert(sizeof(MeshCube) == 48, "MeshCube must match the HLSL struct");
+
+struct MeshConstants {
+    float time;
+    float aspect;
+    UINT meshletCount;
+    UINT groupsX;
+};
+
+// Root parameters
+enum {
+    MESH_RP_CONSTANTS = 0,  // b0, 4 dwords
+    MESH_RP_CUBES,          // t0
+    MESH_RP_STATS,          // u0
+    MESH_RP_COUNT
+};
+
+static ID3D12GraphicsCommandList6* s_meshList = nullptr;   // cmdList, for DispatchMesh
+static ID3D12RootSignature* s_meshRootSig = nullptr;
+static ID3D12PipelineState* s_meshPSO = nullptr;
+static ID3D12Resource* s_cubes = nullptr;                   // MeshCube per cube
+static ID3D12Resource* s_stats = nullptr;                   // Visible meshlets, visible triangles
+static ID3D12Resource* s_statsReset = nullptr;              // Upload copy of two zeros
+static ID3D12Resource* s_statsReadback = nullptr;           // FRAME_COUNT copies of s_stats
+static const UINT* s_statsReadbackMapped = nullptr;
+static UINT s_cubeCount = 0;
+static UINT s_meshletCount = 0;
+static UINT s_groupsX = 0, s_groupsY = 0;
+static UINT s_visibleMeshlets = 0;
+static UINT s_visibleTriangles = 0;
+
+static const UINT STATS_SIZE = 2 * sizeof(UINT);
+
+// Colors[] of the base shaders (d3d11_shaders.h), one per classic scene cube
+static const float s_sceneColors[8][4] = {
+    {0.95f, 0.2f, 0.15f, 1}, {0.2f, 0.7f, 0.3f, 1}, {0.15f, 0.5f, 0.95f, 1}, {1.0f, 0.85f, 0.0f, 1},
+    {1.0f, 0.85f, 0.0f, 1}, {0.15f, 0.5f, 0.95f, 1}, {0.2f, 0.7f, 0.3f, 1}, {0.95f, 0.2f, 0.15f, 1},
+};
+
+// ============== PIPELINE STATE STREAM ==============
+// Mesh shader PSOs only exist as a pipeline state stream (no d3dx12.h here)
+template <D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type, typename T>
+struct alignas(void*) MeshPsoSubobject {
+    D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type = Type;
+    T desc = {};
+};
+
+struct MeshPsoStream {
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE, ID3D12RootSignature*> rootSig;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS, D3D12_SHADER_BYTECODE> as;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, D3D12_SHADER_BYTECODE> ms;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, D3D12_SHADER_BYTECODE> ps;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND, D3D12_BLEND_DESC> blend;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK, UINT> sampleMask;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER, D3D12_RASTERIZER_DESC> rasterizer;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL, D3D12_DEPTH_STENCIL_DESC> depthStencil;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS, D3D12_RT_FORMAT_ARRAY> rtvFormats;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT, DXGI_FORMAT> dsvFormat;
+    MeshPsoSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC, DXGI_SAMPLE_DESC> sampleDesc;
+};
+
+// ============== HELPERS ==============
+static ID3D12Resource* CreateMeshBuffer(UINT64 size, D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_FLAGS flags, D3D12_RESOURCE_STATES state)
+{
+    D3D12_HEAP_PROPERTIES heap = { heapType };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = size; desc.Height = 1; desc.DepthOrArraySize = 1; desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags = flags;
+    ID3D12Resource* res = nullptr;
+    HRESULT hr = dev12->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, state, nullptr, IID_PPV_ARGS(&res));
+    if (FAILED(hr)) { LogHR("CreateMeshBuffer", hr); return nullptr; }
+    return res;
+}
+
+static void Transition(ID3D12GraphicsCommandList* cl, ID3D12Resource* res, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after)
+{
+    D3D12_RESOURCE_BARRIER b = {};
+    b.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    b.Transition.pResource = res;
+    b.Transition.StateBefore = before;
+    b.Transition.StateAfter = after;
+    b.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    cl->ResourceBarrier(1, &b);
+}
+
+// Per-cube parameters: the 8 classic scene cubes (hidden faces dropped, edges
+// towards a neighbour rounded inward, as BuildSceneCubes) or the --cubes
+// instances (every face drawn, every edge outward, as BuildInstanceCube)
+static void BuildMeshCubes(UINT instanceCount, std::vector<MeshCube>& out)
+{
+    out.clear();
+    if (instanceCount > 0) {
+        std::vector<CubeInstance> instances;
+        BuildCubeInstances(instanceCount, instances);
+        out.resize(instances.size());
+        for (size_t i = 0; i < instances.size(); i++) {
+            MeshCube& m = out[i];
+            m = {};
+            memcpy(m.offset, instances[i].offset, sizeof(m.offset));
+            m.scale = instances[i].scale;
+            memcpy(m.color, instances[i].color, sizeof(m.color));
+            m.faceMask = 0x3F;
+            m.outerEdges = 0xFFFFFF;
+        }
+        return;
+    }
+
+    static const int coords[8][3] = {
+        {-1, +1, +1}, {+1, +1, +1}, {-1, -1, +1}, {+1, -1, +1},
+        {-1, +1, -1}, {+1, +1, -1}, {-1, -1, -1}, {+1, -1, -1},
+    };
+    const float half = CUBE_GEOMETRY_SIZE / 2;
+    out.resize(8);
+    for (int c = 0; c < 8; c++) {
+        int cx = coords[c][0], cy = coords[c][1], cz = coords[c][2];
+        MeshCube& m = out[c];
+        m = {};
+        m.offset[0] = cx * half; m.offset[1] = cy * half; m.offset[2] = cz * half;
+        m.scale = 1.0f;
+        memcpy(m.color, s_sceneColors[c], sizeof(m.color));
+
+        // Face order +z -z +x -x +y -y, edge order +u -u +v -v (cube_geometry.cpp)
+        bool face[6] = {(cz > 0), (cz < 0), (cx > 0), (cx < 0), (cy > 0), (cy < 0)};
+        bool outer[6][4] = {
+            {cx < 0, cx > 0, cy > 0, cy < 0},
+            {cx > 0, cx < 0, cy > 0, cy < 0},
+            {cz > 0, cz < 0, cy > 0, cy < 0},
+            {cz < 0, cz > 0, cy > 0, cy < 0},
+            {cx > 0, cx < 0, cz > 0, cz < 0},
+            {cx > 0, cx < 0, cz < 0, cz > 0},
+        };
+        for (int f = 0; f < 6; f++) {
+            if (face[f]) m.faceMask |= 1u << f;
+            for (int e = 0; e < 4; e++)
+                if (outer[f][e]) m.outerEdges |= 1u << (f * 4 + e);
+        }
+    }
+}
+
+// ============== INIT / CLEANUP ==============
+bool MeshShadersSupported12()
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS7 options7 = {};
+    if (FAILED(dev12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS7, &options7, sizeof(options7))) ||
+        options7.MeshShaderTier == D3D12_MESH_SHADER_TIER_NOT_SUPPORTED) {
+        return false;
+    }
+    D3D12_FEATURE_DATA_SHADER_MODEL sm = { D3D_SHADER_MODEL_6_5 };
+    return SUCCEEDED(dev12->CheckFeatureSupport(D3D12_FEATURE_SHADER_MODEL, &sm, sizeof(sm))) &&
+           sm.HighestShaderModel >= D3D_SHADER_MODEL_6_5;
+}
+
+bool InitMeshShaders12(UINT instanceCount)
+{
+    Log("[INFO] Initializing mesh shader path...\n");
+    HRESULT hr;
+
+    std::vector<MeshCube> cubes;
+    BuildMeshCubes(instanceCount, cubes);
+    s_cubeCount = (UINT)cubes.size();
+    s_meshletCount = s_cubeCount * MESHLETS_PER_CUBE;
+    UINT groups = (s_meshletCount + MESH_AS_GROUP_SIZE - 1) / MESH_AS_GROUP_SIZE;
+    if (groups > MESH_MAX_GROUPS) {
+        Log("[ERROR] Mesh shaders: %u amplification groups exceed the DispatchMesh limit\n", groups);
+        return false;
+    }
+    s_groupsX = min(groups, (UINT)MESH_MAX_GROUPS_X);
+    s_groupsY = (groups + s_groupsX - 1) / s_groupsX;
+
+    hr = cmdList->QueryInterface(IID_PPV_ARGS(&s_meshList));
+    if (FAILED(hr)) { LogHR("QueryInterface (ID3D12GraphicsCommandList6)", hr); return false; }
+    ID3D12Device2* dev2 = nullptr;
+    hr = dev12->QueryInterface(IID_PPV_ARGS(&dev2));
+    if (FAILED(hr)) { LogHR("QueryInterface (ID3D12Device2)", hr); return false; }
+
+    // Root signature: constants + root SRV (cubes) + root UAV (stats)
+    D3D12_ROOT_PARAMETER params[MESH_RP_COUNT] = {};
+    params[MESH_RP_CONSTANTS].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    params[MESH_RP_CONSTANTS].Constants.Num32BitValues = sizeof(MeshConstants) / 4;
+    params[MESH_RP_CUBES].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    params[MESH_RP_CUBES].Descriptor.ShaderRegister = 0;
+    params[MESH_RP_STATS].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    params[MESH_RP_STATS].Descriptor.ShaderRegister = 0;
+
+    D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
+    rsDesc.NumParameters = MESH_RP_COUNT;
+    rsDesc.pParameters = params;
+    rsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS |
+                   D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                   D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                   D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
+
+    ID3DBlob* sigBlob = nullptr, *errBlob = nullptr;
+    hr = D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[ERROR] Mesh root sig: %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        dev2->Release();
+        return false;
+    }
+    hr = dev12->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&s_meshRootSig));
+    sigBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateRootSignature (mesh)", hr); dev2->Release(); return false; }
+
+    // AS / MS / PS through the DXIL cache
+    LPCWSTR asArgs[] = { L"-E", L"ASMain", L"-T", L"as_6_5" };
+    LPCWSTR msArgs[] = { L"-E", L"MSMain", L"-T", L"ms_6_5" };
+    LPCWSTR psArgs[] = { L"-E", L"PSMain", L"-T", L"ps_6_5" };
+    ID3DBlob* asBlob = nullptr, *msBlob = nullptr, *psBlob = nullptr;
+    if (!CompileDXC(g_d3d12MeshShaderCode, asArgs, _countof(asArgs), &asBlob, "MeshAS") ||
+        !CompileDXC(g_d3d12MeshShaderCode, msArgs, _countof(msArgs), &msBlob, "MeshMS") ||
+        !CompileDXC(g_d3d12MeshShaderCode, psArgs, _countof(psArgs), &psBlob, "MeshPS")) {
+        if (asBlob) asBlob->Release();
+        if (msBlob) msBlob->Release();
+        dev2->Release();
+        return false;
+    }
+
+    // Same raster / depth / output state as the vertex pipeline PSO
+    MeshPsoStream stream;
+    stream.rootSig.desc = s_meshRootSig;
+    stream.as.desc = { asBlob->GetBufferPointer(), asBlob->GetBufferSize() };
+    stream.ms.desc = { msBlob->GetBufferPointer(), msBlob->GetBufferSize() };
+    stream.ps.desc = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
+    stream.blend.desc.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    stream.sampleMask.desc = UINT_MAX;
+    stream.rasterizer.desc.FillMode = D3D12_FILL_MODE_SOLID;
+    stream.rasterizer.desc.CullMode = D3D12_CULL_MODE_BACK;
+    stream.rasterizer.desc.FrontCounterClockwise = FALSE;
+    stream.rasterizer.desc.DepthClipEnable = TRUE;
+    stream.depthStencil.desc.DepthEnable = TRUE;
+    stream.depthStencil.desc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+    stream.depthStencil.desc.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+    stream.rtvFormats.desc.NumRenderTargets = 1;
+    stream.rtvFormats.desc.RTFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+    stream.dsvFormat.desc = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    stream.sampleDesc.desc.Count = 1;
+
+    D3D12_PIPELINE_STATE_STREAM_DESC streamDesc = { sizeof(stream), &stream };
+    hr = dev2->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&s_meshPSO));
+    asBlob->Release(); msBlob->Release(); psBlob->Release();
+    dev2->Release();
+    if (FAILED(hr)) { LogHR("CreatePipelineState (mesh)", hr); return false; }
+
+    // Cube parameters (DEFAULT heap, COMMON -> promoted to a shader resource on first read)
+    if (!UploadBegin12(dev12)) return false;
+    s_cubes = UploadBuffer12(cubes.data(), cubes.size() * sizeof(MeshCube), "MeshCubes");
+    if (!UploadFlush12() || !s_cubes) {
+        Log("[ERROR] Mesh shader cube upload failed\n");
+        return false;
+    }
+
+    s_stats = CreateMeshBuffer(STATS_SIZE, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+    s_statsReset = CreateMeshBuffer(STATS_SIZE, D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ);
+    s_statsReadback = CreateMeshBuffer(STATS_SIZE * FRAME_COUNT, D3D12_HEAP_TYPE_READBACK, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST);
+    if (!s_stats || !s_statsReset || !s_statsReadback) return false;
+
+    void* mapped = nullptr;
+    s_statsReset->Map(0, nullptr, &mapped);
+    memset(mapped, 0, STATS_SIZE);
+    s_statsReset->Unmap(0, nullptr);
+    s_statsReadback->Map(0, nullptr, &mapped);
+    memset(mapped, 0, STATS_SIZE * FRAME_COUNT);
+    s_statsReadbackMapped = (const UINT*)mapped;
+
+    Log("[INFO] Mesh shader scene: %u cubes, %u meshlets (%u per cube), %zu KB of cube parameters, no VB/IB\n",
+        s_cubeCount, s_meshletCount, (UINT)MESHLETS_PER_CUBE, cubes.size() * sizeof(MeshCube) / 1024);
+    return true;
+}
+
+void CleanupMeshShaders12()
+{
+    if (s_statsReadback) { s_statsReadback->Release(); s_statsReadback = nullptr; }
+    s_statsReadbackMapped = nullptr;
+    if (s_statsReset) { s_statsReset->Release(); s_statsReset = nullptr; }
+    if (s_stats) { s_stats->Release(); s_stats = nullptr; }
+    if (s_cubes) { s_cubes->Release(); s_cubes = nullptr; }
+    if (s_meshPSO) { s_meshPSO->Release(); s_meshPSO = nullptr; }
+    if (s_meshRootSig) { s_meshRootSig->Release(); s_meshRootSig = nullptr; }
+    if (s_meshList) { s_meshList->Release(); s_meshList = nullptr; }
+    s_cubeCount = 0;
+    s_meshletCount = 0;
+    s_groupsX = s_groupsY = 0;
+    s_visibleMeshlets = 0;
+    s_visibleTriangles = 0;
+}
+
+// ============== PER-FRAME ==============
+void MeshShaderStats12(UINT& visibleMeshlets, UINT& totalMeshlets, UINT& visibleTriangles)
+{
+    visibleMeshlets = s_visibleMeshlets;
+    totalMeshlets = s_meshletCount;
+    visibleTriangles = s_visibleTriangles;
+}
+
+// Records the whole scene on cmdList. Render targets, viewport and scissor must
+// already be set; graphics root signature and PSO are left as the mesh ones.
+void MeshShaderRender12(float time, float aspect)
+{
+    // Readback slot for this frame was last written FRAME_COUNT frames ago and
+    // MoveToNextFrame has waited on it
+    const UINT* rb = s_statsReadbackMapped + frameIndex * 2;
+    s_visibleMeshlets = rb[0];
+    s_visibleTriangles = rb[1];
+
+    Transition(s_meshList, s_stats, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+    s_meshList->CopyBufferRegion(s_stats, 0, s_statsReset, 0, STATS_SIZE);
+    Transition(s_meshList, s_stats, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+    MeshConstants mc = { time, aspect, s_meshletCount, s_groupsX };
+    s_meshList->SetGraphicsRootSignature(s_meshRootSig);
+    s_meshList->SetPipelineState(s_meshPSO);
+    s_meshList->SetGraphicsRoot32BitConstants(MESH_RP_CONSTANTS, sizeof(mc) / 4, &mc, 0);
+    s_meshList->SetGraphicsRootShaderResourceView(MESH_RP_CUBES, s_cubes->GetGPUVirtualAddress());
+    s_meshList->SetGraphicsRootUnorderedAccessView(MESH_RP_STATS, s_stats->GetGPUVirtualAddress());
+    s_meshList->DispatchMesh(s_groupsX, s_groupsY, 1);
+
+    // Counts for the overlay, read back FRAME_COUNT frames later
+    Transition(s_meshList, s_stats, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    s_meshList->CopyBufferRegion(s_statsReadback, frameIndex * STATS_SIZE, s_stats, 0, STATS_SIZE);
+}
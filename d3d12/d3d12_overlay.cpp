@@ -0,0 +1,211 @@
+// ============== D3D12 TEXT OVERLAY ==============
+// Instanced glyph overlay (text_overlay.h) for every D3D12 renderer. One
+// root signature with 4 root constants (1 / width, 1 / height), one PSO with
+// per-instance GlyphInstance input and no descriptors: the font bits live in
+// the shader, so there is no texture upload or SRV heap to manage.
+
+#include "../common.h"
+#include "d3d12_shared.h"
+
+#include <d3d12.h>
+#include <d3dcompiler.h>
+#include <cstring>
+
+// ============== BUNDLES (--bundles) ==============
+static void ReleaseBundles(Overlay12& overlay)
+{
+    for (UINT f = 0; f < FRAME_COUNT; f++) {
+        if (overlay.bundle[f]) { overlay.bundle[f]->Release(); overlay.bundle[f] = nullptr; }
+        if (overlay.bundleAlloc[f]) { overlay.bundleAlloc[f]->Release(); overlay.bundleAlloc[f] = nullptr; }
+        overlay.bundleCount[f] = 0;
+    }
+}
+
+static bool CreateBundles(Overlay12& overlay, ID3D12Device* device)
+{
+    for (UINT f = 0; f < FRAME_COUNT; f++) {
+        HRESULT hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(&overlay.bundleAlloc[f]));
+        if (FAILED(hr)) { LogHR("CreateCommandAllocator (overlay bundle)", hr); return false; }
+        hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_BUNDLE, overlay.bundleAlloc[f], overlay.pso,
+                                       IID_PPV_ARGS(&overlay.bundle[f]));
+        if (FAILED(hr)) { LogHR("CreateCommandList (overlay bundle)", hr); return false; }
+        overlay.bundle[f]->Close();
+        overlay.bundleCount[f] = 0;
+    }
+    return true;
+}
+
+// Only the slice address and the glyph count end up in the bundle
+static bool RecordBundle(Overlay12& overlay, UINT frame, UINT count)
+{
+    ID3D12GraphicsCommandList* bundle = overlay.bundle[frame];
+    if (FAILED(overlay.bundleAlloc[frame]->Reset()) || FAILED(bundle->Reset(overlay.bundleAlloc[frame], overlay.pso))) {
+        // Earlier slices may still be in flight, keep the bundles and draw directly this frame
+        overlay.bundleCount[frame] = 0;
+        return false;
+    }
+    D3D12_VERTEX_BUFFER_VIEW view = {};
+    view.BufferLocation = overlay.instances->GetGPUVirtualAddress() +
+                          (UINT64)frame * OVERLAY_MAX_INSTANCES * sizeof(GlyphInstance);
+    view.SizeInBytes = count * (UINT)sizeof(GlyphInstance);
+    view.StrideInBytes = sizeof(GlyphInstance);
+    bundle->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    bundle->IASetVertexBuffers(0, 1, &view);
+    bundle->DrawInstanced(4, count, 0, 0);
+    bundle->Close();
+    overlay.bundleCount[frame] = count;
+    return true;
+}
+
+bool Overlay12Init(Overlay12& overlay, ID3D12Device* device, DXGI_FORMAT rtvFormat, const char* tag)
+{
+    Overlay12Cleanup(overlay);
+    HRESULT hr;
+
+    D3D12_ROOT_PARAMETER param = {};
+    param.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    param.Constants.ShaderRegister = 0;
+    param.Constants.Num32BitValues = 4;
+    param.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+    D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
+    rsDesc.NumParameters = 1;
+    rsDesc.pParameters = &param;
+    rsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+    ID3DBlob* sigBlob = nullptr, *errBlob = nullptr;
+    hr = D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[ERROR] %s overlay root sig: %s\n", tag, (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        return false;
+    }
+    hr = device->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&overlay.rootSig));
+    sigBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateOverlayRootSig", hr); return false; }
+
+    std::string source = OverlayShaderHLSL();
+    ID3DBlob* vsBlob = nullptr, *psBlob = nullptr;
+    UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
+    hr = D3DCompile(source.c_str(), source.size(), "overlay", nullptr, nullptr, "GlyphVS", "vs_5_0", flags, 0, &vsBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[SHADER ERROR] %s overlay: %s\n", tag, (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        return false;
+    }
+    hr = D3DCompile(source.c_str(), source.size(), "overlay", nullptr, nullptr, "GlyphPS", "ps_5_0", flags, 0, &psBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[SHADER ERROR] %s overlay: %s\n", tag, (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        vsBlob->Release(); return false;
+    }
+
+    D3D12_INPUT_ELEMENT_DESC layout[] = {
+        {"GLYPHPOS", 0, DXGI_FORMAT_R16G16_UINT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+        {"GLYPHCODE", 0, DXGI_FORMAT_R8G8_UINT, 0, 4, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+    };
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.InputLayout = { layout, _countof(layout) };
+    psoDesc.pRootSignature = overlay.rootSig;
+    psoDesc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
+    psoDesc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
+    psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    psoDesc.RasterizerState.DepthClipEnable = TRUE;
+    // Alpha blending (translucent shadow)
+    psoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+    psoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+    psoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+    psoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+    psoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+    psoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ZERO;
+    psoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+    psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    psoDesc.DepthStencilState.DepthEnable = FALSE;
+    psoDesc.SampleMask = UINT_MAX;
+    psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    psoDesc.NumRenderTargets = 1;
+    psoDesc.RTVFormats[0] = rtvFormat;
+    psoDesc.SampleDesc.Count = 1;
+
+    hr = device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&overlay.pso));
+    vsBlob->Release(); psBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateOverlayPSO", hr); return false; }
+
+    // Persistently mapped instance slices, 16 KB each
+    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
+    D3D12_RESOURCE_DESC bufDesc = {};
+    bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    bufDesc.Width = (UINT64)FRAME_COUNT * OVERLAY_MAX_INSTANCES * sizeof(GlyphInstance);
+    bufDesc.Height = 1;
+    bufDesc.DepthOrArraySize = 1;
+    bufDesc.MipLevels = 1;
+    bufDesc.SampleDesc.Count = 1;
+    bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    hr = device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&overlay.instances));
+    if (FAILED(hr)) { LogHR("CreateOverlayInstances", hr); return false; }
+    D3D12_RANGE noRead = { 0, 0 };
+    hr = overlay.instances->Map(0, &noRead, (void**)&overlay.mapped);
+    if (FAILED(hr)) { LogHR("MapOverlayInstances", hr); return false; }
+
+    OverlayInvalidate(overlay.text);
+    memset(overlay.sliceVersion, 0, sizeof(overlay.sliceVersion));
+    if (g_bundles && !CreateBundles(overlay, device)) {
+        Log("[WARN] %s overlay bundles unavailable, recording the text draw per frame\n", tag);
+        ReleaseBundles(overlay);
+    }
+    Log("[INFO] %s text overlay initialized (instanced glyphs, %u max%s)\n", tag, OVERLAY_MAX_GLYPHS,
+        overlay.bundle[0] ? ", bundles" : "");
+    return true;
+}
+
+void Overlay12Draw(Overlay12& overlay, ID3D12GraphicsCommandList* cl, UINT frame, UINT width, UINT height)
+{
+    UINT count = OverlayInstanceCount(overlay.text);
+    if (!overlay.pso || !overlay.mapped || count == 0 || frame >= FRAME_COUNT || width == 0 || height == 0) return;
+
+    // The slice was last read FRAME_COUNT frames ago and the caller has waited on that frame
+    if (overlay.sliceVersion[frame] != overlay.text.version) {
+        memcpy(overlay.mapped + frame * OVERLAY_MAX_INSTANCES, overlay.text.instances, OverlayInstanceBytes(overlay.text));
+        overlay.sliceVersion[frame] = overlay.text.version;
+    }
+
+    D3D12_VIEWPORT vp = { 0, 0, (float)width, (float)height, 0, 1 };
+    D3D12_RECT scissor = { 0, 0, (LONG)width, (LONG)height };
+    cl->RSSetViewports(1, &vp);
+    cl->RSSetScissorRects(1, &scissor);
+
+    float constants[4] = { 1.0f / width, 1.0f / height, 0.0f, 0.0f };
+    if (overlay.bundle[frame] && (overlay.bundleCount[frame] == count || RecordBundle(overlay, frame, count))) {
+        // The bundle inherits viewport, scissor, root signature and constants from this list
+        cl->SetGraphicsRootSignature(overlay.rootSig);
+        cl->SetGraphicsRoot32BitConstants(0, 4, constants, 0);
+        cl->ExecuteBundle(overlay.bundle[frame]);
+        return;
+    }
+    cl->SetPipelineState(overlay.pso);
+    cl->SetGraphicsRootSignature(overlay.rootSig);
+    cl->SetGraphicsRoot32BitConstants(0, 4, constants, 0);
+
+    D3D12_VERTEX_BUFFER_VIEW view = {};
+    view.BufferLocation = overlay.instances->GetGPUVirtualAddress() +
+                          (UINT64)frame * OVERLAY_MAX_INSTANCES * sizeof(GlyphInstance);
+    view.SizeInBytes = OverlayInstanceBytes(overlay.text);
+    view.StrideInBytes = sizeof(GlyphInstance);
+    cl->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    cl->IASetVertexBuffers(0, 1, &view);
+    cl->DrawInstanced(4, count, 0, 0);
+}
+
+void Overlay12Cleanup(Overlay12& overlay)
+{
+    if (overlay.instances) {
+        if (overlay.mapped) overlay.instances->Unmap(0, nullptr);
+        overlay.instances->Release();
+    }
+    overlay.instances = nullptr;
+    overlay.mapped = nullptr;
+    if (overlay.pso) { overlay.pso->Release(); overlay.pso = nullptr; }
+    if (overlay.rootSig) { overlay.rootSig->Release(); overlay.rootSig = nullptr; }
+    ReleaseBundles(overlay);
+    OverlayInvalidate(overlay.text);
+}
@@ -0,0 +1,127 @@
+// ============== D3D12 RAY COUNTERS ==============
+// GPU side of --ray-stats (ray_stats.h) for the PT, DXR 1.1 and DXR 1.0
+// renderers. One default-heap buffer of RAY_TYPE_COUNT uints is zeroed at the
+// start of each frame, bound as the root UAV u0 space2 of the tracing passes
+// and copied into the frame's readback slot at the end. The slot is read when
+// the frame index comes round again (its fence has been waited on), like the
+// GPU timestamps.
+
+#include "../common.h"
+#include "d3d12_shared.h"
+#include "../ray_stats.h"
+
+#define RAY_COUNTER_BYTES (RAY_TYPE_COUNT * sizeof(UINT))
+
+static ID3D12Resource* s_rayCounters = nullptr;
+static ID3D12Resource* s_rayCounterZero = nullptr;
+static ID3D12Resource* s_rayCounterReadback = nullptr;
+static D3D12_RESOURCE_STATES s_rayCounterState = D3D12_RESOURCE_STATE_COMMON;
+static bool s_rayCounterPending[FRAME_COUNT] = {};
+
+static bool CreateRayCounterBuffer(ID3D12Device* device, D3D12_HEAP_TYPE heapType, UINT64 size,
+                                   D3D12_RESOURCE_FLAGS flags, D3D12_RESOURCE_STATES state,
+                                   ID3D12Resource** out, const char* what)
+{
+    D3D12_HEAP_PROPERTIES heap = { heapType };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = size;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags = flags;
+    HRESULT hr = device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, state, nullptr, IID_PPV_ARGS(out));
+    if (FAILED(hr)) { LogHR(what, hr); return false; }
+    return true;
+}
+
+bool InitRayCounters12(ID3D12Device* device)
+{
+    CleanupRayCounters12();
+    if (!g_rayStats || !device) return false;
+
+    if (!CreateRayCounterBuffer(device, D3D12_HEAP_TYPE_DEFAULT, RAY_COUNTER_BYTES,
+            D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON,
+            &s_rayCounters, "CreateCommittedResource (ray counters)") ||
+        !CreateRayCounterBuffer(device, D3D12_HEAP_TYPE_UPLOAD, RAY_COUNTER_BYTES,
+            D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+            &s_rayCounterZero, "CreateCommittedResource (ray counter zeros)") ||
+        !CreateRayCounterBuffer(device, D3D12_HEAP_TYPE_READBACK, FRAME_COUNT * RAY_COUNTER_BYTES,
+            D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST,
+            &s_rayCounterReadback, "CreateCommittedResource (ray counter readback)")) {
+        CleanupRayCounters12();
+        return false;
+    }
+
+    void* zero = nullptr;
+    D3D12_RANGE readRange = { 0, 0 };
+    if (FAILED(s_rayCounterZero->Map(0, &readRange, &zero))) { CleanupRayCounters12(); return false; }
+    memset(zero, 0, RAY_COUNTER_BYTES);
+    s_rayCounterZero->Unmap(0, nullptr);
+
+    s_rayCounterState = D3D12_RESOURCE_STATE_COMMON;
+    Log("[INFO] Ray counters ready (%u ray types)\n", (UINT)RAY_TYPE_COUNT);
+    return true;
+}
+
+static void RayCounterTransition(ID3D12GraphicsCommandList* cl, D3D12_RESOURCE_STATES state)
+{
+    if (s_rayCounterState == state) return;
+    D3D12_RESOURCE_BARRIER b = {};
+    b.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    b.Transition.pResource = s_rayCounters;
+    b.Transition.StateBefore = s_rayCounterState;
+    b.Transition.StateAfter = state;
+    b.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    cl->ResourceBarrier(1, &b);
+    s_rayCounterState = state;
+}
+
+void RayCountersBegin12(ID3D12GraphicsCommandList* cl)
+{
+    if (!s_rayCounters) return;
+    // A buffer decays to COMMON when the previous frame's list finishes executing
+    s_rayCounterState = D3D12_RESOURCE_STATE_COMMON;
+    RayCounterTransition(cl, D3D12_RESOURCE_STATE_COPY_DEST);
+    cl->CopyBufferRegion(s_rayCounters, 0, s_rayCounterZero, 0, RAY_COUNTER_BYTES);
+    RayCounterTransition(cl, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS RayCountersAddress12()
+{
+    return s_rayCounters ? s_rayCounters->GetGPUVirtualAddress() : 0;
+}
+
+void RayCountersEnd12(ID3D12GraphicsCommandList* cl, UINT frame)
+{
+    if (!s_rayCounters || frame >= FRAME_COUNT) return;
+    RayCounterTransition(cl, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    cl->CopyBufferRegion(s_rayCounterReadback, frame * RAY_COUNTER_BYTES, s_rayCounters, 0, RAY_COUNTER_BYTES);
+    s_rayCounterPending[frame] = true;
+}
+
+void RayCountersCollect12(UINT frame)
+{
+    if (!s_rayCounterReadback || frame >= FRAME_COUNT || !s_rayCounterPending[frame]) return;
+    s_rayCounterPending[frame] = false;
+
+    D3D12_RANGE readRange = { frame * RAY_COUNTER_BYTES, (frame + 1) * RAY_COUNTER_BYTES };
+    BYTE* data = nullptr;
+    if (FAILED(s_rayCounterReadback->Map(0, &readRange, (void**)&data))) return;
+    UINT counts[RAY_TYPE_COUNT];
+    memcpy(counts, data + frame * RAY_COUNTER_BYTES, RAY_COUNTER_BYTES);
+    D3D12_RANGE writeRange = { 0, 0 };
+    s_rayCounterReadback->Unmap(0, &writeRange);
+    RayStatsAddFrame(counts);
+}
+
+void CleanupRayCounters12()
+{
+    if (s_rayCounterReadback) { s_rayCounterReadback->Release(); s_rayCounterReadback = nullptr; }
+    if (s_rayCounterZero) { s_rayCounterZero->Release(); s_rayCounterZero = nullptr; }
+    if (s_rayCounters) { s_rayCounters->Release(); s_rayCounters = nullptr; }
+    memset(s_rayCounterPending, 0, sizeof(s_rayCounterPending));
+    s_rayCounterState = D3D12_RESOURCE_STATE_COMMON;
+}
@@ -0,0 +1,146 @@
+// ============== D3D12 RT MATERIAL / PRIMITIVE TABLES ==============
+// CPU side of the hit lookup used by the PT (megakernel and --wavefront) and
+// DXR 1.0 shaders. Both tables are built once from the geometry the BLASes
+// are built from and uploaded next to it:
+//   Primitives[InstanceID() + PrimitiveIndex()]  object space normal + material index
+//   Materials[material]                          albedo, MAT_*, OBJ_*
+// so a hit costs two structured buffer loads instead of a walk over
+// hard-coded primitive ranges, and any scene that fills the tables works.
+
+#include "../common.h"
+#include "../rt_sampling.h"
+#include "../mesh_file.h"
+#include "d3d12_shared.h"
+
+// Vertex layout shared by PTVert and DXR10Vert (32 bytes, packed)
+struct RTTableVertex {
+    float pos[3];
+    float normal[3];
+    UINT objectID;
+    UINT materialType;
+};
+
+UINT RTTablesAddMaterial12(RTTables12& t, float r, float g, float b, UINT type, UINT objectID)
+{
+    RTMaterial12 m = {};
+    m.albedo[0] = r; m.albedo[1] = g; m.albedo[2] = b;
+    m.type = type;
+    m.objectID = objectID;
+    t.materials.push_back(m);
+    return (UINT)t.materials.size() - 1;
+}
+
+UINT RTTablesAddTriangles12(RTTables12& t, const void* verts, UINT vertexStride, const UINT* inds, UINT indexCount,
+                            UINT (*materialOf)(UINT objectID, UINT materialType))
+{
+    UINT first = (UINT)t.primitives.size();
+    const BYTE* base = (const BYTE*)verts;
+    for (UINT i = 0; i + 2 < indexCount; i += 3) {
+        RTTableVertex v;
+        memcpy(&v, base + (size_t)inds[i] * vertexStride, sizeof(v));
+        RTPrimitive12 p = {};
+        p.normal[0] = v.normal[0]; p.normal[1] = v.normal[1]; p.normal[2] = v.normal[2];
+        p.material = materialOf(v.objectID, v.materialType);
+        if (p.material >= t.materials.size()) {
+            Log("[WARN] RT tables: triangle %u has material %u of %zu, using 0\n",
+                (UINT)t.primitives.size(), p.material, t.materials.size());
+            p.material = 0;
+        }
+        t.primitives.push_back(p);
+    }
+    return first;
+}
+
+bool RTTablesUpload12(RTTables12& t, const char* tag, const MeshFile* mesh, UINT meshMaterial)
+{
+    if (t.materials.empty() || t.primitives.empty()) {
+        Log("[ERROR] %s RT tables are empty\n", tag);
+        return false;
+    }
+    t.meshPrimitives = mesh ? mesh->indexCount / 3 : 0;
+    t.materialBuffer = UploadBuffer12(t.materials.data(), t.materials.size() * sizeof(RTMaterial12), tag);
+    UINT64 bytes = (UINT64)(t.primitives.size() + t.meshPrimitives) * sizeof(RTPrimitive12);
+    RTPrimitive12* dst = (RTPrimitive12*)UploadBufferMap12(bytes, &t.primitiveBuffer, tag);
+    if (!t.materialBuffer || !dst) return false;
+
+    // Mesh faces go from the file mapping straight into the staging buffer
+    memcpy(dst, t.primitives.data(), t.primitives.size() * sizeof(RTPrimitive12));
+    dst += t.primitives.size();
+    for (UINT i = 0; i < t.meshPrimitives; i++) {
+        RTPrimitive12 p = {};
+        MeshFaceNormal(*mesh, i, p.normal);
+        p.material = meshMaterial;
+        dst[i] = p;
+    }
+    Log("[INFO] %s RT tables: %zu materials, %zu primitives\n", tag, t.materials.size(),
+        t.primitives.size() + t.meshPrimitives);
+    return true;
+}
+
+static void CreateStructuredSrv(ID3D12Device* device, ID3D12Resource* buffer, UINT count, UINT stride,
+                                D3D12_CPU_DESCRIPTOR_HANDLE handle)
+{
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Buffer.NumElements = count;
+    srvDesc.Buffer.StructureByteStride = stride;
+    device->CreateShaderResourceView(buffer, &srvDesc, handle);
+}
+
+void RTTablesCreateSrvs12(ID3D12Device* device, const RTTables12& t,
+                          D3D12_CPU_DESCRIPTOR_HANDLE primitives, D3D12_CPU_DESCRIPTOR_HANDLE materials)
+{
+    CreateStructuredSrv(device, t.primitiveBuffer, (UINT)t.primitives.size() + t.meshPrimitives, sizeof(RTPrimitive12), primitives);
+    CreateStructuredSrv(device, t.materialBuffer, (UINT)t.materials.size(), sizeof(RTMaterial12), materials);
+}
+
+void RTTablesRelease12(RTTables12& t)
+{
+    if (t.materialBuffer) { t.materialBuffer->Release(); t.materialBuffer = nullptr; }
+    if (t.primitiveBuffer) { t.primitiveBuffer->Release(); t.primitiveBuffer = nullptr; }
+    t.materials.clear();
+    t.primitives.clear();
+    t.meshPrimitives = 0;
+}
+
+void RTMeshCreateSrvs12(ID3D12Device* device, ID3D12Resource* vb, UINT vertexCount, UINT vertexStride,
+                        ID3D12Resource* ib, UINT indexCount, bool index16,
+                        D3D12_CPU_DESCRIPTOR_HANDLE vertices, D3D12_CPU_DESCRIPTOR_HANDLE indices)
+{
+    CreateStructuredSrv(device, vb, vertexCount, vertexStride, vertices);
+    if (!index16) {
+        CreateStructuredSrv(device, ib, indexCount, sizeof(UINT), indices);
+        return;
+    }
+    // Two indices per 32-bit element, the buffer is padded to an even count
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Buffer.NumElements = (indexCount + 1) / 2;
+    srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
+    device->CreateShaderResourceView(ib, &srvDesc, indices);
+}
+
+ID3D12Resource* RTBlueNoiseUpload12(const char* tag)
+{
+    if (g_rtSampler != RT_SAMPLER_BLUENOISE) return nullptr;
+    const std::vector<uint16_t>& tile = BlueNoiseTile();
+    char name[64];
+    sprintf_s(name, "%s blue noise", tag);
+    return UploadBuffer12(tile.data(), tile.size() * sizeof(uint16_t), name);
+}
+
+void RTBlueNoiseCreateSrv12(ID3D12Device* device, ID3D12Resource* buffer, D3D12_CPU_DESCRIPTOR_HANDLE handle)
+{
+    // Two uint16 ranks per 32-bit element; a null view when the sampler has no tile
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Buffer.NumElements = BLUE_NOISE_SIZE * BLUE_NOISE_SIZE / 2;
+    srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
+    device->CreateShaderResourceView(buffer, &srvDesc, handle);
+}
@@ -0,0 +1,441 @@
+// ============== D3D12 SHADER + PSO CACHE ==============
+// DXC compilation with a persistent DXIL cache, and an ID3D12PipelineLibrary
+// so a warm start skips both DXC and the driver's PSO compile.
+//
+// Layout next to the executable:
+//   shadercache\<key>.dxil          one file per (source, DXC args) pair
+//   shadercache\psolib_<ven>_<dev>.bin  serialized pipeline library per GPU
+// Delete the folder (or run with --no-shader-cache) to force a cold start.
+//
+// CompileDXC and PipelineCacheCreate* may be called from worker threads
+// (async recompile); shared state below is guarded by s_cacheLock.
+
+#include "../common.h"
+#include "../startup_profiler.h"
+#include "d3d12_shared.h"
+#include "renderer_d3d12.h"
+
+#include <d3d12.h>
+#include <d3dcompiler.h>
+#include <dxcapi.h>
+#include <vector>
+
+bool g_shaderCacheEnabled = true;
+
+static SRWLOCK s_cacheLock = SRWLOCK_INIT;  // DXC module load + pipeline library access
+
+#define SHADER_CACHE_MAGIC   0x4C495844u  // 'DXIL'
+#define SHADER_CACHE_VERSION 1u
+
+struct ShaderCacheHeader {
+    UINT32 magic;
+    UINT32 version;
+    UINT64 key;
+    UINT64 size;
+};
+
+// ============== HASHING ==============
+// FNV-1a 64 - fast, stable across runs, good enough for cache keys
+static UINT64 HashBytes(UINT64 h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+static const UINT64 HASH_SEED = 0xCBF29CE484222325ull;
+
+// ============== CACHE DIRECTORY ==============
+static bool GetCacheDir(char* out, size_t size) {
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+    char* slash = strrchr(exePath, '\\');
+    if (slash) *slash = 0;
+    sprintf_s(out, size, "%s\\shadercache", exePath);
+    if (!CreateDirectoryA(out, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) return false;
+    return true;
+}
+
+static bool ReadWholeFile(const char* path, std::vector<char>& data) {
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "rb") != 0 || !f) return false;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len <= 0) { fclose(f); return false; }
+    data.resize((size_t)len);
+    bool ok = fread(data.data(), 1, (size_t)len, f) == (size_t)len;
+    fclose(f);
+    return ok;
+}
+
+// Write to <path>.<tid>.tmp then rename, so a crash never leaves a truncated
+// entry and two threads writing the same key don't share a temp file
+static bool WriteWholeFile(const char* path, const void* header, size_t headerSize,
+                           const void* data, size_t size) {
+    char tmpPath[MAX_PATH];
+    sprintf_s(tmpPath, "%s.%lu.tmp", path, GetCurrentThreadId());
+    FILE* f = nullptr;
+    if (fopen_s(&f, tmpPath, "wb") != 0 || !f) return false;
+    bool ok = true;
+    if (headerSize) ok = fwrite(header, 1, headerSize, f) == headerSize;
+    if (ok) ok = fwrite(data, 1, size, f) == size;
+    fclose(f);
+    if (!ok || !MoveFileExA(tmpPath, path, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+// ============== DXC ==============
+bool LoadDXC()
+{
+    AcquireSRWLockExclusive(&s_cacheLock);
+    bool ok = true;
+    if (!g_DxcCreateInstance) {
+        StartupScope scope("Load DXC");
+        if (!g_dxcModule) g_dxcModule = LoadLibraryW(L"dxcompiler.dll");
+        if (!g_dxcModule) {
+            Log("[ERROR] Failed to load dxcompiler.dll\n");
+            ok = false;
+        } else {
+            g_DxcCreateInstance = (DxcCreateInstanceProc)GetProcAddress(g_dxcModule, "DxcCreateInstance");
+            if (!g_DxcCreateInstance) {
+                Log("[ERROR] DxcCreateInstance not found in dxcompiler.dll\n");
+                FreeLibrary(g_dxcModule);
+                g_dxcModule = nullptr;
+                ok = false;
+            } else {
+                Log("[INFO] DXC loaded\n");
+            }
+        }
+    }
+    ReleaseSRWLockExclusive(&s_cacheLock);
+    return ok;
+}
+
+static UINT64 ShaderKey(const char* source, size_t sourceLen, const wchar_t** args, UINT argCount) {
+    UINT64 h = HashBytes(HASH_SEED, source, sourceLen);
+    for (UINT i = 0; i < argCount; i++) {
+        h = HashBytes(h, args[i], (wcslen(args[i]) + 1) * sizeof(wchar_t));
+    }
+    return h;
+}
+
+static bool LoadCachedDXIL(const char* path, UINT64 key, ID3DBlob** blob) {
+    std::vector<char> data;
+    if (!ReadWholeFile(path, data) || data.size() < sizeof(ShaderCacheHeader)) return false;
+    const ShaderCacheHeader* hdr = (const ShaderCacheHeader*)data.data();
+    if (hdr->magic != SHADER_CACHE_MAGIC || hdr->version != SHADER_CACHE_VERSION || hdr->key != key ||
+        hdr->size != data.size() - sizeof(ShaderCacheHeader)) return false;
+    if (FAILED(D3DCreateBlob((SIZE_T)hdr->size, blob))) return false;
+    memcpy((*blob)->GetBufferPointer(), data.data() + sizeof(ShaderCacheHeader), (size_t)hdr->size);
+    return true;
+}
+
+bool CompileDXC(const char* source, const wchar_t** args, UINT argCount, ID3DBlob** blob, const char* tag)
+{
+    *blob = nullptr;
+    char phase[STARTUP_NAME_LEN];
+    sprintf_s(phase, "Shader %s", tag);
+    StartupScope scope(phase);
+    size_t sourceLen = strlen(source);
+    UINT64 key = ShaderKey(source, sourceLen, args, argCount);
+
+    char cacheDir[MAX_PATH] = {0};
+    char cachePath[MAX_PATH] = {0};
+    bool useCache = g_shaderCacheEnabled && GetCacheDir(cacheDir, sizeof(cacheDir));
+    if (useCache) {
+        sprintf_s(cachePath, "%s\\%016llx.dxil", cacheDir, key);
+        if (LoadCachedDXIL(cachePath, key, blob)) {
+            Log("[INFO] %s: DXIL cache hit (%016llx, %zu bytes)\n", tag, key, (*blob)->GetBufferSize());
+            return true;
+        }
+    }
+
+    if (!LoadDXC()) return false;
+
+    IDxcUtils* utils = nullptr;
+    IDxcCompiler3* compiler = nullptr;
+    g_DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils));
+    g_DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler));
+    if (!utils || !compiler) {
+        Log("[ERROR] %s: failed to create DXC instances\n", tag);
+        if (utils) utils->Release();
+        if (compiler) compiler->Release();
+        return false;
+    }
+
+    DxcBuffer srcBuf = { source, sourceLen, CP_UTF8 };
+    IDxcResult* result = nullptr;
+    HRESULT hr = compiler->Compile(&srcBuf, args, argCount, nullptr, IID_PPV_ARGS(&result));
+
+    HRESULT status = hr;
+    if (SUCCEEDED(hr)) result->GetStatus(&status);
+    if (FAILED(status)) {
+        if (result) {
+            IDxcBlobUtf8* err = nullptr;
+            result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&err), nullptr);
+            if (err) { Log("[SHADER ERROR] %s: %s\n", tag, err->GetStringPointer()); err->Release(); }
+            result->Release();
+        }
+        compiler->Release(); utils->Release();
+        return false;
+    }
+
+    IDxcBlob* dxil = nullptr;
+    result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&dxil), nullptr);
+    bool ok = dxil && SUCCEEDED(D3DCreateBlob(dxil->GetBufferSize(), blob));
+    if (ok) {
+        memcpy((*blob)->GetBufferPointer(), dxil->GetBufferPointer(), dxil->GetBufferSize());
+        Log("[INFO] %s: compiled with DXC (%zu bytes)\n", tag, dxil->GetBufferSize());
+        if (useCache) {
+            ShaderCacheHeader hdr = { SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key, dxil->GetBufferSize() };
+            if (!WriteWholeFile(cachePath, &hdr, sizeof(hdr), dxil->GetBufferPointer(), dxil->GetBufferSize()))
+                Log("[WARN] %s: could not write %s\n", tag, cachePath);
+        }
+    }
+
+    if (dxil) dxil->Release();
+    result->Release(); compiler->Release(); utils->Release();
+    return ok;
+}
+
+// ============== PIPELINE LIBRARY ==============
+// One library per init/cleanup cycle of a renderer. The serialized blob must
+// outlive the library, so it is kept in s_libraryData until close.
+static ID3D12Device* s_libraryDevice = nullptr;
+static ID3D12PipelineLibrary* s_library = nullptr;
+static std::vector<char> s_libraryData;
+static char s_libraryPath[MAX_PATH] = {0};
+static bool s_libraryDirty = false;    // New PSOs stored, serialize on close
+static bool s_libraryStale = false;    // A stored PSO no longer matches, drop the file
+
+void PipelineCacheOpen(ID3D12Device* device)
+{
+    PipelineCacheClose();
+    if (!g_shaderCacheEnabled || !device) return;
+
+    ID3D12Device1* device1 = nullptr;
+    if (FAILED(device->QueryInterface(IID_PPV_ARGS(&device1)))) {
+        Log("[INFO] Pipeline library not supported (no ID3D12Device1)\n");
+        return;
+    }
+
+    // Driver blobs are only valid on the GPU that produced them
+    UINT vendorId = 0, deviceId = 0;
+    if (g_settings.selectedGPU < (int)g_gpuList.size() && g_gpuList[g_settings.selectedGPU].adapter) {
+        DXGI_ADAPTER_DESC1 desc;
+        if (SUCCEEDED(g_gpuList[g_settings.selectedGPU].adapter->GetDesc1(&desc))) {
+            vendorId = desc.VendorId;
+            deviceId = desc.DeviceId;
+        }
+    }
+    char cacheDir[MAX_PATH];
+    if (!GetCacheDir(cacheDir, sizeof(cacheDir))) { device1->Release(); return; }
+    sprintf_s(s_libraryPath, "%s\\psolib_%04x_%04x.bin", cacheDir, vendorId, deviceId);
+
+    HRESULT hr = E_FAIL;
+    if (ReadWholeFile(s_libraryPath, s_libraryData)) {
+        hr = device1->CreatePipelineLibrary(s_libraryData.data(), s_libraryData.size(), IID_PPV_ARGS(&s_library));
+        if (FAILED(hr)) {
+            // Driver update or different adapter - start over
+            Log("[INFO] Pipeline library rejected (0x%08X), rebuilding\n", hr);
+            s_libraryData.clear();
+        }
+    }
+    if (FAILED(hr)) {
+        hr = device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&s_library));
+        if (FAILED(hr)) {
+            LogHR("CreatePipelineLibrary", hr);
+            s_library = nullptr;
+        }
+    } else {
+        Log("[INFO] Pipeline library loaded (%zu bytes)\n", s_libraryData.size());
+    }
+    device1->Release();
+    s_libraryDevice = device;
+}
+
+void PipelineCacheClose()
+{
+    if (s_library && !s_libraryStale && s_libraryDirty) {
+        SIZE_T size = s_library->GetSerializedSize();
+        std::vector<char> data(size);
+        if (size && SUCCEEDED(s_library->Serialize(data.data(), size)) &&
+            WriteWholeFile(s_libraryPath, nullptr, 0, data.data(), size)) {
+            Log("[INFO] Pipeline library saved (%zu bytes)\n", (size_t)size);
+        } else {
+            Log("[WARN] Could not save pipeline library\n");
+        }
+    }
+    if (s_libraryStale && s_libraryPath[0]) DeleteFileA(s_libraryPath);
+
+    if (s_library) { s_library->Release(); s_library = nullptr; }
+    s_libraryData.clear();
+    s_libraryData.shrink_to_fit();
+    s_libraryDevice = nullptr;
+    s_libraryPath[0] = 0;
+    s_libraryDirty = false;
+    s_libraryStale = false;
+}
+
+static void HashShader(UINT64& h, const D3D12_SHADER_BYTECODE& bc) {
+    h = HashBytes(h, &bc.BytecodeLength, sizeof(bc.BytecodeLength));
+    if (bc.pShaderBytecode) h = HashBytes(h, bc.pShaderBytecode, bc.BytecodeLength);
+}
+
+// PSO names include a hash of the shaders and fixed-function state, so a
+// changed shader gets a new entry instead of colliding with the old one
+static void PipelineName(wchar_t* out, size_t count, const wchar_t* label, UINT64 h) {
+    swprintf_s(out, count, L"%s_%016llx", label, h);
+}
+
+// Stale entry (same name, different root signature): build normally and
+// discard the library file at close so the next run rebuilds it
+static HRESULT StoreOrMarkStale(const wchar_t* name, ID3D12PipelineState* pso) {
+    AcquireSRWLockExclusive(&s_cacheLock);
+    HRESULT hr = s_library->StorePipeline(name, pso);
+    if (SUCCEEDED(hr)) s_libraryDirty = true;
+    else if (hr == E_INVALIDARG) s_libraryStale = true;
+    ReleaseSRWLockExclusive(&s_cacheLock);
+    return hr;
+}
+
+HRESULT PipelineCacheCreateGraphics(ID3D12Device* device, const wchar_t* label,
+                                    const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3D12PipelineState** pso)
+{
+    char phase[STARTUP_NAME_LEN];
+    sprintf_s(phase, "PSO %ls", label);
+    StartupScope scope(phase);
+    if (!s_library || device != s_libraryDevice)
+        return device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pso));
+
+    // Hash POD state with pointers cleared, then the data they point to
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC pod = desc;
+    pod.pRootSignature = nullptr;
+    pod.VS.pShaderBytecode = pod.PS.pShaderBytecode = pod.DS.pShaderBytecode = nullptr;
+    pod.HS.pShaderBytecode = pod.GS.pShaderBytecode = nullptr;
+    pod.StreamOutput.pSODeclaration = nullptr;
+    pod.StreamOutput.pBufferStrides = nullptr;
+    pod.InputLayout.pInputElementDescs = nullptr;
+    pod.CachedPSO = {};
+    UINT64 h = HashBytes(HASH_SEED, &pod, sizeof(pod));
+    HashShader(h, desc.VS); HashShader(h, desc.PS); HashShader(h, desc.DS);
+    HashShader(h, desc.HS); HashShader(h, desc.GS);
+    for (UINT i = 0; i < desc.InputLayout.NumElements; i++) {
+        D3D12_INPUT_ELEMENT_DESC e = desc.InputLayout.pInputElementDescs[i];
+        h = HashBytes(h, e.SemanticName, strlen(e.SemanticName));
+        e.SemanticName = nullptr;
+        h = HashBytes(h, &e, sizeof(e));
+    }
+    wchar_t name[128];
+    PipelineName(name, _countof(name), label, h);
+
+    // Loads are serialized too: two threads loading the same name must not race
+    AcquireSRWLockExclusive(&s_cacheLock);
+    HRESULT hr = s_library->LoadGraphicsPipeline(name, &desc, IID_PPV_ARGS(pso));
+    ReleaseSRWLockExclusive(&s_cacheLock);
+    if (SUCCEEDED(hr)) {
+        Log("[INFO] PSO %ls loaded from pipeline library\n", label);
+        return hr;
+    }
+    hr = device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pso));
+    if (SUCCEEDED(hr)) StoreOrMarkStale(name, *pso);
+    return hr;
+}
+
+HRESULT PipelineCacheCreateCompute(ID3D12Device* device, const wchar_t* label,
+                                   const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, ID3D12PipelineState** pso)
+{
+    char phase[STARTUP_NAME_LEN];
+    sprintf_s(phase, "PSO %ls", label);
+    StartupScope scope(phase);
+    if (!s_library || device != s_libraryDevice)
+        return device->CreateComputePipelineState(&desc, IID_PPV_ARGS(pso));
+
+    UINT64 h = HashBytes(HASH_SEED, &desc.NodeMask, sizeof(desc.NodeMask));
+    h = HashBytes(h, &desc.Flags, sizeof(desc.Flags));
+    HashShader(h, desc.CS);
+    wchar_t name[128];
+    PipelineName(name, _countof(name), label, h);
+
+    AcquireSRWLockExclusive(&s_cacheLock);
+    HRESULT hr = s_library->LoadComputePipeline(name, &desc, IID_PPV_ARGS(pso));
+    ReleaseSRWLockExclusive(&s_cacheLock);
+    if (SUCCEEDED(hr)) {
+        Log("[INFO] PSO %ls loaded from pipeline library\n", label);
+        return hr;
+    }
+    hr = device->CreateComputePipelineState(&desc, IID_PPV_ARGS(pso));
+    if (SUCCEEDED(hr)) StoreOrMarkStale(name, *pso);
+    return hr;
+}
+
+// ============== PERMUTATION PRECOMPILE ==============
+// Fills the DXIL cache with every RT feature permutation so a runtime toggle
+// is a file read instead of a DXC run. Workers pull jobs from a shared index.
+static std::vector<ShaderPrecompileJob> s_precompileJobs;
+static volatile LONG s_precompileNext = 0;
+static volatile LONG s_precompileFailed = 0;
+
+static DWORD WINAPI PrecompileWorker(LPVOID) {
+    for (;;) {
+        LONG i = InterlockedIncrement(&s_precompileNext) - 1;
+        if (i >= (LONG)s_precompileJobs.size()) break;
+        const ShaderPrecompileJob& job = s_precompileJobs[i];
+        ID3DBlob* blob = nullptr;
+        if (CompileDXC(job.source.c_str(), job.args.data(), (UINT)job.args.size(), &blob, job.tag)) blob->Release();
+        else InterlockedIncrement(&s_precompileFailed);
+    }
+    return 0;
+}
+
+bool PrecompileD3D12ShaderPermutations()
+{
+    if (!g_shaderCacheEnabled) {
+        Log("[WARN] Shader precompile skipped: --no-shader-cache is set\n");
+        return false;
+    }
+    if (!LoadDXC()) return false;
+
+    s_precompileJobs.clear();
+    AddRTPrecompileJobs(s_precompileJobs);
+    AddDXR10PrecompileJobs(s_precompileJobs);
+    s_precompileNext = 0;
+    s_precompileFailed = 0;
+
+    SYSTEM_INFO si = {};
+    GetSystemInfo(&si);
+    UINT threadCount = si.dwNumberOfProcessors ? si.dwNumberOfProcessors : 1;
+    if (threadCount > MAXIMUM_WAIT_OBJECTS) threadCount = MAXIMUM_WAIT_OBJECTS;
+    if (threadCount > s_precompileJobs.size()) threadCount = (UINT)s_precompileJobs.size();
+    Log("[INFO] Precompiling %zu shader permutations on %u threads...\n", s_precompileJobs.size(), threadCount);
+
+    LARGE_INTEGER freq, t0, t1;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t0);
+
+    HANDLE threads[MAXIMUM_WAIT_OBJECTS] = {};
+    UINT started = 0;
+    for (UINT i = 0; i < threadCount; i++) {
+        threads[started] = CreateThread(nullptr, 0, PrecompileWorker, nullptr, 0, nullptr);
+        if (threads[started]) started++;
+    }
+    if (started == 0) PrecompileWorker(nullptr);  // No threads: compile inline
+    else WaitForMultipleObjects(started, threads, TRUE, INFINITE);
+    for (UINT i = 0; i < started; i++) CloseHandle(threads[i]);
+
+    QueryPerformanceCounter(&t1);
+    double seconds = (double)(t1.QuadPart - t0.QuadPart) / freq.QuadPart;
+    Log("[INFO] Shader precompile done: %zu permutations, %ld failed, %.2f s\n",
+        s_precompileJobs.size(), s_precompileFailed, seconds);
+
+    bool ok = s_precompileFailed == 0;
+    s_precompileJobs.clear();
+    s_precompileJobs.shrink_to_fit();
+    return ok;
+}
@@ -5,10 +5,12 @@
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include "../common.h"
+#include "../frame_latency.h"
+#include "../text_overlay.h"
+#include "../group_tune.h"
 
 // ============== CONSTANTS ==============
 #define FRAME_COUNT 3
-#define MAX_TEXT_VERTS 6000
 
 // ============== D3D12 BASE GLOBALS ==============
 extern bool g_tearingSupported12;
@@ -18,20 +20,15 @@ extern ID3D12CommandQueue* cmdQueue;
 extern ID3D12CommandAllocator* cmdAlloc[3];
 extern ID3D12GraphicsCommandList* cmdList;
 extern IDXGISwapChain3* swap12;
+extern HANDLE swapWaitable12;   // Frame latency waitable object (--max-latency), nullptr when off
 extern ID3D12DescriptorHeap* rtvHeap12;
 extern ID3D12DescriptorHeap* dsvHeap12;
-extern ID3D12DescriptorHeap* srvHeap12;
 extern ID3D12Resource* renderTargets12[3];
 extern ID3D12Resource* depthStencil12;
 extern ID3D12RootSignature* rootSig;
 extern ID3D12PipelineState* pso;
-extern ID3D12PipelineState* textPso;
 extern ID3D12Resource* vb12;
 extern ID3D12Resource* ib12;
-extern ID3D12Resource* cbUpload12;
-extern ID3D12Resource* fontTex12;
-extern ID3D12Resource* textVB12;
-extern ID3D12RootSignature* textRootSig12;
 
 // Synchronization
 extern ID3D12Fence* fence;
@@ -43,15 +40,15 @@ extern UINT rtvDescSize;
 // Buffer views
 extern D3D12_VERTEX_BUFFER_VIEW vbView12;
 extern D3D12_INDEX_BUFFER_VIEW ibView12;
-extern D3D12_VERTEX_BUFFER_VIEW textVbView12;
-
-// Persistent mapped pointers
-extern void* cbMapped12;
-extern void* textVbMapped12;
 
 // Geometry counts
 extern UINT totalIndices12;
 extern UINT totalVertices12;
+// Layout of vb12 / ib12 as the PT uploaded them (rt_geometry.h)
+extern UINT vbStride12;
+extern bool ib16Bit12;
+// --sampler=bluenoise tile the PT uploaded (nullptr otherwise), bound by DLSS too
+extern ID3D12Resource* blueNoise12;
 
 // ============== DXR FEATURE FLAGS ==============
 // Each feature can be toggled independently
@@ -189,16 +186,12 @@ extern ID3D12PipelineState* pathTracePSO;
 extern ID3D12RootSignature* denoiseRootSig;
 extern ID3D12PipelineState* denoisePSO;
 extern ID3D12DescriptorHeap* pathTraceSrvUavHeap;
-extern ID3D12Resource* pathTraceCB;
-extern ID3D12Resource* denoiseCB;
-extern void* pathTraceCBMapped;
-extern void* denoiseCBMapped;
 extern UINT g_frameCount;
 
-// Denoise modes
+// Denoise modes (D3D12 PT, N cycles them)
 enum DenoiseMode { DENOISE_OFF, DENOISE_ATROUS, DENOISE_TEMPORAL };
 extern DenoiseMode g_denoiseMode;
-extern UINT g_temporalFrameCount;
+extern UINT g_temporalFrameCount;   // Frames in the temporal history, 0 = reset on next use
 
 // ============== DLSS GLOBALS ==============
 struct NVSDK_NGX_Handle;
@@ -215,25 +208,282 @@ extern ID3D12Resource* g_gbufferDepth;
 extern ID3D12Resource* g_dlssOutput;
 extern ID3D12DescriptorHeap* g_gbufferHeap;
 
-// ============== TEXT RENDERING ==============
-// MAX_TEXT_VERTS is defined as 6000 above
-extern TextVert g_textVerts[MAX_TEXT_VERTS];
-extern UINT g_textVertCount;
+// ============== TEXT OVERLAY ==============
+// Instanced glyph overlay (text_overlay.h) on any D3D12 device. The instance
+// buffer is UPLOAD memory with one slice per frame in flight; a slice is only
+// rewritten when its version lags the overlay's, i.e. after a text change.
+// --bundles: each slice also has a bundle (PSO, topology, VB, draw) that is
+// re-recorded only when the slice's glyph count changed; the caller's list
+// sets the root signature and the 1 / size constants, which the bundle inherits.
+struct Overlay12 {
+    ID3D12RootSignature* rootSig = nullptr;     // 4 root constants (b0, vertex)
+    ID3D12PipelineState* pso = nullptr;
+    ID3D12Resource* instances = nullptr;        // FRAME_COUNT x OVERLAY_MAX_INSTANCES
+    GlyphInstance* mapped = nullptr;
+    UINT sliceVersion[FRAME_COUNT] = {};
+    ID3D12CommandAllocator* bundleAlloc[FRAME_COUNT] = {};
+    ID3D12GraphicsCommandList* bundle[FRAME_COUNT] = {};
+    UINT bundleCount[FRAME_COUNT] = {};         // Glyphs the slice's bundle draws, 0 = not recorded
+    TextOverlay text;
+};
+
+// Shared by base, PT and DLSS renderers (on dev12); RT and DXR 1.0 own theirs
+extern Overlay12 g_overlay12;
 extern int g_cachedFps;
 extern bool g_textNeedsRebuild;
 
+// ============== GPU TIMESTAMP PROFILER ==============
+// Timestamp query heap with one slot range per frame in flight.
+// Results are resolved into a readback buffer and collected FRAME_COUNT
+// frames later, when MoveToNextFrame has already waited on that slot.
+#define GPU_TIMER_MAX_STAMPS 16
+
+extern ID3D12QueryHeap* g_timerQueryHeap12;
+extern ID3D12Resource* g_timerReadback12;
+
 // ============== DXC SHADER COMPILER ==============
 typedef HRESULT(WINAPI* DxcCreateInstanceProc)(REFCLSID, REFIID, LPVOID*);
 extern HMODULE g_dxcModule;
 extern DxcCreateInstanceProc g_DxcCreateInstance;
 
+// ============== SHADER + PSO CACHE (defined in d3d12_shader_cache.cpp) ==============
+// DXIL is cached in shadercache\ next to the exe, keyed by a hash of the source
+// and the full DXC argument list (entry, target, -D feature defines).
+// PSOs go through an ID3D12PipelineLibrary that is opened at renderer init and
+// serialized at cleanup. --no-shader-cache clears g_shaderCacheEnabled (common.h).
+bool LoadDXC();  // Loads dxcompiler.dll into g_dxcModule on first use
+bool CompileDXC(const char* source, const wchar_t** args, UINT argCount, ID3DBlob** blob, const char* tag);
+void PipelineCacheOpen(ID3D12Device* device);
+void PipelineCacheClose();
+HRESULT PipelineCacheCreateGraphics(ID3D12Device* device, const wchar_t* label,
+                                    const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3D12PipelineState** pso);
+HRESULT PipelineCacheCreateCompute(ID3D12Device* device, const wchar_t* label,
+                                   const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, ID3D12PipelineState** pso);
+
+// One DXC invocation for PrecompileD3D12ShaderPermutations (renderer_d3d12.h).
+// Args must match what the renderer passes at runtime so the DXIL cache key is
+// identical; they point at string literals only.
+struct ShaderPrecompileJob {
+    std::string source;
+    std::vector<const wchar_t*> args;
+    const char* tag;
+};
+void AddRTPrecompileJobs(std::vector<ShaderPrecompileJob>& jobs);     // renderer_d3d12_rt.cpp
+void AddDXR10PrecompileJobs(std::vector<ShaderPrecompileJob>& jobs);  // renderer_d3d12_dxr10.cpp
+
 // ============== SHARED HELPER FUNCTIONS ==============
 void WaitForGpu();
 void MoveToNextFrame();
-void DrawText12(const char* text, float x, float y, float r, float g, float b, float a, float scale);
-void DrawTextDirect(const char* text, float x, float y, float r, float g, float b, float a, float scale);
-bool LoadDXC();
-bool InitGPUText12();  // Text rendering init - shared by base, PT, and DLSS renderers
+bool ResizeSwapChain12();  // ResizeBuffers + RTVs + depth for the current W x H (base, PT, DLSS)
+UINT64 ResourceBytes12(ID3D12Resource* resource);  // Allocation size as placed by the device, 0 for nullptr
+
+// Text overlay (defined in d3d12_overlay.cpp). Overlay12Draw updates the
+// frame's instance slice if stale and draws with the render target already
+// bound; it sets its own viewport and scissor to width x height.
+bool Overlay12Init(Overlay12& overlay, ID3D12Device* device, DXGI_FORMAT rtvFormat, const char* tag);
+void Overlay12Draw(Overlay12& overlay, ID3D12GraphicsCommandList* cl, UINT frame, UINT width, UINT height);
+void Overlay12Cleanup(Overlay12& overlay);
+
+// GPU timestamps (defined in renderer_d3d12.cpp)
+bool InitGpuTimer12(ID3D12Device* device, ID3D12CommandQueue* queue);
+void GpuTimerCollect12(UINT frame);        // Read results of the last frame recorded in this slot (no wait)
+double GpuTimerLastFrameMs12();            // First to last stamp of the latest collected frame, 0 = none yet
+void GpuTimerBegin12(ID3D12GraphicsCommandList* cl, UINT frame);
+void GpuTimerStamp12(ID3D12GraphicsCommandList* cl, UINT frame, const char* passName);  // Ends the named pass
+void GpuTimerEnd12(ID3D12GraphicsCommandList* cl, UINT frame);   // Resolve into readback buffer
+void CleanupGpuTimer12();
+
+// GPU-driven culling for --cubes=N --gpu-culling (defined in d3d12_gpu_cull.cpp)
+bool InitGpuCull12(ID3D12Resource* instances, UINT instanceCount, UINT indexCount);
+bool ResizeGpuCull12();    // Rebuild Hi-Z after ResizeSwapChain12
+void GpuCullRender12(ID3D12GraphicsCommandList* cl, ID3D12PipelineState* scenePso, float time, float aspect);
+UINT GpuCullVisibleCount12();  // Instances drawn FRAME_COUNT frames ago
+void CleanupGpuCull12();
+
+// Amplification + mesh shader cubes for --mesh-shaders (defined in d3d12_mesh_shader.cpp)
+bool MeshShadersSupported12();              // Mesh shader tier 1 + shader model 6.5 on dev12
+bool InitMeshShaders12(UINT instanceCount); // 0 = the classic 8-cube scene; records on cmdList
+void MeshShaderRender12(float time, float aspect);
+void MeshShaderStats12(UINT& visibleMeshlets, UINT& totalMeshlets, UINT& visibleTriangles);  // FRAME_COUNT frames ago
+void CleanupMeshShaders12();
+
+// Static geometry upload through a COPY queue (defined in d3d12_upload.cpp)
+// UploadBegin12 -> any number of UploadBuffer12 -> UploadFlush12 (one fence, one wait).
+// Returned buffers are DEFAULT heap, state COMMON, owned by the caller.
+bool UploadBegin12(ID3D12Device* device);
+ID3D12Resource* UploadBuffer12(const void* data, UINT64 size, const char* tag);
+// Same, but hands back the staging memory for the caller to fill before
+// UploadFlush12 (data derived while streaming, e.g. --mesh face records).
+// nullptr on failure, *buffer is then nullptr too.
+void* UploadBufferMap12(UINT64 size, ID3D12Resource** buffer, const char* tag);
+bool UploadFlush12();
+
+// Per-frame upload ring for constant buffers (defined in d3d12_frame_ring.cpp)
+// Allocate while recording, FrameRingRetire12(value) right before the queue
+// Signal(value) that ends the frame, FrameRingReclaim12(completed) after the
+// frame-slot wait. Alloc blocks on the oldest frame only if the ring is full.
+// g_frameRing12 belongs to the shared dev12/fence (base, PT, DLSS);
+// the RT and DXR 1.0 renderers keep their own ring for their own device.
+#define FRAME_RING_SIZE (1024 * 1024)
+#define FRAME_RING_MAX_PENDING 8
+
+struct FrameAlloc12 {
+    void* cpu;
+    D3D12_GPU_VIRTUAL_ADDRESS gpu;
+};
+
+struct FrameRing12 {
+    ID3D12Resource* buffer = nullptr;
+    BYTE* cpu = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS gpu = 0;
+    UINT64 size = 0;
+    UINT64 head = 0;    // Monotonic byte counters, offset = counter % size
+    UINT64 tail = 0;
+    struct { UINT64 fenceValue; UINT64 head; } pending[FRAME_RING_MAX_PENDING] = {};
+    UINT pendingFirst = 0;
+    UINT pendingCount = 0;
+    ID3D12Fence* fence = nullptr;  // Not owned
+    HANDLE event = nullptr;
+    const char* tag = "";
+    bool warnedFull = false;
+};
+
+extern FrameRing12 g_frameRing12;
+
+bool InitFrameRing12(FrameRing12& ring, ID3D12Device* device, ID3D12Fence* fence, UINT64 size, const char* tag);
+void CleanupFrameRing12(FrameRing12& ring);
+bool FrameRingAlloc12(FrameRing12& ring, UINT64 size, UINT64 align, FrameAlloc12& out);
+D3D12_GPU_VIRTUAL_ADDRESS FrameRingPush12(FrameRing12& ring, const void* data, UINT64 size, UINT64 align);  // 0 on overflow
+void FrameRingRetire12(FrameRing12& ring, UINT64 fenceValue);
+void FrameRingReclaim12(FrameRing12& ring, UINT64 completedValue);
+
+// TLAS refit / rebuild (defined in d3d12_tlas.cpp, policy in tlas_policy.h)
+// Every TLAS build (init and per frame) uses the same flags, or PERFORM_UPDATE is invalid.
+// Instance descs for the per-frame update go through a frame ring so the CPU
+// never rewrites descs an in-flight build still reads.
+#define TLAS_BUILD_FLAGS12 (D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | \
+                            D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE)
+struct TlasPolicy;
+void TlasInputs12(D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS& inputs, UINT count, D3D12_GPU_VIRTUAL_ADDRESS instanceGpu);
+UINT64 TlasScratchSize12(const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO& prebuild);  // Build and update
+// Copies count descs into the ring (fallbackGpu if it is full) and records an
+// in-place refit or a full build of tlas + UAV barrier
+void TlasUpdate12(ID3D12GraphicsCommandList4* cl, FrameRing12& ring, TlasPolicy& policy, ID3D12Resource* tlas,
+                  ID3D12Resource* scratch, const D3D12_RAYTRACING_INSTANCE_DESC* instances, UINT count,
+                  D3D12_GPU_VIRTUAL_ADDRESS fallbackGpu);
+
+// Static BLAS compaction (defined in d3d12_blas.cpp)
+// Build static BLASes with BLAS_STATIC_FLAGS12, record their UAV barriers, then
+// call CompactBLAS12 before any instance desc takes their addresses. It executes
+// cl on queue and waits, replaces each *blas[i] by a compacted copy and returns
+// with cl reset on alloc and open. false: cl could not be executed, the builds
+// are still pending in it (nothing compacted); true: the queue is idle, so the
+// build scratch can be released.
+#define BLAS_STATIC_FLAGS12 (D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | \
+                             D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION)
+bool CompactBLAS12(ID3D12Device5* device, ID3D12CommandQueue* queue, ID3D12CommandAllocator* alloc,
+                   ID3D12GraphicsCommandList4* cl, ID3D12Resource** blas[], UINT count, const char* tag);
+
+// Init-time GPU timing for the startup profiler (defined in d3d12_startup_timer.cpp)
+// StartupGpuBegin12 after the list is opened, StartupGpuEnd12 before its last
+// Close; the lists in between may be executed and reset on the same queue
+// (CompactBLAS12). StartupGpuCollect12 after the final wait adds the duration
+// as a GPU leaf of the open startup phase and releases the queries.
+struct StartupGpuTimer12 {
+    ID3D12QueryHeap* heap;
+    ID3D12Resource* readback;
+    UINT64 frequency;
+    bool recorded;
+};
+bool StartupGpuBegin12(StartupGpuTimer12& timer, ID3D12Device* device, ID3D12CommandQueue* queue,
+                       ID3D12GraphicsCommandList* cl);
+void StartupGpuEnd12(StartupGpuTimer12& timer, ID3D12GraphicsCommandList* cl);
+void StartupGpuCollect12(StartupGpuTimer12& timer, const char* name);
+
+// Ray tracing material / primitive tables (defined in d3d12_rt_tables.cpp)
+// Hit shading looks the surface up instead of decoding primitive ranges:
+//   RTPrimitive p = Primitives[InstanceID() + PrimitiveIndex()];
+//   RTMaterial m = Materials[p.material];
+// Each TLAS instance's InstanceID is the first table entry of its BLAS's
+// triangles (RTTablesAddTriangles12 returns it). The BLASes hold a single
+// geometry, so GeometryIndex() is always 0 and needs no offset of its own.
+struct RTMaterial12 {
+    float albedo[3];
+    UINT type;          // MAT_* of the shader
+    UINT objectID;      // OBJ_* of the shader
+    UINT pad[3];
+};
+static_assert(sizeof(RTMaterial12) == 32, "RTMaterial12 must match the HLSL Material struct");
+
+struct RTPrimitive12 {
+    float normal[3];    // Object space face normal
+    UINT material;      // Index into the material table
+};
+static_assert(sizeof(RTPrimitive12) == 16, "RTPrimitive12 must match the HLSL Primitive struct");
+
+struct RTTables12 {
+    std::vector<RTMaterial12> materials;
+    std::vector<RTPrimitive12> primitives;
+    ID3D12Resource* materialBuffer = nullptr;   // DEFAULT heap, COMMON (d3d12_upload.cpp)
+    ID3D12Resource* primitiveBuffer = nullptr;
+    UINT meshPrimitives = 0;    // --mesh faces after primitives (RTTablesUpload12)
+};
+
+UINT RTTablesAddMaterial12(RTTables12& t, float r, float g, float b, UINT type, UINT objectID);
+// verts: 32-byte pos / normal / objectID / materialType vertices (PTVert, DXR10Vert).
+// One entry per triangle with its first vertex's normal and materialOf(IDs).
+UINT RTTablesAddTriangles12(RTTables12& t, const void* verts, UINT vertexStride, const UINT* inds, UINT indexCount,
+                            UINT (*materialOf)(UINT objectID, UINT materialType));
+// Between UploadBegin12 and UploadFlush12. mesh (mesh_file.h): one entry per
+// face after t.primitives, all with material meshMaterial.
+struct MeshFile;
+bool RTTablesUpload12(RTTables12& t, const char* tag, const MeshFile* mesh = nullptr, UINT meshMaterial = 0);
+void RTTablesCreateSrvs12(ID3D12Device* device, const RTTables12& t,
+                          D3D12_CPU_DESCRIPTOR_HANDLE primitives, D3D12_CPU_DESCRIPTOR_HANDLE materials);
+void RTTablesRelease12(RTTables12& t);
+// Vertices (t1) / Indices (t2) views of a BLAS input mesh: structured vertices
+// of the given stride, and structured uint or (16-bit, --compact-verts) raw indices
+void RTMeshCreateSrvs12(ID3D12Device* device, ID3D12Resource* vb, UINT vertexCount, UINT vertexStride,
+                        ID3D12Resource* ib, UINT indexCount, bool index16,
+                        D3D12_CPU_DESCRIPTOR_HANDLE vertices, D3D12_CPU_DESCRIPTOR_HANDLE indices);
+// --sampler=bluenoise tile (rt_sampling.h), t0 space1 of the RT / PT shaders.
+// Upload returns nullptr for the other samplers (between UploadBegin12 and
+// UploadFlush12); the SRV of a null buffer is a null view.
+ID3D12Resource* RTBlueNoiseUpload12(const char* tag);
+void RTBlueNoiseCreateSrv12(ID3D12Device* device, ID3D12Resource* buffer, D3D12_CPU_DESCRIPTOR_HANDLE handle);
+
+// --ray-stats counters (defined in d3d12_ray_stats.cpp): zeroed by Begin, bound
+// as root UAV u0 space2 (RayCountersAddress12) while tracing, copied to the
+// frame's readback slot by End and reported to ray_stats.h by Collect (frame
+// start, after the fence wait). Init does nothing without --ray-stats.
+bool InitRayCounters12(ID3D12Device* device);
+void RayCountersBegin12(ID3D12GraphicsCommandList* cl);
+D3D12_GPU_VIRTUAL_ADDRESS RayCountersAddress12();   // 0 = not active
+void RayCountersEnd12(ID3D12GraphicsCommandList* cl, UINT frame);
+void RayCountersCollect12(UINT frame);
+void CleanupRayCounters12();
+
+// --capture frames (defined in d3d12_capture.cpp, see frame_capture.h): Record
+// copies image (in state, returned to it) into a readback slot when frameNumber
+// is due, Collect hands the slot of frame to the encoder after its fence wait
+// (frame start). Cleanup after WaitForGpu (resize, renderer cleanup): encodes
+// what is still pending and releases the readback buffers.
+void Capture12Record(ID3D12GraphicsCommandList* cl, ID3D12Resource* image, D3D12_RESOURCE_STATES state,
+                     UINT frame, UINT frameNumber, const char* tag);
+void Capture12Collect(UINT frame);
+void CleanupCapture12();
+
+// --group-size variants (defined in d3d12_group_tune.cpp, see group_tune.h).
+// Begin asks the device which wave sizes SM 6.6 can force and starts the
+// kernel's tuner. CreateVariants compiles the extra variants of mask from the
+// kernel's runtime source + args (the -T target becomes cs_6_6 for wave
+// variants) into psos[]; psos[GROUP_VARIANT_DEFAULT] is the renderer's own
+// PSO. A variant that fails is dropped. Release skips the default slot.
+UINT GroupTuneBegin12(ID3D12Device* device, GroupKernel kernel);
+void GroupCreateVariants12(ID3D12Device* device, GroupKernel kernel, UINT mask, const char* source,
+                           const wchar_t** args, UINT argCount, ID3D12RootSignature* rootSig,
+                           ID3D12PipelineState* defaultPSO, ID3D12PipelineState** psos);
+void GroupReleaseVariants12(ID3D12PipelineState** psos);
 
 // DXR support check (defined in renderer_d3d12_rt.cpp)
 bool CheckDXRSupport(struct IDXGIAdapter1* adapter);
@@ -242,3 +492,5 @@ bool CheckDXRSupport(struct IDXGIAdapter1* adapter);
 // Used by DLSS renderer to update cube transform and rebuild TLAS
 void UpdateCubeTransformPT(float time);
 void RebuildTLAS_PT(ID3D12GraphicsCommandList4* cmdListRT);
+// VRAM breakdown of the path tracer's resources (VramCategoryFn); DLSS adds its own on top
+void VramCategoriesPT(UINT64* bytes);
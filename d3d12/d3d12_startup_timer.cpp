@@ -0,0 +1,64 @@
+// ============== D3D12 STARTUP GPU TIMER ==============
+// One timestamp before the first init-time command and one after the last,
+// resolved by the final list into a readback buffer (see d3d12_shared.h).
+// Only used while a renderer initializes, so each timer owns its query heap.
+
+#include "../common.h"
+#include "../startup_profiler.h"
+#include "d3d12_shared.h"
+
+bool StartupGpuBegin12(StartupGpuTimer12& timer, ID3D12Device* device, ID3D12CommandQueue* queue,
+                       ID3D12GraphicsCommandList* cl)
+{
+    timer = {};
+    if (FAILED(queue->GetTimestampFrequency(&timer.frequency)) || timer.frequency == 0) return false;
+
+    D3D12_QUERY_HEAP_DESC heapDesc = {};
+    heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    heapDesc.Count = 2;
+    HRESULT hr = device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&timer.heap));
+    if (FAILED(hr)) { LogHR("Startup timer CreateQueryHeap", hr); timer = {}; return false; }
+
+    D3D12_HEAP_PROPERTIES readbackHeap = { D3D12_HEAP_TYPE_READBACK };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = 2 * sizeof(UINT64);
+    desc.Height = 1; desc.DepthOrArraySize = 1; desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    hr = device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&timer.readback));
+    if (FAILED(hr)) {
+        LogHR("Startup timer readback", hr);
+        timer.heap->Release();
+        timer = {};
+        return false;
+    }
+
+    cl->EndQuery(timer.heap, D3D12_QUERY_TYPE_TIMESTAMP, 0);
+    return true;
+}
+
+void StartupGpuEnd12(StartupGpuTimer12& timer, ID3D12GraphicsCommandList* cl)
+{
+    if (!timer.heap) return;
+    cl->EndQuery(timer.heap, D3D12_QUERY_TYPE_TIMESTAMP, 1);
+    cl->ResolveQueryData(timer.heap, D3D12_QUERY_TYPE_TIMESTAMP, 0, 2, timer.readback, 0);
+    timer.recorded = true;
+}
+
+void StartupGpuCollect12(StartupGpuTimer12& timer, const char* name)
+{
+    if (timer.recorded) {
+        UINT64* ticks = nullptr;
+        D3D12_RANGE readRange = { 0, 2 * sizeof(UINT64) };
+        if (SUCCEEDED(timer.readback->Map(0, &readRange, (void**)&ticks))) {
+            if (ticks[1] > ticks[0])
+                StartupAddGpuTime(name, (double)(ticks[1] - ticks[0]) * 1000.0 / timer.frequency);
+            D3D12_RANGE noWrite = { 0, 0 };
+            timer.readback->Unmap(0, &noWrite);
+        }
+    }
+    if (timer.readback) timer.readback->Release();
+    if (timer.heap) timer.heap->Release();
+    timer = {};
+}
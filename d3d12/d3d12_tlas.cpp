@@ -0,0 +1,57 @@
+// ============== D3D12 TLAS UPDATE ==============
+// Per-frame TLAS refit / rebuild shared by the PT, PT + DLSS, DXR 1.1 and
+// DXR 1.0 renderers. Each keeps a single TLAS updated in place on its direct
+// queue; tlas_policy.h decides when the refit is replaced by a full build.
+//
+// There is no async-compute build here: overlapping frame N+1's build with
+// frame N's trace needs a TLAS per frame slot, and all four renderers bind
+// the TLAS as t0 at the start of descriptor tables that are shared by every
+// frame (and, in PT, by the wavefront, DLSS G-buffer and split-GPU kernels).
+// The update is recorded before the trace on the same list, so the trace
+// sees it without a cross-queue fence. The only overlapped TLAS update is
+// Vulkan RQ's with --async-compute (vk_tlas.h).
+
+#include "../common.h"
+#include "d3d12_shared.h"
+#include "../tlas_policy.h"
+
+void TlasInputs12(D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS& inputs, UINT count, D3D12_GPU_VIRTUAL_ADDRESS instanceGpu)
+{
+    inputs = {};
+    inputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
+    inputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
+    inputs.NumDescs = count;
+    inputs.InstanceDescs = instanceGpu;
+    inputs.Flags = TLAS_BUILD_FLAGS12;
+}
+
+UINT64 TlasScratchSize12(const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO& prebuild)
+{
+    return max(prebuild.ScratchDataSizeInBytes, prebuild.UpdateScratchDataSizeInBytes);
+}
+
+void TlasUpdate12(ID3D12GraphicsCommandList4* cl, FrameRing12& ring, TlasPolicy& policy, ID3D12Resource* tlas,
+                  ID3D12Resource* scratch, const D3D12_RAYTRACING_INSTANCE_DESC* instances, UINT count,
+                  D3D12_GPU_VIRTUAL_ADDRESS fallbackGpu)
+{
+    D3D12_GPU_VIRTUAL_ADDRESS instanceGpu = FrameRingPush12(ring, instances, count * sizeof(D3D12_RAYTRACING_INSTANCE_DESC),
+                                                            D3D12_RAYTRACING_INSTANCE_DESCS_BYTE_ALIGNMENT);
+    if (!instanceGpu) instanceGpu = fallbackGpu;
+
+    bool rebuild = TlasPolicyDecide(policy, instances, count, sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
+
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC buildDesc = {};
+    TlasInputs12(buildDesc.Inputs, count, instanceGpu);
+    if (!rebuild) {
+        buildDesc.Inputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+        buildDesc.SourceAccelerationStructureData = tlas->GetGPUVirtualAddress();  // Refit in place
+    }
+    buildDesc.DestAccelerationStructureData = tlas->GetGPUVirtualAddress();
+    buildDesc.ScratchAccelerationStructureData = scratch->GetGPUVirtualAddress();
+    cl->BuildRaytracingAccelerationStructure(&buildDesc, 0, nullptr);
+
+    D3D12_RESOURCE_BARRIER uavBarrier = {};
+    uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    uavBarrier.UAV.pResource = tlas;
+    cl->ResourceBarrier(1, &uavBarrier);
+}
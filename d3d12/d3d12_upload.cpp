@@ -0,0 +1,136 @@
+// ============== D3D12 STATIC GEOMETRY UPLOAD ==============
+// Init-time uploads of vertex/index/instance buffers into DEFAULT heap memory.
+// Each UploadBuffer12 call stages its data in an upload-heap buffer and records
+// a CopyBufferRegion on a dedicated COPY queue; UploadFlush12 submits the whole
+// batch behind a single fence and waits once.
+//
+// Buffers are created in COMMON. The copy promotes them to COPY_DEST and they
+// decay back to COMMON when the copy queue finishes, so the direct queue can
+// use them as VB/IB, SRV or BLAS input through implicit promotion - no barriers.
+
+#include "../common.h"
+#include "../startup_profiler.h"
+#include "d3d12_shared.h"
+
+// ============== UPLOAD GLOBALS ==============
+static ID3D12Device* s_uploadDevice = nullptr;
+static ID3D12CommandQueue* s_copyQueue = nullptr;
+static ID3D12CommandAllocator* s_copyAlloc = nullptr;
+static ID3D12GraphicsCommandList* s_copyList = nullptr;
+static ID3D12Fence* s_copyFence = nullptr;
+static HANDLE s_copyEvent = nullptr;
+static UINT64 s_copyFenceValue = 0;
+static std::vector<ID3D12Resource*> s_staging;   // Freed by UploadFlush12
+static UINT64 s_pendingBytes = 0;
+
+static void ReleaseUploadObjects()
+{
+    for (ID3D12Resource* r : s_staging) r->Release();
+    s_staging.clear();
+    s_pendingBytes = 0;
+    if (s_copyList) { s_copyList->Release(); s_copyList = nullptr; }
+    if (s_copyAlloc) { s_copyAlloc->Release(); s_copyAlloc = nullptr; }
+    if (s_copyQueue) { s_copyQueue->Release(); s_copyQueue = nullptr; }
+    if (s_copyFence) { s_copyFence->Release(); s_copyFence = nullptr; }
+    if (s_copyEvent) { CloseHandle(s_copyEvent); s_copyEvent = nullptr; }
+    s_uploadDevice = nullptr;
+}
+
+static D3D12_RESOURCE_DESC BufferDesc(UINT64 size)
+{
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = size; desc.Height = 1; desc.DepthOrArraySize = 1; desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    return desc;
+}
+
+// ============== BEGIN / UPLOAD / FLUSH ==============
+bool UploadBegin12(ID3D12Device* device)
+{
+    if (s_uploadDevice) {
+        Log("[WARN] UploadBegin12: previous batch was never flushed, flushing now\n");
+        if (!UploadFlush12()) return false;
+    }
+    s_uploadDevice = device;
+
+    D3D12_COMMAND_QUEUE_DESC qDesc = {};
+    qDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+    HRESULT hr = device->CreateCommandQueue(&qDesc, IID_PPV_ARGS(&s_copyQueue));
+    if (FAILED(hr)) { LogHR("CreateCommandQueue(COPY)", hr); ReleaseUploadObjects(); return false; }
+    hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&s_copyAlloc));
+    if (FAILED(hr)) { LogHR("CreateCommandAllocator(COPY)", hr); ReleaseUploadObjects(); return false; }
+    hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, s_copyAlloc, nullptr, IID_PPV_ARGS(&s_copyList));
+    if (FAILED(hr)) { LogHR("CreateCommandList(COPY)", hr); ReleaseUploadObjects(); return false; }
+    hr = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&s_copyFence));
+    if (FAILED(hr)) { LogHR("CreateFence(COPY)", hr); ReleaseUploadObjects(); return false; }
+    s_copyEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!s_copyEvent) { Log("[ERROR] UploadBegin12: CreateEvent failed\n"); ReleaseUploadObjects(); return false; }
+    s_copyFenceValue = 0;
+    return true;
+}
+
+void* UploadBufferMap12(UINT64 size, ID3D12Resource** buffer, const char* tag)
+{
+    *buffer = nullptr;
+    if (!s_copyList) { Log("[ERROR] UploadBuffer12(%s) called outside UploadBegin12/UploadFlush12\n", tag); return nullptr; }
+
+    D3D12_RESOURCE_DESC desc = BufferDesc(size);
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
+
+    ID3D12Resource* dst = nullptr;
+    HRESULT hr = s_uploadDevice->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&dst));
+    if (FAILED(hr)) { Log("[ERROR] UploadBuffer12(%s): ", tag); LogHR("CreateCommittedResource(DEFAULT)", hr); return nullptr; }
+
+    ID3D12Resource* staging = nullptr;
+    hr = s_uploadDevice->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&staging));
+    if (FAILED(hr)) { Log("[ERROR] UploadBuffer12(%s): ", tag); LogHR("CreateCommittedResource(UPLOAD)", hr); dst->Release(); return nullptr; }
+
+    // Stays mapped until UploadFlush12 releases it (upload heaps allow that)
+    void* mapped = nullptr;
+    D3D12_RANGE noRead = { 0, 0 };
+    hr = staging->Map(0, &noRead, &mapped);
+    if (FAILED(hr)) { Log("[ERROR] UploadBuffer12(%s): ", tag); LogHR("Map(UPLOAD)", hr); staging->Release(); dst->Release(); return nullptr; }
+
+    s_copyList->CopyBufferRegion(dst, 0, staging, 0, size);
+    s_staging.push_back(staging);
+    s_pendingBytes += size;
+    *buffer = dst;
+    return mapped;
+}
+
+ID3D12Resource* UploadBuffer12(const void* data, UINT64 size, const char* tag)
+{
+    ID3D12Resource* dst = nullptr;
+    void* mapped = UploadBufferMap12(size, &dst, tag);
+    if (mapped) memcpy(mapped, data, (size_t)size);
+    return dst;
+}
+
+bool UploadFlush12()
+{
+    if (!s_copyList) return true;
+    StartupScope scope("Upload flush");
+
+    bool ok = true;
+    UINT count = (UINT)s_staging.size();
+    HRESULT hr = s_copyList->Close();
+    if (FAILED(hr)) { LogHR("CopyList Close", hr); ok = false; }
+
+    if (ok && count > 0) {
+        ID3D12CommandList* lists[] = { s_copyList };
+        s_copyQueue->ExecuteCommandLists(1, lists);
+        s_copyQueue->Signal(s_copyFence, ++s_copyFenceValue);
+        if (s_copyFence->GetCompletedValue() < s_copyFenceValue) {
+            s_copyFence->SetEventOnCompletion(s_copyFenceValue, s_copyEvent);
+            WaitForSingleObject(s_copyEvent, INFINITE);
+        }
+        Log("[INFO] Uploaded %u static buffers (%.1f KB) via copy queue\n", count, s_pendingBytes / 1024.0);
+    }
+
+    ReleaseUploadObjects();
+    return ok;
+}
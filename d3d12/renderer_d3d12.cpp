@@ -5,6 +5,14 @@
 #include "d3d12_shared.h"
 #include "renderer_d3d12.h"
 #include "../shaders/d3d11_shaders.h"
+#include "../gpu_profiler.h"
+#include "../benchmark.h"
+#include "../mesh_file.h"
+#include "../cube_geometry.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "../offscreen.h"
+#include "../group_tune.h"
 
 #include <d3d12.h>
 #include <dxgi1_6.h>
@@ -19,457 +27,464 @@
 using namespace DirectX;
 
 // ============== LOCAL STRUCTS ==============
-struct Vert {
-    XMFLOAT3 p, n;
-    UINT cubeID;
-};
-
 struct CB {
     float time;
-    float _pad[3];
+    float aspect;   // W / H for the cube projection
+    float _pad[2];
 };
 
-// ============== GEOMETRY GENERATION ==============
-static void GenRoundedFace(float size, int seg, XMFLOAT3 offset, int faceIdx,
-    float edgeRadius[4], UINT cubeID, std::vector<Vert>& verts, std::vector<UINT>& inds)
-{
-    UINT base = (UINT)verts.size();
-    float h = size / 2;
-
-    XMFLOAT3 faceN[6] = {{0,0,1},{0,0,-1},{1,0,0},{-1,0,0},{0,1,0},{0,-1,0}};
-    XMFLOAT3 faceU[6] = {{-1,0,0},{1,0,0},{0,0,1},{0,0,-1},{1,0,0},{1,0,0}};
-    XMFLOAT3 faceV[6] = {{0,1,0},{0,1,0},{0,1,0},{0,1,0},{0,0,1},{0,0,-1}};
-
-    XMFLOAT3 fn = faceN[faceIdx], fu = faceU[faceIdx], fv = faceV[faceIdx];
-
-    for (int j = 0; j <= seg; j++) {
-        for (int i = 0; i <= seg; i++) {
-            float u = (float)i / seg * 2 - 1;
-            float vv = (float)j / seg * 2 - 1;
-
-            float px = u * h, py = vv * h;
-            float pz = h;
-            float nx = 0, ny = 0, nz = 1;
-
-            float rU_raw = (u > 0) ? edgeRadius[0] : edgeRadius[1];
-            float rV_raw = (vv > 0) ? edgeRadius[2] : edgeRadius[3];
-            float rU = fabsf(rU_raw), rV = fabsf(rV_raw);
-            bool outerU = (rU_raw > 0), outerV = (rV_raw > 0);
-
-            if (rU > 0 || rV > 0) {
-                float innerU = h - rU, innerV = h - rV;
-                float dx = (rU > 0) ? fmaxf(0, fabsf(px) - innerU) : 0;
-                float dy = (rV > 0) ? fmaxf(0, fabsf(py) - innerV) : 0;
-
-                if (dx > 0 || dy > 0) {
-                    bool isCorner = (dx > 0 && dy > 0);
-                    bool sphericalCorner = isCorner && (outerU || outerV);
-
-                    if (sphericalCorner) {
-                        float r = fmaxf(rU, rV);
-                        float dist = sqrtf(dx*dx + dy*dy);
-                        if (dist > r) { dx = dx * r / dist; dy = dy * r / dist; }
-                        float curveZ = sqrtf(fmaxf(0, r*r - dx*dx - dy*dy));
-                        pz = (h - r) + curveZ;
-                        px = (u > 0 ? 1 : -1) * (innerU + dx);
-                        py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                        nx = (u > 0 ? 1 : -1) * dx / r;
-                        ny = (vv > 0 ? 1 : -1) * dy / r;
-                        nz = curveZ / r;
-                    } else if (isCorner) {
-                        if (dx >= dy) {
-                            float curveZ = sqrtf(fmaxf(0, rU*rU - dx*dx));
-                            pz = (h - rU) + curveZ;
-                            px = (u > 0 ? 1 : -1) * (innerU + dx);
-                            nx = (u > 0 ? 1 : -1) * dx / rU;
-                            nz = curveZ / rU;
-                        } else {
-                            float curveZ = sqrtf(fmaxf(0, rV*rV - dy*dy));
-                            pz = (h - rV) + curveZ;
-                            py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                            ny = (vv > 0 ? 1 : -1) * dy / rV;
-                            nz = curveZ / rV;
-                        }
-                    } else {
-                        float r = (dx > 0) ? rU : rV;
-                        float d = (dx > 0) ? dx : dy;
-                        float curveZ = sqrtf(fmaxf(0, r*r - d*d));
-                        pz = (h - r) + curveZ;
-                        if (dx > 0) { px = (u > 0 ? 1 : -1) * (innerU + dx); nx = (u > 0 ? 1 : -1) * dx / r; }
-                        else { py = (vv > 0 ? 1 : -1) * (innerV + dy); ny = (vv > 0 ? 1 : -1) * dy / r; }
-                        nz = curveZ / r;
-                    }
-                }
-            }
-
-            Vert vert;
-            vert.p.x = offset.x + px*fu.x + py*fv.x + pz*fn.x;
-            vert.p.y = offset.y + px*fu.y + py*fv.y + pz*fn.y;
-            vert.p.z = offset.z + px*fu.z + py*fv.z + pz*fn.z;
-
-            float nnx = nx*fu.x + ny*fv.x + nz*fn.x;
-            float nny = nx*fu.y + ny*fv.y + nz*fn.y;
-            float nnz = nx*fu.z + ny*fv.z + nz*fn.z;
-            float len = sqrtf(nnx*nnx + nny*nny + nnz*nnz);
-            if (len < 0.001f) len = 1;
-            vert.n = {nnx/len, nny/len, nnz/len};
-            vert.cubeID = cubeID;
-            verts.push_back(vert);
-        }
-    }
-
-    for (int j = 0; j < seg; j++) {
-        for (int i = 0; i < seg; i++) {
-            UINT idx = base + j * (seg + 1) + i;
-            inds.push_back(idx); inds.push_back(idx + seg + 1); inds.push_back(idx + 1);
-            inds.push_back(idx + 1); inds.push_back(idx + seg + 1); inds.push_back(idx + seg + 2);
-        }
-    }
-}
-
-static void BuildAllGeometry(std::vector<Vert>& verts, std::vector<UINT>& inds)
-{
-    float cubeSize = 0.95f;
-    float outerR = 0.12f, innerR = -0.12f;
-    float half = cubeSize / 2;
-    int seg = 20;
-
-    int coords[8][3] = {
-        {-1, +1, +1}, {+1, +1, +1}, {-1, -1, +1}, {+1, -1, +1},
-        {-1, +1, -1}, {+1, +1, -1}, {-1, -1, -1}, {+1, -1, -1},
-    };
-
-    for (int c = 0; c < 8; c++) {
-        int cx = coords[c][0], cy = coords[c][1], cz = coords[c][2];
-        XMFLOAT3 pos = {cx * half, cy * half, cz * half};
-
-        bool renderFace[6] = {(cz > 0), (cz < 0), (cx > 0), (cx < 0), (cy > 0), (cy < 0)};
-
-        for (int f = 0; f < 6; f++) {
-            if (!renderFace[f]) continue;
-
-            float er[4];
-            switch (f) {
-                case 0: er[0] = (cx < 0) ? outerR : innerR; er[1] = (cx > 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 1: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 2: er[0] = (cz > 0) ? outerR : innerR; er[1] = (cz < 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 3: er[0] = (cz < 0) ? outerR : innerR; er[1] = (cz > 0) ? outerR : innerR;
-                        er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-                case 4: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                        er[2] = (cz > 0) ? outerR : innerR; er[3] = (cz < 0) ? outerR : innerR; break;
-                case 5: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                        er[2] = (cz < 0) ? outerR : innerR; er[3] = (cz > 0) ? outerR : innerR; break;
-            }
-            GenRoundedFace(cubeSize, seg, pos, f, er, c, verts, inds);
-        }
-    }
-}
+// Per-instance data for --cubes=N (slot 1)
+static ID3D12Resource* s_instanceVB = nullptr;
+static D3D12_VERTEX_BUFFER_VIEW s_instanceVBView = {};
+static UINT s_instanceCount = 1;
+static bool s_gpuCull = false;     // --gpu-culling: draws go through d3d12_gpu_cull.cpp
+static bool s_meshShaders = false; // --mesh-shaders: draws go through d3d12_mesh_shader.cpp
+
+// --record-threads=T: per-cube draws split across worker threads
+struct RecordWorker {
+    HANDLE thread;
+    HANDLE startEvent;      // Auto-reset, set by RenderD3D12
+    HANDLE doneEvent;       // Auto-reset, set by the worker
+    ID3D12CommandAllocator* alloc[FRAME_COUNT];
+    ID3D12GraphicsCommandList* list;
+    UINT firstInstance;
+    UINT instanceCount;
+};
+static RecordWorker s_workers[MAX_RECORD_THREADS] = {};
+static HANDLE s_workerDone[MAX_RECORD_THREADS] = {};
+static UINT s_workerCount = 0;
+static volatile LONG s_workersQuit = 0;
+static ID3D12CommandAllocator* s_epilogueAlloc[FRAME_COUNT] = {};
+static ID3D12GraphicsCommandList* s_epilogueList = nullptr;   // Text + present barrier after the workers
+static D3D12_CPU_DESCRIPTOR_HANDLE s_frameRtv = {}, s_frameDsv = {};
+static D3D12_GPU_VIRTUAL_ADDRESS s_frameCb = 0;   // This frame's CB in g_frameRing12
+static double s_cpuRecordMs = 0.0;
+
+// --bundles: PSO, topology, VB/IB and the draw recorded once; the direct list
+// keeps the per-frame root CBV (frame ring address), viewport and scissor
+static ID3D12CommandAllocator* s_sceneBundleAlloc = nullptr;
+static ID3D12GraphicsCommandList* s_sceneBundle = nullptr;
 
 // ============== SYNCHRONIZATION (non-static, declared in d3d12_shared.h) ==============
 void WaitForGpu()
 {
     if (!cmdQueue || !fence) return;
     const UINT64 fenceVal = fenceValues[frameIndex];
+    FrameRingRetire12(g_frameRing12, fenceVal);
     cmdQueue->Signal(fence, fenceVal);
     if (fence->GetCompletedValue() < fenceVal) {
         fence->SetEventOnCompletion(fenceVal, fenceEvent);
         WaitForSingleObject(fenceEvent, INFINITE);
     }
+    FrameRingReclaim12(g_frameRing12, fence->GetCompletedValue());
     fenceValues[frameIndex]++;
 }
 
 void MoveToNextFrame()
 {
     const UINT64 currentFenceValue = fenceValues[frameIndex];
+    FrameRingRetire12(g_frameRing12, currentFenceValue);
     cmdQueue->Signal(fence, currentFenceValue);
     frameIndex = swap12->GetCurrentBackBufferIndex();
     if (fence->GetCompletedValue() < fenceValues[frameIndex]) {
         fence->SetEventOnCompletion(fenceValues[frameIndex], fenceEvent);
         WaitForSingleObject(fenceEvent, INFINITE);
     }
+    FrameRingReclaim12(g_frameRing12, fence->GetCompletedValue());
     fenceValues[frameIndex] = currentFenceValue + 1;
 }
 
-// ============== TEXT RENDERING ==============
-// Non-static - exported for use by PT and DLSS renderers
-void DrawTextDirect(const char* text, float x, float y, float r, float g, float b, float a, float scale)
+// ============== SWAP CHAIN RESIZE (non-static, declared in d3d12_shared.h) ==============
+// Depth is created typeless so --gpu-culling can read it through an R24 SRV
+static bool CreateDepthStencil12()
 {
-    const int FONT_COLS = 16;
-    const float CHAR_W = 8.0f * scale, CHAR_H = 8.0f * scale;
-    const float LINE_H = CHAR_H * 1.4f;
-    const float TEX_W = 128.0f, TEX_H = 48.0f;
+    D3D12_HEAP_PROPERTIES heapProps = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC dsDesc = {};
+    dsDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    dsDesc.Width = W; dsDesc.Height = H; dsDesc.DepthOrArraySize = 1;
+    dsDesc.MipLevels = 1; dsDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
+    dsDesc.SampleDesc.Count = 1;
+    dsDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+    D3D12_CLEAR_VALUE clearVal = {}; clearVal.Format = DXGI_FORMAT_D24_UNORM_S8_UINT; clearVal.DepthStencil.Depth = 1.0f;
+    HRESULT hr = dev12->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &dsDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE, &clearVal, IID_PPV_ARGS(&depthStencil12));
+    if (FAILED(hr)) { LogHR("CreateDepthStencil", hr); return false; }
 
-    float cx = x, cy = y;
+    D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+    dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+    dev12->CreateDepthStencilView(depthStencil12, &dsvDesc, dsvHeap12->GetCPUDescriptorHandleForHeapStart());
+    return true;
+}
 
-    for (const char* p = text; *p && g_textVertCount < MAX_TEXT_VERTS - 6; p++) {
-        if (*p == '\n') { cx = x; cy += LINE_H; continue; }
-        if (*p < 32 || *p > 127) continue;
+// Shared by base, PT and DLSS renderers: all use swap12/renderTargets12/depthStencil12
+bool ResizeSwapChain12()
+{
+    if (!swap12 || !dev12) return false;
+    WaitForGpu();
 
-        int idx = *p - 32;
-        int col = idx % FONT_COLS, row = idx / FONT_COLS;
-        float u0 = col * 8.0f / TEX_W, v0 = row * 8.0f / TEX_H;
-        float u1 = u0 + 8.0f / TEX_W, v1 = v0 + 8.0f / TEX_H;
+    for (UINT i = 0; i < FRAME_COUNT; i++) {
+        if (renderTargets12[i]) { renderTargets12[i]->Release(); renderTargets12[i] = nullptr; }
+    }
+    if (depthStencil12) { depthStencil12->Release(); depthStencil12 = nullptr; }
 
-        // Two triangles per character (6 vertices)
-        g_textVerts[g_textVertCount++] = {cx, cy, u0, v0, r, g, b, a};
-        g_textVerts[g_textVertCount++] = {cx + CHAR_W, cy, u1, v0, r, g, b, a};
-        g_textVerts[g_textVertCount++] = {cx, cy + CHAR_H, u0, v1, r, g, b, a};
-        g_textVerts[g_textVertCount++] = {cx + CHAR_W, cy, u1, v0, r, g, b, a};
-        g_textVerts[g_textVertCount++] = {cx + CHAR_W, cy + CHAR_H, u1, v1, r, g, b, a};
-        g_textVerts[g_textVertCount++] = {cx, cy + CHAR_H, u0, v1, r, g, b, a};
+    DXGI_SWAP_CHAIN_DESC1 scd = {};
+    swap12->GetDesc1(&scd);
+    HRESULT hr = swap12->ResizeBuffers(FRAME_COUNT, W, H, DXGI_FORMAT_UNKNOWN, scd.Flags);
+    if (FAILED(hr)) { LogHR("ResizeBuffers", hr); return false; }
 
-        cx += CHAR_W;
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap12->GetCPUDescriptorHandleForHeapStart();
+    for (UINT i = 0; i < FRAME_COUNT; i++) {
+        hr = swap12->GetBuffer(i, IID_PPV_ARGS(&renderTargets12[i]));
+        if (FAILED(hr)) { LogHR("GetBuffer", hr); return false; }
+        dev12->CreateRenderTargetView(renderTargets12[i], nullptr, rtvHandle);
+        rtvHandle.ptr += rtvDescSize;
     }
+
+    if (!CreateDepthStencil12()) return false;
+
+    // Back buffer index restarts; all slots are idle after WaitForGpu
+    UINT64 next = fenceValues[frameIndex];
+    frameIndex = swap12->GetCurrentBackBufferIndex();
+    for (UINT i = 0; i < FRAME_COUNT; i++) fenceValues[i] = next;
+
+    // Overlay shows the resolution and is laid out for it
+    g_textNeedsRebuild = true;
+    return true;
 }
 
-// Public DrawText12 function (declared in d3d12_shared.h)
-void DrawText12(const char* text, float x, float y, float r, float g, float b, float a, float scale)
+bool ResizeD3D12()
 {
-    DrawTextDirect(text, x, y, r, g, b, a, scale);
+    if (!ResizeSwapChain12()) return false;
+    if (s_gpuCull && !ResizeGpuCull12()) return false;
+    Log("[INFO] D3D12 resized to %ux%u\n", W, H);
+    return true;
 }
 
-// ============== GPU TEXT INITIALIZATION ==============
-// Exported for use by PT and DLSS renderers
-bool InitGPUText12()
+// ============== RESOURCE SIZE (non-static, declared in d3d12_shared.h) ==============
+UINT64 ResourceBytes12(ID3D12Resource* resource)
 {
-    Log("[INFO] Initializing D3D12 text rendering...\n");
-    HRESULT hr;
+    if (!resource) return 0;
+    ID3D12Device* device = nullptr;
+    if (FAILED(resource->GetDevice(IID_PPV_ARGS(&device)))) return 0;
+    D3D12_RESOURCE_DESC desc = resource->GetDesc();
+    UINT64 bytes = device->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+    device->Release();
+    return bytes == UINT64_MAX ? 0 : bytes;
+}
 
-    // Create SRV heap for font texture (shader visible)
-    D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-    srvHeapDesc.NumDescriptors = 1;
-    srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    hr = dev12->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&srvHeap12));
-    if (FAILED(hr)) { LogHR("CreateSRVHeap", hr); return false; }
-
-    // Text root signature: descriptor table (SRV) + static sampler
-    D3D12_DESCRIPTOR_RANGE srvRange = {};
-    srvRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-    srvRange.NumDescriptors = 1;
-    srvRange.BaseShaderRegister = 0;
-
-    D3D12_ROOT_PARAMETER textRootParam = {};
-    textRootParam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    textRootParam.DescriptorTable.NumDescriptorRanges = 1;
-    textRootParam.DescriptorTable.pDescriptorRanges = &srvRange;
-    textRootParam.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    D3D12_STATIC_SAMPLER_DESC staticSampler = {};
-    staticSampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-    staticSampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    staticSampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    staticSampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    staticSampler.ShaderRegister = 0;
-    staticSampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    D3D12_ROOT_SIGNATURE_DESC textRsDesc = {};
-    textRsDesc.NumParameters = 1;
-    textRsDesc.pParameters = &textRootParam;
-    textRsDesc.NumStaticSamplers = 1;
-    textRsDesc.pStaticSamplers = &staticSampler;
-    textRsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+// ============== GPU TIMESTAMPS (non-static, declared in d3d12_shared.h) ==============
+static UINT64 s_timerFreq = 0;
+static UINT s_timerStampCount[FRAME_COUNT] = {};
+static bool s_timerPending[FRAME_COUNT] = {};
+static const char* s_timerPassNames[FRAME_COUNT][GPU_TIMER_MAX_STAMPS] = {};
+static double s_timerLastFrameMs = 0.0;
 
-    ID3DBlob* sigBlob = nullptr, *errBlob = nullptr;
-    hr = D3D12SerializeRootSignature(&textRsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
-    if (FAILED(hr)) {
-        if (errBlob) { Log("[ERROR] Text root sig: %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+bool InitGpuTimer12(ID3D12Device* device, ID3D12CommandQueue* queue)
+{
+    CleanupGpuTimer12();
+    GpuProfilerReset();
+    if (!device || !queue || FAILED(queue->GetTimestampFrequency(&s_timerFreq)) || s_timerFreq == 0) {
+        Log("[WARN] GPU timestamps not available on this queue\n");
         return false;
     }
-    hr = dev12->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&textRootSig12));
-    sigBlob->Release();
-    if (FAILED(hr)) { LogHR("CreateTextRootSig", hr); return false; }
-    Log("[INFO] Text root signature created\n");
 
-    // Compile text shaders
-    ID3DBlob* vsBlob = nullptr, *psBlob = nullptr;
-    size_t shaderLen = strlen(g_d3d11ShaderCode);
-    UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
+    D3D12_QUERY_HEAP_DESC qhDesc = {};
+    qhDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    qhDesc.Count = FRAME_COUNT * GPU_TIMER_MAX_STAMPS;
+    HRESULT hr = device->CreateQueryHeap(&qhDesc, IID_PPV_ARGS(&g_timerQueryHeap12));
+    if (FAILED(hr)) { LogHR("CreateQueryHeap (timestamp)", hr); return false; }
 
-    Log("[INFO] Compiling D3D12 text shaders...\n");
-    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, "TextVS", "vs_5_0", flags, 0, &vsBlob, &errBlob);
+    D3D12_HEAP_PROPERTIES readbackHeap = { D3D12_HEAP_TYPE_READBACK };
+    D3D12_RESOURCE_DESC bufDesc = {};
+    bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    bufDesc.Width = FRAME_COUNT * GPU_TIMER_MAX_STAMPS * sizeof(UINT64);
+    bufDesc.Height = 1;
+    bufDesc.DepthOrArraySize = 1;
+    bufDesc.MipLevels = 1;
+    bufDesc.SampleDesc.Count = 1;
+    bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    hr = device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&g_timerReadback12));
     if (FAILED(hr)) {
-        if (errBlob) { Log("[SHADER ERROR] %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        LogHR("CreateCommittedResource (timestamp readback)", hr);
+        CleanupGpuTimer12();
         return false;
     }
-    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, "TextPS", "ps_5_0", flags, 0, &psBlob, &errBlob);
-    if (FAILED(hr)) {
-        if (errBlob) { Log("[SHADER ERROR] %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
-        vsBlob->Release(); return false;
+
+    Log("[INFO] GPU timestamp profiler ready (%llu Hz)\n", s_timerFreq);
+    return true;
+}
+
+void GpuTimerCollect12(UINT frame)
+{
+    if (!g_timerReadback12 || frame >= FRAME_COUNT || !s_timerPending[frame]) return;
+    s_timerPending[frame] = false;
+
+    UINT count = s_timerStampCount[frame];
+    if (count < 2) return;
+
+    // The fence for this slot has already been waited on by MoveToNextFrame
+    D3D12_RANGE readRange = { frame * GPU_TIMER_MAX_STAMPS * sizeof(UINT64),
+                              (frame * GPU_TIMER_MAX_STAMPS + count) * sizeof(UINT64) };
+    UINT64* data = nullptr;
+    if (FAILED(g_timerReadback12->Map(0, &readRange, (void**)&data))) return;
+    const UINT64* stamps = data + frame * GPU_TIMER_MAX_STAMPS;
+    for (UINT i = 1; i < count; i++) {
+        if (stamps[i] < stamps[i - 1]) continue;
+        double ms = (double)(stamps[i] - stamps[i - 1]) * 1000.0 / s_timerFreq;
+        GpuProfilerAddSample(i - 1, s_timerPassNames[frame][i], ms);
     }
+    if (stamps[count - 1] >= stamps[0]) {
+        s_timerLastFrameMs = (double)(stamps[count - 1] - stamps[0]) * 1000.0 / s_timerFreq;
+        GroupTuneFrameTime(frame, s_timerLastFrameMs);   // --group-size=auto: the variant dispatched in this slot
+    }
+    D3D12_RANGE writeRange = { 0, 0 };
+    g_timerReadback12->Unmap(0, &writeRange);
+}
 
-    // Text PSO with blending
-    D3D12_INPUT_ELEMENT_DESC textLayout[] = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-    };
+double GpuTimerLastFrameMs12()
+{
+    return s_timerLastFrameMs;
+}
 
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC textPsoDesc = {};
-    textPsoDesc.InputLayout = { textLayout, _countof(textLayout) };
-    textPsoDesc.pRootSignature = textRootSig12;
-    textPsoDesc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
-    textPsoDesc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
-    textPsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    textPsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
-    textPsoDesc.RasterizerState.DepthClipEnable = TRUE;
-    // Alpha blending
-    textPsoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
-    textPsoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
-    textPsoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
-    textPsoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
-    textPsoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
-    textPsoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ZERO;
-    textPsoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
-    textPsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
-    textPsoDesc.DepthStencilState.DepthEnable = FALSE;
-    textPsoDesc.SampleMask = UINT_MAX;
-    textPsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    textPsoDesc.NumRenderTargets = 1;
-    textPsoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textPsoDesc.SampleDesc.Count = 1;
-
-    hr = dev12->CreateGraphicsPipelineState(&textPsoDesc, IID_PPV_ARGS(&textPso));
-    vsBlob->Release(); psBlob->Release();
-    if (FAILED(hr)) { LogHR("CreateTextPSO", hr); return false; }
-    Log("[INFO] Text PSO created\n");
-
-    // Create font texture (16x6 characters = 128x48 pixels)
-    const int FONT_COLS = 16, FONT_ROWS = 6;
-    const int TEX_W = FONT_COLS * 8, TEX_H = FONT_ROWS * 8;
-    unsigned char texData[TEX_W * TEX_H];
-    memset(texData, 0, sizeof(texData));
-
-    for (int c = 0; c < 96; c++) {
-        int col = c % FONT_COLS, row = c / FONT_COLS;
-        for (int y = 0; y < 8; y++) {
-            unsigned char bits = g_font8x8[c][y];
-            for (int x = 0; x < 8; x++) {
-                int px = col * 8 + x, py = row * 8 + y;
-                texData[py * TEX_W + px] = (bits & (0x80 >> x)) ? 255 : 0;
-            }
+void GpuTimerBegin12(ID3D12GraphicsCommandList* cl, UINT frame)
+{
+    if (!g_timerQueryHeap12 || frame >= FRAME_COUNT) return;
+    s_timerStampCount[frame] = 1;
+    s_timerPassNames[frame][0] = nullptr;
+    cl->EndQuery(g_timerQueryHeap12, D3D12_QUERY_TYPE_TIMESTAMP, frame * GPU_TIMER_MAX_STAMPS);
+}
+
+void GpuTimerStamp12(ID3D12GraphicsCommandList* cl, UINT frame, const char* passName)
+{
+    if (!g_timerQueryHeap12 || frame >= FRAME_COUNT) return;
+    UINT idx = s_timerStampCount[frame];
+    if (idx == 0 || idx >= GPU_TIMER_MAX_STAMPS) return;
+    s_timerPassNames[frame][idx] = passName;
+    cl->EndQuery(g_timerQueryHeap12, D3D12_QUERY_TYPE_TIMESTAMP, frame * GPU_TIMER_MAX_STAMPS + idx);
+    s_timerStampCount[frame] = idx + 1;
+}
+
+void GpuTimerEnd12(ID3D12GraphicsCommandList* cl, UINT frame)
+{
+    if (!g_timerQueryHeap12 || frame >= FRAME_COUNT || s_timerStampCount[frame] < 2) return;
+    UINT first = frame * GPU_TIMER_MAX_STAMPS;
+    cl->ResolveQueryData(g_timerQueryHeap12, D3D12_QUERY_TYPE_TIMESTAMP, first, s_timerStampCount[frame],
+        g_timerReadback12, first * sizeof(UINT64));
+    s_timerPending[frame] = true;
+}
+
+void CleanupGpuTimer12()
+{
+    if (g_timerReadback12) { g_timerReadback12->Release(); g_timerReadback12 = nullptr; }
+    if (g_timerQueryHeap12) { g_timerQueryHeap12->Release(); g_timerQueryHeap12 = nullptr; }
+    memset(s_timerStampCount, 0, sizeof(s_timerStampCount));
+    s_timerLastFrameMs = 0.0;
+    memset(s_timerPending, 0, sizeof(s_timerPending));
+}
+
+// ============== MULTITHREADED RECORDING ==============
+// Each worker owns one allocator per frame in flight and a command list that
+// records its slice of the per-cube draws. RenderD3D12 records the prologue
+// (clear) and epilogue (text, present barrier) and submits everything with a
+// single ExecuteCommandLists.
+static void RecordWorkerDraws(RecordWorker& w)
+{
+    ID3D12GraphicsCommandList* cl = w.list;
+    cl->Reset(w.alloc[frameIndex], pso);
+    cl->OMSetRenderTargets(1, &s_frameRtv, FALSE, &s_frameDsv);
+    cl->SetGraphicsRootSignature(rootSig);
+    cl->SetGraphicsRootConstantBufferView(0, s_frameCb);
+    D3D12_VIEWPORT vp = { 0, 0, (float)W, (float)H, 0, 1 };
+    D3D12_RECT scissor = { 0, 0, (LONG)W, (LONG)H };
+    cl->RSSetViewports(1, &vp);
+    cl->RSSetScissorRects(1, &scissor);
+    cl->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    D3D12_VERTEX_BUFFER_VIEW vbViews[2] = { vbView12, s_instanceVBView };
+    cl->IASetVertexBuffers(0, 2, vbViews);
+    cl->IASetIndexBuffer(&ibView12);
+    for (UINT i = 0; i < w.instanceCount; i++) {
+        cl->DrawIndexedInstanced(totalIndices12, 1, 0, 0, w.firstInstance + i);
+    }
+    cl->Close();
+}
+
+static DWORD WINAPI RecordWorkerThread(LPVOID param)
+{
+    RecordWorker& w = *(RecordWorker*)param;
+    for (;;) {
+        WaitForSingleObject(w.startEvent, INFINITE);
+        if (s_workersQuit) break;
+        RecordWorkerDraws(w);
+        SetEvent(w.doneEvent);
+    }
+    return 0;
+}
+
+static void StopRecordWorkers()
+{
+    InterlockedExchange(&s_workersQuit, 1);
+    for (UINT i = 0; i < s_workerCount; i++) {
+        RecordWorker& w = s_workers[i];
+        if (w.thread) {
+            SetEvent(w.startEvent);
+            WaitForSingleObject(w.thread, INFINITE);
+            CloseHandle(w.thread);
+        }
+        if (w.startEvent) CloseHandle(w.startEvent);
+        if (w.doneEvent) CloseHandle(w.doneEvent);
+        if (w.list) w.list->Release();
+        for (UINT f = 0; f < FRAME_COUNT; f++) {
+            if (w.alloc[f]) w.alloc[f]->Release();
         }
+        w = {};
+        s_workerDone[i] = nullptr;
     }
+    s_workerCount = 0;
+    InterlockedExchange(&s_workersQuit, 0);
 
-    // Create font texture resource
-    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
-    D3D12_RESOURCE_DESC texDesc = {};
-    texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    texDesc.Width = TEX_W;
-    texDesc.Height = TEX_H;
-    texDesc.DepthOrArraySize = 1;
-    texDesc.MipLevels = 1;
-    texDesc.Format = DXGI_FORMAT_R8_UNORM;
-    texDesc.SampleDesc.Count = 1;
-    texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-    texDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-    hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
-        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&fontTex12));
-    if (FAILED(hr)) { LogHR("CreateFontTexture", hr); return false; }
-
-    // Upload texture via upload buffer
-    UINT64 uploadSize = 0;
-    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
-    dev12->GetCopyableFootprints(&texDesc, 0, 1, 0, &footprint, nullptr, nullptr, &uploadSize);
-
-    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
-    D3D12_RESOURCE_DESC uploadBufDesc = {};
-    uploadBufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    uploadBufDesc.Width = uploadSize;
-    uploadBufDesc.Height = 1;
-    uploadBufDesc.DepthOrArraySize = 1;
-    uploadBufDesc.MipLevels = 1;
-    uploadBufDesc.SampleDesc.Count = 1;
-    uploadBufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-    ID3D12Resource* uploadBuf = nullptr;
-    hr = dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &uploadBufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadBuf));
-    if (FAILED(hr)) { LogHR("CreateUploadBuffer", hr); return false; }
-
-    // Copy texture data to upload buffer
-    void* mapped;
-    uploadBuf->Map(0, nullptr, &mapped);
-    BYTE* destRow = (BYTE*)mapped + footprint.Offset;
-    for (UINT y = 0; y < TEX_H; y++) {
-        memcpy(destRow + y * footprint.Footprint.RowPitch, texData + y * TEX_W, TEX_W);
-    }
-    uploadBuf->Unmap(0, nullptr);
-
-    // Execute copy command
-    cmdAlloc[0]->Reset();
-    cmdList->Reset(cmdAlloc[0], nullptr);
-
-    D3D12_TEXTURE_COPY_LOCATION dst = {}, src = {};
-    dst.pResource = fontTex12;
-    dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    dst.SubresourceIndex = 0;
-    src.pResource = uploadBuf;
-    src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-    src.PlacedFootprint = footprint;
-
-    cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
-
-    // Transition to shader resource
-    D3D12_RESOURCE_BARRIER barrier = {};
-    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barrier.Transition.pResource = fontTex12;
-    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    cmdList->ResourceBarrier(1, &barrier);
+    if (s_epilogueList) { s_epilogueList->Release(); s_epilogueList = nullptr; }
+    for (UINT f = 0; f < FRAME_COUNT; f++) {
+        if (s_epilogueAlloc[f]) { s_epilogueAlloc[f]->Release(); s_epilogueAlloc[f] = nullptr; }
+    }
+}
 
-    cmdList->Close();
-    ID3D12CommandList* cmdLists[] = { cmdList };
-    cmdQueue->ExecuteCommandLists(1, cmdLists);
+static void ReleaseSceneBundle()
+{
+    if (s_sceneBundle) { s_sceneBundle->Release(); s_sceneBundle = nullptr; }
+    if (s_sceneBundleAlloc) { s_sceneBundleAlloc->Release(); s_sceneBundleAlloc = nullptr; }
+}
 
-    // Wait for upload to complete
-    WaitForGpu();
-    uploadBuf->Release();
-
-    // Create SRV for font texture
-    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-    srvDesc.Format = DXGI_FORMAT_R8_UNORM;
-    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    srvDesc.Texture2D.MipLevels = 1;
-    dev12->CreateShaderResourceView(fontTex12, &srvDesc, srvHeap12->GetCPUDescriptorHandleForHeapStart());
-
-    // Create dynamic text vertex buffer (max 1000 characters = 6000 vertices)
-    UINT textVbSize = 6000 * sizeof(TextVert);
-    D3D12_RESOURCE_DESC bufDesc = {};
-    bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    bufDesc.Width = textVbSize;
-    bufDesc.Height = 1;
-    bufDesc.DepthOrArraySize = 1;
-    bufDesc.MipLevels = 1;
-    bufDesc.SampleDesc.Count = 1;
-    bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+// Called once the geometry exists; nothing in it depends on the frame or the window size
+static bool RecordSceneBundle()
+{
+    HRESULT hr = dev12->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(&s_sceneBundleAlloc));
+    if (FAILED(hr)) { LogHR("CreateCommandAllocator (scene bundle)", hr); return false; }
+    hr = dev12->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_BUNDLE, s_sceneBundleAlloc, pso, IID_PPV_ARGS(&s_sceneBundle));
+    if (FAILED(hr)) { LogHR("CreateCommandList (scene bundle)", hr); return false; }
+
+    D3D12_VERTEX_BUFFER_VIEW vbViews[2] = { vbView12, s_instanceVBView };
+    s_sceneBundle->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    s_sceneBundle->IASetVertexBuffers(0, s_instanceVB ? 2 : 1, vbViews);
+    s_sceneBundle->IASetIndexBuffer(&ibView12);
+    s_sceneBundle->DrawIndexedInstanced(totalIndices12, s_instanceCount, 0, 0, 0);
+    hr = s_sceneBundle->Close();
+    if (FAILED(hr)) { LogHR("Close (scene bundle)", hr); return false; }
+    return true;
+}
+
+static bool StartRecordWorkers(UINT threads, UINT instances)
+{
+    HRESULT hr;
+    for (UINT f = 0; f < FRAME_COUNT; f++) {
+        hr = dev12->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&s_epilogueAlloc[f]));
+        if (FAILED(hr)) { LogHR("CreateCommandAllocator (epilogue)", hr); return false; }
+    }
+    hr = dev12->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, s_epilogueAlloc[0], nullptr, IID_PPV_ARGS(&s_epilogueList));
+    if (FAILED(hr)) { LogHR("CreateCommandList (epilogue)", hr); return false; }
+    s_epilogueList->Close();
+
+    if (threads > instances) threads = instances;
+    UINT first = 0;
+    for (UINT i = 0; i < threads; i++) {
+        RecordWorker& w = s_workers[i];
+        w.firstInstance = first;
+        w.instanceCount = instances / threads + (i < instances % threads ? 1 : 0);
+        first += w.instanceCount;
+
+        for (UINT f = 0; f < FRAME_COUNT; f++) {
+            hr = dev12->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&w.alloc[f]));
+            if (FAILED(hr)) { LogHR("CreateCommandAllocator (worker)", hr); return false; }
+        }
+        hr = dev12->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, w.alloc[0], pso, IID_PPV_ARGS(&w.list));
+        if (FAILED(hr)) { LogHR("CreateCommandList (worker)", hr); return false; }
+        w.list->Close();
+
+        w.startEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        w.doneEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        s_workerDone[i] = w.doneEvent;
+        s_workerCount = i + 1;
+        w.thread = CreateThread(nullptr, 0, RecordWorkerThread, &w, 0, nullptr);
+        if (!w.thread) { Log("[ERROR] CreateThread failed for record worker %u\n", i); return false; }
+    }
+    Log("[INFO] D3D12 multithreaded recording: %u threads, %u draws\n", s_workerCount, instances);
+    return true;
+}
+
+// ============== INITIALIZATION ==============
+// Vertex pipeline scene: VB/IB of the baked cubes, the --cubes instance mesh
+// or --mesh, plus the instance buffer and the --gpu-culling / --record-threads
+// setup that draws from it
+static bool CreateSceneGeometry12(bool instanced)
+{
+    // Build geometry and upload (--mesh: straight from the file mapping, mesh_file.h)
+    std::vector<CubeVertex> verts;
+    std::vector<UINT> inds;
+    if (!MeshLoaded()) {
+        if (instanced) BuildInstanceCube(verts, inds);
+        else BuildSceneCubes(verts, inds);
+    }
+    const void* vbData = MeshLoaded() ? (const void*)g_mesh.vertices : verts.data();
+    const void* ibData = MeshLoaded() ? (const void*)g_mesh.indices : inds.data();
+    UINT vbStride = MeshLoaded() ? (UINT)sizeof(MeshVertex) : (UINT)sizeof(CubeVertex);
+    totalIndices12 = MeshLoaded() ? g_mesh.indexCount : (UINT)inds.size();
+    totalVertices12 = MeshLoaded() ? g_mesh.vertexCount : (UINT)verts.size();
+
+    // Upload VB/IB (and instances) to DEFAULT heap through the copy queue
+    if (!UploadBegin12(dev12)) return false;
+    UINT vbSize = totalVertices12 * vbStride;
+    vb12 = UploadBuffer12(vbData, vbSize, "VB");
+    vbView12.BufferLocation = vb12 ? vb12->GetGPUVirtualAddress() : 0;
+    vbView12.SizeInBytes = vbSize;
+    vbView12.StrideInBytes = vbStride;
 
-    hr = dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&textVB12));
-    if (FAILED(hr)) { LogHR("CreateTextVB", hr); return false; }
+    UINT ibSize = totalIndices12 * (UINT)sizeof(UINT);
+    ib12 = UploadBuffer12(ibData, ibSize, "IB");
+    ibView12.BufferLocation = ib12 ? ib12->GetGPUVirtualAddress() : 0;
+    ibView12.SizeInBytes = ibSize;
+    ibView12.Format = DXGI_FORMAT_R32_UINT;
 
-    textVbView12.BufferLocation = textVB12->GetGPUVirtualAddress();
-    textVbView12.SizeInBytes = textVbSize;
-    textVbView12.StrideInBytes = sizeof(TextVert);
+    // Instance buffer (--cubes=N), also the GPU culling source SRV
+    s_instanceCount = 1;
+    if (instanced) {
+        std::vector<CubeInstance> instances;
+        BuildCubeInstances(max(g_cubeCount, 1u), instances);
+        UINT instSize = (UINT)(instances.size() * sizeof(CubeInstance));
+        s_instanceVB = UploadBuffer12(instances.data(), instSize, "InstanceVB");
+        s_instanceCount = (UINT)instances.size();
+        if (s_instanceVB) {
+            s_instanceVBView.BufferLocation = s_instanceVB->GetGPUVirtualAddress();
+            s_instanceVBView.SizeInBytes = instSize;
+            s_instanceVBView.StrideInBytes = sizeof(CubeInstance);
+        }
+    }
+    if (!UploadFlush12() || !vb12 || !ib12 || (instanced && !s_instanceVB)) {
+        Log("[ERROR] D3D12 geometry upload failed\n");
+        return false;
+    }
 
-    // Persistent map - never unmap
-    textVB12->Map(0, nullptr, &textVbMapped12);
+    if (instanced) {
+        Log("[INFO] Instanced scene: %u %s, %u triangles each\n", s_instanceCount,
+            MeshLoaded() ? "meshes" : "cubes", totalIndices12 / 3);
 
-    Log("[INFO] D3D12 text rendering initialized\n");
+        if (g_gpuCulling) {
+            if (!InitGpuCull12(s_instanceVB, s_instanceCount, totalIndices12)) return false;
+            s_gpuCull = true;
+            if (g_recordThreads) Log("[WARN] --record-threads is ignored with --gpu-culling\n");
+        } else if (g_recordThreads) {
+            if (!StartRecordWorkers(g_recordThreads, s_instanceCount)) return false;
+        }
+    } else if (g_gpuCulling || g_recordThreads) {
+        Log("[WARN] --gpu-culling / --record-threads need --cubes=N, using the classic scene\n");
+    }
     return true;
 }
 
-// ============== INITIALIZATION ==============
 bool InitD3D12(HWND hwnd)
 {
     Log("[INFO] Initializing Direct3D 12...\n");
     HRESULT hr;
+    StartupStep("Device");
 
     // Get adapter
     IDXGIAdapter1* selectedAdapter = nullptr;
@@ -493,6 +508,7 @@ bool InitD3D12(HWND hwnd)
     if (FAILED(hr)) { LogHR("CreateCommandQueue", hr); return false; }
 
     // Swap chain with tearing support check
+    StartupStep("Swap chain + frame resources");
     IDXGIFactory5* factory5 = nullptr;
     CreateDXGIFactory1(IID_PPV_ARGS(&factory5));
 
@@ -510,14 +526,15 @@ bool InitD3D12(HWND hwnd)
     scd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
     scd.BufferCount = FRAME_COUNT;
     scd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    scd.Flags = g_tearingSupported12 ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+    scd.Flags = DxgiSwapChainFlags(g_tearingSupported12);
 
     IDXGISwapChain1* swap1 = nullptr;
-    hr = factory5->CreateSwapChainForHwnd(cmdQueue, hwnd, &scd, nullptr, nullptr, &swap1);
+    hr = DxgiCreateSwapChain(factory5, cmdQueue, hwnd, scd, &swap1);
     factory5->Release();
     if (FAILED(hr)) { LogHR("CreateSwapChain", hr); return false; }
     swap1->QueryInterface(IID_PPV_ARGS(&swap12));
     swap1->Release();
+    swapWaitable12 = DxgiInitFrameLatency(swap12, "D3D12");
     frameIndex = swap12->GetCurrentBackBufferIndex();
     Log("[INFO] Swap chain created (BufferCount=%d)\n", FRAME_COUNT);
 
@@ -541,17 +558,7 @@ bool InitD3D12(HWND hwnd)
     dsvHeapDesc.NumDescriptors = 1;
     dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
     dev12->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&dsvHeap12));
-
-    D3D12_HEAP_PROPERTIES heapProps = { D3D12_HEAP_TYPE_DEFAULT };
-    D3D12_RESOURCE_DESC dsDesc = {};
-    dsDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    dsDesc.Width = W; dsDesc.Height = H; dsDesc.DepthOrArraySize = 1;
-    dsDesc.MipLevels = 1; dsDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    dsDesc.SampleDesc.Count = 1;
-    dsDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-    D3D12_CLEAR_VALUE clearVal = {}; clearVal.Format = DXGI_FORMAT_D24_UNORM_S8_UINT; clearVal.DepthStencil.Depth = 1.0f;
-    dev12->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &dsDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE, &clearVal, IID_PPV_ARGS(&depthStencil12));
-    dev12->CreateDepthStencilView(depthStencil12, nullptr, dsvHeap12->GetCPUDescriptorHandleForHeapStart());
+    if (!CreateDepthStencil12()) return false;
 
     // Command allocators
     for (UINT i = 0; i < FRAME_COUNT; i++) {
@@ -562,8 +569,10 @@ bool InitD3D12(HWND hwnd)
     dev12->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
     fenceValues[0] = fenceValues[1] = fenceValues[2] = 1;
     fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!InitFrameRing12(g_frameRing12, dev12, fence, FRAME_RING_SIZE, "D3D12")) return false;
 
     // Root signature (simple: 1 CBV at b0)
+    StartupStep("Pipeline");
     D3D12_ROOT_PARAMETER rootParam = {};
     rootParam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     rootParam.Descriptor.ShaderRegister = 0;
@@ -589,8 +598,9 @@ bool InitD3D12(HWND hwnd)
     size_t shaderLen = strlen(g_d3d11ShaderCode);
     UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
 
-    Log("[INFO] Compiling D3D12 shaders...\n");
-    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, "VS", "vs_5_0", flags, 0, &vsBlob, &errBlob);
+    bool instanced = g_cubeCount > 0 || MeshLoaded();   // --mesh is drawn as the instanced mesh
+    Log("[INFO] Compiling D3D12 shaders%s...\n", instanced ? " (instanced)" : "");
+    hr = D3DCompile(g_d3d11ShaderCode, shaderLen, "embedded", nullptr, nullptr, instanced ? "VSInstanced" : "VS", "vs_5_0", flags, 0, &vsBlob, &errBlob);
     if (FAILED(hr)) {
         if (errBlob) { Log("[SHADER ERROR] %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
         return false;
@@ -607,9 +617,16 @@ bool InitD3D12(HWND hwnd)
         {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
         {"CUBEID", 0, DXGI_FORMAT_R32_UINT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
     };
+    D3D12_INPUT_ELEMENT_DESC instLayout[] = {
+        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        {"INSTANCE", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+        {"INSTCOLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+    };
 
     D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
-    psoDesc.InputLayout = { inputLayout, _countof(inputLayout) };
+    if (instanced) psoDesc.InputLayout = { instLayout, _countof(instLayout) };
+    else psoDesc.InputLayout = { inputLayout, _countof(inputLayout) };
     psoDesc.pRootSignature = rootSig;
     psoDesc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
     psoDesc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
@@ -637,45 +654,37 @@ bool InitD3D12(HWND hwnd)
     dev12->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, cmdAlloc[0], pso, IID_PPV_ARGS(&cmdList));
     cmdList->Close();
 
-    // Build geometry and upload
-    std::vector<Vert> verts;
-    std::vector<UINT> inds;
-    BuildAllGeometry(verts, inds);
-    totalIndices12 = (UINT)inds.size();
-    totalVertices12 = (UINT)verts.size();
-
-    // Upload VB
-    UINT vbSize = (UINT)(verts.size() * sizeof(Vert));
-    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
-    D3D12_RESOURCE_DESC bufDesc = {}; bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    bufDesc.Width = vbSize; bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
-    bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&vb12));
-    void* mapped; vb12->Map(0, nullptr, &mapped);
-    memcpy(mapped, verts.data(), vbSize);
-    vb12->Unmap(0, nullptr);
-    vbView12.BufferLocation = vb12->GetGPUVirtualAddress();
-    vbView12.SizeInBytes = vbSize;
-    vbView12.StrideInBytes = sizeof(Vert);
-
-    // Upload IB
-    UINT ibSize = (UINT)(inds.size() * sizeof(UINT));
-    bufDesc.Width = ibSize;
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&ib12));
-    ib12->Map(0, nullptr, &mapped);
-    memcpy(mapped, inds.data(), ibSize);
-    ib12->Unmap(0, nullptr);
-    ibView12.BufferLocation = ib12->GetGPUVirtualAddress();
-    ibView12.SizeInBytes = ibSize;
-    ibView12.Format = DXGI_FORMAT_R32_UINT;
-
-    // Upload CB with persistent mapping
-    bufDesc.Width = 256; // Aligned
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&cbUpload12));
-    cbUpload12->Map(0, nullptr, &cbMapped12); // Persistent map - never unmap
+    // --mesh-shaders: cubes generated on the GPU, no VB/IB; otherwise the
+    // vertex pipeline scene (VB/IB, instancing, GPU culling, record threads)
+    StartupStep("Scene geometry");
+    if (g_meshShaders) {
+        if (MeshLoaded()) {
+            Log("[WARN] --mesh-shaders generates the procedural cubes only, drawing --mesh with the vertex pipeline\n");
+        } else if (!MeshShadersSupported12()) {
+            Log("[WARN] --mesh-shaders needs mesh shader tier 1 and shader model 6.5, using the vertex pipeline\n");
+        } else if (!InitMeshShaders12(g_cubeCount)) {
+            Log("[WARN] Mesh shader path initialization failed, using the vertex pipeline\n");
+            CleanupMeshShaders12();
+        } else {
+            s_meshShaders = true;
+            if (g_gpuCulling || g_recordThreads) Log("[WARN] --gpu-culling / --record-threads are ignored with --mesh-shaders\n");
+        }
+    }
+    if (!s_meshShaders && !CreateSceneGeometry12(instanced)) return false;
+    if (g_bundles) {
+        if (s_meshShaders || s_gpuCull || s_workerCount > 0) {
+            Log("[WARN] --bundles covers the overlay only with --mesh-shaders / --gpu-culling / --record-threads\n");
+        } else if (!RecordSceneBundle()) {
+            Log("[WARN] Scene bundle unavailable, recording the scene draw per frame\n");
+            ReleaseSceneBundle();
+        } else {
+            Log("[INFO] Scene draw recorded into a bundle (%u instances)\n", s_instanceCount);
+        }
+    }
 
     // Initialize text rendering
-    if (!InitGPUText12()) {
+    StartupStep("Overlay");
+    if (!Overlay12Init(g_overlay12, dev12, DXGI_FORMAT_R8G8B8A8_UNORM, "D3D12")) {
         Log("[WARN] Text rendering initialization failed, continuing without text\n");
     }
 
@@ -686,15 +695,20 @@ bool InitD3D12(HWND hwnd)
 // ============== RENDERING ==============
 void RenderD3D12()
 {
+    DxgiWaitFrameLatency(swapWaitable12);
+
+    LARGE_INTEGER recordStart;
+    QueryPerformanceCounter(&recordStart);
+
     cmdAlloc[frameIndex]->Reset();
     cmdList->Reset(cmdAlloc[frameIndex], pso);
 
-    // Update CB using persistent mapping (no Map/Unmap overhead)
+    // Per-frame CB from the upload ring (frames in flight keep their own copy)
     LARGE_INTEGER nowTime;
     QueryPerformanceCounter(&nowTime);
     float t = (float)(nowTime.QuadPart - g_startTime.QuadPart) / g_perfFreq.QuadPart;
-    CB cbData = { t };
-    memcpy(cbMapped12, &cbData, sizeof(CB));
+    CB cbData = { t, (float)W / (float)H };
+    s_frameCb = FrameRingPush12(g_frameRing12, &cbData, sizeof(CB), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
     // Transition to render target
     D3D12_RESOURCE_BARRIER barrier = {};
@@ -715,7 +729,7 @@ void RenderD3D12()
 
     cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
     cmdList->SetGraphicsRootSignature(rootSig);
-    cmdList->SetGraphicsRootConstantBufferView(0, cbUpload12->GetGPUVirtualAddress());
+    cmdList->SetGraphicsRootConstantBufferView(0, s_frameCb);
 
     D3D12_VIEWPORT vp = { 0, 0, (float)W, (float)H, 0, 1 };
     D3D12_RECT scissor = { 0, 0, (LONG)W, (LONG)H };
@@ -723,9 +737,37 @@ void RenderD3D12()
     cmdList->RSSetScissorRects(1, &scissor);
 
     cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    cmdList->IASetVertexBuffers(0, 1, &vbView12);
-    cmdList->IASetIndexBuffer(&ibView12);
-    cmdList->DrawIndexedInstanced(totalIndices12, 1, 0, 0, 0);
+    ID3D12GraphicsCommandList* tail = cmdList;   // List that records text + present barrier
+    if (s_workerCount > 0) {
+        // Workers record the draws while this thread records the epilogue
+        s_frameRtv = rtvHandle;
+        s_frameDsv = dsvHandle;
+        cmdList->Close();
+        for (UINT i = 0; i < s_workerCount; i++) SetEvent(s_workers[i].startEvent);
+
+        s_epilogueAlloc[frameIndex]->Reset();
+        s_epilogueList->Reset(s_epilogueAlloc[frameIndex], nullptr);
+        s_epilogueList->RSSetViewports(1, &vp);
+        s_epilogueList->RSSetScissorRects(1, &scissor);
+        s_epilogueList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        tail = s_epilogueList;
+    } else if (s_meshShaders) {
+        // Amplification + mesh shaders, sets its own root signature and PSO
+        MeshShaderRender12(t, (float)W / (float)H);
+    } else if (s_gpuCull) {
+        // Cull + ExecuteIndirect; slot 1 is bound to the compacted instances
+        cmdList->IASetVertexBuffers(0, 1, &vbView12);
+        cmdList->IASetIndexBuffer(&ibView12);
+        GpuCullRender12(cmdList, pso, t, (float)W / (float)H);
+    } else if (s_sceneBundle) {
+        // Root signature + this frame's CBV are inherited from cmdList
+        cmdList->ExecuteBundle(s_sceneBundle);
+    } else {
+        D3D12_VERTEX_BUFFER_VIEW vbViews[2] = { vbView12, s_instanceVBView };
+        cmdList->IASetVertexBuffers(0, s_instanceVB ? 2 : 1, vbViews);
+        cmdList->IASetIndexBuffer(&ibView12);
+        cmdList->DrawIndexedInstanced(totalIndices12, s_instanceCount, 0, 0, 0);
+    }
 
     // ============== TEXT RENDERING (GPU cached) ==============
     // Only rebuild text when FPS changes (once per second) - NOT every frame!
@@ -740,50 +782,71 @@ void RenderD3D12()
             wcstombs_s(&converted, gpuNameA, sizeof(gpuNameA), gpuName.c_str(), _TRUNCATE);
         }
 
-        char infoText[512];
-        sprintf_s(infoText,
+        char infoText[768];
+        UINT drawn = s_gpuCull ? GpuCullVisibleCount12() : s_instanceCount;
+        unsigned long long triangles = (unsigned long long)totalIndices12 / 3 * drawn;
+        UINT visibleMeshlets = 0, totalMeshlets = 0, meshTriangles = 0;
+        if (s_meshShaders) {
+            MeshShaderStats12(visibleMeshlets, totalMeshlets, meshTriangles);
+            triangles = meshTriangles;
+        }
+        int len = sprintf_s(infoText,
             "API: Direct3D 12\n"
             "GPU: %s\n"
             "FPS: %d\n"
-            "Triangles: %u\n"
+            "Triangles: %llu\n"
             "Resolution: %ux%u",
-            gpuNameA, fps, totalIndices12 / 3, W, H);
-
-        // Build text vertices (only when changed)
-        g_textVertCount = 0;
-        DrawTextDirect(infoText, 12.0f, 12.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.5f); // Shadow
-        DrawTextDirect(infoText, 10.0f, 10.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.5f); // Main text
-
-        // Upload to GPU (only when changed)
-        memcpy(textVbMapped12, g_textVerts, g_textVertCount * sizeof(TextVert));
+            gpuNameA, fps, triangles, W, H);
+        if (s_meshShaders && len > 0) {
+            len += sprintf_s(infoText + len, sizeof(infoText) - len, "\nMesh shaders: %u / %u meshlets", visibleMeshlets, totalMeshlets);
+        } else if (s_gpuCull && len > 0) {
+            len += sprintf_s(infoText + len, sizeof(infoText) - len, "\nGPU culling: %u / %u drawn", drawn, s_instanceCount);
+        } else if (s_workerCount > 0 && len > 0) {
+            len += sprintf_s(infoText + len, sizeof(infoText) - len, "\nCPU record: %.2f ms (%u threads, %u draws)",
+                s_cpuRecordMs, s_workerCount, s_instanceCount);
+        } else if (s_sceneBundle && len > 0) {
+            len += sprintf_s(infoText + len, sizeof(infoText) - len, "\nCPU record: %.2f ms (bundles)", s_cpuRecordMs);
+        }
+        char latency[64];
+        LatencyFormat(latency, sizeof(latency));
+        if (latency[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", latency);
+        char vram[192];
+        VramFormat(vram, sizeof(vram));
+        if (vram[0] && len > 0) sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", vram);
+
+        // Glyph instances are rebuilt only if the string differs
+        OverlaySetText(g_overlay12.text, infoText);
     }
 
-    // Always draw text (uses cached vertex data)
-    if (g_textVertCount > 0 && textPso && textRootSig12 && srvHeap12) {
-        cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-        cmdList->SetPipelineState(textPso);
-        cmdList->SetGraphicsRootSignature(textRootSig12);
-
-        ID3D12DescriptorHeap* heaps[] = { srvHeap12 };
-        cmdList->SetDescriptorHeaps(1, heaps);
-        cmdList->SetGraphicsRootDescriptorTable(0, srvHeap12->GetGPUDescriptorHandleForHeapStart());
-
-        cmdList->IASetVertexBuffers(0, 1, &textVbView12);
-        cmdList->IASetIndexBuffer(nullptr);
-        cmdList->DrawInstanced(g_textVertCount, 1, 0, 0);
-    }
+    // Always draw text (instances copied into this frame's slice only after a change)
+    tail->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    Overlay12Draw(g_overlay12, tail, frameIndex, W, H);
 
     // Transition to present
     barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
     barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-    cmdList->ResourceBarrier(1, &barrier);
+    tail->ResourceBarrier(1, &barrier);
+
+    tail->Close();
+    if (s_workerCount > 0) {
+        WaitForMultipleObjects(s_workerCount, s_workerDone, TRUE, INFINITE);
+        ID3D12CommandList* lists[MAX_RECORD_THREADS + 2];
+        UINT n = 0;
+        lists[n++] = cmdList;
+        for (UINT i = 0; i < s_workerCount; i++) lists[n++] = s_workers[i].list;
+        lists[n++] = s_epilogueList;
+        cmdQueue->ExecuteCommandLists(n, lists);
+    } else {
+        ID3D12CommandList* cmdLists[] = { cmdList };
+        cmdQueue->ExecuteCommandLists(1, cmdLists);
+    }
 
-    cmdList->Close();
-    ID3D12CommandList* cmdLists[] = { cmdList };
-    cmdQueue->ExecuteCommandLists(1, cmdLists);
+    LARGE_INTEGER recordEnd;
+    QueryPerformanceCounter(&recordEnd);
+    s_cpuRecordMs = (double)(recordEnd.QuadPart - recordStart.QuadPart) * 1000.0 / g_perfFreq.QuadPart;
+    BenchmarkCpuRecordSample(s_cpuRecordMs);
 
-    UINT presentFlags = g_tearingSupported12 ? DXGI_PRESENT_ALLOW_TEARING : 0;
-    swap12->Present(0, presentFlags);
+    DxgiPresent(swap12, g_tearingSupported12);
     MoveToNextFrame();
 }
 
@@ -792,28 +855,41 @@ void CleanupD3D12()
 {
     WaitForGpu();
     // Text resources
-    if (textVB12) textVB12->Release();
-    if (fontTex12) fontTex12->Release();
-    if (textPso) textPso->Release();
-    if (textRootSig12) textRootSig12->Release();
-    if (srvHeap12) srvHeap12->Release();
+    CleanupFrameRing12(g_frameRing12);
+    Overlay12Cleanup(g_overlay12);
     // Main resources
-    if (fenceEvent) CloseHandle(fenceEvent);
-    if (fence) fence->Release();
-    if (cbUpload12) cbUpload12->Release();
-    if (ib12) ib12->Release();
-    if (vb12) vb12->Release();
-    if (pso) pso->Release();
-    if (rootSig) rootSig->Release();
-    if (cmdList) cmdList->Release();
+    if (fenceEvent) { CloseHandle(fenceEvent); fenceEvent = nullptr; }
+    if (fence) { fence->Release(); fence = nullptr; }
+    if (ib12) { ib12->Release(); ib12 = nullptr; }
+    if (vb12) { vb12->Release(); vb12 = nullptr; }
+    CleanupGpuCull12();
+    s_gpuCull = false;
+    CleanupMeshShaders12();
+    s_meshShaders = false;
+    StopRecordWorkers();
+    ReleaseSceneBundle();
+    if (s_instanceVB) { s_instanceVB->Release(); s_instanceVB = nullptr; }
+    s_instanceVBView = {};
+    s_instanceCount = 1;
+    if (pso) { pso->Release(); pso = nullptr; }
+    if (rootSig) { rootSig->Release(); rootSig = nullptr; }
+    if (cmdList) { cmdList->Release(); cmdList = nullptr; }
     for (UINT i = 0; i < FRAME_COUNT; i++) {
-        if (cmdAlloc[i]) cmdAlloc[i]->Release();
-        if (renderTargets12[i]) renderTargets12[i]->Release();
-    }
-    if (depthStencil12) depthStencil12->Release();
-    if (dsvHeap12) dsvHeap12->Release();
-    if (rtvHeap12) rtvHeap12->Release();
-    if (swap12) swap12->Release();
-    if (cmdQueue) cmdQueue->Release();
-    if (dev12) dev12->Release();
+        if (cmdAlloc[i]) { cmdAlloc[i]->Release(); cmdAlloc[i] = nullptr; }
+        if (renderTargets12[i]) { renderTargets12[i]->Release(); renderTargets12[i] = nullptr; }
+    }
+    if (depthStencil12) { depthStencil12->Release(); depthStencil12 = nullptr; }
+    if (dsvHeap12) { dsvHeap12->Release(); dsvHeap12 = nullptr; }
+    if (rtvHeap12) { rtvHeap12->Release(); rtvHeap12 = nullptr; }
+    if (swapWaitable12) { CloseHandle(swapWaitable12); swapWaitable12 = nullptr; }
+    if (swap12) { swap12->Release(); swap12 = nullptr; }
+    if (cmdQueue) { cmdQueue->Release(); cmdQueue = nullptr; }
+    if (dev12) { dev12->Release(); dev12 = nullptr; }
+
+    // Reset frame state so another D3D12 renderer can initialize cleanly
+    memset(fenceValues, 0, sizeof(fenceValues));
+    frameIndex = 0;
+    s_frameCb = 0;
+    g_cachedFps = -1;
+    g_textNeedsRebuild = true;
 }
@@ -7,23 +7,53 @@
 bool InitD3D12(HWND hwnd);
 void RenderD3D12();
 void CleanupD3D12();
+bool ResizeD3D12();
 
 // D3D12 + DXR 1.0 (TraceRay with raygen/hit/miss shaders)
 bool InitD3D12DXR10(HWND hwnd);
 void RenderD3D12DXR10();
 void CleanupD3D12DXR10();
+bool ResizeD3D12DXR10();
 
 // D3D12 + DXR 1.1 (Inline RayQuery in pixel shader)
 bool InitD3D12RT(HWND hwnd);
 void RenderD3D12RT();
 void CleanupD3D12RT();
+bool ResizeD3D12RT();
+const char* D3D12RTIndirectRateName();  // --rt-indirect rate, e.g. "half"
+UINT D3D12RTVrsTileSize();               // --vrs shading rate tile, 0 = off / unsupported
 
 // D3D12 + Path Tracing
 bool InitD3D12PT(HWND hwnd);
 void RenderD3D12PT();
 void CleanupD3D12PT();
+bool ResizeD3D12PT();
+// Mean paths per pixel per frame so far: read back from the GPU with
+// --adaptive, otherwise --spp
+float D3D12PTAverageSpp();
+// --split-gpu: adapter tracing the lower band (-1 = single GPU), its mean share
+// of the rows and mean trace time while the benchmark measured
+int D3D12PTSplitGpu();
+float D3D12PTSplitShare();
+double D3D12PTSplitSecondaryMs();
 
 // D3D12 + Path Tracing + DLSS Ray Reconstruction
 bool InitD3D12PT_DLSS(HWND hwnd);
 void RenderD3D12PT_DLSS();
 void CleanupD3D12PT_DLSS();
+bool ResizeD3D12PT_DLSS();
+const char* D3D12DlssModeName();      // --dlss quality mode, e.g. "Quality"
+// Mean input width / output width so far (1.0 = DLAA, lower with
+// --dlss-target-ms when the dynamic resolution controller backs off)
+float D3D12DlssAverageInputScale();
+// --frame-interp: interpolated frames per rendered frame so far (0 = off,
+// 1 = every frame)
+float D3D12DlssInterpolatedFrameRatio();
+// --frame-interp, over the benchmark window: frames DXGI reports as presented
+// to the screen (frame statistics) and presents issued; -1 = not available
+float D3D12DlssPresentedFps();
+float D3D12DlssSubmittedPresentFps();
+
+// Compile every DXR 1.0 / DXR 1.1 feature permutation into the DXIL cache,
+// spread over all CPU cores (--precompile-shaders / --precompile-only)
+bool PrecompileD3D12ShaderPermutations();
@@ -15,13 +15,28 @@ bool InitD3D12PT_DLSS(HWND hwnd) {
 }
 void RenderD3D12PT_DLSS() {}
 void CleanupD3D12PT_DLSS() {}
+bool ResizeD3D12PT_DLSS() { return false; }
+const char* D3D12DlssModeName() { return "n/a"; }
+float D3D12DlssAverageInputScale() { return 1.0f; }
+float D3D12DlssInterpolatedFrameRatio() { return 0.0f; }
+float D3D12DlssPresentedFps() { return -1.0f; }
+float D3D12DlssSubmittedPresentFps() { return -1.0f; }
 #else
 
 // Local includes
 #include "../common.h"
 #include "d3d12_shared.h"
 #include "renderer_d3d12.h"
+#include "../accumulation.h"
+#include "../rt_geometry.h"
+#include "../rt_sampling.h"
+#include "../startup_profiler.h"
+#include "../benchmark.h"
+#include "../vram_budget.h"
+#include "../group_tune.h"
 #include "../shaders/d3d12_dlss_shaders.h"
+#include "../shaders/rt_sampling_shaders.h"
+#include "../shaders/group_shape_shaders.h"
 
 // NVIDIA NGX SDK for DLSS Ray Reconstruction
 #include "nvsdk_ngx.h"
@@ -37,6 +52,8 @@ void CleanupD3D12PT_DLSS() {}
 #include <DirectXMath.h>
 #include <dxcapi.h>
 #include <vector>
+#include <string>
+#include <cmath>
 
 // Linker directives
 #pragma comment(lib, "d3d12.lib")
@@ -59,6 +76,7 @@ static ID3D12Resource* g_gbufferMotionVectors = nullptr;     // Screen-space mot
 // DLSS-specific resources
 ID3D12RootSignature* g_pathTraceGbufferRootSig = nullptr;  // Root sig for G-Buffer PT
 ID3D12PipelineState* g_pathTraceGbufferPSO = nullptr;      // PSO for G-Buffer PT
+static ID3D12PipelineState* s_gbufferVariants[GROUP_VARIANT_COUNT] = {};   // --group-size, [0] = g_pathTraceGbufferPSO
 ID3D12DescriptorHeap* g_dlssSrvUavHeap = nullptr;          // SRV/UAV heap for DLSS
 
 // Tone mapping for HDR->LDR conversion
@@ -66,19 +84,89 @@ ID3D12RootSignature* g_tonemapRootSig = nullptr;
 ID3D12PipelineState* g_tonemapPSO = nullptr;
 ID3D12DescriptorHeap* g_tonemapSrvHeap = nullptr;
 
-// DLSS constant buffer
-static ID3D12Resource* g_dlssCB = nullptr;
-static void* g_dlssCBMapped = nullptr;
-
 // Previous frame's ViewProj matrix for motion vectors
 static XMMATRIX g_prevViewProj = XMMatrixIdentity();
 
-// ============== CONSTANT BUFFER STRUCTURES ==============
-
-struct CB {
-    float time;
-    float _pad[3];
+// ============== INPUT RESOLUTION ==============
+// --dlss=<mode> / --dlss-target-ms (common.h). The G-buffer is allocated at
+// the mode's size (s_renderMaxW x s_renderMaxH) and traced into its top-left
+// s_renderW x s_renderH subrect; DLSS-RR writes g_dlssOutput at window size.
+#define DLSS_DYN_MIN_RATIO (1.0f / 3.0f)   // Dynamic floor when NGX doesn't report one
+#define DLSS_DYN_DEADBAND 0.05f            // Keep the size within +-5% of the target
+#define DLSS_DYN_GAIN 0.5f                 // Timestamps are FRAME_COUNT frames old - don't overshoot
+#define DLSS_JITTER_MIN_PHASES 8
+static const char* s_dlssModeNames[DLSS_MODE_COUNT] = { "DLAA", "Quality", "Balanced", "Performance", "Ultra Performance" };
+static const float s_dlssModeRatios[DLSS_MODE_COUNT] = { 1.0f, 0.667f, 0.58f, 0.5f, 0.333f };   // Fallback per-axis scale
+static const NVSDK_NGX_PerfQuality_Value s_dlssModeQuality[DLSS_MODE_COUNT] = {
+    NVSDK_NGX_PerfQuality_Value_DLAA, NVSDK_NGX_PerfQuality_Value_MaxQuality, NVSDK_NGX_PerfQuality_Value_Balanced,
+    NVSDK_NGX_PerfQuality_Value_MaxPerf, NVSDK_NGX_PerfQuality_Value_UltraPerformance };
+static const char* s_dlssModePresetParams[DLSS_MODE_COUNT] = {
+    NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_DLAA,
+    NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_Quality,
+    NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_Balanced,
+    NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_Performance,
+    NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_UltraPerformance };
+static UINT s_renderW = 0, s_renderH = 0;         // This frame's input size
+static UINT s_renderMaxW = 0, s_renderMaxH = 0;   // G-buffer size (the mode's input size)
+static UINT s_renderMinW = 0, s_renderMinH = 0;   // Dynamic resolution floor
+static float s_dynScale = 1.0f;                   // s_renderW / s_renderMaxW
+static UINT s_jitterIndex = 0;
+static bool s_dlssReset = true;                   // InReset on the first evaluation after (re)creation
+static double s_inputScaleSum = 0.0;              // Benchmark: mean s_renderW / W
+static UINT s_inputScaleFrames = 0;
+
+// ============== FRAME INTERPOLATION ==============
+// --frame-interp (common.h). This is NOT NVIDIA DLSS Frame Generation: NGX
+// only exposes that through Streamline, which this tree doesn't ship
+// (nvsdk_ngx_*_dlfg.h are empty placeholders). The interpolated frame comes
+// from the in-house FrameGenCS (d3d12_dlss_shaders.h), fed with the DLSS-RR
+// output, g_gbufferMotionVectors and g_gbufferDepth.
+// Both presents of a rendered frame go out at the end of that frame, so the
+// rendered one is held back to half the rendered-frame interval after the
+// interpolated one (and waits for its own slot in the --max-latency queue);
+// otherwise the interpolated frame would mostly be replaced before scan-out.
+// Presented fps comes from the swap chain's frame statistics, not from the
+// interpolated / rendered ratio.
+#define DLSS_FG_PHASE 0.5f
+#define DLSS_FG_MAX_HOLD_MS 50.0    // Pacing hold cap (interval not settled yet, hitches)
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002   // Windows 10 1803 SDK
+#endif
+static ID3D12Resource* s_fgPrevColor = nullptr;    // Last DLSS-RR output, NON_PIXEL_SHADER_RESOURCE between frames
+static ID3D12Resource* s_fgOutput = nullptr;       // Generated frame, UNORDERED_ACCESS between frames
+static ID3D12RootSignature* s_fgRootSig = nullptr;
+static ID3D12PipelineState* s_fgPSO = nullptr;
+static ID3D12DescriptorHeap* s_fgHeap = nullptr;   // t0 current, t1 previous, t2 motion, t3 depth, u0 output
+static bool s_fgHistoryValid = false;              // s_fgPrevColor holds a frame at the current size
+static UINT s_fgRendered = 0;
+static UINT s_fgInterpolated = 0;
+static LARGE_INTEGER s_fgQpcFreq = {};
+static LONGLONG s_fgInterpPresentQpc = 0;          // Last interpolated present
+static LONGLONG s_fgRenderedPresentQpc = 0;        // Last rendered present
+static double s_fgIntervalMs = 0.0;                // Rendered-frame interval, smoothed
+static HANDLE s_fgHoldTimer = nullptr;             // High-resolution waitable timer for the hold (null: spin)
+
+// Presented frame rate from DXGI_FRAME_STATISTICS: PresentCount is the id of
+// the newest present that reached the screen, SyncQPCTime when it did
+struct PresentRateSample {
+    UINT count;
+    LONGLONG qpc;
 };
+static PresentRateSample s_fgBenchFirst = {}, s_fgBenchLast = {};   // Benchmark measurement window
+static PresentRateSample s_fgWindowStart = {};                      // Overlay: one-second window
+static float s_fgPresentedDisplay = 0.0f;
+static UINT s_fgSubmitted = 0;                     // Presents issued while the benchmark measures
+static LONGLONG s_fgSubmitFirstQpc = 0, s_fgSubmitLastQpc = 0;
+
+struct FrameGenConstants {
+    UINT OutputWidth;
+    UINT OutputHeight;
+    UINT InputWidth;
+    UINT InputHeight;
+    float Phase;
+};
+
+// ============== CONSTANT BUFFER STRUCTURES ==============
 
 struct PathTraceCBData {
     XMFLOAT4X4 InvView;
@@ -87,6 +175,11 @@ struct PathTraceCBData {
     UINT FrameCount;
     UINT Width;
     UINT Height;
+    UINT AccumFrame;    // --accumulate sample index, 0 = off (accumulation.h)
+    UINT SamplesPerPixel;   // --spp
+    UINT MaxBounces;        // --bounces
+    UINT AdaptiveMaxSpp;    // --adaptive-max-spp, 0 = adaptive off
+    float AdaptiveTarget;   // --adaptive
 };
 
 struct PathTraceDlssCBData {
@@ -97,6 +190,8 @@ struct PathTraceDlssCBData {
     UINT FrameCount;
     UINT Width;
     UINT Height;
+    float JitterX;      // Camera sample offset from the pixel centre, in input pixels
+    float JitterY;
 };
 
 struct Vert {
@@ -185,18 +280,17 @@ static bool CreateDLSSRRFeature()
     dlssdCreateParams.InDenoiseMode = NVSDK_NGX_DLSS_Denoise_Mode_DLUnified;  // DL-based denoiser
     dlssdCreateParams.InRoughnessMode = NVSDK_NGX_DLSS_Roughness_Mode_Unpacked;  // Separate roughness buffer
     dlssdCreateParams.InUseHWDepth = NVSDK_NGX_DLSS_Depth_Type_Linear;  // We output linear depth
-    dlssdCreateParams.InWidth = W;
-    dlssdCreateParams.InHeight = H;
-    dlssdCreateParams.InTargetWidth = W;   // No upscaling, same resolution
+    dlssdCreateParams.InWidth = s_renderMaxW;   // Largest input; smaller frames use a subrect
+    dlssdCreateParams.InHeight = s_renderMaxH;
+    dlssdCreateParams.InTargetWidth = W;
     dlssdCreateParams.InTargetHeight = H;
-    dlssdCreateParams.InPerfQualityValue = NVSDK_NGX_PerfQuality_Value_Balanced;
+    dlssdCreateParams.InPerfQualityValue = s_dlssModeQuality[g_dlssMode];
     dlssdCreateParams.InFeatureCreateFlags = NVSDK_NGX_DLSS_Feature_Flags_IsHDR |
                                               NVSDK_NGX_DLSS_Feature_Flags_MVLowRes;
     dlssdCreateParams.InEnableOutputSubrects = false;
 
     // Set Ray Reconstruction preset (D for transformer model - best quality)
-    ngxParams->Set(NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_Balanced,
-        (int)NVSDK_NGX_RayReconstruction_Hint_Render_Preset_D);
+    ngxParams->Set(s_dlssModePresetParams[g_dlssMode], (int)NVSDK_NGX_RayReconstruction_Hint_Render_Preset_D);
 
     // Create command list for feature creation
     cmdList->Reset(cmdAlloc[0], nullptr);
@@ -224,20 +318,115 @@ static bool CreateDLSSRRFeature()
         return false;
     }
 
-    Log("[INFO] DLSS Ray Reconstruction feature created successfully\n");
+    s_dlssReset = true;
+    Log("[INFO] DLSS Ray Reconstruction feature created successfully (%s, %ux%u -> %ux%u)\n",
+        s_dlssModeNames[g_dlssMode], s_renderMaxW, s_renderMaxH, W, H);
     return true;
 }
 
+// ============== INPUT RESOLUTION ==============
+// Mode's input size for the current window, from NGX when it reports one
+static void ChooseDlssRenderSize()
+{
+    float ratio = s_dlssModeRatios[g_dlssMode];
+    s_renderMaxW = (UINT)(W * ratio + 0.5f);
+    s_renderMaxH = (UINT)(H * ratio + 0.5f);
+    s_renderMinW = (UINT)(W * DLSS_DYN_MIN_RATIO + 0.5f);
+    s_renderMinH = (UINT)(H * DLSS_DYN_MIN_RATIO + 0.5f);
+
+    unsigned int optW = 0, optH = 0, maxW = 0, maxH = 0, minW = 0, minH = 0;
+    float sharpness = 0.0f;
+    if (g_ngxParams && NVSDK_NGX_SUCCEED(NGX_DLSSD_GET_OPTIMAL_SETTINGS(g_ngxParams, W, H, s_dlssModeQuality[g_dlssMode],
+            &optW, &optH, &maxW, &maxH, &minW, &minH, &sharpness)) && optW && optH) {
+        s_renderMaxW = optW;
+        s_renderMaxH = optH;
+        if (minW && minH && minW <= optW && minH <= optH) {
+            s_renderMinW = minW;
+            s_renderMinH = minH;
+        }
+    }
+    if (s_renderMaxW < 1) s_renderMaxW = 1;
+    if (s_renderMaxH < 1) s_renderMaxH = 1;
+    if (s_renderMinW < 1 || s_renderMinW > s_renderMaxW) s_renderMinW = s_renderMaxW;
+    if (s_renderMinH < 1 || s_renderMinH > s_renderMaxH) s_renderMinH = s_renderMaxH;
+
+    s_renderW = s_renderMaxW;
+    s_renderH = s_renderMaxH;
+    s_dynScale = 1.0f;
+    Log("[INFO] DLSS %s: input %ux%u for %ux%u output\n", s_dlssModeNames[g_dlssMode],
+        s_renderMaxW, s_renderMaxH, W, H);
+    if (g_dlssTargetMs > 0.0f)
+        Log("[INFO] DLSS dynamic resolution: %.2f ms target, input %ux%u .. %ux%u\n",
+            g_dlssTargetMs, s_renderMinW, s_renderMinH, s_renderMaxW, s_renderMaxH);
+}
+
+// --dlss-target-ms: path tracing cost is roughly linear in the pixel count,
+// so the per-axis scale moves by sqrt(target / measured), damped
+static void UpdateDynamicResolution()
+{
+    if (g_dlssTargetMs <= 0.0f || !g_dlssRRHandle) return;
+    double gpuMs = GpuTimerLastFrameMs12();
+    if (gpuMs <= 0.0) return;
+    double ratio = g_dlssTargetMs / gpuMs;
+    if (fabs(ratio - 1.0) < DLSS_DYN_DEADBAND) return;
+
+    float wanted = s_dynScale * (float)sqrt(ratio);
+    s_dynScale += (wanted - s_dynScale) * DLSS_DYN_GAIN;
+    float minScale = (float)s_renderMinW / s_renderMaxW;
+    if ((float)s_renderMinH / s_renderMaxH > minScale) minScale = (float)s_renderMinH / s_renderMaxH;
+    if (s_dynScale < minScale) s_dynScale = minScale;
+    if (s_dynScale > 1.0f) s_dynScale = 1.0f;
+
+    s_renderW = (UINT)(s_renderMaxW * s_dynScale + 0.5f);
+    s_renderH = (UINT)(s_renderMaxH * s_dynScale + 0.5f);
+    if (s_renderW < s_renderMinW) s_renderW = s_renderMinW;
+    if (s_renderH < s_renderMinH) s_renderH = s_renderMinH;
+    if (s_renderW > s_renderMaxW) s_renderW = s_renderMaxW;
+    if (s_renderH > s_renderMaxH) s_renderH = s_renderMaxH;
+}
+
+// Halton (2, 3) camera jitter in [-0.5, 0.5), 8 phases per upscale factor squared
+static float Halton(UINT index, UINT base)
+{
+    float f = 1.0f, r = 0.0f;
+    for (UINT i = index; i > 0; i /= base) {
+        f /= base;
+        r += f * (i % base);
+    }
+    return r;
+}
+
+static void NextJitter(float& x, float& y)
+{
+    float upscale = (float)W / s_renderW;
+    UINT phases = (UINT)(DLSS_JITTER_MIN_PHASES * upscale * upscale + 0.5f);
+    if (phases < DLSS_JITTER_MIN_PHASES) phases = DLSS_JITTER_MIN_PHASES;
+    UINT index = (s_jitterIndex++ % phases) + 1;
+    x = Halton(index, 2) - 0.5f;
+    y = Halton(index, 3) - 0.5f;
+}
+
+const char* D3D12DlssModeName()
+{
+    return s_dlssModeNames[g_dlssMode];
+}
+
+float D3D12DlssAverageInputScale()
+{
+    return s_inputScaleFrames ? (float)(s_inputScaleSum / s_inputScaleFrames) : 1.0f;
+}
+
 // ============== CREATE G-BUFFER TEXTURES ==============
 
 static bool CreateGBufferTextures()
 {
     Log("[INFO] Creating G-Buffer textures for DLSS-RR...\n");
+    ChooseDlssRenderSize();
 
     D3D12_RESOURCE_DESC texDesc = {};
     texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    texDesc.Width = W;
-    texDesc.Height = H;
+    texDesc.Width = s_renderMaxW;
+    texDesc.Height = s_renderMaxH;
     texDesc.DepthOrArraySize = 1;
     texDesc.MipLevels = 1;
     texDesc.SampleDesc.Count = 1;
@@ -300,7 +489,9 @@ static bool CreateGBufferTextures()
         return false;
     }
 
-    // DLSS output (RGBA16F)
+    // DLSS output (RGBA16F) at window size
+    texDesc.Width = W;
+    texDesc.Height = H;
     texDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
     if (FAILED(dev12->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &texDesc,
         D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&g_dlssOutput)))) {
@@ -312,31 +503,374 @@ static bool CreateGBufferTextures()
     return true;
 }
 
+// ============== G-BUFFER DESCRIPTORS ==============
+// Views of the input-size textures; rewritten after CreateGBufferTextures on resize
+
+static void WriteGBufferUAVs()
+{
+    UINT descSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = g_dlssSrvUavHeap->GetCPUDescriptorHandleForHeapStart();
+    cpuHandle.ptr += 3 * descSize;  // After TLAS, vertices, indices SRVs
+
+    // UAV 0: HDR noisy color output (RGBA16F)
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    uavDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    dev12->CreateUnorderedAccessView(g_gbufferColor, nullptr, &uavDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // UAV 1: Diffuse Albedo (RGBA16F)
+    dev12->CreateUnorderedAccessView(g_gbufferDiffuseAlbedo, nullptr, &uavDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // UAV 2: Specular Albedo
+    dev12->CreateUnorderedAccessView(g_gbufferSpecularAlbedo, nullptr, &uavDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // UAV 3: Normals
+    dev12->CreateUnorderedAccessView(g_gbufferNormals, nullptr, &uavDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // UAV 4: Roughness
+    uavDesc.Format = DXGI_FORMAT_R16_FLOAT;
+    dev12->CreateUnorderedAccessView(g_gbufferRoughness, nullptr, &uavDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // UAV 5: Depth
+    uavDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    dev12->CreateUnorderedAccessView(g_gbufferDepth, nullptr, &uavDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // UAV 6: Motion Vectors
+    uavDesc.Format = DXGI_FORMAT_R16G16_FLOAT;
+    dev12->CreateUnorderedAccessView(g_gbufferMotionVectors, nullptr, &uavDesc, cpuHandle);
+}
+
+static void WriteTonemapSRVs()
+{
+    UINT descSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = g_tonemapSrvHeap->GetCPUDescriptorHandleForHeapStart();
+
+    // SRV 0: g_gbufferColor (noisy HDR)
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Texture2D.MipLevels = 1;
+    dev12->CreateShaderResourceView(g_gbufferColor, &srvDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // SRV 1: g_dlssOutput (denoised HDR)
+    dev12->CreateShaderResourceView(g_dlssOutput, &srvDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // SRV 2: s_fgOutput (interpolated frame, --frame-interp)
+    if (s_fgOutput) dev12->CreateShaderResourceView(s_fgOutput, &srvDesc, cpuHandle);
+}
+
+// ============== FRAME INTERPOLATION ==============
+static void ReleaseFrameGenTargets()
+{
+    if (s_fgPrevColor) { s_fgPrevColor->Release(); s_fgPrevColor = nullptr; }
+    if (s_fgOutput) { s_fgOutput->Release(); s_fgOutput = nullptr; }
+    s_fgHistoryValid = false;
+}
+
+// Window-size history and output, recreated on resize
+static bool CreateFrameGenTargets()
+{
+    D3D12_RESOURCE_DESC texDesc = {};
+    texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    texDesc.Width = W;
+    texDesc.Height = H;
+    texDesc.DepthOrArraySize = 1;
+    texDesc.MipLevels = 1;
+    texDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    texDesc.SampleDesc.Count = 1;
+    texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+
+    D3D12_HEAP_PROPERTIES heapProps = {};
+    heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    if (FAILED(dev12->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &texDesc,
+        D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, nullptr, IID_PPV_ARGS(&s_fgPrevColor)))) {
+        Log("[ERROR] Failed to create frame interpolation history texture\n");
+        return false;
+    }
+    texDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    if (FAILED(dev12->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &texDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_fgOutput)))) {
+        Log("[ERROR] Failed to create frame interpolation output texture\n");
+        return false;
+    }
+    s_fgHistoryValid = false;
+    return true;
+}
+
+static void WriteFrameGenViews()
+{
+    UINT descSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = s_fgHeap->GetCPUDescriptorHandleForHeapStart();
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Texture2D.MipLevels = 1;
+
+    // t0 = g_dlssOutput, t1 = s_fgPrevColor
+    srvDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    dev12->CreateShaderResourceView(g_dlssOutput, &srvDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+    dev12->CreateShaderResourceView(s_fgPrevColor, &srvDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // t2 = motion vectors, t3 = linear depth
+    srvDesc.Format = DXGI_FORMAT_R16G16_FLOAT;
+    dev12->CreateShaderResourceView(g_gbufferMotionVectors, &srvDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+    srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    dev12->CreateShaderResourceView(g_gbufferDepth, &srvDesc, cpuHandle);
+    cpuHandle.ptr += descSize;
+
+    // u0 = s_fgOutput
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    uavDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    dev12->CreateUnorderedAccessView(s_fgOutput, nullptr, &uavDesc, cpuHandle);
+}
+
+static bool InitFrameGen()
+{
+    if (!CreateFrameGenTargets()) return false;
+
+    // Root signature: b0 = constants, table = t0-t3 + u0, s0 = linear clamp
+    D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+    ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[0].NumDescriptors = 4;
+    ranges[0].BaseShaderRegister = 0;
+    ranges[0].OffsetInDescriptorsFromTableStart = 0;
+    ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    ranges[1].NumDescriptors = 1;
+    ranges[1].BaseShaderRegister = 0;
+    ranges[1].OffsetInDescriptorsFromTableStart = 4;
+
+    D3D12_ROOT_PARAMETER rootParams[2] = {};
+    rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    rootParams[0].Constants.ShaderRegister = 0;
+    rootParams[0].Constants.Num32BitValues = sizeof(FrameGenConstants) / 4;
+    rootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParams[1].DescriptorTable.NumDescriptorRanges = 2;
+    rootParams[1].DescriptorTable.pDescriptorRanges = ranges;
+    rootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_STATIC_SAMPLER_DESC sampler = {};
+    sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    sampler.ShaderRegister = 0;
+    sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
+    rsDesc.NumParameters = 2;
+    rsDesc.pParameters = rootParams;
+    rsDesc.NumStaticSamplers = 1;
+    rsDesc.pStaticSamplers = &sampler;
+
+    ID3DBlob* sigBlob = nullptr;
+    ID3DBlob* errBlob = nullptr;
+    if (FAILED(D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob))) {
+        if (errBlob) { Log("[ERROR] Frame interpolation root sig: %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        return false;
+    }
+    HRESULT hr = dev12->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&s_fgRootSig));
+    sigBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateRootSignature (frame interpolation)", hr); return false; }
+
+    LPCWSTR args[] = { L"-E", L"FrameGenCS", L"-T", L"cs_6_0" };
+    ID3DBlob* shaderBlob = nullptr;
+    if (!CompileDXC(g_frameGenShaderCode, args, _countof(args), &shaderBlob, "FrameGenCS")) return false;
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.pRootSignature = s_fgRootSig;
+    psoDesc.CS.pShaderBytecode = shaderBlob->GetBufferPointer();
+    psoDesc.CS.BytecodeLength = shaderBlob->GetBufferSize();
+    hr = PipelineCacheCreateCompute(dev12, L"FrameGenCS", psoDesc, &s_fgPSO);
+    shaderBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateComputePipelineState (frame interpolation)", hr); return false; }
+
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+    heapDesc.NumDescriptors = 5;
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    hr = dev12->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&s_fgHeap));
+    if (FAILED(hr)) { LogHR("CreateDescriptorHeap (frame interpolation)", hr); return false; }
+    WriteFrameGenViews();
+
+    s_fgRendered = 0;
+    s_fgInterpolated = 0;
+    s_fgInterpPresentQpc = s_fgRenderedPresentQpc = 0;
+    s_fgIntervalMs = 0.0;
+    s_fgBenchFirst = s_fgBenchLast = s_fgWindowStart = {};
+    s_fgPresentedDisplay = 0.0f;
+    s_fgSubmitted = 0;
+    s_fgSubmitFirstQpc = s_fgSubmitLastQpc = 0;
+    QueryPerformanceFrequency(&s_fgQpcFreq);
+    // Sleep(1) rounds up to the system timer tick (15.6 ms by default), far
+    // longer than the hold; the high-resolution timer wakes within ~0.5 ms
+    if (!s_fgHoldTimer)
+        s_fgHoldTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!s_fgHoldTimer) Log("[WARN] Frame interpolation: no high-resolution timer (error %lu), pacing spins\n", GetLastError());
+    Log("[INFO] Frame interpolation enabled (in-house motion vector interpolation after DLSS-RR, not NVIDIA DLSS-FG; 1 per rendered frame)\n");
+    return true;
+}
+
+static void CleanupFrameGen()
+{
+    ReleaseFrameGenTargets();
+    if (s_fgPSO) { s_fgPSO->Release(); s_fgPSO = nullptr; }
+    if (s_fgRootSig) { s_fgRootSig->Release(); s_fgRootSig = nullptr; }
+    if (s_fgHeap) { s_fgHeap->Release(); s_fgHeap = nullptr; }
+    if (s_fgHoldTimer) { CloseHandle(s_fgHoldTimer); s_fgHoldTimer = nullptr; }
+}
+
+float D3D12DlssInterpolatedFrameRatio()
+{
+    return s_fgRendered ? (float)s_fgInterpolated / s_fgRendered : 0.0f;
+}
+
+float D3D12DlssPresentedFps()
+{
+    if (!s_fgPSO || !s_fgQpcFreq.QuadPart || s_fgBenchLast.qpc <= s_fgBenchFirst.qpc) return -1.0f;
+    double seconds = (double)(s_fgBenchLast.qpc - s_fgBenchFirst.qpc) / s_fgQpcFreq.QuadPart;
+    return (float)((s_fgBenchLast.count - s_fgBenchFirst.count) / seconds);
+}
+
+float D3D12DlssSubmittedPresentFps()
+{
+    if (!s_fgPSO || !s_fgQpcFreq.QuadPart || s_fgSubmitted < 2 || s_fgSubmitLastQpc <= s_fgSubmitFirstQpc) return -1.0f;
+    double seconds = (double)(s_fgSubmitLastQpc - s_fgSubmitFirstQpc) / s_fgQpcFreq.QuadPart;
+    return (float)((s_fgSubmitted - 1) / seconds);
+}
+
+static LONGLONG FrameInterpNowQpc()
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+// Rendered frame after an interpolated one: take its own --max-latency slot,
+// then hold the present until half a rendered-frame interval has passed
+// since the interpolated present
+static void PaceRenderedPresent()
+{
+    DxgiWaitPresentSlot(swapWaitable12);
+    if (s_fgIntervalMs <= 0.0 || !s_fgInterpPresentQpc) return;
+    double holdMs = min(s_fgIntervalMs * 0.5, DLSS_FG_MAX_HOLD_MS);
+    LONGLONG target = s_fgInterpPresentQpc + (LONGLONG)(holdMs * s_fgQpcFreq.QuadPart / 1000.0);
+    for (LONGLONG now = FrameInterpNowQpc(); now < target; now = FrameInterpNowQpc()) {
+        // Wait on the timer until ~1 ms remain (its wake-up jitter), spin the rest
+        LONGLONG remaining100ns = (target - now) * 10000000 / s_fgQpcFreq.QuadPart;
+        if (s_fgHoldTimer && remaining100ns > 10000) {
+            LARGE_INTEGER due;
+            due.QuadPart = -(remaining100ns - 10000);   // Relative
+            if (SetWaitableTimer(s_fgHoldTimer, &due, 0, nullptr, nullptr, FALSE))
+                WaitForSingleObject(s_fgHoldTimer, INFINITE);
+            continue;
+        }
+        YieldProcessor();
+    }
+}
+
+// After each present: timing for the pacing and the presented frame rate
+static void TrackPresent(bool interpolated)
+{
+    LONGLONG now = FrameInterpNowQpc();
+    if (interpolated) {
+        s_fgInterpPresentQpc = now;
+    } else {
+        if (s_fgRenderedPresentQpc) {
+            double ms = (double)(now - s_fgRenderedPresentQpc) * 1000.0 / s_fgQpcFreq.QuadPart;
+            s_fgIntervalMs = s_fgIntervalMs > 0.0 ? s_fgIntervalMs * 0.9 + ms * 0.1 : ms;
+        }
+        s_fgRenderedPresentQpc = now;
+    }
+
+    bool measuring = g_benchConfig.enabled && BenchmarkIsMeasuring();
+    if (measuring) {
+        if (!s_fgSubmitted) s_fgSubmitFirstQpc = now;
+        s_fgSubmitLastQpc = now;
+        s_fgSubmitted++;
+    }
+
+    DXGI_FRAME_STATISTICS stats = {};
+    if (FAILED(swap12->GetFrameStatistics(&stats)) || !stats.PresentCount) return;
+    PresentRateSample sample = { stats.PresentCount, stats.SyncQPCTime.QuadPart };
+    if (measuring) {
+        if (!s_fgBenchFirst.count) s_fgBenchFirst = sample;
+        s_fgBenchLast = sample;
+    }
+    if (!s_fgWindowStart.count || sample.count < s_fgWindowStart.count) {
+        s_fgWindowStart = sample;
+    } else if (sample.qpc - s_fgWindowStart.qpc >= s_fgQpcFreq.QuadPart) {
+        double seconds = (double)(sample.qpc - s_fgWindowStart.qpc) / s_fgQpcFreq.QuadPart;
+        s_fgPresentedDisplay = (float)((sample.count - s_fgWindowStart.count) / seconds);
+        s_fgWindowStart = sample;
+    }
+}
+
+// ============== VRAM CATEGORIES ==============
+// The path tracer's acceleration structures and images plus the DLSS inputs,
+// frame interpolation copies and the memory NGX allocated for the feature
+static void VramCategoriesDLSS(UINT64 bytes[VRAM_CATEGORY_COUNT])
+{
+    VramCategoriesPT(bytes);
+    bytes[VRAM_GBUFFER] += ResourceBytes12(g_gbufferColor) + ResourceBytes12(g_gbufferDiffuseAlbedo) +
+                           ResourceBytes12(g_gbufferSpecularAlbedo) + ResourceBytes12(g_gbufferNormals) +
+                           ResourceBytes12(g_gbufferRoughness) + ResourceBytes12(g_gbufferMotionVectors) +
+                           ResourceBytes12(g_gbufferDepth);
+    bytes[VRAM_HISTORY] += ResourceBytes12(s_fgPrevColor);
+    bytes[VRAM_DLSS] += ResourceBytes12(g_dlssOutput) + ResourceBytes12(s_fgOutput);
+    unsigned long long ngxBytes = 0;
+    if (g_ngxParams && NVSDK_NGX_SUCCEED(NGX_DLSS_GET_STATS(g_ngxParams, &ngxBytes))) bytes[VRAM_DLSS] += ngxBytes;
+}
+
 // ============== INIT D3D12 PATH TRACING + DLSS ==============
 
 bool InitD3D12PT_DLSS(HWND hwnd)
 {
     Log("[INFO] Initializing Direct3D 12 with Path Tracing + DLSS Ray Reconstruction...\n");
-
-    // First initialize the base D3D12 PT
-    if (!InitD3D12PT(hwnd)) {
+    s_inputScaleSum = 0.0;
+    s_inputScaleFrames = 0;
+    s_jitterIndex = 0;
+
+    // First initialize the base D3D12 PT (its steps nest under this phase)
+    StartupPhaseBegin("Path tracing base");
+    bool baseOK = InitD3D12PT(hwnd);
+    StartupPhaseEnd();
+    if (!baseOK) {
         Log("[ERROR] Failed to initialize base D3D12 PT\n");
         return false;
     }
 
     // Initialize NGX
+    StartupStep("NGX init");
     if (!InitNGX()) {
         Log("[ERROR] NGX initialization failed - DLSS-RR not available\n");
         return true;  // Continue with basic PT
     }
 
     // Create G-Buffer textures
+    StartupStep("G-buffer targets");
     if (!CreateGBufferTextures()) {
         Log("[ERROR] Failed to create G-Buffer textures\n");
         return false;
     }
 
     // Create DLSS-RR feature
+    StartupStep("DLSS-RR feature");
     if (!CreateDLSSRRFeature()) {
         Log("[ERROR] Failed to create DLSS-RR feature\n");
         g_dlssRRSupported = false;
@@ -350,9 +884,10 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         return false;
     }
 
-    // Create G-Buffer root signature (CBV + SRVs + 7 UAVs)
+    // Create G-Buffer root signature (CBV + SRVs + 7 UAVs + blue noise)
+    StartupStep("G-buffer + tonemap pipelines");
     {
-        D3D12_DESCRIPTOR_RANGE1 srvUavRanges[2] = {};
+        D3D12_DESCRIPTOR_RANGE1 srvUavRanges[3] = {};
         // SRVs: t0 = TLAS, t1 = Vertices, t2 = Indices
         srvUavRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
         srvUavRanges[0].NumDescriptors = 3;
@@ -365,6 +900,12 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         srvUavRanges[1].BaseShaderRegister = 0;
         srvUavRanges[1].RegisterSpace = 0;
         srvUavRanges[1].OffsetInDescriptorsFromTableStart = 3;
+        // SRV: t0 space1 = --sampler=bluenoise tile (descriptor 10)
+        srvUavRanges[2].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        srvUavRanges[2].NumDescriptors = 1;
+        srvUavRanges[2].BaseShaderRegister = 0;
+        srvUavRanges[2].RegisterSpace = 1;
+        srvUavRanges[2].OffsetInDescriptorsFromTableStart = 10;
 
         D3D12_ROOT_PARAMETER1 rootParams[2] = {};
         rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
@@ -373,7 +914,7 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         rootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
         rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-        rootParams[1].DescriptorTable.NumDescriptorRanges = 2;
+        rootParams[1].DescriptorTable.NumDescriptorRanges = 3;
         rootParams[1].DescriptorTable.pDescriptorRanges = srvUavRanges;
         rootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
@@ -401,65 +942,36 @@ bool InitD3D12PT_DLSS(HWND hwnd)
     // Compile G-Buffer path tracing shader
     {
         Log("[INFO] Compiling G-Buffer path tracing shader...\n");
-        HMODULE dxcModule = LoadLibraryW(L"dxcompiler.dll");
-        if (!dxcModule) {
-            Log("[ERROR] Failed to load dxcompiler.dll\n");
+        // Vertex / index fetch variant matching vb12 / ib12 (rt_geometry.h)
+        // and the --sampler backend (rt_sampling.h)
+        std::vector<LPCWSTR> args = { L"-T", L"cs_6_5", L"-E", L"PathTraceDlssCS", L"-D", RtSamplerDefine() };
+        if (vbStride12 == sizeof(RTCompactVert)) { args.push_back(L"-D"); args.push_back(L"COMPACT_VERTS"); }
+        if (ib16Bit12) { args.push_back(L"-D"); args.push_back(L"INDEX16"); }
+        ID3DBlob* shaderBlob = nullptr;
+        std::string source = std::string(g_groupShapeShaderCode) + g_rtSamplingShaderCode + g_ptDlssShaderCode;
+        if (!CompileDXC(source.c_str(), args.data(), (UINT)args.size(), &shaderBlob, "PathTraceDlssCS")) {
+            Log("[ERROR] G-Buffer shader compile failed\n");
             return false;
         }
-        DxcCreateInstanceProc DxcCreateInstance = (DxcCreateInstanceProc)GetProcAddress(dxcModule, "DxcCreateInstance");
-
-        IDxcCompiler3* compiler = nullptr;
-        IDxcUtils* utils = nullptr;
-        DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler));
-        DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils));
-
-        IDxcBlobEncoding* sourceBlob = nullptr;
-        utils->CreateBlob(g_ptDlssShaderCode, (UINT)strlen(g_ptDlssShaderCode), CP_UTF8, &sourceBlob);
-
-        LPCWSTR args[] = { L"-T", L"cs_6_5", L"-E", L"PathTraceDlssCS" };
-        DxcBuffer sourceBuffer = { sourceBlob->GetBufferPointer(), sourceBlob->GetBufferSize(), CP_UTF8 };
-
-        IDxcResult* result = nullptr;
-        compiler->Compile(&sourceBuffer, args, _countof(args), nullptr, IID_PPV_ARGS(&result));
-
-        HRESULT hrStatus;
-        result->GetStatus(&hrStatus);
-        if (FAILED(hrStatus)) {
-            IDxcBlobEncoding* errors = nullptr;
-            result->GetErrorBuffer(&errors);
-            Log("[ERROR] G-Buffer shader compile failed: %s\n", (char*)errors->GetBufferPointer());
-            errors->Release();
-            result->Release();
-            sourceBlob->Release();
-            compiler->Release();
-            utils->Release();
-            return false;
-        }
-
-        IDxcBlob* shaderBlob = nullptr;
-        result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
 
         D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
         psoDesc.pRootSignature = g_pathTraceGbufferRootSig;
         psoDesc.CS.pShaderBytecode = shaderBlob->GetBufferPointer();
         psoDesc.CS.BytecodeLength = shaderBlob->GetBufferSize();
 
-        if (FAILED(dev12->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(&g_pathTraceGbufferPSO)))) {
+        if (FAILED(PipelineCacheCreateCompute(dev12, L"PathTraceDlssCS", psoDesc, &g_pathTraceGbufferPSO))) {
             Log("[ERROR] Failed to create G-Buffer PSO\n");
             shaderBlob->Release();
-            result->Release();
-            sourceBlob->Release();
-            compiler->Release();
-            utils->Release();
             return false;
         }
 
         Log("[INFO] G-Buffer PSO created (shader size: %zu)\n", shaderBlob->GetBufferSize());
         shaderBlob->Release();
-        result->Release();
-        sourceBlob->Release();
-        compiler->Release();
-        utils->Release();
+
+        // --group-size variants (group_tune.h); the pathTracePSO fallback stays 8x8
+        UINT groupMask = GroupTuneBegin12(dev12, GROUP_KERNEL_DLSS_GBUFFER);
+        GroupCreateVariants12(dev12, GROUP_KERNEL_DLSS_GBUFFER, groupMask, source.c_str(), args.data(), (UINT)args.size(),
+                              g_pathTraceGbufferRootSig, g_pathTraceGbufferPSO, s_gbufferVariants);
 
         // Check if device was removed during PSO creation
         hrRemoved = dev12->GetDeviceRemovedReason();
@@ -469,10 +981,10 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         }
     }
 
-    // Create descriptor heap for G-Buffer (3 SRVs + 7 UAVs = 10 descriptors)
+    // Create descriptor heap for G-Buffer (3 SRVs + 7 UAVs + blue noise = 11 descriptors)
     {
         D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
-        heapDesc.NumDescriptors = 10;
+        heapDesc.NumDescriptors = 11;
         heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
         heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
 
@@ -492,60 +1004,22 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         dev12->CreateShaderResourceView(nullptr, &srvDesc, cpuHandle);
         cpuHandle.ptr += descSize;
 
-        // SRV 1: Vertices
-        srvDesc = {};
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Buffer.NumElements = totalVertices12;
-        srvDesc.Buffer.StructureByteStride = sizeof(Vert);
-        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
-        dev12->CreateShaderResourceView(vb12, &srvDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
-
-        // SRV 2: Indices
-        srvDesc = {};
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Buffer.NumElements = totalIndices12;
-        srvDesc.Buffer.StructureByteStride = sizeof(UINT);
-        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
-        dev12->CreateShaderResourceView(ib12, &srvDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
-
-        // UAV 0: HDR noisy color output (RGBA16F)
-        D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
-        uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
-        uavDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-        dev12->CreateUnorderedAccessView(g_gbufferColor, nullptr, &uavDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
-
-        // UAV 1: Diffuse Albedo (RGBA16F)
-        dev12->CreateUnorderedAccessView(g_gbufferDiffuseAlbedo, nullptr, &uavDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
+        // SRV 1, 2: Vertices / Indices in the layout InitD3D12PT uploaded (--compact-verts)
+        D3D12_CPU_DESCRIPTOR_HANDLE indicesHandle = cpuHandle;
+        indicesHandle.ptr += descSize;
+        RTMeshCreateSrvs12(dev12, vb12, totalVertices12, vbStride12, ib12, totalIndices12, ib16Bit12,
+                           cpuHandle, indicesHandle);
+        cpuHandle.ptr += 2 * descSize;
 
-        // UAV 2: Specular Albedo
-        dev12->CreateUnorderedAccessView(g_gbufferSpecularAlbedo, nullptr, &uavDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
+        // UAV 0-6: G-Buffer outputs (descriptors 3-9, rewritten on resize)
+        WriteGBufferUAVs();
 
-        // UAV 3: Normals
-        dev12->CreateUnorderedAccessView(g_gbufferNormals, nullptr, &uavDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
-
-        // UAV 4: Roughness
-        uavDesc.Format = DXGI_FORMAT_R16_FLOAT;
-        dev12->CreateUnorderedAccessView(g_gbufferRoughness, nullptr, &uavDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
-
-        // UAV 5: Depth
-        uavDesc.Format = DXGI_FORMAT_R32_FLOAT;
-        dev12->CreateUnorderedAccessView(g_gbufferDepth, nullptr, &uavDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
+        // SRV 10: blue noise tile InitD3D12PT uploaded (null view for the other samplers)
+        D3D12_CPU_DESCRIPTOR_HANDLE blueNoiseHandle = g_dlssSrvUavHeap->GetCPUDescriptorHandleForHeapStart();
+        blueNoiseHandle.ptr += 10 * descSize;
+        RTBlueNoiseCreateSrv12(dev12, blueNoise12, blueNoiseHandle);
 
-        // UAV 6: Motion Vectors
-        uavDesc.Format = DXGI_FORMAT_R16G16_FLOAT;
-        dev12->CreateUnorderedAccessView(g_gbufferMotionVectors, nullptr, &uavDesc, cpuHandle);
-
-        Log("[INFO] G-Buffer descriptor heap created (10 descriptors)\n");
+        Log("[INFO] G-Buffer descriptor heap created (11 descriptors)\n");
 
         // Check if device was removed during descriptor heap creation
         hrRemoved = dev12->GetDeviceRemovedReason();
@@ -565,28 +1039,7 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         return false;
     }
 
-    // Create DLSS constant buffer (larger, includes PrevViewProj)
-    D3D12_HEAP_PROPERTIES heapProps = {};
-    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-
-    D3D12_RESOURCE_DESC cbDesc = {};
-    cbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    cbDesc.Width = (sizeof(PathTraceDlssCBData) + 255) & ~255;
-    cbDesc.Height = 1;
-    cbDesc.DepthOrArraySize = 1;
-    cbDesc.MipLevels = 1;
-    cbDesc.SampleDesc.Count = 1;
-    cbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-    HRESULT hrCB = dev12->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &cbDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&g_dlssCB));
-    if (FAILED(hrCB)) {
-        Log("[ERROR] Failed to create DLSS constant buffer: 0x%08X (size=%zu)\n", hrCB, (size_t)cbDesc.Width);
-        return false;
-    }
-
-    D3D12_RANGE readRange = { 0, 0 };
-    g_dlssCB->Map(0, &readRange, &g_dlssCBMapped);
+    // DLSS constants (PathTraceDlssCBData, includes PrevViewProj) come from g_frameRing12 per frame
 
     // ===== CREATE TONE MAPPING PSO =====
     // This converts HDR (RGBA16F) to LDR (RGBA8) for display
@@ -611,9 +1064,16 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         sampler.ShaderRegister = 0;
         sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
+        // b0 = UV scale: the noisy fallback samples only the traced subrect
+        D3D12_ROOT_PARAMETER rootParams[2] = { rootParam };
+        rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        rootParams[1].Constants.ShaderRegister = 0;
+        rootParams[1].Constants.Num32BitValues = 2;
+        rootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
         D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
-        rsDesc.NumParameters = 1;
-        rsDesc.pParameters = &rootParam;
+        rsDesc.NumParameters = 2;
+        rsDesc.pParameters = rootParams;
         rsDesc.NumStaticSamplers = 1;
         rsDesc.pStaticSamplers = &sampler;
         rsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
@@ -630,6 +1090,7 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         const char* tonemapShader = R"(
             Texture2D<float4> hdrInput : register(t0);
             SamplerState samp : register(s0);
+            cbuffer TonemapCB : register(b0) { float2 UVScale; };
 
             struct VSOut {
                 float4 pos : SV_Position;
@@ -648,7 +1109,7 @@ bool InitD3D12PT_DLSS(HWND hwnd)
 
             // Pixel shader with tone mapping
             float4 PSMain(VSOut input) : SV_Target {
-                float3 hdr = hdrInput.Sample(samp, input.uv).rgb;
+                float3 hdr = hdrInput.Sample(samp, input.uv * UVScale).rgb;
 
                 // Reinhard tone mapping
                 float3 ldr = hdr / (1.0 + hdr);
@@ -660,39 +1121,16 @@ bool InitD3D12PT_DLSS(HWND hwnd)
             }
         )";
 
-        // Use DXC compiler for tone mapping shaders
-        HMODULE dxcModule = LoadLibraryW(L"dxcompiler.dll");
-        DxcCreateInstanceProc DxcCreateInstance = (DxcCreateInstanceProc)GetProcAddress(dxcModule, "DxcCreateInstance");
-
-        IDxcUtils* utils = nullptr;
-        IDxcCompiler3* compiler = nullptr;
-        DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils));
-        DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler));
-
-        IDxcBlobEncoding* sourceBlob = nullptr;
-        utils->CreateBlob(tonemapShader, (UINT)strlen(tonemapShader), CP_UTF8, &sourceBlob);
-
-        DxcBuffer srcBuffer = { sourceBlob->GetBufferPointer(), sourceBlob->GetBufferSize(), CP_UTF8 };
-
-        // Compile VS
         LPCWSTR vsArgs[] = { L"-E", L"VSMain", L"-T", L"vs_6_0" };
-        IDxcResult* vsResult = nullptr;
-        compiler->Compile(&srcBuffer, vsArgs, _countof(vsArgs), nullptr, IID_PPV_ARGS(&vsResult));
-        IDxcBlob* vsBlob = nullptr;
-        vsResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&vsBlob), nullptr);
-        vsResult->Release();
-
-        // Compile PS
         LPCWSTR psArgs[] = { L"-E", L"PSMain", L"-T", L"ps_6_0" };
-        IDxcResult* psResult = nullptr;
-        compiler->Compile(&srcBuffer, psArgs, _countof(psArgs), nullptr, IID_PPV_ARGS(&psResult));
-        IDxcBlob* psBlob = nullptr;
-        psResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&psBlob), nullptr);
-        psResult->Release();
-
-        sourceBlob->Release();
-        compiler->Release();
-        utils->Release();
+        ID3DBlob* vsBlob = nullptr;
+        ID3DBlob* psBlob = nullptr;
+        if (!CompileDXC(tonemapShader, vsArgs, _countof(vsArgs), &vsBlob, "TonemapVS") ||
+            !CompileDXC(tonemapShader, psArgs, _countof(psArgs), &psBlob, "TonemapPS")) {
+            if (vsBlob) vsBlob->Release();
+            Log("[ERROR] Tone mapping shader compile failed\n");
+            return false;
+        }
 
         // Create PSO
         D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
@@ -708,7 +1146,7 @@ bool InitD3D12PT_DLSS(HWND hwnd)
         psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
         psoDesc.SampleDesc.Count = 1;
 
-        dev12->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&g_tonemapPSO));
+        PipelineCacheCreateGraphics(dev12, L"Tonemap", psoDesc, &g_tonemapPSO);
         vsBlob->Release();
         psBlob->Release();
 
@@ -716,54 +1154,197 @@ bool InitD3D12PT_DLSS(HWND hwnd)
 
         // Create SRV heap for tone mapping (1 descriptor for HDR input)
         D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-        srvHeapDesc.NumDescriptors = 2;  // One for g_gbufferColor, one for g_dlssOutput
+        srvHeapDesc.NumDescriptors = 3;  // g_gbufferColor, g_dlssOutput, s_fgOutput
         srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
         srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
         dev12->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&g_tonemapSrvHeap));
 
-        UINT descSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-        D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = g_tonemapSrvHeap->GetCPUDescriptorHandleForHeapStart();
-
-        // SRV 0: g_gbufferColor (noisy HDR)
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Texture2D.MipLevels = 1;
-        dev12->CreateShaderResourceView(g_gbufferColor, &srvDesc, cpuHandle);
-        cpuHandle.ptr += descSize;
-
-        // SRV 1: g_dlssOutput (denoised HDR)
-        dev12->CreateShaderResourceView(g_dlssOutput, &srvDesc, cpuHandle);
+        WriteTonemapSRVs();
 
         Log("[INFO] Tone mapping SRV heap created\n");
     }
 
+    if (g_frameInterp) {
+        StartupStep("Frame interpolation");
+        if (!g_dlssRRSupported || !InitFrameGen()) {
+            Log("[WARN] Frame interpolation needs an active DLSS-RR feature - disabled\n");
+            CleanupFrameGen();
+        } else {
+            WriteTonemapSRVs();
+        }
+    }
+
     // Initialize text rendering (shared with base D3D12 renderer)
-    if (!InitGPUText12()) {
+    StartupStep("Overlay");
+    if (!Overlay12Init(g_overlay12, dev12, DXGI_FORMAT_R8G8B8A8_UNORM, "D3D12 DLSS")) {
         Log("[ERROR] Failed to initialize text rendering for DLSS!\n");
         return false;
     }
 
+    VramSetCategories(VramCategoriesDLSS);
     Log("[INFO] D3D12 + Path Tracing + DLSS Ray Reconstruction initialization complete\n");
     return true;
 }
 
+// ============== TONE MAP + PRESENT ==============
+// Tone map one HDR image into the current back buffer, draw the overlay,
+// submit and present. uvScale maps the back buffer onto the image's valid
+// region (the traced subrect for the noisy G-buffer color). Only the first
+// command list of a rendered frame carries GPU timestamps (timed). paced:
+// this rendered frame follows an interpolated present (PaceRenderedPresent).
+static void TonemapAndPresent(ID3D12Resource* hdr, UINT srvIndex, float uvScaleX, float uvScaleY, bool timed,
+                              bool paced)
+{
+    // Transition backbuffer to render target and HDR texture to SRV
+    D3D12_RESOURCE_BARRIER barriers[2] = {};
+    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barriers[0].Transition.pResource = renderTargets12[frameIndex];
+    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+    barriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barriers[1].Transition.pResource = hdr;
+    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    barriers[1].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    cmdList->ResourceBarrier(2, barriers);
+
+    // Render fullscreen triangle with tone mapping
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap12->GetCPUDescriptorHandleForHeapStart();
+    rtvHandle.ptr += frameIndex * rtvDescSize;
+    cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+    D3D12_VIEWPORT vp = {0, 0, (float)W, (float)H, 0, 1};
+    D3D12_RECT sr = {0, 0, (LONG)W, (LONG)H};
+    cmdList->RSSetViewports(1, &vp);
+    cmdList->RSSetScissorRects(1, &sr);
+
+    cmdList->SetPipelineState(g_tonemapPSO);
+    cmdList->SetGraphicsRootSignature(g_tonemapRootSig);
+
+    ID3D12DescriptorHeap* heaps[] = { g_tonemapSrvHeap };
+    cmdList->SetDescriptorHeaps(1, heaps);
+
+    // SRV index: 0 = g_gbufferColor (noisy), 1 = g_dlssOutput (denoised), 2 = s_fgOutput (interpolated)
+    UINT descSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = g_tonemapSrvHeap->GetGPUDescriptorHandleForHeapStart();
+    gpuHandle.ptr += srvIndex * descSize;
+    cmdList->SetGraphicsRootDescriptorTable(0, gpuHandle);
+
+    float uvScale[2] = { uvScaleX, uvScaleY };
+    cmdList->SetGraphicsRoot32BitConstants(1, 2, uvScale, 0);
+
+    cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    cmdList->DrawInstanced(3, 1, 0, 0);  // Fullscreen triangle
+
+    // Transition HDR texture back to UAV for next frame
+    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    cmdList->ResourceBarrier(1, &barriers[1]);
+    if (timed) GpuTimerStamp12(cmdList, frameIndex, "Tonemap");
+
+    // ===== TEXT OVERLAY =====
+    // rtvHandle already computed above in tone mapping section
+
+    if (fps != g_cachedFps || g_textNeedsRebuild) {
+        g_cachedFps = fps;
+        g_textNeedsRebuild = false;
+
+        static char gpuNameA[128] = {0};
+        if (gpuNameA[0] == 0) {
+            size_t converted;
+            wcstombs_s(&converted, gpuNameA, sizeof(gpuNameA), gpuName.c_str(), _TRUNCATE);
+        }
+
+        char infoText[1024];
+        char dlssStatus[160];
+        char frameGen[128] = "";
+        if (g_dlssRRSupported) {
+            char target[48] = "";
+            if (g_dlssTargetMs > 0.0f) sprintf_s(target, ", target %.1f ms", g_dlssTargetMs);
+            sprintf_s(dlssStatus, "DLSS-RR Active (%s %ux%u -> %ux%u%s)", s_dlssModeNames[g_dlssMode],
+                s_renderW, s_renderH, W, H, target);
+        } else {
+            strcpy_s(dlssStatus, "DLSS-RR N/A (fallback)");
+        }
+        // fps counts rendered frames (one RenderD3D12PT_DLSS call each);
+        // presented is measured from the frame statistics (n/a without them)
+        if (s_fgPSO) {
+            char presented[16] = "n/a";
+            if (s_fgPresentedDisplay > 0.0f) sprintf_s(presented, "%d", (int)(s_fgPresentedDisplay + 0.5f));
+            sprintf_s(frameGen, "\nFrame Interp: Rendered %d fps | Interpolated %d fps | Presented %s fps",
+                fps, (int)(fps * D3D12DlssInterpolatedFrameRatio() + 0.5f), presented);
+        }
+        char latency[64];
+        LatencyFormat(latency, sizeof(latency));
+        char vram[192];
+        VramFormat(vram, sizeof(vram));
+        sprintf_s(infoText,
+            "API: D3D12 + PT + DLSS RR\n"
+            "GPU: %s\n"
+            "FPS: %d\n"
+            "Triangles: %u\n"
+            "Resolution: %ux%u\n"
+            "Rays: 1 SPP | Bounces: 3\n"
+            "%s%s%s%s%s%s",
+            gpuNameA, fps, totalIndices12 / 3, W, H, dlssStatus, frameGen, latency[0] ? "\n" : "", latency,
+            vram[0] ? "\n" : "", vram);
+
+        OverlaySetText(g_overlay12.text, infoText);
+    }
+
+    // Draw text
+    cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    Overlay12Draw(g_overlay12, cmdList, frameIndex, W, H);
+    if (timed) GpuTimerStamp12(cmdList, frameIndex, "Text");
+
+    // Transition backbuffer to present
+    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barriers[0].Transition.pResource = renderTargets12[frameIndex];
+    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+    cmdList->ResourceBarrier(1, barriers);
+
+    if (timed) GpuTimerEnd12(cmdList, frameIndex);
+    cmdList->Close();
+
+    ID3D12CommandList* lists[] = { cmdList };
+    cmdQueue->ExecuteCommandLists(1, lists);
+
+    if (paced) PaceRenderedPresent();
+    DxgiPresent(swap12, g_tearingSupported12);
+    if (s_fgPSO) TrackPresent(srvIndex == 2);
+
+    MoveToNextFrame();
+}
+
+
+}
+
 // ============== RENDER D3D12 PT + DLSS ==============
 
 void RenderD3D12PT_DLSS()
 {
+    DxgiWaitFrameLatency(swapWaitable12);
+
+    // Timestamps from the last use of this frame slot are complete by now
+    GpuTimerCollect12(frameIndex);
+    UpdateDynamicResolution();
+    s_inputScaleSum += (double)s_renderW / W;
+    s_inputScaleFrames++;
+
     cmdAlloc[frameIndex]->Reset();
     cmdList->Reset(cmdAlloc[frameIndex], nullptr);  // Start with no PSO
+    GpuTimerBegin12(cmdList, frameIndex);
 
-    // Update constant buffer
-    LARGE_INTEGER nowTime;
-    QueryPerformanceCounter(&nowTime);
-    float t = (float)(nowTime.QuadPart - g_startTime.QuadPart) / g_perfFreq.QuadPart;
+    // Update constant buffer (P pauses the animation, see accumulation.h)
+    float t = AnimationTime();
 
     // ===== UPDATE CUBE TRANSFORM AND REBUILD TLAS =====
     UpdateCubeTransformPT(t);
     RebuildTLAS_PT(cmdListRT);
+    GpuTimerStamp12(cmdList, frameIndex, "TLAS");
 
     // Build camera matrices (looking at room from outside)
     XMMATRIX view = XMMatrixLookAtLH(
@@ -777,16 +1358,21 @@ void RenderD3D12PT_DLSS()
     XMMATRIX viewProj = view * proj;
 
     // Use DLSS constant buffer with PrevViewProj for motion vectors
-    if (g_dlssRRSupported && g_dlssCBMapped) {
+    D3D12_GPU_VIRTUAL_ADDRESS cbGpu = 0;
+    float jitterX = 0.0f, jitterY = 0.0f;
+    if (g_dlssRRSupported) {
+        NextJitter(jitterX, jitterY);
         PathTraceDlssCBData dlssCbData;
         XMStoreFloat4x4(&dlssCbData.InvView, XMMatrixTranspose(invView));
         XMStoreFloat4x4(&dlssCbData.InvProj, XMMatrixTranspose(invProj));
         XMStoreFloat4x4(&dlssCbData.PrevViewProj, XMMatrixTranspose(g_prevViewProj));
         dlssCbData.Time = t;
         dlssCbData.FrameCount = g_frameCount++;
-        dlssCbData.Width = W;
-        dlssCbData.Height = H;
-        memcpy(g_dlssCBMapped, &dlssCbData, sizeof(dlssCbData));
+        dlssCbData.Width = s_renderW;
+        dlssCbData.Height = s_renderH;
+        dlssCbData.JitterX = jitterX;
+        dlssCbData.JitterY = jitterY;
+        cbGpu = FrameRingPush12(g_frameRing12, &dlssCbData, sizeof(dlssCbData), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
     } else {
         PathTraceCBData cbData;
         XMStoreFloat4x4(&cbData.InvView, XMMatrixTranspose(invView));
@@ -795,21 +1381,29 @@ void RenderD3D12PT_DLSS()
         cbData.FrameCount = g_frameCount++;
         cbData.Width = W;
         cbData.Height = H;
-        memcpy(pathTraceCBMapped, &cbData, sizeof(cbData));
+        cbData.AccumFrame = 0;   // DLSS does its own temporal accumulation
+        cbData.SamplesPerPixel = g_ptSpp;
+        cbData.MaxBounces = g_ptMaxBounces;
+        cbData.AdaptiveMaxSpp = 0;   // No sample counter readback here
+        cbData.AdaptiveTarget = g_ptAdaptiveTarget;
+        cbGpu = FrameRingPush12(g_frameRing12, &cbData, sizeof(cbData), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
     }
 
     // Store current ViewProj for next frame's motion vectors
     g_prevViewProj = viewProj;
 
-    // Also update regular CB for text rendering
-    CB textCbData = { t };
-    memcpy(cbMapped12, &textCbData, sizeof(CB));
-
     // ===== PATH TRACING WITH G-BUFFER OUTPUT =====
+    UINT traceW = W, traceH = H;
+    const GroupShape* traceShape = &GroupVariant(GROUP_VARIANT_DEFAULT);
     if (g_dlssRRSupported && g_pathTraceGbufferRootSig && g_dlssSrvUavHeap && g_pathTraceGbufferPSO) {
-        cmdList->SetPipelineState(g_pathTraceGbufferPSO);
+        traceW = s_renderW;   // Top-left subrect of the G-buffer
+        traceH = s_renderH;
+        UINT variant = GroupTuneSelect(GROUP_KERNEL_DLSS_GBUFFER, frameIndex);
+        if (!s_gbufferVariants[variant]) variant = GROUP_VARIANT_DEFAULT;
+        traceShape = &GroupVariant(variant);
+        cmdList->SetPipelineState(s_gbufferVariants[variant] ? s_gbufferVariants[variant] : g_pathTraceGbufferPSO);
         cmdList->SetComputeRootSignature(g_pathTraceGbufferRootSig);
-        cmdList->SetComputeRootConstantBufferView(0, g_dlssCB->GetGPUVirtualAddress());
+        cmdList->SetComputeRootConstantBufferView(0, cbGpu);
 
         ID3D12DescriptorHeap* heaps[] = { g_dlssSrvUavHeap };
         cmdList->SetDescriptorHeaps(1, heaps);
@@ -818,16 +1412,25 @@ void RenderD3D12PT_DLSS()
         // Fallback to standard PT (no DLSS)
         cmdList->SetPipelineState(pathTracePSO);
         cmdList->SetComputeRootSignature(pathTraceRootSig);
-        cmdList->SetComputeRootConstantBufferView(0, pathTraceCB->GetGPUVirtualAddress());
+        cmdList->SetComputeRootConstantBufferView(0, cbGpu);
 
         ID3D12DescriptorHeap* heaps[] = { pathTraceSrvUavHeap };
         cmdList->SetDescriptorHeaps(1, heaps);
-        cmdList->SetComputeRootDescriptorTable(1, pathTraceSrvUavHeap->GetGPUDescriptorHandleForHeapStart());
+        D3D12_GPU_DESCRIPTOR_HANDLE ptTable = pathTraceSrvUavHeap->GetGPUDescriptorHandleForHeapStart();
+        UINT srvUavDescSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        D3D12_GPU_DESCRIPTOR_HANDLE outputTable = ptTable;
+        outputTable.ptr += 3 * srvUavDescSize;
+        D3D12_GPU_DESCRIPTOR_HANDLE accumTable = ptTable;
+        accumTable.ptr += (8 + FRAME_COUNT) * srvUavDescSize;
+        cmdList->SetComputeRootDescriptorTable(1, ptTable);
+        cmdList->SetComputeRootDescriptorTable(2, outputTable);   // u0 = pathTraceOutput
+        cmdList->SetComputeRootDescriptorTable(3, accumTable);    // u1 = AccumSum, u2 = SampleCounter (unused here)
     }
 
-    UINT groupsX = (W + 7) / 8;
-    UINT groupsY = (H + 7) / 8;
+    UINT groupsX = (traceW + traceShape->x - 1) / traceShape->x;
+    UINT groupsY = (traceH + traceShape->y - 1) / traceShape->y;
     cmdList->Dispatch(groupsX, groupsY, 1);
+    GpuTimerStamp12(cmdList, frameIndex, "Trace");
 
     // ===== DLSS RAY RECONSTRUCTION EVALUATION =====
     D3D12_RESOURCE_BARRIER barriers[8] = {};
@@ -875,13 +1478,14 @@ void RenderD3D12PT_DLSS()
         dlssEvalParams.pInSpecularAlbedo = g_gbufferSpecularAlbedo;
         dlssEvalParams.pInNormals = g_gbufferNormals;
         dlssEvalParams.pInRoughness = g_gbufferRoughness;
-        dlssEvalParams.InJitterOffsetX = 0.0f;  // We use full-res, no jitter
-        dlssEvalParams.InJitterOffsetY = 0.0f;
-        dlssEvalParams.InRenderSubrectDimensions.Width = W;
-        dlssEvalParams.InRenderSubrectDimensions.Height = H;
-        dlssEvalParams.InMVScaleX = 1.0f;
+        dlssEvalParams.InJitterOffsetX = jitterX;   // Same offset the camera rays used
+        dlssEvalParams.InJitterOffsetY = jitterY;
+        dlssEvalParams.InRenderSubrectDimensions.Width = s_renderW;
+        dlssEvalParams.InRenderSubrectDimensions.Height = s_renderH;
+        dlssEvalParams.InMVScaleX = 1.0f;   // Motion vectors are in input pixels
         dlssEvalParams.InMVScaleY = 1.0f;
-        dlssEvalParams.InReset = 0;
+        dlssEvalParams.InReset = s_dlssReset ? 1 : 0;
+        s_dlssReset = false;
 
         // Execute DLSS Ray Reconstruction
         NVSDK_NGX_Result result = NGX_D3D12_EVALUATE_DLSSD_EXT(
@@ -903,126 +1507,131 @@ void RenderD3D12PT_DLSS()
             barriers[i].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
         }
         cmdList->ResourceBarrier(7, barriers);
+        GpuTimerStamp12(cmdList, frameIndex, "DLSS-RR");
     }
 
     // ===== TONE MAPPING: HDR -> LDR =====
-    // Transition backbuffer to render target and HDR texture to SRV
-    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barriers[0].Transition.pResource = renderTargets12[frameIndex];
-    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-    barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-
-    barriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barriers[1].Transition.pResource = outputToCopy;
-    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    barriers[1].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    cmdList->ResourceBarrier(2, barriers);
-
-    // Render fullscreen triangle with tone mapping
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap12->GetCPUDescriptorHandleForHeapStart();
-    rtvHandle.ptr += frameIndex * rtvDescSize;
-    cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-
-    D3D12_VIEWPORT vp = {0, 0, (float)W, (float)H, 0, 1};
-    D3D12_RECT sr = {0, 0, (LONG)W, (LONG)H};
-    cmdList->RSSetViewports(1, &vp);
-    cmdList->RSSetScissorRects(1, &sr);
-
-    cmdList->SetPipelineState(g_tonemapPSO);
-    cmdList->SetGraphicsRootSignature(g_tonemapRootSig);
+    s_fgRendered++;
+    bool frameGen = s_fgPSO && outputToCopy == g_dlssOutput;
+    bool interpolated = false;
+    if (frameGen && s_fgHistoryValid) {
+        // ===== FRAME INTERPOLATION =====
+        // Midpoint between the previous and this DLSS-RR output, presented first
+        barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barriers[0].Transition.pResource = g_dlssOutput;
+        barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barriers[1] = barriers[0];
+        barriers[1].Transition.pResource = g_gbufferMotionVectors;
+        barriers[2] = barriers[0];
+        barriers[2].Transition.pResource = g_gbufferDepth;
+        cmdList->ResourceBarrier(3, barriers);
+
+        FrameGenConstants fg = { W, H, s_renderW, s_renderH, DLSS_FG_PHASE };
+        cmdList->SetPipelineState(s_fgPSO);
+        cmdList->SetComputeRootSignature(s_fgRootSig);
+        ID3D12DescriptorHeap* fgHeaps[] = { s_fgHeap };
+        cmdList->SetDescriptorHeaps(1, fgHeaps);
+        cmdList->SetComputeRoot32BitConstants(0, sizeof(fg) / 4, &fg, 0);
+        cmdList->SetComputeRootDescriptorTable(1, s_fgHeap->GetGPUDescriptorHandleForHeapStart());
+        cmdList->Dispatch((W + 7) / 8, (H + 7) / 8, 1);
+
+        for (int i = 0; i < 3; i++) {
+            barriers[i].Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            barriers[i].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        }
+        cmdList->ResourceBarrier(3, barriers);
+        GpuTimerStamp12(cmdList, frameIndex, "FrameGen");
 
-    ID3D12DescriptorHeap* heaps[] = { g_tonemapSrvHeap };
-    cmdList->SetDescriptorHeaps(1, heaps);
+        TonemapAndPresent(s_fgOutput, 2, 1.0f, 1.0f, true, false);
+        s_fgInterpolated++;
+        interpolated = true;
 
-    // Select correct SRV: index 0 = g_gbufferColor (noisy), index 1 = g_dlssOutput (denoised)
-    UINT descSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = g_tonemapSrvHeap->GetGPUDescriptorHandleForHeapStart();
-    if (outputToCopy == g_dlssOutput) {
-        gpuHandle.ptr += descSize;  // Use SRV 1 (denoised)
+        // The rendered frame goes out in the next frame slot
+        GpuTimerCollect12(frameIndex);
+        cmdAlloc[frameIndex]->Reset();
+        cmdList->Reset(cmdAlloc[frameIndex], nullptr);
     }
-    cmdList->SetGraphicsRootDescriptorTable(0, gpuHandle);
 
-    cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    cmdList->DrawInstanced(3, 1, 0, 0);  // Fullscreen triangle
+    if (frameGen) {
+        // This output is the next interpolated frame's previous image
+        barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barriers[0].Transition.pResource = g_dlssOutput;
+        barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barriers[1] = barriers[0];
+        barriers[1].Transition.pResource = s_fgPrevColor;
+        barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+        cmdList->ResourceBarrier(2, barriers);
+        cmdList->CopyResource(s_fgPrevColor, g_dlssOutput);
+        for (int i = 0; i < 2; i++) {
+            D3D12_RESOURCE_STATES before = barriers[i].Transition.StateBefore;
+            barriers[i].Transition.StateBefore = barriers[i].Transition.StateAfter;
+            barriers[i].Transition.StateAfter = before;
+        }
+        cmdList->ResourceBarrier(2, barriers);
+        s_fgHistoryValid = true;
+    }
 
-    // Transition HDR texture back to UAV for next frame
-    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-    cmdList->ResourceBarrier(1, &barriers[1]);
+    // The noisy input only covers the traced subrect of the G-buffer
+    float uvScaleX = 1.0f, uvScaleY = 1.0f;
+    if (outputToCopy == g_gbufferColor && g_dlssRRSupported && s_renderMaxW && s_renderMaxH) {
+        uvScaleX = (float)s_renderW / s_renderMaxW;
+        uvScaleY = (float)s_renderH / s_renderMaxH;
+    }
+    TonemapAndPresent(outputToCopy, outputToCopy == g_dlssOutput ? 1 : 0, uvScaleX, uvScaleY,
+                      !interpolated, interpolated);
+}
 
-    // ===== TEXT OVERLAY =====
-    // rtvHandle already computed above in tone mapping section
+// ============== RESIZE D3D12 PT + DLSS ==============
 
-    if (fps != g_cachedFps || g_textNeedsRebuild) {
-        g_cachedFps = fps;
-        g_textNeedsRebuild = false;
+bool ResizeD3D12PT_DLSS()
+{
+    // Swap chain + PT output first (waits for the GPU)
+    if (!ResizeD3D12PT()) return false;
+    if (!g_gbufferColor) return true;  // NGX unavailable - running as plain PT
 
-        static char gpuNameA[128] = {0};
-        if (gpuNameA[0] == 0) {
-            size_t converted;
-            wcstombs_s(&converted, gpuNameA, sizeof(gpuNameA), gpuName.c_str(), _TRUNCATE);
-        }
+    // DLSS-RR feature is created for a fixed input/output size
+    if (g_dlssRRHandle) {
+        NVSDK_NGX_D3D12_ReleaseFeature(g_dlssRRHandle);
+        g_dlssRRHandle = nullptr;
+    }
 
-        char infoText[512];
-        const char* dlssStatus = g_dlssRRSupported ? "DLSS-RR Active" : "DLSS-RR N/A (fallback)";
-        sprintf_s(infoText,
-            "API: D3D12 + PT + DLSS RR\n"
-            "GPU: %s\n"
-            "FPS: %d\n"
-            "Triangles: %u\n"
-            "Resolution: %ux%u\n"
-            "Rays: 1 SPP | Bounces: 3\n"
-            "%s",
-            gpuNameA, fps, totalIndices12 / 3, W, H, dlssStatus);
+    if (g_gbufferColor) { g_gbufferColor->Release(); g_gbufferColor = nullptr; }
+    if (g_gbufferDiffuseAlbedo) { g_gbufferDiffuseAlbedo->Release(); g_gbufferDiffuseAlbedo = nullptr; }
+    if (g_gbufferSpecularAlbedo) { g_gbufferSpecularAlbedo->Release(); g_gbufferSpecularAlbedo = nullptr; }
+    if (g_gbufferNormals) { g_gbufferNormals->Release(); g_gbufferNormals = nullptr; }
+    if (g_gbufferRoughness) { g_gbufferRoughness->Release(); g_gbufferRoughness = nullptr; }
+    if (g_gbufferDepth) { g_gbufferDepth->Release(); g_gbufferDepth = nullptr; }
+    if (g_gbufferMotionVectors) { g_gbufferMotionVectors->Release(); g_gbufferMotionVectors = nullptr; }
+    if (g_dlssOutput) { g_dlssOutput->Release(); g_dlssOutput = nullptr; }
 
-        g_textVertCount = 0;
-        DrawTextDirect(infoText, 12.0f, 12.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.5f);
-        DrawTextDirect(infoText, 10.0f, 10.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.5f);
-        memcpy(textVbMapped12, g_textVerts, g_textVertCount * sizeof(TextVert));
+    if (!CreateGBufferTextures()) return false;
+    if (g_dlssSrvUavHeap) WriteGBufferUAVs();
+    if (s_fgHeap) {
+        ReleaseFrameGenTargets();
+        if (!CreateFrameGenTargets()) return false;
+        WriteFrameGenViews();
     }
+    if (g_tonemapSrvHeap) WriteTonemapSRVs();
 
-    // Draw text
-    if (g_textVertCount > 0) {
-        cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-        D3D12_VIEWPORT vp = {0, 0, (float)W, (float)H, 0, 1};
-        D3D12_RECT sr = {0, 0, (LONG)W, (LONG)H};
-        cmdList->RSSetViewports(1, &vp);
-        cmdList->RSSetScissorRects(1, &sr);
-        cmdList->SetPipelineState(textPso);
-        cmdList->SetGraphicsRootSignature(textRootSig12);
-        ID3D12DescriptorHeap* srvHeaps[] = { srvHeap12 };
-        cmdList->SetDescriptorHeaps(1, srvHeaps);
-        cmdList->SetGraphicsRootDescriptorTable(0, srvHeap12->GetGPUDescriptorHandleForHeapStart());
-        cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        cmdList->IASetVertexBuffers(0, 1, &textVbView12);
-        cmdList->DrawInstanced(g_textVertCount, 1, 0, 0);
+    if (g_dlssRRSupported && !CreateDLSSRRFeature()) {
+        Log("[ERROR] Failed to recreate DLSS-RR feature, falling back to noisy output\n");
+        g_dlssRRSupported = false;
     }
 
-    // Transition backbuffer to present
-    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barriers[0].Transition.pResource = renderTargets12[frameIndex];
-    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-    cmdList->ResourceBarrier(1, barriers);
-
-    cmdList->Close();
-
-    ID3D12CommandList* lists[] = { cmdList };
-    cmdQueue->ExecuteCommandLists(1, lists);
-
-    UINT syncInterval = 0;  // Vsync off
-    UINT presentFlags = g_tearingSupported12 ? DXGI_PRESENT_ALLOW_TEARING : 0;
-    swap12->Present(syncInterval, presentFlags);
-
-    MoveToNextFrame();
+    Log("[INFO] D3D12 PT + DLSS resized to %ux%u\n", W, H);
+    return true;
 }
 
 // ============== CLEANUP D3D12 PT + DLSS ==============
 
 void CleanupD3D12PT_DLSS()
 {
+    VramSetCategories(nullptr);
     WaitForGpu();
 
     // Release DLSS-RR resources
@@ -1032,10 +1641,13 @@ void CleanupD3D12PT_DLSS()
     }
 
     // Release G-Buffer PSO and root signature
+    GroupReleaseVariants12(s_gbufferVariants);
     if (g_pathTraceGbufferPSO) { g_pathTraceGbufferPSO->Release(); g_pathTraceGbufferPSO = nullptr; }
     if (g_pathTraceGbufferRootSig) { g_pathTraceGbufferRootSig->Release(); g_pathTraceGbufferRootSig = nullptr; }
     if (g_dlssSrvUavHeap) { g_dlssSrvUavHeap->Release(); g_dlssSrvUavHeap = nullptr; }
 
+    CleanupFrameGen();
+
     // Release tone mapping resources
     if (g_tonemapPSO) { g_tonemapPSO->Release(); g_tonemapPSO = nullptr; }
     if (g_tonemapRootSig) { g_tonemapRootSig->Release(); g_tonemapRootSig = nullptr; }
@@ -1050,7 +1662,6 @@ void CleanupD3D12PT_DLSS()
     if (g_gbufferDepth) { g_gbufferDepth->Release(); g_gbufferDepth = nullptr; }
     if (g_gbufferMotionVectors) { g_gbufferMotionVectors->Release(); g_gbufferMotionVectors = nullptr; }
     if (g_dlssOutput) { g_dlssOutput->Release(); g_dlssOutput = nullptr; }
-    if (g_dlssCB) { g_dlssCB->Release(); g_dlssCB = nullptr; }
 
     // Shutdown NGX
     if (g_ngxInitialized && dev12) {
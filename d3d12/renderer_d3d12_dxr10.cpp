@@ -6,6 +6,17 @@
 #include "../common.h"
 #include "d3d12_shared.h"
 #include "renderer_d3d12.h"
+#include "../tlas_policy.h"
+#include "../rt_geometry.h"
+#include "../rt_sampling.h"
+#include "../ray_stats.h"
+#include "../ray_reorder.h"
+#include "../gpu_profiler.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "../offscreen.h"
+#include "../shaders/rt_sampling_shaders.h"
+#include "../shaders/ray_stats_shaders.h"
 
 #include <d3d12.h>
 #include <dxgi1_6.h>
@@ -22,7 +33,8 @@
 using namespace DirectX;
 
 // ============== DXR 1.0 SHADER CODE (lib_6_3) ==============
-// Split into multiple strings to avoid MSVC string length limit
+// Split into multiple strings to avoid MSVC string length limit; Part2
+// (raygen) and Part3 (hit / miss) become separate collections
 // Uses #ifdef for conditional feature compilation:
 //   FEATURE_SPOTLIGHT    - Cone light with falloff
 //   FEATURE_SOFT_SHADOWS - Multiple shadow samples
@@ -34,7 +46,7 @@ using namespace DirectX;
 static const char* g_dxr10ShaderPart1 = R"HLSL(
 // ============== RAYTRACING SHADER LIBRARY (lib_6_3) ==============
 // Cornell Box scene - matches DXR 1.1 exactly
-// Uses InstanceIndex() and PrimitiveIndex() ranges - no vertex buffer access
+// Hit surfaces come from the primitive / material tables - no vertex buffer access
 // Conditional compilation via #ifdef FEATURE_*
 
 // Output UAV
@@ -43,6 +55,21 @@ RWTexture2D<float4> OutputUAV : register(u0);
 // Acceleration structure
 RaytracingAccelerationStructure Scene : register(t0);
 
+// Hit surface lookup (d3d12_rt_tables.cpp): one entry per triangle, the TLAS
+// instance's InstanceID is the index of its BLAS's first triangle
+struct Primitive {
+    float3 normal;       // Object space face normal
+    uint material;
+};
+struct Material {
+    float3 albedo;
+    uint type;           // MAT_*
+    uint objectID;       // OBJ_*
+    uint3 pad;
+};
+StructuredBuffer<Primitive> Primitives : register(t1);
+StructuredBuffer<Material> Materials : register(t2);
+
 // Constant buffer - parameters from CPU
 cbuffer SceneCB : register(b0) {
     float Time;
@@ -72,7 +99,7 @@ struct RayPayload {
     float3 normal;
     float3 hitPos;
     uint objectID;
-    uint cubeIndex;    // For rotating cubes
+    uint material;     // Materials[] index
     uint materialType;
     bool hit;
 };
@@ -82,6 +109,22 @@ struct ShadowPayload {
     bool inShadow;
 };
 
+// Secondary (incoherent) rays that run the closest hit shader. --ser (SM 6.9):
+// trace into a hit object, regroup the threads by hit object + the hit's
+// material type (2 bits), then invoke the hit / miss shader.
+#ifdef SER
+uint SerMaterialHint(dx::HitObject hitObject) {
+    if (!hitObject.IsHit()) return 0;
+    return Materials[Primitives[hitObject.GetInstanceID() + hitObject.GetPrimitiveIndex()].material].type;
+}
+#define TRACE_SECONDARY(rayDesc, rayPayload) { \
+    dx::HitObject hitObject = dx::HitObject::TraceRay(Scene, RAY_FLAG_NONE, 0xFF, 0, 1, 0, rayDesc, rayPayload); \
+    dx::MaybeReorderThread(hitObject, SerMaterialHint(hitObject), 2); \
+    dx::HitObject::Invoke(hitObject, rayPayload); }
+#else
+#define TRACE_SECONDARY(rayDesc, rayPayload) TraceRay(Scene, RAY_FLAG_NONE, 0xFF, 0, 1, 0, rayDesc, rayPayload)
+#endif
+
 // ============== MATERIAL TYPES ==============
 #define MAT_DIFFUSE  0
 #define MAT_MIRROR   1
@@ -101,131 +144,27 @@ struct ShadowPayload {
 #define OBJ_SMALL_CUBE 9
 #define OBJ_FRONT_WALL 10
 
-// ============== INSTANCE IDs ==============
-#define INSTANCE_STATIC 0
-#define INSTANCE_CUBES  1
-
-// ============== SCENE COLORS (MUST MATCH DXR 1.1) ==============
-static const float3 Colors[11] = {
-    float3(0.7, 0.7, 0.7),    // 0: Floor - grey
-    float3(0.9, 0.9, 0.9),    // 1: Ceiling - white
-    float3(0.7, 0.7, 0.7),    // 2: Back wall - grey
-    float3(0.75, 0.15, 0.15), // 3: Left wall - RED
-    float3(0.15, 0.75, 0.15), // 4: Right wall - GREEN
-    float3(15.0, 14.0, 12.0), // 5: Light - bright emissive
-    float3(0.9, 0.6, 0.2),    // 6: Cube - orange (fallback)
-    float3(0.95, 0.95, 0.95), // 7: Mirror - neutral
-    float3(0.9, 0.95, 1.0),   // 8: Glass - slight blue tint
-    float3(0.9, 0.15, 0.1),   // 9: Small cube - RED
-    float3(0.5, 0.15, 0.7)    // 10: Front wall - PURPLE
-};
-
-// ============== CUBE COLORS (8 cubes, brighter and more saturated) ==============
-static const float3 CubeColors[8] = {
-    float3(1.0, 0.15, 0.1),   // 0: Bright Red
-    float3(0.1, 0.9, 0.2),    // 1: Bright Green
-    float3(0.1, 0.4, 1.0),    // 2: Bright Blue
-    float3(1.0, 0.95, 0.1),   // 3: Bright Yellow
-    float3(1.0, 0.95, 0.1),   // 4: Bright Yellow
-    float3(0.1, 0.4, 1.0),    // 5: Bright Blue
-    float3(0.1, 0.9, 0.2),    // 6: Bright Green
-    float3(1.0, 0.15, 0.1)    // 7: Bright Red
-};
-
-// ============== STATIC GEOMETRY PRIMITIVE RANGES ==============
-// Order: floor(2), ceiling(2), back_wall(2), left_wall(2), right_wall(2),
-//        light(2), mirror(2), small_cube(12), glass(4), front_wall(2)
-void GetStaticObjectInfo(uint primID, out uint objID, out uint matType, out float3 normal) {
-    matType = MAT_DIFFUSE;
-    if (primID < 2) { objID = OBJ_FLOOR; normal = float3(0, 1, 0); }
-    else if (primID < 4) { objID = OBJ_CEILING; normal = float3(0, -1, 0); }
-    else if (primID < 6) { objID = OBJ_BACK_WALL; normal = float3(0, 0, -1); }
-    else if (primID < 8) { objID = OBJ_LEFT_WALL; normal = float3(1, 0, 0); }
-    else if (primID < 10) { objID = OBJ_RIGHT_WALL; normal = float3(-1, 0, 0); }
-    else if (primID < 12) { objID = OBJ_LIGHT; normal = float3(0, -1, 0); matType = MAT_EMISSIVE; }
-    else if (primID < 14) { objID = OBJ_MIRROR; normal = normalize(float3(0.707, 0, -0.707)); matType = MAT_MIRROR; }
-    else if (primID < 26) {
-        objID = OBJ_SMALL_CUBE;
-        // Get face normal for small cube (12 triangles = 6 faces)
-        uint faceIdx = (primID - 14) / 2;
-        if (faceIdx == 0) normal = float3(0, 0, 1);      // front
-        else if (faceIdx == 1) normal = float3(0, 0, -1); // back
-        else if (faceIdx == 2) normal = float3(1, 0, 0);  // right
-        else if (faceIdx == 3) normal = float3(-1, 0, 0); // left
-        else if (faceIdx == 4) normal = float3(0, 1, 0);  // top
-        else normal = float3(0, -1, 0);                   // bottom
-    }
-    else if (primID < 30) { objID = OBJ_GLASS; normal = float3(0, 0, -1); matType = MAT_GLASS; }
-    else { objID = OBJ_FRONT_WALL; normal = float3(0, 0, 1); }
-}
-
-// ============== ROTATION MATRICES ==============
-float3x3 RotateY(float angle) {
-    float c = cos(angle), s = sin(angle);
-    return float3x3(c, 0, s, 0, 1, 0, -s, 0, c);
-}
-float3x3 RotateX(float angle) {
-    float c = cos(angle), s = sin(angle);
-    return float3x3(1, 0, 0, 0, c, -s, 0, s, c);
-}
-
-// Get cube face normal in WORLD SPACE (after rotation)
-float3 GetCubeFaceNormal(uint primID) {
-    // Each cube has 12 triangles (6 faces * 2)
-    uint localPrim = primID % 12;
-    uint faceIdx = localPrim / 2;
-    float3 localNormal;
-    if (faceIdx == 0) localNormal = float3(0, 0, 1);      // front
-    else if (faceIdx == 1) localNormal = float3(0, 0, -1); // back
-    else if (faceIdx == 2) localNormal = float3(1, 0, 0);  // right
-    else if (faceIdx == 3) localNormal = float3(-1, 0, 0); // left
-    else if (faceIdx == 4) localNormal = float3(0, 1, 0);  // top
-    else localNormal = float3(0, -1, 0);                   // bottom
-
-    // Transform to world space using current rotation
-    float angleY = Time * 1.2;
-    float angleX = Time * 0.7;
-    float3x3 rot = mul(RotateY(angleY), RotateX(angleX));
-    return normalize(mul(localNormal, rot));
-}
-
-// Get color for object
-float3 GetObjectColor(uint objID, uint cubeIndex) {
-    if (objID == OBJ_CUBE) {
-        return CubeColors[min(cubeIndex, 7u)];
-    }
-    return Colors[min(objID, 10u)];
+// Get color for a hit's material
+float3 GetObjectColor(uint material) {
+    return Materials[material].albedo;
 }
 
-// ============== RANDOM NUMBER GENERATOR ==============
-uint WangHash(uint seed) {
-    seed = (seed ^ 61) ^ (seed >> 16);
-    seed *= 9;
-    seed = seed ^ (seed >> 4);
-    seed *= 0x27d4eb2d;
-    seed = seed ^ (seed >> 15);
-    return seed;
-}
-
-float Random(inout uint seed) {
-    seed = WangHash(seed);
-    return float(seed) / 4294967295.0;
-}
-
-float3 RandomInDisk(inout uint seed) {
-    float r = sqrt(Random(seed));
-    float theta = 6.28318530718 * Random(seed);
+// ============== RANDOM NUMBERS ==============
+// RTSampler (--sampler): g_rtSamplingShaderCode, first part of the source
+float3 RandomInDisk(inout RTSampler rng) {
+    float2 u = Sample2D(rng);
+    float r = sqrt(u.x);
+    float theta = 6.28318530718 * u.y;
     return float3(r * cos(theta), 0, r * sin(theta));
 }
 
-float3 RandomInHemisphere(float3 normal, inout uint seed) {
-    float u1 = Random(seed);
-    float u2 = Random(seed);
-    float r = sqrt(u1);
-    float theta = 6.28318530718 * u2;
+float3 RandomInHemisphere(float3 normal, inout RTSampler rng) {
+    float2 u = Sample2D(rng);
+    float r = sqrt(u.x);
+    float theta = 6.28318530718 * u.y;
     float x = r * cos(theta);
     float y = r * sin(theta);
-    float z = sqrt(1.0 - u1);
+    float z = sqrt(1.0 - u.x);
     float3 up = abs(normal.y) < 0.999 ? float3(0, 1, 0) : float3(1, 0, 0);
     float3 tangent = normalize(cross(up, normal));
     float3 bitangent = cross(normal, tangent);
@@ -274,9 +213,10 @@ void RayGen() {
     payload.color = float3(0, 0, 0);
     payload.hitT = -1;
     payload.hit = false;
-    payload.cubeIndex = 0;
+    payload.material = 0;
 
     TraceRay(Scene, RAY_FLAG_NONE, 0xFF, 0, 1, 0, ray, payload);
+    CountRays(RAY_PRIMARY, 1);
 
     float3 finalColor = float3(0.05, 0.05, 0.08);  // Background
 
@@ -285,8 +225,7 @@ void RayGen() {
         float3 normal = payload.normal;
         uint objID = payload.objectID;
         uint matType = payload.materialType;
-        uint cubeIdx = payload.cubeIndex;
-        float3 baseColor = GetObjectColor(objID, cubeIdx);
+        float3 baseColor = GetObjectColor(payload.material);
 
         // Emissive light
         if (objID == OBJ_LIGHT) {
@@ -304,11 +243,12 @@ void RayGen() {
 
             RayPayload reflectPayload;
             reflectPayload.hit = false;
-            reflectPayload.cubeIndex = 0;
-            TraceRay(Scene, RAY_FLAG_NONE, 0xFF, 0, 1, 0, reflectRay, reflectPayload);
+            reflectPayload.material = 0;
+            TRACE_SECONDARY(reflectRay, reflectPayload);
+            CountRays(RAY_REFLECT, 1);
 
             if (reflectPayload.hit) {
-                float3 reflColor = GetObjectColor(reflectPayload.objectID, reflectPayload.cubeIndex);
+                float3 reflColor = GetObjectColor(reflectPayload.material);
                 if (reflectPayload.objectID == OBJ_LIGHT) {
                     reflColor = float3(1.0, 0.98, 0.9);
                 } else {
@@ -338,12 +278,13 @@ void RayGen() {
 
             RayPayload throughPayload;
             throughPayload.hit = false;
-            throughPayload.cubeIndex = 0;
-            TraceRay(Scene, RAY_FLAG_NONE, 0xFF, 0, 1, 0, throughRay, throughPayload);
+            throughPayload.material = 0;
+            TRACE_SECONDARY(throughRay, throughPayload);
+            CountRays(RAY_REFLECT, 1);
 
             float3 behindColor = float3(0.05, 0.05, 0.08);
             if (throughPayload.hit) {
-                behindColor = GetObjectColor(throughPayload.objectID, throughPayload.cubeIndex);
+                behindColor = GetObjectColor(throughPayload.material);
                 if (throughPayload.objectID != OBJ_LIGHT) {
                     float3 toLight = normalize(LightPos - throughPayload.hitPos);
                     float NdotL = max(dot(throughPayload.normal, toLight), 0.0);
@@ -362,7 +303,8 @@ void RayGen() {
 #endif
         // Diffuse surfaces
         else {
-            uint seed = launchIndex.x + launchIndex.y * 1920 + FrameCount * 1920 * 1080;
+            // One shading sample per pixel and frame: frame n is sample n of the sequence
+            RTSampler rng = SamplerCreate(launchIndex, launchDim.x, launchDim.y, FrameCount, FrameCount);
 
             float3 toLight = normalize(LightPos - hitPos);
             float NdotL = max(dot(normal, toLight), 0.0);
@@ -375,7 +317,8 @@ void RayGen() {
             shadow = 0.0;
             int shadowSamples = max(ShadowSamples, 1);
             for (int s = 0; s < shadowSamples; s++) {
-                float3 jitter = RandomInDisk(seed) * LightRadius;
+                RTSampler shadowRng = SamplerLoop(rng, s, shadowSamples);
+                float3 jitter = RandomInDisk(shadowRng) * LightRadius;
                 float3 targetPos = LightPos + jitter;
                 float3 toJitteredLight = targetPos - hitPos;
                 float jitteredDist = length(toJitteredLight);
@@ -395,6 +338,8 @@ void RayGen() {
                 if (!shadowPayload.inShadow) shadow += 1.0;
             }
             shadow /= float(shadowSamples);
+            CountRays(RAY_SHADOW, shadowSamples);
+            SamplerSkip(rng, 1);
 #else
             // Single hard shadow ray
             {
@@ -409,6 +354,7 @@ void RayGen() {
                 TraceRay(Scene, RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH,
                          0xFF, 1, 1, 1, shadowRay, shadowPayload);
                 shadow = shadowPayload.inShadow ? 0.0 : 1.0;
+                CountRays(RAY_SHADOW, 1);
             }
 #endif
 
@@ -418,7 +364,8 @@ void RayGen() {
             ao = 0.0;
             int aoSamples = max(AOSamples, 1);
             for (int a = 0; a < aoSamples; a++) {
-                float3 aoDir = RandomInHemisphere(normal, seed);
+                RTSampler aoRng = SamplerLoop(rng, a, aoSamples);
+                float3 aoDir = RandomInHemisphere(normal, aoRng);
 
                 RayDesc aoRay;
                 aoRay.Origin = hitPos + normal * 0.002;
@@ -434,12 +381,14 @@ void RayGen() {
                 if (!aoPayload.inShadow) ao += 1.0;
             }
             ao /= float(aoSamples);
+            CountRays(RAY_AO, aoSamples);
+            SamplerSkip(rng, 1);
 #endif
 
             // ============== GLOBAL ILLUMINATION ==============
             float3 gi = float3(0, 0, 0);
 #ifdef FEATURE_GI
-            float3 giDir = RandomInHemisphere(normal, seed);
+            float3 giDir = RandomInHemisphere(normal, rng);
 
             RayDesc giRay;
             giRay.Origin = hitPos + normal * 0.002;
@@ -449,11 +398,12 @@ void RayGen() {
 
             RayPayload giPayload;
             giPayload.hit = false;
-            giPayload.cubeIndex = 0;
-            TraceRay(Scene, RAY_FLAG_NONE, 0xFF, 0, 1, 0, giRay, giPayload);
+            giPayload.material = 0;
+            TRACE_SECONDARY(giRay, giPayload);
+            CountRays(RAY_GI, 1);
 
             if (giPayload.hit && giPayload.objectID != OBJ_LIGHT) {
-                float3 giColor = GetObjectColor(giPayload.objectID, giPayload.cubeIndex);
+                float3 giColor = GetObjectColor(giPayload.material);
                 float giNdotL = max(dot(giPayload.normal, -giDir), 0.0);
                 gi = giColor * giNdotL * 0.3;
             }
@@ -493,28 +443,17 @@ static const char* g_dxr10ShaderPart3 = R"HLSL(
 // ============== CLOSEST HIT SHADER ==============
 [shader("closesthit")]
 void ClosestHit(inout RayPayload payload, in BuiltInTriangleIntersectionAttributes attribs) {
-    uint primIdx = PrimitiveIndex();
-    // Use InstanceIndex() instead of InstanceID() - InstanceIndex returns 0-based TLAS index
-    // InstanceID() returns user-defined value which we never set, so it's always 0!
-    uint instIdx = InstanceIndex();
+    Primitive prim = Primitives[InstanceID() + PrimitiveIndex()];
+    Material m = Materials[prim.material];
 
     payload.hitPos = WorldRayOrigin() + WorldRayDirection() * RayTCurrent();
     payload.hitT = RayTCurrent();
     payload.hit = true;
-    payload.cubeIndex = 0;
-
-    if (instIdx == INSTANCE_STATIC) {  // Instance 0 = static geometry
-        // Static geometry - use primitive ranges to determine object
-        GetStaticObjectInfo(primIdx, payload.objectID, payload.materialType, payload.normal);
-    } else {
-        // Dynamic cubes - Instance 1
-        payload.objectID = OBJ_CUBE;
-        payload.materialType = MAT_DIFFUSE;
-        // Each of 8 cubes has 12 triangles
-        payload.cubeIndex = primIdx / 12;
-        // Get rotated normal
-        payload.normal = GetCubeFaceNormal(primIdx);
-    }
+    payload.objectID = m.objectID;
+    payload.materialType = m.type;
+    payload.material = prim.material;
+    // Instance transforms are rigid, so the 3x3 part rotates normals as well
+    payload.normal = normalize(mul((float3x3)ObjectToWorld3x4(), prim.normal));
 }
 
 // ============== MISS SHADER ==============
@@ -576,6 +515,7 @@ static ID3D12CommandQueue* s_cmdQueue = nullptr;
 static ID3D12CommandAllocator* s_cmdAlloc[3] = {};
 static ID3D12GraphicsCommandList4* s_cmdList = nullptr;
 static IDXGISwapChain3* s_swapChain = nullptr;
+static HANDLE s_swapWaitable = nullptr;   // --max-latency
 
 static ID3D12DescriptorHeap* s_rtvHeap = nullptr;
 static ID3D12Resource* s_renderTargets[3] = {};
@@ -594,6 +534,7 @@ static ID3D12Resource* s_tlas = nullptr;
 static ID3D12Resource* s_scratchBuffer = nullptr;
 static ID3D12Resource* s_instanceBuffer = nullptr;
 static void* s_instanceMapped = nullptr;
+static TlasPolicy s_tlasPolicy;   // Refit vs rebuild, see tlas_policy.h
 
 static ID3D12Resource* s_vertexBufferStatic = nullptr;
 static ID3D12Resource* s_indexBufferStatic = nullptr;
@@ -602,8 +543,14 @@ static ID3D12Resource* s_indexBufferCube = nullptr;
 static UINT s_vertexCountStatic = 0, s_indexCountStatic = 0;
 static UINT s_vertexCountCube = 0, s_indexCountCube = 0;
 
-static ID3D12Resource* s_constantBuffer = nullptr;
-static void* s_cbMapped = nullptr;
+// Primitive (t1) and material (t2) tables of ClosestHit, see d3d12_rt_tables.cpp.
+// Materials 0-10 are the objects by OBJ_*, 11-18 the eight rotating cubes.
+#define DXR10_CUBE_MATERIAL_BASE 11
+static RTTables12 s_rtTables;
+static ID3D12Resource* s_blueNoise = nullptr;   // --sampler=bluenoise tile (t0 space1)
+static UINT s_tableBaseStatic = 0, s_tableBaseCube = 0;   // TLAS InstanceIDs
+
+static FrameRing12 s_frameRing;   // Per-frame CB + text vertices
 
 // RT pipeline
 static ID3D12StateObject* s_rtPSO = nullptr;
@@ -619,16 +566,8 @@ static UINT64 s_rayGenRecordSize = 0;
 static UINT64 s_missRecordSize = 0;
 static UINT64 s_hitGroupRecordSize = 0;
 
-// Text rendering
-static ID3D12RootSignature* s_textRootSig = nullptr;
-static ID3D12PipelineState* s_textPso = nullptr;
-static ID3D12DescriptorHeap* s_textSrvHeap = nullptr;
-static ID3D12Resource* s_fontTexture = nullptr;
-static ID3D12Resource* s_textVB = nullptr;
-static D3D12_VERTEX_BUFFER_VIEW s_textVBView = {};
-static void* s_textVBMapped = nullptr;
-static TextVert s_textVerts[6000];
-static UINT s_textVertCount = 0;
+// Text overlay (instanced glyphs, see d3d12_overlay.cpp)
+static Overlay12 s_overlay;
 static int s_cachedFps = -1;
 static std::wstring s_gpuName;
 
@@ -636,22 +575,26 @@ static std::wstring s_gpuName;
 static void WaitForGpu10() {
     if (!s_cmdQueue || !s_fence || !s_fenceEvent) return;
     const UINT64 fv = s_fenceValues[s_frameIndex];
+    FrameRingRetire12(s_frameRing, fv);
     s_cmdQueue->Signal(s_fence, fv);
     if (s_fence->GetCompletedValue() < fv) {
         s_fence->SetEventOnCompletion(fv, s_fenceEvent);
         WaitForSingleObject(s_fenceEvent, INFINITE);
     }
+    FrameRingReclaim12(s_frameRing, s_fence->GetCompletedValue());
     s_fenceValues[s_frameIndex]++;
 }
 
 static void MoveToNextFrame10() {
     const UINT64 currentFenceValue = s_fenceValues[s_frameIndex];
+    FrameRingRetire12(s_frameRing, currentFenceValue);
     s_cmdQueue->Signal(s_fence, currentFenceValue);
     s_frameIndex = s_swapChain->GetCurrentBackBufferIndex();
     if (s_fence->GetCompletedValue() < s_fenceValues[s_frameIndex]) {
         s_fence->SetEventOnCompletion(s_fenceValues[s_frameIndex], s_fenceEvent);
         WaitForSingleObject(s_fenceEvent, INFINITE);
     }
+    FrameRingReclaim12(s_frameRing, s_fence->GetCompletedValue());
     s_fenceValues[s_frameIndex] = currentFenceValue + 1;
 }
 
@@ -722,6 +665,48 @@ static void BuildDynamicCube10(std::vector<DXR10Vert>& verts, std::vector<UINT>&
     }
 }
 
+// Triangle -> material: static objects by OBJ_*, the cubes by the index kept in materialType
+static UINT MaterialOf10(UINT objectID, UINT materialType) {
+    return objectID == DXR10_OBJ_CUBE ? DXR10_CUBE_MATERIAL_BASE + materialType : objectID;
+}
+
+static void BuildSceneTables10(const std::vector<DXR10Vert>& vertsStatic, const std::vector<UINT>& indsStatic,
+                               const std::vector<DXR10Vert>& vertsCube, const std::vector<UINT>& indsCube) {
+    // Scene colors by OBJ_* (must match DXR 1.1)
+    static const float objectColors[DXR10_CUBE_MATERIAL_BASE][3] = {
+        {0.7f, 0.7f, 0.7f},     // Floor - grey
+        {0.9f, 0.9f, 0.9f},     // Ceiling - white
+        {0.7f, 0.7f, 0.7f},     // Back wall - grey
+        {0.75f, 0.15f, 0.15f},  // Left wall - RED
+        {0.15f, 0.75f, 0.15f},  // Right wall - GREEN
+        {15.0f, 14.0f, 12.0f},  // Light - bright emissive
+        {0.9f, 0.6f, 0.2f},     // Cube - orange (fallback)
+        {0.95f, 0.95f, 0.95f},  // Mirror - neutral
+        {0.9f, 0.95f, 1.0f},    // Glass - slight blue tint
+        {0.9f, 0.15f, 0.1f},    // Small cube - RED
+        {0.5f, 0.15f, 0.7f}     // Front wall - PURPLE
+    };
+    // Rotating cubes, brighter and more saturated
+    static const float cubeColors[8][3] = {
+        {1.0f, 0.15f, 0.1f}, {0.1f, 0.9f, 0.2f}, {0.1f, 0.4f, 1.0f}, {1.0f, 0.95f, 0.1f},
+        {1.0f, 0.95f, 0.1f}, {0.1f, 0.4f, 1.0f}, {0.1f, 0.9f, 0.2f}, {1.0f, 0.15f, 0.1f}
+    };
+
+    RTTablesRelease12(s_rtTables);
+    for (UINT i = 0; i < DXR10_CUBE_MATERIAL_BASE; i++) {
+        UINT type = i == DXR10_OBJ_LIGHT ? DXR10_MAT_EMISSIVE : i == DXR10_OBJ_MIRROR ? DXR10_MAT_MIRROR :
+                    i == DXR10_OBJ_GLASS ? DXR10_MAT_GLASS : DXR10_MAT_DIFFUSE;
+        RTTablesAddMaterial12(s_rtTables, objectColors[i][0], objectColors[i][1], objectColors[i][2], type, i);
+    }
+    for (UINT i = 0; i < 8; i++)
+        RTTablesAddMaterial12(s_rtTables, cubeColors[i][0], cubeColors[i][1], cubeColors[i][2], DXR10_MAT_DIFFUSE, DXR10_OBJ_CUBE);
+
+    s_tableBaseStatic = RTTablesAddTriangles12(s_rtTables, vertsStatic.data(), sizeof(DXR10Vert),
+                                               indsStatic.data(), (UINT)indsStatic.size(), MaterialOf10);
+    s_tableBaseCube = RTTablesAddTriangles12(s_rtTables, vertsCube.data(), sizeof(DXR10Vert),
+                                             indsCube.data(), (UINT)indsCube.size(), MaterialOf10);
+}
+
 static void UpdateCubeTransform10(float time) {
     if (!s_instanceMapped) return;
     float angleY = time * 1.2f, angleX = time * 0.7f;
@@ -736,25 +721,11 @@ static void UpdateCubeTransform10(float time) {
     instances[1].Transform[2][0] = m02; instances[1].Transform[2][1] = m12; instances[1].Transform[2][2] = m22; instances[1].Transform[2][3] = tz;
 }
 
+// Refit in place, or a full build when tlas_policy.h asks for one
 static void RebuildTLAS10() {
     if (!s_cmdList || !s_tlas || !s_instanceBuffer) return;
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs = {};
-    tlasInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    tlasInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    tlasInputs.NumDescs = 2;
-    tlasInputs.InstanceDescs = s_instanceBuffer->GetGPUVirtualAddress();
-    tlasInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC tlasBuildDesc = {};
-    tlasBuildDesc.Inputs = tlasInputs;
-    tlasBuildDesc.Inputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
-    tlasBuildDesc.SourceAccelerationStructureData = s_tlas->GetGPUVirtualAddress();
-    tlasBuildDesc.DestAccelerationStructureData = s_tlas->GetGPUVirtualAddress();
-    tlasBuildDesc.ScratchAccelerationStructureData = s_scratchBuffer->GetGPUVirtualAddress();
-    s_cmdList->BuildRaytracingAccelerationStructure(&tlasBuildDesc, 0, nullptr);
-    D3D12_RESOURCE_BARRIER uavBarrier = {};
-    uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-    uavBarrier.UAV.pResource = s_tlas;
-    s_cmdList->ResourceBarrier(1, &uavBarrier);
+    TlasUpdate12(s_cmdList, s_frameRing, s_tlasPolicy, s_tlas, s_scratchBuffer,
+                 (const D3D12_RAYTRACING_INSTANCE_DESC*)s_instanceMapped, 2, s_instanceBuffer->GetGPUVirtualAddress());
 }
 
 // ============== FEATURE DEFINE BUILDING ==============
@@ -770,76 +741,171 @@ static int BuildDXR10Defines(const DXR10Features& f, const wchar_t** defines) {
     return count;
 }
 
-// Recompile shaders with new feature flags
-static bool RecompileDXR10Shaders(const DXR10Features& features) {
-    if (!s_device) return false;
-
-    Log("[DXR10] Recompiling shaders with features: %s%s%s%s%s%s\n",
-        features.spotlight ? "Spot " : "",
-        features.softShadows ? "SoftShadow " : "",
-        features.ambientOcclusion ? "AO " : "",
-        features.globalIllum ? "GI " : "",
-        features.reflections ? "Reflect " : "",
-        features.glassRefraction ? "Glass " : "");
-
-    // Build defines list
+// Build args array: -T lib_6_3 -O3 -D RT_SAMPLER=n [-D RAY_STATS] -D FEATURE_X -D FEATURE_Y ...
+// ser (raygen library with --ser): -T lib_6_9 -disable-payload-qualifiers -D SER, the
+// payload structs stay those of the lib_6_3 hit / miss library
+static void BuildDXR10Args(const DXR10Features& features, bool ser, std::vector<const wchar_t*>& args) {
     const wchar_t* featureDefines[10];
     int defineCount = BuildDXR10Defines(features, featureDefines);
-
-    // Build args array: -T lib_6_3 -O3 -D FEATURE_X -D FEATURE_Y ...
-    std::vector<const wchar_t*> args;
+    args.clear();
     args.push_back(L"-T");
-    args.push_back(L"lib_6_3");
+    args.push_back(ser ? L"lib_6_9" : L"lib_6_3");
     args.push_back(L"-O3");
+    if (ser) {
+        args.push_back(L"-disable-payload-qualifiers");
+        args.push_back(L"-D");
+        args.push_back(L"SER");
+    }
+    args.push_back(L"-D");
+    args.push_back(RtSamplerDefine());
+    if (RayCountersAddress12()) {   // --ray-stats, global root parameter 3
+        args.push_back(L"-D");
+        args.push_back(L"RAY_STATS");
+    }
     for (int i = 0; i < defineCount; i++) {
         args.push_back(L"-D");
         args.push_back(featureDefines[i]);
     }
+}
 
-    // Combine shader parts
-    std::string shaderCode = std::string(g_dxr10ShaderPart1) + g_dxr10ShaderPart2 + g_dxr10ShaderPart3;
+// Combine shader parts: the raygen collection is Part1 + Part2 with the
+// feature defines, the hit / miss collection Part1 + Part3 without them
+static std::string GetDXR10RayGenSource() {
+    return std::string(g_rtSamplingShaderCode) + g_rayStatsShaderCode + g_dxr10ShaderPart1 + g_dxr10ShaderPart2;
+}
 
-    // Load DXC
-    typedef HRESULT(WINAPI* DxcCreateInstanceProc)(REFCLSID, REFIID, LPVOID*);
-    HMODULE dxcMod = LoadLibraryW(L"dxcompiler.dll");
-    if (!dxcMod) { Log("[DXR10] Cannot load dxcompiler.dll\n"); return false; }
-    auto DxcCreate = (DxcCreateInstanceProc)GetProcAddress(dxcMod, "DxcCreateInstance");
+static std::string GetDXR10HitMissSource() {
+    return std::string(g_rtSamplingShaderCode) + g_rayStatsShaderCode + g_dxr10ShaderPart1 + g_dxr10ShaderPart3;
+}
 
-    IDxcUtils* utils = nullptr; IDxcCompiler3* compiler = nullptr;
-    DxcCreate(CLSID_DxcUtils, IID_PPV_ARGS(&utils));
-    DxcCreate(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler));
+#define DXR10_FEATURE_VARIANTS (1u << 6)
 
-    IDxcBlobEncoding* srcBlob = nullptr;
-    utils->CreateBlob(shaderCode.c_str(), (UINT)shaderCode.size(), CP_UTF8, &srcBlob);
-    DxcBuffer srcBuf = { srcBlob->GetBufferPointer(), srcBlob->GetBufferSize(), CP_UTF8 };
+// --ser with a device that runs SM 6.9 hit objects; fixed after init
+static bool s_ser = false;
 
-    IDxcResult* result = nullptr;
-    compiler->Compile(&srcBuf, args.data(), (UINT)args.size(), nullptr, IID_PPV_ARGS(&result));
+static UINT FeatureMask10(const DXR10Features& f) {
+    return (f.spotlight ? 0x01u : 0u) | (f.softShadows ? 0x02u : 0u) | (f.ambientOcclusion ? 0x04u : 0u) |
+           (f.globalIllum ? 0x08u : 0u) | (f.reflections ? 0x10u : 0u) | (f.glassRefraction ? 0x20u : 0u);
+}
 
-    HRESULT status; result->GetStatus(&status);
-    if (FAILED(status)) {
-        IDxcBlobUtf8* err = nullptr;
-        result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&err), nullptr);
-        if (err) { Log("[DXR10] Shader error: %s\n", err->GetStringPointer()); err->Release(); }
-        srcBlob->Release(); result->Release(); compiler->Release(); utils->Release(); FreeLibrary(dxcMod);
-        return false;
+// ============== PERMUTATION PRECOMPILE ==============
+// All 2^6 #ifdef variants of the raygen library (twice with --ser: the SM 6.9
+// variants are only used where the device supports them) plus the feature
+// independent hit / miss library; sample counts and radii are constant-buffer values
+void AddDXR10PrecompileJobs(std::vector<ShaderPrecompileJob>& jobs) {
+    std::string source = GetDXR10RayGenSource();
+    for (UINT mask = 0; mask < DXR10_FEATURE_VARIANTS * (g_ser ? 2 : 1); mask++) {
+        DXR10Features f = {};
+        f.spotlight = (mask & 0x01) != 0;
+        f.softShadows = (mask & 0x02) != 0;
+        f.ambientOcclusion = (mask & 0x04) != 0;
+        f.globalIllum = (mask & 0x08) != 0;
+        f.reflections = (mask & 0x10) != 0;
+        f.glassRefraction = (mask & 0x20) != 0;
+        ShaderPrecompileJob job = { source, {}, "DXR10 RayGen" };
+        BuildDXR10Args(f, mask >= DXR10_FEATURE_VARIANTS, job.args);
+        jobs.push_back(job);
     }
+    ShaderPrecompileJob hitMiss = { GetDXR10HitMissSource(), {}, "DXR10 HitMiss" };
+    BuildDXR10Args(DXR10Features(), false, hitMiss.args);
+    jobs.push_back(hitMiss);
+}
+
+// State object plus the shader tables holding its identifiers. Each build gets
+// its own raygen table so a new pipeline can be prepared while the old one is
+// in flight; miss / hit group tables are shared (AddRef'd) when the pipeline
+// was added to s_basePSO, whose identifiers stay valid in every child.
+struct DXR10Pipeline {
+    ID3D12StateObject* pso;
+    ID3D12StateObjectProperties* props;
+    ID3D12Resource* rayGenTable;
+    ID3D12Resource* missTable;
+    ID3D12Resource* hitGroupTable;
+};
+
+static void ReleasePipeline10(DXR10Pipeline& p) {
+    if (p.hitGroupTable) { p.hitGroupTable->Release(); p.hitGroupTable = nullptr; }
+    if (p.missTable) { p.missTable->Release(); p.missTable = nullptr; }
+    if (p.rayGenTable) { p.rayGenTable->Release(); p.rayGenTable = nullptr; }
+    if (p.props) { p.props->Release(); p.props = nullptr; }
+    if (p.pso) { p.pso->Release(); p.pso = nullptr; }
+}
+
+static bool CreateShaderTable10(UINT64 size, ID3D12Resource** table) {
+    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
+    D3D12_RESOURCE_DESC bufDesc = {};
+    bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    bufDesc.Width = size; bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
+    bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    return SUCCEEDED(s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(table)));
+}
+
+// Records: RayGen at 0; Miss, ShadowMiss; HitGroup, ShadowHitGroup
+static void WriteRayGenTable10(ID3D12StateObjectProperties* props, ID3D12Resource* table) {
+    void* mapped;
+    table->Map(0, nullptr, &mapped);
+    memcpy(mapped, props->GetShaderIdentifier(L"RayGen"), D3D12_SHADER_IDENTIFIER_SIZE_IN_BYTES);
+    table->Unmap(0, nullptr);
+}
 
-    IDxcBlob* shaderBlob = nullptr;
-    result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
-    Log("[DXR10] Shader compiled: %zu bytes\n", shaderBlob->GetBufferSize());
+static void WriteHitMissTables10(ID3D12StateObjectProperties* props, ID3D12Resource* missTable, ID3D12Resource* hitGroupTable) {
+    UINT shaderIdSize = D3D12_SHADER_IDENTIFIER_SIZE_IN_BYTES;
+    void* mapped;
+    missTable->Map(0, nullptr, &mapped);
+    memcpy(mapped, props->GetShaderIdentifier(L"Miss"), shaderIdSize);
+    memcpy((BYTE*)mapped + s_missRecordSize, props->GetShaderIdentifier(L"ShadowMiss"), shaderIdSize);
+    missTable->Unmap(0, nullptr);
+
+    hitGroupTable->Map(0, nullptr, &mapped);
+    memcpy(mapped, props->GetShaderIdentifier(L"HitGroup"), shaderIdSize);
+    memcpy((BYTE*)mapped + s_hitGroupRecordSize, props->GetShaderIdentifier(L"ShadowHitGroup"), shaderIdSize);
+    hitGroupTable->Unmap(0, nullptr);
+}
+
+// ============== STATE OBJECT COLLECTIONS ==============
+// The feature defines only reach the raygen shader, so hit / miss shaders are
+// compiled once into a collection and each feature mask gets its own raygen
+// collection, kept until cleanup. A feature switch compiles (or takes from
+// the DXIL cache) one raygen library the first time that mask is used and
+// afterwards only links: AddToStateObject onto s_basePSO on raytracing tier
+// 1.1 (only the raygen record is rewritten), otherwise a CreateStateObject of
+// the two existing collections.
+static ID3D12Device7* s_device7 = nullptr;                                   // AddToStateObject, tier 1.1 only
+static ID3D12StateObject* s_hitMissCollection = nullptr;
+static ID3D12StateObject* s_rayGenCollections[DXR10_FEATURE_VARIANTS] = {};  // Per FeatureMask10, written by the recompile thread
+static ID3D12StateObject* s_basePSO = nullptr;                               // Hit / miss only, allows additions
+static ID3D12Resource* s_baseMissTable = nullptr;
+static ID3D12Resource* s_baseHitGroupTable = nullptr;
+
+static const D3D12_RAYTRACING_SHADER_CONFIG s_shaderConfig10 = { sizeof(float) * 10 + sizeof(UINT) * 4, sizeof(float) * 2 };
+static const D3D12_RAYTRACING_PIPELINE_CONFIG s_pipelineConfig10 = { 1 };  // Some GPUs only support depth 1
+static const D3D12_STATE_OBJECT_CONFIG s_additionsConfig10 = { D3D12_STATE_OBJECT_FLAG_ALLOW_STATE_OBJECT_ADDITIONS };
+
+// Compile a library and wrap the listed exports (+ hit groups) in a collection
+static bool CreateCollection10(const std::string& source, const std::vector<const wchar_t*>& args, const char* tag,
+                               const LPCWSTR* exportNames, UINT exportCount, bool hitGroups, ID3D12StateObject** out) {
+    *out = nullptr;
+    // DXIL comes from the shared cache when this library was compiled before.
+    // State objects can't go in an ID3D12PipelineLibrary, so only DXC is skipped.
+    ID3DBlob* shaderBlob = nullptr;
+    if (!CompileDXC(source.c_str(), args.data(), (UINT)args.size(), &shaderBlob, tag)) {
+        Log("[DXR10] %s compile failed\n", tag);
+        return false;
+    }
 
-    // Release old PSO
-    if (s_rtPSOProps) { s_rtPSOProps->Release(); s_rtPSOProps = nullptr; }
-    if (s_rtPSO) { s_rtPSO->Release(); s_rtPSO = nullptr; }
+    // Explicit exports: both libraries also define the shared helper functions
+    D3D12_EXPORT_DESC exports[4] = {};
+    for (UINT i = 0; i < exportCount && i < _countof(exports); i++) exports[i].Name = exportNames[i];
 
-    // Recreate state object with new shader
-    D3D12_STATE_SUBOBJECT subobjects[10] = {};
+    D3D12_STATE_SUBOBJECT subobjects[8] = {};
     int subIdx = 0;
 
     D3D12_DXIL_LIBRARY_DESC libDesc = {};
     libDesc.DXILLibrary.pShaderBytecode = shaderBlob->GetBufferPointer();
     libDesc.DXILLibrary.BytecodeLength = shaderBlob->GetBufferSize();
+    libDesc.NumExports = min(exportCount, (UINT)_countof(exports));
+    libDesc.pExports = exports;
     subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_DXIL_LIBRARY;
     subobjects[subIdx++].pDesc = &libDesc;
 
@@ -847,102 +913,309 @@ static bool RecompileDXR10Shaders(const DXR10Features& features) {
     hitGroupDesc.HitGroupExport = L"HitGroup";
     hitGroupDesc.ClosestHitShaderImport = L"ClosestHit";
     hitGroupDesc.Type = D3D12_HIT_GROUP_TYPE_TRIANGLES;
-    subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_HIT_GROUP;
-    subobjects[subIdx++].pDesc = &hitGroupDesc;
-
     D3D12_HIT_GROUP_DESC shadowHitGroupDesc = {};
     shadowHitGroupDesc.HitGroupExport = L"ShadowHitGroup";
     shadowHitGroupDesc.ClosestHitShaderImport = L"ShadowHit";
     shadowHitGroupDesc.Type = D3D12_HIT_GROUP_TYPE_TRIANGLES;
-    subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_HIT_GROUP;
-    subobjects[subIdx++].pDesc = &shadowHitGroupDesc;
+    if (hitGroups) {
+        subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_HIT_GROUP;
+        subobjects[subIdx++].pDesc = &hitGroupDesc;
+        subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_HIT_GROUP;
+        subobjects[subIdx++].pDesc = &shadowHitGroupDesc;
+    }
 
-    D3D12_RAYTRACING_SHADER_CONFIG shaderConfig = {};
-    shaderConfig.MaxPayloadSizeInBytes = sizeof(float) * 10 + sizeof(UINT) * 4;
-    shaderConfig.MaxAttributeSizeInBytes = sizeof(float) * 2;
+    // A collection is compiled on its own, so it carries the full configuration
     subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_RAYTRACING_SHADER_CONFIG;
-    subobjects[subIdx++].pDesc = &shaderConfig;
-
+    subobjects[subIdx++].pDesc = &s_shaderConfig10;
     subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_GLOBAL_ROOT_SIGNATURE;
     subobjects[subIdx++].pDesc = &s_globalRootSig;
-
-    D3D12_RAYTRACING_PIPELINE_CONFIG pipelineConfig = {};
-    pipelineConfig.MaxTraceRecursionDepth = 1;  // Some GPUs only support depth 1
     subobjects[subIdx].Type = D3D12_STATE_SUBOBJECT_TYPE_RAYTRACING_PIPELINE_CONFIG;
-    subobjects[subIdx++].pDesc = &pipelineConfig;
+    subobjects[subIdx++].pDesc = &s_pipelineConfig10;
 
     D3D12_STATE_OBJECT_DESC stateDesc = {};
-    stateDesc.Type = D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE;
+    stateDesc.Type = D3D12_STATE_OBJECT_TYPE_COLLECTION;
     stateDesc.NumSubobjects = subIdx;
     stateDesc.pSubobjects = subobjects;
+    HRESULT hr = s_device->CreateStateObject(&stateDesc, IID_PPV_ARGS(out));
+    shaderBlob->Release();
+    if (FAILED(hr)) {
+        Log("[DXR10] %s collection: CreateStateObject failed: 0x%08X\n", tag, hr);
+        *out = nullptr;
+        return false;
+    }
+    return true;
+}
 
-    HRESULT hr = s_device->CreateStateObject(&stateDesc, IID_PPV_ARGS(&s_rtPSO));
-    shaderBlob->Release(); srcBlob->Release(); result->Release(); compiler->Release(); utils->Release(); FreeLibrary(dxcMod);
+static void ReleaseCollections10() {
+    for (UINT i = 0; i < DXR10_FEATURE_VARIANTS; i++) {
+        if (s_rayGenCollections[i]) { s_rayGenCollections[i]->Release(); s_rayGenCollections[i] = nullptr; }
+    }
+    if (s_baseHitGroupTable) { s_baseHitGroupTable->Release(); s_baseHitGroupTable = nullptr; }
+    if (s_baseMissTable) { s_baseMissTable->Release(); s_baseMissTable = nullptr; }
+    if (s_basePSO) { s_basePSO->Release(); s_basePSO = nullptr; }
+    if (s_hitMissCollection) { s_hitMissCollection->Release(); s_hitMissCollection = nullptr; }
+    if (s_device7) { s_device7->Release(); s_device7 = nullptr; }
+}
 
-    if (FAILED(hr)) {
-        Log("[DXR10] CreateStateObject failed: 0x%08X\n", hr);
+// Init: the hit / miss collection and, on tier 1.1, the base pipeline every
+// raygen variant is added to (with its miss / hit group tables)
+static bool CreateHitMissCollection10() {
+    std::vector<const wchar_t*> args;
+    BuildDXR10Args(DXR10Features(), false, args);
+    const LPCWSTR exportNames[] = { L"ClosestHit", L"Miss", L"ShadowHit", L"ShadowMiss" };
+    if (!CreateCollection10(GetDXR10HitMissSource(), args, "DXR10 HitMiss", exportNames, _countof(exportNames), true,
+                            &s_hitMissCollection)) {
         return false;
     }
 
-    s_rtPSO->QueryInterface(IID_PPV_ARGS(&s_rtPSOProps));
+    D3D12_FEATURE_DATA_D3D12_OPTIONS5 options5 = {};
+    if (FAILED(s_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS5, &options5, sizeof(options5))) ||
+        options5.RaytracingTier < D3D12_RAYTRACING_TIER_1_1 ||
+        FAILED(s_device->QueryInterface(IID_PPV_ARGS(&s_device7)))) {
+        s_device7 = nullptr;
+        Log("[DXR10] Raygen variants linked with CreateStateObject (AddToStateObject needs raytracing tier 1.1)\n");
+        return true;
+    }
 
-    // Update shader tables with new identifiers
-    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
-    UINT shaderIdSize = D3D12_SHADER_IDENTIFIER_SIZE_IN_BYTES;
-    void* mapped;
+    D3D12_EXISTING_COLLECTION_DESC hitMiss = { s_hitMissCollection, 0, nullptr };
+    D3D12_STATE_SUBOBJECT subobjects[3] = {
+        { D3D12_STATE_SUBOBJECT_TYPE_STATE_OBJECT_CONFIG, &s_additionsConfig10 },
+        { D3D12_STATE_SUBOBJECT_TYPE_EXISTING_COLLECTION, &hitMiss },
+        { D3D12_STATE_SUBOBJECT_TYPE_RAYTRACING_PIPELINE_CONFIG, &s_pipelineConfig10 },
+    };
+    D3D12_STATE_OBJECT_DESC stateDesc = { D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE, _countof(subobjects), subobjects };
+    ID3D12StateObjectProperties* props = nullptr;
+    HRESULT hr = s_device->CreateStateObject(&stateDesc, IID_PPV_ARGS(&s_basePSO));
+    if (SUCCEEDED(hr)) hr = s_basePSO->QueryInterface(IID_PPV_ARGS(&props));
+    if (FAILED(hr) ||
+        !CreateShaderTable10(s_missRecordSize * 2, &s_baseMissTable) ||
+        !CreateShaderTable10(s_hitGroupRecordSize * 2, &s_baseHitGroupTable)) {
+        Log("[DXR10] Base state object failed (0x%08X), linking raygen variants with CreateStateObject\n", hr);
+        if (props) props->Release();
+        if (s_baseHitGroupTable) { s_baseHitGroupTable->Release(); s_baseHitGroupTable = nullptr; }
+        if (s_baseMissTable) { s_baseMissTable->Release(); s_baseMissTable = nullptr; }
+        if (s_basePSO) { s_basePSO->Release(); s_basePSO = nullptr; }
+        s_device7->Release(); s_device7 = nullptr;
+        return true;
+    }
+    WriteHitMissTables10(props, s_baseMissTable, s_baseHitGroupTable);
+    props->Release();
+    Log("[DXR10] Hit / miss base state object created, raygen variants linked with AddToStateObject\n");
+    return true;
+}
 
-    s_rayGenTable->Map(0, nullptr, &mapped);
-    memcpy(mapped, s_rtPSOProps->GetShaderIdentifier(L"RayGen"), shaderIdSize);
-    s_rayGenTable->Unmap(0, nullptr);
+// --ser: hit objects are SM 6.9 and need raytracing tier 1.2 (DXR 1.2). The
+// enum values postdate some SDK headers, hence the casts.
+static const char* SerUnsupported10() {
+    D3D12_FEATURE_DATA_D3D12_OPTIONS5 options5 = {};
+    if (FAILED(s_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS5, &options5, sizeof(options5))) ||
+        options5.RaytracingTier < (D3D12_RAYTRACING_TIER)12) {
+        return "DXR 1.0 needs raytracing tier 1.2 for hit objects";
+    }
+    D3D12_FEATURE_DATA_SHADER_MODEL sm = { (D3D_SHADER_MODEL)0x69 };
+    if (FAILED(s_device->CheckFeatureSupport(D3D12_FEATURE_SHADER_MODEL, &sm, sizeof(sm))) ||
+        sm.HighestShaderModel < (D3D_SHADER_MODEL)0x69) {
+        return "DXR 1.0 needs shader model 6.9 for hit objects";
+    }
+    return nullptr;
+}
 
-    s_missTable->Map(0, nullptr, &mapped);
-    memcpy(mapped, s_rtPSOProps->GetShaderIdentifier(L"Miss"), shaderIdSize);
-    memcpy((BYTE*)mapped + s_missRecordSize, s_rtPSOProps->GetShaderIdentifier(L"ShadowMiss"), shaderIdSize);
-    s_missTable->Unmap(0, nullptr);
+// Link the feature set's raygen collection (compiled on first use) with the
+// hit / miss shaders and fill the shader tables. Only touches s_device,
+// s_device7, the collections and the record sizes, so it is safe on a worker
+// thread while the current pipeline keeps tracing. On failure everything
+// created so far is released.
+static bool BuildDXR10Pipeline(const DXR10Features& features, DXR10Pipeline& out) {
+    out = {};
+    if (!s_device || !s_hitMissCollection) return false;
+
+    UINT mask = FeatureMask10(features);
+    if (!s_rayGenCollections[mask]) {
+        Log("[DXR10] Compiling raygen with features: %s%s%s%s%s%s\n",
+            features.spotlight ? "Spot " : "",
+            features.softShadows ? "SoftShadow " : "",
+            features.ambientOcclusion ? "AO " : "",
+            features.globalIllum ? "GI " : "",
+            features.reflections ? "Reflect " : "",
+            features.glassRefraction ? "Glass " : "");
+        std::vector<const wchar_t*> args;
+        BuildDXR10Args(features, s_ser, args);
+        const LPCWSTR exportNames[] = { L"RayGen" };
+        if (!CreateCollection10(GetDXR10RayGenSource(), args, "DXR10 RayGen", exportNames, 1, false,
+                                &s_rayGenCollections[mask])) {
+            return false;
+        }
+    }
 
-    s_hitGroupTable->Map(0, nullptr, &mapped);
-    memcpy(mapped, s_rtPSOProps->GetShaderIdentifier(L"HitGroup"), shaderIdSize);
-    memcpy((BYTE*)mapped + s_hitGroupRecordSize, s_rtPSOProps->GetShaderIdentifier(L"ShadowHitGroup"), shaderIdSize);
-    s_hitGroupTable->Unmap(0, nullptr);
+    LARGE_INTEGER linkStart, linkEnd, freq;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&linkStart);
+    StartupPhaseBegin("RT state object");
+    D3D12_EXISTING_COLLECTION_DESC rayGen = { s_rayGenCollections[mask], 0, nullptr };
+    D3D12_EXISTING_COLLECTION_DESC hitMiss = { s_hitMissCollection, 0, nullptr };
+    HRESULT hr;
+    if (s_basePSO) {
+        D3D12_STATE_SUBOBJECT subobjects[2] = {
+            { D3D12_STATE_SUBOBJECT_TYPE_STATE_OBJECT_CONFIG, &s_additionsConfig10 },
+            { D3D12_STATE_SUBOBJECT_TYPE_EXISTING_COLLECTION, &rayGen },
+        };
+        D3D12_STATE_OBJECT_DESC addition = { D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE, _countof(subobjects), subobjects };
+        hr = s_device7->AddToStateObject(&addition, s_basePSO, IID_PPV_ARGS(&out.pso));
+    } else {
+        D3D12_STATE_SUBOBJECT subobjects[3] = {
+            { D3D12_STATE_SUBOBJECT_TYPE_EXISTING_COLLECTION, &hitMiss },
+            { D3D12_STATE_SUBOBJECT_TYPE_EXISTING_COLLECTION, &rayGen },
+            { D3D12_STATE_SUBOBJECT_TYPE_RAYTRACING_PIPELINE_CONFIG, &s_pipelineConfig10 },
+        };
+        D3D12_STATE_OBJECT_DESC stateDesc = { D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE, _countof(subobjects), subobjects };
+        hr = s_device->CreateStateObject(&stateDesc, IID_PPV_ARGS(&out.pso));
+    }
+    StartupPhaseEnd();
+    QueryPerformanceCounter(&linkEnd);
 
-    s_compiledFeatures = features;
-    Log("[DXR10] Shaders recompiled successfully\n");
+    if (FAILED(hr)) {
+        Log("[DXR10] %s failed: 0x%08X\n", s_basePSO ? "AddToStateObject" : "CreateStateObject (link)", hr);
+        out.pso = nullptr;
+        return false;
+    }
+    Log("[DXR10] Raygen variant 0x%02X linked in %.2f ms\n", mask,
+        (double)(linkEnd.QuadPart - linkStart.QuadPart) * 1000.0 / freq.QuadPart);
+
+    out.pso->QueryInterface(IID_PPV_ARGS(&out.props));
+    if (!out.props || !CreateShaderTable10(s_rayGenRecordSize, &out.rayGenTable)) {
+        Log("[DXR10] Shader table creation failed\n");
+        ReleasePipeline10(out);
+        return false;
+    }
+    WriteRayGenTable10(out.props, out.rayGenTable);
+
+    // Identifiers of the parent's shaders stay valid in the child state object
+    if (s_basePSO) {
+        out.missTable = s_baseMissTable; out.missTable->AddRef();
+        out.hitGroupTable = s_baseHitGroupTable; out.hitGroupTable->AddRef();
+        return true;
+    }
+    if (!CreateShaderTable10(s_missRecordSize * 2, &out.missTable) ||
+        !CreateShaderTable10(s_hitGroupRecordSize * 2, &out.hitGroupTable)) {
+        Log("[DXR10] Shader table creation failed\n");
+        ReleasePipeline10(out);
+        return false;
+    }
+    WriteHitMissTables10(out.props, out.missTable, out.hitGroupTable);
     return true;
 }
 
-// ============== TEXT DRAWING ==============
-static void DrawText10(const char* text, float x, float y, float r, float g, float b, float a, float scale) {
-    const float charW = 8.0f * scale, charH = 8.0f * scale;
-    float startX = x;
-    while (*text && s_textVertCount < 5994) {
-        char c = *text++;
-        if (c == '\n') { y += charH + 2; x = startX; continue; }
-        if (c < 32 || c > 127) c = '?';
-        int ci = c - 32, row = ci / 16, col = ci % 16;
-        float u0 = col / 16.0f, v0 = row / 6.0f, u1 = (col + 1) / 16.0f, v1 = (row + 1) / 6.0f;
-        float x0 = x * 2.0f / W - 1.0f, y0 = 1.0f - y * 2.0f / H;
-        float x1 = (x + charW) * 2.0f / W - 1.0f, y1 = 1.0f - (y + charH) * 2.0f / H;
-        TextVert* v = &s_textVerts[s_textVertCount];
-        v[0] = {x0, y0, u0, v0, r, g, b, a}; v[1] = {x1, y0, u1, v0, r, g, b, a}; v[2] = {x0, y1, u0, v1, r, g, b, a};
-        v[3] = {x1, y0, u1, v0, r, g, b, a}; v[4] = {x1, y1, u1, v1, r, g, b, a}; v[5] = {x0, y1, u0, v1, r, g, b, a};
-        s_textVertCount += 6; x += charW;
+// Make a built pipeline current (the statics used by RenderD3D12DXR10)
+static void InstallPipeline10(const DXR10Pipeline& p, const DXR10Features& features) {
+    s_rtPSO = p.pso;
+    s_rtPSOProps = p.props;
+    s_rayGenTable = p.rayGenTable;
+    s_missTable = p.missTable;
+    s_hitGroupTable = p.hitGroupTable;
+    s_compiledFeatures = features;
+}
+
+static DXR10Pipeline CurrentPipeline10() {
+    return { s_rtPSO, s_rtPSOProps, s_rayGenTable, s_missTable, s_hitGroupTable };
+}
+
+// ============== ASYNC RECOMPILE ==============
+// Feature toggles build a new state object on a worker thread while the old one
+// keeps tracing. The swap happens at the start of a frame; the old state object
+// and its shader tables are released once the GPU has passed the last frame
+// that referenced them. The queue itself is never drained for a recompile.
+struct DXR10RecompileJob {
+    HANDLE thread;
+    DXR10Features features;
+    DXR10Pipeline result;
+    bool ok;
+    volatile LONG done;
+};
+
+struct DXR10RetiredPipeline {
+    DXR10Pipeline pipeline;
+    UINT64 fenceValue;  // Safe to release once s_fence reaches this
+};
+
+static DXR10RecompileJob s_recompileJob = {};
+static std::vector<DXR10RetiredPipeline> s_retiredPipelines;
+
+static DWORD WINAPI RecompileThread10(LPVOID) {
+    s_recompileJob.ok = BuildDXR10Pipeline(s_recompileJob.features, s_recompileJob.result);
+    InterlockedExchange(&s_recompileJob.done, 1);
+    return 0;
+}
+
+static void StartRecompile10(const DXR10Features& features) {
+    s_recompileJob.features = features;
+    s_recompileJob.result = {};
+    s_recompileJob.ok = false;
+    s_recompileJob.done = 0;
+    s_recompileJob.thread = CreateThread(nullptr, 0, RecompileThread10, nullptr, 0, nullptr);
+    if (!s_recompileJob.thread) {
+        Log("[DXR10] WARNING: Failed to start recompile thread, reverting features\n");
+        g_dxr10Features = s_compiledFeatures;
+    }
+}
+
+static void WaitForRecompile10() {
+    if (!s_recompileJob.thread) return;
+    WaitForSingleObject(s_recompileJob.thread, INFINITE);
+    CloseHandle(s_recompileJob.thread);
+    s_recompileJob.thread = nullptr;
+}
+
+static void ReleaseRetiredPipelines10(bool all) {
+    UINT64 completed = s_fence ? s_fence->GetCompletedValue() : 0;
+    for (size_t i = 0; i < s_retiredPipelines.size();) {
+        if (all || completed >= s_retiredPipelines[i].fenceValue) {
+            ReleasePipeline10(s_retiredPipelines[i].pipeline);
+            s_retiredPipelines[i] = s_retiredPipelines.back();
+            s_retiredPipelines.pop_back();
+        } else {
+            i++;
+        }
     }
 }
 
-// Text shader code
-static const char* g_textShader10 = R"(
-Texture2D fontTex : register(t0);
-SamplerState samp : register(s0);
-struct VSIn { float2 pos : POSITION; float2 uv : TEXCOORD; float4 col : COLOR; };
-struct PSIn { float4 pos : SV_POSITION; float2 uv : TEXCOORD; float4 col : COLOR; };
-PSIn TextVS(VSIn i) { PSIn o; o.pos = float4(i.pos, 0, 1); o.uv = i.uv; o.col = i.col; return o; }
-float4 TextPS(PSIn i) : SV_TARGET { return float4(i.col.rgb, i.col.a * fontTex.Sample(samp, i.uv).r); }
-)";
+// Called at the top of each frame, before anything is recorded
+static void UpdateRecompile10() {
+    if (s_recompileJob.thread && InterlockedCompareExchange(&s_recompileJob.done, 0, 0)) {
+        WaitForRecompile10();
+        if (s_recompileJob.ok) {
+            // Frames recorded so far have signaled at most s_fenceValues[s_frameIndex] - 1
+            s_retiredPipelines.push_back({ CurrentPipeline10(), s_fenceValues[s_frameIndex] - 1 });
+            InstallPipeline10(s_recompileJob.result, s_recompileJob.features);
+            s_recompileJob.result = {};
+            Log("[DXR10] Shaders recompiled, new state object swapped in\n");
+        } else {
+            Log("[DXR10] WARNING: Shader recompilation failed, reverting features\n");
+            g_dxr10Features = s_compiledFeatures;  // Revert to working features
+        }
+        s_cachedFps = -1;  // Force text rebuild to show new features
+    }
+
+    ReleaseRetiredPipelines10(false);
+
+    // Features may have changed again while a job ran; start the next one now
+    if (!s_recompileJob.thread && g_dxr10Features != s_compiledFeatures) {
+        StartRecompile10(g_dxr10Features);
+    }
+}
+
+// ============== VRAM CATEGORIES ==============
+static void VramCategories10(UINT64 bytes[VRAM_CATEGORY_COUNT]) {
+    bytes[VRAM_BLAS] += ResourceBytes12(s_blasStatic) + ResourceBytes12(s_blasCube);
+    bytes[VRAM_TLAS] += ResourceBytes12(s_tlas) + ResourceBytes12(s_instanceBuffer);
+    bytes[VRAM_SCRATCH] += ResourceBytes12(s_scratchBuffer);
+    bytes[VRAM_GBUFFER] += ResourceBytes12(s_outputUAV);
+}
 
 // ============== INITIALIZATION ==============
 bool InitD3D12DXR10(HWND hwnd) {
     Log("[DXR10] Initializing D3D12 + DXR 1.0...\n");
     HRESULT hr;
+    StartupStep("Device");
 
     // Note: g_dxr10Features is already set by ShowDxr10SettingsDialog() in main.cpp
     // Do NOT call SetDefaults() here - it would overwrite user's menu selections
@@ -973,16 +1246,18 @@ bool InitD3D12DXR10(HWND hwnd) {
     s_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&s_cmdQueue));
 
     // Swap chain with tearing support
+    StartupStep("Swap chain + frame resources");
     DXGI_SWAP_CHAIN_DESC1 swapDesc = {};
     swapDesc.Width = W; swapDesc.Height = H; swapDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
     swapDesc.SampleDesc.Count = 1; swapDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
     swapDesc.BufferCount = 3; swapDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    swapDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    swapDesc.Flags = DxgiSwapChainFlags(true);
     IDXGISwapChain1* swapChain1 = nullptr;
-    factory->CreateSwapChainForHwnd(s_cmdQueue, hwnd, &swapDesc, nullptr, nullptr, &swapChain1);
+    DxgiCreateSwapChain(factory, s_cmdQueue, hwnd, swapDesc, &swapChain1);
     factory->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
     swapChain1->QueryInterface(IID_PPV_ARGS(&s_swapChain));
     swapChain1->Release(); factory->Release(); if (adapter) adapter->Release();
+    s_swapWaitable = DxgiInitFrameLatency(s_swapChain, "DXR10");
     s_frameIndex = s_swapChain->GetCurrentBackBufferIndex();
 
     // RTV heap
@@ -1000,6 +1275,7 @@ bool InitD3D12DXR10(HWND hwnd) {
     for (UINT i = 0; i < 3; i++) s_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&s_cmdAlloc[i]));
     s_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&s_fence));
     s_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!InitFrameRing12(s_frameRing, s_device, s_fence, FRAME_RING_SIZE, "DXR10")) return false;
 
     // Command list
     ID3D12GraphicsCommandList* baseCmdList = nullptr;
@@ -1015,6 +1291,7 @@ bool InitD3D12DXR10(HWND hwnd) {
     void* mapped;
 
     // ============== GEOMETRY ==============
+    StartupStep("Geometry + upload");
     std::vector<DXR10Vert> vertsStatic, vertsCube;
     std::vector<UINT> indsStatic, indsCube;
     BuildCornellBox10(vertsStatic, indsStatic);
@@ -1023,34 +1300,40 @@ bool InitD3D12DXR10(HWND hwnd) {
     s_vertexCountCube = (UINT)vertsCube.size(); s_indexCountCube = (UINT)indsCube.size();
     Log("[DXR10] Static: %u verts, %u inds | Cube: %u verts, %u inds\n", s_vertexCountStatic, s_indexCountStatic, s_vertexCountCube, s_indexCountCube);
 
-    // Upload geometry
-    UINT vbSizeStatic = s_vertexCountStatic * sizeof(DXR10Vert), ibSizeStatic = s_indexCountStatic * sizeof(UINT);
-    UINT vbSizeCube = s_vertexCountCube * sizeof(DXR10Vert), ibSizeCube = s_indexCountCube * sizeof(UINT);
-    bufDesc.Width = vbSizeStatic; s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_vertexBufferStatic));
-    s_vertexBufferStatic->Map(0, nullptr, &mapped); memcpy(mapped, vertsStatic.data(), vbSizeStatic); s_vertexBufferStatic->Unmap(0, nullptr);
-    bufDesc.Width = ibSizeStatic; s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_indexBufferStatic));
-    s_indexBufferStatic->Map(0, nullptr, &mapped); memcpy(mapped, indsStatic.data(), ibSizeStatic); s_indexBufferStatic->Unmap(0, nullptr);
-    bufDesc.Width = vbSizeCube; s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_vertexBufferCube));
-    s_vertexBufferCube->Map(0, nullptr, &mapped); memcpy(mapped, vertsCube.data(), vbSizeCube); s_vertexBufferCube->Unmap(0, nullptr);
-    bufDesc.Width = ibSizeCube; s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_indexBufferCube));
-    s_indexBufferCube->Map(0, nullptr, &mapped); memcpy(mapped, indsCube.data(), ibSizeCube); s_indexBufferCube->Unmap(0, nullptr);
-
-    // Constant buffer
-    bufDesc.Width = 256; s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_constantBuffer));
-    s_constantBuffer->Map(0, nullptr, &s_cbMapped);
+    // Upload geometry. Hit shading only reads the tables, so the buffers are
+    // BLAS inputs alone and can take the --compact-verts layout (rt_geometry.h)
+    BuildSceneTables10(vertsStatic, indsStatic, vertsCube, indsCube);
+    RTMeshData meshStatic, meshCube;
+    RTMeshPrepare(meshStatic, vertsStatic.data(), sizeof(DXR10Vert), s_vertexCountStatic, indsStatic, "DXR10 static");
+    RTMeshPrepare(meshCube, vertsCube.data(), sizeof(DXR10Vert), s_vertexCountCube, indsCube, "DXR10 cube");
+    if (!UploadBegin12(s_device)) return false;
+    s_vertexBufferStatic = UploadBuffer12(meshStatic.vertices, meshStatic.vertexBytes, "DXR10 static VB");
+    s_indexBufferStatic = UploadBuffer12(meshStatic.indices, meshStatic.indexBytes, "DXR10 static IB");
+    s_vertexBufferCube = UploadBuffer12(meshCube.vertices, meshCube.vertexBytes, "DXR10 cube VB");
+    s_indexBufferCube = UploadBuffer12(meshCube.indices, meshCube.indexBytes, "DXR10 cube IB");
+    bool tablesOk = RTTablesUpload12(s_rtTables, "DXR10");
+    s_blueNoise = RTBlueNoiseUpload12("DXR10");
+    bool noiseOk = s_blueNoise || g_rtSampler != RT_SAMPLER_BLUENOISE;
+    if (!UploadFlush12() || !s_vertexBufferStatic || !s_indexBufferStatic || !s_vertexBufferCube || !s_indexBufferCube || !tablesOk || !noiseOk) {
+        Log("[DXR10] Geometry upload failed\n");
+        return false;
+    }
 
     // ============== BUILD ACCELERATION STRUCTURES ==============
+    StartupStep("Acceleration structures");
+    StartupGpuTimer12 asTimer;
+    StartupGpuBegin12(asTimer, s_device, s_cmdQueue, s_cmdList);
     D3D12_RESOURCE_DESC asDesc = bufDesc; asDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
     // BLAS Static
     D3D12_RAYTRACING_GEOMETRY_DESC geomDescStatic = {};
     geomDescStatic.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
     geomDescStatic.Triangles.VertexBuffer.StartAddress = s_vertexBufferStatic->GetGPUVirtualAddress();
-    geomDescStatic.Triangles.VertexBuffer.StrideInBytes = sizeof(DXR10Vert);
+    geomDescStatic.Triangles.VertexBuffer.StrideInBytes = meshStatic.vertexStride;
     geomDescStatic.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
     geomDescStatic.Triangles.VertexCount = s_vertexCountStatic;
     geomDescStatic.Triangles.IndexBuffer = s_indexBufferStatic->GetGPUVirtualAddress();
-    geomDescStatic.Triangles.IndexFormat = DXGI_FORMAT_R32_UINT;
+    geomDescStatic.Triangles.IndexFormat = meshStatic.index16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
     geomDescStatic.Triangles.IndexCount = s_indexCountStatic;
     geomDescStatic.Flags = D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
 
@@ -1058,7 +1341,7 @@ bool InitD3D12DXR10(HWND hwnd) {
     blasInputsStatic.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL;
     blasInputsStatic.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
     blasInputsStatic.NumDescs = 1; blasInputsStatic.pGeometryDescs = &geomDescStatic;
-    blasInputsStatic.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+    blasInputsStatic.Flags = BLAS_STATIC_FLAGS12;
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO blasPrebuildStatic = {};
     s_device->GetRaytracingAccelerationStructurePrebuildInfo(&blasInputsStatic, &blasPrebuildStatic);
@@ -1068,8 +1351,10 @@ bool InitD3D12DXR10(HWND hwnd) {
     // BLAS Cube
     D3D12_RAYTRACING_GEOMETRY_DESC geomDescCube = geomDescStatic;
     geomDescCube.Triangles.VertexBuffer.StartAddress = s_vertexBufferCube->GetGPUVirtualAddress();
+    geomDescCube.Triangles.VertexBuffer.StrideInBytes = meshCube.vertexStride;
     geomDescCube.Triangles.VertexCount = s_vertexCountCube;
     geomDescCube.Triangles.IndexBuffer = s_indexBufferCube->GetGPUVirtualAddress();
+    geomDescCube.Triangles.IndexFormat = meshCube.index16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
     geomDescCube.Triangles.IndexCount = s_indexCountCube;
 
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS blasInputsCube = blasInputsStatic;
@@ -1102,14 +1387,20 @@ bool InitD3D12DXR10(HWND hwnd) {
     s_cmdList->BuildRaytracingAccelerationStructure(&blasBuildCube, 0, nullptr);
     uavBarrier.UAV.pResource = s_blasCube; s_cmdList->ResourceBarrier(1, &uavBarrier);
 
+    // Compact both BLASes while nothing references them yet (see d3d12_blas.cpp)
+    ID3D12Resource** blases[] = { &s_blasStatic, &s_blasCube };
+    bool blasBuilt = CompactBLAS12(s_device, s_cmdQueue, s_cmdAlloc[0], s_cmdList, blases, 2, "DXR 1.0");
+
     // TLAS instances
     D3D12_RAYTRACING_INSTANCE_DESC instances[2] = {};
     instances[0].Transform[0][0] = instances[0].Transform[1][1] = instances[0].Transform[2][2] = 1.0f;
     instances[0].InstanceMask = 0xFF;
+    instances[0].InstanceID = s_tableBaseStatic;
     instances[0].AccelerationStructure = s_blasStatic->GetGPUVirtualAddress();
     instances[1].Transform[0][0] = instances[1].Transform[1][1] = instances[1].Transform[2][2] = 1.0f;
     instances[1].Transform[0][3] = 0.15f; instances[1].Transform[1][3] = 0.15f; instances[1].Transform[2][3] = 0.2f;
     instances[1].InstanceMask = 0xFF;
+    instances[1].InstanceID = s_tableBaseCube;
     instances[1].AccelerationStructure = s_blasCube->GetGPUVirtualAddress();
 
     bufDesc.Width = sizeof(instances); bufDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
@@ -1118,12 +1409,9 @@ bool InitD3D12DXR10(HWND hwnd) {
     memcpy(s_instanceMapped, instances, sizeof(instances));
 
     // Build TLAS
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs = {};
-    tlasInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    tlasInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    tlasInputs.NumDescs = 2;
-    tlasInputs.InstanceDescs = s_instanceBuffer->GetGPUVirtualAddress();
-    tlasInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs;
+    TlasInputs12(tlasInputs, 2, s_instanceBuffer->GetGPUVirtualAddress());
+    TlasPolicyInvalidate(s_tlasPolicy);
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO tlasPrebuild = {};
     s_device->GetRaytracingAccelerationStructurePrebuildInfo(&tlasInputs, &tlasPrebuild);
@@ -1131,6 +1419,13 @@ bool InitD3D12DXR10(HWND hwnd) {
     asDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
     s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc, D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE, nullptr, IID_PPV_ARGS(&s_tlas));
 
+    // The BLAS builds have finished: swap their scratch for one sized for the TLAS build / refit
+    if (blasBuilt) {
+        s_scratchBuffer->Release();
+        asDesc.Width = TlasScratchSize12(tlasPrebuild);
+        s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&s_scratchBuffer));
+    }
+
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC tlasBuildDesc = {};
     tlasBuildDesc.Inputs = tlasInputs;
     tlasBuildDesc.DestAccelerationStructureData = s_tlas->GetGPUVirtualAddress();
@@ -1138,16 +1433,19 @@ bool InitD3D12DXR10(HWND hwnd) {
     s_cmdList->BuildRaytracingAccelerationStructure(&tlasBuildDesc, 0, nullptr);
     uavBarrier.UAV.pResource = s_tlas; s_cmdList->ResourceBarrier(1, &uavBarrier);
 
+    StartupGpuEnd12(asTimer, s_cmdList);
     s_cmdList->Close();
     ID3D12CommandList* lists[] = { s_cmdList };
     s_cmdQueue->ExecuteCommandLists(1, lists);
     WaitForGpu10();
+    StartupGpuCollect12(asTimer, "BLAS + TLAS build");
     s_cmdAlloc[0]->Reset();
     s_cmdList->Reset(s_cmdAlloc[0], nullptr);
 
     Log("[DXR10] Acceleration structures built\n");
 
     // ============== OUTPUT UAV ==============
+    StartupStep("Descriptors + root signature");
     D3D12_RESOURCE_DESC uavDesc = {};
     uavDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
     uavDesc.Width = W; uavDesc.Height = H;
@@ -1158,9 +1456,9 @@ bool InitD3D12DXR10(HWND hwnd) {
     s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &uavDesc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_outputUAV));
 
     // ============== SRV/UAV HEAP ==============
-    // Only need UAV output and TLAS - no vertex/index buffers needed (use primitive ranges)
+    // UAV output, TLAS, the hit tables and the blue noise tile - no vertex/index buffers needed
     D3D12_DESCRIPTOR_HEAP_DESC srvUavHeapDesc = {};
-    srvUavHeapDesc.NumDescriptors = 2;  // UAV output, TLAS
+    srvUavHeapDesc.NumDescriptors = 5;  // UAV output, TLAS, primitives, materials, blue noise
     srvUavHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
     srvUavHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
     s_device->CreateDescriptorHeap(&srvUavHeapDesc, IID_PPV_ARGS(&s_srvUavHeap));
@@ -1182,21 +1480,41 @@ bool InitD3D12DXR10(HWND hwnd) {
     tlasSrvDesc.RaytracingAccelerationStructure.Location = s_tlas->GetGPUVirtualAddress();
     s_device->CreateShaderResourceView(nullptr, &tlasSrvDesc, handle);
 
+    // t1: Primitives, t2: Materials
+    handle.ptr += descSize;
+    D3D12_CPU_DESCRIPTOR_HANDLE materialsHandle = handle;
+    materialsHandle.ptr += descSize;
+    RTTablesCreateSrvs12(s_device, s_rtTables, handle, materialsHandle);
+
+    // t0 space1: blue noise (null view for the other samplers)
+    D3D12_CPU_DESCRIPTOR_HANDLE blueNoiseHandle = materialsHandle;
+    blueNoiseHandle.ptr += descSize;
+    RTBlueNoiseCreateSrv12(s_device, s_blueNoise, blueNoiseHandle);
+
     // ============== GLOBAL ROOT SIGNATURE ==============
     D3D12_DESCRIPTOR_RANGE uavRange = {}; uavRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV; uavRange.NumDescriptors = 1;
-    D3D12_DESCRIPTOR_RANGE srvRange = {}; srvRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV; srvRange.NumDescriptors = 1;  // Only TLAS
-    D3D12_ROOT_PARAMETER rootParams[3] = {};
+    D3D12_DESCRIPTOR_RANGE srvRanges[2] = {};
+    srvRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV; srvRanges[0].NumDescriptors = 3;  // TLAS, primitives, materials
+    srvRanges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV; srvRanges[1].NumDescriptors = 1;  // Blue noise
+    srvRanges[1].RegisterSpace = 1;
+    srvRanges[1].OffsetInDescriptorsFromTableStart = 3;
+    // --ray-stats counters (u0 space2) as root UAV 3, only when they exist
+    InitRayCounters12(s_device);
+    D3D12_ROOT_PARAMETER rootParams[4] = {};
     rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
     rootParams[0].DescriptorTable.NumDescriptorRanges = 1;
     rootParams[0].DescriptorTable.pDescriptorRanges = &uavRange;
     rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    rootParams[1].DescriptorTable.NumDescriptorRanges = 1;
-    rootParams[1].DescriptorTable.pDescriptorRanges = &srvRange;
+    rootParams[1].DescriptorTable.NumDescriptorRanges = 2;
+    rootParams[1].DescriptorTable.pDescriptorRanges = srvRanges;
     rootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     rootParams[2].Descriptor.ShaderRegister = 0;
+    rootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    rootParams[3].Descriptor.ShaderRegister = 0;
+    rootParams[3].Descriptor.RegisterSpace = 2;
 
     D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
-    rsDesc.NumParameters = 3; rsDesc.pParameters = rootParams;
+    rsDesc.NumParameters = RayCountersAddress12() ? 4 : 3; rsDesc.pParameters = rootParams;
     ID3DBlob* rsBlob = nullptr, *rsErr = nullptr;
     D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &rsBlob, &rsErr);
     if (rsErr) { Log("[DXR10] Root sig error: %s\n", (char*)rsErr->GetBufferPointer()); rsErr->Release(); }
@@ -1204,163 +1522,68 @@ bool InitD3D12DXR10(HWND hwnd) {
     rsBlob->Release();
 
     // ============== COMPILE RT SHADERS (with feature flags) ==============
-    // First, allocate shader table buffers (RecompileDXR10Shaders will fill them)
+    // Each pipeline owns its raygen table (see BuildDXR10Pipeline)
+    StartupStep("Pipelines");
     UINT shaderIdSize = D3D12_SHADER_IDENTIFIER_SIZE_IN_BYTES;
     s_rayGenRecordSize = (shaderIdSize + 255) & ~255;
     s_missRecordSize = (shaderIdSize + 255) & ~255;
     s_hitGroupRecordSize = (shaderIdSize + 255) & ~255;
 
-    bufDesc.Width = s_rayGenRecordSize; bufDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_rayGenTable));
-
-    bufDesc.Width = s_missRecordSize * 2;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_missTable));
-
-    bufDesc.Width = s_hitGroupRecordSize * 2;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_hitGroupTable));
-
-    // Initial compilation with current features
-    if (!RecompileDXR10Shaders(g_dxr10Features)) {
+    // Hit / miss collection, then the initial raygen variant linked to it
+    const char* serUnsupported = g_ser ? SerUnsupported10() : nullptr;
+    s_ser = g_ser && !serUnsupported;
+    if (serUnsupported) SerSetFallback(serUnsupported);
+    DXR10Pipeline initialPipeline;
+    if (!CreateHitMissCollection10()) {
         Log("[DXR10] Initial shader compilation failed\n");
         return false;
     }
-
-    // ============== TEXT RENDERING ==============
-    D3D12_STATIC_SAMPLER_DESC sampler = {};
-    sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-    sampler.AddressU = sampler.AddressV = sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    D3D12_DESCRIPTOR_RANGE texRange = {}; texRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV; texRange.NumDescriptors = 1;
-    D3D12_ROOT_PARAMETER textParam = {};
-    textParam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    textParam.DescriptorTable.NumDescriptorRanges = 1;
-    textParam.DescriptorTable.pDescriptorRanges = &texRange;
-    textParam.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    D3D12_ROOT_SIGNATURE_DESC textRsDesc = {};
-    textRsDesc.NumParameters = 1; textRsDesc.pParameters = &textParam;
-    textRsDesc.NumStaticSamplers = 1; textRsDesc.pStaticSamplers = &sampler;
-    textRsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
-
-    D3D12SerializeRootSignature(&textRsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &rsBlob, &rsErr);
-    s_device->CreateRootSignature(0, rsBlob->GetBufferPointer(), rsBlob->GetBufferSize(), IID_PPV_ARGS(&s_textRootSig));
-    rsBlob->Release();
-
-    ID3DBlob* textVs = nullptr, *textPs = nullptr;
-    D3DCompile(g_textShader10, strlen(g_textShader10), nullptr, nullptr, nullptr, "TextVS", "vs_5_0", 0, 0, &textVs, nullptr);
-    D3DCompile(g_textShader10, strlen(g_textShader10), nullptr, nullptr, nullptr, "TextPS", "ps_5_0", 0, 0, &textPs, nullptr);
-
-    D3D12_INPUT_ELEMENT_DESC textLayout[] = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-    };
-
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC textPsoDesc = {};
-    textPsoDesc.InputLayout = { textLayout, _countof(textLayout) };
-    textPsoDesc.pRootSignature = s_textRootSig;
-    textPsoDesc.VS = { textVs->GetBufferPointer(), textVs->GetBufferSize() };
-    textPsoDesc.PS = { textPs->GetBufferPointer(), textPs->GetBufferSize() };
-    textPsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    textPsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
-    textPsoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
-    textPsoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
-    textPsoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
-    textPsoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
-    textPsoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
-    textPsoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ZERO;
-    textPsoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
-    textPsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
-    textPsoDesc.SampleMask = UINT_MAX;
-    textPsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    textPsoDesc.NumRenderTargets = 1;
-    textPsoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textPsoDesc.SampleDesc.Count = 1;
-    s_device->CreateGraphicsPipelineState(&textPsoDesc, IID_PPV_ARGS(&s_textPso));
-    textVs->Release(); textPs->Release();
-
-    // Font texture
-    const int FONT_COLS = 16, FONT_ROWS = 6, TEX_W = FONT_COLS * 8, TEX_H = FONT_ROWS * 8;
-    unsigned char texData[TEX_W * TEX_H] = {};
-    for (int c = 0; c < 96; c++) {
-        int col = c % FONT_COLS, row = c / FONT_COLS;
-        for (int y = 0; y < 8; y++) {
-            unsigned char bits = g_font8x8[c][y];
-            for (int x = 0; x < 8; x++) texData[(row * 8 + y) * TEX_W + col * 8 + x] = (bits & (0x80 >> x)) ? 255 : 0;
-        }
+    bool built = BuildDXR10Pipeline(g_dxr10Features, initialPipeline);
+    if (!built && s_ser) {
+        // e.g. a dxcompiler.dll without SM 6.9: every later variant uses the plain raygen too
+        s_ser = false;
+        SerSetFallback("SM 6.9 raygen compile / link failed");
+        built = BuildDXR10Pipeline(g_dxr10Features, initialPipeline);
     }
+    if (!built) {
+        Log("[DXR10] Initial shader compilation failed\n");
+        return false;
+    }
+    if (s_ser) SerSetActive("SM 6.9 HitObject + MaybeReorderThread", true);
+    InstallPipeline10(initialPipeline, g_dxr10Features);
 
-    D3D12_RESOURCE_DESC texDesc = {}; texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    texDesc.Width = TEX_W; texDesc.Height = TEX_H; texDesc.DepthOrArraySize = 1; texDesc.MipLevels = 1;
-    texDesc.Format = DXGI_FORMAT_R8_UNORM; texDesc.SampleDesc.Count = 1;
-    s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&s_fontTexture));
-
-    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint; UINT64 uploadSize = 0;
-    s_device->GetCopyableFootprints(&texDesc, 0, 1, 0, &footprint, nullptr, nullptr, &uploadSize);
-    bufDesc.Width = uploadSize; bufDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    ID3D12Resource* uploadBuf = nullptr;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadBuf));
-    uploadBuf->Map(0, nullptr, &mapped);
-    BYTE* destRow = (BYTE*)mapped + footprint.Offset;
-    for (UINT r = 0; r < TEX_H; r++) memcpy(destRow + r * footprint.Footprint.RowPitch, texData + r * TEX_W, TEX_W);
-    uploadBuf->Unmap(0, nullptr);
-
-    s_cmdList->Reset(s_cmdAlloc[0], nullptr);
-    D3D12_TEXTURE_COPY_LOCATION srcLoc = {}, dstLoc = {};
-    srcLoc.pResource = uploadBuf; srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT; srcLoc.PlacedFootprint = footprint;
-    dstLoc.pResource = s_fontTexture; dstLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    s_cmdList->CopyTextureRegion(&dstLoc, 0, 0, 0, &srcLoc, nullptr);
-
-    D3D12_RESOURCE_BARRIER texBarrier = {}; texBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    texBarrier.Transition.pResource = s_fontTexture;
-    texBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    texBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    texBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    s_cmdList->ResourceBarrier(1, &texBarrier);
-    s_cmdList->Close();
-    s_cmdQueue->ExecuteCommandLists(1, lists);
-    WaitForGpu10();
-    uploadBuf->Release();
-
-    D3D12_DESCRIPTOR_HEAP_DESC textSrvHeapDesc = {}; textSrvHeapDesc.NumDescriptors = 1;
-    textSrvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV; textSrvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    s_device->CreateDescriptorHeap(&textSrvHeapDesc, IID_PPV_ARGS(&s_textSrvHeap));
-    D3D12_SHADER_RESOURCE_VIEW_DESC texSrvDesc = {}; texSrvDesc.Format = DXGI_FORMAT_R8_UNORM;
-    texSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    texSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    texSrvDesc.Texture2D.MipLevels = 1;
-    s_device->CreateShaderResourceView(s_fontTexture, &texSrvDesc, s_textSrvHeap->GetCPUDescriptorHandleForHeapStart());
-
-    bufDesc.Width = 6000 * sizeof(TextVert);
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_textVB));
-    s_textVB->Map(0, nullptr, &s_textVBMapped);
-    s_textVBView.BufferLocation = s_textVB->GetGPUVirtualAddress();
-    s_textVBView.SizeInBytes = 6000 * sizeof(TextVert);
-    s_textVBView.StrideInBytes = sizeof(TextVert);
+    // ============== TEXT OVERLAY ==============
+    StartupStep("Overlay + timers");
+    if (!Overlay12Init(s_overlay, s_device, DXGI_FORMAT_R8G8B8A8_UNORM, "DXR10")) {
+        Log("[DXR10] Text overlay initialization failed, continuing without text\n");
+    }
 
     s_cmdAlloc[0]->Reset();
     s_cmdList->Reset(s_cmdAlloc[0], nullptr);
     s_cmdList->Close();
 
+    // GPU pass timings (optional - the overlay just omits them on failure)
+    InitGpuTimer12(s_device, s_cmdQueue);
+
+    VramSetCategories(VramCategories10);
     Log("[DXR10] Initialization complete\n");
     return true;
 }
 
 // ============== RENDER ==============
 void RenderD3D12DXR10() {
-    // Check if features changed and recompile if needed
-    if (g_dxr10Features != s_compiledFeatures) {
-        WaitForGpu10();  // Wait for GPU before recompiling
-        if (!RecompileDXR10Shaders(g_dxr10Features)) {
-            Log("[DXR10] WARNING: Shader recompilation failed, reverting features\n");
-            g_dxr10Features = s_compiledFeatures;  // Revert to working features
-        }
-        s_cachedFps = -1;  // Force text rebuild to show new features
-    }
+    DxgiWaitFrameLatency(s_swapWaitable);
+
+    // Pick up a finished async recompile, or start one if features changed
+    UpdateRecompile10();
+
+    // Timestamps / ray counts from the last use of this frame slot are complete by now
+    GpuTimerCollect12(s_frameIndex);
+    RayCountersCollect12(s_frameIndex);
 
     s_cmdAlloc[s_frameIndex]->Reset();
     s_cmdList->Reset(s_cmdAlloc[s_frameIndex], nullptr);
+    GpuTimerBegin12(s_cmdList, s_frameIndex);
 
     // Time
     static LARGE_INTEGER startTime = {}, perfFreq = {};
@@ -1379,11 +1602,13 @@ void RenderD3D12DXR10() {
     cb.shadowSamples = g_dxr10Features.shadowSamples;
     cb.aoSamples = g_dxr10Features.aoSamples;
     cb.aoRadius = g_dxr10Features.aoRadius;
-    memcpy(s_cbMapped, &cb, sizeof(cb));
+    D3D12_GPU_VIRTUAL_ADDRESS cbGpu = FrameRingPush12(s_frameRing, &cb, sizeof(cb), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
     // Update cube transform and rebuild TLAS
     UpdateCubeTransform10(time);
     RebuildTLAS10();
+    GpuTimerStamp12(s_cmdList, s_frameIndex, "TLAS");
+    RayCountersBegin12(s_cmdList);
 
     // Set pipeline state and root signature
     s_cmdList->SetComputeRootSignature(s_globalRootSig);
@@ -1395,7 +1620,8 @@ void RenderD3D12DXR10() {
     s_cmdList->SetComputeRootDescriptorTable(0, gpuHandle);  // UAV
     gpuHandle.ptr += descSize;
     s_cmdList->SetComputeRootDescriptorTable(1, gpuHandle);  // SRVs
-    s_cmdList->SetComputeRootConstantBufferView(2, s_constantBuffer->GetGPUVirtualAddress());
+    s_cmdList->SetComputeRootConstantBufferView(2, cbGpu);
+    if (RayCountersAddress12()) s_cmdList->SetComputeRootUnorderedAccessView(3, RayCountersAddress12());
 
     // Dispatch rays
     D3D12_DISPATCH_RAYS_DESC dispatchDesc = {};
@@ -1413,6 +1639,8 @@ void RenderD3D12DXR10() {
 
     s_cmdList->SetPipelineState1(s_rtPSO);
     s_cmdList->DispatchRays(&dispatchDesc);
+    GpuTimerStamp12(s_cmdList, s_frameIndex, "Trace");
+    RayCountersEnd12(s_cmdList, s_frameIndex);
 
     // Copy output to backbuffer
     D3D12_RESOURCE_BARRIER barriers[2] = {};
@@ -1429,6 +1657,7 @@ void RenderD3D12DXR10() {
     s_cmdList->ResourceBarrier(2, barriers);
 
     s_cmdList->CopyResource(s_renderTargets[s_frameIndex], s_outputUAV);
+    GpuTimerStamp12(s_cmdList, s_frameIndex, "Copy");
 
     // Transition for text rendering
     barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
@@ -1440,83 +1669,144 @@ void RenderD3D12DXR10() {
     // Text rendering
     if (fps != s_cachedFps) {
         s_cachedFps = fps;
-        s_textVertCount = 0;
         char gpuNameA[128] = {}; size_t converted = 0;
         wcstombs_s(&converted, gpuNameA, 128, s_gpuName.c_str(), 127);
-        char buf[256]; float y = 10.0f;
-        sprintf_s(buf, "API: Direct3D 12 + DXR 1.0 (TraceRay)");
-        DrawText10(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawText10(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, "GPU: %s", gpuNameA);
-        DrawText10(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawText10(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, "FPS: %d", fps);
-        DrawText10(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawText10(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, "Triangles: %u", (s_indexCountStatic + s_indexCountCube) / 3);
-        DrawText10(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawText10(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, "Resolution: %dx%d", W, H);
-        DrawText10(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawText10(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-
-        // Show active features
-        y += 5;  // Small gap
-        sprintf_s(buf, "Features: %s%s%s%s%s%s",
+        char infoText[1024];
+        int len = sprintf_s(infoText,
+            "API: Direct3D 12 + DXR 1.0 (TraceRay)\n"
+            "GPU: %s\n"
+            "FPS: %d\n"
+            "Triangles: %u\n"
+            "Resolution: %dx%d\n"
+            "Features: " OVERLAY_TEXT_GREEN "%s%s%s%s%s%s",
+            gpuNameA, fps, (s_indexCountStatic + s_indexCountCube) / 3, W, H,
             g_dxr10Features.spotlight ? "Spot " : "",
             g_dxr10Features.softShadows ? "Shadow " : "",
             g_dxr10Features.ambientOcclusion ? "AO " : "",
             g_dxr10Features.globalIllum ? "GI " : "",
             g_dxr10Features.reflections ? "Refl " : "",
             g_dxr10Features.glassRefraction ? "Glass" : "");
-        DrawText10(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawText10(buf, 10, y, 0.7f, 1.0f, 0.7f, 1, 1.5f);
+        if (g_ser && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", SerOverlayText());
+
+        char buf[256];
+        RayStatsFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+        GpuProfilerFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+        LatencyFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+        VramFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+
+        OverlaySetText(s_overlay.text, infoText);
     }
 
-    if (s_textVertCount > 0) {
-        memcpy(s_textVBMapped, s_textVerts, s_textVertCount * sizeof(TextVert));
-        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = s_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-        rtvHandle.ptr += s_frameIndex * s_rtvDescSize;
-        s_cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-        D3D12_VIEWPORT vp = { 0, 0, (float)W, (float)H, 0, 1 };
-        D3D12_RECT scissor = { 0, 0, (LONG)W, (LONG)H };
-        s_cmdList->RSSetViewports(1, &vp);
-        s_cmdList->RSSetScissorRects(1, &scissor);
-        s_cmdList->SetGraphicsRootSignature(s_textRootSig);
-        ID3D12DescriptorHeap* textHeaps[] = { s_textSrvHeap };
-        s_cmdList->SetDescriptorHeaps(1, textHeaps);
-        s_cmdList->SetGraphicsRootDescriptorTable(0, s_textSrvHeap->GetGPUDescriptorHandleForHeapStart());
-        s_cmdList->SetPipelineState(s_textPso);
-        s_cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        s_cmdList->IASetVertexBuffers(0, 1, &s_textVBView);
-        s_cmdList->DrawInstanced(s_textVertCount, 1, 0, 0);
-    }
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = s_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+    rtvHandle.ptr += s_frameIndex * s_rtvDescSize;
+    s_cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    Overlay12Draw(s_overlay, s_cmdList, s_frameIndex, W, H);
+    GpuTimerStamp12(s_cmdList, s_frameIndex, "Text");
 
     // Present
     barriers[0].Transition.pResource = s_renderTargets[s_frameIndex];
     barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
     barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
     s_cmdList->ResourceBarrier(1, barriers);
+    GpuTimerEnd12(s_cmdList, s_frameIndex);
 
     s_cmdList->Close();
     ID3D12CommandList* lists[] = { s_cmdList };
     s_cmdQueue->ExecuteCommandLists(1, lists);
-    s_swapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
+    DxgiPresent(s_swapChain, true);
     MoveToNextFrame10();
 }
 
+// ============== RESIZE ==============
+bool ResizeD3D12DXR10() {
+    if (!s_swapChain || !s_device) return false;
+    WaitForGpu10();
+
+    for (UINT i = 0; i < 3; i++) if (s_renderTargets[i]) { s_renderTargets[i]->Release(); s_renderTargets[i] = nullptr; }
+    if (s_outputUAV) { s_outputUAV->Release(); s_outputUAV = nullptr; }
+
+    HRESULT hr = s_swapChain->ResizeBuffers(3, W, H, DXGI_FORMAT_UNKNOWN, DxgiSwapChainFlags(true));
+    if (FAILED(hr)) { LogHR("ResizeBuffers", hr); return false; }
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = s_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+    for (UINT i = 0; i < 3; i++) {
+        s_swapChain->GetBuffer(i, IID_PPV_ARGS(&s_renderTargets[i]));
+        s_device->CreateRenderTargetView(s_renderTargets[i], nullptr, rtvHandle);
+        rtvHandle.ptr += s_rtvDescSize;
+    }
+
+    // Output UAV (copied to the back buffer every frame, so sizes must match)
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC uavDesc = {};
+    uavDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    uavDesc.Width = W; uavDesc.Height = H;
+    uavDesc.DepthOrArraySize = 1; uavDesc.MipLevels = 1;
+    uavDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    uavDesc.SampleDesc.Count = 1;
+    uavDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    hr = s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &uavDesc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_outputUAV));
+    if (FAILED(hr)) { LogHR("CreateOutputUAV", hr); return false; }
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uavViewDesc = {};
+    uavViewDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    uavViewDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    s_device->CreateUnorderedAccessView(s_outputUAV, nullptr, &uavViewDesc, s_srvUavHeap->GetCPUDescriptorHandleForHeapStart());
+
+    // All slots idle after the wait; restart from the new back buffer index
+    UINT64 next = s_fenceValues[s_frameIndex];
+    s_frameIndex = s_swapChain->GetCurrentBackBufferIndex();
+    for (UINT i = 0; i < 3; i++) s_fenceValues[i] = next;
+    s_cachedFps = -1;  // Rebuild overlay for the new size
+
+    Log("[DXR10] Resized to %ux%u\n", W, H);
+    return true;
+}
+
 // ============== CLEANUP ==============
 void CleanupD3D12DXR10() {
+    VramSetCategories(nullptr);
+    WaitForRecompile10();
+    ReleasePipeline10(s_recompileJob.result);
     WaitForGpu10();
+    ReleaseRetiredPipelines10(true);
+    CleanupGpuTimer12();
+    CleanupRayCounters12();
     #define SAFE_RELEASE(x) if(x) { x->Release(); x = nullptr; }
     SAFE_RELEASE(s_rayGenTable); SAFE_RELEASE(s_missTable); SAFE_RELEASE(s_hitGroupTable);
-    SAFE_RELEASE(s_rtPSOProps); SAFE_RELEASE(s_rtPSO); SAFE_RELEASE(s_globalRootSig);
+    SAFE_RELEASE(s_rtPSOProps); SAFE_RELEASE(s_rtPSO);
+    ReleaseCollections10();
+    s_ser = false;
+    SAFE_RELEASE(s_globalRootSig);
     SAFE_RELEASE(s_outputUAV); SAFE_RELEASE(s_srvUavHeap);
     SAFE_RELEASE(s_blasStatic); SAFE_RELEASE(s_blasCube); SAFE_RELEASE(s_tlas);
     SAFE_RELEASE(s_scratchBuffer); SAFE_RELEASE(s_instanceBuffer);
     SAFE_RELEASE(s_vertexBufferStatic); SAFE_RELEASE(s_indexBufferStatic);
     SAFE_RELEASE(s_vertexBufferCube); SAFE_RELEASE(s_indexBufferCube);
-    SAFE_RELEASE(s_constantBuffer);
-    SAFE_RELEASE(s_textRootSig); SAFE_RELEASE(s_textPso); SAFE_RELEASE(s_textSrvHeap);
-    SAFE_RELEASE(s_fontTexture); SAFE_RELEASE(s_textVB);
+    RTTablesRelease12(s_rtTables);
+    SAFE_RELEASE(s_blueNoise);
+    CleanupFrameRing12(s_frameRing);
+    Overlay12Cleanup(s_overlay);
     SAFE_RELEASE(s_fence); if (s_fenceEvent) { CloseHandle(s_fenceEvent); s_fenceEvent = nullptr; }
     for (UINT i = 0; i < 3; i++) { SAFE_RELEASE(s_cmdAlloc[i]); SAFE_RELEASE(s_renderTargets[i]); }
+    if (s_swapWaitable) { CloseHandle(s_swapWaitable); s_swapWaitable = nullptr; }
     SAFE_RELEASE(s_cmdList); SAFE_RELEASE(s_rtvHeap); SAFE_RELEASE(s_swapChain);
     SAFE_RELEASE(s_cmdQueue); SAFE_RELEASE(s_device);
     #undef SAFE_RELEASE
+
+    // Reset frame state so a re-init in the same process (F5, fallback, sweep) starts clean
+    s_frameIndex = 0;
+    memset(s_fenceValues, 0, sizeof(s_fenceValues));
+    s_cachedFps = -1;
+    s_instanceMapped = nullptr;
+    s_compiledFeatures = {};
+    TlasPolicyInvalidate(s_tlasPolicy);
+    s_recompileJob = {};
+    s_retiredPipelines.clear();
+    s_rayGenRecordSize = s_missRecordSize = s_hitGroupRecordSize = 0;
+    s_tableBaseStatic = s_tableBaseCube = 0;
+    s_vertexCountStatic = s_indexCountStatic = 0;
+    s_vertexCountCube = s_indexCountCube = 0;
     Log("[DXR10] Cleanup complete\n");
 }
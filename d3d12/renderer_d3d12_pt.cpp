@@ -6,6 +6,24 @@
 #include "renderer_d3d12.h"
 #include "../shaders/d3d12_pt_shaders.h"
 #include "../shaders/d3d12_denoise_shaders.h"
+#include "../shaders/d3d12_upscale_shaders.h"
+#include "../shaders/d3d12_pt_wavefront_shaders.h"
+#include "../shaders/rt_sampling_shaders.h"
+#include "../shaders/ray_stats_shaders.h"
+#include "../shaders/group_shape_shaders.h"
+#include "../gpu_profiler.h"
+#include "../accumulation.h"
+#include "../tlas_policy.h"
+#include "../rt_geometry.h"
+#include "../rt_sampling.h"
+#include "../ray_stats.h"
+#include "../pt_lights.h"
+#include "../mesh_file.h"
+#include "../benchmark.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "../offscreen.h"
+#include "../group_tune.h"
 
 #include <d3d12.h>
 #include <dxgi1_6.h>
@@ -13,6 +31,7 @@
 #include <DirectXMath.h>
 #include <dxcapi.h>
 #include <vector>
+#include <string>
 
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -28,6 +47,14 @@ struct PathTraceCBData {
     UINT FrameCount;
     UINT Width;
     UINT Height;
+    UINT AccumFrame;    // --accumulate sample index, 0 = off (accumulation.h)
+    UINT SamplesPerPixel;   // --spp
+    UINT MaxBounces;        // --bounces
+    UINT AdaptiveMaxSpp;    // --adaptive-max-spp, 0 = adaptive off
+    float AdaptiveTarget;   // --adaptive
+    UINT LightCount;        // --lights + the spotlight
+    UINT LightSampling;     // --light-sampling (PtLightSampling)
+    UINT RowOffset;         // --split-gpu: first row of the dispatch
 };
 
 struct DenoiseCBData {
@@ -35,11 +62,15 @@ struct DenoiseCBData {
     UINT Height;
     UINT StepSize;
     float ColorSigma;
+    float TemporalAlpha;
 };
 
-struct CB {
-    float time;
-    float _pad[3];
+struct UpscaleCBData {
+    UINT InputWidth;
+    UINT InputHeight;
+    UINT OutputWidth;
+    UINT OutputHeight;
+    float Sharpness;
 };
 
 // ============== LOCAL VERTEX STRUCTURE ==============
@@ -59,7 +90,6 @@ static_assert(sizeof(PTVert) == 32, "PTVert struct must be exactly 32 bytes!");
 extern void WaitForGpu();
 extern void MoveToNextFrame();
 extern bool CheckDXRSupport(IDXGIAdapter1* adapter);
-extern void DrawTextDirect(const char* text, float x, float y, float r, float g, float b, float a, float scale);
 
 // Material types for Cornell Box scene (same as RT renderer)
 enum MaterialType { MAT_DIFFUSE = 0, MAT_MIRROR = 1, MAT_GLASS = 2, MAT_EMISSIVE = 3 };
@@ -76,11 +106,131 @@ static ID3D12Resource* s_ibCube = nullptr;
 static ID3D12Resource* s_blasStatic = nullptr;
 static ID3D12Resource* s_blasCube = nullptr;
 static ID3D12Resource* s_tlasBuffer = nullptr;
+static TlasPolicy s_tlasPolicy;   // Refit vs rebuild, see tlas_policy.h
 static ID3D12Resource* s_scratchBuffer = nullptr;
 static ID3D12Resource* s_instanceBuffer = nullptr;
 static void* s_instanceMapped = nullptr;
 static UINT s_vertCountStatic = 0, s_indCountStatic = 0;
 static UINT s_vertCountCube = 0, s_indCountCube = 0;
+// --mesh (mesh_file.h): the file's mesh is the BLAS of the cube instance,
+// uploaded straight from the mapping. Not for DLSS, which decodes cube hits
+// from primitive ranges.
+static bool s_meshCube = false;
+// --zero-copy: back buffers were created with DXGI_USAGE_UNORDERED_ACCESS and
+// the trace writes them directly (UAVs in heap slots 8+i), no CopyResource
+static bool s_zeroCopy = false;
+// --accumulate: FP32 running sum (u1, heap slot PT_ACCUM_SLOT). Without it the
+// slot holds a null UAV so the root signature stays the same.
+#define PT_ACCUM_SLOT (8 + FRAME_COUNT)
+static ID3D12Resource* s_accumSum = nullptr;
+
+// --adaptive: paths traced, one wrapping uint (u2, slot PT_COUNTER_SLOT) that
+// the kernel adds to per tile. Copied to s_sampleReadback[frameIndex] after
+// the dispatch and read when the slot comes round again; the difference to the
+// previous frame's value is that frame's sample count.
+#define PT_COUNTER_SLOT (PT_ACCUM_SLOT + 1)
+static ID3D12Resource* s_sampleCounter = nullptr;
+static ID3D12Resource* s_sampleReadback = nullptr;
+static UINT* s_sampleReadbackMapped = nullptr;
+static bool s_sampleReadbackPending[FRAME_COUNT] = {};
+static UINT s_lastSampleCount = 0;
+static double s_adaptiveSamples = 0.0;   // Paths per pixel summed over the read back frames
+static UINT s_adaptiveFrames = 0;
+static float s_frameAvgSpp = 0.0f;        // Latest read back frame
+
+// ============== DENOISE ==============
+// DENOISE_ATROUS: PT_DENOISE_ITERATIONS DenoiseCS passes with step 1/2/4/8,
+// ping-ponging between pathTraceOutput (slots 3/4) and denoiseTemp (5/6).
+// DENOISE_TEMPORAL: TemporalCS first (EMA into s_denoiseHistory, u1 at
+// PT_HISTORY_SLOT), then the same chain. The edge-stopping sigma halves every
+// iteration as the taps spread further apart.
+#define PT_HISTORY_SLOT (PT_COUNTER_SLOT + 1)
+#define PT_DENOISE_ITERATIONS 4
+#define PT_DENOISE_COLOR_SIGMA 0.25f
+#define PT_TEMPORAL_MIN_ALPHA 0.1f    // History weight settles at 90%
+static ID3D12Resource* s_denoiseHistory = nullptr;
+static ID3D12PipelineState* s_temporalPSO = nullptr;
+
+// ============== GROUP SHAPES ==============
+// --group-size (group_tune.h) variants of PathTraceCS and of the denoise chain
+// (DenoiseCS and TemporalCS share one variant); [GROUP_VARIANT_DEFAULT] is
+// pathTracePSO / denoisePSO / s_temporalPSO. Only the PT renderer's own
+// megakernel is tuned: --wavefront, --split-gpu and the DLSS fallback stay 8x8.
+static ID3D12PipelineState* s_traceVariants[GROUP_VARIANT_COUNT] = {};
+static ID3D12PipelineState* s_denoiseVariants[GROUP_VARIANT_COUNT] = {};
+static ID3D12PipelineState* s_temporalVariants[GROUP_VARIANT_COUNT] = {};
+
+// ============== RENDER SCALE ==============
+// --render-scale: trace, accumulation and denoising run at s_traceW x s_traceH.
+// UpscaleCS writes s_upscaleTemp (PT_UPSCALE_SLOT UAV, +1 SRV) at window size,
+// SharpenCS writes s_upscaleOutput (+2) or, zero-copy, the back buffer.
+// Both use the denoise root signature.
+#define PT_UPSCALE_SLOT (PT_HISTORY_SLOT + 1)
+#define PT_SHARPNESS 0.5f
+static UINT s_traceW = 0, s_traceH = 0;
+static bool s_upscale = false;
+static ID3D12Resource* s_upscaleTemp = nullptr;
+static ID3D12Resource* s_upscaleOutput = nullptr;
+static ID3D12PipelineState* s_upscalePSO = nullptr;
+static ID3D12PipelineState* s_sharpenPSO = nullptr;
+
+// ============== SCENE TABLES ==============
+// Primitive (t3) and material (t4) tables of GetHitSurface, SRVs at
+// PT_SCENE_TABLE_SLOT and +1. The scene root table reaches them with a second
+// range, so t0-t2 keep heap slots 0-2 (the DLSS renderer binds those too).
+// Materials 0-10 are the objects by OBJ_*, 11-18 the eight rotating cubes.
+#define PT_SCENE_TABLE_SLOT (PT_UPSCALE_SLOT + 3)
+// --sampler=bluenoise tile (t0 space1, null SRV for the other samplers)
+#define PT_BLUE_NOISE_SLOT (PT_SCENE_TABLE_SLOT + 2)
+// --light-sampling=restir reservoirs (u0 space3, null UAV otherwise) and the
+// --lights table (t0 space3, always: entry 0 is the spotlight)
+#define PT_RESERVOIR_SLOT (PT_BLUE_NOISE_SLOT + 1)
+#define PT_LIGHT_SLOT (PT_RESERVOIR_SLOT + 1)
+#define PT_SRV_UAV_DESCRIPTORS (PT_LIGHT_SLOT + 1)
+#define PT_RESERVOIR_BYTES 24   // struct Reservoir
+#define PT_CUBE_MATERIAL_BASE 11
+static RTTables12 s_rtTables;
+static UINT s_tableBaseStatic = 0, s_tableBaseCube = 0;   // TLAS InstanceIDs
+
+// ============== MANY LIGHTS ==============
+// --lights emitters (pt_lights.h): s_lights[0] is the spotlight, each extra
+// one also gets an emissive quad in the static BLAS. The ReSTIR reservoirs
+// are two frames of trace pixels, recreated with the trace targets.
+static std::vector<PtLight> s_lights;
+static ID3D12Resource* s_lightBuffer = nullptr;
+static ID3D12Resource* s_reservoirs = nullptr;
+
+// ============== WAVEFRONT ==============
+// --wavefront: the kernels of d3d12_pt_wavefront_shaders.h instead of
+// PathTraceCS. Same heap slots as the megakernel for t0-t4, u0 and u1; path
+// state, queues, counters and indirect args are root UAVs (u3-u8), sized for
+// one path per trace pixel and recreated with the trace targets.
+enum {
+    WF_RP_CB = 0,       // b0 PathTraceCB
+    WF_RP_CONSTANTS,    // b1 Bounce, Sample, Stage
+    WF_RP_SCENE,        // t0-t4
+    WF_RP_OUTPUT,       // u0
+    WF_RP_ACCUM,        // u1
+    WF_RP_PATHS,        // u3
+    WF_RP_HITS,         // u4
+    WF_RP_QUEUES,       // u5
+    WF_RP_SHADOW_RAYS,  // u6
+    WF_RP_COUNTERS,     // u7
+    WF_RP_ARGS,         // u8
+    WF_RP_COUNT
+};
+#define WF_BUFFER_COUNT (WF_RP_COUNT - WF_RP_PATHS)
+// Element sizes of PathState, PathHit and ShadowRay
+#define WF_PATH_STATE_BYTES 64
+#define WF_PATH_HIT_BYTES 32
+#define WF_SHADOW_RAY_BYTES 48
+static ID3D12RootSignature* s_wfRootSig = nullptr;
+static ID3D12PipelineState* s_wfGeneratePSO = nullptr;
+static ID3D12PipelineState* s_wfPreparePSO = nullptr;
+static ID3D12PipelineState* s_wfResolvePSO = nullptr;
+static ID3D12PipelineState* s_wfIndirectPSO[WF_ARG_COUNT] = {};   // Indexed by WF_ARG_*
+static ID3D12CommandSignature* s_wfDispatchSig = nullptr;
+static ID3D12Resource* s_wfBuffers[WF_BUFFER_COUNT] = {};         // Indexed by WF_RP_* - WF_RP_PATHS
 
 // Add a quad (two triangles)
 static void AddQuad(std::vector<PTVert>& verts, std::vector<UINT>& inds,
@@ -111,7 +261,8 @@ static void AddBox(std::vector<PTVert>& verts, std::vector<UINT>& inds,
     AddQuad(verts, inds, {cx-hx, cy-hy, cz-hz}, {cx+hx, cy-hy, cz-hz}, {cx+hx, cy-hy, cz+hz}, {cx-hx, cy-hy, cz+hz}, {0, -1, 0}, objID, matType);
 }
 
-// Build static geometry (room, mirror, light) - same as RT renderer
+// Build static geometry (room, mirror, light) - same as RT renderer, plus the
+// --lights emitters of s_lights
 static void BuildStaticGeometry(std::vector<PTVert>& verts, std::vector<UINT>& inds)
 {
     verts.clear(); inds.clear();
@@ -156,6 +307,13 @@ static void BuildStaticGeometry(std::vector<PTVert>& verts, std::vector<UINT>& i
     AddQuad(verts, inds, {glassX, -s, glassZ - gw}, {glassX, -s, glassZ + gw}, {glassX, -s + gh * 2, glassZ + gw}, {glassX, -s + gh * 2, glassZ - gw}, {-1, 0, 0}, OBJ_GLASS, MAT_GLASS);
     AddQuad(verts, inds, {glassX, -s, glassZ + gw}, {glassX, -s, glassZ - gw}, {glassX, -s + gh * 2, glassZ - gw}, {glassX, -s + gh * 2, glassZ + gw}, {1, 0, 0}, OBJ_GLASS, MAT_GLASS);
 
+    // --lights: one downward quad per emitter, just above its sampled disk
+    for (size_t i = 1; i < s_lights.size(); i++) {
+        const PtLight& l = s_lights[i];
+        float x = l.pos[0], z = l.pos[2], r = l.radius, y = s - 0.01f;
+        AddQuad(verts, inds, {x - r, y, z - r}, {x + r, y, z - r}, {x + r, y, z + r}, {x - r, y, z + r}, {0, -1, 0}, OBJ_LIGHT, MAT_EMISSIVE);
+    }
+
     // No front wall - camera is inside the room looking at the scene
 }
 
@@ -181,6 +339,51 @@ static void BuildDynamicCubes(std::vector<PTVert>& verts, std::vector<UINT>& ind
     }
 }
 
+// Triangle -> material: static objects by OBJ_*, the cubes by the index kept in materialType
+static UINT MaterialOfPT(UINT objectID, UINT materialType)
+{
+    return objectID == OBJ_CUBE ? PT_CUBE_MATERIAL_BASE + materialType : objectID;
+}
+
+static void BuildSceneTablesPT(const std::vector<PTVert>& vertsStatic, const std::vector<UINT>& indsStatic,
+                               const std::vector<PTVert>& vertsCube, const std::vector<UINT>& indsCube)
+{
+    // Cornell Box colors by OBJ_* (the light's albedo is unused, it is emissive)
+    static const float objectColors[PT_CUBE_MATERIAL_BASE][3] = {
+        {0.7f, 0.7f, 0.7f},     // Floor - grey
+        {0.9f, 0.9f, 0.9f},     // Ceiling - white
+        {0.7f, 0.7f, 0.7f},     // Back wall - grey
+        {0.75f, 0.15f, 0.15f},  // Left wall - RED
+        {0.15f, 0.75f, 0.15f},  // Right wall - GREEN
+        {15.0f, 14.0f, 12.0f},  // Light
+        {0.9f, 0.6f, 0.2f},     // Cube - orange (fallback)
+        {0.95f, 0.95f, 0.95f},  // Mirror - neutral
+        {0.9f, 0.95f, 1.0f},    // Glass - slight blue tint
+        {0.9f, 0.15f, 0.1f},    // Small cube behind glass - RED
+        {0.5f, 0.15f, 0.7f}     // Front wall - PURPLE
+    };
+    // Rotating cube colors (same as the D3D12 base renderer)
+    static const float cubeColors[8][3] = {
+        {0.95f, 0.2f, 0.15f}, {0.2f, 0.7f, 0.3f}, {0.15f, 0.5f, 0.95f}, {1.0f, 0.85f, 0.0f},
+        {1.0f, 0.85f, 0.0f}, {0.15f, 0.5f, 0.95f}, {0.2f, 0.7f, 0.3f}, {0.95f, 0.2f, 0.15f}
+    };
+
+    RTTablesRelease12(s_rtTables);
+    for (UINT i = 0; i < PT_CUBE_MATERIAL_BASE; i++) {
+        UINT type = i == OBJ_LIGHT ? MAT_EMISSIVE : i == OBJ_MIRROR ? MAT_MIRROR : i == OBJ_GLASS ? MAT_GLASS : MAT_DIFFUSE;
+        RTTablesAddMaterial12(s_rtTables, objectColors[i][0], objectColors[i][1], objectColors[i][2], type, i);
+    }
+    for (UINT i = 0; i < 8; i++)
+        RTTablesAddMaterial12(s_rtTables, cubeColors[i][0], cubeColors[i][1], cubeColors[i][2], MAT_DIFFUSE, OBJ_CUBE);
+
+    s_tableBaseStatic = RTTablesAddTriangles12(s_rtTables, vertsStatic.data(), sizeof(PTVert),
+                                               indsStatic.data(), (UINT)indsStatic.size(), MaterialOfPT);
+    // --mesh: its faces follow the static ones at upload (RTTablesUpload12), as the orange fallback cube
+    if (s_meshCube) s_tableBaseCube = (UINT)s_rtTables.primitives.size();
+    else s_tableBaseCube = RTTablesAddTriangles12(s_rtTables, vertsCube.data(), sizeof(PTVert),
+                                                  indsCube.data(), (UINT)indsCube.size(), MaterialOfPT);
+}
+
 // Update cube instance transform (called each frame)
 // Not static - accessible from DLSS renderer
 void UpdateCubeTransformPT(float time)
@@ -207,31 +410,963 @@ void UpdateCubeTransformPT(float time)
     instances[1].Transform[2][0] = m02; instances[1].Transform[2][1] = m12; instances[1].Transform[2][2] = m22; instances[1].Transform[2][3] = tz;
 }
 
-// Rebuild TLAS after transform update (called from DLSS renderer)
+// Refit or rebuild the TLAS after the transform update (also called from the DLSS renderer)
 void RebuildTLAS_PT(ID3D12GraphicsCommandList4* cmdListRT)
 {
     if (!s_tlasBuffer || !s_instanceBuffer || !s_scratchBuffer) return;
+    TlasUpdate12(cmdListRT, g_frameRing12, s_tlasPolicy, s_tlasBuffer, s_scratchBuffer,
+                 (const D3D12_RAYTRACING_INSTANCE_DESC*)s_instanceMapped, 2, s_instanceBuffer->GetGPUVirtualAddress());
+}
 
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs = {};
-    tlasInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    tlasInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    tlasInputs.NumDescs = 2;
-    tlasInputs.InstanceDescs = s_instanceBuffer->GetGPUVirtualAddress();
-    tlasInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD |
-                       D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE |
-                       D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+// ============== WAVEFRONT SETUP ==============
+static void ReleaseWavefrontBuffers()
+{
+    for (UINT i = 0; i < WF_BUFFER_COUNT; i++) {
+        if (s_wfBuffers[i]) { s_wfBuffers[i]->Release(); s_wfBuffers[i] = nullptr; }
+    }
+}
 
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC tlasBuildDesc = {};
-    tlasBuildDesc.Inputs = tlasInputs;
-    tlasBuildDesc.DestAccelerationStructureData = s_tlasBuffer->GetGPUVirtualAddress();
-    tlasBuildDesc.SourceAccelerationStructureData = s_tlasBuffer->GetGPUVirtualAddress();
-    tlasBuildDesc.ScratchAccelerationStructureData = s_scratchBuffer->GetGPUVirtualAddress();
-    cmdListRT->BuildRaytracingAccelerationStructure(&tlasBuildDesc, 0, nullptr);
+// Created in COMMON: buffers decay back to it after every ExecuteCommandLists
+static bool CreateWavefrontBuffers()
+{
+    UINT64 paths = (UINT64)s_traceW * s_traceH;
+    const UINT64 sizes[WF_BUFFER_COUNT] = {
+        paths * WF_PATH_STATE_BYTES,
+        paths * WF_PATH_HIT_BYTES,
+        paths * WF_QUEUE_COUNT * sizeof(UINT),
+        paths * WF_SHADOW_RAY_BYTES,
+        WF_QUEUE_COUNT * sizeof(UINT),
+        WF_ARG_COUNT * sizeof(D3D12_DISPATCH_ARGUMENTS)
+    };
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Height = 1; desc.DepthOrArraySize = 1; desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1; desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    UINT64 total = 0;
+    for (UINT i = 0; i < WF_BUFFER_COUNT; i++) {
+        desc.Width = sizes[i];
+        HRESULT hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &desc,
+            D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&s_wfBuffers[i]));
+        if (FAILED(hr)) { LogHR("CreateWavefrontBuffer", hr); return false; }
+        total += sizes[i];
+    }
+    Log("[INFO] Wavefront: %llu paths, %.1f MB path state + queues\n", paths, total / (1024.0 * 1024.0));
+    return true;
+}
+
+static bool InitWavefront()
+{
+    // ===== ROOT SIGNATURE =====
+    D3D12_DESCRIPTOR_RANGE ranges[5] = {};
+    ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;   // t0-t2, heap slots 0-2
+    ranges[0].NumDescriptors = 3;
+    ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;   // t3-t4, PT_SCENE_TABLE_SLOT (same table)
+    ranges[1].NumDescriptors = 2;
+    ranges[1].BaseShaderRegister = 3;
+    ranges[1].OffsetInDescriptorsFromTableStart = PT_SCENE_TABLE_SLOT;
+    ranges[2].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;   // t0 space1, PT_BLUE_NOISE_SLOT (same table)
+    ranges[2].NumDescriptors = 1;
+    ranges[2].RegisterSpace = 1;
+    ranges[2].OffsetInDescriptorsFromTableStart = PT_BLUE_NOISE_SLOT;
+    ranges[3].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;   // u0, slot 3 or 8+i
+    ranges[3].NumDescriptors = 1;
+    ranges[4].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;   // u1, PT_ACCUM_SLOT
+    ranges[4].NumDescriptors = 1;
+    ranges[4].BaseShaderRegister = 1;
+
+    D3D12_ROOT_PARAMETER params[WF_RP_COUNT] = {};
+    params[WF_RP_CB].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    params[WF_RP_CB].Descriptor.ShaderRegister = 0;
+    params[WF_RP_CONSTANTS].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    params[WF_RP_CONSTANTS].Constants.ShaderRegister = 1;
+    params[WF_RP_CONSTANTS].Constants.Num32BitValues = 3;
+    for (UINT i = 0; i < 3; i++) {
+        params[WF_RP_SCENE + i].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        params[WF_RP_SCENE + i].DescriptorTable.NumDescriptorRanges = i == 0 ? 3 : 1;   // Scene: t0-t2 + t3-t4 + blue noise
+        params[WF_RP_SCENE + i].DescriptorTable.pDescriptorRanges = &ranges[i == 0 ? 0 : i + 2];
+    }
+    for (UINT i = 0; i < WF_BUFFER_COUNT; i++) {
+        params[WF_RP_PATHS + i].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        params[WF_RP_PATHS + i].Descriptor.ShaderRegister = 3 + i;
+    }
+
+    D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
+    rsDesc.NumParameters = WF_RP_COUNT;
+    rsDesc.pParameters = params;
+
+    ID3DBlob* sigBlob = nullptr, *errBlob = nullptr;
+    HRESULT hr = D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[ERROR] Wavefront root sig: %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        return false;
+    }
+    hr = dev12->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&s_wfRootSig));
+    sigBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateWavefrontRootSig", hr); return false; }
+
+    // ===== KERNELS =====
+    // One combined source: the sampler, the megakernel's scene helpers + the stage kernels
+    // (CountRays in the shared helpers compiles away: no RAY_STATS here)
+    std::string source = std::string(g_groupShapeShaderCode) + g_rtSamplingShaderCode + g_rayStatsShaderCode + g_ptShaderCode + g_ptWavefrontShaderCode;
+    const char* entries[3 + WF_ARG_COUNT] = {
+        "GenerateCS", "PrepareArgsCS", "ResolveCS",
+        "ExtendCS", "ShadeDiffuseCS", "ShadeMirrorCS", "ShadeGlassCS", "ShadowCS"
+    };
+    LPCWSTR entriesW[3 + WF_ARG_COUNT] = {
+        L"GenerateCS", L"PrepareArgsCS", L"ResolveCS",
+        L"ExtendCS", L"ShadeDiffuseCS", L"ShadeMirrorCS", L"ShadeGlassCS", L"ShadowCS"
+    };
+    ID3D12PipelineState** psos[3 + WF_ARG_COUNT] = {
+        &s_wfGeneratePSO, &s_wfPreparePSO, &s_wfResolvePSO,
+        &s_wfIndirectPSO[WF_ARG_EXTEND], &s_wfIndirectPSO[WF_ARG_DIFFUSE], &s_wfIndirectPSO[WF_ARG_MIRROR],
+        &s_wfIndirectPSO[WF_ARG_GLASS], &s_wfIndirectPSO[WF_ARG_SHADOW]
+    };
+    for (UINT i = 0; i < _countof(entries); i++) {
+        LPCWSTR args[] = { L"-E", entriesW[i], L"-T", L"cs_6_5", L"-D", RtSamplerDefine() };
+        ID3DBlob* blob = nullptr;
+        if (!CompileDXC(source.c_str(), args, _countof(args), &blob, entries[i])) return false;
+        D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+        psoDesc.pRootSignature = s_wfRootSig;
+        psoDesc.CS = { blob->GetBufferPointer(), blob->GetBufferSize() };
+        hr = PipelineCacheCreateCompute(dev12, entriesW[i], psoDesc, psos[i]);
+        blob->Release();
+        if (FAILED(hr)) { LogHR("CreateWavefrontPSO", hr); return false; }
+    }
+
+    // ===== DISPATCH COMMAND SIGNATURE =====
+    // One Dispatch per record; PrepareArgsCS writes a record per queue kernel
+    D3D12_INDIRECT_ARGUMENT_DESC argDesc = {};
+    argDesc.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH;
+    D3D12_COMMAND_SIGNATURE_DESC sigDesc = {};
+    sigDesc.ByteStride = sizeof(D3D12_DISPATCH_ARGUMENTS);
+    sigDesc.NumArgumentDescs = 1;
+    sigDesc.pArgumentDescs = &argDesc;
+    hr = dev12->CreateCommandSignature(&sigDesc, nullptr, IID_PPV_ARGS(&s_wfDispatchSig));
+    if (FAILED(hr)) { LogHR("CreateCommandSignature (wavefront)", hr); return false; }
+
+    Log("[INFO] Wavefront path tracer: %u kernels, queues binned by material\n", (UINT)_countof(entries));
+    return true;
+}
+
+static void CleanupWavefront()
+{
+    ReleaseWavefrontBuffers();
+    if (s_wfDispatchSig) { s_wfDispatchSig->Release(); s_wfDispatchSig = nullptr; }
+    for (UINT i = 0; i < WF_ARG_COUNT; i++) {
+        if (s_wfIndirectPSO[i]) { s_wfIndirectPSO[i]->Release(); s_wfIndirectPSO[i] = nullptr; }
+    }
+    if (s_wfResolvePSO) { s_wfResolvePSO->Release(); s_wfResolvePSO = nullptr; }
+    if (s_wfPreparePSO) { s_wfPreparePSO->Release(); s_wfPreparePSO = nullptr; }
+    if (s_wfGeneratePSO) { s_wfGeneratePSO->Release(); s_wfGeneratePSO = nullptr; }
+    if (s_wfRootSig) { s_wfRootSig->Release(); s_wfRootSig = nullptr; }
+}
+
+// ============== OUTPUT TARGETS ==============
+// pathTraceOutput/denoiseTemp and their descriptors (heap slots 3-7), the
+// back buffer UAVs (slots 8+i) in zero-copy mode, the accumulation sum, the
+// temporal denoise history and the --render-scale upscale targets.
+// Called at init and from ResizeD3D12PT; the TLAS and geometry slots 0-2 are untouched.
+static bool CreatePathTraceTargets()
+{
+    s_traceW = RENDER_SCALED(W);
+    s_traceH = RENDER_SCALED(H);
+    s_upscale = s_traceW != W || s_traceH != H;
+
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC texDesc = {};
+    texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    texDesc.Width = s_traceW;
+    texDesc.Height = s_traceH;
+    texDesc.DepthOrArraySize = 1;
+    texDesc.MipLevels = 1;
+    texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texDesc.SampleDesc.Count = 1;
+    texDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    HRESULT hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&pathTraceOutput));
+    if (FAILED(hr)) { LogHR("CreatePathTraceOutput", hr); return false; }
+    Log("[INFO] Path trace output texture created\n");
+
+    // Create denoise temp texture (for ping-pong denoising)
+    hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&denoiseTemp));
+    if (FAILED(hr)) { LogHR("CreateDenoiseTemp", hr); return false; }
+    Log("[INFO] Denoise temp texture created\n");
+
+    UINT srvUavDescSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE heapStart = pathTraceSrvUavHeap->GetCPUDescriptorHandleForHeapStart();
+
+    // Descriptor 3: Output UAV (u0) - RWTexture2D<float4>
+    D3D12_UNORDERED_ACCESS_VIEW_DESC outputUavDesc = {};
+    outputUavDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    outputUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    D3D12_CPU_DESCRIPTOR_HANDLE outputHandle = heapStart;
+    outputHandle.ptr += 3 * srvUavDescSize;
+    dev12->CreateUnorderedAccessView(pathTraceOutput, nullptr, &outputUavDesc, outputHandle);
+
+    // ===== DENOISE DESCRIPTORS =====
+    // Descriptor 4: PT Output as SRV (for denoise to read)
+    D3D12_SHADER_RESOURCE_VIEW_DESC texSrvDesc = {};
+    texSrvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    texSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    texSrvDesc.Texture2D.MipLevels = 1;
+    D3D12_CPU_DESCRIPTOR_HANDLE h4 = heapStart;
+    h4.ptr += 4 * srvUavDescSize;
+    dev12->CreateShaderResourceView(pathTraceOutput, &texSrvDesc, h4);
+
+    // Descriptor 5: DenoiseTemp as UAV (for denoise to write)
+    D3D12_CPU_DESCRIPTOR_HANDLE h5 = heapStart;
+    h5.ptr += 5 * srvUavDescSize;
+    dev12->CreateUnorderedAccessView(denoiseTemp, nullptr, &outputUavDesc, h5);
+
+    // Descriptor 6: DenoiseTemp as SRV (for second pass to read)
+    D3D12_CPU_DESCRIPTOR_HANDLE h6 = heapStart;
+    h6.ptr += 6 * srvUavDescSize;
+    dev12->CreateShaderResourceView(denoiseTemp, &texSrvDesc, h6);
+
+    // Descriptor 7: PT Output as UAV again (for second pass to write back)
+    D3D12_CPU_DESCRIPTOR_HANDLE h7 = heapStart;
+    h7.ptr += 7 * srvUavDescSize;
+    dev12->CreateUnorderedAccessView(pathTraceOutput, nullptr, &outputUavDesc, h7);
+
+    // Descriptors 8+i: back buffer i as UAV (zero-copy), the swap chain buffers
+    // were just (re)created by CreateSwapChain / ResizeSwapChain12
+    if (s_zeroCopy) {
+        for (UINT i = 0; i < FRAME_COUNT; i++) {
+            D3D12_CPU_DESCRIPTOR_HANDLE h = heapStart;
+            h.ptr += (8 + i) * srvUavDescSize;
+            dev12->CreateUnorderedAccessView(renderTargets12[i], nullptr, &outputUavDesc, h);
+        }
+    }
+
+    // Descriptor PT_ACCUM_SLOT: accumulation sum (u1), null UAV when off
+    D3D12_UNORDERED_ACCESS_VIEW_DESC accumUavDesc = {};
+    accumUavDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    accumUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    if (g_accumTargetSpp) {
+        texDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_accumSum));
+        if (FAILED(hr)) { LogHR("CreateAccumSum", hr); return false; }
+    }
+    D3D12_CPU_DESCRIPTOR_HANDLE hAccum = heapStart;
+    hAccum.ptr += PT_ACCUM_SLOT * srvUavDescSize;
+    dev12->CreateUnorderedAccessView(s_accumSum, nullptr, &accumUavDesc, hAccum);
+
+    // Descriptor PT_HISTORY_SLOT: temporal denoise history (u1 of TemporalCS).
+    // Always created so N can switch to DENOISE_TEMPORAL at runtime.
+    texDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_denoiseHistory));
+    if (FAILED(hr)) { LogHR("CreateDenoiseHistory", hr); return false; }
+    D3D12_UNORDERED_ACCESS_VIEW_DESC historyUavDesc = {};
+    historyUavDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    historyUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    D3D12_CPU_DESCRIPTOR_HANDLE hHistory = heapStart;
+    hHistory.ptr += PT_HISTORY_SLOT * srvUavDescSize;
+    dev12->CreateUnorderedAccessView(s_denoiseHistory, nullptr, &historyUavDesc, hHistory);
+    g_temporalFrameCount = 0;
+
+    // Descriptors PT_UPSCALE_SLOT+0..2: window size upscale targets
+    if (s_upscale) {
+        texDesc.Width = W;
+        texDesc.Height = H;
+        texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_upscaleTemp));
+        if (FAILED(hr)) { LogHR("CreateUpscaleTemp", hr); return false; }
+        D3D12_CPU_DESCRIPTOR_HANDLE hUp = heapStart;
+        hUp.ptr += PT_UPSCALE_SLOT * srvUavDescSize;
+        dev12->CreateUnorderedAccessView(s_upscaleTemp, nullptr, &outputUavDesc, hUp);
+        hUp.ptr += srvUavDescSize;
+        dev12->CreateShaderResourceView(s_upscaleTemp, &texSrvDesc, hUp);
+        if (!s_zeroCopy) {
+            hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
+                D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_upscaleOutput));
+            if (FAILED(hr)) { LogHR("CreateUpscaleOutput", hr); return false; }
+            hUp.ptr += srvUavDescSize;
+            dev12->CreateUnorderedAccessView(s_upscaleOutput, nullptr, &outputUavDesc, hUp);
+        }
+        Log("[INFO] Render scale %u%%: tracing %ux%u, upscaling to %ux%u\n",
+            g_renderScalePct, s_traceW, s_traceH, W, H);
+    }
+
+    // Descriptor PT_RESERVOIR_SLOT: two frames of ReSTIR reservoirs (u0 space3),
+    // null UAV for the other light sampling modes. Zeroed on creation = M 0.
+    D3D12_UNORDERED_ACCESS_VIEW_DESC reservoirUavDesc = {};
+    reservoirUavDesc.Format = DXGI_FORMAT_UNKNOWN;
+    reservoirUavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+    reservoirUavDesc.Buffer.NumElements = 2 * s_traceW * s_traceH;
+    reservoirUavDesc.Buffer.StructureByteStride = PT_RESERVOIR_BYTES;
+    if (g_ptLightSampling == PT_LIGHTS_RESTIR) {
+        D3D12_RESOURCE_DESC bufDesc = {};
+        bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufDesc.Width = (UINT64)reservoirUavDesc.Buffer.NumElements * PT_RESERVOIR_BYTES;
+        bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
+        bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s_reservoirs));
+        if (FAILED(hr)) { LogHR("CreateReservoirs", hr); return false; }
+    }
+    D3D12_CPU_DESCRIPTOR_HANDLE hReservoirs = heapStart;
+    hReservoirs.ptr += PT_RESERVOIR_SLOT * srvUavDescSize;
+    dev12->CreateUnorderedAccessView(s_reservoirs, nullptr, &reservoirUavDesc, hReservoirs);
+
+    if (g_ptWavefront && !CreateWavefrontBuffers()) return false;
+
+    return true;
+}
+
+// ============== SPLIT-FRAME MULTI-GPU ==============
+// --split-gpu: a second device on another adapter traces rows
+// [splitRow, s_traceH) of every frame while this one traces [0, splitRow);
+// PathTraceCS offsets its pixels by RowOffset. The secondary has its own copy
+// of the scene (geometry, tables, lights, compacted BLASes) and rebuilds its
+// 2-instance TLAS each frame from the descs this device just wrote, so it
+// keeps no refit state and adds nothing to the TLAS policy stats.
+// Its band goes into a buffer in a cross-adapter heap (one texture footprint
+// per frame slot, the slot is free again once this device's frame in it has
+// completed) and it signals a shared fence; cmdQueue waits on that fence and
+// copies the band into the trace target before denoise / upscale / present.
+// splitRow follows both GPUs' trace times (this device's "Trace" pass, a
+// timestamp pair on the secondary) once per profiler window, unless
+// --split-ratio fixes it or --accumulate is summing into the current bands.
+#define PT_SPLIT_ROW_ALIGN 8u       // Thread group height: no group straddles the split
+#define PT_SPLIT_MIN_SHARE 0.05f
+#define PT_SPLIT_DEFAULT_SHARE 0.5f
+
+struct PtSplitGpu {
+    int adapterIndex = -1;
+    char name[128] = {};
+    ID3D12Device5* device = nullptr;
+    ID3D12CommandQueue* queue = nullptr;
+    ID3D12CommandAllocator* alloc[FRAME_COUNT] = {};
+    ID3D12GraphicsCommandList4* cl = nullptr;
+    ID3D12Fence* fence = nullptr;           // Shared, signalled after every band
+    ID3D12Fence* fencePrimary = nullptr;    // The same fence opened on dev12
+    UINT64 fenceValue = 0;
+    HANDLE event = nullptr;
+    FrameRing12 ring;                       // CBs and instance descs of the secondary
+
+    // Scene copy (same heap slot layout as pathTraceSrvUavHeap)
+    ID3D12Resource* vbStatic = nullptr;
+    ID3D12Resource* ibStatic = nullptr;
+    ID3D12Resource* vbCube = nullptr;
+    ID3D12Resource* ibCube = nullptr;
+    RTTables12 tables;
+    ID3D12Resource* lights = nullptr;
+    ID3D12Resource* blueNoise = nullptr;
+    ID3D12Resource* blasStatic = nullptr;
+    ID3D12Resource* blasCube = nullptr;
+    ID3D12Resource* tlas = nullptr;
+    ID3D12Resource* scratch = nullptr;
+    ID3D12Resource* instances = nullptr;    // Fallback when the ring is full
+    void* instancesMapped = nullptr;
+    ID3D12RootSignature* rootSig = nullptr;
+    ID3D12PipelineState* pso = nullptr;
+    ID3D12DescriptorHeap* heap = nullptr;
+
+    // Band targets (recreated with the trace targets)
+    ID3D12Resource* output = nullptr;
+    ID3D12Resource* accumSum = nullptr;
+    ID3D12Heap* sharedHeap = nullptr;
+    ID3D12Heap* sharedHeapPrimary = nullptr;
+    ID3D12Resource* shared = nullptr;
+    ID3D12Resource* sharedPrimary = nullptr;
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {};   // Trace target layout, slot offset added per frame
+    UINT64 sliceBytes = 0;
+
+    // Timing and balance
+    ID3D12QueryHeap* queries = nullptr;     // Begin / end of the dispatch per frame slot
+    ID3D12Resource* queryReadback = nullptr;
+    UINT64* queryMapped = nullptr;
+    bool queryPending[FRAME_COUNT] = {};
+    UINT64 timestampFreq = 0;
+    UINT splitRow = 0;
+    float share = PT_SPLIT_DEFAULT_SHARE;   // Target share of the lower band, splitRow is its rounding
+    UINT profilerVersion = 0;
+    double windowMs = 0.0;
+    UINT windowSamples = 0;
+    double lastMs = 0.0;
+    double shareSum = 0.0, msSum = 0.0;     // While the benchmark measures
+    UINT shareFrames = 0, msFrames = 0;
+};
+static PtSplitGpu s_split;
+
+// Explicit index, or the first adapter that is not rendering; -1 = single GPU
+static int PickSplitAdapter()
+{
+    if (g_ptSplitGpu == PT_SPLIT_GPU_OFF) return -1;
+    int index = g_ptSplitGpu;
+    if (index == PT_SPLIT_GPU_AUTO) {
+        index = -1;
+        for (int i = 0; i < (int)g_gpuList.size() && index < 0; i++)
+            if (i != g_settings.selectedGPU) index = i;
+    }
+    if (index < 0 || index >= (int)g_gpuList.size() || index == g_settings.selectedGPU) {
+        Log("[WARN] --split-gpu: no second adapter (%d, %zu enumerated, rendering on %d), tracing on one GPU\n",
+            g_ptSplitGpu, g_gpuList.size(), g_settings.selectedGPU);
+        return -1;
+    }
+    return index;
+}
+
+static UINT SplitLowerRows()
+{
+    return s_traceH - s_split.splitRow;
+}
+
+// Lower band share -> splitRow, aligned to whole thread groups; each GPU keeps at least one row
+static void SplitSetShare(float share)
+{
+    PtSplitGpu& s = s_split;
+    s.share = min(max(share, PT_SPLIT_MIN_SHARE), 1.0f - PT_SPLIT_MIN_SHARE);
+    UINT row = (UINT)((1.0f - s.share) * s_traceH + 0.5f);
+    row = (row + PT_SPLIT_ROW_ALIGN / 2) / PT_SPLIT_ROW_ALIGN * PT_SPLIT_ROW_ALIGN;
+    UINT maxRow = s_traceH > 1 ? (s_traceH - 1) / PT_SPLIT_ROW_ALIGN * PT_SPLIT_ROW_ALIGN : 0;
+    s.splitRow = min(max(row, PT_SPLIT_ROW_ALIGN), maxRow);
+}
+
+static void SplitWaitIdle()
+{
+    PtSplitGpu& s = s_split;
+    if (!s.fence || s.fence->GetCompletedValue() >= s.fenceValue) return;
+    s.fence->SetEventOnCompletion(s.fenceValue, s.event);
+    WaitForSingleObject(s.event, INFINITE);
+}
+
+static void ReleaseSplitTargets()
+{
+    PtSplitGpu& s = s_split;
+    if (s.sharedPrimary) { s.sharedPrimary->Release(); s.sharedPrimary = nullptr; }
+    if (s.shared) { s.shared->Release(); s.shared = nullptr; }
+    if (s.sharedHeapPrimary) { s.sharedHeapPrimary->Release(); s.sharedHeapPrimary = nullptr; }
+    if (s.sharedHeap) { s.sharedHeap->Release(); s.sharedHeap = nullptr; }
+    if (s.accumSum) { s.accumSum->Release(); s.accumSum = nullptr; }
+    if (s.output) { s.output->Release(); s.output = nullptr; }
+}
+
+// Output, accumulation sum and the cross-adapter band buffer at the trace size
+static bool CreateSplitTargets()
+{
+    PtSplitGpu& s = s_split;
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC texDesc = {};
+    texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    texDesc.Width = s_traceW;
+    texDesc.Height = s_traceH;
+    texDesc.DepthOrArraySize = 1;
+    texDesc.MipLevels = 1;
+    texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texDesc.SampleDesc.Count = 1;
+    texDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    HRESULT hr = s.device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s.output));
+    if (FAILED(hr)) { LogHR("CreateSplitOutput", hr); return false; }
+
+    UINT descSize = s.device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE heapStart = s.heap->GetCPUDescriptorHandleForHeapStart();
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    D3D12_CPU_DESCRIPTOR_HANDLE h = heapStart;
+    h.ptr += 3 * descSize;
+    s.device->CreateUnorderedAccessView(s.output, nullptr, &uavDesc, h);
+
+    // PT_ACCUM_SLOT: the lower band's running sum, null UAV without --accumulate
+    uavDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    if (g_accumTargetSpp) {
+        D3D12_RESOURCE_DESC accumDesc = texDesc;
+        accumDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        hr = s.device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &accumDesc,
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&s.accumSum));
+        if (FAILED(hr)) { LogHR("CreateSplitAccumSum", hr); return false; }
+    }
+    h = heapStart;
+    h.ptr += PT_ACCUM_SLOT * descSize;
+    s.device->CreateUnorderedAccessView(s.accumSum, nullptr, &uavDesc, h);
+
+    // Band buffer: FRAME_COUNT copies of the output's row-major footprint in a
+    // heap both devices map (textures can't be shared across adapters unless
+    // they are row-major, which rules out the UAV)
+    texDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+    UINT64 textureBytes = 0;
+    s.device->GetCopyableFootprints(&texDesc, 0, 1, 0, &s.footprint, nullptr, nullptr, &textureBytes);
+    const UINT64 placement = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+    s.sliceBytes = (textureBytes + placement - 1) / placement * placement;
+    const UINT64 heapAlign = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    D3D12_HEAP_DESC heapDesc = {};
+    heapDesc.SizeInBytes = (s.sliceBytes * FRAME_COUNT + heapAlign - 1) / heapAlign * heapAlign;
+    heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    heapDesc.Alignment = heapAlign;
+    heapDesc.Flags = D3D12_HEAP_FLAG_SHARED | D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER;
+    hr = s.device->CreateHeap(&heapDesc, IID_PPV_ARGS(&s.sharedHeap));
+    if (FAILED(hr)) { LogHR("CreateHeap (split GPU, cross-adapter)", hr); return false; }
+    HANDLE handle = nullptr;
+    hr = s.device->CreateSharedHandle(s.sharedHeap, nullptr, GENERIC_ALL, nullptr, &handle);
+    if (FAILED(hr)) { LogHR("CreateSharedHandle (split GPU heap)", hr); return false; }
+    hr = dev12->OpenSharedHandle(handle, IID_PPV_ARGS(&s.sharedHeapPrimary));
+    CloseHandle(handle);
+    if (FAILED(hr)) { LogHR("OpenSharedHandle (split GPU heap)", hr); return false; }
+
+    D3D12_RESOURCE_DESC bufDesc = {};
+    bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    bufDesc.Width = heapDesc.SizeInBytes;
+    bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
+    bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    bufDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER;
+    // COMMON on both sides: the copies promote it and it decays after each submit
+    hr = s.device->CreatePlacedResource(s.sharedHeap, 0, &bufDesc, D3D12_RESOURCE_STATE_COMMON,
+        nullptr, IID_PPV_ARGS(&s.shared));
+    if (FAILED(hr)) { LogHR("CreatePlacedResource (split GPU band)", hr); return false; }
+    hr = dev12->CreatePlacedResource(s.sharedHeapPrimary, 0, &bufDesc, D3D12_RESOURCE_STATE_COMMON,
+        nullptr, IID_PPV_ARGS(&s.sharedPrimary));
+    if (FAILED(hr)) { LogHR("CreatePlacedResource (split GPU band, presenting side)", hr); return false; }
+
+    SplitSetShare(g_ptSplitRatio > 0.0f ? g_ptSplitRatio : s.share);
+    Log("[INFO] Split GPU: %ux%u, lower band from row %u, %.1f MB cross-adapter\n",
+        s_traceW, s_traceH, s.splitRow, heapDesc.SizeInBytes / (1024.0 * 1024.0));
+    return true;
+}
+
+static void CleanupSplitGpu()
+{
+    PtSplitGpu& s = s_split;
+    SplitWaitIdle();
+    ReleaseSplitTargets();
+    if (s.queryReadback) { s.queryReadback->Unmap(0, nullptr); s.queryReadback->Release(); }
+    if (s.queries) s.queries->Release();
+    if (s.heap) s.heap->Release();
+    if (s.pso) s.pso->Release();
+    if (s.rootSig) s.rootSig->Release();
+    if (s.instances) { s.instances->Unmap(0, nullptr); s.instances->Release(); }
+    ID3D12Resource* buffers[] = { s.scratch, s.tlas, s.blasCube, s.blasStatic, s.blueNoise, s.lights,
+                                  s.ibCube, s.vbCube, s.ibStatic, s.vbStatic };
+    for (ID3D12Resource* b : buffers) if (b) b->Release();
+    RTTablesRelease12(s.tables);
+    CleanupFrameRing12(s.ring);
+    if (s.event) CloseHandle(s.event);
+    if (s.fencePrimary) s.fencePrimary->Release();
+    if (s.fence) s.fence->Release();
+    if (s.cl) s.cl->Release();
+    for (UINT i = 0; i < FRAME_COUNT; i++) if (s.alloc[i]) s.alloc[i]->Release();
+    if (s.queue) s.queue->Release();
+    if (s.device) s.device->Release();
+    s_split = PtSplitGpu();
+}
+
+// Everything the band needs on s_split.adapterIndex. Called at the end of
+// InitD3D12PT with its geometry, shader source and root signature desc.
+static bool InitSplitGpu(const RTMeshData& meshStatic, const RTMeshData& meshCube, const std::string& csSource,
+                         LPCWSTR* csArgs, UINT csArgCount, D3D12_ROOT_SIGNATURE_DESC rsDesc)
+{
+    PtSplitGpu& s = s_split;
+    size_t converted = 0;
+    wcstombs_s(&converted, s.name, sizeof(s.name), g_gpuList[s.adapterIndex].name.c_str(), _TRUNCATE);
+    HRESULT hr = D3D12CreateDevice(g_gpuList[s.adapterIndex].adapter, D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&s.device));
+    if (FAILED(hr)) { LogHR("CreateDevice (split GPU)", hr); return false; }
+    D3D12_FEATURE_DATA_D3D12_OPTIONS5 options5 = {};
+    if (FAILED(s.device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS5, &options5, sizeof(options5))) ||
+        options5.RaytracingTier < D3D12_RAYTRACING_TIER_1_1) {
+        Log("[WARN] --split-gpu: %s has no DXR 1.1 (ray queries)\n", s.name);
+        return false;
+    }
+
+    D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    hr = s.device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&s.queue));
+    if (FAILED(hr)) { LogHR("CreateCommandQueue (split GPU)", hr); return false; }
+    for (UINT i = 0; i < FRAME_COUNT; i++) {
+        hr = s.device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&s.alloc[i]));
+        if (FAILED(hr)) { LogHR("CreateCommandAllocator (split GPU)", hr); return false; }
+    }
+    hr = s.device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, s.alloc[0], nullptr, IID_PPV_ARGS(&s.cl));
+    if (FAILED(hr)) { LogHR("CreateCommandList (split GPU)", hr); return false; }
+
+    // Shared fence: signalled by the secondary queue, waited on by cmdQueue
+    hr = s.device->CreateFence(0, D3D12_FENCE_FLAG_SHARED | D3D12_FENCE_FLAG_SHARED_CROSS_ADAPTER, IID_PPV_ARGS(&s.fence));
+    if (FAILED(hr)) { LogHR("CreateFence (split GPU, cross-adapter)", hr); return false; }
+    HANDLE handle = nullptr;
+    hr = s.device->CreateSharedHandle(s.fence, nullptr, GENERIC_ALL, nullptr, &handle);
+    if (FAILED(hr)) { LogHR("CreateSharedHandle (split GPU fence)", hr); return false; }
+    hr = dev12->OpenSharedHandle(handle, IID_PPV_ARGS(&s.fencePrimary));
+    CloseHandle(handle);
+    if (FAILED(hr)) { LogHR("OpenSharedHandle (split GPU fence)", hr); return false; }
+    s.event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!s.event) { Log("[ERROR] CreateEvent failed (split GPU)\n"); return false; }
+    if (!InitFrameRing12(s.ring, s.device, s.fence, FRAME_RING_SIZE, "PT split GPU")) return false;
+
+    // ===== SCENE COPY =====
+    s.tables.materials = s_rtTables.materials;
+    s.tables.primitives = s_rtTables.primitives;
+    if (!UploadBegin12(s.device)) return false;
+    s.vbStatic = UploadBuffer12(meshStatic.vertices, meshStatic.vertexBytes, "PT split static VB");
+    s.ibStatic = UploadBuffer12(meshStatic.indices, meshStatic.indexBytes, "PT split static IB");
+    if (s_meshCube) {
+        s.vbCube = UploadBuffer12(g_mesh.vertices, MeshVertexBytes(g_mesh), "PT split mesh VB");
+        s.ibCube = UploadBuffer12(g_mesh.indices, MeshIndexBytes(g_mesh), "PT split mesh IB");
+    } else {
+        s.vbCube = UploadBuffer12(meshCube.vertices, meshCube.vertexBytes, "PT split cube VB");
+        s.ibCube = UploadBuffer12(meshCube.indices, meshCube.indexBytes, "PT split cube IB");
+    }
+    bool tablesOk = RTTablesUpload12(s.tables, "PT split", s_meshCube ? &g_mesh : nullptr, OBJ_CUBE);
+    s.lights = UploadBuffer12(s_lights.data(), s_lights.size() * sizeof(PtLight), "PT split lights");
+    s.blueNoise = RTBlueNoiseUpload12("PT split");
+    bool noiseOk = s.blueNoise || g_rtSampler != RT_SAMPLER_BLUENOISE;
+    if (!UploadFlush12() || !s.vbStatic || !s.ibStatic || !s.vbCube || !s.ibCube || !tablesOk || !noiseOk || !s.lights) {
+        Log("[ERROR] Split GPU geometry upload failed\n");
+        return false;
+    }
+
+    // ===== ACCELERATION STRUCTURES =====
+    // Same inputs as this device's BLASes; one scratch large enough for the
+    // BLAS builds and the per-frame TLAS build
+    D3D12_RAYTRACING_GEOMETRY_DESC geoms[2] = {};
+    const RTMeshData* meshes[2] = { &meshStatic, &meshCube };
+    ID3D12Resource* vbs[2] = { s.vbStatic, s.vbCube };
+    ID3D12Resource* ibs[2] = { s.ibStatic, s.ibCube };
+    const UINT vertexCounts[2] = { s_vertCountStatic, s_vertCountCube };
+    const UINT indexCounts[2] = { s_indCountStatic, s_indCountCube };
+    ID3D12Resource** blas[2] = { &s.blasStatic, &s.blasCube };
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS blasInputs[2] = {};
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO prebuild[3] = {};
+    for (UINT i = 0; i < 2; i++) {
+        geoms[i].Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
+        geoms[i].Triangles.VertexBuffer.StartAddress = vbs[i]->GetGPUVirtualAddress();
+        geoms[i].Triangles.VertexBuffer.StrideInBytes = meshes[i]->vertexStride;
+        geoms[i].Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+        geoms[i].Triangles.VertexCount = vertexCounts[i];
+        geoms[i].Triangles.IndexBuffer = ibs[i]->GetGPUVirtualAddress();
+        geoms[i].Triangles.IndexFormat = meshes[i]->index16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+        geoms[i].Triangles.IndexCount = indexCounts[i];
+        geoms[i].Flags = D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
+        blasInputs[i].Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL;
+        blasInputs[i].DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
+        blasInputs[i].NumDescs = 1;
+        blasInputs[i].pGeometryDescs = &geoms[i];
+        blasInputs[i].Flags = BLAS_STATIC_FLAGS12;
+        s.device->GetRaytracingAccelerationStructurePrebuildInfo(&blasInputs[i], &prebuild[i]);
+    }
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs;
+    TlasInputs12(tlasInputs, 2, 0);
+    s.device->GetRaytracingAccelerationStructurePrebuildInfo(&tlasInputs, &prebuild[2]);
+
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC asDesc = {};
+    asDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    asDesc.Height = 1; asDesc.DepthOrArraySize = 1; asDesc.MipLevels = 1;
+    asDesc.SampleDesc.Count = 1; asDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    asDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    asDesc.Width = max(max(prebuild[0].ScratchDataSizeInBytes, prebuild[1].ScratchDataSizeInBytes), TlasScratchSize12(prebuild[2]));
+    hr = s.device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc,
+        D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&s.scratch));
+    if (FAILED(hr)) { LogHR("CreateScratch (split GPU)", hr); return false; }
+    for (UINT i = 0; i < 3; i++) {
+        asDesc.Width = prebuild[i].ResultDataMaxSizeInBytes;
+        hr = s.device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc,
+            D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE, nullptr, IID_PPV_ARGS(i < 2 ? blas[i] : &s.tlas));
+        if (FAILED(hr)) { LogHR("CreateAccelerationStructure (split GPU)", hr); return false; }
+    }
 
     D3D12_RESOURCE_BARRIER uavBarrier = {};
-    uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-    uavBarrier.UAV.pResource = s_tlasBuffer;
-    cmdListRT->ResourceBarrier(1, &uavBarrier);
+    uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;   // Null: the shared scratch
+    for (UINT i = 0; i < 2; i++) {
+        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC build = {};
+        build.Inputs = blasInputs[i];
+        build.DestAccelerationStructureData = (*blas[i])->GetGPUVirtualAddress();
+        build.ScratchAccelerationStructureData = s.scratch->GetGPUVirtualAddress();
+        s.cl->BuildRaytracingAccelerationStructure(&build, 0, nullptr);
+        s.cl->ResourceBarrier(1, &uavBarrier);
+    }
+    CompactBLAS12(s.device, s.queue, s.alloc[0], s.cl, blas, 2, "PT split");
+    // Compacted: cl is empty again; not compacted: the builds are still in it
+    s.cl->Close();
+    ID3D12CommandList* lists[] = { s.cl };
+    s.queue->ExecuteCommandLists(1, lists);
+    s.queue->Signal(s.fence, ++s.fenceValue);
+    SplitWaitIdle();
+
+    D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
+    asDesc.Width = 2 * sizeof(D3D12_RAYTRACING_INSTANCE_DESC);
+    asDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+    hr = s.device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &asDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s.instances));
+    if (FAILED(hr)) { LogHR("CreateInstanceBuffer (split GPU)", hr); return false; }
+    s.instances->Map(0, nullptr, &s.instancesMapped);
+
+    // ===== PIPELINE =====
+    // Root signature of the megakernel without the --ray-stats UAV
+    rsDesc.NumParameters = 4;
+    ID3DBlob* sigBlob = nullptr, *errBlob = nullptr;
+    hr = D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) { Log("[ERROR] Split GPU root sig: %s\n", (char*)errBlob->GetBufferPointer()); errBlob->Release(); }
+        return false;
+    }
+    hr = s.device->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&s.rootSig));
+    sigBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateRootSignature (split GPU)", hr); return false; }
+    // The pipeline cache is dev12's; the DXIL still comes from the DXIL cache
+    ID3DBlob* csBlob = nullptr;
+    if (!CompileDXC(csSource.c_str(), csArgs, csArgCount, &csBlob, "PathTraceCS (split GPU)")) return false;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.pRootSignature = s.rootSig;
+    psoDesc.CS = { csBlob->GetBufferPointer(), csBlob->GetBufferSize() };
+    hr = s.device->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(&s.pso));
+    csBlob->Release();
+    if (FAILED(hr)) { LogHR("CreatePathTracePSO (split GPU)", hr); return false; }
+
+    // ===== DESCRIPTORS =====
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+    heapDesc.NumDescriptors = PT_SRV_UAV_DESCRIPTORS;
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    hr = s.device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&s.heap));
+    if (FAILED(hr)) { LogHR("CreateDescriptorHeap (split GPU)", hr); return false; }
+    UINT descSize = s.device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE heapStart = s.heap->GetCPUDescriptorHandleForHeapStart();
+    auto slot = [&](UINT i) { D3D12_CPU_DESCRIPTOR_HANDLE h = heapStart; h.ptr += i * descSize; return h; };
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC tlasSrvDesc = {};
+    tlasSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_RAYTRACING_ACCELERATION_STRUCTURE;
+    tlasSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    tlasSrvDesc.RaytracingAccelerationStructure.Location = s.tlas->GetGPUVirtualAddress();
+    s.device->CreateShaderResourceView(nullptr, &tlasSrvDesc, slot(0));
+    RTMeshCreateSrvs12(s.device, s.vbStatic, s_vertCountStatic, meshStatic.vertexStride, s.ibStatic, s_indCountStatic,
+                       meshStatic.index16, slot(1), slot(2));
+    RTTablesCreateSrvs12(s.device, s.tables, slot(PT_SCENE_TABLE_SLOT), slot(PT_SCENE_TABLE_SLOT + 1));
+    RTBlueNoiseCreateSrv12(s.device, s.blueNoise, slot(PT_BLUE_NOISE_SLOT));
+    D3D12_SHADER_RESOURCE_VIEW_DESC lightSrvDesc = {};
+    lightSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    lightSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    lightSrvDesc.Buffer.NumElements = (UINT)s_lights.size();
+    lightSrvDesc.Buffer.StructureByteStride = sizeof(PtLight);
+    s.device->CreateShaderResourceView(s.lights, &lightSrvDesc, slot(PT_LIGHT_SLOT));
+    // No --adaptive or ReSTIR in split mode: null counter and reservoir UAVs
+    D3D12_UNORDERED_ACCESS_VIEW_DESC counterUavDesc = {};
+    counterUavDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    counterUavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+    counterUavDesc.Buffer.NumElements = 1;
+    counterUavDesc.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_RAW;
+    s.device->CreateUnorderedAccessView(nullptr, nullptr, &counterUavDesc, slot(PT_COUNTER_SLOT));
+    D3D12_UNORDERED_ACCESS_VIEW_DESC reservoirUavDesc = {};
+    reservoirUavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+    reservoirUavDesc.Buffer.NumElements = 1;
+    reservoirUavDesc.Buffer.StructureByteStride = PT_RESERVOIR_BYTES;
+    s.device->CreateUnorderedAccessView(nullptr, nullptr, &reservoirUavDesc, slot(PT_RESERVOIR_SLOT));
+
+    // ===== TIMESTAMPS =====
+    D3D12_QUERY_HEAP_DESC queryDesc = {};
+    queryDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    queryDesc.Count = 2 * FRAME_COUNT;
+    hr = s.device->CreateQueryHeap(&queryDesc, IID_PPV_ARGS(&s.queries));
+    if (FAILED(hr)) { LogHR("CreateQueryHeap (split GPU)", hr); return false; }
+    D3D12_HEAP_PROPERTIES readbackHeap = { D3D12_HEAP_TYPE_READBACK };
+    asDesc.Width = 2 * FRAME_COUNT * sizeof(UINT64);
+    hr = s.device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &asDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&s.queryReadback));
+    if (FAILED(hr)) { LogHR("CreateQueryReadback (split GPU)", hr); return false; }
+    s.queryReadback->Map(0, nullptr, (void**)&s.queryMapped);   // Persistent map
+    s.queue->GetTimestampFrequency(&s.timestampFreq);
+
+    if (!CreateSplitTargets()) return false;
+    Log("[INFO] Split-frame path tracing: GPU %d (%s) traces the lower band, %s\n", s.adapterIndex, s.name,
+        g_ptSplitRatio > 0.0f ? "fixed share" : "share balanced by GPU time");
+    return true;
+}
+
+// Timestamps of the band last traced in this slot (complete: this device's
+// frame in the slot waited for it)
+static void SplitCollectTimestamps(UINT slot)
+{
+    PtSplitGpu& s = s_split;
+    if (!s.queryPending[slot]) return;
+    s.queryPending[slot] = false;
+    const UINT64* t = s.queryMapped + 2 * slot;
+    if (t[1] <= t[0] || !s.timestampFreq) return;
+    s.lastMs = (double)(t[1] - t[0]) * 1000.0 / s.timestampFreq;
+    s.windowMs += s.lastMs;
+    s.windowSamples++;
+    if (BenchmarkIsMeasuring()) { s.msSum += s.lastMs; s.msFrames++; }
+}
+
+// Once per profiler window: move the split half way to where both GPUs
+// would have taken the same time at their measured rows per ms
+static void SplitRebalance(UINT accumFrame)
+{
+    PtSplitGpu& s = s_split;
+    if (g_ptSplitRatio > 0.0f || accumFrame != 0) return;
+    UINT version = GpuProfilerGetVersion();
+    if (version == s.profilerVersion) return;
+    s.profilerVersion = version;
+
+    double primaryMs = 0.0;
+    for (UINT i = 0; i < GpuProfilerPassCount(); i++) {
+        const GpuPassStats* pass = GpuProfilerGetPass(i);
+        if (pass && pass->name && strcmp(pass->name, "Trace") == 0) primaryMs = pass->displayMs;
+    }
+    double secondaryMs = s.windowSamples ? s.windowMs / s.windowSamples : 0.0;
+    s.windowMs = 0.0;
+    s.windowSamples = 0;
+    if (primaryMs <= 0.0 || secondaryMs <= 0.0) return;
+
+    double primaryRate = s.splitRow / primaryMs;
+    double secondaryRate = SplitLowerRows() / secondaryMs;
+    float balanced = (float)(secondaryRate / (primaryRate + secondaryRate));
+    SplitSetShare(0.5f * (s.share + balanced));
+}
+
+// Records and submits the lower band on the secondary: TLAS from this
+// frame's instances, the dispatch, and the copy into this slot's footprint
+static void SplitSubmit(const PathTraceCBData& frameCB)
+{
+    PtSplitGpu& s = s_split;
+    SplitCollectTimestamps(frameIndex);
+    FrameRingReclaim12(s.ring, s.fence->GetCompletedValue());
+    s.alloc[frameIndex]->Reset();
+    s.cl->Reset(s.alloc[frameIndex], s.pso);
+
+    D3D12_RAYTRACING_INSTANCE_DESC descs[2];
+    memcpy(descs, s_instanceMapped, sizeof(descs));
+    descs[0].AccelerationStructure = s.blasStatic->GetGPUVirtualAddress();
+    descs[1].AccelerationStructure = s.blasCube->GetGPUVirtualAddress();
+    D3D12_GPU_VIRTUAL_ADDRESS descGpu = FrameRingPush12(s.ring, descs, sizeof(descs), D3D12_RAYTRACING_INSTANCE_DESCS_BYTE_ALIGNMENT);
+    if (!descGpu) {
+        memcpy(s.instancesMapped, descs, sizeof(descs));
+        descGpu = s.instances->GetGPUVirtualAddress();
+    }
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC build = {};
+    TlasInputs12(build.Inputs, 2, descGpu);
+    build.DestAccelerationStructureData = s.tlas->GetGPUVirtualAddress();
+    build.ScratchAccelerationStructureData = s.scratch->GetGPUVirtualAddress();
+    s.cl->BuildRaytracingAccelerationStructure(&build, 0, nullptr);
+    D3D12_RESOURCE_BARRIER barriers[2] = {};
+    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    barriers[0].UAV.pResource = s.tlas;
+    barriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    barriers[1].UAV.pResource = s.accumSum;
+    s.cl->ResourceBarrier(s.accumSum ? 2 : 1, barriers);
+
+    PathTraceCBData cb = frameCB;
+    cb.RowOffset = s.splitRow;
+    D3D12_GPU_VIRTUAL_ADDRESS cbGpu = FrameRingPush12(s.ring, &cb, sizeof(cb), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    UINT descSize = s.device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_GPU_DESCRIPTOR_HANDLE table = s.heap->GetGPUDescriptorHandleForHeapStart();
+    D3D12_GPU_DESCRIPTOR_HANDLE outputTable = table, accumTable = table;
+    outputTable.ptr += 3 * descSize;
+    accumTable.ptr += PT_ACCUM_SLOT * descSize;
+    ID3D12DescriptorHeap* heaps[] = { s.heap };
+    s.cl->SetDescriptorHeaps(1, heaps);
+    s.cl->SetComputeRootSignature(s.rootSig);
+    s.cl->SetComputeRootConstantBufferView(0, cbGpu);
+    s.cl->SetComputeRootDescriptorTable(1, table);
+    s.cl->SetComputeRootDescriptorTable(2, outputTable);
+    s.cl->SetComputeRootDescriptorTable(3, accumTable);
+    s.cl->EndQuery(s.queries, D3D12_QUERY_TYPE_TIMESTAMP, 2 * frameIndex);
+    s.cl->Dispatch((s_traceW + 7) / 8, (SplitLowerRows() + PT_SPLIT_ROW_ALIGN - 1) / PT_SPLIT_ROW_ALIGN, 1);
+    s.cl->EndQuery(s.queries, D3D12_QUERY_TYPE_TIMESTAMP, 2 * frameIndex + 1);
+    s.cl->ResolveQueryData(s.queries, D3D12_QUERY_TYPE_TIMESTAMP, 2 * frameIndex, 2,
+                           s.queryReadback, 2 * frameIndex * sizeof(UINT64));
+    s.queryPending[frameIndex] = true;
+
+    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barriers[0].Transition.pResource = s.output;
+    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    s.cl->ResourceBarrier(1, barriers);
+    D3D12_TEXTURE_COPY_LOCATION src = {}, dst = {};
+    src.pResource = s.output;
+    src.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    dst.pResource = s.shared;
+    dst.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    dst.PlacedFootprint = s.footprint;
+    dst.PlacedFootprint.Offset = frameIndex * s.sliceBytes;
+    D3D12_BOX band = { 0, s.splitRow, 0, s_traceW, s_traceH, 1 };
+    s.cl->CopyTextureRegion(&dst, 0, s.splitRow, 0, &src, &band);
+    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    s.cl->ResourceBarrier(1, barriers);
+    s.cl->Close();
+
+    ID3D12CommandList* lists[] = { s.cl };
+    s.queue->ExecuteCommandLists(1, lists);
+    FrameRingRetire12(s.ring, s.fenceValue + 1);
+    s.queue->Signal(s.fence, ++s.fenceValue);
+    if (BenchmarkIsMeasuring()) {
+        s.shareSum += (double)SplitLowerRows() / s_traceH;
+        s.shareFrames++;
+    }
+}
+
+// Submits the upper band recorded so far, makes cmdQueue wait for the
+// secondary's band and reopens cmdList with its copy into target (UAV state)
+static void SplitComposite(ID3D12Resource* target)
+{
+    PtSplitGpu& s = s_split;
+    cmdList->Close();
+    ID3D12CommandList* lists[] = { cmdList };
+    cmdQueue->ExecuteCommandLists(1, lists);
+    cmdQueue->Wait(s.fencePrimary, s.fenceValue);
+    cmdList->Reset(cmdAlloc[frameIndex], nullptr);
+    ID3D12DescriptorHeap* heaps[] = { pathTraceSrvUavHeap };
+    cmdList->SetDescriptorHeaps(1, heaps);
+
+    D3D12_RESOURCE_BARRIER barrier = {};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barrier.Transition.pResource = target;
+    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    cmdList->ResourceBarrier(1, &barrier);
+    D3D12_TEXTURE_COPY_LOCATION src = {}, dst = {};
+    src.pResource = s.sharedPrimary;
+    src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    src.PlacedFootprint = s.footprint;
+    src.PlacedFootprint.Offset = frameIndex * s.sliceBytes;
+    dst.pResource = target;
+    dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    D3D12_BOX band = { 0, s.splitRow, 0, s_traceW, s_traceH, 1 };
+    cmdList->CopyTextureRegion(&dst, 0, s.splitRow, 0, &src, &band);
+    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    cmdList->ResourceBarrier(1, &barrier);
+    GpuTimerStamp12(cmdList, frameIndex, "Composite");
+}
+
+int D3D12PTSplitGpu()
+{
+    return s_split.device ? s_split.adapterIndex : -1;
+}
+
+float D3D12PTSplitShare()
+{
+    if (!s_split.device) return 0.0f;
+    if (s_split.shareFrames) return (float)(s_split.shareSum / s_split.shareFrames);
+    return s_traceH ? (float)SplitLowerRows() / s_traceH : 0.0f;
+}
+
+double D3D12PTSplitSecondaryMs()
+{
+    if (!s_split.device) return 0.0;
+    return s_split.msFrames ? s_split.msSum / s_split.msFrames : s_split.lastMs;
+}
+
+// ============== VRAM CATEGORIES (non-static, declared in d3d12_shared.h) ==============
+void VramCategoriesPT(UINT64* bytes)
+{
+    bytes[VRAM_BLAS] += ResourceBytes12(s_blasStatic) + ResourceBytes12(s_blasCube);
+    bytes[VRAM_TLAS] += ResourceBytes12(s_tlasBuffer) + ResourceBytes12(s_instanceBuffer);
+    bytes[VRAM_SCRATCH] += ResourceBytes12(s_scratchBuffer);
+    bytes[VRAM_GBUFFER] += ResourceBytes12(pathTraceOutput) + ResourceBytes12(denoiseTemp) +
+                           ResourceBytes12(s_upscaleTemp) + ResourceBytes12(s_upscaleOutput);
+    for (UINT i = 0; i < WF_BUFFER_COUNT; i++) bytes[VRAM_GBUFFER] += ResourceBytes12(s_wfBuffers[i]);
+    bytes[VRAM_HISTORY] += ResourceBytes12(s_accumSum) + ResourceBytes12(s_denoiseHistory) + ResourceBytes12(s_reservoirs);
 }
 
 // ============== INITIALIZATION ==============
@@ -239,6 +1374,7 @@ bool InitD3D12PT(HWND hwnd)
 {
     Log("[INFO] Initializing Direct3D 12 with Path Tracing...\n");
     HRESULT hr;
+    StartupStep("Device");
 
     // Enable debug layer
     ID3D12Debug* debugController = nullptr;
@@ -269,6 +1405,7 @@ bool InitD3D12PT(HWND hwnd)
     if (FAILED(hr)) { LogHR("CreateCommandQueue", hr); factory->Release(); return false; }
 
     // Swap chain
+    StartupStep("Swap chain + frame resources");
     IDXGIFactory5* factory5 = nullptr;
     factory->QueryInterface(IID_PPV_ARGS(&factory5));
 
@@ -282,15 +1419,22 @@ bool InitD3D12PT(HWND hwnd)
     scd.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
     scd.SampleDesc.Count = 1;
     scd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;  // No UAV - we copy from separate texture
+    if (g_zeroCopyPresent) scd.BufferUsage |= DXGI_USAGE_UNORDERED_ACCESS;  // Trace writes the back buffer
     scd.BufferCount = FRAME_COUNT;
     scd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    scd.Flags = g_tearingSupported12 ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+    scd.Flags = DxgiSwapChainFlags(g_tearingSupported12);
 
     Log("[INFO] Creating swap chain: %ux%u, BufferCount=%u, Tearing=%s\n",
         scd.Width, scd.Height, scd.BufferCount, g_tearingSupported12 ? "YES" : "NO");
 
     IDXGISwapChain1* swap1 = nullptr;
-    hr = factory5->CreateSwapChainForHwnd(cmdQueue, hwnd, &scd, nullptr, nullptr, &swap1);
+    hr = DxgiCreateSwapChain(factory5, cmdQueue, hwnd, scd, &swap1);
+    if (FAILED(hr) && g_zeroCopyPresent) {
+        Log("[WARN] D3D12 PT: UAV back buffers not supported (0x%08X), using the copy path\n", hr);
+        scd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        hr = DxgiCreateSwapChain(factory5, cmdQueue, hwnd, scd, &swap1);
+    }
+    s_zeroCopy = SUCCEEDED(hr) && (scd.BufferUsage & DXGI_USAGE_UNORDERED_ACCESS);
     if (factory5) factory5->Release();
     factory->Release();
     if (FAILED(hr)) {
@@ -299,9 +1443,10 @@ bool InitD3D12PT(HWND hwnd)
             scd.Format, scd.BufferUsage, scd.SwapEffect);
         return false;
     }
-    Log("[INFO] Swap chain created successfully\n");
+    Log("[INFO] Swap chain created successfully%s\n", s_zeroCopy ? " (UAV back buffers, zero-copy present)" : "");
     swap1->QueryInterface(IID_PPV_ARGS(&swap12));
     swap1->Release();
+    swapWaitable12 = DxgiInitFrameLatency(swap12, "D3D12 PT");
     frameIndex = swap12->GetCurrentBackBufferIndex();
     Log("[INFO] Initial frame index: %u\n", frameIndex);
 
@@ -360,8 +1505,30 @@ bool InitD3D12PT(HWND hwnd)
     fenceValues[0] = fenceValues[1] = fenceValues[2] = 1;
     fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
     if (!fenceEvent) { Log("[ERROR] CreateEvent failed!\n"); return false; }
+    if (!InitFrameRing12(g_frameRing12, dev12, fence, FRAME_RING_SIZE, "D3D12 PT")) return false;
+
+    StartupStep("Geometry + upload");
+    // --split-gpu: the bands are traced independently, so nothing may depend on
+    // the whole frame (wavefront queues, the adaptive counter, ReSTIR neighbours)
+    if (g_ptSplitGpu != PT_SPLIT_GPU_OFF && (g_ptWavefront || g_ptAdaptiveMaxSpp || g_ptLightSampling == PT_LIGHTS_RESTIR)) {
+        Log("[WARN] --split-gpu: --wavefront / --adaptive off, --light-sampling=restir falls back to ris\n");
+        g_ptWavefront = false;
+        g_ptAdaptiveMaxSpp = 0;
+        if (g_ptLightSampling == PT_LIGHTS_RESTIR) g_ptLightSampling = PT_LIGHTS_RIS;
+    }
 
     // ===== BUILD GEOMETRY (Static + Dynamic Cubes) =====
+    // --lights / --light-sampling: the wavefront kernels only know the spotlight
+    if (g_ptWavefront && (g_ptLights || g_ptLightSampling != PT_LIGHTS_UNIFORM)) {
+        Log("[WARN] --lights / --light-sampling need the megakernel, ignored with --wavefront\n");
+        g_ptLights = 0;
+        g_ptLightSampling = PT_LIGHTS_UNIFORM;
+    }
+    BuildPtLights(2.0f, s_lights);
+    if (g_ptLights || g_ptLightSampling != PT_LIGHTS_UNIFORM)
+        Log("[INFO] PT lights: %zu (spotlight + %u emitters), %s sampling\n",
+            s_lights.size(), g_ptLights, PtLightSamplingName());
+
     Log("[INFO] Building geometry...\n");
     std::vector<PTVert> vertsStatic, vertsCube;
     std::vector<UINT> indsStatic, indsCube;
@@ -369,56 +1536,62 @@ bool InitD3D12PT(HWND hwnd)
     BuildDynamicCubes(vertsCube, indsCube);
     s_vertCountStatic = (UINT)vertsStatic.size();
     s_indCountStatic = (UINT)indsStatic.size();
-    s_vertCountCube = (UINT)vertsCube.size();
-    s_indCountCube = (UINT)indsCube.size();
-    Log("[INFO] Static: %u verts, %u inds | Cubes: %u verts, %u inds\n",
-        s_vertCountStatic, s_indCountStatic, s_vertCountCube, s_indCountCube);
+    s_meshCube = MeshLoaded() && MeshSupportedBy(g_settings.renderer);
+    s_vertCountCube = s_meshCube ? g_mesh.vertexCount : (UINT)vertsCube.size();
+    s_indCountCube = s_meshCube ? g_mesh.indexCount : (UINT)indsCube.size();
+    Log("[INFO] Static: %u verts, %u inds | %s: %u verts, %u inds\n",
+        s_vertCountStatic, s_indCountStatic, s_meshCube ? "Mesh" : "Cubes", s_vertCountCube, s_indCountCube);
+
+    // Material / primitive tables of the hit shading (d3d12_rt_tables.cpp)
+    BuildSceneTablesPT(vertsStatic, indsStatic, vertsCube, indsCube);
+
+    // BLAS input layout: full PTVert + 32-bit indices, or --compact-verts (rt_geometry.h)
+    RTMeshData meshStatic, meshCube;
+    RTMeshPrepare(meshStatic, vertsStatic.data(), sizeof(PTVert), s_vertCountStatic, indsStatic, "PT static");
+    if (!s_meshCube) RTMeshPrepare(meshCube, vertsCube.data(), sizeof(PTVert), s_vertCountCube, indsCube, "PT cube");
+
+    // Static + cube VB/IB and the tables to DEFAULT heap, one copy-queue submission
+    if (!UploadBegin12(dev12)) return false;
+    s_vbStatic = UploadBuffer12(meshStatic.vertices, meshStatic.vertexBytes, "PT static VB");
+    s_ibStatic = UploadBuffer12(meshStatic.indices, meshStatic.indexBytes, "PT static IB");
+    if (s_meshCube) {
+        // File layout as is: 24-byte MeshVertex, 32-bit indices (also with --compact-verts)
+        meshCube.vertexStride = sizeof(MeshVertex);
+        meshCube.index16 = false;
+        s_vbCube = UploadBuffer12(g_mesh.vertices, MeshVertexBytes(g_mesh), "PT mesh VB");
+        s_ibCube = UploadBuffer12(g_mesh.indices, MeshIndexBytes(g_mesh), "PT mesh IB");
+    } else {
+        s_vbCube = UploadBuffer12(meshCube.vertices, meshCube.vertexBytes, "PT cube VB");
+        s_ibCube = UploadBuffer12(meshCube.indices, meshCube.indexBytes, "PT cube IB");
+    }
+    bool tablesOk = RTTablesUpload12(s_rtTables, "PT", s_meshCube ? &g_mesh : nullptr, OBJ_CUBE);
+    s_lightBuffer = UploadBuffer12(s_lights.data(), s_lights.size() * sizeof(PtLight), "PT lights");
+    blueNoise12 = RTBlueNoiseUpload12("PT");
+    bool noiseOk = blueNoise12 || g_rtSampler != RT_SAMPLER_BLUENOISE;
+    if (!UploadFlush12() || !s_vbStatic || !s_ibStatic || !s_vbCube || !s_ibCube || !tablesOk || !noiseOk || !s_lightBuffer) {
+        Log("[ERROR] PT geometry upload failed\n");
+        return false;
+    }
 
-    // Upload buffers
     D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
     D3D12_RESOURCE_DESC bufDesc = {}; bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
     bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
     bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    void* mapped;
-
-    // Static VB/IB
-    UINT vbSizeStatic = s_vertCountStatic * sizeof(PTVert);
-    bufDesc.Width = vbSizeStatic;
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_vbStatic));
-    s_vbStatic->Map(0, nullptr, &mapped); memcpy(mapped, vertsStatic.data(), vbSizeStatic); s_vbStatic->Unmap(0, nullptr);
-
-    UINT ibSizeStatic = s_indCountStatic * sizeof(UINT);
-    bufDesc.Width = ibSizeStatic;
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_ibStatic));
-    s_ibStatic->Map(0, nullptr, &mapped); memcpy(mapped, indsStatic.data(), ibSizeStatic); s_ibStatic->Unmap(0, nullptr);
-
-    // Cube VB/IB
-    UINT vbSizeCube = s_vertCountCube * sizeof(PTVert);
-    bufDesc.Width = vbSizeCube;
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_vbCube));
-    s_vbCube->Map(0, nullptr, &mapped); memcpy(mapped, vertsCube.data(), vbSizeCube); s_vbCube->Unmap(0, nullptr);
-
-    UINT ibSizeCube = s_indCountCube * sizeof(UINT);
-    bufDesc.Width = ibSizeCube;
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_ibCube));
-    s_ibCube->Map(0, nullptr, &mapped); memcpy(mapped, indsCube.data(), ibSizeCube); s_ibCube->Unmap(0, nullptr);
 
     // Also keep vb12/ib12 pointing to static for shader StructuredBuffer access
     vb12 = s_vbStatic;  // Shader reads vertices from here
     ib12 = s_ibStatic;
     totalVertices12 = s_vertCountStatic;
     totalIndices12 = s_indCountStatic;
-
-    // Path tracing constant buffer
-    bufDesc.Width = 256;
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&pathTraceCB));
-    pathTraceCB->Map(0, nullptr, &pathTraceCBMapped);
-    dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&cbUpload12));
-    cbUpload12->Map(0, nullptr, &cbMapped12);
+    vbStride12 = meshStatic.vertexStride;
+    ib16Bit12 = meshStatic.index16;
 
     // Create command list
+    StartupStep("Acceleration structures");
     dev12->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, cmdAlloc[0], nullptr, IID_PPV_ARGS(&cmdList));
     cmdList->QueryInterface(IID_PPV_ARGS(&cmdListRT));
+    StartupGpuTimer12 asTimer;
+    StartupGpuBegin12(asTimer, dev12, cmdQueue, cmdList);
 
     Log("[INFO] Building acceleration structures (2 BLAS + TLAS)...\n");
     D3D12_RESOURCE_DESC asDesc = {}; asDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
@@ -430,11 +1603,11 @@ bool InitD3D12PT(HWND hwnd)
     D3D12_RAYTRACING_GEOMETRY_DESC geomStatic = {};
     geomStatic.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
     geomStatic.Triangles.VertexBuffer.StartAddress = s_vbStatic->GetGPUVirtualAddress();
-    geomStatic.Triangles.VertexBuffer.StrideInBytes = sizeof(PTVert);
+    geomStatic.Triangles.VertexBuffer.StrideInBytes = meshStatic.vertexStride;
     geomStatic.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
     geomStatic.Triangles.VertexCount = s_vertCountStatic;
     geomStatic.Triangles.IndexBuffer = s_ibStatic->GetGPUVirtualAddress();
-    geomStatic.Triangles.IndexFormat = DXGI_FORMAT_R32_UINT;
+    geomStatic.Triangles.IndexFormat = meshStatic.index16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
     geomStatic.Triangles.IndexCount = s_indCountStatic;
     geomStatic.Flags = D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
 
@@ -443,7 +1616,7 @@ bool InitD3D12PT(HWND hwnd)
     blasInputsStatic.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
     blasInputsStatic.NumDescs = 1;
     blasInputsStatic.pGeometryDescs = &geomStatic;
-    blasInputsStatic.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+    blasInputsStatic.Flags = BLAS_STATIC_FLAGS12;
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO prebuildStatic = {};
     dev12RT->GetRaytracingAccelerationStructurePrebuildInfo(&blasInputsStatic, &prebuildStatic);
@@ -454,11 +1627,11 @@ bool InitD3D12PT(HWND hwnd)
     D3D12_RAYTRACING_GEOMETRY_DESC geomCube = {};
     geomCube.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
     geomCube.Triangles.VertexBuffer.StartAddress = s_vbCube->GetGPUVirtualAddress();
-    geomCube.Triangles.VertexBuffer.StrideInBytes = sizeof(PTVert);
+    geomCube.Triangles.VertexBuffer.StrideInBytes = meshCube.vertexStride;
     geomCube.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
     geomCube.Triangles.VertexCount = s_vertCountCube;
     geomCube.Triangles.IndexBuffer = s_ibCube->GetGPUVirtualAddress();
-    geomCube.Triangles.IndexFormat = DXGI_FORMAT_R32_UINT;
+    geomCube.Triangles.IndexFormat = meshCube.index16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
     geomCube.Triangles.IndexCount = s_indCountCube;
     geomCube.Flags = D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
 
@@ -467,7 +1640,7 @@ bool InitD3D12PT(HWND hwnd)
     blasInputsCube.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
     blasInputsCube.NumDescs = 1;
     blasInputsCube.pGeometryDescs = &geomCube;
-    blasInputsCube.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+    blasInputsCube.Flags = BLAS_STATIC_FLAGS12;
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO prebuildCube = {};
     dev12RT->GetRaytracingAccelerationStructurePrebuildInfo(&blasInputsCube, &prebuildCube);
@@ -498,6 +1671,10 @@ bool InitD3D12PT(HWND hwnd)
     cmdListRT->BuildRaytracingAccelerationStructure(&blasBuildCube, 0, nullptr);
     uavBarrier.UAV.pResource = s_blasCube; cmdListRT->ResourceBarrier(1, &uavBarrier);
 
+    // Compact both BLASes while nothing references them yet (see d3d12_blas.cpp)
+    ID3D12Resource** blases[] = { &s_blasStatic, &s_blasCube };
+    bool blasBuilt = CompactBLAS12(dev12RT, cmdQueue, cmdAlloc[0], cmdListRT, blases, 2, "PT");
+
     // ===== INSTANCE BUFFER (2 instances, persistent mapping) =====
     bufDesc.Width = sizeof(D3D12_RAYTRACING_INSTANCE_DESC) * 2;
     bufDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
@@ -509,29 +1686,33 @@ bool InitD3D12PT(HWND hwnd)
     memset(&instances[0], 0, sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
     instances[0].Transform[0][0] = instances[0].Transform[1][1] = instances[0].Transform[2][2] = 1.0f;
     instances[0].InstanceMask = 0xFF;
-    instances[0].InstanceID = 0;
+    instances[0].InstanceID = s_tableBaseStatic;
     instances[0].AccelerationStructure = s_blasStatic->GetGPUVirtualAddress();
     // Instance 1: Cube (will be updated each frame)
     memset(&instances[1], 0, sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
     instances[1].Transform[0][0] = instances[1].Transform[1][1] = instances[1].Transform[2][2] = 1.0f;
     instances[1].InstanceMask = 0xFF;
-    instances[1].InstanceID = 1;
+    instances[1].InstanceID = s_tableBaseCube;
     instances[1].AccelerationStructure = s_blasCube->GetGPUVirtualAddress();
     UpdateCubeTransformPT(0.0f);  // Initial position
 
     // ===== BUILD TLAS =====
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs = {};
-    tlasInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    tlasInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    tlasInputs.NumDescs = 2;
-    tlasInputs.InstanceDescs = s_instanceBuffer->GetGPUVirtualAddress();
-    tlasInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs;
+    TlasInputs12(tlasInputs, 2, s_instanceBuffer->GetGPUVirtualAddress());
+    TlasPolicyInvalidate(s_tlasPolicy);   // First frame rebuilds and records the transforms
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO tlasPrebuild = {};
     dev12RT->GetRaytracingAccelerationStructurePrebuildInfo(&tlasInputs, &tlasPrebuild);
     asDesc.Width = tlasPrebuild.ResultDataMaxSizeInBytes;
     dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc, D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE, nullptr, IID_PPV_ARGS(&s_tlasBuffer));
 
+    // The BLAS builds have finished: swap their scratch for one sized for the TLAS build / refit
+    if (blasBuilt) {
+        s_scratchBuffer->Release();
+        asDesc.Width = TlasScratchSize12(tlasPrebuild);
+        dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&s_scratchBuffer));
+    }
+
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC tlasBuildDesc = {};
     tlasBuildDesc.Inputs = tlasInputs;
     tlasBuildDesc.DestAccelerationStructureData = s_tlasBuffer->GetGPUVirtualAddress();
@@ -540,43 +1721,24 @@ bool InitD3D12PT(HWND hwnd)
     uavBarrier.UAV.pResource = s_tlasBuffer; cmdListRT->ResourceBarrier(1, &uavBarrier);
 
     // Execute and wait
+    StartupGpuEnd12(asTimer, cmdList);
     cmdList->Close();
     ID3D12CommandList* cmdLists[] = { cmdList };
     cmdQueue->ExecuteCommandLists(1, cmdLists);
     WaitForGpu();
+    StartupGpuCollect12(asTimer, "BLAS + TLAS build");
     Log("[INFO] Acceleration structures built (2 BLAS + TLAS with 2 instances)\n");
 
     // Update global pointers for shader access
     tlasBuffer = s_tlasBuffer;
     blasBuffer = s_blasStatic;  // For compatibility
 
-    // ===== CREATE PATH TRACING OUTPUT TEXTURE =====
-    D3D12_RESOURCE_DESC texDesc = {};
-    texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    texDesc.Width = W;
-    texDesc.Height = H;
-    texDesc.DepthOrArraySize = 1;
-    texDesc.MipLevels = 1;
-    texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    texDesc.SampleDesc.Count = 1;
-    texDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-
-    hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
-        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&pathTraceOutput));
-    if (FAILED(hr)) { LogHR("CreatePathTraceOutput", hr); return false; }
-    Log("[INFO] Path trace output texture created\n");
-
-    // Create denoise temp texture (for ping-pong denoising)
-    hr = dev12->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
-        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&denoiseTemp));
-    if (FAILED(hr)) { LogHR("CreateDenoiseTemp", hr); return false; }
-    Log("[INFO] Denoise temp texture created\n");
-
     // ===== CREATE SRV/UAV HEAP FOR PATH TRACING =====
+    StartupStep("Descriptors + targets");
     // Descriptors: 0=TLAS, 1=Vertices, 2=Indices, 3=PT Output UAV
     //              4=PT Output SRV (for denoise read), 5=DenoiseTemp UAV, 6=DenoiseTemp SRV, 7=PT Output UAV (for denoise write back)
     D3D12_DESCRIPTOR_HEAP_DESC srvUavHeapDesc = {};
-    srvUavHeapDesc.NumDescriptors = 16;  // Extra for denoise ping-pong
+    srvUavHeapDesc.NumDescriptors = PT_SRV_UAV_DESCRIPTORS;  // Extra for denoise ping-pong and upscale
     srvUavHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
     srvUavHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
     hr = dev12->CreateDescriptorHeap(&srvUavHeapDesc, IID_PPV_ARGS(&pathTraceSrvUavHeap));
@@ -594,99 +1756,165 @@ bool InitD3D12PT(HWND hwnd)
     tlasSrvDesc.RaytracingAccelerationStructure.Location = tlasBuffer->GetGPUVirtualAddress();
     dev12->CreateShaderResourceView(nullptr, &tlasSrvDesc, heapStart);
 
-    // Descriptor 1: Vertices SRV (t1) - StructuredBuffer<Vertex> (static geometry only)
-    Log("[INFO] Creating descriptor 1: Vertices SRV (stride=%zu, count=%u)\n", sizeof(PTVert), s_vertCountStatic);
-    D3D12_SHADER_RESOURCE_VIEW_DESC verticesSrvDesc = {};
-    verticesSrvDesc.Format = DXGI_FORMAT_UNKNOWN;
-    verticesSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-    verticesSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    verticesSrvDesc.Buffer.FirstElement = 0;
-    verticesSrvDesc.Buffer.NumElements = s_vertCountStatic;
-    verticesSrvDesc.Buffer.StructureByteStride = sizeof(PTVert);
+    // Descriptors 1, 2: Vertices (t1) / Indices (t2) SRVs (static geometry only, in
+    // the --compact-verts layout when enabled; see RTMeshCreateSrvs12)
+    Log("[INFO] Creating descriptors 1-2: Vertices SRV (stride=%u, count=%u), Indices SRV (count=%u, %s)\n",
+        vbStride12, s_vertCountStatic, s_indCountStatic, ib16Bit12 ? "16-bit raw" : "32-bit");
     D3D12_CPU_DESCRIPTOR_HANDLE verticesHandle = heapStart;
     verticesHandle.ptr += srvUavDescSize;
-    dev12->CreateShaderResourceView(s_vbStatic, &verticesSrvDesc, verticesHandle);
-
-    // Descriptor 2: Indices SRV (t2) - StructuredBuffer<uint> (static geometry only)
-    Log("[INFO] Creating descriptor 2: Indices SRV (count=%u)\n", s_indCountStatic);
-    D3D12_SHADER_RESOURCE_VIEW_DESC indicesSrvDesc = {};
-    indicesSrvDesc.Format = DXGI_FORMAT_UNKNOWN;
-    indicesSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-    indicesSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    indicesSrvDesc.Buffer.FirstElement = 0;
-    indicesSrvDesc.Buffer.NumElements = s_indCountStatic;
-    indicesSrvDesc.Buffer.StructureByteStride = sizeof(UINT);
     D3D12_CPU_DESCRIPTOR_HANDLE indicesHandle = heapStart;
     indicesHandle.ptr += 2 * srvUavDescSize;
-    dev12->CreateShaderResourceView(s_ibStatic, &indicesSrvDesc, indicesHandle);
-
-    // Descriptor 3: Output UAV (u0) - RWTexture2D<float4>
-    Log("[INFO] Creating descriptor 3: Output UAV\n");
-    D3D12_UNORDERED_ACCESS_VIEW_DESC outputUavDesc = {};
-    outputUavDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    outputUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
-    D3D12_CPU_DESCRIPTOR_HANDLE outputHandle = heapStart;
-    outputHandle.ptr += 3 * srvUavDescSize;
-    dev12->CreateUnorderedAccessView(pathTraceOutput, nullptr, &outputUavDesc, outputHandle);
-
-    // ===== DENOISE DESCRIPTORS =====
-    // Descriptor 4: PT Output as SRV (for denoise to read)
-    D3D12_SHADER_RESOURCE_VIEW_DESC texSrvDesc = {};
-    texSrvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    texSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    texSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    texSrvDesc.Texture2D.MipLevels = 1;
-    D3D12_CPU_DESCRIPTOR_HANDLE h4 = heapStart;
-    h4.ptr += 4 * srvUavDescSize;
-    dev12->CreateShaderResourceView(pathTraceOutput, &texSrvDesc, h4);
-
-    // Descriptor 5: DenoiseTemp as UAV (for denoise to write)
-    D3D12_CPU_DESCRIPTOR_HANDLE h5 = heapStart;
-    h5.ptr += 5 * srvUavDescSize;
-    dev12->CreateUnorderedAccessView(denoiseTemp, nullptr, &outputUavDesc, h5);
-
-    // Descriptor 6: DenoiseTemp as SRV (for second pass to read)
-    D3D12_CPU_DESCRIPTOR_HANDLE h6 = heapStart;
-    h6.ptr += 6 * srvUavDescSize;
-    dev12->CreateShaderResourceView(denoiseTemp, &texSrvDesc, h6);
-
-    // Descriptor 7: PT Output as UAV again (for second pass to write back)
-    D3D12_CPU_DESCRIPTOR_HANDLE h7 = heapStart;
-    h7.ptr += 7 * srvUavDescSize;
-    dev12->CreateUnorderedAccessView(pathTraceOutput, nullptr, &outputUavDesc, h7);
+    RTMeshCreateSrvs12(dev12, s_vbStatic, s_vertCountStatic, vbStride12, s_ibStatic, s_indCountStatic, ib16Bit12,
+                       verticesHandle, indicesHandle);
+
+    // Descriptors 3-7: output-sized textures (recreated on resize)
+    if (!CreatePathTraceTargets()) return false;
+
+    // Descriptors PT_SCENE_TABLE_SLOT, +1: primitive (t3) and material (t4) tables
+    D3D12_CPU_DESCRIPTOR_HANDLE primitivesHandle = heapStart, materialsHandle = heapStart;
+    primitivesHandle.ptr += PT_SCENE_TABLE_SLOT * srvUavDescSize;
+    materialsHandle.ptr += (PT_SCENE_TABLE_SLOT + 1) * srvUavDescSize;
+    RTTablesCreateSrvs12(dev12, s_rtTables, primitivesHandle, materialsHandle);
+
+    // Descriptor PT_BLUE_NOISE_SLOT: --sampler=bluenoise tile (t0 space1)
+    D3D12_CPU_DESCRIPTOR_HANDLE blueNoiseHandle = heapStart;
+    blueNoiseHandle.ptr += PT_BLUE_NOISE_SLOT * srvUavDescSize;
+    RTBlueNoiseCreateSrv12(dev12, blueNoise12, blueNoiseHandle);
+
+    // Descriptor PT_LIGHT_SLOT: --lights table (t0 space3)
+    D3D12_SHADER_RESOURCE_VIEW_DESC lightSrvDesc = {};
+    lightSrvDesc.Format = DXGI_FORMAT_UNKNOWN;
+    lightSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    lightSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    lightSrvDesc.Buffer.NumElements = (UINT)s_lights.size();
+    lightSrvDesc.Buffer.StructureByteStride = sizeof(PtLight);
+    D3D12_CPU_DESCRIPTOR_HANDLE lightHandle = heapStart;
+    lightHandle.ptr += PT_LIGHT_SLOT * srvUavDescSize;
+    dev12->CreateShaderResourceView(s_lightBuffer, &lightSrvDesc, lightHandle);
+
+    // Descriptor PT_COUNTER_SLOT: adaptive sample counter (u2), null UAV when off
+    D3D12_UNORDERED_ACCESS_VIEW_DESC counterUavDesc = {};
+    counterUavDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    counterUavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+    counterUavDesc.Buffer.NumElements = 1;
+    counterUavDesc.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_RAW;
+    if (g_ptWavefront && g_ptAdaptiveMaxSpp) {
+        Log("[WARN] --adaptive needs the megakernel's per-tile loop, ignored with --wavefront\n");
+        g_ptAdaptiveMaxSpp = 0;
+    }
+    if (g_ptAdaptiveMaxSpp) {
+        D3D12_HEAP_PROPERTIES counterHeap = { D3D12_HEAP_TYPE_DEFAULT };
+        D3D12_HEAP_PROPERTIES readbackHeap = { D3D12_HEAP_TYPE_READBACK };
+        D3D12_RESOURCE_DESC counterDesc = {};
+        counterDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        counterDesc.Width = sizeof(UINT);
+        counterDesc.Height = 1; counterDesc.DepthOrArraySize = 1; counterDesc.MipLevels = 1;
+        counterDesc.SampleDesc.Count = 1; counterDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        counterDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hr = dev12->CreateCommittedResource(&counterHeap, D3D12_HEAP_FLAG_NONE, &counterDesc,
+            D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&s_sampleCounter));
+        if (FAILED(hr)) { LogHR("CreateSampleCounter", hr); return false; }
+        counterDesc.Width = sizeof(UINT) * FRAME_COUNT;
+        counterDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hr = dev12->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &counterDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&s_sampleReadback));
+        if (FAILED(hr)) { LogHR("CreateSampleReadback", hr); return false; }
+        s_sampleReadback->Map(0, nullptr, (void**)&s_sampleReadbackMapped);   // Persistent map
+        Log("[INFO] Adaptive sampling: %u-%u SPP per 8x8 tile, error target %.4f\n",
+            g_ptSpp > 2 ? g_ptSpp : 2, g_ptAdaptiveMaxSpp, g_ptAdaptiveTarget);
+    }
+    D3D12_CPU_DESCRIPTOR_HANDLE counterHandle = heapStart;
+    counterHandle.ptr += PT_COUNTER_SLOT * srvUavDescSize;
+    dev12->CreateUnorderedAccessView(s_sampleCounter, nullptr, &counterUavDesc, counterHandle);
 
     Log("[INFO] Path tracing and denoise descriptors created\n");
 
     // ===== CREATE PATH TRACING ROOT SIGNATURE =====
+    StartupStep("Path trace pipeline");
     // Root parameters:
     // 0: CBV (b0) - PathTraceCB
-    // 1: Descriptor table (t0: TLAS, t1: Normals, t2: Indices, u0: Output)
-
-    D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+    // 1: Descriptor table (t0: TLAS, t1: Vertices, t2: Indices; t3: Primitives, t4: Materials at PT_SCENE_TABLE_SLOT;
+    //    t0 space1: blue noise at PT_BLUE_NOISE_SLOT; t0 space3: lights at PT_LIGHT_SLOT)
+    // 2: Descriptor table (u0: Output) - slot 3, or back buffer slot 8+i with --zero-copy
+    // 3: Descriptor table (u1: AccumSum, u2: SampleCounter; u0 space3: reservoirs) - slots PT_ACCUM_SLOT,
+    //    PT_COUNTER_SLOT, PT_RESERVOIR_SLOT
+    // 4: Root UAV (u0 space2: ray counters) - only with --ray-stats
+
+    // --ray-stats: the megakernel counts its rays, the wavefront stages do not
+    if (g_rayStats && g_ptWavefront)
+        Log("[INFO] --ray-stats: not counted by the wavefront kernels, use the megakernel\n");
+    else
+        InitRayCounters12(dev12);
+    bool rayStats = RayCountersAddress12() != 0;
+
+    D3D12_DESCRIPTOR_RANGE ranges[7] = {};
     // SRVs: t0=TLAS, t1=Vertices, t2=Indices
     ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
     ranges[0].NumDescriptors = 3;
     ranges[0].BaseShaderRegister = 0;
     ranges[0].OffsetInDescriptorsFromTableStart = 0;
+    // SRVs: t3=Primitives, t4=Materials (same table, further into the heap)
+    ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[1].NumDescriptors = 2;
+    ranges[1].BaseShaderRegister = 3;
+    ranges[1].OffsetInDescriptorsFromTableStart = PT_SCENE_TABLE_SLOT;
+    // SRV: t0 space1=BlueNoise (--sampler=bluenoise)
+    ranges[2].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[2].NumDescriptors = 1;
+    ranges[2].BaseShaderRegister = 0;
+    ranges[2].RegisterSpace = 1;
+    ranges[2].OffsetInDescriptorsFromTableStart = PT_BLUE_NOISE_SLOT;
+    // SRV: t0 space3=Lights (--lights)
+    ranges[3].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[3].NumDescriptors = 1;
+    ranges[3].BaseShaderRegister = 0;
+    ranges[3].RegisterSpace = 3;
+    ranges[3].OffsetInDescriptorsFromTableStart = PT_LIGHT_SLOT;
     // UAVs: u0=Output
-    ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
-    ranges[1].NumDescriptors = 1;
-    ranges[1].BaseShaderRegister = 0;
-    ranges[1].OffsetInDescriptorsFromTableStart = 3;  // After 3 SRVs
-
-    D3D12_ROOT_PARAMETER rootParams[2] = {};
+    ranges[4].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    ranges[4].NumDescriptors = 1;
+    ranges[4].BaseShaderRegister = 0;
+    ranges[4].OffsetInDescriptorsFromTableStart = 0;  // Own table
+    // UAVs: u1=AccumSum, u2=SampleCounter
+    ranges[5].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    ranges[5].NumDescriptors = 2;
+    ranges[5].BaseShaderRegister = 1;
+    ranges[5].OffsetInDescriptorsFromTableStart = 0;
+    // UAV: u0 space3=Reservoirs (--light-sampling=restir), relative to PT_ACCUM_SLOT
+    ranges[6].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    ranges[6].NumDescriptors = 1;
+    ranges[6].BaseShaderRegister = 0;
+    ranges[6].RegisterSpace = 3;
+    ranges[6].OffsetInDescriptorsFromTableStart = PT_RESERVOIR_SLOT - PT_ACCUM_SLOT;
+
+    D3D12_ROOT_PARAMETER rootParams[5] = {};
     // CBV at root parameter 0
     rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     rootParams[0].Descriptor.ShaderRegister = 0;
     rootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
     // Descriptor table at root parameter 1
     rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    rootParams[1].DescriptorTable.NumDescriptorRanges = 2;
-    rootParams[1].DescriptorTable.pDescriptorRanges = ranges;
+    rootParams[1].DescriptorTable.NumDescriptorRanges = 4;
+    rootParams[1].DescriptorTable.pDescriptorRanges = &ranges[0];
     rootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    // Output UAV table at root parameter 2
+    rootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParams[2].DescriptorTable.NumDescriptorRanges = 1;
+    rootParams[2].DescriptorTable.pDescriptorRanges = &ranges[4];
+    rootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    // Accumulation sum table at root parameter 3
+    rootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParams[3].DescriptorTable.NumDescriptorRanges = 2;
+    rootParams[3].DescriptorTable.pDescriptorRanges = &ranges[5];
+    rootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    // --ray-stats counters (root UAV u0 space2) at root parameter 4
+    rootParams[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    rootParams[4].Descriptor.ShaderRegister = 0;
+    rootParams[4].Descriptor.RegisterSpace = 2;
+    rootParams[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
     D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
-    rsDesc.NumParameters = 2;
+    rsDesc.NumParameters = rayStats ? 5 : 4;
     rsDesc.pParameters = rootParams;
     rsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
 
@@ -702,59 +1930,22 @@ bool InitD3D12PT(HWND hwnd)
     Log("[INFO] Path tracing root signature created\n");
 
     // ===== COMPILE PATH TRACING COMPUTE SHADER =====
-    Log("[INFO] Compiling path tracing compute shader with DXC...\n");
-
-    if (!g_dxcModule) {
-        g_dxcModule = LoadLibraryW(L"dxcompiler.dll");
-        if (!g_dxcModule) {
-            Log("[ERROR] Failed to load dxcompiler.dll!\n");
-            return false;
-        }
-        g_DxcCreateInstance = (DxcCreateInstanceProc)GetProcAddress(g_dxcModule, "DxcCreateInstance");
-        if (!g_DxcCreateInstance) { FreeLibrary(g_dxcModule); g_dxcModule = nullptr; return false; }
-        Log("[INFO] DXC loaded\n");
-    }
-
-    IDxcUtils* dxcUtils = nullptr;
-    IDxcCompiler3* dxcCompiler = nullptr;
-    g_DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxcUtils));
-    g_DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxcCompiler));
-
-    IDxcBlobEncoding* srcBlob = nullptr;
-    dxcUtils->CreateBlob(g_ptShaderCode, (UINT)strlen(g_ptShaderCode), CP_UTF8, &srcBlob);
-    DxcBuffer srcBuf = { srcBlob->GetBufferPointer(), srcBlob->GetBufferSize(), 0 };
-
-    // Compile with cs_6_5 for RayQuery support
-    LPCWSTR csArgs[] = { L"-E", L"PathTraceCS", L"-T", L"cs_6_5", L"-Zi", L"-Od" };
-
-    IDxcResult* csRes = nullptr;
-    hr = dxcCompiler->Compile(&srcBuf, csArgs, _countof(csArgs), nullptr, IID_PPV_ARGS(&csRes));
-
-    HRESULT csStatus;
-    csRes->GetStatus(&csStatus);
-
-    if (FAILED(csStatus)) {
-        IDxcBlobUtf8* err = nullptr;
-        csRes->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&err), nullptr);
-        Log("[CS ERROR] %s\n", err->GetStringPointer());
-        err->Release();
-        srcBlob->Release(); csRes->Release(); dxcCompiler->Release(); dxcUtils->Release();
-        return false;
-    }
-
-    IDxcBlob* csBlob = nullptr;
-    csRes->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&csBlob), nullptr);
-    Log("[INFO] Path tracing compute shader compiled (size: %zu)\n", csBlob->GetBufferSize());
-
-    srcBlob->Release(); csRes->Release();
-    dxcCompiler->Release(); dxcUtils->Release();
+    // cs_6_5 for RayQuery support; DXIL/PSO come from the shader cache on warm starts
+    PipelineCacheOpen(dev12);
+    // The group shape, --sampler and --ray-stats snippets go first, RT_SAMPLER
+    // picks the sampler and RAY_STATS (last two args) turns the counters on
+    std::string csSource = std::string(g_groupShapeShaderCode) + g_rtSamplingShaderCode + g_rayStatsShaderCode + g_ptShaderCode;
+    LPCWSTR csArgs[] = { L"-E", L"PathTraceCS", L"-T", L"cs_6_5", L"-Zi", L"-Od", L"-D", RtSamplerDefine(), L"-D", L"RAY_STATS" };
+    UINT csArgCount = _countof(csArgs) - (rayStats ? 0 : 2);
+    ID3DBlob* csBlob = nullptr;
+    if (!CompileDXC(csSource.c_str(), csArgs, csArgCount, &csBlob, "PathTraceCS")) return false;
 
     // ===== CREATE PATH TRACING COMPUTE PSO =====
     D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
     psoDesc.pRootSignature = pathTraceRootSig;
     psoDesc.CS = { csBlob->GetBufferPointer(), csBlob->GetBufferSize() };
 
-    hr = dev12->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(&pathTracePSO));
+    hr = PipelineCacheCreateCompute(dev12, L"PathTraceCS", psoDesc, &pathTracePSO);
     csBlob->Release();
 
     if (FAILED(hr)) {
@@ -781,9 +1972,34 @@ bool InitD3D12PT(HWND hwnd)
     }
     Log("[INFO] Path tracing compute PSO created\n");
 
+    if (g_ptWavefront) {
+        StartupStep("Wavefront pipelines");
+        if (!InitWavefront()) return false;
+    }
+
+    // --split-gpu: the second device gets the same shader, without RAY_STATS
+    s_split.adapterIndex = PickSplitAdapter();
+    if (s_split.adapterIndex >= 0) StartupStep("Split GPU");
+    if (s_split.adapterIndex >= 0 &&
+        !InitSplitGpu(meshStatic, meshCube, csSource, csArgs, _countof(csArgs) - 2, rsDesc)) {
+        Log("[WARN] --split-gpu: second adapter unavailable, tracing on one GPU\n");
+        CleanupSplitGpu();
+    }
+
+    // --group-size variants of the megakernel. Not with --split-gpu: splitRow is
+    // aligned to PT_SPLIT_ROW_ALIGN, and a group height that doesn't divide it
+    // would trace rows of the secondary's band on this device as well
+    if (g_settings.renderer == RENDERER_D3D12_PT && !g_ptWavefront && !s_split.device) {
+        UINT mask = GroupTuneBegin12(dev12, GROUP_KERNEL_PT_TRACE);
+        GroupCreateVariants12(dev12, GROUP_KERNEL_PT_TRACE, mask, csSource.c_str(), csArgs, csArgCount,
+                              pathTraceRootSig, pathTracePSO, s_traceVariants);
+    }
+
     // ===== CREATE DENOISE ROOT SIGNATURE =====
-    // Root params: 0=CBV (DenoiseCB), 1=SRV (input texture), 2=UAV (output texture)
-    D3D12_ROOT_PARAMETER denoiseRootParams[3] = {};
+    StartupStep("Denoise + upscale pipelines");
+    // Root params: 0=CBV (DenoiseCB), 1=SRV (input texture), 2=UAV (output texture),
+    // 3=UAV (temporal history, TemporalCS only)
+    D3D12_ROOT_PARAMETER denoiseRootParams[4] = {};
     denoiseRootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     denoiseRootParams[0].Descriptor.ShaderRegister = 0;
     denoiseRootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
@@ -806,8 +2022,17 @@ bool InitD3D12PT(HWND hwnd)
     denoiseRootParams[2].DescriptorTable.pDescriptorRanges = &denoiseUavRange;
     denoiseRootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
+    D3D12_DESCRIPTOR_RANGE historyUavRange = {};
+    historyUavRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    historyUavRange.NumDescriptors = 1;
+    historyUavRange.BaseShaderRegister = 1;
+    denoiseRootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    denoiseRootParams[3].DescriptorTable.NumDescriptorRanges = 1;
+    denoiseRootParams[3].DescriptorTable.pDescriptorRanges = &historyUavRange;
+    denoiseRootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
     D3D12_ROOT_SIGNATURE_DESC denoiseRsDesc = {};
-    denoiseRsDesc.NumParameters = 3;
+    denoiseRsDesc.NumParameters = 4;
     denoiseRsDesc.pParameters = denoiseRootParams;
 
     sigBlob = nullptr; errBlob = nullptr;
@@ -822,54 +2047,61 @@ bool InitD3D12PT(HWND hwnd)
     Log("[INFO] Denoise root signature created\n");
 
     // ===== COMPILE DENOISE SHADER =====
-    Log("[INFO] Compiling denoise compute shader...\n");
-    IDxcBlobEncoding* denoiseSrcBlob = nullptr;
-    dxcUtils = nullptr; dxcCompiler = nullptr;
-    g_DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxcUtils));
-    g_DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxcCompiler));
-
-    dxcUtils->CreateBlob(g_ptDenoiseShaderCode, (UINT)strlen(g_ptDenoiseShaderCode), CP_UTF8, &denoiseSrcBlob);
-    DxcBuffer denoiseSrcBuf = { denoiseSrcBlob->GetBufferPointer(), denoiseSrcBlob->GetBufferSize(), 0 };
-
+    std::string denoiseSource = std::string(g_groupShapeShaderCode) + g_ptDenoiseShaderCode;
     LPCWSTR denoiseArgs[] = { L"-E", L"DenoiseCS", L"-T", L"cs_6_0" };
-    IDxcResult* denoiseRes = nullptr;
-    hr = dxcCompiler->Compile(&denoiseSrcBuf, denoiseArgs, _countof(denoiseArgs), nullptr, IID_PPV_ARGS(&denoiseRes));
-
-    HRESULT denoiseStatus;
-    denoiseRes->GetStatus(&denoiseStatus);
-    if (FAILED(denoiseStatus)) {
-        IDxcBlobUtf8* err = nullptr;
-        denoiseRes->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&err), nullptr);
-        Log("[DENOISE CS ERROR] %s\n", err->GetStringPointer());
-        err->Release();
-        denoiseSrcBlob->Release(); denoiseRes->Release(); dxcCompiler->Release(); dxcUtils->Release();
-        return false;
-    }
-
-    IDxcBlob* denoiseBlob = nullptr;
-    denoiseRes->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&denoiseBlob), nullptr);
-    Log("[INFO] Denoise shader compiled (size: %zu)\n", denoiseBlob->GetBufferSize());
-
-    denoiseSrcBlob->Release(); denoiseRes->Release();
-    dxcCompiler->Release(); dxcUtils->Release();
+    ID3DBlob* denoiseBlob = nullptr;
+    if (!CompileDXC(denoiseSource.c_str(), denoiseArgs, _countof(denoiseArgs), &denoiseBlob, "DenoiseCS")) return false;
 
     // ===== CREATE DENOISE PSO =====
     D3D12_COMPUTE_PIPELINE_STATE_DESC denoisePsoDesc = {};
     denoisePsoDesc.pRootSignature = denoiseRootSig;
     denoisePsoDesc.CS = { denoiseBlob->GetBufferPointer(), denoiseBlob->GetBufferSize() };
 
-    hr = dev12->CreateComputePipelineState(&denoisePsoDesc, IID_PPV_ARGS(&denoisePSO));
+    hr = PipelineCacheCreateCompute(dev12, L"DenoiseCS", denoisePsoDesc, &denoisePSO);
     denoiseBlob->Release();
     if (FAILED(hr)) { LogHR("CreateDenoisePSO", hr); return false; }
     Log("[INFO] Denoise PSO created\n");
 
-    // ===== CREATE DENOISE CONSTANT BUFFER =====
-    bufDesc.Width = 256;
-    hr = dev12->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&denoiseCB));
-    if (FAILED(hr)) { LogHR("CreateDenoiseCB", hr); return false; }
-    denoiseCB->Map(0, nullptr, &denoiseCBMapped);
-    Log("[INFO] Denoise constant buffer created\n");
+    // ===== COMPILE TEMPORAL DENOISE SHADER + PSO =====
+    // Per-pass constants come from g_frameRing12 (one DenoiseCB per iteration)
+    LPCWSTR temporalArgs[] = { L"-E", L"TemporalCS", L"-T", L"cs_6_0" };
+    ID3DBlob* temporalBlob = nullptr;
+    if (!CompileDXC(denoiseSource.c_str(), temporalArgs, _countof(temporalArgs), &temporalBlob, "TemporalCS")) return false;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC temporalPsoDesc = {};
+    temporalPsoDesc.pRootSignature = denoiseRootSig;
+    temporalPsoDesc.CS = { temporalBlob->GetBufferPointer(), temporalBlob->GetBufferSize() };
+    hr = PipelineCacheCreateCompute(dev12, L"TemporalCS", temporalPsoDesc, &s_temporalPSO);
+    temporalBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateTemporalPSO", hr); return false; }
+    Log("[INFO] Temporal denoise PSO created\n");
+
+    // --group-size variants of the denoise chain (the DLSS renderer doesn't denoise)
+    if (g_settings.renderer == RENDERER_D3D12_PT) {
+        UINT mask = GroupTuneBegin12(dev12, GROUP_KERNEL_PT_DENOISE);
+        GroupCreateVariants12(dev12, GROUP_KERNEL_PT_DENOISE, mask, denoiseSource.c_str(), denoiseArgs, _countof(denoiseArgs),
+                              denoiseRootSig, denoisePSO, s_denoiseVariants);
+        GroupCreateVariants12(dev12, GROUP_KERNEL_PT_DENOISE, mask, denoiseSource.c_str(), temporalArgs, _countof(temporalArgs),
+                              denoiseRootSig, s_temporalPSO, s_temporalVariants);
+    }
+
+    // ===== COMPILE UPSCALE + SHARPEN SHADERS (--render-scale) =====
+    if (g_renderScalePct < 100) {
+        const char* upscaleEntries[2] = { "UpscaleCS", "SharpenCS" };
+        LPCWSTR upscaleEntriesW[2] = { L"UpscaleCS", L"SharpenCS" };
+        ID3D12PipelineState** upscalePSOs[2] = { &s_upscalePSO, &s_sharpenPSO };
+        for (int i = 0; i < 2; i++) {
+            LPCWSTR upscaleArgs[] = { L"-E", upscaleEntriesW[i], L"-T", L"cs_6_0" };
+            ID3DBlob* upscaleBlob = nullptr;
+            if (!CompileDXC(g_ptUpscaleShaderCode, upscaleArgs, _countof(upscaleArgs), &upscaleBlob, upscaleEntries[i])) return false;
+            D3D12_COMPUTE_PIPELINE_STATE_DESC upscalePsoDesc = {};
+            upscalePsoDesc.pRootSignature = denoiseRootSig;
+            upscalePsoDesc.CS = { upscaleBlob->GetBufferPointer(), upscaleBlob->GetBufferSize() };
+            hr = PipelineCacheCreateCompute(dev12, upscaleEntriesW[i], upscalePsoDesc, upscalePSOs[i]);
+            upscaleBlob->Release();
+            if (FAILED(hr)) { LogHR("CreateUpscalePSO", hr); return false; }
+        }
+        Log("[INFO] Upscale + sharpen PSOs created\n");
+    }
 
     // Reset command list for rendering
     cmdAlloc[0]->Reset();
@@ -877,50 +2109,142 @@ bool InitD3D12PT(HWND hwnd)
     cmdList->Close();
 
     // Initialize text rendering (shared with base D3D12 renderer)
-    if (!InitGPUText12()) {
+    StartupStep("Overlay + timers");
+    if (!Overlay12Init(g_overlay12, dev12, DXGI_FORMAT_R8G8B8A8_UNORM, "D3D12 PT")) {
         Log("[ERROR] Failed to initialize text rendering for Path Tracing!\n");
         return false;
     }
 
+    // GPU pass timings (optional - overlay/report just omit them on failure)
+    InitGpuTimer12(dev12, cmdQueue);
+
+    VramSetCategories(VramCategoriesPT);
     Log("[INFO] D3D12 + Path Tracing initialization complete\n");
     return true;
 }
 
+// ============== ADAPTIVE SAMPLE COUNT ==============
+// Value the counter had after the frame last recorded in this slot; slots
+// complete in submission order, so consecutive reads differ by one frame.
+static void CollectSampleCount()
+{
+    if (!s_sampleReadbackPending[frameIndex]) return;
+    s_sampleReadbackPending[frameIndex] = false;
+    UINT count = s_sampleReadbackMapped[frameIndex];
+    UINT frameSamples = count - s_lastSampleCount;   // Wraps like the GPU counter
+    s_lastSampleCount = count;
+    s_frameAvgSpp = (float)((double)frameSamples / ((double)s_traceW * s_traceH));
+    s_adaptiveSamples += s_frameAvgSpp;
+    s_adaptiveFrames++;
+}
+
+float D3D12PTAverageSpp()
+{
+    return s_adaptiveFrames ? (float)(s_adaptiveSamples / s_adaptiveFrames) : (float)g_ptSpp;
+}
+
+// ============== WAVEFRONT DISPATCH ==============
+// Null UAV barrier between dependent stages, with the indirect args moved
+// between UNORDERED_ACCESS (PrepareArgsCS) and INDIRECT_ARGUMENT when asked
+static void WavefrontBarrier(D3D12_RESOURCE_STATES argsBefore, D3D12_RESOURCE_STATES argsAfter)
+{
+    D3D12_RESOURCE_BARRIER b[2] = {};
+    b[0].Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    b[1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    b[1].Transition.pResource = s_wfBuffers[WF_RP_ARGS - WF_RP_PATHS];
+    b[1].Transition.StateBefore = argsBefore;
+    b[1].Transition.StateAfter = argsAfter;
+    b[1].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    cmdList->ResourceBarrier(argsBefore != argsAfter ? 2 : 1, b);
+}
+
+// PrepareArgsCS for the stage, then the queue kernels it sized
+static void WavefrontStage(UINT bounce, UINT stage, UINT firstArg, UINT argCount)
+{
+    UINT consts[3] = { bounce, 0, stage };
+    cmdList->SetComputeRoot32BitConstants(WF_RP_CONSTANTS, 3, consts, 0);
+    cmdList->SetPipelineState(s_wfPreparePSO);
+    cmdList->Dispatch(1, 1, 1);
+    WavefrontBarrier(D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+
+    // The shade kernels write disjoint paths, so they overlap without barriers
+    ID3D12Resource* args = s_wfBuffers[WF_RP_ARGS - WF_RP_PATHS];
+    for (UINT a = firstArg; a < firstArg + argCount; a++) {
+        cmdList->SetPipelineState(s_wfIndirectPSO[a]);
+        cmdList->ExecuteIndirect(s_wfDispatchSig, 1, args, a * sizeof(D3D12_DISPATCH_ARGUMENTS), nullptr, 0);
+    }
+    WavefrontBarrier(D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+}
+
+// Records the whole frame's trace: --spp generate + g_ptMaxBounces rounds of
+// extend / shade / shadow, then the resolve into u0 (and u1 with --accumulate)
+static void RecordWavefront(D3D12_GPU_VIRTUAL_ADDRESS cbGpu, D3D12_GPU_DESCRIPTOR_HANDLE sceneTable,
+    D3D12_GPU_DESCRIPTOR_HANDLE outputTable, D3D12_GPU_DESCRIPTOR_HANDLE accumTable)
+{
+    D3D12_RESOURCE_BARRIER toUav[WF_BUFFER_COUNT] = {};
+    for (UINT i = 0; i < WF_BUFFER_COUNT; i++) {
+        toUav[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        toUav[i].Transition.pResource = s_wfBuffers[i];
+        toUav[i].Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+        toUav[i].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        toUav[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    }
+    cmdList->ResourceBarrier(WF_BUFFER_COUNT, toUav);
+
+    cmdList->SetComputeRootSignature(s_wfRootSig);
+    cmdList->SetComputeRootConstantBufferView(WF_RP_CB, cbGpu);
+    cmdList->SetComputeRootDescriptorTable(WF_RP_SCENE, sceneTable);
+    cmdList->SetComputeRootDescriptorTable(WF_RP_OUTPUT, outputTable);
+    cmdList->SetComputeRootDescriptorTable(WF_RP_ACCUM, accumTable);
+    for (UINT i = 0; i < WF_BUFFER_COUNT; i++)
+        cmdList->SetComputeRootUnorderedAccessView(WF_RP_PATHS + i, s_wfBuffers[i]->GetGPUVirtualAddress());
+
+    UINT groupsX = (s_traceW + 7) / 8;
+    UINT groupsY = (s_traceH + 7) / 8;
+    for (UINT sample = 0; sample < g_ptSpp; sample++) {
+        UINT consts[3] = { 0, sample, 0 };
+        cmdList->SetComputeRoot32BitConstants(WF_RP_CONSTANTS, 3, consts, 0);
+        cmdList->SetPipelineState(s_wfGeneratePSO);
+        cmdList->Dispatch(groupsX, groupsY, 1);
+        WavefrontBarrier(D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+        for (UINT bounce = 0; bounce < g_ptMaxBounces; bounce++) {
+            WavefrontStage(bounce, WF_STAGE_EXTEND, WF_ARG_EXTEND, 1);
+            WavefrontStage(bounce, WF_STAGE_SHADE, WF_ARG_DIFFUSE, 3);
+            WavefrontStage(bounce, WF_STAGE_SHADOW, WF_ARG_SHADOW, 1);
+        }
+    }
+
+    cmdList->SetPipelineState(s_wfResolvePSO);
+    cmdList->Dispatch(groupsX, groupsY, 1);
+}
+
 // ============== RENDER ==============
 void RenderD3D12PT()
 {
+    DxgiWaitFrameLatency(swapWaitable12);
+
+    // Timestamps from the last use of this frame slot are complete by now
+    GpuTimerCollect12(frameIndex);
+    RayCountersCollect12(frameIndex);
+    Capture12Collect(frameIndex);
+    CollectSampleCount();
+
     cmdAlloc[frameIndex]->Reset();
     cmdList->Reset(cmdAlloc[frameIndex], nullptr);  // Start with no PSO - we'll set compute PSO later
+    GpuTimerBegin12(cmdList, frameIndex);
 
-    // Update constant buffer
-    LARGE_INTEGER nowTime;
-    QueryPerformanceCounter(&nowTime);
-    float t = (float)(nowTime.QuadPart - g_startTime.QuadPart) / g_perfFreq.QuadPart;
+    // Update constant buffer (animation time stops while paused, see accumulation.h)
+    float t = AnimationTime();
+    UINT accumFrame = AccumFrameBegin(t, s_traceW, s_traceH, g_ptSpp);
+    // The accumulated reference image is never filtered
+    bool denoise = g_denoiseMode != DENOISE_OFF && accumFrame == 0;
+    bool temporal = denoise && g_denoiseMode == DENOISE_TEMPORAL;
 
     // ===== UPDATE CUBE TRANSFORM AND REBUILD TLAS =====
     UpdateCubeTransformPT(t);
-
-    // Rebuild TLAS with updated instance transform (using UPDATE flag for fast rebuild)
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs = {};
-    tlasInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    tlasInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    tlasInputs.NumDescs = 2;
-    tlasInputs.InstanceDescs = s_instanceBuffer->GetGPUVirtualAddress();
-    tlasInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD |
-                       D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE |
-                       D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
-
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC tlasBuildDesc = {};
-    tlasBuildDesc.Inputs = tlasInputs;
-    tlasBuildDesc.DestAccelerationStructureData = s_tlasBuffer->GetGPUVirtualAddress();
-    tlasBuildDesc.SourceAccelerationStructureData = s_tlasBuffer->GetGPUVirtualAddress();  // Update in place
-    tlasBuildDesc.ScratchAccelerationStructureData = s_scratchBuffer->GetGPUVirtualAddress();
-    cmdListRT->BuildRaytracingAccelerationStructure(&tlasBuildDesc, 0, nullptr);
-
-    D3D12_RESOURCE_BARRIER uavBarrier = {};
-    uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-    uavBarrier.UAV.pResource = s_tlasBuffer;
-    cmdListRT->ResourceBarrier(1, &uavBarrier);
+    RebuildTLAS_PT(cmdListRT);
+    GpuTimerStamp12(cmdList, frameIndex, "TLAS");
 
     // Build inverse matrices for camera (looking at room from outside)
     XMMATRIX view = XMMatrixLookAtLH(
@@ -937,61 +2261,315 @@ void RenderD3D12PT()
     XMStoreFloat4x4(&cbData.InvProj, XMMatrixTranspose(invProj));
     cbData.Time = t;
     cbData.FrameCount = g_frameCount++;
-    cbData.Width = W;
-    cbData.Height = H;
-    memcpy(pathTraceCBMapped, &cbData, sizeof(cbData));
-
-    // Also update regular CB for text rendering
-    CB textCbData = { t };
-    memcpy(cbMapped12, &textCbData, sizeof(CB));
+    cbData.Width = s_traceW;
+    cbData.Height = s_traceH;
+    cbData.AccumFrame = accumFrame;
+    cbData.SamplesPerPixel = g_ptSpp;
+    cbData.MaxBounces = g_ptMaxBounces;
+    cbData.AdaptiveMaxSpp = g_ptAdaptiveMaxSpp;
+    cbData.AdaptiveTarget = g_ptAdaptiveTarget;
+    cbData.LightCount = (UINT)s_lights.size();
+    cbData.LightSampling = (UINT)g_ptLightSampling;
+    cbData.RowOffset = 0;
+    D3D12_GPU_VIRTUAL_ADDRESS cbGpu = FrameRingPush12(g_frameRing12, &cbData, sizeof(cbData), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+    // --split-gpu: the lower band is already running on the second GPU while
+    // this list is recorded
+    bool split = s_split.device != nullptr;
+    if (split) {
+        SplitRebalance(accumFrame);
+        SplitSubmit(cbData);
+    }
 
     // ===== PATH TRACING DISPATCH =====
-    cmdList->SetPipelineState(pathTracePSO);
+    RayCountersBegin12(cmdList);
+    UINT traceVariant = GroupTuneSelect(GROUP_KERNEL_PT_TRACE, frameIndex);
+    ID3D12PipelineState* tracePSO = s_traceVariants[traceVariant] ? s_traceVariants[traceVariant] : pathTracePSO;
+    const GroupShape& traceShape = GroupVariant(s_traceVariants[traceVariant] ? traceVariant : GROUP_VARIANT_DEFAULT);
+    cmdList->SetPipelineState(tracePSO);
     cmdList->SetComputeRootSignature(pathTraceRootSig);
-    cmdList->SetComputeRootConstantBufferView(0, pathTraceCB->GetGPUVirtualAddress());
+    cmdList->SetComputeRootConstantBufferView(0, cbGpu);
 
     ID3D12DescriptorHeap* heaps[] = { pathTraceSrvUavHeap };
     cmdList->SetDescriptorHeaps(1, heaps);
-    cmdList->SetComputeRootDescriptorTable(1, pathTraceSrvUavHeap->GetGPUDescriptorHandleForHeapStart());
+    D3D12_GPU_DESCRIPTOR_HANDLE ptTable = pathTraceSrvUavHeap->GetGPUDescriptorHandleForHeapStart();
+    UINT srvUavDescSize = dev12->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    // Zero-copy with denoising or upscaling: trace into pathTraceOutput, the
+    // last pass writes the back buffer
+    D3D12_GPU_DESCRIPTOR_HANDLE outputTable = ptTable;
+    outputTable.ptr += (s_zeroCopy && !denoise && !s_upscale ? 8 + frameIndex : 3) * srvUavDescSize;
+    D3D12_GPU_DESCRIPTOR_HANDLE accumTable = ptTable;
+    accumTable.ptr += PT_ACCUM_SLOT * srvUavDescSize;
+    cmdList->SetComputeRootDescriptorTable(1, ptTable);
+    cmdList->SetComputeRootDescriptorTable(2, outputTable);
+    cmdList->SetComputeRootDescriptorTable(3, accumTable);
+    if (RayCountersAddress12()) cmdList->SetComputeRootUnorderedAccessView(4, RayCountersAddress12());
+
+    // The previous frame's dispatch wrote the sum this one reads
+    if (s_accumSum) {
+        D3D12_RESOURCE_BARRIER accumBarrier = {};
+        accumBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+        accumBarrier.UAV.pResource = s_accumSum;
+        cmdList->ResourceBarrier(1, &accumBarrier);
+    }
 
-    // Dispatch compute shader (8x8 thread groups)
-    UINT groupsX = (W + 7) / 8;
-    UINT groupsY = (H + 7) / 8;
-    cmdList->Dispatch(groupsX, groupsY, 1);
+    if (s_sampleCounter) {
+        D3D12_RESOURCE_BARRIER counterBarrier = {};
+        counterBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        counterBarrier.Transition.pResource = s_sampleCounter;
+        counterBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+        counterBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        counterBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        cmdList->ResourceBarrier(1, &counterBarrier);
+    }
 
-    // ===== COPY RAW PATH TRACED OUTPUT TO BACKBUFFER (no denoising) =====
-    D3D12_RESOURCE_BARRIER barriers[2] = {};
-    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barriers[0].Transition.pResource = renderTargets12[frameIndex];
-    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
-    barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    // Zero-copy: the back buffer itself is the UAV target
+    D3D12_RESOURCE_BARRIER bbBarrier = {};
+    bbBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    bbBarrier.Transition.pResource = renderTargets12[frameIndex];
+    bbBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+    bbBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    bbBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    if (s_zeroCopy) cmdList->ResourceBarrier(1, &bbBarrier);
+
+    // Dispatch compute shader (8x8 thread groups unless --group-size), or the --wavefront stages
+    UINT groupsX = (s_traceW + traceShape.x - 1) / traceShape.x;
+    UINT groupsY = (s_traceH + traceShape.y - 1) / traceShape.y;
+    if (g_ptWavefront) RecordWavefront(cbGpu, ptTable, outputTable, accumTable);
+    else cmdList->Dispatch(groupsX, split ? (s_split.splitRow + traceShape.y - 1) / traceShape.y : groupsY, 1);
+    GpuTimerStamp12(cmdList, frameIndex, "Trace");
+    RayCountersEnd12(cmdList, frameIndex);
+
+    // Sample count for the overlay, read back FRAME_COUNT frames later (the
+    // buffer decays back to COMMON at the end of the submit)
+    if (s_sampleCounter) {
+        D3D12_RESOURCE_BARRIER counterBarrier = {};
+        counterBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        counterBarrier.Transition.pResource = s_sampleCounter;
+        counterBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        counterBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        counterBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        cmdList->ResourceBarrier(1, &counterBarrier);
+        cmdList->CopyBufferRegion(s_sampleReadback, frameIndex * sizeof(UINT), s_sampleCounter, 0, sizeof(UINT));
+        s_sampleReadbackPending[frameIndex] = true;
+    }
 
-    barriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barriers[1].Transition.pResource = pathTraceOutput;
-    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
-    barriers[1].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    cmdList->ResourceBarrier(2, barriers);
+    // The lower band joins the trace target before anything reads the full image
+    if (split) SplitComposite(s_zeroCopy && !denoise && !s_upscale ? renderTargets12[frameIndex] : pathTraceOutput);
+
+    // ===== DENOISE CHAIN =====
+    // Ping-pong between pathTraceOutput and denoiseTemp; src is the one holding
+    // the current image. Each pass reads src as SRV and returns it to UAV.
+    ID3D12Resource* pingPong[2] = { pathTraceOutput, denoiseTemp };
+    const UINT pingPongUav[2] = { 3, 5 };
+    const UINT pingPongSrv[2] = { 4, 6 };
+    UINT src = 0;
+    if (denoise) {
+        UINT denoiseVariant = GroupTuneSelect(GROUP_KERNEL_PT_DENOISE, frameIndex);
+        if (!s_denoiseVariants[denoiseVariant] || !s_temporalVariants[denoiseVariant]) denoiseVariant = GROUP_VARIANT_DEFAULT;
+        ID3D12PipelineState* atrousPSO = s_denoiseVariants[denoiseVariant] ? s_denoiseVariants[denoiseVariant] : denoisePSO;
+        ID3D12PipelineState* temporalPSO = s_temporalVariants[denoiseVariant] ? s_temporalVariants[denoiseVariant] : s_temporalPSO;
+        const GroupShape& denoiseShape = GroupVariant(denoiseVariant);
+        UINT denoiseGroupsX = (s_traceW + denoiseShape.x - 1) / denoiseShape.x;
+        UINT denoiseGroupsY = (s_traceH + denoiseShape.y - 1) / denoiseShape.y;
+        cmdList->SetPipelineState(temporal ? temporalPSO : atrousPSO);
+        cmdList->SetComputeRootSignature(denoiseRootSig);
+        D3D12_GPU_DESCRIPTOR_HANDLE historyTable = ptTable;
+        historyTable.ptr += PT_HISTORY_SLOT * srvUavDescSize;
+        cmdList->SetComputeRootDescriptorTable(3, historyTable);
+
+        static const char* s_atrousStampNames[PT_DENOISE_ITERATIONS] = { "A-Trous 1", "A-Trous 2", "A-Trous 4", "A-Trous 8" };
+        UINT passCount = PT_DENOISE_ITERATIONS + (temporal ? 1 : 0);
+        for (UINT pass = 0; pass < passCount; pass++) {
+            bool temporalPass = temporal && pass == 0;
+            UINT iteration = temporal ? pass - 1 : pass;
+            UINT dst = src ^ 1;
+
+            if (temporalPass) {
+                // Last frame's TemporalCS wrote the history this one reads
+                D3D12_RESOURCE_BARRIER historyBarrier = {};
+                historyBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+                historyBarrier.UAV.pResource = s_denoiseHistory;
+                cmdList->ResourceBarrier(1, &historyBarrier);
+            } else if (temporal && pass == 1) {
+                cmdList->SetPipelineState(atrousPSO);
+            }
 
-    // Copy raw path traced output to backbuffer
-    cmdList->CopyResource(renderTargets12[frameIndex], pathTraceOutput);
+            D3D12_RESOURCE_BARRIER srcBarrier = {};
+            srcBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            srcBarrier.Transition.pResource = pingPong[src];
+            srcBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            srcBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            srcBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            cmdList->ResourceBarrier(1, &srcBarrier);
+
+            DenoiseCBData denoiseData;
+            denoiseData.Width = s_traceW;
+            denoiseData.Height = s_traceH;
+            denoiseData.StepSize = temporalPass ? 1 : 1u << iteration;
+            denoiseData.ColorSigma = PT_DENOISE_COLOR_SIGMA / (float)(1u << (temporalPass ? 0 : iteration));
+            denoiseData.TemporalAlpha = max(1.0f / (float)(g_temporalFrameCount + 1), PT_TEMPORAL_MIN_ALPHA);
+            cmdList->SetComputeRootConstantBufferView(0,
+                FrameRingPush12(g_frameRing12, &denoiseData, sizeof(denoiseData), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT));
+
+            D3D12_GPU_DESCRIPTOR_HANDLE srvTable = ptTable;
+            srvTable.ptr += pingPongSrv[src] * srvUavDescSize;
+            D3D12_GPU_DESCRIPTOR_HANDLE uavTable = ptTable;
+            uavTable.ptr += (s_zeroCopy && !s_upscale && pass == passCount - 1 ? 8 + frameIndex : pingPongUav[dst]) * srvUavDescSize;
+            cmdList->SetComputeRootDescriptorTable(1, srvTable);
+            cmdList->SetComputeRootDescriptorTable(2, uavTable);
+            cmdList->Dispatch(denoiseGroupsX, denoiseGroupsY, 1);
+
+            srcBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            srcBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            cmdList->ResourceBarrier(1, &srcBarrier);
+            GpuTimerStamp12(cmdList, frameIndex, temporalPass ? "Temporal" : s_atrousStampNames[iteration]);
+            src = dst;
+        }
+        if (temporal) g_temporalFrameCount++;
+    }
+
+    // ===== UPSCALE + SHARPEN (--render-scale) =====
+    ID3D12Resource* finalImage = pingPong[src];
+    if (s_upscale) {
+        D3D12_RESOURCE_BARRIER upBarriers[2] = {};
+        for (int i = 0; i < 2; i++) {
+            upBarriers[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            upBarriers[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        }
+        upBarriers[0].Transition.pResource = pingPong[src];
+        upBarriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        upBarriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        upBarriers[1].Transition.pResource = s_upscaleTemp;
+        cmdList->ResourceBarrier(1, upBarriers);
+
+        UpscaleCBData upscaleData;
+        upscaleData.InputWidth = s_traceW;
+        upscaleData.InputHeight = s_traceH;
+        upscaleData.OutputWidth = W;
+        upscaleData.OutputHeight = H;
+        upscaleData.Sharpness = PT_SHARPNESS;
+        cmdList->SetComputeRootSignature(denoiseRootSig);
+        cmdList->SetComputeRootConstantBufferView(0,
+            FrameRingPush12(g_frameRing12, &upscaleData, sizeof(upscaleData), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT));
+        D3D12_GPU_DESCRIPTOR_HANDLE historyTable = ptTable;
+        historyTable.ptr += PT_HISTORY_SLOT * srvUavDescSize;
+        cmdList->SetComputeRootDescriptorTable(3, historyTable);
+
+        UINT outGroupsX = (W + 7) / 8;
+        UINT outGroupsY = (H + 7) / 8;
+        D3D12_GPU_DESCRIPTOR_HANDLE srvTable = ptTable;
+        srvTable.ptr += pingPongSrv[src] * srvUavDescSize;
+        D3D12_GPU_DESCRIPTOR_HANDLE uavTable = ptTable;
+        uavTable.ptr += PT_UPSCALE_SLOT * srvUavDescSize;
+        cmdList->SetPipelineState(s_upscalePSO);
+        cmdList->SetComputeRootDescriptorTable(1, srvTable);
+        cmdList->SetComputeRootDescriptorTable(2, uavTable);
+        cmdList->Dispatch(outGroupsX, outGroupsY, 1);
+
+        upBarriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        upBarriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        upBarriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        upBarriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        cmdList->ResourceBarrier(2, upBarriers);
+        GpuTimerStamp12(cmdList, frameIndex, "Upscale");
+
+        srvTable.ptr = ptTable.ptr + (PT_UPSCALE_SLOT + 1) * srvUavDescSize;
+        uavTable.ptr = ptTable.ptr + (s_zeroCopy ? 8 + frameIndex : PT_UPSCALE_SLOT + 2) * srvUavDescSize;
+        cmdList->SetPipelineState(s_sharpenPSO);
+        cmdList->SetComputeRootDescriptorTable(1, srvTable);
+        cmdList->SetComputeRootDescriptorTable(2, uavTable);
+        cmdList->Dispatch(outGroupsX, outGroupsY, 1);
+
+        upBarriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        upBarriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        cmdList->ResourceBarrier(1, &upBarriers[1]);
+        GpuTimerStamp12(cmdList, frameIndex, "Sharpen");
+        finalImage = s_upscaleOutput;
+    }
+
+    if (s_zeroCopy) {
+        // Straight to the text pass - no copy, one transition
+        bbBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        bbBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        cmdList->ResourceBarrier(1, &bbBarrier);
+    } else {
+        // ===== COPY PATH TRACED (OR DENOISED) OUTPUT TO BACKBUFFER =====
+        D3D12_RESOURCE_BARRIER barriers[2] = {};
+        barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barriers[0].Transition.pResource = renderTargets12[frameIndex];
+        barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+        barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+        barriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barriers[1].Transition.pResource = finalImage;
+        barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        barriers[1].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        cmdList->ResourceBarrier(2, barriers);
+
+        cmdList->CopyResource(renderTargets12[frameIndex], finalImage);
+
+        // Transition for text rendering
+        barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        cmdList->ResourceBarrier(2, barriers);
+        GpuTimerStamp12(cmdList, frameIndex, "Copy");
+    }
 
-    // Transition for text rendering
-    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
-    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-    cmdList->ResourceBarrier(2, barriers);
+    // --capture: the finished image, without the overlay
+    Capture12Record(cmdList, renderTargets12[frameIndex], D3D12_RESOURCE_STATE_RENDER_TARGET,
+                    frameIndex, cbData.FrameCount, GetRendererId(RENDERER_D3D12_PT));
 
     // ===== TEXT OVERLAY =====
     D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap12->GetCPUDescriptorHandleForHeapStart();
     rtvHandle.ptr += frameIndex * rtvDescSize;
 
-    // Update text if FPS changed
-    if (fps != g_cachedFps || g_textNeedsRebuild) {
+    // Update text if FPS or GPU timings changed
+    static UINT s_cachedProfilerVersion = 0;
+    if (fps != g_cachedFps || g_textNeedsRebuild || s_cachedProfilerVersion != GpuProfilerGetVersion()) {
         g_cachedFps = fps;
         g_textNeedsRebuild = false;
+        s_cachedProfilerVersion = GpuProfilerGetVersion();
+
+        char gpuTimes[256];
+        GpuProfilerFormat(gpuTimes, sizeof(gpuTimes));
+        char latency[64];
+        LatencyFormat(latency, sizeof(latency));
+        char vram[192];
+        VramFormat(vram, sizeof(vram));
+        char accum[96];
+        AccumFormat(accum, sizeof(accum));
+        char tlasText[96];
+        TlasStatsFormat(tlasText, sizeof(tlasText));
+        char rayStats[160];
+        RayStatsFormat(rayStats, sizeof(rayStats));
+        char rays[160];
+        if (g_ptAdaptiveMaxSpp)
+            sprintf_s(rays, "Rays: %u-%u SPP adaptive (avg %.2f, err %.3f) | Bounces: %u",
+                      g_ptSpp > 2 ? g_ptSpp : 2, g_ptAdaptiveMaxSpp, s_frameAvgSpp, g_ptAdaptiveTarget, g_ptMaxBounces);
+        else
+            sprintf_s(rays, "Rays: %u SPP | Bounces: %u%s", g_ptSpp, g_ptMaxBounces, g_ptWavefront ? " | Wavefront" : "");
+        if (s_lights.size() > 1 || g_ptLightSampling != PT_LIGHTS_UNIFORM) {
+            char lights[48];
+            sprintf_s(lights, " | Lights: %zu %s", s_lights.size(), PtLightSamplingName());
+            strcat_s(rays, lights);
+        }
+        char denoiseText[64];
+        if (g_denoiseMode == DENOISE_ATROUS) strcpy_s(denoiseText, "Denoise: A-Trous 1-2-4-8 (N)");
+        else if (g_denoiseMode == DENOISE_TEMPORAL) strcpy_s(denoiseText, "Denoise: Temporal + A-Trous 1-2-4-8 (N)");
+        else strcpy_s(denoiseText, "Denoise: Off (N)");
+        char splitText[192] = "";
+        if (s_split.device)
+            sprintf_s(splitText, "Split: rows %u-%u on GPU %d (%s), %.0f%% %s, %.2f ms\n",
+                      s_split.splitRow, s_traceH - 1, s_split.adapterIndex, s_split.name,
+                      100.0f * SplitLowerRows() / s_traceH, g_ptSplitRatio > 0.0f ? "fixed" : "balanced", s_split.lastMs);
+        char scaleText[64] = "";
+        if (s_upscale)
+            sprintf_s(scaleText, " (traced %ux%u, %u%% + upscale)", s_traceW, s_traceH, g_renderScalePct);
 
         static char gpuNameA[128] = {0};
         if (gpuNameA[0] == 0) {
@@ -999,42 +2577,32 @@ void RenderD3D12PT()
             wcstombs_s(&converted, gpuNameA, sizeof(gpuNameA), gpuName.c_str(), _TRUNCATE);
         }
 
-        char infoText[512];
+        char infoText[1280];
         sprintf_s(infoText,
-            "API: D3D12 + Path Tracing\n"
+            "API: D3D12 + Path Tracing%s\n"
             "GPU: %s\n"
             "FPS: %d\n"
             "Triangles: %u\n"
-            "Resolution: %ux%u\n"
-            "Rays: 1 SPP | Bounces: 3",
-            gpuNameA, fps, totalIndices12 / 3, W, H);
-
-        g_textVertCount = 0;
-        DrawTextDirect(infoText, 12.0f, 12.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.5f);
-        DrawTextDirect(infoText, 10.0f, 10.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.5f);
-        memcpy(textVbMapped12, g_textVerts, g_textVertCount * sizeof(TextVert));
+            "Resolution: %ux%u%s\n"
+            "%s\n"
+            "%s\n"
+            "%s"
+            "%s%s"
+            "%s%s"
+            "%s%s"
+            "%s%s%s"
+            "%s%s",
+            s_zeroCopy ? " (zero-copy)" : "", gpuNameA, fps, totalIndices12 / 3, W, H, scaleText, rays, denoiseText, splitText,
+            accum, accum[0] ? "\n" : "", tlasText, tlasText[0] ? "\n" : "", rayStats, rayStats[0] ? "\n" : "",
+            gpuTimes, latency[0] ? "\n" : "", latency, vram[0] ? "\n" : "", vram);
+
+        OverlaySetText(g_overlay12.text, infoText);
     }
 
-    // Draw text
-    if (g_textVertCount > 0) {
-        cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-        cmdList->SetPipelineState(textPso);
-        cmdList->SetGraphicsRootSignature(textRootSig12);
-
-        ID3D12DescriptorHeap* textHeaps[] = { srvHeap12 };
-        cmdList->SetDescriptorHeaps(1, textHeaps);
-        cmdList->SetGraphicsRootDescriptorTable(0, srvHeap12->GetGPUDescriptorHandleForHeapStart());
-
-        D3D12_VIEWPORT vp = { 0, 0, (float)W, (float)H, 0, 1 };
-        D3D12_RECT scissor = { 0, 0, (LONG)W, (LONG)H };
-        cmdList->RSSetViewports(1, &vp);
-        cmdList->RSSetScissorRects(1, &scissor);
-
-        cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        cmdList->IASetVertexBuffers(0, 1, &textVbView12);
-        cmdList->IASetIndexBuffer(nullptr);
-        cmdList->DrawInstanced(g_textVertCount, 1, 0, 0);
-    }
+    // Draw text (viewport / scissor back to display size, see Overlay12Draw)
+    cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    Overlay12Draw(g_overlay12, cmdList, frameIndex, W, H);
+    GpuTimerStamp12(cmdList, frameIndex, "Text");
 
     // Transition to present
     D3D12_RESOURCE_BARRIER presentBarrier = {};
@@ -1044,33 +2612,91 @@ void RenderD3D12PT()
     presentBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
     presentBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
     cmdList->ResourceBarrier(1, &presentBarrier);
+    GpuTimerEnd12(cmdList, frameIndex);
 
     cmdList->Close();
     ID3D12CommandList* cmdLists[] = { cmdList };
     cmdQueue->ExecuteCommandLists(1, cmdLists);
 
-    UINT presentFlags = g_tearingSupported12 ? DXGI_PRESENT_ALLOW_TEARING : 0;
-    swap12->Present(0, presentFlags);
+    DxgiPresent(swap12, g_tearingSupported12);
     MoveToNextFrame();
 }
 
+// ============== RESIZE ==============
+bool ResizeD3D12PT()
+{
+    if (!ResizeSwapChain12()) return false;  // Waits for the GPU first
+
+    CleanupCapture12();
+    if (pathTraceOutput) { pathTraceOutput->Release(); pathTraceOutput = nullptr; }
+    if (denoiseTemp) { denoiseTemp->Release(); denoiseTemp = nullptr; }
+    if (s_accumSum) { s_accumSum->Release(); s_accumSum = nullptr; }
+    if (s_denoiseHistory) { s_denoiseHistory->Release(); s_denoiseHistory = nullptr; }
+    if (s_upscaleTemp) { s_upscaleTemp->Release(); s_upscaleTemp = nullptr; }
+    if (s_upscaleOutput) { s_upscaleOutput->Release(); s_upscaleOutput = nullptr; }
+    if (s_reservoirs) { s_reservoirs->Release(); s_reservoirs = nullptr; }
+    ReleaseWavefrontBuffers();
+    AccumRestart();
+    if (!CreatePathTraceTargets()) return false;
+    if (s_split.device) {
+        SplitWaitIdle();
+        ReleaseSplitTargets();
+        if (!CreateSplitTargets()) {
+            Log("[WARN] --split-gpu: band targets could not be recreated, tracing on one GPU\n");
+            CleanupSplitGpu();
+        }
+    }
+
+    // Temporal history is meaningless at the new size
+    g_temporalFrameCount = 0;
+    Log("[INFO] D3D12 PT resized to %ux%u\n", W, H);
+    return true;
+}
+
 // ============== CLEANUP ==============
 void CleanupD3D12PT()
 {
+    VramSetCategories(nullptr);
     WaitForGpu();
+    CleanupSplitGpu();   // Opened dev12 handles, before dev12 goes
+    CleanupGpuTimer12();
+    CleanupRayCounters12();
+    CleanupCapture12();
+    PipelineCacheClose();
 
     // Path tracing resources
-    if (pathTracePSO) pathTracePSO->Release();
-    if (pathTraceRootSig) pathTraceRootSig->Release();
-    if (pathTraceSrvUavHeap) pathTraceSrvUavHeap->Release();
-    if (pathTraceOutput) pathTraceOutput->Release();
-    if (pathTraceCB) pathTraceCB->Release();
+    GroupReleaseVariants12(s_traceVariants);
+    GroupReleaseVariants12(s_denoiseVariants);
+    GroupReleaseVariants12(s_temporalVariants);
+    if (pathTracePSO) { pathTracePSO->Release(); pathTracePSO = nullptr; }
+    if (pathTraceRootSig) { pathTraceRootSig->Release(); pathTraceRootSig = nullptr; }
+    if (pathTraceSrvUavHeap) { pathTraceSrvUavHeap->Release(); pathTraceSrvUavHeap = nullptr; }
+    if (pathTraceOutput) { pathTraceOutput->Release(); pathTraceOutput = nullptr; }
+    if (s_accumSum) { s_accumSum->Release(); s_accumSum = nullptr; }
+    if (s_sampleCounter) { s_sampleCounter->Release(); s_sampleCounter = nullptr; }
+    if (s_sampleReadback) { s_sampleReadback->Release(); s_sampleReadback = nullptr; }
+    s_sampleReadbackMapped = nullptr;
+    memset(s_sampleReadbackPending, 0, sizeof(s_sampleReadbackPending));
+    s_lastSampleCount = 0;
+    s_adaptiveSamples = 0.0;
+    s_adaptiveFrames = 0;
+    s_frameAvgSpp = 0.0f;
 
     // Denoise resources
-    if (denoisePSO) denoisePSO->Release();
-    if (denoiseRootSig) denoiseRootSig->Release();
-    if (denoiseTemp) denoiseTemp->Release();
-    if (denoiseCB) denoiseCB->Release();
+    if (denoisePSO) { denoisePSO->Release(); denoisePSO = nullptr; }
+    if (denoiseRootSig) { denoiseRootSig->Release(); denoiseRootSig = nullptr; }
+    if (denoiseTemp) { denoiseTemp->Release(); denoiseTemp = nullptr; }
+    if (s_temporalPSO) { s_temporalPSO->Release(); s_temporalPSO = nullptr; }
+    if (s_denoiseHistory) { s_denoiseHistory->Release(); s_denoiseHistory = nullptr; }
+
+    // Upscale resources
+    if (s_upscalePSO) { s_upscalePSO->Release(); s_upscalePSO = nullptr; }
+    if (s_sharpenPSO) { s_sharpenPSO->Release(); s_sharpenPSO = nullptr; }
+    if (s_upscaleTemp) { s_upscaleTemp->Release(); s_upscaleTemp = nullptr; }
+    if (s_upscaleOutput) { s_upscaleOutput->Release(); s_upscaleOutput = nullptr; }
+
+    // Wavefront resources
+    CleanupWavefront();
 
     // RT resources (local static)
     if (s_instanceBuffer) { s_instanceBuffer->Unmap(0, nullptr); s_instanceBuffer->Release(); s_instanceBuffer = nullptr; }
@@ -1082,40 +2708,53 @@ void CleanupD3D12PT()
     if (s_ibStatic) { s_ibStatic->Release(); s_ibStatic = nullptr; }
     if (s_vbCube) { s_vbCube->Release(); s_vbCube = nullptr; }
     if (s_ibCube) { s_ibCube->Release(); s_ibCube = nullptr; }
+    RTTablesRelease12(s_rtTables);
     s_instanceMapped = nullptr;
 
+    // --lights / --light-sampling
+    if (s_lightBuffer) { s_lightBuffer->Release(); s_lightBuffer = nullptr; }
+    if (s_reservoirs) { s_reservoirs->Release(); s_reservoirs = nullptr; }
+    s_lights.clear();
+
     // RT resources (global, for compatibility)
-    if (scratchBuffer) scratchBuffer->Release();
-    if (instanceBuffer) instanceBuffer->Release();
-    if (tlasBuffer) tlasBuffer->Release();
-    if (blasBuffer) blasBuffer->Release();
-    if (cmdListRT) cmdListRT->Release();
-    if (dev12RT) dev12RT->Release();
+    if (scratchBuffer) { scratchBuffer->Release(); scratchBuffer = nullptr; }
+    if (instanceBuffer) { instanceBuffer->Release(); instanceBuffer = nullptr; }
+    if (tlasBuffer) { tlasBuffer->Release(); tlasBuffer = nullptr; }
+    if (blasBuffer) { blasBuffer->Release(); blasBuffer = nullptr; }
+    if (cmdListRT) { cmdListRT->Release(); cmdListRT = nullptr; }
+    if (dev12RT) { dev12RT->Release(); dev12RT = nullptr; }
 
     // Text resources
-    if (textVB12) textVB12->Release();
-    if (fontTex12) fontTex12->Release();
-    if (textPso) textPso->Release();
-    if (textRootSig12) textRootSig12->Release();
-    if (srvHeap12) srvHeap12->Release();
+    Overlay12Cleanup(g_overlay12);
 
     // Main resources
-    if (fenceEvent) CloseHandle(fenceEvent);
-    if (fence) fence->Release();
-    if (cbUpload12) cbUpload12->Release();
-    if (ib12) ib12->Release();
-    if (vb12) vb12->Release();
-    if (cmdList) cmdList->Release();
+    if (fenceEvent) { CloseHandle(fenceEvent); fenceEvent = nullptr; }
+    if (fence) { fence->Release(); fence = nullptr; }
+    CleanupFrameRing12(g_frameRing12);
+    // vb12/ib12 alias s_vbStatic/s_ibStatic (no extra ref) - already released above
+    vb12 = nullptr;
+    ib12 = nullptr;
+    vbStride12 = 0;
+    ib16Bit12 = false;
+    if (blueNoise12) { blueNoise12->Release(); blueNoise12 = nullptr; }
+    if (cmdList) { cmdList->Release(); cmdList = nullptr; }
     for (UINT i = 0; i < FRAME_COUNT; i++) {
-        if (cmdAlloc[i]) cmdAlloc[i]->Release();
-        if (renderTargets12[i]) renderTargets12[i]->Release();
-    }
-    if (depthStencil12) depthStencil12->Release();
-    if (dsvHeap12) dsvHeap12->Release();
-    if (rtvHeap12) rtvHeap12->Release();
-    if (swap12) swap12->Release();
-    if (cmdQueue) cmdQueue->Release();
-    if (dev12) dev12->Release();
+        if (cmdAlloc[i]) { cmdAlloc[i]->Release(); cmdAlloc[i] = nullptr; }
+        if (renderTargets12[i]) { renderTargets12[i]->Release(); renderTargets12[i] = nullptr; }
+    }
+    if (depthStencil12) { depthStencil12->Release(); depthStencil12 = nullptr; }
+    if (dsvHeap12) { dsvHeap12->Release(); dsvHeap12 = nullptr; }
+    if (rtvHeap12) { rtvHeap12->Release(); rtvHeap12 = nullptr; }
+    if (swapWaitable12) { CloseHandle(swapWaitable12); swapWaitable12 = nullptr; }
+    if (swap12) { swap12->Release(); swap12 = nullptr; }
+    if (cmdQueue) { cmdQueue->Release(); cmdQueue = nullptr; }
+    if (dev12) { dev12->Release(); dev12 = nullptr; }
+
+    // Reset frame state so another D3D12 renderer can initialize cleanly
+    memset(fenceValues, 0, sizeof(fenceValues));
+    frameIndex = 0;
+    g_cachedFps = -1;
+    g_textNeedsRebuild = true;
 
     // DXC module
     if (g_dxcModule) {
@@ -6,6 +6,16 @@
 #include "d3d12_shared.h"
 #include "renderer_d3d12.h"
 #include "../shaders/rt_cornell_shaders.h"
+#include "../shaders/rt_sampling_shaders.h"
+#include "../shaders/ray_stats_shaders.h"
+#include "../shaders/d3d12_vrs_shaders.h"
+#include "../tlas_policy.h"
+#include "../rt_sampling.h"
+#include "../ray_stats.h"
+#include "../gpu_profiler.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "../offscreen.h"
 
 #include <d3d12.h>
 #include <dxgi1_6.h>
@@ -66,7 +76,13 @@ struct alignas(256) RTCB {
     int giBounces;
     float giStrength;
     float denoiseBlendFactor;
-    int _padding;
+    int indirectMode;   // RtIndirectRate
+
+    float indirectScaleX, indirectScaleY;   // Indirect buffer pixels per output pixel
+    UINT indirectWidth, indirectHeight;     // Indirect pass viewport
+
+    UINT frameNumber;   // Checkerboard parity, sampler sequence index
+    UINT _padding[3];
 };
 
 // ============== SHADER FEATURE FLAGS (for compile-time #defines) ==============
@@ -80,6 +96,7 @@ struct ShaderFeatures {
     bool gi;
     bool reflections;
     bool temporalDenoise;
+    bool indirectUpsample;  // AO/GI from the reduced-rate indirect pass (--rt-indirect)
 
     bool operator==(const ShaderFeatures& other) const {
         return useRayQuery == other.useRayQuery &&
@@ -89,7 +106,8 @@ struct ShaderFeatures {
                ao == other.ao &&
                gi == other.gi &&
                reflections == other.reflections &&
-               temporalDenoise == other.temporalDenoise;
+               temporalDenoise == other.temporalDenoise &&
+               indirectUpsample == other.indirectUpsample;
     }
     bool operator!=(const ShaderFeatures& other) const { return !(*this == other); }
 };
@@ -103,6 +121,7 @@ static ID3D12CommandQueue* s_cmdQueue = nullptr;
 static ID3D12CommandAllocator* s_cmdAlloc[3] = {};
 static ID3D12GraphicsCommandList4* s_cmdList = nullptr;
 static IDXGISwapChain3* s_swapChain = nullptr;
+static HANDLE s_swapWaitable = nullptr;   // --max-latency
 
 // Render targets
 static ID3D12DescriptorHeap* s_rtvHeap = nullptr;
@@ -116,6 +135,20 @@ static UINT s_frameIndex = 0;
 static ID3D12Resource* s_historyBuffer = nullptr;
 static bool s_historyValid = false;  // First frame has no history
 
+// Reduced-rate AO/GI (--rt-indirect): RGBA16F at W x H, the indirect pass
+// only covers its IndirectSize corner. RTVs 3-4, SRVs t2-t3.
+static ID3D12Resource* s_indirectBuffer = nullptr;  // rgb = GI, a = AO
+static ID3D12Resource* s_indirectGuide = nullptr;   // xyz = normal, w = view distance
+static bool s_indirectValid = false;  // Checkerboard: the untraced half holds last frame's values
+
+// --vrs: R8_UINT shading rate image, one texel per tile, UAV in SRV heap slot 5.
+// Lives in SHADING_RATE_SOURCE outside the rate pass.
+static ID3D12GraphicsCommandList5* s_cmdList5 = nullptr;  // RSSetShadingRate(Image)
+static ID3D12RootSignature* s_vrsRootSig = nullptr;
+static ID3D12PipelineState* s_vrsPso = nullptr;
+static ID3D12Resource* s_vrsImage = nullptr;
+static UINT s_vrsTileSize = 0;   // 0 = VRS off or unsupported
+
 // Synchronization
 static ID3D12Fence* s_fence = nullptr;
 static UINT64 s_fenceValues[3] = {};
@@ -129,9 +162,8 @@ static D3D12_INDEX_BUFFER_VIEW s_ibView = {};
 static UINT s_indexCount = 0;
 static UINT s_vertexCount = 0;
 
-// Constant buffer
-static ID3D12Resource* s_constantBuffer = nullptr;
-static void* s_cbMapped = nullptr;
+// Per-frame upload ring (RTCB, text vertices) - own device, so not g_frameRing12
+static FrameRing12 s_frameRing;
 
 // Ray tracing resources - Static geometry (room)
 static ID3D12Resource* s_blasBufferStatic = nullptr;
@@ -144,6 +176,7 @@ static UINT s_indexCountStatic = 0;
 static ID3D12Resource* s_blasBufferCube = nullptr;
 static ID3D12Resource* s_vertexBufferCube = nullptr;
 static ID3D12Resource* s_indexBufferCube = nullptr;
+static ID3D12Resource* s_blueNoise = nullptr;   // --sampler=bluenoise tile (t0 space1)
 static UINT s_vertexCountCube = 0;
 static UINT s_indexCountCube = 0;
 static D3D12_VERTEX_BUFFER_VIEW s_vbViewCube = {};
@@ -155,24 +188,17 @@ static ID3D12Resource* s_scratchBuffer = nullptr;
 static ID3D12Resource* s_instanceBuffer = nullptr;
 static void* s_instanceMapped = nullptr;  // Persistent mapping for runtime updates
 static UINT64 s_tlasScratchSize = 0;
+static TlasPolicy s_tlasPolicy;   // Refit vs rebuild, see tlas_policy.h
 
 // Pipeline
 static ID3D12RootSignature* s_rootSig = nullptr;
 static ID3D12PipelineState* s_pso = nullptr;
+static ID3D12PipelineState* s_indirectPso = nullptr;  // IndirectPS, with s_pso when features.indirectUpsample
+static ID3D12PipelineState* s_depthPso = nullptr;     // --depth-prepass: VSMain depth only, with s_pso
 static ID3D12DescriptorHeap* s_srvHeap = nullptr;
 
-// Text rendering
-static ID3D12RootSignature* s_textRootSig = nullptr;
-static ID3D12PipelineState* s_textPso = nullptr;
-static ID3D12DescriptorHeap* s_textSrvHeap = nullptr;
-static ID3D12Resource* s_fontTexture = nullptr;
-static ID3D12Resource* s_textVB = nullptr;
-static D3D12_VERTEX_BUFFER_VIEW s_textVBView = {};
-static void* s_textVBMapped = nullptr;
-
-// Text vertex cache
-static TextVert s_textVerts[6000];
-static UINT s_textVertCount = 0;
+// Text overlay (instanced glyphs, see d3d12_overlay.cpp)
+static Overlay12 s_overlay;
 static int s_cachedFps = -1;
 
 // GPU info
@@ -182,23 +208,27 @@ static std::wstring s_gpuName;
 static void WaitForGpuRT() {
     if (!s_cmdQueue || !s_fence || !s_fenceEvent) return;
     const UINT64 fv = s_fenceValues[s_frameIndex];
+    FrameRingRetire12(s_frameRing, fv);
     s_cmdQueue->Signal(s_fence, fv);
     if (s_fence->GetCompletedValue() < fv) {
         s_fence->SetEventOnCompletion(fv, s_fenceEvent);
         WaitForSingleObject(s_fenceEvent, INFINITE);
     }
+    FrameRingReclaim12(s_frameRing, s_fence->GetCompletedValue());
     s_fenceValues[s_frameIndex]++;
 }
 
 // ============== HELPER: Move to next frame ==============
 static void MoveToNextFrameRT() {
     const UINT64 currentFenceValue = s_fenceValues[s_frameIndex];
+    FrameRingRetire12(s_frameRing, currentFenceValue);
     s_cmdQueue->Signal(s_fence, currentFenceValue);
     s_frameIndex = s_swapChain->GetCurrentBackBufferIndex();
     if (s_fence->GetCompletedValue() < s_fenceValues[s_frameIndex]) {
         s_fence->SetEventOnCompletion(s_fenceValues[s_frameIndex], s_fenceEvent);
         WaitForSingleObject(s_fenceEvent, INFINITE);
     }
+    FrameRingReclaim12(s_frameRing, s_fence->GetCompletedValue());
     s_fenceValues[s_frameIndex] = currentFenceValue + 1;
 }
 
@@ -455,127 +485,43 @@ static void UpdateCubeTransform(float time) {
 }
 
 // ============== REBUILD TLAS (for dynamic updates) ==============
+// Refit in place, or a full build when tlas_policy.h asks for one
 static void RebuildTLAS() {
     if (!s_cmdList || !s_tlasBuffer || !s_instanceBuffer) return;
-
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs = {};
-    tlasInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    tlasInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    tlasInputs.NumDescs = 2;  // Static + Cube
-    tlasInputs.InstanceDescs = s_instanceBuffer->GetGPUVirtualAddress();
-    tlasInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD |
-                       D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
-
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC tlasBuildDesc = {};
-    tlasBuildDesc.Inputs = tlasInputs;
-    tlasBuildDesc.Inputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
-    tlasBuildDesc.SourceAccelerationStructureData = s_tlasBuffer->GetGPUVirtualAddress();
-    tlasBuildDesc.DestAccelerationStructureData = s_tlasBuffer->GetGPUVirtualAddress();
-    tlasBuildDesc.ScratchAccelerationStructureData = s_scratchBuffer->GetGPUVirtualAddress();
-
-    s_cmdList->BuildRaytracingAccelerationStructure(&tlasBuildDesc, 0, nullptr);
-
-    D3D12_RESOURCE_BARRIER uavBarrier = {};
-    uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-    uavBarrier.UAV.pResource = s_tlasBuffer;
-    s_cmdList->ResourceBarrier(1, &uavBarrier);
+    TlasUpdate12(s_cmdList, s_frameRing, s_tlasPolicy, s_tlasBuffer, s_scratchBuffer,
+                 (const D3D12_RAYTRACING_INSTANCE_DESC*)s_instanceMapped, 2, s_instanceBuffer->GetGPUVirtualAddress());
 }
 
-// ============== TEXT DRAWING ==============
-static void DrawTextRT(const char* text, float x, float y, float r, float g, float b, float a, float scale) {
-    const float charW = 8.0f * scale;
-    const float charH = 8.0f * scale;
-    float startX = x;
-
-    while (*text && s_textVertCount < 5994) {
-        char c = *text++;
-        if (c == '\n') { y += charH + 2; x = startX; continue; }
-        if (c < 32 || c > 127) c = '?';
-
-        int ci = c - 32;
-        int row = ci / 16;
-        int col = ci % 16;
-        float u0 = col / 16.0f, v0 = row / 6.0f;
-        float u1 = (col + 1) / 16.0f, v1 = (row + 1) / 6.0f;
-
-        float x0 = x * 2.0f / W - 1.0f;
-        float y0 = 1.0f - y * 2.0f / H;
-        float x1 = (x + charW) * 2.0f / W - 1.0f;
-        float y1 = 1.0f - (y + charH) * 2.0f / H;
-
-        TextVert* v = &s_textVerts[s_textVertCount];
-        v[0] = {x0, y0, u0, v0, r, g, b, a};
-        v[1] = {x1, y0, u1, v0, r, g, b, a};
-        v[2] = {x0, y1, u0, v1, r, g, b, a};
-        v[3] = {x1, y0, u1, v0, r, g, b, a};
-        v[4] = {x1, y1, u1, v1, r, g, b, a};
-        v[5] = {x0, y1, u0, v1, r, g, b, a};
-        s_textVertCount += 6;
-        x += charW;
+// ============== DXC SHADER COMPILATION ==============
+// Base: -E entry -T target -O3 (5 args), each define: -D DEFINE (2 args).
+// Shared with AddRTPrecompileJobs so precompiled entries hit the same cache key.
+#define RT_MAX_SHADER_ARGS (5 + 2 * 12)
+static UINT BuildShaderArgs(const wchar_t* entry, const wchar_t* target,
+                            const wchar_t** defines, int defineCount, const wchar_t** args) {
+    UINT argCount = 0;
+    args[argCount++] = L"-E"; args[argCount++] = entry;
+    args[argCount++] = L"-T"; args[argCount++] = target;
+    args[argCount++] = L"-O3";
+    for (int i = 0; i < defineCount && i < 12; i++) {
+        args[argCount++] = L"-D";
+        args[argCount++] = defines[i];
     }
+    return argCount;
 }
 
-// ============== DXC SHADER COMPILATION ==============
-// Compiles shader with optional defines (array of L"-D", L"DEFINE_NAME" pairs)
+// Compiles shader with optional defines (array of define names, passed as -D).
+// Goes through the shared DXIL cache, so the key covers the feature set.
 static bool CompileShaderDXC(const char* source, const wchar_t* entry, const wchar_t* target,
                              ID3DBlob** blob, const wchar_t** defines = nullptr, int defineCount = 0) {
-    typedef HRESULT(WINAPI* DxcCreateInstanceProc)(REFCLSID, REFIID, LPVOID*);
-    HMODULE dxcMod = LoadLibraryW(L"dxcompiler.dll");
-    if (!dxcMod) { Log("[ERROR] Cannot load dxcompiler.dll\n"); return false; }
-
-    auto DxcCreate = (DxcCreateInstanceProc)GetProcAddress(dxcMod, "DxcCreateInstance");
-    if (!DxcCreate) { FreeLibrary(dxcMod); return false; }
-
-    IDxcUtils* utils = nullptr;
-    IDxcCompiler3* compiler = nullptr;
-    DxcCreate(CLSID_DxcUtils, IID_PPV_ARGS(&utils));
-    DxcCreate(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler));
-
-    IDxcBlobEncoding* srcBlob = nullptr;
-    utils->CreateBlob(source, (UINT)strlen(source), CP_UTF8, &srcBlob);
-
-    DxcBuffer srcBuf = { srcBlob->GetBufferPointer(), srcBlob->GetBufferSize(), CP_UTF8 };
-
-    // Build args array: base args + defines
-    // Base: -E entry -T target -O3 (5 args)
-    // Each define: -D DEFINE (2 args each)
-    const int baseArgCount = 5;
-    int totalArgs = baseArgCount + defineCount * 2;
-    const wchar_t** args = new const wchar_t*[totalArgs];
-    args[0] = L"-E"; args[1] = entry;
-    args[2] = L"-T"; args[3] = target;
-    args[4] = L"-O3";
-    for (int i = 0; i < defineCount; i++) {
-        args[baseArgCount + i * 2] = L"-D";
-        args[baseArgCount + i * 2 + 1] = defines[i];
-    }
-
-    IDxcResult* result = nullptr;
-    compiler->Compile(&srcBuf, args, totalArgs, nullptr, IID_PPV_ARGS(&result));
-    delete[] args;
-
-    HRESULT status;
-    result->GetStatus(&status);
-    if (FAILED(status)) {
-        IDxcBlobUtf8* err = nullptr;
-        result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&err), nullptr);
-        if (err) { Log("[SHADER ERROR] %s\n", err->GetStringPointer()); err->Release(); }
-        srcBlob->Release(); result->Release(); compiler->Release(); utils->Release();
-        FreeLibrary(dxcMod);
-        return false;
-    }
-
-    IDxcBlob* shaderBlob = nullptr;
-    result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
-
-    // Copy to ID3DBlob
-    D3DCreateBlob(shaderBlob->GetBufferSize(), blob);
-    memcpy((*blob)->GetBufferPointer(), shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize());
+    const wchar_t* args[RT_MAX_SHADER_ARGS];
+    UINT argCount = BuildShaderArgs(entry, target, defines, defineCount, args);
+    return CompileDXC(source, args, argCount, blob, "RT");
+}
 
-    shaderBlob->Release(); srcBlob->Release(); result->Release();
-    compiler->Release(); utils->Release();
-    FreeLibrary(dxcMod);
-    return true;
+// The --sampler (rt_sampling.h) and --ray-stats (ray_stats.h) snippets in
+// front of the Cornell box shaders
+static std::string GetRTShaderSource() {
+    return std::string(g_rtSamplingShaderCode) + g_rayStatsShaderCode + g_rtCornellShaderCode;
 }
 
 // Get current shader features from global DXR settings
@@ -591,6 +537,7 @@ static ShaderFeatures GetCurrentShaderFeatures() {
     // These don't require RayQuery
     f.rtLighting = g_dxrFeatures.rtLighting;
     f.temporalDenoise = g_dxrFeatures.enableTemporalDenoise;
+    f.indirectUpsample = g_rtIndirectRate != RT_INDIRECT_FULL && (f.ao || f.gi);
     return f;
 }
 
@@ -605,19 +552,68 @@ static int BuildShaderDefines(const ShaderFeatures& f, const wchar_t** defines)
     if (f.gi)             defines[count++] = L"FEATURE_GI";
     if (f.reflections)    defines[count++] = L"FEATURE_REFLECTIONS";
     if (f.temporalDenoise) defines[count++] = L"FEATURE_TEMPORAL_DENOISE";
+    if (f.indirectUpsample) defines[count++] = L"FEATURE_INDIRECT_UPSAMPLE";
+    defines[count++] = RtSamplerDefine();
+    if (f.useRayQuery && RayCountersAddress12()) defines[count++] = L"RAY_STATS";  // Root parameter 2
     return count;
 }
 
-// Recompile shaders with specified feature flags
-static bool RecompileShaders(const ShaderFeatures& features) {
-    const wchar_t* defines[10];  // Max 8 defines + safety margin
+// ============== PERMUTATION PRECOMPILE ==============
+// Every distinct ShaderFeatures value GetCurrentShaderFeatures can produce:
+// the RayQuery-only flags are always off when useRayQuery is off, and the
+// indirect pass only exists with AO or GI.
+void AddRTPrecompileJobs(std::vector<ShaderPrecompileJob>& jobs) {
+    std::string source = GetRTShaderSource();
+    for (UINT mask = 0; mask < (1u << 9); mask++) {
+        ShaderFeatures f = {};
+        f.useRayQuery = (mask & 0x01) != 0;
+        f.shadows = (mask & 0x02) != 0;
+        f.softShadows = (mask & 0x04) != 0;
+        f.ao = (mask & 0x08) != 0;
+        f.gi = (mask & 0x10) != 0;
+        f.reflections = (mask & 0x20) != 0;
+        f.rtLighting = (mask & 0x40) != 0;
+        f.temporalDenoise = (mask & 0x80) != 0;
+        f.indirectUpsample = (mask & 0x100) != 0;
+        if (!f.useRayQuery && (mask & 0x3E)) continue;
+        if (f.indirectUpsample && !f.ao && !f.gi) continue;
+
+        const wchar_t* defines[12];
+        int defineCount = BuildShaderDefines(f, defines);
+        const wchar_t* vsTarget = f.useRayQuery ? L"vs_6_5" : L"vs_6_0";
+        const wchar_t* psTarget = f.useRayQuery ? L"ps_6_5" : L"ps_6_0";
+
+        const wchar_t* args[RT_MAX_SHADER_ARGS];
+        UINT argCount = BuildShaderArgs(L"VSMain", vsTarget, defines, defineCount, args);
+        jobs.push_back({ source, std::vector<const wchar_t*>(args, args + argCount), "RT" });
+        argCount = BuildShaderArgs(L"PSMain", psTarget, defines, defineCount, args);
+        jobs.push_back({ source, std::vector<const wchar_t*>(args, args + argCount), "RT" });
+        if (f.indirectUpsample) {
+            argCount = BuildShaderArgs(L"IndirectPS", psTarget, defines, defineCount, args);
+            jobs.push_back({ source, std::vector<const wchar_t*>(args, args + argCount), "RT" });
+        }
+    }
+}
+
+// Compile shaders and build the PSO for a feature set. Touches no renderer
+// state besides reading s_device/s_rootSig, so it is safe on a worker thread.
+// With features.indirectUpsample the IndirectPS PSO is built too and returned
+// in *indirectPso; with --depth-prepass the depth-only PSO in *depthPso, and
+// the shading PSOs test EQUAL without writing depth. Returns nullptr on
+// failure (and builds none of them).
+static ID3D12PipelineState* CreateRTPipeline(const ShaderFeatures& features, ID3D12PipelineState** indirectPso,
+                                             ID3D12PipelineState** depthPso) {
+    *indirectPso = nullptr;
+    *depthPso = nullptr;
+    const wchar_t* defines[12];  // Max 10 defines + safety margin
     int defineCount = BuildShaderDefines(features, defines);
+    std::string source = GetRTShaderSource();
 
     // Select shader model: 6.5 for RayQuery, 6.0 for compatibility
     const wchar_t* vsTarget = features.useRayQuery ? L"vs_6_5" : L"vs_6_0";
     const wchar_t* psTarget = features.useRayQuery ? L"ps_6_5" : L"ps_6_0";
 
-    Log("[INFO] Recompiling shaders (%ls) with features: %s%s%s%s%s%s%s%s\n",
+    Log("[INFO] Compiling shaders (%ls) with features: %s%s%s%s%s%s%s%s%s\n",
         psTarget,
         features.useRayQuery ? "RAYQUERY " : "",
         features.shadows ? "SHADOWS " : "",
@@ -626,25 +622,23 @@ static bool RecompileShaders(const ShaderFeatures& features) {
         features.ao ? "AO " : "",
         features.gi ? "GI " : "",
         features.reflections ? "REFLECTIONS " : "",
-        features.temporalDenoise ? "TEMPORAL_DENOISE " : "");
+        features.temporalDenoise ? "TEMPORAL_DENOISE " : "",
+        features.indirectUpsample ? "INDIRECT_UPSAMPLE " : "");
 
     ID3DBlob* vsBlob = nullptr;
     ID3DBlob* psBlob = nullptr;
 
-    if (!CompileShaderDXC(g_rtCornellShaderCode, L"VSMain", vsTarget, &vsBlob, defines, defineCount)) {
+    if (!CompileShaderDXC(source.c_str(), L"VSMain", vsTarget, &vsBlob, defines, defineCount)) {
         Log("[ERROR] Failed to compile vertex shader\n");
-        return false;
+        return nullptr;
     }
-    if (!CompileShaderDXC(g_rtCornellShaderCode, L"PSMain", psTarget, &psBlob, defines, defineCount)) {
+    if (!CompileShaderDXC(source.c_str(), L"PSMain", psTarget, &psBlob, defines, defineCount)) {
         vsBlob->Release();
         Log("[ERROR] Failed to compile pixel shader\n");
-        return false;
+        return nullptr;
     }
+    Log("[INFO] Shaders compiled (VS: %zu, PS: %zu bytes)\n", vsBlob->GetBufferSize(), psBlob->GetBufferSize());
 
-    // Release old PSO
-    if (s_pso) { s_pso->Release(); s_pso = nullptr; }
-
-    // Create new PSO with recompiled shaders
     D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
         {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
         {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
@@ -658,13 +652,19 @@ static bool RecompileShaders(const ShaderFeatures& features) {
     psoDesc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
     psoDesc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
     psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;  // No culling - show both sides
     psoDesc.RasterizerState.FrontCounterClockwise = TRUE;
     psoDesc.RasterizerState.DepthClipEnable = TRUE;
     psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
     psoDesc.DepthStencilState.DepthEnable = TRUE;
     psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
     psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+    if (g_rtDepthPrepass) {
+        // The prepass wrote the nearest depth with the same VS bytecode, so
+        // only the visible fragment of each pixel passes
+        psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+        psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_EQUAL;
+    }
     psoDesc.SampleMask = UINT_MAX;
     psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
     psoDesc.NumRenderTargets = 1;
@@ -672,25 +672,456 @@ static bool RecompileShaders(const ShaderFeatures& features) {
     psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
     psoDesc.SampleDesc.Count = 1;
 
-    HRESULT hr = s_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&s_pso));
-    vsBlob->Release();
+    ID3D12PipelineState* pso = nullptr;
+    HRESULT hr = PipelineCacheCreateGraphics(s_device, L"RT_Cornell", psoDesc, &pso);
     psBlob->Release();
 
     if (FAILED(hr)) {
-        Log("[ERROR] Failed to create PSO after recompile: 0x%08X\n", hr);
-        return false;
+        vsBlob->Release();
+        Log("[ERROR] Failed to create PSO: 0x%08X\n", hr);
+        return nullptr;
     }
 
-    s_compiledFeatures = features;
-    Log("[INFO] Shaders recompiled successfully\n");
+    // Indirect pass: same VS and state, AO/GI + guide into two RGBA16F targets
+    if (features.indirectUpsample) {
+        ID3DBlob* indirectBlob = nullptr;
+        if (!CompileShaderDXC(source.c_str(), L"IndirectPS", psTarget, &indirectBlob, defines, defineCount)) {
+            vsBlob->Release();
+            pso->Release();
+            Log("[ERROR] Failed to compile indirect pixel shader\n");
+            return nullptr;
+        }
+        psoDesc.PS = { indirectBlob->GetBufferPointer(), indirectBlob->GetBufferSize() };
+        psoDesc.NumRenderTargets = 2;
+        psoDesc.RTVFormats[0] = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        psoDesc.RTVFormats[1] = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        psoDesc.BlendState.RenderTarget[1].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+        hr = PipelineCacheCreateGraphics(s_device, L"RT_Cornell_Indirect", psoDesc, indirectPso);
+        indirectBlob->Release();
+        if (FAILED(hr)) {
+            vsBlob->Release();
+            pso->Release();
+            *indirectPso = nullptr;
+            Log("[ERROR] Failed to create indirect PSO: 0x%08X\n", hr);
+            return nullptr;
+        }
+    }
+
+    // Depth prepass: same VS and rasterizer state, no pixel shader or targets
+    if (g_rtDepthPrepass) {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC depthDesc = psoDesc;
+        depthDesc.PS = {};
+        depthDesc.NumRenderTargets = 0;
+        depthDesc.RTVFormats[0] = DXGI_FORMAT_UNKNOWN;
+        depthDesc.RTVFormats[1] = DXGI_FORMAT_UNKNOWN;
+        depthDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = 0;
+        depthDesc.BlendState.RenderTarget[1].RenderTargetWriteMask = 0;
+        depthDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+        depthDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+        hr = PipelineCacheCreateGraphics(s_device, L"RT_Cornell_Depth", depthDesc, depthPso);
+        if (FAILED(hr)) {
+            vsBlob->Release();
+            pso->Release();
+            if (*indirectPso) { (*indirectPso)->Release(); *indirectPso = nullptr; }
+            *depthPso = nullptr;
+            Log("[ERROR] Failed to create depth prepass PSO: 0x%08X\n", hr);
+            return nullptr;
+        }
+    }
+    vsBlob->Release();
+    return pso;
+}
+
+// ============== ASYNC RECOMPILE ==============
+// Feature toggles build the new PSO on a worker thread while the old one keeps
+// rendering. The render thread swaps it in when the job is done, and the old
+// PSO is released once the last frame that used it has retired on the GPU.
+struct RTRecompileJob {
+    HANDLE thread;
+    ShaderFeatures features;
+    ID3D12PipelineState* result;
+    ID3D12PipelineState* indirectResult;  // features.indirectUpsample only
+    ID3D12PipelineState* depthResult;     // --depth-prepass only
+    volatile LONG done;
+};
+
+struct RTRetiredPSO {
+    ID3D12PipelineState* pso;
+    UINT64 fenceValue;  // Safe to release once s_fence reaches this
+};
+
+static RTRecompileJob s_recompileJob = {};
+static std::vector<RTRetiredPSO> s_retiredPSOs;
+static ShaderFeatures s_failedFeatures = {};
+static bool s_hasFailedFeatures = false;  // Don't respin a worker for a set that just failed
+
+static DWORD WINAPI RecompileThreadRT(LPVOID) {
+    s_recompileJob.result = CreateRTPipeline(s_recompileJob.features, &s_recompileJob.indirectResult,
+                                             &s_recompileJob.depthResult);
+    InterlockedExchange(&s_recompileJob.done, 1);
+    return 0;
+}
+
+static void StartRecompileRT(const ShaderFeatures& features) {
+    s_recompileJob.features = features;
+    s_recompileJob.result = nullptr;
+    s_recompileJob.indirectResult = nullptr;
+    s_recompileJob.depthResult = nullptr;
+    s_recompileJob.done = 0;
+    s_recompileJob.thread = CreateThread(nullptr, 0, RecompileThreadRT, nullptr, 0, nullptr);
+    if (!s_recompileJob.thread) Log("[ERROR] Failed to start shader recompile thread\n");
+}
+
+static void WaitForRecompileRT() {
+    if (!s_recompileJob.thread) return;
+    WaitForSingleObject(s_recompileJob.thread, INFINITE);
+    CloseHandle(s_recompileJob.thread);
+    s_recompileJob.thread = nullptr;
+}
+
+static void ReleaseRetiredPSOs(bool all) {
+    UINT64 completed = s_fence ? s_fence->GetCompletedValue() : 0;
+    for (size_t i = 0; i < s_retiredPSOs.size();) {
+        if (all || completed >= s_retiredPSOs[i].fenceValue) {
+            s_retiredPSOs[i].pso->Release();
+            s_retiredPSOs[i] = s_retiredPSOs.back();
+            s_retiredPSOs.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+// Called at the top of each frame, before the command list is reset with s_pso
+static void UpdateRecompileRT(const ShaderFeatures& wanted) {
+    if (s_recompileJob.thread && InterlockedCompareExchange(&s_recompileJob.done, 0, 0)) {
+        WaitForRecompileRT();
+        if (s_recompileJob.result) {
+            // Frames recorded so far have signaled at most s_fenceValues[s_frameIndex] - 1
+            if (s_pso) s_retiredPSOs.push_back({ s_pso, s_fenceValues[s_frameIndex] - 1 });
+            if (s_indirectPso) s_retiredPSOs.push_back({ s_indirectPso, s_fenceValues[s_frameIndex] - 1 });
+            if (s_depthPso) s_retiredPSOs.push_back({ s_depthPso, s_fenceValues[s_frameIndex] - 1 });
+            s_pso = s_recompileJob.result;
+            s_indirectPso = s_recompileJob.indirectResult;
+            s_depthPso = s_recompileJob.depthResult;
+            s_recompileJob.result = nullptr;
+            s_recompileJob.indirectResult = nullptr;
+            s_recompileJob.depthResult = nullptr;
+            s_compiledFeatures = s_recompileJob.features;
+            s_hasFailedFeatures = false;
+            s_cachedFps = -1;
+            Log("[INFO] Shaders recompiled, new PSO swapped in\n");
+        } else {
+            Log("[ERROR] Shader recompilation failed, keeping previous PSO\n");
+            s_failedFeatures = s_recompileJob.features;
+            s_hasFailedFeatures = true;
+        }
+    }
+
+    ReleaseRetiredPSOs(false);
+
+    // The wanted set may have changed again while a job ran; start the next one now
+    if (!s_recompileJob.thread && wanted != s_compiledFeatures &&
+        !(s_hasFailedFeatures && wanted == s_failedFeatures)) {
+        StartRecompileRT(wanted);
+    }
+}
+
+// ============== SIZE-DEPENDENT RESOURCES ==============
+// Back buffer RTVs, depth, history and --rt-indirect buffers for the current
+// W x H. Used by InitD3D12RT and ResizeD3D12RT (heaps already exist).
+static bool CreateSizeDependentRT() {
+    // Create RTVs
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = s_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+    for (UINT i = 0; i < 3; i++) {
+        if (FAILED(s_swapChain->GetBuffer(i, IID_PPV_ARGS(&s_renderTargets[i])))) { Log("[ERROR] GetBuffer failed\n"); return false; }
+        s_device->CreateRenderTargetView(s_renderTargets[i], nullptr, rtvHandle);
+        rtvHandle.ptr += s_rtvDescSize;
+    }
+
+    // Depth buffer
+    D3D12_RESOURCE_DESC depthDesc = {};
+    depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    depthDesc.Width = W;
+    depthDesc.Height = H;
+    depthDesc.DepthOrArraySize = 1;
+    depthDesc.MipLevels = 1;
+    depthDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    depthDesc.SampleDesc.Count = 1;
+    depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+    D3D12_CLEAR_VALUE clearValue = {};
+    clearValue.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    clearValue.DepthStencil.Depth = 1.0f;
+
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    HRESULT hr = s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &depthDesc,
+        D3D12_RESOURCE_STATE_DEPTH_WRITE, &clearValue, IID_PPV_ARGS(&s_depthStencil));
+    if (FAILED(hr)) { Log("[ERROR] Create depth buffer failed\n"); return false; }
+
+    D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+    dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+    s_device->CreateDepthStencilView(s_depthStencil, &dsvDesc, s_dsvHeap->GetCPUDescriptorHandleForHeapStart());
+
+    // Create history buffer for temporal denoising (same format as render target)
+    D3D12_RESOURCE_DESC historyDesc = {};
+    historyDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    historyDesc.Width = W;
+    historyDesc.Height = H;
+    historyDesc.DepthOrArraySize = 1;
+    historyDesc.MipLevels = 1;
+    historyDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    historyDesc.SampleDesc.Count = 1;
+    historyDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+    hr = s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &historyDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&s_historyBuffer));
+    if (FAILED(hr)) { Log("[ERROR] Create history buffer failed\n"); return false; }
+    s_historyValid = false;
+
+    // Reduced-rate AO/GI targets, kept in PIXEL_SHADER_RESOURCE between passes
+    s_indirectValid = false;
+    if (g_rtIndirectRate != RT_INDIRECT_FULL) {
+        D3D12_RESOURCE_DESC indirectDesc = historyDesc;
+        indirectDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        indirectDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+        D3D12_CLEAR_VALUE indirectClear = {};
+        indirectClear.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        ID3D12Resource** targets[2] = { &s_indirectBuffer, &s_indirectGuide };
+        for (UINT i = 0; i < 2; i++) {
+            hr = s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &indirectDesc,
+                D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, &indirectClear, IID_PPV_ARGS(targets[i]));
+            if (FAILED(hr)) { Log("[ERROR] Create indirect buffer failed\n"); return false; }
+            s_device->CreateRenderTargetView(*targets[i], nullptr, rtvHandle);
+            rtvHandle.ptr += s_rtvDescSize;
+        }
+    }
+    return true;
+}
+
+// t2/t3: indirect buffer and guide SRVs. Null descriptors with --rt-indirect=full,
+// the table always spans 4 slots.
+static void CreateIndirectSrvsRT() {
+    UINT srvDescSize = s_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = s_srvHeap->GetCPUDescriptorHandleForHeapStart();
+    srvHandle.ptr += 2 * srvDescSize;
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Texture2D.MipLevels = 1;
+    s_device->CreateShaderResourceView(s_indirectBuffer, &srvDesc, srvHandle);
+    srvHandle.ptr += srvDescSize;
+    s_device->CreateShaderResourceView(s_indirectGuide, &srvDesc, srvHandle);
+}
+
+// ============== VARIABLE RATE SHADING ==============
+// --vrs: shading rate image for the current W x H (one texel per tile) and its
+// UAV in SRV heap slot 5. Used by InitVrsRT and ResizeD3D12RT.
+static bool CreateVrsImageRT() {
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    desc.Width = (W + s_vrsTileSize - 1) / s_vrsTileSize;
+    desc.Height = (H + s_vrsTileSize - 1) / s_vrsTileSize;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = DXGI_FORMAT_R8_UINT;
+    desc.SampleDesc.Count = 1;
+    desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
+    HRESULT hr = s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE, nullptr, IID_PPV_ARGS(&s_vrsImage));
+    if (FAILED(hr)) { LogHR("Create shading rate image", hr); return false; }
+
+    UINT srvDescSize = s_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE uavHandle = s_srvHeap->GetCPUDescriptorHandleForHeapStart();
+    uavHandle.ptr += 5 * srvDescSize;
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.Format = DXGI_FORMAT_R8_UINT;
+    uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    s_device->CreateUnorderedAccessView(s_vrsImage, nullptr, &uavDesc, uavHandle);
     return true;
 }
 
+// Tier 2 check, rate pass root signature / PSO and the first image. Any
+// failure leaves s_vrsTileSize = 0 and the frame renders at 1x1.
+static void InitVrsRT() {
+    if (!g_rtVrs) return;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS6 options6 = {};
+    if (FAILED(s_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS6, &options6, sizeof(options6))) ||
+        options6.VariableShadingRateTier < D3D12_VARIABLE_SHADING_RATE_TIER_2 || options6.ShadingRateImageTileSize == 0) {
+        Log("[WARN] --vrs needs VRS Tier 2, shading at full rate\n");
+        return;
+    }
+    if (FAILED(s_cmdList->QueryInterface(IID_PPV_ARGS(&s_cmdList5)))) {
+        Log("[WARN] --vrs: no ID3D12GraphicsCommandList5, shading at full rate\n");
+        return;
+    }
+
+    // b0: VrsCB root constants; table t0 = history (slot 1), u0 = rate image (slot 5)
+    D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+    ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[0].NumDescriptors = 1;
+    ranges[0].OffsetInDescriptorsFromTableStart = 1;
+    ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    ranges[1].NumDescriptors = 1;
+    ranges[1].OffsetInDescriptorsFromTableStart = 5;
+    D3D12_ROOT_PARAMETER params[2] = {};
+    params[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    params[0].Constants.Num32BitValues = 4;
+    params[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    params[1].DescriptorTable.NumDescriptorRanges = 2;
+    params[1].DescriptorTable.pDescriptorRanges = ranges;
+    D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
+    rsDesc.NumParameters = 2;
+    rsDesc.pParameters = params;
+
+    ID3DBlob* rsBlob = nullptr, *rsError = nullptr;
+    HRESULT hr = D3D12SerializeRootSignature(&rsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &rsBlob, &rsError);
+    if (rsError) { Log("[ERROR] VRS root sig: %s\n", (char*)rsError->GetBufferPointer()); rsError->Release(); }
+    if (FAILED(hr)) return;
+    hr = s_device->CreateRootSignature(0, rsBlob->GetBufferPointer(), rsBlob->GetBufferSize(), IID_PPV_ARGS(&s_vrsRootSig));
+    rsBlob->Release();
+    if (FAILED(hr)) { LogHR("CreateRootSignature (VRS)", hr); return; }
+
+    ID3DBlob* cs = nullptr;
+    if (!CompileShaderDXC(g_vrsShaderCode, L"VrsRateCS", L"cs_6_0", &cs)) { Log("[ERROR] VRS rate shader failed\n"); return; }
+    D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.pRootSignature = s_vrsRootSig;
+    psoDesc.CS = { cs->GetBufferPointer(), cs->GetBufferSize() };
+    hr = PipelineCacheCreateCompute(s_device, L"RT_VrsRate", psoDesc, &s_vrsPso);
+    cs->Release();
+    if (FAILED(hr)) { LogHR("CreateComputePipelineState (VRS)", hr); return; }
+
+    s_vrsTileSize = options6.ShadingRateImageTileSize;
+    if (!CreateVrsImageRT()) { s_vrsTileSize = 0; return; }
+    Log("[INFO] VRS Tier 2: %ux%u tiles, 2x2 below luminance variance %.4f\n",
+        s_vrsTileSize, s_vrsTileSize, g_rtVrsThreshold);
+}
+
+// Rate pass: last frame's history -> shading rate image. The history must be
+// valid (PIXEL_SHADER_RESOURCE); leaves s_pso bound for the lighting pass.
+static void RecordVrsRatePassRT() {
+    D3D12_RESOURCE_BARRIER barriers[2] = {};
+    for (UINT i = 0; i < 2; i++) {
+        barriers[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barriers[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    }
+    barriers[0].Transition.pResource = s_historyBuffer;
+    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    barriers[1].Transition.pResource = s_vrsImage;
+    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE;
+    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    s_cmdList->ResourceBarrier(2, barriers);
+
+    UINT constants[4] = { W, H, s_vrsTileSize, 0 };
+    memcpy(&constants[3], &g_rtVrsThreshold, sizeof(float));
+    s_cmdList->SetComputeRootSignature(s_vrsRootSig);
+    ID3D12DescriptorHeap* heaps[] = { s_srvHeap };
+    s_cmdList->SetDescriptorHeaps(1, heaps);
+    s_cmdList->SetComputeRoot32BitConstants(0, 4, constants, 0);
+    s_cmdList->SetComputeRootDescriptorTable(1, s_srvHeap->GetGPUDescriptorHandleForHeapStart());
+    s_cmdList->SetPipelineState(s_vrsPso);
+    s_cmdList->Dispatch((W + s_vrsTileSize - 1) / s_vrsTileSize, (H + s_vrsTileSize - 1) / s_vrsTileSize, 1);
+
+    barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE;
+    s_cmdList->ResourceBarrier(2, barriers);
+    s_cmdList->SetPipelineState(s_pso);
+}
+
+// Room + animated cube (the VS rotates it) with the bound PSO
+static void DrawSceneRT() {
+    s_cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    s_cmdList->IASetVertexBuffers(0, 1, &s_vbView);
+    s_cmdList->IASetIndexBuffer(&s_ibView);
+    s_cmdList->DrawIndexedInstanced(s_indexCount, 1, 0, 0, 0);
+    s_cmdList->IASetVertexBuffers(0, 1, &s_vbViewCube);
+    s_cmdList->IASetIndexBuffer(&s_ibViewCube);
+    s_cmdList->DrawIndexedInstanced(s_indexCountCube, 1, 0, 0, 0);
+}
+
+// --depth-prepass: nearest depth for the bound viewport, so the EQUAL-tested
+// shading pass after it runs its pixel shader (and RayQueries) once per pixel.
+// Root signature and constants must be bound; leaves s_depthPso bound.
+static void RecordDepthPrepassRT(D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle) {
+    s_cmdList->OMSetRenderTargets(0, nullptr, FALSE, &dsvHandle);
+    s_cmdList->SetPipelineState(s_depthPso);
+    DrawSceneRT();
+}
+
+// Indirect pass: AO/GI rays for the IndirectSize corner of the indirect
+// targets, before the lighting pass samples them. Leaves s_pso bound.
+static void RecordIndirectPassRT(D3D12_GPU_VIRTUAL_ADDRESS cbGpu, UINT indirectW, UINT indirectH) {
+    D3D12_RESOURCE_BARRIER barriers[2] = {};
+    ID3D12Resource* targets[2] = { s_indirectBuffer, s_indirectGuide };
+    for (UINT i = 0; i < 2; i++) {
+        barriers[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barriers[i].Transition.pResource = targets[i];
+        barriers[i].Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        barriers[i].Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        barriers[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    }
+    s_cmdList->ResourceBarrier(2, barriers);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = s_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+    rtvHandle.ptr += 3 * s_rtvDescSize;
+    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = s_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+
+    // Checkerboard keeps the other half from last frame; guide w = 0 marks "no surface"
+    if (g_rtIndirectRate != RT_INDIRECT_CHECKER || !s_indirectValid) {
+        float clearColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = rtvHandle;
+        s_cmdList->ClearRenderTargetView(handle, clearColor, 0, nullptr);
+        handle.ptr += s_rtvDescSize;
+        s_cmdList->ClearRenderTargetView(handle, clearColor, 0, nullptr);
+    }
+    s_cmdList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+
+    s_cmdList->SetGraphicsRootSignature(s_rootSig);
+    ID3D12DescriptorHeap* heaps[] = { s_srvHeap };
+    s_cmdList->SetDescriptorHeaps(1, heaps);
+    s_cmdList->SetGraphicsRootConstantBufferView(0, cbGpu);
+    s_cmdList->SetGraphicsRootDescriptorTable(1, s_srvHeap->GetGPUDescriptorHandleForHeapStart());
+    if (RayCountersAddress12()) s_cmdList->SetGraphicsRootUnorderedAccessView(2, RayCountersAddress12());
+
+    D3D12_VIEWPORT vp = { 0, 0, (float)indirectW, (float)indirectH, 0, 1 };
+    D3D12_RECT scissor = { 0, 0, (LONG)indirectW, (LONG)indirectH };
+    s_cmdList->RSSetViewports(1, &vp);
+    s_cmdList->RSSetScissorRects(1, &scissor);
+
+    if (s_depthPso) RecordDepthPrepassRT(dsvHandle);
+    s_cmdList->OMSetRenderTargets(2, &rtvHandle, TRUE, &dsvHandle);
+    s_cmdList->SetPipelineState(s_indirectPso);
+    DrawSceneRT();
+
+    for (UINT i = 0; i < 2; i++) {
+        barriers[i].Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        barriers[i].Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    }
+    s_cmdList->ResourceBarrier(2, barriers);
+    s_cmdList->SetPipelineState(s_pso);
+    s_indirectValid = true;
+}
+
+// ============== VRAM CATEGORIES ==============
+static void VramCategoriesRT(UINT64 bytes[VRAM_CATEGORY_COUNT]) {
+    bytes[VRAM_BLAS] += ResourceBytes12(s_blasBufferStatic) + ResourceBytes12(s_blasBufferCube);
+    bytes[VRAM_TLAS] += ResourceBytes12(s_tlasBuffer) + ResourceBytes12(s_instanceBuffer);
+    bytes[VRAM_SCRATCH] += ResourceBytes12(s_scratchBuffer);
+    bytes[VRAM_GBUFFER] += ResourceBytes12(s_indirectBuffer) + ResourceBytes12(s_indirectGuide) + ResourceBytes12(s_vrsImage);
+    bytes[VRAM_HISTORY] += ResourceBytes12(s_historyBuffer);
+}
+
 // ============== INITIALIZATION ==============
 bool InitD3D12RT(HWND hwnd) {
     Log("[INFO] Initializing D3D12 + Ray Tracing (from scratch)...\n");
 
     HRESULT hr;
+    StartupStep("Device");
 
     // Enable debug layer
     #ifdef _DEBUG
@@ -732,6 +1163,7 @@ bool InitD3D12RT(HWND hwnd) {
         factory->Release();
         return false;
     }
+    PipelineCacheOpen(s_device);
 
     // Create command queue
     D3D12_COMMAND_QUEUE_DESC queueDesc = {};
@@ -740,6 +1172,7 @@ bool InitD3D12RT(HWND hwnd) {
     if (FAILED(hr)) { Log("[ERROR] CreateCommandQueue failed\n"); return false; }
 
     // Create swap chain
+    StartupStep("Swap chain + frame resources");
     DXGI_SWAP_CHAIN_DESC1 swapDesc = {};
     swapDesc.Width = W;
     swapDesc.Height = H;
@@ -748,13 +1181,14 @@ bool InitD3D12RT(HWND hwnd) {
     swapDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
     swapDesc.BufferCount = 3;
     swapDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    swapDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    swapDesc.Flags = DxgiSwapChainFlags(true);
 
     IDXGISwapChain1* swapChain1 = nullptr;
-    hr = factory->CreateSwapChainForHwnd(s_cmdQueue, hwnd, &swapDesc, nullptr, nullptr, &swapChain1);
+    hr = DxgiCreateSwapChain(factory, s_cmdQueue, hwnd, swapDesc, &swapChain1);
     factory->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
     swapChain1->QueryInterface(IID_PPV_ARGS(&s_swapChain));
     swapChain1->Release();
+    s_swapWaitable = DxgiInitFrameLatency(s_swapChain, "D3D12 RT");
     factory->Release();
     if (adapter) adapter->Release();
 
@@ -762,61 +1196,19 @@ bool InitD3D12RT(HWND hwnd) {
 
     // Create RTV heap
     D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-    rtvHeapDesc.NumDescriptors = 3;
+    rtvHeapDesc.NumDescriptors = 5;  // Back buffers + --rt-indirect targets
     rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
     s_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&s_rtvHeap));
     s_rtvDescSize = s_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 
-    // Create RTVs
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = s_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-    for (UINT i = 0; i < 3; i++) {
-        s_swapChain->GetBuffer(i, IID_PPV_ARGS(&s_renderTargets[i]));
-        s_device->CreateRenderTargetView(s_renderTargets[i], nullptr, rtvHandle);
-        rtvHandle.ptr += s_rtvDescSize;
-    }
-
-    // Create DSV heap and depth buffer
+    // Create DSV heap
     D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
     dsvHeapDesc.NumDescriptors = 1;
     dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
     s_device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&s_dsvHeap));
 
-    D3D12_RESOURCE_DESC depthDesc = {};
-    depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    depthDesc.Width = W;
-    depthDesc.Height = H;
-    depthDesc.DepthOrArraySize = 1;
-    depthDesc.MipLevels = 1;
-    depthDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    depthDesc.SampleDesc.Count = 1;
-    depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-
-    D3D12_CLEAR_VALUE clearValue = {};
-    clearValue.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    clearValue.DepthStencil.Depth = 1.0f;
-
-    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
-    s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &depthDesc,
-        D3D12_RESOURCE_STATE_DEPTH_WRITE, &clearValue, IID_PPV_ARGS(&s_depthStencil));
-
-    D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
-    dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-    s_device->CreateDepthStencilView(s_depthStencil, &dsvDesc, s_dsvHeap->GetCPUDescriptorHandleForHeapStart());
-
-    // Create history buffer for temporal denoising (same format as render target)
-    D3D12_RESOURCE_DESC historyDesc = {};
-    historyDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    historyDesc.Width = W;
-    historyDesc.Height = H;
-    historyDesc.DepthOrArraySize = 1;
-    historyDesc.MipLevels = 1;
-    historyDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    historyDesc.SampleDesc.Count = 1;
-    historyDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &historyDesc,
-        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&s_historyBuffer));
-    s_historyValid = false;
+    // Back buffer RTVs, depth buffer, history buffer
+    if (!CreateSizeDependentRT()) return false;
 
     // Create command allocators
     for (UINT i = 0; i < 3; i++) {
@@ -826,8 +1218,11 @@ bool InitD3D12RT(HWND hwnd) {
     // Create fence
     s_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&s_fence));
     s_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!InitFrameRing12(s_frameRing, s_device, s_fence, FRAME_RING_SIZE, "D3D12 RT")) return false;
 
     // ============== BUILD GEOMETRY ==============
+    StartupStep("Geometry + upload");
+    D3D12_HEAP_PROPERTIES defaultHeap = { D3D12_HEAP_TYPE_DEFAULT };
     D3D12_HEAP_PROPERTIES uploadHeap = { D3D12_HEAP_TYPE_UPLOAD };
     D3D12_RESOURCE_DESC bufDesc = {};
     bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
@@ -846,21 +1241,11 @@ bool InitD3D12RT(HWND hwnd) {
     s_indexCountStatic = (UINT)indsStatic.size();
     Log("[INFO] Static geometry: %u vertices, %u indices\n", s_vertexCountStatic, s_indexCountStatic);
 
+    if (!UploadBegin12(s_device)) return false;
     UINT vbSizeStatic = s_vertexCountStatic * sizeof(RTVert);
-    bufDesc.Width = vbSizeStatic;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_vertexBufferStatic));
-    s_vertexBufferStatic->Map(0, nullptr, &mapped);
-    memcpy(mapped, vertsStatic.data(), vbSizeStatic);
-    s_vertexBufferStatic->Unmap(0, nullptr);
-
+    s_vertexBufferStatic = UploadBuffer12(vertsStatic.data(), vbSizeStatic, "RT static VB");
     UINT ibSizeStatic = s_indexCountStatic * sizeof(UINT);
-    bufDesc.Width = ibSizeStatic;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_indexBufferStatic));
-    s_indexBufferStatic->Map(0, nullptr, &mapped);
-    memcpy(mapped, indsStatic.data(), ibSizeStatic);
-    s_indexBufferStatic->Unmap(0, nullptr);
+    s_indexBufferStatic = UploadBuffer12(indsStatic.data(), ibSizeStatic, "RT static IB");
 
     // --- DYNAMIC GEOMETRY (cube, at origin) ---
     std::vector<RTVert> vertsCube;
@@ -871,20 +1256,17 @@ bool InitD3D12RT(HWND hwnd) {
     Log("[INFO] Dynamic cube: %u vertices, %u indices\n", s_vertexCountCube, s_indexCountCube);
 
     UINT vbSizeCube = s_vertexCountCube * sizeof(RTVert);
-    bufDesc.Width = vbSizeCube;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_vertexBufferCube));
-    s_vertexBufferCube->Map(0, nullptr, &mapped);
-    memcpy(mapped, vertsCube.data(), vbSizeCube);
-    s_vertexBufferCube->Unmap(0, nullptr);
-
+    s_vertexBufferCube = UploadBuffer12(vertsCube.data(), vbSizeCube, "RT cube VB");
     UINT ibSizeCube = s_indexCountCube * sizeof(UINT);
-    bufDesc.Width = ibSizeCube;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_indexBufferCube));
-    s_indexBufferCube->Map(0, nullptr, &mapped);
-    memcpy(mapped, indsCube.data(), ibSizeCube);
-    s_indexBufferCube->Unmap(0, nullptr);
+    s_indexBufferCube = UploadBuffer12(indsCube.data(), ibSizeCube, "RT cube IB");
+    s_blueNoise = RTBlueNoiseUpload12("RT");
+    bool noiseOk = s_blueNoise || g_rtSampler != RT_SAMPLER_BLUENOISE;
+
+    // One copy-queue submission for all of them; BLAS builds below read them from DEFAULT heap
+    if (!UploadFlush12() || !s_vertexBufferStatic || !s_indexBufferStatic || !s_vertexBufferCube || !s_indexBufferCube || !noiseOk) {
+        Log("[ERROR] RT geometry upload failed\n");
+        return false;
+    }
 
     // Static geometry views for rasterization
     s_vertexCount = s_vertexCountStatic;
@@ -904,17 +1286,14 @@ bool InitD3D12RT(HWND hwnd) {
     s_ibViewCube.SizeInBytes = ibSizeCube;
     s_ibViewCube.Format = DXGI_FORMAT_R32_UINT;
 
-    // Create constant buffer
-    bufDesc.Width = 256;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_constantBuffer));
-    s_constantBuffer->Map(0, nullptr, &s_cbMapped);
-
     // Create command list
+    StartupStep("Acceleration structures");
     ID3D12GraphicsCommandList* baseCmdList = nullptr;
     s_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, s_cmdAlloc[0], nullptr, IID_PPV_ARGS(&baseCmdList));
     baseCmdList->QueryInterface(IID_PPV_ARGS(&s_cmdList));
     baseCmdList->Release();
+    StartupGpuTimer12 asTimer;
+    StartupGpuBegin12(asTimer, s_device, s_cmdQueue, s_cmdList);
 
     // ============== BUILD ACCELERATION STRUCTURES ==============
     D3D12_RESOURCE_DESC asDesc = {};
@@ -940,7 +1319,7 @@ bool InitD3D12RT(HWND hwnd) {
     blasInputsStatic.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
     blasInputsStatic.NumDescs = 1;
     blasInputsStatic.pGeometryDescs = &geomDescStatic;
-    blasInputsStatic.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+    blasInputsStatic.Flags = BLAS_STATIC_FLAGS12;
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO blasPrebuildStatic = {};
     s_device->GetRaytracingAccelerationStructurePrebuildInfo(&blasInputsStatic, &blasPrebuildStatic);
@@ -966,7 +1345,7 @@ bool InitD3D12RT(HWND hwnd) {
     blasInputsCube.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
     blasInputsCube.NumDescs = 1;
     blasInputsCube.pGeometryDescs = &geomDescCube;
-    blasInputsCube.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+    blasInputsCube.Flags = BLAS_STATIC_FLAGS12;
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO blasPrebuildCube = {};
     s_device->GetRaytracingAccelerationStructurePrebuildInfo(&blasInputsCube, &blasPrebuildCube);
@@ -1004,6 +1383,10 @@ bool InitD3D12RT(HWND hwnd) {
     uavBarrier.UAV.pResource = s_blasBufferCube;
     s_cmdList->ResourceBarrier(1, &uavBarrier);
 
+    // Compact both BLASes while nothing references them yet (see d3d12_blas.cpp)
+    ID3D12Resource** blases[] = { &s_blasBufferStatic, &s_blasBufferCube };
+    bool blasBuilt = CompactBLAS12(s_device, s_cmdQueue, s_cmdAlloc[0], s_cmdList, blases, 2, "DXR 1.1");
+
     // --- TLAS with 2 instances (static + cube) ---
     D3D12_RAYTRACING_INSTANCE_DESC instances[2] = {};
 
@@ -1034,26 +1417,30 @@ bool InitD3D12RT(HWND hwnd) {
     s_instanceBuffer->Map(0, nullptr, &s_instanceMapped);  // Keep mapped for runtime updates!
     memcpy(s_instanceMapped, instances, sizeof(instances));
 
-    // TLAS with ALLOW_UPDATE for efficient per-frame rebuilds
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs = {};
-    tlasInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    tlasInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    tlasInputs.NumDescs = 2;  // Static + Cube
-    tlasInputs.InstanceDescs = s_instanceBuffer->GetGPUVirtualAddress();
-    tlasInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD |
-                       D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
+    // TLAS with ALLOW_UPDATE for per-frame refits
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS tlasInputs;
+    TlasInputs12(tlasInputs, 2, s_instanceBuffer->GetGPUVirtualAddress());  // Static + Cube
+    TlasPolicyInvalidate(s_tlasPolicy);
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO tlasPrebuild = {};
     s_device->GetRaytracingAccelerationStructurePrebuildInfo(&tlasInputs, &tlasPrebuild);
 
     // Make sure scratch buffer is big enough for TLAS too
-    s_tlasScratchSize = max(s_tlasScratchSize, tlasPrebuild.ScratchDataSizeInBytes);
+    s_tlasScratchSize = max(s_tlasScratchSize, TlasScratchSize12(tlasPrebuild));
 
     asDesc.Width = tlasPrebuild.ResultDataMaxSizeInBytes;
     asDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
     s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc,
         D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE, nullptr, IID_PPV_ARGS(&s_tlasBuffer));
 
+    // The BLAS builds have finished: swap their scratch for one sized for the TLAS build / refit
+    if (blasBuilt) {
+        s_scratchBuffer->Release();
+        asDesc.Width = TlasScratchSize12(tlasPrebuild);
+        s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &asDesc,
+            D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&s_scratchBuffer));
+    }
+
     // Initial TLAS build
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC tlasBuildDesc = {};
     tlasBuildDesc.Inputs = tlasInputs;
@@ -1067,18 +1454,21 @@ bool InitD3D12RT(HWND hwnd) {
     Log("[INFO] TLAS built with 2 instances (static + dynamic cube)\n");
 
     // Execute AS build commands
+    StartupGpuEnd12(asTimer, s_cmdList);
     s_cmdList->Close();
     ID3D12CommandList* lists[] = { s_cmdList };
     s_cmdQueue->ExecuteCommandLists(1, lists);
     WaitForGpuRT();
+    StartupGpuCollect12(asTimer, "BLAS + TLAS build");
     s_cmdAlloc[0]->Reset();
     s_cmdList->Reset(s_cmdAlloc[0], nullptr);
 
     Log("[INFO] Acceleration structures built\n");
 
     // ============== SRV HEAP FOR TLAS + HISTORY ==============
+    StartupStep("Descriptors + root signature");
     D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-    srvHeapDesc.NumDescriptors = 2;  // t0: TLAS, t1: History buffer
+    srvHeapDesc.NumDescriptors = 6;  // t0: TLAS, t1: History buffer, t2-t3: Indirect buffer + guide, t0 space1: blue noise, --vrs rate image UAV
     srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
     srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
     s_device->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&s_srvHeap));
@@ -1102,25 +1492,45 @@ bool InitD3D12RT(HWND hwnd) {
     historySrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     historySrvDesc.Texture2D.MipLevels = 1;
     s_device->CreateShaderResourceView(s_historyBuffer, &historySrvDesc, srvHandle);
+    CreateIndirectSrvsRT();
+
+    // t0 space1: blue noise tile (null view for the other samplers)
+    D3D12_CPU_DESCRIPTOR_HANDLE blueNoiseHandle = s_srvHeap->GetCPUDescriptorHandleForHeapStart();
+    blueNoiseHandle.ptr += 4 * srvDescSize;
+    RTBlueNoiseCreateSrv12(s_device, s_blueNoise, blueNoiseHandle);
+
+    // Slot 5: --vrs shading rate image (compute root signature of its own)
+    InitVrsRT();
 
     // ============== ROOT SIGNATURE ==============
-    D3D12_ROOT_PARAMETER rootParams[2] = {};
+    // --ray-stats counters (u0 space2) as root UAV 2, only when they exist
+    InitRayCounters12(s_device);
+    D3D12_ROOT_PARAMETER rootParams[3] = {};
     // b0: CBV
     rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     rootParams[0].Descriptor.ShaderRegister = 0;
     rootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
-    // t0: TLAS, t1: History buffer
-    D3D12_DESCRIPTOR_RANGE range = {};
-    range.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-    range.NumDescriptors = 2;  // t0=TLAS, t1=History
-    range.BaseShaderRegister = 0;
+    // t0: TLAS, t1: History buffer, t2-t3: Indirect buffer + guide; t0 space1: blue noise
+    D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+    ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[0].NumDescriptors = 4;  // t0=TLAS, t1=History, t2=Indirect, t3=Guide
+    ranges[0].BaseShaderRegister = 0;
+    ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    ranges[1].NumDescriptors = 1;
+    ranges[1].BaseShaderRegister = 0;
+    ranges[1].RegisterSpace = 1;
+    ranges[1].OffsetInDescriptorsFromTableStart = 4;
     rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    rootParams[1].DescriptorTable.NumDescriptorRanges = 1;
-    rootParams[1].DescriptorTable.pDescriptorRanges = &range;
+    rootParams[1].DescriptorTable.NumDescriptorRanges = 2;
+    rootParams[1].DescriptorTable.pDescriptorRanges = ranges;
     rootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    rootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    rootParams[2].Descriptor.ShaderRegister = 0;
+    rootParams[2].Descriptor.RegisterSpace = 2;
+    rootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
     D3D12_ROOT_SIGNATURE_DESC rsDesc = {};
-    rsDesc.NumParameters = 2;
+    rsDesc.NumParameters = RayCountersAddress12() ? 3 : 2;
     rsDesc.pParameters = rootParams;
     rsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
@@ -1131,231 +1541,30 @@ bool InitD3D12RT(HWND hwnd) {
     rsBlob->Release();
 
     // ============== COMPILE SHADERS ==============
+    StartupStep("Pipelines");
     Log("[INFO] Compiling RT shaders with feature defines...\n");
     s_compiledFeatures = GetCurrentShaderFeatures();
     // Don't enable temporal denoise at init - history buffer isn't valid yet
     // It will be enabled on subsequent frames once history is valid
     s_compiledFeatures.temporalDenoise = false;
-    const wchar_t* defines[10];
-    int defineCount = BuildShaderDefines(s_compiledFeatures, defines);
-
-    // Select shader model: 6.5 for RayQuery, 6.0 for compatibility
-    const wchar_t* vsTarget = s_compiledFeatures.useRayQuery ? L"vs_6_5" : L"vs_6_0";
-    const wchar_t* psTarget = s_compiledFeatures.useRayQuery ? L"ps_6_5" : L"ps_6_0";
-
-    Log("[INFO] Shader Model: %ls, Features: %s%s%s%s%s%s%s%s\n",
-        psTarget,
-        s_compiledFeatures.useRayQuery ? "RAYQUERY " : "",
-        s_compiledFeatures.shadows ? "SHADOWS " : "",
-        s_compiledFeatures.softShadows ? "SOFT_SHADOWS " : "",
-        s_compiledFeatures.rtLighting ? "RT_LIGHTING " : "",
-        s_compiledFeatures.ao ? "AO " : "",
-        s_compiledFeatures.gi ? "GI " : "",
-        s_compiledFeatures.reflections ? "REFLECTIONS " : "",
-        s_compiledFeatures.temporalDenoise ? "TEMPORAL_DENOISE " : "");
-
-    ID3DBlob* vsBlob = nullptr, *psBlob = nullptr;
-    if (!CompileShaderDXC(g_rtCornellShaderCode, L"VSMain", vsTarget, &vsBlob, defines, defineCount)) return false;
-    if (!CompileShaderDXC(g_rtCornellShaderCode, L"PSMain", psTarget, &psBlob, defines, defineCount)) { vsBlob->Release(); return false; }
-    Log("[INFO] Shaders compiled (VS: %zu, PS: %zu bytes)\n", vsBlob->GetBufferSize(), psBlob->GetBufferSize());
+    s_pso = CreateRTPipeline(s_compiledFeatures, &s_indirectPso, &s_depthPso);
+    if (!s_pso) { Log("[ERROR] CreatePSO failed\n"); return false; }
 
-    // ============== PSO ==============
-    D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"OBJECTID", 0, DXGI_FORMAT_R32_UINT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"MATERIALTYPE", 0, DXGI_FORMAT_R32_UINT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-    };
-
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
-    psoDesc.InputLayout = { inputLayout, _countof(inputLayout) };
-    psoDesc.pRootSignature = s_rootSig;
-    psoDesc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
-    psoDesc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
-    psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;  // No culling - show both sides
-    psoDesc.RasterizerState.FrontCounterClockwise = TRUE;
-    psoDesc.RasterizerState.DepthClipEnable = TRUE;
-    psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
-    psoDesc.DepthStencilState.DepthEnable = TRUE;
-    psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
-    psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
-    psoDesc.SampleMask = UINT_MAX;
-    psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    psoDesc.NumRenderTargets = 1;
-    psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-    psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    psoDesc.SampleDesc.Count = 1;
-
-    hr = s_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&s_pso));
-    vsBlob->Release();
-    psBlob->Release();
-    if (FAILED(hr)) { Log("[ERROR] CreatePSO failed\n"); return false; }
-
-    // ============== TEXT RENDERING SETUP ==============
-    // Text root signature
-    D3D12_DESCRIPTOR_RANGE texRange = {};
-    texRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-    texRange.NumDescriptors = 1;
-    texRange.BaseShaderRegister = 0;
-
-    D3D12_ROOT_PARAMETER textParams[1] = {};
-    textParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    textParams[0].DescriptorTable.NumDescriptorRanges = 1;
-    textParams[0].DescriptorTable.pDescriptorRanges = &texRange;
-    textParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    D3D12_STATIC_SAMPLER_DESC sampler = {};
-    sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-    sampler.AddressU = sampler.AddressV = sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    sampler.ShaderRegister = 0;
-    sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    D3D12_ROOT_SIGNATURE_DESC textRsDesc = {};
-    textRsDesc.NumParameters = 1;
-    textRsDesc.pParameters = textParams;
-    textRsDesc.NumStaticSamplers = 1;
-    textRsDesc.pStaticSamplers = &sampler;
-    textRsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
-
-    D3D12SerializeRootSignature(&textRsDesc, D3D_ROOT_SIGNATURE_VERSION_1, &rsBlob, &rsError);
-    s_device->CreateRootSignature(0, rsBlob->GetBufferPointer(), rsBlob->GetBufferSize(), IID_PPV_ARGS(&s_textRootSig));
-    rsBlob->Release();
-
-    // Text shaders
-    ID3DBlob* textVs = nullptr, *textPs = nullptr;
-    D3DCompile(g_textShaderCode, strlen(g_textShaderCode), nullptr, nullptr, nullptr, "TextVS", "vs_5_0", 0, 0, &textVs, nullptr);
-    D3DCompile(g_textShaderCode, strlen(g_textShaderCode), nullptr, nullptr, nullptr, "TextPS", "ps_5_0", 0, 0, &textPs, nullptr);
-
-    // Text PSO
-    D3D12_INPUT_ELEMENT_DESC textLayout[] = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-    };
-
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC textPsoDesc = {};
-    textPsoDesc.InputLayout = { textLayout, _countof(textLayout) };
-    textPsoDesc.pRootSignature = s_textRootSig;
-    textPsoDesc.VS = { textVs->GetBufferPointer(), textVs->GetBufferSize() };
-    textPsoDesc.PS = { textPs->GetBufferPointer(), textPs->GetBufferSize() };
-    textPsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    textPsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
-    textPsoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
-    textPsoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
-    textPsoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
-    textPsoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
-    textPsoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
-    textPsoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ZERO;
-    textPsoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
-    textPsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
-    textPsoDesc.SampleMask = UINT_MAX;
-    textPsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    textPsoDesc.NumRenderTargets = 1;
-    textPsoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textPsoDesc.SampleDesc.Count = 1;
-
-    s_device->CreateGraphicsPipelineState(&textPsoDesc, IID_PPV_ARGS(&s_textPso));
-    textVs->Release();
-    textPs->Release();
-
-    // Generate font texture from g_font8x8 bitmap data (16x6 characters = 128x48 pixels)
-    const int FONT_COLS = 16, FONT_ROWS = 6;
-    const int TEX_W = FONT_COLS * 8, TEX_H = FONT_ROWS * 8;
-    unsigned char texData[TEX_W * TEX_H];
-    memset(texData, 0, sizeof(texData));
-
-    for (int c = 0; c < 96; c++) {
-        int col = c % FONT_COLS, row = c / FONT_COLS;
-        for (int y = 0; y < 8; y++) {
-            unsigned char bits = g_font8x8[c][y];
-            for (int x = 0; x < 8; x++) {
-                int px = col * 8 + x, py = row * 8 + y;
-                texData[py * TEX_W + px] = (bits & (0x80 >> x)) ? 255 : 0;
-            }
-        }
-    }
-
-    // Font texture resource
-    D3D12_RESOURCE_DESC texDesc = {};
-    texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    texDesc.Width = TEX_W;
-    texDesc.Height = TEX_H;
-    texDesc.DepthOrArraySize = 1;
-    texDesc.MipLevels = 1;
-    texDesc.Format = DXGI_FORMAT_R8_UNORM;
-    texDesc.SampleDesc.Count = 1;
-    texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-    s_device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &texDesc,
-        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&s_fontTexture));
-
-    // Get proper footprint for upload (handles row pitch alignment)
-    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
-    UINT64 uploadSize = 0;
-    s_device->GetCopyableFootprints(&texDesc, 0, 1, 0, &footprint, nullptr, nullptr, &uploadSize);
-
-    bufDesc.Width = uploadSize;
-    bufDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    ID3D12Resource* uploadBuf = nullptr;
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadBuf));
-    uploadBuf->Map(0, nullptr, &mapped);
-    // Copy row by row using proper aligned pitch
-    BYTE* destRow = (BYTE*)mapped + footprint.Offset;
-    for (UINT row = 0; row < TEX_H; row++) {
-        memcpy(destRow + row * footprint.Footprint.RowPitch, texData + row * TEX_W, TEX_W);
+    // ============== TEXT OVERLAY ==============
+    StartupStep("Overlay + timers");
+    if (!Overlay12Init(s_overlay, s_device, DXGI_FORMAT_R8G8B8A8_UNORM, "DXR 1.1")) {
+        Log("[WARN] Text overlay initialization failed, continuing without text\n");
     }
-    uploadBuf->Unmap(0, nullptr);
-
-    s_cmdList->Reset(s_cmdAlloc[0], nullptr);
-    D3D12_TEXTURE_COPY_LOCATION srcLoc = {}, dstLoc = {};
-    srcLoc.pResource = uploadBuf;
-    srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-    srcLoc.PlacedFootprint = footprint;
-    dstLoc.pResource = s_fontTexture;
-    dstLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    s_cmdList->CopyTextureRegion(&dstLoc, 0, 0, 0, &srcLoc, nullptr);
-
-    D3D12_RESOURCE_BARRIER texBarrier = {};
-    texBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    texBarrier.Transition.pResource = s_fontTexture;
-    texBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    texBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    texBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    s_cmdList->ResourceBarrier(1, &texBarrier);
-    s_cmdList->Close();
-    s_cmdQueue->ExecuteCommandLists(1, lists);
-    WaitForGpuRT();
-    uploadBuf->Release();
-
-    // Text SRV heap
-    D3D12_DESCRIPTOR_HEAP_DESC textSrvHeapDesc = {};
-    textSrvHeapDesc.NumDescriptors = 1;
-    textSrvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    textSrvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    s_device->CreateDescriptorHeap(&textSrvHeapDesc, IID_PPV_ARGS(&s_textSrvHeap));
-
-    D3D12_SHADER_RESOURCE_VIEW_DESC texSrvDesc = {};
-    texSrvDesc.Format = DXGI_FORMAT_R8_UNORM;
-    texSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    texSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    texSrvDesc.Texture2D.MipLevels = 1;
-    s_device->CreateShaderResourceView(s_fontTexture, &texSrvDesc, s_textSrvHeap->GetCPUDescriptorHandleForHeapStart());
-
-    // Text vertex buffer
-    bufDesc.Width = 6000 * sizeof(TextVert);
-    s_device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&s_textVB));
-    s_textVB->Map(0, nullptr, &s_textVBMapped);
-    s_textVBView.BufferLocation = s_textVB->GetGPUVirtualAddress();
-    s_textVBView.SizeInBytes = 6000 * sizeof(TextVert);
-    s_textVBView.StrideInBytes = sizeof(TextVert);
 
     // Reset command list for rendering
     s_cmdAlloc[0]->Reset();
     s_cmdList->Reset(s_cmdAlloc[0], s_pso);
     s_cmdList->Close();
 
+    // GPU pass timings (optional - the overlay just omits them on failure)
+    InitGpuTimer12(s_device, s_cmdQueue);
+
+    VramSetCategories(VramCategoriesRT);
     Log("[INFO] D3D12 + Ray Tracing initialization complete\n");
 
     return true;
@@ -1363,22 +1572,24 @@ bool InitD3D12RT(HWND hwnd) {
 
 // ============== RENDER ==============
 void RenderD3D12RT() {
+    DxgiWaitFrameLatency(s_swapWaitable);
+
     // Check if shader features changed - recompile if needed
     // MUST be done BEFORE command list reset, because reset uses s_pso
     ShaderFeatures currentFeatures = GetCurrentShaderFeatures();
     // For temporal denoise, only enable in shader if history is valid
     ShaderFeatures effectiveFeatures = currentFeatures;
     effectiveFeatures.temporalDenoise = currentFeatures.temporalDenoise && s_historyValid;
-    if (effectiveFeatures != s_compiledFeatures) {
-        WaitForGpuRT();
-        if (!RecompileShaders(effectiveFeatures)) {
-            Log("[ERROR] Shader recompilation failed\n");
-        }
-    }
+    UpdateRecompileRT(effectiveFeatures);
+
+    // Timestamps / ray counts from the last use of this frame slot are complete by now
+    GpuTimerCollect12(s_frameIndex);
+    RayCountersCollect12(s_frameIndex);
 
-    // Reset command allocator and list (uses s_pso which may have been recompiled above)
+    // Reset command allocator and list (uses s_pso which may have been swapped above)
     s_cmdAlloc[s_frameIndex]->Reset();
     s_cmdList->Reset(s_cmdAlloc[s_frameIndex], s_pso);
+    GpuTimerBegin12(s_cmdList, s_frameIndex);
 
     // Frame counter for AA jitter sequence
     static UINT s_rtFrameNumber = 0;
@@ -1411,11 +1622,38 @@ void RenderD3D12RT() {
     cb.giBounces = g_dxrFeatures.giBounces;
     cb.giStrength = g_dxrFeatures.giStrength;
     cb.denoiseBlendFactor = g_dxrFeatures.denoiseBlendFactor;
-    memcpy(s_cbMapped, &cb, sizeof(RTCB));
+
+    // --rt-indirect: AO/GI pass size (rounded up, checkerboard stays at W x H)
+    bool indirectPass = s_compiledFeatures.indirectUpsample && s_indirectPso && s_indirectBuffer;
+    UINT indirectDiv = g_rtIndirectRate == RT_INDIRECT_HALF ? 2 : g_rtIndirectRate == RT_INDIRECT_QUARTER ? 4 : 1;
+    UINT indirectW = (W + indirectDiv - 1) / indirectDiv;
+    UINT indirectH = (H + indirectDiv - 1) / indirectDiv;
+    cb.indirectMode = (int)g_rtIndirectRate;
+    cb.indirectScaleX = (float)indirectW / W;
+    cb.indirectScaleY = (float)indirectH / H;
+    cb.indirectWidth = indirectW;
+    cb.indirectHeight = indirectH;
+    cb.frameNumber = s_rtFrameNumber;
+    D3D12_GPU_VIRTUAL_ADDRESS cbGpu = FrameRingPush12(s_frameRing, &cb, sizeof(RTCB), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
     // Update cube transform and rebuild TLAS for dynamic reflections
     UpdateCubeTransform(time);
     RebuildTLAS();
+    GpuTimerStamp12(s_cmdList, s_frameIndex, "TLAS");
+    RayCountersBegin12(s_cmdList);
+
+    if (indirectPass) {
+        RecordIndirectPassRT(cbGpu, indirectW, indirectH);
+        GpuTimerStamp12(s_cmdList, s_frameIndex, "Trace AO/GI");
+    }
+
+    // --vrs: rates from last frame's colour; the first frame after init /
+    // resize has no history and shades 1x1
+    bool vrs = s_vrsTileSize && s_vrsImage && s_historyValid;
+    if (vrs) {
+        RecordVrsRatePassRT();
+        GpuTimerStamp12(s_cmdList, s_frameIndex, "VRS");
+    }
 
     // Render resolution and target
     UINT renderW = W;
@@ -1464,8 +1702,9 @@ void RenderD3D12RT() {
     s_cmdList->SetDescriptorHeaps(1, heaps);
 
     // Bind parameters
-    s_cmdList->SetGraphicsRootConstantBufferView(0, s_constantBuffer->GetGPUVirtualAddress());
+    s_cmdList->SetGraphicsRootConstantBufferView(0, cbGpu);
     s_cmdList->SetGraphicsRootDescriptorTable(1, s_srvHeap->GetGPUDescriptorHandleForHeapStart());
+    if (RayCountersAddress12()) s_cmdList->SetGraphicsRootUnorderedAccessView(2, RayCountersAddress12());
 
     // Set viewport and scissor (render resolution)
     D3D12_VIEWPORT vp = { 0, 0, (float)renderW, (float)renderH, 0, 1 };
@@ -1473,21 +1712,36 @@ void RenderD3D12RT() {
     s_cmdList->RSSetViewports(1, &vp);
     s_cmdList->RSSetScissorRects(1, &scissor);
 
-    // Draw static geometry (room)
-    s_cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    s_cmdList->IASetVertexBuffers(0, 1, &s_vbView);
-    s_cmdList->IASetIndexBuffer(&s_ibView);
-    s_cmdList->DrawIndexedInstanced(s_indexCount, 1, 0, 0, 0);
+    // --depth-prepass: visible depth first, then shade with EQUAL depth test
+    if (s_depthPso) {
+        RecordDepthPrepassRT(dsvHandle);
+        GpuTimerStamp12(s_cmdList, s_frameIndex, "Depth");
+        s_cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+        s_cmdList->SetPipelineState(s_pso);
+    }
 
-    // Draw dynamic cube (vertex shader applies rotation)
-    s_cmdList->IASetVertexBuffers(0, 1, &s_vbViewCube);
-    s_cmdList->IASetIndexBuffer(&s_ibViewCube);
-    s_cmdList->DrawIndexedInstanced(s_indexCountCube, 1, 0, 0, 0);
+    // Shading rate image overrides the 1x1 base rate per tile (Tier 2 combiner 1)
+    if (vrs) {
+        D3D12_SHADING_RATE_COMBINER combiners[2] = { D3D12_SHADING_RATE_COMBINER_PASSTHROUGH, D3D12_SHADING_RATE_COMBINER_OVERRIDE };
+        s_cmdList5->RSSetShadingRate(D3D12_SHADING_RATE_1X1, combiners);
+        s_cmdList5->RSSetShadingRateImage(s_vrsImage);
+    }
+
+    // Room and dynamic cube (vertex shader applies rotation)
+    DrawSceneRT();
+    if (vrs) {
+        // Back to 1x1 for the overlay text
+        s_cmdList5->RSSetShadingRateImage(nullptr);
+        s_cmdList5->RSSetShadingRate(D3D12_SHADING_RATE_1X1, nullptr);
+    }
+    GpuTimerStamp12(s_cmdList, s_frameIndex, "Trace");
+    RayCountersEnd12(s_cmdList, s_frameIndex);
 
     // ===== TEMPORAL DENOISING - Copy current frame to history =====
     // The blending happens in the pixel shader (reads history, blends with current)
     // Here we just copy the final result to history for next frame
-    if (g_dxrFeatures.enableTemporalDenoise && s_historyBuffer) {
+    // (also the --vrs rate pass input)
+    if ((g_dxrFeatures.enableTemporalDenoise || s_vrsTileSize) && s_historyBuffer) {
         D3D12_RESOURCE_BARRIER denoiseBarriers[2] = {};
 
         // Transition backbuffer to copy source
@@ -1519,6 +1773,7 @@ void RenderD3D12RT() {
         s_cmdList->ResourceBarrier(2, denoiseBarriers);
 
         s_historyValid = true;
+        GpuTimerStamp12(s_cmdList, s_frameIndex, "History");
     }
 
     // ===== TEXT RENDERING =====
@@ -1536,24 +1791,10 @@ void RenderD3D12RT() {
         s_cachedAO = g_dxrFeatures.rtAO;
         s_cachedGI = g_dxrFeatures.rtGI;
         s_cachedLighting = g_dxrFeatures.rtLighting;
-        s_textVertCount = 0;
-
         char gpuNameA[128] = {};
         size_t converted = 0;
         wcstombs_s(&converted, gpuNameA, 128, s_gpuName.c_str(), 127);
 
-        char buf[256];
-        float y = 10.0f;
-
-        // Shadow + Text (basic info)
-        sprintf_s(buf, sizeof(buf), "API: D3D12 + DXR 1.1 (RayQuery)");
-        DrawTextRT(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawTextRT(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, sizeof(buf), "GPU: %s", gpuNameA); DrawTextRT(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawTextRT(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, sizeof(buf), "FPS: %d", fps); DrawTextRT(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawTextRT(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, sizeof(buf), "Triangles: %u", (s_indexCount + s_indexCountCube) / 3); DrawTextRT(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawTextRT(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 15;
-        sprintf_s(buf, sizeof(buf), "Resolution: %dx%d", W, H);
-        DrawTextRT(buf, 11, y+1, 0, 0, 0, 1, 1.5f); DrawTextRT(buf, 10, y, 1, 1, 1, 1, 1.5f); y += 20;
-
         // Build enabled features string
         char features[256] = "";
         if (g_dxrFeatures.rtLighting) strcat_s(features, "Spot ");
@@ -1561,31 +1802,40 @@ void RenderD3D12RT() {
         if (g_dxrFeatures.rtAO) strcat_s(features, "AO ");
         if (g_dxrFeatures.rtGI) strcat_s(features, "GI ");
         if (strlen(features) == 0) strcpy_s(features, "None");
+        if (s_compiledFeatures.indirectUpsample) {
+            strcat_s(features, "| AO/GI ");
+            strcat_s(features, D3D12RTIndirectRateName());
+        }
+        if (s_depthPso) strcat_s(features, " | Z-prepass");
+        if (s_vrsTileSize) strcat_s(features, " | VRS");
+
+        char infoText[1024];
+        int len = sprintf_s(infoText,
+            "API: D3D12 + DXR 1.1 (RayQuery)\n"
+            "GPU: %s\n"
+            "FPS: %d\n"
+            "Triangles: %u\n"
+            "Resolution: %dx%d\n"
+            "RT Features: " OVERLAY_TEXT_GREEN "%s",   // Green tint for features
+            gpuNameA, fps, (s_indexCount + s_indexCountCube) / 3, W, H, features);
 
-        sprintf_s(buf, sizeof(buf), "RT Features: %s", features);
-        DrawTextRT(buf, 11, y+1, 0, 0, 0, 1, 1.5f);
-        DrawTextRT(buf, 10, y, 0.5f, 1.0f, 0.5f, 1, 1.5f);  // Green tint for features
-
-        memcpy(s_textVBMapped, s_textVerts, s_textVertCount * sizeof(TextVert));
+        char buf[256];
+        RayStatsFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+        GpuProfilerFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+        LatencyFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+        VramFormat(buf, sizeof(buf));
+        if (buf[0] && len > 0) len += sprintf_s(infoText + len, sizeof(infoText) - len, "\n%s", buf);
+
+        OverlaySetText(s_overlay.text, infoText);
     }
 
-    // Set viewport to display resolution for text
-    D3D12_VIEWPORT textVp = { 0, 0, (float)W, (float)H, 0, 1 };
-    D3D12_RECT textScissor = { 0, 0, (LONG)W, (LONG)H };
-    s_cmdList->RSSetViewports(1, &textVp);
-    s_cmdList->RSSetScissorRects(1, &textScissor);
-
-    if (s_textVertCount > 0) {
-        s_cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-        s_cmdList->SetPipelineState(s_textPso);
-        s_cmdList->SetGraphicsRootSignature(s_textRootSig);
-        ID3D12DescriptorHeap* textHeaps[] = { s_textSrvHeap };
-        s_cmdList->SetDescriptorHeaps(1, textHeaps);
-        s_cmdList->SetGraphicsRootDescriptorTable(0, s_textSrvHeap->GetGPUDescriptorHandleForHeapStart());
-        s_cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        s_cmdList->IASetVertexBuffers(0, 1, &s_textVBView);
-        s_cmdList->DrawInstanced(s_textVertCount, 1, 0, 0);
-    }
+    // Text at display resolution (Overlay12Draw sets viewport and scissor)
+    s_cmdList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    Overlay12Draw(s_overlay, s_cmdList, s_frameIndex, W, H);
+    GpuTimerStamp12(s_cmdList, s_frameIndex, "Text");
 
     // Transition to present
     barrier.Transition.pResource = s_renderTargets[s_frameIndex];
@@ -1593,6 +1843,7 @@ void RenderD3D12RT() {
     barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
     barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
     s_cmdList->ResourceBarrier(1, &barrier);
+    GpuTimerEnd12(s_cmdList, s_frameIndex);
 
     // Execute
     s_cmdList->Close();
@@ -1600,25 +1851,90 @@ void RenderD3D12RT() {
     s_cmdQueue->ExecuteCommandLists(1, lists);
 
     // Present
-    s_swapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
+    DxgiPresent(s_swapChain, true);
     MoveToNextFrameRT();
 }
 
+// ============== AO/GI RATE ==============
+const char* D3D12RTIndirectRateName() {
+    static const char* names[RT_INDIRECT_COUNT] = { "full", "half", "quarter", "checkerboard" };
+    return names[g_rtIndirectRate];
+}
+
+UINT D3D12RTVrsTileSize() {
+    return s_vrsTileSize;
+}
+
+// ============== RESIZE ==============
+bool ResizeD3D12RT() {
+    if (!s_swapChain || !s_device) return false;
+    WaitForGpuRT();
+
+    for (int i = 0; i < 3; i++) if (s_renderTargets[i]) { s_renderTargets[i]->Release(); s_renderTargets[i] = nullptr; }
+    if (s_depthStencil) { s_depthStencil->Release(); s_depthStencil = nullptr; }
+    if (s_historyBuffer) { s_historyBuffer->Release(); s_historyBuffer = nullptr; }
+    if (s_indirectBuffer) { s_indirectBuffer->Release(); s_indirectBuffer = nullptr; }
+    if (s_indirectGuide) { s_indirectGuide->Release(); s_indirectGuide = nullptr; }
+    if (s_vrsImage) { s_vrsImage->Release(); s_vrsImage = nullptr; }
+
+    HRESULT hr = s_swapChain->ResizeBuffers(3, W, H, DXGI_FORMAT_UNKNOWN, DxgiSwapChainFlags(true));
+    if (FAILED(hr)) { LogHR("ResizeBuffers", hr); return false; }
+    if (!CreateSizeDependentRT()) return false;
+
+    // t1: History buffer SRV points at the new resource
+    UINT srvDescSize = s_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = s_srvHeap->GetCPUDescriptorHandleForHeapStart();
+    srvHandle.ptr += srvDescSize;
+    D3D12_SHADER_RESOURCE_VIEW_DESC historySrvDesc = {};
+    historySrvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    historySrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    historySrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    historySrvDesc.Texture2D.MipLevels = 1;
+    s_device->CreateShaderResourceView(s_historyBuffer, &historySrvDesc, srvHandle);
+    CreateIndirectSrvsRT();
+    if (s_vrsTileSize && !CreateVrsImageRT()) s_vrsTileSize = 0;
+
+    // All slots idle after the wait; restart from the new back buffer index
+    UINT64 next = s_fenceValues[s_frameIndex];
+    s_frameIndex = s_swapChain->GetCurrentBackBufferIndex();
+    for (int i = 0; i < 3; i++) s_fenceValues[i] = next;
+    s_cachedFps = -1;  // Rebuild overlay for the new size
+
+    Log("[INFO] D3D12 RT resized to %ux%u\n", W, H);
+    return true;
+}
+
 // ============== CLEANUP ==============
 void CleanupD3D12RT() {
+    VramSetCategories(nullptr);
+    // Worker must finish before the pipeline library and device go away
+    WaitForRecompileRT();
+    if (s_recompileJob.result) { s_recompileJob.result->Release(); s_recompileJob.result = nullptr; }
+    if (s_recompileJob.indirectResult) { s_recompileJob.indirectResult->Release(); s_recompileJob.indirectResult = nullptr; }
+    if (s_recompileJob.depthResult) { s_recompileJob.depthResult->Release(); s_recompileJob.depthResult = nullptr; }
+    s_hasFailedFeatures = false;
     WaitForGpuRT();
+    ReleaseRetiredPSOs(true);
+    CleanupGpuTimer12();
+    CleanupRayCounters12();
+    PipelineCacheClose();
 
     // Text rendering
-    if (s_textVB) s_textVB->Release();
-    if (s_fontTexture) s_fontTexture->Release();
-    if (s_textSrvHeap) s_textSrvHeap->Release();
-    if (s_textPso) s_textPso->Release();
-    if (s_textRootSig) s_textRootSig->Release();
+    Overlay12Cleanup(s_overlay);
 
     // Pipeline
-    if (s_pso) s_pso->Release();
-    if (s_rootSig) s_rootSig->Release();
-    if (s_srvHeap) s_srvHeap->Release();
+    if (s_pso) { s_pso->Release(); s_pso = nullptr; }
+    if (s_indirectPso) { s_indirectPso->Release(); s_indirectPso = nullptr; }
+    if (s_depthPso) { s_depthPso->Release(); s_depthPso = nullptr; }
+    if (s_rootSig) { s_rootSig->Release(); s_rootSig = nullptr; }
+    if (s_srvHeap) { s_srvHeap->Release(); s_srvHeap = nullptr; }
+
+    // --vrs
+    if (s_vrsPso) { s_vrsPso->Release(); s_vrsPso = nullptr; }
+    if (s_vrsRootSig) { s_vrsRootSig->Release(); s_vrsRootSig = nullptr; }
+    if (s_vrsImage) { s_vrsImage->Release(); s_vrsImage = nullptr; }
+    if (s_cmdList5) { s_cmdList5->Release(); s_cmdList5 = nullptr; }
+    s_vrsTileSize = 0;
 
     // Ray tracing - Unmap instance buffer first
     if (s_instanceBuffer && s_instanceMapped) {
@@ -1627,39 +1943,44 @@ void CleanupD3D12RT() {
     }
 
     // Ray tracing resources
-    if (s_instanceBuffer) s_instanceBuffer->Release();
-    if (s_scratchBuffer) s_scratchBuffer->Release();
-    if (s_tlasBuffer) s_tlasBuffer->Release();
-    if (s_blasBufferStatic) s_blasBufferStatic->Release();
-    if (s_blasBufferCube) s_blasBufferCube->Release();
+    if (s_instanceBuffer) { s_instanceBuffer->Release(); s_instanceBuffer = nullptr; }
+    if (s_scratchBuffer) { s_scratchBuffer->Release(); s_scratchBuffer = nullptr; }
+    if (s_tlasBuffer) { s_tlasBuffer->Release(); s_tlasBuffer = nullptr; }
+    if (s_blasBufferStatic) { s_blasBufferStatic->Release(); s_blasBufferStatic = nullptr; }
+    if (s_blasBufferCube) { s_blasBufferCube->Release(); s_blasBufferCube = nullptr; }
 
     // Buffers
-    if (s_constantBuffer) s_constantBuffer->Release();
-    if (s_indexBufferStatic) s_indexBufferStatic->Release();
-    if (s_vertexBufferStatic) s_vertexBufferStatic->Release();
-    if (s_indexBufferCube) s_indexBufferCube->Release();
-    if (s_vertexBufferCube) s_vertexBufferCube->Release();
-    if (s_indexBuffer) s_indexBuffer->Release();
-    if (s_vertexBuffer) s_vertexBuffer->Release();
+    CleanupFrameRing12(s_frameRing);
+    if (s_indexBufferStatic) { s_indexBufferStatic->Release(); s_indexBufferStatic = nullptr; }
+    if (s_vertexBufferStatic) { s_vertexBufferStatic->Release(); s_vertexBufferStatic = nullptr; }
+    if (s_indexBufferCube) { s_indexBufferCube->Release(); s_indexBufferCube = nullptr; }
+    if (s_blueNoise) { s_blueNoise->Release(); s_blueNoise = nullptr; }
+    if (s_vertexBufferCube) { s_vertexBufferCube->Release(); s_vertexBufferCube = nullptr; }
+    if (s_indexBuffer) { s_indexBuffer->Release(); s_indexBuffer = nullptr; }
+    if (s_vertexBuffer) { s_vertexBuffer->Release(); s_vertexBuffer = nullptr; }
 
     // Synchronization
-    if (s_fenceEvent) CloseHandle(s_fenceEvent);
-    if (s_fence) s_fence->Release();
-    for (int i = 0; i < 3; i++) if (s_cmdAlloc[i]) s_cmdAlloc[i]->Release();
-    if (s_cmdList) s_cmdList->Release();
+    if (s_fenceEvent) { CloseHandle(s_fenceEvent); s_fenceEvent = nullptr; }
+    if (s_fence) { s_fence->Release(); s_fence = nullptr; }
+    for (int i = 0; i < 3; i++) if (s_cmdAlloc[i]) { s_cmdAlloc[i]->Release(); s_cmdAlloc[i] = nullptr; }
+    if (s_cmdList) { s_cmdList->Release(); s_cmdList = nullptr; }
 
     // Render targets
-    if (s_depthStencil) s_depthStencil->Release();
+    if (s_depthStencil) { s_depthStencil->Release(); s_depthStencil = nullptr; }
     if (s_historyBuffer) { s_historyBuffer->Release(); s_historyBuffer = nullptr; }
     s_historyValid = false;
-    if (s_dsvHeap) s_dsvHeap->Release();
-    for (int i = 0; i < 3; i++) if (s_renderTargets[i]) s_renderTargets[i]->Release();
-    if (s_rtvHeap) s_rtvHeap->Release();
+    if (s_indirectBuffer) { s_indirectBuffer->Release(); s_indirectBuffer = nullptr; }
+    if (s_indirectGuide) { s_indirectGuide->Release(); s_indirectGuide = nullptr; }
+    s_indirectValid = false;
+    if (s_dsvHeap) { s_dsvHeap->Release(); s_dsvHeap = nullptr; }
+    for (int i = 0; i < 3; i++) if (s_renderTargets[i]) { s_renderTargets[i]->Release(); s_renderTargets[i] = nullptr; }
+    if (s_rtvHeap) { s_rtvHeap->Release(); s_rtvHeap = nullptr; }
 
     // Core
-    if (s_swapChain) s_swapChain->Release();
-    if (s_cmdQueue) s_cmdQueue->Release();
-    if (s_device) s_device->Release();
+    if (s_swapWaitable) { CloseHandle(s_swapWaitable); s_swapWaitable = nullptr; }
+    if (s_swapChain) { s_swapChain->Release(); s_swapChain = nullptr; }
+    if (s_cmdQueue) { s_cmdQueue->Release(); s_cmdQueue = nullptr; }
+    if (s_device) { s_device->Release(); s_device = nullptr; }
 
     // Reset all pointers
     s_device = nullptr;
@@ -0,0 +1,205 @@
+// ============== FRAME CAPTURE ==============
+// Slot bookkeeping and the PNG encoder thread (see frame_capture.h)
+
+#include "frame_capture.h"
+#include "benchmark.h"
+#include <wincodec.h>
+
+#pragma comment(lib, "windowscodecs.lib")
+#pragma comment(lib, "ole32.lib")
+
+#define CAPTURE_QUEUE_SIZE 16       // Power of two, > CAPTURE_SLOTS
+
+struct CaptureJob {
+    CaptureRing* ring;
+    int slot;
+};
+
+// Single producer (render thread), single consumer (encoder thread)
+static CaptureJob s_queue[CAPTURE_QUEUE_SIZE];
+static volatile LONG s_queueHead = 0;
+static volatile LONG s_queueTail = 0;
+static HANDLE s_encoderThread = nullptr;
+static HANDLE s_encoderWake = nullptr;
+static volatile LONG s_written = 0;
+static volatile LONG s_skipped = 0;
+static volatile LONG s_failed = 0;
+static char s_dir[MAX_PATH] = {0};
+
+// ============== PNG ENCODING ==============
+static void ResolveCaptureDir()
+{
+    if (g_captureDir[0]) {
+        strcpy_s(s_dir, g_captureDir);
+    } else {
+        char exePath[MAX_PATH];
+        GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+        char* slash = strrchr(exePath, '\\');
+        if (slash) *slash = 0;
+        sprintf_s(s_dir, "%s\\captures", exePath);
+    }
+    if (!CreateDirectoryA(s_dir, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+        Log("[ERROR] Capture: cannot create %s (error %lu)\n", s_dir, GetLastError());
+}
+
+static bool WritePng(IWICImagingFactory* factory, const wchar_t* path, UINT width, UINT height,
+                     const BYTE* bgr, UINT stride)
+{
+    IWICStream* stream = nullptr;
+    IWICBitmapEncoder* encoder = nullptr;
+    IWICBitmapFrameEncode* frame = nullptr;
+    WICPixelFormatGUID format = GUID_WICPixelFormat24bppBGR;
+
+    HRESULT hr = factory->CreateStream(&stream);
+    if (SUCCEEDED(hr)) hr = stream->InitializeFromFilename(path, GENERIC_WRITE);
+    if (SUCCEEDED(hr)) hr = factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, &encoder);
+    if (SUCCEEDED(hr)) hr = encoder->Initialize(stream, WICBitmapEncoderNoCache);
+    if (SUCCEEDED(hr)) hr = encoder->CreateNewFrame(&frame, nullptr);
+    if (SUCCEEDED(hr)) hr = frame->Initialize(nullptr);
+    if (SUCCEEDED(hr)) hr = frame->SetSize(width, height);
+    if (SUCCEEDED(hr)) hr = frame->SetPixelFormat(&format);
+    if (SUCCEEDED(hr) && !IsEqualGUID(format, GUID_WICPixelFormat24bppBGR)) hr = E_FAIL;
+    if (SUCCEEDED(hr)) hr = frame->WritePixels(height, stride, stride * height, const_cast<BYTE*>(bgr));
+    if (SUCCEEDED(hr)) hr = frame->Commit();
+    if (SUCCEEDED(hr)) hr = encoder->Commit();
+
+    if (frame) frame->Release();
+    if (encoder) encoder->Release();
+    if (stream) stream->Release();
+    if (FAILED(hr)) LogHR("Capture PNG encode", hr);
+    return SUCCEEDED(hr);
+}
+
+static void EncodeJob(IWICImagingFactory* factory, const CaptureJob& job, std::vector<BYTE>& bgr)
+{
+    CaptureRing& ring = *job.ring;
+    CaptureSlot& slot = ring.slots[job.slot];
+
+    // Opaque 24-bit BGR: the trace targets' alpha isn't meaningful and would
+    // only make image diffs noisier
+    UINT stride = (ring.width * 3 + 3) & ~3u;
+    bgr.resize((size_t)stride * ring.height);
+    for (UINT y = 0; y < ring.height; y++) {
+        const BYTE* src = slot.pixels + (size_t)y * slot.rowPitch;
+        BYTE* dst = bgr.data() + (size_t)y * stride;
+        for (UINT x = 0; x < ring.width; x++, src += 4, dst += 3) {
+            dst[0] = ring.bgra ? src[0] : src[2];
+            dst[1] = src[1];
+            dst[2] = ring.bgra ? src[2] : src[0];
+        }
+    }
+
+    wchar_t path[MAX_PATH];
+    if (g_benchConfig.instanceTag[0])
+        swprintf_s(path, L"%hs\\%hs_%hs_%06u.png", s_dir, g_benchConfig.instanceTag, ring.tag, slot.frameNumber);
+    else
+        swprintf_s(path, L"%hs\\%hs_%06u.png", s_dir, ring.tag, slot.frameNumber);
+    if (factory && WritePng(factory, path, ring.width, ring.height, bgr.data(), stride))
+        InterlockedIncrement(&s_written);
+    else
+        InterlockedIncrement(&s_failed);      // Captured, but the file couldn't be written
+
+    InterlockedExchange(&slot.state, CAPTURE_FREE);
+}
+
+static DWORD WINAPI CaptureEncoderProc(LPVOID)
+{
+    IWICImagingFactory* factory = nullptr;
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (SUCCEEDED(hr))
+        hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+    if (FAILED(hr)) LogHR("Capture WIC factory", hr);
+    ResolveCaptureDir();
+    Log("[INFO] Capture: every %u frames to %s\n", g_captureEvery, s_dir);
+
+    std::vector<BYTE> bgr;
+    for (;;) {
+        WaitForSingleObject(s_encoderWake, INFINITE);
+        while (s_queueTail != s_queueHead) {
+            EncodeJob(factory, s_queue[s_queueTail & (CAPTURE_QUEUE_SIZE - 1)], bgr);
+            InterlockedIncrement(&s_queueTail);
+        }
+    }
+}
+
+// Started with the first capture; lives until the process exits
+static bool StartEncoder()
+{
+    if (s_encoderThread) return true;
+    s_encoderWake = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    s_encoderThread = s_encoderWake ? CreateThread(nullptr, 0, CaptureEncoderProc, nullptr, 0, nullptr) : nullptr;
+    if (!s_encoderThread) {
+        Log("[ERROR] Capture: encoder thread failed (error %lu), --capture disabled\n", GetLastError());
+        if (s_encoderWake) { CloseHandle(s_encoderWake); s_encoderWake = nullptr; }
+        g_captureEvery = 0;
+        return false;
+    }
+    SetThreadPriority(s_encoderThread, THREAD_PRIORITY_BELOW_NORMAL);
+    return true;
+}
+
+// ============== SLOTS ==============
+bool CaptureDue(UINT frameNumber)
+{
+    return g_captureEvery && frameNumber % g_captureEvery == 0;
+}
+
+int CaptureAcquire(CaptureRing& ring)
+{
+    if (!StartEncoder()) return -1;
+    for (int i = 0; i < CAPTURE_SLOTS; i++)
+        if (ring.slots[i].state == CAPTURE_FREE) return i;
+    InterlockedIncrement(&s_skipped);
+    return -1;
+}
+
+void CaptureSubmitted(CaptureRing& ring, int slot, UINT frameSlot, UINT frameNumber)
+{
+    ring.slots[slot].frameSlot = frameSlot;
+    ring.slots[slot].frameNumber = frameNumber;
+    InterlockedExchange(&ring.slots[slot].state, CAPTURE_COPYING);
+}
+
+static void Enqueue(CaptureRing& ring, int slot)
+{
+    if (s_queueHead - s_queueTail >= CAPTURE_QUEUE_SIZE) {
+        InterlockedIncrement(&s_skipped);
+        InterlockedExchange(&ring.slots[slot].state, CAPTURE_FREE);
+        return;
+    }
+    InterlockedExchange(&ring.slots[slot].state, CAPTURE_ENCODING);
+    CaptureJob& job = s_queue[s_queueHead & (CAPTURE_QUEUE_SIZE - 1)];
+    job.ring = &ring;
+    job.slot = slot;
+    InterlockedIncrement(&s_queueHead);
+    SetEvent(s_encoderWake);
+}
+
+void CaptureRetire(CaptureRing& ring, UINT frameSlot)
+{
+    for (int i = 0; i < CAPTURE_SLOTS; i++)
+        if (ring.slots[i].state == CAPTURE_COPYING && ring.slots[i].frameSlot == frameSlot) Enqueue(ring, i);
+}
+
+void CaptureDrain(CaptureRing& ring)
+{
+    for (int i = 0; i < CAPTURE_SLOTS; i++)
+        if (ring.slots[i].state == CAPTURE_COPYING) Enqueue(ring, i);
+    for (int i = 0; i < CAPTURE_SLOTS; i++)
+        while (ring.slots[i].state != CAPTURE_FREE) Sleep(1);
+}
+
+UINT CaptureWrittenCount()
+{
+    return (UINT)s_written;
+}
+
+UINT CaptureSkippedCount()
+{
+    return (UINT)s_skipped;
+}
+
+UINT CaptureFailedCount()
+{
+    return (UINT)s_failed;
+}
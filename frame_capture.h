@@ -0,0 +1,52 @@
+#pragma once
+// ============== FRAME CAPTURE ==============
+// --capture=N: every Nth frame of D3D12 PT and Vulkan RT is written to
+// <dir>\<renderer>_<frame>.png without stalling the frame loop. The backend
+// records a copy of the final image (before the text overlay) into one of
+// CAPTURE_SLOTS persistently mapped readback buffers. The buffer is read only
+// once the fence of that frame slot has passed, FRAME_COUNT frames later, when
+// the backend calls CaptureRetire. PNG encoding (WIC) runs on a worker thread,
+// which hands the slot back when the file is written. If every slot is still
+// in flight or being encoded, the capture is skipped and counted; the frame
+// loop never waits.
+//
+// The API-specific halves (buffers, copy commands) are Capture12Record in
+// d3d12_capture.cpp and VkCaptureRecord in vk_capture.cpp.
+
+#include "common.h"
+
+#define CAPTURE_SLOTS 4             // FRAME_COUNT copies in flight + one being encoded
+
+enum CaptureSlotState {
+    CAPTURE_FREE,
+    CAPTURE_COPYING,                // Copy recorded, its frame slot's fence hasn't passed yet
+    CAPTURE_ENCODING                // Owned by the encoder thread
+};
+
+struct CaptureSlot {
+    volatile LONG state;
+    const BYTE* pixels;             // Mapped readback memory
+    UINT rowPitch;
+    UINT frameSlot;                 // Backend frame slot whose fence covers the copy
+    UINT frameNumber;
+};
+
+struct CaptureRing {
+    CaptureSlot slots[CAPTURE_SLOTS];
+    UINT width;
+    UINT height;
+    bool bgra;                      // Source byte order B, G, R, A (else R, G, B, A)
+    const char* tag;                // File name prefix, static string
+};
+
+// Render thread
+bool CaptureDue(UINT frameNumber);                  // --capture is on and this frame is one of them
+int CaptureAcquire(CaptureRing& ring);              // A free slot, -1 = all busy (counted as skipped)
+void CaptureSubmitted(CaptureRing& ring, int slot, UINT frameSlot, UINT frameNumber);
+void CaptureRetire(CaptureRing& ring, UINT frameSlot);  // frameSlot's fence passed: encode its copy
+void CaptureDrain(CaptureRing& ring);               // GPU idle: encode what's left and wait for the
+                                                    // encoder, before the buffers are released
+// Report
+UINT CaptureWrittenCount();
+UINT CaptureSkippedCount();                         // No free slot / encoder queue full
+UINT CaptureFailedCount();                          // No WIC factory or the PNG write failed
@@ -0,0 +1,192 @@
+// ============== FRAME LATENCY ==============
+// Present pacing options and CPU-to-present latency tracking shared by all
+// backends. The DXGI helpers live here as well since D3D11 and D3D12 drive
+// their swap chains the same way.
+
+#include "frame_latency.h"
+#include "benchmark.h"
+#include "offscreen.h"
+
+UINT g_maxFrameLatency = 0;
+PresentModeOption g_presentMode = PRESENT_MODE_DEFAULT;
+
+#define LATENCY_MAX_PENDING 16
+
+struct PendingFrame {
+    UINT64 presentId;
+    LONGLONG startQpc;
+};
+
+static PendingFrame s_pending[LATENCY_MAX_PENDING] = {};
+static UINT s_pendingFirst = 0;
+static UINT s_pendingCount = 0;
+static LONGLONG s_frameStartQpc = 0;
+static UINT64 s_lastSubmittedId = 0;
+static LatencySource s_source = LATENCY_SOURCE_NONE;
+static double s_windowSumMs = 0.0;
+static UINT s_windowSamples = 0;
+static double s_displayMs = 0.0;
+static bool s_hasDisplay = false;
+static bool s_dxgiStatsOK = false;   // GetFrameStatistics succeeded at least once
+static LARGE_INTEGER s_qpcFreq = {};
+
+const char* PresentModeName(PresentModeOption mode) {
+    switch (mode) {
+    case PRESENT_MODE_IMMEDIATE: return "immediate";
+    case PRESENT_MODE_MAILBOX: return "mailbox";
+    case PRESENT_MODE_FIFO: return "fifo";
+    case PRESENT_MODE_ADAPTIVE: return "adaptive";
+    default: return "default";
+    }
+}
+
+// ============== MEASUREMENT ==============
+void LatencyReset() {
+    s_pendingFirst = s_pendingCount = 0;
+    s_frameStartQpc = 0;
+    s_lastSubmittedId = 0;
+    s_source = LATENCY_SOURCE_NONE;
+    s_windowSumMs = 0.0;
+    s_windowSamples = 0;
+    s_displayMs = 0.0;
+    s_hasDisplay = false;
+    s_dxgiStatsOK = false;
+    QueryPerformanceFrequency(&s_qpcFreq);
+}
+
+void LatencyFrameBegin() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    s_frameStartQpc = now.QuadPart;
+}
+
+void LatencyFrameSubmitted(UINT64 presentId) {
+    s_lastSubmittedId = presentId;
+    if (s_frameStartQpc == 0) return;   // Renderer never called LatencyFrameBegin
+    if (s_pendingCount == LATENCY_MAX_PENDING) {
+        // Feedback stalled - drop the oldest frame
+        s_pendingFirst = (s_pendingFirst + 1) % LATENCY_MAX_PENDING;
+        s_pendingCount--;
+    }
+    PendingFrame& p = s_pending[(s_pendingFirst + s_pendingCount) % LATENCY_MAX_PENDING];
+    p.presentId = presentId;
+    p.startQpc = s_frameStartQpc;
+    s_pendingCount++;
+    s_frameStartQpc = 0;
+}
+
+void LatencyFrameDisplayed(UINT64 presentId, LONGLONG qpc, LatencySource source) {
+    while (s_pendingCount > 0) {
+        PendingFrame& p = s_pending[s_pendingFirst];
+        if (p.presentId > presentId) break;
+        if (p.presentId == presentId && qpc >= p.startQpc && s_qpcFreq.QuadPart) {
+            double ms = (double)(qpc - p.startQpc) * 1000.0 / s_qpcFreq.QuadPart;
+            s_windowSumMs += ms;
+            s_windowSamples++;
+            s_source = source;
+            BenchmarkLatencySample(ms);
+        }
+        // Frames older than the displayed one were replaced (mailbox) or missed
+        s_pendingFirst = (s_pendingFirst + 1) % LATENCY_MAX_PENDING;
+        s_pendingCount--;
+    }
+}
+
+void LatencyTick() {
+    if (s_windowSamples == 0) return;
+    s_displayMs = s_windowSumMs / s_windowSamples;
+    s_hasDisplay = true;
+    s_windowSumMs = 0.0;
+    s_windowSamples = 0;
+}
+
+const char* LatencySourceName() {
+    switch (s_source) {
+    case LATENCY_SOURCE_DXGI_STATS: return "DXGI stats";
+    case LATENCY_SOURCE_WAITABLE: return "waitable";
+    case LATENCY_SOURCE_PRESENT_WAIT: return "present wait";
+    case LATENCY_SOURCE_FENCE: return "GPU fence";
+    default: return "none";
+    }
+}
+
+void LatencyFormat(char* buf, size_t size) {
+    if (!buf || size == 0) return;
+    buf[0] = 0;
+    if (!s_hasDisplay) return;
+    if (g_maxFrameLatency)
+        _snprintf_s(buf, size, _TRUNCATE, "Latency: %.1f ms (%s, max %u)", s_displayMs, LatencySourceName(), g_maxFrameLatency);
+    else
+        _snprintf_s(buf, size, _TRUNCATE, "Latency: %.1f ms (%s)", s_displayMs, LatencySourceName());
+}
+
+// ============== DXGI HELPERS ==============
+UINT DxgiSwapChainFlags(bool tearingSupported) {
+    UINT flags = tearingSupported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+    if (g_maxFrameLatency) flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    return flags;
+}
+
+HANDLE DxgiInitFrameLatency(IDXGISwapChain* swap, const char* tag) {
+    if (!swap || g_maxFrameLatency == 0) return nullptr;
+    if (g_offscreen) {
+        // No present queue to wait on: the offscreen Present paces on its fence
+        Log("[INFO] %s: offscreen, max %u frames in flight on the GPU fence\n", tag, g_maxFrameLatency);
+        return nullptr;
+    }
+
+    IDXGISwapChain2* swap2 = nullptr;
+    HRESULT hr = swap->QueryInterface(IID_PPV_ARGS(&swap2));
+    if (FAILED(hr)) { Log("[WARN] %s: IDXGISwapChain2 unavailable, --max-latency ignored\n", tag); return nullptr; }
+
+    HANDLE waitable = nullptr;
+    hr = swap2->SetMaximumFrameLatency(g_maxFrameLatency);
+    if (SUCCEEDED(hr)) waitable = swap2->GetFrameLatencyWaitableObject();
+    else LogHR("SetMaximumFrameLatency", hr);
+    swap2->Release();
+
+    if (waitable) Log("[INFO] %s: waitable swap chain, max frame latency %u\n", tag, g_maxFrameLatency);
+    return waitable;
+}
+
+void DxgiWaitFrameLatency(HANDLE waitable) {
+    if (waitable) {
+        // 1 s timeout so a lost present (occluded window, device removal) can't hang the loop
+        WaitForSingleObjectEx(waitable, 1000, TRUE);
+
+        // Without frame statistics, the signal is the best "displayed" event we get:
+        // the queue is below N frames, so the frame N-1 presents back has left it
+        if (!s_dxgiStatsOK && s_lastSubmittedId >= g_maxFrameLatency) {
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+            LatencyFrameDisplayed(s_lastSubmittedId - (g_maxFrameLatency - 1), now.QuadPart, LATENCY_SOURCE_WAITABLE);
+        }
+    }
+    LatencyFrameBegin();
+}
+
+void DxgiWaitPresentSlot(HANDLE waitable) {
+    // The waitable is released once per present, so every present needs its own wait
+    if (waitable) WaitForSingleObjectEx(waitable, 1000, TRUE);
+}
+
+void DxgiPresent(IDXGISwapChain* swap, bool tearingSupported) {
+    UINT syncInterval = 0;
+    UINT flags = 0;
+    switch (g_presentMode) {
+    case PRESENT_MODE_FIFO:
+    case PRESENT_MODE_ADAPTIVE: syncInterval = 1; break;   // DXGI has no late-frame tearing
+    case PRESENT_MODE_MAILBOX: break;   // Flip model without tearing: DWM shows the newest frame
+    default: if (tearingSupported) flags = DXGI_PRESENT_ALLOW_TEARING; break;
+    }
+    swap->Present(syncInterval, flags);
+
+    UINT presentId = 0;
+    if (SUCCEEDED(swap->GetLastPresentCount(&presentId))) LatencyFrameSubmitted(presentId);
+
+    DXGI_FRAME_STATISTICS stats = {};
+    if (SUCCEEDED(swap->GetFrameStatistics(&stats)) && stats.PresentCount) {
+        s_dxgiStatsOK = true;
+        LatencyFrameDisplayed(stats.PresentCount, stats.SyncQPCTime.QuadPart, LATENCY_SOURCE_DXGI_STATS);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+// ============== FRAME LATENCY ==============
+// Present pacing options and CPU-to-present latency measurement.
+//
+// --max-latency=N (1-3) caps how many frames the CPU may run ahead of the
+// display. D3D11/D3D12 create the swap chain with
+// DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT, call
+// SetMaximumFrameLatency(N) and wait on the waitable object before starting
+// a frame. Vulkan waits with VK_KHR_present_wait until frame (id - N) is on
+// screen (see vulkan/vk_present.h).
+//
+// --present-mode=immediate|mailbox|fifo|adaptive selects the Vulkan present
+// mode; the DXGI renderers map it to tearing / composed / sync-interval-1
+// presents (adaptive = sync interval 1), OpenGL to the WGL swap interval and
+// fence pacing (see opengl/gl_present.h).
+//
+// Latency is measured from the moment the CPU starts a frame (after the pacing
+// wait, when animation time is sampled) to the moment the presentation engine
+// reports that frame as displayed. The overlay shows a once-per-second
+// average; the benchmark report shows the mean/p95 over the measurement window.
+
+#include "common.h"
+
+// ============== OPTIONS ==============
+enum PresentModeOption {
+    PRESENT_MODE_DEFAULT,       // Renderer's previous behavior (no vsync, tearing where supported)
+    PRESENT_MODE_IMMEDIATE,     // No vsync, tearing allowed
+    PRESENT_MODE_MAILBOX,       // No vsync, no tearing, newest frame replaces queued ones
+    PRESENT_MODE_FIFO,          // Vsync
+    PRESENT_MODE_ADAPTIVE       // Vsync, late frames tear (FIFO_RELAXED / swap interval -1)
+};
+
+#define MAX_FRAME_LATENCY 3
+
+extern UINT g_maxFrameLatency;           // --max-latency=N, 0 = off (no waitable object / present wait)
+extern PresentModeOption g_presentMode;  // --present-mode=
+
+const char* PresentModeName(PresentModeOption mode);
+
+// ============== MEASUREMENT ==============
+// Where the "displayed" timestamp came from (shown next to the number)
+enum LatencySource {
+    LATENCY_SOURCE_NONE,
+    LATENCY_SOURCE_DXGI_STATS,     // IDXGISwapChain::GetFrameStatistics SyncQPCTime
+    LATENCY_SOURCE_WAITABLE,       // Waitable object signaled (frame left the present queue)
+    LATENCY_SOURCE_PRESENT_WAIT,   // vkWaitForPresentKHR returned
+    LATENCY_SOURCE_FENCE           // GPU finished the frame (no present feedback available)
+};
+
+void LatencyReset();                       // Renderer init / benchmark start
+void LatencyFrameBegin();                  // CPU starts a frame
+void LatencyFrameSubmitted(UINT64 presentId);   // After Present / vkQueuePresentKHR for that frame
+void LatencyFrameDisplayed(UINT64 presentId, LONGLONG qpc, LatencySource source);  // Older pending ids are dropped
+void LatencyTick();                        // Refresh display average (called once per second)
+const char* LatencySourceName();
+void LatencyFormat(char* buf, size_t size);   // e.g. "Latency: 14.2 ms (DXGI stats, max 2)", empty without samples
+
+// ============== DXGI HELPERS (D3D11 / D3D12) ==============
+UINT DxgiSwapChainFlags(bool tearingSupported);   // Creation + ResizeBuffers flags
+HANDLE DxgiInitFrameLatency(IDXGISwapChain* swap, const char* tag);   // Waitable object, or nullptr when off
+void DxgiWaitFrameLatency(HANDLE waitable);       // Start of frame: pacing wait + LatencyFrameBegin
+void DxgiWaitPresentSlot(HANDLE waitable);        // Pacing wait only, for a second present within one frame
+void DxgiPresent(IDXGISwapChain* swap, bool tearingSupported);   // Present per --present-mode + latency feedback
@@ -0,0 +1,70 @@
+// ============== GPU PROFILER ==============
+// Per-pass GPU timing aggregation shared by all backends
+
+#include "gpu_profiler.h"
+
+static GpuPassStats s_passes[GPU_PROFILER_MAX_PASSES] = {};
+static UINT s_passCount = 0;
+static UINT s_version = 0;
+
+void GpuProfilerAddSample(UINT pass, const char* name, double ms) {
+    if (pass >= GPU_PROFILER_MAX_PASSES) return;
+    // Ignore obviously bogus deltas (timestamp wrap, disjoint intervals)
+    if (ms < 0.0 || ms > 10000.0) return;
+
+    GpuPassStats& p = s_passes[pass];
+    p.name = name;
+    p.windowSumMs += ms;
+    p.windowSamples++;
+    p.totalSumMs += ms;
+    p.totalSamples++;
+    if (pass >= s_passCount) s_passCount = pass + 1;
+}
+
+void GpuProfilerReset() {
+    memset(s_passes, 0, sizeof(s_passes));
+    s_passCount = 0;
+    s_version++;
+}
+
+void GpuProfilerTick() {
+    bool changed = false;
+    for (UINT i = 0; i < s_passCount; i++) {
+        GpuPassStats& p = s_passes[i];
+        if (p.windowSamples == 0) continue;
+        p.displayMs = p.windowSumMs / p.windowSamples;
+        p.windowSumMs = 0.0;
+        p.windowSamples = 0;
+        changed = true;
+    }
+    if (changed) s_version++;
+}
+
+UINT GpuProfilerGetVersion() {
+    return s_version;
+}
+
+UINT GpuProfilerPassCount() {
+    return s_passCount;
+}
+
+const GpuPassStats* GpuProfilerGetPass(UINT pass) {
+    return pass < s_passCount ? &s_passes[pass] : nullptr;
+}
+
+void GpuProfilerFormat(char* buf, size_t size) {
+    if (!buf || size == 0) return;
+    buf[0] = 0;
+    if (s_passCount == 0) return;
+
+    size_t len = 0;
+    int n = _snprintf_s(buf, size, _TRUNCATE, "GPU ms:");
+    if (n > 0) len = (size_t)n;
+    for (UINT i = 0; i < s_passCount && len < size; i++) {
+        const GpuPassStats& p = s_passes[i];
+        if (!p.name) continue;
+        n = _snprintf_s(buf + len, size - len, _TRUNCATE, "%s %s %.2f", i ? " |" : "", p.name, p.displayMs);
+        if (n <= 0) break;
+        len += (size_t)n;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+// ============== GPU PROFILER ==============
+// API-agnostic store for per-pass GPU timings.
+// Each backend records timestamp queries around its passes and, a few frames
+// later when the results are available, reports the durations here.
+// The overlay shows a once-per-second average; the benchmark report shows the
+// mean over the measurement window.
+
+#include "common.h"
+
+#define GPU_PROFILER_MAX_PASSES 16   // Matches GPU_TIMER_MAX_STAMPS
+
+struct GpuPassStats {
+    const char* name;        // Static string owned by the backend
+    double displayMs;        // Average over the last display window
+    double windowSumMs;
+    UINT windowSamples;
+    double totalSumMs;       // Accumulated since last GpuProfilerReset()
+    UINT totalSamples;
+};
+
+// Backend side
+void GpuProfilerAddSample(UINT pass, const char* name, double ms);
+
+// Frontend side
+void GpuProfilerReset();                          // Clear all passes (renderer init / benchmark start)
+void GpuProfilerTick();                           // Refresh display averages (called once per second)
+UINT GpuProfilerGetVersion();                     // Incremented by every Tick that changed display values
+UINT GpuProfilerPassCount();
+const GpuPassStats* GpuProfilerGetPass(UINT pass);
+void GpuProfilerFormat(char* buf, size_t size);   // e.g. "GPU ms: TLAS 0.05 | Trace 2.31 | Copy 0.04"
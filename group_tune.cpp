@@ -0,0 +1,307 @@
+// ============== THREAD-GROUP SHAPE AUTO-TUNER ==============
+// Variant table, per-kernel tuning state and the per-adapter result file (see group_tune.h)
+
+#include "group_tune.h"
+#include <algorithm>
+
+int g_groupSize = GROUP_VARIANT_DEFAULT;
+
+static const GroupShape s_variants[GROUP_VARIANT_COUNT] = {
+    { 8, 8, 0, "8x8" },
+    { 16, 8, 0, "16x8" },
+    { 8, 4, 0, "8x4" },
+    { 8, 8, 32, "8x8w32" },
+    { 8, 8, 64, "8x8w64" },
+    { 16, 8, 32, "16x8w32" },
+};
+static const char* s_kernelNames[GROUP_KERNEL_COUNT] = { "PathTraceCS", "DenoiseCS", "PathTraceDlssCS", "VkRayQueryCS" };
+
+#define GROUP_TUNE_IDLE_FRAMES 30   // Frames without the kernel / without timings before tuning gives up
+
+enum GroupSource { GROUP_SOURCE_DEFAULT, GROUP_SOURCE_OPTION, GROUP_SOURCE_STORED, GROUP_SOURCE_TUNED };
+static const char* s_sourceNames[] = { "default", "option", "stored", "tuned" };
+
+struct KernelTune {
+    bool begun;
+    UINT mask;              // Variants with a pipeline
+    UINT chosen;            // Dispatched when not tuning
+    GroupSource source;
+    bool pending;           // auto, nothing stored: tune when first selected
+    bool wanted;            // Selected while another kernel was tuning
+    UINT current;           // Variant being measured
+    UINT seen;              // Frames of `current` read back, incl. warm-up
+    UINT sampleCount;
+    double samples[GROUP_TUNE_SAMPLES];
+    double medianMs[GROUP_VARIANT_COUNT];   // 0 = not measured
+};
+
+static KernelTune s_tune[GROUP_KERNEL_COUNT] = {};
+static int s_tuningKernel = -1;
+static UINT s_idleFrames = 0;          // Timed frames that didn't dispatch the tuned kernel
+static UINT s_unsampledFrames = 0;     // Dispatches of the tuned kernel without a read-back time
+static int s_slotKernel[GROUP_TUNE_SLOTS];
+static UINT s_slotVariant[GROUP_TUNE_SLOTS];
+
+// Stored results of this adapter, by kernel (-1 = none)
+static int s_storedVariant[GROUP_KERNEL_COUNT];
+static double s_storedMs[GROUP_KERNEL_COUNT];
+static char s_storePath[MAX_PATH] = {0};
+
+const GroupShape& GroupVariant(UINT variant) {
+    return s_variants[variant < GROUP_VARIANT_COUNT ? variant : GROUP_VARIANT_DEFAULT];
+}
+
+int GroupVariantFind(const char* name) {
+    for (int i = 0; i < GROUP_VARIANT_COUNT; i++)
+        if (strcmp(name, s_variants[i].name) == 0) return i;
+    return -1;
+}
+
+const char* GroupKernelName(GroupKernel kernel) {
+    return kernel < GROUP_KERNEL_COUNT ? s_kernelNames[kernel] : "?";
+}
+
+// ============== RESULT FILE ==============
+// One line per kernel: "<kernel> <variant> <median ms>"
+static bool GetStorePath(IDXGIAdapter1* adapter, char* out, size_t size) {
+    DXGI_ADAPTER_DESC1 desc = {};
+    if (!adapter || FAILED(adapter->GetDesc1(&desc))) return false;
+    char dir[MAX_PATH];
+    GetModuleFileNameA(nullptr, dir, MAX_PATH);
+    char* slash = strrchr(dir, '\\');
+    if (slash) *slash = 0;
+    strcat_s(dir, "\\shadercache");
+    if (!CreateDirectoryA(dir, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) return false;
+    sprintf_s(out, size, "%s\\grouptune_%04x_%04x.txt", dir, desc.VendorId, desc.DeviceId);
+    return true;
+}
+
+static void LoadStore() {
+    FILE* f = nullptr;
+    if (!s_storePath[0] || fopen_s(&f, s_storePath, "r") != 0 || !f) return;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        char kernel[32], variant[16];
+        double ms = 0.0;
+        if (sscanf_s(line, "%31s %15s %lf", kernel, (unsigned)sizeof(kernel), variant, (unsigned)sizeof(variant), &ms) != 3)
+            continue;
+        int v = GroupVariantFind(variant);
+        for (UINT k = 0; k < GROUP_KERNEL_COUNT && v >= 0; k++) {
+            if (strcmp(kernel, s_kernelNames[k]) == 0) {
+                s_storedVariant[k] = v;
+                s_storedMs[k] = ms;
+            }
+        }
+    }
+    fclose(f);
+}
+
+// Temp file + rename: --all-gpus children with identical GPUs share the file
+static void SaveStore() {
+    if (!s_storePath[0]) return;
+    char tmpPath[MAX_PATH];
+    sprintf_s(tmpPath, "%s.%lu.tmp", s_storePath, GetCurrentProcessId());
+    FILE* f = nullptr;
+    if (fopen_s(&f, tmpPath, "w") != 0 || !f) return;
+    for (UINT k = 0; k < GROUP_KERNEL_COUNT; k++) {
+        if (s_storedVariant[k] >= 0)
+            fprintf(f, "%s %s %.4f\n", s_kernelNames[k], s_variants[s_storedVariant[k]].name, s_storedMs[k]);
+    }
+    fclose(f);
+    if (!MoveFileExA(tmpPath, s_storePath, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(tmpPath);
+        Log("[WARN] Group tune: could not write %s\n", s_storePath);
+    }
+}
+
+// ============== FRONTEND ==============
+void GroupTuneReset(IDXGIAdapter1* adapter) {
+    memset(s_tune, 0, sizeof(s_tune));
+    s_tuningKernel = -1;
+    s_idleFrames = s_unsampledFrames = 0;
+    for (UINT i = 0; i < GROUP_TUNE_SLOTS; i++) s_slotKernel[i] = -1;
+    for (UINT k = 0; k < GROUP_KERNEL_COUNT; k++) {
+        s_storedVariant[k] = -1;
+        s_storedMs[k] = 0.0;
+    }
+    s_storePath[0] = 0;
+    if (g_groupSize != GROUP_SIZE_AUTO || !g_shaderCacheEnabled) return;
+    if (GetStorePath(adapter, s_storePath, sizeof(s_storePath))) LoadStore();
+}
+
+bool GroupTuneBusy() {
+    if (s_tuningKernel >= 0) return true;
+    for (UINT k = 0; k < GROUP_KERNEL_COUNT; k++)
+        if (s_tune[k].pending && s_tune[k].wanted) return true;
+    return false;
+}
+
+void GroupTuneWriteJson(FILE* f) {
+    fprintf(f, "  \"groupSize\": {\n");
+    fprintf(f, "    \"mode\": \"%s\",\n", g_groupSize == GROUP_SIZE_AUTO ? "auto" : GroupVariant(g_groupSize).name);
+    fprintf(f, "    \"kernels\": {");
+    bool first = true;
+    for (UINT k = 0; k < GROUP_KERNEL_COUNT; k++) {
+        const KernelTune& t = s_tune[k];
+        if (!t.begun) continue;
+        fprintf(f, "%s\n      \"%s\": { \"variant\": \"%s\", \"source\": \"%s\", \"medianMs\": {", first ? "" : ",",
+            s_kernelNames[k], s_variants[t.chosen].name, t.pending ? "untuned" : s_sourceNames[t.source]);
+        bool firstMs = true;
+        for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) {
+            if (t.medianMs[v] <= 0.0) continue;
+            fprintf(f, "%s \"%s\": %.4f", firstMs ? "" : ",", s_variants[v].name, t.medianMs[v]);
+            firstMs = false;
+        }
+        fprintf(f, " } }");
+        first = false;
+    }
+    fprintf(f, "%s}\n", first ? " " : "\n    ");
+    fprintf(f, "  },\n");
+}
+
+// ============== TUNING ==============
+static UINT NextVariant(UINT mask, UINT after) {
+    for (UINT v = after + 1; v < GROUP_VARIANT_COUNT; v++)
+        if (mask & (1u << v)) return v;
+    return GROUP_VARIANT_COUNT;
+}
+
+static void StartTuning(UINT kernel) {
+    KernelTune& t = s_tune[kernel];
+    s_tuningKernel = (int)kernel;
+    s_idleFrames = s_unsampledFrames = 0;
+    t.current = NextVariant(t.mask, (UINT)-1);
+    t.seen = t.sampleCount = 0;
+    UINT count = 0;
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) count += (t.mask >> v) & 1;
+    Log("[INFO] Group tune: timing %u %s variants\n", count, s_kernelNames[kernel]);
+}
+
+static void AbortTuning(const char* reason) {
+    KernelTune& t = s_tune[s_tuningKernel];
+    Log("[WARN] Group tune: %s %s, keeping %s\n", s_kernelNames[s_tuningKernel], reason, s_variants[t.chosen].name);
+    t.pending = t.wanted = false;   // Not retried before the next renderer init
+    s_tuningKernel = -1;
+}
+
+static void FinishTuning(KernelTune& t, UINT kernel) {
+    UINT best = GROUP_VARIANT_DEFAULT;
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) {
+        if (t.medianMs[v] > 0.0 && (t.medianMs[best] <= 0.0 || t.medianMs[v] < t.medianMs[best])) best = v;
+    }
+    char table[256] = "";
+    size_t len = 0;
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT && len < sizeof(table); v++) {
+        if (t.medianMs[v] <= 0.0) continue;
+        int n = sprintf_s(table + len, sizeof(table) - len, "%s%s %.3f", len ? " | " : "", s_variants[v].name, t.medianMs[v]);
+        if (n < 0) break;
+        len += n;
+    }
+    double base = t.medianMs[GROUP_VARIANT_DEFAULT];
+    Log("[INFO] Group tune %s (median GPU ms): %s -> %s (%+.1f%% vs 8x8)\n", s_kernelNames[kernel], table,
+        s_variants[best].name, base > 0.0 ? 100.0 * (t.medianMs[best] - base) / base : 0.0);
+
+    t.chosen = best;
+    t.source = GROUP_SOURCE_TUNED;
+    t.pending = t.wanted = false;
+    s_tuningKernel = -1;
+    if (s_storePath[0]) {
+        s_storedVariant[kernel] = (int)best;
+        s_storedMs[kernel] = t.medianMs[best];
+        SaveStore();
+    }
+}
+
+// ============== BACKENDS ==============
+UINT GroupTuneBegin(GroupKernel kernel, UINT waveMin, UINT waveMax) {
+    if (kernel >= GROUP_KERNEL_COUNT) return 1u << GROUP_VARIANT_DEFAULT;
+    KernelTune& t = s_tune[kernel];
+    memset(&t, 0, sizeof(t));
+    t.begun = true;
+    t.chosen = GROUP_VARIANT_DEFAULT;
+
+    UINT supported = 0;
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) {
+        UINT wave = s_variants[v].wave;
+        if (!wave || (wave >= waveMin && wave <= waveMax)) supported |= 1u << v;
+    }
+
+    if (g_groupSize != GROUP_SIZE_AUTO) {
+        if (g_groupSize == GROUP_VARIANT_DEFAULT) {
+            t.mask = 1u << GROUP_VARIANT_DEFAULT;
+            return t.mask;
+        }
+        if (supported & (1u << g_groupSize)) {
+            t.chosen = (UINT)g_groupSize;
+            t.source = GROUP_SOURCE_OPTION;
+        } else {
+            Log("[WARN] --group-size=%s: wave size not supported by this device for %s, using 8x8\n",
+                s_variants[g_groupSize].name, s_kernelNames[kernel]);
+        }
+        t.mask = (1u << GROUP_VARIANT_DEFAULT) | (1u << t.chosen);
+    } else if (s_storedVariant[kernel] >= 0 && (supported & (1u << s_storedVariant[kernel]))) {
+        t.chosen = (UINT)s_storedVariant[kernel];
+        t.source = GROUP_SOURCE_STORED;
+        t.mask = (1u << GROUP_VARIANT_DEFAULT) | (1u << t.chosen);
+        Log("[INFO] Group size %s: %s (stored in %s)\n", s_kernelNames[kernel], s_variants[t.chosen].name, s_storePath);
+    } else {
+        t.pending = true;
+        t.mask = supported;
+    }
+    return t.mask;
+}
+
+void GroupTuneDrop(GroupKernel kernel, UINT variant) {
+    if (kernel >= GROUP_KERNEL_COUNT || variant == GROUP_VARIANT_DEFAULT || variant >= GROUP_VARIANT_COUNT) return;
+    KernelTune& t = s_tune[kernel];
+    t.mask &= ~(1u << variant);
+    if (t.chosen == variant) {
+        t.chosen = GROUP_VARIANT_DEFAULT;
+        t.source = GROUP_SOURCE_DEFAULT;
+    }
+}
+
+UINT GroupTuneSelect(GroupKernel kernel, UINT slot) {
+    if (kernel >= GROUP_KERNEL_COUNT || !s_tune[kernel].begun) return GROUP_VARIANT_DEFAULT;
+    KernelTune& t = s_tune[kernel];
+    if (t.pending) {
+        if (s_tuningKernel < 0) StartTuning(kernel);
+        else if (s_tuningKernel != (int)kernel) t.wanted = true;
+    }
+    if (s_tuningKernel != (int)kernel) return t.chosen;
+    if (++s_unsampledFrames > GROUP_TUNE_IDLE_FRAMES) {
+        AbortTuning("gets no GPU timings");
+        return t.chosen;
+    }
+    if (slot < GROUP_TUNE_SLOTS) {
+        s_slotKernel[slot] = (int)kernel;
+        s_slotVariant[slot] = t.current;
+    }
+    return t.current;
+}
+
+void GroupTuneFrameTime(UINT slot, double gpuMs) {
+    if (slot >= GROUP_TUNE_SLOTS) return;
+    int kernel = s_slotKernel[slot];
+    s_slotKernel[slot] = -1;
+    if (s_tuningKernel < 0) return;
+
+    KernelTune& t = s_tune[s_tuningKernel];
+    if (kernel != s_tuningKernel) {
+        // The pass was switched off mid-tune: leave it untuned for this run
+        if (++s_idleFrames >= GROUP_TUNE_IDLE_FRAMES) AbortTuning("no longer dispatched");
+        return;
+    }
+    s_idleFrames = s_unsampledFrames = 0;
+    if (s_slotVariant[slot] != t.current || gpuMs <= 0.0) return;   // Recorded before the last switch
+    if (t.seen++ < GROUP_TUNE_WARMUP) return;
+
+    t.samples[t.sampleCount++] = gpuMs;
+    if (t.sampleCount < GROUP_TUNE_SAMPLES) return;
+    std::sort(t.samples, t.samples + GROUP_TUNE_SAMPLES);
+    t.medianMs[t.current] = 0.5 * (t.samples[GROUP_TUNE_SAMPLES / 2 - 1] + t.samples[GROUP_TUNE_SAMPLES / 2]);
+
+    t.current = NextVariant(t.mask, t.current);
+    t.seen = t.sampleCount = 0;
+    if (t.current >= GROUP_VARIANT_COUNT) FinishTuning(t, (UINT)s_tuningKernel);
+}
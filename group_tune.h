@@ -0,0 +1,70 @@
+#pragma once
+// ============== THREAD-GROUP SHAPE AUTO-TUNER ==============
+// --group-size=<auto|8x8|16x8|8x4|8x8w32|8x8w64|16x8w32>: thread-group shape
+// of the per-pixel compute kernels that used to hard-code 8x8 (D3D12 PT
+// PathTraceCS, DenoiseCS + TemporalCS, the DLSS G-buffer PathTraceDlssCS and
+// the Vulkan RQ compute shader). "wN" variants also force the wave / subgroup
+// size (SM 6.6 [WaveSize], VK_EXT_subgroup_size_control) and are only offered
+// when the device supports that lane count. Divergent ray-query loops are
+// sensitive to both, and the best shape differs a lot between vendors.
+//
+// The D3D12 kernels are compiled per variant from the GROUP_X / GROUP_Y /
+// WAVE_SIZE defines of shaders/group_shape_shaders.h (each its own DXIL cache
+// entry and PSO); the Vulkan RQ SPIR-V gets its LocalSize rewritten
+// (vk_specialize.h). The default variant 8x8 always exists: the other paths
+// (DLSS fallback, --split-gpu) keep dispatching it.
+//
+// auto: a kernel without a stored result is tuned on its first frames, one
+// kernel at a time. Each supported variant runs GROUP_TUNE_WARMUP frames, then
+// GROUP_TUNE_SAMPLES frames whose GPU time is read back per frame slot; the
+// variant with the lowest median wins and is stored per adapter in
+// shadercache\grouptune_<ven>_<dev>.txt, so later runs on that GPU start with
+// it. Delete the file to tune again; --no-shader-cache neither reads nor
+// writes it. --benchmark keeps warming up until tuning is over.
+
+#include "common.h"
+
+enum GroupKernel {
+    GROUP_KERNEL_PT_TRACE,      // D3D12 PT megakernel
+    GROUP_KERNEL_PT_DENOISE,    // D3D12 PT temporal + a-trous passes (one shape for both)
+    GROUP_KERNEL_DLSS_GBUFFER,  // D3D12 PT + DLSS G-buffer path tracer
+    GROUP_KERNEL_VK_RQ,         // Vulkan RQ compute tracer
+    GROUP_KERNEL_COUNT
+};
+
+struct GroupShape {
+    UINT x, y;
+    UINT wave;          // Required wave / subgroup size, 0 = driver choice
+    const char* name;   // --group-size value
+};
+
+#define GROUP_VARIANT_COUNT 6
+#define GROUP_VARIANT_DEFAULT 0     // 8x8, driver wave size
+#define GROUP_SIZE_AUTO -1
+#define GROUP_TUNE_WARMUP 4         // Frames per variant before sampling (PSO warm-up, caches)
+#define GROUP_TUNE_SAMPLES 24       // Frame times per variant, median
+#define GROUP_TUNE_SLOTS 4          // >= FRAME_COUNT of every backend
+
+extern int g_groupSize;     // --group-size: variant index, GROUP_SIZE_AUTO = tune
+
+const GroupShape& GroupVariant(UINT variant);
+int GroupVariantFind(const char* name);   // -1 if unknown
+const char* GroupKernelName(GroupKernel kernel);
+
+// Frontend
+void GroupTuneReset(IDXGIAdapter1* adapter);   // InitRenderer: loads the adapter's stored results
+bool GroupTuneBusy();                          // A kernel is being (or waits to be) tuned
+void GroupTuneWriteJson(FILE* f);              // Benchmark report "groupSize" block (incl. trailing comma)
+
+// Backends
+// At init, before creating the kernel's pipelines. waveMin / waveMax = lane
+// counts the device can force (0, 0 = none). Returns the variants to create
+// as a bit mask (bit GROUP_VARIANT_DEFAULT always set).
+UINT GroupTuneBegin(GroupKernel kernel, UINT waveMin, UINT waveMax);
+void GroupTuneDrop(GroupKernel kernel, UINT variant);          // Its pipeline failed, never select it
+// While recording frame slot `slot`: the variant to dispatch. Kernels that
+// were never begun get GROUP_VARIANT_DEFAULT.
+UINT GroupTuneSelect(GroupKernel kernel, UINT slot);
+// When the slot's GPU timestamps are read back: the frame's GPU time (or the
+// tuned pass' time, when the backend times it separately)
+void GroupTuneFrameTime(UINT slot, double gpuMs);
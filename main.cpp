@@ -3,6 +3,22 @@
 // Supports: D3D11, D3D12, D3D12+RT, D3D12+PT, D3D12+DLSS, OpenGL, Vulkan
 
 #include "common.h"
+#include "benchmark.h"
+#include "gpu_profiler.h"
+#include "frame_latency.h"
+#include "offscreen.h"
+#include "accumulation.h"
+#include "tlas_policy.h"
+#include "rt_geometry.h"
+#include "rt_sampling.h"
+#include "ray_stats.h"
+#include "ray_reorder.h"
+#include "pt_lights.h"
+#include "mesh_file.h"
+#include "multi_gpu_bench.h"
+#include "startup_profiler.h"
+#include "vram_budget.h"
+#include "group_tune.h"
 
 // Include renderer headers
 #include "d3d11/renderer_d3d11.h"
@@ -21,8 +37,8 @@ extern "C" {
 }
 
 // ============== GLOBAL DEFINITIONS ==============
-const UINT W = 640;
-const UINT H = 480;
+UINT W = 640;
+UINT H = 480;
 
 std::vector<GPUInfo> g_gpuList;
 Settings g_settings;
@@ -30,12 +46,79 @@ HINSTANCE g_hInstance;
 bool g_tearingSupported = false;
 std::wstring gpuName;
 int fps = 0;
+UINT g_cubeCount = 0;
+bool g_gpuCulling = false;
+UINT g_recordThreads = 0;
+bool g_meshShaders = false;
+bool g_glCore = false;
+bool g_asyncCompute = false;
+bool g_zeroCopyPresent = false;
+bool g_vkPrerecord = false;
+bool g_bundles = false;
+UINT g_captureEvery = 0;
+char g_captureDir[MAX_PATH] = {0};
+char g_recordPath[MAX_PATH] = {0};
+UINT g_recordMbps = 20;
+LogLevel g_logLevel = LOG_LEVEL_DEBUG;
+bool g_logSync = false;
+UINT g_ptSpp = 1;
+UINT g_ptMaxBounces = 4;
+UINT g_ptAdaptiveMaxSpp = 0;
+float g_ptAdaptiveTarget = PT_ADAPTIVE_DEFAULT_TARGET;
+bool g_ptWavefront = false;
+int g_ptSplitGpu = PT_SPLIT_GPU_OFF;
+float g_ptSplitRatio = 0.0f;
+UINT g_renderScalePct = 100;
+RtIndirectRate g_rtIndirectRate = RT_INDIRECT_FULL;
+bool g_rtDepthPrepass = false;
+bool g_rtVrs = false;
+float g_rtVrsThreshold = RT_VRS_DEFAULT_THRESHOLD;
+DlssQualityMode g_dlssMode = DLSS_MODE_DLAA;
+float g_dlssTargetMs = 0.0f;
+bool g_frameInterp = false;
 LARGE_INTEGER g_startTime, g_perfFreq;
 HWND g_hMainWnd = nullptr;
 static HWND g_hSettingsDlg = nullptr;
 static bool g_settingsAccepted = false;
 static bool g_settingsDlgClosed = false;
-static bool g_inSizeMove = false;
+static volatile LONG s_pendingSize = 0;       // Latest WM_SIZE client size (w << 16 | h), 0 = none
+static volatile LONG s_renderQuit = 0;        // Window thread -> render thread: stop after this frame
+static HANDLE s_renderThread = nullptr;       // Runs RenderThreadProc while the window thread pumps messages
+static int s_pendingSwitch = -1;              // Render thread: RendererType requested by F5 / Shift+F5, -1 = none
+
+// ============== RENDER THREAD EVENTS ==============
+// Rendering runs on its own thread (RenderThreadProc); the window thread only
+// pumps messages. Key presses reach the render thread through this single
+// producer (WndProc) / single consumer (render loop) ring, so neither side
+// ever blocks on the other. A full ring drops the key instead of stalling the
+// pump. Resizes bypass the ring: only the latest size matters, so WM_SIZE
+// just overwrites s_pendingSize.
+struct RenderEvent {
+    UINT key;       // Virtual key code from WM_KEYDOWN
+    bool shift;     // Shift held when the key went down
+};
+static const LONG RENDER_EVENT_CAPACITY = 64;
+static RenderEvent s_renderEvents[RENDER_EVENT_CAPACITY];
+static volatile LONG s_renderEventHead = 0;   // Next slot written by the window thread
+static volatile LONG s_renderEventTail = 0;   // Next slot read by the render thread
+
+static bool PushRenderEvent(const RenderEvent& e)
+{
+    LONG head = s_renderEventHead;
+    if (head - InterlockedCompareExchange(&s_renderEventTail, 0, 0) >= RENDER_EVENT_CAPACITY) return false;
+    s_renderEvents[head % RENDER_EVENT_CAPACITY] = e;
+    InterlockedExchange(&s_renderEventHead, head + 1);   // Publishes the slot
+    return true;
+}
+
+static bool PopRenderEvent(RenderEvent& e)
+{
+    LONG tail = s_renderEventTail;
+    if (tail == InterlockedCompareExchange(&s_renderEventHead, 0, 0)) return false;
+    e = s_renderEvents[tail % RENDER_EVENT_CAPACITY];
+    InterlockedExchange(&s_renderEventTail, tail + 1);   // Frees the slot
+    return true;
+}
 
 // Vulkan text state
 bool g_vkTextInitialized = false;
@@ -47,6 +130,9 @@ struct CmdLineArgs {
     bool hasRenderer = false;
     bool hasGpu = false;
     bool skipDialogs = false;
+    bool precompileShaders = false;  // --precompile-shaders: fill the DXIL cache before init
+    bool precompileOnly = false;     // --precompile-only: fill the DXIL cache and exit
+    std::string convertMesh;         // --convert-mesh=<in>: write <in>.rtm and exit
 };
 
 static CmdLineArgs g_cmdArgs;
@@ -65,12 +151,30 @@ static bool ParseRendererType(const char* str, RendererType& out) {
     return false;
 }
 
+char* CommandArgToken(char* str, char** context) {
+    char* p = str ? str : *context;
+    if (!p) return nullptr;
+    while (*p == ' ') p++;
+    if (!*p) { *context = p; return nullptr; }
+    char* token = p;
+    char* out = p;      // Quotes are dropped in place
+    bool quoted = false;
+    for (; *p && (quoted || *p != ' '); p++) {
+        if (*p == '"') quoted = !quoted;
+        else *out++ = *p;
+    }
+    if (*p) p++;        // Past the separating space
+    *out = 0;
+    *context = p;
+    return token;
+}
+
 static void ParseCommandLine(LPSTR cmdLine) {
     if (!cmdLine || !*cmdLine) return;
 
     char* cmd = _strdup(cmdLine);
     char* context = nullptr;
-    char* token = strtok_s(cmd, " ", &context);
+    char* token = CommandArgToken(cmd, &context);
 
     while (token) {
         // --renderer=vulkan_rt or -r vulkan_rt
@@ -81,7 +185,7 @@ static void ParseCommandLine(LPSTR cmdLine) {
             }
         }
         else if (strcmp(token, "-r") == 0 || strcmp(token, "--renderer") == 0) {
-            token = strtok_s(nullptr, " ", &context);
+            token = CommandArgToken(nullptr, &context);
             if (token && ParseRendererType(token, g_cmdArgs.renderer)) {
                 g_cmdArgs.hasRenderer = true;
                 g_cmdArgs.skipDialogs = true;
@@ -94,13 +198,284 @@ static void ParseCommandLine(LPSTR cmdLine) {
             g_cmdArgs.hasGpu = true;
         }
         else if (strcmp(token, "-g") == 0 || strcmp(token, "--gpu") == 0) {
-            token = strtok_s(nullptr, " ", &context);
+            token = CommandArgToken(nullptr, &context);
             if (token) {
                 g_cmdArgs.gpuIndex = atoi(token);
                 g_cmdArgs.hasGpu = true;
             }
             continue;
         }
+        // --benchmark [--frames=N | --seconds=S] [--warmup=N] [--report=<path>]
+        else if (strcmp(token, "--benchmark") == 0) {
+            g_benchConfig.enabled = true;
+            g_cmdArgs.skipDialogs = true;
+        }
+        else if (strcmp(token, "--sweep") == 0) {
+            g_benchConfig.enabled = true;
+            g_benchConfig.sweep = true;
+            g_cmdArgs.skipDialogs = true;
+        }
+        else if (strncmp(token, "--frames=", 9) == 0) {
+            int n = atoi(token + 9);
+            g_benchConfig.frames = n > 0 ? (UINT)n : 0;
+        }
+        else if (strncmp(token, "--seconds=", 10) == 0) {
+            double s = atof(token + 10);
+            if (s > 0.0) g_benchConfig.seconds = s;
+        }
+        else if (strncmp(token, "--warmup=", 9) == 0) {
+            int n = atoi(token + 9);
+            g_benchConfig.warmupFrames = n > 0 ? (UINT)n : 0;
+        }
+        else if (strncmp(token, "--report=", 9) == 0) {
+            strcpy_s(g_benchConfig.reportPath, token + 9);
+        }
+        // --all-gpus: one concurrent --benchmark / --sweep child per adapter
+        else if (strcmp(token, "--all-gpus") == 0) {
+            g_benchConfig.enabled = true;
+            g_benchConfig.allGpus = true;
+            g_cmdArgs.skipDialogs = true;
+        }
+        else if (strncmp(token, "--instance=", 11) == 0) {
+            strcpy_s(g_benchConfig.instanceTag, token + 11);
+            SetLogInstance(g_benchConfig.instanceTag);
+        }
+        else if (strcmp(token, "--no-shader-cache") == 0) {
+            g_shaderCacheEnabled = false;
+        }
+        else if (strcmp(token, "--precompile-shaders") == 0) {
+            g_cmdArgs.precompileShaders = true;
+        }
+        else if (strcmp(token, "--precompile-only") == 0) {
+            g_cmdArgs.precompileOnly = true;
+        }
+        // --cubes=N (instanced raster stress scene)
+        else if (strncmp(token, "--cubes=", 8) == 0) {
+            int n = atoi(token + 8);
+            if (n > MAX_CUBE_INSTANCES) n = MAX_CUBE_INSTANCES;
+            g_cubeCount = n > 0 ? (UINT)n : 0;
+        }
+        // --mesh=<file.rtm> (streamed mesh in place of the cube), --convert-mesh=<in>
+        else if (strncmp(token, "--mesh=", 7) == 0) {
+            g_meshPath = token + 7;
+        }
+        else if (strncmp(token, "--convert-mesh=", 15) == 0) {
+            g_cmdArgs.convertMesh = token + 15;
+        }
+        else if (strcmp(token, "--gpu-culling") == 0) {
+            g_gpuCulling = true;
+        }
+        else if (strncmp(token, "--record-threads=", 17) == 0) {
+            int n = atoi(token + 17);
+            if (n > MAX_RECORD_THREADS) n = MAX_RECORD_THREADS;
+            g_recordThreads = n > 0 ? (UINT)n : 0;
+        }
+        else if (strcmp(token, "--mesh-shaders") == 0) {
+            g_meshShaders = true;
+        }
+        else if (strcmp(token, "--gl-core") == 0) {
+            g_glCore = true;
+        }
+        else if (strcmp(token, "--async-compute") == 0) {
+            g_asyncCompute = true;
+        }
+        else if (strcmp(token, "--zero-copy") == 0) {
+            g_zeroCopyPresent = true;
+        }
+        else if (strcmp(token, "--prerecord") == 0) {
+            g_vkPrerecord = true;
+        }
+        else if (strcmp(token, "--bundles") == 0) {
+            g_bundles = true;
+        }
+        // --accumulate or --accumulate=N (target SPP)
+        else if (strcmp(token, "--accumulate") == 0) {
+            g_accumTargetSpp = ACCUM_DEFAULT_TARGET_SPP;
+        }
+        else if (strncmp(token, "--accumulate=", 13) == 0) {
+            int n = atoi(token + 13);
+            g_accumTargetSpp = n > 0 ? (UINT)n : ACCUM_DEFAULT_TARGET_SPP;
+        }
+        // --tlas-rebuild-threshold=D --tlas-rebuild-period=N (refit vs rebuild, tlas_policy.h)
+        else if (strncmp(token, "--tlas-rebuild-threshold=", 25) == 0) {
+            float d = (float)atof(token + 25);
+            g_tlasRebuildThreshold = d > 0.0f ? d : 0.0f;
+        }
+        else if (strncmp(token, "--tlas-rebuild-period=", 22) == 0) {
+            int n = atoi(token + 22);
+            g_tlasRebuildPeriod = n > 0 ? (UINT)n : 0;
+        }
+        // --spp=N --bounces=N --adaptive[=E] --adaptive-max-spp=N --wavefront (D3D12 PT sampling)
+        else if (strncmp(token, "--spp=", 6) == 0) {
+            int n = atoi(token + 6);
+            if (n > PT_MAX_SPP) n = PT_MAX_SPP;
+            g_ptSpp = n > 0 ? (UINT)n : 1;
+        }
+        else if (strncmp(token, "--bounces=", 10) == 0) {
+            int n = atoi(token + 10);
+            if (n > PT_MAX_BOUNCES) n = PT_MAX_BOUNCES;
+            g_ptMaxBounces = n > 0 ? (UINT)n : 1;
+        }
+        else if (strcmp(token, "--adaptive") == 0) {
+            if (!g_ptAdaptiveMaxSpp) g_ptAdaptiveMaxSpp = PT_ADAPTIVE_DEFAULT_MAX_SPP;
+        }
+        else if (strncmp(token, "--adaptive=", 11) == 0) {
+            float e = (float)atof(token + 11);
+            g_ptAdaptiveTarget = e > 0.0f ? e : PT_ADAPTIVE_DEFAULT_TARGET;
+            if (!g_ptAdaptiveMaxSpp) g_ptAdaptiveMaxSpp = PT_ADAPTIVE_DEFAULT_MAX_SPP;
+        }
+        else if (strncmp(token, "--adaptive-max-spp=", 19) == 0) {
+            int n = atoi(token + 19);
+            if (n > PT_MAX_SPP) n = PT_MAX_SPP;
+            g_ptAdaptiveMaxSpp = n > 0 ? (UINT)n : PT_ADAPTIVE_DEFAULT_MAX_SPP;
+        }
+        else if (strcmp(token, "--wavefront") == 0) {
+            g_ptWavefront = true;
+        }
+        // --split-gpu[=N] --split-ratio=F (D3D12 PT split-frame multi-adapter)
+        else if (strcmp(token, "--split-gpu") == 0) {
+            g_ptSplitGpu = PT_SPLIT_GPU_AUTO;
+        }
+        else if (strncmp(token, "--split-gpu=", 12) == 0) {
+            int n = atoi(token + 12);
+            g_ptSplitGpu = n >= 0 ? n : PT_SPLIT_GPU_AUTO;
+        }
+        else if (strncmp(token, "--split-ratio=", 14) == 0) {
+            float r = (float)atof(token + 14);
+            g_ptSplitRatio = r > 0.0f && r < 1.0f ? r : 0.0f;
+            if (g_ptSplitGpu == PT_SPLIT_GPU_OFF) g_ptSplitGpu = PT_SPLIT_GPU_AUTO;
+        }
+        // --lights=N --light-sampling=<uniform|ris|restir> (D3D12 PT many lights, pt_lights.h)
+        else if (strncmp(token, "--lights=", 9) == 0) {
+            int n = atoi(token + 9);
+            if (n > PT_MAX_LIGHTS) n = PT_MAX_LIGHTS;
+            g_ptLights = n > 0 ? (UINT)n : 0;
+        }
+        else if (strncmp(token, "--light-sampling=", 17) == 0) {
+            const char* name = token + 17;
+            if (strcmp(name, "uniform") == 0) g_ptLightSampling = PT_LIGHTS_UNIFORM;
+            else if (strcmp(name, "ris") == 0) g_ptLightSampling = PT_LIGHTS_RIS;
+            else if (strcmp(name, "restir") == 0) g_ptLightSampling = PT_LIGHTS_RESTIR;
+            else Log("[WARN] Unknown light sampling '%s', using uniform\n", name);
+        }
+        // --compact-verts (RT BLAS inputs, rt_geometry.h)
+        else if (strcmp(token, "--compact-verts") == 0) {
+            g_compactVerts = true;
+        }
+        // --sampler=<white|sobol|bluenoise> (RT / PT random numbers, rt_sampling.h)
+        else if (strncmp(token, "--sampler=", 10) == 0) {
+            const char* name = token + 10;
+            if (strcmp(name, "white") == 0) g_rtSampler = RT_SAMPLER_WHITE;
+            else if (strcmp(name, "sobol") == 0) g_rtSampler = RT_SAMPLER_SOBOL;
+            else if (strcmp(name, "bluenoise") == 0) g_rtSampler = RT_SAMPLER_BLUENOISE;
+            else Log("[WARN] Unknown sampler '%s', using white\n", name);
+        }
+        // --ray-stats (per-type ray counts + Mrays/s, ray_stats.h)
+        else if (strcmp(token, "--ray-stats") == 0) {
+            g_rayStats = true;
+        }
+        // --ser (shader execution reordering, ray_reorder.h)
+        else if (strcmp(token, "--ser") == 0) {
+            g_ser = true;
+        }
+        // --render-scale=P (percent per axis, D3D12 PT / Vulkan RQ)
+        else if (strncmp(token, "--render-scale=", 15) == 0) {
+            int n = atoi(token + 15);
+            if (n < RENDER_SCALE_MIN_PCT) n = RENDER_SCALE_MIN_PCT;
+            g_renderScalePct = n < 100 ? (UINT)n : 100;
+        }
+        // --rt-indirect=<rate> (DXR 1.1 AO/GI resolution)
+        else if (strncmp(token, "--rt-indirect=", 14) == 0) {
+            const char* rate = token + 14;
+            if (strcmp(rate, "full") == 0) g_rtIndirectRate = RT_INDIRECT_FULL;
+            else if (strcmp(rate, "half") == 0) g_rtIndirectRate = RT_INDIRECT_HALF;
+            else if (strcmp(rate, "quarter") == 0) g_rtIndirectRate = RT_INDIRECT_QUARTER;
+            else if (strcmp(rate, "checkerboard") == 0 || strcmp(rate, "checker") == 0) g_rtIndirectRate = RT_INDIRECT_CHECKER;
+            else Log("[WARN] Unknown AO/GI rate '%s', using full\n", rate);
+        }
+        // --depth-prepass (DXR 1.1 depth-only pass, shading with EQUAL depth)
+        else if (strcmp(token, "--depth-prepass") == 0) {
+            g_rtDepthPrepass = true;
+        }
+        // --vrs / --vrs=T (DXR 1.1 shading rate image, T = luminance variance threshold)
+        else if (strcmp(token, "--vrs") == 0) {
+            g_rtVrs = true;
+        }
+        else if (strncmp(token, "--vrs=", 6) == 0) {
+            g_rtVrs = true;
+            float t = (float)atof(token + 6);
+            if (t > 0.0f) g_rtVrsThreshold = t;
+            else Log("[WARN] Invalid VRS threshold '%s', using %.4f\n", token + 6, RT_VRS_DEFAULT_THRESHOLD);
+        }
+        // --dlss=<mode> --dlss-target-ms=T (D3D12 PT + DLSS input size)
+        else if (strncmp(token, "--dlss=", 7) == 0) {
+            const char* mode = token + 7;
+            if (strcmp(mode, "dlaa") == 0) g_dlssMode = DLSS_MODE_DLAA;
+            else if (strcmp(mode, "quality") == 0) g_dlssMode = DLSS_MODE_QUALITY;
+            else if (strcmp(mode, "balanced") == 0) g_dlssMode = DLSS_MODE_BALANCED;
+            else if (strcmp(mode, "performance") == 0) g_dlssMode = DLSS_MODE_PERFORMANCE;
+            else if (strcmp(mode, "ultra-performance") == 0 || strcmp(mode, "ultra") == 0) g_dlssMode = DLSS_MODE_ULTRA_PERFORMANCE;
+            else Log("[WARN] Unknown DLSS mode '%s', using DLAA\n", mode);
+        }
+        else if (strncmp(token, "--dlss-target-ms=", 17) == 0) {
+            float ms = (float)atof(token + 17);
+            g_dlssTargetMs = ms > 0.0f ? ms : 0.0f;
+        }
+        else if (strcmp(token, "--frame-interp") == 0) g_frameInterp = true;
+        // --max-latency=N (1-3) --present-mode=immediate|mailbox|fifo|adaptive
+        else if (strncmp(token, "--max-latency=", 14) == 0) {
+            int n = atoi(token + 14);
+            if (n > MAX_FRAME_LATENCY) n = MAX_FRAME_LATENCY;
+            g_maxFrameLatency = n > 0 ? (UINT)n : 0;
+        }
+        else if (strncmp(token, "--present-mode=", 15) == 0) {
+            const char* mode = token + 15;
+            if (strcmp(mode, "immediate") == 0) g_presentMode = PRESENT_MODE_IMMEDIATE;
+            else if (strcmp(mode, "mailbox") == 0) g_presentMode = PRESENT_MODE_MAILBOX;
+            else if (strcmp(mode, "fifo") == 0 || strcmp(mode, "vsync") == 0) g_presentMode = PRESENT_MODE_FIFO;
+            else if (strcmp(mode, "adaptive") == 0) g_presentMode = PRESENT_MODE_ADAPTIVE;
+            else Log("[WARN] Unknown present mode '%s', using default\n", mode);
+        }
+        else if (strcmp(token, "--offscreen") == 0) g_offscreen = true;
+        // --capture=N --capture-dir=<dir>
+        else if (strncmp(token, "--capture=", 10) == 0) {
+            int n = atoi(token + 10);
+            g_captureEvery = n > 0 ? (UINT)n : 0;
+        }
+        else if (strncmp(token, "--capture-dir=", 14) == 0) strcpy_s(g_captureDir, token + 14);
+        // --record=<file.h264> --record-mbps=N
+        else if (strncmp(token, "--record=", 9) == 0) strcpy_s(g_recordPath, token + 9);
+        else if (strncmp(token, "--record-mbps=", 14) == 0) {
+            int n = atoi(token + 14);
+            if (n > 0) g_recordMbps = (UINT)n;
+        }
+        // --group-size=auto|8x8|16x8|8x4|8x8w32|8x8w64|16x8w32 (group_tune.h)
+        else if (strncmp(token, "--group-size=", 13) == 0) {
+            const char* shape = token + 13;
+            int v = GroupVariantFind(shape);
+            if (strcmp(shape, "auto") == 0) g_groupSize = GROUP_SIZE_AUTO;
+            else if (v >= 0) g_groupSize = v;
+            else Log("[WARN] Unknown group size '%s', using 8x8\n", shape);
+        }
+        // --log-level=error|warn|info|debug --log-sync
+        else if (strncmp(token, "--log-level=", 12) == 0) {
+            const char* level = token + 12;
+            if (strcmp(level, "error") == 0) g_logLevel = LOG_LEVEL_ERROR;
+            else if (strcmp(level, "warn") == 0) g_logLevel = LOG_LEVEL_WARN;
+            else if (strcmp(level, "info") == 0) g_logLevel = LOG_LEVEL_INFO;
+            else if (strcmp(level, "debug") == 0) g_logLevel = LOG_LEVEL_DEBUG;
+            else Log("[WARN] Unknown log level '%s', using debug\n", level);
+        }
+        else if (strcmp(token, "--log-sync") == 0) g_logSync = true;
+        // --width=N --height=N (initial client size)
+        else if (strncmp(token, "--width=", 8) == 0) {
+            int n = atoi(token + 8);
+            if (n >= 64 && n <= 16384) W = (UINT)n;
+        }
+        else if (strncmp(token, "--height=", 9) == 0) {
+            int n = atoi(token + 9);
+            if (n >= 64 && n <= 16384) H = (UINT)n;
+        }
         // --help or -h
         else if (strcmp(token, "--help") == 0 || strcmp(token, "-h") == 0) {
             MessageBoxA(0,
@@ -112,59 +487,126 @@ static void ParseCommandLine(LPSTR cmdLine) {
                 "    Short aliases: dxr10, dxr11, pt, dlss, gl, vk, vk_rt, vk_rq\n\n"
                 "  --gpu=<index> or -g <index>\n"
                 "    GPU index (0 = first GPU)\n\n"
+                "  --benchmark\n"
+                "    Run without dialogs, record frame times, write report and exit\n"
+                "  --frames=<N> | --seconds=<S>\n"
+                "    Measured frames, or seconds if frames not given (default 10 s)\n"
+                "  --warmup=<N>\n"
+                "    Frames skipped before measuring (default 100)\n"
+                "  --report=<path>\n"
+                "    Report base path, writes <path>.json and <path>.csv\n"
+                "  --sweep\n"
+                "    Benchmark every renderer in turn, write a comparison table\n"
+                "  --all-gpus\n"
+                "    Run the benchmark / sweep on every GPU at once (one process each), write <report>_gpus.csv\n"
+                "  --width=<N> --height=<N>\n"
+                "    Initial window client size (default 640x480)\n"
+                "  --cubes=<N>\n"
+                "    Raster renderers draw N instanced rounded cubes (stress test)\n"
+                "  --mesh=<file.rtm>\n"
+                "    Raster: draw the mesh in place of the --cubes cube; D3D12 PT / Vulkan RQ: as the cube BLAS\n"
+                "  --convert-mesh=<file.obj|.gltf|.glb>\n"
+                "    Write <file>.rtm (memory-mapped vertex / index layout for --mesh) and exit\n"
+                "  --gpu-culling\n"
+                "    D3D12: frustum + Hi-Z occlusion cull the cubes on the GPU, draw via ExecuteIndirect\n"
+                "  --record-threads=<T>\n"
+                "    D3D12 / D3D11: one draw per cube, recorded by T worker threads (D3D11: deferred contexts)\n"
+                "  --mesh-shaders\n"
+                "    D3D12: generate the cubes in amplification + mesh shaders (meshlet culling, no VB/IB)\n"
+                "  --gl-core\n"
+                "    OpenGL: 4.5 core context, persistent-mapped frame ring, GLSL, multi-draw indirect\n"
+                "  --async-compute\n"
+                "    Vulkan RQ: TLAS rebuild + ray query dispatch on the async compute queue\n"
+                "  --zero-copy\n"
+                "    D3D12 PT / Vulkan RT: trace straight into the swap chain image (no output copy)\n"
+                "  --prerecord\n"
+                "    Vulkan: replay per-image command buffers recorded once (re-record on overlay change)\n"
+                "  --bundles\n"
+                "    D3D12: replay the scene / overlay draws from bundles recorded once (re-record on overlay change)\n"
+                "  --accumulate[=<N>]\n"
+                "    D3D12 PT / Vulkan RQ: progressive FP32 accumulation while the scene is static,\n"
+                "    animation starts frozen (P toggles), reports Msamples/s and time to N SPP (1024)\n"
+                "  --tlas-rebuild-threshold=<D> --tlas-rebuild-period=<N>\n"
+                "    DXR / Vulkan RT / RQ: refit the TLAS, full rebuild once a transform element moved\n"
+                "    more than D since the last build (0.5, 0 = always) or every N frames (240, 0 = off)\n"
+                "  --spp=<N> --bounces=<N>\n"
+                "    D3D12 PT: paths per pixel per frame (default 1), max path length (default 4)\n"
+                "  --adaptive[=<E>] --adaptive-max-spp=<N>\n"
+                "    D3D12 PT: extra samples per 8x8 tile until its error is below E (0.01), max N (16)\n"
+                "  --wavefront\n"
+                "    D3D12 PT: generate / extend / shade-per-material / shadow kernels via ExecuteIndirect\n"
+                "  --split-gpu[=<N>] --split-ratio=<F>\n"
+                "    D3D12 PT: adapter N traces the lower rows of each frame, balanced by GPU time or fixed F\n"
+                "  --lights=<N> --light-sampling=<uniform|ris|restir>\n"
+                "    D3D12 PT: N extra ceiling emitters; NEE light choice (restir: RIS + reservoir reuse)\n"
+                "  --compact-verts\n"
+                "    DXR 1.0 / PT / DLSS, Vulkan RT / RQ: 16-byte RT vertices, 16-bit indices\n"
+                "  --sampler=<white|sobol|bluenoise>\n"
+                "    D3D12 PT / DLSS, DXR 1.0 / 1.1: random sequence of the path / shadow / AO / GI rays\n"
+                "  --ray-stats\n"
+                "    D3D12 PT, DXR 1.0 / 1.1: count rays per type, show Mrays/s of the trace passes\n"
+                "  --ser\n"
+                "    DXR 1.0 / Vulkan RT: reorder secondary rays by hit object + material before shading\n"
+                "  --render-scale=<P>\n"
+                "    D3D12 PT / Vulkan RQ: trace at P% (50/67/77) per axis, then upscale + sharpen\n"
+                "    (Vulkan RQ: plain bilinear blit, no sharpen)\n"
+                "  --rt-indirect=<full|half|quarter|checkerboard>\n"
+                "    DXR 1.1: trace AO + GI at reduced rate, bilateral upsample to full size\n"
+                "  --depth-prepass\n"
+                "    DXR 1.1: depth-only prepass, shade + trace once per pixel (EQUAL depth test)\n"
+                "  --vrs[=<T>]\n"
+                "    DXR 1.1 (VRS Tier 2): 2x2 shading where last frame's luminance variance < T (0.0005)\n"
+                "  --dlss=<dlaa|quality|balanced|performance|ultra-performance>\n"
+                "    D3D12 PT + DLSS: DLSS-RR input resolution (default dlaa = native)\n"
+                "  --dlss-target-ms=<T>\n"
+                "    D3D12 PT + DLSS: dynamic input resolution holding T ms of GPU time\n"
+                "  --frame-interp\n"
+                "    D3D12 PT + DLSS: in-house frame interpolation (not DLSS-FG), one per rendered frame\n"
+                "  --max-latency=<N>\n"
+                "    Low-latency pacing: at most N (1-3) frames queued ahead of the display\n"
+                "  --present-mode=<immediate|mailbox|fifo|adaptive>\n"
+                "    Present mode (Vulkan), tearing/composed/vsync present (D3D11/D3D12), swap interval (OpenGL)\n"
+                "  --offscreen\n"
+                "    Render into an own target ring, never present, hidden window (fence-paced throughput)\n"
+                "  --capture=<N>\n"
+                "    D3D12 PT / Vulkan RT: write every Nth frame as PNG, without stalling the GPU\n"
+                "  --capture-dir=<dir>\n"
+                "    Capture folder (default captures\\ next to the exe)\n"
+                "  --record=<file.h264>\n"
+                "    Vulkan RT: encode the frames to an H.264 stream on the GPU video encoder (60 fps)\n"
+                "  --record-mbps=<N>\n"
+                "    Target bitrate of --record in Mbit/s (default 20)\n"
+                "  --group-size=<auto|8x8|16x8|8x4|8x8w32|8x8w64|16x8w32>\n"
+                "    D3D12 PT / DLSS, Vulkan RQ: thread-group shape (wN: wave size) of the per-pixel\n"
+                "    kernels (default 8x8); auto times each per GPU once and keeps the fastest\n"
+                "  --log-level=<error|warn|info|debug>\n"
+                "    Log only lines up to this severity (default debug = everything)\n"
+                "  --log-sync\n"
+                "    Write and flush every log line on the calling thread (no writer thread)\n"
+                "  --no-shader-cache\n"
+                "    Ignore and don't write the D3D12 DXIL/PSO cache (cold start)\n"
+                "  --precompile-shaders\n"
+                "    Compile all DXR feature permutations into the cache on all cores first\n"
+                "  --precompile-only\n"
+                "    Same, then exit (offline cache warm-up)\n\n"
                 "Examples:\n"
                 "  rendertestgpu.exe --renderer=vulkan_rt\n"
-                "  rendertestgpu.exe -r vk_rt -g 0\n",
+                "  rendertestgpu.exe -r vk_rt -g 0\n"
+                "  rendertestgpu.exe -r pt --benchmark --frames=2000\n"
+                "  rendertestgpu.exe -r pt --benchmark --width=1920 --height=1080\n"
+                "  rendertestgpu.exe -r d3d12 --max-latency=1 --present-mode=fifo\n"
+                "  rendertestgpu.exe --precompile-only\n"
+                "  rendertestgpu.exe --convert-mesh=bunny.obj\n"
+                "  rendertestgpu.exe -r d3d12 --cubes=10000 --mesh=bunny.obj.rtm\n",
                 "Help", MB_OK);
             free(cmd);
             exit(0);
         }
-        token = strtok_s(nullptr, " ", &context);
+        token = CommandArgToken(nullptr, &context);
     }
     free(cmd);
-}
-
-// ============== LOGGING ==============
-static FILE* g_logFile = nullptr;
-static wchar_t g_logPath[MAX_PATH] = {0};
-
-void InitLog()
-{
-    wchar_t exePath[MAX_PATH];
-    GetModuleFileNameW(nullptr, exePath, MAX_PATH);
-    wcscpy_s(g_logPath, exePath);
-    wchar_t* dot = wcsrchr(g_logPath, L'.');
-    if (dot) wcscpy_s(dot, 20, L"_error.log");
-    else wcscat_s(g_logPath, L"_error.log");
-}
-
-void Log(const char* fmt, ...)
-{
-    if (!g_logFile) {
-        _wfopen_s(&g_logFile, g_logPath, L"a");
-        if (!g_logFile) return;
-        time_t now = time(nullptr);
-        tm t; localtime_s(&t, &now);
-        fprintf(g_logFile, "\n========== %04d-%02d-%02d %02d:%02d:%02d ==========\n",
-            t.tm_year+1900, t.tm_mon+1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
-    }
-    va_list args;
-    va_start(args, fmt);
-    vfprintf(g_logFile, fmt, args);
-    va_end(args);
-    fflush(g_logFile);
-}
-
-void LogHR(const char* operation, HRESULT hr)
-{
-    char msg[256];
-    FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM, nullptr, hr, 0, msg, sizeof(msg), nullptr);
-    Log("[ERROR] %s failed: 0x%08X - %s\n", operation, hr, msg);
-}
-
-void CloseLog()
-{
-    if (g_logFile) { fclose(g_logFile); g_logFile = nullptr; }
+    if (g_offscreen && g_presentMode != PRESENT_MODE_DEFAULT)
+        Log("[WARN] --present-mode has no effect with --offscreen (nothing is presented)\n");
 }
 
 // ============== 8x8 BITMAP FONT DATA ==============
@@ -267,6 +709,37 @@ const unsigned char g_font8x8[96][8] = {
     {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, // DEL
 };
 
+// ============== CUBE INSTANCES ==============
+// N cubes on the smallest n*n*n grid that holds them, filling the same
+// 1.9-unit volume as the classic 8-cube scene so the camera needs no change
+void BuildCubeInstances(UINT count, std::vector<CubeInstance>& out)
+{
+    static const float palette[4][4] = {
+        {0.95f, 0.2f, 0.15f, 1}, {0.2f, 0.7f, 0.3f, 1},
+        {0.15f, 0.5f, 0.95f, 1}, {1.0f, 0.85f, 0.0f, 1},
+    };
+    out.clear();
+    if (count == 0) return;
+    out.reserve(count);
+
+    UINT n = 1;
+    while ((UINT64)n * n * n < count) n++;
+    const float extent = 1.9f;
+    const float cell = extent / n;
+    const float scale = cell * 0.9f / 0.95f;  // 10% gap between neighbours
+
+    for (UINT i = 0; i < count; i++) {
+        UINT x = i % n, y = (i / n) % n, z = i / (n * n);
+        CubeInstance inst;
+        inst.offset[0] = -extent / 2 + cell * (x + 0.5f);
+        inst.offset[1] = -extent / 2 + cell * (y + 0.5f);
+        inst.offset[2] = -extent / 2 + cell * (z + 0.5f);
+        inst.scale = scale;
+        memcpy(inst.color, palette[(x + y + z) & 3], sizeof(inst.color));
+        out.push_back(inst);
+    }
+}
+
 // ============== GPU ENUMERATION ==============
 void EnumerateGPUs()
 {
@@ -1019,68 +1492,421 @@ static bool ShowSettingsDialog()
     return g_settingsAccepted;
 }
 
+// ============== RENDERER REGISTRY ==============
+// One entry per RendererType, in enum order. Everything that starts, drives
+// or stops a backend (startup, main loop, WM_TIMER redraw while sizing, the
+// F5 hot switch and --sweep) goes through this table.
+struct RendererEntry {
+    RendererType type;
+    const char* title;              // Window title
+    const wchar_t* initFailure;     // Message box text, nullptr = no box
+    bool (*init)(HWND hwnd);
+    void (*render)();
+    bool (*resize)();
+    void (*cleanup)();
+};
+
+// Vulkan's text pipeline is optional and created after the device
+static bool InitVulkanWithText(HWND hwnd)
+{
+    if (!InitVulkan(hwnd)) return false;
+    if (InitVulkanText()) g_vkTextInitialized = true;
+    return true;
+}
+
+static const RendererEntry s_renderers[] = {
+    { RENDERER_D3D11, "RenderTestGPU - Direct3D 11", L"Failed to init D3D11!",
+      InitD3D11, RenderD3D11, ResizeD3D11, CleanupD3D11 },
+    { RENDERER_D3D12, "RenderTestGPU - Direct3D 12", L"Failed to init D3D12!",
+      InitD3D12, RenderD3D12, ResizeD3D12, CleanupD3D12 },
+    { RENDERER_D3D12_DXR10, "RenderTestGPU - D3D12 + DXR 1.0", L"Failed to init D3D12+DXR1.0!",
+      InitD3D12DXR10, RenderD3D12DXR10, ResizeD3D12DXR10, CleanupD3D12DXR10 },
+    { RENDERER_D3D12_RT, "RenderTestGPU - D3D12 + DXR 1.1", L"Failed to init D3D12+DXR1.1!",
+      InitD3D12RT, RenderD3D12RT, ResizeD3D12RT, CleanupD3D12RT },
+    { RENDERER_D3D12_PT, "RenderTestGPU - Direct3D 12 + Path Tracing", L"Failed to init D3D12+PT!",
+      InitD3D12PT, RenderD3D12PT, ResizeD3D12PT, CleanupD3D12PT },
+    { RENDERER_D3D12_PT_DLSS, "RenderTestGPU - D3D12 + PT + DLSS RR", L"Failed to init D3D12+DLSS!",
+      InitD3D12PT_DLSS, RenderD3D12PT_DLSS, ResizeD3D12PT_DLSS, CleanupD3D12PT_DLSS },
+    { RENDERER_OPENGL, "RenderTestGPU - OpenGL", L"Failed to init OpenGL!",
+      InitOpenGL, RenderOpenGL, ResizeOpenGL, CleanupOpenGL },
+    { RENDERER_VULKAN, "RenderTestGPU - Vulkan", nullptr,
+      InitVulkanWithText, RenderVulkan, ResizeVulkan, CleanupVulkan },
+    { RENDERER_VULKAN_RT, "RenderTestGPU - Vulkan + RT", L"Failed to init Vulkan RT!",
+      InitVulkanRT, RenderVulkanRT, ResizeVulkanRT, CleanupVulkanRT },
+    { RENDERER_VULKAN_RQ, "RenderTestGPU - Vulkan + RayQuery", L"Failed to init Vulkan RayQuery!",
+      InitVulkanRQ, RenderVulkanRQ, ResizeVulkanRQ, CleanupVulkanRQ },
+};
+static const int RENDERER_COUNT = (int)(sizeof(s_renderers) / sizeof(s_renderers[0]));
+static_assert(sizeof(s_renderers) / sizeof(s_renderers[0]) == RENDERER_VULKAN_RQ + 1,
+              "s_renderers needs one entry per RendererType");
+
+static const RendererEntry& GetRenderer(RendererType type)
+{
+    if (type < 0 || type >= RENDERER_COUNT) type = RENDERER_D3D11;
+    return s_renderers[type];
+}
+
+// Shows a message box on failure unless running headless (benchmark/sweep)
+static void ReportInitFailure(const wchar_t* msg)
+{
+    if (!g_benchConfig.enabled) MessageBoxW(0, msg, L"Error", MB_OK);
+}
+
+static bool InitRenderer(RendererType type, HWND hwnd)
+{
+    LatencyReset();
+    AnimationReset();
+    AccumReset();
+    TlasStatsReset();
+    RayStatsReset();
+    SerReset();
+    VramReset(g_settings.selectedGPU >= 0 && g_settings.selectedGPU < (int)g_gpuList.size() ? g_gpuList[g_settings.selectedGPU].adapter : nullptr);
+    GroupTuneReset(g_settings.selectedGPU >= 0 && g_settings.selectedGPU < (int)g_gpuList.size() ? g_gpuList[g_settings.selectedGPU].adapter : nullptr);
+    if (MeshLoaded() && !MeshSupportedBy(type))
+        Log("[WARN] --mesh is not used by %s, drawing the procedural scene\n", GetRendererId(type));
+    const RendererEntry& entry = GetRenderer(type);
+    StartupRendererBegin(GetRendererId(type));
+    bool initOK = entry.init(hwnd);
+    if (!initOK && entry.initFailure) ReportInitFailure(entry.initFailure);
+    if (initOK) VramTick();
+    return initOK;
+}
+
+static void RenderFrame(RendererType type) { GetRenderer(type).render(); }
+static bool ResizeRenderer(RendererType type) { return GetRenderer(type).resize(); }
+static void CleanupRenderer(RendererType type) { GetRenderer(type).cleanup(); }
+
+// Apply the last WM_SIZE before rendering. Done by the render thread between
+// frames so back buffers are never released while a frame is being built.
+static void ApplyPendingResize()
+{
+    LONG size = InterlockedExchange(&s_pendingSize, 0);
+    if (size == 0) return;
+    UINT newW = (UINT)size >> 16, newH = (UINT)size & 0xFFFF;
+    if (newW == W && newH == H) return;
+
+    Log("[INFO] Resize %ux%u -> %ux%u\n", W, H, newW, newH);
+    W = newW;
+    H = newH;
+    if (!ResizeRenderer(g_settings.renderer)) Log("[ERROR] Resize failed\n");
+}
+
+// Render thread side of WM_KEYDOWN (everything but ESC, which only quits)
+static void ApplyKeyEvent(const RenderEvent& e)
+{
+    UINT key = e.key;
+    if (key == 'P') AnimationTogglePause();
+    // F5 / Shift+F5: hot switch to the next / previous renderer
+    if (key == VK_F5 && !g_benchConfig.enabled) {
+        int step = e.shift ? RENDERER_COUNT - 1 : 1;
+        s_pendingSwitch = ((int)g_settings.renderer + step) % RENDERER_COUNT;
+    }
+    // N cycles the path tracer denoiser: Off -> A-Trous -> Temporal + A-Trous
+    if (key == 'N' && g_settings.renderer == RENDERER_D3D12_PT) {
+        static const char* denoiseNames[] = {"Off", "A-Trous", "Temporal + A-Trous"};
+        g_denoiseMode = (DenoiseMode)((g_denoiseMode + 1) % 3);
+        g_temporalFrameCount = 0;
+        g_textNeedsRebuild = true;
+        GpuProfilerReset();   // Stamp indices shift with the pass count
+        Log("[INFO] Denoise: %s\n", denoiseNames[g_denoiseMode]);
+    }
+    // Debug mode keys 0-6 (for both DXR 1.0 and 1.1 renderers)
+    if (g_settings.renderer == RENDERER_D3D12_DXR10 || g_settings.renderer == RENDERER_D3D12_RT) {
+        if (key >= '0' && key <= '6') {
+            g_dxrFeatures.debugMode = (int)(key - '0');
+            // Show debug mode name in title
+            const char* modeNames[] = {"Normal", "Object IDs", "Normals", "Reflect Dir", "Shadows", "World Pos", "Depth"};
+            const char* dxrVersion = (g_settings.renderer == RENDERER_D3D12_DXR10) ? "1.0" : "1.1";
+            char title[128];
+            sprintf_s(title, "RenderTestGPU - D3D12 + DXR %s [Debug: %s]", dxrVersion, modeNames[g_dxrFeatures.debugMode]);
+            SetWindowTextA(g_hMainWnd, title);
+        }
+    }
+}
+
 // ============== WINDOW PROCEDURE ==============
+#define WM_APP_RECREATE_WINDOW (WM_APP + 1)   // Render thread -> window thread, lParam = title
+
+static HWND CreateMainWindow(HINSTANCE hI, const char* title);
+
 static LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
 {
     switch (m) {
     case WM_CLOSE:
-        if (h == g_hMainWnd) DestroyWindow(h);
+        // While the render thread runs it still presents to this window; it
+        // is destroyed once the thread has cleaned up (RunMessageLoop)
+        if (h == g_hMainWnd) {
+            if (s_renderThread) InterlockedExchange(&s_renderQuit, 1);
+            else DestroyWindow(h);
+        }
         return 0;
     case WM_DESTROY:
         if (h == g_hMainWnd) PostQuitMessage(0);
         return 0;
     case WM_KEYDOWN:
-        if (w == VK_ESCAPE) PostQuitMessage(0);
-        // Debug mode keys 0-6 (for both DXR 1.0 and 1.1 renderers)
-        if (g_settings.renderer == RENDERER_D3D12_DXR10 || g_settings.renderer == RENDERER_D3D12_RT) {
-            if (w >= '0' && w <= '6') {
-                g_dxrFeatures.debugMode = (int)(w - '0');
-                // Show debug mode name in title
-                const char* modeNames[] = {"Normal", "Object IDs", "Normals", "Reflect Dir", "Shadows", "World Pos", "Depth"};
-                const char* dxrVersion = (g_settings.renderer == RENDERER_D3D12_DXR10) ? "1.0" : "1.1";
-                char title[128];
-                sprintf_s(title, "RenderTestGPU - D3D12 + DXR %s [Debug: %s]", dxrVersion, modeNames[g_dxrFeatures.debugMode]);
-                SetWindowTextA(h, title);
-            }
+        if (w == VK_ESCAPE) {
+            PostMessage(h, WM_CLOSE, 0, 0);
+        } else if (h == g_hMainWnd) {
+            RenderEvent e = { (UINT)w, (GetKeyState(VK_SHIFT) & 0x8000) != 0 };
+            if (!PushRenderEvent(e)) Log("[WARN] Render event queue full, key 0x%02X dropped\n", (UINT)w);
         }
         break;
-    case WM_ENTERSIZEMOVE:
-        g_inSizeMove = true;
-        SetTimer(h, 1, 1, nullptr);
+    case WM_SIZE:
+        // Minimized windows report 0x0; keep the current buffers until restored
+        if (h == g_hMainWnd && w != SIZE_MINIMIZED && LOWORD(l) > 0 && HIWORD(l) > 0)
+            InterlockedExchange(&s_pendingSize, (LONG)((UINT)LOWORD(l) << 16 | HIWORD(l)));
         break;
-    case WM_EXITSIZEMOVE:
-        g_inSizeMove = false;
-        KillTimer(h, 1);
-        break;
-    case WM_TIMER:
-        if (w == 1 && g_inSizeMove) {
-            switch (g_settings.renderer) {
-            case RENDERER_D3D12_PT_DLSS: RenderD3D12PT_DLSS(); break;
-            case RENDERER_D3D12_PT: RenderD3D12PT(); break;
-            case RENDERER_D3D12_RT: RenderD3D12RT(); break;
-            case RENDERER_D3D12_DXR10: RenderD3D12DXR10(); break;
-            case RENDERER_D3D12: RenderD3D12(); break;
-            case RENDERER_OPENGL: RenderOpenGL(); break;
-            case RENDERER_VULKAN: RenderVulkan(); break;
-            case RENDERER_VULKAN_RT: RenderVulkanRT(); break;
-            case RENDERER_VULKAN_RQ: RenderVulkanRQ(); break;
-            default: RenderD3D11(); break;
-            }
+    case WM_APP_RECREATE_WINDOW:
+        // Sent (blocking) by the render thread, whose renderer has already
+        // released the window. Clearing g_hMainWnd first keeps WM_DESTROY
+        // from posting WM_QUIT.
+        if (h == g_hMainWnd) {
+            g_hMainWnd = nullptr;
+            DestroyWindow(h);
+            return (LRESULT)CreateMainWindow(g_hInstance, (const char*)l);
         }
-        break;
+        return 0;
     }
     return DefWindowProc(h, m, w, l);
 }
 
+// ============== MAIN WINDOW ==============
+static HWND CreateMainWindow(HINSTANCE hI, const char* title)
+{
+    static bool classRegistered = false;
+    if (!classRegistered) {
+        WNDCLASS wc = {0, WndProc, 0, 0, hI, 0, LoadCursor(0, IDC_ARROW), 0, 0, "RenderTestGPU"};
+        RegisterClass(&wc);
+        classRegistered = true;
+    }
+    RECT r = {0, 0, (LONG)W, (LONG)H}; AdjustWindowRect(&r, WS_OVERLAPPEDWINDOW, FALSE);
+    HWND hwnd = CreateWindow("RenderTestGPU", title, WS_OVERLAPPEDWINDOW, 100, 100,
+        r.right - r.left, r.bottom - r.top, 0, 0, hI, 0);
+    g_hMainWnd = hwnd;
+    // --offscreen: the window only anchors the device / surface, nothing is presented to it
+    if (hwnd && !g_offscreen) ShowWindow(hwnd, SW_SHOW);
+    return hwnd;
+}
+
+// Destroy the window without posting WM_QUIT (window thread, after the render thread exited)
+static void DestroyMainWindow()
+{
+    HWND hwnd = g_hMainWnd;
+    g_hMainWnd = nullptr;
+    if (hwnd) DestroyWindow(hwnd);
+    MSG msg;
+    while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+        if (msg.message == WM_QUIT) { PostQuitMessage((int)msg.wParam); break; }
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+}
+
+// ============== HOT SWITCH ==============
+// Tears down the running backend and brings up another in the same process,
+// so the adapter, the driver's shader caches and shadercache\ stay warm and
+// A/B runs see the same thermal state. The window is kept unless OpenGL is
+// on either side: a window's pixel format can only be set once, and GL
+// can't take over a window a DXGI flip model swap chain presented to.
+static bool SwitchRenderer(RendererType to)
+{
+    RendererType from = g_settings.renderer;
+    if (from == to && g_hMainWnd) return true;
+    Log("[INFO] Switching renderer: %s -> %s\n", GetRendererId(from), GetRendererId(to));
+
+    CleanupRenderer(from);
+    g_settings.renderer = to;
+    if (!g_hMainWnd) return false;
+    if (from == RENDERER_OPENGL || to == RENDERER_OPENGL) {
+        // The window belongs to the window thread, which recreates it
+        if (!SendMessage(g_hMainWnd, WM_APP_RECREATE_WINDOW, 0, (LPARAM)GetRenderer(to).title)) return false;
+    } else {
+        SetWindowTextA(g_hMainWnd, GetRenderer(to).title);
+    }
+    return InitRenderer(to, g_hMainWnd);
+}
+
+// F5 / Shift+F5 from the event ring. Falls back to the previous renderer if the new
+// one fails to initialize; false only if neither comes up.
+static bool ApplyPendingSwitch()
+{
+    if (s_pendingSwitch < 0) return true;
+    RendererType from = g_settings.renderer;
+    RendererType to = (RendererType)s_pendingSwitch;
+    s_pendingSwitch = -1;
+    if (SwitchRenderer(to)) return true;
+
+    Log("[WARN] %s failed to initialize, switching back to %s\n", GetRendererId(to), GetRendererId(from));
+    if (SwitchRenderer(from)) return true;
+    Log("[ERROR] %s failed to reinitialize\n", GetRendererId(from));
+    return false;
+}
+
+// ============== RENDER LOOP ==============
+// Render thread. Returns true when a benchmark window completed, false when
+// the user quit (or a hot switch left no renderer running).
+static bool RunRenderLoop()
+{
+    LARGE_INTEGER freq, lastTime, nowTime;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&lastTime);
+    UINT64 frames = 0;
+    fps = 0;
+
+    // Benchmark: per-frame timing measured from one loop iteration to the next
+    LARGE_INTEGER prevFrameTime = lastTime;
+    if (g_benchConfig.enabled) BenchmarkBegin();
+
+    while (!InterlockedCompareExchange(&s_renderQuit, 0, 0)) {
+        RenderEvent e;
+        while (PopRenderEvent(e)) ApplyKeyEvent(e);
+
+        if (s_pendingSwitch >= 0) {
+            if (!ApplyPendingSwitch()) break;
+            QueryPerformanceCounter(&lastTime);
+            frames = 0;
+            fps = 0;
+        }
+        ApplyPendingResize();
+        StartupFrameBegin();
+        RenderFrame(g_settings.renderer);
+        StartupFrameEnd();
+        frames++;
+
+        QueryPerformanceCounter(&nowTime);
+        if (g_benchConfig.enabled) {
+            double frameMs = (double)(nowTime.QuadPart - prevFrameTime.QuadPart) * 1000.0 / freq.QuadPart;
+            prevFrameTime = nowTime;
+            if (BenchmarkFrame(frameMs)) return true;
+        }
+
+        double elapsed = (double)(nowTime.QuadPart - lastTime.QuadPart) / freq.QuadPart;
+        if (elapsed >= 1.0) {
+            fps = (int)(frames / elapsed);
+            frames = 0;
+            lastTime = nowTime;
+            GpuProfilerTick();
+            RayStatsTick();
+            LatencyTick();
+            VramTick();
+        }
+    }
+    return false;
+}
+
+// ============== RENDERER SWEEP ==============
+// Render thread. Benchmarks every RendererType in turn on the selected GPU,
+// hot switching from one to the next (SwitchRenderer: same window except
+// around OpenGL).
+static void RunSweep()
+{
+    std::vector<SweepResult> results;
+
+    for (int i = 0; i < RENDERER_COUNT; i++) {
+        RendererType type = s_renderers[i].type;
+
+        SweepResult res = {};
+        res.renderer = type;
+        Log("[INFO] Sweep: starting %s\n", GetRendererId(type));
+        QueryPerformanceCounter(&g_startTime);
+
+        bool userQuit = false;
+        bool initOK = (i == 0) ? InitRenderer(type, g_hMainWnd) : SwitchRenderer(type);
+        if (!g_hMainWnd) break;
+        if (initOK) {
+            res.initOK = true;
+            if (RunRenderLoop()) {
+                BenchmarkWriteReport();
+                res.completed = BenchmarkComputeStats(res.stats);
+            } else {
+                userQuit = true;
+            }
+        } else {
+            Log("[WARN] Sweep: %s failed to initialize, skipping\n", GetRendererId(type));
+        }
+        results.push_back(res);
+
+        if (userQuit) {
+            Log("[INFO] Sweep aborted by user\n");
+            break;
+        }
+    }
+    CleanupRenderer(g_settings.renderer);
+
+    BenchmarkWriteSweepReport(results);
+}
+
+// ============== RENDER THREAD ==============
+// Init, the frame loop and cleanup all run here, so GL contexts, DCs and
+// swap chains are created and released on one thread while the window thread
+// keeps pumping (drags and other modal loops no longer stall frames).
+static DWORD WINAPI RenderThreadProc(void*)
+{
+    if (g_benchConfig.sweep) {
+        RunSweep();
+        return 0;
+    }
+    if (!InitRenderer(g_settings.renderer, g_hMainWnd)) return 1;
+    if (RunRenderLoop() && g_benchConfig.enabled) BenchmarkWriteReport();
+    CleanupRenderer(g_settings.renderer);
+    return 0;
+}
+
+// Window thread: dispatch messages until the render thread exits. WM_QUIT
+// only asks it to stop; pumping continues meanwhile because its cleanup may
+// still send messages to the window (SwapChain release, SetWindowText).
+static DWORD RunMessageLoop(HANDLE renderThread)
+{
+    for (;;) {
+        DWORD wait = MsgWaitForMultipleObjects(1, &renderThread, FALSE, INFINITE, QS_ALLINPUT);
+        if (wait == WAIT_OBJECT_0) break;
+        MSG msg;
+        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            if (msg.message == WM_QUIT) { InterlockedExchange(&s_renderQuit, 1); continue; }
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+    }
+    DWORD exitCode = 1;
+    GetExitCodeThread(renderThread, &exitCode);
+    return exitCode;
+}
+
 // ============== MAIN ENTRY POINT ==============
 int WINAPI WinMain(HINSTANCE hI, HINSTANCE, LPSTR cmdLine, int)
 {
     g_hInstance = hI;
+    StartupProfilerInit();
+    StartupStep("Log + command line");
     InitLog();
 
     // Parse command line arguments first
     ParseCommandLine(cmdLine);
+    LogStartWriter();
+
+    // Offline cache warm-up: DXIL doesn't depend on the GPU, so no device needed
+    if (g_cmdArgs.precompileOnly) {
+        bool ok = PrecompileD3D12ShaderPermutations();
+        CloseLog();
+        return ok ? 0 : 1;
+    }
+
+    // Offline mesh conversion, no device needed either
+    if (!g_cmdArgs.convertMesh.empty()) {
+        bool ok = MeshConvert(g_cmdArgs.convertMesh.c_str());
+        CloseLog();
+        return ok ? 0 : 1;
+    }
+
+    if (!g_meshPath.empty()) StartupStep("Mesh file");
+    if (!g_meshPath.empty() && !MeshFileOpen(g_meshPath.c_str(), g_mesh)) {
+        Log("[FATAL] Failed to open mesh file '%s'\n", g_meshPath.c_str());
+        MessageBoxA(0, "Failed to open the --mesh file, see the log.", "Error", MB_OK);
+        CloseLog();
+        return 1;
+    }
 
+    StartupStep("GPU enumeration");
     EnumerateGPUs();
 
     if (g_gpuList.empty()) {
@@ -1090,7 +1916,23 @@ int WINAPI WinMain(HINSTANCE hI, HINSTANCE, LPSTR cmdLine, int)
         return 1;
     }
 
+    // Coordinator only: the children do the rendering
+    if (g_benchConfig.allGpus) {
+        int exitCode = MultiGpuBenchmarkRun(cmdLine, g_cmdArgs.renderer);
+        MeshFileClose(g_mesh);
+        FreeGPUList();
+        CloseLog();
+        return exitCode;
+    }
+
+    // RT feature defaults for every renderer, not just the selected one: F5
+    // can switch to any of them later. The RT dialogs refine their own set.
+    g_dxrFeatures.SetDefaults();
+    g_dxr10Features.SetDefaults();
+    g_vulkanRTFeatures.SetDefaults();
+
     // If command line specifies renderer, skip dialogs and use defaults
+    StartupStep(g_cmdArgs.skipDialogs ? "Settings" : "Settings dialogs");
     if (g_cmdArgs.skipDialogs) {
         g_settings.renderer = g_cmdArgs.renderer;
         g_settings.selectedGPU = g_cmdArgs.hasGpu ? g_cmdArgs.gpuIndex : 0;
@@ -1101,13 +1943,9 @@ int WINAPI WinMain(HINSTANCE hI, HINSTANCE, LPSTR cmdLine, int)
             g_settings.selectedGPU = 0;
         }
 
-        // Use default settings for RT renderers
-        g_dxrFeatures.SetDefaults();
-        g_dxr10Features.SetDefaults();
-        g_vulkanRTFeatures.SetDefaults();
-
-        Log("[INFO] Command line mode: renderer=%d gpu=%d\n",
-            (int)g_settings.renderer, g_settings.selectedGPU);
+        Log("[INFO] Command line mode: renderer=%d gpu=%d%s\n",
+            (int)g_settings.renderer, g_settings.selectedGPU,
+            g_benchConfig.sweep ? " (sweep)" : g_benchConfig.enabled ? " (benchmark)" : "");
     }
     else {
         // Show settings dialog
@@ -1142,144 +1980,43 @@ int WINAPI WinMain(HINSTANCE hI, HINSTANCE, LPSTR cmdLine, int)
                 CloseLog();
                 return 0;
             }
-        } else {
-            // Initialize defaults for non-RT renderers
-            g_dxrFeatures.SetDefaults();
-            g_dxr10Features.SetDefaults();
-            g_vulkanRTFeatures.SetDefaults();
         }
     }
 
     { MSG tmpMsg; while (PeekMessage(&tmpMsg, nullptr, WM_QUIT, WM_QUIT, PM_REMOVE)) {} }
 
-    const char* windowTitle = "RenderTestGPU - Direct3D 11";
-    switch (g_settings.renderer) {
-    case RENDERER_D3D12: windowTitle = "RenderTestGPU - Direct3D 12"; break;
-    case RENDERER_D3D12_DXR10: windowTitle = "RenderTestGPU - D3D12 + DXR 1.0"; break;
-    case RENDERER_D3D12_RT: windowTitle = "RenderTestGPU - D3D12 + DXR 1.1"; break;
-    case RENDERER_D3D12_PT: windowTitle = "RenderTestGPU - Direct3D 12 + Path Tracing"; break;
-    case RENDERER_D3D12_PT_DLSS: windowTitle = "RenderTestGPU - D3D12 + PT + DLSS RR"; break;
-    case RENDERER_OPENGL: windowTitle = "RenderTestGPU - OpenGL"; break;
-    case RENDERER_VULKAN: windowTitle = "RenderTestGPU - Vulkan"; break;
-    case RENDERER_VULKAN_RT: windowTitle = "RenderTestGPU - Vulkan + RT"; break;
-    case RENDERER_VULKAN_RQ: windowTitle = "RenderTestGPU - Vulkan + RayQuery"; break;
+    if (g_cmdArgs.precompileShaders) {
+        StartupStep("Shader precompile");
+        PrecompileD3D12ShaderPermutations();
     }
 
-    WNDCLASS wc = {0, WndProc, 0, 0, hI, 0, LoadCursor(0, IDC_ARROW), 0, 0, "RenderTestGPU"};
-    RegisterClass(&wc);
-    RECT r = {0, 0, (LONG)W, (LONG)H}; AdjustWindowRect(&r, WS_OVERLAPPEDWINDOW, FALSE);
-    HWND hwnd = CreateWindow("RenderTestGPU", windowTitle, WS_OVERLAPPEDWINDOW, 100, 100,
-        r.right - r.left, r.bottom - r.top, 0, 0, hI, 0);
-    g_hMainWnd = hwnd;
+    if (g_benchConfig.sweep) g_settings.renderer = RENDERER_D3D11;   // First sweep entry
+
+    StartupStep("Main window");
+    HWND hwnd = CreateMainWindow(hI, GetRenderer(g_settings.renderer).title);
     if (!hwnd) { FreeGPUList(); CloseLog(); return 1; }
-    ShowWindow(hwnd, SW_SHOW);
 
     QueryPerformanceFrequency(&g_perfFreq);
     QueryPerformanceCounter(&g_startTime);
 
-    // Initialize selected renderer
-    bool initOK = false;
-    switch (g_settings.renderer) {
-    case RENDERER_D3D12_PT_DLSS:
-        initOK = InitD3D12PT_DLSS(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init D3D12+DLSS!", L"Error", MB_OK); }
-        break;
-    case RENDERER_D3D12_PT:
-        initOK = InitD3D12PT(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init D3D12+PT!", L"Error", MB_OK); }
-        break;
-    case RENDERER_D3D12_RT:
-        initOK = InitD3D12RT(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init D3D12+DXR1.1!", L"Error", MB_OK); }
-        break;
-    case RENDERER_D3D12_DXR10:
-        initOK = InitD3D12DXR10(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init D3D12+DXR1.0!", L"Error", MB_OK); }
-        break;
-    case RENDERER_D3D12:
-        initOK = InitD3D12(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init D3D12!", L"Error", MB_OK); }
-        break;
-    case RENDERER_OPENGL:
-        initOK = InitOpenGL(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init OpenGL!", L"Error", MB_OK); }
-        break;
-    case RENDERER_VULKAN:
-        initOK = InitVulkan(hwnd);
-        if (initOK && InitVulkanText()) g_vkTextInitialized = true;
-        break;
-    case RENDERER_VULKAN_RT:
-        initOK = InitVulkanRT(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init Vulkan RT!", L"Error", MB_OK); }
-        break;
-    case RENDERER_VULKAN_RQ:
-        initOK = InitVulkanRQ(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init Vulkan RayQuery!", L"Error", MB_OK); }
-        break;
-    default:
-        initOK = InitD3D11(hwnd);
-        if (!initOK) { MessageBoxW(0, L"Failed to init D3D11!", L"Error", MB_OK); }
-        break;
-    }
-
-    if (!initOK) {
+    // Init, render and cleanup happen on the render thread; its InitRenderer
+    // takes over the startup profiler from here
+    StartupStep("Render thread start");
+    s_renderThread = CreateThread(nullptr, 0, RenderThreadProc, nullptr, 0, nullptr);
+    if (!s_renderThread) {
+        Log("[FATAL] CreateThread failed for the render thread (error %lu)\n", GetLastError());
+        DestroyMainWindow();
         FreeGPUList();
         CloseLog();
         return 1;
     }
+    DWORD exitCode = RunMessageLoop(s_renderThread);
+    CloseHandle(s_renderThread);
+    s_renderThread = nullptr;
+    DestroyMainWindow();
 
-    LARGE_INTEGER freq, lastTime, nowTime;
-    QueryPerformanceFrequency(&freq);
-    QueryPerformanceCounter(&lastTime);
-    UINT64 frames = 0;
-
-    MSG msg = {};
-    while (msg.message != WM_QUIT) {
-        while (PeekMessage(&msg, 0, 0, 0, PM_REMOVE)) {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-            if (msg.message == WM_QUIT) break;
-        }
-        if (msg.message == WM_QUIT) break;
-
-        switch (g_settings.renderer) {
-        case RENDERER_D3D12_PT_DLSS: RenderD3D12PT_DLSS(); break;
-        case RENDERER_D3D12_PT: RenderD3D12PT(); break;
-        case RENDERER_D3D12_RT: RenderD3D12RT(); break;
-        case RENDERER_D3D12_DXR10: RenderD3D12DXR10(); break;
-        case RENDERER_D3D12: RenderD3D12(); break;
-        case RENDERER_OPENGL: RenderOpenGL(); break;
-        case RENDERER_VULKAN: RenderVulkan(); break;
-        case RENDERER_VULKAN_RT: RenderVulkanRT(); break;
-        case RENDERER_VULKAN_RQ: RenderVulkanRQ(); break;
-        default: RenderD3D11(); break;
-        }
-        frames++;
-
-        QueryPerformanceCounter(&nowTime);
-        double elapsed = (double)(nowTime.QuadPart - lastTime.QuadPart) / freq.QuadPart;
-        if (elapsed >= 1.0) {
-            fps = (int)(frames / elapsed);
-            frames = 0;
-            lastTime = nowTime;
-        }
-    }
-
-    // Cleanup
-    switch (g_settings.renderer) {
-    case RENDERER_D3D12_PT_DLSS: CleanupD3D12PT_DLSS(); break;
-    case RENDERER_D3D12_PT: CleanupD3D12PT(); break;
-    case RENDERER_D3D12_RT: CleanupD3D12RT(); break;
-    case RENDERER_D3D12_DXR10: CleanupD3D12DXR10(); break;
-    case RENDERER_D3D12: CleanupD3D12(); break;
-    case RENDERER_OPENGL: CleanupOpenGL(); break;
-    case RENDERER_VULKAN: CleanupVulkan(); break;
-    case RENDERER_VULKAN_RT: CleanupVulkanRT(); break;
-    case RENDERER_VULKAN_RQ: CleanupVulkanRQ(); break;
-    default: CleanupD3D11(); break;
-    }
-
+    MeshFileClose(g_mesh);
     FreeGPUList();
     CloseLog();
-    return 0;
+    return (int)exitCode;
 }
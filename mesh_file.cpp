@@ -0,0 +1,686 @@
+// ============== STREAMED MESH FILES ==============
+// .rtm file mapping for --mesh and the OBJ / glTF importer behind
+// --convert-mesh (see mesh_file.h)
+
+#include "mesh_file.h"
+#include <unordered_map>
+#include <cfloat>
+
+std::string g_meshPath;
+MeshFile g_mesh;
+
+// ============== FILE MAPPING ==============
+static uint64_t AlignMesh(uint64_t offset) {
+    return (offset + MESH_FILE_ALIGN - 1) & ~(uint64_t)(MESH_FILE_ALIGN - 1);
+}
+
+bool MeshFileOpen(const char* path, MeshFile& mesh) {
+    MeshFileClose(mesh);
+    mesh.file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (mesh.file == INVALID_HANDLE_VALUE) {
+        Log("[ERROR] Mesh %s: cannot open (error %lu)\n", path, GetLastError());
+        return false;
+    }
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(mesh.file, &size) || (uint64_t)size.QuadPart < sizeof(MeshFileHeader)) {
+        Log("[ERROR] Mesh %s: too small for a header\n", path);
+        MeshFileClose(mesh);
+        return false;
+    }
+    mesh.size = (uint64_t)size.QuadPart;
+    mesh.mapping = CreateFileMappingA(mesh.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mesh.mapping) mesh.view = (const BYTE*)MapViewOfFile(mesh.mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!mesh.view) {
+        Log("[ERROR] Mesh %s: file mapping failed (error %lu)\n", path, GetLastError());
+        MeshFileClose(mesh);
+        return false;
+    }
+
+    const MeshFileHeader* h = (const MeshFileHeader*)mesh.view;
+    if (h->magic != MESH_FILE_MAGIC || h->version != MESH_FILE_VERSION) {
+        Log("[ERROR] Mesh %s: not an RTM%u file (convert it with --convert-mesh)\n", path, MESH_FILE_VERSION);
+        MeshFileClose(mesh);
+        return false;
+    }
+    // Offsets first, then counts against the bytes left: offset + count * size
+    // could wrap for a corrupt header
+    if (h->vertexCount == 0 || h->indexCount < 3 || h->indexCount % 3 != 0 ||
+        h->vertexOffset % MESH_FILE_ALIGN != 0 || h->indexOffset % MESH_FILE_ALIGN != 0 ||
+        h->vertexOffset > mesh.size || h->indexOffset > mesh.size ||
+        h->vertexCount > (mesh.size - h->vertexOffset) / sizeof(MeshVertex) ||
+        h->indexCount > (mesh.size - h->indexOffset) / sizeof(uint32_t)) {
+        Log("[ERROR] Mesh %s: header does not match the file (%u verts, %u inds, %llu bytes)\n",
+            path, h->vertexCount, h->indexCount, (unsigned long long)mesh.size);
+        MeshFileClose(mesh);
+        return false;
+    }
+    // Every renderer indexes the vertex buffer with these unchecked (and
+    // MeshFaceNormal reads through them on the CPU)
+    const uint32_t* indices = (const uint32_t*)(mesh.view + h->indexOffset);
+    uint32_t maxIndex = 0;
+    for (uint32_t i = 0; i < h->indexCount; i++) maxIndex = max(maxIndex, indices[i]);
+    if (maxIndex >= h->vertexCount) {
+        Log("[ERROR] Mesh %s: index %u out of range (%u verts)\n", path, maxIndex, h->vertexCount);
+        MeshFileClose(mesh);
+        return false;
+    }
+    mesh.vertices = (const MeshVertex*)(mesh.view + h->vertexOffset);
+    mesh.indices = indices;
+    mesh.vertexCount = h->vertexCount;
+    mesh.indexCount = h->indexCount;
+    Log("[INFO] Mesh %s: %u verts, %u triangles, %.1f MB mapped\n",
+        path, mesh.vertexCount, mesh.indexCount / 3, mesh.size / (1024.0 * 1024.0));
+    return true;
+}
+
+void MeshFileClose(MeshFile& mesh) {
+    if (mesh.view) UnmapViewOfFile(mesh.view);
+    if (mesh.mapping) CloseHandle(mesh.mapping);
+    if (mesh.file != INVALID_HANDLE_VALUE) CloseHandle(mesh.file);
+    mesh = MeshFile();
+}
+
+size_t MeshVertexBytes(const MeshFile& mesh) { return (size_t)mesh.vertexCount * sizeof(MeshVertex); }
+size_t MeshIndexBytes(const MeshFile& mesh) { return (size_t)mesh.indexCount * sizeof(uint32_t); }
+
+static void Cross3(const float a[3], const float b[3], float out[3]) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+void MeshFaceNormal(const MeshFile& mesh, uint32_t t, float out[3]) {
+    const MeshVertex& a = mesh.vertices[mesh.indices[t * 3 + 0]];
+    const MeshVertex& b = mesh.vertices[mesh.indices[t * 3 + 1]];
+    const MeshVertex& c = mesh.vertices[mesh.indices[t * 3 + 2]];
+    float e1[3], e2[3], avg[3];
+    for (int i = 0; i < 3; i++) {
+        e1[i] = b.pos[i] - a.pos[i];
+        e2[i] = c.pos[i] - a.pos[i];
+        avg[i] = a.normal[i] + b.normal[i] + c.normal[i];
+    }
+    Cross3(e1, e2, out);
+    float len = sqrtf(out[0] * out[0] + out[1] * out[1] + out[2] * out[2]);
+    if (len <= 0.0f) {
+        // Degenerate triangle: the vertices' normal is the best guess
+        len = sqrtf(avg[0] * avg[0] + avg[1] * avg[1] + avg[2] * avg[2]);
+        for (int i = 0; i < 3; i++) out[i] = len > 0.0f ? avg[i] / len : (i == 1 ? 1.0f : 0.0f);
+        return;
+    }
+    if (out[0] * avg[0] + out[1] * avg[1] + out[2] * avg[2] < 0.0f) len = -len;
+    for (int i = 0; i < 3; i++) out[i] /= len;
+}
+
+bool MeshSupportedBy(RendererType type) {
+    switch (type) {
+    case RENDERER_D3D11:
+    case RENDERER_D3D12:
+    case RENDERER_D3D12_PT:
+    case RENDERER_OPENGL:
+    case RENDERER_VULKAN:
+    case RENDERER_VULKAN_RQ:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// ============== IMPORT ==============
+// Gathered in the importers' own coordinate system (right-handed, counter-
+// clockwise front faces for both OBJ and glTF), then converted by MeshFinish
+struct MeshImport {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<bool> needsNormal;      // Vertex had none in the source
+};
+
+// Area-weighted vertex normals for the vertices the source left without one
+static void GenerateNormals(MeshImport& m, size_t firstVertex, size_t firstIndex) {
+    bool any = false;
+    for (size_t i = firstVertex; i < m.needsNormal.size(); i++) any = any || m.needsNormal[i];
+    if (!any) return;
+    for (size_t i = firstIndex; i + 2 < m.indices.size(); i += 3) {
+        MeshVertex* v[3] = { &m.vertices[m.indices[i]], &m.vertices[m.indices[i + 1]], &m.vertices[m.indices[i + 2]] };
+        float e1[3], e2[3], n[3];
+        for (int k = 0; k < 3; k++) { e1[k] = v[1]->pos[k] - v[0]->pos[k]; e2[k] = v[2]->pos[k] - v[0]->pos[k]; }
+        Cross3(e1, e2, n);
+        for (int j = 0; j < 3; j++) {
+            if (!m.needsNormal[m.indices[i + j]]) continue;
+            for (int k = 0; k < 3; k++) v[j]->normal[k] += n[k];
+        }
+    }
+    for (size_t i = firstVertex; i < m.vertices.size(); i++) {
+        if (!m.needsNormal[i]) continue;
+        float* n = m.vertices[i].normal;
+        float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len > 0.0f) { n[0] /= len; n[1] /= len; n[2] /= len; }
+        else { n[0] = 0; n[1] = 1; n[2] = 0; }
+        m.needsNormal[i] = false;
+    }
+}
+
+// ============== WAVEFRONT OBJ ==============
+// v / vn / f only (texture coordinates are skipped), polygons as fans,
+// negative (relative) indices. One output vertex per distinct v//vn pair.
+static bool ParseObjIndex(const char*& p, int count, uint32_t& out) {
+    char* end = nullptr;
+    long i = strtol(p, &end, 10);
+    if (end == p) return false;
+    p = end;
+    long v = i < 0 ? count + i : i - 1;
+    if (v < 0 || v >= count) return false;
+    out = (uint32_t)v;
+    return true;
+}
+
+static bool ImportObj(const char* path, MeshImport& m) {
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "r") != 0 || !f) { Log("[ERROR] Convert: cannot open %s\n", path); return false; }
+
+    std::vector<float> positions, normals;
+    std::unordered_map<uint64_t, uint32_t> remap;
+    std::vector<uint32_t> face;
+    std::vector<char> line(1 << 16);
+    size_t lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line.data(), (int)line.size(), f)) {
+        lineNo++;
+        const char* p = line.data();
+        while (*p == ' ' || *p == '\t') p++;
+        if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            float x = 0, y = 0, z = 0;
+            sscanf_s(p + 2, "%f %f %f", &x, &y, &z);
+            positions.push_back(x); positions.push_back(y); positions.push_back(z);
+        } else if (p[0] == 'v' && p[1] == 'n') {
+            float x = 0, y = 0, z = 0;
+            sscanf_s(p + 3, "%f %f %f", &x, &y, &z);
+            normals.push_back(x); normals.push_back(y); normals.push_back(z);
+        } else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            int posCount = (int)(positions.size() / 3), nrmCount = (int)(normals.size() / 3);
+            face.clear();
+            p += 2;
+            while (ok) {
+                while (*p == ' ' || *p == '\t') p++;
+                if (*p == '\0' || *p == '\n' || *p == '\r') break;
+                uint32_t vi = 0, ni = UINT32_MAX;
+                ok = ParseObjIndex(p, posCount, vi);
+                if (ok && *p == '/') {
+                    p++;
+                    char* end = nullptr;
+                    strtol(p, &end, 10);    // Texture coordinate, unused
+                    p = end;
+                    if (*p == '/') { p++; ok = ParseObjIndex(p, nrmCount, ni); }
+                }
+                if (!ok) break;
+                while (*p && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') p++;
+
+                uint64_t key = ((uint64_t)ni << 32) | vi;
+                auto it = remap.find(key);
+                if (it == remap.end()) {
+                    MeshVertex v = {};
+                    memcpy(v.pos, &positions[(size_t)vi * 3], sizeof(v.pos));
+                    if (ni != UINT32_MAX) memcpy(v.normal, &normals[(size_t)ni * 3], sizeof(v.normal));
+                    it = remap.emplace(key, (uint32_t)m.vertices.size()).first;
+                    m.vertices.push_back(v);
+                    m.needsNormal.push_back(ni == UINT32_MAX);
+                }
+                face.push_back(it->second);
+            }
+            if (!ok) { Log("[ERROR] Convert: %s line %zu: bad face index\n", path, lineNo); break; }
+            for (size_t i = 2; i < face.size(); i++) {
+                m.indices.push_back(face[0]); m.indices.push_back(face[i - 1]); m.indices.push_back(face[i]);
+            }
+        }
+    }
+    fclose(f);
+    if (ok) GenerateNormals(m, 0, 0);
+    return ok;
+}
+
+// ============== JSON (glTF) ==============
+// Just enough of RFC 8259 for glTF documents
+struct JsonValue {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } type = NUL;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;       // Array elements / object values
+    std::vector<std::string> keys;      // Object keys, parallel to items
+
+    const JsonValue* Get(const char* key) const {
+        for (size_t i = 0; i < keys.size(); i++)
+            if (keys[i] == key) return &items[i];
+        return nullptr;
+    }
+    const JsonValue* At(size_t i) const { return type == ARRAY && i < items.size() ? &items[i] : nullptr; }
+    double Number(const char* key, double fallback) const {
+        const JsonValue* v = Get(key);
+        return v && v->type == NUMBER ? v->number : fallback;
+    }
+};
+
+static void JsonSkipSpace(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+}
+
+static bool JsonParseString(const char*& p, const char* end, std::string& out) {
+    if (p >= end || *p != '"') return false;
+    p++;
+    while (p < end && *p != '"') {
+        char c = *p++;
+        if (c != '\\') { out += c; continue; }
+        if (p >= end) return false;
+        c = *p++;
+        switch (c) {
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            if (end - p < 4) return false;
+            unsigned code = (unsigned)strtoul(std::string(p, 4).c_str(), nullptr, 16);
+            p += 4;
+            // UTF-8, surrogate pairs kept as two 3-byte sequences
+            if (code < 0x80) out += (char)code;
+            else if (code < 0x800) { out += (char)(0xC0 | (code >> 6)); out += (char)(0x80 | (code & 0x3F)); }
+            else { out += (char)(0xE0 | (code >> 12)); out += (char)(0x80 | ((code >> 6) & 0x3F)); out += (char)(0x80 | (code & 0x3F)); }
+            break;
+        }
+        default: out += c; break;
+        }
+    }
+    if (p >= end) return false;
+    p++;
+    return true;
+}
+
+static bool JsonParse(const char*& p, const char* end, JsonValue& out, int depth) {
+    JsonSkipSpace(p, end);
+    if (p >= end || depth > 64) return false;
+    if (*p == '{' || *p == '[') {
+        bool object = *p == '{';
+        char close = object ? '}' : ']';
+        out.type = object ? JsonValue::OBJECT : JsonValue::ARRAY;
+        p++;
+        JsonSkipSpace(p, end);
+        if (p < end && *p == close) { p++; return true; }
+        for (;;) {
+            if (object) {
+                std::string key;
+                JsonSkipSpace(p, end);
+                if (!JsonParseString(p, end, key)) return false;
+                JsonSkipSpace(p, end);
+                if (p >= end || *p != ':') return false;
+                p++;
+                out.keys.push_back(key);
+            }
+            out.items.emplace_back();
+            if (!JsonParse(p, end, out.items.back(), depth + 1)) return false;
+            JsonSkipSpace(p, end);
+            if (p < end && *p == ',') { p++; continue; }
+            if (p < end && *p == close) { p++; return true; }
+            return false;
+        }
+    }
+    if (*p == '"') { out.type = JsonValue::STRING; return JsonParseString(p, end, out.string); }
+    if (end - p >= 4 && strncmp(p, "true", 4) == 0) { out.type = JsonValue::BOOL; out.number = 1; p += 4; return true; }
+    if (end - p >= 5 && strncmp(p, "false", 5) == 0) { out.type = JsonValue::BOOL; p += 5; return true; }
+    if (end - p >= 4 && strncmp(p, "null", 4) == 0) { p += 4; return true; }
+    char* numEnd = nullptr;
+    out.number = strtod(p, &numEnd);
+    if (numEnd == p || numEnd > end) return false;
+    out.type = JsonValue::NUMBER;
+    p = numEnd;
+    return true;
+}
+
+// ============== glTF 2.0 ==============
+// Triangle-list primitives of the default scene's node tree, node transforms
+// applied. Buffers: the GLB BIN chunk, external files, base64 data URIs.
+#define GLTF_FLOAT 5126
+#define GLTF_UBYTE 5121
+#define GLTF_USHORT 5123
+#define GLTF_UINT 5125
+#define GLTF_TRIANGLES 4
+
+struct GltfDoc {
+    JsonValue json;
+    std::vector<std::vector<BYTE>> buffers;
+};
+
+static bool ReadWholeFile(const std::string& path, std::vector<BYTE>& out) {
+    FILE* f = nullptr;
+    if (fopen_s(&f, path.c_str(), "rb") != 0 || !f) return false;
+    _fseeki64(f, 0, SEEK_END);
+    long long size = _ftelli64(f);
+    _fseeki64(f, 0, SEEK_SET);
+    out.resize(size > 0 ? (size_t)size : 0);
+    bool ok = size >= 0 && fread(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+}
+
+static bool DecodeBase64(const char* p, std::vector<BYTE>& out) {
+    uint32_t acc = 0;
+    int bits = 0;
+    for (; *p && *p != '='; p++) {
+        char c = *p;
+        int v = c >= 'A' && c <= 'Z' ? c - 'A' : c >= 'a' && c <= 'z' ? c - 'a' + 26 :
+                c >= '0' && c <= '9' ? c - '0' + 52 : c == '+' ? 62 : c == '/' ? 63 : -1;
+        if (v < 0) return false;
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) { bits -= 8; out.push_back((BYTE)(acc >> bits)); }
+    }
+    return true;
+}
+
+static bool LoadGltf(const char* path, GltfDoc& doc) {
+    std::vector<BYTE> file;
+    if (!ReadWholeFile(path, file)) { Log("[ERROR] Convert: cannot read %s\n", path); return false; }
+
+    bool glb = file.size() >= 12 && memcmp(file.data(), "glTF", 4) == 0;
+    size_t jsonSize = file.size();
+    file.push_back(0);      // strtod stops at the end of a .gltf document
+    const char* json = (const char*)file.data();
+    if (glb) {
+        // 12-byte header, then JSON and BIN chunks (length, type, data)
+        size_t offset = 12;
+        json = nullptr;
+        while (offset + 8 <= file.size()) {
+            uint32_t length, type;
+            memcpy(&length, &file[offset], 4);
+            memcpy(&type, &file[offset + 4], 4);
+            offset += 8;
+            if (offset + length > file.size()) break;
+            if (type == 0x4E4F534Au) { json = (const char*)&file[offset]; jsonSize = length; }                  // "JSON"
+            else if (type == 0x004E4942u) doc.buffers.emplace_back(file.begin() + offset, file.begin() + offset + length); // "BIN\0"
+            offset += length;
+        }
+        if (!json) { Log("[ERROR] Convert: %s has no JSON chunk\n", path); return false; }
+    }
+    const char* p = json;
+    if (!JsonParse(p, json + jsonSize, doc.json, 0) || doc.json.type != JsonValue::OBJECT) {
+        Log("[ERROR] Convert: %s: malformed glTF JSON\n", path);
+        return false;
+    }
+
+    // External / embedded buffers (a GLB's buffer 0 without a uri is the BIN chunk)
+    std::string dir(path);
+    size_t slash = dir.find_last_of("\\/");
+    dir = slash == std::string::npos ? std::string() : dir.substr(0, slash + 1);
+    const JsonValue* buffers = doc.json.Get("buffers");
+    for (size_t i = 0; buffers && i < buffers->items.size(); i++) {
+        const JsonValue* uri = buffers->items[i].Get("uri");
+        if (!uri) {
+            if (!glb || i != 0 || doc.buffers.empty()) { Log("[ERROR] Convert: buffer %zu has no data\n", i); return false; }
+            continue;
+        }
+        std::vector<BYTE> data;
+        const std::string& u = uri->string;
+        bool ok;
+        if (u.compare(0, 5, "data:") == 0) {
+            size_t comma = u.find(";base64,");
+            ok = comma != std::string::npos && DecodeBase64(u.c_str() + comma + 8, data);
+        } else {
+            ok = ReadWholeFile(dir + u, data);
+        }
+        if (!ok) { Log("[ERROR] Convert: cannot load buffer '%s'\n", u.compare(0, 5, "data:") == 0 ? "data:" : u.c_str()); return false; }
+        if (glb && i == 0 && !doc.buffers.empty()) doc.buffers[0] = data;
+        else doc.buffers.push_back(data);
+    }
+    return true;
+}
+
+// Element e of an accessor: pointer and component type, nullptr when out of range
+struct GltfAccessor {
+    const BYTE* data = nullptr;
+    size_t stride = 0;
+    uint32_t count = 0;
+    int componentType = 0;
+    int components = 0;
+};
+
+static bool GltfGetAccessor(const GltfDoc& doc, int index, GltfAccessor& out) {
+    const JsonValue* accessors = doc.json.Get("accessors");
+    const JsonValue* a = accessors ? accessors->At(index) : nullptr;
+    if (!a || a->Get("sparse")) return false;
+    const JsonValue* views = doc.json.Get("bufferViews");
+    const JsonValue* view = views ? views->At((size_t)a->Number("bufferView", -1)) : nullptr;
+    if (!view) return false;
+    size_t buffer = (size_t)view->Number("buffer", 0);
+    if (buffer >= doc.buffers.size()) return false;
+
+    const JsonValue* type = a->Get("type");
+    std::string t = type ? type->string : "";
+    out.components = t == "SCALAR" ? 1 : t == "VEC2" ? 2 : t == "VEC3" ? 3 : t == "VEC4" ? 4 : 0;
+    out.componentType = (int)a->Number("componentType", 0);
+    out.count = (uint32_t)a->Number("count", 0);
+    size_t componentBytes = out.componentType == GLTF_FLOAT || out.componentType == GLTF_UINT ? 4 :
+                            out.componentType == GLTF_USHORT ? 2 : 1;
+    size_t elementBytes = componentBytes * out.components;
+    out.stride = (size_t)view->Number("byteStride", 0);
+    if (out.stride == 0) out.stride = elementBytes;
+    size_t offset = (size_t)view->Number("byteOffset", 0) + (size_t)a->Number("byteOffset", 0);
+    size_t viewEnd = (size_t)view->Number("byteOffset", 0) + (size_t)view->Number("byteLength", 0);
+    const std::vector<BYTE>& data = doc.buffers[buffer];
+    if (out.components == 0 || out.count == 0 || viewEnd > data.size() ||
+        offset + (size_t)(out.count - 1) * out.stride + elementBytes > viewEnd)
+        return false;
+    out.data = data.data() + offset;
+    return true;
+}
+
+// Column-major 4x4 (glTF order)
+static void MatMul(const float a[16], const float b[16], float out[16]) {
+    float r[16];
+    for (int c = 0; c < 4; c++)
+        for (int row = 0; row < 4; row++)
+            r[c * 4 + row] = a[0 * 4 + row] * b[c * 4 + 0] + a[1 * 4 + row] * b[c * 4 + 1] +
+                             a[2 * 4 + row] * b[c * 4 + 2] + a[3 * 4 + row] * b[c * 4 + 3];
+    memcpy(out, r, sizeof(r));
+}
+
+static void NodeLocalMatrix(const JsonValue& node, float m[16]) {
+    static const float identity[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+    memcpy(m, identity, sizeof(identity));
+    const JsonValue* matrix = node.Get("matrix");
+    if (matrix && matrix->items.size() == 16) {
+        for (int i = 0; i < 16; i++) m[i] = (float)matrix->items[i].number;
+        return;
+    }
+    float t[3] = { 0, 0, 0 }, q[4] = { 0, 0, 0, 1 }, s[3] = { 1, 1, 1 };
+    const JsonValue* v;
+    if ((v = node.Get("translation")) && v->items.size() == 3) for (int i = 0; i < 3; i++) t[i] = (float)v->items[i].number;
+    if ((v = node.Get("rotation")) && v->items.size() == 4) for (int i = 0; i < 4; i++) q[i] = (float)v->items[i].number;
+    if ((v = node.Get("scale")) && v->items.size() == 3) for (int i = 0; i < 3; i++) s[i] = (float)v->items[i].number;
+    float x = q[0], y = q[1], z = q[2], w = q[3];
+    float r[9] = {
+        1 - 2 * (y * y + z * z), 2 * (x * y + z * w),     2 * (x * z - y * w),
+        2 * (x * y - z * w),     1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+        2 * (x * z + y * w),     2 * (y * z - x * w),     1 - 2 * (x * x + y * y),
+    };
+    for (int c = 0; c < 3; c++)
+        for (int row = 0; row < 3; row++) m[c * 4 + row] = r[c * 3 + row] * s[c];
+    m[12] = t[0]; m[13] = t[1]; m[14] = t[2];
+}
+
+static bool ImportGltfPrimitive(const GltfDoc& doc, const JsonValue& prim, const float world[16], MeshImport& m) {
+    if ((int)prim.Number("mode", GLTF_TRIANGLES) != GLTF_TRIANGLES) return true;   // Lines / points: skipped
+    const JsonValue* attribs = prim.Get("attributes");
+    GltfAccessor pos, nrm, idx;
+    if (!attribs || !GltfGetAccessor(doc, (int)attribs->Number("POSITION", -1), pos) ||
+        pos.componentType != GLTF_FLOAT || pos.components != 3) {
+        Log("[ERROR] Convert: primitive without a float3 POSITION accessor\n");
+        return false;
+    }
+    bool hasNormals = GltfGetAccessor(doc, (int)attribs->Number("NORMAL", -1), nrm) &&
+                      nrm.componentType == GLTF_FLOAT && nrm.components == 3 && nrm.count == pos.count;
+    bool indexed = prim.Get("indices") != nullptr;
+    if (indexed && (!GltfGetAccessor(doc, (int)prim.Number("indices", -1), idx) || idx.components != 1)) {
+        Log("[ERROR] Convert: bad index accessor\n");
+        return false;
+    }
+
+    // Normals by the inverse transpose (cofactors) of the upper 3x3; a mirroring
+    // transform flips the winding
+    const float* a = world;
+    float cof[9] = {
+        a[5] * a[10] - a[6] * a[9], a[6] * a[8] - a[4] * a[10], a[4] * a[9] - a[5] * a[8],
+        a[2] * a[9] - a[1] * a[10], a[0] * a[10] - a[2] * a[8], a[1] * a[8] - a[0] * a[9],
+        a[1] * a[6] - a[2] * a[5],  a[2] * a[4] - a[0] * a[6],  a[0] * a[5] - a[1] * a[4],
+    };
+    float det = a[0] * cof[0] + a[1] * cof[1] + a[2] * cof[2];
+
+    uint32_t base = (uint32_t)m.vertices.size();
+    size_t firstIndex = m.indices.size();
+    for (uint32_t i = 0; i < pos.count; i++) {
+        float p[3], n[3] = { 0, 0, 0 };
+        memcpy(p, pos.data + (size_t)i * pos.stride, sizeof(p));
+        if (hasNormals) memcpy(n, nrm.data + (size_t)i * nrm.stride, sizeof(n));
+        MeshVertex v;
+        for (int r = 0; r < 3; r++) {
+            v.pos[r] = a[r] * p[0] + a[4 + r] * p[1] + a[8 + r] * p[2] + a[12 + r];
+            v.normal[r] = cof[r] * n[0] + cof[3 + r] * n[1] + cof[6 + r] * n[2];
+        }
+        float len = sqrtf(v.normal[0] * v.normal[0] + v.normal[1] * v.normal[1] + v.normal[2] * v.normal[2]);
+        if (det < 0.0f) len = -len;
+        for (int r = 0; r < 3; r++) v.normal[r] = len != 0.0f ? v.normal[r] / len : 0.0f;
+        m.vertices.push_back(v);
+        m.needsNormal.push_back(!hasNormals);
+    }
+
+    uint32_t count = indexed ? idx.count : pos.count;
+    for (uint32_t i = 0; i + 2 < count; i += 3) {
+        uint32_t tri[3];
+        for (int k = 0; k < 3; k++) {
+            uint32_t e = i + k;
+            if (!indexed) { tri[k] = e; continue; }
+            const BYTE* src = idx.data + (size_t)e * idx.stride;
+            if (idx.componentType == GLTF_UINT) memcpy(&tri[k], src, 4);
+            else if (idx.componentType == GLTF_USHORT) { uint16_t s; memcpy(&s, src, 2); tri[k] = s; }
+            else tri[k] = *src;
+            if (tri[k] >= pos.count) { Log("[ERROR] Convert: index %u of %u vertices\n", tri[k], pos.count); return false; }
+        }
+        if (det < 0.0f) { uint32_t t = tri[1]; tri[1] = tri[2]; tri[2] = t; }
+        for (int k = 0; k < 3; k++) m.indices.push_back(base + tri[k]);
+    }
+    GenerateNormals(m, base, firstIndex);
+    return true;
+}
+
+static bool ImportGltfNode(const GltfDoc& doc, int index, const float parent[16], MeshImport& m, int depth) {
+    const JsonValue* nodes = doc.json.Get("nodes");
+    const JsonValue* node = nodes ? nodes->At(index) : nullptr;
+    if (!node || depth > 64) { Log("[ERROR] Convert: bad node %d\n", index); return false; }
+    float local[16], world[16];
+    NodeLocalMatrix(*node, local);
+    MatMul(parent, local, world);
+
+    const JsonValue* meshes = doc.json.Get("meshes");
+    const JsonValue* mesh = node->Get("mesh") && meshes ? meshes->At((size_t)node->Number("mesh", -1)) : nullptr;
+    const JsonValue* prims = mesh ? mesh->Get("primitives") : nullptr;
+    for (size_t i = 0; prims && i < prims->items.size(); i++)
+        if (!ImportGltfPrimitive(doc, prims->items[i], world, m)) return false;
+
+    const JsonValue* children = node->Get("children");
+    for (size_t i = 0; children && i < children->items.size(); i++)
+        if (!ImportGltfNode(doc, (int)children->items[i].number, world, m, depth + 1)) return false;
+    return true;
+}
+
+static bool ImportGltf(const char* path, MeshImport& m) {
+    GltfDoc doc;
+    if (!LoadGltf(path, doc)) return false;
+    static const float identity[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+
+    const JsonValue* scenes = doc.json.Get("scenes");
+    const JsonValue* scene = scenes ? scenes->At((size_t)doc.json.Number("scene", 0)) : nullptr;
+    const JsonValue* roots = scene ? scene->Get("nodes") : nullptr;
+    if (roots) {
+        for (size_t i = 0; i < roots->items.size(); i++)
+            if (!ImportGltfNode(doc, (int)roots->items[i].number, identity, m, 0)) return false;
+        return true;
+    }
+    // No scene: every mesh once, untransformed
+    const JsonValue* meshes = doc.json.Get("meshes");
+    for (size_t i = 0; meshes && i < meshes->items.size(); i++) {
+        const JsonValue* prims = meshes->items[i].Get("primitives");
+        for (size_t j = 0; prims && j < prims->items.size(); j++)
+            if (!ImportGltfPrimitive(doc, prims->items[j], identity, m)) return false;
+    }
+    return true;
+}
+
+// ============== CONVERT ==============
+// Right-handed source -> the left-handed scene (mirror z, which also turns
+// the counter-clockwise front faces clockwise), centred and scaled to
+// MESH_FILE_EXTENT
+static void MeshFinish(MeshImport& m, MeshFileHeader& h) {
+    float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (MeshVertex& v : m.vertices) {
+        v.pos[2] = -v.pos[2];
+        v.normal[2] = -v.normal[2];
+        for (int i = 0; i < 3; i++) { lo[i] = fminf(lo[i], v.pos[i]); hi[i] = fmaxf(hi[i], v.pos[i]); }
+    }
+    float extent = fmaxf(hi[0] - lo[0], fmaxf(hi[1] - lo[1], hi[2] - lo[2]));
+    float scale = extent > 0.0f ? MESH_FILE_EXTENT / extent : 1.0f;
+    float center[3] = { (lo[0] + hi[0]) * 0.5f, (lo[1] + hi[1]) * 0.5f, (lo[2] + hi[2]) * 0.5f };
+    for (MeshVertex& v : m.vertices)
+        for (int i = 0; i < 3; i++) v.pos[i] = (v.pos[i] - center[i]) * scale;
+    for (int i = 0; i < 3; i++) {
+        h.boundsMin[i] = (lo[i] - center[i]) * scale;
+        h.boundsMax[i] = (hi[i] - center[i]) * scale;
+    }
+}
+
+static bool WritePadding(FILE* f, uint64_t& offset, uint64_t target) {
+    static const BYTE zeros[MESH_FILE_ALIGN] = {};
+    size_t n = (size_t)(target - offset);
+    offset = target;
+    return fwrite(zeros, 1, n, f) == n;
+}
+
+bool MeshConvert(const char* inPath) {
+    std::string in(inPath);
+    size_t dot = in.find_last_of('.');
+    std::string ext = dot == std::string::npos ? "" : in.substr(dot);
+    for (char& c : ext) c = (char)tolower((unsigned char)c);
+    std::string out = (dot == std::string::npos ? in : in.substr(0, dot)) + ".rtm";
+
+    MeshImport m;
+    bool ok;
+    if (ext == ".obj") ok = ImportObj(inPath, m);
+    else if (ext == ".gltf" || ext == ".glb") ok = ImportGltf(inPath, m);
+    else { Log("[ERROR] Convert: unknown mesh type '%s' (obj, gltf, glb)\n", ext.c_str()); return false; }
+    if (!ok) return false;
+    if (m.indices.empty() || m.vertices.size() > UINT32_MAX || m.indices.size() > UINT32_MAX) {
+        Log("[ERROR] Convert: %s: %zu verts, %zu inds - nothing to write or too large\n",
+            inPath, m.vertices.size(), m.indices.size());
+        return false;
+    }
+
+    MeshFileHeader h = {};
+    h.magic = MESH_FILE_MAGIC;
+    h.version = MESH_FILE_VERSION;
+    h.vertexCount = (uint32_t)m.vertices.size();
+    h.indexCount = (uint32_t)m.indices.size();
+    h.vertexOffset = AlignMesh(sizeof(MeshFileHeader));
+    h.indexOffset = AlignMesh(h.vertexOffset + (uint64_t)h.vertexCount * sizeof(MeshVertex));
+    MeshFinish(m, h);
+
+    FILE* f = nullptr;
+    if (fopen_s(&f, out.c_str(), "wb") != 0 || !f) { Log("[ERROR] Convert: cannot create %s\n", out.c_str()); return false; }
+    uint64_t offset = sizeof(MeshFileHeader);
+    ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    ok = ok && WritePadding(f, offset, h.vertexOffset);
+    ok = ok && fwrite(m.vertices.data(), sizeof(MeshVertex), m.vertices.size(), f) == m.vertices.size();
+    offset += (uint64_t)h.vertexCount * sizeof(MeshVertex);
+    ok = ok && WritePadding(f, offset, h.indexOffset);
+    ok = ok && fwrite(m.indices.data(), sizeof(uint32_t), m.indices.size(), f) == m.indices.size();
+    ok = fclose(f) == 0 && ok;
+    if (!ok) { Log("[ERROR] Convert: writing %s failed\n", out.c_str()); return false; }
+
+    Log("[INFO] Converted %s -> %s: %u verts, %u triangles\n", inPath, out.c_str(), h.vertexCount, h.indexCount / 3);
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+// ============== STREAMED MESH FILES ==============
+// --mesh=<file.rtm>: an external triangle mesh for the scale tests, in a flat
+// binary layout that the renderers upload straight out of a read-only file
+// mapping (no parsing, no intermediate copies):
+//   MeshFileHeader                 64 bytes
+//   MeshVertex[vertexCount]        float3 position, float3 normal
+//   uint32_t[indexCount]           triangle list
+// Sections start on MESH_FILE_ALIGN byte boundaries. The layout follows the
+// procedural meshes: left-handed, clockwise front faces, centred at the origin
+// with the longest side MESH_FILE_EXTENT long - the size of the rounded cube
+// of the --cubes scene, so the same instance grid fits either.
+//
+// --convert-mesh=<in> writes <in>.rtm from Wavefront OBJ or glTF 2.0 (.gltf
+// with external buffers, .glb) and exits. The raster renderers (D3D11, D3D12,
+// OpenGL, Vulkan) draw the mesh in place of the --cubes rounded cube, once
+// when --cubes is 0. D3D12 PT and Vulkan RQ build it as the BLAS of the
+// rotating cube instance.
+
+#include "common.h"
+#include <cstdint>
+
+#define MESH_FILE_MAGIC 0x314D5452u     // "RTM1"
+#define MESH_FILE_VERSION 1
+#define MESH_FILE_ALIGN 256
+#define MESH_FILE_EXTENT 0.95f
+
+struct MeshVertex {
+    float pos[3];
+    float normal[3];
+};
+static_assert(sizeof(MeshVertex) == 24, "MeshVertex must be 24 bytes");
+
+struct MeshFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint64_t vertexOffset;      // Bytes from the start of the file
+    uint64_t indexOffset;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t reserved[2];
+};
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader must be 64 bytes");
+
+// An open file mapping. vertices / indices point into the mapped view, so
+// UploadBuffer12 / VkUploadBuffer / glVertexPointer read the file pages
+// directly and the OS streams them in on first touch.
+struct MeshFile {
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+    const BYTE* view = nullptr;
+    uint64_t size = 0;
+    const MeshVertex* vertices = nullptr;
+    const uint32_t* indices = nullptr;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+};
+
+extern std::string g_meshPath;  // --mesh, empty = procedural scene
+extern MeshFile g_mesh;         // Mapped at startup (MeshFileOpen), shared by every renderer
+
+bool MeshFileOpen(const char* path, MeshFile& mesh);
+void MeshFileClose(MeshFile& mesh);
+inline bool MeshLoaded() { return g_mesh.view != nullptr; }
+
+size_t MeshVertexBytes(const MeshFile& mesh);
+size_t MeshIndexBytes(const MeshFile& mesh);
+// Unit face normal of triangle t, turned towards its vertex normals
+void MeshFaceNormal(const MeshFile& mesh, uint32_t t, float out[3]);
+
+// Renderers that draw --mesh (the others keep their procedural scene)
+bool MeshSupportedBy(RendererType type);
+
+// --convert-mesh: OBJ / glTF / GLB -> <in>.rtm, false (after logging) on failure
+bool MeshConvert(const char* inPath);
@@ -0,0 +1,250 @@
+// ============== MULTI-GPU BENCHMARK ==============
+// Coordinator for --all-gpus (see multi_gpu_bench.h). The children are
+// ordinary --benchmark / --sweep runs; everything here is process plumbing
+// and reading their CSVs back.
+
+#include "multi_gpu_bench.h"
+#include "benchmark.h"
+#include "offscreen.h"
+
+#define MULTI_GPU_MAX MAXIMUM_WAIT_OBJECTS
+
+struct MultiGpuChild {
+    int gpu;
+    char gpuName[256];
+    char reportBase[MAX_PATH];
+    PROCESS_INFORMATION pi;
+    bool launched;
+    DWORD exitCode;
+};
+
+struct MultiGpuRow {
+    int gpu;
+    RendererType renderer;
+    const char* status;
+    BenchmarkStats stats;
+};
+
+// ============== PATHS ==============
+// Same default location as the other reports: next to the executable
+static void GetMultiGpuBasePath(char* out, size_t size) {
+    if (g_benchConfig.reportPath[0]) {
+        strcpy_s(out, size, g_benchConfig.reportPath);
+        return;
+    }
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+    char* dot = strrchr(exePath, '.');
+    if (dot) *dot = 0;
+    sprintf_s(out, size, "%s_multigpu", exePath);
+}
+
+// <child base>.csv, or <child base>_<renderer>.csv for a sweep
+static void GetChildFrameCsvPath(const MultiGpuChild& child, RendererType renderer, char* out, size_t size) {
+    if (g_benchConfig.sweep)
+        sprintf_s(out, size, "%s_%s.csv", child.reportBase, GetRendererId(renderer));
+    else
+        sprintf_s(out, size, "%s.csv", child.reportBase);
+}
+
+static bool ReadFrameCsv(const char* path, std::vector<double>& out) {
+    out.clear();
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "r") != 0 || !f) return false;
+    char header[64];
+    if (fgets(header, sizeof(header), f)) {
+        unsigned int frame = 0;
+        double ms = 0.0;
+        while (fscanf_s(f, "%u,%lf", &frame, &ms) == 2) out.push_back(ms);
+    }
+    fclose(f);
+    return !out.empty();
+}
+
+// ============== CHILD COMMAND LINE ==============
+// The original arguments minus the ones the coordinator sets per child
+// (--offscreen included: LaunchChild decides it)
+static std::string FilterChildArgs(const char* cmdLine) {
+    std::string args;
+    if (!cmdLine || !*cmdLine) return args;
+
+    char* cmd = _strdup(cmdLine);
+    char* context = nullptr;
+    char* token = CommandArgToken(cmd, &context);
+    while (token) {
+        if (strcmp(token, "-g") == 0 || strcmp(token, "--gpu") == 0) {
+            CommandArgToken(nullptr, &context);   // Drop the index as well
+        }
+        else if (strcmp(token, "--all-gpus") != 0 &&
+                 strcmp(token, "--offscreen") != 0 &&
+                 strncmp(token, "--gpu=", 6) != 0 &&
+                 strncmp(token, "--report=", 9) != 0 &&
+                 strncmp(token, "--instance=", 11) != 0) {
+            // Re-quote what the parser unquoted (paths with spaces)
+            bool quote = strchr(token, ' ') != nullptr;
+            args += quote ? " \"" : " ";
+            args += token;
+            if (quote) args += '"';
+        }
+        token = CommandArgToken(nullptr, &context);
+    }
+    free(cmd);
+    return args;
+}
+
+// offscreen: the children render without presenting, so they don't compete
+// for window focus and DWM composition on the primary display
+static bool LaunchChild(MultiGpuChild& child, const char* exePath, const std::string& args, bool offscreen) {
+    char cmdLine[4096];
+    // Quoted: the report base may contain spaces (exe directory, user --report)
+    sprintf_s(cmdLine, "\"%s\" --instance=gpu%d --gpu=%d \"--report=%s\"%s%s%s",
+        exePath, child.gpu, child.gpu, child.reportBase,
+        g_benchConfig.sweep ? "" : " --benchmark", offscreen ? " --offscreen" : "", args.c_str());
+
+    STARTUPINFOA si = {};
+    si.cb = sizeof(si);
+    if (!CreateProcessA(exePath, cmdLine, nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &child.pi)) {
+        Log("[ERROR] All GPUs: cannot start the benchmark for GPU %d (error %lu)\n", child.gpu, GetLastError());
+        return false;
+    }
+    Log("[INFO] All GPUs: GPU %d (%s) started, pid %lu\n", child.gpu, child.gpuName, child.pi.dwProcessId);
+    return true;
+}
+
+// ============== COMBINED REPORT ==============
+static bool WriteCombinedReport(const char* basePath, const std::vector<MultiGpuChild>& children,
+                                const std::vector<MultiGpuRow>& rows, double wallSeconds) {
+    double measuredSeconds = 0.0;
+    Log("[INFO] ===== All GPUs results (%zu adapters, concurrent) =====\n", children.size());
+    Log("[INFO] %-3s %-14s %-9s %8s %9s %9s %9s %9s %9s %9s\n",
+        "gpu", "renderer", "status", "avg fps", "mean ms", "median", "p95", "p99", "1% low", "max ms");
+    for (const MultiGpuRow& r : rows) {
+        measuredSeconds += r.stats.totalSeconds;
+        if (r.stats.frameCount) {
+            Log("[INFO] %-3d %-14s %-9s %8.1f %9.3f %9.3f %9.3f %9.3f %9.1f %9.3f\n",
+                r.gpu, GetRendererId(r.renderer), r.status, r.stats.avgFps, r.stats.meanMs,
+                r.stats.medianMs, r.stats.p95Ms, r.stats.p99Ms, r.stats.low1Fps, r.stats.maxMs);
+        } else {
+            Log("[INFO] %-3d %-14s %-9s\n", r.gpu, GetRendererId(r.renderer), r.status);
+        }
+    }
+    Log("[INFO] All GPUs: %.1f s wall-clock for %.1f s of measured frames\n", wallSeconds, measuredSeconds);
+
+    char csvPath[MAX_PATH];
+    sprintf_s(csvPath, "%s_gpus.csv", basePath);
+    FILE* f = nullptr;
+    if (fopen_s(&f, csvPath, "w") != 0 || !f) {
+        Log("[ERROR] All GPUs: cannot write %s\n", csvPath);
+        return false;
+    }
+    fprintf(f, "gpu_index,gpu,renderer,status,frames,avg_fps,mean_ms,median_ms,p95_ms,p99_ms,low1_ms,low1_fps,max_ms,exit_code\n");
+    for (const MultiGpuRow& r : rows) {
+        const MultiGpuChild* child = nullptr;
+        for (const MultiGpuChild& c : children) if (c.gpu == r.gpu) child = &c;
+        fprintf(f, "%d,\"%s\",%s,%s,%u,%.2f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%.4f,%lu\n",
+            r.gpu, child ? child->gpuName : "unknown", GetRendererId(r.renderer), r.status,
+            r.stats.frameCount, r.stats.avgFps, r.stats.meanMs, r.stats.medianMs, r.stats.p95Ms,
+            r.stats.p99Ms, r.stats.low1Ms, r.stats.low1Fps, r.stats.maxMs, child ? child->exitCode : 0ul);
+    }
+    fclose(f);
+    Log("[INFO] All GPUs report: %s\n", csvPath);
+    return true;
+}
+
+// ============== COORDINATOR ==============
+int MultiGpuBenchmarkRun(const char* cmdLine, RendererType renderer)
+{
+    if (g_gpuList.size() > MULTI_GPU_MAX)
+        Log("[WARN] All GPUs: %zu adapters, only the first %d are benchmarked\n", g_gpuList.size(), MULTI_GPU_MAX);
+
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+    char basePath[MAX_PATH];
+    GetMultiGpuBasePath(basePath, sizeof(basePath));
+    std::string args = FilterChildArgs(cmdLine);
+
+    std::vector<RendererType> renderers;
+    if (g_benchConfig.sweep) {
+        for (int t = RENDERER_D3D11; t <= RENDERER_VULKAN_RQ; t++) renderers.push_back((RendererType)t);
+    } else {
+        renderers.push_back(renderer);
+    }
+
+    // Every renderer of the run has to support --offscreen, else all children use windows
+    bool offscreen = true;
+    for (RendererType r : renderers) {
+        if (OffscreenSupported(r)) continue;
+        Log("[WARN] All GPUs: %s has no --offscreen path, children render into visible windows "
+            "(focus and DWM composition on the primary display skew the per-GPU numbers)\n", GetRendererId(r));
+        offscreen = false;
+    }
+
+    std::vector<MultiGpuChild> children;
+    for (size_t i = 0; i < g_gpuList.size() && i < MULTI_GPU_MAX; i++) {
+        MultiGpuChild child = {};
+        child.gpu = (int)i;
+        size_t conv = 0;
+        wcstombs_s(&conv, child.gpuName, sizeof(child.gpuName), g_gpuList[i].name.c_str(), _TRUNCATE);
+        sprintf_s(child.reportBase, "%s_gpu%d", basePath, child.gpu);
+        children.push_back(child);
+    }
+
+    // Stale CSVs from an earlier run would otherwise be read as this run's results
+    for (const MultiGpuChild& child : children) {
+        for (RendererType r : renderers) {
+            char csvPath[MAX_PATH];
+            GetChildFrameCsvPath(child, r, csvPath, sizeof(csvPath));
+            DeleteFileA(csvPath);
+        }
+    }
+
+    Log("[INFO] All GPUs: %s%s on %zu adapters at once%s\n",
+        g_benchConfig.sweep ? "sweep" : "benchmark ", g_benchConfig.sweep ? "" : GetRendererId(renderer), children.size(),
+        offscreen ? ", offscreen" : "");
+
+    LARGE_INTEGER freq, start, end;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+
+    std::vector<HANDLE> processes;
+    for (MultiGpuChild& child : children) {
+        child.launched = LaunchChild(child, exePath, args, offscreen);
+        if (child.launched) processes.push_back(child.pi.hProcess);
+    }
+    if (!processes.empty())
+        WaitForMultipleObjects((DWORD)processes.size(), processes.data(), TRUE, INFINITE);
+    QueryPerformanceCounter(&end);
+
+    bool allOK = true;
+    for (MultiGpuChild& child : children) {
+        if (!child.launched) { allOK = false; continue; }
+        GetExitCodeProcess(child.pi.hProcess, &child.exitCode);
+        CloseHandle(child.pi.hProcess);
+        CloseHandle(child.pi.hThread);
+        if (child.exitCode != 0) {
+            Log("[WARN] All GPUs: GPU %d exited with code %lu, see its _error_gpu%d.log\n",
+                child.gpu, child.exitCode, child.gpu);
+            allOK = false;
+        }
+    }
+
+    std::vector<MultiGpuRow> rows;
+    std::vector<double> frames;
+    for (const MultiGpuChild& child : children) {
+        for (RendererType r : renderers) {
+            MultiGpuRow row = {};
+            row.gpu = child.gpu;
+            row.renderer = r;
+            char csvPath[MAX_PATH];
+            GetChildFrameCsvPath(child, r, csvPath, sizeof(csvPath));
+            if (!child.launched) row.status = "no_start";
+            else if (ReadFrameCsv(csvPath, frames) && BenchmarkStatsFromFrames(frames, row.stats)) row.status = "ok";
+            else { row.status = "no_report"; if (!g_benchConfig.sweep) allOK = false; }
+            rows.push_back(row);
+        }
+    }
+
+    double wallSeconds = (double)(end.QuadPart - start.QuadPart) / freq.QuadPart;
+    if (!WriteCombinedReport(basePath, children, rows, wallSeconds)) allOK = false;
+    return allOK ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#pragma once
+// ============== MULTI-GPU BENCHMARK ==============
+// --all-gpus: runs the requested --benchmark (or --sweep) on every enumerated
+// adapter at the same time. Renderer state is per-process global, so each
+// adapter gets its own child process of this executable with
+// --gpu=N --report=<base>_gpuN --instance=gpuN; the coordinator waits for all
+// of them, reads back their per-frame CSVs and writes <base>_gpus.csv plus a
+// log table with one row per GPU and renderer.
+//
+// The children also get --offscreen (offscreen.h) so they don't present into
+// windows competing for focus and DWM composition; if a renderer of the run
+// has no offscreen path, that is logged and the children use windows.
+//
+// Comparing a row against a single-GPU run of the same adapter shows the cost
+// of sharing PCIe, CPU cores and the driver with the other GPUs.
+
+#include "common.h"
+
+// Returns the process exit code: 0 if every child completed its report
+int MultiGpuBenchmarkRun(const char* cmdLine, RendererType renderer);
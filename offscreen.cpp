@@ -0,0 +1,401 @@
+// ============== OFFSCREEN RENDERING ==============
+// The --offscreen swap chain of the DXGI renderers (see offscreen.h). Only
+// what D3D11 / D3D12 renderers and frame_latency.cpp call does real work;
+// the fullscreen, output and composition methods answer like a windowed
+// flip model swap chain that never reaches the screen.
+
+#include "offscreen.h"
+
+#include <d3d11.h>
+#include <d3d12.h>
+
+bool g_offscreen = false;
+
+UINT OffscreenFramesInFlight() {
+    return g_maxFrameLatency ? g_maxFrameLatency : MAX_FRAME_LATENCY;
+}
+
+bool OffscreenSupported(RendererType renderer) {
+    switch (renderer) {
+    case RENDERER_D3D11:
+    case RENDERER_D3D12:
+    case RENDERER_D3D12_DXR10:
+    case RENDERER_D3D12_RT:
+    case RENDERER_D3D12_PT:
+    case RENDERER_D3D12_PT_DLSS:
+    case RENDERER_OPENGL:
+    case RENDERER_VULKAN:
+    case RENDERER_VULKAN_RT:
+    case RENDERER_VULKAN_RQ:
+        return true;
+    default:
+        return false;
+    }
+}
+
+UINT OffscreenEmptySubmitsPerFrame(RendererType renderer) {
+    switch (renderer) {
+    case RENDERER_VULKAN:
+    case RENDERER_VULKAN_RT:
+    case RENDERER_VULKAN_RQ:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+#define OFFSCREEN_MAX_BUFFERS DXGI_MAX_SWAP_CHAIN_BUFFERS
+
+class OffscreenSwapChain : public IDXGISwapChain4 {
+public:
+    OffscreenSwapChain(IUnknown* device, HWND hwnd, const DXGI_SWAP_CHAIN_DESC1& desc)
+        : m_hwnd(hwnd), m_desc(desc) {
+        device->AddRef();
+        m_device = device;
+        ID3D12CommandQueue* queue = nullptr;
+        if (SUCCEEDED(device->QueryInterface(IID_PPV_ARGS(&queue)))) {
+            m_queue12 = queue;
+            queue->GetDevice(IID_PPV_ARGS(&m_dev12));
+        } else {
+            device->QueryInterface(IID_PPV_ARGS(&m_dev11));
+            if (m_dev11) m_dev11->GetImmediateContext(&m_ctx11);
+        }
+    }
+
+    bool Init() {
+        if (m_dev12) {
+            if (FAILED(m_dev12->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence12)))) return false;
+            m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+            if (!m_fenceEvent) return false;
+        } else if (m_dev11) {
+            D3D11_QUERY_DESC qd = { D3D11_QUERY_EVENT, 0 };
+            for (UINT i = 0; i < MAX_FRAME_LATENCY; i++)
+                if (FAILED(m_dev11->CreateQuery(&qd, &m_query11[i]))) return false;
+        } else {
+            return false;
+        }
+        return SUCCEEDED(CreateBuffers());
+    }
+
+    // ============== IUnknown ==============
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppv) override {
+        if (!ppv) return E_POINTER;
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIDeviceSubObject) ||
+            riid == __uuidof(IDXGISwapChain) || riid == __uuidof(IDXGISwapChain1) || riid == __uuidof(IDXGISwapChain2) ||
+            riid == __uuidof(IDXGISwapChain3) || riid == __uuidof(IDXGISwapChain4)) {
+            *ppv = static_cast<IDXGISwapChain4*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *ppv = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return (ULONG)InterlockedIncrement(&m_refs); }
+    ULONG STDMETHODCALLTYPE Release() override {
+        LONG refs = InterlockedDecrement(&m_refs);
+        if (refs == 0) delete this;
+        return (ULONG)refs;
+    }
+
+    // ============== IDXGIObject / IDXGIDeviceSubObject ==============
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return DXGI_ERROR_NOT_FOUND; }
+    HRESULT STDMETHODCALLTYPE GetParent(REFIID riid, void** ppv) override {
+        IDXGIFactory1* factory = nullptr;
+        if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory)))) return E_FAIL;
+        HRESULT hr = factory->QueryInterface(riid, ppv);
+        factory->Release();
+        return hr;
+    }
+    HRESULT STDMETHODCALLTYPE GetDevice(REFIID riid, void** ppv) override { return m_device->QueryInterface(riid, ppv); }
+
+    // ============== IDXGISwapChain ==============
+    HRESULT STDMETHODCALLTYPE Present(UINT, UINT flags) override {
+        if (flags & DXGI_PRESENT_TEST) return S_OK;
+        m_presentCount++;
+        if (m_queue12) {
+            m_queue12->Signal(m_fence12, m_presentCount);
+            PaceD3D12();
+        } else {
+            PaceD3D11();
+        }
+        m_index = (m_index + 1) % m_bufferCount;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetBuffer(UINT buffer, REFIID riid, void** ppv) override {
+        if (!ppv) return E_POINTER;
+        // D3D11 flip model: buffer 0 is always the current back buffer
+        if (m_dev11) return m_tex11 ? m_tex11->QueryInterface(riid, ppv) : DXGI_ERROR_INVALID_CALL;
+        if (buffer >= m_bufferCount || !m_buffers12[buffer]) return DXGI_ERROR_INVALID_CALL;
+        return m_buffers12[buffer]->QueryInterface(riid, ppv);
+    }
+    HRESULT STDMETHODCALLTYPE SetFullscreenState(BOOL fullscreen, IDXGIOutput*) override {
+        return fullscreen ? DXGI_ERROR_NOT_CURRENTLY_AVAILABLE : S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetFullscreenState(BOOL* fullscreen, IDXGIOutput** target) override {
+        if (fullscreen) *fullscreen = FALSE;
+        if (target) *target = nullptr;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetDesc(DXGI_SWAP_CHAIN_DESC* desc) override {
+        if (!desc) return E_INVALIDARG;
+        *desc = {};
+        desc->BufferDesc.Width = m_desc.Width;
+        desc->BufferDesc.Height = m_desc.Height;
+        desc->BufferDesc.Format = m_desc.Format;
+        desc->SampleDesc = m_desc.SampleDesc;
+        desc->BufferUsage = m_desc.BufferUsage;
+        desc->BufferCount = m_desc.BufferCount;
+        desc->OutputWindow = m_hwnd;
+        desc->Windowed = TRUE;
+        desc->SwapEffect = m_desc.SwapEffect;
+        desc->Flags = m_desc.Flags;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE ResizeBuffers(UINT count, UINT width, UINT height, DXGI_FORMAT format, UINT flags) override {
+        if (count) m_desc.BufferCount = count;
+        if (width) m_desc.Width = width;
+        if (height) m_desc.Height = height;
+        if (format != DXGI_FORMAT_UNKNOWN) m_desc.Format = format;
+        m_desc.Flags = flags;
+        return CreateBuffers();
+    }
+    HRESULT STDMETHODCALLTYPE ResizeTarget(const DXGI_MODE_DESC*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE GetContainingOutput(IDXGIOutput** output) override {
+        if (output) *output = nullptr;
+        return DXGI_ERROR_UNSUPPORTED;
+    }
+    HRESULT STDMETHODCALLTYPE GetFrameStatistics(DXGI_FRAME_STATISTICS*) override { return DXGI_ERROR_FRAME_STATISTICS_DISJOINT; }
+    HRESULT STDMETHODCALLTYPE GetLastPresentCount(UINT* count) override {
+        if (!count) return E_INVALIDARG;
+        *count = (UINT)m_presentCount;
+        return S_OK;
+    }
+
+    // ============== IDXGISwapChain1 ==============
+    HRESULT STDMETHODCALLTYPE GetDesc1(DXGI_SWAP_CHAIN_DESC1* desc) override {
+        if (!desc) return E_INVALIDARG;
+        *desc = m_desc;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetFullscreenDesc(DXGI_SWAP_CHAIN_FULLSCREEN_DESC* desc) override {
+        if (!desc) return E_INVALIDARG;
+        *desc = {};
+        desc->Windowed = TRUE;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetHwnd(HWND* hwnd) override {
+        if (!hwnd) return E_INVALIDARG;
+        *hwnd = m_hwnd;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetCoreWindow(REFIID, void** ppv) override {
+        if (ppv) *ppv = nullptr;
+        return DXGI_ERROR_INVALID_CALL;
+    }
+    HRESULT STDMETHODCALLTYPE Present1(UINT syncInterval, UINT flags, const DXGI_PRESENT_PARAMETERS*) override {
+        return Present(syncInterval, flags);
+    }
+    BOOL STDMETHODCALLTYPE IsTemporaryMonoSupported() override { return FALSE; }
+    HRESULT STDMETHODCALLTYPE GetRestrictToOutput(IDXGIOutput** output) override {
+        if (output) *output = nullptr;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE SetBackgroundColor(const DXGI_RGBA*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE GetBackgroundColor(DXGI_RGBA* color) override {
+        if (color) *color = {};
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE SetRotation(DXGI_MODE_ROTATION rotation) override {
+        return rotation == DXGI_MODE_ROTATION_IDENTITY ? S_OK : DXGI_ERROR_INVALID_CALL;
+    }
+    HRESULT STDMETHODCALLTYPE GetRotation(DXGI_MODE_ROTATION* rotation) override {
+        if (rotation) *rotation = DXGI_MODE_ROTATION_IDENTITY;
+        return S_OK;
+    }
+
+    // ============== IDXGISwapChain2 ==============
+    HRESULT STDMETHODCALLTYPE SetSourceSize(UINT, UINT) override { return DXGI_ERROR_INVALID_CALL; }
+    HRESULT STDMETHODCALLTYPE GetSourceSize(UINT* width, UINT* height) override {
+        if (width) *width = m_desc.Width;
+        if (height) *height = m_desc.Height;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE SetMaximumFrameLatency(UINT) override { return DXGI_ERROR_INVALID_CALL; }
+    HRESULT STDMETHODCALLTYPE GetMaximumFrameLatency(UINT* latency) override {
+        if (latency) *latency = OffscreenFramesInFlight();
+        return S_OK;
+    }
+    HANDLE STDMETHODCALLTYPE GetFrameLatencyWaitableObject() override { return nullptr; }
+    HRESULT STDMETHODCALLTYPE SetMatrixTransform(const DXGI_MATRIX_3X2_F*) override { return DXGI_ERROR_INVALID_CALL; }
+    HRESULT STDMETHODCALLTYPE GetMatrixTransform(DXGI_MATRIX_3X2_F*) override { return DXGI_ERROR_INVALID_CALL; }
+
+    // ============== IDXGISwapChain3 / 4 ==============
+    UINT STDMETHODCALLTYPE GetCurrentBackBufferIndex() override { return m_dev11 ? 0 : m_index; }
+    HRESULT STDMETHODCALLTYPE CheckColorSpaceSupport(DXGI_COLOR_SPACE_TYPE colorSpace, UINT* support) override {
+        if (!support) return E_INVALIDARG;
+        *support = colorSpace == DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709 ? DXGI_SWAP_CHAIN_COLOR_SPACE_SUPPORT_FLAG_PRESENT : 0;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE SetColorSpace1(DXGI_COLOR_SPACE_TYPE colorSpace) override {
+        return colorSpace == DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709 ? S_OK : DXGI_ERROR_UNSUPPORTED;
+    }
+    HRESULT STDMETHODCALLTYPE ResizeBuffers1(UINT count, UINT width, UINT height, DXGI_FORMAT format, UINT flags,
+                                             const UINT*, IUnknown* const*) override {
+        return ResizeBuffers(count, width, height, format, flags);
+    }
+    HRESULT STDMETHODCALLTYPE SetHDRMetaData(DXGI_HDR_METADATA_TYPE, UINT, void*) override { return S_OK; }
+
+private:
+    ~OffscreenSwapChain() {
+        if (m_queue12 && m_fence12 && m_presentCount) {
+            // Like a real swap chain, don't free buffers the GPU may still write
+            m_queue12->Signal(m_fence12, ++m_presentCount);
+            WaitFence12(m_presentCount);
+        }
+        ReleaseBuffers();
+        for (UINT i = 0; i < MAX_FRAME_LATENCY; i++) if (m_query11[i]) m_query11[i]->Release();
+        if (m_fenceEvent) CloseHandle(m_fenceEvent);
+        if (m_fence12) m_fence12->Release();
+        if (m_ctx11) m_ctx11->Release();
+        if (m_dev11) m_dev11->Release();
+        if (m_dev12) m_dev12->Release();
+        if (m_queue12) m_queue12->Release();
+        m_device->Release();
+    }
+
+    void ReleaseBuffers() {
+        for (UINT i = 0; i < OFFSCREEN_MAX_BUFFERS; i++) {
+            if (m_buffers12[i]) { m_buffers12[i]->Release(); m_buffers12[i] = nullptr; }
+        }
+        if (m_tex11) { m_tex11->Release(); m_tex11 = nullptr; }
+    }
+
+    HRESULT CreateBuffers() {
+        ReleaseBuffers();
+        m_bufferCount = max(1u, min(m_desc.BufferCount, (UINT)OFFSCREEN_MAX_BUFFERS));
+        m_index = 0;
+        bool uav = (m_desc.BufferUsage & DXGI_USAGE_UNORDERED_ACCESS) != 0;
+        HRESULT hr = E_FAIL;
+        if (m_dev12) {
+            D3D12_HEAP_PROPERTIES heap = { D3D12_HEAP_TYPE_DEFAULT };
+            D3D12_RESOURCE_DESC rd = {};
+            rd.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            rd.Width = m_desc.Width;
+            rd.Height = m_desc.Height;
+            rd.DepthOrArraySize = 1;
+            rd.MipLevels = 1;
+            rd.Format = m_desc.Format;
+            rd.SampleDesc.Count = 1;
+            rd.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+            if (uav) rd.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+            for (UINT i = 0; i < m_bufferCount; i++) {
+                // PRESENT == COMMON: the renderers' PRESENT -> RENDER_TARGET barriers apply unchanged
+                hr = m_dev12->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_PRESENT,
+                                                      nullptr, IID_PPV_ARGS(&m_buffers12[i]));
+                if (FAILED(hr)) { LogHR("Offscreen back buffer", hr); return hr; }
+                wchar_t name[48];
+                swprintf_s(name, L"Offscreen back buffer %u", i);
+                m_buffers12[i]->SetName(name);
+            }
+        } else if (m_dev11) {
+            D3D11_TEXTURE2D_DESC td = {};
+            td.Width = m_desc.Width;
+            td.Height = m_desc.Height;
+            td.MipLevels = 1;
+            td.ArraySize = 1;
+            td.Format = m_desc.Format;
+            td.SampleDesc.Count = 1;
+            td.Usage = D3D11_USAGE_DEFAULT;
+            td.BindFlags = D3D11_BIND_RENDER_TARGET;
+            if (uav) td.BindFlags |= D3D11_BIND_UNORDERED_ACCESS;
+            if (m_desc.BufferUsage & DXGI_USAGE_SHADER_INPUT) td.BindFlags |= D3D11_BIND_SHADER_RESOURCE;
+            hr = m_dev11->CreateTexture2D(&td, nullptr, &m_tex11);
+            if (FAILED(hr)) { LogHR("Offscreen back buffer", hr); return hr; }
+        }
+        Log("[INFO] Offscreen: %u x %u back buffer ring of %u (format %u), no presents\n",
+            m_desc.Width, m_desc.Height, m_dev11 ? 1u : m_bufferCount, (UINT)m_desc.Format);
+        return hr;
+    }
+
+    void WaitFence12(UINT64 value) {
+        if (m_fence12->GetCompletedValue() >= value) return;
+        m_fence12->SetEventOnCompletion(value, m_fenceEvent);
+        // 1 s timeout so device removal can't hang the loop
+        WaitForSingleObject(m_fenceEvent, 1000);
+    }
+
+    static LONGLONG NowQpc() {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return now.QuadPart;
+    }
+
+    // Frame (count - N) must be done before the next one starts; the newest
+    // completed frame is the "displayed" event of the latency measurement
+    void PaceD3D12() {
+        UINT depth = OffscreenFramesInFlight();
+        if (m_presentCount > depth) WaitFence12(m_presentCount - depth);
+        UINT64 done = m_fence12->GetCompletedValue();
+        if (done > m_completed) {
+            m_completed = done;
+            LatencyFrameDisplayed(done, NowQpc(), LATENCY_SOURCE_FENCE);
+        }
+    }
+
+    void PaceD3D11() {
+        UINT depth = OffscreenFramesInFlight();
+        UINT slot = (UINT)(m_presentCount % depth);
+        if (m_queryId[slot]) {
+            // GetData flushes the context; spin like the DXGI present queue would block
+            LONGLONG start = NowQpc();
+            LARGE_INTEGER freq;
+            QueryPerformanceFrequency(&freq);
+            while (m_ctx11->GetData(m_query11[slot], nullptr, 0, 0) == S_FALSE && NowQpc() - start < freq.QuadPart) SwitchToThread();
+            LatencyFrameDisplayed(m_queryId[slot], NowQpc(), LATENCY_SOURCE_FENCE);
+        }
+        m_ctx11->End(m_query11[slot]);
+        m_ctx11->Flush();
+        m_queryId[slot] = m_presentCount;
+    }
+
+    volatile LONG m_refs = 1;
+    IUnknown* m_device = nullptr;
+    HWND m_hwnd = nullptr;
+    DXGI_SWAP_CHAIN_DESC1 m_desc = {};
+    UINT m_bufferCount = 0;
+    UINT m_index = 0;
+    UINT64 m_presentCount = 0;
+
+    // D3D12
+    ID3D12CommandQueue* m_queue12 = nullptr;
+    ID3D12Device* m_dev12 = nullptr;
+    ID3D12Resource* m_buffers12[OFFSCREEN_MAX_BUFFERS] = {};
+    ID3D12Fence* m_fence12 = nullptr;
+    HANDLE m_fenceEvent = nullptr;
+    UINT64 m_completed = 0;
+
+    // D3D11
+    ID3D11Device* m_dev11 = nullptr;
+    ID3D11DeviceContext* m_ctx11 = nullptr;
+    ID3D11Texture2D* m_tex11 = nullptr;
+    ID3D11Query* m_query11[MAX_FRAME_LATENCY] = {};
+    UINT64 m_queryId[MAX_FRAME_LATENCY] = {};
+};
+
+HRESULT DxgiCreateSwapChain(IDXGIFactory2* factory, IUnknown* device, HWND hwnd,
+                            const DXGI_SWAP_CHAIN_DESC1& desc, IDXGISwapChain1** swap) {
+    if (!swap) return E_POINTER;
+    *swap = nullptr;
+    if (!g_offscreen) return factory->CreateSwapChainForHwnd(device, hwnd, &desc, nullptr, nullptr, swap);
+
+    OffscreenSwapChain* offscreen = new OffscreenSwapChain(device, hwnd, desc);
+    if (!offscreen->Init()) {
+        offscreen->Release();
+        Log("[ERROR] Offscreen: back buffer ring creation failed\n");
+        return E_FAIL;
+    }
+    *swap = offscreen;
+    return S_OK;
+}
@@ -0,0 +1,44 @@
+#pragma once
+// ============== OFFSCREEN RENDERING ==============
+// --offscreen: every backend renders into its own ring of render targets and
+// nothing is ever presented, so the frame rate is the GPU / CPU throughput
+// without compositor, flip queue or present mode effects (and runs on
+// machines without a display). The main window is still created - DXGI,
+// WGL and VkSurfaceKHR hang off it - but stays hidden.
+//
+// - D3D11 / D3D12: DxgiCreateSwapChain hands out an in-process
+//   IDXGISwapChain4 whose GetBuffer / ResizeBuffers / Present /
+//   GetCurrentBackBufferIndex work on textures it created itself, so the
+//   renderers keep their swap chain code. Present rotates the back buffer
+//   index and paces on a fence (D3D12) or event queries (D3D11).
+// - Vulkan: the vk_present.h swapchain wrappers return a plain image ring;
+//   acquire and present become empty submits that signal / consume the
+//   renderer's semaphores.
+// - OpenGL: gl_present.h binds a framebuffer object over the default
+//   framebuffer and skips SwapBuffers; frames are paced by ARB_sync fences.
+//
+// The CPU runs at most OffscreenFramesInFlight() frames ahead of the GPU
+// (--max-latency=N, default MAX_FRAME_LATENCY); the latency measurement
+// reports CPU frame start -> GPU done (source "GPU fence").
+
+#include "common.h"
+#include "frame_latency.h"
+
+extern bool g_offscreen;
+
+UINT OffscreenFramesInFlight();
+
+// The renderer's presents go through one of the wrappers above (DXGI,
+// vk_present.h, gl_present.h); a new backend stays unsupported until it does
+bool OffscreenSupported(RendererType renderer);
+
+// vkQueueSubmit calls the Vulkan image ring adds per frame (acquire signal +
+// present consume, each a batch without command buffers); 0 for the other
+// backends. Written to the report: on drivers with a costly submit path they
+// are part of the measured CPU frame time.
+UINT OffscreenEmptySubmitsPerFrame(RendererType renderer);
+
+// CreateSwapChainForHwnd, or with --offscreen the in-process swap chain.
+// device: ID3D12CommandQueue (D3D12) or ID3D11Device (D3D11), as for DXGI.
+HRESULT DxgiCreateSwapChain(IDXGIFactory2* factory, IUnknown* device, HWND hwnd,
+                            const DXGI_SWAP_CHAIN_DESC1& desc, IDXGISwapChain1** swap);
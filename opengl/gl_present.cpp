@@ -0,0 +1,278 @@
+// ============== OPENGL PRESENT PACING ==============
+// See gl_present.h. Present ids start at 1; the fence of id p lives in slot
+// p % N (N = --max-latency), so frame p + 1 waits on the fence of id p + 1 - N.
+// With --offscreen N is OffscreenFramesInFlight() and the frame renders into an
+// FBO that stays bound over the default framebuffer.
+
+#include <Windows.h>
+#include <GL/gl.h>
+
+#include "../common.h"
+#include "../benchmark.h"
+#include "../offscreen.h"
+#include "gl_present.h"
+#include <cstring>
+
+// ============== ARB_SYNC / WGL DECLARATIONS ==============
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+typedef unsigned long long GLuint64;
+typedef struct __GLsync* GLsync;
+#define GL_SYNC_GPU_COMMANDS_COMPLETE       0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT          0x00000001
+#define GL_TIMEOUT_EXPIRED                  0x911B
+#define GL_WAIT_FAILED                      0x911D
+#endif
+typedef GLsync (APIENTRY* PFNGLFENCESYNC)(GLenum condition, GLbitfield flags);
+typedef GLenum (APIENTRY* PFNGLCLIENTWAITSYNC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void (APIENTRY* PFNGLDELETESYNC)(GLsync sync);
+typedef BOOL (WINAPI* PFNWGLSWAPINTERVALEXT)(int interval);
+typedef int (WINAPI* PFNWGLGETSWAPINTERVALEXT)(void);
+typedef const char* (WINAPI* PFNWGLGETEXTENSIONSSTRINGARB)(HDC hdc);
+
+// ============== FRAMEBUFFER OBJECT DECLARATIONS ==============
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER                      0x8D40
+#define GL_RENDERBUFFER                     0x8D41
+#define GL_COLOR_ATTACHMENT0                0x8CE0
+#define GL_DEPTH_STENCIL_ATTACHMENT         0x821A
+#define GL_DEPTH24_STENCIL8                 0x88F0
+#define GL_FRAMEBUFFER_COMPLETE             0x8CD5
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8                            0x8058
+#endif
+typedef void (APIENTRY* PFNGLGENFRAMEBUFFERS)(GLsizei n, GLuint* framebuffers);
+typedef void (APIENTRY* PFNGLDELETEFRAMEBUFFERS)(GLsizei n, const GLuint* framebuffers);
+typedef void (APIENTRY* PFNGLBINDFRAMEBUFFER)(GLenum target, GLuint framebuffer);
+typedef GLenum (APIENTRY* PFNGLCHECKFRAMEBUFFERSTATUS)(GLenum target);
+typedef void (APIENTRY* PFNGLGENRENDERBUFFERS)(GLsizei n, GLuint* renderbuffers);
+typedef void (APIENTRY* PFNGLDELETERENDERBUFFERS)(GLsizei n, const GLuint* renderbuffers);
+typedef void (APIENTRY* PFNGLBINDRENDERBUFFER)(GLenum target, GLuint renderbuffer);
+typedef void (APIENTRY* PFNGLRENDERBUFFERSTORAGE)(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+typedef void (APIENTRY* PFNGLFRAMEBUFFERRENDERBUFFER)(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+
+// ============== PACING GLOBALS ==============
+static PFNGLFENCESYNC s_glFenceSync = nullptr;
+static PFNGLCLIENTWAITSYNC s_glClientWaitSync = nullptr;
+static PFNGLDELETESYNC s_glDeleteSync = nullptr;
+static GLsync s_fence[MAX_FRAME_LATENCY] = {};
+static UINT64 s_fenceId[MAX_FRAME_LATENCY] = {};
+static UINT64 s_presentCount = 0;            // Id of the last SwapBuffers
+static bool s_pacing = false;                // --max-latency and ARB_sync available
+static int s_swapInterval = 0;
+static bool s_swapIntervalSet = false;
+static UINT s_depth = 0;                     // Frames in flight: --max-latency or the offscreen default
+
+// --offscreen target: color + depth/stencil renderbuffers at W x H
+static PFNGLGENFRAMEBUFFERS s_glGenFramebuffers = nullptr;
+static PFNGLDELETEFRAMEBUFFERS s_glDeleteFramebuffers = nullptr;
+static PFNGLBINDFRAMEBUFFER s_glBindFramebuffer = nullptr;
+static PFNGLCHECKFRAMEBUFFERSTATUS s_glCheckFramebufferStatus = nullptr;
+static PFNGLGENRENDERBUFFERS s_glGenRenderbuffers = nullptr;
+static PFNGLDELETERENDERBUFFERS s_glDeleteRenderbuffers = nullptr;
+static PFNGLBINDRENDERBUFFER s_glBindRenderbuffer = nullptr;
+static PFNGLRENDERBUFFERSTORAGE s_glRenderbufferStorage = nullptr;
+static PFNGLFRAMEBUFFERRENDERBUFFER s_glFramebufferRenderbuffer = nullptr;
+static GLuint s_fbo = 0;
+static GLuint s_colorRb = 0;
+static GLuint s_depthRb = 0;
+
+// Fence wait, averaged over one-second windows for the overlay
+static double s_waitSumMs = 0.0;
+static UINT s_waitFrames = 0;
+static double s_waitDisplayMs = 0.0;
+static LONGLONG s_waitWindowStart = 0;
+static LARGE_INTEGER s_qpcFreq = {};
+
+static LONGLONG PacingNowQpc() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static void DeleteFences() {
+    for (UINT i = 0; i < MAX_FRAME_LATENCY; i++) {
+        if (s_fence[i] && s_glDeleteSync) s_glDeleteSync(s_fence[i]);
+        s_fence[i] = nullptr;
+        s_fenceId[i] = 0;
+    }
+}
+
+static void DeleteOffscreenTarget() {
+    if (s_glBindFramebuffer && s_fbo) s_glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (s_glDeleteFramebuffers && s_fbo) s_glDeleteFramebuffers(1, &s_fbo);
+    if (s_glDeleteRenderbuffers && s_colorRb) s_glDeleteRenderbuffers(1, &s_colorRb);
+    if (s_glDeleteRenderbuffers && s_depthRb) s_glDeleteRenderbuffers(1, &s_depthRb);
+    s_fbo = s_colorRb = s_depthRb = 0;
+}
+
+// Renderbuffer storage at the current W x H; the FBO is left bound
+static bool AllocOffscreenTarget(const char* tag) {
+    s_glBindRenderbuffer(GL_RENDERBUFFER, s_colorRb);
+    s_glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, (GLsizei)W, (GLsizei)H);
+    s_glBindRenderbuffer(GL_RENDERBUFFER, s_depthRb);
+    s_glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, (GLsizei)W, (GLsizei)H);
+    s_glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    s_glBindFramebuffer(GL_FRAMEBUFFER, s_fbo);
+    s_glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, s_colorRb);
+    s_glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, s_depthRb);
+    GLenum status = s_glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Log("[ERROR] %s: offscreen framebuffer incomplete (0x%04X)\n", tag, status);
+        return false;
+    }
+    return true;
+}
+
+static bool CreateOffscreenTarget(const char* tag) {
+    s_glGenFramebuffers = (PFNGLGENFRAMEBUFFERS)wglGetProcAddress("glGenFramebuffers");
+    s_glDeleteFramebuffers = (PFNGLDELETEFRAMEBUFFERS)wglGetProcAddress("glDeleteFramebuffers");
+    s_glBindFramebuffer = (PFNGLBINDFRAMEBUFFER)wglGetProcAddress("glBindFramebuffer");
+    s_glCheckFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUS)wglGetProcAddress("glCheckFramebufferStatus");
+    s_glGenRenderbuffers = (PFNGLGENRENDERBUFFERS)wglGetProcAddress("glGenRenderbuffers");
+    s_glDeleteRenderbuffers = (PFNGLDELETERENDERBUFFERS)wglGetProcAddress("glDeleteRenderbuffers");
+    s_glBindRenderbuffer = (PFNGLBINDRENDERBUFFER)wglGetProcAddress("glBindRenderbuffer");
+    s_glRenderbufferStorage = (PFNGLRENDERBUFFERSTORAGE)wglGetProcAddress("glRenderbufferStorage");
+    s_glFramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFER)wglGetProcAddress("glFramebufferRenderbuffer");
+    if (!s_glGenFramebuffers || !s_glDeleteFramebuffers || !s_glBindFramebuffer || !s_glCheckFramebufferStatus ||
+        !s_glGenRenderbuffers || !s_glDeleteRenderbuffers || !s_glBindRenderbuffer ||
+        !s_glRenderbufferStorage || !s_glFramebufferRenderbuffer) {
+        Log("[WARN] %s: framebuffer objects not supported, rendering to the hidden window\n", tag);
+        return false;
+    }
+    s_glGenFramebuffers(1, &s_fbo);
+    s_glGenRenderbuffers(1, &s_colorRb);
+    s_glGenRenderbuffers(1, &s_depthRb);
+    if (!AllocOffscreenTarget(tag)) {
+        DeleteOffscreenTarget();
+        return false;
+    }
+    Log("[INFO] %s: offscreen framebuffer %u x %u, no SwapBuffers\n", tag, W, H);
+    return true;
+}
+
+// ============== PUBLIC API ==============
+void GLPresentInit(HDC hdc, const char* tag) {
+    DeleteFences();
+    DeleteOffscreenTarget();
+    s_presentCount = 0;
+    s_waitSumMs = 0.0;
+    s_waitFrames = 0;
+    s_waitDisplayMs = 0.0;
+    QueryPerformanceFrequency(&s_qpcFreq);
+    s_waitWindowStart = PacingNowQpc();
+
+    // Swap interval from --present-mode
+    s_swapIntervalSet = false;
+    PFNWGLSWAPINTERVALEXT wglSwapIntervalEXTPtr = (PFNWGLSWAPINTERVALEXT)wglGetProcAddress("wglSwapIntervalEXT");
+    PFNWGLGETSWAPINTERVALEXT wglGetSwapIntervalEXTPtr = (PFNWGLGETSWAPINTERVALEXT)wglGetProcAddress("wglGetSwapIntervalEXT");
+    if (g_presentMode != PRESENT_MODE_DEFAULT && !g_offscreen) {
+        PFNWGLGETEXTENSIONSSTRINGARB wglGetExtensionsStringARBPtr =
+            (PFNWGLGETEXTENSIONSSTRINGARB)wglGetProcAddress("wglGetExtensionsStringARB");
+        const char* wglExts = wglGetExtensionsStringARBPtr ? wglGetExtensionsStringARBPtr(hdc) : nullptr;
+        bool tearSupported = wglExts && strstr(wglExts, "WGL_EXT_swap_control_tear");
+
+        int interval = 0;
+        switch (g_presentMode) {
+        case PRESENT_MODE_FIFO: interval = 1; break;
+        case PRESENT_MODE_ADAPTIVE:
+            interval = tearSupported ? -1 : 1;
+            if (!tearSupported) Log("[WARN] %s: WGL_EXT_swap_control_tear not supported, adaptive -> fifo\n", tag);
+            break;
+        case PRESENT_MODE_MAILBOX:
+            Log("[WARN] %s: WGL has no mailbox mode, using immediate\n", tag);
+            break;
+        default: break;
+        }
+        if (wglSwapIntervalEXTPtr && wglSwapIntervalEXTPtr(interval)) {
+            s_swapInterval = interval;
+            s_swapIntervalSet = true;
+        } else {
+            Log("[WARN] %s: wglSwapIntervalEXT unavailable or failed, --present-mode ignored\n", tag);
+        }
+    }
+    if (!s_swapIntervalSet && wglGetSwapIntervalEXTPtr) s_swapInterval = wglGetSwapIntervalEXTPtr();
+    Log("[INFO] %s: swap interval %d%s\n", tag, s_swapInterval, s_swapIntervalSet ? "" : " (driver default)");
+
+    // Fence pacing for --max-latency (GL 3.2 / ARB_sync)
+    s_glFenceSync = (PFNGLFENCESYNC)wglGetProcAddress("glFenceSync");
+    s_glClientWaitSync = (PFNGLCLIENTWAITSYNC)wglGetProcAddress("glClientWaitSync");
+    s_glDeleteSync = (PFNGLDELETESYNC)wglGetProcAddress("glDeleteSync");
+    bool syncSupported = s_glFenceSync && s_glClientWaitSync && s_glDeleteSync;
+    // Offscreen there is no swap to throttle on, so the fence bound is always on
+    s_depth = g_offscreen ? OffscreenFramesInFlight() : g_maxFrameLatency;
+    s_pacing = s_depth && syncSupported;
+    if (s_depth && !syncSupported)
+        Log("[WARN] %s: ARB_sync not supported, %s\n", tag,
+            g_offscreen ? "offscreen frames are unpaced" : "--max-latency ignored");
+    else if (s_pacing)
+        Log("[INFO] %s: fence pacing, max %u frames in flight\n", tag, s_depth);
+
+    if (g_offscreen) CreateOffscreenTarget(tag);
+}
+
+void GLPresentResize() {
+    if (s_fbo && !AllocOffscreenTarget("OpenGL resize")) DeleteOffscreenTarget();
+}
+
+void GLPresentShutdown() {
+    DeleteFences();
+    DeleteOffscreenTarget();
+    s_pacing = false;
+    s_glFenceSync = nullptr;
+    s_glClientWaitSync = nullptr;
+    s_glDeleteSync = nullptr;
+}
+
+void GLWaitFrameLatency() {
+    if (s_pacing) {
+        UINT slot = (UINT)((s_presentCount + 1) % s_depth);
+        if (s_fence[slot]) {
+            LONGLONG start = PacingNowQpc();
+            // 1 s timeout so a lost present (device removal) can't hang the loop
+            GLenum r = s_glClientWaitSync(s_fence[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            LONGLONG end = PacingNowQpc();
+            if (r == GL_WAIT_FAILED) Log("[WARN] glClientWaitSync failed for frame %llu\n", s_fenceId[slot]);
+            else if (r != GL_TIMEOUT_EXPIRED) LatencyFrameDisplayed(s_fenceId[slot], end, LATENCY_SOURCE_FENCE);
+            s_glDeleteSync(s_fence[slot]);
+            s_fence[slot] = nullptr;
+
+            double ms = (double)(end - start) * 1000.0 / s_qpcFreq.QuadPart;
+            BenchmarkPacingWaitSample(ms);
+            s_waitSumMs += ms;
+            s_waitFrames++;
+        }
+        LONGLONG now = PacingNowQpc();
+        if (now - s_waitWindowStart >= s_qpcFreq.QuadPart && s_waitFrames) {
+            s_waitDisplayMs = s_waitSumMs / s_waitFrames;
+            s_waitSumMs = 0.0;
+            s_waitFrames = 0;
+            s_waitWindowStart = now;
+        }
+    }
+    LatencyFrameBegin();
+}
+
+bool GLPresent(HDC hdc) {
+    BOOL ok = s_fbo ? TRUE : SwapBuffers(hdc);
+    s_presentCount++;
+    LatencyFrameSubmitted(s_presentCount);
+    if (s_pacing) {
+        // The slot was retired by GLWaitFrameLatency at the start of this frame
+        UINT slot = (UINT)(s_presentCount % s_depth);
+        if (s_fence[slot]) s_glDeleteSync(s_fence[slot]);
+        s_fence[slot] = s_glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s_fenceId[slot] = s_presentCount;
+    }
+    return ok != FALSE;
+}
+
+void GLPacingFormat(char* buf, size_t size) {
+    if (!buf || size == 0) return;
+    buf[0] = 0;
+    if (s_pacing)
+        _snprintf_s(buf, size, _TRUNCATE, "Pacing: max %u in flight, wait %.2f ms/frame, interval %d",
+            s_depth, s_waitDisplayMs, s_swapInterval);
+    else if (s_swapIntervalSet)
+        _snprintf_s(buf, size, _TRUNCATE, "Pacing: driver queue, interval %d", s_swapInterval);
+}
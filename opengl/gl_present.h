@@ -0,0 +1,38 @@
+#pragma once
+// ============== OPENGL PRESENT PACING ==============
+// Shared by the legacy and --gl-core OpenGL paths. SwapBuffers alone leaves
+// the CPU run-ahead to the driver's queueing policy; here every swap is
+// followed by a glFenceSync, and with --max-latency=N the next frame starts
+// only after the fence of frame (id - N) signaled, so at most N frames are in
+// flight - the same bound the DXGI waitable object and VK_KHR_present_wait
+// give the other APIs. The fence signal is also the "displayed" event for the
+// latency measurement (frame_latency.h, source "GPU fence").
+//
+// --present-mode sets the swap interval (WGL_EXT_swap_control): immediate /
+// mailbox -> 0, fifo -> 1, adaptive -> -1 (WGL_EXT_swap_control_tear, tears
+// only when a frame misses vblank). Without --present-mode the driver's
+// setting is left alone.
+//
+// --offscreen (offscreen.h): frames render into an FBO bound over the default
+// framebuffer, SwapBuffers is skipped and the fence bound is always on
+// (OffscreenFramesInFlight()).
+
+#include <Windows.h>
+#include "../frame_latency.h"
+
+// After the final context is current: swap interval, ARB_sync entry points
+void GLPresentInit(HDC hdc, const char* tag);
+void GLPresentShutdown();
+
+// After W / H changed: reallocates the --offscreen FBO storage (no-op otherwise)
+void GLPresentResize();
+
+// Start of frame: fence wait for --max-latency (timed) + LatencyFrameBegin
+void GLWaitFrameLatency();
+
+// SwapBuffers + the frame's fence; returns false if SwapBuffers failed
+bool GLPresent(HDC hdc);
+
+// Overlay line, e.g. "Pacing: max 2 in flight, wait 3.41 ms/frame, interval 0";
+// empty without --max-latency or --present-mode
+void GLPacingFormat(char* buf, size_t size);
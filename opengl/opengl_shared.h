@@ -0,0 +1,24 @@
+#pragma once
+// ============== OPENGL SHARED ==============
+// Between the legacy path (renderer_opengl.cpp: context, fixed function,
+// display lists) and the --gl-core path (renderer_opengl_core.cpp)
+
+#include <Windows.h>
+
+// Logs and returns false if glGetError reports an error (renderer_opengl.cpp)
+bool CheckGLError(const char* operation);
+
+// GPU pass timers, "Scene" = pass 0, "Text" = pass 1 (renderer_opengl.cpp)
+void CollectGLTimers();
+void BeginGLTimer(int pass);
+void EndGLTimer(int pass);
+
+// --gl-core: 4.5 core context and scene (renderer_opengl_core.cpp)
+// CreateCoreContextGL needs a current legacy context (for wglGetProcAddress)
+// and returns nullptr if the driver has no 4.5 core profile; the caller makes
+// the new context current before InitOpenGLCore.
+HGLRC CreateCoreContextGL(HDC hdc);
+bool InitOpenGLCore(HDC hdc);
+void RenderOpenGLCore();
+bool ResizeOpenGLCore();
+void CleanupOpenGLCore();
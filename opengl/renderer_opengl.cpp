@@ -11,9 +11,32 @@
 #pragma comment(lib, "glu32.lib")
 
 #include "../common.h"
+#include "../gpu_profiler.h"
+#include "../mesh_file.h"
+#include "../cube_geometry.h"
+#include "../text_overlay.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "opengl_shared.h"
+#include "gl_present.h"
 #include <vector>
 #include <cstring>
 
+// ============== GL TIMER QUERY (GL 3.3 / ARB_timer_query) ==============
+// Not in the 1.1 headers shipped with Windows - loaded via wglGetProcAddress
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED             0x88BF
+#define GL_QUERY_RESULT             0x8866
+#define GL_QUERY_RESULT_AVAILABLE   0x8867
+typedef unsigned long long GLuint64;
+#endif
+typedef void (APIENTRY* PFNGLGENQUERIES)(GLsizei n, GLuint* ids);
+typedef void (APIENTRY* PFNGLDELETEQUERIES)(GLsizei n, const GLuint* ids);
+typedef void (APIENTRY* PFNGLBEGINQUERY)(GLenum target, GLuint id);
+typedef void (APIENTRY* PFNGLENDQUERY)(GLenum target);
+typedef void (APIENTRY* PFNGLGETQUERYOBJECTIV)(GLuint id, GLenum pname, GLint* params);
+typedef void (APIENTRY* PFNGLGETQUERYOBJECTUI64V)(GLuint id, GLenum pname, GLuint64* params);
+
 // ============== EXTERN DECLARATIONS ==============
 // Shared globals from main module (most are in common.h)
 // g_hMainWnd is declared in common.h
@@ -22,164 +45,36 @@
 static HDC g_glHDC = nullptr;
 static HGLRC g_glRC = nullptr;
 static GLuint g_glFontBase = 0;
+static GLuint g_glTextList = 0;        // Compiled overlay, rebuilt only when the text changes
+static TextOverlay g_glOverlay;        // Change detection for g_glTextList
 static GLuint g_glCubeLists[8] = {0};  // Display lists for 8 cubes
 static int g_glTriangleCount = 0;
 
-// ============== OPENGL VERTEX STRUCTURE ==============
-// OpenGL vertex structure matching D3D11
-struct GLVert {
-    float px, py, pz;
-    float nx, ny, nz;
-};
-
-// ============== GEOMETRY GENERATION ==============
-
-// Generate rounded face - port of D3D11's GenRoundedFace
-void GenRoundedFaceGL(float size, int seg, float offX, float offY, float offZ, int faceIdx,
-    float edgeRadius[4], std::vector<GLVert>& verts, std::vector<unsigned int>& inds)
-{
-    unsigned int base = (unsigned int)verts.size();
-    float h = size / 2;
-
-    // Face normals, U and V directions for each face
-    float faceN[6][3] = {{0,0,1},{0,0,-1},{1,0,0},{-1,0,0},{0,1,0},{0,-1,0}};
-    float faceU[6][3] = {{-1,0,0},{1,0,0},{0,0,1},{0,0,-1},{1,0,0},{1,0,0}};
-    float faceV[6][3] = {{0,1,0},{0,1,0},{0,1,0},{0,1,0},{0,0,1},{0,0,-1}};
-
-    float fnx = faceN[faceIdx][0], fny = faceN[faceIdx][1], fnz = faceN[faceIdx][2];
-    float fux = faceU[faceIdx][0], fuy = faceU[faceIdx][1], fuz = faceU[faceIdx][2];
-    float fvx = faceV[faceIdx][0], fvy = faceV[faceIdx][1], fvz = faceV[faceIdx][2];
-
-    for (int j = 0; j <= seg; j++) {
-        for (int i = 0; i <= seg; i++) {
-            float u = (float)i / seg * 2 - 1;
-            float vv = (float)j / seg * 2 - 1;
-
-            float px = u * h, py = vv * h;
-            float pz = h;
-            float nx = 0, ny = 0, nz = 1;
-
-            float rU_raw = (u > 0) ? edgeRadius[0] : edgeRadius[1];
-            float rV_raw = (vv > 0) ? edgeRadius[2] : edgeRadius[3];
-            float rU = fabsf(rU_raw), rV = fabsf(rV_raw);
-            bool outerU = (rU_raw > 0), outerV = (rV_raw > 0);
-
-            if (rU > 0 || rV > 0) {
-                float innerU = h - rU, innerV = h - rV;
-                float dx = (rU > 0) ? fmaxf(0, fabsf(px) - innerU) : 0;
-                float dy = (rV > 0) ? fmaxf(0, fabsf(py) - innerV) : 0;
-
-                if (dx > 0 || dy > 0) {
-                    bool isCorner = (dx > 0 && dy > 0);
-                    bool sphericalCorner = isCorner && (outerU || outerV);
-
-                    if (sphericalCorner) {
-                        float r = fmaxf(rU, rV);
-                        float dist = sqrtf(dx*dx + dy*dy);
-                        if (dist > r) { dx = dx * r / dist; dy = dy * r / dist; }
-                        float curveZ = sqrtf(fmaxf(0, r*r - dx*dx - dy*dy));
-                        pz = (h - r) + curveZ;
-                        px = (u > 0 ? 1 : -1) * (innerU + dx);
-                        py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                        nx = (u > 0 ? 1 : -1) * dx / r;
-                        ny = (vv > 0 ? 1 : -1) * dy / r;
-                        nz = curveZ / r;
-                    } else if (isCorner) {
-                        if (dx >= dy) {
-                            float curveZ = sqrtf(fmaxf(0, rU*rU - dx*dx));
-                            pz = (h - rU) + curveZ;
-                            px = (u > 0 ? 1 : -1) * (innerU + dx);
-                            nx = (u > 0 ? 1 : -1) * dx / rU;
-                            nz = curveZ / rU;
-                        } else {
-                            float curveZ = sqrtf(fmaxf(0, rV*rV - dy*dy));
-                            pz = (h - rV) + curveZ;
-                            py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                            ny = (vv > 0 ? 1 : -1) * dy / rV;
-                            nz = curveZ / rV;
-                        }
-                    } else {
-                        float r = (dx > 0) ? rU : rV;
-                        float d = (dx > 0) ? dx : dy;
-                        float curveZ = sqrtf(fmaxf(0, r*r - d*d));
-                        pz = (h - r) + curveZ;
-                        if (dx > 0) { px = (u > 0 ? 1 : -1) * (innerU + dx); nx = (u > 0 ? 1 : -1) * dx / r; }
-                        else { py = (vv > 0 ? 1 : -1) * (innerV + dy); ny = (vv > 0 ? 1 : -1) * dy / r; }
-                        nz = curveZ / r;
-                    }
-                }
-            }
-
-            GLVert vert;
-            vert.px = offX + px*fux + py*fvx + pz*fnx;
-            vert.py = offY + px*fuy + py*fvy + pz*fny;
-            vert.pz = offZ + px*fuz + py*fvz + pz*fnz;
-
-            float nnx = nx*fux + ny*fvx + nz*fnx;
-            float nny = nx*fuy + ny*fvy + nz*fny;
-            float nnz = nx*fuz + ny*fvz + nz*fnz;
-            float len = sqrtf(nnx*nnx + nny*nny + nnz*nnz);
-            if (len < 0.001f) len = 1;
-            vert.nx = nnx/len;
-            vert.ny = nny/len;
-            vert.nz = nnz/len;
-            verts.push_back(vert);
-        }
-    }
-
-    for (int j = 0; j < seg; j++) {
-        for (int i = 0; i < seg; i++) {
-            unsigned int idx = base + j * (seg + 1) + i;
-            inds.push_back(idx); inds.push_back(idx + seg + 1); inds.push_back(idx + 1);
-            inds.push_back(idx + 1); inds.push_back(idx + seg + 1); inds.push_back(idx + seg + 2);
-        }
-    }
-}
-
-// Build all geometry for one cube (matching D3D11's BuildAllGeometry for single cube)
-void BuildCubeGeometryGL(int cubeID, std::vector<GLVert>& verts, std::vector<unsigned int>& inds)
-{
-    float cubeSize = 0.95f;
-    float outerR = 0.12f, innerR = -0.12f;
-    float half = cubeSize / 2;
-    int seg = 20;
-
-    int coords[8][3] = {
-        {-1, +1, +1}, {+1, +1, +1}, {-1, -1, +1}, {+1, -1, +1},
-        {-1, +1, -1}, {+1, +1, -1}, {-1, -1, -1}, {+1, -1, -1},
-    };
-
-    int cx = coords[cubeID][0], cy = coords[cubeID][1], cz = coords[cubeID][2];
-    float posX = cx * half, posY = cy * half, posZ = cz * half;
-
-    bool renderFace[6] = {(cz > 0), (cz < 0), (cx > 0), (cx < 0), (cy > 0), (cy < 0)};
-
-    for (int f = 0; f < 6; f++) {
-        if (!renderFace[f]) continue;
-
-        float er[4];
-        switch (f) {
-            case 0: er[0] = (cx < 0) ? outerR : innerR; er[1] = (cx > 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 1: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 2: er[0] = (cz > 0) ? outerR : innerR; er[1] = (cz < 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 3: er[0] = (cz < 0) ? outerR : innerR; er[1] = (cz > 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 4: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                    er[2] = (cz > 0) ? outerR : innerR; er[3] = (cz < 0) ? outerR : innerR; break;
-            case 5: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                    er[2] = (cz < 0) ? outerR : innerR; er[3] = (cz > 0) ? outerR : innerR; break;
-        }
-        GenRoundedFaceGL(cubeSize, seg, posX, posY, posZ, f, er, verts, inds);
-    }
-}
+// --cubes=N: one display list for the full rounded cube, replayed per instance
+static GLuint g_glInstanceList = 0;
+static std::vector<CubeInstance> g_glInstances;
+
+// --gl-core: the context is 4.5 core and renderer_opengl_core.cpp draws the frame
+static bool s_glCore = false;
+
+// GPU pass timing (ring of frames so results are read without stalling)
+#define GL_TIMER_FRAMES 4
+#define GL_TIMER_PASSES 2   // Scene, Text
+static PFNGLGENQUERIES glGenQueriesPtr = nullptr;
+static PFNGLDELETEQUERIES glDeleteQueriesPtr = nullptr;
+static PFNGLBEGINQUERY glBeginQueryPtr = nullptr;
+static PFNGLENDQUERY glEndQueryPtr = nullptr;
+static PFNGLGETQUERYOBJECTIV glGetQueryObjectivPtr = nullptr;
+static PFNGLGETQUERYOBJECTUI64V glGetQueryObjectui64vPtr = nullptr;
+static GLuint g_glTimerQueries[GL_TIMER_FRAMES][GL_TIMER_PASSES] = {};
+static bool g_glTimerIssued[GL_TIMER_FRAMES] = {};
+static UINT g_glTimerFrame = 0;
+static const char* g_glTimerPassNames[GL_TIMER_PASSES] = { "Scene", "Text" };
 
 // ============== ERROR CHECKING ==============
 
 // Helper to check and log OpenGL errors
-static bool CheckGLError(const char* operation)
+bool CheckGLError(const char* operation)
 {
     GLenum err = glGetError();
     if (err != GL_NO_ERROR) {
@@ -198,11 +93,36 @@ static bool CheckGLError(const char* operation)
     return true;
 }
 
+// GPU timer queries (optional - needs GL 3.3 or ARB_timer_query)
+static void InitGLTimers()
+{
+    GpuProfilerReset();
+    glGenQueriesPtr = (PFNGLGENQUERIES)wglGetProcAddress("glGenQueries");
+    glDeleteQueriesPtr = (PFNGLDELETEQUERIES)wglGetProcAddress("glDeleteQueries");
+    glBeginQueryPtr = (PFNGLBEGINQUERY)wglGetProcAddress("glBeginQuery");
+    glEndQueryPtr = (PFNGLENDQUERY)wglGetProcAddress("glEndQuery");
+    glGetQueryObjectivPtr = (PFNGLGETQUERYOBJECTIV)wglGetProcAddress("glGetQueryObjectiv");
+    glGetQueryObjectui64vPtr = (PFNGLGETQUERYOBJECTUI64V)wglGetProcAddress("glGetQueryObjectui64v");
+    const char* glExts = (const char*)glGetString(GL_EXTENSIONS);
+    bool timerQuerySupported = glGenQueriesPtr && glDeleteQueriesPtr && glBeginQueryPtr && glEndQueryPtr &&
+        glGetQueryObjectivPtr && glGetQueryObjectui64vPtr &&
+        (!glExts || strstr(glExts, "GL_ARB_timer_query") || strstr(glExts, "GL_EXT_timer_query"));
+    if (timerQuerySupported) {
+        glGenQueriesPtr(GL_TIMER_FRAMES * GL_TIMER_PASSES, &g_glTimerQueries[0][0]);
+        Log("[INFO] OpenGL GPU timer queries enabled\n");
+    } else {
+        glGenQueriesPtr = nullptr;
+        Log("[INFO] OpenGL timer queries not supported, GPU pass timings disabled\n");
+    }
+    glGetError();  // Clear any error from the extension probe
+}
+
 // ============== INITIALIZATION ==============
 
 bool InitOpenGL(HWND hwnd)
 {
     Log("[INFO] Initializing OpenGL...\n");
+    StartupStep("Context");
 
     g_glHDC = GetDC(hwnd);
     if (!g_glHDC) {
@@ -244,7 +164,40 @@ bool InitOpenGL(HWND hwnd)
     Log("[INFO] OpenGL Renderer: %s\n", renderer ? renderer : "Unknown");
     Log("[INFO] OpenGL Version: %s\n", version ? version : "Unknown");
 
+    // --gl-core: swap to a 4.5 core context; any failure keeps the legacy path
+    if (g_glCore) {
+        HGLRC coreRC = CreateCoreContextGL(g_glHDC);
+        if (coreRC && wglMakeCurrent(g_glHDC, coreRC)) {
+            wglDeleteContext(g_glRC);
+            g_glRC = coreRC;
+            StartupStep("Core pipeline + scene");
+            if (InitOpenGLCore(g_glHDC)) {
+                s_glCore = true;
+                GLPresentInit(g_glHDC, "OpenGL core");
+                InitGLTimers();
+                Log("[INFO] OpenGL initialization complete (4.5 core)\n");
+                return true;
+            }
+            CleanupOpenGLCore();
+            wglMakeCurrent(nullptr, nullptr);
+            wglDeleteContext(g_glRC);
+            g_glRC = wglCreateContext(g_glHDC);
+            if (!g_glRC || !wglMakeCurrent(g_glHDC, g_glRC)) {
+                Log("[ERROR] Failed to recreate the legacy OpenGL context\n");
+                if (g_glRC) wglDeleteContext(g_glRC);
+                ReleaseDC(hwnd, g_glHDC);
+                g_glRC = nullptr;
+                g_glHDC = nullptr;
+                return false;
+            }
+        } else if (coreRC) {
+            wglDeleteContext(coreRC);
+        }
+        Log("[WARN] --gl-core unavailable, using the legacy OpenGL path\n");
+    }
+
     // Clear any pending errors
+    StartupStep("Font + scene");
     while (glGetError() != GL_NO_ERROR) {}
 
     // Setup OpenGL state
@@ -304,11 +257,54 @@ bool InitOpenGL(HWND hwnd)
     // Build rounded cube geometry for each of the 8 cubes (matching D3D11 exactly)
     Log("[INFO] Building rounded cube geometry...\n");
     g_glTriangleCount = 0;
+    g_glInstances.clear();
+
+    // GL 1.1 has no hardware instancing - the shared cube list is replayed per instance
+    bool instanced = g_cubeCount > 0 || MeshLoaded();   // --mesh is drawn as the instanced mesh
+    if (instanced) {
+        std::vector<CubeVertex> verts;
+        std::vector<uint32_t> inds;
+        if (!MeshLoaded()) BuildInstanceCube(verts, inds);
+        BuildCubeInstances(max(g_cubeCount, 1u), g_glInstances);
+
+        g_glInstanceList = glGenLists(1);
+        if (g_glInstanceList == 0) {
+            Log("[ERROR] glGenLists(1) failed for instanced cube\n");
+            return false;
+        }
+        glNewList(g_glInstanceList, GL_COMPILE);
+        if (MeshLoaded()) {
+            // Client arrays over the file mapping - glDrawElements copies them into the list
+            glEnableClientState(GL_VERTEX_ARRAY);
+            glEnableClientState(GL_NORMAL_ARRAY);
+            glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), g_mesh.vertices->pos);
+            glNormalPointer(GL_FLOAT, sizeof(MeshVertex), g_mesh.vertices->normal);
+            glDrawElements(GL_TRIANGLES, (GLsizei)g_mesh.indexCount, GL_UNSIGNED_INT, g_mesh.indices);
+            glDisableClientState(GL_NORMAL_ARRAY);
+            glDisableClientState(GL_VERTEX_ARRAY);
+        } else {
+            glBegin(GL_TRIANGLES);
+            for (size_t i = 0; i < inds.size(); i++) {
+                const CubeVertex& v = verts[inds[i]];
+                glNormal3fv(v.normal);
+                glVertex3fv(v.pos);
+            }
+            glEnd();
+        }
+        glEndList();
+        CheckGLError("instanced display list creation");
 
-    for (int c = 0; c < 8; c++) {
-        std::vector<GLVert> verts;
-        std::vector<unsigned int> inds;
-        BuildCubeGeometryGL(c, verts, inds);
+        // Per-instance glScalef would otherwise scale the lighting normals
+        glEnable(GL_NORMALIZE);
+        g_glTriangleCount = MeshLoaded() ? (int)(g_mesh.indexCount / 3) : (int)inds.size() / 3;
+        Log("[INFO] OpenGL instanced scene: %zu %s, %d triangles each\n", g_glInstances.size(),
+            MeshLoaded() ? "meshes" : "cubes", g_glTriangleCount);
+    }
+
+    for (int c = 0; c < 8 && !instanced; c++) {
+        std::vector<CubeVertex> verts;
+        std::vector<uint32_t> inds;
+        BuildSceneCube(c, verts, inds);
 
         Log("[INFO] Cube %d: %zu vertices, %zu indices\n", c, verts.size(), inds.size());
 
@@ -321,9 +317,9 @@ bool InitOpenGL(HWND hwnd)
         glNewList(g_glCubeLists[c], GL_COMPILE);
         glBegin(GL_TRIANGLES);
         for (size_t i = 0; i < inds.size(); i++) {
-            GLVert& v = verts[inds[i]];
-            glNormal3f(v.nx, v.ny, v.nz);
-            glVertex3f(v.px, v.py, v.pz);
+            const CubeVertex& v = verts[inds[i]];
+            glNormal3fv(v.normal);
+            glVertex3fv(v.pos);
         }
         glEnd();
         glEndList();
@@ -337,6 +333,9 @@ bool InitOpenGL(HWND hwnd)
 
     Log("[INFO] OpenGL geometry: %d triangles total\n", g_glTriangleCount);
 
+    GLPresentInit(g_glHDC, "OpenGL");
+    InitGLTimers();
+
     // Final error check
     if (!CheckGLError("initialization complete")) {
         Log("[WARN] OpenGL initialization completed with errors\n");
@@ -388,14 +387,58 @@ void DrawTextGL(const char* text, float x, float y)
     glMatrixMode(GL_MODELVIEW);
 }
 
+// ============== GPU TIMER QUERIES ==============
+
+// Read the oldest slot if its results are available (never blocks)
+void CollectGLTimers()
+{
+    UINT slot = g_glTimerFrame % GL_TIMER_FRAMES;
+    if (!glGenQueriesPtr || !g_glTimerIssued[slot]) return;
+
+    GLint available = 0;
+    glGetQueryObjectivPtr(g_glTimerQueries[slot][GL_TIMER_PASSES - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+
+    for (int p = 0; p < GL_TIMER_PASSES; p++) {
+        GLuint64 ns = 0;
+        glGetQueryObjectui64vPtr(g_glTimerQueries[slot][p], GL_QUERY_RESULT, &ns);
+        GpuProfilerAddSample(p, g_glTimerPassNames[p], (double)ns / 1.0e6);
+    }
+    g_glTimerIssued[slot] = false;
+}
+
+// GL_TIME_ELAPSED queries cannot nest - passes are timed back to back
+void BeginGLTimer(int pass)
+{
+    UINT slot = g_glTimerFrame % GL_TIMER_FRAMES;
+    if (glGenQueriesPtr && !g_glTimerIssued[slot]) glBeginQueryPtr(GL_TIME_ELAPSED, g_glTimerQueries[slot][pass]);
+}
+
+void EndGLTimer(int pass)
+{
+    UINT slot = g_glTimerFrame % GL_TIMER_FRAMES;
+    if (!glGenQueriesPtr || g_glTimerIssued[slot]) return;
+    glEndQueryPtr(GL_TIME_ELAPSED);
+    if (pass == GL_TIMER_PASSES - 1) {
+        g_glTimerIssued[slot] = true;
+        g_glTimerFrame++;
+    }
+}
+
 // ============== RENDERING ==============
 
 void RenderOpenGL()
 {
+    if (s_glCore) { RenderOpenGLCore(); return; }
+
     static int frameNum = 0;
     static bool errorLogged = false;
     frameNum++;
 
+    GLWaitFrameLatency();
+    CollectGLTimers();
+    BeginGLTimer(0);
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Get time for animation
@@ -460,6 +503,16 @@ void RenderOpenGL()
     // Draw 8 cubes using rounded display lists with per-vertex lighting
     // Note: Display lists already contain geometry positioned at +/-half offsets,
     // so no additional translation is needed here
+    for (size_t i = 0; i < g_glInstances.size(); i++) {
+        const CubeInstance& inst = g_glInstances[i];
+        glColor3f(inst.color[0], inst.color[1], inst.color[2]);
+        glPushMatrix();
+        glTranslatef(inst.offset[0], inst.offset[1], inst.offset[2]);
+        glScalef(inst.scale, inst.scale, inst.scale);
+        glCallList(g_glInstanceList);
+        glPopMatrix();
+    }
+
     for (int i = 0; i < 8; i++) {
         if (g_glCubeLists[i] == 0) continue;  // Skip if display list not created
 
@@ -476,6 +529,9 @@ void RenderOpenGL()
         errorLogged = true;
     }
 
+    EndGLTimer(0);
+    BeginGLTimer(1);
+
     // Disable lighting for text overlay
     glDisable(GL_LIGHTING);
     glDisable(GL_COLOR_MATERIAL);
@@ -484,20 +540,41 @@ void RenderOpenGL()
     const char* glRenderer = (const char*)glGetString(GL_RENDERER);
     if (!glRenderer) glRenderer = "Unknown";
 
-    char infoText[512];
-    sprintf_s(infoText, "API: OpenGL\nGPU: %s\nFPS: %d\nTriangles: %d\nResolution: %ux%u",
-        glRenderer, fps, g_glTriangleCount, W, H);
-
-    char* context = nullptr;
-    char* line = strtok_s(infoText, "\n", &context);
-    float textY = 20.0f;
-    while (line) {
-        DrawTextGL(line, 10.0f, textY);
-        textY += 16.0f;
-        line = strtok_s(nullptr, "\n", &context);
+    char gpuTimes[160];
+    GpuProfilerFormat(gpuTimes, sizeof(gpuTimes));
+
+    char infoText[704];
+    unsigned long long triangles = (unsigned long long)g_glTriangleCount * (g_glInstances.empty() ? 1 : g_glInstances.size());
+    char latency[96], pacing[96];
+    LatencyFormat(latency, sizeof(latency));
+    GLPacingFormat(pacing, sizeof(pacing));
+    char vram[192];
+    VramFormat(vram, sizeof(vram));
+    sprintf_s(infoText, "API: OpenGL\nGPU: %s\nFPS: %d\nTriangles: %llu\nResolution: %ux%u\n%s\n%s\n%s\n%s",
+        glRenderer, fps, triangles, W, H, gpuTimes, latency, pacing, vram);
+
+    // Fixed function can't take glyph instances; compile the bitmap font calls
+    // into one display list when the text changes and replay it otherwise
+    if (g_glFontBase && OverlaySetText(g_glOverlay, infoText)) {
+        if (g_glTextList == 0) g_glTextList = glGenLists(1);
+        if (g_glTextList) {
+            glNewList(g_glTextList, GL_COMPILE);
+            char* context = nullptr;
+            char* line = strtok_s(infoText, "\n", &context);
+            float textY = 20.0f;
+            while (line) {
+                DrawTextGL(line, 10.0f, textY);
+                textY += 16.0f;
+                line = strtok_s(nullptr, "\n", &context);
+            }
+            glEndList();
+        }
     }
+    if (g_glTextList) glCallList(g_glTextList);
+
+    EndGLTimer(1);
 
-    if (!SwapBuffers(g_glHDC)) {
+    if (!GLPresent(g_glHDC)) {
         if (!errorLogged) {
             Log("[ERROR] SwapBuffers failed at frame %d (error %lu)\n", frameNum, GetLastError());
             errorLogged = true;
@@ -505,12 +582,37 @@ void RenderOpenGL()
     }
 }
 
+// ============== RESIZE ==============
+
+bool ResizeOpenGL()
+{
+    if (!g_glRC) return false;
+    if (s_glCore) return ResizeOpenGLCore();
+
+    // Default framebuffer follows the window; only viewport and projection change
+    glViewport(0, 0, (GLsizei)W, (GLsizei)H);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluPerspective(45.0, (double)W / (double)H, 0.1, 100.0);
+    glMatrixMode(GL_MODELVIEW);
+    OverlayInvalidate(g_glOverlay);     // The compiled glOrtho uses the old size
+    GLPresentResize();
+
+    Log("[INFO] OpenGL resized to %ux%u\n", W, H);
+    return CheckGLError("resize");
+}
+
 // ============== CLEANUP ==============
 
 void CleanupOpenGL()
 {
     Log("[INFO] Cleaning up OpenGL...\n");
 
+    if (s_glCore) {
+        CleanupOpenGLCore();
+        s_glCore = false;
+    }
+
     // Delete all 8 rounded cube display lists
     for (int i = 0; i < 8; i++) {
         if (g_glCubeLists[i]) {
@@ -518,11 +620,30 @@ void CleanupOpenGL()
             g_glCubeLists[i] = 0;
         }
     }
+    if (g_glInstanceList) {
+        glDeleteLists(g_glInstanceList, 1);
+        g_glInstanceList = 0;
+    }
+    g_glInstances.clear();
 
     if (g_glFontBase) {
         glDeleteLists(g_glFontBase, 96);
         g_glFontBase = 0;
     }
+    if (g_glTextList) {
+        glDeleteLists(g_glTextList, 1);
+        g_glTextList = 0;
+    }
+    OverlayInvalidate(g_glOverlay);
+
+    if (glGenQueriesPtr) {
+        glDeleteQueriesPtr(GL_TIMER_FRAMES * GL_TIMER_PASSES, &g_glTimerQueries[0][0]);
+        memset(g_glTimerQueries, 0, sizeof(g_glTimerQueries));
+        memset(g_glTimerIssued, 0, sizeof(g_glTimerIssued));
+        glGenQueriesPtr = nullptr;
+    }
+
+    GLPresentShutdown();
 
     if (g_glRC) {
         wglMakeCurrent(nullptr, nullptr);
@@ -7,3 +7,4 @@
 bool InitOpenGL(HWND hwnd);
 void RenderOpenGL();
 void CleanupOpenGL();
+bool ResizeOpenGL();  // Update viewport/projection for the current W x H
@@ -0,0 +1,506 @@
+// ============== OPENGL 4.5 CORE RENDERER ==============
+// --gl-core path of the OpenGL renderer: the same scene drawn the way a
+// current GL application does it, next to the legacy fixed-function /
+// display list path of renderer_opengl.cpp:
+//   - 4.5 core profile context, DSA (ARB_direct_state_access) objects
+//   - immutable VBO / IBO / instance buffer, one VAO for the scene layout
+//   - GLSL that reproduces the D3D11 transform and lighting (opengl_core_shaders.h)
+//   - per-frame UBO and overlay glyph instances (text_overlay.h) in one
+//     persistent, coherent mapped ring (ARB_buffer_storage); each slot is
+//     fenced before it is rewritten, glyphs only when the text changed
+//   - the scene is one glMultiDrawElementsIndirect: 8 commands (one per baked
+//     cube) or a single command with N instances for --cubes / --mesh
+
+#include <Windows.h>
+#include <GL/gl.h>
+
+#include "../common.h"
+#include "../gpu_profiler.h"
+#include "../mesh_file.h"
+#include "../cube_geometry.h"
+#include "../text_overlay.h"
+#include "../vram_budget.h"
+#include "../shaders/opengl_core_shaders.h"
+#include "opengl_shared.h"
+#include "gl_present.h"
+#include <vector>
+#include <cstring>
+#include <cstddef>
+
+// ============== GL 4.5 DECLARATIONS ==============
+// The Windows SDK only ships the GL 1.1 header; everything newer is declared
+// here and loaded via wglGetProcAddress once the core context is current
+#ifndef GL_VERSION_4_5
+typedef char GLchar;
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+typedef unsigned long long GLuint64;
+typedef struct __GLsync* GLsync;
+
+#define GL_UNIFORM_BUFFER                   0x8A11
+#define GL_DRAW_INDIRECT_BUFFER             0x8F3F
+#define GL_MAP_WRITE_BIT                    0x0002
+#define GL_MAP_PERSISTENT_BIT               0x0040
+#define GL_MAP_COHERENT_BIT                 0x0080
+#define GL_VERTEX_SHADER                    0x8B31
+#define GL_FRAGMENT_SHADER                  0x8B30
+#define GL_COMPILE_STATUS                   0x8B81
+#define GL_LINK_STATUS                      0x8B82
+#define GL_SYNC_GPU_COMMANDS_COMPLETE       0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT          0x00000001
+#define GL_TIMEOUT_EXPIRED                  0x911B
+#define GL_WAIT_FAILED                      0x911D
+#define GL_CLAMP_TO_EDGE                    0x812F
+#define GL_LOWER_LEFT                       0x8CA1
+#define GL_ZERO_TO_ONE                      0x935F
+#define GL_MAJOR_VERSION                    0x821B
+#define GL_MINOR_VERSION                    0x821C
+#endif
+
+#define WGL_CONTEXT_MAJOR_VERSION_ARB       0x2091
+#define WGL_CONTEXT_MINOR_VERSION_ARB       0x2092
+#define WGL_CONTEXT_PROFILE_MASK_ARB        0x9126
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB    0x00000001
+typedef HGLRC(WINAPI* PFNWGLCREATECONTEXTATTRIBSARB)(HDC hdc, HGLRC shareContext, const int* attribList);
+
+#define GL_CORE_FUNCS(X) \
+    X(void, glCreateBuffers, (GLsizei n, GLuint* buffers)) \
+    X(void, glNamedBufferStorage, (GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags)) \
+    X(void*, glMapNamedBufferRange, (GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access)) \
+    X(GLboolean, glUnmapNamedBuffer, (GLuint buffer)) \
+    X(void, glDeleteBuffers, (GLsizei n, const GLuint* buffers)) \
+    X(void, glBindBuffer, (GLenum target, GLuint buffer)) \
+    X(void, glBindBufferRange, (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)) \
+    X(void, glCreateVertexArrays, (GLsizei n, GLuint* arrays)) \
+    X(void, glDeleteVertexArrays, (GLsizei n, const GLuint* arrays)) \
+    X(void, glBindVertexArray, (GLuint array)) \
+    X(void, glVertexArrayVertexBuffer, (GLuint vaobj, GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride)) \
+    X(void, glVertexArrayElementBuffer, (GLuint vaobj, GLuint buffer)) \
+    X(void, glEnableVertexArrayAttrib, (GLuint vaobj, GLuint index)) \
+    X(void, glVertexArrayAttribFormat, (GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset)) \
+    X(void, glVertexArrayAttribIFormat, (GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset)) \
+    X(void, glVertexArrayAttribBinding, (GLuint vaobj, GLuint attribindex, GLuint bindingindex)) \
+    X(void, glVertexArrayBindingDivisor, (GLuint vaobj, GLuint bindingindex, GLuint divisor)) \
+    X(GLuint, glCreateShader, (GLenum type)) \
+    X(void, glShaderSource, (GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)) \
+    X(void, glCompileShader, (GLuint shader)) \
+    X(void, glGetShaderiv, (GLuint shader, GLenum pname, GLint* params)) \
+    X(void, glGetShaderInfoLog, (GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)) \
+    X(void, glDeleteShader, (GLuint shader)) \
+    X(GLuint, glCreateProgram, (void)) \
+    X(void, glAttachShader, (GLuint program, GLuint shader)) \
+    X(void, glLinkProgram, (GLuint program)) \
+    X(void, glGetProgramiv, (GLuint program, GLenum pname, GLint* params)) \
+    X(void, glGetProgramInfoLog, (GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)) \
+    X(void, glDeleteProgram, (GLuint program)) \
+    X(void, glUseProgram, (GLuint program)) \
+    X(void, glDrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount)) \
+    X(void, glMultiDrawElementsIndirect, (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)) \
+    X(void, glClipControl, (GLenum origin, GLenum depth)) \
+    X(GLsync, glFenceSync, (GLenum condition, GLbitfield flags)) \
+    X(GLenum, glClientWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout)) \
+    X(void, glDeleteSync, (GLsync sync))
+
+#define GL_CORE_DECLARE(ret, name, params) typedef ret (APIENTRY* PFN_##name) params; static PFN_##name name##Ptr = nullptr;
+GL_CORE_FUNCS(GL_CORE_DECLARE)
+#undef GL_CORE_DECLARE
+
+// ============== CORE GLOBALS ==============
+#define GL_CORE_RING_SLOTS 3                    // Frames the CPU may run ahead of the GPU
+#define GL_CORE_SLOT_SIZE (128 * 1024)          // A multiple of any UBO offset alignment
+#define GL_CORE_TEXT_OFFSET 256                 // FrameUBO first, overlay glyph instances after it
+
+struct FrameUBO {                               // std140 FrameUBO in opengl_core_shaders.h
+    float time;
+    float aspect;
+    float screenSize[2];
+};
+
+static_assert(GL_CORE_TEXT_OFFSET + OVERLAY_MAX_INSTANCES * sizeof(GlyphInstance) <= GL_CORE_SLOT_SIZE,
+              "overlay instances must fit in a ring slot");
+
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+static HDC s_hdc = nullptr;
+static GLuint s_sceneProgram = 0, s_textProgram = 0;
+static GLuint s_vbo = 0, s_ibo = 0, s_instanceBuffer = 0, s_indirectBuffer = 0;
+static GLuint s_sceneVao = 0, s_textVao = 0;
+static GLsizei s_drawCount = 0;
+static unsigned long long s_triangleCount = 0;
+
+static GLuint s_ring = 0;
+static BYTE* s_ringMapped = nullptr;
+static GLsync s_ringFence[GL_CORE_RING_SLOTS] = {};
+static UINT s_ringSlot = 0;
+
+// Overlay, reformatted when the FPS changes; a slot's copy of the glyph
+// instances is refreshed only when its version lags the overlay's
+static TextOverlay s_overlay;
+static UINT s_slotTextVersion[GL_CORE_RING_SLOTS] = {};
+static int s_textFps = -1;
+
+// ============== CONTEXT + LOADER ==============
+HGLRC CreateCoreContextGL(HDC hdc)
+{
+    PFNWGLCREATECONTEXTATTRIBSARB wglCreateContextAttribsARBPtr =
+        (PFNWGLCREATECONTEXTATTRIBSARB)wglGetProcAddress("wglCreateContextAttribsARB");
+    if (!wglCreateContextAttribsARBPtr) {
+        Log("[WARN] --gl-core: WGL_ARB_create_context not supported\n");
+        return nullptr;
+    }
+    const int attribs[] = {
+        WGL_CONTEXT_MAJOR_VERSION_ARB, 4,
+        WGL_CONTEXT_MINOR_VERSION_ARB, 5,
+        WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+        0
+    };
+    HGLRC rc = wglCreateContextAttribsARBPtr(hdc, nullptr, attribs);
+    if (!rc) Log("[WARN] --gl-core: no OpenGL 4.5 core profile context (error 0x%lX)\n", GetLastError());
+    return rc;
+}
+
+static bool LoadCoreFunctionsGL()
+{
+    bool ok = true;
+#define GL_CORE_LOAD(ret, name, params) \
+    name##Ptr = (PFN_##name)wglGetProcAddress(#name); \
+    if (!name##Ptr) { Log("[ERROR] --gl-core: %s not exported by the driver\n", #name); ok = false; }
+    GL_CORE_FUNCS(GL_CORE_LOAD)
+#undef GL_CORE_LOAD
+    return ok;
+}
+
+// ============== SHADERS ==============
+static GLuint CompileShaderGL(GLenum type, const char* defines, const char* body, const char* tag)
+{
+    const GLchar* sources[3] = { "#version 450 core\n", defines, body };
+    GLuint shader = glCreateShaderPtr(type);
+    glShaderSourcePtr(shader, 3, sources, nullptr);
+    glCompileShaderPtr(shader);
+
+    GLint ok = 0;
+    glGetShaderivPtr(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[2048] = {0};
+        glGetShaderInfoLogPtr(shader, sizeof(log), nullptr, log);
+        Log("[SHADER ERROR] %s: %s\n", tag, log);
+        glDeleteShaderPtr(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static GLuint LinkProgramGL(const char* defines, const char* vsBody, const char* fsBody, const char* tag)
+{
+    GLuint vs = CompileShaderGL(GL_VERTEX_SHADER, defines, vsBody, tag);
+    GLuint fs = CompileShaderGL(GL_FRAGMENT_SHADER, defines, fsBody, tag);
+    if (!vs || !fs) {
+        if (vs) glDeleteShaderPtr(vs);
+        if (fs) glDeleteShaderPtr(fs);
+        return 0;
+    }
+    GLuint program = glCreateProgramPtr();
+    glAttachShaderPtr(program, vs);
+    glAttachShaderPtr(program, fs);
+    glLinkProgramPtr(program);
+    glDeleteShaderPtr(vs);
+    glDeleteShaderPtr(fs);
+
+    GLint ok = 0;
+    glGetProgramivPtr(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[2048] = {0};
+        glGetProgramInfoLogPtr(program, sizeof(log), nullptr, log);
+        Log("[SHADER ERROR] %s link: %s\n", tag, log);
+        glDeleteProgramPtr(program);
+        return 0;
+    }
+    return program;
+}
+
+// ============== SCENE ==============
+// Immutable buffers + VAO + indirect commands. Attribute locations follow
+// g_glCoreSceneVS: 0 position, 1 normal, 2 cube ID or instance offset/scale,
+// 3 instance color.
+static bool CreateSceneGL(bool instanced)
+{
+    std::vector<CubeVertex> verts;
+    std::vector<uint32_t> inds;
+    std::vector<CubeInstance> instances;
+    std::vector<DrawElementsIndirectCommand> cmds;
+
+    if (instanced) {
+        if (!MeshLoaded()) BuildInstanceCube(verts, inds);
+        BuildCubeInstances(max(g_cubeCount, 1u), instances);
+        GLuint indexCount = MeshLoaded() ? g_mesh.indexCount : (GLuint)inds.size();
+        cmds.push_back({ indexCount, (GLuint)instances.size(), 0, 0, 0 });
+        s_triangleCount = (unsigned long long)indexCount / 3 * instances.size();
+    } else {
+        // Cube c's indices are rebased onto its own vertices, so baseVertex stays 0
+        for (int c = 0; c < 8; c++) {
+            GLuint first = (GLuint)inds.size();
+            BuildSceneCube(c, verts, inds);
+            cmds.push_back({ (GLuint)inds.size() - first, 1, first, 0, (GLuint)c });
+        }
+        s_triangleCount = inds.size() / 3;
+    }
+
+    // --mesh: storage is initialised straight from the file mapping
+    const void* vbData = MeshLoaded() ? (const void*)g_mesh.vertices : verts.data();
+    const void* ibData = MeshLoaded() ? (const void*)g_mesh.indices : inds.data();
+    GLsizeiptr vbBytes = MeshLoaded() ? (GLsizeiptr)MeshVertexBytes(g_mesh) : (GLsizeiptr)(verts.size() * sizeof(CubeVertex));
+    GLsizeiptr ibBytes = MeshLoaded() ? (GLsizeiptr)MeshIndexBytes(g_mesh) : (GLsizeiptr)(inds.size() * sizeof(uint32_t));
+    GLsizei stride = MeshLoaded() ? (GLsizei)sizeof(MeshVertex) : (GLsizei)sizeof(CubeVertex);
+
+    glCreateBuffersPtr(1, &s_vbo);
+    glNamedBufferStoragePtr(s_vbo, vbBytes, vbData, 0);
+    glCreateBuffersPtr(1, &s_ibo);
+    glNamedBufferStoragePtr(s_ibo, ibBytes, ibData, 0);
+    glCreateBuffersPtr(1, &s_indirectBuffer);
+    glNamedBufferStoragePtr(s_indirectBuffer, (GLsizeiptr)(cmds.size() * sizeof(DrawElementsIndirectCommand)), cmds.data(), 0);
+    s_drawCount = (GLsizei)cmds.size();
+
+    glCreateVertexArraysPtr(1, &s_sceneVao);
+    glVertexArrayVertexBufferPtr(s_sceneVao, 0, s_vbo, 0, stride);
+    glVertexArrayElementBufferPtr(s_sceneVao, s_ibo);
+    glEnableVertexArrayAttribPtr(s_sceneVao, 0);
+    glVertexArrayAttribFormatPtr(s_sceneVao, 0, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBindingPtr(s_sceneVao, 0, 0);
+    glEnableVertexArrayAttribPtr(s_sceneVao, 1);
+    glVertexArrayAttribFormatPtr(s_sceneVao, 1, 3, GL_FLOAT, GL_FALSE, 12);
+    glVertexArrayAttribBindingPtr(s_sceneVao, 1, 0);
+
+    if (instanced) {
+        glCreateBuffersPtr(1, &s_instanceBuffer);
+        glNamedBufferStoragePtr(s_instanceBuffer, (GLsizeiptr)(instances.size() * sizeof(CubeInstance)), instances.data(), 0);
+        glVertexArrayVertexBufferPtr(s_sceneVao, 1, s_instanceBuffer, 0, sizeof(CubeInstance));
+        glVertexArrayBindingDivisorPtr(s_sceneVao, 1, 1);
+        glEnableVertexArrayAttribPtr(s_sceneVao, 2);
+        glVertexArrayAttribFormatPtr(s_sceneVao, 2, 4, GL_FLOAT, GL_FALSE, offsetof(CubeInstance, offset));
+        glVertexArrayAttribBindingPtr(s_sceneVao, 2, 1);
+        glEnableVertexArrayAttribPtr(s_sceneVao, 3);
+        glVertexArrayAttribFormatPtr(s_sceneVao, 3, 4, GL_FLOAT, GL_FALSE, offsetof(CubeInstance, color));
+        glVertexArrayAttribBindingPtr(s_sceneVao, 3, 1);
+    } else {
+        glEnableVertexArrayAttribPtr(s_sceneVao, 2);
+        glVertexArrayAttribIFormatPtr(s_sceneVao, 2, 1, GL_UNSIGNED_INT, offsetof(CubeVertex, cubeID));
+        glVertexArrayAttribBindingPtr(s_sceneVao, 2, 0);
+    }
+
+    Log("[INFO] OpenGL core scene: %d indirect draw%s, %llu triangles (%s)\n", s_drawCount, s_drawCount == 1 ? "" : "s",
+        s_triangleCount, instanced ? (MeshLoaded() ? "instanced mesh" : "instanced cubes") : "8 baked cubes");
+    return CheckGLError("core scene buffers");
+}
+
+// ============== PER-FRAME RING ==============
+static bool CreateRingGL()
+{
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = (GLsizeiptr)GL_CORE_RING_SLOTS * GL_CORE_SLOT_SIZE;
+    glCreateBuffersPtr(1, &s_ring);
+    glNamedBufferStoragePtr(s_ring, size, nullptr, flags);
+    s_ringMapped = (BYTE*)glMapNamedBufferRangePtr(s_ring, 0, size, flags);
+    if (!s_ringMapped) {
+        Log("[ERROR] --gl-core: persistent mapping of the frame ring failed\n");
+        return false;
+    }
+    s_ringSlot = 0;
+    return true;
+}
+
+// Waits until the GPU is done with the frame that last used this slot
+static BYTE* AcquireRingSlotGL()
+{
+    GLsync& fence = s_ringFence[s_ringSlot];
+    if (fence) {
+        GLenum r;
+        do {
+            r = glClientWaitSyncPtr(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000ull);   // 100 ms
+        } while (r == GL_TIMEOUT_EXPIRED);
+        if (r == GL_WAIT_FAILED) Log("[WARN] --gl-core: glClientWaitSync failed on ring slot %u\n", s_ringSlot);
+        glDeleteSyncPtr(fence);
+        fence = nullptr;
+    }
+    return s_ringMapped + (size_t)s_ringSlot * GL_CORE_SLOT_SIZE;
+}
+
+// ============== TEXT ==============
+static bool CreateOverlayGL()
+{
+    // GlyphInstance per instance from the ring; the binding offset moves with
+    // the frame slot, the quad corners come from gl_VertexID
+    glCreateVertexArraysPtr(1, &s_textVao);
+    glVertexArrayBindingDivisorPtr(s_textVao, 0, 1);
+    glEnableVertexArrayAttribPtr(s_textVao, 0);
+    glVertexArrayAttribIFormatPtr(s_textVao, 0, 2, GL_UNSIGNED_SHORT, offsetof(GlyphInstance, x));
+    glVertexArrayAttribBindingPtr(s_textVao, 0, 0);
+    glEnableVertexArrayAttribPtr(s_textVao, 1);
+    glVertexArrayAttribIFormatPtr(s_textVao, 1, 2, GL_UNSIGNED_BYTE, offsetof(GlyphInstance, ch));
+    glVertexArrayAttribBindingPtr(s_textVao, 1, 0);
+    return CheckGLError("core overlay");
+}
+
+// ============== INIT ==============
+bool InitOpenGLCore(HDC hdc)
+{
+    Log("[INFO] Initializing OpenGL 4.5 core path...\n");
+    s_hdc = hdc;
+    if (!LoadCoreFunctionsGL()) return false;
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    const char* version = (const char*)glGetString(GL_VERSION);
+    Log("[INFO] OpenGL core context: %d.%d (%s)\n", major, minor, version ? version : "Unknown");
+
+    // Same View / Proj as the D3D11 shaders: D3D depth range and winding
+    glClipControlPtr(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CW);
+    glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+    glViewport(0, 0, (GLsizei)W, (GLsizei)H);
+
+    bool instanced = g_cubeCount > 0 || MeshLoaded();   // --mesh is drawn as the instanced mesh
+    s_sceneProgram = LinkProgramGL(instanced ? "#define INSTANCED 1\n" : "", g_glCoreSceneVS, g_glCoreSceneFS, "GLCoreScene");
+    std::string overlayVS = OverlayShaderGLSL(true), overlayFS = OverlayShaderGLSL(false);
+    s_textProgram = LinkProgramGL("", overlayVS.c_str(), overlayFS.c_str(), "GLCoreOverlay");
+    if (!s_sceneProgram || !s_textProgram) return false;
+
+    if (!CreateSceneGL(instanced) || !CreateRingGL() || !CreateOverlayGL()) return false;
+    OverlayInvalidate(s_overlay);
+    memset(s_slotTextVersion, 0, sizeof(s_slotTextVersion));
+    s_textFps = -1;
+    return true;
+}
+
+// ============== RENDERING ==============
+void RenderOpenGLCore()
+{
+    static int frameNum = 0;
+    static bool errorLogged = false;
+    frameNum++;
+
+    GLWaitFrameLatency();
+    CollectGLTimers();
+    BeginGLTimer(0);
+
+    BYTE* slot = AcquireRingSlotGL();
+    GLintptr slotOffset = (GLintptr)s_ringSlot * GL_CORE_SLOT_SIZE;
+
+    LARGE_INTEGER nowTime;
+    QueryPerformanceCounter(&nowTime);
+    float t = (float)(nowTime.QuadPart - g_startTime.QuadPart) / g_perfFreq.QuadPart;
+    FrameUBO ubo = { t, (float)W / (float)H, { (float)W, (float)H } };
+    memcpy(slot, &ubo, sizeof(ubo));
+    glBindBufferRangePtr(GL_UNIFORM_BUFFER, 0, s_ring, slotOffset, sizeof(FrameUBO));
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glUseProgramPtr(s_sceneProgram);
+    glBindVertexArrayPtr(s_sceneVao);
+    glBindBufferPtr(GL_DRAW_INDIRECT_BUFFER, s_indirectBuffer);
+    glMultiDrawElementsIndirectPtr(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, s_drawCount, 0);
+
+    if (!errorLogged && !CheckGLError("core scene draw")) {
+        Log("[ERROR] OpenGL error during core scene draw at frame %d\n", frameNum);
+        errorLogged = true;
+    }
+
+    EndGLTimer(0);
+    BeginGLTimer(1);
+
+    // Overlay (reformatted when the FPS changes, instances rebuilt only if the text differs)
+    if (fps != s_textFps) {
+        s_textFps = fps;
+        const char* glRenderer = (const char*)glGetString(GL_RENDERER);
+        char gpuTimes[160];
+        GpuProfilerFormat(gpuTimes, sizeof(gpuTimes));
+        char latency[96], pacing[96];
+        LatencyFormat(latency, sizeof(latency));
+        GLPacingFormat(pacing, sizeof(pacing));
+        char vram[192];
+        VramFormat(vram, sizeof(vram));
+        char infoText[832];
+        sprintf_s(infoText, "API: OpenGL 4.5 core\nGPU: %s\nFPS: %d\nTriangles: %llu\nResolution: %ux%u\nMulti-draw indirect: %d draws\n%s\n%s\n%s\n%s",
+            glRenderer ? glRenderer : "Unknown", fps, s_triangleCount, W, H, s_drawCount, gpuTimes, latency, pacing, vram);
+        OverlaySetText(s_overlay, infoText);
+    }
+    UINT glyphInstances = OverlayInstanceCount(s_overlay);
+    if (glyphInstances > 0) {
+        if (s_slotTextVersion[s_ringSlot] != s_overlay.version) {
+            memcpy(slot + GL_CORE_TEXT_OFFSET, s_overlay.instances, OverlayInstanceBytes(s_overlay));
+            s_slotTextVersion[s_ringSlot] = s_overlay.version;
+        }
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_CULL_FACE);
+        glUseProgramPtr(s_textProgram);
+        glBindVertexArrayPtr(s_textVao);
+        glVertexArrayVertexBufferPtr(s_textVao, 0, s_ring, slotOffset + GL_CORE_TEXT_OFFSET, sizeof(GlyphInstance));
+        glDrawArraysInstancedPtr(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)glyphInstances);   // Shadow range first
+    }
+
+    EndGLTimer(1);
+
+    // The slot may be rewritten once the GPU has passed this point
+    s_ringFence[s_ringSlot] = glFenceSyncPtr(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s_ringSlot = (s_ringSlot + 1) % GL_CORE_RING_SLOTS;
+
+    if (!GLPresent(s_hdc)) {
+        if (!errorLogged) {
+            Log("[ERROR] SwapBuffers failed at frame %d (error %lu)\n", frameNum, GetLastError());
+            errorLogged = true;
+        }
+    }
+}
+
+// ============== RESIZE ==============
+bool ResizeOpenGLCore()
+{
+    // FrameUBO carries the aspect and overlay size, so only the viewport changes
+    glViewport(0, 0, (GLsizei)W, (GLsizei)H);
+    s_textFps = -1;
+    GLPresentResize();
+    Log("[INFO] OpenGL core resized to %ux%u\n", W, H);
+    return CheckGLError("core resize");
+}
+
+// ============== CLEANUP ==============
+void CleanupOpenGLCore()
+{
+    for (UINT i = 0; i < GL_CORE_RING_SLOTS; i++) {
+        if (s_ringFence[i]) { glDeleteSyncPtr(s_ringFence[i]); s_ringFence[i] = nullptr; }
+    }
+    if (s_ring) {
+        if (s_ringMapped) glUnmapNamedBufferPtr(s_ring);
+        glDeleteBuffersPtr(1, &s_ring);
+        s_ring = 0;
+    }
+    s_ringMapped = nullptr;
+    s_ringSlot = 0;
+
+    GLuint buffers[] = { s_vbo, s_ibo, s_instanceBuffer, s_indirectBuffer };
+    if (glDeleteBuffersPtr) glDeleteBuffersPtr(4, buffers);
+    s_vbo = s_ibo = s_instanceBuffer = s_indirectBuffer = 0;
+    GLuint vaos[] = { s_sceneVao, s_textVao };
+    if (glDeleteVertexArraysPtr) glDeleteVertexArraysPtr(2, vaos);
+    s_sceneVao = s_textVao = 0;
+    if (s_sceneProgram) { glDeleteProgramPtr(s_sceneProgram); s_sceneProgram = 0; }
+    if (s_textProgram) { glDeleteProgramPtr(s_textProgram); s_textProgram = 0; }
+
+    s_drawCount = 0;
+    s_triangleCount = 0;
+    OverlayInvalidate(s_overlay);
+    memset(s_slotTextVersion, 0, sizeof(s_slotTextVersion));
+    s_textFps = -1;
+    s_hdc = nullptr;
+}
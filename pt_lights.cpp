@@ -0,0 +1,76 @@
+// ============== PATH TRACER MANY-LIGHT SAMPLING ==============
+// --lights emitter layout and --light-sampling names (see pt_lights.h)
+
+#include "pt_lights.h"
+
+UINT g_ptLights = 0;
+PtLightSampling g_ptLightSampling = PT_LIGHTS_UNIFORM;
+
+const char* PtLightSamplingName() {
+    static const char* names[PT_LIGHTS_COUNT] = { "uniform", "ris", "restir" };
+    return names[g_ptLightSampling];
+}
+
+static uint32_t LightHash(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+static float LightRandom(uint32_t& state) {
+    state = LightHash(state + 0x9e3779b9u);
+    return (state >> 8) / 16777216.0f;
+}
+
+void BuildPtLights(float roomHalf, std::vector<PtLight>& out) {
+    out.clear();
+
+    // Spotlight: the constants of SampleAreaLight
+    PtLight spot = {};
+    spot.pos[1] = 1.92f;
+    spot.radius = 0.3f;
+    spot.emission[0] = 1.0f * 6.0f; spot.emission[1] = 0.95f * 6.0f; spot.emission[2] = 0.9f * 6.0f;
+    float d[3] = { 0.0f, -1.0f, 0.15f };
+    float len = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    for (int i = 0; i < 3; i++) spot.dir[i] = d[i] / len;
+    spot.spotInnerCos = 0.85f;
+    spot.spotOuterCos = 0.5f;
+    out.push_back(spot);
+    if (g_ptLights == 0) return;
+
+    // One emitter per cell of a near-square grid, jittered inside the cell;
+    // cells over the main light's quad (|x|, |z| < 0.6) are pushed outward
+    UINT cols = (UINT)ceilf(sqrtf((float)g_ptLights));
+    UINT rows = (g_ptLights + cols - 1) / cols;
+    float span = roomHalf - 0.15f;
+    float cellW = 2.0f * span / cols, cellH = 2.0f * span / rows;
+    uint32_t state = 1;
+    float powerSum = 0.0f;
+    size_t first = out.size();
+    for (UINT i = 0; i < g_ptLights; i++) {
+        PtLight l = {};
+        float x = -span + ((i % cols) + 0.2f + 0.6f * LightRandom(state)) * cellW;
+        float z = -span + ((i / cols) + 0.2f + 0.6f * LightRandom(state)) * cellH;
+        if (fabsf(x) < 0.6f && fabsf(z) < 0.6f) {
+            if (fabsf(x) > fabsf(z)) x = x < 0.0f ? -0.6f : 0.6f;
+            else z = z < 0.0f ? -0.6f : 0.6f;
+        }
+        l.pos[0] = x; l.pos[1] = roomHalf - 0.02f; l.pos[2] = z;
+        l.radius = PT_LIGHT_RADIUS;
+        // Warm to cool white, power spread over 0.25x - 1.75x of the mean
+        float warm = LightRandom(state);
+        float power = 0.25f + 1.5f * LightRandom(state);
+        l.emission[0] = power * (0.8f + 0.2f * warm);
+        l.emission[1] = power * 0.9f;
+        l.emission[2] = power * (1.0f - 0.2f * warm);
+        l.dir[1] = -1.0f;
+        l.spotInnerCos = 0.3f;
+        l.spotOuterCos = 0.0f;
+        powerSum += power;
+        out.push_back(l);
+    }
+    float scale = PT_LIGHT_TOTAL_INTENSITY / powerSum;
+    for (size_t i = first; i < out.size(); i++)
+        for (int c = 0; c < 3; c++) out[i].emission[c] *= scale;
+}
@@ -0,0 +1,46 @@
+#pragma once
+// ============== PATH TRACER MANY-LIGHT SAMPLING ==============
+// --lights=N adds N small emitters to the D3D12 PT Cornell box ceiling (light
+// 0 stays the spotlight), --light-sampling picks how next event estimation
+// chooses one of them (shaders/d3d12_pt_shaders.h):
+//   uniform  one light at random, weight = light count (the original NEE)
+//   ris      resampled importance sampling: PT_RIS_CANDIDATES uniform
+//            candidates, one kept with probability ~ its unshadowed luminance
+//   restir   ris + reuse at the primary hit (ReSTIR DI): the pixel's and a
+//            few neighbours' reservoirs of the previous frame are resampled
+//            into this frame's, so good lights found anywhere nearby spread
+// The emitters get uneven power so that light choice matters. Megakernel
+// only; --wavefront keeps the single spotlight.
+
+#include "common.h"
+#include <cstdint>
+
+enum PtLightSampling {
+    PT_LIGHTS_UNIFORM,
+    PT_LIGHTS_RIS,
+    PT_LIGHTS_RESTIR,
+    PT_LIGHTS_COUNT
+};
+extern UINT g_ptLights;                 // --lights=N extra emitters (0 = spotlight only)
+extern PtLightSampling g_ptLightSampling;
+
+#define PT_MAX_LIGHTS 4096
+#define PT_LIGHT_RADIUS 0.06f           // Emitter disk radius (quad half size)
+#define PT_LIGHT_TOTAL_INTENSITY 8.0f   // Summed over the extra emitters
+
+// Matches struct Light in d3d12_pt_shaders.h. Disks in the xz plane.
+struct PtLight {
+    float pos[3];
+    float radius;
+    float emission[3];      // Colour * intensity
+    float spotInnerCos;
+    float dir[3];           // Emission axis, attenuated by the cone below
+    float spotOuterCos;
+};
+static_assert(sizeof(PtLight) == 48, "PtLight must match the shader's Light");
+
+const char* PtLightSamplingName();
+
+// [0] = the spotlight, then g_ptLights emitters on a jittered ceiling grid of
+// the room with half size roomHalf (deterministic, outside the main light)
+void BuildPtLights(float roomHalf, std::vector<PtLight>& out);
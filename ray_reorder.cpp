@@ -0,0 +1,43 @@
+// ============== SHADER EXECUTION REORDERING ==============
+// --ser state shared by DXR 1.0 and Vulkan RT (see ray_reorder.h)
+
+#include "ray_reorder.h"
+
+bool g_ser = false;
+
+static const char* s_path = nullptr;      // Active path, nullptr = off / fallback
+static const char* s_reason = "";         // Why it fell back
+static bool s_reorders = false;
+static char s_overlay[96] = "";
+
+void SerReset() {
+    s_path = nullptr;
+    s_reason = g_ser ? "renderer has no TraceRay path" : "";
+    s_reorders = false;
+    s_overlay[0] = 0;
+}
+
+void SerSetActive(const char* path, bool reorders) {
+    s_path = path;
+    s_reason = "";
+    s_reorders = reorders;
+    sprintf_s(s_overlay, "SER: %s%s", path, reorders ? "" : " (driver does not reorder)");
+    Log("[INFO] SER: secondary rays reordered via %s%s\n", path, reorders ? "" : ", but the device reports no reordering");
+}
+
+void SerSetFallback(const char* reason) {
+    s_path = nullptr;
+    s_reason = reason;
+    s_reorders = false;
+    sprintf_s(s_overlay, "SER: off (%s)", reason);
+    Log("[WARN] --ser: %s, tracing without reordering\n", reason);
+}
+
+const char* SerOverlayText() {
+    return g_ser ? s_overlay : "";
+}
+
+void SerWriteJson(FILE* f) {
+    fprintf(f, "  \"ser\": { \"requested\": %s, \"active\": %s, \"path\": \"%s\", \"reorders\": %s, \"fallback\": \"%s\" },\n",
+        g_ser ? "true" : "false", s_path ? "true" : "false", s_path ? s_path : "", s_reorders ? "true" : "false", s_reason);
+}
@@ -0,0 +1,29 @@
+#pragma once
+// ============== SHADER EXECUTION REORDERING ==============
+// --ser: the TraceRay renderers (DXR 1.0, Vulkan RT) reorder their incoherent
+// secondary rays (mirror reflection, glass refraction, GI) before the hit
+// shader runs: trace into a hit object, regroup the threads by hit object +
+// coherence hint, then invoke the closest hit / miss shader. Primary and
+// shadow / AO rays are traced as before.
+//   DXR 1.0: SM 6.9 dx::HitObject + dx::MaybeReorderThread (raytracing tier
+//            1.2), hint = material type from the material table
+//   Vulkan RT: VK_NV_ray_tracing_invocation_reorder; the precompiled raygen
+//            SPIR-V is rewritten (vk_specialize.h), hint = material type from
+//            the hit's instance + primitive index
+// Without support the renderer traces the plain path and the report says why.
+
+#include "common.h"
+
+extern bool g_ser;   // --ser
+
+// Frontend
+void SerReset();                  // InitRenderer: nothing active until a backend says so
+void SerWriteJson(FILE* f);       // Benchmark report "ser" block (incl. trailing comma)
+
+// Backends, at init when g_ser is set: the path that reorders, or the reason
+// for the fallback. reorders = false when the device reports the reorder as a
+// no-op (Vulkan rayTracingInvocationReorderReorderingHint); D3D12 has no such
+// query and passes true.
+void SerSetActive(const char* path, bool reorders);
+void SerSetFallback(const char* reason);
+const char* SerOverlayText();     // "SER: ..." for the overlay, "" when --ser is off
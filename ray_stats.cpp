@@ -0,0 +1,102 @@
+// ============== RAY THROUGHPUT STATS ==============
+// Per-type ray counts and Mrays/s behind --ray-stats (see ray_stats.h)
+
+#include "ray_stats.h"
+#include "gpu_profiler.h"
+#include <cstring>
+
+bool g_rayStats = false;
+
+static const char* s_rayTypeNames[RAY_TYPE_COUNT] = { "Primary", "Shadow", "AO", "GI", "Reflect" };
+static const char* s_rayTypeKeys[RAY_TYPE_COUNT] = { "primary", "shadow", "ao", "gi", "reflect" };
+
+static double s_windowRays[RAY_TYPE_COUNT] = {};
+static UINT s_windowFrames = 0;
+static double s_displayRays[RAY_TYPE_COUNT] = {};   // Rays per frame, last display window
+static double s_totalRays[RAY_TYPE_COUNT] = {};
+static UINT s_totalFrames = 0;
+
+const char* RayTypeName(UINT type) {
+    return type < RAY_TYPE_COUNT ? s_rayTypeNames[type] : "?";
+}
+
+void RayStatsAddFrame(const UINT counts[RAY_TYPE_COUNT]) {
+    for (UINT i = 0; i < RAY_TYPE_COUNT; i++) {
+        s_windowRays[i] += counts[i];
+        s_totalRays[i] += counts[i];
+    }
+    s_windowFrames++;
+    s_totalFrames++;
+}
+
+void RayStatsReset() {
+    for (UINT i = 0; i < RAY_TYPE_COUNT; i++) {
+        s_windowRays[i] = 0.0;
+        s_displayRays[i] = 0.0;
+        s_totalRays[i] = 0.0;
+    }
+    s_windowFrames = 0;
+    s_totalFrames = 0;
+}
+
+void RayStatsTick() {
+    if (!s_windowFrames) return;
+    for (UINT i = 0; i < RAY_TYPE_COUNT; i++) {
+        s_displayRays[i] = s_windowRays[i] / s_windowFrames;
+        s_windowRays[i] = 0.0;
+    }
+    s_windowFrames = 0;
+}
+
+// GPU ms per frame of the passes that trace rays (profiler passes named "Trace...")
+static double TraceMs(bool total) {
+    double ms = 0.0;
+    for (UINT i = 0; i < GpuProfilerPassCount(); i++) {
+        const GpuPassStats* p = GpuProfilerGetPass(i);
+        if (!p || !p->name || strncmp(p->name, "Trace", 5) != 0) continue;
+        if (total) ms += p->totalSamples ? p->totalSumMs / p->totalSamples : 0.0;
+        else ms += p->displayMs;
+    }
+    return ms;
+}
+
+void RayStatsFormat(char* buf, size_t size) {
+    if (!buf || size == 0) return;
+    buf[0] = 0;
+    if (!g_rayStats) return;
+    double ms = TraceMs(false);
+    double sum = 0.0;
+    for (UINT i = 0; i < RAY_TYPE_COUNT; i++) sum += s_displayRays[i];
+    if (sum <= 0.0 || ms <= 0.0) return;   // No counted frame / trace timing yet
+
+    // rays / (ms * 1e-3) / 1e6
+    int len = _snprintf_s(buf, size, _TRUNCATE, "Mrays/s:");
+    for (UINT i = 0; i < RAY_TYPE_COUNT && len >= 0 && (size_t)len < size; i++) {
+        if (s_displayRays[i] <= 0.0) continue;
+        int n = _snprintf_s(buf + len, size - len, _TRUNCATE, " %s %.0f |",
+                            s_rayTypeNames[i], s_displayRays[i] / ms / 1000.0);
+        if (n < 0) return;
+        len += n;
+    }
+    if (len >= 0 && (size_t)len < size)
+        _snprintf_s(buf + len, size - len, _TRUNCATE, " Total %.0f (%.2f Mrays/frame)",
+                    sum / ms / 1000.0, sum / 1e6);
+}
+
+void RayStatsWriteJson(FILE* f) {
+    if (!g_rayStats || !s_totalFrames) return;
+    double ms = TraceMs(true);
+    double sum = 0.0;
+    fprintf(f, "  \"rays\": {\n");
+    fprintf(f, "    \"frames\": %u,\n", s_totalFrames);
+    fprintf(f, "    \"traceMs\": %.4f,\n", ms);
+    for (UINT i = 0; i < RAY_TYPE_COUNT; i++) {
+        double perFrame = s_totalRays[i] / s_totalFrames;
+        sum += perFrame;
+        fprintf(f, "    \"%s\": { \"raysPerFrame\": %.0f, \"mraysPerSec\": %.2f },\n",
+            s_rayTypeKeys[i], perFrame, ms > 0.0 ? perFrame / ms / 1000.0 : 0.0);
+    }
+    fprintf(f, "    \"total\": { \"raysPerFrame\": %.0f, \"mraysPerSec\": %.2f }\n",
+        sum, ms > 0.0 ? sum / ms / 1000.0 : 0.0);
+    fprintf(f, "  },\n");
+}
@@ -0,0 +1,31 @@
+#pragma once
+// ============== RAY THROUGHPUT STATS ==============
+// --ray-stats: the D3D12 PT, DXR 1.0 and DXR 1.1 shaders count the rays they
+// trace per type (shaders/ray_stats_shaders.h, one wave-aggregated atomic per
+// TraceRay / RayQuery site) into a small UAV that is read back a few frames
+// later (d3d12/d3d12_ray_stats.cpp). Together with the GPU time of the passes
+// that trace ("Trace..." in the GPU profiler) that gives Mrays/s per type.
+
+#include "common.h"
+
+enum RayType {
+    RAY_PRIMARY,
+    RAY_SHADOW,
+    RAY_AO,
+    RAY_GI,
+    RAY_REFLECT,       // Mirror / glass reflection and refraction
+    RAY_TYPE_COUNT
+};
+
+extern bool g_rayStats;   // --ray-stats
+
+const char* RayTypeName(UINT type);
+
+// Backend side: counts of one frame, once its readback is available
+void RayStatsAddFrame(const UINT counts[RAY_TYPE_COUNT]);
+
+// Frontend side
+void RayStatsReset();                          // InitRenderer / benchmark start
+void RayStatsTick();                           // Refresh display averages (called once per second)
+void RayStatsFormat(char* buf, size_t size);   // e.g. "Mrays/s: Primary 812 | Shadow 790 | AO 2210 | Total 3812"
+void RayStatsWriteJson(FILE* f);               // Benchmark report "rays" block (incl. trailing comma)
@@ -0,0 +1,72 @@
+// ============== COMPACT RAY TRACING GEOMETRY ==============
+// Octahedral normal packing and 16-bit index narrowing behind --compact-verts
+// (see rt_geometry.h)
+
+#include "rt_geometry.h"
+
+bool g_compactVerts = false;
+
+static int16_t PackSnorm16(float v) {
+    v = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+    return (int16_t)lrintf(v * 32767.0f);
+}
+
+uint32_t OctEncodeNormal(float x, float y, float z) {
+    float l1 = fabsf(x) + fabsf(y) + fabsf(z);
+    if (l1 <= 0.0f) return 0;
+    x /= l1; y /= l1;
+    if (z < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx; y = fy;
+    }
+    return (uint16_t)PackSnorm16(x) | ((uint32_t)(uint16_t)PackSnorm16(y) << 16);
+}
+
+void RTMeshPrepare(RTMeshData& mesh, const void* verts, uint32_t stride, uint32_t vertexCount,
+                   const std::vector<uint32_t>& inds, const char* tag) {
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = (uint32_t)inds.size();
+    mesh.compactVerts.clear();
+    mesh.indices16.clear();
+
+    if (!g_compactVerts) {
+        mesh.vertices = verts;
+        mesh.vertexStride = stride;
+        mesh.vertexBytes = (size_t)vertexCount * stride;
+        mesh.indices = inds.data();
+        mesh.indexBytes = inds.size() * sizeof(uint32_t);
+        mesh.index16 = false;
+        return;
+    }
+
+    mesh.compactVerts.resize(vertexCount);
+    const BYTE* src = (const BYTE*)verts;
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        float v[6];
+        memcpy(v, src + (size_t)i * stride, sizeof(v));
+        RTCompactVert& c = mesh.compactVerts[i];
+        c.pos[0] = v[0]; c.pos[1] = v[1]; c.pos[2] = v[2];
+        c.normal = OctEncodeNormal(v[3], v[4], v[5]);
+    }
+    mesh.vertices = mesh.compactVerts.data();
+    mesh.vertexStride = sizeof(RTCompactVert);
+    mesh.vertexBytes = mesh.compactVerts.size() * sizeof(RTCompactVert);
+
+    mesh.index16 = vertexCount <= 65536;
+    if (mesh.index16) {
+        // Even count, so raw (4-byte) buffer views cover every index
+        mesh.indices16.assign(inds.begin(), inds.end());
+        if (mesh.indices16.size() & 1) mesh.indices16.push_back(0);
+        mesh.indices = mesh.indices16.data();
+        mesh.indexBytes = mesh.indices16.size() * sizeof(uint16_t);
+    } else {
+        mesh.indices = inds.data();
+        mesh.indexBytes = inds.size() * sizeof(uint32_t);
+    }
+
+    Log("[INFO] %s compact geometry: %u verts %zu -> %zu bytes, %u inds %zu -> %zu bytes (%s)\n",
+        tag, vertexCount, (size_t)vertexCount * stride, mesh.vertexBytes,
+        mesh.indexCount, inds.size() * sizeof(uint32_t), mesh.indexBytes, mesh.index16 ? "16-bit" : "32-bit");
+}
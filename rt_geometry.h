@@ -0,0 +1,44 @@
+#pragma once
+// ============== COMPACT RAY TRACING GEOMETRY ==============
+// --compact-verts: vertex / index layout of the BLAS inputs of the D3D12 PT
+// (+ DLSS), DXR 1.0 and Vulkan RT / RQ renderers. The full vertices are 32 or
+// 40 bytes (float3 position, float3 normal, then IDs or a colour); the
+// compact one keeps the position for the BLAS build and packs the normal
+// octahedrally into two snorm16 - 16 bytes. Object and material IDs are not
+// stored: hit shading takes them from the material / primitive tables
+// (d3d12/d3d12_rt_tables.cpp) or the primitive ranges. A mesh with at most
+// 65536 vertices also gets 16-bit indices (DXGI_FORMAT_R16_UINT /
+// VK_INDEX_TYPE_UINT16).
+
+#include "common.h"
+#include <cstdint>
+
+extern bool g_compactVerts;
+
+struct RTCompactVert {
+    float pos[3];
+    uint32_t normal;    // Octahedral, x snorm16 in bits 0-15, y in 16-31
+};
+static_assert(sizeof(RTCompactVert) == 16, "RTCompactVert must be 16 bytes");
+
+uint32_t OctEncodeNormal(float x, float y, float z);
+
+// One mesh's buffer contents in the layout the renderer uploads. vertices /
+// indices point at the caller's arrays (full layout) or at the compact copies
+// held here, so the mesh must outlive the upload.
+struct RTMeshData {
+    const void* vertices = nullptr;
+    size_t vertexBytes = 0;
+    uint32_t vertexStride = 0;
+    uint32_t vertexCount = 0;
+    const void* indices = nullptr;
+    size_t indexBytes = 0;      // 16-bit: padded to a multiple of 4 (raw buffer views)
+    uint32_t indexCount = 0;
+    bool index16 = false;
+    std::vector<RTCompactVert> compactVerts;
+    std::vector<uint16_t> indices16;
+};
+
+// verts: vertices with a float3 position at offset 0 and a float3 normal at 12
+void RTMeshPrepare(RTMeshData& mesh, const void* verts, uint32_t stride, uint32_t vertexCount,
+                   const std::vector<uint32_t>& inds, const char* tag);
@@ -0,0 +1,119 @@
+// ============== RT / PT SAMPLER ==============
+// --sampler backend selection and the blue-noise tile (see rt_sampling.h)
+
+#include "rt_sampling.h"
+
+RtSampler g_rtSampler = RT_SAMPLER_WHITE;
+
+const char* RtSamplerName() {
+    static const char* names[RT_SAMPLER_COUNT] = { "white", "sobol", "bluenoise" };
+    return names[g_rtSampler];
+}
+
+const wchar_t* RtSamplerDefine() {
+    static const wchar_t* defines[RT_SAMPLER_COUNT] = { L"RT_SAMPLER=0", L"RT_SAMPLER=1", L"RT_SAMPLER=2" };
+    return defines[g_rtSampler];
+}
+
+// ============== VOID AND CLUSTER ==============
+// Ulichney 1993 on a torus: a Gaussian energy per pixel from every set pixel.
+// The tightest cluster is the set pixel with the highest energy, the largest
+// void the empty one with the lowest. Ranking the initial pattern by removing
+// clusters and the rest by filling voids gives each pixel a threshold whose
+// every prefix is a blue-noise point set. Filling voids past half is the same
+// as the inverted-pattern cluster search: the energy of the empty pixels is a
+// constant minus that of the set ones.
+
+#define BN_SIGMA 1.5f
+#define BN_N (BLUE_NOISE_SIZE * BLUE_NOISE_SIZE)
+
+struct BlueNoiseBuilder {
+    std::vector<float> lut;     // Energy of a set pixel at toroidal offset (dx, dy)
+    std::vector<float> energy;
+    std::vector<uint8_t> set;
+
+    BlueNoiseBuilder() : lut(BN_N), energy(BN_N, 0.0f), set(BN_N, 0) {
+        for (int y = 0; y < BLUE_NOISE_SIZE; y++) {
+            for (int x = 0; x < BLUE_NOISE_SIZE; x++) {
+                int dx = x < BLUE_NOISE_SIZE / 2 ? x : x - BLUE_NOISE_SIZE;
+                int dy = y < BLUE_NOISE_SIZE / 2 ? y : y - BLUE_NOISE_SIZE;
+                lut[y * BLUE_NOISE_SIZE + x] = expf(-(float)(dx * dx + dy * dy) / (2.0f * BN_SIGMA * BN_SIGMA));
+            }
+        }
+    }
+
+    void Toggle(int p, bool on) {
+        set[p] = on ? 1 : 0;
+        float sign = on ? 1.0f : -1.0f;
+        int px = p % BLUE_NOISE_SIZE, py = p / BLUE_NOISE_SIZE;
+        for (int y = 0; y < BLUE_NOISE_SIZE; y++) {
+            int ly = ((y - py) & (BLUE_NOISE_SIZE - 1)) * BLUE_NOISE_SIZE;
+            for (int x = 0; x < BLUE_NOISE_SIZE; x++)
+                energy[y * BLUE_NOISE_SIZE + x] += sign * lut[ly + ((x - px) & (BLUE_NOISE_SIZE - 1))];
+        }
+    }
+
+    int TightestCluster() const {
+        int best = -1;
+        for (int i = 0; i < BN_N; i++)
+            if (set[i] && (best < 0 || energy[i] > energy[best])) best = i;
+        return best;
+    }
+
+    int LargestVoid() const {
+        int best = -1;
+        for (int i = 0; i < BN_N; i++)
+            if (!set[i] && (best < 0 || energy[i] < energy[best])) best = i;
+        return best;
+    }
+};
+
+static void BuildBlueNoise(std::vector<uint16_t>& ranks) {
+    ranks.assign(BN_N, 0);
+    BlueNoiseBuilder b;
+
+    // Initial pattern: 10% of the pixels from a fixed LCG, then swap the
+    // tightest cluster into the largest void until that changes nothing
+    uint32_t rng = 0x1234567u;
+    int initial = BN_N / 10;
+    for (int placed = 0; placed < initial; ) {
+        rng = rng * 1664525u + 1013904223u;
+        int p = (int)((rng >> 8) % BN_N);
+        if (!b.set[p]) { b.Toggle(p, true); placed++; }
+    }
+    for (int iter = 0; iter < BN_N; iter++) {
+        int cluster = b.TightestCluster();
+        b.Toggle(cluster, false);
+        int gap = b.LargestVoid();
+        b.Toggle(gap, true);
+        if (gap == cluster) break;
+    }
+
+    // Phase 1: rank the initial pattern from its densest point down
+    BlueNoiseBuilder phase1 = b;
+    for (int rank = initial - 1; rank >= 0; rank--) {
+        int p = phase1.TightestCluster();
+        phase1.Toggle(p, false);
+        ranks[p] = (uint16_t)rank;
+    }
+    // Phases 2 + 3: fill the remaining pixels void by void
+    for (int rank = initial; rank < BN_N; rank++) {
+        int p = b.LargestVoid();
+        b.Toggle(p, true);
+        ranks[p] = (uint16_t)rank;
+    }
+}
+
+const std::vector<uint16_t>& BlueNoiseTile() {
+    static std::vector<uint16_t> s_tile;
+    if (s_tile.empty()) {
+        LARGE_INTEGER t0, t1, freq;
+        QueryPerformanceCounter(&t0);
+        BuildBlueNoise(s_tile);
+        QueryPerformanceCounter(&t1);
+        QueryPerformanceFrequency(&freq);
+        Log("[INFO] Blue noise tile %dx%d generated in %.1f ms\n", BLUE_NOISE_SIZE, BLUE_NOISE_SIZE,
+            (double)(t1.QuadPart - t0.QuadPart) * 1000.0 / (double)freq.QuadPart);
+    }
+    return s_tile;
+}
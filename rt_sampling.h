@@ -0,0 +1,28 @@
+#pragma once
+// ============== RT / PT SAMPLER ==============
+// --sampler=white|sobol|bluenoise: random number backend of the DXR 1.0,
+// DXR 1.1, D3D12 PT (+ --wavefront) and DLSS shaders (shaders/rt_sampling_shaders.h).
+// Low-discrepancy and blue-noise samples spread the error of a few soft
+// shadow / AO / GI / path samples evenly over the pixel and its neighbours,
+// so fewer rays reach the same noise level and the denoisers see smoother
+// input. The Vulkan RT / RQ shaders are precompiled SPIR-V and keep white noise.
+
+#include "common.h"
+#include <cstdint>
+
+enum RtSampler {
+    RT_SAMPLER_WHITE,       // WangHash per pixel and frame (default)
+    RT_SAMPLER_SOBOL,       // Owen-scrambled Sobol (0, 2) pairs
+    RT_SAMPLER_BLUENOISE,   // 64x64 blue-noise tile, golden ratio per sample
+    RT_SAMPLER_COUNT
+};
+extern RtSampler g_rtSampler;
+
+#define BLUE_NOISE_SIZE 64
+
+const char* RtSamplerName();
+const wchar_t* RtSamplerDefine();   // DXC define, e.g. L"RT_SAMPLER=1"
+
+// Void-and-cluster ranks 0..BLUE_NOISE_SIZE^2-1, row-major. Generated on first
+// use (tens of ms) and kept for the process.
+const std::vector<uint16_t>& BlueNoiseTile();
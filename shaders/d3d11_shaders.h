@@ -1,12 +1,13 @@
 #pragma once
 // ============== D3D11/D3D12 BASE SHADERS ==============
-// Vertex/Pixel shaders for basic cube rendering and text overlay
+// Vertex/Pixel shaders for basic cube rendering (text overlay: overlay_shaders.h)
 
 static const char* g_d3d11ShaderCode = R"HLSL(
-cbuffer CB : register(b0) { float Time; float3 _pad; };
+cbuffer CB : register(b0) { float Time; float Aspect; float2 _pad; };
 
 static const matrix View = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,4,1 };
-static const matrix Proj = { 1.81066f,0,0,0, 0,2.41421f,0,0, 0,0,1.001f,1, 0,0,-0.1001f,0 };
+// 45 deg vertical FOV; x is divided by Aspect in VS (0 = legacy 4:3)
+static const matrix Proj = { 2.41421f,0,0,0, 0,2.41421f,0,0, 0,0,1.001f,1, 0,0,-0.1001f,0 };
 
 static const float4 Colors[8] = {
     float4(0.95f,0.2f,0.15f,1), float4(0.2f,0.7f,0.3f,1),
@@ -28,35 +29,33 @@ PSIn VS(VSIn i) {
     float3x3 rot = mul(RotY(Time*1.2f), RotX(Time*0.7f));
     float3 worldPos = mul(i.pos, rot);
     o.pos = mul(mul(float4(worldPos,1), View), Proj);
+    o.pos.x /= (Aspect > 0.0f) ? Aspect : 1.33333f;
     o.worldNorm = mul(i.norm, rot);
     o.color = Colors[i.cubeID];
     return o;
 }
 
-float4 PS(PSIn i) : SV_TARGET {
-    float3 n = normalize(i.worldNorm);
-    float d = max(dot(n, LightDir), 0) * 0.65f + 0.35f;
-    return float4(i.color.rgb * d, 1);
-}
-
-// ============== TEXT RENDERING SHADERS ==============
-struct TextVSIn { float2 pos : POSITION; float2 uv : TEXCOORD; float4 color : COLOR; };
-struct TextPSIn { float4 pos : SV_POSITION; float2 uv : TEXCOORD; float4 color : COLOR; };
-
-Texture2D fontTexture : register(t0);
-SamplerState fontSampler : register(s0);
+// Instanced path (--cubes=N): one rounded-cube mesh, per-instance offset/scale/color
+struct VSInstIn {
+    float3 pos : POSITION; float3 norm : NORMAL;
+    float4 inst : INSTANCE;      // xyz = offset, w = uniform scale
+    float4 instColor : INSTCOLOR;
+};
 
-TextPSIn TextVS(TextVSIn i) {
-    TextPSIn o;
-    o.pos = float4(i.pos.x/320.0f-1.0f, 1.0f-i.pos.y/240.0f, 0, 1);
-    o.uv = i.uv;
-    o.color = i.color;
+PSIn VSInstanced(VSInstIn i) {
+    PSIn o;
+    float3x3 rot = mul(RotY(Time*1.2f), RotX(Time*0.7f));
+    float3 worldPos = mul(i.pos * i.inst.w + i.inst.xyz, rot);
+    o.pos = mul(mul(float4(worldPos,1), View), Proj);
+    o.pos.x /= (Aspect > 0.0f) ? Aspect : 1.33333f;
+    o.worldNorm = mul(i.norm, rot);
+    o.color = i.instColor;
     return o;
 }
 
-float4 TextPS(TextPSIn i) : SV_TARGET {
-    float alpha = fontTexture.Sample(fontSampler, i.uv).r;
-    if (alpha < 0.5f) discard;
-    return float4(i.color.rgb, alpha);
+float4 PS(PSIn i) : SV_TARGET {
+    float3 n = normalize(i.worldNorm);
+    float d = max(dot(n, LightDir), 0) * 0.65f + 0.35f;
+    return float4(i.color.rgb * d, 1);
 }
 )HLSL";
@@ -0,0 +1,133 @@
+#pragma once
+// ============== D3D12 GPU CULLING SHADERS ==============
+// Compute shaders for the --gpu-culling path of the D3D12 base renderer:
+// two-phase frustum + Hi-Z occlusion culling of the --cubes=N instances.
+// Transforms must match VSInstanced in d3d11_shaders.h.
+
+static const char* g_d3d12CullShaderCode = R"HLSL(
+cbuffer CullCB : register(b0) {
+    float Time;
+    float Aspect;
+    uint  InstanceCount;
+    uint  Phase;          // Cull: 0 = last frame's visible set, 1 = Hi-Z test. Downsample: source mip
+    uint2 HiZSize;        // Mip 0 size (= backbuffer)
+    uint  HiZMips;
+    uint  _pad;
+};
+
+struct CubeInstance { float4 offsetScale; float4 color; };
+
+Texture2D<float>                   SrcTex      : register(t0);   // Depth (copy) or Hi-Z pyramid (cull)
+StructuredBuffer<CubeInstance>     Instances   : register(t1);
+RWTexture2D<float>                 HiZSrc      : register(u0);
+RWTexture2D<float>                 HiZDst      : register(u1);
+RWByteAddressBuffer                Visibility  : register(u2);  // 1 uint per instance, persists across frames
+RWStructuredBuffer<CubeInstance>   Compacted   : register(u3);  // Surviving instances for this phase
+RWByteAddressBuffer                Args        : register(u4);  // 2 x D3D12_DRAW_INDEXED_ARGUMENTS
+
+// Same constants as the raster VS: View = translate(0,0,4), 45 deg vertical FOV
+static const float ProjScale = 2.41421f;
+static const float NearZ = 0.1f;
+static const float MeshRadius = 0.8227f;   // Half-diagonal of the 0.95-unit rounded cube
+
+float3x3 RotY(float a) { float c=cos(a),s=sin(a); return float3x3(c,0,s,0,1,0,-s,0,c); }
+float3x3 RotX(float a) { float c=cos(a),s=sin(a); return float3x3(1,0,0,0,c,-s,0,s,c); }
+
+float NdcDepth(float z) { return (1.001f * z - 0.1001f) / z; }
+
+float2 ProjectToTexel(float3 v) {
+    float a = (Aspect > 0.0f) ? Aspect : 1.33333f;
+    float2 ndc = float2(v.x * ProjScale / a, v.y * ProjScale) / v.z;
+    return float2(ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f) * (float2)HiZSize;
+}
+
+bool InFrustum(float3 c, float r) {
+    float a = ProjScale / ((Aspect > 0.0f) ? Aspect : 1.33333f);
+    if (c.z + r < NearZ) return false;
+    if ((a * c.x - c.z) * rsqrt(a * a + 1) > r) return false;
+    if ((-a * c.x - c.z) * rsqrt(a * a + 1) > r) return false;
+    if ((ProjScale * c.y - c.z) * rsqrt(ProjScale * ProjScale + 1) > r) return false;
+    if ((-ProjScale * c.y - c.z) * rsqrt(ProjScale * ProjScale + 1) > r) return false;
+    return true;
+}
+
+// Conservative: true only if the whole sphere lies behind the Hi-Z max depth
+bool Occluded(float3 c, float r) {
+    if (c.z - r <= NearZ) return false;
+
+    // Screen bounds of the 8 corners of the sphere's view-space AABB
+    float2 lo = float2(1e30f, 1e30f), hi = float2(-1e30f, -1e30f);
+    [unroll] for (int k = 0; k < 8; k++) {
+        float3 corner = c + float3((k & 1) ? r : -r, (k & 2) ? r : -r, (k & 4) ? r : -r);
+        float2 p = ProjectToTexel(corner);
+        lo = min(lo, p); hi = max(hi, p);
+    }
+    lo = clamp(lo, 0, (float2)HiZSize - 1);
+    hi = clamp(hi, 0, (float2)HiZSize - 1);
+
+    float extent = max(hi.x - lo.x, hi.y - lo.y);
+    uint mip = min((uint)ceil(log2(max(extent, 1.0f))), HiZMips - 1);
+    uint2 dim = max(HiZSize >> mip, 1);
+    uint2 t0 = min((uint2)lo >> mip, dim - 1);
+    uint2 t1 = min(t0 + 1, dim - 1);
+
+    float maxZ = max(max(SrcTex.Load(int3(t0, mip)), SrcTex.Load(int3(t1.x, t0.y, mip))),
+                     max(SrcTex.Load(int3(t0.x, t1.y, mip)), SrcTex.Load(int3(t1, mip))));
+    return NdcDepth(c.z - r) > maxZ;
+}
+
+void Emit(uint argOffset, CubeInstance inst) {
+    uint slot;
+    Args.InterlockedAdd(argOffset + 4, 1, slot);
+    Compacted[slot] = inst;
+}
+
+[numthreads(64, 1, 1)]
+void CSCull(uint3 id : SV_DispatchThreadID) {
+    if (id.x >= InstanceCount) return;
+    CubeInstance inst = Instances[id.x];
+
+    float3x3 rot = mul(RotY(Time*1.2f), RotX(Time*0.7f));
+    float3 c = mul(inst.offsetScale.xyz, rot) + float3(0, 0, 4);
+    float r = MeshRadius * inst.offsetScale.w;
+
+    bool wasVisible = Visibility.Load(id.x * 4) != 0;
+    bool inFrustum = InFrustum(c, r);
+
+    if (Phase == 0) {
+        if (wasVisible && inFrustum) Emit(0, inst);
+        return;
+    }
+
+    bool visible = inFrustum && !Occluded(c, r);
+    if (visible && !wasVisible) Emit(20, inst);
+    Visibility.Store(id.x * 4, visible ? 1u : 0u);
+}
+
+// Hi-Z mip 0 = depth buffer after the phase 0 draw
+[numthreads(8, 8, 1)]
+void CSHiZCopy(uint3 id : SV_DispatchThreadID) {
+    if (any(id.xy >= HiZSize)) return;
+    HiZSrc[id.xy] = SrcTex.Load(int3(id.xy, 0));
+}
+
+// Max-reduce mip N (u0) into mip N+1 (u1). Odd source sizes fold the extra
+// row/column into the last destination texel so coverage stays conservative.
+[numthreads(8, 8, 1)]
+void CSHiZDownsample(uint3 id : SV_DispatchThreadID) {
+    uint2 srcSize = max(HiZSize >> Phase, 1);
+    uint2 dstSize = max(srcSize >> 1, 1);
+    if (any(id.xy >= dstSize)) return;
+
+    uint2 s = id.xy * 2;
+    uint2 e = min(s + 1, srcSize - 1);
+    if (id.x == dstSize.x - 1) e.x = srcSize.x - 1;
+    if (id.y == dstSize.y - 1) e.y = srcSize.y - 1;
+
+    float m = 0;
+    for (uint y = s.y; y <= e.y; y++)
+        for (uint x = s.x; x <= e.x; x++)
+            m = max(m, HiZSrc[uint2(x, y)]);
+    HiZDst[id.xy] = m;
+}
+)HLSL";
@@ -1,10 +1,12 @@
 #pragma once
 // ============== D3D12 DENOISING SHADER ==============
-// Edge-aware bilateral filter using À-Trous wavelet transform
+// Edge-aware bilateral filter using À-Trous wavelet transform (DenoiseCS, run
+// with StepSize 1/2/4/8) and the optional temporal stage before it (TemporalCS)
 
 static const char* g_ptDenoiseShaderCode = R"HLSL(
 Texture2D<float4> InputTexture : register(t0);
 RWTexture2D<float4> OutputTexture : register(u0);
+RWTexture2D<float4> HistoryTexture : register(u1);   // TemporalCS only, read-modify-write in place
 
 cbuffer DenoiseCB : register(b0)
 {
@@ -12,6 +14,7 @@ cbuffer DenoiseCB : register(b0)
     uint Height;
     uint StepSize;      // 1, 2, 4, 8 for à-trous iterations
     float ColorSigma;   // Color similarity weight
+    float TemporalAlpha;    // TemporalCS: weight of the new frame (1 = reset history)
 };
 
 // Gaussian kernel 5x5 (precomputed weights)
@@ -22,7 +25,7 @@ float Luminance(float3 c)
     return dot(c, float3(0.299f, 0.587f, 0.114f));
 }
 
-[numthreads(8, 8, 1)]
+GROUP_SHAPE
 void DenoiseCS(uint3 dispatchThreadID : SV_DispatchThreadID)
 {
     int2 pixel = int2(dispatchThreadID.xy);
@@ -74,4 +77,33 @@ void DenoiseCS(uint3 dispatchThreadID : SV_DispatchThreadID)
     float3 result = colorSum / max(weightSum, 0.0001f);
     OutputTexture[pixel] = float4(result, 1.0f);
 }
+
+// Exponential moving average with the history clamped to the 3x3 range of
+// the current frame, so the moving cubes don't leave trails
+GROUP_SHAPE
+void TemporalCS(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    int2 pixel = int2(dispatchThreadID.xy);
+    if (pixel.x >= (int)Width || pixel.y >= (int)Height)
+        return;
+
+    float3 current = InputTexture[pixel].rgb;
+    float3 boxMin = current;
+    float3 boxMax = current;
+    for (int dy = -1; dy <= 1; dy++)
+    {
+        for (int dx = -1; dx <= 1; dx++)
+        {
+            int2 samplePos = clamp(pixel + int2(dx, dy), int2(0, 0), int2(Width - 1, Height - 1));
+            float3 c = InputTexture[samplePos].rgb;
+            boxMin = min(boxMin, c);
+            boxMax = max(boxMax, c);
+        }
+    }
+
+    float3 history = clamp(HistoryTexture[pixel].rgb, boxMin, boxMax);
+    float3 result = lerp(history, current, TemporalAlpha);
+    HistoryTexture[pixel] = float4(result, 1.0f);
+    OutputTexture[pixel] = float4(result, 1.0f);
+}
 )HLSL";
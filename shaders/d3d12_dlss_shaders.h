@@ -11,11 +11,31 @@ cbuffer PathTraceCB : register(b0)
     float4x4 PrevViewProj;  // Previous frame's ViewProj for motion vectors
     float Time;
     uint FrameCount;
-    uint Width;
+    uint Width;             // Input (render) size, <= G-buffer size
     uint Height;
+    float2 Jitter;          // Halton camera jitter in pixels, reported to DLSS-RR
 };
 
-// Vertex structure matching CPU side (pos, normal, objectID, materialType)
+// Vertex structure matching CPU side (pos, normal, objectID, materialType).
+// COMPACT_VERTS (--compact-verts, rt_geometry.h): float3 pos + octahedral normal
+#ifdef COMPACT_VERTS
+struct Vertex
+{
+    float3 pos;
+    uint normal;
+};
+
+float3 OctDecodeNormal(uint p)
+{
+    int2 s = int2(asint(p << 16), asint(p)) >> 16;
+    float2 e = max(float2(s) / 32767.0, -1.0);
+    float3 n = float3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+#else
 struct Vertex
 {
     float3 pos;
@@ -23,6 +43,7 @@ struct Vertex
     uint objectID;
     uint materialType;
 };
+#endif
 
 // Material types
 #define MAT_DIFFUSE  0
@@ -46,8 +67,25 @@ struct Vertex
 // Resources
 RaytracingAccelerationStructure Scene : register(t0);
 StructuredBuffer<Vertex> Vertices : register(t1);
+#ifdef COMPACT_VERTS
+float3 VertexNormal(uint i) { return OctDecodeNormal(Vertices[i].normal); }
+#else
+float3 VertexNormal(uint i) { return Vertices[i].normal; }
+#endif
+#ifdef INDEX16
+ByteAddressBuffer Indices : register(t2);   // Packed 16-bit indices, raw view
+
+uint LoadIndex(uint i)
+{
+    uint word = Indices.Load((i * 2) & ~3u);
+    return (i & 1) ? (word >> 16) : (word & 0xFFFF);
+}
+#else
 StructuredBuffer<uint> Indices : register(t2);
 
+uint LoadIndex(uint i) { return Indices[i]; }
+#endif
+
 // G-Buffer outputs for DLSS-RR
 RWTexture2D<float4> OutputColor : register(u0);           // Noisy path traced color (linear HDR)
 RWTexture2D<float4> OutputDiffuseAlbedo : register(u1);   // Diffuse albedo
@@ -107,21 +145,7 @@ static const float3 SpotlightDir = normalize(float3(0, -1, 0.15));
 static const float SpotInnerCos = 0.85;
 static const float SpotOuterCos = 0.5;
 
-uint WangHash(uint seed)
-{
-    seed = (seed ^ 61) ^ (seed >> 16);
-    seed *= 9;
-    seed = seed ^ (seed >> 4);
-    seed *= 0x27d4eb2d;
-    seed = seed ^ (seed >> 15);
-    return seed;
-}
-
-float RandomFloat(inout uint seed)
-{
-    seed = WangHash(seed);
-    return float(seed) / 4294967296.0;
-}
+// RTSampler / WangHash: g_rtSamplingShaderCode, compiled in front of this
 
 // Rotation matrices
 float3x3 RotateY(float angle) {
@@ -197,12 +221,11 @@ float3 CosineSampleHemisphere(float2 u, float3 N)
     return normalize(tangent * x + bitangent * y + N * z);
 }
 
-float3 RandomInDisk(inout uint seed)
+float3 RandomInDisk(inout RTSampler rng)
 {
-    float u1 = RandomFloat(seed);
-    float u2 = RandomFloat(seed);
-    float r = sqrt(u1);
-    float theta = 2.0 * PI * u2;
+    float2 u = Sample2D(rng);
+    float r = sqrt(u.x);
+    float theta = 2.0 * PI * u.y;
     return float3(r * cos(theta), 0, r * sin(theta));
 }
 
@@ -211,17 +234,19 @@ float FresnelSchlick(float cosTheta, float F0)
     return F0 + (1.0 - F0) * pow(saturate(1.0 - cosTheta), 5.0);
 }
 
-[numthreads(8, 8, 1)]
+GROUP_SHAPE
 void PathTraceDlssCS(uint3 dispatchThreadID : SV_DispatchThreadID)
 {
     uint2 pixel = dispatchThreadID.xy;
     if (pixel.x >= Width || pixel.y >= Height)
         return;
 
-    uint seed = WangHash(pixel.x + pixel.y * Width + FrameCount * Width * Height);
+    // One path per pixel and frame: frame n is sample n of the pixel's sequence
+    RTSampler rng = SamplerCreate(pixel, Width, Height, FrameCount, FrameCount);
 
-    // Jittered pixel for AA
-    float2 jitter = float2(RandomFloat(seed), RandomFloat(seed));
+    // Jittered pixel for AA: one known sub-pixel offset per frame so DLSS-RR
+    // can reconstruct across frames (and upscale the reduced input)
+    float2 jitter = 0.5 + Jitter;
     float2 uv = (float2(pixel) + jitter) / float2(Width, Height);
     uv = uv * 2.0 - 1.0;
     uv.y = -uv.y;
@@ -264,7 +289,7 @@ void PathTraceDlssCS(uint3 dispatchThreadID : SV_DispatchThreadID)
         {
             float t = q.CommittedRayT();
             uint primID = q.CommittedPrimitiveIndex();
-            uint instID = q.CommittedInstanceID();
+            uint instID = q.CommittedInstanceIndex();   // InstanceID is the PT table base (d3d12_rt_tables.cpp)
             float2 bary = q.CommittedTriangleBarycentrics();
             float3 hitPos = rayOrigin + rayDir * t;
 
@@ -290,14 +315,14 @@ void PathTraceDlssCS(uint3 dispatchThreadID : SV_DispatchThreadID)
                 roughness = ObjectRoughness[min(objID, 10u)];
 
                 // Interpolate normals from vertex data
-                uint i0 = Indices[primID * 3 + 0];
-                uint i1 = Indices[primID * 3 + 1];
-                uint i2 = Indices[primID * 3 + 2];
+                uint i0 = LoadIndex(primID * 3 + 0);
+                uint i1 = LoadIndex(primID * 3 + 1);
+                uint i2 = LoadIndex(primID * 3 + 2);
                 float w = 1.0 - bary.x - bary.y;
                 hitNormal = normalize(
-                    Vertices[i0].normal * w +
-                    Vertices[i1].normal * bary.x +
-                    Vertices[i2].normal * bary.y
+                    VertexNormal(i0) * w +
+                    VertexNormal(i1) * bary.x +
+                    VertexNormal(i2) * bary.y
                 );
             }
 
@@ -362,7 +387,7 @@ void PathTraceDlssCS(uint3 dispatchThreadID : SV_DispatchThreadID)
                 float3 n = hitNormal;
                 if (cosi < 0) { cosi = -cosi; n = -n; eta = 1.0 / eta; }
                 float fresnel = FresnelSchlick(cosi, 0.04);
-                if (RandomFloat(seed) < fresnel) {
+                if (Sample1D(rng) < fresnel) {
                     rayDir = reflect(rayDir, n);
                     rayOrigin = hitPos + n * 0.001;
                 } else {
@@ -381,7 +406,7 @@ void PathTraceDlssCS(uint3 dispatchThreadID : SV_DispatchThreadID)
 
             // Diffuse - direct lighting with spotlight
             float3 directLight = float3(0, 0, 0);
-            float3 lightSample = LightPos + RandomInDisk(seed) * LightRadius;
+            float3 lightSample = LightPos + RandomInDisk(rng) * LightRadius;
             float3 toLight = lightSample - hitPos;
             float lightDist = length(toLight);
             toLight /= lightDist;
@@ -412,12 +437,12 @@ void PathTraceDlssCS(uint3 dispatchThreadID : SV_DispatchThreadID)
             // Russian roulette
             if (bounce > 0) {
                 float p = max(throughput.x, max(throughput.y, throughput.z));
-                if (RandomFloat(seed) > p || p < 0.01) break;
+                if (Sample1D(rng) > p || p < 0.01) break;
                 throughput /= p;
             }
 
             // Indirect bounce
-            float2 u = float2(RandomFloat(seed), RandomFloat(seed));
+            float2 u = Sample2D(rng);
             rayDir = CosineSampleHemisphere(u, hitNormal);
             rayOrigin = hitPos + hitNormal * 0.001;
             throughput *= albedo;
@@ -440,3 +465,81 @@ void PathTraceDlssCS(uint3 dispatchThreadID : SV_DispatchThreadID)
     OutputMotionVectors[pixel] = motionVector;
 }
 )HLSL";
+
+// ============== FRAME INTERPOLATION (--frame-interp) ==============
+// Midpoint frame between the previous and the current DLSS-RR output. Each
+// output pixel follows the motion of the nearest surface around it in the
+// G-buffer (depth-dilated motion vectors, so foreground edges carry their own
+// motion) back into the previous frame and forward into the current one.
+// The previous sample is clamped to the current neighbourhood to suppress
+// ghosting where the surface was disoccluded.
+
+static const char* g_frameGenShaderCode = R"HLSL(
+Texture2D<float4> CurrColor : register(t0);       // This frame's DLSS-RR output (output size)
+Texture2D<float4> PrevColor : register(t1);       // Last frame's DLSS-RR output
+Texture2D<float2> MotionVectors : register(t2);   // Input pixels, current - previous position
+Texture2D<float> LinearDepth : register(t3);      // Input pixels, first hit distance
+RWTexture2D<float4> Output : register(u0);
+SamplerState LinearClamp : register(s0);
+
+cbuffer FrameGenCB : register(b0)
+{
+    uint OutputWidth;
+    uint OutputHeight;
+    uint InputWidth;    // Traced subrect of the G-buffer
+    uint InputHeight;
+    float Phase;        // Generated frame time between previous (0) and current (1)
+};
+
+[numthreads(8, 8, 1)]
+void FrameGenCS(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    int2 pixel = int2(dispatchThreadID.xy);
+    if (pixel.x >= (int)OutputWidth || pixel.y >= (int)OutputHeight)
+        return;
+
+    float2 outSize = float2(OutputWidth, OutputHeight);
+    float2 inScale = float2(InputWidth, InputHeight) / outSize;
+    int2 inPixel = int2((float2(pixel) + 0.5f) * inScale);
+    int2 inMax = int2(InputWidth - 1, InputHeight - 1);
+
+    float nearest = 1e30f;
+    float2 motion = 0.0f;
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            int2 p = clamp(inPixel + int2(x, y), int2(0, 0), inMax);
+            float d = LinearDepth[p];
+            if (d < nearest)
+            {
+                nearest = d;
+                motion = MotionVectors[p];
+            }
+        }
+    }
+    float2 motionUV = motion / inScale / outSize;
+
+    float2 uv = (float2(pixel) + 0.5f) / outSize;
+    float2 currUV = uv + motionUV * (1.0f - Phase);
+    float3 curr = CurrColor.SampleLevel(LinearClamp, currUV, 0).rgb;
+    float3 prev = PrevColor.SampleLevel(LinearClamp, uv - motionUV * Phase, 0).rgb;
+
+    int2 currPixel = clamp(int2(currUV * outSize), int2(0, 0), int2(OutputWidth - 1, OutputHeight - 1));
+    float3 minC = curr;
+    float3 maxC = curr;
+    for (int ny = -1; ny <= 1; ny++)
+    {
+        for (int nx = -1; nx <= 1; nx++)
+        {
+            int2 p = clamp(currPixel + int2(nx, ny), int2(0, 0), int2(OutputWidth - 1, OutputHeight - 1));
+            float3 c = CurrColor[p].rgb;
+            minC = min(minC, c);
+            maxC = max(maxC, c);
+        }
+    }
+    prev = clamp(prev, minC, maxC);
+
+    Output[pixel] = float4(lerp(prev, curr, Phase), 1.0f);
+}
+)HLSL";
@@ -0,0 +1,227 @@
+#pragma once
+// ============== D3D12 MESH SHADERS ==============
+// Amplification + mesh + pixel shader for the --mesh-shaders path of the D3D12
+// base renderer. The rounded cubes are evaluated per vertex from per-cube
+// parameters (GenRoundedFace in cube_geometry.cpp, scalar), so there is no
+// vertex or index buffer. Every face grid is cut into 3 x 3 meshlets of at
+// most 7 x 7 cells (64 vertices, 98 triangles); the amplification shader
+// frustum and normal-cone culls them before DispatchMesh.
+// Geometry constants must match cube_geometry.h, transforms match VS /
+// VSInstanced in d3d11_shaders.h, InFrustum matches d3d12_cull_shaders.h.
+
+static const char* g_d3d12MeshShaderCode = R"HLSL(
+cbuffer MeshCB : register(b0) {
+    float Time;
+    float Aspect;
+    uint  MeshletCount;     // Cubes * MeshletsPerCube
+    uint  GroupsX;          // Amplification groups per dispatch row
+};
+
+struct MeshCube {
+    float3 offset;          // Scene cube: corner offset, --cubes: instance offset
+    float  scale;
+    float4 color;
+    uint   faceMask;        // Bit f: face f is drawn
+    uint   outerEdges;      // Bit f*4+e: edge e (+u, -u, +v, -v) of face f rounds outward
+    uint2  _pad;
+};
+
+StructuredBuffer<MeshCube> Cubes : register(t0);
+RWByteAddressBuffer        Stats : register(u0);   // Visible meshlets, visible triangles
+
+static const float CubeSize = 0.95f;
+static const float Radius = 0.12f;
+static const uint  Segments = 20;
+static const uint  TileCells = 7;
+static const uint  Tiles = 3;                       // ceil(Segments / TileCells)
+static const uint  MeshletsPerFace = Tiles * Tiles;
+static const uint  MeshletsPerCube = 6 * MeshletsPerFace;
+
+static const float3 FaceN[6] = { float3(0,0,1), float3(0,0,-1), float3(1,0,0), float3(-1,0,0), float3(0,1,0), float3(0,-1,0) };
+static const float3 FaceU[6] = { float3(-1,0,0), float3(1,0,0), float3(0,0,1), float3(0,0,-1), float3(1,0,0), float3(1,0,0) };
+static const float3 FaceV[6] = { float3(0,1,0), float3(0,1,0), float3(0,1,0), float3(0,1,0), float3(0,0,1), float3(0,0,-1) };
+
+static const matrix View = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,4,1 };
+static const matrix Proj = { 2.41421f,0,0,0, 0,2.41421f,0,0, 0,0,1.001f,1, 0,0,-0.1001f,0 };
+static const float ProjScale = 2.41421f;
+static const float NearZ = 0.1f;
+static const float3 LightDir = normalize(float3(0.2f, 1.0f, 0.3f));
+
+float3x3 RotY(float a) { float c=cos(a),s=sin(a); return float3x3(c,0,s,0,1,0,-s,0,c); }
+float3x3 RotX(float a) { float c=cos(a),s=sin(a); return float3x3(1,0,0,0,c,-s,0,s,c); }
+
+uint TileStart(uint t) { return t * TileCells; }
+uint TileCellCount(uint t) { return min(TileCells, Segments - t * TileCells); }
+float EdgeRadius(uint outerEdges, uint face, uint edge) { return ((outerEdges >> (face * 4 + edge)) & 1) ? Radius : -Radius; }
+
+bool InFrustum(float3 c, float r) {
+    float a = ProjScale / ((Aspect > 0.0f) ? Aspect : 1.33333f);
+    if (c.z + r < NearZ) return false;
+    if ((a * c.x - c.z) * rsqrt(a * a + 1) > r) return false;
+    if ((-a * c.x - c.z) * rsqrt(a * a + 1) > r) return false;
+    if ((ProjScale * c.y - c.z) * rsqrt(ProjScale * ProjScale + 1) > r) return false;
+    if ((-ProjScale * c.y - c.z) * rsqrt(ProjScale * ProjScale + 1) > r) return false;
+    return true;
+}
+
+// Grid point (i, j) of a face in object space, same cases as GenRoundedFace:
+// inward-only corners take the cylinder of the side that reaches further in,
+// everything else is projected from the inner box (45 degree split on edges
+// shared with another drawn face).
+void FaceVertex(uint face, uint i, uint j, uint outerEdges, out float3 pos, out float3 norm) {
+    float h = CubeSize * 0.5f;
+    float u = (float)i / Segments * 2 - 1;
+    float v = (float)j / Segments * 2 - 1;
+    float rURaw = EdgeRadius(outerEdges, face, (u > 0) ? 0 : 1);
+    float rVRaw = EdgeRadius(outerEdges, face, (v > 0) ? 2 : 3);
+    float rU = abs(rURaw), rV = abs(rVRaw);
+    bool outerU = rURaw > 0, outerV = rVRaw > 0;
+    float sgnU = (u > 0) ? 1.0f : -1.0f, sgnV = (v > 0) ? 1.0f : -1.0f;
+    float px0 = u * h, py0 = v * h;
+    float innerU = h - rU, innerV = h - rV;
+    float dx = max(0, abs(px0) - innerU), dy = max(0, abs(py0) - innerV);
+    bool hasDx = dx > 0, hasDy = dy > 0;
+
+    float3 p = float3(px0, py0, h), n = float3(0, 0, 1);
+    if (!outerU && !outerV && hasDx && hasDy) {
+        if (dx >= dy) {
+            float cz = sqrt(max(0, rU * rU - dx * dx));
+            p = float3(sgnU * (innerU + dx), py0, innerU + cz);
+            n = float3(sgnU * dx / rU, 0, cz / rU);
+        } else {
+            float cz = sqrt(max(0, rV * rV - dy * dy));
+            p = float3(px0, sgnV * (innerV + dy), innerV + cz);
+            n = float3(0, sgnV * dy / rV, cz / rV);
+        }
+    } else {
+        float r = max(hasDx ? rU : 0, hasDy ? rV : 0);
+        if (r > 0) {
+            float s2 = r * r - ((!outerU && hasDx) ? dx * dx : 0) - ((!outerV && hasDy) ? dy * dy : 0);
+            float sz = sqrt(max(0, s2));
+            float3 a = float3(outerU ? dx * sz / r : dx, outerV ? dy * sz / r : dy, sz);
+            float alen = length(a);
+            float3 d = a / ((alen > 0) ? alen : 1);
+            float centre = h - r;
+            p = float3(hasDx ? sgnU * (centre + r * d.x) : px0, hasDy ? sgnV * (centre + r * d.y) : py0, centre + r * d.z);
+            n = float3(sgnU * d.x, sgnV * d.y, d.z);
+        }
+    }
+    pos = p.x * FaceU[face] + p.y * FaceV[face] + p.z * FaceN[face];
+    float3 on = n.x * FaceU[face] + n.y * FaceV[face] + n.z * FaceN[face];
+    float len = length(on);
+    norm = on / ((len < 0.001f) ? 1 : len);
+}
+
+void DecodeMeshlet(uint id, out uint cube, out uint face, out uint tu, out uint tv) {
+    cube = id / MeshletsPerCube;
+    uint inCube = id % MeshletsPerCube;
+    face = inCube / MeshletsPerFace;
+    tu = (inCube % MeshletsPerFace) % Tiles;
+    tv = (inCube % MeshletsPerFace) / Tiles;
+}
+
+// Frustum + backface test of one face tile. The tile lies in the slab between
+// the flat face and Radius below it. Its normals are within a cone around the
+// face normal: 45 degrees up an outward edge, 54.7 at an outward corner; an
+// inward edge sweeps the full 90, so such tiles skip the cone test.
+bool MeshletVisible(MeshCube cube, uint face, uint tu, uint tv, float3x3 rot) {
+    float h = CubeSize * 0.5f;
+    float u0 = (float)TileStart(tu) / Segments * 2 - 1, u1 = (float)(TileStart(tu) + TileCellCount(tu)) / Segments * 2 - 1;
+    float v0 = (float)TileStart(tv) / Segments * 2 - 1, v1 = (float)(TileStart(tv) + TileCellCount(tv)) / Segments * 2 - 1;
+
+    float3 tileCentre = FaceU[face] * ((u0 + u1) * 0.5f * h) + FaceV[face] * ((v0 + v1) * 0.5f * h) + FaceN[face] * (h - Radius * 0.5f);
+    float3 c = mul(tileCentre * cube.scale + cube.offset, rot) + float3(0, 0, 4);
+    float r = length(float3((u1 - u0) * h, (v1 - v0) * h, Radius)) * 0.5f * cube.scale;
+    if (!InFrustum(c, r)) return false;
+
+    float inner = h - Radius;
+    bool touches[4] = { u1 * h > inner, u0 * h < -inner, v1 * h > inner, v0 * h < -inner };
+    float dx = 0, dy = 0;
+    [unroll] for (uint e = 0; e < 4; e++) {
+        if (!touches[e]) continue;
+        if (EdgeRadius(cube.outerEdges, face, e) < 0) return true;
+        if (e < 2) dx = Radius; else dy = Radius;
+    }
+    float cosA = Radius * rsqrt(dx * dx + dy * dy + Radius * Radius);
+    float sinA = sqrt(1 - cosA * cosA);
+    float3 axis = mul(FaceN[face], rot);
+    return dot(c, axis) < sinA * length(c) + r;
+}
+
+// ============== AMPLIFICATION ==============
+struct Payload { uint meshlets[32]; };
+groupshared Payload s_payload;
+groupshared uint s_visible;
+groupshared uint s_triangles;
+
+[numthreads(32, 1, 1)]
+void ASMain(uint3 gid : SV_GroupID, uint tid : SV_GroupIndex) {
+    if (tid == 0) { s_visible = 0; s_triangles = 0; }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint id = (gid.y * GroupsX + gid.x) * 32 + tid;
+    if (id < MeshletCount) {
+        uint cubeIdx, face, tu, tv;
+        DecodeMeshlet(id, cubeIdx, face, tu, tv);
+        MeshCube cube = Cubes[cubeIdx];
+        float3x3 rot = mul(RotY(Time*1.2f), RotX(Time*0.7f));
+        if (((cube.faceMask >> face) & 1) && MeshletVisible(cube, face, tu, tv, rot)) {
+            uint slot;
+            InterlockedAdd(s_visible, 1, slot);
+            InterlockedAdd(s_triangles, TileCellCount(tu) * TileCellCount(tv) * 2);
+            s_payload.meshlets[slot] = id;
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (tid == 0 && s_visible > 0) {
+        Stats.InterlockedAdd(0, s_visible);
+        Stats.InterlockedAdd(4, s_triangles);
+    }
+    DispatchMesh(s_visible, 1, 1, s_payload);
+}
+
+// ============== MESH ==============
+struct MSVert { float4 pos : SV_POSITION; float3 worldNorm : NORMAL; float4 color : COLOR; };
+
+[outputtopology("triangle")]
+[numthreads(64, 1, 1)]
+void MSMain(uint gtid : SV_GroupThreadID, uint3 gid : SV_GroupID, in payload Payload p,
+            out vertices MSVert verts[64], out indices uint3 tris[98]) {
+    uint cubeIdx, face, tu, tv;
+    DecodeMeshlet(p.meshlets[gid.x], cubeIdx, face, tu, tv);
+    uint cu = TileCellCount(tu), cv = TileCellCount(tv);
+    uint rowLen = cu + 1;
+    uint vertCount = rowLen * (cv + 1), triCount = cu * cv * 2;
+    SetMeshOutputCounts(vertCount, triCount);
+
+    if (gtid < vertCount) {
+        MeshCube cube = Cubes[cubeIdx];
+        float3 pos, norm;
+        FaceVertex(face, TileStart(tu) + gtid % rowLen, TileStart(tv) + gtid / rowLen, cube.outerEdges, pos, norm);
+
+        float3x3 rot = mul(RotY(Time*1.2f), RotX(Time*0.7f));
+        float3 worldPos = mul(pos * cube.scale + cube.offset, rot);
+        MSVert o;
+        o.pos = mul(mul(float4(worldPos,1), View), Proj);
+        o.pos.x /= (Aspect > 0.0f) ? Aspect : 1.33333f;
+        o.worldNorm = mul(norm, rot);
+        o.color = cube.color;
+        verts[gtid] = o;
+    }
+
+    // Same winding as the CPU grid: (a, a+row, a+1), (a+1, a+row, a+row+1)
+    for (uint t = gtid; t < triCount; t += 64) {
+        uint cell = t >> 1;
+        uint a = (cell / cu) * rowLen + cell % cu;
+        tris[t] = (t & 1) ? uint3(a + 1, a + rowLen, a + rowLen + 1) : uint3(a, a + rowLen, a + 1);
+    }
+}
+
+// ============== PIXEL ==============
+float4 PSMain(MSVert i) : SV_TARGET {
+    float3 n = normalize(i.worldNorm);
+    float d = max(dot(n, LightDir), 0) * 0.65f + 0.35f;
+    return float4(i.color.rgb * d, 1);
+}
+)HLSL";
@@ -1,7 +1,9 @@
 #pragma once
 // ============== D3D12 PATH TRACING COMPUTE SHADER ==============
 // Cornell Box scene with path tracing (matching RT renderer)
-// Shader Model 6.5 with RayQuery for inline ray tracing
+// Shader Model 6.5 with RayQuery for inline ray tracing. The scene helpers
+// are shared with the --wavefront kernels (d3d12_pt_wavefront_shaders.h).
+// Compiled after g_rtSamplingShaderCode (RTSampler, WangHash).
 
 static const char* g_ptShaderCode = R"HLSL(
 // Constant buffer with camera and timing data
@@ -13,6 +15,14 @@ cbuffer PathTraceCB : register(b0)
     uint FrameCount;
     uint Width;
     uint Height;
+    uint AccumFrame;    // --accumulate: sample index written this frame (1 = restart), 0 = off
+    uint SamplesPerPixel;   // --spp: paths per pixel per frame
+    uint MaxBounces;        // --bounces: path length limit
+    uint AdaptiveMaxSpp;    // --adaptive: per-tile sample budget, 0 = off
+    float AdaptiveTarget;   // --adaptive: standard error goal of the tone mapped pixel mean
+    uint LightCount;        // --lights: entries of Lights (1 = the spotlight only)
+    uint LightSampling;     // --light-sampling: LIGHT_SAMPLING_*
+    uint RowOffset;         // --split-gpu: first image row of this dispatch, 0 otherwise
 };
 
 // Vertex structure matching CPU side (pos, normal, objectID, materialType)
@@ -48,34 +58,31 @@ RaytracingAccelerationStructure Scene : register(t0);
 StructuredBuffer<Vertex> Vertices : register(t1);
 StructuredBuffer<uint> Indices : register(t2);
 RWTexture2D<float4> Output : register(u0);
+RWTexture2D<float4> AccumSum : register(u1);   // FP32 radiance sum, .w = sample count
+RWByteAddressBuffer SampleCounter : register(u2);   // --adaptive: paths traced (wraps, read as deltas)
 
-// Cornell Box colors (matching RT shader)
-static const float3 Colors[11] = {
-    float3(0.7, 0.7, 0.7),    // 0: Floor - grey
-    float3(0.9, 0.9, 0.9),    // 1: Ceiling - white
-    float3(0.7, 0.7, 0.7),    // 2: Back wall - grey (like floor)
-    float3(0.75, 0.15, 0.15), // 3: Left wall - RED
-    float3(0.15, 0.75, 0.15), // 4: Right wall - GREEN
-    float3(15.0, 14.0, 12.0), // 5: Light - bright emissive
-    float3(0.9, 0.6, 0.2),    // 6: Cube - orange (fallback)
-    float3(0.95, 0.95, 0.95), // 7: Mirror - neutral
-    float3(0.9, 0.95, 1.0),   // 8: Glass - slight blue tint
-    float3(0.9, 0.15, 0.1),   // 9: Small cube behind glass - RED
-    float3(0.5, 0.15, 0.7)    // 10: Front wall - PURPLE
+// Hit surface lookup (d3d12_rt_tables.cpp): one entry per triangle, the TLAS
+// instance's InstanceID is the index of its BLAS's first triangle
+struct Primitive
+{
+    float3 normal;      // Object space face normal
+    uint material;
 };
 
-// Cube colors (8 cubes, same as D3D12 base renderer)
-static const float3 CubeColors[8] = {
-    float3(0.95, 0.2, 0.15),  // 0: Red
-    float3(0.2, 0.7, 0.3),    // 1: Green
-    float3(0.15, 0.5, 0.95),  // 2: Blue
-    float3(1.0, 0.85, 0.0),   // 3: Yellow
-    float3(1.0, 0.85, 0.0),   // 4: Yellow
-    float3(0.15, 0.5, 0.95),  // 5: Blue
-    float3(0.2, 0.7, 0.3),    // 6: Green
-    float3(0.95, 0.2, 0.15)   // 7: Red
+struct Material
+{
+    float3 albedo;
+    uint type;          // MAT_*
+    uint objectID;      // OBJ_*
+    uint3 pad;
 };
 
+StructuredBuffer<Primitive> Primitives : register(t3);
+StructuredBuffer<Material> Materials : register(t4);
+
+// Adaptive sampling: per tile (thread group) maximum of the pixel errors
+groupshared float gs_tileError[GROUP_THREADS];
+
 // Light properties (adjusted for larger room s=2.0)
 static const float3 LightPos = float3(0, 1.92, 0);
 static const float3 LightColor = float3(1.0, 0.95, 0.9);
@@ -88,101 +95,12 @@ static const float3 SpotlightDir = normalize(float3(0, -1, 0.15));
 static const float SpotInnerCos = 0.85;  // ~32 degrees - full intensity
 static const float SpotOuterCos = 0.5;   // ~60 degrees - falloff edge
 
-// Wang hash for random number generation
-uint WangHash(uint seed)
+// First sample of this frame in each pixel's sampler sequence (rt_sampling.h):
+// frame * the most paths a pixel can trace per frame, so frames don't overlap
+uint FrameSampleBase()
 {
-    seed = (seed ^ 61) ^ (seed >> 16);
-    seed *= 9;
-    seed = seed ^ (seed >> 4);
-    seed *= 0x27d4eb2d;
-    seed = seed ^ (seed >> 15);
-    return seed;
-}
-
-float RandomFloat(inout uint seed)
-{
-    seed = WangHash(seed);
-    return float(seed) / 4294967296.0;
-}
-
-// Rotation matrices (for cube normal transform)
-float3x3 RotateY(float angle) {
-    float c = cos(angle);
-    float s = sin(angle);
-    return float3x3(
-        c,  0, s,
-        0,  1, 0,
-        -s, 0, c
-    );
-}
-
-float3x3 RotateX(float angle) {
-    float c = cos(angle);
-    float s = sin(angle);
-    return float3x3(
-        1,  0,  0,
-        0,  c, -s,
-        0,  s,  c
-    );
-}
-
-// Get cube face normal in object space from primitive ID
-float3 GetCubeFaceNormal(uint primID) {
-    uint triangleInCube = primID % 12;
-    uint faceIndex = triangleInCube / 2;
-    // Face order matches AddBox: Front(+Z), Back(-Z), Right(+X), Left(-X), Top(+Y), Bottom(-Y)
-    if (faceIndex == 0) return float3(0, 0, 1);
-    if (faceIndex == 1) return float3(0, 0, -1);
-    if (faceIndex == 2) return float3(1, 0, 0);
-    if (faceIndex == 3) return float3(-1, 0, 0);
-    if (faceIndex == 4) return float3(0, 1, 0);
-    return float3(0, -1, 0);
-}
-
-// Transform cube normal from object space to world space
-float3 TransformCubeNormal(float3 localNormal) {
-    float angleY = Time * 1.2;
-    float angleX = Time * 0.7;
-    float3x3 rotY = RotateY(angleY);
-    float3x3 rotX = RotateX(angleX);
-    float3x3 rot = mul(rotY, rotX);
-    return normalize(mul(localNormal, rot));
-}
-
-// Get color from primitive ID (static geometry only)
-// Order: Floor(2), Ceiling(2), Back(2), Left(2), Right(2), Light(2), Mirror(2), SmallCube(12), Glass(4)
-float3 GetColorFromPrimitive(uint primID, out uint objID) {
-    if (primID < 2) objID = OBJ_FLOOR;
-    else if (primID < 4) objID = OBJ_CEILING;
-    else if (primID < 6) objID = OBJ_BACK_WALL;
-    else if (primID < 8) objID = OBJ_LEFT_WALL;
-    else if (primID < 10) objID = OBJ_RIGHT_WALL;
-    else if (primID < 12) objID = OBJ_LIGHT;
-    else if (primID < 14) objID = OBJ_MIRROR;
-    else if (primID < 26) objID = OBJ_SMALL_CUBE;
-    else objID = OBJ_GLASS;  // primID 26-29 (no front wall)
-    return Colors[min(objID, 10u)];
-}
-
-// Get material type from object ID
-uint GetMaterialFromObject(uint objID) {
-    if (objID == OBJ_LIGHT) return MAT_EMISSIVE;
-    if (objID == OBJ_MIRROR) return MAT_MIRROR;
-    if (objID == OBJ_GLASS) return MAT_GLASS;
-    return MAT_DIFFUSE;
-}
-
-// Get approximate normal for object
-float3 GetNormalForObject(uint objID) {
-    if (objID == OBJ_FLOOR) return float3(0, 1, 0);
-    if (objID == OBJ_CEILING) return float3(0, -1, 0);
-    if (objID == OBJ_BACK_WALL) return float3(0, 0, -1);
-    if (objID == OBJ_LEFT_WALL) return float3(1, 0, 0);
-    if (objID == OBJ_RIGHT_WALL) return float3(-1, 0, 0);
-    if (objID == OBJ_LIGHT) return float3(0, -1, 0);
-    if (objID == OBJ_MIRROR) return normalize(float3(0.707, 0, -0.707));
-    if (objID == OBJ_FRONT_WALL) return float3(0, 0, 1);
-    return float3(0, 0, -1);
+    uint budget = AdaptiveMaxSpp > 0 ? max(max(SamplesPerPixel, 2u), AdaptiveMaxSpp) : SamplesPerPixel;
+    return FrameCount * budget;
 }
 
 // Spotlight cone attenuation
@@ -209,12 +127,11 @@ float3 CosineSampleHemisphere(float2 u, float3 N)
 }
 
 // Random point on disk (for area light sampling)
-float3 RandomInDisk(inout uint seed)
+float3 RandomInDisk(inout RTSampler rng)
 {
-    float u1 = RandomFloat(seed);
-    float u2 = RandomFloat(seed);
-    float r = sqrt(u1);
-    float theta = 2.0 * PI * u2;
+    float2 u = Sample2D(rng);
+    float r = sqrt(u.x);
+    float theta = 2.0 * PI * u.y;
     return float3(r * cos(theta), 0, r * sin(theta));
 }
 
@@ -224,17 +141,307 @@ float FresnelSchlick(float cosTheta, float F0)
     return F0 + (1.0 - F0) * pow(saturate(1.0 - cosTheta), 5.0);
 }
 
-[numthreads(8, 8, 1)]
-void PathTraceCS(uint3 dispatchThreadID : SV_DispatchThreadID)
+// Table entry of a committed hit: instanceID = CommittedInstanceID()
+Primitive HitPrimitive(uint instanceID, uint primID)
 {
-    uint2 pixel = dispatchThreadID.xy;
-    if (pixel.x >= Width || pixel.y >= Height)
-        return;
+    return Primitives[instanceID + primID];
+}
+
+// World space normal of a hit primitive (instance transforms are rigid)
+float3 HitNormal(Primitive prim, float3x4 objectToWorld)
+{
+    return normalize(mul((float3x3)objectToWorld, prim.normal));
+}
+
+// Albedo, shading normal and material of a committed hit
+void GetHitSurface(uint instanceID, uint primID, float3x4 objectToWorld, out float3 albedo, out float3 hitNormal, out uint matType)
+{
+    Primitive prim = HitPrimitive(instanceID, primID);
+    Material m = Materials[prim.material];
+    albedo = m.albedo;
+    matType = m.type;
+    hitNormal = HitNormal(prim, objectToWorld);
+}
+
+// Glass: Fresnel-weighted choice between reflection and refraction
+void ScatterGlass(float3 hitPos, float3 hitNormal, inout float3 rayOrigin, inout float3 rayDir, inout RTSampler rng)
+{
+    float eta = 1.5;  // Glass IOR
+    float cosi = -dot(rayDir, hitNormal);
+    float3 n = hitNormal;
+
+    if (cosi < 0) {
+        cosi = -cosi;
+        n = -n;
+        eta = 1.0 / eta;
+    }
+
+    float fresnel = FresnelSchlick(cosi, 0.04);
+
+    if (Sample1D(rng) < fresnel) {
+        rayDir = reflect(rayDir, n);
+        rayOrigin = hitPos + n * 0.001;
+    } else {
+        float k = 1.0 - (1.0 / eta) * (1.0 / eta) * (1.0 - cosi * cosi);
+        if (k < 0) {
+            rayDir = reflect(rayDir, n);
+            rayOrigin = hitPos + n * 0.001;
+        } else {
+            rayDir = (1.0 / eta) * rayDir + ((1.0 / eta) * cosi - sqrt(k)) * n;
+            rayOrigin = hitPos - n * 0.001;
+        }
+    }
+}
+
+// Diffuse next event estimation: unshadowed spotlight contribution of a
+// random point on the area light (0 when it faces away) and the shadow ray
+// that decides whether it counts
+float3 SampleAreaLight(float3 hitPos, float3 hitNormal, float3 albedo, inout RTSampler rng, out RayDesc shadowRay)
+{
+    float3 lightSample = LightPos + RandomInDisk(rng) * LightRadius;
+    float3 toLight = lightSample - hitPos;
+    float lightDist = length(toLight);
+    toLight /= lightDist;
+
+    shadowRay.Origin = hitPos + hitNormal * 0.001;
+    shadowRay.Direction = toLight;
+    shadowRay.TMin = 0.001;
+    shadowRay.TMax = lightDist - 0.01;
+
+    float NdotL = max(dot(hitNormal, toLight), 0);
+    if (NdotL <= 0)
+        return float3(0, 0, 0);
+    float distAtten = 1.0 / (1.0 + lightDist * lightDist * 0.08);
+    float spotAtten = SpotlightAttenuation(hitPos - LightPos);
+    float atten = distAtten * spotAtten * LightIntensity;
+    return albedo * LightColor * NdotL * atten / PI;
+}
+
+// ============== MANY LIGHTS ==============
+// --lights / --light-sampling (pt_lights.h), megakernel only: Lights[0] is the
+// spotlight of SampleAreaLight, the rest small ceiling emitters.
+#define LIGHT_SAMPLING_UNIFORM 0
+#define LIGHT_SAMPLING_RIS     1
+#define LIGHT_SAMPLING_RESTIR  2
+#define RIS_CANDIDATES 8
+#define RESTIR_MAX_M (20 * RIS_CANDIDATES)  // History clamp: old samples can't dominate
+#define RESTIR_SPATIAL_TAPS 3
+#define RESTIR_SPATIAL_RADIUS 16.0
+
+struct Light
+{
+    float3 pos;
+    float radius;
+    float3 emission;
+    float spotInnerCos;
+    float3 dir;
+    float spotOuterCos;
+};
+
+// ReSTIR: the light sample kept for a pixel's primary diffuse hit, its
+// contribution weight W and the candidate count M behind it, plus the surface
+// it was chosen for so reuse can reject neighbours on another surface. Two
+// halves of Width * Height, written and read alternately by frame parity.
+struct Reservoir
+{
+    uint normal;        // 10:10:10 unorm of n * 0.5 + 0.5
+    float depth;        // Primary hit distance
+    uint light;
+    uint disk;          // Point on the light disk, two halfs
+    float W;
+    float M;            // 0 = no reservoir
+};
+
+StructuredBuffer<Light> Lights : register(t0, space3);
+RWStructuredBuffer<Reservoir> Reservoirs : register(u0, space3);
+
+struct LightSample
+{
+    uint light;
+    float2 disk;        // In the unit disk, scaled by the light's radius
+};
+
+// Weighted reservoir sampling state (the streaming RIS of ReSTIR DI)
+struct RisReservoir
+{
+    LightSample y;
+    float wSum;
+    float M;
+    float pHat;         // Target function at y
+};
+
+uint PackNormal(float3 n)
+{
+    uint3 q = uint3(saturate(n * 0.5 + 0.5) * 1023.0 + 0.5);
+    return q.x | (q.y << 10) | (q.z << 20);
+}
+
+float3 UnpackNormal(uint p)
+{
+    return float3(p & 1023, (p >> 10) & 1023, (p >> 20) & 1023) / 1023.0 * 2.0 - 1.0;
+}
+
+// Unshadowed contribution of a light sample without the albedo (the same
+// falloff as SampleAreaLight); its luminance is the RIS target function
+float3 LightContribution(LightSample ls, float3 hitPos, float3 hitNormal, out float3 toLight, out float lightDist)
+{
+    Light l = Lights[ls.light];
+    float3 p = l.pos + float3(ls.disk.x, 0, ls.disk.y) * l.radius;
+    toLight = p - hitPos;
+    lightDist = length(toLight);
+    toLight /= lightDist;
+    float NdotL = max(dot(hitNormal, toLight), 0);
+    float distAtten = 1.0 / (1.0 + lightDist * lightDist * 0.08);
+    float cosAngle = dot(normalize(hitPos - l.pos), l.dir);
+    float spotAtten = saturate((cosAngle - l.spotOuterCos) / (l.spotInnerCos - l.spotOuterCos));
+    return l.emission * NdotL * distAtten * spotAtten / PI;
+}
+
+float TargetPdf(float3 contribution)
+{
+    return dot(contribution, float3(0.2126, 0.7152, 0.0722));
+}
 
-    uint seed = WangHash(pixel.x + pixel.y * Width + FrameCount * Width * Height);
+// Uniform over the lights, then uniform over the light's disk
+LightSample RandomLightSample(inout RTSampler rng)
+{
+    LightSample ls;
+    ls.light = LightCount > 1 ? min(uint(Sample1D(rng) * LightCount), LightCount - 1) : 0;
+    ls.disk = RandomInDisk(rng).xz;
+    return ls;
+}
+
+void ReservoirUpdate(inout RisReservoir r, LightSample s, float w, float pHat, float M, float u)
+{
+    r.wSum += w;
+    r.M += M;
+    if (w > 0 && u * r.wSum < w) {
+        r.y = s;
+        r.pHat = pHat;
+    }
+}
+
+// Contribution weight of the kept sample: wSum / (M * pHat(y))
+float ReservoirWeight(RisReservoir r)
+{
+    return r.pHat > 0 ? r.wSum / (r.M * r.pHat) : 0.0;
+}
+
+// RIS_CANDIDATES uniform candidates (source pdf 1 / LightCount per light, the
+// disk pdf is the same in both and cancels)
+RisReservoir InitialCandidates(float3 hitPos, float3 hitNormal, inout RTSampler rng)
+{
+    RisReservoir r = (RisReservoir)0;
+    for (uint i = 0; i < RIS_CANDIDATES; i++) {
+        LightSample s = RandomLightSample(rng);
+        float3 toLight;
+        float lightDist;
+        float pHat = TargetPdf(LightContribution(s, hitPos, hitNormal, toLight, lightDist));
+        ReservoirUpdate(r, s, pHat * LightCount, pHat, 1.0, Sample1D(rng));
+    }
+    return r;
+}
+
+// albedo * contribution * W and the shadow ray that decides whether it counts
+float3 ShadeLightSample(LightSample s, float W, float3 hitPos, float3 hitNormal, float3 albedo, out RayDesc shadowRay)
+{
+    float3 toLight;
+    float lightDist;
+    float3 c = LightContribution(s, hitPos, hitNormal, toLight, lightDist);
+    shadowRay.Origin = hitPos + hitNormal * 0.001;
+    shadowRay.Direction = toLight;
+    shadowRay.TMin = 0.001;
+    shadowRay.TMax = lightDist - 0.01;
+    return albedo * c * W;
+}
+
+// Next event estimation over Lights with uniform or RIS selection: the
+// unshadowed estimate and its shadow ray, like SampleAreaLight
+float3 SampleDirectLight(float3 hitPos, float3 hitNormal, float3 albedo, inout RTSampler rng, out RayDesc shadowRay)
+{
+    if (LightSampling == LIGHT_SAMPLING_UNIFORM) {
+        LightSample s = RandomLightSample(rng);
+        return ShadeLightSample(s, LightCount, hitPos, hitNormal, albedo, shadowRay);
+    }
+    RisReservoir r = InitialCandidates(hitPos, hitNormal, rng);
+    return ShadeLightSample(r.y, ReservoirWeight(r), hitPos, hitNormal, albedo, shadowRay);
+}
+
+bool ShadowRayHit(RayDesc shadowRay)
+{
+    RayQuery<RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH> shadowQ;
+    shadowQ.TraceRayInline(Scene, RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH, 0xFF, shadowRay);
+    shadowQ.Proceed();
+    CountRays(RAY_SHADOW, 1);
+    return shadowQ.CommittedStatus() == COMMITTED_TRIANGLE_HIT;
+}
+
+void ReservoirClear(uint2 pixel)
+{
+    uint current = (FrameCount & 1) * Width * Height;
+    Reservoirs[current + pixel.y * Width + pixel.x] = (Reservoir)0;
+}
+
+// ReSTIR DI at the pixel's primary diffuse hit: fresh candidates, then the
+// previous frame's reservoirs of the pixel (temporal) and of a few random
+// neighbours (spatial - also last frame's, so one dispatch does both) are
+// resampled at this surface. The kept sample is shadow tested once; an
+// occluded one is stored with W = 0 so it stops spreading. Returns the
+// shadowed direct light.
+float3 DirectLightReSTIR(uint2 pixel, float depth, float3 hitPos, float3 hitNormal, float3 albedo, inout RTSampler rng)
+{
+    uint pixels = Width * Height;
+    uint current = (FrameCount & 1) * pixels;
+    uint previous = pixels - current;
+
+    RisReservoir r = InitialCandidates(hitPos, hitNormal, rng);
+    for (uint i = 0; i <= RESTIR_SPATIAL_TAPS; i++) {
+        int2 q = int2(pixel);
+        if (i > 0) {
+            float2 u = Sample2D(rng);
+            float angle = 2.0 * PI * u.y;
+            q += int2(float2(cos(angle), sin(angle)) * RESTIR_SPATIAL_RADIUS * sqrt(u.x));
+        }
+        if (any(q < 0) || q.x >= int(Width) || q.y >= int(Height))
+            continue;
+        Reservoir n = Reservoirs[previous + q.y * Width + q.x];
+        if (n.M <= 0 || n.light >= LightCount || dot(UnpackNormal(n.normal), hitNormal) < 0.9 ||
+            abs(n.depth - depth) > 0.1 * depth)
+            continue;
+        LightSample s;
+        s.light = n.light;
+        s.disk = float2(f16tof32(n.disk), f16tof32(n.disk >> 16));
+        float3 toLight;
+        float lightDist;
+        float pHat = TargetPdf(LightContribution(s, hitPos, hitNormal, toLight, lightDist));
+        float M = min(n.M, RESTIR_MAX_M);
+        ReservoirUpdate(r, s, pHat * n.W * M, pHat, M, Sample1D(rng));
+    }
+
+    float W = ReservoirWeight(r);
+    RayDesc shadowRay;
+    float3 directLight = ShadeLightSample(r.y, W, hitPos, hitNormal, albedo, shadowRay);
+    if (any(directLight > 0) && ShadowRayHit(shadowRay)) {
+        directLight = float3(0, 0, 0);
+        W = 0.0;
+    }
+
+    Reservoir o;
+    o.normal = PackNormal(hitNormal);
+    o.depth = depth;
+    o.light = r.y.light;
+    o.disk = f32tof16(r.y.disk.x) | (f32tof16(r.y.disk.y) << 16);
+    o.W = W;
+    o.M = min(r.M, RESTIR_MAX_M);
+    Reservoirs[current + pixel.y * Width + pixel.x] = o;
+    return directLight;
+}
 
+// Camera ray through a jittered position in the pixel
+void GenerateCameraRay(uint2 pixel, inout RTSampler rng, out float3 rayOrigin, out float3 rayDir)
+{
     // Jittered pixel for AA
-    float2 jitter = float2(RandomFloat(seed), RandomFloat(seed));
+    float2 jitter = Sample2D(rng);
     float2 uv = (float2(pixel) + jitter) / float2(Width, Height);
     uv = uv * 2.0 - 1.0;
     uv.y = -uv.y;
@@ -244,14 +451,24 @@ void PathTraceCS(uint3 dispatchThreadID : SV_DispatchThreadID)
     float4 viewPos = mul(clipPos, InvProj);
     viewPos /= viewPos.w;
 
-    float3 rayOrigin = mul(float4(0, 0, 0, 1), InvView).xyz;
-    float3 rayDir = normalize(mul(float4(viewPos.xyz, 0), InvView).xyz);
+    rayOrigin = mul(float4(0, 0, 0, 1), InvView).xyz;
+    rayDir = normalize(mul(float4(viewPos.xyz, 0), InvView).xyz);
+}
+
+// One camera path through a jittered position in the pixel. reservoir: this
+// path owns the pixel's --light-sampling=restir reservoir for the frame.
+float3 TracePath(uint2 pixel, inout RTSampler rng, bool reservoir)
+{
+    float3 rayOrigin, rayDir;
+    GenerateCameraRay(pixel, rng, rayOrigin, rayDir);
 
     // Path tracing
     float3 radiance = float3(0, 0, 0);
     float3 throughput = float3(1, 1, 1);
+    uint rayType = RAY_PRIMARY;
+    bool restir = reservoir && LightSampling == LIGHT_SAMPLING_RESTIR;
 
-    for (int bounce = 0; bounce < 4; bounce++)
+    for (uint bounce = 0; bounce < MaxBounces; bounce++)
     {
         RayDesc ray;
         ray.Origin = rayOrigin;
@@ -262,45 +479,18 @@ void PathTraceCS(uint3 dispatchThreadID : SV_DispatchThreadID)
         RayQuery<RAY_FLAG_NONE> q;
         q.TraceRayInline(Scene, RAY_FLAG_NONE, 0xFF, ray);
         q.Proceed();
+        CountRays(rayType, 1);
 
         if (q.CommittedStatus() == COMMITTED_TRIANGLE_HIT)
         {
             float t = q.CommittedRayT();
-            uint primID = q.CommittedPrimitiveIndex();
-            uint instID = q.CommittedInstanceID();
-            float2 bary = q.CommittedTriangleBarycentrics();
             float3 hitPos = rayOrigin + rayDir * t;
 
-            // Determine object type, color, normal based on instance
-            uint objID;
             float3 albedo;
             float3 hitNormal;
             uint matType;
-
-            if (instID == 1) {
-                // Instance 1 = cube BLAS (8 rotating cubes)
-                objID = OBJ_CUBE;
-                uint cubeIndex = primID / 12;  // Each cube has 12 triangles
-                albedo = CubeColors[min(cubeIndex, 7u)];
-                float3 localNormal = GetCubeFaceNormal(primID);
-                hitNormal = TransformCubeNormal(localNormal);
-                matType = MAT_DIFFUSE;
-            } else {
-                // Instance 0 = static geometry
-                albedo = GetColorFromPrimitive(primID, objID);
-                matType = GetMaterialFromObject(objID);
-
-                // For static geometry, interpolate normals from vertex data
-                uint i0 = Indices[primID * 3 + 0];
-                uint i1 = Indices[primID * 3 + 1];
-                uint i2 = Indices[primID * 3 + 2];
-                float w = 1.0 - bary.x - bary.y;
-                hitNormal = normalize(
-                    Vertices[i0].normal * w +
-                    Vertices[i1].normal * bary.x +
-                    Vertices[i2].normal * bary.y
-                );
-            }
+            GetHitSurface(q.CommittedInstanceID(), q.CommittedPrimitiveIndex(), q.CommittedObjectToWorld3x4(),
+                          albedo, hitNormal, matType);
 
             // Emissive material (light source)
             if (matType == MAT_EMISSIVE) {
@@ -313,69 +503,29 @@ void PathTraceCS(uint3 dispatchThreadID : SV_DispatchThreadID)
                 rayDir = reflect(rayDir, hitNormal);
                 rayOrigin = hitPos + hitNormal * 0.001;
                 throughput *= 0.95;  // Slight absorption
+                rayType = RAY_REFLECT;
                 continue;
             }
 
             // Glass material
             if (matType == MAT_GLASS) {
-                float eta = 1.5;  // Glass IOR
-                float cosi = -dot(rayDir, hitNormal);
-                float3 n = hitNormal;
-
-                if (cosi < 0) {
-                    cosi = -cosi;
-                    n = -n;
-                    eta = 1.0 / eta;
-                }
-
-                float fresnel = FresnelSchlick(cosi, 0.04);
-
-                if (RandomFloat(seed) < fresnel) {
-                    rayDir = reflect(rayDir, n);
-                    rayOrigin = hitPos + n * 0.001;
-                } else {
-                    float k = 1.0 - (1.0 / eta) * (1.0 / eta) * (1.0 - cosi * cosi);
-                    if (k < 0) {
-                        rayDir = reflect(rayDir, n);
-                        rayOrigin = hitPos + n * 0.001;
-                    } else {
-                        rayDir = (1.0 / eta) * rayDir + ((1.0 / eta) * cosi - sqrt(k)) * n;
-                        rayOrigin = hitPos - n * 0.001;
-                    }
-                }
+                ScatterGlass(hitPos, hitNormal, rayOrigin, rayDir, rng);
                 throughput *= albedo;
+                rayType = RAY_REFLECT;
                 continue;
             }
 
             // Diffuse material - sample light directly with spotlight
-            float3 directLight = float3(0, 0, 0);
-
-            // Sample area light
-            float3 lightSample = LightPos + RandomInDisk(seed) * LightRadius;
-            float3 toLight = lightSample - hitPos;
-            float lightDist = length(toLight);
-            toLight /= lightDist;
-
-            float NdotL = max(dot(hitNormal, toLight), 0);
-            if (NdotL > 0) {
-                // Shadow ray
+            // (--light-sampling=restir: reservoir reuse at the primary hit)
+            float3 directLight;
+            if (restir && bounce == 0) {
+                directLight = DirectLightReSTIR(pixel, t, hitPos, hitNormal, albedo, rng);
+                restir = false;
+            } else {
                 RayDesc shadowRay;
-                shadowRay.Origin = hitPos + hitNormal * 0.001;
-                shadowRay.Direction = toLight;
-                shadowRay.TMin = 0.001;
-                shadowRay.TMax = lightDist - 0.01;
-
-                RayQuery<RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH> shadowQ;
-                shadowQ.TraceRayInline(Scene, RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH, 0xFF, shadowRay);
-                shadowQ.Proceed();
-
-                if (shadowQ.CommittedStatus() != COMMITTED_TRIANGLE_HIT) {
-                    // Not in shadow - apply spotlight attenuation
-                    float distAtten = 1.0 / (1.0 + lightDist * lightDist * 0.08);
-                    float spotAtten = SpotlightAttenuation(hitPos - LightPos);
-                    float atten = distAtten * spotAtten * LightIntensity;
-                    directLight = albedo * LightColor * NdotL * atten / PI;
-                }
+                directLight = SampleDirectLight(hitPos, hitNormal, albedo, rng, shadowRay);
+                if (any(directLight > 0) && ShadowRayHit(shadowRay))
+                    directLight = float3(0, 0, 0);
             }
 
             radiance += throughput * directLight;
@@ -386,16 +536,17 @@ void PathTraceCS(uint3 dispatchThreadID : SV_DispatchThreadID)
             // Russian roulette after first bounce
             if (bounce > 0) {
                 float p = max(throughput.x, max(throughput.y, throughput.z));
-                if (RandomFloat(seed) > p || p < 0.01)
+                if (Sample1D(rng) > p || p < 0.01)
                     break;
                 throughput /= p;
             }
 
             // Indirect bounce - cosine-weighted hemisphere sampling
-            float2 u = float2(RandomFloat(seed), RandomFloat(seed));
+            float2 u = Sample2D(rng);
             rayDir = CosineSampleHemisphere(u, hitNormal);
             rayOrigin = hitPos + hitNormal * 0.001;
             throughput *= albedo;
+            rayType = RAY_GI;
         }
         else
         {
@@ -405,10 +556,103 @@ void PathTraceCS(uint3 dispatchThreadID : SV_DispatchThreadID)
         }
     }
 
+    // No diffuse primary hit (sky, light, mirror / glass first): nothing to reuse here
+    if (restir)
+        ReservoirClear(pixel);
+    return radiance;
+}
+
+// Adds one path to the pixel's sums; the luminance moments use the tone
+// mapped value so the error estimate matches what is displayed
+void AddSample(uint2 pixel, inout RTSampler rng, inout float3 radianceSum, inout float lumSum, inout float lumSqSum,
+               bool reservoir)
+{
+    float3 radiance = TracePath(pixel, rng, reservoir);
+    SamplerNextSample(rng);
+    float lum = dot(radiance, float3(0.2126, 0.7152, 0.0722));
+    lum = lum / (lum + 1.0);
+    radianceSum += radiance;
+    lumSum += lum;
+    lumSqSum += lum * lum;
+}
+
+// Mean of the frame's spp paths (radianceSum), progressive accumulation,
+// then tone mapped to Output
+void ResolvePixel(uint2 pixel, float3 radianceSum, uint spp)
+{
+    float3 radiance = radianceSum / spp;
+
+    // Progressive accumulation: average the linear radiance of every sample
+    // since the last restart, then tone map the mean
+    if (AccumFrame > 0) {
+        float4 sum = float4(radianceSum, spp);
+        if (AccumFrame > 1) sum += AccumSum[pixel];
+        AccumSum[pixel] = sum;
+        radiance = sum.rgb / sum.w;
+    }
+
     // Tone mapping (simple Reinhard) and gamma
     radiance = radiance / (radiance + 1.0);
     radiance = pow(saturate(radiance), 1.0 / 2.2);
 
     Output[pixel] = float4(radiance, 1.0);
 }
+
+GROUP_SHAPE
+void PathTraceCS(uint3 dispatchThreadID : SV_DispatchThreadID, uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    uint2 pixel = dispatchThreadID.xy + uint2(0, RowOffset);
+    // Threads outside the image stay for the tile reductions but trace nothing
+    bool inside = pixel.x < Width && pixel.y < Height;
+
+    RTSampler rng = SamplerCreate(pixel, Width, Height, FrameCount, FrameSampleBase());
+
+    // Base samples (at least 2 in adaptive mode, for a variance estimate)
+    uint spp = AdaptiveMaxSpp > 0 ? max(SamplesPerPixel, 2u) : SamplesPerPixel;
+    float3 radianceSum = float3(0, 0, 0);
+    float lumSum = 0.0, lumSqSum = 0.0;
+    if (inside) {
+        for (uint s = 0; s < spp; s++)
+            AddSample(pixel, rng, radianceSum, lumSum, lumSqSum, s == 0);
+    }
+
+    // Adaptive: while the tile's worst standard error of the mean is above
+    // the target, double its sample count (up to AdaptiveMaxSpp). spp is the
+    // same in every thread and the exit test reads groupshared memory, so the
+    // loop (and its barriers) stays uniform across the tile.
+    while (AdaptiveMaxSpp > spp) {
+        float err = 0.0;
+        if (inside) {
+            float mean = lumSum / spp;
+            err = sqrt(max(lumSqSum / spp - mean * mean, 0.0) / (spp - 1));
+        }
+        gs_tileError[groupIndex] = err;
+        GroupMemoryBarrierWithGroupSync();
+        for (uint stride = GROUP_THREADS / 2; stride > 0; stride >>= 1) {
+            if (groupIndex < stride)
+                gs_tileError[groupIndex] = max(gs_tileError[groupIndex], gs_tileError[groupIndex + stride]);
+            GroupMemoryBarrierWithGroupSync();
+        }
+        float tileError = gs_tileError[0];
+        GroupMemoryBarrierWithGroupSync();   // Everyone has read [0] before the next round writes
+        if (tileError <= AdaptiveTarget)
+            break;
+
+        uint extra = min(spp, AdaptiveMaxSpp - spp);
+        if (inside) {
+            for (uint s = 0; s < extra; s++)
+                AddSample(pixel, rng, radianceSum, lumSum, lumSqSum, false);
+        }
+        spp += extra;
+    }
+
+    if (AdaptiveMaxSpp > 0 && groupIndex == 0) {
+        uint2 tilePixels = min(uint2(GROUP_X, GROUP_Y), uint2(Width, Height) - (groupID.xy * uint2(GROUP_X, GROUP_Y) + uint2(0, RowOffset)));
+        SampleCounter.InterlockedAdd(0, spp * tilePixels.x * tilePixels.y);
+    }
+    if (!inside)
+        return;
+
+    ResolvePixel(pixel, radianceSum, spp);
+}
 )HLSL";
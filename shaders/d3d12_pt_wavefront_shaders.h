@@ -0,0 +1,372 @@
+#pragma once
+// ============== D3D12 WAVEFRONT PATH TRACING SHADERS ==============
+// --wavefront: the megakernel's TracePath split into one compute kernel per
+// stage. Appended to g_ptShaderCode (scene tables, cbuffer, GetHitSurface and
+// the other helpers), every entry point is compiled from the combined source.
+//
+// One path per trace pixel (path index = y * Width + x). Per sample:
+//   GenerateCS           camera ray for every path into ray queue 0
+// then per bounce (ray queue Bounce & 1 -> the other one):
+//   PrepareArgsCS        dispatch args from the queue counters, clear the next queues
+//   ExtendCS             closest hit; emissive / miss end the path, others are
+//                        binned into the diffuse, mirror or glass queue
+//   ShadeDiffuseCS       next event estimation into the shadow queue, Russian
+//   ShadeMirrorCS        roulette, scatter into the next ray queue - one kernel
+//   ShadeGlassCS         per material, so every wave runs one BRDF
+//   ShadowCS             any-hit occlusion, adds the light sample when visible
+// and finally ResolveCS: mean over the samples, --accumulate, tone map.
+// Extend, shade and shadow run through ExecuteIndirect with the group counts
+// PrepareArgsCS wrote, so empty queues cost an empty dispatch.
+
+// Queue / counter / args layout shared with renderer_d3d12_pt.cpp
+#define WF_QUEUE_RAY0    0
+#define WF_QUEUE_RAY1    1
+#define WF_QUEUE_DIFFUSE 2
+#define WF_QUEUE_MIRROR  3
+#define WF_QUEUE_GLASS   4
+#define WF_QUEUE_SHADOW  5
+#define WF_QUEUE_COUNT   6
+
+#define WF_ARG_EXTEND  0
+#define WF_ARG_DIFFUSE 1
+#define WF_ARG_MIRROR  2
+#define WF_ARG_GLASS   3
+#define WF_ARG_SHADOW  4
+#define WF_ARG_COUNT   5
+
+#define WF_STAGE_EXTEND 0   // PrepareArgsCS before ExtendCS
+#define WF_STAGE_SHADE  1   // ... before the three shade kernels
+#define WF_STAGE_SHADOW 2   // ... before ShadowCS
+
+#define WF_GROUP_SIZE     64     // Threads per queue kernel group
+#define WF_GROUPS_PER_ROW 1024   // Queue dispatches are 2D past this many groups
+
+#define WF_STR2(x) #x
+#define WF_STR(x) WF_STR2(x)
+
+static const char* g_ptWavefrontShaderCode =
+"#define WF_QUEUE_RAY0 "     WF_STR(WF_QUEUE_RAY0) "\n"
+"#define WF_QUEUE_DIFFUSE "  WF_STR(WF_QUEUE_DIFFUSE) "\n"
+"#define WF_QUEUE_MIRROR "   WF_STR(WF_QUEUE_MIRROR) "\n"
+"#define WF_QUEUE_GLASS "    WF_STR(WF_QUEUE_GLASS) "\n"
+"#define WF_QUEUE_SHADOW "   WF_STR(WF_QUEUE_SHADOW) "\n"
+"#define WF_ARG_EXTEND "     WF_STR(WF_ARG_EXTEND) "\n"
+"#define WF_ARG_DIFFUSE "    WF_STR(WF_ARG_DIFFUSE) "\n"
+"#define WF_ARG_MIRROR "     WF_STR(WF_ARG_MIRROR) "\n"
+"#define WF_ARG_GLASS "      WF_STR(WF_ARG_GLASS) "\n"
+"#define WF_ARG_SHADOW "     WF_STR(WF_ARG_SHADOW) "\n"
+"#define WF_STAGE_EXTEND "   WF_STR(WF_STAGE_EXTEND) "\n"
+"#define WF_STAGE_SHADE "    WF_STR(WF_STAGE_SHADE) "\n"
+"#define WF_GROUP_SIZE "     WF_STR(WF_GROUP_SIZE) "\n"
+"#define WF_GROUPS_PER_ROW " WF_STR(WF_GROUPS_PER_ROW) "\n"
+R"HLSL(
+// Per-stage root constants
+cbuffer WavefrontCB : register(b1)
+{
+    uint Bounce;    // Extend / shade / PrepareArgsCS: path segment being traced
+    uint Sample;    // GenerateCS: index within SamplesPerPixel (0 = clear the sums)
+    uint Stage;     // PrepareArgsCS: WF_STAGE_*
+};
+
+// Path state, one per pixel. Radiance sums all samples of the frame.
+struct PathState
+{
+    float3 origin;
+    float3 dir;
+    float3 throughput;
+    float3 radiance;
+    RTSampler rng;
+};
+
+// ExtendCS result for the shade kernels
+struct PathHit
+{
+    float3 normal;      // World space shading normal
+    float t;
+    uint material;      // Materials[] index
+    uint3 pad;
+};
+
+// Pending light sample of a diffuse hit
+struct ShadowRay
+{
+    float3 origin;
+    float tMax;
+    float3 dir;
+    uint pad0;
+    float3 contribution;    // Throughput * unshadowed light, added when visible
+    uint pad1;
+};
+
+RWStructuredBuffer<PathState> Paths : register(u3);
+RWStructuredBuffer<PathHit> Hits : register(u4);
+RWStructuredBuffer<uint> Queues : register(u5);          // WF_QUEUE_COUNT x PathCount path indices
+RWStructuredBuffer<ShadowRay> ShadowRays : register(u6);
+RWByteAddressBuffer Counters : register(u7);             // One uint per queue
+RWByteAddressBuffer DispatchArgs : register(u8);         // WF_ARG_COUNT x D3D12_DISPATCH_ARGUMENTS
+
+#define PathCount (Width * Height)
+
+uint QueueSize(uint q)
+{
+    return Counters.Load(q * 4);
+}
+
+// Appends path to queue q with one counter atomic per wave; lanes take
+// consecutive slots. q must be the same in all calling lanes (each call
+// site passes a literal or a root constant expression).
+void QueuePush(uint q, uint path)
+{
+    uint laneOffset = WavePrefixCountBits(true);
+    uint laneCount = WaveActiveCountBits(true);
+    uint base = 0;
+    if (WaveIsFirstLane())
+        Counters.InterlockedAdd(q * 4, laneCount, base);
+    base = WaveReadLaneFirst(base);
+    Queues[q * PathCount + base + laneOffset] = path;
+}
+
+// Queue entry of this thread in a (possibly 2D) indirect dispatch,
+// false past the end of queue q
+bool QueueEntry(uint q, uint3 groupID, uint groupIndex, out uint path)
+{
+    uint i = (groupID.y * WF_GROUPS_PER_ROW + groupID.x) * WF_GROUP_SIZE + groupIndex;
+    path = 0;
+    if (i >= QueueSize(q))
+        return false;
+    path = Queues[q * PathCount + i];
+    return true;
+}
+
+uint NextRayQueue()
+{
+    return WF_QUEUE_RAY0 + ((Bounce + 1) & 1);
+}
+
+// Hit position, albedo, normal of the path's last ExtendCS hit
+void LoadHit(uint path, PathState p, out float3 hitPos, out float3 albedo, out float3 hitNormal)
+{
+    PathHit h = Hits[path];
+    albedo = Materials[h.material].albedo;
+    hitNormal = h.normal;
+    hitPos = p.origin + p.dir * h.t;
+}
+
+[numthreads(8, 8, 1)]
+void GenerateCS(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    uint2 pixel = dispatchThreadID.xy;
+    if (pixel.x >= Width || pixel.y >= Height)
+        return;
+    uint path = pixel.y * Width + pixel.x;
+    if (path == 0)
+        Counters.Store(WF_QUEUE_RAY0 * 4, PathCount);
+
+    // Same random sequence as the megakernel: created once per frame and
+    // carried across the pixel's samples
+    PathState p;
+    if (Sample == 0) {
+        p.rng = SamplerCreate(pixel, Width, Height, FrameCount, FrameSampleBase());
+        p.radiance = float3(0, 0, 0);
+    } else {
+        p.rng = Paths[path].rng;
+        SamplerNextSample(p.rng);
+        p.radiance = Paths[path].radiance;
+    }
+    GenerateCameraRay(pixel, p.rng, p.origin, p.dir);
+    p.throughput = float3(1, 1, 1);
+    Paths[path] = p;
+    Queues[WF_QUEUE_RAY0 * PathCount + path] = path;
+}
+
+void WriteDispatchArgs(uint arg, uint count)
+{
+    uint groups = (count + WF_GROUP_SIZE - 1) / WF_GROUP_SIZE;
+    uint3 args = groups > WF_GROUPS_PER_ROW
+        ? uint3(WF_GROUPS_PER_ROW, (groups + WF_GROUPS_PER_ROW - 1) / WF_GROUPS_PER_ROW, 1)
+        : uint3(groups, 1, 1);
+    DispatchArgs.Store3(arg * 12, args);
+}
+
+[numthreads(1, 1, 1)]
+void PrepareArgsCS()
+{
+    if (Stage == WF_STAGE_EXTEND) {
+        WriteDispatchArgs(WF_ARG_EXTEND, QueueSize(WF_QUEUE_RAY0 + (Bounce & 1)));
+        Counters.Store(NextRayQueue() * 4, 0);
+        Counters.Store(WF_QUEUE_DIFFUSE * 4, 0);
+        Counters.Store(WF_QUEUE_MIRROR * 4, 0);
+        Counters.Store(WF_QUEUE_GLASS * 4, 0);
+        Counters.Store(WF_QUEUE_SHADOW * 4, 0);
+    } else if (Stage == WF_STAGE_SHADE) {
+        WriteDispatchArgs(WF_ARG_DIFFUSE, QueueSize(WF_QUEUE_DIFFUSE));
+        WriteDispatchArgs(WF_ARG_MIRROR, QueueSize(WF_QUEUE_MIRROR));
+        WriteDispatchArgs(WF_ARG_GLASS, QueueSize(WF_QUEUE_GLASS));
+    } else {
+        WriteDispatchArgs(WF_ARG_SHADOW, QueueSize(WF_QUEUE_SHADOW));
+    }
+}
+
+[numthreads(WF_GROUP_SIZE, 1, 1)]
+void ExtendCS(uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    uint path;
+    if (!QueueEntry(WF_QUEUE_RAY0 + (Bounce & 1), groupID, groupIndex, path))
+        return;
+    PathState p = Paths[path];
+
+    RayDesc ray;
+    ray.Origin = p.origin;
+    ray.Direction = p.dir;
+    ray.TMin = 0.001;
+    ray.TMax = 100.0;
+
+    RayQuery<RAY_FLAG_NONE> q;
+    q.TraceRayInline(Scene, RAY_FLAG_NONE, 0xFF, ray);
+    q.Proceed();
+
+    if (q.CommittedStatus() != COMMITTED_TRIANGLE_HIT) {
+        // Miss - background color (very dark for closed box)
+        Paths[path].radiance = p.radiance + p.throughput * float3(0.01, 0.01, 0.02);
+        return;
+    }
+
+    // The instance transform is only known here, so the world space normal
+    // goes into the hit record with the material index
+    Primitive prim = HitPrimitive(q.CommittedInstanceID(), q.CommittedPrimitiveIndex());
+    uint matType = Materials[prim.material].type;
+
+    if (matType == MAT_EMISSIVE) {
+        Paths[path].radiance = p.radiance + p.throughput * float3(1.0, 0.95, 0.85) * 2.0;
+        return;
+    }
+
+    PathHit h;
+    h.normal = HitNormal(prim, q.CommittedObjectToWorld3x4());
+    h.t = q.CommittedRayT();
+    h.material = prim.material;
+    h.pad = uint3(0, 0, 0);
+    Hits[path] = h;
+
+    if (matType == MAT_MIRROR) QueuePush(WF_QUEUE_MIRROR, path);
+    else if (matType == MAT_GLASS) QueuePush(WF_QUEUE_GLASS, path);
+    else QueuePush(WF_QUEUE_DIFFUSE, path);
+}
+
+[numthreads(WF_GROUP_SIZE, 1, 1)]
+void ShadeDiffuseCS(uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    uint path;
+    if (!QueueEntry(WF_QUEUE_DIFFUSE, groupID, groupIndex, path))
+        return;
+    PathState p = Paths[path];
+    float3 hitPos, albedo, hitNormal;
+    LoadHit(path, p, hitPos, albedo, hitNormal);
+
+    // Light sample - ShadowCS decides whether it counts
+    RayDesc shadowRay;
+    float3 directLight = SampleAreaLight(hitPos, hitNormal, albedo, p.rng, shadowRay);
+    if (any(directLight > 0)) {
+        ShadowRay s;
+        s.origin = shadowRay.Origin;
+        s.tMax = shadowRay.TMax;
+        s.dir = shadowRay.Direction;
+        s.contribution = p.throughput * directLight;
+        s.pad0 = s.pad1 = 0;
+        ShadowRays[path] = s;
+        QueuePush(WF_QUEUE_SHADOW, path);
+    }
+
+    // Add ambient for areas outside spotlight
+    p.radiance += p.throughput * albedo * 0.02;
+
+    // Russian roulette after first bounce
+    bool alive = true;
+    if (Bounce > 0) {
+        float survive = max(p.throughput.x, max(p.throughput.y, p.throughput.z));
+        if (Sample1D(p.rng) > survive || survive < 0.01)
+            alive = false;
+        else
+            p.throughput /= survive;
+    }
+
+    if (alive) {
+        // Indirect bounce - cosine-weighted hemisphere sampling
+        float2 u = Sample2D(p.rng);
+        p.dir = CosineSampleHemisphere(u, hitNormal);
+        p.origin = hitPos + hitNormal * 0.001;
+        p.throughput *= albedo;
+    }
+    Paths[path] = p;
+    if (alive && Bounce + 1 < MaxBounces)
+        QueuePush(NextRayQueue(), path);
+}
+
+[numthreads(WF_GROUP_SIZE, 1, 1)]
+void ShadeMirrorCS(uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    uint path;
+    if (!QueueEntry(WF_QUEUE_MIRROR, groupID, groupIndex, path))
+        return;
+    PathState p = Paths[path];
+    float3 hitPos, albedo, hitNormal;
+    LoadHit(path, p, hitPos, albedo, hitNormal);
+
+    p.dir = reflect(p.dir, hitNormal);
+    p.origin = hitPos + hitNormal * 0.001;
+    p.throughput *= 0.95;  // Slight absorption
+    Paths[path] = p;
+    if (Bounce + 1 < MaxBounces)
+        QueuePush(NextRayQueue(), path);
+}
+
+[numthreads(WF_GROUP_SIZE, 1, 1)]
+void ShadeGlassCS(uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    uint path;
+    if (!QueueEntry(WF_QUEUE_GLASS, groupID, groupIndex, path))
+        return;
+    PathState p = Paths[path];
+    float3 hitPos, albedo, hitNormal;
+    LoadHit(path, p, hitPos, albedo, hitNormal);
+
+    ScatterGlass(hitPos, hitNormal, p.origin, p.dir, p.rng);
+    p.throughput *= albedo;
+    Paths[path] = p;
+    if (Bounce + 1 < MaxBounces)
+        QueuePush(NextRayQueue(), path);
+}
+
+[numthreads(WF_GROUP_SIZE, 1, 1)]
+void ShadowCS(uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    uint path;
+    if (!QueueEntry(WF_QUEUE_SHADOW, groupID, groupIndex, path))
+        return;
+    ShadowRay s = ShadowRays[path];
+
+    RayDesc ray;
+    ray.Origin = s.origin;
+    ray.Direction = s.dir;
+    ray.TMin = 0.001;
+    ray.TMax = s.tMax;
+
+    RayQuery<RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH> q;
+    q.TraceRayInline(Scene, RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH, 0xFF, ray);
+    q.Proceed();
+    if (q.CommittedStatus() != COMMITTED_TRIANGLE_HIT)
+        Paths[path].radiance += s.contribution;
+}
+
+[numthreads(8, 8, 1)]
+void ResolveCS(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    uint2 pixel = dispatchThreadID.xy;
+    if (pixel.x >= Width || pixel.y >= Height)
+        return;
+    ResolvePixel(pixel, Paths[pixel.y * Width + pixel.x].radiance, SamplesPerPixel);
+}
+)HLSL";
+
+#undef WF_STR
+#undef WF_STR2
@@ -0,0 +1,131 @@
+#pragma once
+// ============== D3D12 SPATIAL UPSCALE SHADERS ==============
+// --render-scale for the D3D12 path tracer: UpscaleCS resamples the reduced
+// resolution image to the back buffer size with an edge-adaptive Lanczos-2
+// kernel (stretched along edges, deringed against the 2x2 neighbourhood),
+// SharpenCS then applies contrast adaptive sharpening at output resolution.
+// Both work on the display space (tone mapped) RGBA8 image.
+
+static const char* g_ptUpscaleShaderCode = R"HLSL(
+Texture2D<float4> InputTexture : register(t0);
+RWTexture2D<float4> OutputTexture : register(u0);
+
+cbuffer UpscaleCB : register(b0)
+{
+    uint InputWidth;
+    uint InputHeight;
+    uint OutputWidth;
+    uint OutputHeight;
+    float Sharpness;    // SharpenCS: 0 = mild, 1 = strongest
+};
+
+float Luma(float3 c)
+{
+    return dot(c, float3(0.299f, 0.587f, 0.114f));
+}
+
+float3 Fetch(int2 p)
+{
+    return InputTexture[clamp(p, int2(0, 0), int2(InputWidth - 1, InputHeight - 1))].rgb;
+}
+
+// Polynomial Lanczos-2 approximation on the squared distance (0 beyond 2 texels)
+float Lanczos2(float x2)
+{
+    x2 = min(x2, 4.0f);
+    float a = 0.4f * x2 - 1.0f;
+    float b = 0.25f * x2 - 1.0f;
+    return (1.5625f * a * a - 0.5625f) * (b * b);
+}
+
+[numthreads(8, 8, 1)]
+void UpscaleCS(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    int2 pixel = int2(dispatchThreadID.xy);
+    if (pixel.x >= (int)OutputWidth || pixel.y >= (int)OutputHeight)
+        return;
+
+    // Output pixel centre in input texel space
+    float2 srcPos = (float2(pixel) + 0.5f) * float2(InputWidth, InputHeight) / float2(OutputWidth, OutputHeight) - 0.5f;
+    int2 base = int2(floor(srcPos));
+    float2 f = srcPos - float2(base);
+
+    // Luma gradient of the 2x2 footprint, bilinearly weighted
+    float l[4][4];
+    for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+            l[y][x] = Luma(Fetch(base + int2(x - 1, y - 1)));
+    float2 grad = 0.0f;
+    float2 bw[4] = { float2(1.0f - f.x, 1.0f - f.y), float2(f.x, 1.0f - f.y), float2(1.0f - f.x, f.y), float2(f.x, f.y) };
+    for (int i = 0; i < 4; i++)
+    {
+        int cx = 1 + (i & 1);
+        int cy = 1 + (i >> 1);
+        float2 g = float2(l[cy][cx + 1] - l[cy][cx - 1], l[cy + 1][cx] - l[cy - 1][cx]);
+        grad += g * (bw[i].x * bw[i].y);
+    }
+
+    // Across-edge axis follows the gradient; the kernel is widened along the
+    // edge in proportion to its strength so edges stay sharp without stairs
+    float len = length(grad);
+    float2 across = len > 1e-4f ? grad / len : float2(1.0f, 0.0f);
+    float2 along = float2(-across.y, across.x);
+    float edge = saturate(len * 2.0f);
+    float alongScale = lerp(1.0f, 0.5f, edge);
+
+    float3 colorSum = 0.0f;
+    float weightSum = 0.0f;
+    float3 minC = 1.0f;
+    float3 maxC = 0.0f;
+    for (int ty = 0; ty < 4; ty++)
+    {
+        for (int tx = 0; tx < 4; tx++)
+        {
+            // 12-tap footprint: the 4x4 block without its corners
+            if ((tx == 0 || tx == 3) && (ty == 0 || ty == 3))
+                continue;
+            float3 c = Fetch(base + int2(tx - 1, ty - 1));
+            float2 d = float2(tx - 1, ty - 1) - f;
+            float da = dot(d, across);
+            float dl = dot(d, along) * alongScale;
+            float w = Lanczos2(da * da + dl * dl);
+            colorSum += c * w;
+            weightSum += w;
+            if (tx >= 1 && tx <= 2 && ty >= 1 && ty <= 2)
+            {
+                minC = min(minC, c);
+                maxC = max(maxC, c);
+            }
+        }
+    }
+
+    // Negative lobes can overshoot - clamp to the nearest texels (deringing)
+    float3 result = clamp(colorSum / max(weightSum, 1e-4f), minC, maxC);
+    OutputTexture[pixel] = float4(result, 1.0f);
+}
+
+[numthreads(8, 8, 1)]
+void SharpenCS(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    int2 pixel = int2(dispatchThreadID.xy);
+    if (pixel.x >= (int)OutputWidth || pixel.y >= (int)OutputHeight)
+        return;
+
+    int2 maxPos = int2(OutputWidth - 1, OutputHeight - 1);
+    float3 e = InputTexture[pixel].rgb;
+    float3 b = InputTexture[clamp(pixel + int2(0, -1), int2(0, 0), maxPos)].rgb;
+    float3 d = InputTexture[clamp(pixel + int2(-1, 0), int2(0, 0), maxPos)].rgb;
+    float3 fr = InputTexture[clamp(pixel + int2(1, 0), int2(0, 0), maxPos)].rgb;
+    float3 h = InputTexture[clamp(pixel + int2(0, 1), int2(0, 0), maxPos)].rgb;
+
+    // Less sharpening where the local contrast is already high, so flat areas
+    // gain detail and edges don't ring
+    float3 minC = min(min(min(b, d), min(fr, h)), e);
+    float3 maxC = max(max(max(b, d), max(fr, h)), e);
+    float3 amp = sqrt(saturate(min(minC, 1.0f - maxC) / max(maxC, 1e-4f)));
+    float3 w = amp * (-1.0f / lerp(8.0f, 5.0f, saturate(Sharpness)));
+
+    float3 result = ((b + d + fr + h) * w + e) / (1.0f + 4.0f * w);
+    OutputTexture[pixel] = float4(saturate(result), 1.0f);
+}
+)HLSL";
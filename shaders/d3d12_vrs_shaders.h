@@ -0,0 +1,56 @@
+#pragma once
+// ============== DXR 1.1 SHADING RATE IMAGE ==============
+// --vrs (renderer_d3d12_rt.cpp): one thread group per shading rate tile of the
+// previous frame's colour (the temporal history copy, before the overlay).
+// The group reduces the tile's luminance mean and variance; a tile below the
+// threshold is smooth enough for one pixel shader invocation per 2x2 quad,
+// everything else (edges, shadow boundaries, noisy AO / GI) stays at 1x1.
+// Output: R8_UINT D3D12_SHADING_RATE values, bound with RSSetShadingRateImage.
+
+static const char* g_vrsShaderCode = R"HLSL(
+cbuffer VrsCB : register(b0)
+{
+    uint Width;
+    uint Height;
+    uint TileSize;      // D3D12_FEATURE_DATA_D3D12_OPTIONS6::ShadingRateImageTileSize
+    float Threshold;    // Luminance variance below which the tile shades 2x2
+};
+
+Texture2D<float4> History : register(t0);
+RWTexture2D<uint> ShadingRate : register(u0);
+
+#define VRS_RATE_1X1 0x0
+#define VRS_RATE_2X2 0x5
+
+groupshared float3 gsMoments[64];   // Sum, sum of squares, pixel count
+
+[numthreads(8, 8, 1)]
+void VrsRateCS(uint3 tile : SV_GroupID, uint3 lane : SV_GroupThreadID, uint index : SV_GroupIndex)
+{
+    float3 m = 0;
+    uint2 base = tile.xy * TileSize;
+    for (uint y = lane.y; y < TileSize; y += 8) {
+        for (uint x = lane.x; x < TileSize; x += 8) {
+            uint2 p = base + uint2(x, y);
+            if (p.x >= Width || p.y >= Height) continue;
+            float l = dot(History[p].rgb, float3(0.2126, 0.7152, 0.0722));
+            m += float3(l, l * l, 1.0);
+        }
+    }
+    gsMoments[index] = m;
+    GroupMemoryBarrierWithGroupSync();
+
+    for (uint s = 32; s > 0; s >>= 1) {
+        if (index < s) gsMoments[index] += gsMoments[index + s];
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (index == 0) {
+        float3 t = gsMoments[0];
+        float n = max(t.z, 1.0);
+        float mean = t.x / n;
+        float variance = max(t.y / n - mean * mean, 0.0);
+        ShadingRate[tile.xy] = variance < Threshold ? VRS_RATE_2X2 : VRS_RATE_1X1;
+    }
+}
+)HLSL";
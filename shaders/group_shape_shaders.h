@@ -0,0 +1,23 @@
+#pragma once
+// ============== THREAD-GROUP SHAPE ==============
+// --group-size (group_tune.h): prepended to the sources of the per-pixel
+// kernels whose tile shape is tuned (PathTraceCS, DenoiseCS, TemporalCS,
+// PathTraceDlssCS). A variant is compiled with -D GROUP_X=n -D GROUP_Y=n and,
+// for the wave-forcing ones, -D WAVE_SIZE=n (SM 6.6). Without the defines the
+// kernels keep their 8x8 groups and the driver's wave size.
+
+static const char* g_groupShapeShaderCode = R"HLSL(
+#ifndef GROUP_X
+#define GROUP_X 8
+#endif
+#ifndef GROUP_Y
+#define GROUP_Y 8
+#endif
+#define GROUP_THREADS (GROUP_X * GROUP_Y)   // Power of two: tile reductions halve it
+
+#ifdef WAVE_SIZE
+#define GROUP_SHAPE [WaveSize(WAVE_SIZE)] [numthreads(GROUP_X, GROUP_Y, 1)]
+#else
+#define GROUP_SHAPE [numthreads(GROUP_X, GROUP_Y, 1)]
+#endif
+)HLSL";
@@ -0,0 +1,64 @@
+#pragma once
+// ============== OPENGL 4.5 CORE SHADERS ==============
+// GLSL for the --gl-core path of the OpenGL renderer. The scene shaders
+// reproduce VS / VSInstanced / PS of d3d11_shaders.h (same View / Proj, with
+// glClipControl giving D3D's 0..1 depth); GLSL mat3(r0, r1, r2) * v equals the
+// HLSL row-vector mul(v, float3x3(r0, r1, r2)). The scene vertex shader is
+// compiled twice, with and without INSTANCED (prepended after #version).
+// The overlay uses the shared glyph shaders of overlay_shaders.h.
+
+static const char* g_glCoreSceneVS = R"GLSL(
+layout(std140, binding = 0) uniform FrameUBO { float Time; float Aspect; vec2 ScreenSize; };
+
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec3 inNormal;
+#ifdef INSTANCED
+layout(location = 2) in vec4 inInstance;     // xyz = offset, w = uniform scale
+layout(location = 3) in vec4 inInstColor;
+#else
+layout(location = 2) in uint inCubeID;
+#endif
+
+out vec3 vWorldNorm;
+out vec4 vColor;
+
+const vec4 Colors[8] = vec4[8](
+    vec4(0.95, 0.2, 0.15, 1), vec4(0.2, 0.7, 0.3, 1),
+    vec4(0.15, 0.5, 0.95, 1), vec4(1.0, 0.85, 0.0, 1),
+    vec4(1.0, 0.85, 0.0, 1), vec4(0.15, 0.5, 0.95, 1),
+    vec4(0.2, 0.7, 0.3, 1), vec4(0.95, 0.2, 0.15, 1));
+
+mat3 RotY(float a) { float c = cos(a), s = sin(a); return mat3(c,0,s, 0,1,0, -s,0,c); }
+mat3 RotX(float a) { float c = cos(a), s = sin(a); return mat3(1,0,0, 0,c,-s, 0,s,c); }
+
+void main() {
+    mat3 rot = RotX(Time * 0.7) * RotY(Time * 1.2);
+#ifdef INSTANCED
+    vec3 worldPos = rot * (inPos * inInstance.w + inInstance.xyz);
+    vColor = inInstColor;
+#else
+    vec3 worldPos = rot * inPos;
+    vColor = Colors[inCubeID];
+#endif
+    // View = translate(0, 0, 4), Proj = 45 degree vertical FOV, x / Aspect
+    vec3 v = worldPos + vec3(0, 0, 4);
+    float a = (Aspect > 0.0) ? Aspect : 1.33333;
+    gl_Position = vec4(v.x * 2.41421 / a, v.y * 2.41421, v.z * 1.001 - 0.1001, v.z);
+    vWorldNorm = rot * inNormal;
+}
+)GLSL";
+
+static const char* g_glCoreSceneFS = R"GLSL(
+in vec3 vWorldNorm;
+in vec4 vColor;
+layout(location = 0) out vec4 outColor;
+
+const vec3 LightDir = vec3(0.188144, 0.940721, 0.282216);   // normalize(0.2, 1.0, 0.3)
+
+void main() {
+    vec3 n = normalize(vWorldNorm);
+    float d = max(dot(n, LightDir), 0.0) * 0.65 + 0.35;
+    outColor = vec4(vColor.rgb * d, 1);
+}
+)GLSL";
+
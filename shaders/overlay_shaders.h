@@ -0,0 +1,78 @@
+#pragma once
+// ============== OVERLAY GLYPH SHADERS ==============
+// Instanced text overlay (text_overlay.h). One GlyphInstance per glyph:
+// the vertex shader expands it into a 4-vertex triangle strip from the vertex
+// id and the pixel shader tests the glyph's bit in OverlayFont. The tables
+// OverlayFont (g_font8x8 packed 4 rows per uint), OverlayPalette,
+// OVERLAY_SCALE and OVERLAY_COLOR_COUNT are generated by OverlayShaderHLSL /
+// OverlayShaderGLSL and prepended to these bodies.
+
+// D3D11 (constant buffer) and D3D12 (4 root constants) share b0
+static const char* g_overlayHLSL = R"HLSL(
+cbuffer OverlayCB : register(b0) { float2 InvScreen; float2 OverlayPad; };
+
+struct GlyphVSIn {
+    uint2 pos : GLYPHPOS;       // Pixel position of the top-left corner
+    uint2 code : GLYPHCODE;     // x = char - 32, y = palette index
+    uint vid : SV_VertexID;
+};
+struct GlyphPSIn {
+    float4 pos : SV_POSITION;
+    float2 texel : TEXCOORD0;
+    nointerpolation uint ch : GLYPHCHAR;
+    nointerpolation float4 color : COLOR;
+};
+
+GlyphPSIn GlyphVS(GlyphVSIn i) {
+    GlyphPSIn o;
+    float2 corner = float2(i.vid & 1, i.vid >> 1);
+    float2 px = float2(i.pos) + corner * (8.0f * OVERLAY_SCALE);
+    o.pos = float4(px.x * InvScreen.x * 2.0f - 1.0f, 1.0f - px.y * InvScreen.y * 2.0f, 0, 1);
+    o.texel = corner * 8.0f;
+    o.ch = min(i.code.x, 95u);
+    o.color = OverlayPalette[min(i.code.y, OVERLAY_COLOR_COUNT - 1)];
+    return o;
+}
+
+float4 GlyphPS(GlyphPSIn i) : SV_TARGET {
+    uint2 t = min(uint2(i.texel), 7u);
+    uint row = (OverlayFont[i.ch * 2 + (t.y >> 2)] >> ((t.y & 3) * 8)) & 0xFF;
+    if ((row & (0x80u >> t.x)) == 0) discard;
+    return i.color;
+}
+)HLSL";
+
+// --gl-core: instances from the persistent ring, ScreenSize from FrameUBO
+static const char* g_overlayGLSLVS = R"GLSL(
+layout(std140, binding = 0) uniform FrameUBO { float Time; float Aspect; vec2 ScreenSize; };
+
+layout(location = 0) in uvec2 inPos;
+layout(location = 1) in uvec2 inCode;
+
+out vec2 vTexel;
+flat out uint vChar;
+flat out vec4 vColor;
+
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 px = vec2(inPos) + corner * (8.0 * OVERLAY_SCALE);
+    gl_Position = vec4(px.x / ScreenSize.x * 2.0 - 1.0, 1.0 - px.y / ScreenSize.y * 2.0, 0, 1);
+    vTexel = corner * 8.0;
+    vChar = min(inCode.x, 95u);
+    vColor = OverlayPalette[min(inCode.y, uint(OVERLAY_COLOR_COUNT - 1))];
+}
+)GLSL";
+
+static const char* g_overlayGLSLFS = R"GLSL(
+in vec2 vTexel;
+flat in uint vChar;
+flat in vec4 vColor;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    uvec2 t = min(uvec2(vTexel), uvec2(7u));
+    uint row = (OverlayFont[vChar * 2u + (t.y >> 2)] >> ((t.y & 3u) * 8u)) & 0xFFu;
+    if ((row & (0x80u >> t.x)) == 0u) discard;
+    outColor = vColor;
+}
+)GLSL";
@@ -0,0 +1,29 @@
+#pragma once
+// ============== RAY COUNTERS ==============
+// --ray-stats (ray_stats.h): prepended to the DXR 1.0, DXR 1.1 and PT shader
+// sources. With -D RAY_STATS every trace site calls CountRays(type, n); the
+// wave sums its lanes and one lane does the atomic, so the counters cost one
+// InterlockedAdd per wave and site. Without the define CountRays compiles
+// away. The RAY_* values match RayType.
+
+static const char* g_rayStatsShaderCode = R"HLSL(
+#define RAY_PRIMARY 0
+#define RAY_SHADOW  1
+#define RAY_AO      2
+#define RAY_GI      3
+#define RAY_REFLECT 4
+
+#ifdef RAY_STATS
+// One uint per ray type (root UAV, u0 in space2)
+RWByteAddressBuffer RayCounters : register(u0, space2);
+
+void CountRays(uint type, uint n)
+{
+    uint total = WaveActiveSum(n);
+    if (WaveIsFirstLane() && total != 0)
+        RayCounters.InterlockedAdd(type * 4, total);
+}
+#else
+#define CountRays(type, n)
+#endif
+)HLSL";
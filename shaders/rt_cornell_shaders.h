@@ -14,6 +14,11 @@
 // - FEATURE_GI: Global illumination (requires USE_RAYQUERY)
 // - FEATURE_REFLECTIONS: Mirror and glass reflections (requires USE_RAYQUERY)
 // - FEATURE_TEMPORAL_DENOISE: Temporal denoising (no RayQuery needed)
+// - FEATURE_INDIRECT_UPSAMPLE: AO/GI come from the IndirectPS pass (--rt-indirect)
+//   instead of being traced in PSMain (requires FEATURE_AO or FEATURE_GI)
+//
+// Compiled after g_rtSamplingShaderCode (RTSampler, -D RT_SAMPLER=n for --sampler)
+// and g_rayStatsShaderCode (CountRays, -D RAY_STATS for --ray-stats)
 
 static const char* g_rtCornellShaderCode = R"HLSL(
 
@@ -33,7 +38,13 @@ cbuffer SceneCB : register(b0) {
     int GIBounces;
     float GIStrength;
     float DenoiseBlendFactor;
-    int _Padding;
+    int IndirectMode;   // RtIndirectRate
+
+    float2 IndirectScale;   // Indirect buffer pixels per output pixel
+    uint2 IndirectSize;     // Indirect pass viewport
+
+    uint FrameNumber;       // Checkerboard parity, sampler sequence index
+    uint3 _Padding;
 };
 
 // ============== DEBUG MODE CONSTANTS ==============
@@ -55,6 +66,13 @@ RaytracingAccelerationStructure Scene : register(t0);
 Texture2D<float4> HistoryBuffer : register(t1);
 #endif
 
+// ============== REDUCED-RATE AO/GI (--rt-indirect) ==============
+#ifdef FEATURE_INDIRECT_UPSAMPLE
+Texture2D<float4> IndirectBuffer : register(t2);   // rgb = GI radiance, a = AO visibility
+Texture2D<float4> IndirectGuide : register(t3);    // xyz = normal, w = view distance (0 = no surface)
+#define INDIRECT_CHECKER 3   // RT_INDIRECT_CHECKER
+#endif
+
 // ============== MATERIAL TYPES ==============
 #define MAT_DIFFUSE  0
 #define MAT_MIRROR   1
@@ -160,19 +178,8 @@ float3x3 RotateX(float angle) {
     return float3x3(1, 0, 0, 0, c, -s, 0, s, c);
 }
 
-uint WangHash(uint seed) {
-    seed = (seed ^ 61) ^ (seed >> 16);
-    seed *= 9;
-    seed = seed ^ (seed >> 4);
-    seed *= 0x27d4eb2d;
-    seed = seed ^ (seed >> 15);
-    return seed;
-}
-
-float Random(inout uint seed) {
-    seed = WangHash(seed);
-    return float(seed) / 4294967295.0;
-}
+// Pixel stride of the white-noise seed (the passes don't know the render size)
+#define RT_SEED_STRIDE 8192
 
 #ifdef FEATURE_RT_LIGHTING
 float SpotlightAttenuation(float3 lightToPoint) {
@@ -182,21 +189,21 @@ float SpotlightAttenuation(float3 lightToPoint) {
 }
 #endif
 
-float3 RandomInDisk(inout uint seed) {
-    float r = sqrt(Random(seed));
-    float theta = 6.28318530718 * Random(seed);
+float3 RandomInDisk(inout RTSampler rng) {
+    float2 u = Sample2D(rng);
+    float r = sqrt(u.x);
+    float theta = 6.28318530718 * u.y;
     return float3(r * cos(theta), 0, r * sin(theta));
 }
 
 // Generate random direction in hemisphere around normal (cosine-weighted)
-float3 RandomInHemisphere(float3 normal, inout uint seed) {
-    float u1 = Random(seed);
-    float u2 = Random(seed);
-    float r = sqrt(u1);
-    float theta = 6.28318530718 * u2;
+float3 RandomInHemisphere(float3 normal, inout RTSampler rng) {
+    float2 u = Sample2D(rng);
+    float r = sqrt(u.x);
+    float theta = 6.28318530718 * u.y;
     float x = r * cos(theta);
     float y = r * sin(theta);
-    float z = sqrt(1.0 - u1);
+    float z = sqrt(1.0 - u.x);
     float3 up = abs(normal.y) < 0.999 ? float3(0, 1, 0) : float3(1, 0, 0);
     float3 tangent = normalize(cross(up, normal));
     float3 bitangent = cross(normal, tangent);
@@ -207,14 +214,14 @@ float3 RandomInHemisphere(float3 normal, inout uint seed) {
 
 #ifdef FEATURE_SHADOWS
 // Trace shadow ray - returns visibility (0 = blocked, 1 = visible)
-float TraceShadow(float3 origin, float3 lightPos, inout uint seed) {
+float TraceShadow(float3 origin, float3 lightPos, inout RTSampler rng) {
     float3 toLight = lightPos - origin;
     float lightDist = length(toLight);
     float3 lightDir = toLight / lightDist;
 
 #ifdef FEATURE_SOFT_SHADOWS
     // Jitter light position for soft shadows
-    float3 jitter = RandomInDisk(seed) * LightRadius;
+    float3 jitter = RandomInDisk(rng) * LightRadius;
     float3 targetPos = lightPos + jitter;
     toLight = targetPos - origin;
     lightDist = length(toLight);
@@ -230,6 +237,7 @@ float TraceShadow(float3 origin, float3 lightPos, inout uint seed) {
 
     query.TraceRayInline(Scene, RAY_FLAG_NONE, 0xFF, ray);
     query.Proceed();
+    CountRays(RAY_SHADOW, 1);
 
     return (query.CommittedStatus() == COMMITTED_NOTHING) ? 1.0 : 0.0;
 }
@@ -294,24 +302,27 @@ float TraceAORay(float3 origin, float3 direction, float maxDist) {
 
     query.TraceRayInline(Scene, RAY_FLAG_NONE, 0xFF, ray);
     query.Proceed();
+    CountRays(RAY_AO, 1);
 
     if (query.CommittedStatus() == COMMITTED_NOTHING) return 1.0;
     return query.CommittedRayT() / maxDist;
 }
 
-float CalculateAO(float3 worldPos, float3 normal, float radius, int numSamples, inout uint seed) {
+float CalculateAO(float3 worldPos, float3 normal, float radius, int numSamples, inout RTSampler rng) {
     float ao = 0.0;
     for (int i = 0; i < numSamples; i++) {
-        float3 sampleDir = RandomInHemisphere(normal, seed);
+        RTSampler aoRng = SamplerLoop(rng, i, numSamples);
+        float3 sampleDir = RandomInHemisphere(normal, aoRng);
         ao += TraceAORay(worldPos + normal * 0.002, sampleDir, radius);
     }
+    SamplerSkip(rng, 1);
     return ao / float(numSamples);
 }
 #endif
 
 // ============== GLOBAL ILLUMINATION ==============
 #ifdef FEATURE_GI
-float3 TraceGIRayIterative(float3 origin, float3 direction, int maxBounces, inout uint seed) {
+float3 TraceGIRayIterative(float3 origin, float3 direction, int maxBounces, inout RTSampler rng) {
     float3 accumulated = float3(0, 0, 0);
     float3 throughput = float3(1, 1, 1);
     float3 rayOrigin = origin;
@@ -327,6 +338,7 @@ float3 TraceGIRayIterative(float3 origin, float3 direction, int maxBounces, inou
 
         query.TraceRayInline(Scene, RAY_FLAG_NONE, 0xFF, ray);
         query.Proceed();
+        CountRays(RAY_GI, 1);
 
         if (query.CommittedStatus() != COMMITTED_TRIANGLE_HIT) {
             accumulated += throughput * float3(0.02, 0.02, 0.03);
@@ -370,6 +382,7 @@ float3 TraceGIRayIterative(float3 origin, float3 direction, int maxBounces, inou
         shadowRay.TMax = sqrt(lightDistSq);
         shadowQuery.TraceRayInline(Scene, RAY_FLAG_NONE, 0xFF, shadowRay);
         shadowQuery.Proceed();
+        CountRays(RAY_SHADOW, 1);
         float shadow = (shadowQuery.CommittedStatus() == COMMITTED_NOTHING) ? 1.0 : 0.0;
 
         float atten = 1.5 / (1.0 + lightDistSq * 0.1);
@@ -380,14 +393,14 @@ float3 TraceGIRayIterative(float3 origin, float3 direction, int maxBounces, inou
         if (p < 0.1) break;
 
         rayOrigin = hitPos + hitNormal * 0.002;
-        rayDir = RandomInHemisphere(hitNormal, seed);
+        rayDir = RandomInHemisphere(hitNormal, rng);
     }
     return accumulated;
 }
 
-float3 CalculateGI(float3 worldPos, float3 normal, int numBounces, inout uint seed) {
-    float3 giDir = RandomInHemisphere(normal, seed);
-    return TraceGIRayIterative(worldPos + normal * 0.002, giDir, numBounces, seed);
+float3 CalculateGI(float3 worldPos, float3 normal, int numBounces, inout RTSampler rng) {
+    float3 giDir = RandomInHemisphere(normal, rng);
+    return TraceGIRayIterative(worldPos + normal * 0.002, giDir, numBounces, rng);
 }
 #endif
 
@@ -403,6 +416,7 @@ float3 TraceRayColor(float3 origin, float3 direction) {
 
     query.TraceRayInline(Scene, RAY_FLAG_NONE, 0xFF, ray);
     query.Proceed();
+    CountRays(RAY_REFLECT, 1);
 
     if (query.CommittedStatus() == COMMITTED_TRIANGLE_HIT) {
         uint primID = query.CommittedPrimitiveIndex();
@@ -498,6 +512,94 @@ float3 DebugObjectIDColor(uint objID) {
     return float3(0, 0, 1);
 }
 
+#ifdef FEATURE_INDIRECT_UPSAMPLE
+// ============== INDIRECT PASS ==============
+// Same geometry as PSMain, drawn into the IndirectSize viewport: traces only
+// the AO and GI rays. Checkerboard discards the half of the pixels that is
+// not due this frame, so those keep last frame's value.
+struct IndirectOutput {
+    float4 Indirect : SV_TARGET0;
+    float4 Guide : SV_TARGET1;
+};
+
+IndirectOutput IndirectPS(PSInput input) {
+    uint2 pixelCoord = uint2(input.Position.xy);
+    if (IndirectMode == INDIRECT_CHECKER && ((pixelCoord.x + pixelCoord.y + FrameNumber) & 1u) != 0)
+        discard;
+
+    float3 worldPos = input.WorldPos;
+    float3 normal = normalize(input.Normal);
+    IndirectOutput output;
+    output.Indirect = float4(0, 0, 0, 1);
+    output.Guide = float4(normal, length(worldPos - CameraPos));
+    if (input.ObjectID == OBJ_LIGHT) return output;
+
+    RTSampler rng = SamplerCreate(pixelCoord, RT_SEED_STRIDE, RT_SEED_STRIDE, FrameNumber, FrameNumber);
+#ifdef FEATURE_AO
+    output.Indirect.a = CalculateAO(worldPos, normal, AORadius, AOSamples, rng);
+#endif
+#ifdef FEATURE_GI
+    output.Indirect.rgb = CalculateGI(worldPos, normal, GIBounces, rng);
+#endif
+    return output;
+}
+
+// How well an indirect texel's surface matches this pixel's: 0 across depth
+// discontinuities and creases, so AO/GI don't bleed between surfaces
+float IndirectWeight(float4 guide, float3 normal, float dist) {
+    if (guide.w <= 0.0) return 0.0;
+    float normalW = pow(saturate(dot(guide.xyz, normal)), 16.0);
+    float depthW = exp(-abs(guide.w - dist) / (0.02 * dist + 0.001));
+    return normalW * depthW;
+}
+
+// Joint bilateral upsample: the bilinear (or checkerboard cross) taps around
+// the pixel, each scaled by IndirectWeight. Falls back to the best matching
+// tap, or to no occlusion / no GI when none lies on this surface.
+float4 FetchIndirect(int2 pixel, float3 normal, float dist) {
+    int2 maxPos = int2(IndirectSize) - 1;
+    float4 sum = 0.0;
+    float weightSum = 0.0;
+    float4 best = float4(0, 0, 0, 1);
+    float bestW = 0.0;
+
+    if (IndirectMode == INDIRECT_CHECKER) {
+        float4 center = IndirectBuffer[pixel];
+        if (((uint(pixel.x) + uint(pixel.y) + FrameNumber) & 1u) == 0) return center;
+        // Traced last frame: the four direct neighbours are this frame's
+        static const int2 cross4[4] = { int2(-1, 0), int2(1, 0), int2(0, -1), int2(0, 1) };
+        float w = IndirectWeight(IndirectGuide[pixel], normal, dist);
+        sum = center * w;
+        weightSum = w;
+        best = center;
+        bestW = w;
+        for (int i = 0; i < 4; i++) {
+            int2 p = clamp(pixel + cross4[i], int2(0, 0), maxPos);
+            float4 v = IndirectBuffer[p];
+            w = IndirectWeight(IndirectGuide[p], normal, dist);
+            sum += v * w;
+            weightSum += w;
+            if (w > bestW) { bestW = w; best = v; }
+        }
+    } else {
+        float2 pos = (float2(pixel) + 0.5) * IndirectScale - 0.5;
+        int2 base = int2(floor(pos));
+        float2 f = pos - float2(base);
+        for (int i = 0; i < 4; i++) {
+            int2 o = int2(i & 1, i >> 1);
+            int2 p = clamp(base + o, int2(0, 0), maxPos);
+            float4 v = IndirectBuffer[p];
+            float w = IndirectWeight(IndirectGuide[p], normal, dist);
+            float bw = (o.x ? f.x : 1.0 - f.x) * (o.y ? f.y : 1.0 - f.y);
+            sum += v * (w * bw);
+            weightSum += w * bw;
+            if (w > bestW) { bestW = w; best = v; }
+        }
+    }
+    return weightSum > 1e-4 ? sum / weightSum : best;
+}
+#endif
+
 // ============== PIXEL SHADER ==============
 float4 PSMain(PSInput input) : SV_TARGET {
     float3 worldPos = input.WorldPos;
@@ -518,8 +620,8 @@ float4 PSMain(PSInput input) : SV_TARGET {
 #ifdef FEATURE_SHADOWS
     if (DebugMode == DEBUG_SHADOWS) {
         uint2 pixelCoord = uint2(input.Position.xy);
-        uint seed = pixelCoord.x * 1973 + pixelCoord.y * 9277;
-        float vis = TraceShadow(worldPos + normal * 0.002, LightPos, seed);
+        RTSampler rng = SamplerCreate(pixelCoord, RT_SEED_STRIDE, RT_SEED_STRIDE, 0, 0);
+        float vis = TraceShadow(worldPos + normal * 0.002, LightPos, rng);
         return float4(vis, vis, vis, 1.0);
     }
 #endif
@@ -540,9 +642,9 @@ float4 PSMain(PSInput input) : SV_TARGET {
     // Emissive (light source)
     if (objID == OBJ_LIGHT) return float4(baseColor, 1.0);
 
-    // Random seed for stochastic sampling
+    // Sampler for stochastic sampling: frame n is sample n of the pixel's sequence
     uint2 pixelCoord = uint2(input.Position.xy);
-    uint seed = pixelCoord.x * 1973 + pixelCoord.y * 9277 + uint(Time * 1000) * 26699;
+    RTSampler rng = SamplerCreate(pixelCoord, RT_SEED_STRIDE, RT_SEED_STRIDE, FrameNumber, FrameNumber);
 
     // Calculate lighting
     float3 toLight = LightPos - worldPos;
@@ -561,10 +663,12 @@ float4 PSMain(PSInput input) : SV_TARGET {
         uint numSamples = 1;
 #endif
         for (uint i = 0; i < numSamples; i++) {
-            shadow += TraceShadow(worldPos + normal * 0.002, LightPos, seed);
+            RTSampler shadowRng = SamplerLoop(rng, i, numSamples);
+            shadow += TraceShadow(worldPos + normal * 0.002, LightPos, shadowRng);
         }
         shadow /= float(numSamples);
     }
+    SamplerSkip(rng, 1);
 #endif
 
     // ============== LIGHTING ==============
@@ -583,15 +687,27 @@ float4 PSMain(PSInput input) : SV_TARGET {
 
     float3 finalColor = ambient + diffuse;
 
+#ifdef FEATURE_INDIRECT_UPSAMPLE
+    float4 indirect = FetchIndirect(int2(pixelCoord), normal, length(worldPos - CameraPos));
+#endif
+
     // ============== AMBIENT OCCLUSION ==============
 #ifdef FEATURE_AO
-    float ao = CalculateAO(worldPos, normal, AORadius, AOSamples, seed);
+#ifdef FEATURE_INDIRECT_UPSAMPLE
+    float ao = indirect.a;
+#else
+    float ao = CalculateAO(worldPos, normal, AORadius, AOSamples, rng);
+#endif
     finalColor *= lerp(1.0 - AOStrength, 1.0, ao);
 #endif
 
     // ============== GLOBAL ILLUMINATION ==============
 #ifdef FEATURE_GI
-    float3 gi = CalculateGI(worldPos, normal, GIBounces, seed);
+#ifdef FEATURE_INDIRECT_UPSAMPLE
+    float3 gi = indirect.rgb;
+#else
+    float3 gi = CalculateGI(worldPos, normal, GIBounces, rng);
+#endif
     finalColor += gi * GIStrength * baseColor;
 #endif
 
@@ -639,25 +755,3 @@ float4 PSMain(PSInput input) : SV_TARGET {
 }
 
 )HLSL";
-
-// ============== TEXT SHADER (unchanged) ==============
-static const char* g_textShaderCode = R"HLSL(
-Texture2D fontTex : register(t0);
-SamplerState samp : register(s0);
-
-struct VSIn { float2 pos : POSITION; float2 uv : TEXCOORD; float4 col : COLOR; };
-struct PSIn { float4 pos : SV_POSITION; float2 uv : TEXCOORD; float4 col : COLOR; };
-
-PSIn TextVS(VSIn i) {
-    PSIn o;
-    o.pos = float4(i.pos, 0, 1);
-    o.uv = i.uv;
-    o.col = i.col;
-    return o;
-}
-
-float4 TextPS(PSIn i) : SV_TARGET {
-    float a = fontTex.Sample(samp, i.uv).r;
-    return float4(i.col.rgb, i.col.a * a);
-}
-)HLSL";
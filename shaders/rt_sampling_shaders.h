@@ -0,0 +1,177 @@
+#pragma once
+// ============== RT / PT SAMPLER ==============
+// --sampler (rt_sampling.h): the random numbers of the DXR 1.0, DXR 1.1, PT
+// (+ --wavefront) and DLSS shaders. Prepended to their source; the backend is
+// chosen with -D RT_SAMPLER=n (RtSamplerDefine):
+//   0 white   WangHash chain per pixel and frame (the original sampling)
+//   1 sobol   2D Sobol points, Owen scrambled per pixel and dimension pair
+//             (Burley 2020, hash based nested uniform scramble)
+//   2 blue    64x64 void-and-cluster blue noise tile, one R2 offset per
+//             dimension, animated along the golden ratio per sample
+// A sampler hands out 2D dimensions in order. Sobol and blue noise index
+// them with the pixel's sample index, so the N samples of a loop (or frame
+// after frame with --accumulate) are stratified instead of independent.
+
+static const char* g_rtSamplingShaderCode = R"HLSL(
+#ifndef RT_SAMPLER
+#define RT_SAMPLER 0
+#endif
+#define RT_SAMPLER_WHITE     0
+#define RT_SAMPLER_SOBOL     1
+#define RT_SAMPLER_BLUENOISE 2
+
+#define BLUE_NOISE_SIZE 64
+
+#if RT_SAMPLER == RT_SAMPLER_BLUENOISE
+// Tile ranks 0..4095, two uint16 per element (t0 in space1, every RT / PT root signature)
+ByteAddressBuffer BlueNoise : register(t0, space1);
+#endif
+
+uint WangHash(uint seed)
+{
+    seed = (seed ^ 61) ^ (seed >> 16);
+    seed *= 9;
+    seed = seed ^ (seed >> 4);
+    seed *= 0x27d4eb2d;
+    seed = seed ^ (seed >> 15);
+    return seed;
+}
+
+struct RTSampler
+{
+    uint seed;      // White: hash chain. Sobol: per-pixel scramble seed
+    uint pixel;     // x | y << 16, blue noise tile position
+    uint index;     // Sample index in the pixel's sequence
+    uint dim;       // Next 2D dimension
+};
+
+// index: first sample of this frame in the pixel's sequence (frame * samples per frame)
+RTSampler SamplerCreate(uint2 pixel, uint width, uint height, uint frame, uint index)
+{
+    RTSampler s;
+#if RT_SAMPLER == RT_SAMPLER_WHITE
+    s.seed = WangHash(pixel.x + pixel.y * width + frame * width * height);
+#else
+    s.seed = WangHash(pixel.x + pixel.y * width);
+#endif
+    s.pixel = (pixel.x & 0xFFFF) | (pixel.y << 16);
+    s.index = index;
+    s.dim = 0;
+    return s;
+}
+
+float SamplerRandom(inout uint seed)
+{
+    seed = WangHash(seed);
+    return float(seed) / 4294967296.0;
+}
+
+// Nested uniform scramble (Laine-Karras permutation in reversed bit order)
+uint OwenScramble(uint x, uint seed)
+{
+    x = reversebits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reversebits(x);
+}
+
+// Second Sobol dimension (the first is reversebits(i))
+uint Sobol2(uint i)
+{
+    uint r = 0;
+    for (uint v = 1u << 31; i != 0; i >>= 1, v ^= v >> 1)
+        if (i & 1) r ^= v;
+    return r;
+}
+
+float2 SobolOwen2D(uint index, uint seed)
+{
+    uint i = OwenScramble(index, seed);
+    uint x = OwenScramble(reversebits(i), WangHash(seed ^ 0x0a2f4b5du));
+    uint y = OwenScramble(Sobol2(i), WangHash(seed ^ 0x5b1d3c77u));
+    return float2(x >> 8, y >> 8) / 16777216.0;
+}
+
+#if RT_SAMPLER == RT_SAMPLER_BLUENOISE
+float BlueNoiseValue(uint2 p)
+{
+    uint i = (p.y % BLUE_NOISE_SIZE) * BLUE_NOISE_SIZE + (p.x % BLUE_NOISE_SIZE);
+    uint word = BlueNoise.Load((i >> 1) * 4);
+    uint rank = (i & 1) ? (word >> 16) : (word & 0xFFFF);
+    return (float(rank) + 0.5) / float(BLUE_NOISE_SIZE * BLUE_NOISE_SIZE);
+}
+
+// Offsets along the R2 sequence keep the dimensions' tile reads uncorrelated
+uint2 BlueNoiseOffset(uint d)
+{
+    return uint2(frac(float2(0.7548776662, 0.5698402910) * float(d + 1)) * BLUE_NOISE_SIZE);
+}
+
+float2 BlueNoise2D(RTSampler s)
+{
+    uint2 p = uint2(s.pixel & 0xFFFF, s.pixel >> 16);
+    float2 v = float2(BlueNoiseValue(p + BlueNoiseOffset(s.dim * 2)),
+                      BlueNoiseValue(p + BlueNoiseOffset(s.dim * 2 + 1)));
+    return frac(v + 0.6180339887 * float(s.index));
+}
+#endif
+
+float2 Sample2D(inout RTSampler s)
+{
+    float2 u;
+#if RT_SAMPLER == RT_SAMPLER_SOBOL
+    u = SobolOwen2D(s.index, WangHash(s.seed + s.dim * 0x9e3779b9u));
+#elif RT_SAMPLER == RT_SAMPLER_BLUENOISE
+    u = BlueNoise2D(s);
+#else
+    u.x = SamplerRandom(s.seed);
+    u.y = SamplerRandom(s.seed);
+#endif
+    s.dim++;
+    return u;
+}
+
+// Decisions (Russian roulette, Fresnel): first component of a 2D dimension
+float Sample1D(inout RTSampler s)
+{
+#if RT_SAMPLER == RT_SAMPLER_WHITE
+    return SamplerRandom(s.seed);
+#else
+    return Sample2D(s).x;
+#endif
+}
+
+// Next sample of the pixel (spp loops): restart at the first dimension.
+// White noise just continues its chain.
+void SamplerNextSample(inout RTSampler s)
+{
+#if RT_SAMPLER != RT_SAMPLER_WHITE
+    s.index++;
+    s.dim = 0;
+#endif
+}
+
+// Sample i of an n-sample loop (soft shadow / AO rays) at the current
+// dimensions: sequence index s.index * n + i. Follow the loop with
+// SamplerSkip(s, dimensions one iteration used).
+RTSampler SamplerLoop(RTSampler s, uint i, uint n)
+{
+    RTSampler r = s;
+    r.index = s.index * n + i;
+#if RT_SAMPLER == RT_SAMPLER_WHITE
+    r.seed = WangHash(s.seed + i * 0x9e3779b9u);
+#endif
+    return r;
+}
+
+void SamplerSkip(inout RTSampler s, uint dims)
+{
+    s.dim += dims;
+#if RT_SAMPLER == RT_SAMPLER_WHITE
+    s.seed = WangHash(s.seed ^ dims);
+#endif
+}
+)HLSL";
@@ -0,0 +1,214 @@
+// ============== STARTUP PROFILER ==============
+// Phase stack, process-creation origin and the flame-style log of the
+// startup breakdown (see startup_profiler.h)
+
+#include "startup_profiler.h"
+
+#define STARTUP_BAR_WIDTH 20
+
+static StartupPhase s_phases[STARTUP_MAX_PHASES];
+static UINT s_phaseCount = 0;
+static UINT s_dropped = 0;                      // Phases lost to a full s_phases
+static int s_stack[STARTUP_MAX_DEPTH];          // Open phases, -1 = dropped
+static bool s_stackStep[STARTUP_MAX_DEPTH];
+static int s_stackDepth = 0;
+static UINT s_overflow = 0;                     // Begins past STARTUP_MAX_DEPTH, matched by ends
+static LARGE_INTEGER s_freq = {};
+static LARGE_INTEGER s_origin = {};             // QPC value of startMs 0
+static volatile DWORD s_owner = 0;
+static bool s_cold = false;
+static bool s_pending = false;                  // Renderer initialized, first frame not logged yet
+static bool s_complete = false;
+
+// ============== PHASE STACK ==============
+static double NowMs() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)(now.QuadPart - s_origin.QuadPart) * 1000.0 / s_freq.QuadPart;
+}
+
+// The tree is frozen once logged, until the next StartupRendererBegin
+static bool OwnerThread() {
+    return s_freq.QuadPart != 0 && !s_complete && GetCurrentThreadId() == s_owner;
+}
+
+static int OpenParent() {
+    for (int i = s_stackDepth - 1; i >= 0; i--)
+        if (s_stack[i] >= 0) return s_stack[i];
+    return -1;
+}
+
+static int AddPhase(const char* name, bool step, bool gpu) {
+    if (s_phaseCount >= STARTUP_MAX_PHASES) { s_dropped++; return -1; }
+    StartupPhase& p = s_phases[s_phaseCount];
+    memset(&p, 0, sizeof(p));
+    strncpy_s(p.name, name ? name : "", _TRUNCATE);
+    p.parent = OpenParent();
+    p.depth = p.parent >= 0 ? s_phases[p.parent].depth + 1 : 0;
+    p.step = step;
+    p.gpu = gpu;
+    p.startMs = NowMs();
+    return (int)s_phaseCount++;
+}
+
+static void Push(const char* name, bool step) {
+    if (s_stackDepth >= STARTUP_MAX_DEPTH) { s_overflow++; return; }
+    s_stack[s_stackDepth] = AddPhase(name, step, false);
+    s_stackStep[s_stackDepth] = step;
+    s_stackDepth++;
+}
+
+static void PopTop() {
+    int index = s_stack[--s_stackDepth];
+    if (index >= 0) s_phases[index].cpuMs = NowMs() - s_phases[index].startMs;
+}
+
+static void ResetPhases() {
+    s_phaseCount = 0;
+    s_dropped = 0;
+    s_stackDepth = 0;
+    s_overflow = 0;
+}
+
+// ============== RECORDING ==============
+void StartupProfilerInit() {
+    QueryPerformanceFrequency(&s_freq);
+    QueryPerformanceCounter(&s_origin);
+    s_owner = GetCurrentThreadId();
+
+    // Move the origin back to the process creation time: the loader, DLL
+    // imports and static initializers ran before WinMain
+    double beforeMs = 0.0;
+    FILETIME creation, exitTime, kernelTime, userTime, now;
+    if (GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernelTime, &userTime)) {
+        GetSystemTimePreciseAsFileTime(&now);
+        ULARGE_INTEGER c = { { creation.dwLowDateTime, creation.dwHighDateTime } };
+        ULARGE_INTEGER n = { { now.dwLowDateTime, now.dwHighDateTime } };
+        if (n.QuadPart > c.QuadPart) beforeMs = (double)(n.QuadPart - c.QuadPart) / 10000.0;
+    }
+    s_origin.QuadPart -= (LONGLONG)(beforeMs * s_freq.QuadPart / 1000.0);
+
+    ResetPhases();
+    s_cold = true;
+    s_pending = false;
+    s_complete = false;
+    Push("Process", false);
+    if (s_stackDepth) s_phases[0].startMs = 0.0;
+    if (beforeMs > 0.0) {
+        int index = AddPhase("Before WinMain", false, false);
+        if (index >= 0) { s_phases[index].startMs = 0.0; s_phases[index].cpuMs = beforeMs; }
+    }
+}
+
+void StartupPhaseBegin(const char* name) {
+    if (!OwnerThread()) return;
+    Push(name, false);
+}
+
+void StartupPhaseEnd() {
+    if (!OwnerThread()) return;
+    if (s_overflow) { s_overflow--; return; }
+    while (s_stackDepth > 0 && s_stackStep[s_stackDepth - 1]) PopTop();
+    if (s_stackDepth > 0) PopTop();
+}
+
+void StartupStep(const char* name) {
+    if (!OwnerThread() || s_overflow) return;
+    if (s_stackDepth > 0 && s_stackStep[s_stackDepth - 1]) PopTop();
+    Push(name, true);
+}
+
+void StartupAddGpuTime(const char* name, double ms) {
+    if (!OwnerThread() || ms < 0.0) return;
+    int index = AddPhase(name, false, true);
+    if (index < 0) return;
+    // Collected right after the wait, so the work ran just before now
+    s_phases[index].gpuMs = ms;
+    s_phases[index].startMs = max(s_phases[index].startMs - ms, 0.0);
+}
+
+// ============== RENDERER LIFECYCLE ==============
+void StartupRendererBegin(const char* rendererId) {
+    if (!s_freq.QuadPart) return;
+    s_owner = GetCurrentThreadId();
+    if (s_complete || !s_cold || s_stackDepth == 0) {
+        // Warm start (F5, --sweep): a new tree for this renderer alone
+        QueryPerformanceCounter(&s_origin);
+        ResetPhases();
+        s_cold = false;
+        Push("Renderer switch", false);
+    } else {
+        // Still cold: a failed init before this one stays in the tree
+        while (s_stackDepth > 1) PopTop();
+        s_overflow = 0;
+    }
+    char name[STARTUP_NAME_LEN];
+    sprintf_s(name, "Renderer %s", rendererId ? rendererId : "?");
+    Push(name, false);
+    s_pending = true;
+    s_complete = false;
+}
+
+static void LogBreakdown() {
+    if (s_phaseCount == 0) return;
+    const StartupPhase& root = s_phases[0];
+    Log("[INFO] Startup: %.1f ms %s to the first frame%s\n", root.cpuMs,
+        s_cold ? "from process creation" : "from the renderer switch",
+        s_dropped ? " (phase table full, some phases dropped)" : "");
+    Log("[INFO] Startup   total ms   self ms      %%  %-*s  phase\n", STARTUP_BAR_WIDTH, "");
+    for (UINT i = 0; i < s_phaseCount; i++) {
+        const StartupPhase& p = s_phases[i];
+        char bar[STARTUP_BAR_WIDTH + 1];
+        int fill = root.cpuMs > 0.0 ? (int)((p.gpu ? p.gpuMs : p.cpuMs) / root.cpuMs * STARTUP_BAR_WIDTH + 0.5) : 0;
+        fill = min(max(fill, 0), STARTUP_BAR_WIDTH);
+        for (int b = 0; b < STARTUP_BAR_WIDTH; b++) bar[b] = b < fill ? (p.gpu ? '=' : '#') : ' ';
+        bar[STARTUP_BAR_WIDTH] = 0;
+        if (p.gpu) {
+            Log("[INFO] Startup %10.2f %9s         %s  %*s%s (GPU)\n",
+                p.gpuMs, "", bar, p.depth * 2, "", p.name);
+        } else {
+            double pct = root.cpuMs > 0.0 ? p.cpuMs * 100.0 / root.cpuMs : 0.0;
+            Log("[INFO] Startup %10.2f %9.2f %5.1f%%  %s  %*s%s\n",
+                p.cpuMs, p.selfMs, pct, bar, p.depth * 2, "", p.name);
+        }
+    }
+}
+
+void StartupFrameBegin() {
+    if (!s_pending || !OwnerThread()) return;
+    // The renderer phase ends with its init; steps it left open end with it
+    while (s_stackDepth > 1) PopTop();
+    Push("First frame", false);
+}
+
+void StartupFrameEnd() {
+    if (!s_pending || !OwnerThread()) return;
+    while (s_stackDepth > 0) PopTop();
+    s_overflow = 0;
+
+    for (UINT i = 0; i < s_phaseCount; i++) s_phases[i].selfMs = s_phases[i].cpuMs;
+    for (UINT i = 0; i < s_phaseCount; i++) {
+        const StartupPhase& p = s_phases[i];
+        if (p.parent >= 0 && !p.gpu) s_phases[p.parent].selfMs -= p.cpuMs;
+    }
+    s_pending = false;
+    s_complete = true;
+    LogBreakdown();
+}
+
+// ============== RESULTS ==============
+bool StartupComplete() {
+    return s_complete;
+}
+
+bool StartupColdStart() {
+    return s_cold;
+}
+
+UINT StartupPhaseCount() {
+    return s_complete ? s_phaseCount : 0;
+}
+
+const StartupPhase* StartupGetPhase(UINT index) {
+    return s_complete && index < s_phaseCount ? &s_phases[index] : nullptr;
+}
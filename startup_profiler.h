@@ -0,0 +1,65 @@
+#pragma once
+// ============== STARTUP PROFILER ==============
+// Hierarchical CPU timer for the cold start, from process creation to the
+// first rendered frame. Phases nest as a stack: StartupScope (RAII) for a
+// helper or a block, StartupStep for the straight-line body of an init
+// function, where each step ends the previous one and the last is closed by
+// whatever encloses it. Init-time GPU work (AS builds) is timed with
+// timestamp queries by the backend and added with StartupAddGpuTime as a
+// leaf of the phase that submitted it; GPU leaves overlap their parent's CPU
+// time and are not part of its self time.
+//
+// The process root starts at the process creation time (loader and CRT init
+// show up as "Before WinMain"), WinMain adds its own phases, and each
+// InitRenderer opens a renderer phase. The breakdown is logged after the
+// first frame of a renderer and kept for the benchmark report's "startup"
+// block. Only the first renderer of the process is a cold start; a later one
+// (F5, --sweep) replaces the tree with its own init and first frame.
+//
+// Phases are recorded on one thread only: the thread that called
+// StartupProfilerInit, then the render thread from StartupRendererBegin on.
+// Calls from any other thread (precompile workers) are ignored, so their
+// time is part of the enclosing phase on the owning thread.
+
+#include "common.h"
+
+#define STARTUP_MAX_PHASES 256
+#define STARTUP_MAX_DEPTH 16
+#define STARTUP_NAME_LEN 48
+
+struct StartupPhase {
+    char name[STARTUP_NAME_LEN];
+    int parent;             // Index of the enclosing phase, -1 for the root
+    int depth;
+    bool gpu;               // GPU leaf: gpuMs is valid, cpuMs is 0
+    bool step;              // Opened by StartupStep
+    double startMs;         // Since the root started (process creation for a cold start)
+    double cpuMs;           // Wall-clock, children included
+    double selfMs;          // cpuMs minus the CPU phases directly below
+    double gpuMs;
+};
+
+// ============== RECORDING ==============
+void StartupProfilerInit();                     // First thing in WinMain
+void StartupPhaseBegin(const char* name);       // Name is copied (truncated to STARTUP_NAME_LEN)
+void StartupPhaseEnd();                         // Also closes steps left open inside the phase
+void StartupStep(const char* name);             // Ends the open step at this level, starts the next
+void StartupAddGpuTime(const char* name, double ms);
+
+struct StartupScope {
+    explicit StartupScope(const char* name) { StartupPhaseBegin(name); }
+    ~StartupScope() { StartupPhaseEnd(); }
+    StartupScope(const StartupScope&) = delete;
+    StartupScope& operator=(const StartupScope&) = delete;
+};
+
+// ============== RENDERER LIFECYCLE ==============
+void StartupRendererBegin(const char* rendererId);  // InitRenderer, before the backend's init
+void StartupFrameBegin();                       // Around every RenderFrame; no-ops once the
+void StartupFrameEnd();                         // first frame after an init has been logged
+
+// ============== RESULTS ==============
+bool StartupComplete();                         // A renderer reached its first frame
+bool StartupColdStart();                        // The tree starts at process creation
+UINT StartupPhaseCount();
+const StartupPhase* StartupGetPhase(UINT index);    // 0 = root
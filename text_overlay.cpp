@@ -0,0 +1,127 @@
+// ============== TEXT OVERLAY ==============
+// Layout, dirty tracking and shader source generation for the instanced
+// glyph overlay (see text_overlay.h).
+
+#include "text_overlay.h"
+#include "shaders/overlay_shaders.h"
+#include <cstring>
+
+const float g_overlayPalette[OVERLAY_COLOR_COUNT][4] = {
+    { 0.0f, 0.0f, 0.0f, 0.8f },     // Shadow
+    { 1.0f, 1.0f, 1.0f, 1.0f },     // White
+    { 0.5f, 1.0f, 0.5f, 1.0f },     // Green
+    { 1.0f, 0.85f, 0.2f, 1.0f },    // Yellow
+    { 1.0f, 0.35f, 0.3f, 1.0f },    // Red
+};
+
+// ============== LAYOUT ==============
+bool OverlaySetText(TextOverlay& overlay, const char* text, OverlayColor color) {
+    if (!text) text = "";
+    if (overlay.version != 0 && overlay.color == color && strncmp(overlay.text, text, OVERLAY_MAX_TEXT) == 0)
+        return false;
+    overlay.color = color;
+    strncpy_s(overlay.text, text, _TRUNCATE);
+
+    const float charW = 8.0f * OVERLAY_SCALE;
+    const float lineH = 8.0f * OVERLAY_SCALE * 1.4f;
+    UINT count = 0, line = 0;
+    float cx = (float)OVERLAY_ORIGIN;
+    uint8_t lineColor = (uint8_t)color;
+    for (const char* p = overlay.text; *p && count < OVERLAY_MAX_GLYPHS; p++) {
+        if (*p == '\n') { cx = (float)OVERLAY_ORIGIN; line++; lineColor = (uint8_t)color; continue; }
+        if (*p > 0 && *p < OVERLAY_COLOR_COUNT) { lineColor = (uint8_t)*p; continue; }
+        if (*p < 32 || *p > 127) continue;
+        if (*p != ' ') {
+            // Spaces only advance; they have no bits to draw
+            GlyphInstance& g = overlay.instances[OVERLAY_MAX_GLYPHS + count++];
+            g.x = (uint16_t)cx;
+            g.y = (uint16_t)(OVERLAY_ORIGIN + (UINT)(line * lineH + 0.5f));
+            g.ch = (uint8_t)(*p - 32);
+            g.color = lineColor;
+            g.reserved = 0;
+        }
+        cx += charW;
+    }
+
+    // Shadow range first so it is drawn underneath, then move the text down to [N, 2N)
+    for (UINT i = 0; i < count; i++) {
+        GlyphInstance g = overlay.instances[OVERLAY_MAX_GLYPHS + i];
+        overlay.instances[count + i] = g;
+        g.x = (uint16_t)(g.x + OVERLAY_SHADOW_OFFSET);
+        g.y = (uint16_t)(g.y + OVERLAY_SHADOW_OFFSET);
+        g.color = OVERLAY_COLOR_SHADOW;
+        overlay.instances[i] = g;
+    }
+    overlay.glyphCount = count;
+    overlay.version++;
+    if (overlay.version == 0) overlay.version = 1;
+    return true;
+}
+
+void OverlayInvalidate(TextOverlay& overlay) {
+    overlay.version = 0;
+    overlay.glyphCount = 0;
+}
+
+UINT OverlayExpandVerts(const TextOverlay& overlay, TextVert* out, UINT maxVerts,
+                        float scaleX, float scaleY, float offsetX, float offsetY) {
+    const float size = 8.0f * OVERLAY_SCALE;
+    UINT n = 0;
+    for (UINT i = 0; i < OverlayInstanceCount(overlay) && n + 6 <= maxVerts; i++) {
+        const GlyphInstance& g = overlay.instances[i];
+        const float* c = g_overlayPalette[g.color < OVERLAY_COLOR_COUNT ? g.color : OVERLAY_COLOR_WHITE];
+        int col = g.ch % 16, row = g.ch / 16;
+        float u0 = col * 8.0f / 128.0f, v0 = row * 8.0f / 48.0f;
+        float u1 = u0 + 8.0f / 128.0f, v1 = v0 + 8.0f / 48.0f;
+        float x0 = g.x * scaleX + offsetX, y0 = g.y * scaleY + offsetY;
+        float x1 = (g.x + size) * scaleX + offsetX, y1 = (g.y + size) * scaleY + offsetY;
+
+        out[n++] = { x0, y0, u0, v0, c[0], c[1], c[2], c[3] };
+        out[n++] = { x1, y0, u1, v0, c[0], c[1], c[2], c[3] };
+        out[n++] = { x0, y1, u0, v1, c[0], c[1], c[2], c[3] };
+        out[n++] = { x1, y0, u1, v0, c[0], c[1], c[2], c[3] };
+        out[n++] = { x1, y1, u1, v1, c[0], c[1], c[2], c[3] };
+        out[n++] = { x0, y1, u0, v1, c[0], c[1], c[2], c[3] };
+    }
+    return n;
+}
+
+// ============== SHADER SOURCE ==============
+// g_font8x8 packed little-endian, 4 rows per uint: row r of char c is byte
+// (r & 3) of OverlayFont[c * 2 + r / 4]
+static std::string OverlayTables(bool glsl) {
+    std::string s;
+    char buf[96];
+    sprintf_s(buf, "#define OVERLAY_SCALE %.3f\n#define OVERLAY_COLOR_COUNT %d\n", OVERLAY_SCALE, (int)OVERLAY_COLOR_COUNT);
+    s += buf;
+    s += glsl ? "const uint OverlayFont[192] = uint[192](" : "static const uint OverlayFont[192] = {";
+    for (int c = 0; c < 96; c++) {
+        for (int k = 0; k < 2; k++) {
+            const unsigned char* r = &g_font8x8[c][k * 4];
+            unsigned int packed = r[0] | (r[1] << 8) | (r[2] << 16) | ((unsigned int)r[3] << 24);
+            sprintf_s(buf, "%s0x%08Xu", (c | k) ? "," : "", packed);
+            s += buf;
+        }
+        if ((c & 7) == 7) s += "\n";
+    }
+    s += glsl ? ");\n" : "};\n";
+
+    sprintf_s(buf, glsl ? "const vec4 OverlayPalette[%d] = vec4[%d](" : "static const float4 OverlayPalette[%d] = {",
+              (int)OVERLAY_COLOR_COUNT, (int)OVERLAY_COLOR_COUNT);
+    s += buf;
+    for (int i = 0; i < OVERLAY_COLOR_COUNT; i++) {
+        const float* c = g_overlayPalette[i];
+        sprintf_s(buf, "%s%s(%.3f, %.3f, %.3f, %.3f)", i ? ", " : "", glsl ? "vec4" : "float4", c[0], c[1], c[2], c[3]);
+        s += buf;
+    }
+    s += glsl ? ");\n" : "};\n";
+    return s;
+}
+
+std::string OverlayShaderHLSL() {
+    return OverlayTables(false) + g_overlayHLSL;
+}
+
+std::string OverlayShaderGLSL(bool vertexStage) {
+    return OverlayTables(true) + (vertexStage ? g_overlayGLSLVS : g_overlayGLSLFS);
+}
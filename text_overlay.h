@@ -0,0 +1,89 @@
+#pragma once
+// ============== TEXT OVERLAY ==============
+// Instanced glyph overlay shared by all renderers. The overlay string is laid
+// out once per change into 8-byte GlyphInstance records (pixel position, char
+// code, palette index); the GPU expands each instance into a 4-vertex strip
+// and tests the 8x8 font bits in the pixel shader, so there is no per-frame
+// CPU vertex generation, no font texture and no sampler.
+//
+// The instance array holds two ranges of glyphCount instances: the drop shadow
+// ([0, N), offset by OVERLAY_SHADOW_OFFSET, OVERLAY_COLOR_SHADOW) followed by
+// the text itself ([N, 2N)), so one DrawInstanced(4, 2N) draws both and the
+// shadow is always behind the text.
+//
+// OverlaySetText compares against the previous string and only rebuilds (and
+// bumps version) when it differs; renderers keep one version per upload slice
+// and copy instances only when a slice is stale. Backends whose text shaders
+// can't take instances (precompiled SPIR-V) use OverlayExpandVerts to turn the
+// same layout into TextVert triangles, again only on change.
+
+#include "common.h"
+#include <cstdint>
+
+// ============== CONSTANTS ==============
+#define OVERLAY_MAX_GLYPHS 1024                     // Per range; buffers hold 2x (shadow + text)
+#define OVERLAY_MAX_INSTANCES (2 * OVERLAY_MAX_GLYPHS)
+#define OVERLAY_MAX_TEXT 2048
+#define OVERLAY_SCALE 1.5f                          // 8x8 glyphs drawn as 12x12 pixels
+#define OVERLAY_ORIGIN 10                           // Top-left corner of the first line
+#define OVERLAY_SHADOW_OFFSET 2
+
+// ============== PALETTE ==============
+// Indexed by GlyphInstance::color; embedded in the overlay shaders
+enum OverlayColor {
+    OVERLAY_COLOR_SHADOW,
+    OVERLAY_COLOR_WHITE,
+    OVERLAY_COLOR_GREEN,
+    OVERLAY_COLOR_YELLOW,
+    OVERLAY_COLOR_RED,
+    OVERLAY_COLOR_COUNT
+};
+extern const float g_overlayPalette[OVERLAY_COLOR_COUNT][4];
+
+// In-string color switch, valid until the end of the line:
+// "RT Features: " OVERLAY_TEXT_GREEN "AO GI"
+#define OVERLAY_TEXT_GREEN "\x02"
+#define OVERLAY_TEXT_YELLOW "\x03"
+#define OVERLAY_TEXT_RED "\x04"
+
+// ============== INSTANCES ==============
+struct GlyphInstance {
+    uint16_t x, y;          // Top-left corner in pixels
+    uint8_t ch;             // Character code - 32 (g_font8x8 row)
+    uint8_t color;          // OverlayColor
+    uint16_t reserved;
+};
+static_assert(sizeof(GlyphInstance) == 8, "GlyphInstance must stay 8 bytes (input layouts use offsets 0 and 4)");
+
+struct TextOverlay {
+    char text[OVERLAY_MAX_TEXT] = {};
+    GlyphInstance instances[OVERLAY_MAX_INSTANCES];
+    OverlayColor color = OVERLAY_COLOR_WHITE;
+    UINT glyphCount = 0;    // Per range; 2 * glyphCount instances are valid
+    UINT version = 0;       // Bumped by every rebuild, 0 = never built
+};
+
+// Lays out text at OVERLAY_ORIGIN ('\n' starts a new line) in color, or
+// the color selected by an OVERLAY_TEXT_* switch earlier on the line.
+// Returns true if the string (or color) differed and the instances were
+// rebuilt.
+bool OverlaySetText(TextOverlay& overlay, const char* text, OverlayColor color = OVERLAY_COLOR_WHITE);
+
+// Forces the next OverlaySetText to rebuild (renderer reset / resize)
+void OverlayInvalidate(TextOverlay& overlay);
+
+inline UINT OverlayInstanceCount(const TextOverlay& overlay) { return overlay.glyphCount * 2; }
+inline UINT OverlayInstanceBytes(const TextOverlay& overlay) { return OverlayInstanceCount(overlay) * sizeof(GlyphInstance); }
+
+// Expands the instances into 6 TextVert per glyph, positions mapped as
+// pixel * scale + offset (e.g. 2 / width and -1 for Vulkan NDC) and UVs into
+// the 128x48 font atlas. Returns the vertex count (multiple of 6).
+UINT OverlayExpandVerts(const TextOverlay& overlay, TextVert* out, UINT maxVerts,
+                        float scaleX, float scaleY, float offsetX, float offsetY);
+
+// ============== SHADER SOURCE ==============
+// Concatenates the generated font / palette tables with the shader bodies in
+// shaders/overlay_shaders.h. HLSL entry points are GlyphVS / GlyphPS (one
+// source for D3D11 and D3D12); GLSL sources have no #version line.
+std::string OverlayShaderHLSL();
+std::string OverlayShaderGLSL(bool vertexStage);
@@ -0,0 +1,72 @@
+// ============== TLAS REFIT / REBUILD POLICY ==============
+// Transform-drift based refit vs rebuild decision (see tlas_policy.h)
+
+#include "tlas_policy.h"
+
+float g_tlasRebuildThreshold = TLAS_DEFAULT_REBUILD_THRESHOLD;
+UINT g_tlasRebuildPeriod = TLAS_DEFAULT_REBUILD_PERIOD;
+
+static UINT s_refits = 0;
+static UINT s_rebuilds = 0;
+static float s_maxDrift = 0.0f;   // Largest drift that was still refit
+
+static const float* TransformAt(const void* instances, UINT i, size_t stride) {
+    return (const float*)((const BYTE*)instances + i * stride);
+}
+
+bool TlasPolicyDecide(TlasPolicy& policy, const void* instances, UINT count, size_t stride) {
+    bool rebuild = !policy.built || policy.builtTransforms.size() != count * 12 ||
+                   (g_tlasRebuildPeriod && policy.framesSinceBuild + 1 >= g_tlasRebuildPeriod);
+
+    float drift = 0.0f;
+    for (UINT i = 0; i < count && !rebuild; i++) {
+        const float* m = TransformAt(instances, i, stride);
+        const float* b = &policy.builtTransforms[i * 12];
+        for (int e = 0; e < 12; e++) {
+            float d = fabsf(m[e] - b[e]);
+            if (d > drift) drift = d;
+        }
+    }
+    if (drift >= g_tlasRebuildThreshold) rebuild = true;
+
+    if (!rebuild) {
+        policy.framesSinceBuild++;
+        s_refits++;
+        if (drift > s_maxDrift) s_maxDrift = drift;
+        return false;
+    }
+
+    policy.builtTransforms.resize(count * 12);
+    for (UINT i = 0; i < count; i++)
+        memcpy(&policy.builtTransforms[i * 12], TransformAt(instances, i, stride), 12 * sizeof(float));
+    policy.framesSinceBuild = 0;
+    policy.built = true;
+    s_rebuilds++;
+    return true;
+}
+
+void TlasPolicyInvalidate(TlasPolicy& policy) {
+    policy.built = false;
+    policy.framesSinceBuild = 0;
+}
+
+// ============== STATS ==============
+void TlasStatsReset() {
+    s_refits = 0;
+    s_rebuilds = 0;
+    s_maxDrift = 0.0f;
+}
+
+void TlasStatsFormat(char* buf, size_t size) {
+    if (!buf || size == 0) return;
+    buf[0] = 0;
+    if (!s_refits && !s_rebuilds) return;
+    _snprintf_s(buf, size, _TRUNCATE, "TLAS: %u refits | %u rebuilds (max drift %.2f)",
+                s_refits, s_rebuilds, s_maxDrift);
+}
+
+void TlasWriteJson(FILE* f) {
+    if (!s_refits && !s_rebuilds) return;
+    fprintf(f, "  \"tlas\": { \"refits\": %u, \"rebuilds\": %u, \"maxRefitDrift\": %.4f, \"rebuildThreshold\": %.4f, \"rebuildPeriod\": %u },\n",
+        s_refits, s_rebuilds, s_maxDrift, g_tlasRebuildThreshold, g_tlasRebuildPeriod);
+}
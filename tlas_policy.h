@@ -0,0 +1,41 @@
+#pragma once
+// ============== TLAS REFIT / REBUILD POLICY ==============
+// Shared by every TLAS update path (D3D12 PT / PT + DLSS / DXR 1.1 / DXR 1.0,
+// Vulkan RT / RQ; recorders in d3d12/d3d12_tlas.cpp and vulkan/vk_tlas.h).
+// Updates run on the queue that traces, except Vulkan RQ with --async-compute,
+// where the refit chain runs on the compute queue.
+//
+// A refit keeps the BVH topology of the last full build and only stretches its
+// bounds, so trace cost creeps up the further instances move from the pose the
+// tree was built for. Each frame the policy compares the instance transforms
+// with the ones of the last full build: while the largest 3x4 element change
+// stays below --tlas-rebuild-threshold the TLAS is refit, otherwise - or every
+// --tlas-rebuild-period frames - it is rebuilt from scratch.
+//
+// Both D3D12 instance descs and VkAccelerationStructureInstanceKHR start with
+// a row-major 3x4 float transform, so the policy reads them through a stride.
+
+#include "common.h"
+
+#define TLAS_DEFAULT_REBUILD_THRESHOLD 0.5f
+#define TLAS_DEFAULT_REBUILD_PERIOD 240
+
+extern float g_tlasRebuildThreshold;   // --tlas-rebuild-threshold=D, 0 = rebuild every frame
+extern UINT g_tlasRebuildPeriod;       // --tlas-rebuild-period=N frames, 0 = only on threshold
+
+// One per TLAS chain (a renderer's TLAS, or its per-frame-slot TLAS that
+// refit from one another)
+struct TlasPolicy {
+    std::vector<float> builtTransforms;   // 12 floats per instance at the last full build
+    UINT framesSinceBuild = 0;
+    bool built = false;                   // false: next update must be a full build
+};
+
+// True = record a full build (and remember these transforms), false = refit
+bool TlasPolicyDecide(TlasPolicy& policy, const void* instances, UINT count, size_t stride);
+void TlasPolicyInvalidate(TlasPolicy& policy);   // Buffers recreated: force a full build
+
+// ============== STATS ==============
+void TlasStatsReset();                        // InitRenderer / benchmark start
+void TlasStatsFormat(char* buf, size_t size); // e.g. "TLAS: 236 refits | 4 rebuilds (max drift 0.41)"
+void TlasWriteJson(FILE* f);                  // Benchmark report "tlas" block (incl. trailing comma)
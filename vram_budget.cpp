@@ -0,0 +1,149 @@
+// ============== VRAM BUDGET ==============
+// Budget sampling, peaks and the overlay / report output (see vram_budget.h)
+
+#include "vram_budget.h"
+#include "text_overlay.h"
+
+#define VRAM_WARN_PERCENT 90
+#define VRAM_MB(bytes) ((double)(bytes) / (1024.0 * 1024.0))
+
+static const char* s_categoryNames[VRAM_CATEGORY_COUNT] = { "BLAS", "TLAS", "Scratch", "G-buffers", "History", "DLSS" };
+static const char* s_categoryKeys[VRAM_CATEGORY_COUNT] = { "blas", "tlas", "scratch", "gbuffer", "history", "dlss" };
+
+static IDXGIAdapter3* s_adapter3 = nullptr;
+static VramQueryFn s_query = nullptr;           // Backend override of DXGI
+static const char* s_source = "none";
+static VramCategoryFn s_categories = nullptr;
+
+static VramBudget s_current = {};
+static VramBudget s_peak = {};                  // Usage maxima; budgets at the time of the local peak
+static UINT64 s_categoryBytes[VRAM_CATEGORY_COUNT] = {};
+static UINT64 s_categoryPeak[VRAM_CATEGORY_COUNT] = {};
+static bool s_hasSample = false;
+static UINT s_samples = 0;
+static UINT s_overBudgetSamples = 0;
+static bool s_warnedNear = false;
+static bool s_warnedOver = false;
+
+const char* VramCategoryName(UINT category) {
+    return category < VRAM_CATEGORY_COUNT ? s_categoryNames[category] : "?";
+}
+
+static bool QueryDxgi(VramBudget& out) {
+    if (!s_adapter3) return false;
+    DXGI_QUERY_VIDEO_MEMORY_INFO local = {}, nonLocal = {};
+    if (FAILED(s_adapter3->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &local))) return false;
+    if (FAILED(s_adapter3->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL, &nonLocal))) return false;
+    out.localUsage = local.CurrentUsage;
+    out.localBudget = local.Budget;
+    out.nonLocalUsage = nonLocal.CurrentUsage;
+    out.nonLocalBudget = nonLocal.Budget;
+    return true;
+}
+
+// ============== FRONTEND ==============
+void VramReset(IDXGIAdapter1* adapter) {
+    if (s_adapter3) { s_adapter3->Release(); s_adapter3 = nullptr; }
+    if (adapter && FAILED(adapter->QueryInterface(IID_PPV_ARGS(&s_adapter3)))) {
+        Log("[WARN] VRAM: IDXGIAdapter3 unavailable, no budget from DXGI\n");
+        s_adapter3 = nullptr;
+    }
+    s_query = nullptr;
+    s_source = s_adapter3 ? "DXGI" : "none";
+    s_categories = nullptr;
+    s_current = {};
+    s_peak = {};
+    for (UINT i = 0; i < VRAM_CATEGORY_COUNT; i++) s_categoryBytes[i] = s_categoryPeak[i] = 0;
+    s_hasSample = false;
+    s_samples = s_overBudgetSamples = 0;
+    s_warnedNear = s_warnedOver = false;
+}
+
+void VramTick() {
+    VramBudget b = {};
+    bool ok = s_query ? s_query(b) : QueryDxgi(b);
+    UINT64 bytes[VRAM_CATEGORY_COUNT] = {};
+    if (s_categories) s_categories(bytes);
+    for (UINT i = 0; i < VRAM_CATEGORY_COUNT; i++) {
+        s_categoryBytes[i] = bytes[i];
+        s_categoryPeak[i] = max(s_categoryPeak[i], bytes[i]);
+    }
+    if (!ok) return;
+
+    s_current = b;
+    s_hasSample = true;
+    s_samples++;
+    if (b.localUsage >= s_peak.localUsage) {
+        s_peak.localUsage = b.localUsage;
+        s_peak.localBudget = b.localBudget;
+    }
+    if (b.nonLocalUsage >= s_peak.nonLocalUsage) {
+        s_peak.nonLocalUsage = b.nonLocalUsage;
+        s_peak.nonLocalBudget = b.nonLocalBudget;
+    }
+
+    if (!b.localBudget) return;
+    if (b.localUsage > b.localBudget) {
+        s_overBudgetSamples++;
+        if (!s_warnedOver) {
+            Log("[WARN] VRAM: %.0f MB used, over the %.0f MB budget - allocations may be paged to system memory\n",
+                VRAM_MB(b.localUsage), VRAM_MB(b.localBudget));
+            s_warnedOver = true;
+        }
+    } else if (b.localUsage * 100 >= b.localBudget * VRAM_WARN_PERCENT && !s_warnedNear) {
+        Log("[WARN] VRAM: %.0f MB used, %u%% of the %.0f MB budget\n", VRAM_MB(b.localUsage),
+            (UINT)(b.localUsage * 100 / b.localBudget), VRAM_MB(b.localBudget));
+        s_warnedNear = true;
+    }
+}
+
+void VramFormat(char* buf, size_t size) {
+    if (!buf || size == 0) return;
+    buf[0] = 0;
+    if (!s_hasSample) return;
+
+    const VramBudget& b = s_current;
+    UINT percent = b.localBudget ? (UINT)(b.localUsage * 100 / b.localBudget) : 0;
+    const char* color = "";
+    if (b.localBudget && b.localUsage > b.localBudget) color = OVERLAY_TEXT_RED;
+    else if (percent >= VRAM_WARN_PERCENT) color = OVERLAY_TEXT_YELLOW;
+    int len = _snprintf_s(buf, size, _TRUNCATE, "%sVRAM: %.0f / %.0f MB (%u%%) | shared %.0f MB", color,
+                          VRAM_MB(b.localUsage), VRAM_MB(b.localBudget), percent, VRAM_MB(b.nonLocalUsage));
+    for (UINT i = 0; i < VRAM_CATEGORY_COUNT && len >= 0 && (size_t)len < size; i++) {
+        if (!s_categoryBytes[i]) continue;
+        int n = _snprintf_s(buf + len, size - len, _TRUNCATE, " | %s %.1f", s_categoryNames[i], VRAM_MB(s_categoryBytes[i]));
+        if (n < 0) return;
+        len += n;
+    }
+}
+
+void VramWriteJson(FILE* f) {
+    VramTick();   // The state at the end of the window
+    fprintf(f, "  \"vram\": {\n");
+    fprintf(f, "    \"source\": \"%s\",\n", s_source);
+    fprintf(f, "    \"samples\": %u,\n", s_samples);
+    fprintf(f, "    \"localBudgetMB\": %.1f,\n", VRAM_MB(s_current.localBudget));
+    fprintf(f, "    \"localUsageMB\": %.1f,\n", VRAM_MB(s_current.localUsage));
+    fprintf(f, "    \"peakLocalUsageMB\": %.1f,\n", VRAM_MB(s_peak.localUsage));
+    fprintf(f, "    \"peakLocalPercent\": %.1f,\n",
+        s_peak.localBudget ? 100.0 * s_peak.localUsage / s_peak.localBudget : 0.0);
+    fprintf(f, "    \"nonLocalBudgetMB\": %.1f,\n", VRAM_MB(s_current.nonLocalBudget));
+    fprintf(f, "    \"peakNonLocalUsageMB\": %.1f,\n", VRAM_MB(s_peak.nonLocalUsage));
+    fprintf(f, "    \"overBudgetSamples\": %u,\n", s_overBudgetSamples);
+    fprintf(f, "    \"categoriesMB\": {");
+    for (UINT i = 0; i < VRAM_CATEGORY_COUNT; i++)
+        fprintf(f, "%s \"%s\": { \"current\": %.2f, \"peak\": %.2f }", i ? "," : "", s_categoryKeys[i],
+            VRAM_MB(s_categoryBytes[i]), VRAM_MB(s_categoryPeak[i]));
+    fprintf(f, " }\n");
+    fprintf(f, "  },\n");
+}
+
+// ============== BACKENDS ==============
+void VramSetQuery(VramQueryFn query, const char* source) {
+    s_query = query;
+    s_source = query ? source : (s_adapter3 ? "DXGI" : "none");
+}
+
+void VramSetCategories(VramCategoryFn categories) {
+    s_categories = categories;
+}
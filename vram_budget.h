@@ -0,0 +1,53 @@
+#pragma once
+// ============== VRAM BUDGET ==============
+// Video memory usage against the OS budget, plus a breakdown of the
+// renderer's own large allocations, for the overlay and the benchmark report.
+//
+// Usage / budget come from IDXGIAdapter3::QueryVideoMemoryInfo on the
+// selected adapter (bound by InitRenderer, so every API gets numbers; DXGI
+// reports the process' usage whatever API allocated it). Vulkan devices
+// created with VK_EXT_memory_budget replace that with
+// VkPhysicalDeviceMemoryBudgetPropertiesEXT between VkMemInit and
+// VkMemShutdown (see vulkan/vk_memory.h). Local = device-local heaps /
+// DXGI_MEMORY_SEGMENT_GROUP_LOCAL, non-local = system memory the GPU uses.
+//
+// The breakdown is pulled from the active renderer through a callback that
+// sums the resources it owns per VramCategory; anything else (swap chain,
+// geometry, pipelines, driver) is the difference to the process usage.
+//
+// Sampled once per second (VramTick) and once after renderer init; peaks are
+// kept since the last VramReset. Crossing 90% of the local budget, or the
+// budget itself, is logged once each and turns the overlay line yellow / red:
+// past the budget the OS starts demoting our allocations to system memory.
+
+#include "common.h"
+
+enum VramCategory {
+    VRAM_BLAS,
+    VRAM_TLAS,          // Incl. instance descriptors
+    VRAM_SCRATCH,       // Acceleration structure build / update scratch
+    VRAM_GBUFFER,       // Per-pixel render targets and intermediate images
+    VRAM_HISTORY,       // Accumulation, temporal history, previous-frame copies
+    VRAM_DLSS,          // NGX feature memory and DLSS outputs
+    VRAM_CATEGORY_COUNT
+};
+
+struct VramBudget {
+    UINT64 localUsage, localBudget;
+    UINT64 nonLocalUsage, nonLocalBudget;
+};
+
+typedef bool (*VramQueryFn)(VramBudget& out);
+typedef void (*VramCategoryFn)(UINT64 bytes[VRAM_CATEGORY_COUNT]);   // Adds to bytes
+
+const char* VramCategoryName(UINT category);
+
+// Frontend
+void VramReset(IDXGIAdapter1* adapter);         // InitRenderer: DXGI source, no breakdown, peaks cleared
+void VramTick();                                // Sample (called once per second and after init)
+void VramFormat(char* buf, size_t size);        // e.g. "VRAM: 812 / 7680 MB (11%) | shared 40 MB | BLAS 2 TLAS 1 ...", empty before the first sample
+void VramWriteJson(FILE* f);                    // Benchmark report "vram" block (incl. trailing comma)
+
+// Backends
+void VramSetQuery(VramQueryFn query, const char* source);   // nullptr = back to DXGI
+void VramSetCategories(VramCategoryFn categories);          // Renderer init; nullptr at cleanup
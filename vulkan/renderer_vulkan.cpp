@@ -6,6 +6,16 @@
 #include "../common.h"
 #include "vulkan_shaders.h"
 #include "renderer_vulkan.h"
+#include "vk_upload.h"
+#include "vk_present.h"
+#include "vk_pipeline_cache.h"
+#include "vk_memory.h"
+#include "vk_specialize.h"
+#include "../mesh_file.h"
+#include "../cube_geometry.h"
+#include "../text_overlay.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
 
 #pragma comment(lib, "vulkan-1.lib")
 
@@ -15,13 +25,14 @@ extern std::wstring gpuName;
 extern LARGE_INTEGER g_startTime;
 extern LARGE_INTEGER g_perfFreq;
 extern const unsigned char g_font8x8[96][8];
-extern const UINT W;
-extern const UINT H;
+extern UINT W;
+extern UINT H;
 
 // ============== VULKAN GLOBALS ==============
 static VkInstance g_vkInstance = VK_NULL_HANDLE;
 static VkPhysicalDevice g_vkPhysicalDevice = VK_NULL_HANDLE;
 static VkDevice g_vkDevice = VK_NULL_HANDLE;
+static VkPipelineCache g_vkPipelineCache = VK_NULL_HANDLE;   // Persisted in shadercache\ (vk_pipeline_cache.h)
 static VkQueue g_vkGraphicsQueue = VK_NULL_HANDLE;
 static VkQueue g_vkPresentQueue = VK_NULL_HANDLE;
 static VkSurfaceKHR g_vkSurface = VK_NULL_HANDLE;
@@ -30,31 +41,43 @@ static std::vector<VkImage> g_vkSwapchainImages;
 static std::vector<VkImageView> g_vkSwapchainImageViews;
 static VkFormat g_vkSwapchainFormat;
 static VkExtent2D g_vkSwapchainExtent;
+static VkPresentModeKHR g_vkPresentMode = VK_PRESENT_MODE_FIFO_KHR;
 static VkRenderPass g_vkRenderPass = VK_NULL_HANDLE;
 static VkPipelineLayout g_vkPipelineLayout = VK_NULL_HANDLE;
 static VkPipeline g_vkPipeline = VK_NULL_HANDLE;
 static std::vector<VkFramebuffer> g_vkFramebuffers;
 static VkCommandPool g_vkCommandPool = VK_NULL_HANDLE;
-static std::vector<VkCommandBuffer> g_vkCommandBuffers;
-static VkSemaphore g_vkImageAvailableSemaphore = VK_NULL_HANDLE;
-static VkSemaphore g_vkRenderFinishedSemaphore = VK_NULL_HANDLE;
-static VkFence g_vkInFlightFence = VK_NULL_HANDLE;
+
+// Frames in flight: the CPU records frame N+1 while the GPU still renders
+// frame N. Command buffer, acquire semaphore, fence and text vertices are per
+// frame slot; render-finished semaphores are per swapchain image because the
+// presentation engine holds them until that image is acquired again.
+static const uint32_t FRAME_COUNT = 2;
+static VkCommandBuffer g_vkCommandBuffers[FRAME_COUNT] = {};
+static VkSemaphore g_vkImageAvailableSemaphores[FRAME_COUNT] = {};
+static VkFence g_vkInFlightFences[FRAME_COUNT] = {};
+static std::vector<VkSemaphore> g_vkRenderFinishedSemaphores;
+static uint32_t g_vkFrameIndex = 0;
 static VkBuffer g_vkVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory g_vkVertexBufferMemory = VK_NULL_HANDLE;
+static VkMemAlloc g_vkVertexBufferMemory;
 static VkBuffer g_vkIndexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory g_vkIndexBufferMemory = VK_NULL_HANDLE;
+static VkMemAlloc g_vkIndexBufferMemory;
 static VkImage g_vkDepthImage = VK_NULL_HANDLE;
-static VkDeviceMemory g_vkDepthImageMemory = VK_NULL_HANDLE;
+static VkMemAlloc g_vkDepthImageMemory;
 static VkImageView g_vkDepthImageView = VK_NULL_HANDLE;
 static uint32_t g_vkGraphicsFamily = UINT32_MAX;
 static uint32_t g_vkPresentFamily = UINT32_MAX;
+static uint32_t g_vkTransferFamily = UINT32_MAX;   // Dedicated transfer queue for static uploads, if any
 static uint32_t g_vkIndexCount = 0;
 static int g_vkTriangleCount = 0;
+static VkBuffer g_vkInstanceBuffer = VK_NULL_HANDLE;          // --cubes=N per-instance data (binding 1)
+static VkMemAlloc g_vkInstanceBufferMemory;
+static uint32_t g_vkInstanceCount = 1;
 static std::string g_vkGpuName;
 
 // Text rendering resources
 static VkImage g_vkFontImage = VK_NULL_HANDLE;
-static VkDeviceMemory g_vkFontImageMemory = VK_NULL_HANDLE;
+static VkMemAlloc g_vkFontImageMemory;
 static VkImageView g_vkFontImageView = VK_NULL_HANDLE;
 static VkSampler g_vkFontSampler = VK_NULL_HANDLE;
 static VkDescriptorSetLayout g_vkTextDescSetLayout = VK_NULL_HANDLE;
@@ -63,10 +86,33 @@ static VkDescriptorSet g_vkTextDescSet = VK_NULL_HANDLE;
 static VkPipelineLayout g_vkTextPipelineLayout = VK_NULL_HANDLE;
 static VkPipeline g_vkTextPipeline = VK_NULL_HANDLE;
 static VkBuffer g_vkTextVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory g_vkTextVertexBufferMemory = VK_NULL_HANDLE;
-static void* g_vkTextVertexBufferMapped = nullptr;  // Persistently mapped for CPU updates
+static VkMemAlloc g_vkTextVertexBufferMemory;
+static void* g_vkTextVertexBufferMapped = nullptr;  // Persistently mapped for CPU updates, g_vkTextSlices slices
 static const int g_vkMaxTextChars = 256;
 
+// --prerecord: one command buffer per swapchain image, recorded once and
+// replayed. MVP / light / time come from a host-visible slice per image that
+// the recording binds through a dynamic storage buffer offset (the shaders'
+// push constant block is patched into a read-only SSBO, vk_specialize.h).
+// An image is re-recorded only when the overlay text changed since its last
+// recording or after a resize.
+#define VK_PRERECORD_MAX_IMAGES 8
+static bool g_vkPrerecordActive = false;   // Resources created; per-frame path if the swapchain has more images
+static VkCommandBuffer g_vkImageCommandBuffers[VK_PRERECORD_MAX_IMAGES] = {};
+static VkFence g_vkImageFences[VK_PRERECORD_MAX_IMAGES] = {};        // Frame fence that last submitted the image (not owned)
+static uint32_t g_vkImageTextVersion[VK_PRERECORD_MAX_IMAGES] = {};  // Overlay version recorded, 0 = must record
+static TextOverlay g_vkOverlay;                      // Layout + version of the overlay string
+static TextVert g_vkTextVerts[g_vkMaxTextChars * 6]; // g_vkOverlay expanded for the SPIR-V text pipeline
+static int g_vkTextVertCount = 0;
+static uint32_t g_vkSliceTextVersion[VK_PRERECORD_MAX_IMAGES] = {};  // Overlay version in each text VB slice
+static VkBuffer g_vkFrameDataBuffer = VK_NULL_HANDLE;
+static VkMemAlloc g_vkFrameDataMemory;
+static VkDeviceSize g_vkFrameDataStride = 0;
+static VkDescriptorSetLayout g_vkFrameDataSetLayout = VK_NULL_HANDLE;
+static VkDescriptorPool g_vkFrameDataPool = VK_NULL_HANDLE;
+static VkDescriptorSet g_vkFrameDataSet = VK_NULL_HANDLE;
+static uint32_t g_vkTextSlices = FRAME_COUNT;   // Text VB slices: per frame in flight, or per image when pre-recorded
+
 // ============== VULKAN VERTEX STRUCTURE ==============
 struct VkVert {
     float px, py, pz;
@@ -82,26 +128,8 @@ struct VkPushConstants {
     float padding[3];
 };
 
-// Text vertex structure (position, UV, color)
-struct VkTextVert {
-    float x, y;     // Screen position in NDC [-1, 1]
-    float u, v;     // Texture coordinates
-    float r, g, b, a;  // Color
-};
-
 // ============== HELPER FUNCTIONS ==============
 
-static uint32_t VkFindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(g_vkPhysicalDevice, &memProps);
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-    return UINT32_MAX;
-}
-
 static VkShaderModule VkCreateShaderModule(const uint32_t* code, size_t codeSize) {
     VkShaderModuleCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -116,7 +144,7 @@ static VkShaderModule VkCreateShaderModule(const uint32_t* code, size_t codeSize
 }
 
 static bool VkCreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-                           VkBuffer& buffer, VkDeviceMemory& bufferMemory) {
+                           VkBuffer& buffer, VkMemAlloc& bufferMemory) {
     VkBufferCreateInfo bufferInfo = {};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size = size;
@@ -127,165 +155,14 @@ static bool VkCreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemory
         return false;
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetBufferMemoryRequirements(g_vkDevice, buffer, &memReqs);
-
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = VkFindMemoryType(memReqs.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(g_vkDevice, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
+    if (!VkMemAllocBuffer(buffer, properties, bufferMemory)) {
+        vkDestroyBuffer(g_vkDevice, buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
         return false;
     }
-
-    vkBindBufferMemory(g_vkDevice, buffer, bufferMemory, 0);
     return true;
 }
 
-// ============== GEOMETRY GENERATION ==============
-
-// Generate rounded face for Vulkan (same as D3D11/OpenGL)
-void GenRoundedFaceVk(float size, int seg, float offX, float offY, float offZ, int faceIdx,
-    float edgeRadius[4], float r, float g, float b, std::vector<VkVert>& verts, std::vector<uint32_t>& inds)
-{
-    uint32_t base = (uint32_t)verts.size();
-    float h = size / 2;
-
-    float faceN[6][3] = {{0,0,1},{0,0,-1},{1,0,0},{-1,0,0},{0,1,0},{0,-1,0}};
-    float faceU[6][3] = {{-1,0,0},{1,0,0},{0,0,1},{0,0,-1},{1,0,0},{1,0,0}};
-    float faceV[6][3] = {{0,1,0},{0,1,0},{0,1,0},{0,1,0},{0,0,1},{0,0,-1}};
-
-    float fnx = faceN[faceIdx][0], fny = faceN[faceIdx][1], fnz = faceN[faceIdx][2];
-    float fux = faceU[faceIdx][0], fuy = faceU[faceIdx][1], fuz = faceU[faceIdx][2];
-    float fvx = faceV[faceIdx][0], fvy = faceV[faceIdx][1], fvz = faceV[faceIdx][2];
-
-    for (int j = 0; j <= seg; j++) {
-        for (int i = 0; i <= seg; i++) {
-            float u = (float)i / seg * 2 - 1;
-            float vv = (float)j / seg * 2 - 1;
-
-            float px = u * h, py = vv * h;
-            float pz = h;
-            float nx = 0, ny = 0, nz = 1;
-
-            float rU_raw = (u > 0) ? edgeRadius[0] : edgeRadius[1];
-            float rV_raw = (vv > 0) ? edgeRadius[2] : edgeRadius[3];
-            float rU = fabsf(rU_raw), rV = fabsf(rV_raw);
-            bool outerU = (rU_raw > 0), outerV = (rV_raw > 0);
-
-            if (rU > 0 || rV > 0) {
-                float innerU = h - rU, innerV = h - rV;
-                float dx = (rU > 0) ? fmaxf(0, fabsf(px) - innerU) : 0;
-                float dy = (rV > 0) ? fmaxf(0, fabsf(py) - innerV) : 0;
-
-                if (dx > 0 || dy > 0) {
-                    bool isCorner = (dx > 0 && dy > 0);
-                    bool sphericalCorner = isCorner && (outerU || outerV);
-
-                    if (sphericalCorner) {
-                        float rad = fmaxf(rU, rV);
-                        float dist = sqrtf(dx*dx + dy*dy);
-                        if (dist > rad) { dx = dx * rad / dist; dy = dy * rad / dist; }
-                        float curveZ = sqrtf(fmaxf(0, rad*rad - dx*dx - dy*dy));
-                        pz = (h - rad) + curveZ;
-                        px = (u > 0 ? 1 : -1) * (innerU + dx);
-                        py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                        nx = (u > 0 ? 1 : -1) * dx / rad;
-                        ny = (vv > 0 ? 1 : -1) * dy / rad;
-                        nz = curveZ / rad;
-                    } else if (isCorner) {
-                        if (dx >= dy) {
-                            float curveZ = sqrtf(fmaxf(0, rU*rU - dx*dx));
-                            pz = (h - rU) + curveZ;
-                            px = (u > 0 ? 1 : -1) * (innerU + dx);
-                            nx = (u > 0 ? 1 : -1) * dx / rU;
-                            nz = curveZ / rU;
-                        } else {
-                            float curveZ = sqrtf(fmaxf(0, rV*rV - dy*dy));
-                            pz = (h - rV) + curveZ;
-                            py = (vv > 0 ? 1 : -1) * (innerV + dy);
-                            ny = (vv > 0 ? 1 : -1) * dy / rV;
-                            nz = curveZ / rV;
-                        }
-                    } else {
-                        float rad = (dx > 0) ? rU : rV;
-                        float d = (dx > 0) ? dx : dy;
-                        float curveZ = sqrtf(fmaxf(0, rad*rad - d*d));
-                        pz = (h - rad) + curveZ;
-                        if (dx > 0) { px = (u > 0 ? 1 : -1) * (innerU + dx); nx = (u > 0 ? 1 : -1) * dx / rad; }
-                        else { py = (vv > 0 ? 1 : -1) * (innerV + dy); ny = (vv > 0 ? 1 : -1) * dy / rad; }
-                        nz = curveZ / rad;
-                    }
-                }
-            }
-
-            VkVert vert;
-            vert.px = offX + px*fux + py*fvx + pz*fnx;
-            vert.py = offY + px*fuy + py*fvy + pz*fny;
-            vert.pz = offZ + px*fuz + py*fvz + pz*fnz;
-
-            float nnx = nx*fux + ny*fvx + nz*fnx;
-            float nny = nx*fuy + ny*fvy + nz*fny;
-            float nnz = nx*fuz + ny*fvz + nz*fnz;
-            float len = sqrtf(nnx*nnx + nny*nny + nnz*nnz);
-            if (len < 0.001f) len = 1;
-            vert.nx = nnx/len;
-            vert.ny = nny/len;
-            vert.nz = nnz/len;
-            vert.r = r; vert.g = g; vert.b = b;
-            verts.push_back(vert);
-        }
-    }
-
-    for (int j = 0; j < seg; j++) {
-        for (int i = 0; i < seg; i++) {
-            uint32_t idx = base + j * (seg + 1) + i;
-            inds.push_back(idx); inds.push_back(idx + seg + 1); inds.push_back(idx + 1);
-            inds.push_back(idx + 1); inds.push_back(idx + seg + 1); inds.push_back(idx + seg + 2);
-        }
-    }
-}
-
-void BuildCubeGeometryVk(int cubeID, float r, float g, float b, std::vector<VkVert>& verts, std::vector<uint32_t>& inds)
-{
-    float cubeSize = 0.95f;
-    float outerR = 0.12f, innerR = -0.12f;
-    float half = cubeSize / 2;
-    int seg = 20;
-
-    int coords[8][3] = {
-        {-1, +1, +1}, {+1, +1, +1}, {-1, -1, +1}, {+1, -1, +1},
-        {-1, +1, -1}, {+1, +1, -1}, {-1, -1, -1}, {+1, -1, -1},
-    };
-
-    int cx = coords[cubeID][0], cy = coords[cubeID][1], cz = coords[cubeID][2];
-    float posX = cx * half, posY = cy * half, posZ = cz * half;
-
-    bool renderFace[6] = {(cz > 0), (cz < 0), (cx > 0), (cx < 0), (cy > 0), (cy < 0)};
-
-    for (int f = 0; f < 6; f++) {
-        if (!renderFace[f]) continue;
-
-        float er[4];
-        switch (f) {
-            case 0: er[0] = (cx < 0) ? outerR : innerR; er[1] = (cx > 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 1: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 2: er[0] = (cz > 0) ? outerR : innerR; er[1] = (cz < 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 3: er[0] = (cz < 0) ? outerR : innerR; er[1] = (cz > 0) ? outerR : innerR;
-                    er[2] = (cy > 0) ? outerR : innerR; er[3] = (cy < 0) ? outerR : innerR; break;
-            case 4: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                    er[2] = (cz > 0) ? outerR : innerR; er[3] = (cz < 0) ? outerR : innerR; break;
-            case 5: er[0] = (cx > 0) ? outerR : innerR; er[1] = (cx < 0) ? outerR : innerR;
-                    er[2] = (cz < 0) ? outerR : innerR; er[3] = (cz > 0) ? outerR : innerR; break;
-        }
-        GenRoundedFaceVk(cubeSize, seg, posX, posY, posZ, f, er, r, g, b, verts, inds);
-    }
-}
-
 // ============== VULKAN TEXT RENDERING ==============
 
 // Initialize Vulkan text rendering with minimal CPU-GPU interaction
@@ -320,7 +197,7 @@ bool InitVulkanText() {
 
     // Create staging buffer
     VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
+    VkMemAlloc stagingMemory;
     VkDeviceSize imageSize = FONT_TEX_W * FONT_TEX_H * 4;
 
     if (!VkCreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -330,10 +207,7 @@ bool InitVulkanText() {
         return false;
     }
 
-    void* data;
-    vkMapMemory(g_vkDevice, stagingMemory, 0, imageSize, 0, &data);
-    memcpy(data, fontData.data(), imageSize);
-    vkUnmapMemory(g_vkDevice, stagingMemory);
+    memcpy(stagingMemory.mapped, fontData.data(), imageSize);
 
     // Create font image
     VkImageCreateInfo imageInfo = {};
@@ -354,26 +228,18 @@ bool InitVulkanText() {
     if (vkCreateImage(g_vkDevice, &imageInfo, nullptr, &g_vkFontImage) != VK_SUCCESS) {
         Log("[ERROR] Failed to create font image\n");
         vkDestroyBuffer(g_vkDevice, stagingBuffer, nullptr);
-        vkFreeMemory(g_vkDevice, stagingMemory, nullptr);
+        VkMemFree(stagingMemory);
         return false;
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(g_vkDevice, g_vkFontImage, &memReqs);
-
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = VkFindMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(g_vkDevice, &allocInfo, nullptr, &g_vkFontImageMemory) != VK_SUCCESS) {
+    if (!VkMemAllocImage(g_vkFontImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, g_vkFontImageMemory)) {
         Log("[ERROR] Failed to allocate font image memory\n");
         vkDestroyImage(g_vkDevice, g_vkFontImage, nullptr);
+        g_vkFontImage = VK_NULL_HANDLE;
         vkDestroyBuffer(g_vkDevice, stagingBuffer, nullptr);
-        vkFreeMemory(g_vkDevice, stagingMemory, nullptr);
+        VkMemFree(stagingMemory);
         return false;
     }
-    vkBindImageMemory(g_vkDevice, g_vkFontImage, g_vkFontImageMemory, 0);
 
     // Copy staging buffer to image using a one-time command buffer
     VkCommandBuffer cmdBuf;
@@ -443,7 +309,7 @@ bool InitVulkanText() {
 
     // Cleanup staging buffer
     vkDestroyBuffer(g_vkDevice, stagingBuffer, nullptr);
-    vkFreeMemory(g_vkDevice, stagingMemory, nullptr);
+    VkMemFree(stagingMemory);
 
     // Create image view
     VkImageViewCreateInfo viewInfo = {};
@@ -579,22 +445,22 @@ bool InitVulkanText() {
     // Vertex input: pos(vec2), uv(vec2), color(vec4)
     VkVertexInputBindingDescription bindingDesc = {};
     bindingDesc.binding = 0;
-    bindingDesc.stride = sizeof(VkTextVert);
+    bindingDesc.stride = sizeof(TextVert);
     bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
     VkVertexInputAttributeDescription attrDescs[3] = {};
     attrDescs[0].binding = 0;
     attrDescs[0].location = 0;
     attrDescs[0].format = VK_FORMAT_R32G32_SFLOAT;  // pos
-    attrDescs[0].offset = offsetof(VkTextVert, x);
+    attrDescs[0].offset = offsetof(TextVert, x);
     attrDescs[1].binding = 0;
     attrDescs[1].location = 1;
     attrDescs[1].format = VK_FORMAT_R32G32_SFLOAT;  // uv
-    attrDescs[1].offset = offsetof(VkTextVert, u);
+    attrDescs[1].offset = offsetof(TextVert, u);
     attrDescs[2].binding = 0;
     attrDescs[2].location = 2;
     attrDescs[2].format = VK_FORMAT_R32G32B32A32_SFLOAT;  // color
-    attrDescs[2].offset = offsetof(VkTextVert, r);
+    attrDescs[2].offset = offsetof(TextVert, r);
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -666,7 +532,13 @@ bool InitVulkanText() {
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
-    // NO dynamic state - use static viewport/scissor like 3D pipeline
+    // Dynamic viewport/scissor so the pipeline survives swapchain resize
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
     VkGraphicsPipelineCreateInfo pipelineInfo = {};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     pipelineInfo.stageCount = 2;
@@ -678,12 +550,12 @@ bool InitVulkanText() {
     pipelineInfo.pMultisampleState = &multisampling;
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = nullptr;  // Static viewport/scissor
+    pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = g_vkTextPipelineLayout;
     pipelineInfo.renderPass = g_vkRenderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(g_vkDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_vkTextPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_vkDevice, g_vkPipelineCache, 1, &pipelineInfo, nullptr, &g_vkTextPipeline) != VK_SUCCESS) {
         Log("[ERROR] Failed to create text pipeline\n");
         vkDestroyShaderModule(g_vkDevice, textVertShader, nullptr);
         vkDestroyShaderModule(g_vkDevice, textFragShader, nullptr);
@@ -693,8 +565,9 @@ bool InitVulkanText() {
     vkDestroyShaderModule(g_vkDevice, textVertShader, nullptr);
     vkDestroyShaderModule(g_vkDevice, textFragShader, nullptr);
 
-    // Create persistently mapped text vertex buffer (6 verts per char * max chars)
-    VkDeviceSize textBufferSize = sizeof(VkTextVert) * 6 * g_vkMaxTextChars;
+    // Create persistently mapped text vertex buffer (6 verts per char * max chars, one slice per frame in flight
+    // or, pre-recorded, per swapchain image)
+    VkDeviceSize textBufferSize = sizeof(TextVert) * 6 * g_vkMaxTextChars * g_vkTextSlices;
     if (!VkCreateBuffer(textBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                         g_vkTextVertexBuffer, g_vkTextVertexBufferMemory)) {
@@ -702,10 +575,10 @@ bool InitVulkanText() {
         return false;
     }
 
-    // Persistently map for minimal CPU-GPU sync
-    VkResult mapResult = vkMapMemory(g_vkDevice, g_vkTextVertexBufferMemory, 0, textBufferSize, 0, &g_vkTextVertexBufferMapped);
-    if (mapResult != VK_SUCCESS || !g_vkTextVertexBufferMapped) {
-        Log("[ERROR] Failed to map text vertex buffer memory: %d\n", mapResult);
+    // Persistently mapped (host-visible allocator blocks stay mapped) for minimal CPU-GPU sync
+    g_vkTextVertexBufferMapped = g_vkTextVertexBufferMemory.mapped;
+    if (!g_vkTextVertexBufferMapped) {
+        Log("[ERROR] Text vertex buffer memory is not host mapped\n");
         return false;
     }
 
@@ -714,58 +587,295 @@ bool InitVulkanText() {
     return true;
 }
 
-// Helper to draw text using Vulkan (generates vertices into mapped buffer, returns vertex count)
-static int VkBuildTextVertices(const char* text, float x, float y, float r, float g, float b, float a, float scale) {
-    const int FONT_COLS = 16;
-    const float CHAR_W = 8.0f * scale;
-    const float CHAR_H = 8.0f * scale;
-    const float TEX_W = 128.0f, TEX_H = 48.0f;
+// ============== SWAPCHAIN (recreated on resize) ==============
+
+// Swapchain, image views and depth buffer for the current W x H
+static bool CreateSwapchainVk(VkSwapchainKHR oldSwapchain)
+{
+    VkSurfaceCapabilitiesKHR capabilities = {};
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(g_vkPhysicalDevice, g_vkSurface, &capabilities);
+
+    g_vkSwapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
+    g_vkSwapchainExtent = { W, H };
+    if (capabilities.currentExtent.width != UINT32_MAX && capabilities.currentExtent.width > 0 && capabilities.currentExtent.height > 0) {
+        g_vkSwapchainExtent = capabilities.currentExtent;  // Surface dictates size on Win32
+        W = g_vkSwapchainExtent.width;
+        H = g_vkSwapchainExtent.height;
+    }
+
+    uint32_t imageCount = capabilities.minImageCount + 1;
+    if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount) {
+        imageCount = capabilities.maxImageCount;
+    }
+
+    VkSwapchainCreateInfoKHR swapchainInfo = {};
+    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    swapchainInfo.surface = g_vkSurface;
+    swapchainInfo.minImageCount = imageCount;
+    swapchainInfo.imageFormat = g_vkSwapchainFormat;
+    swapchainInfo.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    swapchainInfo.imageExtent = g_vkSwapchainExtent;
+    swapchainInfo.imageArrayLayers = 1;
+    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    swapchainInfo.preTransform = capabilities.currentTransform;
+    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapchainInfo.presentMode = g_vkPresentMode;
+    swapchainInfo.clipped = VK_TRUE;
+    swapchainInfo.oldSwapchain = oldSwapchain;
+
+    if (g_vkGraphicsFamily != g_vkPresentFamily) {
+        uint32_t queueFamilyIndices[] = { g_vkGraphicsFamily, g_vkPresentFamily };
+        swapchainInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+        swapchainInfo.queueFamilyIndexCount = 2;
+        swapchainInfo.pQueueFamilyIndices = queueFamilyIndices;
+    } else {
+        swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    VkResult res = VkPresentCreateSwapchain(g_vkDevice, swapchainInfo, &g_vkSwapchain);
+    if (oldSwapchain) VkPresentDestroySwapchain(g_vkDevice, oldSwapchain);
+    if (res != VK_SUCCESS) {
+        g_vkSwapchain = VK_NULL_HANDLE;
+        Log("[ERROR] Failed to create swapchain\n");
+        return false;
+    }
+
+    VkPresentGetImages(g_vkDevice, g_vkSwapchain, &imageCount, nullptr);
+    g_vkSwapchainImages.resize(imageCount);
+    VkPresentGetImages(g_vkDevice, g_vkSwapchain, &imageCount, g_vkSwapchainImages.data());
+    Log("[INFO] Swapchain created with %u images\n", imageCount);
+
+    // Create image views
+    g_vkSwapchainImageViews.resize(g_vkSwapchainImages.size());
+    for (size_t i = 0; i < g_vkSwapchainImages.size(); i++) {
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = g_vkSwapchainImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = g_vkSwapchainFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(g_vkDevice, &viewInfo, nullptr, &g_vkSwapchainImageViews[i]) != VK_SUCCESS) {
+            Log("[ERROR] Failed to create image view %zu\n", i);
+            return false;
+        }
+    }
+
+    // Create depth buffer
+    VkImageCreateInfo depthImageInfo = {};
+    depthImageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    depthImageInfo.imageType = VK_IMAGE_TYPE_2D;
+    depthImageInfo.extent.width = g_vkSwapchainExtent.width;
+    depthImageInfo.extent.height = g_vkSwapchainExtent.height;
+    depthImageInfo.extent.depth = 1;
+    depthImageInfo.mipLevels = 1;
+    depthImageInfo.arrayLayers = 1;
+    depthImageInfo.format = VK_FORMAT_D32_SFLOAT;
+    depthImageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    depthImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthImageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    depthImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+    if (vkCreateImage(g_vkDevice, &depthImageInfo, nullptr, &g_vkDepthImage) != VK_SUCCESS) {
+        Log("[ERROR] Failed to create depth image\n");
+        return false;
+    }
+
+    if (!VkMemAllocImage(g_vkDepthImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, g_vkDepthImageMemory)) {
+        Log("[ERROR] Failed to allocate depth image memory\n");
+        return false;
+    }
+
+    VkImageViewCreateInfo depthViewInfo = {};
+    depthViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    depthViewInfo.image = g_vkDepthImage;
+    depthViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    depthViewInfo.format = VK_FORMAT_D32_SFLOAT;
+    depthViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    depthViewInfo.subresourceRange.baseMipLevel = 0;
+    depthViewInfo.subresourceRange.levelCount = 1;
+    depthViewInfo.subresourceRange.baseArrayLayer = 0;
+    depthViewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(g_vkDevice, &depthViewInfo, nullptr, &g_vkDepthImageView) != VK_SUCCESS) {
+        Log("[ERROR] Failed to create depth image view\n");
+        return false;
+    }
+    Log("[INFO] Depth buffer created\n");
+    return true;
+}
+
+// One framebuffer per swapchain image (color + shared depth)
+static bool CreateFramebuffersVk()
+{
+    g_vkFramebuffers.resize(g_vkSwapchainImageViews.size());
+    for (size_t i = 0; i < g_vkSwapchainImageViews.size(); i++) {
+        VkImageView attachments[] = { g_vkSwapchainImageViews[i], g_vkDepthImageView };
 
-    // Convert pixel coordinates to NDC [-1, 1]
-    float ndcScaleX = 2.0f / (float)g_vkSwapchainExtent.width;
-    float ndcScaleY = 2.0f / (float)g_vkSwapchainExtent.height;
+        VkFramebufferCreateInfo fbInfo = {};
+        fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        fbInfo.renderPass = g_vkRenderPass;
+        fbInfo.attachmentCount = 2;
+        fbInfo.pAttachments = attachments;
+        fbInfo.width = g_vkSwapchainExtent.width;
+        fbInfo.height = g_vkSwapchainExtent.height;
+        fbInfo.layers = 1;
 
-    VkTextVert* verts = (VkTextVert*)g_vkTextVertexBufferMapped;
-    int vertCount = 0;
-    float cx = x, cy = y;
+        if (vkCreateFramebuffer(g_vkDevice, &fbInfo, nullptr, &g_vkFramebuffers[i]) != VK_SUCCESS) {
+            Log("[ERROR] Failed to create framebuffer %zu\n", i);
+            return false;
+        }
+    }
+    return true;
+}
 
-    for (const char* p = text; *p && vertCount < g_vkMaxTextChars * 6 - 6; p++) {
-        if (*p == '\n') { cx = x; cy += CHAR_H * 1.4f; continue; }
-        if (*p < 32 || *p > 127) continue;
+// Everything that depends on the swapchain extent, except the swapchain itself
+static void DestroySwapchainResourcesVk()
+{
+    for (auto fb : g_vkFramebuffers) if (fb) vkDestroyFramebuffer(g_vkDevice, fb, nullptr);
+    g_vkFramebuffers.clear();
 
-        int idx = *p - 32;
-        int col = idx % FONT_COLS, row = idx / FONT_COLS;
-        float u0 = col * 8.0f / TEX_W, v0 = row * 8.0f / TEX_H;
-        float u1 = u0 + 8.0f / TEX_W, v1 = v0 + 8.0f / TEX_H;
+    if (g_vkDepthImageView) { vkDestroyImageView(g_vkDevice, g_vkDepthImageView, nullptr); g_vkDepthImageView = VK_NULL_HANDLE; }
+    if (g_vkDepthImage) { vkDestroyImage(g_vkDevice, g_vkDepthImage, nullptr); g_vkDepthImage = VK_NULL_HANDLE; }
+    VkMemFree(g_vkDepthImageMemory);
 
-        // Convert pixel coords to NDC (Y is flipped in Vulkan, so we go from top)
-        float x0 = cx * ndcScaleX - 1.0f;
-        float y0 = cy * ndcScaleY - 1.0f;
-        float x1 = (cx + CHAR_W) * ndcScaleX - 1.0f;
-        float y1 = (cy + CHAR_H) * ndcScaleY - 1.0f;
+    for (auto iv : g_vkSwapchainImageViews) if (iv) vkDestroyImageView(g_vkDevice, iv, nullptr);
+    g_vkSwapchainImageViews.clear();
+}
 
-        // Two triangles (6 vertices)
-        verts[vertCount++] = {x0, y0, u0, v0, r, g, b, a};
-        verts[vertCount++] = {x1, y0, u1, v0, r, g, b, a};
-        verts[vertCount++] = {x0, y1, u0, v1, r, g, b, a};
-        verts[vertCount++] = {x1, y0, u1, v0, r, g, b, a};
-        verts[vertCount++] = {x1, y1, u1, v1, r, g, b, a};
-        verts[vertCount++] = {x0, y1, u0, v1, r, g, b, a};
+// ============== PRE-RECORDED COMMAND BUFFERS ==============
+static bool PrerecordUsableVk()
+{
+    return g_vkPrerecordActive && g_vkSwapchainImages.size() <= VK_PRERECORD_MAX_IMAGES;
+}
 
-        cx += CHAR_W;
+// Forget what each image recorded (new swapchain: framebuffers, extent and overlay layout changed)
+static void ResetPrerecordVk()
+{
+    for (uint32_t i = 0; i < VK_PRERECORD_MAX_IMAGES; i++) {
+        g_vkImageFences[i] = VK_NULL_HANDLE;
+        g_vkImageTextVersion[i] = 0;
     }
+    OverlayInvalidate(g_vkOverlay);
+    memset(g_vkSliceTextVersion, 0, sizeof(g_vkSliceTextVersion));
+    if (g_vkPrerecordActive && !PrerecordUsableVk())
+        Log("[WARN] Vulkan --prerecord: %zu swapchain images (max %u), recording per frame\n",
+            g_vkSwapchainImages.size(), VK_PRERECORD_MAX_IMAGES);
+}
 
-    return vertCount;
+// Frame data ring (one aligned slice per swapchain image) and its dynamic SSBO descriptor
+static bool CreateFrameDataVk()
+{
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(g_vkPhysicalDevice, &props);
+    VkDeviceSize align = props.limits.minStorageBufferOffsetAlignment ? props.limits.minStorageBufferOffsetAlignment : 1;
+    g_vkFrameDataStride = (sizeof(VkPushConstants) + align - 1) / align * align;
+
+    if (!VkCreateBuffer(g_vkFrameDataStride * VK_PRERECORD_MAX_IMAGES, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        g_vkFrameDataBuffer, g_vkFrameDataMemory) || !g_vkFrameDataMemory.mapped) {
+        Log("[ERROR] Failed to create Vulkan frame data buffer\n");
+        return false;
+    }
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(g_vkDevice, &layoutInfo, nullptr, &g_vkFrameDataSetLayout) != VK_SUCCESS) {
+        Log("[ERROR] Failed to create frame data descriptor set layout\n");
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSize = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1 };
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(g_vkDevice, &poolInfo, nullptr, &g_vkFrameDataPool) != VK_SUCCESS) {
+        Log("[ERROR] Failed to create frame data descriptor pool\n");
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = g_vkFrameDataPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &g_vkFrameDataSetLayout;
+    if (vkAllocateDescriptorSets(g_vkDevice, &allocInfo, &g_vkFrameDataSet) != VK_SUCCESS) {
+        Log("[ERROR] Failed to allocate frame data descriptor set\n");
+        return false;
+    }
+
+    VkDescriptorBufferInfo bufferInfo = { g_vkFrameDataBuffer, 0, sizeof(VkPushConstants) };
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = g_vkFrameDataSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(g_vkDevice, 1, &write, 0, nullptr);
+    return true;
+}
+
+static void DestroyFrameDataVk()
+{
+    g_vkPrerecordActive = false;
+    for (uint32_t i = 0; i < VK_PRERECORD_MAX_IMAGES; i++) g_vkImageCommandBuffers[i] = VK_NULL_HANDLE;  // Freed with the pool
+    ResetPrerecordVk();
+    if (g_vkFrameDataPool) { vkDestroyDescriptorPool(g_vkDevice, g_vkFrameDataPool, nullptr); g_vkFrameDataPool = VK_NULL_HANDLE; }
+    g_vkFrameDataSet = VK_NULL_HANDLE;
+    if (g_vkFrameDataSetLayout) { vkDestroyDescriptorSetLayout(g_vkDevice, g_vkFrameDataSetLayout, nullptr); g_vkFrameDataSetLayout = VK_NULL_HANDLE; }
+    if (g_vkFrameDataBuffer) { vkDestroyBuffer(g_vkDevice, g_vkFrameDataBuffer, nullptr); g_vkFrameDataBuffer = VK_NULL_HANDLE; }
+    VkMemFree(g_vkFrameDataMemory);
+    OverlayInvalidate(g_vkOverlay);
+    memset(g_vkSliceTextVersion, 0, sizeof(g_vkSliceTextVersion));
+    g_vkTextSlices = FRAME_COUNT;
 }
 
 // ============== MAIN VULKAN FUNCTIONS ==============
 
+// One render-finished semaphore per swapchain image (count can change on resize)
+static void DestroyRenderFinishedSemaphoresVk()
+{
+    for (VkSemaphore sem : g_vkRenderFinishedSemaphores) vkDestroySemaphore(g_vkDevice, sem, nullptr);
+    g_vkRenderFinishedSemaphores.clear();
+}
+
+static bool CreateRenderFinishedSemaphoresVk()
+{
+    DestroyRenderFinishedSemaphoresVk();
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    g_vkRenderFinishedSemaphores.resize(g_vkSwapchainImages.size(), VK_NULL_HANDLE);
+    for (VkSemaphore& sem : g_vkRenderFinishedSemaphores) {
+        if (vkCreateSemaphore(g_vkDevice, &semaphoreInfo, nullptr, &sem) != VK_SUCCESS) {
+            Log("[ERROR] Failed to create render-finished semaphores\n");
+            return false;
+        }
+    }
+    return true;
+}
+
 static bool g_vkFirstFrame = true;
 // g_vkTextInitialized is defined in main.cpp (declared extern in renderer_vulkan.h)
 
 bool InitVulkan(HWND hwnd)
 {
     Log("[INFO] Initializing Vulkan...\n");
+    StartupStep("Instance + device");
 
     // Create instance
     VkApplicationInfo appInfo = {};
@@ -831,8 +941,7 @@ bool InitVulkan(HWND hwnd)
             if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
                 graphicsFamily = i;
             }
-            VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, g_vkSurface, &presentSupport);
+            VkBool32 presentSupport = VkPresentFamilySupported(device, i, g_vkSurface, queueFamilies[i].queueFlags);
             if (presentSupport) {
                 presentFamily = i;
             }
@@ -869,17 +978,27 @@ bool InitVulkan(HWND hwnd)
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
-    const char* deviceExtensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    g_vkTransferFamily = VkUploadFindTransferFamily(g_vkPhysicalDevice);
+    if (g_vkTransferFamily != UINT32_MAX && g_vkTransferFamily != g_vkPresentFamily) {
+        queueCreateInfo.queueFamilyIndex = g_vkTransferFamily;
+        queueCreateInfos.push_back(queueCreateInfo);
+    }
+
+    std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    void* featureChain = nullptr;
+    VkPresentWaitEnable(g_vkPhysicalDevice, deviceExtensions, &featureChain, "Vulkan");
+    VkMemBudgetEnable(g_vkPhysicalDevice, deviceExtensions);
 
     VkPhysicalDeviceFeatures deviceFeatures = {};
 
     VkDeviceCreateInfo deviceCreateInfo = {};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceCreateInfo.pNext = featureChain;
     deviceCreateInfo.queueCreateInfoCount = (uint32_t)queueCreateInfos.size();
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.enabledExtensionCount = 1;
-    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions;
+    deviceCreateInfo.enabledExtensionCount = (uint32_t)deviceExtensions.size();
+    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
     if (vkCreateDevice(g_vkPhysicalDevice, &deviceCreateInfo, nullptr, &g_vkDevice) != VK_SUCCESS) {
         Log("[ERROR] Failed to create logical device\n");
@@ -890,141 +1009,16 @@ bool InitVulkan(HWND hwnd)
     vkGetDeviceQueue(g_vkDevice, g_vkPresentFamily, 0, &g_vkPresentQueue);
     Log("[INFO] Vulkan device created\n");
 
-    // Create swapchain
-    VkSurfaceCapabilitiesKHR capabilities;
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(g_vkPhysicalDevice, g_vkSurface, &capabilities);
-
-    g_vkSwapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
-    g_vkSwapchainExtent = { W, H };
-
-    uint32_t imageCount = capabilities.minImageCount + 1;
-    if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount) {
-        imageCount = capabilities.maxImageCount;
-    }
-
-    // Select best present mode for no VSync (MAILBOX > IMMEDIATE > FIFO)
-    uint32_t presentModeCount;
-    vkGetPhysicalDeviceSurfacePresentModesKHR(g_vkPhysicalDevice, g_vkSurface, &presentModeCount, nullptr);
-    std::vector<VkPresentModeKHR> presentModes(presentModeCount);
-    vkGetPhysicalDeviceSurfacePresentModesKHR(g_vkPhysicalDevice, g_vkSurface, &presentModeCount, presentModes.data());
+    VkPresentWaitInit(g_vkDevice);
+    VkMemInit(g_vkPhysicalDevice, g_vkDevice, false, "Vulkan");
+    g_vkPipelineCache = VkPipelineCacheLoad(g_vkPhysicalDevice, g_vkDevice, "raster", "Vulkan");
 
-    VkPresentModeKHR selectedPresentMode = VK_PRESENT_MODE_FIFO_KHR;  // Always available fallback
-    for (auto mode : presentModes) {
-        if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            selectedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
-            break;  // Best option - triple buffering, no VSync, no tearing
-        }
-        if (mode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-            selectedPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;  // Good - no VSync
-        }
-    }
-    Log("[INFO] Present mode: %s\n",
-        selectedPresentMode == VK_PRESENT_MODE_MAILBOX_KHR ? "MAILBOX (no VSync)" :
-        selectedPresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR ? "IMMEDIATE (no VSync)" : "FIFO (VSync)");
-
-    VkSwapchainCreateInfoKHR swapchainInfo = {};
-    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-    swapchainInfo.surface = g_vkSurface;
-    swapchainInfo.minImageCount = imageCount;
-    swapchainInfo.imageFormat = g_vkSwapchainFormat;
-    swapchainInfo.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
-    swapchainInfo.imageExtent = g_vkSwapchainExtent;
-    swapchainInfo.imageArrayLayers = 1;
-    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    swapchainInfo.preTransform = capabilities.currentTransform;
-    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapchainInfo.presentMode = selectedPresentMode;
-    swapchainInfo.clipped = VK_TRUE;
+    // Default: best no-VSync mode (MAILBOX > IMMEDIATE > FIFO)
+    g_vkPresentMode = VkPresentChooseMode(g_vkPhysicalDevice, g_vkSurface, VK_PRESENT_MODE_MAILBOX_KHR, "Vulkan");
 
-    if (g_vkGraphicsFamily != g_vkPresentFamily) {
-        uint32_t queueFamilyIndices[] = { g_vkGraphicsFamily, g_vkPresentFamily };
-        swapchainInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-        swapchainInfo.queueFamilyIndexCount = 2;
-        swapchainInfo.pQueueFamilyIndices = queueFamilyIndices;
-    } else {
-        swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    }
-
-    if (vkCreateSwapchainKHR(g_vkDevice, &swapchainInfo, nullptr, &g_vkSwapchain) != VK_SUCCESS) {
-        Log("[ERROR] Failed to create swapchain\n");
-        return false;
-    }
-
-    vkGetSwapchainImagesKHR(g_vkDevice, g_vkSwapchain, &imageCount, nullptr);
-    g_vkSwapchainImages.resize(imageCount);
-    vkGetSwapchainImagesKHR(g_vkDevice, g_vkSwapchain, &imageCount, g_vkSwapchainImages.data());
-    Log("[INFO] Swapchain created with %u images\n", imageCount);
-
-    // Create image views
-    g_vkSwapchainImageViews.resize(g_vkSwapchainImages.size());
-    for (size_t i = 0; i < g_vkSwapchainImages.size(); i++) {
-        VkImageViewCreateInfo viewInfo = {};
-        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        viewInfo.image = g_vkSwapchainImages[i];
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewInfo.format = g_vkSwapchainFormat;
-        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
-        viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
-
-        if (vkCreateImageView(g_vkDevice, &viewInfo, nullptr, &g_vkSwapchainImageViews[i]) != VK_SUCCESS) {
-            Log("[ERROR] Failed to create image view %zu\n", i);
-            return false;
-        }
-    }
-
-    // Create depth buffer
-    VkImageCreateInfo depthImageInfo = {};
-    depthImageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    depthImageInfo.imageType = VK_IMAGE_TYPE_2D;
-    depthImageInfo.extent.width = W;
-    depthImageInfo.extent.height = H;
-    depthImageInfo.extent.depth = 1;
-    depthImageInfo.mipLevels = 1;
-    depthImageInfo.arrayLayers = 1;
-    depthImageInfo.format = VK_FORMAT_D32_SFLOAT;
-    depthImageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    depthImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depthImageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-    depthImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-
-    if (vkCreateImage(g_vkDevice, &depthImageInfo, nullptr, &g_vkDepthImage) != VK_SUCCESS) {
-        Log("[ERROR] Failed to create depth image\n");
-        return false;
-    }
-
-    VkMemoryRequirements depthMemReqs;
-    vkGetImageMemoryRequirements(g_vkDevice, g_vkDepthImage, &depthMemReqs);
-
-    VkMemoryAllocateInfo depthAllocInfo = {};
-    depthAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    depthAllocInfo.allocationSize = depthMemReqs.size;
-    depthAllocInfo.memoryTypeIndex = VkFindMemoryType(depthMemReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(g_vkDevice, &depthAllocInfo, nullptr, &g_vkDepthImageMemory) != VK_SUCCESS) {
-        Log("[ERROR] Failed to allocate depth image memory\n");
-        return false;
-    }
-    vkBindImageMemory(g_vkDevice, g_vkDepthImage, g_vkDepthImageMemory, 0);
-
-    VkImageViewCreateInfo depthViewInfo = {};
-    depthViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    depthViewInfo.image = g_vkDepthImage;
-    depthViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    depthViewInfo.format = VK_FORMAT_D32_SFLOAT;
-    depthViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    depthViewInfo.subresourceRange.baseMipLevel = 0;
-    depthViewInfo.subresourceRange.levelCount = 1;
-    depthViewInfo.subresourceRange.baseArrayLayer = 0;
-    depthViewInfo.subresourceRange.layerCount = 1;
-
-    if (vkCreateImageView(g_vkDevice, &depthViewInfo, nullptr, &g_vkDepthImageView) != VK_SUCCESS) {
-        Log("[ERROR] Failed to create depth image view\n");
-        return false;
-    }
-    Log("[INFO] Depth buffer created\n");
+    // Create swapchain, image views and depth buffer
+    StartupStep("Swap chain");
+    if (!CreateSwapchainVk(VK_NULL_HANDLE)) return false;
 
     // Create render pass
     VkAttachmentDescription colorAttachment = {};
@@ -1082,8 +1076,35 @@ bool InitVulkan(HWND hwnd)
     Log("[INFO] Render pass created\n");
 
     // Create pipeline
-    VkShaderModule vertModule = VkCreateShaderModule(g_vkVertShaderCode, sizeof(g_vkVertShaderCode));
-    VkShaderModule fragModule = VkCreateShaderModule(g_vkFragShaderCode, sizeof(g_vkFragShaderCode));
+    StartupStep("Pipeline");
+    bool instanced = g_cubeCount > 0 || MeshLoaded();   // --mesh is drawn as the instanced mesh
+    const uint32_t* vertCode = instanced ? g_vkVertInstShaderCode : g_vkVertShaderCode;
+    size_t vertCodeSize = instanced ? sizeof(g_vkVertInstShaderCode) : sizeof(g_vkVertShaderCode);
+    const uint32_t* fragCode = g_vkFragShaderCode;
+    size_t fragCodeSize = sizeof(g_vkFragShaderCode);
+
+    // --prerecord: the push constant block becomes set 0 binding 0 (dynamic SSBO)
+    std::vector<uint32_t> vertPatched, fragPatched;
+    g_vkPrerecordActive = false;
+    if (g_vkPrerecord) {
+        if (VkSpirvPushConstantsToStorageBuffer(vertCode, vertCodeSize, 0, 0, vertPatched) &&
+            VkSpirvPushConstantsToStorageBuffer(fragCode, fragCodeSize, 0, 0, fragPatched) &&
+            CreateFrameDataVk()) {
+            vertCode = vertPatched.data(); vertCodeSize = vertPatched.size() * sizeof(uint32_t);
+            fragCode = fragPatched.data(); fragCodeSize = fragPatched.size() * sizeof(uint32_t);
+            g_vkPrerecordActive = true;
+            g_vkTextSlices = VK_PRERECORD_MAX_IMAGES;
+            Log("[INFO] Vulkan --prerecord: per-image command buffers, frame data stride %llu\n",
+                (unsigned long long)g_vkFrameDataStride);
+            ResetPrerecordVk();
+        } else {
+            Log("[WARN] Vulkan --prerecord unavailable, recording per frame\n");
+            DestroyFrameDataVk();
+        }
+    }
+
+    VkShaderModule vertModule = VkCreateShaderModule(vertCode, vertCodeSize);
+    VkShaderModule fragModule = VkCreateShaderModule(fragCode, fragCodeSize);
 
     if (!vertModule || !fragModule) {
         Log("[ERROR] Failed to create shader modules\n");
@@ -1100,12 +1121,15 @@ bool InitVulkan(HWND hwnd)
     shaderStages[1].module = fragModule;
     shaderStages[1].pName = "main";
 
-    VkVertexInputBindingDescription bindingDesc = {};
-    bindingDesc.binding = 0;
-    bindingDesc.stride = sizeof(VkVert);
-    bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    VkVertexInputBindingDescription bindingDescs[2] = {};
+    bindingDescs[0].binding = 0;
+    bindingDescs[0].stride = MeshLoaded() ? sizeof(MeshVertex) : sizeof(VkVert);  // pos / normal at the same offsets
+    bindingDescs[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    bindingDescs[1].binding = 1;
+    bindingDescs[1].stride = sizeof(CubeInstance);
+    bindingDescs[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
-    VkVertexInputAttributeDescription attrDescs[3] = {};
+    VkVertexInputAttributeDescription attrDescs[4] = {};
     attrDescs[0].binding = 0;
     attrDescs[0].location = 0;
     attrDescs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
@@ -1118,20 +1142,35 @@ bool InitVulkan(HWND hwnd)
     attrDescs[2].location = 2;
     attrDescs[2].format = VK_FORMAT_R32G32B32_SFLOAT;
     attrDescs[2].offset = offsetof(VkVert, r);
+    if (instanced) {
+        // Color comes from the instance; location 3 = offset.xyz + scale
+        attrDescs[2].binding = 1;
+        attrDescs[2].offset = offsetof(CubeInstance, color);
+        attrDescs[3].binding = 1;
+        attrDescs[3].location = 3;
+        attrDescs[3].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attrDescs[3].offset = offsetof(CubeInstance, offset);
+    }
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDesc;
-    vertexInputInfo.vertexAttributeDescriptionCount = 3;
+    vertexInputInfo.vertexBindingDescriptionCount = instanced ? 2 : 1;
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescs;
+    vertexInputInfo.vertexAttributeDescriptionCount = instanced ? 4 : 3;
     vertexInputInfo.pVertexAttributeDescriptions = attrDescs;
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
     inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 
+    // Viewport/scissor are dynamic (set per frame from the swapchain extent)
     VkViewport viewport = { 0, 0, (float)W, (float)H, 0, 1 };
     VkRect2D scissor = { {0, 0}, {W, H} };
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
 
     VkPipelineViewportStateCreateInfo viewportState = {};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
@@ -1173,8 +1212,13 @@ bool InitVulkan(HWND hwnd)
 
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    if (g_vkPrerecordActive) {
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &g_vkFrameDataSetLayout;
+    } else {
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    }
 
     if (vkCreatePipelineLayout(g_vkDevice, &pipelineLayoutInfo, nullptr, &g_vkPipelineLayout) != VK_SUCCESS) {
         Log("[ERROR] Failed to create pipeline layout\n");
@@ -1192,11 +1236,12 @@ bool InitVulkan(HWND hwnd)
     pipelineInfo.pMultisampleState = &multisampling;
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = g_vkPipelineLayout;
     pipelineInfo.renderPass = g_vkRenderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(g_vkDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &g_vkPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(g_vkDevice, g_vkPipelineCache, 1, &pipelineInfo, nullptr, &g_vkPipeline) != VK_SUCCESS) {
         Log("[ERROR] Failed to create graphics pipeline\n");
         return false;
     }
@@ -1206,24 +1251,8 @@ bool InitVulkan(HWND hwnd)
     Log("[INFO] Pipeline created\n");
 
     // Create framebuffers
-    g_vkFramebuffers.resize(g_vkSwapchainImageViews.size());
-    for (size_t i = 0; i < g_vkSwapchainImageViews.size(); i++) {
-        VkImageView attachments[] = { g_vkSwapchainImageViews[i], g_vkDepthImageView };
-
-        VkFramebufferCreateInfo fbInfo = {};
-        fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        fbInfo.renderPass = g_vkRenderPass;
-        fbInfo.attachmentCount = 2;
-        fbInfo.pAttachments = attachments;
-        fbInfo.width = W;
-        fbInfo.height = H;
-        fbInfo.layers = 1;
-
-        if (vkCreateFramebuffer(g_vkDevice, &fbInfo, nullptr, &g_vkFramebuffers[i]) != VK_SUCCESS) {
-            Log("[ERROR] Failed to create framebuffer %zu\n", i);
-            return false;
-        }
-    }
+    StartupStep("Frame resources");
+    if (!CreateFramebuffersVk()) return false;
     Log("[INFO] Framebuffers created\n");
 
     // Create command pool and buffers
@@ -1237,17 +1266,23 @@ bool InitVulkan(HWND hwnd)
         return false;
     }
 
-    g_vkCommandBuffers.resize(g_vkFramebuffers.size());
     VkCommandBufferAllocateInfo allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.commandPool = g_vkCommandPool;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = (uint32_t)g_vkCommandBuffers.size();
+    allocInfo.commandBufferCount = FRAME_COUNT;
 
-    if (vkAllocateCommandBuffers(g_vkDevice, &allocInfo, g_vkCommandBuffers.data()) != VK_SUCCESS) {
+    if (vkAllocateCommandBuffers(g_vkDevice, &allocInfo, g_vkCommandBuffers) != VK_SUCCESS) {
         Log("[ERROR] Failed to allocate command buffers\n");
         return false;
     }
+    if (g_vkPrerecordActive) {
+        allocInfo.commandBufferCount = VK_PRERECORD_MAX_IMAGES;
+        if (vkAllocateCommandBuffers(g_vkDevice, &allocInfo, g_vkImageCommandBuffers) != VK_SUCCESS) {
+            Log("[ERROR] Failed to allocate pre-recorded command buffers\n");
+            return false;
+        }
+    }
     Log("[INFO] Command buffers created\n");
 
     // Create sync objects
@@ -1258,15 +1293,19 @@ bool InitVulkan(HWND hwnd)
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    if (vkCreateSemaphore(g_vkDevice, &semaphoreInfo, nullptr, &g_vkImageAvailableSemaphore) != VK_SUCCESS ||
-        vkCreateSemaphore(g_vkDevice, &semaphoreInfo, nullptr, &g_vkRenderFinishedSemaphore) != VK_SUCCESS ||
-        vkCreateFence(g_vkDevice, &fenceInfo, nullptr, &g_vkInFlightFence) != VK_SUCCESS) {
-        Log("[ERROR] Failed to create sync objects\n");
-        return false;
+    for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+        if (vkCreateSemaphore(g_vkDevice, &semaphoreInfo, nullptr, &g_vkImageAvailableSemaphores[i]) != VK_SUCCESS ||
+            vkCreateFence(g_vkDevice, &fenceInfo, nullptr, &g_vkInFlightFences[i]) != VK_SUCCESS) {
+            Log("[ERROR] Failed to create sync objects\n");
+            return false;
+        }
     }
-    Log("[INFO] Sync objects created\n");
+    if (!CreateRenderFinishedSemaphoresVk()) return false;
+    g_vkFrameIndex = 0;
+    Log("[INFO] Sync objects created (%u frames in flight)\n", FRAME_COUNT);
 
     // Create vertex and index buffers
+    StartupStep("Geometry + upload");
     Log("[INFO] Building Vulkan cube geometry...\n");
     std::vector<VkVert> vertices;
     std::vector<uint32_t> indices;
@@ -1276,70 +1315,67 @@ bool InitVulkan(HWND hwnd)
         {1.00f, 0.85f, 0.00f}, {0.15f, 0.50f, 0.95f}, {0.20f, 0.70f, 0.30f}, {0.95f, 0.20f, 0.15f}
     };
 
-    for (int c = 0; c < 8; c++) {
-        BuildCubeGeometryVk(c, colors[c][0], colors[c][1], colors[c][2], vertices, indices);
+    if (!MeshLoaded()) {    // --mesh: uploaded straight from the file mapping below
+        // Shared welded / cache-ordered cubes (cube_geometry.h) plus the colour
+        // of the baked scene's cube; the instanced pipeline reads it per instance
+        std::vector<CubeVertex> cubeVerts;
+        if (instanced) BuildInstanceCube(cubeVerts, indices);
+        else BuildSceneCubes(cubeVerts, indices);
+        vertices.resize(cubeVerts.size());
+        for (size_t i = 0; i < cubeVerts.size(); i++) {
+            const CubeVertex& cv = cubeVerts[i];
+            const float* rgb = colors[cv.cubeID];
+            vertices[i] = {cv.pos[0], cv.pos[1], cv.pos[2], cv.normal[0], cv.normal[1], cv.normal[2], rgb[0], rgb[1], rgb[2]};
+        }
     }
 
-    g_vkIndexCount = (uint32_t)indices.size();
+    uint32_t vertexCount = MeshLoaded() ? g_mesh.vertexCount : (uint32_t)vertices.size();
+    g_vkIndexCount = MeshLoaded() ? g_mesh.indexCount : (uint32_t)indices.size();
     g_vkTriangleCount = g_vkIndexCount / 3;
-    Log("[INFO] Vulkan geometry: %d vertices, %d indices (%d triangles)\n",
-        (int)vertices.size(), (int)indices.size(), g_vkTriangleCount);
-
-    VkDeviceSize vertexBufferSize = sizeof(VkVert) * vertices.size();
-    VkDeviceSize indexBufferSize = sizeof(uint32_t) * indices.size();
-
-    if (!VkCreateBuffer(vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        g_vkVertexBuffer, g_vkVertexBufferMemory)) {
-        Log("[ERROR] Failed to create vertex buffer\n");
-        return false;
+    Log("[INFO] Vulkan geometry: %u vertices, %u indices (%d triangles)\n",
+        vertexCount, g_vkIndexCount, g_vkTriangleCount);
+
+    const void* vertexData = MeshLoaded() ? (const void*)g_mesh.vertices : vertices.data();
+    const void* indexData = MeshLoaded() ? (const void*)g_mesh.indices : indices.data();
+    VkDeviceSize vertexBufferSize = MeshLoaded() ? MeshVertexBytes(g_mesh) : sizeof(VkVert) * vertices.size();
+    VkDeviceSize indexBufferSize = sizeof(uint32_t) * g_vkIndexCount;
+
+    // Static geometry goes to DEVICE_LOCAL memory through one transfer-queue batch
+    if (!VkUploadBegin(g_vkDevice, g_vkTransferFamily, g_vkGraphicsFamily)) return false;
+    bool uploaded = VkUploadBuffer(vertexData, vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                   g_vkVertexBuffer, g_vkVertexBufferMemory, "vertex buffer");
+    uploaded = uploaded && VkUploadBuffer(indexData, indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                          g_vkIndexBuffer, g_vkIndexBufferMemory, "index buffer");
+
+    g_vkInstanceCount = 1;
+    if (instanced) {
+        std::vector<CubeInstance> instances;
+        BuildCubeInstances(max(g_cubeCount, 1u), instances);
+        VkDeviceSize instanceBufferSize = sizeof(CubeInstance) * instances.size();
+        uploaded = uploaded && VkUploadBuffer(instances.data(), instanceBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                              g_vkInstanceBuffer, g_vkInstanceBufferMemory, "instance buffer");
+        g_vkInstanceCount = (uint32_t)instances.size();
+        Log("[INFO] Vulkan instanced scene: %u %s\n", g_vkInstanceCount, MeshLoaded() ? "meshes" : "cubes");
     }
-
-    void* data;
-    vkMapMemory(g_vkDevice, g_vkVertexBufferMemory, 0, vertexBufferSize, 0, &data);
-    memcpy(data, vertices.data(), vertexBufferSize);
-    vkUnmapMemory(g_vkDevice, g_vkVertexBufferMemory);
-
-    if (!VkCreateBuffer(indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        g_vkIndexBuffer, g_vkIndexBufferMemory)) {
-        Log("[ERROR] Failed to create index buffer\n");
+    if (!VkUploadFlush() || !uploaded) {
+        Log("[ERROR] Failed to upload Vulkan geometry\n");
         return false;
     }
 
-    vkMapMemory(g_vkDevice, g_vkIndexBufferMemory, 0, indexBufferSize, 0, &data);
-    memcpy(data, indices.data(), indexBufferSize);
-    vkUnmapMemory(g_vkDevice, g_vkIndexBufferMemory);
-
     Log("[INFO] Vulkan buffers created\n");
     Log("[INFO] Vulkan initialization complete\n");
     return true;
 }
 
-void RenderVulkan()
+// ============== FRAME HELPERS ==============
+// Per-frame constants: MVP and object-space light for time t
+static void BuildFrameConstantsVk(float t, VkPushConstants& pc)
 {
-    VkResult result;
-
-    result = vkWaitForFences(g_vkDevice, 1, &g_vkInFlightFence, VK_TRUE, UINT64_MAX);
-    if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkWaitForFences: %d\n", result);
-
-    result = vkResetFences(g_vkDevice, 1, &g_vkInFlightFence);
-    if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkResetFences: %d\n", result);
-
-    uint32_t imageIndex;
-    result = vkAcquireNextImageKHR(g_vkDevice, g_vkSwapchain, UINT64_MAX, g_vkImageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
-    if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkAcquireNextImageKHR: %d\n", result);
-
-    // Get time
-    LARGE_INTEGER nowTime;
-    QueryPerformanceCounter(&nowTime);
-    float t = (float)(nowTime.QuadPart - g_startTime.QuadPart) / g_perfFreq.QuadPart;
-
     // Build matrices in COLUMN-MAJOR format for GLSL (mat4 * vec4)
     // In column-major, each column is stored consecutively
     // mat[col][row] -> array[col * 4 + row]
 
-    float aspect = (float)W / (float)H;
+    float aspect = (float)g_vkSwapchainExtent.width / (float)g_vkSwapchainExtent.height;
     float fov = 45.0f * 3.14159265f / 180.0f;
     float nearZ = 0.1f, farZ = 100.0f;
     float tanHalfFov = tanf(fov / 2.0f);
@@ -1406,8 +1442,7 @@ void RenderVulkan()
     matMulColMajor(viewRot, view, rot);     // viewRot = view * rot
     matMulColMajor(mvp, proj, viewRot);     // mvp = proj * viewRot
 
-    // Push constants (already in column-major, no transpose needed)
-    VkPushConstants pc;
+    // Already in column-major, no transpose needed
     memcpy(pc.mvp, mvp, sizeof(mvp));
 
     // Light direction in world space
@@ -1424,11 +1459,69 @@ void RenderVulkan()
 
     pc.lightDir[0] = lightObjX; pc.lightDir[1] = lightObjY; pc.lightDir[2] = lightObjZ; pc.lightDir[3] = 0;
     pc.time = t;
+    pc.padding[0] = pc.padding[1] = pc.padding[2] = 0.0f;
+}
 
-    // Record command buffer
-    VkCommandBuffer cmd = g_vkCommandBuffers[imageIndex];
-    vkResetCommandBuffer(cmd, 0);
+// Overlay string (same format as D3D11/D3D12), empty while text is unavailable
+static void FormatOverlayVk(char* textBuf, size_t size)
+{
+    textBuf[0] = 0;
+    if (!g_vkTextInitialized || !g_vkTextPipeline || !g_vkTextVertexBufferMapped) return;
+
+    // Calculate FPS
+    static LARGE_INTEGER lastFpsTime = {0};
+    static int frameCount = 0;
+    static float fps = 0.0f;
+    LARGE_INTEGER currentTime;
+    QueryPerformanceCounter(&currentTime);
+    frameCount++;
+    double elapsed = (double)(currentTime.QuadPart - lastFpsTime.QuadPart) / g_perfFreq.QuadPart;
+    if (elapsed >= 0.5) {
+        fps = (float)(frameCount / elapsed);
+        frameCount = 0;
+        lastFpsTime = currentTime;
+    }
 
+    snprintf(textBuf, size, "API: Vulkan%s\nGPU: %s\nFPS: %.0f\nTriangles: %llu\nResolution: %ux%u",
+             PrerecordUsableVk() ? " (pre-recorded)" : "",
+             g_vkGpuName.c_str(), fps, (unsigned long long)g_vkTriangleCount * g_vkInstanceCount,
+             g_vkSwapchainExtent.width, g_vkSwapchainExtent.height);
+    char latencyBuf[96];
+    LatencyFormat(latencyBuf, sizeof(latencyBuf));
+    if (latencyBuf[0]) {
+        size_t len = strlen(textBuf);
+        snprintf(textBuf + len, size - len, "\n%s", latencyBuf);
+    }
+    char vramBuf[192];
+    VramFormat(vramBuf, sizeof(vramBuf));
+    if (vramBuf[0]) {
+        size_t len = strlen(textBuf);
+        snprintf(textBuf + len, size - len, "\n%s", vramBuf);
+    }
+}
+
+// Lay out the overlay (shadow first, then text) only when the string changed
+// and refresh a text VB slice only when it holds an older version; returns
+// the vertex count
+static int BuildTextVertsVk(const char* textBuf, uint32_t slice)
+{
+    if (OverlaySetText(g_vkOverlay, textBuf)) {
+        g_vkTextVertCount = (int)OverlayExpandVerts(g_vkOverlay, g_vkTextVerts, g_vkMaxTextChars * 6,
+            2.0f / (float)g_vkSwapchainExtent.width, 2.0f / (float)g_vkSwapchainExtent.height, -1.0f, -1.0f);
+    }
+    if (g_vkSliceTextVersion[slice] != g_vkOverlay.version) {
+        TextVert* verts = (TextVert*)g_vkTextVertexBufferMapped + (size_t)slice * g_vkMaxTextChars * 6;
+        memcpy(verts, g_vkTextVerts, g_vkTextVertCount * sizeof(TextVert));
+        g_vkSliceTextVersion[slice] = g_vkOverlay.version;
+    }
+    return g_vkTextVertCount;
+}
+
+// Record the scene + overlay into cmd. pc = push constants; nullptr binds the
+// pre-recorded frame data slice of imageIndex through the dynamic offset.
+static void RecordFrameVk(VkCommandBuffer cmd, uint32_t imageIndex, const VkPushConstants* pc,
+                          uint32_t textSlice, int textVerts)
+{
     VkCommandBufferBeginInfo beginInfo = {};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     vkBeginCommandBuffer(cmd, &beginInfo);
@@ -1446,116 +1539,128 @@ void RenderVulkan()
     renderPassBeginInfo.pClearValues = clearValues;
 
     vkCmdBeginRenderPass(cmd, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    VkViewport viewport = { 0, 0, (float)g_vkSwapchainExtent.width, (float)g_vkSwapchainExtent.height, 0, 1 };
+    VkRect2D scissor = { {0, 0}, g_vkSwapchainExtent };
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vkPipeline);
 
-    VkBuffer vertexBuffers[] = { g_vkVertexBuffer };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
+    VkBuffer vertexBuffers[] = { g_vkVertexBuffer, g_vkInstanceBuffer };
+    VkDeviceSize offsets[] = { 0, 0 };
+    vkCmdBindVertexBuffers(cmd, 0, g_vkInstanceBuffer ? 2 : 1, vertexBuffers, offsets);
     vkCmdBindIndexBuffer(cmd, g_vkIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-    vkCmdPushConstants(cmd, g_vkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pc), &pc);
-    vkCmdDrawIndexed(cmd, g_vkIndexCount, 1, 0, 0, 0);
-
-    // Render text overlay if initialized
-    if (g_vkTextInitialized && g_vkTextPipeline && g_vkTextVertexBufferMapped) {
-        // Calculate FPS
-        static LARGE_INTEGER lastFpsTime = {0};
-        static int frameCount = 0;
-        static float fps = 0.0f;
-        LARGE_INTEGER currentTime;
-        QueryPerformanceCounter(&currentTime);
-        frameCount++;
-        double elapsed = (double)(currentTime.QuadPart - lastFpsTime.QuadPart) / g_perfFreq.QuadPart;
-        if (elapsed >= 0.5) {
-            fps = (float)(frameCount / elapsed);
-            frameCount = 0;
-            lastFpsTime = currentTime;
-        }
-
-        // Build text string (same format as D3D11/D3D12)
-        char textBuf[512];
-        snprintf(textBuf, sizeof(textBuf), "API: Vulkan\nGPU: %s\nFPS: %.0f\nTriangles: %d\nResolution: %ux%u",
-                 g_vkGpuName.c_str(), fps, g_vkTriangleCount,
-                 g_vkSwapchainExtent.width, g_vkSwapchainExtent.height);
-
-        // Build vertices (shadow first, then text)
-        int totalVerts = 0;
-        VkTextVert* verts = (VkTextVert*)g_vkTextVertexBufferMapped;
-
-        // Text styling (same as D3D11: scale 1.5, shadow offset)
-        float scale = 1.5f;
-        float shadowOff = 2.0f;
-        const int FONT_COLS = 16;
-        const float CHAR_W = 8.0f * scale;
-        const float CHAR_H = 8.0f * scale;
-        const float TEX_W = 128.0f, TEX_H = 48.0f;
-        float ndcScaleX = 2.0f / (float)g_vkSwapchainExtent.width;
-        float ndcScaleY = 2.0f / (float)g_vkSwapchainExtent.height;
-
-        // Helper lambda to add text vertices
-        auto addText = [&](const char* text, float startX, float startY, float r, float g, float b, float a) {
-            float cx = startX, cy = startY;
-            for (const char* p = text; *p && totalVerts < g_vkMaxTextChars * 6 - 6; p++) {
-                if (*p == '\n') { cx = startX; cy += CHAR_H * 1.4f; continue; }
-                if (*p < 32 || *p > 127) continue;
-
-                int idx = *p - 32;
-                int col = idx % FONT_COLS, row = idx / FONT_COLS;
-                float u0 = col * 8.0f / TEX_W, v0 = row * 8.0f / TEX_H;
-                float u1 = u0 + 8.0f / TEX_W, v1 = v0 + 8.0f / TEX_H;
-
-                float x0 = cx * ndcScaleX - 1.0f;
-                float y0 = cy * ndcScaleY - 1.0f;
-                float x1 = (cx + CHAR_W) * ndcScaleX - 1.0f;
-                float y1 = (cy + CHAR_H) * ndcScaleY - 1.0f;
-
-                verts[totalVerts++] = {x0, y0, u0, v0, r, g, b, a};
-                verts[totalVerts++] = {x1, y0, u1, v0, r, g, b, a};
-                verts[totalVerts++] = {x0, y1, u0, v1, r, g, b, a};
-                verts[totalVerts++] = {x1, y0, u1, v0, r, g, b, a};
-                verts[totalVerts++] = {x1, y1, u1, v1, r, g, b, a};
-                verts[totalVerts++] = {x0, y1, u0, v1, r, g, b, a};
-                cx += CHAR_W;
-            }
-        };
-
-        // Add shadow and main text (top-left corner like D3D11)
-        float textX = 10.0f;
-        float textY = 10.0f;
-        addText(textBuf, textX + shadowOff, textY + shadowOff, 0.0f, 0.0f, 0.0f, 0.7f);  // Shadow (black, semi-transparent)
-        addText(textBuf, textX, textY, 1.0f, 1.0f, 1.0f, 1.0f);  // White text
-
-        if (totalVerts > 0) {
-            // Render text in SAME render pass as 3D content (after 3D, before ending pass)
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vkTextPipeline);
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vkTextPipelineLayout,
-                                    0, 1, &g_vkTextDescSet, 0, nullptr);
-
-            VkBuffer textVBs[] = { g_vkTextVertexBuffer };
-            VkDeviceSize textOffsets[] = { 0 };
-            vkCmdBindVertexBuffers(cmd, 0, 1, textVBs, textOffsets);
-            vkCmdDraw(cmd, totalVerts, 1, 0, 0);
-        }
+    if (pc) {
+        vkCmdPushConstants(cmd, g_vkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(*pc), pc);
+    } else {
+        uint32_t dynamicOffset = (uint32_t)(imageIndex * g_vkFrameDataStride);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vkPipelineLayout,
+                                0, 1, &g_vkFrameDataSet, 1, &dynamicOffset);
+    }
+    vkCmdDrawIndexed(cmd, g_vkIndexCount, g_vkInstanceCount, 0, 0, 0);
+
+    if (textVerts > 0) {
+        // Render text in SAME render pass as 3D content (after 3D, before ending pass)
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vkTextPipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vkTextPipelineLayout,
+                                0, 1, &g_vkTextDescSet, 0, nullptr);
+
+        VkBuffer textVBs[] = { g_vkTextVertexBuffer };
+        VkDeviceSize textOffsets[] = { sizeof(TextVert) * 6 * g_vkMaxTextChars * textSlice };
+        vkCmdBindVertexBuffers(cmd, 0, 1, textVBs, textOffsets);
+        vkCmdDraw(cmd, textVerts, 1, 0, 0);
     }
 
     vkCmdEndRenderPass(cmd);
     vkEndCommandBuffer(cmd);
+}
+
+// --prerecord: update imageIndex's data slice and hand back its command
+// buffer, re-recording it only when the overlay changed since it was recorded
+static VkCommandBuffer PrerecordedCommandBufferVk(uint32_t frame, uint32_t imageIndex,
+                                                  const VkPushConstants& pc, const char* overlay)
+{
+    // The image's command buffer, data slice and text slice may still be in
+    // use by the frame slot that last drew it (acquire order isn't round-robin)
+    VkFence& imageFence = g_vkImageFences[imageIndex];
+    if (imageFence && imageFence != g_vkInFlightFences[frame])
+        vkWaitForFences(g_vkDevice, 1, &imageFence, VK_TRUE, UINT64_MAX);
+    imageFence = g_vkInFlightFences[frame];
+
+    memcpy((char*)g_vkFrameDataMemory.mapped + imageIndex * g_vkFrameDataStride, &pc, sizeof(pc));
+
+    int textVerts = BuildTextVertsVk(overlay, imageIndex);
+
+    VkCommandBuffer cmd = g_vkImageCommandBuffers[imageIndex];
+    if (g_vkImageTextVersion[imageIndex] != g_vkOverlay.version) {
+        vkResetCommandBuffer(cmd, 0);
+        RecordFrameVk(cmd, imageIndex, nullptr, imageIndex, textVerts);
+        g_vkImageTextVersion[imageIndex] = g_vkOverlay.version;
+    }
+    return cmd;
+}
+
+void RenderVulkan()
+{
+    VkResult result;
+
+    // Wait only for the frame that last used this slot (FRAME_COUNT frames ago)
+    uint32_t frame = g_vkFrameIndex;
+    result = vkWaitForFences(g_vkDevice, 1, &g_vkInFlightFences[frame], VK_TRUE, UINT64_MAX);
+    if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkWaitForFences: %d\n", result);
+    VkPresentFrameBegin(g_vkSwapchain, FRAME_COUNT);
+
+    uint32_t imageIndex;
+    result = VkPresentAcquire(g_vkDevice, g_vkSwapchain, g_vkGraphicsQueue, g_vkImageAvailableSemaphores[frame], &imageIndex);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        // Surface changed before WM_SIZE reached the main loop. Fence is
+        // still signaled (not reset yet), so just rebuild and skip the frame.
+        ResizeVulkan();
+        return;
+    }
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR && g_vkFirstFrame) Log("[VK ERROR] vkAcquireNextImageKHR: %d\n", result);
+
+    result = vkResetFences(g_vkDevice, 1, &g_vkInFlightFences[frame]);
+    if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkResetFences: %d\n", result);
+
+    // Get time
+    LARGE_INTEGER nowTime;
+    QueryPerformanceCounter(&nowTime);
+    float t = (float)(nowTime.QuadPart - g_startTime.QuadPart) / g_perfFreq.QuadPart;
+
+    VkPushConstants pc;
+    BuildFrameConstantsVk(t, pc);
+
+    char overlay[512];
+    FormatOverlayVk(overlay, sizeof(overlay));
+
+    VkCommandBuffer cmd;
+    if (PrerecordUsableVk()) {
+        cmd = PrerecordedCommandBufferVk(frame, imageIndex, pc, overlay);
+    } else {
+        // Record command buffer (text goes to this frame's slice)
+        cmd = g_vkCommandBuffers[frame];
+        vkResetCommandBuffer(cmd, 0);
+        int textVerts = BuildTextVertsVk(overlay, frame);
+        RecordFrameVk(cmd, imageIndex, &pc, frame, textVerts);
+    }
 
     // Submit
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    VkSemaphore waitSemaphores[] = { g_vkImageAvailableSemaphore };
+    VkSemaphore waitSemaphores[] = { g_vkImageAvailableSemaphores[frame] };
     VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
     submitInfo.waitSemaphoreCount = 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmd;
-    VkSemaphore signalSemaphores[] = { g_vkRenderFinishedSemaphore };
+    VkSemaphore signalSemaphores[] = { g_vkRenderFinishedSemaphores[imageIndex] };
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    result = vkQueueSubmit(g_vkGraphicsQueue, 1, &submitInfo, g_vkInFlightFence);
+    result = vkQueueSubmit(g_vkGraphicsQueue, 1, &submitInfo, g_vkInFlightFences[frame]);
+    g_vkFrameIndex = (g_vkFrameIndex + 1) % FRAME_COUNT;
     if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkQueueSubmit: %d\n", result);
 
     // Present
@@ -1567,8 +1672,9 @@ void RenderVulkan()
     presentInfo.pSwapchains = &g_vkSwapchain;
     presentInfo.pImageIndices = &imageIndex;
 
-    result = vkQueuePresentKHR(g_vkPresentQueue, &presentInfo);
-    if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkQueuePresentKHR: %d\n", result);
+    result = VkPresentQueue(g_vkPresentQueue, presentInfo);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) ResizeVulkan();
+    else if (result != VK_SUCCESS && g_vkFirstFrame) Log("[VK ERROR] vkQueuePresentKHR: %d\n", result);
 
     if (g_vkFirstFrame) {
         Log("[VK DEBUG] First frame rendered. imageIndex=%u, indexCount=%u\n", imageIndex, g_vkIndexCount);
@@ -1577,6 +1683,29 @@ void RenderVulkan()
 
 }
 
+// ============== RESIZE ==============
+// Rebuild swapchain-sized resources; device, pipelines and buffers are kept.
+bool ResizeVulkan()
+{
+    if (!g_vkDevice || !g_vkSwapchain) return false;
+    vkDeviceWaitIdle(g_vkDevice);
+
+    size_t oldImageCount = g_vkSwapchainImages.size();
+    DestroySwapchainResourcesVk();
+    if (!CreateSwapchainVk(g_vkSwapchain)) {
+        Log("[ERROR] Vulkan swapchain recreation failed\n");
+        return false;
+    }
+    if (!CreateFramebuffersVk()) return false;
+
+    // Image count may change with the new swapchain
+    if (g_vkSwapchainImages.size() != oldImageCount && !CreateRenderFinishedSemaphoresVk()) return false;
+    ResetPrerecordVk();
+
+    Log("[INFO] Vulkan resized to %ux%u\n", g_vkSwapchainExtent.width, g_vkSwapchainExtent.height);
+    return true;
+}
+
 void CleanupVulkan()
 {
     Log("[INFO] Cleaning up Vulkan...\n");
@@ -1584,12 +1713,9 @@ void CleanupVulkan()
     if (g_vkDevice) vkDeviceWaitIdle(g_vkDevice);
 
     // Cleanup text rendering resources
-    if (g_vkTextVertexBufferMapped) {
-        vkUnmapMemory(g_vkDevice, g_vkTextVertexBufferMemory);
-        g_vkTextVertexBufferMapped = nullptr;
-    }
+    g_vkTextVertexBufferMapped = nullptr;   // Block mapping, released with the allocator
     if (g_vkTextVertexBuffer) { vkDestroyBuffer(g_vkDevice, g_vkTextVertexBuffer, nullptr); g_vkTextVertexBuffer = VK_NULL_HANDLE; }
-    if (g_vkTextVertexBufferMemory) { vkFreeMemory(g_vkDevice, g_vkTextVertexBufferMemory, nullptr); g_vkTextVertexBufferMemory = VK_NULL_HANDLE; }
+    VkMemFree(g_vkTextVertexBufferMemory);
     if (g_vkTextPipeline) { vkDestroyPipeline(g_vkDevice, g_vkTextPipeline, nullptr); g_vkTextPipeline = VK_NULL_HANDLE; }
     if (g_vkTextPipelineLayout) { vkDestroyPipelineLayout(g_vkDevice, g_vkTextPipelineLayout, nullptr); g_vkTextPipelineLayout = VK_NULL_HANDLE; }
     if (g_vkTextDescPool) { vkDestroyDescriptorPool(g_vkDevice, g_vkTextDescPool, nullptr); g_vkTextDescPool = VK_NULL_HANDLE; }
@@ -1597,42 +1723,40 @@ void CleanupVulkan()
     if (g_vkFontSampler) { vkDestroySampler(g_vkDevice, g_vkFontSampler, nullptr); g_vkFontSampler = VK_NULL_HANDLE; }
     if (g_vkFontImageView) { vkDestroyImageView(g_vkDevice, g_vkFontImageView, nullptr); g_vkFontImageView = VK_NULL_HANDLE; }
     if (g_vkFontImage) { vkDestroyImage(g_vkDevice, g_vkFontImage, nullptr); g_vkFontImage = VK_NULL_HANDLE; }
-    if (g_vkFontImageMemory) { vkFreeMemory(g_vkDevice, g_vkFontImageMemory, nullptr); g_vkFontImageMemory = VK_NULL_HANDLE; }
+    VkMemFree(g_vkFontImageMemory);
     g_vkTextInitialized = false;
 
-    if (g_vkIndexBuffer) vkDestroyBuffer(g_vkDevice, g_vkIndexBuffer, nullptr);
-    if (g_vkIndexBufferMemory) vkFreeMemory(g_vkDevice, g_vkIndexBufferMemory, nullptr);
-    if (g_vkVertexBuffer) vkDestroyBuffer(g_vkDevice, g_vkVertexBuffer, nullptr);
-    if (g_vkVertexBufferMemory) vkFreeMemory(g_vkDevice, g_vkVertexBufferMemory, nullptr);
-
-    if (g_vkInFlightFence) vkDestroyFence(g_vkDevice, g_vkInFlightFence, nullptr);
-    if (g_vkRenderFinishedSemaphore) vkDestroySemaphore(g_vkDevice, g_vkRenderFinishedSemaphore, nullptr);
-    if (g_vkImageAvailableSemaphore) vkDestroySemaphore(g_vkDevice, g_vkImageAvailableSemaphore, nullptr);
-
-    if (g_vkCommandPool) vkDestroyCommandPool(g_vkDevice, g_vkCommandPool, nullptr);
-
-    for (auto fb : g_vkFramebuffers) if (fb) vkDestroyFramebuffer(g_vkDevice, fb, nullptr);
-    g_vkFramebuffers.clear();
-
-    if (g_vkPipeline) vkDestroyPipeline(g_vkDevice, g_vkPipeline, nullptr);
-    if (g_vkPipelineLayout) vkDestroyPipelineLayout(g_vkDevice, g_vkPipelineLayout, nullptr);
-    if (g_vkRenderPass) vkDestroyRenderPass(g_vkDevice, g_vkRenderPass, nullptr);
+    if (g_vkIndexBuffer) { vkDestroyBuffer(g_vkDevice, g_vkIndexBuffer, nullptr); g_vkIndexBuffer = VK_NULL_HANDLE; }
+    VkMemFree(g_vkIndexBufferMemory);
+    if (g_vkVertexBuffer) { vkDestroyBuffer(g_vkDevice, g_vkVertexBuffer, nullptr); g_vkVertexBuffer = VK_NULL_HANDLE; }
+    VkMemFree(g_vkVertexBufferMemory);
+    if (g_vkInstanceBuffer) { vkDestroyBuffer(g_vkDevice, g_vkInstanceBuffer, nullptr); g_vkInstanceBuffer = VK_NULL_HANDLE; }
+    VkMemFree(g_vkInstanceBufferMemory);
+    g_vkInstanceCount = 1;
+
+    for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+        if (g_vkInFlightFences[i]) { vkDestroyFence(g_vkDevice, g_vkInFlightFences[i], nullptr); g_vkInFlightFences[i] = VK_NULL_HANDLE; }
+        if (g_vkImageAvailableSemaphores[i]) { vkDestroySemaphore(g_vkDevice, g_vkImageAvailableSemaphores[i], nullptr); g_vkImageAvailableSemaphores[i] = VK_NULL_HANDLE; }
+        g_vkCommandBuffers[i] = VK_NULL_HANDLE;  // Freed with the pool
+    }
+    DestroyRenderFinishedSemaphoresVk();
 
-    if (g_vkDepthImageView) vkDestroyImageView(g_vkDevice, g_vkDepthImageView, nullptr);
-    if (g_vkDepthImage) vkDestroyImage(g_vkDevice, g_vkDepthImage, nullptr);
-    if (g_vkDepthImageMemory) vkFreeMemory(g_vkDevice, g_vkDepthImageMemory, nullptr);
+    if (g_vkCommandPool) { vkDestroyCommandPool(g_vkDevice, g_vkCommandPool, nullptr); g_vkCommandPool = VK_NULL_HANDLE; }
+    DestroyFrameDataVk();
 
-    for (auto iv : g_vkSwapchainImageViews) if (iv) vkDestroyImageView(g_vkDevice, iv, nullptr);
-    g_vkSwapchainImageViews.clear();
+    DestroySwapchainResourcesVk();
 
-    if (g_vkSwapchain) vkDestroySwapchainKHR(g_vkDevice, g_vkSwapchain, nullptr);
-    if (g_vkDevice) vkDestroyDevice(g_vkDevice, nullptr);
-    if (g_vkSurface) vkDestroySurfaceKHR(g_vkInstance, g_vkSurface, nullptr);
-    if (g_vkInstance) vkDestroyInstance(g_vkInstance, nullptr);
+    if (g_vkPipeline) { vkDestroyPipeline(g_vkDevice, g_vkPipeline, nullptr); g_vkPipeline = VK_NULL_HANDLE; }
+    if (g_vkPipelineLayout) { vkDestroyPipelineLayout(g_vkDevice, g_vkPipelineLayout, nullptr); g_vkPipelineLayout = VK_NULL_HANDLE; }
+    if (g_vkRenderPass) { vkDestroyRenderPass(g_vkDevice, g_vkRenderPass, nullptr); g_vkRenderPass = VK_NULL_HANDLE; }
 
-    g_vkInstance = VK_NULL_HANDLE;
-    g_vkDevice = VK_NULL_HANDLE;
-    g_vkSwapchain = VK_NULL_HANDLE;
+    if (g_vkSwapchain) { VkPresentDestroySwapchain(g_vkDevice, g_vkSwapchain); g_vkSwapchain = VK_NULL_HANDLE; }
+    VkPipelineCacheSave(g_vkPhysicalDevice, g_vkDevice, g_vkPipelineCache, "raster", "Vulkan");
+    VkPresentWaitShutdown();
+    VkMemShutdown();
+    if (g_vkDevice) { vkDestroyDevice(g_vkDevice, nullptr); g_vkDevice = VK_NULL_HANDLE; }
+    if (g_vkSurface) { vkDestroySurfaceKHR(g_vkInstance, g_vkSurface, nullptr); g_vkSurface = VK_NULL_HANDLE; }
+    if (g_vkInstance) { vkDestroyInstance(g_vkInstance, nullptr); g_vkInstance = VK_NULL_HANDLE; }
 
     Log("[INFO] Vulkan cleanup complete\n");
 }
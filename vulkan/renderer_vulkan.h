@@ -8,6 +8,7 @@ bool InitVulkan(HWND hwnd);
 bool InitVulkanText();
 void RenderVulkan();
 void CleanupVulkan();
+bool ResizeVulkan();  // Recreate swapchain and size-dependent resources
 
 // Text initialization state (set by main after calling InitVulkanText)
 extern bool g_vkTextInitialized;
@@ -8,6 +8,22 @@
 #include "renderer_vulkan_rq.h"
 #include "vulkan_rq_shaders.h"
 #include "vulkan_shaders.h"  // For text rendering shaders
+#include "vk_upload.h"
+#include "vk_present.h"
+#include "vk_pipeline_cache.h"
+#include "vk_specialize.h"
+#include "vk_memory.h"
+#include "vk_tlas.h"
+#include "vk_blas.h"
+#include "vk_startup_timer.h"
+#include "../gpu_profiler.h"
+#include "../rt_geometry.h"
+#include "../text_overlay.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "../group_tune.h"
+#include "../accumulation.h"
+#include "../mesh_file.h"
 
 #pragma comment(lib, "vulkan-1.lib")
 
@@ -20,11 +36,9 @@
 // External declarations
 extern int fps;
 extern std::wstring gpuName;
-extern LARGE_INTEGER g_startTime;
-extern LARGE_INTEGER g_perfFreq;
 extern const unsigned char g_font8x8[96][8];
-extern const UINT W;
-extern const UINT H;
+extern UINT W;
+extern UINT H;
 
 // ============== VULKAN RQ FUNCTION POINTERS ==============
 static PFN_vkGetBufferDeviceAddressKHR pvkGetBufferDeviceAddressKHR = nullptr;
@@ -35,12 +49,13 @@ static PFN_vkCmdBuildAccelerationStructuresKHR pvkCmdBuildAccelerationStructures
 static PFN_vkGetAccelerationStructureDeviceAddressKHR pvkGetAccelerationStructureDeviceAddressKHR = nullptr;
 
 // ============== CONSTANTS ==============
-static const uint32_t FRAME_COUNT = 2;
+static const uint32_t FRAME_COUNT = 2;   // Frames in flight
 
 // ============== VULKAN RQ GLOBALS ==============
 static VkInstance s_instance = VK_NULL_HANDLE;
 static VkPhysicalDevice s_physicalDevice = VK_NULL_HANDLE;
 static VkDevice s_device = VK_NULL_HANDLE;
+static VkPipelineCache s_pipelineCache = VK_NULL_HANDLE;   // Persisted in shadercache\ (vk_pipeline_cache.h)
 static VkQueue s_graphicsQueue = VK_NULL_HANDLE;
 static VkQueue s_presentQueue = VK_NULL_HANDLE;
 static VkQueue s_computeQueue = VK_NULL_HANDLE;
@@ -50,66 +65,112 @@ static std::vector<VkImage> s_swapchainImages;
 static std::vector<VkImageView> s_swapchainImageViews;
 static VkFormat s_swapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
 static VkExtent2D s_swapchainExtent = {};
+static VkPresentModeKHR s_presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
 static VkCommandPool s_commandPool = VK_NULL_HANDLE;
-static std::vector<VkCommandBuffer> s_commandBuffers;
-static VkSemaphore s_imageAvailableSemaphore = VK_NULL_HANDLE;
-static VkSemaphore s_renderFinishedSemaphore = VK_NULL_HANDLE;
-static VkFence s_inFlightFence = VK_NULL_HANDLE;
+// Per frame slot (s_frameCount % FRAME_COUNT): the CPU records frame N+1
+// while the GPU still traces frame N. Render-finished semaphores are per
+// swapchain image - the presentation engine holds them until re-acquire.
+static VkCommandBuffer s_commandBuffers[FRAME_COUNT] = {};
+static VkSemaphore s_imageAvailableSemaphores[FRAME_COUNT] = {};
+static VkFence s_inFlightFences[FRAME_COUNT] = {};
+static std::vector<VkSemaphore> s_renderFinishedSemaphores;
 static uint32_t s_graphicsFamily = UINT32_MAX;
 static uint32_t s_presentFamily = UINT32_MAX;
+static uint32_t s_transferFamily = UINT32_MAX;   // Dedicated transfer queue for static uploads, if any
 static uint32_t s_computeFamily = UINT32_MAX;
+static uint32_t s_computeQueueIndex = 0;         // 1 when async compute shares the graphics family
+
+// --async-compute: TLAS rebuild + ray query dispatch are recorded into
+// s_computeCommandBuffers and submitted to s_computeQueue; the graphics queue
+// waits on s_computeDoneSemaphores[frame] before copying and drawing the text.
+// The compute work of frame N+1 can then run while frame N is still copying.
+static bool s_asyncCompute = false;
+static VkCommandPool s_computeCommandPool = VK_NULL_HANDLE;
+static VkCommandBuffer s_computeCommandBuffers[FRAME_COUNT] = {};
+static VkSemaphore s_computeDoneSemaphores[FRAME_COUNT] = {};
+
+// GPU timestamps per frame slot: 0-2 on the queue that traces (begin, TLAS, trace),
+// 3-4 around the copy + text on the graphics queue
+#define TIMESTAMP_STAMPS 5
+static VkQueryPool s_timestampPool = VK_NULL_HANDLE;
+static float s_timestampPeriod = 0.0f;        // ns per tick
+static bool s_timestampPending[FRAME_COUNT] = {};
+static uint64_t s_lastGraphicsSpan[2] = {};   // Copy + text of the previous collected frame (async overlap)
 static std::string s_gpuName;
 
 // Acceleration structures
 static VkAccelerationStructureKHR s_blasStatic = VK_NULL_HANDLE;
 static VkAccelerationStructureKHR s_blasCubes = VK_NULL_HANDLE;
-static VkAccelerationStructureKHR s_tlas = VK_NULL_HANDLE;
+static VkAccelerationStructureKHR s_tlas[FRAME_COUNT] = {};   // Updated every frame: one per frame slot
+static TlasPolicy s_tlasPolicy;   // Refit vs rebuild for the s_tlas chain
 static VkBuffer s_blasStaticBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_blasStaticMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_blasStaticMemory;
 static VkBuffer s_blasCubesBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_blasCubesMemory = VK_NULL_HANDLE;
-static VkBuffer s_tlasBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_tlasMemory = VK_NULL_HANDLE;
-static VkBuffer s_instanceBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_instanceMemory = VK_NULL_HANDLE;
-static void* s_instanceMapped = nullptr;
-static VkBuffer s_tlasScratchBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_tlasScratchMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_blasCubesMemory;
+static VkBuffer s_tlasBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_tlasMemory[FRAME_COUNT];
+static VkBuffer s_instanceBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_instanceMemory[FRAME_COUNT];
+static void* s_instanceMapped[FRAME_COUNT] = {};
+static VkBuffer s_tlasScratchBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_tlasScratchMemory[FRAME_COUNT];
 
 // Geometry buffers
 static VkBuffer s_staticVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_staticVertexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_staticVertexMemory;
 static VkBuffer s_staticIndexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_staticIndexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_staticIndexMemory;
 static VkBuffer s_cubesVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_cubesVertexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_cubesVertexMemory;
 static VkBuffer s_cubesIndexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_cubesIndexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_cubesIndexMemory;
 static uint32_t s_staticVertexCount = 0;
 static uint32_t s_staticIndexCount = 0;
 static uint32_t s_cubesVertexCount = 0;
 static uint32_t s_cubesIndexCount = 0;
+// BLAS input layout, full vertices or --compact-verts (rt_geometry.h)
+static uint32_t s_staticVertexStride = sizeof(VkRQVertex), s_cubesVertexStride = sizeof(VkRQVertex);
+static VkIndexType s_staticIndexType = VK_INDEX_TYPE_UINT32, s_cubesIndexType = VK_INDEX_TYPE_UINT32;
 
 // Compute pipeline (replaces RT pipeline)
 static VkPipeline s_computePipeline = VK_NULL_HANDLE;
 static VkPipelineLayout s_computePipelineLayout = VK_NULL_HANDLE;
+// --group-size (group_tune.h): LocalSize-rewritten copies of the compute
+// pipeline, [GROUP_VARIANT_DEFAULT] = s_computePipeline. Wave variants need
+// VK_EXT_subgroup_size_control (s_subgroupSizeMin / Max stay 0 without it).
+static VkPipeline s_computeVariants[GROUP_VARIANT_COUNT] = {};
+static VkPhysicalDeviceSubgroupSizeControlFeaturesEXT s_subgroupSizeFeatures = {};
+static uint32_t s_subgroupSizeMin = 0, s_subgroupSizeMax = 0;
 static VkDescriptorSetLayout s_computeDescSetLayout = VK_NULL_HANDLE;
 static VkDescriptorPool s_computeDescPool = VK_NULL_HANDLE;
-static VkDescriptorSet s_computeDescSet = VK_NULL_HANDLE;
+static VkDescriptorSet s_computeDescSet[FRAME_COUNT] = {};   // TLAS + uniforms of that frame slot
 
 // Output image
-static VkImage s_outputImage = VK_NULL_HANDLE;
-static VkDeviceMemory s_outputMemory = VK_NULL_HANDLE;
-static VkImageView s_outputImageView = VK_NULL_HANDLE;
+// One per frame slot so the compute queue can trace frame N+1 while frame N is copied
+static VkImage s_outputImage[FRAME_COUNT] = {};
+static VkMemAlloc s_outputMemory[FRAME_COUNT];
+static VkImageView s_outputImageView[FRAME_COUNT] = {};
+// --render-scale: output (and accumulation) size, smaller than the swapchain
+// when scaled; the copy to the swapchain then becomes a linear blit
+static VkExtent2D s_traceExtent = {};
+
+// --accumulate: rgba32f running sum at binding 3 (vk_specialize.h patches the
+// shader's store). Shared by the frame slots - the dispatches that use it are
+// all on the same queue, ordered by a barrier in RecordTrace.
+static VkImage s_accumImage = VK_NULL_HANDLE;
+static VkMemAlloc s_accumMemory;
+static VkImageView s_accumImageView = VK_NULL_HANDLE;
+static bool s_accumulate = false;
+static uint32_t s_accumFrame[FRAME_COUNT] = {};   // AccumFrameBegin of the frame recorded in that slot
 
 // Uniform buffer
-static VkBuffer s_uniformBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_uniformMemory = VK_NULL_HANDLE;
-static void* s_uniformMapped = nullptr;
+static VkBuffer s_uniformBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_uniformMemory[FRAME_COUNT];
+static void* s_uniformMapped[FRAME_COUNT] = {};
 
 // Text rendering
 static VkImage s_fontImage = VK_NULL_HANDLE;
-static VkDeviceMemory s_fontMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_fontMemory;
 static VkImageView s_fontImageView = VK_NULL_HANDLE;
 static VkSampler s_fontSampler = VK_NULL_HANDLE;
 static VkDescriptorSetLayout s_textDescSetLayout = VK_NULL_HANDLE;
@@ -120,10 +181,13 @@ static VkPipeline s_textPipeline = VK_NULL_HANDLE;
 static VkRenderPass s_textRenderPass = VK_NULL_HANDLE;
 static std::vector<VkFramebuffer> s_framebuffers;
 static VkBuffer s_textVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_textVertexMemory = VK_NULL_HANDLE;
-static void* s_textVertexMapped = nullptr;
-static TextVert s_textVerts[6000];
+static VkMemAlloc s_textVertexMemory;
+static void* s_textVertexMapped = nullptr;   // FRAME_COUNT slices of TEXT_MAX_VERTS
+static const uint32_t TEXT_MAX_VERTS = 8000;
+static TextVert s_textVerts[TEXT_MAX_VERTS];
 static uint32_t s_textVertCount = 0;
+static TextOverlay s_overlay;                        // s_textVerts is re-expanded only when it changes
+static UINT s_textSliceVersion[FRAME_COUNT] = {};    // Overlay version in each text VB slice
 
 // Frame tracking
 static uint32_t s_frameCount = 0;
@@ -154,20 +218,9 @@ struct VkRQUniforms {
 struct float3 { float x, y, z; };
 
 // ============== HELPER FUNCTIONS ==============
-static uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(s_physicalDevice, &memProps);
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-    Log("[VkRQ] ERROR: Failed to find suitable memory type\n");
-    return UINT32_MAX;
-}
-
+// Memory comes from the sub-allocator (vk_memory.h); linear = lives until cleanup
 static bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-                         VkBuffer& buffer, VkDeviceMemory& memory) {
+                         VkBuffer& buffer, VkMemAlloc& memory, bool linear = false, VkDeviceSize minAlign = 0) {
     VkBufferCreateInfo bufferInfo = {};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size = size;
@@ -179,33 +232,12 @@ static bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPr
         return false;
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetBufferMemoryRequirements(s_device, buffer, &memReqs);
-
-    VkMemoryAllocateFlagsInfo allocFlagsInfo = {};
-    allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-    if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
-        allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
-    }
-
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.pNext = (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) ? &allocFlagsInfo : nullptr;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, properties);
-
-    if (allocInfo.memoryTypeIndex == UINT32_MAX) {
-        vkDestroyBuffer(s_device, buffer, nullptr);
-        return false;
-    }
-
-    if (vkAllocateMemory(s_device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+    if (!VkMemAllocBuffer(buffer, properties, memory, linear, minAlign)) {
         Log("[VkRQ] ERROR: Failed to allocate buffer memory\n");
         vkDestroyBuffer(s_device, buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
         return false;
     }
-
-    vkBindBufferMemory(s_device, buffer, memory, 0);
     return true;
 }
 
@@ -248,14 +280,6 @@ static void EndSingleTimeCommands(VkCommandBuffer commandBuffer) {
     vkFreeCommandBuffers(s_device, s_commandPool, 1, &commandBuffer);
 }
 
-static void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-    VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-    VkBufferCopy copyRegion = {};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-    EndSingleTimeCommands(commandBuffer);
-}
-
 // ============== GEOMETRY GENERATION ==============
 static void GenerateCornellBox(std::vector<VkRQVertex>& verts, std::vector<uint32_t>& indices) {
     uint32_t baseIdx = (uint32_t)verts.size();
@@ -477,89 +501,64 @@ static bool CreateGeometryBuffers() {
     s_staticVertexCount = (uint32_t)staticVerts.size();
     s_staticIndexCount = (uint32_t)staticInds.size();
 
+    // --mesh replaces the rotating cubes BLAS, built straight from the file
+    // mapping. The precompiled shaders still shade hits by the cube primitive
+    // ranges, so the mesh gets cube face colours - a traversal / memory test,
+    // not a faithful image.
     std::vector<VkRQVertex> cubeVerts;
     std::vector<uint32_t> cubeInds;
-    GenerateRotatingCubes(cubeVerts, cubeInds);
-    s_cubesVertexCount = (uint32_t)cubeVerts.size();
-    s_cubesIndexCount = (uint32_t)cubeInds.size();
-
-    VkDeviceSize staticVBSize = staticVerts.size() * sizeof(VkRQVertex);
-    VkDeviceSize staticIBSize = staticInds.size() * sizeof(uint32_t);
-    VkDeviceSize cubesVBSize = cubeVerts.size() * sizeof(VkRQVertex);
-    VkDeviceSize cubesIBSize = cubeInds.size() * sizeof(uint32_t);
-
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
-    void* data;
-
-    CreateBuffer(staticVBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    vkMapMemory(s_device, stagingMemory, 0, staticVBSize, 0, &data);
-    memcpy(data, staticVerts.data(), staticVBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-    CreateBuffer(staticVBSize,
-                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_staticVertexBuffer, s_staticVertexMemory);
-    CopyBuffer(stagingBuffer, s_staticVertexBuffer, staticVBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
-
-    CreateBuffer(staticIBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    vkMapMemory(s_device, stagingMemory, 0, staticIBSize, 0, &data);
-    memcpy(data, staticInds.data(), staticIBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-    CreateBuffer(staticIBSize,
-                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_staticIndexBuffer, s_staticIndexMemory);
-    CopyBuffer(stagingBuffer, s_staticIndexBuffer, staticIBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
-
-    CreateBuffer(cubesVBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    vkMapMemory(s_device, stagingMemory, 0, cubesVBSize, 0, &data);
-    memcpy(data, cubeVerts.data(), cubesVBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-    CreateBuffer(cubesVBSize,
-                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_cubesVertexBuffer, s_cubesVertexMemory);
-    CopyBuffer(stagingBuffer, s_cubesVertexBuffer, cubesVBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
-
-    CreateBuffer(cubesIBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    vkMapMemory(s_device, stagingMemory, 0, cubesIBSize, 0, &data);
-    memcpy(data, cubeInds.data(), cubesIBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-    CreateBuffer(cubesIBSize,
-                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_cubesIndexBuffer, s_cubesIndexMemory);
-    CopyBuffer(stagingBuffer, s_cubesIndexBuffer, cubesIBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
+    if (!MeshLoaded()) GenerateRotatingCubes(cubeVerts, cubeInds);
+    s_cubesVertexCount = MeshLoaded() ? g_mesh.vertexCount : (uint32_t)cubeVerts.size();
+    s_cubesIndexCount = MeshLoaded() ? g_mesh.indexCount : (uint32_t)cubeInds.size();
+
+    // The shaders never fetch vertices (hit colours come from primitive ranges),
+    // so the buffers are BLAS inputs only and can take the compact layout
+    RTMeshData staticMesh, cubesMesh;
+    RTMeshPrepare(staticMesh, staticVerts.data(), sizeof(VkRQVertex), s_staticVertexCount, staticInds, "VkRQ static");
+    if (MeshLoaded()) {
+        cubesMesh.vertices = g_mesh.vertices;
+        cubesMesh.vertexBytes = MeshVertexBytes(g_mesh);
+        cubesMesh.vertexStride = sizeof(MeshVertex);
+        cubesMesh.vertexCount = g_mesh.vertexCount;
+        cubesMesh.indices = g_mesh.indices;
+        cubesMesh.indexBytes = MeshIndexBytes(g_mesh);
+        cubesMesh.indexCount = g_mesh.indexCount;
+        cubesMesh.index16 = false;
+    } else {
+        RTMeshPrepare(cubesMesh, cubeVerts.data(), sizeof(VkRQVertex), s_cubesVertexCount, cubeInds, "VkRQ cubes");
+    }
+    s_staticVertexStride = staticMesh.vertexStride;
+    s_cubesVertexStride = cubesMesh.vertexStride;
+    s_staticIndexType = staticMesh.index16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    s_cubesIndexType = cubesMesh.index16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+    // All four go to DEVICE_LOCAL memory in one transfer-queue batch; the BLAS
+    // builds read them through their device addresses
+    const VkBufferUsageFlags geomUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                                         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+    if (!VkUploadBegin(s_device, s_transferFamily, s_graphicsFamily)) return false;
+    bool uploaded = VkUploadBuffer(staticMesh.vertices, staticMesh.vertexBytes, geomUsage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                   s_staticVertexBuffer, s_staticVertexMemory, "static VB");
+    uploaded = uploaded && VkUploadBuffer(staticMesh.indices, staticMesh.indexBytes, geomUsage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                          s_staticIndexBuffer, s_staticIndexMemory, "static IB");
+    uploaded = uploaded && VkUploadBuffer(cubesMesh.vertices, cubesMesh.vertexBytes, geomUsage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                          s_cubesVertexBuffer, s_cubesVertexMemory, "cubes VB");
+    uploaded = uploaded && VkUploadBuffer(cubesMesh.indices, cubesMesh.indexBytes, geomUsage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                          s_cubesIndexBuffer, s_cubesIndexMemory, "cubes IB");
+    if (!VkUploadFlush() || !uploaded) {
+        Log("[VkRQ] ERROR: Geometry upload failed\n");
+        return false;
+    }
 
-    Log("[VkRQ] Geometry: Static %u verts/%u inds, Cubes %u verts/%u inds\n",
-        s_staticVertexCount, s_staticIndexCount, s_cubesVertexCount, s_cubesIndexCount);
+    Log("[VkRQ] Geometry: Static %u verts/%u inds, %s %u verts/%u inds\n",
+        s_staticVertexCount, s_staticIndexCount, MeshLoaded() ? "Mesh" : "Cubes", s_cubesVertexCount, s_cubesIndexCount);
     return true;
 }
 
 // ============== CREATE BLAS ==============
 static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t vertexCount, uint32_t indexCount,
-                       VkAccelerationStructureKHR& blas, VkBuffer& blasBuffer, VkDeviceMemory& blasMemory) {
+                       uint32_t vertexStride, VkIndexType indexType,
+                       VkAccelerationStructureKHR& blas, VkBuffer& blasBuffer, VkMemAlloc& blasMemory, const char* name) {
     VkAccelerationStructureGeometryKHR geometry = {};
     geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
     geometry.geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR;
@@ -567,15 +566,15 @@ static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t ver
     geometry.geometry.triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
     geometry.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
     geometry.geometry.triangles.vertexData.deviceAddress = GetBufferDeviceAddress(vertexBuffer);
-    geometry.geometry.triangles.vertexStride = sizeof(VkRQVertex);
+    geometry.geometry.triangles.vertexStride = vertexStride;
     geometry.geometry.triangles.maxVertex = vertexCount - 1;
-    geometry.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
+    geometry.geometry.triangles.indexType = indexType;
     geometry.geometry.triangles.indexData.deviceAddress = GetBufferDeviceAddress(indexBuffer);
 
     VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
     buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
     buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+    buildInfo.flags = VK_BLAS_STATIC_FLAGS;
     buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
     buildInfo.geometryCount = 1;
     buildInfo.pGeometries = &geometry;
@@ -602,7 +601,7 @@ static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t ver
     }
 
     VkBuffer scratchBuffer;
-    VkDeviceMemory scratchMemory;
+    VkMemAlloc scratchMemory;
     CreateBuffer(sizeInfo.buildScratchSize,
                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, scratchBuffer, scratchMemory);
@@ -615,11 +614,21 @@ static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t ver
     const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
 
     VkCommandBuffer cmd = BeginSingleTimeCommands();
+    VkStartupTimer timer;
+    VkStartupTimerBegin(timer, s_physicalDevice, s_device, s_graphicsFamily, cmd);
     pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
+    VkStartupTimerEnd(timer, cmd);
     EndSingleTimeCommands(cmd);
+    char timerName[STARTUP_NAME_LEN];
+    sprintf_s(timerName, "BLAS %s build", name);
+    VkStartupTimerCollect(timer, timerName);
 
     vkDestroyBuffer(s_device, scratchBuffer, nullptr);
-    vkFreeMemory(s_device, scratchMemory, nullptr);
+    VkMemFree(scratchMemory);
+
+    // Shrink to the compacted size (keeps the uncompacted BLAS if that fails)
+    VkCompactBLAS(s_device, s_graphicsQueue, s_commandPool, sizeInfo.accelerationStructureSize,
+                  blas, blasBuffer, blasMemory, "VkRQ", name);
     return true;
 }
 
@@ -652,75 +661,86 @@ static bool CreateTLAS() {
     instances[1].flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
     instances[1].accelerationStructureReference = blasCubesAddr;
 
-    VkDeviceSize instanceBufferSize = sizeof(instances);
-    CreateBuffer(instanceBufferSize,
-                 VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 s_instanceBuffer, s_instanceMemory);
-    vkMapMemory(s_device, s_instanceMemory, 0, instanceBufferSize, 0, &s_instanceMapped);
-    memcpy(s_instanceMapped, instances, instanceBufferSize);
-
-    VkAccelerationStructureGeometryKHR geometry = {};
-    geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-    geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    geometry.geometry.instances.arrayOfPointers = VK_FALSE;
-    geometry.geometry.instances.data.deviceAddress = GetBufferDeviceAddress(s_instanceBuffer);
-
-    VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
-    buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-    buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR |
-                      VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-    buildInfo.geometryCount = 1;
-    buildInfo.pGeometries = &geometry;
-
     uint32_t instanceCount = 2;
-    VkAccelerationStructureBuildSizesInfoKHR sizeInfo = {};
-    sizeInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-    pvkGetAccelerationStructureBuildSizesKHR(s_device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-                                              &buildInfo, &instanceCount, &sizeInfo);
+    TlasPolicyInvalidate(s_tlasPolicy);   // New TLAS chain: the first frame rebuilds
+    VkDeviceSize instanceBufferSize = sizeof(instances);
+    VkCommandBuffer cmd = BeginSingleTimeCommands();
+    VkStartupTimer timer;
+    VkStartupTimerBegin(timer, s_physicalDevice, s_device, s_graphicsFamily, cmd);
+
+    // One instance buffer / TLAS / scratch per frame slot so the per-frame
+    // rebuild never touches memory a frame still in flight is reading
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        CreateBuffer(instanceBufferSize,
+                     VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+                     VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     s_instanceBuffer[f], s_instanceMemory[f], true);
+        s_instanceMapped[f] = s_instanceMemory[f].mapped;
+        memcpy(s_instanceMapped[f], instances, instanceBufferSize);
+
+        VkAccelerationStructureGeometryKHR geometry = {};
+        geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+        geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+        geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+        geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+        geometry.geometry.instances.arrayOfPointers = VK_FALSE;
+        geometry.geometry.instances.data.deviceAddress = GetBufferDeviceAddress(s_instanceBuffer[f]);
+
+        VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
+        buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+        buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+        buildInfo.flags = VK_TLAS_BUILD_FLAGS;
+        buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+        buildInfo.geometryCount = 1;
+        buildInfo.pGeometries = &geometry;
+
+        VkAccelerationStructureBuildSizesInfoKHR sizeInfo = {};
+        sizeInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+        pvkGetAccelerationStructureBuildSizesKHR(s_device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+                                                  &buildInfo, &instanceCount, &sizeInfo);
+
+        CreateBuffer(sizeInfo.accelerationStructureSize,
+                     VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasBuffer[f], s_tlasMemory[f], true);
+
+        VkAccelerationStructureCreateInfoKHR createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+        createInfo.buffer = s_tlasBuffer[f];
+        createInfo.size = sizeInfo.accelerationStructureSize;
+        createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+
+        if (pvkCreateAccelerationStructureKHR(s_device, &createInfo, nullptr, &s_tlas[f]) != VK_SUCCESS) {
+            Log("[VkRQ] ERROR: Failed to create TLAS\n");
+            EndSingleTimeCommands(cmd);
+            VkStartupTimerCollect(timer, "TLAS build");
+            return false;
+        }
 
-    CreateBuffer(sizeInfo.accelerationStructureSize,
-                 VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasBuffer, s_tlasMemory);
+        CreateBuffer(VkTlasScratchSize(sizeInfo),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasScratchBuffer[f], s_tlasScratchMemory[f], true);
 
-    VkAccelerationStructureCreateInfoKHR createInfo = {};
-    createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
-    createInfo.buffer = s_tlasBuffer;
-    createInfo.size = sizeInfo.accelerationStructureSize;
-    createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+        buildInfo.dstAccelerationStructure = s_tlas[f];
+        buildInfo.scratchData.deviceAddress = GetBufferDeviceAddress(s_tlasScratchBuffer[f]);
 
-    if (pvkCreateAccelerationStructureKHR(s_device, &createInfo, nullptr, &s_tlas) != VK_SUCCESS) {
-        Log("[VkRQ] ERROR: Failed to create TLAS\n");
-        return false;
+        VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {};
+        rangeInfo.primitiveCount = instanceCount;
+        const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
+        pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
     }
 
-    CreateBuffer(sizeInfo.buildScratchSize,
-                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasScratchBuffer, s_tlasScratchMemory);
-
-    buildInfo.dstAccelerationStructure = s_tlas;
-    buildInfo.scratchData.deviceAddress = GetBufferDeviceAddress(s_tlasScratchBuffer);
-
-    VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {};
-    rangeInfo.primitiveCount = instanceCount;
-    const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
-
-    VkCommandBuffer cmd = BeginSingleTimeCommands();
-    pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
+    VkStartupTimerEnd(timer, cmd);
     EndSingleTimeCommands(cmd);
+    VkStartupTimerCollect(timer, "TLAS build");
 
-    Log("[VkRQ] TLAS created with %u instances\n", instanceCount);
+    Log("[VkRQ] TLAS created with %u instances (x%u frames in flight)\n", instanceCount, FRAME_COUNT);
     return true;
 }
 
 // ============== UPDATE CUBE TRANSFORM ==============
-static void UpdateCubeTransform(float time) {
-    if (!s_instanceMapped) return;
+static void UpdateCubeTransform(float time, uint32_t frame) {
+    if (!s_instanceMapped[frame]) return;
     float angleY = time * 1.2f;
     float angleX = time * 0.7f;
     float cosY = cosf(angleY), sinY = sinf(angleY);
@@ -729,147 +749,521 @@ static void UpdateCubeTransform(float time) {
     float m10 = 0, m11 = cosX, m12 = -sinX;
     float m20 = -sinY, m21 = cosY * sinX, m22 = cosY * cosX;
     float tx = 0.15f, ty = 0.15f, tz = 0.2f;
-    VkAccelerationStructureInstanceKHR* instances = (VkAccelerationStructureInstanceKHR*)s_instanceMapped;
+    VkAccelerationStructureInstanceKHR* instances = (VkAccelerationStructureInstanceKHR*)s_instanceMapped[frame];
     instances[1].transform.matrix[0][0] = m00; instances[1].transform.matrix[0][1] = m10; instances[1].transform.matrix[0][2] = m20; instances[1].transform.matrix[0][3] = tx;
     instances[1].transform.matrix[1][0] = m01; instances[1].transform.matrix[1][1] = m11; instances[1].transform.matrix[1][2] = m21; instances[1].transform.matrix[1][3] = ty;
     instances[1].transform.matrix[2][0] = m02; instances[1].transform.matrix[2][1] = m12; instances[1].transform.matrix[2][2] = m22; instances[1].transform.matrix[2][3] = tz;
 }
 
 // ============== REBUILD TLAS ==============
-static void RebuildTLAS(VkCommandBuffer cmd) {
-    if (!s_tlas || !s_instanceBuffer || !s_tlasScratchBuffer) return;
-    VkAccelerationStructureGeometryKHR geometry = {};
-    geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-    geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    geometry.geometry.instances.arrayOfPointers = VK_FALSE;
-    geometry.geometry.instances.data.deviceAddress = GetBufferDeviceAddress(s_instanceBuffer);
+// Refit (or rebuild, see tlas_policy.h) this slot's TLAS from the previous slot's
+static void RebuildTLAS(VkCommandBuffer cmd, uint32_t frame) {
+    if (!s_tlas[frame] || !s_instanceBuffer[frame] || !s_tlasScratchBuffer[frame]) return;
+    uint32_t prev = (frame + FRAME_COUNT - 1) % FRAME_COUNT;
+    VkTlasRecord(cmd, pvkCmdBuildAccelerationStructuresKHR, s_tlasPolicy,
+                 (const VkAccelerationStructureInstanceKHR*)s_instanceMapped[frame], 2,
+                 GetBufferDeviceAddress(s_instanceBuffer[frame]), s_tlas[prev], s_tlas[frame],
+                 GetBufferDeviceAddress(s_tlasScratchBuffer[frame]), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+}
 
-    VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
-    buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-    buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_BUILD_BIT_KHR |
-                      VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-    buildInfo.srcAccelerationStructure = VK_NULL_HANDLE;
-    buildInfo.dstAccelerationStructure = s_tlas;
-    buildInfo.geometryCount = 1;
-    buildInfo.pGeometries = &geometry;
-    buildInfo.scratchData.deviceAddress = GetBufferDeviceAddress(s_tlasScratchBuffer);
+// ============== GPU TIMESTAMPS ==============
+static bool CreateTimestampQueryPool() {
+    GpuProfilerReset();
+    memset(s_lastGraphicsSpan, 0, sizeof(s_lastGraphicsSpan));
+    if (s_computePipeline == VK_NULL_HANDLE) return false;   // Placeholder clear, nothing to time
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(s_physicalDevice, &props);
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(s_physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(s_physicalDevice, &familyCount, families.data());
+    uint32_t traceFamily = s_asyncCompute ? s_computeFamily : s_graphicsFamily;
+    if (s_graphicsFamily >= familyCount || traceFamily >= familyCount ||
+        families[s_graphicsFamily].timestampValidBits == 0 || families[traceFamily].timestampValidBits == 0 ||
+        props.limits.timestampPeriod <= 0.0f) {
+        Log("[VkRQ] Timestamps not supported on the render queues, GPU pass timings disabled\n");
+        return false;
+    }
+    s_timestampPeriod = props.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = FRAME_COUNT * TIMESTAMP_STAMPS;
+    if (vkCreateQueryPool(s_device, &poolInfo, nullptr, &s_timestampPool) != VK_SUCCESS) {
+        Log("[VkRQ] Warning: Failed to create timestamp query pool\n");
+        return false;
+    }
+    Log("[VkRQ] Timestamp query pool created (period %.2f ns)\n", s_timestampPeriod);
+    return true;
+}
 
-    VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {};
-    rangeInfo.primitiveCount = 2;
-    const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
-    pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
+// Called after the in-flight fence wait. The graphics submit waited on the
+// compute one, so both halves of the slot are written.
+static void CollectTimestamps(uint32_t slot) {
+    if (!s_timestampPool || !s_timestampPending[slot]) return;
+    s_timestampPending[slot] = false;
+
+    uint64_t stamps[TIMESTAMP_STAMPS] = {};
+    VkResult res = vkGetQueryPoolResults(s_device, s_timestampPool, slot * TIMESTAMP_STAMPS, TIMESTAMP_STAMPS,
+                                         sizeof(stamps), stamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (res != VK_SUCCESS) return;  // VK_NOT_READY - drop this sample rather than stall
+
+    auto toMs = [](uint64_t begin, uint64_t end) { return end > begin ? (double)(end - begin) * s_timestampPeriod / 1.0e6 : 0.0; };
+    GpuProfilerAddSample(0, "TLAS", toMs(stamps[0], stamps[1]));
+    double traceMs = toMs(stamps[1], stamps[2]);
+    GpuProfilerAddSample(1, "Trace", traceMs);
+    GroupTuneFrameTime(slot, traceMs);   // --group-size=auto times the trace pass alone
+    GpuProfilerAddSample(2, "Copy+Text", toMs(stamps[3], stamps[4]));
+
+    // Overlap gain: how long this frame's compute ran alongside the previous
+    // frame's copy + text. Both queues count the same device timestamp clock;
+    // ~0 means the GPU serializes the two queues.
+    if (s_asyncCompute) {
+        if (s_lastGraphicsSpan[1]) {
+            uint64_t begin = stamps[0] > s_lastGraphicsSpan[0] ? stamps[0] : s_lastGraphicsSpan[0];
+            uint64_t end = stamps[2] < s_lastGraphicsSpan[1] ? stamps[2] : s_lastGraphicsSpan[1];
+            GpuProfilerAddSample(3, "Overlap", toMs(begin, end));
+        }
+        s_lastGraphicsSpan[0] = stamps[3];
+        s_lastGraphicsSpan[1] = stamps[4];
+    }
+}
+
+static void WriteTimestamp(VkCommandBuffer cmd, uint32_t slot, uint32_t index, VkPipelineStageFlagBits stage) {
+    if (s_timestampPool) vkCmdWriteTimestamp(cmd, stage, s_timestampPool, slot * TIMESTAMP_STAMPS + index);
+}
+
+static void ResetTimestamps(VkCommandBuffer cmd, uint32_t slot, uint32_t first, uint32_t count) {
+    if (s_timestampPool) vkCmdResetQueryPool(cmd, s_timestampPool, slot * TIMESTAMP_STAMPS + first, count);
+}
 
-    VkMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
-    barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+// ============== ASYNC COMPUTE ==============
+// Compute pool, command buffers and compute-done semaphores for --async-compute.
+// The BLAS and instance buffers were last used by the graphics queue during
+// init, so with separate families their ownership is handed to the compute
+// family once here. The output images start from UNDEFINED every frame and the
+// TLAS is fully rebuilt, so those need no transfer on the way in.
+static bool InitAsyncCompute() {
+    if (s_computePipeline == VK_NULL_HANDLE) return false;
+    if (s_computeQueue == VK_NULL_HANDLE || s_computeQueue == s_graphicsQueue) {
+        Log("[VkRQ] Async compute: no queue besides the graphics queue\n");
+        return false;
+    }
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = s_computeFamily;
+    if (vkCreateCommandPool(s_device, &poolInfo, nullptr, &s_computeCommandPool) != VK_SUCCESS) {
+        Log("[VkRQ] ERROR: Failed to create compute command pool\n");
+        return false;
+    }
+
+    VkCommandBufferAllocateInfo cmdAllocInfo = {};
+    cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    cmdAllocInfo.commandPool = s_computeCommandPool;
+    cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAllocInfo.commandBufferCount = FRAME_COUNT;
+    if (vkAllocateCommandBuffers(s_device, &cmdAllocInfo, s_computeCommandBuffers) != VK_SUCCESS) {
+        Log("[VkRQ] ERROR: Failed to allocate compute command buffers\n");
+        return false;
+    }
+
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_computeDoneSemaphores[f]) != VK_SUCCESS) {
+            Log("[VkRQ] ERROR: Failed to create compute-done semaphores\n");
+            return false;
+        }
+    }
+
+    if (s_computeFamily != s_graphicsFamily) {
+        std::vector<VkBufferMemoryBarrier> barriers;
+        auto addBuffer = [&](VkBuffer buffer) {
+            if (!buffer) return;
+            VkBufferMemoryBarrier b = {};
+            b.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            b.srcQueueFamilyIndex = s_graphicsFamily;
+            b.dstQueueFamilyIndex = s_computeFamily;
+            b.buffer = buffer;
+            b.offset = 0;
+            b.size = VK_WHOLE_SIZE;
+            barriers.push_back(b);
+        };
+        addBuffer(s_blasStaticBuffer);
+        addBuffer(s_blasCubesBuffer);
+        for (uint32_t f = 0; f < FRAME_COUNT; f++) addBuffer(s_instanceBuffer[f]);
+
+        // Release on the graphics queue (waits idle)
+        for (auto& b : barriers) { b.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR; b.dstAccessMask = 0; }
+        VkCommandBuffer cmd = BeginSingleTimeCommands();
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0, 0, nullptr, (uint32_t)barriers.size(), barriers.data(), 0, nullptr);
+        EndSingleTimeCommands(cmd);
+
+        // Acquire on the compute queue
+        for (auto& b : barriers) { b.srcAccessMask = 0; b.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_SHADER_READ_BIT; }
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        VkCommandBuffer acquire = s_computeCommandBuffers[0];
+        vkBeginCommandBuffer(acquire, &beginInfo);
+        vkCmdPipelineBarrier(acquire, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                             VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, (uint32_t)barriers.size(), barriers.data(), 0, nullptr);
+        vkEndCommandBuffer(acquire);
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &acquire;
+        vkQueueSubmit(s_computeQueue, 1, &submitInfo, VK_NULL_HANDLE);
+        vkQueueWaitIdle(s_computeQueue);
+    }
+
+    s_asyncCompute = true;
+    Log("[VkRQ] Async compute enabled (%s)\n",
+        s_computeFamily != s_graphicsFamily ? "separate queue family, ownership transfers" : "second graphics-family queue");
+    return true;
+}
+
+// Records TLAS rebuild + ray query dispatch into the frame's output image and
+// leaves it in TRANSFER_SRC. In async mode this is the compute command buffer:
+// the final barrier is the release half of the ownership transfer and the
+// graphics queue is ordered after it by s_computeDoneSemaphores.
+static void RecordTrace(VkCommandBuffer cmd, uint32_t frame) {
+    ResetTimestamps(cmd, frame, 0, 3);
+    WriteTimestamp(cmd, frame, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    RebuildTLAS(cmd, frame);
+    WriteTimestamp(cmd, frame, 1, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR);
+
+    // Transition output image to general for compute shader write
+    VkImageMemoryBarrier outputBarrier = {};
+    outputBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    outputBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    outputBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    outputBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    outputBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    outputBarrier.image = s_outputImage[frame];
+    outputBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    outputBarrier.subresourceRange.baseMipLevel = 0;
+    outputBarrier.subresourceRange.levelCount = 1;
+    outputBarrier.subresourceRange.baseArrayLayer = 0;
+    outputBarrier.subresourceRange.layerCount = 1;
+    outputBarrier.srcAccessMask = 0;
+    outputBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &outputBarrier);
+
+    // Accumulation sum: cleared on the first sample, otherwise the previous
+    // dispatch's read-modify-write has to finish first
+    if (s_accumulate) {
+        VkImageMemoryBarrier accumBarrier = outputBarrier;
+        accumBarrier.image = s_accumImage;
+        accumBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        if (s_accumFrame[frame] == 1) {
+            // Old contents are discarded anyway, so UNDEFINED also covers the first use
+            accumBarrier.srcAccessMask = 0;
+            accumBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &accumBarrier);
+            VkClearColorValue zero = {};
+            vkCmdClearColorImage(cmd, s_accumImage, VK_IMAGE_LAYOUT_GENERAL, &zero, 1, &accumBarrier.subresourceRange);
+            accumBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+            accumBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            accumBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &accumBarrier);
+        } else {
+            accumBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+            accumBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &accumBarrier);
+        }
+    }
+
+    // Bind compute pipeline (the --group-size variant) and dispatch
+    UINT variant = GroupTuneSelect(GROUP_KERNEL_VK_RQ, frame);
+    if (!s_computeVariants[variant]) variant = GROUP_VARIANT_DEFAULT;
+    const GroupShape& shape = GroupVariant(variant);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, s_computeVariants[variant] ? s_computeVariants[variant] : s_computePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, s_computePipelineLayout, 0, 1, &s_computeDescSet[frame], 0, nullptr);
+
+    // Dispatch: 8x8 workgroups unless --group-size
+    uint32_t groupsX = (s_traceExtent.width + shape.x - 1) / shape.x;
+    uint32_t groupsY = (s_traceExtent.height + shape.y - 1) / shape.y;
+    vkCmdDispatch(cmd, groupsX, groupsY, 1);
+    WriteTimestamp(cmd, frame, 2, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    // Transition output image to transfer src
+    outputBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    outputBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    outputBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    if (s_asyncCompute) {
+        // Visibility for the copy comes from the semaphore (and the acquire barrier)
+        if (s_computeFamily != s_graphicsFamily) {
+            outputBarrier.srcQueueFamilyIndex = s_computeFamily;
+            outputBarrier.dstQueueFamilyIndex = s_graphicsFamily;
+        }
+        outputBarrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &outputBarrier);
+    } else {
+        outputBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &outputBarrier);
+    }
+}
+
+// ============== SYNC OBJECTS ==============
+// One render-finished semaphore per swapchain image (count can change on resize)
+static void DestroyRenderFinishedSemaphores() {
+    for (VkSemaphore sem : s_renderFinishedSemaphores) vkDestroySemaphore(s_device, sem, nullptr);
+    s_renderFinishedSemaphores.clear();
+}
+
+static bool CreateRenderFinishedSemaphores() {
+    DestroyRenderFinishedSemaphores();
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    s_renderFinishedSemaphores.resize(s_swapchainImages.size(), VK_NULL_HANDLE);
+    for (VkSemaphore& sem : s_renderFinishedSemaphores) {
+        if (vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &sem) != VK_SUCCESS) {
+            Log("[VkRQ] ERROR: Failed to create render-finished semaphores\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============== SWAPCHAIN ==============
+// Creates swapchain + image views at the current surface size (W/H fallback).
+// Also used by ResizeVulkanRQ, passing the old swapchain for recycling.
+static bool CreateSwapchainRQ(VkSwapchainKHR oldSwapchain) {
+    VkSurfaceCapabilitiesKHR surfaceCaps = {};
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(s_physicalDevice, s_surface, &surfaceCaps);
+    s_swapchainExtent = {W, H};
+    if (surfaceCaps.currentExtent.width != UINT32_MAX && surfaceCaps.currentExtent.width > 0) {
+        s_swapchainExtent = surfaceCaps.currentExtent;
+        W = s_swapchainExtent.width;
+        H = s_swapchainExtent.height;
+    }
+    s_traceExtent = {RENDER_SCALED(s_swapchainExtent.width), RENDER_SCALED(s_swapchainExtent.height)};
+
+    uint32_t imageCount = surfaceCaps.minImageCount + 1;
+    if (surfaceCaps.maxImageCount > 0 && imageCount > surfaceCaps.maxImageCount) imageCount = surfaceCaps.maxImageCount;
+
+    VkSwapchainCreateInfoKHR swapchainInfo = {};
+    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    swapchainInfo.surface = s_surface;
+    swapchainInfo.minImageCount = imageCount;
+    swapchainInfo.imageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+    swapchainInfo.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    swapchainInfo.imageExtent = s_swapchainExtent;
+    swapchainInfo.imageArrayLayers = 1;
+    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    swapchainInfo.preTransform = surfaceCaps.currentTransform;
+    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapchainInfo.presentMode = s_presentMode;
+    swapchainInfo.clipped = VK_TRUE;
+    swapchainInfo.oldSwapchain = oldSwapchain;
+
+    VkSwapchainKHR newSwapchain = VK_NULL_HANDLE;
+    VkResult res = VkPresentCreateSwapchain(s_device, swapchainInfo, &newSwapchain);
+    if (oldSwapchain) VkPresentDestroySwapchain(s_device, oldSwapchain);
+    s_swapchain = newSwapchain;
+    if (res != VK_SUCCESS) {
+        Log("[VkRQ] ERROR: Failed to create swapchain\n");
+        return false;
+    }
+    Log("[VkRQ] Swapchain created (%ux%u)\n", s_swapchainExtent.width, s_swapchainExtent.height);
+
+    VkPresentGetImages(s_device, s_swapchain, &imageCount, nullptr);
+    s_swapchainImages.resize(imageCount);
+    VkPresentGetImages(s_device, s_swapchain, &imageCount, s_swapchainImages.data());
+    s_swapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
+
+    s_swapchainImageViews.resize(imageCount);
+    for (uint32_t i = 0; i < imageCount; i++) {
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = s_swapchainImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = s_swapchainFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        vkCreateImageView(s_device, &viewInfo, nullptr, &s_swapchainImageViews[i]);
+    }
+    return true;
 }
 
 // ============== CREATE OUTPUT IMAGE ==============
+// Each frame transitions its image from UNDEFINED before the dispatch, so no
+// initial layout transition (or queue family ownership) is needed here
+static void DestroyOutputImages() {
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (s_outputImageView[f]) { vkDestroyImageView(s_device, s_outputImageView[f], nullptr); s_outputImageView[f] = VK_NULL_HANDLE; }
+        if (s_outputImage[f]) { vkDestroyImage(s_device, s_outputImage[f], nullptr); s_outputImage[f] = VK_NULL_HANDLE; }
+        VkMemFree(s_outputMemory[f]);
+    }
+}
+
 static bool CreateOutputImage() {
-    Log("[VkRQ] Creating output image...\n");
+    Log("[VkRQ] Creating output images...\n");
     VkImageCreateInfo imageInfo = {};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
     imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-    imageInfo.extent = {s_swapchainExtent.width, s_swapchainExtent.height, 1};
+    imageInfo.extent = {s_traceExtent.width, s_traceExtent.height, 1};
     imageInfo.mipLevels = 1;
     imageInfo.arrayLayers = 1;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    // The shader stores BGR into the rgba8 view for the raw copy; a blit
+    // converts channels, so the image itself is BGRA (storage via the view).
+    // B8G8R8A8 isn't a storage format everywhere: EXTENDED_USAGE lets the
+    // STORAGE usage rest on the listed RGBA8 view format (core in 1.2).
+    VkFormat viewFormats[2] = { VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM };
+    VkImageFormatListCreateInfo formatList = {};
+    formatList.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO;
+    formatList.viewFormatCount = 2;
+    formatList.pViewFormats = viewFormats;
+    if (g_renderScalePct < 100) {
+        imageInfo.pNext = &formatList;
+        imageInfo.format = VK_FORMAT_B8G8R8A8_UNORM;
+        imageInfo.flags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+    }
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-    if (vkCreateImage(s_device, &imageInfo, nullptr, &s_outputImage) != VK_SUCCESS) {
-        Log("[VkRQ] ERROR: Failed to create output image\n");
-        return false;
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (vkCreateImage(s_device, &imageInfo, nullptr, &s_outputImage[f]) != VK_SUCCESS) {
+            Log("[VkRQ] ERROR: Failed to create output image\n");
+            return false;
+        }
+
+        if (!VkMemAllocImage(s_outputImage[f], VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_outputMemory[f])) {
+            Log("[VkRQ] ERROR: Failed to allocate output image memory\n");
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = s_outputImage[f];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(s_device, &viewInfo, nullptr, &s_outputImageView[f]) != VK_SUCCESS) {
+            Log("[VkRQ] ERROR: Failed to create output image view\n");
+            return false;
+        }
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(s_device, s_outputImage, &memReqs);
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    if (vkAllocateMemory(s_device, &allocInfo, nullptr, &s_outputMemory) != VK_SUCCESS) {
-        Log("[VkRQ] ERROR: Failed to allocate output image memory\n");
+    Log("[VkRQ] Output images created (%ux%u x%u frames in flight)\n", s_traceExtent.width, s_traceExtent.height, FRAME_COUNT);
+    return true;
+}
+
+// --accumulate sum image. Left UNDEFINED: the first sample's frame transitions
+// it to GENERAL and clears it on the queue that traces (see RecordTrace).
+static void DestroyAccumImage() {
+    if (s_accumImageView) { vkDestroyImageView(s_device, s_accumImageView, nullptr); s_accumImageView = VK_NULL_HANDLE; }
+    if (s_accumImage) { vkDestroyImage(s_device, s_accumImage, nullptr); s_accumImage = VK_NULL_HANDLE; }
+    VkMemFree(s_accumMemory);
+}
+
+static bool CreateAccumImage() {
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    imageInfo.extent = {s_traceExtent.width, s_traceExtent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (vkCreateImage(s_device, &imageInfo, nullptr, &s_accumImage) != VK_SUCCESS) {
+        Log("[VkRQ] ERROR: Failed to create accumulation image\n");
+        return false;
+    }
+    if (!VkMemAllocImage(s_accumImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_accumMemory)) {
+        Log("[VkRQ] ERROR: Failed to allocate accumulation image memory\n");
         return false;
     }
-    vkBindImageMemory(s_device, s_outputImage, s_outputMemory, 0);
 
     VkImageViewCreateInfo viewInfo = {};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = s_outputImage;
+    viewInfo.image = s_accumImage;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    viewInfo.format = VK_FORMAT_R32G32B32A32_SFLOAT;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel = 0;
     viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
-    if (vkCreateImageView(s_device, &viewInfo, nullptr, &s_outputImageView) != VK_SUCCESS) {
-        Log("[VkRQ] ERROR: Failed to create output image view\n");
+    if (vkCreateImageView(s_device, &viewInfo, nullptr, &s_accumImageView) != VK_SUCCESS) {
+        Log("[VkRQ] ERROR: Failed to create accumulation image view\n");
         return false;
     }
-
-    VkCommandBuffer cmd = BeginSingleTimeCommands();
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = s_outputImage;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = 0;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         0, 0, nullptr, 0, nullptr, 1, &barrier);
-    EndSingleTimeCommands(cmd);
-
-    Log("[VkRQ] Output image created (%ux%u)\n", s_swapchainExtent.width, s_swapchainExtent.height);
+    AccumRestart();   // The new image holds no samples
     return true;
 }
 
+// Binding 3 of every frame's set (the shared accumulation image)
+static void WriteAccumDescriptors() {
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageView = s_accumImageView;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = s_computeDescSet[f];
+        write.dstBinding = 3;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(s_device, 1, &write, 0, nullptr);
+    }
+}
+
 // ============== CREATE UNIFORM BUFFER ==============
 static bool CreateUniformBuffer() {
     VkDeviceSize bufferSize = sizeof(VkRQUniforms);
-    CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 s_uniformBuffer, s_uniformMemory);
-    vkMapMemory(s_device, s_uniformMemory, 0, bufferSize, 0, &s_uniformMapped);
-    VkRQUniforms* uniforms = (VkRQUniforms*)s_uniformMapped;
-    uniforms->time = 0.0f;
-    uniforms->lightPos[0] = 0.0f;
-    uniforms->lightPos[1] = 0.92f;
-    uniforms->lightPos[2] = 0.0f;
-    uniforms->lightRadius = g_vulkanRTFeatures.lightRadius;
-    uniforms->frameCount = 0;
-    uniforms->shadowSamples = g_vulkanRTFeatures.shadowSamples;
-    uniforms->aoSamples = g_vulkanRTFeatures.aoSamples;
-    uniforms->aoRadius = g_vulkanRTFeatures.aoRadius;
-
-    // Build features bitmask from g_vulkanRTFeatures
-    uint32_t features = 0;
-    if (g_vulkanRTFeatures.spotlight)        features |= 0x01;
-    if (g_vulkanRTFeatures.softShadows)      features |= 0x02;
-    if (g_vulkanRTFeatures.ambientOcclusion) features |= 0x04;
-    if (g_vulkanRTFeatures.globalIllum)      features |= 0x08;
-    if (g_vulkanRTFeatures.reflections)      features |= 0x10;
-    if (g_vulkanRTFeatures.glassRefraction)  features |= 0x20;
-    uniforms->features = features;
-
-    Log("[VkRQ] Uniform buffer created (features=0x%02X)\n", features);
+
+    // Features bitmask - the pipeline is specialized on it, the overlay reads it back
+    uint32_t features = g_vulkanRTFeatures.Bits();
+
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (!CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          s_uniformBuffer[f], s_uniformMemory[f], true)) {
+            Log("[VkRQ] ERROR: Failed to create uniform buffer\n");
+            return false;
+        }
+        s_uniformMapped[f] = s_uniformMemory[f].mapped;
+        VkRQUniforms* uniforms = (VkRQUniforms*)s_uniformMapped[f];
+        uniforms->time = 0.0f;
+        uniforms->lightPos[0] = 0.0f;
+        uniforms->lightPos[1] = 0.92f;
+        uniforms->lightPos[2] = 0.0f;
+        uniforms->lightRadius = g_vulkanRTFeatures.lightRadius;
+        uniforms->frameCount = 0;
+        uniforms->shadowSamples = g_vulkanRTFeatures.shadowSamples;
+        uniforms->aoSamples = g_vulkanRTFeatures.aoSamples;
+        uniforms->aoRadius = g_vulkanRTFeatures.aoRadius;
+        uniforms->features = features;
+    }
+
+    Log("[VkRQ] Uniform buffers created (x%u, features=0x%02X)\n", FRAME_COUNT, features);
     return true;
 }
 
@@ -886,11 +1280,50 @@ static VkShaderModule CreateShaderModule(const uint32_t* code, size_t codeSize)
     return shaderModule;
 }
 
+// --group-size: every variant of mask besides the default, from the module
+// code and specialization of the default pipeline
+static void CreateComputeVariants(const std::vector<uint32_t>& code, const VkSpecFeatures& spec, UINT mask) {
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) s_computeVariants[v] = VK_NULL_HANDLE;
+    s_computeVariants[GROUP_VARIANT_DEFAULT] = s_computePipeline;
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) {
+        if (v == GROUP_VARIANT_DEFAULT || !(mask & (1u << v))) continue;
+        const GroupShape& shape = GroupVariant(v);
+        std::vector<uint32_t> variantCode;
+        VkShaderModule module = VK_NULL_HANDLE;
+        if (VkSpirvSetLocalSize(code.data(), code.size() * sizeof(uint32_t), shape.x, shape.y, variantCode))
+            module = CreateShaderModule(variantCode.data(), variantCode.size() * sizeof(uint32_t));
+        if (module) {
+            VkPipelineShaderStageRequiredSubgroupSizeCreateInfoEXT subgroupSize = {};
+            subgroupSize.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO_EXT;
+            subgroupSize.requiredSubgroupSize = shape.wave;
+            VkComputePipelineCreateInfo pipelineInfo = {};
+            pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            pipelineInfo.stage.pNext = shape.wave ? &subgroupSize : nullptr;
+            pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+            pipelineInfo.stage.module = module;
+            pipelineInfo.stage.pName = "main";
+            pipelineInfo.stage.pSpecializationInfo = &spec.info;
+            pipelineInfo.layout = s_computePipelineLayout;
+            if (vkCreateComputePipelines(s_device, s_pipelineCache, 1, &pipelineInfo, nullptr, &s_computeVariants[v]) != VK_SUCCESS)
+                s_computeVariants[v] = VK_NULL_HANDLE;
+            vkDestroyShaderModule(s_device, module, nullptr);
+        }
+        if (!s_computeVariants[v]) {
+            Log("[VkRQ] WARNING: --group-size %s pipeline failed, variant skipped\n", shape.name);
+            GroupTuneDrop(GROUP_KERNEL_VK_RQ, v);
+        }
+    }
+}
+
 static bool CreateComputePipeline() {
     Log("[VkRQ] Creating compute pipeline...\n");
 
+    // --accumulate adds the sum image at binding 3 (needs the embedded SPIR-V to patch)
+    bool accumulate = g_accumTargetSpp > 0 && g_rqComputeSPIRV_available;
+
     // Create descriptor set layout
-    VkDescriptorSetLayoutBinding bindings[3] = {};
+    VkDescriptorSetLayoutBinding bindings[4] = {};
     bindings[0].binding = 0;
     bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
     bindings[0].descriptorCount = 1;
@@ -903,10 +1336,14 @@ static bool CreateComputePipeline() {
     bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     bindings[2].descriptorCount = 1;
     bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[3].binding = 3;
+    bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[3].descriptorCount = 1;
+    bindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
     VkDescriptorSetLayoutCreateInfo layoutInfo = {};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 3;
+    layoutInfo.bindingCount = accumulate ? 4 : 3;
     layoutInfo.pBindings = bindings;
     if (vkCreateDescriptorSetLayout(s_device, &layoutInfo, nullptr, &s_computeDescSetLayout) != VK_SUCCESS) {
         Log("[VkRQ] ERROR: Failed to create descriptor set layout\n");
@@ -916,14 +1353,14 @@ static bool CreateComputePipeline() {
     // Create descriptor pool
     VkDescriptorPoolSize poolSizes[3] = {};
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
-    poolSizes[0].descriptorCount = 1;
+    poolSizes[0].descriptorCount = FRAME_COUNT;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    poolSizes[1].descriptorCount = 1;
+    poolSizes[1].descriptorCount = FRAME_COUNT * (accumulate ? 2 : 1);
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[2].descriptorCount = 1;
+    poolSizes[2].descriptorCount = FRAME_COUNT;
     VkDescriptorPoolCreateInfo poolInfo = {};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.maxSets = 1;
+    poolInfo.maxSets = FRAME_COUNT;
     poolInfo.poolSizeCount = 3;
     poolInfo.pPoolSizes = poolSizes;
     if (vkCreateDescriptorPool(s_device, &poolInfo, nullptr, &s_computeDescPool) != VK_SUCCESS) {
@@ -931,50 +1368,58 @@ static bool CreateComputePipeline() {
         return false;
     }
 
-    // Allocate descriptor set
+    // Allocate one descriptor set per frame slot
+    VkDescriptorSetLayout layouts[FRAME_COUNT];
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) layouts[f] = s_computeDescSetLayout;
     VkDescriptorSetAllocateInfo allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = s_computeDescPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &s_computeDescSetLayout;
-    if (vkAllocateDescriptorSets(s_device, &allocInfo, &s_computeDescSet) != VK_SUCCESS) {
+    allocInfo.descriptorSetCount = FRAME_COUNT;
+    allocInfo.pSetLayouts = layouts;
+    if (vkAllocateDescriptorSets(s_device, &allocInfo, s_computeDescSet) != VK_SUCCESS) {
         Log("[VkRQ] ERROR: Failed to allocate descriptor set\n");
         return false;
     }
 
-    // Update descriptors
-    VkWriteDescriptorSetAccelerationStructureKHR asWrite = {};
-    asWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
-    asWrite.accelerationStructureCount = 1;
-    asWrite.pAccelerationStructures = &s_tlas;
-    VkDescriptorImageInfo imageInfo = {};
-    imageInfo.imageView = s_outputImageView;
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    VkDescriptorBufferInfo bufferInfo = {};
-    bufferInfo.buffer = s_uniformBuffer;
-    bufferInfo.offset = 0;
-    bufferInfo.range = sizeof(VkRQUniforms);
-
-    VkWriteDescriptorSet writes[3] = {};
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].pNext = &asWrite;
-    writes[0].dstSet = s_computeDescSet;
-    writes[0].dstBinding = 0;
-    writes[0].descriptorCount = 1;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = s_computeDescSet;
-    writes[1].dstBinding = 1;
-    writes[1].descriptorCount = 1;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    writes[1].pImageInfo = &imageInfo;
-    writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[2].dstSet = s_computeDescSet;
-    writes[2].dstBinding = 2;
-    writes[2].descriptorCount = 1;
-    writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[2].pBufferInfo = &bufferInfo;
-    vkUpdateDescriptorSets(s_device, 3, writes, 0, nullptr);
+    // Update descriptors (TLAS, output image and uniforms of that frame slot)
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        VkWriteDescriptorSetAccelerationStructureKHR asWrite = {};
+        asWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
+        asWrite.accelerationStructureCount = 1;
+        asWrite.pAccelerationStructures = &s_tlas[f];
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageView = s_outputImageView[f];
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = s_uniformBuffer[f];
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(VkRQUniforms);
+
+        VkWriteDescriptorSet writes[3] = {};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].pNext = &asWrite;
+        writes[0].dstSet = s_computeDescSet[f];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorCount = 1;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = s_computeDescSet[f];
+        writes[1].dstBinding = 1;
+        writes[1].descriptorCount = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &imageInfo;
+        writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[2].dstSet = s_computeDescSet[f];
+        writes[2].dstBinding = 2;
+        writes[2].descriptorCount = 1;
+        writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writes[2].pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(s_device, 3, writes, 0, nullptr);
+    }
+    if (accumulate) {
+        if (!CreateAccumImage()) return false;
+        WriteAccumDescriptors();
+    }
 
     // Create pipeline layout
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
@@ -995,18 +1440,37 @@ static bool CreateComputePipeline() {
         return true;
     }
 
-    // Create shader module from pre-compiled SPIR-V
+    // Create shader module from pre-compiled SPIR-V, specialized on the feature set (vk_specialize.h)
+    std::vector<uint32_t> computeCode;
+    bool specialized = VkSpirvSpecializeMember(g_rqComputeSPIRV, g_rqComputeSPIRV_size, "features",
+                                               VK_SPEC_ID_FEATURES, g_vulkanRTFeatures.Bits(), computeCode);
+    VkSpecFeatures computeSpec;
+    VkSpecFeaturesInit(computeSpec, g_vulkanRTFeatures.Bits());
+    Log("[VkRQ] Compute feature set 0x%02X (%s)\n", computeSpec.value,
+        specialized ? "specialization constant patched in" : "SPIR-V declares it");
+    if (accumulate) {
+        std::vector<uint32_t> accumCode;
+        s_accumulate = VkSpirvAccumulateImageStore(computeCode.data(), computeCode.size() * sizeof(uint32_t), 0, 3, accumCode);
+        if (s_accumulate) {
+            computeCode.swap(accumCode);
+            Log("[VkRQ] Accumulation enabled (%ux%u rgba32f sum, target %u SPP)\n",
+                s_swapchainExtent.width, s_swapchainExtent.height, g_accumTargetSpp);
+        } else {
+            Log("[VkRQ] WARNING: --accumulate: output store not found in the compute SPIR-V, accumulation off\n");
+        }
+    }
+
     VkShaderModuleCreateInfo shaderModuleInfo = {};
     shaderModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    shaderModuleInfo.codeSize = g_rqComputeSPIRV_size;
-    shaderModuleInfo.pCode = g_rqComputeSPIRV;
+    shaderModuleInfo.codeSize = computeCode.size() * sizeof(uint32_t);
+    shaderModuleInfo.pCode = computeCode.data();
 
     VkShaderModule computeShader = VK_NULL_HANDLE;
     if (vkCreateShaderModule(s_device, &shaderModuleInfo, nullptr, &computeShader) != VK_SUCCESS) {
         Log("[VkRQ] ERROR: Failed to create compute shader module\n");
         return false;
     }
-    Log("[VkRQ] Compute shader module created (%zu bytes SPIR-V)\n", g_rqComputeSPIRV_size);
+    Log("[VkRQ] Compute shader module created (%zu bytes SPIR-V)\n", shaderModuleInfo.codeSize);
 
     // Create compute pipeline
     VkPipelineShaderStageCreateInfo stageInfo = {};
@@ -1014,13 +1478,14 @@ static bool CreateComputePipeline() {
     stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
     stageInfo.module = computeShader;
     stageInfo.pName = "main";
+    stageInfo.pSpecializationInfo = &computeSpec.info;
 
     VkComputePipelineCreateInfo pipelineInfo = {};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipelineInfo.stage = stageInfo;
     pipelineInfo.layout = s_computePipelineLayout;
 
-    VkResult result = vkCreateComputePipelines(s_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &s_computePipeline);
+    VkResult result = vkCreateComputePipelines(s_device, s_pipelineCache, 1, &pipelineInfo, nullptr, &s_computePipeline);
     vkDestroyShaderModule(s_device, computeShader, nullptr);  // No longer needed after pipeline creation
 
     if (result != VK_SUCCESS) {
@@ -1028,6 +1493,9 @@ static bool CreateComputePipeline() {
         return false;
     }
     Log("[VkRQ] Compute pipeline created successfully\n");
+
+    UINT groupMask = GroupTuneBegin(GROUP_KERNEL_VK_RQ, s_subgroupSizeMin, s_subgroupSizeMax);
+    CreateComputeVariants(computeCode, computeSpec, groupMask);
     return true;
 }
 
@@ -1135,7 +1603,7 @@ static bool InitTextResources() {
 
     // Staging buffer
     VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
+    VkMemAlloc stagingMemory;
     VkDeviceSize imageSize = FONT_TEX_W * FONT_TEX_H * 4;
     if (!CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
@@ -1143,10 +1611,7 @@ static bool InitTextResources() {
         Log("[VkRQ] Failed to create font staging buffer\n");
         return false;
     }
-    void* data;
-    vkMapMemory(s_device, stagingMemory, 0, imageSize, 0, &data);
-    memcpy(data, fontData.data(), imageSize);
-    vkUnmapMemory(s_device, stagingMemory);
+    memcpy(stagingMemory.mapped, fontData.data(), imageSize);
 
     // Font image
     VkImageCreateInfo imgInfo = {};
@@ -1163,22 +1628,17 @@ static bool InitTextResources() {
 
     if (vkCreateImage(s_device, &imgInfo, nullptr, &s_fontImage) != VK_SUCCESS) {
         vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-        vkFreeMemory(s_device, stagingMemory, nullptr);
+        VkMemFree(stagingMemory);
         return false;
     }
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(s_device, s_fontImage, &memReqs);
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    if (vkAllocateMemory(s_device, &allocInfo, nullptr, &s_fontMemory) != VK_SUCCESS) {
+    if (!VkMemAllocImage(s_fontImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_fontMemory)) {
+        Log("[VkRQ] Failed to allocate font memory\n");
         vkDestroyImage(s_device, s_fontImage, nullptr);
+        s_fontImage = VK_NULL_HANDLE;
         vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-        vkFreeMemory(s_device, stagingMemory, nullptr);
+        VkMemFree(stagingMemory);
         return false;
     }
-    vkBindImageMemory(s_device, s_fontImage, s_fontMemory, 0);
 
     // Copy staging to image
     VkCommandBuffer cmdBuf;
@@ -1227,7 +1687,7 @@ static bool InitTextResources() {
     vkQueueWaitIdle(s_graphicsQueue);
     vkFreeCommandBuffers(s_device, s_commandPool, 1, &cmdBuf);
     vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
+    VkMemFree(stagingMemory);
 
     // Image view
     VkImageViewCreateInfo viewInfo = {};
@@ -1343,6 +1803,13 @@ static bool InitTextResources() {
     viewportState.scissorCount = 1;
     viewportState.pScissors = &scissor;
 
+    // Viewport/scissor are set per frame so the pipeline survives resize
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
     VkPipelineRasterizationStateCreateInfo rasterizer = {};
     rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
@@ -1385,11 +1852,12 @@ static bool InitTextResources() {
     pipelineInfo.pMultisampleState = &multisampling;
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = s_textPipelineLayout;
     pipelineInfo.renderPass = s_textRenderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(s_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &s_textPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(s_device, s_pipelineCache, 1, &pipelineInfo, nullptr, &s_textPipeline) != VK_SUCCESS) {
         vkDestroyShaderModule(s_device, textVertShader, nullptr);
         vkDestroyShaderModule(s_device, textFragShader, nullptr);
         return false;
@@ -1398,21 +1866,40 @@ static bool InitTextResources() {
     vkDestroyShaderModule(s_device, textFragShader, nullptr);
 
     // Text vertex buffer
-    VkDeviceSize textBufferSize = sizeof(TextVert) * 6000;
+    VkDeviceSize textBufferSize = sizeof(TextVert) * TEXT_MAX_VERTS * FRAME_COUNT;
     if (!CreateBuffer(textBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                       s_textVertexBuffer, s_textVertexMemory)) return false;
-    if (vkMapMemory(s_device, s_textVertexMemory, 0, textBufferSize, 0, &s_textVertexMapped) != VK_SUCCESS) return false;
+    s_textVertexMapped = s_textVertexMemory.mapped;   // Host-visible blocks stay mapped
+    OverlayInvalidate(s_overlay);
+    memset(s_textSliceVersion, 0, sizeof(s_textSliceVersion));
+    if (!s_textVertexMapped) return false;
 
     Log("[VkRQ] Text rendering initialized\n");
     return true;
 }
 
+// ============== VRAM CATEGORIES ==============
+// Sub-allocated sizes of this renderer's acceleration structures and images (vram_budget.h)
+static void VramCategoriesRQ(UINT64 bytes[VRAM_CATEGORY_COUNT]) {
+    bytes[VRAM_BLAS] += s_blasStaticMemory.size + s_blasCubesMemory.size;
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        bytes[VRAM_TLAS] += s_tlasMemory[f].size + s_instanceMemory[f].size;
+        bytes[VRAM_SCRATCH] += s_tlasScratchMemory[f].size;
+    }
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) bytes[VRAM_GBUFFER] += s_outputMemory[f].size;
+    bytes[VRAM_HISTORY] += s_accumMemory.size;
+}
+
 // ============== INITIALIZATION ==============
 bool InitVulkanRQ(HWND hwnd) {
     Log("[VkRQ] Initializing Vulkan RayQuery renderer...\n");
+    if (g_renderScalePct < 100)
+        Log("[WARN] VkRQ: --render-scale=%u upscales with a plain bilinear blit - no edge-adaptive upscale or "
+            "sharpen as on D3D12 PT, so image quality is not comparable\n", g_renderScalePct);
 
     // Create Vulkan Instance
+    StartupStep("Instance + device");
     VkApplicationInfo appInfo = {};
     appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
     appInfo.pApplicationName = "RenderTestGPU - Vulkan RQ";
@@ -1481,22 +1968,38 @@ bool InitVulkanRQ(HWND hwnd) {
     for (uint32_t i = 0; i < queueFamilyCount; i++) {
         if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) s_graphicsFamily = i;
         if (queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) s_computeFamily = i;
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(s_physicalDevice, i, s_surface, &presentSupport);
+        VkBool32 presentSupport = VkPresentFamilySupported(s_physicalDevice, i, s_surface, queueFamilies[i].queueFlags);
         if (presentSupport) s_presentFamily = i;
         if (s_graphicsFamily != UINT32_MAX && s_presentFamily != UINT32_MAX && s_computeFamily != UINT32_MAX) break;
     }
 
+    // Async compute wants a compute-only family (the dedicated async queues on
+    // AMD / NVIDIA); otherwise a second queue of the graphics family
+    s_computeQueueIndex = 0;
+    if (g_asyncCompute) {
+        for (uint32_t i = 0; i < queueFamilyCount; i++) {
+            if ((queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                s_computeFamily = i;
+                break;
+            }
+        }
+        if (s_computeFamily == s_graphicsFamily && queueFamilies[s_graphicsFamily].queueCount > 1) s_computeQueueIndex = 1;
+        Log("[VkRQ] Async compute: queue family %u index %u (graphics family %u)\n",
+            s_computeFamily, s_computeQueueIndex, s_graphicsFamily);
+    }
+
     // Create Logical Device with RayQuery extensions
-    float queuePriority = 1.0f;
+    float queuePriorities[2] = {1.0f, 1.0f};
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+    s_transferFamily = VkUploadFindTransferFamily(s_physicalDevice);
     std::set<uint32_t> uniqueQueueFamilies = {s_graphicsFamily, s_presentFamily, s_computeFamily};
+    if (s_transferFamily != UINT32_MAX) uniqueQueueFamilies.insert(s_transferFamily);
     for (uint32_t queueFamily : uniqueQueueFamilies) {
         VkDeviceQueueCreateInfo queueCreateInfo = {};
         queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         queueCreateInfo.queueFamilyIndex = queueFamily;
-        queueCreateInfo.queueCount = 1;
-        queueCreateInfo.pQueuePriorities = &queuePriority;
+        queueCreateInfo.queueCount = (queueFamily == s_computeFamily) ? s_computeQueueIndex + 1 : 1;
+        queueCreateInfo.pQueuePriorities = queuePriorities;
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
@@ -1552,6 +2055,35 @@ bool InitVulkanRQ(HWND hwnd) {
     deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
     deviceFeatures2.pNext = &accelStructFeatures;
 
+    // VK_EXT_subgroup_size_control: lets the --group-size wave variants force a subgroup size
+    s_subgroupSizeMin = s_subgroupSizeMax = 0;
+    if (hasExt(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME)) {
+        s_subgroupSizeFeatures = {};
+        s_subgroupSizeFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT;
+        VkPhysicalDeviceFeatures2 queryFeatures = {};
+        queryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        queryFeatures.pNext = &s_subgroupSizeFeatures;
+        vkGetPhysicalDeviceFeatures2(s_physicalDevice, &queryFeatures);
+        VkPhysicalDeviceSubgroupSizeControlPropertiesEXT sizeProps = {};
+        sizeProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 props2 = {};
+        props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        props2.pNext = &sizeProps;
+        vkGetPhysicalDeviceProperties2(s_physicalDevice, &props2);
+        if (s_subgroupSizeFeatures.subgroupSizeControl && (sizeProps.requiredSubgroupSizeStages & VK_SHADER_STAGE_COMPUTE_BIT)) {
+            deviceExtensions.push_back(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
+            s_subgroupSizeFeatures.computeFullSubgroups = VK_FALSE;
+            s_subgroupSizeFeatures.pNext = deviceFeatures2.pNext;
+            deviceFeatures2.pNext = &s_subgroupSizeFeatures;
+            s_subgroupSizeMin = sizeProps.minSubgroupSize;
+            s_subgroupSizeMax = sizeProps.maxSubgroupSize;
+            Log("[VkRQ] Subgroup size control: %u-%u lanes\n", s_subgroupSizeMin, s_subgroupSizeMax);
+        }
+    }
+
+    VkPresentWaitEnable(s_physicalDevice, deviceExtensions, &deviceFeatures2.pNext, "Vulkan RQ");
+    VkMemBudgetEnable(s_physicalDevice, deviceExtensions);
+
     VkDeviceCreateInfo deviceInfo = {};
     deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     deviceInfo.pNext = &deviceFeatures2;
@@ -1568,7 +2100,11 @@ bool InitVulkanRQ(HWND hwnd) {
 
     vkGetDeviceQueue(s_device, s_graphicsFamily, 0, &s_graphicsQueue);
     vkGetDeviceQueue(s_device, s_presentFamily, 0, &s_presentQueue);
-    vkGetDeviceQueue(s_device, s_computeFamily, 0, &s_computeQueue);
+    VkPresentWaitInit(s_device);
+    VkMemInit(s_physicalDevice, s_device, true, "VkRQ");
+    s_pipelineCache = VkPipelineCacheLoad(s_physicalDevice, s_device, "rq", "VkRQ");
+    s_presentMode = VkPresentChooseMode(s_physicalDevice, s_surface, VK_PRESENT_MODE_IMMEDIATE_KHR, "Vulkan RQ");
+    vkGetDeviceQueue(s_device, s_computeFamily, s_computeQueueIndex, &s_computeQueue);
 
     if (!LoadRQExtensions()) {
         Log("[VkRQ] ERROR: Failed to load ray query extension functions\n");
@@ -1576,54 +2112,8 @@ bool InitVulkanRQ(HWND hwnd) {
     }
 
     // Create Swapchain
-    VkSurfaceCapabilitiesKHR surfaceCaps;
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(s_physicalDevice, s_surface, &surfaceCaps);
-    s_swapchainExtent = {W, H};
-    if (surfaceCaps.currentExtent.width != UINT32_MAX) s_swapchainExtent = surfaceCaps.currentExtent;
-
-    uint32_t imageCount = surfaceCaps.minImageCount + 1;
-    if (surfaceCaps.maxImageCount > 0 && imageCount > surfaceCaps.maxImageCount) imageCount = surfaceCaps.maxImageCount;
-
-    VkSwapchainCreateInfoKHR swapchainInfo = {};
-    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-    swapchainInfo.surface = s_surface;
-    swapchainInfo.minImageCount = imageCount;
-    swapchainInfo.imageFormat = VK_FORMAT_B8G8R8A8_UNORM;
-    swapchainInfo.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
-    swapchainInfo.imageExtent = s_swapchainExtent;
-    swapchainInfo.imageArrayLayers = 1;
-    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-    swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    swapchainInfo.preTransform = surfaceCaps.currentTransform;
-    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapchainInfo.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
-    swapchainInfo.clipped = VK_TRUE;
-
-    if (vkCreateSwapchainKHR(s_device, &swapchainInfo, nullptr, &s_swapchain) != VK_SUCCESS) {
-        Log("[VkRQ] ERROR: Failed to create swapchain\n");
-        return false;
-    }
-    Log("[VkRQ] Swapchain created (%ux%u)\n", s_swapchainExtent.width, s_swapchainExtent.height);
-
-    vkGetSwapchainImagesKHR(s_device, s_swapchain, &imageCount, nullptr);
-    s_swapchainImages.resize(imageCount);
-    vkGetSwapchainImagesKHR(s_device, s_swapchain, &imageCount, s_swapchainImages.data());
-    s_swapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
-
-    s_swapchainImageViews.resize(imageCount);
-    for (uint32_t i = 0; i < imageCount; i++) {
-        VkImageViewCreateInfo viewInfo = {};
-        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        viewInfo.image = s_swapchainImages[i];
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewInfo.format = s_swapchainFormat;
-        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
-        viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
-        vkCreateImageView(s_device, &viewInfo, nullptr, &s_swapchainImageViews[i]);
-    }
+    StartupStep("Swap chain + frame resources");
+    if (!CreateSwapchainRQ(VK_NULL_HANDLE)) return false;
 
     // Create Command Pool
     VkCommandPoolCreateInfo poolInfo = {};
@@ -1635,13 +2125,12 @@ bool InitVulkanRQ(HWND hwnd) {
         return false;
     }
 
-    s_commandBuffers.resize(imageCount);
     VkCommandBufferAllocateInfo cmdAllocInfo = {};
     cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     cmdAllocInfo.commandPool = s_commandPool;
     cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAllocInfo.commandBufferCount = imageCount;
-    vkAllocateCommandBuffers(s_device, &cmdAllocInfo, s_commandBuffers.data());
+    cmdAllocInfo.commandBufferCount = FRAME_COUNT;
+    vkAllocateCommandBuffers(s_device, &cmdAllocInfo, s_commandBuffers);
 
     // Create Sync Objects
     VkSemaphoreCreateInfo semaphoreInfo = {};
@@ -1649,54 +2138,96 @@ bool InitVulkanRQ(HWND hwnd) {
     VkFenceCreateInfo fenceInfo = {};
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_imageAvailableSemaphore);
-    vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_renderFinishedSemaphore);
-    vkCreateFence(s_device, &fenceInfo, nullptr, &s_inFlightFence);
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_imageAvailableSemaphores[f]);
+        vkCreateFence(s_device, &fenceInfo, nullptr, &s_inFlightFences[f]);
+    }
+    CreateRenderFinishedSemaphores();
 
     gpuName = std::wstring(s_gpuName.begin(), s_gpuName.end());
 
     // Create Resources
+    StartupStep("Geometry + upload");
     if (!CreateGeometryBuffers()) { CleanupVulkanRQ(); return false; }
+    StartupStep("Acceleration structures");
     if (!CreateBLAS(s_staticVertexBuffer, s_staticIndexBuffer, s_staticVertexCount, s_staticIndexCount,
-                    s_blasStatic, s_blasStaticBuffer, s_blasStaticMemory)) { CleanupVulkanRQ(); return false; }
+                    s_staticVertexStride, s_staticIndexType,
+                    s_blasStatic, s_blasStaticBuffer, s_blasStaticMemory, "static")) { CleanupVulkanRQ(); return false; }
     if (!CreateBLAS(s_cubesVertexBuffer, s_cubesIndexBuffer, s_cubesVertexCount, s_cubesIndexCount,
-                    s_blasCubes, s_blasCubesBuffer, s_blasCubesMemory)) { CleanupVulkanRQ(); return false; }
+                    s_cubesVertexStride, s_cubesIndexType,
+                    s_blasCubes, s_blasCubesBuffer, s_blasCubesMemory, "cubes")) { CleanupVulkanRQ(); return false; }
     if (!CreateTLAS()) { CleanupVulkanRQ(); return false; }
+    StartupStep("Output image + pipeline");
     if (!CreateOutputImage()) { CleanupVulkanRQ(); return false; }
     if (!CreateUniformBuffer()) { CleanupVulkanRQ(); return false; }
     if (!CreateComputePipeline()) { CleanupVulkanRQ(); return false; }
+    if (g_asyncCompute && !InitAsyncCompute()) {
+        Log("[VkRQ] WARNING: Async compute unavailable, tracing on the graphics queue\n");
+    }
+    StartupStep("Overlay + timers");
+    CreateTimestampQueryPool();
     if (!InitTextResources()) {
         Log("[VkRQ] WARNING: Text rendering unavailable\n");
     }
 
+    VramSetCategories(VramCategoriesRQ);
     Log("[VkRQ] ===== Vulkan RayQuery fully initialized! =====\n");
     return true;
 }
 
 void RenderVulkanRQ() {
-    vkWaitForFences(s_device, 1, &s_inFlightFence, VK_TRUE, UINT64_MAX);
-    vkResetFences(s_device, 1, &s_inFlightFence);
+    // Wait for the frame that last used this slot (FRAME_COUNT frames ago)
+    uint32_t frame = s_frameCount % FRAME_COUNT;
+    vkWaitForFences(s_device, 1, &s_inFlightFences[frame], VK_TRUE, UINT64_MAX);
+    CollectTimestamps(frame);
+    VkPresentFrameBegin(s_swapchain, FRAME_COUNT);
 
     uint32_t imageIndex;
-    vkAcquireNextImageKHR(s_device, s_swapchain, UINT64_MAX, s_imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    if (VkPresentAcquire(s_device, s_swapchain, s_graphicsQueue, s_imageAvailableSemaphores[frame],
+                         &imageIndex) == VK_ERROR_OUT_OF_DATE_KHR) {
+        ResizeVulkanRQ();
+        return;
+    }
+    vkResetFences(s_device, 1, &s_inFlightFences[frame]);
 
-    LARGE_INTEGER currentTime;
-    QueryPerformanceCounter(&currentTime);
-    float elapsedTime = (float)(currentTime.QuadPart - g_startTime.QuadPart) / (float)g_perfFreq.QuadPart;
+    // Animation time stops while paused (P), which is what lets --accumulate converge
+    float elapsedTime = AnimationTime();
+    s_accumFrame[frame] = s_accumulate ? AccumFrameBegin(elapsedTime, s_traceExtent.width, s_traceExtent.height) : 0;
 
-    VkRQUniforms* uniforms = (VkRQUniforms*)s_uniformMapped;
+    VkRQUniforms* uniforms = (VkRQUniforms*)s_uniformMapped[frame];
     uniforms->time = elapsedTime;
     uniforms->frameCount = s_frameCount;
 
-    UpdateCubeTransform(elapsedTime);
+    UpdateCubeTransform(elapsedTime, frame);
 
-    VkCommandBuffer cmd = s_commandBuffers[imageIndex];
-    vkResetCommandBuffer(cmd, 0);
     VkCommandBufferBeginInfo beginInfo = {};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    // Async: trace on the compute queue first, the graphics submit below waits for it
+    if (s_asyncCompute) {
+        VkCommandBuffer computeCmd = s_computeCommandBuffers[frame];
+        vkResetCommandBuffer(computeCmd, 0);
+        vkBeginCommandBuffer(computeCmd, &beginInfo);
+        RecordTrace(computeCmd, frame);
+        vkEndCommandBuffer(computeCmd);
+
+        VkSubmitInfo computeSubmit = {};
+        computeSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        computeSubmit.commandBufferCount = 1;
+        computeSubmit.pCommandBuffers = &computeCmd;
+        computeSubmit.signalSemaphoreCount = 1;
+        computeSubmit.pSignalSemaphores = &s_computeDoneSemaphores[frame];
+        vkQueueSubmit(s_computeQueue, 1, &computeSubmit, VK_NULL_HANDLE);
+    }
+
+    VkCommandBuffer cmd = s_commandBuffers[frame];
+    vkResetCommandBuffer(cmd, 0);
     vkBeginCommandBuffer(cmd, &beginInfo);
 
-    RebuildTLAS(cmd);
+    if (s_computePipeline != VK_NULL_HANDLE && !s_asyncCompute) RecordTrace(cmd, frame);
+    else if (s_computePipeline == VK_NULL_HANDLE) RebuildTLAS(cmd, frame);
+    ResetTimestamps(cmd, frame, 3, 2);
+    WriteTimestamp(cmd, frame, 3, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
 
     // Transition swapchain to transfer dst
     VkImageMemoryBarrier swapBarrier = {};
@@ -1713,60 +2244,56 @@ void RenderVulkanRQ() {
     swapBarrier.subresourceRange.layerCount = 1;
     swapBarrier.srcAccessMask = 0;
     swapBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+    // srcStage = the acquire semaphore's wait stage, so the transition is ordered after the wait
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
                          0, 0, nullptr, 0, nullptr, 1, &swapBarrier);
 
     if (s_computePipeline != VK_NULL_HANDLE) {
-        // Transition output image to general for compute shader write
-        VkImageMemoryBarrier outputBarrier = {};
-        outputBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        outputBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        outputBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-        outputBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        outputBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        outputBarrier.image = s_outputImage;
-        outputBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        outputBarrier.subresourceRange.baseMipLevel = 0;
-        outputBarrier.subresourceRange.levelCount = 1;
-        outputBarrier.subresourceRange.baseArrayLayer = 0;
-        outputBarrier.subresourceRange.layerCount = 1;
-        outputBarrier.srcAccessMask = 0;
-        outputBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                             0, 0, nullptr, 0, nullptr, 1, &outputBarrier);
-
-        // Bind compute pipeline and dispatch
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, s_computePipeline);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, s_computePipelineLayout, 0, 1, &s_computeDescSet, 0, nullptr);
-
-        // Dispatch: 8x8 workgroups
-        uint32_t groupsX = (W + 7) / 8;
-        uint32_t groupsY = (H + 7) / 8;
-        vkCmdDispatch(cmd, groupsX, groupsY, 1);
-
-        // Transition output image to transfer src
-        outputBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-        outputBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        outputBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-        outputBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             0, 0, nullptr, 0, nullptr, 1, &outputBarrier);
+        if (s_asyncCompute && s_computeFamily != s_graphicsFamily) {
+            // Acquire half of the output image ownership transfer (matches RecordTrace's release)
+            VkImageMemoryBarrier acquireBarrier = {};
+            acquireBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            acquireBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+            acquireBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            acquireBarrier.srcQueueFamilyIndex = s_computeFamily;
+            acquireBarrier.dstQueueFamilyIndex = s_graphicsFamily;
+            acquireBarrier.image = s_outputImage[frame];
+            acquireBarrier.subresourceRange = swapBarrier.subresourceRange;
+            acquireBarrier.srcAccessMask = 0;
+            acquireBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            // Chained to the compute-done semaphore wait, which is at TRANSFER
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &acquireBarrier);
+        }
 
-        // Copy output image to swapchain
-        VkImageCopy copyRegion = {};
-        copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.srcSubresource.mipLevel = 0;
-        copyRegion.srcSubresource.baseArrayLayer = 0;
-        copyRegion.srcSubresource.layerCount = 1;
-        copyRegion.srcOffset = {0, 0, 0};
-        copyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.dstSubresource.mipLevel = 0;
-        copyRegion.dstSubresource.baseArrayLayer = 0;
-        copyRegion.dstSubresource.layerCount = 1;
-        copyRegion.dstOffset = {0, 0, 0};
-        copyRegion.extent = {W, H, 1};
-        vkCmdCopyImage(cmd, s_outputImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                       s_swapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+        if (s_traceExtent.width != s_swapchainExtent.width || s_traceExtent.height != s_swapchainExtent.height) {
+            // --render-scale: bilinear upscale to the swapchain
+            VkImageBlit blitRegion = {};
+            blitRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blitRegion.srcSubresource.layerCount = 1;
+            blitRegion.srcOffsets[1] = {(int32_t)s_traceExtent.width, (int32_t)s_traceExtent.height, 1};
+            blitRegion.dstSubresource = blitRegion.srcSubresource;
+            blitRegion.dstOffsets[1] = {(int32_t)s_swapchainExtent.width, (int32_t)s_swapchainExtent.height, 1};
+            vkCmdBlitImage(cmd, s_outputImage[frame], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           s_swapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blitRegion,
+                           VK_FILTER_LINEAR);
+        } else {
+            // Copy output image to swapchain
+            VkImageCopy copyRegion = {};
+            copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.srcSubresource.mipLevel = 0;
+            copyRegion.srcSubresource.baseArrayLayer = 0;
+            copyRegion.srcSubresource.layerCount = 1;
+            copyRegion.srcOffset = {0, 0, 0};
+            copyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.dstSubresource.mipLevel = 0;
+            copyRegion.dstSubresource.baseArrayLayer = 0;
+            copyRegion.dstSubresource.layerCount = 1;
+            copyRegion.dstOffset = {0, 0, 0};
+            copyRegion.extent = {W, H, 1};
+            vkCmdCopyImage(cmd, s_outputImage[frame], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           s_swapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+        }
     } else {
         // Fallback: Clear swapchain with placeholder color (compute shader not available)
         VkClearColorValue clearColor = {{0.1f, 0.15f, 0.2f, 1.0f}};
@@ -1782,7 +2309,6 @@ void RenderVulkanRQ() {
     // Text rendering (also handles transition to PRESENT_SRC_KHR)
     if (s_textPipeline && s_textVertexMapped) {
         // Get current features from uniform buffer
-        VkRQUniforms* uniforms = (VkRQUniforms*)s_uniformMapped;
         uint32_t features = uniforms->features;
 
         // Build features string
@@ -1797,54 +2323,45 @@ void RenderVulkanRQ() {
 
         uint32_t triCount = (s_staticIndexCount + s_cubesIndexCount) / 3;
 
-        char textBuf[512];
+        char gpuTimes[160];
+        GpuProfilerFormat(gpuTimes, sizeof(gpuTimes));
+        char latencyBuf[96];
+        LatencyFormat(latencyBuf, sizeof(latencyBuf));
+        char vramBuf[192];
+        VramFormat(vramBuf, sizeof(vramBuf));
+        char accumBuf[96] = "";
+        if (s_accumulate) AccumFormat(accumBuf, sizeof(accumBuf));
+        char scaleBuf[64] = "";
+        if (s_traceExtent.width != s_swapchainExtent.width || s_traceExtent.height != s_swapchainExtent.height)
+            snprintf(scaleBuf, sizeof(scaleBuf), " (traced %ux%u, %u%% + bilinear)",
+                     s_traceExtent.width, s_traceExtent.height, g_renderScalePct);
+
+        char textBuf[832];
         snprintf(textBuf, sizeof(textBuf),
-                 "API: Vulkan + RayQuery (VK_KHR_ray_query)\n"
+                 "API: Vulkan + RayQuery (VK_KHR_ray_query)%s\n"
                  "GPU: %s\n"
                  "FPS: %d\n"
                  "Triangles: %u\n"
-                 "Resolution: %ux%u\n"
-                 "RT Features: %s",
+                 "Resolution: %ux%u%s\n"
+                 "RT Features: %s"
+                 "%s%s%s%s%s%s%s%s",   // Optional lines, each with its separator only when present
+                 s_asyncCompute ? " + async compute" : "",
                  s_gpuName.c_str(), fps, triCount,
-                 s_swapchainExtent.width, s_swapchainExtent.height,
-                 featStr);
-
-        // Build text vertices
-        s_textVertCount = 0;
-        float scale = 1.5f, shadowOff = 2.0f;
-        float charW = 8.0f * scale, charH = 8.0f * scale;
-        float textX = 10.0f, textY = 10.0f;
-
-        auto addTextVerts = [&](const char* text, float startX, float startY, float cr, float cg, float cb, float ca) {
-            float cx = startX, cy = startY;
-            for (const char* p = text; *p && s_textVertCount < 5994; p++) {
-                if (*p == '\n') { cx = startX; cy += charH * 1.4f; continue; }
-                if (*p < 32 || *p > 127) continue;
-                int idx = *p - 32;
-                int col = idx % 16, row = idx / 16;
-                float u0 = col * 8.0f / 128.0f, v0 = row * 8.0f / 48.0f;
-                float u1 = u0 + 8.0f / 128.0f, v1 = v0 + 8.0f / 48.0f;
-                float x0 = cx / s_swapchainExtent.width * 2.0f - 1.0f;
-                float y0 = cy / s_swapchainExtent.height * 2.0f - 1.0f;
-                float x1 = (cx + charW) / s_swapchainExtent.width * 2.0f - 1.0f;
-                float y1 = (cy + charH) / s_swapchainExtent.height * 2.0f - 1.0f;
-
-                s_textVerts[s_textVertCount++] = {x0, y0, u0, v0, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x1, y0, u1, v0, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x0, y1, u0, v1, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x1, y0, u1, v0, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x1, y1, u1, v1, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x0, y1, u0, v1, cr, cg, cb, ca};
-                cx += charW;
-            }
-        };
-
-        // Shadow + main text
-        addTextVerts(textBuf, textX + shadowOff, textY + shadowOff, 0.0f, 0.0f, 0.0f, 0.7f);
-        addTextVerts(textBuf, textX, textY, 1.0f, 1.0f, 1.0f, 1.0f);
+                 s_swapchainExtent.width, s_swapchainExtent.height, scaleBuf, featStr,
+                 accumBuf[0] ? "\n" : "", accumBuf, gpuTimes[0] ? "\n" : "", gpuTimes,
+                 latencyBuf[0] ? "\n" : "", latencyBuf, vramBuf[0] ? "\n" : "", vramBuf);
+
+        // Shadow + main text, laid out only when the string changed
+        if (OverlaySetText(s_overlay, textBuf)) {
+            s_textVertCount = OverlayExpandVerts(s_overlay, s_textVerts, TEXT_MAX_VERTS,
+                2.0f / s_swapchainExtent.width, 2.0f / s_swapchainExtent.height, -1.0f, -1.0f);
+        }
 
         if (s_textVertCount > 0) {
-            memcpy(s_textVertexMapped, s_textVerts, s_textVertCount * sizeof(TextVert));
+            if (s_textSliceVersion[frame] != s_overlay.version) {
+                memcpy((TextVert*)s_textVertexMapped + frame * TEXT_MAX_VERTS, s_textVerts, s_textVertCount * sizeof(TextVert));
+                s_textSliceVersion[frame] = s_overlay.version;
+            }
 
             // Begin render pass (transitions swapchain to PRESENT_SRC_KHR)
             VkRenderPassBeginInfo renderPassInfo = {};
@@ -1855,11 +2372,15 @@ void RenderVulkanRQ() {
             renderPassInfo.renderArea.extent = s_swapchainExtent;
 
             vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+            VkViewport viewport = {0, 0, (float)s_swapchainExtent.width, (float)s_swapchainExtent.height, 0, 1};
+            VkRect2D scissor = {{0, 0}, s_swapchainExtent};
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
             vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, s_textPipeline);
             vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, s_textPipelineLayout,
                                     0, 1, &s_textDescSet, 0, nullptr);
             VkBuffer textVBs[] = { s_textVertexBuffer };
-            VkDeviceSize textOffsets[] = { 0 };
+            VkDeviceSize textOffsets[] = { sizeof(TextVert) * TEXT_MAX_VERTS * frame };
             vkCmdBindVertexBuffers(cmd, 0, 1, textVBs, textOffsets);
             vkCmdDraw(cmd, s_textVertCount, 1, 0, 0);
             vkCmdEndRenderPass(cmd);
@@ -1882,45 +2403,99 @@ void RenderVulkanRQ() {
                              0, 0, nullptr, 0, nullptr, 1, &swapBarrier);
     }
 
+    WriteTimestamp(cmd, frame, 4, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    if (s_timestampPool) s_timestampPending[frame] = true;
     vkEndCommandBuffer(cmd);
 
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &s_imageAvailableSemaphore;
+    // The swapchain image is first written by a transfer (copy / clear), so the acquire wait must cover TRANSFER;
+    // the copy also reads the output image the compute queue just wrote
+    VkSemaphore waitSemaphores[] = {s_imageAvailableSemaphores[frame], s_computeDoneSemaphores[frame]};
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                         VK_PIPELINE_STAGE_TRANSFER_BIT};
+    submitInfo.waitSemaphoreCount = s_asyncCompute ? 2 : 1;
+    submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmd;
     submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &s_renderFinishedSemaphore;
-    vkQueueSubmit(s_graphicsQueue, 1, &submitInfo, s_inFlightFence);
+    submitInfo.pSignalSemaphores = &s_renderFinishedSemaphores[imageIndex];
+    vkQueueSubmit(s_graphicsQueue, 1, &submitInfo, s_inFlightFences[frame]);
 
     VkPresentInfoKHR presentInfo = {};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = &s_renderFinishedSemaphore;
+    presentInfo.pWaitSemaphores = &s_renderFinishedSemaphores[imageIndex];
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &s_swapchain;
     presentInfo.pImageIndices = &imageIndex;
-    vkQueuePresentKHR(s_presentQueue, &presentInfo);
+    VkResult presentResult = VkPresentQueue(s_presentQueue, presentInfo);
 
     s_frameCount++;
+    if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) ResizeVulkanRQ();
+}
+
+// ============== RESIZE ==============
+// Recreate swapchain, text framebuffers and the compute output image at the
+// new size. The compute pipeline and acceleration structures are kept.
+bool ResizeVulkanRQ() {
+    if (!s_device || !s_swapchain) return false;
+    vkDeviceWaitIdle(s_device);
+
+    for (auto fb : s_framebuffers) { if (fb) vkDestroyFramebuffer(s_device, fb, nullptr); }
+    s_framebuffers.clear();
+    for (auto iv : s_swapchainImageViews) { if (iv) vkDestroyImageView(s_device, iv, nullptr); }
+    s_swapchainImageViews.clear();
+    s_swapchainImages.clear();
+
+    DestroyOutputImages();
+    bool hadAccumImage = s_accumImage != VK_NULL_HANDLE;
+    DestroyAccumImage();
+
+    size_t oldImageCount = s_renderFinishedSemaphores.size();
+    if (!CreateSwapchainRQ(s_swapchain)) return false;
+    if (!CreateOutputImage()) return false;
+    if (hadAccumImage) {
+        if (!CreateAccumImage()) return false;
+        WriteAccumDescriptors();
+    }
+    if (s_textRenderPass && !CreateTextFramebuffers()) return false;
+    if (s_swapchainImages.size() != oldImageCount && !CreateRenderFinishedSemaphores()) return false;
+
+    // Point binding 1 of every frame's set at its new storage image
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageView = s_outputImageView[f];
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = s_computeDescSet[f];
+        write.dstBinding = 1;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(s_device, 1, &write, 0, nullptr);
+    }
+
+    Log("[VkRQ] Resized to %ux%u\n", s_swapchainExtent.width, s_swapchainExtent.height);
+    return true;
 }
 
 void CleanupVulkanRQ() {
     Log("[VkRQ] Cleanup\n");
+    VramSetCategories(nullptr);
     if (s_device != VK_NULL_HANDLE) vkDeviceWaitIdle(s_device);
 
     #define SAFE_DESTROY_BUFFER(buf, mem) \
         if (buf != VK_NULL_HANDLE) { vkDestroyBuffer(s_device, buf, nullptr); buf = VK_NULL_HANDLE; } \
-        if (mem != VK_NULL_HANDLE) { vkFreeMemory(s_device, mem, nullptr); mem = VK_NULL_HANDLE; }
+        VkMemFree(mem);
 
     SAFE_DESTROY_BUFFER(s_textVertexBuffer, s_textVertexMemory);
     if (s_fontSampler) { vkDestroySampler(s_device, s_fontSampler, nullptr); s_fontSampler = VK_NULL_HANDLE; }
     if (s_fontImageView) { vkDestroyImageView(s_device, s_fontImageView, nullptr); s_fontImageView = VK_NULL_HANDLE; }
     if (s_fontImage) { vkDestroyImage(s_device, s_fontImage, nullptr); s_fontImage = VK_NULL_HANDLE; }
-    if (s_fontMemory) { vkFreeMemory(s_device, s_fontMemory, nullptr); s_fontMemory = VK_NULL_HANDLE; }
+    VkMemFree(s_fontMemory);
     if (s_textDescPool) { vkDestroyDescriptorPool(s_device, s_textDescPool, nullptr); s_textDescPool = VK_NULL_HANDLE; }
     if (s_textDescSetLayout) { vkDestroyDescriptorSetLayout(s_device, s_textDescSetLayout, nullptr); s_textDescSetLayout = VK_NULL_HANDLE; }
     if (s_textPipeline) { vkDestroyPipeline(s_device, s_textPipeline, nullptr); s_textPipeline = VK_NULL_HANDLE; }
@@ -1929,20 +2504,30 @@ void CleanupVulkanRQ() {
     for (auto fb : s_framebuffers) { if (fb) vkDestroyFramebuffer(s_device, fb, nullptr); }
     s_framebuffers.clear();
 
+    for (UINT v = 0; v < GROUP_VARIANT_COUNT; v++) {
+        if (v != GROUP_VARIANT_DEFAULT && s_computeVariants[v]) vkDestroyPipeline(s_device, s_computeVariants[v], nullptr);
+        s_computeVariants[v] = VK_NULL_HANDLE;
+    }
     if (s_computePipeline) { vkDestroyPipeline(s_device, s_computePipeline, nullptr); s_computePipeline = VK_NULL_HANDLE; }
     if (s_computePipelineLayout) { vkDestroyPipelineLayout(s_device, s_computePipelineLayout, nullptr); s_computePipelineLayout = VK_NULL_HANDLE; }
     if (s_computeDescPool) { vkDestroyDescriptorPool(s_device, s_computeDescPool, nullptr); s_computeDescPool = VK_NULL_HANDLE; }
     if (s_computeDescSetLayout) { vkDestroyDescriptorSetLayout(s_device, s_computeDescSetLayout, nullptr); s_computeDescSetLayout = VK_NULL_HANDLE; }
 
-    SAFE_DESTROY_BUFFER(s_uniformBuffer, s_uniformMemory);
-    if (s_outputImageView) { vkDestroyImageView(s_device, s_outputImageView, nullptr); s_outputImageView = VK_NULL_HANDLE; }
-    if (s_outputImage) { vkDestroyImage(s_device, s_outputImage, nullptr); s_outputImage = VK_NULL_HANDLE; }
-    if (s_outputMemory) { vkFreeMemory(s_device, s_outputMemory, nullptr); s_outputMemory = VK_NULL_HANDLE; }
-
-    SAFE_DESTROY_BUFFER(s_tlasScratchBuffer, s_tlasScratchMemory);
-    SAFE_DESTROY_BUFFER(s_instanceBuffer, s_instanceMemory);
-    if (s_tlas && pvkDestroyAccelerationStructureKHR) { pvkDestroyAccelerationStructureKHR(s_device, s_tlas, nullptr); s_tlas = VK_NULL_HANDLE; }
-    SAFE_DESTROY_BUFFER(s_tlasBuffer, s_tlasMemory);
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) { SAFE_DESTROY_BUFFER(s_uniformBuffer[f], s_uniformMemory[f]); }
+    DestroyOutputImages();
+    DestroyAccumImage();
+    s_accumulate = false;
+    memset(s_accumFrame, 0, sizeof(s_accumFrame));
+
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        SAFE_DESTROY_BUFFER(s_tlasScratchBuffer[f], s_tlasScratchMemory[f]);
+        SAFE_DESTROY_BUFFER(s_instanceBuffer[f], s_instanceMemory[f]);
+        s_instanceMapped[f] = nullptr;
+        s_uniformMapped[f] = nullptr;
+        if (s_tlas[f] && pvkDestroyAccelerationStructureKHR) { pvkDestroyAccelerationStructureKHR(s_device, s_tlas[f], nullptr); s_tlas[f] = VK_NULL_HANDLE; }
+        SAFE_DESTROY_BUFFER(s_tlasBuffer[f], s_tlasMemory[f]);
+        s_computeDescSet[f] = VK_NULL_HANDLE;
+    }
     if (s_blasCubes && pvkDestroyAccelerationStructureKHR) { pvkDestroyAccelerationStructureKHR(s_device, s_blasCubes, nullptr); s_blasCubes = VK_NULL_HANDLE; }
     SAFE_DESTROY_BUFFER(s_blasCubesBuffer, s_blasCubesMemory);
     if (s_blasStatic && pvkDestroyAccelerationStructureKHR) { pvkDestroyAccelerationStructureKHR(s_device, s_blasStatic, nullptr); s_blasStatic = VK_NULL_HANDLE; }
@@ -1953,13 +2538,27 @@ void CleanupVulkanRQ() {
     SAFE_DESTROY_BUFFER(s_staticIndexBuffer, s_staticIndexMemory);
     SAFE_DESTROY_BUFFER(s_staticVertexBuffer, s_staticVertexMemory);
 
-    if (s_inFlightFence) { vkDestroyFence(s_device, s_inFlightFence, nullptr); s_inFlightFence = VK_NULL_HANDLE; }
-    if (s_renderFinishedSemaphore) { vkDestroySemaphore(s_device, s_renderFinishedSemaphore, nullptr); s_renderFinishedSemaphore = VK_NULL_HANDLE; }
-    if (s_imageAvailableSemaphore) { vkDestroySemaphore(s_device, s_imageAvailableSemaphore, nullptr); s_imageAvailableSemaphore = VK_NULL_HANDLE; }
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (s_inFlightFences[f]) { vkDestroyFence(s_device, s_inFlightFences[f], nullptr); s_inFlightFences[f] = VK_NULL_HANDLE; }
+        if (s_imageAvailableSemaphores[f]) { vkDestroySemaphore(s_device, s_imageAvailableSemaphores[f], nullptr); s_imageAvailableSemaphores[f] = VK_NULL_HANDLE; }
+        s_commandBuffers[f] = VK_NULL_HANDLE;   // Freed with the pool
+    }
+    DestroyRenderFinishedSemaphores();
     if (s_commandPool) { vkDestroyCommandPool(s_device, s_commandPool, nullptr); s_commandPool = VK_NULL_HANDLE; }
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (s_computeDoneSemaphores[f]) { vkDestroySemaphore(s_device, s_computeDoneSemaphores[f], nullptr); s_computeDoneSemaphores[f] = VK_NULL_HANDLE; }
+        s_computeCommandBuffers[f] = VK_NULL_HANDLE;   // Freed with the pool
+    }
+    if (s_computeCommandPool) { vkDestroyCommandPool(s_device, s_computeCommandPool, nullptr); s_computeCommandPool = VK_NULL_HANDLE; }
+    s_asyncCompute = false;
+    if (s_timestampPool) { vkDestroyQueryPool(s_device, s_timestampPool, nullptr); s_timestampPool = VK_NULL_HANDLE; }
+    memset(s_timestampPending, 0, sizeof(s_timestampPending));
     for (auto view : s_swapchainImageViews) { if (view) vkDestroyImageView(s_device, view, nullptr); }
     s_swapchainImageViews.clear();
-    if (s_swapchain) { vkDestroySwapchainKHR(s_device, s_swapchain, nullptr); s_swapchain = VK_NULL_HANDLE; }
+    if (s_swapchain) { VkPresentDestroySwapchain(s_device, s_swapchain); s_swapchain = VK_NULL_HANDLE; }
+    VkPipelineCacheSave(s_physicalDevice, s_device, s_pipelineCache, "rq", "VkRQ");
+    VkPresentWaitShutdown();
+    VkMemShutdown();
     if (s_device) { vkDestroyDevice(s_device, nullptr); s_device = VK_NULL_HANDLE; }
     if (s_surface) { vkDestroySurfaceKHR(s_instance, s_surface, nullptr); s_surface = VK_NULL_HANDLE; }
     if (s_instance) { vkDestroyInstance(s_instance, nullptr); s_instance = VK_NULL_HANDLE; }
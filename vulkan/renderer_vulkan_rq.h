@@ -9,3 +9,4 @@
 bool InitVulkanRQ(HWND hwnd);
 void RenderVulkanRQ();
 void CleanupVulkanRQ();
+bool ResizeVulkanRQ();  // Recreate swapchain and output image
@@ -10,6 +10,22 @@
 #include "renderer_vulkan_rt.h"
 #include "vulkan_rt_shaders.h"
 #include "vulkan_shaders.h"  // For text rendering shaders
+#include "vk_upload.h"
+#include "vk_present.h"
+#include "vk_pipeline_cache.h"
+#include "vk_specialize.h"
+#include "vk_memory.h"
+#include "vk_tlas.h"
+#include "vk_blas.h"
+#include "vk_startup_timer.h"
+#include "vk_capture.h"
+#include "vk_video_record.h"
+#include "../gpu_profiler.h"
+#include "../rt_geometry.h"
+#include "../text_overlay.h"
+#include "../startup_profiler.h"
+#include "../vram_budget.h"
+#include "../ray_reorder.h"
 
 #pragma comment(lib, "vulkan-1.lib")
 
@@ -29,8 +45,8 @@ extern std::wstring gpuName;
 extern LARGE_INTEGER g_startTime;
 extern LARGE_INTEGER g_perfFreq;
 extern const unsigned char g_font8x8[96][8];
-extern const UINT W;
-extern const UINT H;
+extern UINT W;
+extern UINT H;
 
 // Global feature flags (defined in common.h, instantiated here)
 VulkanRTFeatures g_vulkanRTFeatures = {};
@@ -47,27 +63,54 @@ static PFN_vkGetRayTracingShaderGroupHandlesKHR pvkGetRayTracingShaderGroupHandl
 static PFN_vkCmdTraceRaysKHR pvkCmdTraceRaysKHR = nullptr;
 
 // ============== CONSTANTS ==============
-static const uint32_t FRAME_COUNT = 2;
+static const uint32_t FRAME_COUNT = 2;   // Frames in flight
+
+// --ser: the primary traceRayEXT's tMax in g_rtRayGenGLSL, and the material
+// type (MAT_* of the closest hit shader's GetStaticObjectInfo) per range of
+// static primitives; the cubes instance and the rest are diffuse (0). Same
+// 2-bit hint as DXR 1.0's SerMaterialHint.
+static const float SER_PRIMARY_TMAX = 1000.0f;
+static const VkSerHintRange SER_MATERIAL_RANGES[] = {
+    { 0, 10, 2, 3 },    // Light: MAT_EMISSIVE
+    { 0, 12, 2, 1 },    // Mirror: MAT_MIRROR
+    { 0, 26, 4, 2 },    // Glass: MAT_GLASS
+};
+static const uint32_t SER_HINT_BITS = 2;
 
 // ============== VULKAN RT GLOBALS ==============
 static VkInstance s_instance = VK_NULL_HANDLE;
 static VkPhysicalDevice s_physicalDevice = VK_NULL_HANDLE;
 static VkDevice s_device = VK_NULL_HANDLE;
+static VkPipelineCache s_pipelineCache = VK_NULL_HANDLE;   // Persisted in shadercache\ (vk_pipeline_cache.h)
 static VkQueue s_graphicsQueue = VK_NULL_HANDLE;
 static VkQueue s_presentQueue = VK_NULL_HANDLE;
 static VkSurfaceKHR s_surface = VK_NULL_HANDLE;
 static VkSwapchainKHR s_swapchain = VK_NULL_HANDLE;
 static std::vector<VkImage> s_swapchainImages;
 static std::vector<VkImageView> s_swapchainImageViews;
+// --zero-copy: swapchain images carry STORAGE usage (mutable format) and the
+// raygen shader writes them through an RGBA8 view - no output image copy
+static bool s_zeroCopy = false;
+static bool s_swapchainCapture = false;     // Zero-copy images also carry TRANSFER_SRC for --capture / --record
+// --ser: VK_NV_ray_tracing_invocation_reorder enabled, the raygen SPIR-V is rewritten (vk_specialize.h)
+static bool s_ser = false;
+static bool s_serReorders = false;           // Device hint: REORDER (vs. no-op)
+static std::vector<VkImageView> s_swapchainStorageViews;
 static VkFormat s_swapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
 static VkExtent2D s_swapchainExtent = {};
+static VkPresentModeKHR s_presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
 static VkCommandPool s_commandPool = VK_NULL_HANDLE;
-static std::vector<VkCommandBuffer> s_commandBuffers;
-static VkSemaphore s_imageAvailableSemaphore = VK_NULL_HANDLE;
-static VkSemaphore s_renderFinishedSemaphore = VK_NULL_HANDLE;
-static VkFence s_inFlightFence = VK_NULL_HANDLE;
+// Per frame slot (s_frameCount % FRAME_COUNT): the CPU records frame N+1
+// while the GPU still traces frame N. Render-finished semaphores are per
+// swapchain image - the presentation engine holds them until re-acquire.
+static VkCommandBuffer s_commandBuffers[FRAME_COUNT] = {};
+static VkSemaphore s_imageAvailableSemaphores[FRAME_COUNT] = {};
+static VkFence s_inFlightFences[FRAME_COUNT] = {};
+static std::vector<VkSemaphore> s_renderFinishedSemaphores;
 static uint32_t s_graphicsFamily = UINT32_MAX;
 static uint32_t s_presentFamily = UINT32_MAX;
+static uint32_t s_transferFamily = UINT32_MAX;   // Dedicated transfer queue for static uploads, if any
+static uint32_t s_encodeFamily = UINT32_MAX;     // H.264 encode queue for --record, if any
 static std::string s_gpuName;
 
 // Ray tracing properties
@@ -77,44 +120,48 @@ static VkPhysicalDeviceAccelerationStructureFeaturesKHR s_asFeatures = {};
 // Acceleration structures
 static VkAccelerationStructureKHR s_blasStatic = VK_NULL_HANDLE;
 static VkAccelerationStructureKHR s_blasCubes = VK_NULL_HANDLE;
-static VkAccelerationStructureKHR s_tlas = VK_NULL_HANDLE;
+static VkAccelerationStructureKHR s_tlas[FRAME_COUNT] = {};   // Updated every frame: one per frame slot
+static TlasPolicy s_tlasPolicy;   // Refit vs rebuild for the s_tlas chain
 static VkBuffer s_blasStaticBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_blasStaticMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_blasStaticMemory;
 static VkBuffer s_blasCubesBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_blasCubesMemory = VK_NULL_HANDLE;
-static VkBuffer s_tlasBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_tlasMemory = VK_NULL_HANDLE;
-static VkBuffer s_instanceBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_instanceMemory = VK_NULL_HANDLE;
-static void* s_instanceMapped = nullptr;
-static VkBuffer s_tlasScratchBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_tlasScratchMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_blasCubesMemory;
+static VkBuffer s_tlasBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_tlasMemory[FRAME_COUNT];
+static VkBuffer s_instanceBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_instanceMemory[FRAME_COUNT];
+static void* s_instanceMapped[FRAME_COUNT] = {};
+static VkBuffer s_tlasScratchBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_tlasScratchMemory[FRAME_COUNT];
 static VkDeviceSize s_tlasScratchSize = 0;
 
 // Geometry buffers
 static VkBuffer s_staticVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_staticVertexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_staticVertexMemory;
 static VkBuffer s_staticIndexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_staticIndexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_staticIndexMemory;
 static VkBuffer s_cubesVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_cubesVertexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_cubesVertexMemory;
 static VkBuffer s_cubesIndexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_cubesIndexMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_cubesIndexMemory;
 static uint32_t s_staticVertexCount = 0;
 static uint32_t s_staticIndexCount = 0;
 static uint32_t s_cubesVertexCount = 0;
 static uint32_t s_cubesIndexCount = 0;
+// BLAS input layout, full vertices or --compact-verts (rt_geometry.h)
+static uint32_t s_staticVertexStride = sizeof(VkRTVertex), s_cubesVertexStride = sizeof(VkRTVertex);
+static VkIndexType s_staticIndexType = VK_INDEX_TYPE_UINT32, s_cubesIndexType = VK_INDEX_TYPE_UINT32;
 
 // Ray tracing pipeline
 static VkPipeline s_rtPipeline = VK_NULL_HANDLE;
 static VkPipelineLayout s_rtPipelineLayout = VK_NULL_HANDLE;
 static VkDescriptorSetLayout s_rtDescSetLayout = VK_NULL_HANDLE;
 static VkDescriptorPool s_rtDescPool = VK_NULL_HANDLE;
-static VkDescriptorSet s_rtDescSet = VK_NULL_HANDLE;
+static VkDescriptorSet s_rtDescSet[FRAME_COUNT] = {};   // TLAS + uniforms of that frame slot
 
 // Shader binding table
 static VkBuffer s_sbtBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_sbtMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_sbtMemory;
 static VkStridedDeviceAddressRegionKHR s_raygenRegion = {};
 static VkStridedDeviceAddressRegionKHR s_missRegion = {};
 static VkStridedDeviceAddressRegionKHR s_hitRegion = {};
@@ -122,17 +169,17 @@ static VkStridedDeviceAddressRegionKHR s_callableRegion = {};
 
 // Output image (storage image for ray tracing output)
 static VkImage s_outputImage = VK_NULL_HANDLE;
-static VkDeviceMemory s_outputMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_outputMemory;
 static VkImageView s_outputImageView = VK_NULL_HANDLE;
 
 // Uniform buffer
-static VkBuffer s_uniformBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_uniformMemory = VK_NULL_HANDLE;
-static void* s_uniformMapped = nullptr;
+static VkBuffer s_uniformBuffer[FRAME_COUNT] = {};
+static VkMemAlloc s_uniformMemory[FRAME_COUNT];
+static void* s_uniformMapped[FRAME_COUNT] = {};
 
 // Text rendering
 static VkImage s_fontImage = VK_NULL_HANDLE;
-static VkDeviceMemory s_fontMemory = VK_NULL_HANDLE;
+static VkMemAlloc s_fontMemory;
 static VkImageView s_fontImageView = VK_NULL_HANDLE;
 static VkSampler s_fontSampler = VK_NULL_HANDLE;
 static VkDescriptorSetLayout s_textDescSetLayout = VK_NULL_HANDLE;
@@ -143,15 +190,25 @@ static VkPipeline s_textPipeline = VK_NULL_HANDLE;
 static VkRenderPass s_textRenderPass = VK_NULL_HANDLE;
 static std::vector<VkFramebuffer> s_framebuffers;
 static VkBuffer s_textVertexBuffer = VK_NULL_HANDLE;
-static VkDeviceMemory s_textVertexMemory = VK_NULL_HANDLE;
-static void* s_textVertexMapped = nullptr;
-static TextVert s_textVerts[6000];
+static VkMemAlloc s_textVertexMemory;
+static void* s_textVertexMapped = nullptr;   // FRAME_COUNT slices of TEXT_MAX_VERTS
+static const uint32_t TEXT_MAX_VERTS = 8000;
+static TextVert s_textVerts[TEXT_MAX_VERTS];
 static uint32_t s_textVertCount = 0;
+static TextOverlay s_overlay;                        // s_textVerts is re-expanded only when it changes
+static UINT s_textSliceVersion[FRAME_COUNT] = {};    // Overlay version in each text VB slice
 static int s_cachedFps = -1;
 
 // Frame tracking
 static uint32_t s_frameCount = 0;
 
+// GPU timestamps: one range of TIMESTAMP_STAMPS queries per frame slot
+static const uint32_t TIMESTAMP_STAMPS = 5;   // start, TLAS, trace, copy, text
+static VkQueryPool s_timestampPool = VK_NULL_HANDLE;
+static float s_timestampPeriod = 0.0f;        // ns per tick
+static bool s_timestampPending[FRAME_COUNT] = {};
+static const char* s_timestampPassNames[TIMESTAMP_STAMPS] = { nullptr, "TLAS", "Trace", "Copy", "Text" };
+
 // Feature tracking for recompilation
 static VulkanRTFeatures s_compiledFeatures = {};
 
@@ -183,20 +240,9 @@ struct float3 { float x, y, z; };
 
 // ============== HELPER FUNCTIONS ==============
 
-static uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(s_physicalDevice, &memProps);
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-    Log("[VkRT] ERROR: Failed to find suitable memory type\n");
-    return UINT32_MAX;
-}
-
+// Memory comes from the sub-allocator (vk_memory.h); linear = lives until cleanup
 static bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-                         VkBuffer& buffer, VkDeviceMemory& memory) {
+                         VkBuffer& buffer, VkMemAlloc& memory, bool linear = false, VkDeviceSize minAlign = 0) {
     VkBufferCreateInfo bufferInfo = {};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size = size;
@@ -208,33 +254,12 @@ static bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPr
         return false;
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetBufferMemoryRequirements(s_device, buffer, &memReqs);
-
-    VkMemoryAllocateFlagsInfo allocFlagsInfo = {};
-    allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-    if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
-        allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
-    }
-
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.pNext = (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) ? &allocFlagsInfo : nullptr;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, properties);
-
-    if (allocInfo.memoryTypeIndex == UINT32_MAX) {
-        vkDestroyBuffer(s_device, buffer, nullptr);
-        return false;
-    }
-
-    if (vkAllocateMemory(s_device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+    if (!VkMemAllocBuffer(buffer, properties, memory, linear, minAlign)) {
         Log("[VkRT] ERROR: Failed to allocate buffer memory\n");
         vkDestroyBuffer(s_device, buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
         return false;
     }
-
-    vkBindBufferMemory(s_device, buffer, memory, 0);
     return true;
 }
 
@@ -277,49 +302,6 @@ static void EndSingleTimeCommands(VkCommandBuffer commandBuffer) {
     vkFreeCommandBuffers(s_device, s_commandPool, 1, &commandBuffer);
 }
 
-static void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-    VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-    VkBufferCopy copyRegion = {};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-    EndSingleTimeCommands(commandBuffer);
-}
-
-// ============== TEXT RENDERING ==============
-static void DrawTextVkRT(const char* text, float x, float y, float r, float g, float b, float a, float scale) {
-    const float charW = 8.0f * scale;
-    const float charH = 8.0f * scale;
-    const float texCharW = 8.0f / 128.0f;
-    const float texCharH = 8.0f / 48.0f;
-
-    while (*text && s_textVertCount < 5994) {
-        char c = *text++;
-        if (c < 32 || c > 127) c = '?';
-        int idx = c - 32;
-        int tx = idx % 16;
-        int ty = idx / 16;
-
-        float u0 = tx * texCharW;
-        float v0 = ty * texCharH;
-        float u1 = u0 + texCharW;
-        float v1 = v0 + texCharH;
-
-        float x0 = (x / W) * 2.0f - 1.0f;
-        float y0 = (y / H) * 2.0f - 1.0f;
-        float x1 = ((x + charW) / W) * 2.0f - 1.0f;
-        float y1 = ((y + charH) / H) * 2.0f - 1.0f;
-
-        s_textVerts[s_textVertCount++] = {x0, y0, u0, v0, r, g, b, a};
-        s_textVerts[s_textVertCount++] = {x1, y0, u1, v0, r, g, b, a};
-        s_textVerts[s_textVertCount++] = {x0, y1, u0, v1, r, g, b, a};
-        s_textVerts[s_textVertCount++] = {x1, y0, u1, v0, r, g, b, a};
-        s_textVerts[s_textVertCount++] = {x1, y1, u1, v1, r, g, b, a};
-        s_textVerts[s_textVertCount++] = {x0, y1, u0, v1, r, g, b, a};
-
-        x += charW;
-    }
-}
-
 // ============== TEXT INITIALIZATION ==============
 
 static VkShaderModule CreateShaderModule(const uint32_t* code, size_t codeSize) {
@@ -344,7 +326,8 @@ static bool CreateTextRenderPass() {
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    // Copy path leaves the image in TRANSFER_DST, zero-copy in GENERAL (storage writes)
+    colorAttachment.initialLayout = s_zeroCopy ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
     colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference colorAttachmentRef = {};
@@ -359,10 +342,10 @@ static bool CreateTextRenderPass() {
     VkSubpassDependency dependency = {};
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
     dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    dependency.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    dependency.srcStageMask = s_zeroCopy ? VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR : VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependency.srcAccessMask = s_zeroCopy ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_TRANSFER_WRITE_BIT;
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
     VkRenderPassCreateInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -436,7 +419,7 @@ static bool InitTextResources() {
 
     // Create staging buffer
     VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
+    VkMemAlloc stagingMemory;
     VkDeviceSize imageSize = FONT_TEX_W * FONT_TEX_H * 4;
 
     if (!CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -446,10 +429,7 @@ static bool InitTextResources() {
         return false;
     }
 
-    void* data;
-    vkMapMemory(s_device, stagingMemory, 0, imageSize, 0, &data);
-    memcpy(data, fontData.data(), imageSize);
-    vkUnmapMemory(s_device, stagingMemory);
+    memcpy(stagingMemory.mapped, fontData.data(), imageSize);
 
     // Create font image
     VkImageCreateInfo imageInfo = {};
@@ -470,26 +450,18 @@ static bool InitTextResources() {
     if (vkCreateImage(s_device, &imageInfo, nullptr, &s_fontImage) != VK_SUCCESS) {
         Log("[VkRT] Failed to create font image\n");
         vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-        vkFreeMemory(s_device, stagingMemory, nullptr);
+        VkMemFree(stagingMemory);
         return false;
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(s_device, s_fontImage, &memReqs);
-
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(s_device, &allocInfo, nullptr, &s_fontMemory) != VK_SUCCESS) {
+    if (!VkMemAllocImage(s_fontImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_fontMemory)) {
         Log("[VkRT] Failed to allocate font memory\n");
         vkDestroyImage(s_device, s_fontImage, nullptr);
+        s_fontImage = VK_NULL_HANDLE;
         vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-        vkFreeMemory(s_device, stagingMemory, nullptr);
+        VkMemFree(stagingMemory);
         return false;
     }
-    vkBindImageMemory(s_device, s_fontImage, s_fontMemory, 0);
 
     // Copy staging buffer to image
     VkCommandBuffer cmdBuf;
@@ -559,7 +531,7 @@ static bool InitTextResources() {
 
     // Cleanup staging
     vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
+    VkMemFree(stagingMemory);
 
     // ========== Create Image View ==========
     VkImageViewCreateInfo viewInfo = {};
@@ -743,6 +715,13 @@ static bool InitTextResources() {
     viewportState.scissorCount = 1;
     viewportState.pScissors = &scissor;
 
+    // Viewport/scissor are set per frame so the pipeline survives resize
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
     VkPipelineRasterizationStateCreateInfo rasterizer = {};
     rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
     rasterizer.depthClampEnable = VK_FALSE;
@@ -794,12 +773,12 @@ static bool InitTextResources() {
     pipelineInfo.pMultisampleState = &multisampling;
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = nullptr;
+    pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = s_textPipelineLayout;
     pipelineInfo.renderPass = s_textRenderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(s_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &s_textPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(s_device, s_pipelineCache, 1, &pipelineInfo, nullptr, &s_textPipeline) != VK_SUCCESS) {
         Log("[VkRT] Failed to create text pipeline\n");
         vkDestroyShaderModule(s_device, textVertShader, nullptr);
         vkDestroyShaderModule(s_device, textFragShader, nullptr);
@@ -810,7 +789,7 @@ static bool InitTextResources() {
     vkDestroyShaderModule(s_device, textFragShader, nullptr);
 
     // ========== Create Text Vertex Buffer ==========
-    VkDeviceSize textBufferSize = sizeof(TextVert) * 6000;
+    VkDeviceSize textBufferSize = sizeof(TextVert) * TEXT_MAX_VERTS * FRAME_COUNT;
     if (!CreateBuffer(textBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                       s_textVertexBuffer, s_textVertexMemory)) {
@@ -818,7 +797,10 @@ static bool InitTextResources() {
         return false;
     }
 
-    if (vkMapMemory(s_device, s_textVertexMemory, 0, textBufferSize, 0, &s_textVertexMapped) != VK_SUCCESS) {
+    s_textVertexMapped = s_textVertexMemory.mapped;   // Host-visible blocks stay mapped
+    OverlayInvalidate(s_overlay);
+    memset(s_textSliceVersion, 0, sizeof(s_textSliceVersion));
+    if (!s_textVertexMapped) {
         Log("[VkRT] Failed to map text vertex buffer\n");
         return false;
     }
@@ -1117,86 +1099,33 @@ static bool CreateGeometryBuffers() {
     s_cubesVertexCount = (uint32_t)cubeVerts.size();
     s_cubesIndexCount = (uint32_t)cubeInds.size();
 
-    // Create staging buffers and copy to device local buffers
-    VkDeviceSize staticVBSize = staticVerts.size() * sizeof(VkRTVertex);
-    VkDeviceSize staticIBSize = staticInds.size() * sizeof(uint32_t);
-    VkDeviceSize cubesVBSize = cubeVerts.size() * sizeof(VkRTVertex);
-    VkDeviceSize cubesIBSize = cubeInds.size() * sizeof(uint32_t);
-
-    // Static vertex buffer
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
-    CreateBuffer(staticVBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    void* data;
-    vkMapMemory(s_device, stagingMemory, 0, staticVBSize, 0, &data);
-    memcpy(data, staticVerts.data(), staticVBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-
-    CreateBuffer(staticVBSize,
-                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                 s_staticVertexBuffer, s_staticVertexMemory);
-    CopyBuffer(stagingBuffer, s_staticVertexBuffer, staticVBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
-
-    // Static index buffer
-    CreateBuffer(staticIBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    vkMapMemory(s_device, stagingMemory, 0, staticIBSize, 0, &data);
-    memcpy(data, staticInds.data(), staticIBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-
-    CreateBuffer(staticIBSize,
-                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                 s_staticIndexBuffer, s_staticIndexMemory);
-    CopyBuffer(stagingBuffer, s_staticIndexBuffer, staticIBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
-
-    // Cubes vertex buffer
-    CreateBuffer(cubesVBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    vkMapMemory(s_device, stagingMemory, 0, cubesVBSize, 0, &data);
-    memcpy(data, cubeVerts.data(), cubesVBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-
-    CreateBuffer(cubesVBSize,
-                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                 s_cubesVertexBuffer, s_cubesVertexMemory);
-    CopyBuffer(stagingBuffer, s_cubesVertexBuffer, cubesVBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
-
-    // Cubes index buffer
-    CreateBuffer(cubesIBSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer, stagingMemory);
-    vkMapMemory(s_device, stagingMemory, 0, cubesIBSize, 0, &data);
-    memcpy(data, cubeInds.data(), cubesIBSize);
-    vkUnmapMemory(s_device, stagingMemory);
-
-    CreateBuffer(cubesIBSize,
-                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                 s_cubesIndexBuffer, s_cubesIndexMemory);
-    CopyBuffer(stagingBuffer, s_cubesIndexBuffer, cubesIBSize);
-    vkDestroyBuffer(s_device, stagingBuffer, nullptr);
-    vkFreeMemory(s_device, stagingMemory, nullptr);
+    // The shaders never fetch vertices (hit colours come from primitive ranges),
+    // so the buffers are BLAS inputs only and can take the compact layout
+    RTMeshData staticMesh, cubesMesh;
+    RTMeshPrepare(staticMesh, staticVerts.data(), sizeof(VkRTVertex), s_staticVertexCount, staticInds, "VkRT static");
+    RTMeshPrepare(cubesMesh, cubeVerts.data(), sizeof(VkRTVertex), s_cubesVertexCount, cubeInds, "VkRT cubes");
+    s_staticVertexStride = staticMesh.vertexStride;
+    s_cubesVertexStride = cubesMesh.vertexStride;
+    s_staticIndexType = staticMesh.index16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    s_cubesIndexType = cubesMesh.index16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+    // All four go to DEVICE_LOCAL memory in one transfer-queue batch; the BLAS
+    // builds read them through their device addresses
+    const VkBufferUsageFlags geomUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                                         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+    if (!VkUploadBegin(s_device, s_transferFamily, s_graphicsFamily)) return false;
+    bool uploaded = VkUploadBuffer(staticMesh.vertices, staticMesh.vertexBytes, geomUsage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                   s_staticVertexBuffer, s_staticVertexMemory, "static VB");
+    uploaded = uploaded && VkUploadBuffer(staticMesh.indices, staticMesh.indexBytes, geomUsage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                          s_staticIndexBuffer, s_staticIndexMemory, "static IB");
+    uploaded = uploaded && VkUploadBuffer(cubesMesh.vertices, cubesMesh.vertexBytes, geomUsage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                          s_cubesVertexBuffer, s_cubesVertexMemory, "cubes VB");
+    uploaded = uploaded && VkUploadBuffer(cubesMesh.indices, cubesMesh.indexBytes, geomUsage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                          s_cubesIndexBuffer, s_cubesIndexMemory, "cubes IB");
+    if (!VkUploadFlush() || !uploaded) {
+        Log("[VkRT] ERROR: Geometry upload failed\n");
+        return false;
+    }
 
     Log("[VkRT] Geometry buffers created: Static %u verts/%u inds, Cubes %u verts/%u inds\n",
         s_staticVertexCount, s_staticIndexCount, s_cubesVertexCount, s_cubesIndexCount);
@@ -1205,8 +1134,8 @@ static bool CreateGeometryBuffers() {
 
 // ============== CREATE BLAS ==============
 static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer,
-                       uint32_t vertexCount, uint32_t indexCount,
-                       VkAccelerationStructureKHR& blas, VkBuffer& blasBuffer, VkDeviceMemory& blasMemory) {
+                       uint32_t vertexCount, uint32_t indexCount, uint32_t vertexStride, VkIndexType indexType,
+                       VkAccelerationStructureKHR& blas, VkBuffer& blasBuffer, VkMemAlloc& blasMemory, const char* name) {
     // Geometry description
     VkAccelerationStructureGeometryKHR geometry = {};
     geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
@@ -1215,16 +1144,16 @@ static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer,
     geometry.geometry.triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
     geometry.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
     geometry.geometry.triangles.vertexData.deviceAddress = GetBufferDeviceAddress(vertexBuffer);
-    geometry.geometry.triangles.vertexStride = sizeof(VkRTVertex);
+    geometry.geometry.triangles.vertexStride = vertexStride;
     geometry.geometry.triangles.maxVertex = vertexCount - 1;
-    geometry.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
+    geometry.geometry.triangles.indexType = indexType;
     geometry.geometry.triangles.indexData.deviceAddress = GetBufferDeviceAddress(indexBuffer);
 
     // Build info
     VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
     buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
     buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+    buildInfo.flags = VK_BLAS_STATIC_FLAGS;
     buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
     buildInfo.geometryCount = 1;
     buildInfo.pGeometries = &geometry;
@@ -1256,7 +1185,7 @@ static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer,
 
     // Create scratch buffer
     VkBuffer scratchBuffer;
-    VkDeviceMemory scratchMemory;
+    VkMemAlloc scratchMemory;
     CreateBuffer(sizeInfo.buildScratchSize,
                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, scratchBuffer, scratchMemory);
@@ -1270,12 +1199,22 @@ static bool CreateBLAS(VkBuffer vertexBuffer, VkBuffer indexBuffer,
     const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
 
     VkCommandBuffer cmd = BeginSingleTimeCommands();
+    VkStartupTimer timer;
+    VkStartupTimerBegin(timer, s_physicalDevice, s_device, s_graphicsFamily, cmd);
     pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
+    VkStartupTimerEnd(timer, cmd);
     EndSingleTimeCommands(cmd);
+    char timerName[STARTUP_NAME_LEN];
+    sprintf_s(timerName, "BLAS %s build", name);
+    VkStartupTimerCollect(timer, timerName);
 
     // Cleanup scratch
     vkDestroyBuffer(s_device, scratchBuffer, nullptr);
-    vkFreeMemory(s_device, scratchMemory, nullptr);
+    VkMemFree(scratchMemory);
+
+    // Shrink to the compacted size (keeps the uncompacted BLAS if that fails)
+    VkCompactBLAS(s_device, s_graphicsQueue, s_commandPool, sizeInfo.accelerationStructureSize,
+                  blas, blasBuffer, blasMemory, "VkRT", name);
 
     return true;
 }
@@ -1317,83 +1256,92 @@ static bool CreateTLAS() {
     instances[1].flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
     instances[1].accelerationStructureReference = blasCubesAddr;
 
-    // Create instance buffer
-    VkDeviceSize instanceBufferSize = sizeof(instances);
-    CreateBuffer(instanceBufferSize,
-                 VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 s_instanceBuffer, s_instanceMemory);
-
-    vkMapMemory(s_device, s_instanceMemory, 0, instanceBufferSize, 0, &s_instanceMapped);
-    memcpy(s_instanceMapped, instances, instanceBufferSize);
-
-    // Build TLAS
-    VkAccelerationStructureGeometryKHR geometry = {};
-    geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-    geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    geometry.geometry.instances.arrayOfPointers = VK_FALSE;
-    geometry.geometry.instances.data.deviceAddress = GetBufferDeviceAddress(s_instanceBuffer);
-
-    VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
-    buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-    buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR |
-                      VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-    buildInfo.geometryCount = 1;
-    buildInfo.pGeometries = &geometry;
-
     uint32_t instanceCount = 2;
+    TlasPolicyInvalidate(s_tlasPolicy);   // New TLAS chain: the first frame rebuilds
+    VkDeviceSize instanceBufferSize = sizeof(instances);
+    VkCommandBuffer cmd = BeginSingleTimeCommands();
+    VkStartupTimer timer;
+    VkStartupTimerBegin(timer, s_physicalDevice, s_device, s_graphicsFamily, cmd);
+
+    // One instance buffer / TLAS / scratch per frame slot so the per-frame
+    // rebuild never touches memory a frame still in flight is reading
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        CreateBuffer(instanceBufferSize,
+                     VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+                     VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     s_instanceBuffer[f], s_instanceMemory[f], true);
+
+        s_instanceMapped[f] = s_instanceMemory[f].mapped;
+        memcpy(s_instanceMapped[f], instances, instanceBufferSize);
+
+        // Build TLAS
+        VkAccelerationStructureGeometryKHR geometry = {};
+        geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+        geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+        geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+        geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+        geometry.geometry.instances.arrayOfPointers = VK_FALSE;
+        geometry.geometry.instances.data.deviceAddress = GetBufferDeviceAddress(s_instanceBuffer[f]);
+
+        VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
+        buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+        buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+        buildInfo.flags = VK_TLAS_BUILD_FLAGS;
+        buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+        buildInfo.geometryCount = 1;
+        buildInfo.pGeometries = &geometry;
+
+        VkAccelerationStructureBuildSizesInfoKHR sizeInfo = {};
+        sizeInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+        pvkGetAccelerationStructureBuildSizesKHR(s_device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+                                                  &buildInfo, &instanceCount, &sizeInfo);
+
+        CreateBuffer(sizeInfo.accelerationStructureSize,
+                     VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasBuffer[f], s_tlasMemory[f], true);
+
+        VkAccelerationStructureCreateInfoKHR createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+        createInfo.buffer = s_tlasBuffer[f];
+        createInfo.size = sizeInfo.accelerationStructureSize;
+        createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+
+        if (pvkCreateAccelerationStructureKHR(s_device, &createInfo, nullptr, &s_tlas[f]) != VK_SUCCESS) {
+            Log("[VkRT] ERROR: Failed to create TLAS\n");
+            EndSingleTimeCommands(cmd);
+            VkStartupTimerCollect(timer, "TLAS build");
+            return false;
+        }
 
-    VkAccelerationStructureBuildSizesInfoKHR sizeInfo = {};
-    sizeInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-    pvkGetAccelerationStructureBuildSizesKHR(s_device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-                                              &buildInfo, &instanceCount, &sizeInfo);
-
-    CreateBuffer(sizeInfo.accelerationStructureSize,
-                 VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasBuffer, s_tlasMemory);
+        // Create persistent scratch buffer for TLAS updates
+        s_tlasScratchSize = VkTlasScratchSize(sizeInfo);
+        CreateBuffer(s_tlasScratchSize,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasScratchBuffer[f], s_tlasScratchMemory[f], true);
 
-    VkAccelerationStructureCreateInfoKHR createInfo = {};
-    createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
-    createInfo.buffer = s_tlasBuffer;
-    createInfo.size = sizeInfo.accelerationStructureSize;
-    createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+        buildInfo.dstAccelerationStructure = s_tlas[f];
+        buildInfo.scratchData.deviceAddress = GetBufferDeviceAddress(s_tlasScratchBuffer[f]);
 
-    if (pvkCreateAccelerationStructureKHR(s_device, &createInfo, nullptr, &s_tlas) != VK_SUCCESS) {
-        Log("[VkRT] ERROR: Failed to create TLAS\n");
-        return false;
+        VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {};
+        rangeInfo.primitiveCount = instanceCount;
+        const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
+        pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
     }
 
-    // Create persistent scratch buffer for TLAS updates
-    s_tlasScratchSize = sizeInfo.buildScratchSize;
-    CreateBuffer(s_tlasScratchSize,
-                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_tlasScratchBuffer, s_tlasScratchMemory);
-
-    buildInfo.dstAccelerationStructure = s_tlas;
-    buildInfo.scratchData.deviceAddress = GetBufferDeviceAddress(s_tlasScratchBuffer);
-
-    VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {};
-    rangeInfo.primitiveCount = instanceCount;
-    const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
-
-    VkCommandBuffer cmd = BeginSingleTimeCommands();
-    pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
+    VkStartupTimerEnd(timer, cmd);
     EndSingleTimeCommands(cmd);
+    VkStartupTimerCollect(timer, "TLAS build");
 
-    // Don't destroy scratch buffer - we need it for updates!
+    // Don't destroy scratch buffers - we need them for updates!
 
-    Log("[VkRT] TLAS created with %u instances\n", instanceCount);
+    Log("[VkRT] TLAS created with %u instances (x%u frames in flight)\n", instanceCount, FRAME_COUNT);
     return true;
 }
 
 // ============== UPDATE CUBE TRANSFORM ==============
-static void UpdateCubeTransform(float time) {
-    if (!s_instanceMapped) return;
+static void UpdateCubeTransform(float time, uint32_t frame) {
+    if (!s_instanceMapped[frame]) return;
 
     // Rotation angles (same as DXR: Y*1.2, X*0.7)
     float angleY = time * 1.2f;
@@ -1419,7 +1367,7 @@ static void UpdateCubeTransform(float time) {
     float tz = 0.2f;
 
     // Update instance 1 transform (cube)
-    VkAccelerationStructureInstanceKHR* instances = (VkAccelerationStructureInstanceKHR*)s_instanceMapped;
+    VkAccelerationStructureInstanceKHR* instances = (VkAccelerationStructureInstanceKHR*)s_instanceMapped[frame];
 
     // Transform is 3x4 row-major (transpose of rotation + translation)
     instances[1].transform.matrix[0][0] = m00; instances[1].transform.matrix[0][1] = m10; instances[1].transform.matrix[0][2] = m20; instances[1].transform.matrix[0][3] = tx;
@@ -1428,43 +1376,216 @@ static void UpdateCubeTransform(float time) {
 }
 
 // ============== REBUILD TLAS ==============
-static void RebuildTLAS(VkCommandBuffer cmd) {
-    if (!s_tlas || !s_instanceBuffer || !s_tlasScratchBuffer) return;
+// Refit (or rebuild, see tlas_policy.h) this slot's TLAS from the previous slot's
+static void RebuildTLAS(VkCommandBuffer cmd, uint32_t frame) {
+    if (!s_tlas[frame] || !s_instanceBuffer[frame] || !s_tlasScratchBuffer[frame]) return;
+    uint32_t prev = (frame + FRAME_COUNT - 1) % FRAME_COUNT;
+    VkTlasRecord(cmd, pvkCmdBuildAccelerationStructuresKHR, s_tlasPolicy,
+                 (const VkAccelerationStructureInstanceKHR*)s_instanceMapped[frame], 2,
+                 GetBufferDeviceAddress(s_instanceBuffer[frame]), s_tlas[prev], s_tlas[frame],
+                 GetBufferDeviceAddress(s_tlasScratchBuffer[frame]), VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR);
+}
 
-    VkAccelerationStructureGeometryKHR geometry = {};
-    geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-    geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    geometry.geometry.instances.arrayOfPointers = VK_FALSE;
-    geometry.geometry.instances.data.deviceAddress = GetBufferDeviceAddress(s_instanceBuffer);
+// ============== GPU TIMESTAMPS ==============
+static bool CreateTimestampQueryPool() {
+    GpuProfilerReset();
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(s_physicalDevice, &props);
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(s_physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(s_physicalDevice, &familyCount, families.data());
+    if (s_graphicsFamily >= familyCount || families[s_graphicsFamily].timestampValidBits == 0 ||
+        props.limits.timestampPeriod <= 0.0f) {
+        Log("[VkRT] Timestamps not supported on graphics queue, GPU pass timings disabled\n");
+        return false;
+    }
+    s_timestampPeriod = props.limits.timestampPeriod;
 
-    VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
-    buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-    buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_BUILD_BIT_KHR |
-                      VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-    buildInfo.srcAccelerationStructure = VK_NULL_HANDLE;
-    buildInfo.dstAccelerationStructure = s_tlas;
-    buildInfo.geometryCount = 1;
-    buildInfo.pGeometries = &geometry;
-    buildInfo.scratchData.deviceAddress = GetBufferDeviceAddress(s_tlasScratchBuffer);
+    VkQueryPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = FRAME_COUNT * TIMESTAMP_STAMPS;
+    if (vkCreateQueryPool(s_device, &poolInfo, nullptr, &s_timestampPool) != VK_SUCCESS) {
+        Log("[VkRT] Warning: Failed to create timestamp query pool\n");
+        return false;
+    }
+    Log("[VkRT] Timestamp query pool created (period %.2f ns)\n", s_timestampPeriod);
+    return true;
+}
 
-    VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {};
-    rangeInfo.primitiveCount = 2;  // 2 instances
-    const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
+// Called after the in-flight fence wait, so the slot's queries are already written
+static void CollectTimestamps(uint32_t slot) {
+    if (!s_timestampPool || !s_timestampPending[slot]) return;
+    s_timestampPending[slot] = false;
 
-    pvkCmdBuildAccelerationStructuresKHR(cmd, 1, &buildInfo, &pRangeInfo);
+    uint64_t stamps[TIMESTAMP_STAMPS] = {};
+    VkResult res = vkGetQueryPoolResults(s_device, s_timestampPool, slot * TIMESTAMP_STAMPS, TIMESTAMP_STAMPS,
+                                         sizeof(stamps), stamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (res != VK_SUCCESS) return;  // VK_NOT_READY - drop this sample rather than stall
+
+    for (uint32_t i = 1; i < TIMESTAMP_STAMPS; i++) {
+        if (stamps[i] < stamps[i - 1]) continue;
+        double ms = (double)(stamps[i] - stamps[i - 1]) * s_timestampPeriod / 1.0e6;
+        GpuProfilerAddSample(i - 1, s_timestampPassNames[i], ms);
+    }
+}
 
-    // Memory barrier to ensure TLAS is built before ray tracing
-    VkMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
-    barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
-                         VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
-                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+static void WriteTimestamp(VkCommandBuffer cmd, uint32_t slot, uint32_t index, VkPipelineStageFlagBits stage) {
+    if (s_timestampPool) vkCmdWriteTimestamp(cmd, stage, s_timestampPool, slot * TIMESTAMP_STAMPS + index);
+}
+
+// ============== SYNC OBJECTS ==============
+// One render-finished semaphore per swapchain image (count can change on resize)
+static void DestroyRenderFinishedSemaphores() {
+    for (VkSemaphore sem : s_renderFinishedSemaphores) vkDestroySemaphore(s_device, sem, nullptr);
+    s_renderFinishedSemaphores.clear();
+}
+
+static bool CreateRenderFinishedSemaphores() {
+    DestroyRenderFinishedSemaphores();
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    s_renderFinishedSemaphores.resize(s_swapchainImages.size(), VK_NULL_HANDLE);
+    for (VkSemaphore& sem : s_renderFinishedSemaphores) {
+        if (vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &sem) != VK_SUCCESS) {
+            Log("[VkRT] ERROR: Failed to create render-finished semaphores\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============== SWAPCHAIN ==============
+// Creates swapchain + image views at the current surface size (W/H fallback).
+// Also used by ResizeVulkanRT, passing the old swapchain for recycling.
+static bool CreateSwapchainRT(VkSwapchainKHR oldSwapchain) {
+    VkSurfaceCapabilitiesKHR surfaceCaps = {};
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(s_physicalDevice, s_surface, &surfaceCaps);
+
+    s_swapchainExtent = {W, H};
+    if (surfaceCaps.currentExtent.width != UINT32_MAX && surfaceCaps.currentExtent.width > 0) {
+        s_swapchainExtent = surfaceCaps.currentExtent;
+        W = s_swapchainExtent.width;
+        H = s_swapchainExtent.height;
+    }
+
+    uint32_t imageCount = surfaceCaps.minImageCount + 1;
+    if (surfaceCaps.maxImageCount > 0 && imageCount > surfaceCaps.maxImageCount) {
+        imageCount = surfaceCaps.maxImageCount;
+    }
+
+    VkSwapchainCreateInfoKHR swapchainInfo = {};
+    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    swapchainInfo.surface = s_surface;
+    swapchainInfo.minImageCount = imageCount;
+    swapchainInfo.imageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+    swapchainInfo.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    swapchainInfo.imageExtent = s_swapchainExtent;
+    swapchainInfo.imageArrayLayers = 1;
+    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    // Zero-copy: B8G8R8A8 isn't a storage format everywhere, so the images are
+    // created mutable and written through an R8G8B8A8 view. The bytes end up
+    // exactly where the RGBA8 -> BGRA8 vkCmdCopyImage of the copy path puts them.
+    VkFormat viewFormats[2] = { VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM };
+    VkImageFormatListCreateInfo formatList = {};
+    formatList.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO;
+    formatList.viewFormatCount = 2;
+    formatList.pViewFormats = viewFormats;
+    if (s_zeroCopy) {
+        swapchainInfo.pNext = &formatList;
+        swapchainInfo.flags = VK_SWAPCHAIN_CREATE_MUTABLE_FORMAT_BIT_KHR;
+        swapchainInfo.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        // --capture / --record read the image the raygen shader wrote
+        s_swapchainCapture = (g_captureEvery || g_recordPath[0]) && (surfaceCaps.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+        if (s_swapchainCapture) swapchainInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+
+    uint32_t queueFamilyIndices[] = {s_graphicsFamily, s_presentFamily};
+    if (s_graphicsFamily != s_presentFamily) {
+        swapchainInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+        swapchainInfo.queueFamilyIndexCount = 2;
+        swapchainInfo.pQueueFamilyIndices = queueFamilyIndices;
+    } else {
+        swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    swapchainInfo.preTransform = surfaceCaps.currentTransform;
+    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapchainInfo.presentMode = s_presentMode;
+    swapchainInfo.clipped = VK_TRUE;
+    swapchainInfo.oldSwapchain = oldSwapchain;
+
+    VkSwapchainKHR newSwapchain = VK_NULL_HANDLE;
+    VkResult res = VkPresentCreateSwapchain(s_device, swapchainInfo, &newSwapchain);
+    if (oldSwapchain) VkPresentDestroySwapchain(s_device, oldSwapchain);
+    s_swapchain = newSwapchain;
+    if (res != VK_SUCCESS) {
+        Log("[VkRT] ERROR: Failed to create swapchain\n");
+        return false;
+    }
+    Log("[VkRT] Swapchain created (%ux%u)\n", s_swapchainExtent.width, s_swapchainExtent.height);
+
+    // Get swapchain images
+    VkPresentGetImages(s_device, s_swapchain, &imageCount, nullptr);
+    s_swapchainImages.resize(imageCount);
+    VkPresentGetImages(s_device, s_swapchain, &imageCount, s_swapchainImages.data());
+    s_swapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
+
+    // Create image views
+    s_swapchainImageViews.resize(imageCount);
+    for (uint32_t i = 0; i < imageCount; i++) {
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = s_swapchainImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = s_swapchainFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        vkCreateImageView(s_device, &viewInfo, nullptr, &s_swapchainImageViews[i]);
+    }
+
+    // Storage views for the raygen shader (binding 1, rgba8)
+    if (s_zeroCopy) {
+        s_swapchainStorageViews.resize(imageCount);
+        for (uint32_t i = 0; i < imageCount; i++) {
+            VkImageViewCreateInfo viewInfo = {};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = s_swapchainImages[i];
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewInfo.subresourceRange.levelCount = 1;
+            viewInfo.subresourceRange.layerCount = 1;
+            if (vkCreateImageView(s_device, &viewInfo, nullptr, &s_swapchainStorageViews[i]) != VK_SUCCESS) {
+                Log("[VkRT] ERROR: Failed to create swapchain storage view %u\n", i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Zero-copy: point this frame's binding 1 at the acquired swapchain image.
+// The set was last used FRAME_COUNT frames ago and its fence has been waited on.
+static void BindSwapchainStorageView(uint32_t frame, uint32_t imageIndex) {
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.imageView = s_swapchainStorageViews[imageIndex];
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = s_rtDescSet[frame];
+    write.dstBinding = 1;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(s_device, 1, &write, 0, nullptr);
 }
 
 // ============== CREATE OUTPUT IMAGE ==============
@@ -1488,21 +1609,11 @@ static bool CreateOutputImage() {
         return false;
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(s_device, s_outputImage, &memReqs);
-
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(s_device, &allocInfo, nullptr, &s_outputMemory) != VK_SUCCESS) {
+    if (!VkMemAllocImage(s_outputImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_outputMemory)) {
         Log("[VkRT] ERROR: Failed to allocate output image memory\n");
         return false;
     }
 
-    vkBindImageMemory(s_device, s_outputImage, s_outputMemory, 0);
-
     VkImageViewCreateInfo viewInfo = {};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = s_outputImage;
@@ -1547,37 +1658,36 @@ static bool CreateOutputImage() {
 }
 
 // ============== CREATE UNIFORM BUFFER ==============
-static bool CreateUniformBuffer() {
-    VkDeviceSize bufferSize = sizeof(VkRTUniforms);
-
-    CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 s_uniformBuffer, s_uniformMemory);
-
-    vkMapMemory(s_device, s_uniformMemory, 0, bufferSize, 0, &s_uniformMapped);
-
-    // Initialize with default values
-    VkRTUniforms* uniforms = (VkRTUniforms*)s_uniformMapped;
-    uniforms->time = 0.0f;
+static void WriteUniforms(VkRTUniforms* uniforms, float time, uint32_t frameCount) {
+    uniforms->time = time;
     uniforms->lightPos[0] = 0.0f;
     uniforms->lightPos[1] = 0.92f;
     uniforms->lightPos[2] = 0.0f;
     uniforms->lightRadius = g_vulkanRTFeatures.lightRadius;
-    uniforms->frameCount = 0;
+    uniforms->frameCount = frameCount;
     uniforms->shadowSamples = g_vulkanRTFeatures.shadowSamples;
     uniforms->aoSamples = g_vulkanRTFeatures.aoSamples;
     uniforms->aoRadius = g_vulkanRTFeatures.aoRadius;
 
-    // Build feature flags
-    uniforms->features = 0;
-    if (g_vulkanRTFeatures.spotlight) uniforms->features |= (1u << 0);
-    if (g_vulkanRTFeatures.softShadows) uniforms->features |= (1u << 1);
-    if (g_vulkanRTFeatures.ambientOcclusion) uniforms->features |= (1u << 2);
-    if (g_vulkanRTFeatures.globalIllum) uniforms->features |= (1u << 3);
-    if (g_vulkanRTFeatures.reflections) uniforms->features |= (1u << 4);
-    if (g_vulkanRTFeatures.glassRefraction) uniforms->features |= (1u << 5);
+    // Feature flags - the pipeline is specialized on them, kept here for reference
+    uniforms->features = g_vulkanRTFeatures.Bits();
+}
+
+static bool CreateUniformBuffer() {
+    VkDeviceSize bufferSize = sizeof(VkRTUniforms);
 
-    Log("[VkRT] Uniform buffer created\n");
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (!CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          s_uniformBuffer[f], s_uniformMemory[f], true)) {
+            Log("[VkRT] ERROR: Failed to create uniform buffer\n");
+            return false;
+        }
+        s_uniformMapped[f] = s_uniformMemory[f].mapped;
+        WriteUniforms((VkRTUniforms*)s_uniformMapped[f], 0.0f, 0);
+    }
+
+    Log("[VkRT] Uniform buffers created (x%u)\n", FRAME_COUNT);
     return true;
 }
 
@@ -1622,15 +1732,15 @@ static bool CreateDescriptorSet() {
     // Create pool
     VkDescriptorPoolSize poolSizes[3] = {};
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
-    poolSizes[0].descriptorCount = 1;
+    poolSizes[0].descriptorCount = FRAME_COUNT;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    poolSizes[1].descriptorCount = 1;
+    poolSizes[1].descriptorCount = FRAME_COUNT;
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[2].descriptorCount = 1;
+    poolSizes[2].descriptorCount = FRAME_COUNT;
 
     VkDescriptorPoolCreateInfo poolInfo = {};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.maxSets = 1;
+    poolInfo.maxSets = FRAME_COUNT;
     poolInfo.poolSizeCount = 3;
     poolInfo.pPoolSizes = poolSizes;
 
@@ -1639,59 +1749,63 @@ static bool CreateDescriptorSet() {
         return false;
     }
 
-    // Allocate set
+    // Allocate one set per frame slot
+    VkDescriptorSetLayout layouts[FRAME_COUNT];
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) layouts[f] = s_rtDescSetLayout;
     VkDescriptorSetAllocateInfo allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = s_rtDescPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &s_rtDescSetLayout;
+    allocInfo.descriptorSetCount = FRAME_COUNT;
+    allocInfo.pSetLayouts = layouts;
 
-    if (vkAllocateDescriptorSets(s_device, &allocInfo, &s_rtDescSet) != VK_SUCCESS) {
+    if (vkAllocateDescriptorSets(s_device, &allocInfo, s_rtDescSet) != VK_SUCCESS) {
         Log("[VkRT] ERROR: Failed to allocate descriptor set\n");
         return false;
     }
 
-    // Update descriptors
-    VkWriteDescriptorSetAccelerationStructureKHR asWrite = {};
-    asWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
-    asWrite.accelerationStructureCount = 1;
-    asWrite.pAccelerationStructures = &s_tlas;
+    // Update descriptors (the output image is shared, TLAS and uniforms are per frame)
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        VkWriteDescriptorSetAccelerationStructureKHR asWrite = {};
+        asWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
+        asWrite.accelerationStructureCount = 1;
+        asWrite.pAccelerationStructures = &s_tlas[f];
 
-    VkDescriptorImageInfo imageInfo = {};
-    imageInfo.imageView = s_outputImageView;
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageView = s_outputImageView;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = s_uniformBuffer[f];
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(VkRTUniforms);
+
+        VkWriteDescriptorSet writes[3] = {};
+
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].pNext = &asWrite;
+        writes[0].dstSet = s_rtDescSet[f];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorCount = 1;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
 
-    VkDescriptorBufferInfo bufferInfo = {};
-    bufferInfo.buffer = s_uniformBuffer;
-    bufferInfo.offset = 0;
-    bufferInfo.range = sizeof(VkRTUniforms);
-
-    VkWriteDescriptorSet writes[3] = {};
-
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].pNext = &asWrite;
-    writes[0].dstSet = s_rtDescSet;
-    writes[0].dstBinding = 0;
-    writes[0].descriptorCount = 1;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
-
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = s_rtDescSet;
-    writes[1].dstBinding = 1;
-    writes[1].descriptorCount = 1;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    writes[1].pImageInfo = &imageInfo;
-
-    writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[2].dstSet = s_rtDescSet;
-    writes[2].dstBinding = 2;
-    writes[2].descriptorCount = 1;
-    writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[2].pBufferInfo = &bufferInfo;
-
-    vkUpdateDescriptorSets(s_device, 3, writes, 0, nullptr);
-
-    Log("[VkRT] Descriptor set created and updated\n");
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = s_rtDescSet[f];
+        writes[1].dstBinding = 1;
+        writes[1].descriptorCount = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &imageInfo;
+
+        writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[2].dstSet = s_rtDescSet[f];
+        writes[2].dstBinding = 2;
+        writes[2].descriptorCount = 1;
+        writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writes[2].pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(s_device, 3, writes, 0, nullptr);
+    }
+
+    Log("[VkRT] Descriptor sets created and updated (x%u)\n", FRAME_COUNT);
     return true;
 }
 
@@ -1699,11 +1813,30 @@ static bool CreateDescriptorSet() {
 static bool CreateRTPipeline() {
     Log("[VkRT] Creating ray tracing pipeline...\n");
 
-    // Create shader modules from pre-compiled SPIR-V
+    // Create shader modules from pre-compiled SPIR-V. The raygen shader is
+    // specialized on the feature set (vk_specialize.h).
+    std::vector<uint32_t> raygenCode;
+    bool specialized = VkSpirvSpecializeMember(g_rtRayGenSPIRV, g_rtRayGenSPIRV_size, "features",
+                                               VK_SPEC_ID_FEATURES, g_vulkanRTFeatures.Bits(), raygenCode);
+    VkSpecFeatures raygenSpec;
+    VkSpecFeaturesInit(raygenSpec, g_vulkanRTFeatures.Bits());
+    Log("[VkRT] Raygen feature set 0x%02X (%s)\n", raygenSpec.value,
+        specialized ? "specialization constant patched in" : "SPIR-V declares it");
+    if (s_ser) {
+        std::vector<uint32_t> reordered;
+        if (VkSpirvReorderTraceRays(raygenCode.data(), raygenCode.size() * sizeof(uint32_t), SER_PRIMARY_TMAX,
+                                    SER_MATERIAL_RANGES, _countof(SER_MATERIAL_RANGES), SER_HINT_BITS, reordered)) {
+            raygenCode.swap(reordered);
+            SerSetActive("VK_NV_ray_tracing_invocation_reorder", s_serReorders);
+        } else {
+            SerSetFallback("raygen SPIR-V has no rewritable secondary traces or failed the rewrite check");
+        }
+    }
+
     VkShaderModuleCreateInfo raygenModuleInfo = {};
     raygenModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    raygenModuleInfo.codeSize = g_rtRayGenSPIRV_size;
-    raygenModuleInfo.pCode = g_rtRayGenSPIRV;
+    raygenModuleInfo.codeSize = raygenCode.size() * sizeof(uint32_t);
+    raygenModuleInfo.pCode = raygenCode.data();
 
     VkShaderModule raygenModule;
     if (vkCreateShaderModule(s_device, &raygenModuleInfo, nullptr, &raygenModule) != VK_SUCCESS) {
@@ -1744,6 +1877,7 @@ static bool CreateRTPipeline() {
     stages[0].stage = VK_SHADER_STAGE_RAYGEN_BIT_KHR;
     stages[0].module = raygenModule;
     stages[0].pName = "main";
+    stages[0].pSpecializationInfo = &raygenSpec.info;
 
     // Miss
     stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -1808,7 +1942,7 @@ static bool CreateRTPipeline() {
     pipelineInfo.maxPipelineRayRecursionDepth = 2;
     pipelineInfo.layout = s_rtPipelineLayout;
 
-    if (pvkCreateRayTracingPipelinesKHR(s_device, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &s_rtPipeline) != VK_SUCCESS) {
+    if (pvkCreateRayTracingPipelinesKHR(s_device, VK_NULL_HANDLE, s_pipelineCache, 1, &pipelineInfo, nullptr, &s_rtPipeline) != VK_SUCCESS) {
         Log("[VkRT] ERROR: Failed to create ray tracing pipeline\n");
         vkDestroyPipelineLayout(s_device, s_rtPipelineLayout, nullptr);
         s_rtPipelineLayout = VK_NULL_HANDLE;
@@ -1857,16 +1991,13 @@ static bool CreateShaderBindingTable() {
     if (!CreateBuffer(sbtSize,
                       VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                      s_sbtBuffer, s_sbtMemory)) {
+                      s_sbtBuffer, s_sbtMemory, false, baseAlignment)) {
         Log("[VkRT] ERROR: Failed to create SBT buffer\n");
         return false;
     }
 
     // Map and fill SBT
-    void* sbtData;
-    vkMapMemory(s_device, s_sbtMemory, 0, sbtSize, 0, &sbtData);
-
-    uint8_t* pSbt = (uint8_t*)sbtData;
+    uint8_t* pSbt = (uint8_t*)s_sbtMemory.mapped;
     VkDeviceAddress sbtAddress = GetBufferDeviceAddress(s_sbtBuffer);
 
     // Raygen region
@@ -1890,13 +2021,22 @@ static bool CreateShaderBindingTable() {
     // Callable region (empty)
     s_callableRegion = {};
 
-    vkUnmapMemory(s_device, s_sbtMemory);
-
     Log("[VkRT] Shader binding table created (raygen: %llu, miss: %llu, hit: %llu)\n",
         s_raygenRegion.deviceAddress, s_missRegion.deviceAddress, s_hitRegion.deviceAddress);
     return true;
 }
 
+// ============== VRAM CATEGORIES ==============
+// Sub-allocated sizes of this renderer's acceleration structures and images (vram_budget.h)
+static void VramCategoriesRT(UINT64 bytes[VRAM_CATEGORY_COUNT]) {
+    bytes[VRAM_BLAS] += s_blasStaticMemory.size + s_blasCubesMemory.size;
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        bytes[VRAM_TLAS] += s_tlasMemory[f].size + s_instanceMemory[f].size;
+        bytes[VRAM_SCRATCH] += s_tlasScratchMemory[f].size;
+    }
+    bytes[VRAM_GBUFFER] += s_outputMemory.size;
+}
+
 // ============== INITIALIZATION ==============
 bool InitVulkanRT(HWND hwnd) {
     Log("[VkRT] Initializing Vulkan Ray Tracing renderer...\n");
@@ -1904,6 +2044,7 @@ bool InitVulkanRT(HWND hwnd) {
     // Note: g_vulkanRTFeatures is already set by ShowVulkanRTSettingsDialog() in main.cpp
 
     // ========== Step 1: Create Vulkan Instance ==========
+    StartupStep("Instance + device");
     VkApplicationInfo appInfo = {};
     appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
     appInfo.pApplicationName = "RenderTestGPU - Vulkan RT";
@@ -1991,8 +2132,7 @@ bool InitVulkanRT(HWND hwnd) {
         if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
             s_graphicsFamily = i;
         }
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(s_physicalDevice, i, s_surface, &presentSupport);
+        VkBool32 presentSupport = VkPresentFamilySupported(s_physicalDevice, i, s_surface, queueFamilies[i].queueFlags);
         if (presentSupport) {
             s_presentFamily = i;
         }
@@ -2007,7 +2147,9 @@ bool InitVulkanRT(HWND hwnd) {
     // ========== Step 5: Create Logical Device with RT Extensions ==========
     float queuePriority = 1.0f;
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+    s_transferFamily = VkUploadFindTransferFamily(s_physicalDevice);
     std::set<uint32_t> uniqueQueueFamilies = {s_graphicsFamily, s_presentFamily};
+    if (s_transferFamily != UINT32_MAX) uniqueQueueFamilies.insert(s_transferFamily);
 
     for (uint32_t queueFamily : uniqueQueueFamilies) {
         VkDeviceQueueCreateInfo queueCreateInfo = {};
@@ -2052,6 +2194,27 @@ bool InitVulkanRT(HWND hwnd) {
         if (avail) deviceExtensions.push_back(ext);
     }
 
+    // Zero-copy present: STORAGE swapchain images via a mutable-format swapchain
+    if (g_zeroCopyPresent) {
+        VkSurfaceCapabilitiesKHR caps = {};
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(s_physicalDevice, s_surface, &caps);
+        VkFormatProperties rgbaProps = {};
+        vkGetPhysicalDeviceFormatProperties(s_physicalDevice, VK_FORMAT_R8G8B8A8_UNORM, &rgbaProps);
+        bool hasFormatList = hasExt(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME);
+        if (hasExt(VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME) && hasFormatList &&
+            (caps.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) &&
+            (rgbaProps.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)) {
+            deviceExtensions.push_back(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME);
+            s_zeroCopy = true;
+            Log("[VkRT] Zero-copy present: storage swapchain images (VK_KHR_swapchain_mutable_format)\n");
+        } else {
+            Log("[VkRT] Zero-copy present not supported (mutable format %s, storage usage %s), using the copy path\n",
+                hasExt(VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME) ? "YES" : "NO",
+                (caps.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) ? "YES" : "NO");
+        }
+    }
+
     // Check for any RT-related extensions
     Log("[VkRT] All RT-related extensions on this GPU:\n");
     for (const auto& e : availExts) {
@@ -2080,6 +2243,49 @@ bool InitVulkanRT(HWND hwnd) {
     deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
     deviceFeatures2.pNext = &accelStructFeatures;
 
+    VkPresentWaitEnable(s_physicalDevice, deviceExtensions, &deviceFeatures2.pNext, "Vulkan RT");
+    VkMemBudgetEnable(s_physicalDevice, deviceExtensions);
+    s_encodeFamily = VkRecordEnable(s_instance, s_physicalDevice, deviceExtensions, &deviceFeatures2.pNext, "Vulkan RT");
+    if (s_encodeFamily != UINT32_MAX && !uniqueQueueFamilies.count(s_encodeFamily)) {
+        VkDeviceQueueCreateInfo queueCreateInfo = {};
+        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueCreateInfo.queueFamilyIndex = s_encodeFamily;
+        queueCreateInfo.queueCount = 1;
+        queueCreateInfo.pQueuePriorities = &queuePriority;
+        queueCreateInfos.push_back(queueCreateInfo);
+    }
+
+    // --ser: invocation reorder feature; the property says whether the device
+    // actually regroups threads or treats the reorder as a no-op
+    VkPhysicalDeviceRayTracingInvocationReorderFeaturesNV reorderFeatures = {};
+    reorderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_INVOCATION_REORDER_FEATURES_NV;
+    s_ser = false;
+    if (g_ser) {
+        if (hasExt(VK_NV_RAY_TRACING_INVOCATION_REORDER_EXTENSION_NAME)) {
+            VkPhysicalDeviceFeatures2 query = {};
+            query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            query.pNext = &reorderFeatures;
+            vkGetPhysicalDeviceFeatures2(s_physicalDevice, &query);
+            reorderFeatures.pNext = nullptr;
+        }
+        if (reorderFeatures.rayTracingInvocationReorder) {
+            VkPhysicalDeviceRayTracingInvocationReorderPropertiesNV reorderProps = {};
+            reorderProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_INVOCATION_REORDER_PROPERTIES_NV;
+            VkPhysicalDeviceProperties2 props2 = {};
+            props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            props2.pNext = &reorderProps;
+            vkGetPhysicalDeviceProperties2(s_physicalDevice, &props2);
+
+            deviceExtensions.push_back(VK_NV_RAY_TRACING_INVOCATION_REORDER_EXTENSION_NAME);
+            reorderFeatures.pNext = deviceFeatures2.pNext;
+            deviceFeatures2.pNext = &reorderFeatures;
+            s_ser = true;
+            s_serReorders = reorderProps.rayTracingInvocationReorderReorderingHint == VK_RAY_TRACING_INVOCATION_REORDER_MODE_REORDER_NV;
+        } else {
+            SerSetFallback("no VK_NV_ray_tracing_invocation_reorder on this device");
+        }
+    }
+
     VkDeviceCreateInfo deviceInfo = {};
     deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     deviceInfo.pNext = &deviceFeatures2;
@@ -2098,6 +2304,11 @@ bool InitVulkanRT(HWND hwnd) {
 
     vkGetDeviceQueue(s_device, s_graphicsFamily, 0, &s_graphicsQueue);
     vkGetDeviceQueue(s_device, s_presentFamily, 0, &s_presentQueue);
+    VkPresentWaitInit(s_device);
+    VkMemInit(s_physicalDevice, s_device, true, "VkRT");
+    s_pipelineCache = VkPipelineCacheLoad(s_physicalDevice, s_device, "rt", "VkRT");
+    if (s_encodeFamily != UINT32_MAX) VkRecordInit(s_device, s_graphicsFamily);
+    s_presentMode = VkPresentChooseMode(s_physicalDevice, s_surface, VK_PRESENT_MODE_IMMEDIATE_KHR, "Vulkan RT");
 
     // Load RT extension functions
     if (!LoadRTExtensions()) {
@@ -2115,70 +2326,8 @@ bool InitVulkanRT(HWND hwnd) {
         s_rtProperties.shaderGroupHandleSize, s_rtProperties.maxRayRecursionDepth);
 
     // ========== Step 6: Create Swapchain ==========
-    VkSurfaceCapabilitiesKHR surfaceCaps;
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(s_physicalDevice, s_surface, &surfaceCaps);
-
-    s_swapchainExtent = {W, H};
-    if (surfaceCaps.currentExtent.width != UINT32_MAX) {
-        s_swapchainExtent = surfaceCaps.currentExtent;
-    }
-
-    uint32_t imageCount = surfaceCaps.minImageCount + 1;
-    if (surfaceCaps.maxImageCount > 0 && imageCount > surfaceCaps.maxImageCount) {
-        imageCount = surfaceCaps.maxImageCount;
-    }
-
-    VkSwapchainCreateInfoKHR swapchainInfo = {};
-    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-    swapchainInfo.surface = s_surface;
-    swapchainInfo.minImageCount = imageCount;
-    swapchainInfo.imageFormat = VK_FORMAT_B8G8R8A8_UNORM;
-    swapchainInfo.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
-    swapchainInfo.imageExtent = s_swapchainExtent;
-    swapchainInfo.imageArrayLayers = 1;
-    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-
-    uint32_t queueFamilyIndices[] = {s_graphicsFamily, s_presentFamily};
-    if (s_graphicsFamily != s_presentFamily) {
-        swapchainInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-        swapchainInfo.queueFamilyIndexCount = 2;
-        swapchainInfo.pQueueFamilyIndices = queueFamilyIndices;
-    } else {
-        swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    }
-
-    swapchainInfo.preTransform = surfaceCaps.currentTransform;
-    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapchainInfo.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;  // No vsync
-    swapchainInfo.clipped = VK_TRUE;
-
-    if (vkCreateSwapchainKHR(s_device, &swapchainInfo, nullptr, &s_swapchain) != VK_SUCCESS) {
-        Log("[VkRT] ERROR: Failed to create swapchain\n");
-        return false;
-    }
-    Log("[VkRT] Swapchain created (%ux%u)\n", s_swapchainExtent.width, s_swapchainExtent.height);
-
-    // Get swapchain images
-    vkGetSwapchainImagesKHR(s_device, s_swapchain, &imageCount, nullptr);
-    s_swapchainImages.resize(imageCount);
-    vkGetSwapchainImagesKHR(s_device, s_swapchain, &imageCount, s_swapchainImages.data());
-    s_swapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
-
-    // Create image views
-    s_swapchainImageViews.resize(imageCount);
-    for (uint32_t i = 0; i < imageCount; i++) {
-        VkImageViewCreateInfo viewInfo = {};
-        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        viewInfo.image = s_swapchainImages[i];
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewInfo.format = s_swapchainFormat;
-        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
-        viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
-        vkCreateImageView(s_device, &viewInfo, nullptr, &s_swapchainImageViews[i]);
-    }
+    StartupStep("Swap chain + frame resources");
+    if (!CreateSwapchainRT(VK_NULL_HANDLE)) return false;
 
     // ========== Step 7: Create Command Pool ==========
     VkCommandPoolCreateInfo poolInfo = {};
@@ -2191,14 +2340,13 @@ bool InitVulkanRT(HWND hwnd) {
         return false;
     }
 
-    // Create command buffers
-    s_commandBuffers.resize(imageCount);
+    // Create command buffers (one per frame in flight)
     VkCommandBufferAllocateInfo allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.commandPool = s_commandPool;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = imageCount;
-    vkAllocateCommandBuffers(s_device, &allocInfo, s_commandBuffers.data());
+    allocInfo.commandBufferCount = FRAME_COUNT;
+    vkAllocateCommandBuffers(s_device, &allocInfo, s_commandBuffers);
 
     // ========== Step 8: Create Sync Objects ==========
     VkSemaphoreCreateInfo semaphoreInfo = {};
@@ -2208,9 +2356,11 @@ bool InitVulkanRT(HWND hwnd) {
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_imageAvailableSemaphore);
-    vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_renderFinishedSemaphore);
-    vkCreateFence(s_device, &fenceInfo, nullptr, &s_inFlightFence);
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_imageAvailableSemaphores[f]);
+        vkCreateFence(s_device, &fenceInfo, nullptr, &s_inFlightFences[f]);
+    }
+    CreateRenderFinishedSemaphores();
 
     // Set GPU name for display
     gpuName = std::wstring(s_gpuName.begin(), s_gpuName.end());
@@ -2219,15 +2369,18 @@ bool InitVulkanRT(HWND hwnd) {
     Log("[VkRT] GPU: %s\n", s_gpuName.c_str());
 
     // ========== Step 9: Create Geometry Buffers ==========
+    StartupStep("Geometry + upload");
     if (!CreateGeometryBuffers()) {
         CleanupVulkanRT();
         return false;
     }
 
     // ========== Step 10: Create BLAS ==========
+    StartupStep("Acceleration structures");
     Log("[VkRT] Creating BLAS for static geometry...\n");
     if (!CreateBLAS(s_staticVertexBuffer, s_staticIndexBuffer, s_staticVertexCount, s_staticIndexCount,
-                    s_blasStatic, s_blasStaticBuffer, s_blasStaticMemory)) {
+                    s_staticVertexStride, s_staticIndexType,
+                    s_blasStatic, s_blasStaticBuffer, s_blasStaticMemory, "static")) {
         CleanupVulkanRT();
         return false;
     }
@@ -2235,7 +2388,8 @@ bool InitVulkanRT(HWND hwnd) {
 
     Log("[VkRT] Creating BLAS for cubes...\n");
     if (!CreateBLAS(s_cubesVertexBuffer, s_cubesIndexBuffer, s_cubesVertexCount, s_cubesIndexCount,
-                    s_blasCubes, s_blasCubesBuffer, s_blasCubesMemory)) {
+                    s_cubesVertexStride, s_cubesIndexType,
+                    s_blasCubes, s_blasCubesBuffer, s_blasCubesMemory, "cubes")) {
         CleanupVulkanRT();
         return false;
     }
@@ -2248,6 +2402,7 @@ bool InitVulkanRT(HWND hwnd) {
     }
 
     // ========== Step 12: Create Output Image ==========
+    StartupStep("Output image + descriptors");
     if (!CreateOutputImage()) {
         CleanupVulkanRT();
         return false;
@@ -2272,6 +2427,7 @@ bool InitVulkanRT(HWND hwnd) {
     }
 
     // ========== Step 16: Create RT Pipeline ==========
+    StartupStep("RT pipeline + SBT");
     if (!CreateRTPipeline()) {
         CleanupVulkanRT();
         return false;
@@ -2284,11 +2440,16 @@ bool InitVulkanRT(HWND hwnd) {
     }
 
     // ========== Step 18: Initialize Text Rendering ==========
+    StartupStep("Overlay + timers");
     if (!InitTextResources()) {
         Log("[VkRT] Warning: Text rendering initialization failed (non-fatal)\n");
         // Don't fail init - text is optional
     }
 
+    // ========== Step 19: GPU Timestamp Queries (optional) ==========
+    CreateTimestampQueryPool();
+
+    VramSetCategories(VramCategoriesRT);
     Log("[VkRT] ===== Vulkan RT fully initialized! =====\n");
     return true;
 }
@@ -2301,10 +2462,10 @@ void RenderVulkanRT() {
         Log("[VkRT] === First Render Frame Debug ===\n");
         Log("[VkRT] RT Pipeline: %p\n", (void*)s_rtPipeline);
         Log("[VkRT] RT PipelineLayout: %p\n", (void*)s_rtPipelineLayout);
-        Log("[VkRT] RT DescSet: %p\n", (void*)s_rtDescSet);
-        Log("[VkRT] TLAS: %p\n", (void*)s_tlas);
+        Log("[VkRT] RT DescSet: %p\n", (void*)s_rtDescSet[0]);
+        Log("[VkRT] TLAS: %p\n", (void*)s_tlas[0]);
         Log("[VkRT] Output Image: %p, View: %p\n", (void*)s_outputImage, (void*)s_outputImageView);
-        Log("[VkRT] Uniform Buffer: %p (mapped: %p)\n", (void*)s_uniformBuffer, s_uniformMapped);
+        Log("[VkRT] Uniform Buffer: %p (mapped: %p)\n", (void*)s_uniformBuffer[0], s_uniformMapped[0]);
         Log("[VkRT] Swapchain Extent: %ux%u\n", s_swapchainExtent.width, s_swapchainExtent.height);
         Log("[VkRT] SBT Raygen: addr=%llu stride=%llu size=%llu\n",
             s_raygenRegion.deviceAddress, s_raygenRegion.stride, s_raygenRegion.size);
@@ -2316,85 +2477,58 @@ void RenderVulkanRT() {
         Log("[VkRT] Cubes geometry: %u verts, %u indices\n", s_cubesVertexCount, s_cubesIndexCount);
     }
 
-    // Wait for previous frame
-    vkWaitForFences(s_device, 1, &s_inFlightFence, VK_TRUE, UINT64_MAX);
-    vkResetFences(s_device, 1, &s_inFlightFence);
+    // Wait for the frame that last used this slot (FRAME_COUNT frames ago)
+    uint32_t frame = s_frameCount % FRAME_COUNT;
+    vkWaitForFences(s_device, 1, &s_inFlightFences[frame], VK_TRUE, UINT64_MAX);
+    VkCaptureCollect(frame);
+    VkRecordCollect(frame);
+    VkPresentFrameBegin(s_swapchain, FRAME_COUNT);
 
-    // Acquire next image
+    // Acquire next image (fence is reset only once we know we will submit)
     uint32_t imageIndex;
-    vkAcquireNextImageKHR(s_device, s_swapchain, UINT64_MAX, s_imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    if (VkPresentAcquire(s_device, s_swapchain, s_graphicsQueue, s_imageAvailableSemaphores[frame],
+                         &imageIndex) == VK_ERROR_OUT_OF_DATE_KHR) {
+        ResizeVulkanRT();
+        return;
+    }
+    vkResetFences(s_device, 1, &s_inFlightFences[frame]);
+
+    // That frame is complete - read its timestamps before the slot is reused
+    uint32_t timestampSlot = frame;
+    CollectTimestamps(frame);
+
+    if (s_zeroCopy) BindSwapchainStorageView(frame, imageIndex);
 
     // Update uniform buffer with current time and feature flags
     LARGE_INTEGER currentTime;
     QueryPerformanceCounter(&currentTime);
     float elapsedTime = (float)(currentTime.QuadPart - g_startTime.QuadPart) / (float)g_perfFreq.QuadPart;
 
-    VkRTUniforms* uniforms = (VkRTUniforms*)s_uniformMapped;
-    uniforms->time = elapsedTime;
-    uniforms->lightPos[0] = 0.0f;
-    uniforms->lightPos[1] = 0.92f;
-    uniforms->lightPos[2] = 0.0f;
-    uniforms->lightRadius = g_vulkanRTFeatures.lightRadius;
-    uniforms->frameCount = s_frameCount;
-    uniforms->shadowSamples = g_vulkanRTFeatures.shadowSamples;
-    uniforms->aoSamples = g_vulkanRTFeatures.aoSamples;
-    uniforms->aoRadius = g_vulkanRTFeatures.aoRadius;
-
-    // Build feature flags
-    uniforms->features = 0;
-    if (g_vulkanRTFeatures.spotlight) uniforms->features |= (1u << 0);
-    if (g_vulkanRTFeatures.softShadows) uniforms->features |= (1u << 1);
-    if (g_vulkanRTFeatures.ambientOcclusion) uniforms->features |= (1u << 2);
-    if (g_vulkanRTFeatures.globalIllum) uniforms->features |= (1u << 3);
-    if (g_vulkanRTFeatures.reflections) uniforms->features |= (1u << 4);
-    if (g_vulkanRTFeatures.glassRefraction) uniforms->features |= (1u << 5);
+    WriteUniforms((VkRTUniforms*)s_uniformMapped[frame], elapsedTime, s_frameCount);
 
     // Update cube transform for animation
-    UpdateCubeTransform(elapsedTime);
+    UpdateCubeTransform(elapsedTime, frame);
 
     // Reset and begin command buffer
-    VkCommandBuffer cmd = s_commandBuffers[imageIndex];
+    VkCommandBuffer cmd = s_commandBuffers[frame];
     vkResetCommandBuffer(cmd, 0);
 
     VkCommandBufferBeginInfo beginInfo = {};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     vkBeginCommandBuffer(cmd, &beginInfo);
 
-    // Rebuild TLAS with updated cube transform
-    RebuildTLAS(cmd);
-
-    // Bind ray tracing pipeline
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, s_rtPipeline);
-
-    // Bind descriptor set
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, s_rtPipelineLayout,
-                            0, 1, &s_rtDescSet, 0, nullptr);
+    if (s_timestampPool) vkCmdResetQueryPool(cmd, s_timestampPool, timestampSlot * TIMESTAMP_STAMPS, TIMESTAMP_STAMPS);
+    WriteTimestamp(cmd, timestampSlot, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
 
-    // Dispatch rays
-    pvkCmdTraceRaysKHR(cmd, &s_raygenRegion, &s_missRegion, &s_hitRegion, &s_callableRegion,
-                       s_swapchainExtent.width, s_swapchainExtent.height, 1);
+    // Rebuild TLAS with updated cube transform
+    RebuildTLAS(cmd, frame);
+    WriteTimestamp(cmd, timestampSlot, 1, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR);
 
-    // Transition output image for copy
-    VkImageMemoryBarrier outputBarrier = {};
-    outputBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    outputBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-    outputBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    outputBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    outputBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    outputBarrier.image = s_outputImage;
-    outputBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    outputBarrier.subresourceRange.baseMipLevel = 0;
-    outputBarrier.subresourceRange.levelCount = 1;
-    outputBarrier.subresourceRange.baseArrayLayer = 0;
-    outputBarrier.subresourceRange.layerCount = 1;
-    outputBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    outputBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-    // Transition swapchain image for copy
+    // Swapchain image: copy destination, or the storage image itself with --zero-copy
     VkImageMemoryBarrier swapBarrier = {};
     swapBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     swapBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    swapBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    swapBarrier.newLayout = s_zeroCopy ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
     swapBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     swapBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     swapBarrier.image = s_swapchainImages[imageIndex];
@@ -2404,32 +2538,82 @@ void RenderVulkanRT() {
     swapBarrier.subresourceRange.baseArrayLayer = 0;
     swapBarrier.subresourceRange.layerCount = 1;
     swapBarrier.srcAccessMask = 0;
-    swapBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-    VkImageMemoryBarrier barriers[2] = {outputBarrier, swapBarrier};
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         0, 0, nullptr, 0, nullptr, 2, barriers);
-
-    // Copy output image to swapchain
-    VkImageCopy copyRegion = {};
-    copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    copyRegion.srcSubresource.layerCount = 1;
-    copyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    copyRegion.dstSubresource.layerCount = 1;
-    copyRegion.extent = {s_swapchainExtent.width, s_swapchainExtent.height, 1};
+    swapBarrier.dstAccessMask = s_zeroCopy ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_TRANSFER_WRITE_BIT;
+    if (s_zeroCopy) {
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+                             0, 0, nullptr, 0, nullptr, 1, &swapBarrier);
+    }
 
-    vkCmdCopyImage(cmd, s_outputImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   s_swapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                   1, &copyRegion);
+    // Bind ray tracing pipeline
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, s_rtPipeline);
 
-    // Transition output image back to general for next frame
-    outputBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    outputBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    outputBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    outputBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    // Bind descriptor set
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, s_rtPipelineLayout,
+                            0, 1, &s_rtDescSet[frame], 0, nullptr);
 
-    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
-                         0, 0, nullptr, 0, nullptr, 1, &outputBarrier);
+    // Dispatch rays
+    pvkCmdTraceRaysKHR(cmd, &s_raygenRegion, &s_missRegion, &s_hitRegion, &s_callableRegion,
+                       s_swapchainExtent.width, s_swapchainExtent.height, 1);
+    WriteTimestamp(cmd, timestampSlot, 2, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR);
+
+    // --capture: the traced image, before the overlay. Both sources are in GENERAL
+    // here and hold the swap chain's byte order (see CreateSwapchainRT)
+    if (!s_zeroCopy || s_swapchainCapture) {
+        VkCaptureRecord(s_physicalDevice, s_device, cmd, s_zeroCopy ? s_swapchainImages[imageIndex] : s_outputImage,
+                        s_swapchainExtent, s_swapchainFormat != VK_FORMAT_R8G8B8A8_UNORM,
+                        VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+                        frame, s_frameCount, "vulkan_rt");
+    }
+    // --record: same image read back for the CPU conversion; uploads an earlier
+    // converted frame and hands it to the encode queue
+    VkSemaphore recordSemaphore = VkRecordFrame(cmd, s_zeroCopy ? (s_swapchainCapture ? s_swapchainImages[imageIndex] : VK_NULL_HANDLE)
+                                                : s_outputImage, s_swapchainExtent, s_swapchainFormat != VK_FORMAT_R8G8B8A8_UNORM,
+                                                VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, frame);
+
+    if (!s_zeroCopy) {
+        // Transition output image for copy
+        VkImageMemoryBarrier outputBarrier = {};
+        outputBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        outputBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        outputBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        outputBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        outputBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        outputBarrier.image = s_outputImage;
+        outputBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        outputBarrier.subresourceRange.baseMipLevel = 0;
+        outputBarrier.subresourceRange.levelCount = 1;
+        outputBarrier.subresourceRange.baseArrayLayer = 0;
+        outputBarrier.subresourceRange.layerCount = 1;
+        outputBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        outputBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        // The layout transition also waits for the --capture / --record readback copies
+        VkImageMemoryBarrier barriers[2] = {outputBarrier, swapBarrier};
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 2, barriers);
+
+        // Copy output image to swapchain
+        VkImageCopy copyRegion = {};
+        copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.srcSubresource.layerCount = 1;
+        copyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.dstSubresource.layerCount = 1;
+        copyRegion.extent = {s_swapchainExtent.width, s_swapchainExtent.height, 1};
+
+        vkCmdCopyImage(cmd, s_outputImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       s_swapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1, &copyRegion);
+
+        // Transition output image back to general for next frame
+        outputBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        outputBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        outputBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        outputBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+                             0, 0, nullptr, 0, nullptr, 1, &outputBarrier);
+    }
+    WriteTimestamp(cmd, timestampSlot, 3, VK_PIPELINE_STAGE_TRANSFER_BIT);
 
     // ========== TEXT RENDERING ==========
     if (s_textPipeline && s_textVertexMapped && !s_framebuffers.empty()) {
@@ -2447,54 +2631,35 @@ void RenderVulkanRT() {
             lastFpsTime = fpsTime;
         }
 
-        // Build text string
-        char textBuf[512];
-        snprintf(textBuf, sizeof(textBuf), "API: Vulkan RT (VK_KHR_ray_tracing_pipeline)\nGPU: %s\nFPS: %.0f\nTriangles: %d\nResolution: %ux%u",
-                 s_gpuName.c_str(), displayFps, 200,  // Approximate triangle count for RT
-                 s_swapchainExtent.width, s_swapchainExtent.height);
-
-        // Build vertices
-        s_textVertCount = 0;
-        float scale = 1.5f;
-        float shadowOff = 2.0f;
-        float charW = 8.0f * scale;
-        float charH = 8.0f * scale;
-        float textX = 10.0f, textY = 10.0f;
-
-        // Lambda to add text
-        auto addTextVerts = [&](const char* text, float startX, float startY, float cr, float cg, float cb, float ca) {
-            float cx = startX, cy = startY;
-            for (const char* p = text; *p && s_textVertCount < 5994; p++) {
-                if (*p == '\n') { cx = startX; cy += charH * 1.4f; continue; }
-                if (*p < 32 || *p > 127) continue;
-                int idx = *p - 32;
-                int col = idx % 16, row = idx / 16;
-                float u0 = col * 8.0f / 128.0f, v0 = row * 8.0f / 48.0f;
-                float u1 = u0 + 8.0f / 128.0f, v1 = v0 + 8.0f / 48.0f;
-                float x0 = cx / s_swapchainExtent.width * 2.0f - 1.0f;
-                float y0 = cy / s_swapchainExtent.height * 2.0f - 1.0f;
-                float x1 = (cx + charW) / s_swapchainExtent.width * 2.0f - 1.0f;
-                float y1 = (cy + charH) / s_swapchainExtent.height * 2.0f - 1.0f;
-
-                s_textVerts[s_textVertCount++] = {x0, y0, u0, v0, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x1, y0, u1, v0, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x0, y1, u0, v1, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x1, y0, u1, v0, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x1, y1, u1, v1, cr, cg, cb, ca};
-                s_textVerts[s_textVertCount++] = {x0, y1, u0, v1, cr, cg, cb, ca};
-                cx += charW;
-            }
-        };
+        char gpuTimes[160];
+        GpuProfilerFormat(gpuTimes, sizeof(gpuTimes));
+        char latencyBuf[96];
+        LatencyFormat(latencyBuf, sizeof(latencyBuf));
+        char vramBuf[192];
+        VramFormat(vramBuf, sizeof(vramBuf));
 
-        // Shadow + main text
-        addTextVerts(textBuf, textX + shadowOff, textY + shadowOff, 0.0f, 0.0f, 0.0f, 0.7f);
-        addTextVerts(textBuf, textX, textY, 1.0f, 1.0f, 1.0f, 1.0f);
+        // Build text string
+        char textBuf[800];
+        snprintf(textBuf, sizeof(textBuf), "API: Vulkan RT (VK_KHR_ray_tracing_pipeline)%s\nGPU: %s\nFPS: %.0f\nTriangles: %d\nResolution: %ux%u%s%s%s%s%s%s%s%s",
+                 s_zeroCopy ? " zero-copy" : "", s_gpuName.c_str(), displayFps, 200,  // Approximate triangle count for RT
+                 s_swapchainExtent.width, s_swapchainExtent.height, gpuTimes[0] ? "\n" : "", gpuTimes,
+                 latencyBuf[0] ? "\n" : "", latencyBuf, vramBuf[0] ? "\n" : "", vramBuf,
+                 g_ser ? "\n" : "", SerOverlayText());
+
+        // Shadow + main text, laid out only when the string changed
+        if (OverlaySetText(s_overlay, textBuf)) {
+            s_textVertCount = OverlayExpandVerts(s_overlay, s_textVerts, TEXT_MAX_VERTS,
+                2.0f / s_swapchainExtent.width, 2.0f / s_swapchainExtent.height, -1.0f, -1.0f);
+        }
 
         if (s_textVertCount > 0) {
             // Copy to GPU
-            memcpy(s_textVertexMapped, s_textVerts, s_textVertCount * sizeof(TextVert));
+            if (s_textSliceVersion[frame] != s_overlay.version) {
+                memcpy((TextVert*)s_textVertexMapped + frame * TEXT_MAX_VERTS, s_textVerts, s_textVertCount * sizeof(TextVert));
+                s_textSliceVersion[frame] = s_overlay.version;
+            }
 
-            // Begin render pass (swapchain is in TRANSFER_DST_OPTIMAL, pass will transition to PRESENT_SRC_KHR)
+            // Begin render pass (swapchain is in TRANSFER_DST_OPTIMAL or GENERAL, pass will transition to PRESENT_SRC_KHR)
             VkRenderPassBeginInfo renderPassInfo = {};
             renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
             renderPassInfo.renderPass = s_textRenderPass;
@@ -2504,81 +2669,157 @@ void RenderVulkanRT() {
 
             vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
+            VkViewport viewport = { 0, 0, (float)s_swapchainExtent.width, (float)s_swapchainExtent.height, 0, 1 };
+            VkRect2D scissor = { {0, 0}, s_swapchainExtent };
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+
             vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, s_textPipeline);
             vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, s_textPipelineLayout,
                                     0, 1, &s_textDescSet, 0, nullptr);
 
             VkBuffer textVBs[] = { s_textVertexBuffer };
-            VkDeviceSize textOffsets[] = { 0 };
+            VkDeviceSize textOffsets[] = { sizeof(TextVert) * TEXT_MAX_VERTS * frame };
             vkCmdBindVertexBuffers(cmd, 0, 1, textVBs, textOffsets);
             vkCmdDraw(cmd, s_textVertCount, 1, 0, 0);
 
             vkCmdEndRenderPass(cmd);
         } else {
             // No text - still need to transition swapchain to present
-            swapBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            swapBarrier.oldLayout = swapBarrier.newLayout;
             swapBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-            swapBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            swapBarrier.srcAccessMask = swapBarrier.dstAccessMask;
             swapBarrier.dstAccessMask = 0;
-            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            vkCmdPipelineBarrier(cmd, s_zeroCopy ? VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR : VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
                                  0, 0, nullptr, 0, nullptr, 1, &swapBarrier);
         }
     } else {
         // No text resources - transition swapchain for present
-        swapBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        swapBarrier.oldLayout = swapBarrier.newLayout;
         swapBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        swapBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        swapBarrier.srcAccessMask = swapBarrier.dstAccessMask;
         swapBarrier.dstAccessMask = 0;
-        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        vkCmdPipelineBarrier(cmd, s_zeroCopy ? VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR : VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
                              0, 0, nullptr, 0, nullptr, 1, &swapBarrier);
     }
 
+    WriteTimestamp(cmd, timestampSlot, 4, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    if (s_timestampPool) s_timestampPending[timestampSlot] = true;
+
     vkEndCommandBuffer(cmd);
 
     // Submit
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    // The swapchain image is first written by the transfer copy (or the raygen shader with
+    // --zero-copy), so the acquire wait must cover that stage
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    if (s_zeroCopy) waitStages[0] |= VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
     submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &s_imageAvailableSemaphore;
+    submitInfo.pWaitSemaphores = &s_imageAvailableSemaphores[frame];
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmd;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &s_renderFinishedSemaphore;
+    VkSemaphore signalSemaphores[] = {s_renderFinishedSemaphores[imageIndex], recordSemaphore};
+    submitInfo.signalSemaphoreCount = recordSemaphore ? 2 : 1;
+    submitInfo.pSignalSemaphores = signalSemaphores;
 
-    vkQueueSubmit(s_graphicsQueue, 1, &submitInfo, s_inFlightFence);
+    vkQueueSubmit(s_graphicsQueue, 1, &submitInfo, s_inFlightFences[frame]);
+    if (recordSemaphore) VkRecordSubmit();
 
     // Present
     VkPresentInfoKHR presentInfo = {};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = &s_renderFinishedSemaphore;
+    presentInfo.pWaitSemaphores = &s_renderFinishedSemaphores[imageIndex];
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &s_swapchain;
     presentInfo.pImageIndices = &imageIndex;
 
-    vkQueuePresentKHR(s_presentQueue, &presentInfo);
+    VkResult presentResult = VkPresentQueue(s_presentQueue, presentInfo);
 
     s_frameCount++;
+    if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) ResizeVulkanRT();
+}
+
+// ============== RESIZE ==============
+// Recreate swapchain, text framebuffers and the RT output image at the new
+// size. Pipelines, acceleration structures and the SBT are size-independent.
+bool ResizeVulkanRT() {
+    if (!s_device || !s_swapchain) return false;
+    vkDeviceWaitIdle(s_device);
+    VkCaptureCleanup(s_device);
+    VkRecordCleanup();
+
+    for (auto fb : s_framebuffers) {
+        if (fb) vkDestroyFramebuffer(s_device, fb, nullptr);
+    }
+    s_framebuffers.clear();
+    for (auto iv : s_swapchainImageViews) {
+        if (iv) vkDestroyImageView(s_device, iv, nullptr);
+    }
+    s_swapchainImageViews.clear();
+    for (auto iv : s_swapchainStorageViews) {
+        if (iv) vkDestroyImageView(s_device, iv, nullptr);
+    }
+    s_swapchainStorageViews.clear();
+    s_swapchainImages.clear();
+
+    if (s_outputImageView) { vkDestroyImageView(s_device, s_outputImageView, nullptr); s_outputImageView = VK_NULL_HANDLE; }
+    if (s_outputImage) { vkDestroyImage(s_device, s_outputImage, nullptr); s_outputImage = VK_NULL_HANDLE; }
+    VkMemFree(s_outputMemory);
+
+    size_t oldImageCount = s_renderFinishedSemaphores.size();
+    if (!CreateSwapchainRT(s_swapchain)) return false;
+    if (!CreateOutputImage()) return false;
+    if (s_textRenderPass && !CreateTextFramebuffers()) return false;
+    if (s_swapchainImages.size() != oldImageCount && !CreateRenderFinishedSemaphores()) return false;
+
+    // Point binding 1 of every frame's set at the new storage image
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.imageView = s_outputImageView;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = s_rtDescSet[f];
+        write.dstBinding = 1;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(s_device, 1, &write, 0, nullptr);
+    }
+
+    Log("[VkRT] Resized to %ux%u\n", s_swapchainExtent.width, s_swapchainExtent.height);
+    return true;
 }
 
 void CleanupVulkanRT() {
     Log("[VkRT] Cleanup\n");
+    VramSetCategories(nullptr);
 
     if (s_device != VK_NULL_HANDLE) {
         vkDeviceWaitIdle(s_device);
+        VkCaptureCleanup(s_device);
+        VkRecordShutdown();
     }
 
     // Release all resources in reverse order of creation
     #define SAFE_DESTROY_BUFFER(buf, mem) \
         if (buf != VK_NULL_HANDLE) { vkDestroyBuffer(s_device, buf, nullptr); buf = VK_NULL_HANDLE; } \
-        if (mem != VK_NULL_HANDLE) { vkFreeMemory(s_device, mem, nullptr); mem = VK_NULL_HANDLE; }
+        VkMemFree(mem);
 
     #define SAFE_DESTROY_IMAGE(img, mem, view) \
         if (view != VK_NULL_HANDLE) { vkDestroyImageView(s_device, view, nullptr); view = VK_NULL_HANDLE; } \
         if (img != VK_NULL_HANDLE) { vkDestroyImage(s_device, img, nullptr); img = VK_NULL_HANDLE; } \
-        if (mem != VK_NULL_HANDLE) { vkFreeMemory(s_device, mem, nullptr); mem = VK_NULL_HANDLE; }
+        VkMemFree(mem);
+
+    // Timestamp queries
+    if (s_timestampPool) { vkDestroyQueryPool(s_device, s_timestampPool, nullptr); s_timestampPool = VK_NULL_HANDLE; }
+    memset(s_timestampPending, 0, sizeof(s_timestampPending));
 
     // Text resources
     SAFE_DESTROY_BUFFER(s_textVertexBuffer, s_textVertexMemory);
@@ -2598,16 +2839,21 @@ void CleanupVulkanRT() {
     if (s_rtDescSetLayout) { vkDestroyDescriptorSetLayout(s_device, s_rtDescSetLayout, nullptr); s_rtDescSetLayout = VK_NULL_HANDLE; }
 
     SAFE_DESTROY_IMAGE(s_outputImage, s_outputMemory, s_outputImageView);
-    SAFE_DESTROY_BUFFER(s_uniformBuffer, s_uniformMemory);
-
-    // Acceleration structures
-    if (s_tlas && pvkDestroyAccelerationStructureKHR) {
-        pvkDestroyAccelerationStructureKHR(s_device, s_tlas, nullptr);
-        s_tlas = VK_NULL_HANDLE;
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        SAFE_DESTROY_BUFFER(s_uniformBuffer[f], s_uniformMemory[f]);
+        s_uniformMapped[f] = nullptr;
+        s_rtDescSet[f] = VK_NULL_HANDLE;   // Freed with the pool
+
+        // Acceleration structures
+        if (s_tlas[f] && pvkDestroyAccelerationStructureKHR) {
+            pvkDestroyAccelerationStructureKHR(s_device, s_tlas[f], nullptr);
+            s_tlas[f] = VK_NULL_HANDLE;
+        }
+        SAFE_DESTROY_BUFFER(s_tlasBuffer[f], s_tlasMemory[f]);
+        SAFE_DESTROY_BUFFER(s_instanceBuffer[f], s_instanceMemory[f]);
+        s_instanceMapped[f] = nullptr;
+        SAFE_DESTROY_BUFFER(s_tlasScratchBuffer[f], s_tlasScratchMemory[f]);
     }
-    SAFE_DESTROY_BUFFER(s_tlasBuffer, s_tlasMemory);
-    SAFE_DESTROY_BUFFER(s_instanceBuffer, s_instanceMemory);
-    SAFE_DESTROY_BUFFER(s_tlasScratchBuffer, s_tlasScratchMemory);
 
     if (s_blasCubes && pvkDestroyAccelerationStructureKHR) {
         pvkDestroyAccelerationStructureKHR(s_device, s_blasCubes, nullptr);
@@ -2638,18 +2884,30 @@ void CleanupVulkanRT() {
         if (iv) vkDestroyImageView(s_device, iv, nullptr);
     }
     s_swapchainImageViews.clear();
+    for (auto iv : s_swapchainStorageViews) {
+        if (iv) vkDestroyImageView(s_device, iv, nullptr);
+    }
+    s_swapchainStorageViews.clear();
     s_swapchainImages.clear();
-    if (s_swapchain) { vkDestroySwapchainKHR(s_device, s_swapchain, nullptr); s_swapchain = VK_NULL_HANDLE; }
+    if (s_swapchain) { VkPresentDestroySwapchain(s_device, s_swapchain); s_swapchain = VK_NULL_HANDLE; }
+    s_zeroCopy = false;
+    s_ser = false;
 
     // Sync objects
-    if (s_inFlightFence) { vkDestroyFence(s_device, s_inFlightFence, nullptr); s_inFlightFence = VK_NULL_HANDLE; }
-    if (s_renderFinishedSemaphore) { vkDestroySemaphore(s_device, s_renderFinishedSemaphore, nullptr); s_renderFinishedSemaphore = VK_NULL_HANDLE; }
-    if (s_imageAvailableSemaphore) { vkDestroySemaphore(s_device, s_imageAvailableSemaphore, nullptr); s_imageAvailableSemaphore = VK_NULL_HANDLE; }
+    for (uint32_t f = 0; f < FRAME_COUNT; f++) {
+        if (s_inFlightFences[f]) { vkDestroyFence(s_device, s_inFlightFences[f], nullptr); s_inFlightFences[f] = VK_NULL_HANDLE; }
+        if (s_imageAvailableSemaphores[f]) { vkDestroySemaphore(s_device, s_imageAvailableSemaphores[f], nullptr); s_imageAvailableSemaphores[f] = VK_NULL_HANDLE; }
+        s_commandBuffers[f] = VK_NULL_HANDLE;   // Freed with the pool
+    }
+    DestroyRenderFinishedSemaphores();
 
     // Command pool
     if (s_commandPool) { vkDestroyCommandPool(s_device, s_commandPool, nullptr); s_commandPool = VK_NULL_HANDLE; }
 
     // Device and instance
+    VkPipelineCacheSave(s_physicalDevice, s_device, s_pipelineCache, "rt", "VkRT");
+    VkPresentWaitShutdown();
+    VkMemShutdown();
     if (s_device) { vkDestroyDevice(s_device, nullptr); s_device = VK_NULL_HANDLE; }
     if (s_surface) { vkDestroySurfaceKHR(s_instance, s_surface, nullptr); s_surface = VK_NULL_HANDLE; }
     if (s_instance) { vkDestroyInstance(s_instance, nullptr); s_instance = VK_NULL_HANDLE; }
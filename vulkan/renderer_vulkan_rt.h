@@ -8,3 +8,4 @@
 bool InitVulkanRT(HWND hwnd);
 void RenderVulkanRT();
 void CleanupVulkanRT();
+bool ResizeVulkanRT();  // Recreate swapchain and output image
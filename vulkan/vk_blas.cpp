@@ -0,0 +1,127 @@
+// ============== VULKAN BLAS COMPACTION ==============
+// Query, copy and swap of compactable BLASes (see vk_blas.h)
+
+#include "vk_blas.h"
+#include "../common.h"
+#include "../startup_profiler.h"
+
+static VkCommandBuffer BeginCommands(VkDevice device, VkCommandPool pool) {
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = pool;
+    allocInfo.commandBufferCount = 1;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    if (vkAllocateCommandBuffers(device, &allocInfo, &cmd) != VK_SUCCESS) return VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+    return cmd;
+}
+
+static bool SubmitAndWait(VkDevice device, VkQueue queue, VkCommandPool pool, VkCommandBuffer cmd) {
+    vkEndCommandBuffer(cmd);
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    bool ok = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS &&
+              vkQueueWaitIdle(queue) == VK_SUCCESS;
+    vkFreeCommandBuffers(device, pool, 1, &cmd);
+    return ok;
+}
+
+bool VkCompactBLAS(VkDevice device, VkQueue queue, VkCommandPool pool, VkDeviceSize builtSize,
+                   VkAccelerationStructureKHR& blas, VkBuffer& buffer, VkMemAlloc& memory,
+                   const char* tag, const char* name) {
+    StartupScope scope("BLAS compaction");
+    auto pfnCreate = (PFN_vkCreateAccelerationStructureKHR)vkGetDeviceProcAddr(device, "vkCreateAccelerationStructureKHR");
+    auto pfnDestroy = (PFN_vkDestroyAccelerationStructureKHR)vkGetDeviceProcAddr(device, "vkDestroyAccelerationStructureKHR");
+    auto pfnWriteProps = (PFN_vkCmdWriteAccelerationStructuresPropertiesKHR)
+        vkGetDeviceProcAddr(device, "vkCmdWriteAccelerationStructuresPropertiesKHR");
+    auto pfnCopy = (PFN_vkCmdCopyAccelerationStructureKHR)vkGetDeviceProcAddr(device, "vkCmdCopyAccelerationStructureKHR");
+    if (!blas || !pfnCreate || !pfnDestroy || !pfnWriteProps || !pfnCopy) return false;
+
+    // ===== COMPACTED SIZE =====
+    VkQueryPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+    poolInfo.queryCount = 1;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    if (vkCreateQueryPool(device, &poolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        Log("[%s] WARNING: BLAS %s: compacted size query pool failed, keeping uncompacted\n", tag, name);
+        return false;
+    }
+
+    VkCommandBuffer cmd = BeginCommands(device, pool);
+    if (!cmd) { vkDestroyQueryPool(device, queryPool, nullptr); return false; }
+    vkCmdResetQueryPool(cmd, queryPool, 0, 1);
+    pfnWriteProps(cmd, 1, &blas, VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, queryPool, 0);
+    VkDeviceSize compactedSize = 0;
+    bool ok = SubmitAndWait(device, queue, pool, cmd) &&
+              vkGetQueryPoolResults(device, queryPool, 0, 1, sizeof(compactedSize), &compactedSize, sizeof(compactedSize),
+                                    VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) == VK_SUCCESS;
+    vkDestroyQueryPool(device, queryPool, nullptr);
+    if (!ok || compactedSize == 0 || compactedSize >= builtSize) {
+        Log("[%s] BLAS %s: no compaction (%llu KB)\n", tag, name, (unsigned long long)(builtSize / 1024));
+        return false;
+    }
+
+    // ===== COMPACT COPY =====
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = compactedSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkBuffer compactBuffer = VK_NULL_HANDLE;
+    VkMemAlloc compactMemory;
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &compactBuffer) != VK_SUCCESS) return false;
+    if (!VkMemAllocBuffer(compactBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, compactMemory)) {
+        vkDestroyBuffer(device, compactBuffer, nullptr);
+        return false;
+    }
+
+    VkAccelerationStructureCreateInfoKHR createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+    createInfo.buffer = compactBuffer;
+    createInfo.size = compactedSize;
+    createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+    VkAccelerationStructureKHR compactBlas = VK_NULL_HANDLE;
+    if (pfnCreate(device, &createInfo, nullptr, &compactBlas) != VK_SUCCESS) {
+        vkDestroyBuffer(device, compactBuffer, nullptr);
+        VkMemFree(compactMemory);
+        return false;
+    }
+
+    cmd = BeginCommands(device, pool);
+    ok = cmd != VK_NULL_HANDLE;
+    if (ok) {
+        VkCopyAccelerationStructureInfoKHR copyInfo = {};
+        copyInfo.sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR;
+        copyInfo.src = blas;
+        copyInfo.dst = compactBlas;
+        copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+        pfnCopy(cmd, &copyInfo);
+        ok = SubmitAndWait(device, queue, pool, cmd);
+    }
+    if (!ok) {
+        pfnDestroy(device, compactBlas, nullptr);
+        vkDestroyBuffer(device, compactBuffer, nullptr);
+        VkMemFree(compactMemory);
+        Log("[%s] WARNING: BLAS %s: compaction copy failed, keeping uncompacted\n", tag, name);
+        return false;
+    }
+
+    // The queue is idle, the uncompacted BLAS can go
+    pfnDestroy(device, blas, nullptr);
+    vkDestroyBuffer(device, buffer, nullptr);
+    VkMemFree(memory);
+    blas = compactBlas;
+    buffer = compactBuffer;
+    memory = compactMemory;
+    Log("[%s] BLAS %s compacted: %llu KB -> %llu KB\n", tag, name,
+        (unsigned long long)(builtSize / 1024), (unsigned long long)(compactedSize / 1024));
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+// ============== VULKAN BLAS COMPACTION ==============
+// Shared by the Vulkan RT and Vulkan RQ renderers. Static BLASes are built
+// with ALLOW_COMPACTION; once the build has completed, the compacted size is
+// queried, the BLAS is copied (MODE_COMPACT) into a right-sized buffer and the
+// original is destroyed. Compaction typically saves around half of the BLAS
+// memory and the tighter BVH traverses at least as fast.
+
+#include "vulkan.h"
+#include "vk_memory.h"
+
+// BLAS flags for geometry that is built once at init
+#define VK_BLAS_STATIC_FLAGS (VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | \
+                              VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR)
+
+// Blocking: two submits on queue, each waited for. On success blas / buffer /
+// memory are replaced by the compacted copy; on failure the original is kept
+// (still valid) and false is returned. builtSize is the size blas was created with.
+bool VkCompactBLAS(VkDevice device, VkQueue queue, VkCommandPool pool, VkDeviceSize builtSize,
+                   VkAccelerationStructureKHR& blas, VkBuffer& buffer, VkMemAlloc& memory,
+                   const char* tag, const char* name);
@@ -0,0 +1,109 @@
+// ============== VULKAN FRAME CAPTURE ==============
+// Readback buffers and copy commands for --capture (see vk_capture.h)
+
+#include "vulkan.h"
+#include "../common.h"
+#include "../frame_capture.h"
+#include "vk_capture.h"
+#include "vk_memory.h"
+
+static CaptureRing s_ring = {};
+static VkBuffer s_buffers[CAPTURE_SLOTS] = {};
+static VkMemAlloc s_memory[CAPTURE_SLOTS];
+static bool s_failed = false;                   // Buffer creation failed, not retried until cleanup
+
+// The encoder reads every byte once; write-combined memory makes that slow
+static VkMemoryPropertyFlags ReadbackMemoryFlags(VkPhysicalDevice physicalDevice, uint32_t typeBits)
+{
+    const VkMemoryPropertyFlags cached = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    VkPhysicalDeviceMemoryProperties props;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &props);
+    for (uint32_t i = 0; i < props.memoryTypeCount; i++)
+        if ((typeBits & (1u << i)) && (props.memoryTypes[i].propertyFlags & cached) == cached) return cached;
+    return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+static bool CreateCaptureBuffers(VkPhysicalDevice physicalDevice, VkDevice device, VkExtent2D extent, bool bgra)
+{
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = (VkDeviceSize)extent.width * extent.height * 4;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    for (uint32_t i = 0; i < CAPTURE_SLOTS; i++) {
+        if (vkCreateBuffer(device, &bufferInfo, nullptr, &s_buffers[i]) != VK_SUCCESS) {
+            Log("[ERROR] Capture: vkCreateBuffer failed\n");
+            VkCaptureCleanup(device);
+            s_failed = true;
+            return false;
+        }
+        VkMemoryRequirements memReqs;
+        vkGetBufferMemoryRequirements(device, s_buffers[i], &memReqs);
+        if (!VkMemAllocBuffer(s_buffers[i], ReadbackMemoryFlags(physicalDevice, memReqs.memoryTypeBits), s_memory[i]) ||
+            !s_memory[i].mapped) {
+            Log("[ERROR] Capture: no mapped readback memory\n");
+            VkCaptureCleanup(device);
+            s_failed = true;
+            return false;
+        }
+        s_ring.slots[i].pixels = (const BYTE*)s_memory[i].mapped;
+        s_ring.slots[i].rowPitch = extent.width * 4;
+        s_ring.slots[i].state = CAPTURE_FREE;
+    }
+    s_ring.width = extent.width;
+    s_ring.height = extent.height;
+    s_ring.bgra = bgra;
+    return true;
+}
+
+void VkCaptureRecord(VkPhysicalDevice physicalDevice, VkDevice device, VkCommandBuffer cmd, VkImage image,
+                     VkExtent2D extent, bool bgra, VkPipelineStageFlags srcStage,
+                     uint32_t frame, uint32_t frameNumber, const char* tag)
+{
+    if (!CaptureDue(frameNumber) || s_failed) return;
+    if (!s_buffers[0] && !CreateCaptureBuffers(physicalDevice, device, extent, bgra)) return;
+    int slot = CaptureAcquire(s_ring);
+    if (slot < 0) return;
+    s_ring.tag = tag;
+
+    VkMemoryBarrier before = {};
+    before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    before.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    before.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    // TRANSFER covers the TRANSFER_WRITE: the image may come from a blit / copy rather than srcStage
+    vkCmdPipelineBarrier(cmd, srcStage | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &before, 0, nullptr, 0, nullptr);
+
+    VkBufferImageCopy region = {};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { extent.width, extent.height, 1 };
+    vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_GENERAL, s_buffers[slot], 1, &region);
+
+    // Host read after the fence, and nothing overwrites the image before the copy read it
+    VkMemoryBarrier after = {};
+    after.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    after.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    after.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 1, &after, 0, nullptr, 0, nullptr);
+    CaptureSubmitted(s_ring, slot, frame, frameNumber);
+}
+
+void VkCaptureCollect(uint32_t frame)
+{
+    if (s_buffers[0]) CaptureRetire(s_ring, frame);
+}
+
+void VkCaptureCleanup(VkDevice device)
+{
+    if (s_buffers[0]) CaptureDrain(s_ring);
+    for (uint32_t i = 0; i < CAPTURE_SLOTS; i++) {
+        if (s_buffers[i]) { vkDestroyBuffer(device, s_buffers[i], nullptr); s_buffers[i] = VK_NULL_HANDLE; }
+        VkMemFree(s_memory[i]);
+    }
+    s_ring = {};
+    s_failed = false;
+}
@@ -0,0 +1,19 @@
+#pragma once
+// ============== VULKAN FRAME CAPTURE ==============
+// Vulkan half of --capture (frame_capture.h) for Vulkan RT. CAPTURE_SLOTS
+// host-visible buffers from the sub-allocator (HOST_CACHED when the device
+// has it), mapped for their lifetime and read only after VkCaptureCollect has
+// seen the fence of their frame slot pass.
+//
+// Record copies image (GENERAL layout, written at srcStage) into a free slot
+// when frameNumber is due; the layout is unchanged and later passes may write
+// the image right away. Collect after the frame slot's fence wait. Cleanup
+// after vkDeviceWaitIdle (resize, renderer cleanup) and before VkMemShutdown.
+
+#include "vulkan.h"
+
+void VkCaptureRecord(VkPhysicalDevice physicalDevice, VkDevice device, VkCommandBuffer cmd, VkImage image,
+                     VkExtent2D extent, bool bgra, VkPipelineStageFlags srcStage,
+                     uint32_t frame, uint32_t frameNumber, const char* tag);
+void VkCaptureCollect(uint32_t frame);
+void VkCaptureCleanup(VkDevice device);
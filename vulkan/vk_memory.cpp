@@ -0,0 +1,339 @@
+// ============== VULKAN DEVICE MEMORY SUB-ALLOCATOR ==============
+// See vk_memory.h. Init-time and resize-time only, single-threaded.
+
+#define VK_USE_PLATFORM_WIN32_KHR
+#include "vulkan.h"
+#include "../common.h"
+#include "vk_memory.h"
+#include "../vram_budget.h"
+
+#define VK_MEM_BLOCK_SIZE (64ull * 1024 * 1024)   // Capped to heapSize / 8 on small heaps
+#define VK_MEM_MIN_BLOCK_SIZE (4ull * 1024 * 1024)
+
+// ============== MEMORY GLOBALS ==============
+struct VkMemRange {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+};
+
+struct VkMemBlock {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    uint32_t memoryType;
+    bool image;                       // Optimal-tiling images only, never mixed with buffers
+    bool linear;                      // Bump allocator, free list unused
+    VkDeviceSize linearHead;
+    char* mapped;                     // Whole-block mapping (HOST_VISIBLE)
+    std::vector<VkMemRange> free;     // Sorted by offset, never adjacent (coalesced)
+    uint32_t liveCount;
+};
+
+static VkPhysicalDevice s_memPhysicalDevice = VK_NULL_HANDLE;
+static VkDevice s_memDevice = VK_NULL_HANDLE;
+static VkPhysicalDeviceMemoryProperties s_memProps = {};
+static VkDeviceSize s_memBufferImageGranularity = 1;
+static uint32_t s_memMaxAllocations = 0;
+static bool s_memDeviceAddress = false;
+static VkDeviceSize s_memAddressAlign = 1;   // Minimum buffer offset alignment with device addresses
+static const char* s_memTag = "Vulkan";
+static bool s_memBudgetExt = false;          // VK_EXT_memory_budget enabled on the device
+static std::vector<VkMemBlock> s_memBlocks;
+static uint32_t s_memDeviceAllocations = 0;   // Live vkAllocateMemory objects (blocks + dedicated)
+static uint32_t s_memLiveAllocations = 0;     // Live VkMemAlloc handed out
+static uint32_t s_memTotalAllocations = 0;    // Every VkMemAlloc* call that succeeded
+static VkDeviceSize s_memDedicatedBytes = 0;
+
+static VkDeviceSize AlignUp(VkDeviceSize v, VkDeviceSize align) { return (v + align - 1) & ~(align - 1); }  // align: power of two
+
+static uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+    for (uint32_t i = 0; i < s_memProps.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (s_memProps.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static VkDeviceSize BlockSizeFor(uint32_t memoryType) {
+    VkDeviceSize heapSize = s_memProps.memoryHeaps[s_memProps.memoryTypes[memoryType].heapIndex].size;
+    VkDeviceSize size = VK_MEM_BLOCK_SIZE;
+    while (size > VK_MEM_MIN_BLOCK_SIZE && size > heapSize / 8) size /= 2;
+    return size;
+}
+
+static bool AllocateDeviceMemory(VkDeviceSize size, uint32_t memoryType, VkDeviceMemory& memory, void** mapped) {
+    if (s_memMaxAllocations && s_memDeviceAllocations >= s_memMaxAllocations) {
+        Log("[ERROR] %s memory: maxMemoryAllocationCount (%u) reached\n", s_memTag, s_memMaxAllocations);
+        return false;
+    }
+
+    VkMemoryAllocateFlagsInfo allocFlagsInfo = {};
+    allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+
+    VkMemoryAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.pNext = s_memDeviceAddress ? &allocFlagsInfo : nullptr;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+    if (vkAllocateMemory(s_memDevice, &allocInfo, nullptr, &memory) != VK_SUCCESS) return false;
+
+    *mapped = nullptr;
+    if (s_memProps.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(s_memDevice, memory, 0, VK_WHOLE_SIZE, 0, mapped) != VK_SUCCESS) {
+            vkFreeMemory(s_memDevice, memory, nullptr);
+            memory = VK_NULL_HANDLE;
+            return false;
+        }
+    }
+    s_memDeviceAllocations++;
+    return true;
+}
+
+// ============== BLOCK ALLOCATION ==============
+// First fit over the sorted free list; the aligned head and the tail of the
+// chosen range go back on the list
+static bool BlockAllocate(VkMemBlock& block, VkDeviceSize size, VkDeviceSize align, VkDeviceSize& offset) {
+    if (block.linear) {
+        VkDeviceSize o = AlignUp(block.linearHead, align);
+        if (o + size > block.size) return false;
+        block.linearHead = o + size;
+        offset = o;
+        return true;
+    }
+    for (size_t i = 0; i < block.free.size(); i++) {
+        VkMemRange r = block.free[i];
+        VkDeviceSize o = AlignUp(r.offset, align);
+        if (o + size > r.offset + r.size) continue;
+
+        VkDeviceSize tailOffset = o + size;
+        VkDeviceSize tailSize = r.offset + r.size - tailOffset;
+        block.free.erase(block.free.begin() + i);
+        if (tailSize) block.free.insert(block.free.begin() + i, { tailOffset, tailSize });
+        if (o > r.offset) block.free.insert(block.free.begin() + i, { r.offset, o - r.offset });
+        offset = o;
+        return true;
+    }
+    return false;
+}
+
+static void BlockFree(VkMemBlock& block, VkDeviceSize offset, VkDeviceSize size) {
+    size_t i = 0;
+    while (i < block.free.size() && block.free[i].offset < offset) i++;
+    block.free.insert(block.free.begin() + i, { offset, size });
+    // Merge with the next range, then with the previous one
+    if (i + 1 < block.free.size() && block.free[i].offset + block.free[i].size == block.free[i + 1].offset) {
+        block.free[i].size += block.free[i + 1].size;
+        block.free.erase(block.free.begin() + i + 1);
+    }
+    if (i > 0 && block.free[i - 1].offset + block.free[i - 1].size == block.free[i].offset) {
+        block.free[i - 1].size += block.free[i].size;
+        block.free.erase(block.free.begin() + i);
+    }
+}
+
+static bool Allocate(const VkMemoryRequirements& memReqs, VkMemoryPropertyFlags properties,
+                     bool image, bool linear, VkDeviceSize minAlign, VkMemAlloc& out) {
+    out = VkMemAlloc();
+    if (!s_memDevice) {
+        Log("[ERROR] Vulkan memory: allocation before VkMemInit\n");
+        return false;
+    }
+    uint32_t memoryType = FindMemoryType(memReqs.memoryTypeBits, properties);
+    if (memoryType == UINT32_MAX) {
+        Log("[ERROR] %s memory: no memory type for properties 0x%X\n", s_memTag, properties);
+        return false;
+    }
+
+    VkDeviceSize blockSize = BlockSizeFor(memoryType);
+    VkDeviceSize align = memReqs.alignment ? memReqs.alignment : 1;
+    while (align < minAlign) align *= 2;
+    void* mapped = nullptr;
+
+    if (memReqs.size > blockSize / 2) {
+        if (!AllocateDeviceMemory(memReqs.size, memoryType, out.memory, &mapped)) {
+            Log("[ERROR] %s memory: dedicated allocation of %.1f MB failed\n", s_memTag, memReqs.size / (1024.0 * 1024.0));
+            return false;
+        }
+        out.size = memReqs.size;
+        out.mapped = mapped;
+        out.block = VK_MEM_DEDICATED;
+        s_memDedicatedBytes += memReqs.size;
+    } else {
+        uint32_t blockIndex = UINT32_MAX;
+        VkDeviceSize offset = 0;
+        for (uint32_t i = 0; i < (uint32_t)s_memBlocks.size(); i++) {
+            VkMemBlock& b = s_memBlocks[i];
+            if (b.memory && b.memoryType == memoryType && b.image == image && b.linear == linear &&
+                BlockAllocate(b, memReqs.size, align, offset)) {
+                blockIndex = i;
+                break;
+            }
+        }
+        if (blockIndex == UINT32_MAX) {
+            VkMemBlock b = {};
+            if (!AllocateDeviceMemory(blockSize, memoryType, b.memory, &mapped)) {
+                Log("[ERROR] %s memory: failed to allocate %.0f MB block (type %u)\n", s_memTag,
+                    blockSize / (1024.0 * 1024.0), memoryType);
+                return false;
+            }
+            b.size = blockSize;
+            b.memoryType = memoryType;
+            b.image = image;
+            b.linear = linear;
+            b.mapped = (char*)mapped;
+            if (!linear) b.free.push_back({ 0, blockSize });
+            s_memBlocks.push_back(b);
+            blockIndex = (uint32_t)s_memBlocks.size() - 1;
+            BlockAllocate(s_memBlocks[blockIndex], memReqs.size, align, offset);
+        }
+        VkMemBlock& block = s_memBlocks[blockIndex];
+        block.liveCount++;
+        out.memory = block.memory;
+        out.offset = offset;
+        out.size = memReqs.size;
+        out.mapped = block.mapped ? block.mapped + offset : nullptr;
+        out.block = linear ? VK_MEM_LINEAR : blockIndex;
+    }
+    s_memLiveAllocations++;
+    s_memTotalAllocations++;
+    return true;
+}
+
+// ============== MEMORY BUDGET ==============
+void VkMemBudgetEnable(VkPhysicalDevice physicalDevice, std::vector<const char*>& extensions) {
+    s_memBudgetExt = false;
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> exts(count);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, exts.data());
+    for (const auto& e : exts) {
+        if (strcmp(e.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) s_memBudgetExt = true;
+    }
+    if (s_memBudgetExt) extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+}
+
+// Heap usage is this process' (like DXGI); device-local heaps count as local
+static bool QueryMemoryBudget(VramBudget& out) {
+    if (!s_memPhysicalDevice) return false;
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {};
+    budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 props2 = {};
+    props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    props2.pNext = &budget;
+    vkGetPhysicalDeviceMemoryProperties2(s_memPhysicalDevice, &props2);
+    out = {};
+    for (uint32_t i = 0; i < props2.memoryProperties.memoryHeapCount; i++) {
+        bool local = (props2.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        (local ? out.localUsage : out.nonLocalUsage) += budget.heapUsage[i];
+        (local ? out.localBudget : out.nonLocalBudget) += budget.heapBudget[i];
+    }
+    return true;
+}
+
+// ============== PUBLIC API ==============
+bool VkMemInit(VkPhysicalDevice physicalDevice, VkDevice device, bool deviceAddress, const char* tag) {
+    if (s_memDevice) {
+        Log("[WARN] VkMemInit: previous device was never shut down, releasing it\n");
+        VkMemShutdown();
+    }
+    s_memPhysicalDevice = physicalDevice;
+    s_memDevice = device;
+    s_memDeviceAddress = deviceAddress;
+    s_memTag = tag;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &s_memProps);
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    s_memBufferImageGranularity = props.limits.bufferImageGranularity;
+    s_memMaxAllocations = props.limits.maxMemoryAllocationCount;
+
+    s_memAddressAlign = 1;
+    if (deviceAddress) {
+        VkPhysicalDeviceAccelerationStructurePropertiesKHR asProps = {};
+        asProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
+        VkPhysicalDeviceProperties2 props2 = {};
+        props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        props2.pNext = &asProps;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &props2);
+        s_memAddressAlign = 256;   // Acceleration structure offsets are 256-byte aligned
+        while (s_memAddressAlign < asProps.minAccelerationStructureScratchOffsetAlignment) s_memAddressAlign *= 2;
+    }
+    Log("[INFO] %s memory: %.0f MB blocks, bufferImageGranularity %llu, maxMemoryAllocationCount %u\n", tag,
+        VK_MEM_BLOCK_SIZE / (1024.0 * 1024.0), (unsigned long long)s_memBufferImageGranularity, s_memMaxAllocations);
+    if (s_memBudgetExt) VramSetQuery(QueryMemoryBudget, "VK_EXT_memory_budget");
+    return true;
+}
+
+void VkMemShutdown() {
+    if (!s_memDevice) return;
+    if (s_memLiveAllocations) Log("[WARN] %s memory: %u allocations still live at shutdown\n", s_memTag, s_memLiveAllocations);
+    VkMemLogStats();
+    for (VkMemBlock& b : s_memBlocks) {
+        if (b.memory) vkFreeMemory(s_memDevice, b.memory, nullptr);   // Implicitly unmapped
+    }
+    s_memBlocks.clear();
+    s_memDeviceAllocations = 0;
+    s_memLiveAllocations = 0;
+    s_memTotalAllocations = 0;
+    s_memDedicatedBytes = 0;
+    s_memDevice = VK_NULL_HANDLE;
+    s_memPhysicalDevice = VK_NULL_HANDLE;
+    VramSetQuery(nullptr, nullptr);
+}
+
+bool VkMemAllocBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, VkMemAlloc& out,
+                      bool linear, VkDeviceSize minAlign) {
+    VkMemoryRequirements memReqs;
+    vkGetBufferMemoryRequirements(s_memDevice, buffer, &memReqs);
+    if (minAlign < s_memAddressAlign) minAlign = s_memAddressAlign;
+    if (!Allocate(memReqs, properties, false, linear, minAlign, out)) return false;
+    if (vkBindBufferMemory(s_memDevice, buffer, out.memory, out.offset) != VK_SUCCESS) {
+        Log("[ERROR] %s memory: vkBindBufferMemory failed\n", s_memTag);
+        VkMemFree(out);
+        return false;
+    }
+    return true;
+}
+
+bool VkMemAllocImage(VkImage image, VkMemoryPropertyFlags properties, VkMemAlloc& out) {
+    VkMemoryRequirements memReqs;
+    vkGetImageMemoryRequirements(s_memDevice, image, &memReqs);
+    if (!Allocate(memReqs, properties, true, false, 0, out)) return false;
+    if (vkBindImageMemory(s_memDevice, image, out.memory, out.offset) != VK_SUCCESS) {
+        Log("[ERROR] %s memory: vkBindImageMemory failed\n", s_memTag);
+        VkMemFree(out);
+        return false;
+    }
+    return true;
+}
+
+void VkMemFree(VkMemAlloc& alloc) {
+    if (!alloc.memory || !s_memDevice) { alloc = VkMemAlloc(); return; }
+    if (alloc.block == VK_MEM_DEDICATED) {
+        vkFreeMemory(s_memDevice, alloc.memory, nullptr);
+        s_memDeviceAllocations--;
+        s_memDedicatedBytes -= alloc.size;
+    } else if (alloc.block != VK_MEM_LINEAR && alloc.block < s_memBlocks.size()) {
+        // Empty blocks are kept: resize recreates the same resources right away
+        VkMemBlock& block = s_memBlocks[alloc.block];
+        BlockFree(block, alloc.offset, alloc.size);
+        block.liveCount--;
+    }
+    s_memLiveAllocations--;
+    alloc = VkMemAlloc();
+}
+
+void VkMemLogStats() {
+    if (!s_memDevice) return;
+    VkDeviceSize blockBytes = 0;
+    uint32_t blockCount = 0;
+    for (const VkMemBlock& b : s_memBlocks) {
+        if (!b.memory) continue;
+        blockBytes += b.size;
+        blockCount++;
+    }
+    Log("[INFO] %s memory: %u allocations (%u live) in %u blocks (%.0f MB) + %u dedicated (%.1f MB), %u device allocations\n",
+        s_memTag, s_memTotalAllocations, s_memLiveAllocations, blockCount, blockBytes / (1024.0 * 1024.0),
+        s_memDeviceAllocations - blockCount, s_memDedicatedBytes / (1024.0 * 1024.0), s_memDeviceAllocations);
+}
@@ -0,0 +1,52 @@
+#pragma once
+// ============== VULKAN DEVICE MEMORY SUB-ALLOCATOR ==============
+// Shared by the Vulkan, Vulkan RT and Vulkan RQ renderers (one device at a
+// time, bound with VkMemInit / released with VkMemShutdown). Instead of one
+// vkAllocateMemory per buffer or image, resources are carved out of large
+// blocks per memory type, which keeps the allocation count far below
+// maxMemoryAllocationCount and makes init cheaper.
+//
+// - General pool: first-fit free list per block, freed ranges are coalesced.
+// - Linear pool: bump allocation only, VkMemFree is a no-op and the memory
+//   comes back at VkMemShutdown. For buffers that live until cleanup anyway
+//   (per-frame uniforms, instance buffers, TLAS and TLAS scratch).
+// - Requests larger than half a block get a dedicated VkDeviceMemory.
+//
+// Buffers and images never share a block, so bufferImageGranularity can't
+// cause aliasing between linear and optimal-tiling resources. HOST_VISIBLE
+// blocks are mapped once; VkMemAlloc::mapped points at the allocation.
+
+#include "vulkan.h"
+
+struct VkMemAlloc {
+    VkDeviceMemory memory = VK_NULL_HANDLE;   // Block memory, shared - never vkFreeMemory it
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr;                   // Host pointer at offset (HOST_VISIBLE only)
+    uint32_t block = 0;                       // Owning block, VK_MEM_DEDICATED / VK_MEM_LINEAR
+};
+
+#define VK_MEM_DEDICATED 0xFFFFFFFFu
+#define VK_MEM_LINEAR    0xFFFFFFFEu
+
+// deviceAddress: the device enabled bufferDeviceAddress and
+// VK_KHR_acceleration_structure (RT/RQ). Blocks are allocated with
+// VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT, and every buffer starts on a
+// 256-byte / minAccelerationStructureScratchOffsetAlignment boundary so its
+// address is valid as acceleration structure storage or build scratch.
+bool VkMemInit(VkPhysicalDevice physicalDevice, VkDevice device, bool deviceAddress, const char* tag);
+void VkMemShutdown();   // Before vkDestroyDevice; frees every block
+
+// Allocate and bind. linear = bump-allocate from the linear pool (see above).
+// minAlign raises the offset alignment (e.g. shaderGroupBaseAlignment for an SBT).
+bool VkMemAllocBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, VkMemAlloc& out,
+                      bool linear = false, VkDeviceSize minAlign = 0);
+bool VkMemAllocImage(VkImage image, VkMemoryPropertyFlags properties, VkMemAlloc& out);
+void VkMemFree(VkMemAlloc& alloc);   // Safe on empty allocations, resets alloc
+
+void VkMemLogStats();   // Allocation / block counts and sizes
+
+// Before vkCreateDevice: adds VK_EXT_memory_budget when available. VkMemInit
+// then feeds per-heap usage / budget to the VRAM telemetry (vram_budget.h)
+// instead of DXGI, until VkMemShutdown.
+void VkMemBudgetEnable(VkPhysicalDevice physicalDevice, std::vector<const char*>& extensions);
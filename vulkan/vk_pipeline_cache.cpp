@@ -0,0 +1,128 @@
+// ============== VULKAN PIPELINE CACHE ==============
+// See vk_pipeline_cache.h. Uses the same shadercache\ folder as the D3D12
+// DXIL / pipeline library cache.
+
+#define VK_USE_PLATFORM_WIN32_KHR
+#include "vulkan.h"
+#include "../common.h"
+#include "vk_pipeline_cache.h"
+
+// ============== CACHE FILE ==============
+static bool GetVkCachePath(VkPhysicalDevice physicalDevice, const char* name, char* out, size_t size) {
+    char dir[MAX_PATH];
+    GetModuleFileNameA(nullptr, dir, MAX_PATH);
+    char* slash = strrchr(dir, '\\');
+    if (slash) *slash = 0;
+    strcat_s(dir, "\\shadercache");
+    if (!CreateDirectoryA(dir, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) return false;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    sprintf_s(out, size, "%s\\vk_%s_%04x_%04x.bin", dir, name, props.vendorID, props.deviceID);
+    return true;
+}
+
+static bool ReadCacheFile(const char* path, std::vector<char>& data) {
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "rb") != 0 || !f) return false;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len <= 0) { fclose(f); return false; }
+    data.resize((size_t)len);
+    bool ok = fread(data.data(), 1, (size_t)len, f) == (size_t)len;
+    fclose(f);
+    return ok;
+}
+
+// Temp file + rename so a crash during cleanup never leaves a truncated cache.
+// Per-process temp name: --all-gpus children with identical GPUs share a cache file
+static bool WriteCacheFile(const char* path, const void* data, size_t size) {
+    char tmpPath[MAX_PATH];
+    sprintf_s(tmpPath, "%s.%lu.tmp", path, GetCurrentProcessId());
+    FILE* f = nullptr;
+    if (fopen_s(&f, tmpPath, "wb") != 0 || !f) return false;
+    bool ok = fwrite(data, 1, size, f) == size;
+    fclose(f);
+    if (!ok || !MoveFileExA(tmpPath, path, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+// Drivers are required to reject foreign data, but not all of them do it
+// gracefully - check the header ourselves before handing the blob over
+static bool ValidateCacheHeader(VkPhysicalDevice physicalDevice, const std::vector<char>& data, const char* tag) {
+    if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne)) return false;
+    VkPipelineCacheHeaderVersionOne hdr;
+    memcpy(&hdr, data.data(), sizeof(hdr));
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    if (hdr.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || hdr.headerSize > data.size() ||
+        hdr.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) {
+        Log("[INFO] %s: pipeline cache has an unknown header, rebuilding\n", tag);
+        return false;
+    }
+    if (hdr.vendorID != props.vendorID || hdr.deviceID != props.deviceID ||
+        memcmp(hdr.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        Log("[INFO] %s: pipeline cache is from another GPU or driver, rebuilding\n", tag);
+        return false;
+    }
+    return true;
+}
+
+// ============== PUBLIC API ==============
+VkPipelineCache VkPipelineCacheLoad(VkPhysicalDevice physicalDevice, VkDevice device, const char* name, const char* tag) {
+    std::vector<char> data;
+    char path[MAX_PATH] = {0};
+    if (g_shaderCacheEnabled && GetVkCachePath(physicalDevice, name, path, sizeof(path)) &&
+        ReadCacheFile(path, data) && !ValidateCacheHeader(physicalDevice, data, tag)) {
+        data.clear();
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo = {};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = data.size();
+    cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    VkResult result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache);
+    if (result != VK_SUCCESS && !data.empty()) {
+        Log("[INFO] %s: pipeline cache rejected by the driver (%d), rebuilding\n", tag, result);
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache);
+        data.clear();
+    }
+    if (result != VK_SUCCESS) {
+        Log("[WARN] %s: vkCreatePipelineCache failed (%d), pipelines are built uncached\n", tag, result);
+        return VK_NULL_HANDLE;
+    }
+
+    if (!data.empty()) Log("[INFO] %s: pipeline cache loaded (%zu bytes)\n", tag, data.size());
+    else if (g_shaderCacheEnabled) Log("[INFO] %s: pipeline cache empty (cold start)\n", tag);
+    return cache;
+}
+
+void VkPipelineCacheSave(VkPhysicalDevice physicalDevice, VkDevice device, VkPipelineCache& cache,
+                         const char* name, const char* tag) {
+    if (cache == VK_NULL_HANDLE) return;
+
+    char path[MAX_PATH];
+    size_t size = 0;
+    if (g_shaderCacheEnabled && GetVkCachePath(physicalDevice, name, path, sizeof(path)) &&
+        vkGetPipelineCacheData(device, cache, &size, nullptr) == VK_SUCCESS && size > 0) {
+        std::vector<char> data(size);
+        if (vkGetPipelineCacheData(device, cache, &size, data.data()) == VK_SUCCESS &&
+            WriteCacheFile(path, data.data(), size)) {
+            Log("[INFO] %s: pipeline cache saved (%zu bytes)\n", tag, size);
+        } else {
+            Log("[WARN] %s: could not save pipeline cache to %s\n", tag, path);
+        }
+    }
+
+    vkDestroyPipelineCache(device, cache, nullptr);
+    cache = VK_NULL_HANDLE;
+}
@@ -0,0 +1,19 @@
+#pragma once
+// ============== VULKAN PIPELINE CACHE ==============
+// Shared by the Vulkan, Vulkan RT and Vulkan RQ renderers. Each renderer owns
+// one VkPipelineCache for the lifetime of its device: loaded from
+// shadercache\vk_<name>_<ven>_<dev>.bin at init, passed to every
+// vkCreate*Pipelines call and written back at cleanup. A file whose
+// VkPipelineCacheHeaderVersionOne does not match the current GPU (vendor ID,
+// device ID, pipelineCacheUUID - the UUID changes with the driver) is ignored
+// and replaced. --no-shader-cache disables loading and saving.
+
+#include "vulkan.h"
+
+// Never fails: returns an empty cache when there is nothing valid on disk,
+// or VK_NULL_HANDLE if even that can't be created (calls then run uncached).
+VkPipelineCache VkPipelineCacheLoad(VkPhysicalDevice physicalDevice, VkDevice device, const char* name, const char* tag);
+
+// Serializes the cache to disk and destroys it. Call before vkDestroyDevice.
+void VkPipelineCacheSave(VkPhysicalDevice physicalDevice, VkDevice device, VkPipelineCache& cache,
+                         const char* name, const char* tag);
@@ -0,0 +1,312 @@
+// ============== VULKAN PRESENT PACING ==============
+// See vk_present.h. Present ids start at 1 and increase across swapchain
+// recreation; waits are only issued for ids presented to the current swapchain.
+// With --offscreen there is no present wait: the in-flight fence paces.
+
+#define VK_USE_PLATFORM_WIN32_KHR
+#include "vulkan.h"
+#include "../common.h"
+#include "vk_present.h"
+#include "vk_memory.h"
+#include "../offscreen.h"
+
+// ============== PRESENT GLOBALS ==============
+static VkDevice s_presDevice = VK_NULL_HANDLE;
+static PFN_vkWaitForPresentKHR s_vkWaitForPresentKHR = nullptr;
+static bool s_presWaitEnabled = false;       // Extensions + features enabled on the device
+static VkSwapchainKHR s_presSwapchain = VK_NULL_HANDLE;
+static uint64_t s_presNextId = 1;            // Id the next present will carry
+static uint64_t s_presFirstId = 1;           // First id presented to s_presSwapchain
+static uint64_t s_presPolledId = 0;          // Newest id already reported as displayed
+static VkPhysicalDevicePresentIdFeaturesKHR s_presIdFeatures = {};
+static VkPhysicalDevicePresentWaitFeaturesKHR s_presWaitFeatures = {};
+
+// --offscreen "swapchain": the handle points at one of these
+struct OffscreenSwapchain {
+    std::vector<VkImage> images;
+    std::vector<VkMemAlloc> memory;
+    uint32_t next = 0;
+};
+
+static const char* PresentModeString(VkPresentModeKHR mode) {
+    switch (mode) {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE (no VSync)";
+    case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX (no VSync)";
+    case VK_PRESENT_MODE_FIFO_KHR: return "FIFO (VSync)";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED (adaptive VSync)";
+    default: return "other";
+    }
+}
+
+static LONGLONG PresentNowQpc() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+// ============== PUBLIC API ==============
+VkPresentModeKHR VkPresentChooseMode(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+                                     VkPresentModeKHR defaultMode, const char* tag) {
+    if (g_offscreen) {
+        Log("[INFO] %s: offscreen, no present mode (image ring paced by the in-flight fences)\n", tag);
+        return defaultMode;
+    }
+    uint32_t count = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &count, nullptr);
+    std::vector<VkPresentModeKHR> modes(count);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &count, modes.data());
+    auto supported = [&](VkPresentModeKHR m) {
+        for (VkPresentModeKHR s : modes) if (s == m) return true;
+        return false;
+    };
+
+    VkPresentModeKHR wanted = defaultMode;
+    switch (g_presentMode) {
+    case PRESENT_MODE_IMMEDIATE: wanted = VK_PRESENT_MODE_IMMEDIATE_KHR; break;
+    case PRESENT_MODE_MAILBOX: wanted = VK_PRESENT_MODE_MAILBOX_KHR; break;
+    case PRESENT_MODE_FIFO: wanted = VK_PRESENT_MODE_FIFO_KHR; break;
+    case PRESENT_MODE_ADAPTIVE: wanted = VK_PRESENT_MODE_FIFO_RELAXED_KHR; break;
+    default: break;
+    }
+
+    VkPresentModeKHR mode = VK_PRESENT_MODE_FIFO_KHR;  // Always available fallback
+    if (supported(wanted)) mode = wanted;
+    else if (wanted == VK_PRESENT_MODE_FIFO_RELAXED_KHR) {
+        Log("[WARN] %s: %s not supported by surface\n", tag, PresentModeString(wanted));
+    }
+    else if (wanted != VK_PRESENT_MODE_FIFO_KHR) {
+        // No-vsync request: take the other no-vsync mode before falling back to FIFO
+        VkPresentModeKHR other = (wanted == VK_PRESENT_MODE_MAILBOX_KHR) ? VK_PRESENT_MODE_IMMEDIATE_KHR : VK_PRESENT_MODE_MAILBOX_KHR;
+        if (supported(other)) mode = other;
+        Log("[WARN] %s: %s not supported by surface\n", tag, PresentModeString(wanted));
+    }
+    Log("[INFO] %s: Present mode: %s\n", tag, PresentModeString(mode));
+    return mode;
+}
+
+void VkPresentWaitEnable(VkPhysicalDevice physicalDevice, std::vector<const char*>& extensions,
+                         void** pNextChain, const char* tag) {
+    s_presWaitEnabled = false;
+    if (g_offscreen) return;   // Nothing is presented, nothing to wait for
+
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> exts(count);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, exts.data());
+    bool hasId = false, hasWait = false;
+    for (const auto& e : exts) {
+        if (strcmp(e.extensionName, VK_KHR_PRESENT_ID_EXTENSION_NAME) == 0) hasId = true;
+        if (strcmp(e.extensionName, VK_KHR_PRESENT_WAIT_EXTENSION_NAME) == 0) hasWait = true;
+    }
+    if (!hasId || !hasWait) {
+        if (g_maxFrameLatency) Log("[WARN] %s: VK_KHR_present_wait unavailable, --max-latency paces on the in-flight fence only\n", tag);
+        return;
+    }
+
+    s_presIdFeatures = {};
+    s_presIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    s_presWaitFeatures = {};
+    s_presWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    s_presWaitFeatures.pNext = &s_presIdFeatures;
+    VkPhysicalDeviceFeatures2 features2 = {};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &s_presWaitFeatures;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    if (!s_presIdFeatures.presentId || !s_presWaitFeatures.presentWait) {
+        if (g_maxFrameLatency) Log("[WARN] %s: presentId/presentWait features unsupported\n", tag);
+        return;
+    }
+
+    extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    s_presIdFeatures.pNext = *pNextChain;
+    *pNextChain = &s_presWaitFeatures;
+    s_presWaitEnabled = true;
+    Log("[INFO] %s: VK_KHR_present_wait enabled\n", tag);
+}
+
+void VkPresentWaitInit(VkDevice device) {
+    s_presDevice = device;
+    s_presSwapchain = VK_NULL_HANDLE;
+    s_presNextId = s_presFirstId = 1;
+    s_presPolledId = 0;
+    s_vkWaitForPresentKHR = s_presWaitEnabled ?
+        (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(device, "vkWaitForPresentKHR") : nullptr;
+    if (s_presWaitEnabled && !s_vkWaitForPresentKHR) Log("[WARN] vkWaitForPresentKHR not found\n");
+}
+
+void VkPresentWaitShutdown() {
+    s_presDevice = VK_NULL_HANDLE;
+    s_vkWaitForPresentKHR = nullptr;
+    s_presWaitEnabled = false;
+    s_presSwapchain = VK_NULL_HANDLE;
+}
+
+void VkPresentFrameBegin(VkSwapchainKHR swapchain, uint32_t framesInFlight) {
+    if (swapchain != s_presSwapchain) {
+        // Recreated swapchain: earlier ids will never complete on it
+        s_presSwapchain = swapchain;
+        s_presFirstId = s_presNextId;
+        s_presPolledId = s_presNextId - 1;
+    }
+
+    uint64_t lastId = s_presNextId - 1;
+    if (s_vkWaitForPresentKHR) {
+        // Pacing: frame (next - N) must be on screen before this one starts.
+        // 1 s timeout so a lost present (minimized window) can't hang the loop.
+        if (g_maxFrameLatency && s_presNextId >= s_presFirstId + g_maxFrameLatency) {
+            uint64_t waitId = s_presNextId - g_maxFrameLatency;
+            if (s_vkWaitForPresentKHR(s_presDevice, swapchain, waitId, 1000000000ull) == VK_SUCCESS && waitId > s_presPolledId) {
+                LatencyFrameDisplayed(waitId, PresentNowQpc(), LATENCY_SOURCE_PRESENT_WAIT);
+                s_presPolledId = waitId;
+            }
+        }
+        // Measurement: poll (zero timeout) the ids still outstanding
+        while (s_presPolledId < lastId &&
+               s_vkWaitForPresentKHR(s_presDevice, swapchain, s_presPolledId + 1, 0) == VK_SUCCESS) {
+            s_presPolledId++;
+            LatencyFrameDisplayed(s_presPolledId, PresentNowQpc(), LATENCY_SOURCE_PRESENT_WAIT);
+        }
+    } else if (s_presNextId > framesInFlight && s_presNextId - framesInFlight > s_presPolledId) {
+        // No present feedback: the renderer just waited on the fence of the
+        // frame submitted framesInFlight presents ago
+        uint64_t doneId = s_presNextId - framesInFlight;
+        LatencyFrameDisplayed(doneId, PresentNowQpc(), LATENCY_SOURCE_FENCE);
+        s_presPolledId = doneId;
+    }
+    LatencyFrameBegin();
+}
+
+VkResult VkPresentQueue(VkQueue queue, VkPresentInfoKHR& presentInfo) {
+    uint64_t id = s_presNextId;
+    if (g_offscreen) {
+        // Consume the render-finished semaphores so they can be signaled again
+        VkPipelineStageFlags waitStages[4] = { VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                               VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.waitSemaphoreCount = min(presentInfo.waitSemaphoreCount, 4u);
+        submitInfo.pWaitSemaphores = presentInfo.pWaitSemaphores;
+        submitInfo.pWaitDstStageMask = waitStages;
+        VkResult result = submitInfo.waitSemaphoreCount ? vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) : VK_SUCCESS;
+        s_presNextId++;
+        LatencyFrameSubmitted(id);
+        return result;
+    }
+    VkPresentIdKHR presentId = {};
+    presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentId.swapchainCount = 1;
+    presentId.pPresentIds = &id;
+    if (s_vkWaitForPresentKHR) {
+        presentId.pNext = presentInfo.pNext;
+        presentInfo.pNext = &presentId;
+    }
+
+    VkResult result = vkQueuePresentKHR(queue, &presentInfo);
+    if (s_vkWaitForPresentKHR) presentInfo.pNext = presentId.pNext;
+    s_presNextId++;
+    LatencyFrameSubmitted(id);
+    return result;
+}
+
+// ============== SWAPCHAIN / OFFSCREEN ==============
+static OffscreenSwapchain* OffscreenRing(VkSwapchainKHR swapchain) {
+    return (OffscreenSwapchain*)(uintptr_t)swapchain;
+}
+
+static void DestroyOffscreenRing(VkDevice device, OffscreenSwapchain* ring) {
+    for (size_t i = 0; i < ring->images.size(); i++) {
+        if (ring->images[i]) vkDestroyImage(device, ring->images[i], nullptr);
+        VkMemFree(ring->memory[i]);
+    }
+    delete ring;
+}
+
+VkBool32 VkPresentFamilySupported(VkPhysicalDevice physicalDevice, uint32_t family, VkSurfaceKHR surface,
+                                  VkQueueFlags familyFlags) {
+    if (g_offscreen) return (familyFlags & VK_QUEUE_GRAPHICS_BIT) ? VK_TRUE : VK_FALSE;
+    VkBool32 supported = VK_FALSE;
+    vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, family, surface, &supported);
+    return supported;
+}
+
+VkResult VkPresentCreateSwapchain(VkDevice device, const VkSwapchainCreateInfoKHR& info, VkSwapchainKHR* swapchain) {
+    if (!g_offscreen) return vkCreateSwapchainKHR(device, &info, nullptr, swapchain);
+
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    if (info.flags & VK_SWAPCHAIN_CREATE_MUTABLE_FORMAT_BIT_KHR) {
+        // The swapchain's VkImageFormatListCreateInfo is valid for images as well. Mutable
+        // format swapchain images are created with both flags: the usage (e.g. STORAGE on
+        // an sRGB / BGRA image) may only be supported by one of the view formats.
+        imageInfo.pNext = info.pNext;
+        imageInfo.flags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+    }
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = info.imageFormat;
+    imageInfo.extent = { info.imageExtent.width, info.imageExtent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = info.imageArrayLayers;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = info.imageUsage;
+    imageInfo.sharingMode = info.imageSharingMode;
+    imageInfo.queueFamilyIndexCount = info.queueFamilyIndexCount;
+    imageInfo.pQueueFamilyIndices = info.pQueueFamilyIndices;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    OffscreenSwapchain* ring = new OffscreenSwapchain();
+    uint32_t count = max(info.minImageCount, 2u);
+    ring->images.resize(count, VK_NULL_HANDLE);
+    ring->memory.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (vkCreateImage(device, &imageInfo, nullptr, &ring->images[i]) != VK_SUCCESS ||
+            !VkMemAllocImage(ring->images[i], VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ring->memory[i])) {
+            Log("[ERROR] Offscreen: image %u of the ring failed\n", i);
+            DestroyOffscreenRing(device, ring);
+            *swapchain = VK_NULL_HANDLE;
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+    }
+    Log("[INFO] Offscreen: %u x %u image ring of %u (format %d), no presents, %u empty submits per frame\n",
+        info.imageExtent.width, info.imageExtent.height, count, (int)info.imageFormat,
+        OffscreenEmptySubmitsPerFrame(g_settings.renderer));
+    *swapchain = (VkSwapchainKHR)(uintptr_t)ring;
+    return VK_SUCCESS;
+}
+
+VkResult VkPresentGetImages(VkDevice device, VkSwapchainKHR swapchain, uint32_t* count, VkImage* images) {
+    if (!g_offscreen) return vkGetSwapchainImagesKHR(device, swapchain, count, images);
+    OffscreenSwapchain* ring = OffscreenRing(swapchain);
+    uint32_t available = (uint32_t)ring->images.size();
+    if (!images) {
+        *count = available;
+        return VK_SUCCESS;
+    }
+    uint32_t n = min(*count, available);
+    for (uint32_t i = 0; i < n; i++) images[i] = ring->images[i];
+    *count = n;
+    return n < available ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+VkResult VkPresentAcquire(VkDevice device, VkSwapchainKHR swapchain, VkQueue queue, VkSemaphore semaphore,
+                          uint32_t* imageIndex) {
+    if (!g_offscreen) return vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, semaphore, VK_NULL_HANDLE, imageIndex);
+    OffscreenSwapchain* ring = OffscreenRing(swapchain);
+    *imageIndex = ring->next;
+    ring->next = (ring->next + 1) % (uint32_t)ring->images.size();
+    if (!semaphore) return VK_SUCCESS;
+
+    // The frame's submit waits on the acquire semaphore; signal it right away
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &semaphore;
+    return vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+}
+
+void VkPresentDestroySwapchain(VkDevice device, VkSwapchainKHR swapchain) {
+    if (!swapchain) return;
+    if (g_offscreen) DestroyOffscreenRing(device, OffscreenRing(swapchain));
+    else vkDestroySwapchainKHR(device, swapchain, nullptr);
+}
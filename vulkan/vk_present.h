@@ -0,0 +1,54 @@
+#pragma once
+// ============== VULKAN PRESENT PACING ==============
+// Shared by the Vulkan, Vulkan RT and Vulkan RQ renderers. Picks the present
+// mode from --present-mode and, when the device supports VK_KHR_present_id +
+// VK_KHR_present_wait, tags every present with an id so the renderer can wait
+// until frame (id - N) is on screen before starting a new one (--max-latency=N).
+// The same ids feed the CPU-to-present latency measurement in frame_latency.h.
+// Without present wait the in-flight fence wait stands in for "displayed".
+// The swapchain calls go through the wrappers at the end, which provide the
+// --offscreen image ring (offscreen.h).
+
+#include "vulkan.h"
+#include "../frame_latency.h"
+
+// --present-mode if the surface supports it, otherwise defaultMode, otherwise
+// the next best no-vsync mode, otherwise FIFO (always available).
+VkPresentModeKHR VkPresentChooseMode(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+                                     VkPresentModeKHR defaultMode, const char* tag);
+
+// Before vkCreateDevice: adds VK_KHR_present_id / VK_KHR_present_wait and
+// their feature structs (prepended to *pNextChain) when supported. The feature
+// structs are module statics, valid until the next call.
+void VkPresentWaitEnable(VkPhysicalDevice physicalDevice, std::vector<const char*>& extensions,
+                         void** pNextChain, const char* tag);
+
+// After vkCreateDevice: loads vkWaitForPresentKHR (no-op if not enabled).
+void VkPresentWaitInit(VkDevice device);
+void VkPresentWaitShutdown();
+
+// Start of frame, after the in-flight fence wait: pacing wait + LatencyFrameBegin.
+// framesInFlight tells the fence fallback which frame that wait just retired.
+void VkPresentFrameBegin(VkSwapchainKHR swapchain, uint32_t framesInFlight);
+
+// vkQueuePresentKHR with a VkPresentIdKHR chained on (single swapchain), then
+// reports the id to the latency tracker. Returns the vkQueuePresentKHR result.
+VkResult VkPresentQueue(VkQueue queue, VkPresentInfoKHR& presentInfo);
+
+// ============== SWAPCHAIN / OFFSCREEN ==============
+// Without --offscreen these forward to vkGetPhysicalDeviceSurfaceSupportKHR,
+// vkCreateSwapchainKHR, vkGetSwapchainImagesKHR, vkAcquireNextImageKHR and
+// vkDestroySwapchainKHR. With it the "swapchain" is a handle to a ring of
+// plain device-local images with the create info's format, extent, usage,
+// sharing mode and (mutable format) view list, which never reaches the
+// driver: acquire hands out the images round robin and signals the semaphore
+// with an empty submit on queue, VkPresentQueue consumes the wait semaphores
+// the same way. Any graphics family counts as "present" capable, so a
+// surface without present support (no display) doesn't rule out the GPU.
+VkBool32 VkPresentFamilySupported(VkPhysicalDevice physicalDevice, uint32_t family, VkSurfaceKHR surface,
+                                  VkQueueFlags familyFlags);
+VkResult VkPresentCreateSwapchain(VkDevice device, const VkSwapchainCreateInfoKHR& info, VkSwapchainKHR* swapchain);
+VkResult VkPresentGetImages(VkDevice device, VkSwapchainKHR swapchain, uint32_t* count, VkImage* images);
+VkResult VkPresentAcquire(VkDevice device, VkSwapchainKHR swapchain, VkQueue queue, VkSemaphore semaphore,
+                          uint32_t* imageIndex);
+void VkPresentDestroySwapchain(VkDevice device, VkSwapchainKHR swapchain);
@@ -0,0 +1,534 @@
+// ============== VULKAN SHADER FEATURE PERMUTATIONS ==============
+// See vk_specialize.h. Only understands what glslc emits for a block member
+// read: OpAccessChain %ptr %block %memberIndex, then OpLoad of that pointer.
+// Rewrites are done once at pipeline creation.
+
+#define VK_USE_PLATFORM_WIN32_KHR
+#include "vulkan.h"
+#include "../common.h"
+#include "vk_specialize.h"
+#include <unordered_map>
+#include <unordered_set>
+
+#define SPV_MAGIC 0x07230203u
+#define SPV_HEADER_WORDS 5
+
+// Opcodes used below (SPIR-V 1.x unified spec)
+#define SPV_OP_NOP 0
+#define SPV_OP_MEMBER_NAME 6
+#define SPV_OP_EXTENSION 10
+#define SPV_OP_ENTRY_POINT 15
+#define SPV_OP_EXECUTION_MODE 16
+#define SPV_OP_CAPABILITY 17
+#define SPV_OP_TYPE_BOOL 20
+#define SPV_OP_TYPE_INT 21
+#define SPV_OP_TYPE_FLOAT 22
+#define SPV_OP_TYPE_VECTOR 23
+#define SPV_OP_TYPE_IMAGE 25
+#define SPV_OP_TYPE_POINTER 32
+#define SPV_OP_CONSTANT 43
+#define SPV_OP_SPEC_CONSTANT 50
+#define SPV_OP_FUNCTION 54
+#define SPV_OP_VARIABLE 59
+#define SPV_OP_LOAD 61
+#define SPV_OP_ACCESS_CHAIN 65
+#define SPV_OP_IN_BOUNDS_ACCESS_CHAIN 66
+#define SPV_OP_DECORATE 71
+#define SPV_OP_MEMBER_DECORATE 72
+#define SPV_OP_COMPOSITE_EXTRACT 81
+#define SPV_OP_COPY_OBJECT 83
+#define SPV_OP_IMAGE_READ 98
+#define SPV_OP_IMAGE_WRITE 99
+#define SPV_OP_FADD 129
+#define SPV_OP_ISUB 130
+#define SPV_OP_FDIV 136
+#define SPV_OP_VECTOR_TIMES_SCALAR 142
+#define SPV_OP_LOGICAL_AND 167
+#define SPV_OP_SELECT 169
+#define SPV_OP_IEQUAL 170
+#define SPV_OP_ULESS_THAN 176
+#define SPV_OP_LABEL 248
+#define SPV_OP_TRACE_RAY_KHR 4445
+#define SPV_OP_HIT_OBJECT_TRACE_RAY_NV 5260
+#define SPV_OP_HIT_OBJECT_EXECUTE_SHADER_NV 5264
+#define SPV_OP_HIT_OBJECT_GET_PRIMITIVE_INDEX_NV 5268
+#define SPV_OP_HIT_OBJECT_GET_INSTANCE_ID_NV 5270
+#define SPV_OP_HIT_OBJECT_IS_HIT_NV 5277
+#define SPV_OP_REORDER_THREAD_WITH_HIT_OBJECT_NV 5279
+#define SPV_OP_TYPE_HIT_OBJECT_NV 5281
+#define SPV_DECORATION_SPEC_ID 1
+#define SPV_DECORATION_BLOCK 2
+#define SPV_DECORATION_BUILT_IN 11
+#define SPV_DECORATION_BUFFER_BLOCK 3
+#define SPV_DECORATION_NON_WRITABLE 24
+#define SPV_DECORATION_BINDING 33
+#define SPV_DECORATION_DESCRIPTOR_SET 34
+#define SPV_OP_TYPE_STRUCT 30
+#define SPV_STORAGE_UNIFORM_CONSTANT 0
+#define SPV_STORAGE_UNIFORM 2
+#define SPV_DIM_2D 1
+#define SPV_IMAGE_FORMAT_RGBA32F 1
+#define SPV_FLOAT_ONE 0x3F800000u
+#define SPV_VERSION_1_4 0x00010400u
+#define SPV_STORAGE_PUSH_CONSTANT 9
+#define SPV_EXECUTION_MODE_LOCAL_SIZE 17
+#define SPV_BUILT_IN_WORKGROUP_SIZE 25
+#define SPV_CAPABILITY_SHADER_INVOCATION_REORDER_NV 5383
+#define SPV_STORAGE_FUNCTION 7
+#define SPV_RAY_FLAG_TERMINATE_ON_FIRST_HIT 0x4u
+#define SPV_RAY_FLAG_SKIP_CLOSEST_HIT 0x8u
+
+static inline uint32_t SpvWord(uint32_t wordCount, uint32_t opcode) { return (wordCount << 16) | opcode; }
+
+bool VkSpirvSpecializeMember(const uint32_t* code, size_t codeSize, const char* member,
+                             uint32_t specId, uint32_t defaultValue, std::vector<uint32_t>& out) {
+    size_t words = codeSize / sizeof(uint32_t);
+    out.assign(code, code + words);
+    if (words <= SPV_HEADER_WORDS || code[0] != SPV_MAGIC) return false;
+
+    // Pass 1: block type owning the member, its variables, constants, insertion points
+    uint32_t blockType = 0, memberIndex = 0;
+    std::unordered_map<uint32_t, uint32_t> pointee;     // OpTypePointer id -> pointee type
+    std::unordered_map<uint32_t, uint32_t> constants;   // OpConstant id -> value (32-bit)
+    std::unordered_map<uint32_t, uint32_t> variables;   // OpVariable id -> pointer type
+    size_t annotationPos = 0, functionPos = 0;
+    for (size_t i = SPV_HEADER_WORDS; i < words;) {
+        uint32_t wc = code[i] >> 16, op = code[i] & 0xFFFF;
+        if (wc == 0 || i + wc > words) return false;   // Malformed
+        const uint32_t* ins = code + i;
+        switch (op) {
+        case SPV_OP_MEMBER_NAME:
+            if (!blockType && wc > 3 && strncmp((const char*)(ins + 3), member, (wc - 3) * 4) == 0) {
+                blockType = ins[1];
+                memberIndex = ins[2];
+            }
+            break;
+        case SPV_OP_DECORATE:
+            if (wc == 4 && ins[2] == SPV_DECORATION_SPEC_ID && ins[3] == specId) return false;   // Already specialized
+            // fallthrough
+        case SPV_OP_MEMBER_DECORATE:
+            if (!annotationPos) annotationPos = i;
+            break;
+        case SPV_OP_TYPE_POINTER: if (wc == 4) pointee[ins[1]] = ins[3]; break;
+        case SPV_OP_CONSTANT: if (wc == 4) constants[ins[2]] = ins[3]; break;
+        case SPV_OP_VARIABLE: variables[ins[2]] = ins[1]; break;
+        case SPV_OP_FUNCTION: if (!functionPos) functionPos = i; break;
+        }
+        i += wc;
+    }
+    if (!blockType || !annotationPos || !functionPos) return false;
+
+    std::unordered_set<uint32_t> blockVars;
+    for (const auto& v : variables) {
+        auto p = pointee.find(v.second);
+        if (p != pointee.end() && p->second == blockType) blockVars.insert(v.first);
+    }
+
+    // Pass 2: pointers to the member, then the loads through them
+    uint32_t specConst = out[3];   // New id = old bound
+    std::unordered_set<uint32_t> memberPtrs;
+    uint32_t uintType = 0, rewritten = 0;
+    for (size_t i = functionPos; i < words;) {
+        uint32_t wc = out[i] >> 16, op = out[i] & 0xFFFF;
+        uint32_t* ins = out.data() + i;
+        if ((op == SPV_OP_ACCESS_CHAIN || op == SPV_OP_IN_BOUNDS_ACCESS_CHAIN) && wc == 5 && blockVars.count(ins[3])) {
+            auto c = constants.find(ins[4]);
+            if (c != constants.end() && c->second == memberIndex) memberPtrs.insert(ins[2]);
+        } else if (op == SPV_OP_LOAD && wc >= 4 && memberPtrs.count(ins[3])) {
+            if (uintType && ins[1] != uintType) return false;   // Member isn't a single scalar
+            uintType = ins[1];
+            // OpLoad %t %r %ptr [mem operands] -> OpCopyObject %t %r %spec, pad with OpNop
+            ins[0] = SpvWord(4, SPV_OP_COPY_OBJECT);
+            ins[3] = specConst;
+            for (uint32_t k = 4; k < wc; k++) ins[k] = SpvWord(1, SPV_OP_NOP);
+            rewritten++;
+        }
+        i += wc;
+    }
+    if (!rewritten) {
+        out.assign(code, code + words);
+        return false;
+    }
+
+    // OpSpecConstant goes with the other globals, right before the first function;
+    // its SpecId decoration at the start of the annotation section
+    const uint32_t specInst[4] = { SpvWord(4, SPV_OP_SPEC_CONSTANT), uintType, specConst, defaultValue };
+    const uint32_t decoInst[4] = { SpvWord(4, SPV_OP_DECORATE), specConst, SPV_DECORATION_SPEC_ID, specId };
+    out.insert(out.begin() + functionPos, specInst, specInst + 4);
+    out.insert(out.begin() + annotationPos, decoInst, decoInst + 4);
+    out[3] = specConst + 1;
+    return true;
+}
+
+void VkSpecFeaturesInit(VkSpecFeatures& spec, uint32_t features) {
+    spec.value = features;
+    spec.entry.constantID = VK_SPEC_ID_FEATURES;
+    spec.entry.offset = 0;
+    spec.entry.size = sizeof(uint32_t);
+    spec.info.mapEntryCount = 1;
+    spec.info.pMapEntries = &spec.entry;
+    spec.info.dataSize = sizeof(uint32_t);
+    spec.info.pData = &spec.value;
+}
+
+// ============== PUSH CONSTANTS -> STORAGE BUFFER ==============
+bool VkSpirvPushConstantsToStorageBuffer(const uint32_t* code, size_t codeSize, uint32_t set, uint32_t binding,
+                                         std::vector<uint32_t>& out) {
+    size_t words = codeSize / sizeof(uint32_t);
+    out.assign(code, code + words);
+    if (words <= SPV_HEADER_WORDS || code[0] != SPV_MAGIC) return false;
+
+    // Pass 1: PushConstant pointers and variable become Uniform (SPIR-V 1.0 SSBO storage class)
+    uint32_t pcVar = 0, pcBlock = 0;
+    std::unordered_map<uint32_t, uint32_t> memberCount;   // OpTypeStruct id -> members
+    size_t annotationPos = 0;
+    for (size_t i = SPV_HEADER_WORDS; i < words;) {
+        uint32_t wc = out[i] >> 16, op = out[i] & 0xFFFF;
+        if (wc == 0 || i + wc > words) { out.assign(code, code + words); return false; }
+        uint32_t* ins = out.data() + i;
+        if ((op == SPV_OP_DECORATE || op == SPV_OP_MEMBER_DECORATE) && !annotationPos) annotationPos = i;
+        if (op == SPV_OP_TYPE_STRUCT) memberCount[ins[1]] = wc - 2;
+        if (op == SPV_OP_TYPE_POINTER && wc == 4 && ins[2] == SPV_STORAGE_PUSH_CONSTANT) {
+            ins[2] = SPV_STORAGE_UNIFORM;
+        } else if (op == SPV_OP_VARIABLE && wc >= 4 && ins[3] == SPV_STORAGE_PUSH_CONSTANT) {
+            if (pcVar) { out.assign(code, code + words); return false; }   // One block per stage only
+            ins[3] = SPV_STORAGE_UNIFORM;
+            pcVar = ins[2];
+        }
+        i += wc;
+    }
+    if (!pcVar || !annotationPos) { out.assign(code, code + words); return false; }
+
+    // Pass 2: the variable's struct is the Block-decorated one whose pointer it has
+    for (size_t i = SPV_HEADER_WORDS; i < words && !pcBlock;) {
+        uint32_t wc = out[i] >> 16, op = out[i] & 0xFFFF;
+        if (op == SPV_OP_VARIABLE && out[i + 2] == pcVar) {
+            for (size_t j = SPV_HEADER_WORDS; j < i;) {
+                uint32_t wcj = out[j] >> 16;
+                if ((out[j] & 0xFFFF) == SPV_OP_TYPE_POINTER && out[j + 1] == out[i + 1]) pcBlock = out[j + 3];
+                j += wcj;
+            }
+        }
+        i += wc;
+    }
+    for (size_t i = SPV_HEADER_WORDS; i < words && pcBlock;) {
+        uint32_t wc = out[i] >> 16, op = out[i] & 0xFFFF;
+        if (op == SPV_OP_DECORATE && wc == 3 && out[i + 1] == pcBlock && out[i + 2] == SPV_DECORATION_BLOCK)
+            out[i + 2] = SPV_DECORATION_BUFFER_BLOCK;
+        i += wc;
+    }
+    if (!pcBlock || !memberCount.count(pcBlock)) { out.assign(code, code + words); return false; }
+
+    // Set / binding on the variable, NonWritable on every member (vertex stage
+    // SSBOs must be read-only without vertexPipelineStoresAndAtomics)
+    std::vector<uint32_t> decos = {
+        SpvWord(4, SPV_OP_DECORATE), pcVar, SPV_DECORATION_DESCRIPTOR_SET, set,
+        SpvWord(4, SPV_OP_DECORATE), pcVar, SPV_DECORATION_BINDING, binding,
+    };
+    for (uint32_t m = 0; m < memberCount[pcBlock]; m++) {
+        const uint32_t memberDeco[4] = { SpvWord(4, SPV_OP_MEMBER_DECORATE), pcBlock, m, SPV_DECORATION_NON_WRITABLE };
+        decos.insert(decos.end(), memberDeco, memberDeco + 4);
+    }
+    out.insert(out.begin() + annotationPos, decos.begin(), decos.end());
+    return true;
+}
+
+// ============== IMAGE STORE -> RUNNING AVERAGE ==============
+bool VkSpirvAccumulateImageStore(const uint32_t* code, size_t codeSize, uint32_t set, uint32_t binding,
+                                 std::vector<uint32_t>& out) {
+    size_t words = codeSize / sizeof(uint32_t);
+    out.assign(code, code + words);
+    if (words <= SPV_HEADER_WORDS || code[0] != SPV_MAGIC) return false;
+
+    // Pass 1: float / vec4 types, a 1.0 constant, the store and the insertion points
+    uint32_t floatType = 0, vec4Type = 0, oneConst = 0, imageType = 0;
+    std::unordered_map<uint32_t, uint32_t> resultTypes;   // Result id -> type id (function bodies)
+    size_t entryPos = 0, annotationPos = 0, functionPos = 0, writePos = 0;
+    uint32_t writes = 0;
+    for (size_t i = SPV_HEADER_WORDS; i < words;) {
+        uint32_t wc = code[i] >> 16, op = code[i] & 0xFFFF;
+        if (wc == 0 || i + wc > words) return false;   // Malformed
+        const uint32_t* ins = code + i;
+        switch (op) {
+        case SPV_OP_ENTRY_POINT: if (!entryPos) entryPos = i; break;
+        case SPV_OP_DECORATE:
+        case SPV_OP_MEMBER_DECORATE: if (!annotationPos) annotationPos = i; break;
+        case SPV_OP_TYPE_FLOAT: if (wc == 3 && ins[2] == 32) floatType = ins[1]; break;
+        case SPV_OP_TYPE_VECTOR: if (wc == 4 && ins[2] == floatType && ins[3] == 4) vec4Type = ins[1]; break;
+        case SPV_OP_TYPE_IMAGE:
+            if (wc == 9 && ins[2] == floatType && ins[3] == SPV_DIM_2D && ins[4] == 0 && ins[5] == 0 &&
+                ins[6] == 0 && ins[7] == 2 && ins[8] == SPV_IMAGE_FORMAT_RGBA32F) imageType = ins[1];
+            break;
+        case SPV_OP_CONSTANT: if (wc == 4 && ins[1] == floatType && ins[3] == SPV_FLOAT_ONE) oneConst = ins[2]; break;
+        case SPV_OP_FUNCTION: if (!functionPos) functionPos = i; break;
+        case SPV_OP_IMAGE_WRITE: writePos = i; writes++; break;
+        default:
+            // Most instructions in a function body are "OpX %type %result ...". Definitions
+            // precede uses, so the first match wins over e.g. OpStore %ptr %value
+            if (functionPos && wc >= 3) resultTypes.emplace(ins[2], ins[1]);
+            break;
+        }
+        i += wc;
+    }
+    if (writes != 1 || !vec4Type || !entryPos || !annotationPos || !functionPos) return false;
+    const uint32_t* store = code + writePos;
+    auto texelType = resultTypes.find(store[3]);
+    if (texelType == resultTypes.end() || texelType->second != vec4Type) return false;
+
+    // New ids from the old bound
+    uint32_t nextId = out[3];
+    std::vector<uint32_t> globals;
+    if (!imageType) {
+        imageType = nextId++;
+        const uint32_t inst[9] = { SpvWord(9, SPV_OP_TYPE_IMAGE), imageType, floatType, SPV_DIM_2D, 0, 0, 0, 2,
+                                   SPV_IMAGE_FORMAT_RGBA32F };
+        globals.insert(globals.end(), inst, inst + 9);
+    }
+    uint32_t ptrType = nextId++, accumVar = nextId++;
+    const uint32_t ptrInst[4] = { SpvWord(4, SPV_OP_TYPE_POINTER), ptrType, SPV_STORAGE_UNIFORM_CONSTANT, imageType };
+    const uint32_t varInst[4] = { SpvWord(4, SPV_OP_VARIABLE), ptrType, accumVar, SPV_STORAGE_UNIFORM_CONSTANT };
+    globals.insert(globals.end(), ptrInst, ptrInst + 4);
+    globals.insert(globals.end(), varInst, varInst + 4);
+    if (!oneConst) {
+        oneConst = nextId++;
+        const uint32_t inst[4] = { SpvWord(4, SPV_OP_CONSTANT), floatType, oneConst, SPV_FLOAT_ONE };
+        globals.insert(globals.end(), inst, inst + 4);
+    }
+
+    // Sum and average right before the original store, which then writes the average
+    uint32_t image = nextId++, prev = nextId++, sum = nextId++, count = nextId++, inv = nextId++, avg = nextId++;
+    uint32_t coord = store[2], texel = store[3];
+    const uint32_t body[] = {
+        SpvWord(4, SPV_OP_LOAD), imageType, image, accumVar,
+        SpvWord(5, SPV_OP_IMAGE_READ), vec4Type, prev, image, coord,
+        SpvWord(5, SPV_OP_FADD), vec4Type, sum, prev, texel,
+        SpvWord(4, SPV_OP_IMAGE_WRITE), image, coord, sum,
+        SpvWord(5, SPV_OP_COMPOSITE_EXTRACT), floatType, count, sum, 3,
+        SpvWord(5, SPV_OP_FDIV), floatType, inv, oneConst, count,
+        SpvWord(5, SPV_OP_VECTOR_TIMES_SCALAR), vec4Type, avg, sum, inv,
+    };
+    out[writePos + 3] = avg;
+
+    // Insert back to front so the earlier positions stay valid
+    out.insert(out.begin() + writePos, body, body + sizeof(body) / sizeof(body[0]));
+    out.insert(out.begin() + functionPos, globals.begin(), globals.end());
+    const uint32_t decos[8] = {
+        SpvWord(4, SPV_OP_DECORATE), accumVar, SPV_DECORATION_DESCRIPTOR_SET, set,
+        SpvWord(4, SPV_OP_DECORATE), accumVar, SPV_DECORATION_BINDING, binding,
+    };
+    out.insert(out.begin() + annotationPos, decos, decos + 8);
+    // SPIR-V 1.4+ lists every global the entry point uses in its interface
+    if (out[1] >= SPV_VERSION_1_4) {
+        uint32_t wc = out[entryPos] >> 16;
+        out.insert(out.begin() + entryPos + wc, accumVar);
+        out[entryPos] = SpvWord(wc + 1, SPV_OP_ENTRY_POINT);
+    }
+    out[3] = nextId;
+    return true;
+}
+
+bool VkSpirvSetLocalSize(const uint32_t* code, size_t codeSize, uint32_t x, uint32_t y, std::vector<uint32_t>& out) {
+    size_t words = codeSize / sizeof(uint32_t);
+    out.assign(code, code + words);
+    if (words <= SPV_HEADER_WORDS || code[0] != SPV_MAGIC) return false;
+
+    size_t modePos = 0;
+    for (size_t i = SPV_HEADER_WORDS; i < words;) {
+        uint32_t wc = code[i] >> 16, op = code[i] & 0xFFFF;
+        if (wc == 0 || i + wc > words) return false;   // Malformed
+        const uint32_t* ins = code + i;
+        if (op == SPV_OP_EXECUTION_MODE && wc == 6 && ins[2] == SPV_EXECUTION_MODE_LOCAL_SIZE) modePos = i;
+        else if (op == SPV_OP_DECORATE && wc == 4 && ins[2] == SPV_DECORATION_BUILT_IN && ins[3] == SPV_BUILT_IN_WORKGROUP_SIZE)
+            return false;
+        else if (op == SPV_OP_FUNCTION) break;   // Modes and annotations come first
+        i += wc;
+    }
+    if (!modePos) return false;
+    out[modePos + 3] = x;
+    out[modePos + 4] = y;
+    return true;
+}
+
+// ============== SHADER EXECUTION REORDERING ==============
+// Walks the rewritten module once more: every instruction fits, the id bound
+// covers the new ids and the expected traces are left / added. No substitute
+// for spirv-val, but it catches a broken rewrite before vkCreateShaderModule.
+static bool SerCheckRewrite(const std::vector<uint32_t>& code, uint32_t oldBound, uint32_t tracesRewritten) {
+    if (code.size() <= SPV_HEADER_WORDS || code[0] != SPV_MAGIC || code[3] <= oldBound) return false;
+    uint32_t hitObjectTraces = 0, reorders = 0, executes = 0, capabilities = 0;
+    for (size_t i = SPV_HEADER_WORDS; i < code.size();) {
+        uint32_t wc = code[i] >> 16, op = code[i] & 0xFFFF;
+        if (wc == 0 || i + wc > code.size()) return false;
+        const uint32_t* ins = code.data() + i;
+        switch (op) {
+        case SPV_OP_CAPABILITY: if (ins[1] == SPV_CAPABILITY_SHADER_INVOCATION_REORDER_NV) capabilities++; break;
+        case SPV_OP_HIT_OBJECT_TRACE_RAY_NV: if (wc != 13 || ins[1] >= code[3]) return false; hitObjectTraces++; break;
+        case SPV_OP_REORDER_THREAD_WITH_HIT_OBJECT_NV:
+            if (wc != 4 || ins[1] >= code[3] || ins[2] >= code[3] || ins[3] >= code[3]) return false;
+            reorders++;
+            break;
+        case SPV_OP_HIT_OBJECT_EXECUTE_SHADER_NV: if (wc != 3 || ins[1] >= code[3]) return false; executes++; break;
+        }
+        i += wc;
+    }
+    return capabilities == 1 && hitObjectTraces == tracesRewritten && reorders == tracesRewritten &&
+           executes == tracesRewritten;
+}
+
+bool VkSpirvReorderTraceRays(const uint32_t* code, size_t codeSize, float primaryTMax, const VkSerHintRange* ranges,
+                             uint32_t rangeCount, uint32_t hintBits, std::vector<uint32_t>& out) {
+    size_t words = codeSize / sizeof(uint32_t);
+    out.assign(code, code + words);
+    if (words <= SPV_HEADER_WORDS || code[0] != SPV_MAGIC) return false;
+
+    // Pass 1: uint / float / bool types + constants, insertion points, the traces to rewrite
+    uint32_t uintType = 0, floatType = 0, boolType = 0, primaryTMaxBits = 0, primaries = 0;
+    memcpy(&primaryTMaxBits, &primaryTMax, sizeof(primaryTMaxBits));
+    std::unordered_map<uint32_t, uint32_t> constants;   // OpConstant id -> value (32-bit)
+    std::unordered_map<uint32_t, uint32_t> uintConsts;  // Value -> OpConstant id of the uint type
+    std::unordered_set<uint32_t> floatConsts;           // OpConstant ids of the float type
+    std::unordered_set<size_t> traces;
+    size_t capabilityEnd = 0, functionPos = 0, currentFunction = 0, traceFunction = 0, firstLabel = 0;
+    for (size_t i = SPV_HEADER_WORDS; i < words;) {
+        uint32_t wc = code[i] >> 16, op = code[i] & 0xFFFF;
+        if (wc == 0 || i + wc > words) return false;   // Malformed
+        const uint32_t* ins = code + i;
+        switch (op) {
+        case SPV_OP_CAPABILITY:
+            if (wc == 2 && ins[1] == SPV_CAPABILITY_SHADER_INVOCATION_REORDER_NV) return false;   // Already reorders
+            capabilityEnd = i + wc;
+            break;
+        case SPV_OP_TYPE_BOOL: if (wc == 2) boolType = ins[1]; break;
+        case SPV_OP_TYPE_INT: if (wc == 4 && ins[2] == 32 && ins[3] == 0) uintType = ins[1]; break;
+        case SPV_OP_TYPE_FLOAT: if (wc == 3 && ins[2] == 32) floatType = ins[1]; break;
+        case SPV_OP_CONSTANT:
+            if (wc != 4) break;
+            constants[ins[2]] = ins[3];
+            if (ins[1] == uintType) uintConsts.emplace(ins[3], ins[2]);
+            if (ins[1] == floatType) floatConsts.insert(ins[2]);
+            break;
+        case SPV_OP_FUNCTION:
+            if (!functionPos) functionPos = i;
+            currentFunction = i;
+            break;
+        case SPV_OP_TRACE_RAY_KHR: {
+            if (wc != 12) break;
+            // The primary ray by its RayTmax constant: traced as before
+            auto tMax = constants.find(ins[10]);
+            if (floatConsts.count(ins[10]) && tMax->second == primaryTMaxBits) { primaries++; break; }
+            // Shadow / AO rays: traced as before (no closest hit, or any hit will do)
+            auto flags = constants.find(ins[2]);
+            if (flags == constants.end() || (flags->second & (SPV_RAY_FLAG_SKIP_CLOSEST_HIT | SPV_RAY_FLAG_TERMINATE_ON_FIRST_HIT)))
+                break;
+            if (traceFunction && traceFunction != currentFunction) return false;
+            traceFunction = currentFunction;
+            traces.insert(i);
+            break;
+        }
+        }
+        i += wc;
+    }
+    if (primaries != 1 || traces.empty() || !uintType || !capabilityEnd || !functionPos) return false;
+    for (size_t i = traceFunction; i < words && !firstLabel; i += code[i] >> 16) {
+        if ((code[i] & 0xFFFF) == SPV_OP_LABEL) firstLabel = i;
+    }
+    if (!firstLabel) return false;
+
+    // New ids from the old bound: hit object type / pointer / variable, bool
+    // type and the uint constants of the hint (reused where the module has them)
+    uint32_t nextId = code[3];
+    uint32_t hitObjectType = nextId++, hitObjectPtr = nextId++, hitObject = nextId++;
+    std::vector<uint32_t> globals = {
+        SpvWord(2, SPV_OP_TYPE_HIT_OBJECT_NV), hitObjectType,
+        SpvWord(4, SPV_OP_TYPE_POINTER), hitObjectPtr, SPV_STORAGE_FUNCTION, hitObjectType,
+    };
+    if (!boolType) {
+        boolType = nextId++;
+        const uint32_t inst[2] = { SpvWord(2, SPV_OP_TYPE_BOOL), boolType };
+        globals.insert(globals.end(), inst, inst + 2);
+    }
+    auto uintConst = [&](uint32_t value) {
+        auto c = uintConsts.find(value);
+        if (c != uintConsts.end()) return c->second;
+        uint32_t id = nextId++;
+        const uint32_t inst[4] = { SpvWord(4, SPV_OP_CONSTANT), uintType, id, value };
+        globals.insert(globals.end(), inst, inst + 4);
+        uintConsts.emplace(value, id);
+        return id;
+    };
+    uint32_t zeroConst = uintConst(0), bitsConst = uintConst(hintBits);
+    std::vector<uint32_t> rangeConsts;   // Instance, first primitive, count, hint per range
+    for (uint32_t r = 0; r < rangeCount; r++) {
+        rangeConsts.push_back(uintConst(ranges[r].instance));
+        rangeConsts.push_back(uintConst(ranges[r].firstPrimitive));
+        rangeConsts.push_back(uintConst(ranges[r].primitiveCount));
+        rangeConsts.push_back(uintConst(ranges[r].hint));
+    }
+
+    // Pass 2: copy with the capability / extension, the types, the function
+    // variable (first in the function's first block) and the rewritten traces
+    static const char extension[] = "SPV_NV_shader_invocation_reorder";
+    uint32_t extWords = (uint32_t)(sizeof(extension) + 3) / 4;
+    std::vector<uint32_t> result(code, code + SPV_HEADER_WORDS);
+    result.reserve(words + globals.size() + 16 + traces.size() * (32 + rangeCount * 20));
+    for (size_t i = SPV_HEADER_WORDS; i < words;) {
+        uint32_t wc = code[i] >> 16;
+        const uint32_t* ins = code + i;
+        if (i == capabilityEnd) {
+            result.push_back(SpvWord(2, SPV_OP_CAPABILITY));
+            result.push_back(SPV_CAPABILITY_SHADER_INVOCATION_REORDER_NV);
+            result.push_back(SpvWord(1 + extWords, SPV_OP_EXTENSION));
+            size_t at = result.size();
+            result.resize(at + extWords, 0);
+            memcpy(result.data() + at, extension, sizeof(extension));
+        }
+        if (i == functionPos) result.insert(result.end(), globals.begin(), globals.end());
+
+        if (traces.count(i)) {
+            // hint = the range's hint for a hit inside one of the ranges, else 0
+            uint32_t payload = ins[11], isHit = nextId++, instance = nextId++, primitive = nextId++;
+            result.push_back(SpvWord(13, SPV_OP_HIT_OBJECT_TRACE_RAY_NV));
+            result.push_back(hitObject);
+            result.insert(result.end(), ins + 1, ins + 12);
+            const uint32_t query[] = {
+                SpvWord(4, SPV_OP_HIT_OBJECT_IS_HIT_NV), boolType, isHit, hitObject,
+                SpvWord(4, SPV_OP_HIT_OBJECT_GET_INSTANCE_ID_NV), uintType, instance, hitObject,
+                SpvWord(4, SPV_OP_HIT_OBJECT_GET_PRIMITIVE_INDEX_NV), uintType, primitive, hitObject,
+            };
+            result.insert(result.end(), query, query + sizeof(query) / sizeof(query[0]));
+            uint32_t hint = zeroConst;
+            for (uint32_t r = 0; r < rangeCount; r++) {
+                const uint32_t* rc = rangeConsts.data() + r * 4;
+                uint32_t sameInstance = nextId++, offset = nextId++, inRange = nextId++, match = nextId++, next = nextId++;
+                // (primitive - first) < count, unsigned, covers both bounds
+                const uint32_t select[] = {
+                    SpvWord(5, SPV_OP_IEQUAL), boolType, sameInstance, instance, rc[0],
+                    SpvWord(5, SPV_OP_ISUB), uintType, offset, primitive, rc[1],
+                    SpvWord(5, SPV_OP_ULESS_THAN), boolType, inRange, offset, rc[2],
+                    SpvWord(5, SPV_OP_LOGICAL_AND), boolType, match, sameInstance, inRange,
+                    SpvWord(6, SPV_OP_SELECT), uintType, next, match, rc[3], hint,
+                };
+                result.insert(result.end(), select, select + sizeof(select) / sizeof(select[0]));
+                hint = next;
+            }
+            uint32_t hitHint = nextId++;
+            const uint32_t reorder[] = {
+                SpvWord(6, SPV_OP_SELECT), uintType, hitHint, isHit, hint, zeroConst,
+                SpvWord(4, SPV_OP_REORDER_THREAD_WITH_HIT_OBJECT_NV), hitObject, hitHint, bitsConst,
+                SpvWord(3, SPV_OP_HIT_OBJECT_EXECUTE_SHADER_NV), hitObject, payload,
+            };
+            result.insert(result.end(), reorder, reorder + sizeof(reorder) / sizeof(reorder[0]));
+        } else {
+            result.insert(result.end(), ins, ins + wc);
+        }
+        if (i == firstLabel) {
+            const uint32_t var[4] = { SpvWord(4, SPV_OP_VARIABLE), hitObjectPtr, hitObject, SPV_STORAGE_FUNCTION };
+            result.insert(result.end(), var, var + 4);
+        }
+        i += wc;
+    }
+    result[3] = nextId;
+    if (!SerCheckRewrite(result, code[3], (uint32_t)traces.size())) return false;
+    out.swap(result);
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+// ============== VULKAN SHADER FEATURE PERMUTATIONS ==============
+// Shared by the Vulkan RT and Vulkan RQ renderers. The D3D12 DXR paths compile
+// one variant per feature set with #ifdef; the Vulkan shaders read the same
+// feature bits (VulkanRTFeatures::Bits) from a specialization constant
+// instead (layout(constant_id = VK_SPEC_ID_FEATURES) const uint FEATURES), so
+// the driver folds the branches and drops disabled effects (AO sample loops,
+// soft shadow loops, glass refraction) from the compiled pipeline.
+//
+// The embedded SPIR-V predates that constant and still loads scene.features
+// from the uniform block. VkSpirvSpecializeMember rewrites those loads into
+// uses of an OpSpecConstant at module creation; SPIR-V that already declares
+// the SpecId is passed through unchanged. Each feature set becomes its own
+// pipeline entry in the renderer's VkPipelineCache (vk_pipeline_cache.h).
+
+#include "vulkan.h"
+#include <vector>
+
+#define VK_SPEC_ID_FEATURES 0
+
+// Copies code (codeSize in bytes) to out, replacing every OpLoad of uniform
+// block member `member` with an OpSpecConstant (SpecId specId, default
+// defaultValue). Returns false if nothing was rewritten (out is a plain copy).
+bool VkSpirvSpecializeMember(const uint32_t* code, size_t codeSize, const char* member,
+                             uint32_t specId, uint32_t defaultValue, std::vector<uint32_t>& out);
+
+// One uint32 specialization constant. Fill with VkSpecFeaturesInit and point
+// VkPipelineShaderStageCreateInfo::pSpecializationInfo at info; the struct
+// must stay in place until the pipeline is created.
+struct VkSpecFeatures {
+    VkSpecializationMapEntry entry;
+    uint32_t value;
+    VkSpecializationInfo info;
+};
+void VkSpecFeaturesInit(VkSpecFeatures& spec, uint32_t features);
+
+// ============== PUSH CONSTANTS -> STORAGE BUFFER ==============
+// For command buffers recorded once (Vulkan raster --prerecord): the per-frame
+// data can't be pushed, so the push_constant block of the embedded raster
+// shaders is turned into a read-only storage buffer at (set, binding), read
+// through a dynamic offset. Same member offsets, so the CPU struct is unchanged.
+// An SSBO (BufferBlock) rather than a UBO since the block's float[3] padding
+// has a 4-byte array stride, which std140 doesn't allow.
+// Returns false if the module has no push constant block (out is a plain copy).
+bool VkSpirvPushConstantsToStorageBuffer(const uint32_t* code, size_t codeSize, uint32_t set, uint32_t binding,
+                                         std::vector<uint32_t>& out);
+
+// ============== IMAGE STORE -> RUNNING AVERAGE ==============
+// For --accumulate (accumulation.h) on the Vulkan RQ tracer. The single
+// imageStore(outputImage, pixel, color) of the module becomes
+//     sum = imageLoad(accum, pixel) + color; imageStore(accum, pixel, sum);
+//     imageStore(outputImage, pixel, sum / sum.w);
+// with accum a new rgba32f storage image at (set, binding). The shader writes
+// color.w = 1, so sum.w counts the samples; clearing accum restarts the sum.
+// Returns false if the module doesn't have exactly one vec4 OpImageWrite (out
+// is a plain copy).
+bool VkSpirvAccumulateImageStore(const uint32_t* code, size_t codeSize, uint32_t set, uint32_t binding,
+                                 std::vector<uint32_t>& out);
+
+// ============== WORKGROUP SIZE ==============
+// For --group-size (group_tune.h) on the Vulkan RQ tracer: rewrites the x / y
+// of the module's OpExecutionMode LocalSize. Returns false (out is a plain
+// copy) if there is none, or if the module decorates a BuiltIn WorkgroupSize
+// constant, which would override the execution mode.
+bool VkSpirvSetLocalSize(const uint32_t* code, size_t codeSize, uint32_t x, uint32_t y, std::vector<uint32_t>& out);
+
+// ============== SHADER EXECUTION REORDERING ==============
+// For --ser (ray_reorder.h) on the Vulkan RT raygen: every OpTraceRayKHR that
+// runs the closest hit shader (RayFlags constant without SkipClosestHitShader /
+// TerminateOnFirstHit, i.e. not a shadow / AO ray) except the primary ray -
+// the one trace whose RayTmax is the constant primaryTMax - becomes
+//     hitObjectTraceRayNV(hitObject, <same operands>);
+//     reorderThreadNV(hitObject, hint, hintBits);
+//     hitObjectExecuteShaderNV(hitObject, payload);
+// (SPV_NV_shader_invocation_reorder). hint is the material of the hit: the
+// hint of the range holding its TLAS instance + primitive index, 0 for other
+// hits and misses. Returns false (out is a plain copy) if there is nothing to
+// rewrite, the primary trace isn't found exactly once, the traces are spread
+// over several functions, or the rewritten module fails a structural check.
+struct VkSerHintRange {
+    uint32_t instance;          // gl_InstanceID
+    uint32_t firstPrimitive;    // gl_PrimitiveID range [first, first + count)
+    uint32_t primitiveCount;
+    uint32_t hint;              // < 1 << hintBits
+};
+bool VkSpirvReorderTraceRays(const uint32_t* code, size_t codeSize, float primaryTMax, const VkSerHintRange* ranges,
+                             uint32_t rangeCount, uint32_t hintBits, std::vector<uint32_t>& out);
@@ -0,0 +1,57 @@
+// ============== VULKAN STARTUP GPU TIMER ==============
+// Two-timestamp query pool per timed init submission (see vk_startup_timer.h)
+
+#include "vulkan.h"
+#include "../common.h"
+#include "../startup_profiler.h"
+#include "vk_startup_timer.h"
+#include <vector>
+
+bool VkStartupTimerBegin(VkStartupTimer& timer, VkPhysicalDevice physicalDevice, VkDevice device,
+                         uint32_t queueFamily, VkCommandBuffer cmd) {
+    timer = {};
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+    if (queueFamily >= familyCount || families[queueFamily].timestampValidBits == 0) return false;
+    uint32_t validBits = families[queueFamily].timestampValidBits;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+    VkQueryPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = 2;
+    if (vkCreateQueryPool(device, &poolInfo, nullptr, &timer.pool) != VK_SUCCESS) {
+        timer = {};
+        return false;
+    }
+    timer.device = device;
+    timer.periodNs = props.limits.timestampPeriod;
+    timer.validMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    vkCmdResetQueryPool(cmd, timer.pool, 0, 2);
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timer.pool, 0);
+    return true;
+}
+
+void VkStartupTimerEnd(VkStartupTimer& timer, VkCommandBuffer cmd) {
+    if (!timer.pool) return;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timer.pool, 1);
+    timer.recorded = true;
+}
+
+void VkStartupTimerCollect(VkStartupTimer& timer, const char* name) {
+    if (timer.recorded) {
+        uint64_t ticks[2] = {};
+        if (vkGetQueryPoolResults(timer.device, timer.pool, 0, 2, sizeof(ticks), ticks, sizeof(uint64_t),
+                                  VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+            uint64_t begin = ticks[0] & timer.validMask, end = ticks[1] & timer.validMask;
+            if (end > begin) StartupAddGpuTime(name, (double)(end - begin) * timer.periodNs / 1e6);
+        }
+    }
+    if (timer.pool) vkDestroyQueryPool(timer.device, timer.pool, nullptr);
+    timer = {};
+}
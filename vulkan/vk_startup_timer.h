@@ -0,0 +1,23 @@
+#pragma once
+// ============== VULKAN STARTUP GPU TIMER ==============
+// Init-time GPU timing for the startup profiler (startup_profiler.h), shared
+// by the Vulkan RT and RQ renderers for their AS builds. Begin writes the
+// first timestamp into a one-time command buffer, End the second (same or a
+// later buffer on the same queue), Collect after the queue is idle adds the
+// duration as a GPU leaf of the open startup phase and destroys the pool.
+// Queue families without timestamps (timestampValidBits == 0) are skipped.
+
+#include "vulkan.h"
+
+struct VkStartupTimer {
+    VkDevice device;
+    VkQueryPool pool;
+    double periodNs;
+    uint64_t validMask;
+    bool recorded;
+};
+
+bool VkStartupTimerBegin(VkStartupTimer& timer, VkPhysicalDevice physicalDevice, VkDevice device,
+                         uint32_t queueFamily, VkCommandBuffer cmd);
+void VkStartupTimerEnd(VkStartupTimer& timer, VkCommandBuffer cmd);
+void VkStartupTimerCollect(VkStartupTimer& timer, const char* name);
@@ -0,0 +1,57 @@
+// ============== VULKAN TLAS UPDATE ==============
+// Refit / rebuild recording for the per-frame-slot TLAS (see vk_tlas.h)
+
+#include "vk_tlas.h"
+
+VkDeviceSize VkTlasScratchSize(const VkAccelerationStructureBuildSizesInfoKHR& sizeInfo) {
+    return sizeInfo.buildScratchSize > sizeInfo.updateScratchSize ? sizeInfo.buildScratchSize : sizeInfo.updateScratchSize;
+}
+
+void VkTlasRecord(VkCommandBuffer cmd, PFN_vkCmdBuildAccelerationStructuresKHR pfnBuild, TlasPolicy& policy,
+                  const VkAccelerationStructureInstanceKHR* instances, uint32_t count, VkDeviceAddress instanceAddress,
+                  VkAccelerationStructureKHR src, VkAccelerationStructureKHR dst, VkDeviceAddress scratchAddress,
+                  VkPipelineStageFlags dstStage) {
+    bool rebuild = src == VK_NULL_HANDLE ||
+                   TlasPolicyDecide(policy, instances, count, sizeof(VkAccelerationStructureInstanceKHR));
+
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    if (!rebuild) {
+        // The previous frame's build of src must be complete before it is read
+        barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                             VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    VkAccelerationStructureGeometryKHR geometry = {};
+    geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+    geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+    geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+    geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+    geometry.geometry.instances.arrayOfPointers = VK_FALSE;
+    geometry.geometry.instances.data.deviceAddress = instanceAddress;
+
+    VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
+    buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+    buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+    buildInfo.flags = VK_TLAS_BUILD_FLAGS;
+    buildInfo.mode = rebuild ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+    buildInfo.srcAccelerationStructure = rebuild ? VK_NULL_HANDLE : src;
+    buildInfo.dstAccelerationStructure = dst;
+    buildInfo.geometryCount = 1;
+    buildInfo.pGeometries = &geometry;
+    buildInfo.scratchData.deviceAddress = scratchAddress;
+
+    VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {};
+    rangeInfo.primitiveCount = count;
+    const VkAccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
+    pfnBuild(cmd, 1, &buildInfo, &pRangeInfo);
+
+    // TLAS must be built before the trace reads it
+    barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, dstStage,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
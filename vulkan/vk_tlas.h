@@ -0,0 +1,24 @@
+#pragma once
+// ============== VULKAN TLAS UPDATE ==============
+// Shared by the Vulkan RT and Vulkan RQ renderers. Each keeps one TLAS per
+// frame slot; frame N refits its slot's TLAS from the previous slot's (written
+// by frame N-1 on the same queue) instead of rebuilding it, and the policy in
+// tlas_policy.h decides when the BVH is rebuilt from scratch.
+
+#include "vulkan.h"
+#include "../tlas_policy.h"
+
+// Every TLAS build (init and per frame) must use the same flags, or MODE_UPDATE is invalid
+#define VK_TLAS_BUILD_FLAGS (VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | \
+                             VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR)
+
+// Scratch size covering both a full build and an update
+VkDeviceSize VkTlasScratchSize(const VkAccelerationStructureBuildSizesInfoKHR& sizeInfo);
+
+// Records a refit of src into dst (or a full build of dst, as the policy
+// decides) from count instances at instanceAddress, followed by a barrier that
+// makes dst visible to dstStage. instances is the host copy the device reads.
+void VkTlasRecord(VkCommandBuffer cmd, PFN_vkCmdBuildAccelerationStructuresKHR pfnBuild, TlasPolicy& policy,
+                  const VkAccelerationStructureInstanceKHR* instances, uint32_t count, VkDeviceAddress instanceAddress,
+                  VkAccelerationStructureKHR src, VkAccelerationStructureKHR dst, VkDeviceAddress scratchAddress,
+                  VkPipelineStageFlags dstStage);
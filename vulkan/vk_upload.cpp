@@ -0,0 +1,179 @@
+// ============== VULKAN STATIC GEOMETRY UPLOAD ==============
+// See vk_upload.h. Init-time only: the fence wait in VkUploadFlush is the one
+// CPU stall for all static geometry of a renderer.
+
+#define VK_USE_PLATFORM_WIN32_KHR
+#include "vulkan.h"
+#include "../common.h"
+#include "../startup_profiler.h"
+#include "vk_upload.h"
+#include "vk_memory.h"
+
+// ============== UPLOAD GLOBALS ==============
+struct VkStagingBuffer {
+    VkBuffer buffer;
+    VkMemAlloc memory;
+};
+
+static VkDevice s_upDevice = VK_NULL_HANDLE;
+static VkQueue s_upQueue = VK_NULL_HANDLE;
+static VkCommandPool s_upPool = VK_NULL_HANDLE;
+static VkCommandBuffer s_upCmd = VK_NULL_HANDLE;
+static VkFence s_upFence = VK_NULL_HANDLE;
+static uint32_t s_upFamilies[2] = {};
+static uint32_t s_upFamilyCount = 1;    // 2 = dedicated transfer family, buffers are CONCURRENT
+static std::vector<VkStagingBuffer> s_upStaging;
+static VkDeviceSize s_upBytes = 0;
+
+// Memory comes from the renderer's sub-allocator (vk_memory.h); RT/RQ
+// geometry read through buffer device addresses relies on VkMemInit's
+// deviceAddress flag
+static bool UploadCreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                               bool shared, VkBuffer& buffer, VkMemAlloc& memory) {
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    if (shared && s_upFamilyCount > 1) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = s_upFamilyCount;
+        bufferInfo.pQueueFamilyIndices = s_upFamilies;
+    } else {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+    if (vkCreateBuffer(s_upDevice, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) return false;
+
+    if (!VkMemAllocBuffer(buffer, properties, memory)) {
+        vkDestroyBuffer(s_upDevice, buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
+        return false;
+    }
+    return true;
+}
+
+static void UploadReleaseAll() {
+    for (VkStagingBuffer& s : s_upStaging) {
+        vkDestroyBuffer(s_upDevice, s.buffer, nullptr);
+        VkMemFree(s.memory);
+    }
+    s_upStaging.clear();
+    s_upBytes = 0;
+    if (s_upFence) { vkDestroyFence(s_upDevice, s_upFence, nullptr); s_upFence = VK_NULL_HANDLE; }
+    if (s_upPool) { vkDestroyCommandPool(s_upDevice, s_upPool, nullptr); s_upPool = VK_NULL_HANDLE; }
+    s_upCmd = VK_NULL_HANDLE;
+    s_upQueue = VK_NULL_HANDLE;
+    s_upDevice = VK_NULL_HANDLE;
+}
+
+// ============== PUBLIC API ==============
+uint32_t VkUploadFindTransferFamily(VkPhysicalDevice physicalDevice) {
+    uint32_t count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, families.data());
+    for (uint32_t i = 0; i < count; i++) {
+        VkQueueFlags f = families[i].queueFlags;
+        if ((f & VK_QUEUE_TRANSFER_BIT) && !(f & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) && families[i].queueCount > 0)
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+bool VkUploadBegin(VkDevice device, uint32_t transferFamily, uint32_t graphicsFamily) {
+    if (s_upDevice) {
+        Log("[WARN] VkUploadBegin: previous batch was never flushed, flushing now\n");
+        if (!VkUploadFlush()) return false;
+    }
+    s_upDevice = device;
+
+    uint32_t family = (transferFamily != UINT32_MAX) ? transferFamily : graphicsFamily;
+    s_upFamilies[0] = family;
+    s_upFamilies[1] = graphicsFamily;
+    s_upFamilyCount = (family != graphicsFamily) ? 2 : 1;
+    vkGetDeviceQueue(device, family, 0, &s_upQueue);
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = family;
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &s_upPool) != VK_SUCCESS) {
+        Log("[ERROR] VkUploadBegin: failed to create command pool\n");
+        UploadReleaseAll();
+        return false;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = s_upPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkAllocateCommandBuffers(device, &allocInfo, &s_upCmd) != VK_SUCCESS ||
+        vkCreateFence(device, &fenceInfo, nullptr, &s_upFence) != VK_SUCCESS) {
+        Log("[ERROR] VkUploadBegin: failed to create command buffer / fence\n");
+        UploadReleaseAll();
+        return false;
+    }
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(s_upCmd, &beginInfo);
+    return true;
+}
+
+bool VkUploadBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+                    VkBuffer& buffer, VkMemAlloc& memory, const char* tag) {
+    if (!s_upCmd) {
+        Log("[ERROR] VkUploadBuffer(%s) called outside VkUploadBegin/VkUploadFlush\n", tag);
+        return false;
+    }
+
+    VkStagingBuffer staging = {};
+    if (!UploadCreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            false, staging.buffer, staging.memory)) {
+        Log("[ERROR] VkUploadBuffer(%s): failed to create %llu byte staging buffer\n", tag, (unsigned long long)size);
+        return false;
+    }
+    memcpy(staging.memory.mapped, data, (size_t)size);
+    s_upStaging.push_back(staging);
+
+    if (!UploadCreateBuffer(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            true, buffer, memory)) {
+        Log("[ERROR] VkUploadBuffer(%s): failed to create %llu byte device-local buffer\n", tag, (unsigned long long)size);
+        return false;
+    }
+
+    VkBufferCopy region = {};
+    region.size = size;
+    vkCmdCopyBuffer(s_upCmd, staging.buffer, buffer, 1, &region);
+    s_upBytes += size;
+    return true;
+}
+
+bool VkUploadFlush() {
+    if (!s_upCmd) return true;
+    StartupScope scope("Upload flush");
+
+    bool ok = vkEndCommandBuffer(s_upCmd) == VK_SUCCESS;
+    uint32_t count = (uint32_t)s_upStaging.size();
+    if (ok && count > 0) {
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &s_upCmd;
+        ok = vkQueueSubmit(s_upQueue, 1, &submitInfo, s_upFence) == VK_SUCCESS &&
+             vkWaitForFences(s_upDevice, 1, &s_upFence, VK_TRUE, UINT64_MAX) == VK_SUCCESS;
+        if (ok) {
+            Log("[INFO] Uploaded %u static buffers (%.1f KB) via %s queue\n", count, s_upBytes / 1024.0,
+                s_upFamilyCount > 1 ? "transfer" : "graphics");
+        } else {
+            Log("[ERROR] VkUploadFlush: submit/wait failed\n");
+        }
+    }
+
+    UploadReleaseAll();
+    return ok;
+}
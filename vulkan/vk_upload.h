@@ -0,0 +1,27 @@
+#pragma once
+// ============== VULKAN STATIC GEOMETRY UPLOAD ==============
+// Shared by the Vulkan, Vulkan RT and Vulkan RQ renderers (each owns its own
+// VkDevice). Static vertex/index/instance buffers are staged in host-visible
+// memory and copied into DEVICE_LOCAL buffers on a dedicated transfer queue
+// when the GPU has one (graphics queue otherwise). All copies recorded between
+// VkUploadBegin and VkUploadFlush go out in one submit behind one fence.
+
+#include "vulkan.h"
+#include "vk_memory.h"
+
+// Transfer-only queue family (TRANSFER without GRAPHICS/COMPUTE), or UINT32_MAX.
+// Call before vkCreateDevice and request one queue of it there.
+uint32_t VkUploadFindTransferFamily(VkPhysicalDevice physicalDevice);
+
+// transferFamily may be UINT32_MAX - the graphics queue is used instead.
+// Staging and destination memory come from vk_memory.h (VkMemInit first).
+bool VkUploadBegin(VkDevice device, uint32_t transferFamily, uint32_t graphicsFamily);
+
+// Creates a DEVICE_LOCAL buffer (usage | TRANSFER_DST) and records its copy.
+// With a separate transfer family the buffer is CONCURRENT between it and the
+// graphics family, so no queue ownership transfer is needed.
+bool VkUploadBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+                    VkBuffer& buffer, VkMemAlloc& memory, const char* tag);
+
+// Submit, wait on the fence, free staging memory and the transfer command pool.
+bool VkUploadFlush();
@@ -0,0 +1,1112 @@
+// ============== VULKAN VIDEO RECORDING ==============
+// See vk_video_record.h. The stream is I/P only: an IDR (preceded by SPS/PPS,
+// so the file can be cut or seeked anywhere) every VK_RECORD_GOP frames, and
+// every P frame references the picture before it. The two DPB slots alternate
+// between "previous picture" and "reconstructed picture". Slots cycle
+// FREE -> READBACK (copy recorded) -> CONVERTING (writer thread) -> CONVERTED
+// -> PENDING (upload recorded this frame) -> ENCODING (writer thread) -> FREE,
+// and are uploaded strictly in the order they were read back.
+
+#include "vulkan.h"
+#include "../common.h"
+#include "vk_video_record.h"
+#include "vk_memory.h"
+
+#define VK_RECORD_SLOTS 4
+#define VK_RECORD_GOP 120           // 2 s of video at VK_RECORD_FPS
+#define VK_RECORD_QUEUE_SIZE 8      // Power of two, >= VK_RECORD_SLOTS
+#define VK_RECORD_MB 16             // H.264 macroblock size
+
+enum RecordSlotState {
+    RECORD_FREE,
+    RECORD_READBACK,                // Source copy recorded, its frame slot's fence hasn't passed yet
+    RECORD_CONVERTING,              // Writer thread converts the pixels to NV12
+    RECORD_CONVERTED,               // NV12 ready for the next frame's upload
+    RECORD_PENDING,                 // Upload recorded, submitted by VkRecordSubmit
+    RECORD_ENCODING                 // Owned by the writer thread
+};
+
+struct RecordSlot {
+    volatile LONG state;
+    VkBuffer readback;              // Source pixels (4 bytes each, tightly packed), host-visible
+    VkMemAlloc readbackMemory;
+    VkBuffer nv12Buffer;            // CPU-converted NV12, both planes, host-visible
+    VkMemAlloc nv12Memory;
+    VkImage image;                  // Encode input (NV12)
+    VkMemAlloc imageMemory;
+    VkImageView view;
+    VkBuffer bitstream;             // Encode output, host-visible
+    VkMemAlloc bitstreamMemory;
+    VkSemaphore ready;              // Graphics submission -> encode submission
+    VkFence done;                   // Encode submission -> writer thread
+    VkCommandBuffer encodeCmd;
+    uint32_t frameSlot;             // Renderer frame slot whose fence covers the readback
+    uint32_t sequence;              // Readback order, the order of the uploads
+    bool bgra;                      // Source bytes are B, G, R, A
+    bool idr;                       // Writer prepends SPS/PPS
+};
+
+// ============== RECORD GLOBALS ==============
+static PFN_vkGetPhysicalDeviceVideoCapabilitiesKHR pvkGetPhysicalDeviceVideoCapabilitiesKHR = nullptr;
+static PFN_vkGetPhysicalDeviceVideoFormatPropertiesKHR pvkGetPhysicalDeviceVideoFormatPropertiesKHR = nullptr;
+static PFN_vkCreateVideoSessionKHR pvkCreateVideoSessionKHR = nullptr;
+static PFN_vkDestroyVideoSessionKHR pvkDestroyVideoSessionKHR = nullptr;
+static PFN_vkGetVideoSessionMemoryRequirementsKHR pvkGetVideoSessionMemoryRequirementsKHR = nullptr;
+static PFN_vkBindVideoSessionMemoryKHR pvkBindVideoSessionMemoryKHR = nullptr;
+static PFN_vkCreateVideoSessionParametersKHR pvkCreateVideoSessionParametersKHR = nullptr;
+static PFN_vkDestroyVideoSessionParametersKHR pvkDestroyVideoSessionParametersKHR = nullptr;
+static PFN_vkGetEncodedVideoSessionParametersKHR pvkGetEncodedVideoSessionParametersKHR = nullptr;
+static PFN_vkCmdBeginVideoCodingKHR pvkCmdBeginVideoCodingKHR = nullptr;
+static PFN_vkCmdEndVideoCodingKHR pvkCmdEndVideoCodingKHR = nullptr;
+static PFN_vkCmdControlVideoCodingKHR pvkCmdControlVideoCodingKHR = nullptr;
+static PFN_vkCmdEncodeVideoKHR pvkCmdEncodeVideoKHR = nullptr;
+
+static VkPhysicalDevice s_recPhysicalDevice = VK_NULL_HANDLE;
+static VkDevice s_recDevice = VK_NULL_HANDLE;
+static uint32_t s_recEncodeFamily = UINT32_MAX;
+static uint32_t s_recGraphicsFamily = UINT32_MAX;
+static VkFormat s_recDpbFormat = VK_FORMAT_UNDEFINED;
+static VkPhysicalDeviceSynchronization2Features s_recSync2Features = {};
+
+// Profile: H.264 Main, 4:2:0 8-bit. Every object created for the session
+// points at these, so the profile is the same everywhere.
+static VkVideoEncodeUsageInfoKHR s_recUsage = {};
+static VkVideoEncodeH264ProfileInfoKHR s_recH264Profile = {};
+static VkVideoProfileInfoKHR s_recProfile = {};
+static VkVideoProfileListInfoKHR s_recProfileList = {};
+static VkVideoCapabilitiesKHR s_recCaps = {};
+static VkVideoEncodeCapabilitiesKHR s_recEncodeCaps = {};
+static VkVideoEncodeH264CapabilitiesKHR s_recH264Caps = {};
+
+// Queue, slots
+static VkQueue s_recEncodeQueue = VK_NULL_HANDLE;
+static VkCommandPool s_recEncodePool = VK_NULL_HANDLE;
+static RecordSlot s_recSlots[VK_RECORD_SLOTS] = {};
+static int s_recPendingSlot = -1;
+static uint32_t s_recReadbackSeq = 0;           // Sequence of the next readback
+static uint32_t s_recUploadSeq = 0;             // Sequence the next upload must have
+static bool s_recFailed = false;                // Unrecoverable error, not retried until cleanup
+
+// Session (one per extent)
+static VkVideoSessionKHR s_recSession = VK_NULL_HANDLE;
+static VkVideoSessionParametersKHR s_recParams = VK_NULL_HANDLE;
+static std::vector<VkDeviceMemory> s_recSessionMemory;
+static VkImage s_recDpbImage = VK_NULL_HANDLE;  // 2 layers, one per DPB slot
+static VkMemAlloc s_recDpbMemory;
+static VkImageView s_recDpbView = VK_NULL_HANDLE;
+static VkQueryPool s_recQueryPool = VK_NULL_HANDLE;
+static VkExtent2D s_recExtent = {};             // Source size
+static VkExtent2D s_recCodedExtent = {};        // Macroblock-aligned, cropped back in the SPS
+static VkDeviceSize s_recBitstreamSize = 0;
+static VkVideoEncodeRateControlModeFlagBitsKHR s_recRcMode = VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DEFAULT_KHR;
+static VkVideoEncodeRateControlLayerInfoKHR s_recRcLayer = {};
+static VkVideoEncodeH264RateControlInfoKHR s_recH264Rc = {};
+static VkVideoEncodeRateControlInfoKHR s_recRc = {};
+static std::vector<BYTE> s_recHeader;           // Encoded SPS + PPS
+
+// Stream state (render thread)
+static bool s_recNeedsReset = true;             // Next encode command starts with a session reset
+static uint32_t s_recGopFrame = 0;
+static uint16_t s_recIdrId = 0;
+static int s_recDpbLast = -1;                   // DPB slot holding the previous picture
+static StdVideoEncodeH264ReferenceInfo s_recDpbInfo[2] = {};
+static LONGLONG s_recNextQpc = 0;
+
+// Writer thread: single producer (render thread), single consumer
+static int s_recQueue[VK_RECORD_QUEUE_SIZE];
+static volatile LONG s_recQueueHead = 0;
+static volatile LONG s_recQueueTail = 0;
+static HANDLE s_recWriterThread = nullptr;
+static HANDLE s_recWriterWake = nullptr;
+static FILE* s_recFile = nullptr;
+static bool s_recFileStarted = false;           // Later sessions append
+static volatile LONG s_recFrames = 0;
+static volatile LONG s_recDropped = 0;
+static volatile LONGLONG s_recBytes = 0;
+
+// ============== HELPERS ==============
+static uint32_t AlignUp32(uint32_t v, uint32_t align) { return (v + align - 1) / align * align; }
+
+static uint32_t RecordMemoryType(uint32_t typeBits, VkMemoryPropertyFlags wanted) {
+    VkPhysicalDeviceMemoryProperties props;
+    vkGetPhysicalDeviceMemoryProperties(s_recPhysicalDevice, &props);
+    for (uint32_t i = 0; i < props.memoryTypeCount; i++)
+        if ((typeBits & (1u << i)) && (props.memoryTypes[i].propertyFlags & wanted) == wanted) return i;
+    for (uint32_t i = 0; i < props.memoryTypeCount; i++)
+        if (typeBits & (1u << i)) return i;
+    return UINT32_MAX;
+}
+
+// The writer reads every bitstream byte once; write-combined memory makes that slow
+static VkMemoryPropertyFlags RecordReadbackFlags(VkBuffer buffer) {
+    const VkMemoryPropertyFlags cached = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    VkMemoryRequirements memReqs;
+    vkGetBufferMemoryRequirements(s_recDevice, buffer, &memReqs);
+    VkPhysicalDeviceMemoryProperties props;
+    vkGetPhysicalDeviceMemoryProperties(s_recPhysicalDevice, &props);
+    for (uint32_t i = 0; i < props.memoryTypeCount; i++)
+        if ((memReqs.memoryTypeBits & (1u << i)) && (props.memoryTypes[i].propertyFlags & cached) == cached) return cached;
+    return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+static const char* RateControlName(VkVideoEncodeRateControlModeFlagBitsKHR mode) {
+    switch (mode) {
+    case VK_VIDEO_ENCODE_RATE_CONTROL_MODE_VBR_BIT_KHR: return "VBR";
+    case VK_VIDEO_ENCODE_RATE_CONTROL_MODE_CBR_BIT_KHR: return "CBR";
+    default: return "driver default";
+    }
+}
+
+// Formats the profile supports for usage; the first one if wanted isn't among them
+static VkFormat RecordFormat(VkImageUsageFlags usage, VkFormat wanted) {
+    VkPhysicalDeviceVideoFormatInfoKHR formatInfo = {};
+    formatInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VIDEO_FORMAT_INFO_KHR;
+    formatInfo.pNext = &s_recProfileList;
+    formatInfo.imageUsage = usage;
+    uint32_t count = 0;
+    if (pvkGetPhysicalDeviceVideoFormatPropertiesKHR(s_recPhysicalDevice, &formatInfo, &count, nullptr) != VK_SUCCESS || !count)
+        return VK_FORMAT_UNDEFINED;
+    std::vector<VkVideoFormatPropertiesKHR> formats(count);
+    for (auto& f : formats) { f = {}; f.sType = VK_STRUCTURE_TYPE_VIDEO_FORMAT_PROPERTIES_KHR; }
+    pvkGetPhysicalDeviceVideoFormatPropertiesKHR(s_recPhysicalDevice, &formatInfo, &count, formats.data());
+    for (uint32_t i = 0; i < count; i++)
+        if (formats[i].format == wanted) return wanted;
+    return wanted == VK_FORMAT_UNDEFINED ? formats[0].format : VK_FORMAT_UNDEFINED;
+}
+
+static void SetupProfile() {
+    s_recUsage = {};
+    s_recUsage.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_USAGE_INFO_KHR;
+    s_recUsage.videoUsageHints = VK_VIDEO_ENCODE_USAGE_RECORDING_BIT_KHR;
+    s_recUsage.videoContentHints = VK_VIDEO_ENCODE_CONTENT_RENDERED_BIT_KHR;
+    s_recUsage.tuningMode = VK_VIDEO_ENCODE_TUNING_MODE_DEFAULT_KHR;
+
+    s_recH264Profile = {};
+    s_recH264Profile.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_PROFILE_INFO_KHR;
+    s_recH264Profile.pNext = &s_recUsage;
+    s_recH264Profile.stdProfileIdc = STD_VIDEO_H264_PROFILE_IDC_MAIN;
+
+    s_recProfile = {};
+    s_recProfile.sType = VK_STRUCTURE_TYPE_VIDEO_PROFILE_INFO_KHR;
+    s_recProfile.pNext = &s_recH264Profile;
+    s_recProfile.videoCodecOperation = VK_VIDEO_CODEC_OPERATION_ENCODE_H264_BIT_KHR;
+    s_recProfile.chromaSubsampling = VK_VIDEO_CHROMA_SUBSAMPLING_420_BIT_KHR;
+    s_recProfile.lumaBitDepth = VK_VIDEO_COMPONENT_BIT_DEPTH_8_BIT_KHR;
+    s_recProfile.chromaBitDepth = VK_VIDEO_COMPONENT_BIT_DEPTH_8_BIT_KHR;
+
+    s_recProfileList = {};
+    s_recProfileList.sType = VK_STRUCTURE_TYPE_VIDEO_PROFILE_LIST_INFO_KHR;
+    s_recProfileList.profileCount = 1;
+    s_recProfileList.pProfiles = &s_recProfile;
+}
+
+// ============== DEVICE SETUP ==============
+uint32_t VkRecordEnable(VkInstance instance, VkPhysicalDevice physicalDevice, std::vector<const char*>& extensions,
+                        void** pNextChain, const char* tag) {
+    s_recEncodeFamily = UINT32_MAX;
+    if (!g_recordPath[0]) return UINT32_MAX;
+    s_recPhysicalDevice = physicalDevice;
+
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> exts(count);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, exts.data());
+    const char* required[] = {
+        VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+        VK_KHR_VIDEO_QUEUE_EXTENSION_NAME,
+        VK_KHR_VIDEO_ENCODE_QUEUE_EXTENSION_NAME,
+        VK_KHR_VIDEO_ENCODE_H264_EXTENSION_NAME
+    };
+    for (const char* name : required) {
+        bool found = false;
+        for (const auto& e : exts) if (strcmp(e.extensionName, name) == 0) found = true;
+        if (!found) {
+            Log("[WARN] %s: %s unavailable, --record ignored\n", tag, name);
+            return UINT32_MAX;
+        }
+    }
+
+    pvkGetPhysicalDeviceVideoCapabilitiesKHR = (PFN_vkGetPhysicalDeviceVideoCapabilitiesKHR)
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceVideoCapabilitiesKHR");
+    pvkGetPhysicalDeviceVideoFormatPropertiesKHR = (PFN_vkGetPhysicalDeviceVideoFormatPropertiesKHR)
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceVideoFormatPropertiesKHR");
+    if (!pvkGetPhysicalDeviceVideoCapabilitiesKHR || !pvkGetPhysicalDeviceVideoFormatPropertiesKHR) {
+        Log("[WARN] %s: video capability queries not found, --record ignored\n", tag);
+        return UINT32_MAX;
+    }
+
+    // Encode queue family with H.264
+    vkGetPhysicalDeviceQueueFamilyProperties2(physicalDevice, &count, nullptr);
+    std::vector<VkQueueFamilyProperties2> families(count);
+    std::vector<VkQueueFamilyVideoPropertiesKHR> videoProps(count);
+    for (uint32_t i = 0; i < count; i++) {
+        videoProps[i] = {};
+        videoProps[i].sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_VIDEO_PROPERTIES_KHR;
+        families[i] = {};
+        families[i].sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_PROPERTIES_2;
+        families[i].pNext = &videoProps[i];
+    }
+    vkGetPhysicalDeviceQueueFamilyProperties2(physicalDevice, &count, families.data());
+    uint32_t family = UINT32_MAX;
+    for (uint32_t i = 0; i < count && family == UINT32_MAX; i++) {
+        if ((families[i].queueFamilyProperties.queueFlags & VK_QUEUE_VIDEO_ENCODE_BIT_KHR) &&
+            (videoProps[i].videoCodecOperations & VK_VIDEO_CODEC_OPERATION_ENCODE_H264_BIT_KHR))
+            family = i;
+    }
+    if (family == UINT32_MAX) {
+        Log("[WARN] %s: no H.264 encode queue, --record ignored\n", tag);
+        return UINT32_MAX;
+    }
+
+    SetupProfile();
+    s_recH264Caps = {};
+    s_recH264Caps.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_CAPABILITIES_KHR;
+    s_recEncodeCaps = {};
+    s_recEncodeCaps.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_CAPABILITIES_KHR;
+    s_recEncodeCaps.pNext = &s_recH264Caps;
+    s_recCaps = {};
+    s_recCaps.sType = VK_STRUCTURE_TYPE_VIDEO_CAPABILITIES_KHR;
+    s_recCaps.pNext = &s_recEncodeCaps;
+    VkResult result = pvkGetPhysicalDeviceVideoCapabilitiesKHR(physicalDevice, &s_recProfile, &s_recCaps);
+    if (result != VK_SUCCESS) {
+        Log("[WARN] %s: H.264 Main 4:2:0 encode unsupported (%d), --record ignored\n", tag, result);
+        return UINT32_MAX;
+    }
+    const VkVideoEncodeFeedbackFlagsKHR feedback = VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BUFFER_OFFSET_BIT_KHR |
+                                                   VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BYTES_WRITTEN_BIT_KHR;
+    if ((s_recEncodeCaps.supportedEncodeFeedbackFlags & feedback) != feedback ||
+        s_recCaps.maxDpbSlots < 2 || s_recCaps.maxActiveReferencePictures < 1 ||
+        s_recH264Caps.maxPPictureL0ReferenceCount < 1) {
+        Log("[WARN] %s: encoder lacks bitstream feedback or P-frame references, --record ignored\n", tag);
+        return UINT32_MAX;
+    }
+
+    // The converter writes NV12; the DPB takes whatever the encoder wants
+    if (RecordFormat(VK_IMAGE_USAGE_VIDEO_ENCODE_SRC_BIT_KHR | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                     VK_FORMAT_G8_B8R8_2PLANE_420_UNORM) == VK_FORMAT_UNDEFINED) {
+        Log("[WARN] %s: encoder doesn't take NV12 transfer targets as input, --record ignored\n", tag);
+        return UINT32_MAX;
+    }
+    s_recDpbFormat = RecordFormat(VK_IMAGE_USAGE_VIDEO_ENCODE_DPB_BIT_KHR, VK_FORMAT_UNDEFINED);
+    if (s_recDpbFormat == VK_FORMAT_UNDEFINED) {
+        Log("[WARN] %s: no DPB format for H.264 encode, --record ignored\n", tag);
+        return UINT32_MAX;
+    }
+
+    for (const char* name : required) extensions.push_back(name);
+    s_recSync2Features = {};
+    s_recSync2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+    s_recSync2Features.synchronization2 = VK_TRUE;
+    s_recSync2Features.pNext = *pNextChain;
+    *pNextChain = &s_recSync2Features;
+    s_recEncodeFamily = family;
+    Log("[INFO] %s: H.264 encode on queue family %u (max %ux%u, %u DPB slots)\n", tag, family,
+        s_recCaps.maxCodedExtent.width, s_recCaps.maxCodedExtent.height, s_recCaps.maxDpbSlots);
+    return family;
+}
+
+bool VkRecordInit(VkDevice device, uint32_t graphicsFamily) {
+    s_recDevice = device;
+    s_recGraphicsFamily = graphicsFamily;
+    s_recFailed = false;
+
+    #define LOAD_VIDEO_FN(name) p##name = (PFN_##name)vkGetDeviceProcAddr(device, #name); if (!p##name) ok = false;
+    bool ok = true;
+    LOAD_VIDEO_FN(vkCreateVideoSessionKHR)
+    LOAD_VIDEO_FN(vkDestroyVideoSessionKHR)
+    LOAD_VIDEO_FN(vkGetVideoSessionMemoryRequirementsKHR)
+    LOAD_VIDEO_FN(vkBindVideoSessionMemoryKHR)
+    LOAD_VIDEO_FN(vkCreateVideoSessionParametersKHR)
+    LOAD_VIDEO_FN(vkDestroyVideoSessionParametersKHR)
+    LOAD_VIDEO_FN(vkGetEncodedVideoSessionParametersKHR)
+    LOAD_VIDEO_FN(vkCmdBeginVideoCodingKHR)
+    LOAD_VIDEO_FN(vkCmdEndVideoCodingKHR)
+    LOAD_VIDEO_FN(vkCmdControlVideoCodingKHR)
+    LOAD_VIDEO_FN(vkCmdEncodeVideoKHR)
+    #undef LOAD_VIDEO_FN
+    if (!ok) {
+        Log("[ERROR] Record: video encode entry points not found, --record disabled\n");
+        s_recFailed = true;
+        return false;
+    }
+
+    vkGetDeviceQueue(device, s_recEncodeFamily, 0, &s_recEncodeQueue);
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = s_recEncodeFamily;
+    VkCommandBuffer cmds[VK_RECORD_SLOTS] = {};
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = VK_RECORD_SLOTS;
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    ok = vkCreateCommandPool(device, &poolInfo, nullptr, &s_recEncodePool) == VK_SUCCESS;
+    allocInfo.commandPool = s_recEncodePool;
+    ok = ok && vkAllocateCommandBuffers(device, &allocInfo, cmds) == VK_SUCCESS;
+    for (uint32_t i = 0; i < VK_RECORD_SLOTS && ok; i++) {
+        RecordSlot& slot = s_recSlots[i];
+        slot.state = RECORD_FREE;
+        slot.encodeCmd = cmds[i];
+        ok = vkCreateSemaphore(device, &semaphoreInfo, nullptr, &slot.ready) == VK_SUCCESS &&
+             vkCreateFence(device, &fenceInfo, nullptr, &slot.done) == VK_SUCCESS;
+    }
+    if (!ok) {
+        Log("[ERROR] Record: encode queue objects failed, --record disabled\n");
+        s_recFailed = true;
+        return false;
+    }
+    return true;
+}
+
+// ============== WRITER THREAD ==============
+// BT.709 limited range in 8.8 fixed point: Y = 16 + 219/255 (0.2126 R + 0.7152 G
+// + 0.0722 B), Cb / Cr = 128 + 224/255 (B - Y') / 1.8556 and (R - Y') / 1.5748
+#define REC_Y(r, g, b)  ((46 * (r) + 157 * (g) + 16 * (b) + 128) >> 8)
+#define REC_CB(r, g, b) ((-26 * (r) - 87 * (g) + 113 * (b)))
+#define REC_CR(r, g, b) ((113 * (r) - 103 * (g) - 10 * (b)))
+
+// Source (s_recExtent, edge pixels repeated out to the coded size) -> NV12
+static void ConvertSlot(int index) {
+    RecordSlot& slot = s_recSlots[index];
+    const BYTE* src = (const BYTE*)slot.readbackMemory.mapped;
+    BYTE* lumaPlane = (BYTE*)slot.nv12Memory.mapped;
+    BYTE* chromaPlane = lumaPlane + (size_t)s_recCodedExtent.width * s_recCodedExtent.height;
+    const uint32_t w = s_recExtent.width, h = s_recExtent.height;
+    const int ri = slot.bgra ? 2 : 0, bi = slot.bgra ? 0 : 2;
+
+    for (uint32_t y = 0; y < s_recCodedExtent.height; y += 2) {
+        const BYTE* rows[2] = { src + (size_t)min(y, h - 1) * w * 4, src + (size_t)min(y + 1, h - 1) * w * 4 };
+        BYTE* luma[2] = { lumaPlane + (size_t)y * s_recCodedExtent.width, lumaPlane + (size_t)(y + 1) * s_recCodedExtent.width };
+        BYTE* chroma = chromaPlane + (size_t)(y / 2) * s_recCodedExtent.width;
+        for (uint32_t x = 0; x < s_recCodedExtent.width; x += 2) {
+            int sr = 0, sg = 0, sb = 0;     // 2x2 sums for the chroma sample
+            for (int r = 0; r < 2; r++) {
+                for (uint32_t dx = 0; dx < 2; dx++) {
+                    const BYTE* px = rows[r] + (size_t)min(x + dx, w - 1) * 4;
+                    int cr = px[ri], cg = px[1], cb = px[bi];
+                    luma[r][x + dx] = (BYTE)(16 + REC_Y(cr, cg, cb));
+                    sr += cr; sg += cg; sb += cb;
+                }
+            }
+            chroma[x] = (BYTE)(128 + ((REC_CB(sr, sg, sb) + 512) >> 10));
+            chroma[x + 1] = (BYTE)(128 + ((REC_CR(sr, sg, sb) + 512) >> 10));
+        }
+    }
+    InterlockedExchange(&slot.state, RECORD_CONVERTED);
+}
+
+static void WriteSlot(int index) {
+    RecordSlot& slot = s_recSlots[index];
+    vkWaitForFences(s_recDevice, 1, &slot.done, VK_TRUE, UINT64_MAX);
+
+    uint32_t feedback[2] = {};      // Bitstream offset, bytes written
+    VkResult result = vkGetQueryPoolResults(s_recDevice, s_recQueryPool, index, 1, sizeof(feedback), feedback,
+                                            sizeof(feedback), 0);
+    if (result == VK_SUCCESS && feedback[1] && feedback[0] + (VkDeviceSize)feedback[1] <= s_recBitstreamSize) {
+        if (slot.idr && !s_recHeader.empty()) fwrite(s_recHeader.data(), 1, s_recHeader.size(), s_recFile);
+        fwrite((const BYTE*)slot.bitstreamMemory.mapped + feedback[0], 1, feedback[1], s_recFile);
+        InterlockedExchangeAdd64(&s_recBytes, feedback[1] + (slot.idr ? (LONGLONG)s_recHeader.size() : 0));
+        InterlockedIncrement(&s_recFrames);
+    } else {
+        InterlockedIncrement(&s_recDropped);
+    }
+    InterlockedExchange(&slot.state, RECORD_FREE);
+}
+
+static DWORD WINAPI RecordWriterProc(LPVOID) {
+    for (;;) {
+        WaitForSingleObject(s_recWriterWake, INFINITE);
+        while (s_recQueueTail != s_recQueueHead) {
+            int index = s_recQueue[s_recQueueTail & (VK_RECORD_QUEUE_SIZE - 1)];
+            if (s_recSlots[index].state == RECORD_CONVERTING) ConvertSlot(index);
+            else WriteSlot(index);
+            InterlockedIncrement(&s_recQueueTail);
+        }
+    }
+}
+
+// Render thread; a slot is in the queue at most once, so it never fills
+static void EnqueueSlot(int index, LONG state) {
+    InterlockedExchange(&s_recSlots[index].state, state);
+    s_recQueue[s_recQueueHead & (VK_RECORD_QUEUE_SIZE - 1)] = index;
+    InterlockedIncrement(&s_recQueueHead);
+    SetEvent(s_recWriterWake);
+}
+
+// Started with the first session; lives until the process exits
+static bool StartWriter() {
+    if (s_recWriterThread) return true;
+    s_recWriterWake = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    s_recWriterThread = s_recWriterWake ? CreateThread(nullptr, 0, RecordWriterProc, nullptr, 0, nullptr) : nullptr;
+    if (!s_recWriterThread) {
+        Log("[ERROR] Record: writer thread failed (error %lu)\n", GetLastError());
+        if (s_recWriterWake) { CloseHandle(s_recWriterWake); s_recWriterWake = nullptr; }
+        return false;
+    }
+    SetThreadPriority(s_recWriterThread, THREAD_PRIORITY_BELOW_NORMAL);
+    return true;
+}
+
+// ============== SESSION ==============
+static bool CreateVideoSession() {
+    VkVideoSessionCreateInfoKHR sessionInfo = {};
+    sessionInfo.sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_CREATE_INFO_KHR;
+    sessionInfo.queueFamilyIndex = s_recEncodeFamily;
+    sessionInfo.pVideoProfile = &s_recProfile;
+    sessionInfo.pictureFormat = VK_FORMAT_G8_B8R8_2PLANE_420_UNORM;
+    sessionInfo.maxCodedExtent = s_recCodedExtent;
+    sessionInfo.referencePictureFormat = s_recDpbFormat;
+    sessionInfo.maxDpbSlots = 2;
+    sessionInfo.maxActiveReferencePictures = 1;
+    sessionInfo.pStdHeaderVersion = &s_recCaps.stdHeaderVersion;
+    if (pvkCreateVideoSessionKHR(s_recDevice, &sessionInfo, nullptr, &s_recSession) != VK_SUCCESS) {
+        Log("[ERROR] Record: vkCreateVideoSessionKHR failed\n");
+        return false;
+    }
+
+    uint32_t count = 0;
+    pvkGetVideoSessionMemoryRequirementsKHR(s_recDevice, s_recSession, &count, nullptr);
+    std::vector<VkVideoSessionMemoryRequirementsKHR> reqs(count);
+    for (auto& r : reqs) { r = {}; r.sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_MEMORY_REQUIREMENTS_KHR; }
+    pvkGetVideoSessionMemoryRequirementsKHR(s_recDevice, s_recSession, &count, reqs.data());
+    std::vector<VkBindVideoSessionMemoryInfoKHR> binds(count);
+    for (uint32_t i = 0; i < count; i++) {
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = reqs[i].memoryRequirements.size;
+        allocInfo.memoryTypeIndex = RecordMemoryType(reqs[i].memoryRequirements.memoryTypeBits,
+                                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        if (allocInfo.memoryTypeIndex == UINT32_MAX ||
+            vkAllocateMemory(s_recDevice, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+            Log("[ERROR] Record: video session memory (%llu bytes) failed\n", allocInfo.allocationSize);
+            return false;
+        }
+        s_recSessionMemory.push_back(memory);
+        binds[i] = {};
+        binds[i].sType = VK_STRUCTURE_TYPE_BIND_VIDEO_SESSION_MEMORY_INFO_KHR;
+        binds[i].memoryBindIndex = reqs[i].memoryBindIndex;
+        binds[i].memory = memory;
+        binds[i].memorySize = allocInfo.allocationSize;
+    }
+    if (count && pvkBindVideoSessionMemoryKHR(s_recDevice, s_recSession, count, binds.data()) != VK_SUCCESS) {
+        Log("[ERROR] Record: vkBindVideoSessionMemoryKHR failed\n");
+        return false;
+    }
+    return true;
+}
+
+// SPS/PPS for the current extent, and their encoded form for the file
+static bool CreateSessionParameters() {
+    uint32_t visibleW = s_recExtent.width & ~1u, visibleH = s_recExtent.height & ~1u;
+
+    StdVideoH264SequenceParameterSetVui vui = {};
+    vui.flags.video_signal_type_present_flag = 1;
+    vui.flags.color_description_present_flag = 1;
+    vui.flags.timing_info_present_flag = 1;
+    vui.flags.fixed_frame_rate_flag = 1;
+    vui.flags.bitstream_restriction_flag = 1;
+    vui.aspect_ratio_idc = STD_VIDEO_H264_ASPECT_RATIO_IDC_UNSPECIFIED;
+    vui.video_format = 5;           // Unspecified
+    vui.colour_primaries = 1;       // BT.709, limited range (as converted)
+    vui.transfer_characteristics = 1;
+    vui.matrix_coefficients = 1;
+    vui.num_units_in_tick = 1;
+    vui.time_scale = 2 * VK_RECORD_FPS;
+    vui.max_num_reorder_frames = 0; // Decoders may output every picture right away
+    vui.max_dec_frame_buffering = 1;
+
+    StdVideoH264SequenceParameterSet sps = {};
+    sps.flags.direct_8x8_inference_flag = 1;
+    sps.flags.frame_mbs_only_flag = 1;
+    sps.flags.frame_cropping_flag = visibleW != s_recCodedExtent.width || visibleH != s_recCodedExtent.height;
+    sps.flags.vui_parameters_present_flag = 1;
+    sps.profile_idc = STD_VIDEO_H264_PROFILE_IDC_MAIN;
+    sps.level_idc = s_recH264Caps.maxLevelIdc;
+    sps.chroma_format_idc = STD_VIDEO_H264_CHROMA_FORMAT_IDC_420;
+    sps.log2_max_frame_num_minus4 = 4;              // frame_num < 256 > VK_RECORD_GOP
+    sps.pic_order_cnt_type = STD_VIDEO_H264_POC_TYPE_0;
+    sps.log2_max_pic_order_cnt_lsb_minus4 = 5;      // POC = 2 * frame < 512
+    sps.max_num_ref_frames = 1;
+    sps.pic_width_in_mbs_minus1 = s_recCodedExtent.width / VK_RECORD_MB - 1;
+    sps.pic_height_in_map_units_minus1 = s_recCodedExtent.height / VK_RECORD_MB - 1;
+    sps.frame_crop_right_offset = (s_recCodedExtent.width - visibleW) / 2;     // 4:2:0 crop units
+    sps.frame_crop_bottom_offset = (s_recCodedExtent.height - visibleH) / 2;
+    sps.pSequenceParameterSetVui = &vui;
+
+    StdVideoH264PictureParameterSet pps = {};
+    pps.flags.entropy_coding_mode_flag =
+        (s_recH264Caps.stdSyntaxFlags & VK_VIDEO_ENCODE_H264_STD_ENTROPY_CODING_MODE_FLAG_SET_BIT_KHR) ? 1 : 0;
+    pps.flags.deblocking_filter_control_present_flag = 1;
+    pps.weighted_bipred_idc = STD_VIDEO_H264_WEIGHTED_BIPRED_IDC_DEFAULT;
+
+    VkVideoEncodeH264SessionParametersAddInfoKHR addInfo = {};
+    addInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_SESSION_PARAMETERS_ADD_INFO_KHR;
+    addInfo.stdSPSCount = 1;
+    addInfo.pStdSPSs = &sps;
+    addInfo.stdPPSCount = 1;
+    addInfo.pStdPPSs = &pps;
+    VkVideoEncodeH264SessionParametersCreateInfoKHR h264Info = {};
+    h264Info.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_SESSION_PARAMETERS_CREATE_INFO_KHR;
+    h264Info.maxStdSPSCount = 1;
+    h264Info.maxStdPPSCount = 1;
+    h264Info.pParametersAddInfo = &addInfo;
+    VkVideoSessionParametersCreateInfoKHR paramsInfo = {};
+    paramsInfo.sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_PARAMETERS_CREATE_INFO_KHR;
+    paramsInfo.pNext = &h264Info;
+    paramsInfo.videoSession = s_recSession;
+    if (pvkCreateVideoSessionParametersKHR(s_recDevice, &paramsInfo, nullptr, &s_recParams) != VK_SUCCESS) {
+        Log("[ERROR] Record: vkCreateVideoSessionParametersKHR failed\n");
+        return false;
+    }
+
+    VkVideoEncodeH264SessionParametersGetInfoKHR h264Get = {};
+    h264Get.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_SESSION_PARAMETERS_GET_INFO_KHR;
+    h264Get.writeStdSPS = VK_TRUE;
+    h264Get.writeStdPPS = VK_TRUE;
+    VkVideoEncodeSessionParametersGetInfoKHR getInfo = {};
+    getInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_SESSION_PARAMETERS_GET_INFO_KHR;
+    getInfo.pNext = &h264Get;
+    getInfo.videoSessionParameters = s_recParams;
+    size_t size = 0;
+    if (pvkGetEncodedVideoSessionParametersKHR(s_recDevice, &getInfo, nullptr, &size, nullptr) != VK_SUCCESS || !size) {
+        Log("[ERROR] Record: vkGetEncodedVideoSessionParametersKHR failed\n");
+        return false;
+    }
+    s_recHeader.resize(size);
+    if (pvkGetEncodedVideoSessionParametersKHR(s_recDevice, &getInfo, nullptr, &size, s_recHeader.data()) != VK_SUCCESS) {
+        Log("[ERROR] Record: vkGetEncodedVideoSessionParametersKHR failed\n");
+        return false;
+    }
+    s_recHeader.resize(size);
+    return true;
+}
+
+// VBR around --record-mbps when the encoder has it, else CBR, else its default
+static void SetupRateControl() {
+    VkVideoEncodeRateControlModeFlagsKHR modes = s_recEncodeCaps.rateControlModes;
+    s_recRcMode = (modes & VK_VIDEO_ENCODE_RATE_CONTROL_MODE_VBR_BIT_KHR) ? VK_VIDEO_ENCODE_RATE_CONTROL_MODE_VBR_BIT_KHR :
+                  (modes & VK_VIDEO_ENCODE_RATE_CONTROL_MODE_CBR_BIT_KHR) ? VK_VIDEO_ENCODE_RATE_CONTROL_MODE_CBR_BIT_KHR :
+                  VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DEFAULT_KHR;
+    uint64_t bitrate = (uint64_t)g_recordMbps * 1000000;
+    if (s_recEncodeCaps.maxBitrate) bitrate = min(bitrate, s_recEncodeCaps.maxBitrate);
+
+    s_recRcLayer = {};
+    s_recRcLayer.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_RATE_CONTROL_LAYER_INFO_KHR;
+    s_recRcLayer.averageBitrate = bitrate;
+    s_recRcLayer.maxBitrate = s_recRcMode == VK_VIDEO_ENCODE_RATE_CONTROL_MODE_VBR_BIT_KHR ? bitrate * 2 : bitrate;
+    if (s_recEncodeCaps.maxBitrate) s_recRcLayer.maxBitrate = min(s_recRcLayer.maxBitrate, s_recEncodeCaps.maxBitrate);
+    s_recRcLayer.frameRateNumerator = VK_RECORD_FPS;
+    s_recRcLayer.frameRateDenominator = 1;
+
+    s_recH264Rc = {};
+    s_recH264Rc.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_RATE_CONTROL_INFO_KHR;
+    s_recH264Rc.gopFrameCount = VK_RECORD_GOP;
+    s_recH264Rc.idrPeriod = VK_RECORD_GOP;
+    s_recH264Rc.consecutiveBFrameCount = 0;
+    s_recH264Rc.temporalLayerCount = 1;
+
+    s_recRc = {};
+    s_recRc.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_RATE_CONTROL_INFO_KHR;
+    s_recRc.pNext = &s_recH264Rc;
+    s_recRc.rateControlMode = s_recRcMode;
+    s_recRc.layerCount = 1;
+    s_recRc.pLayers = &s_recRcLayer;
+    s_recRc.virtualBufferSizeInMs = 1000;
+    s_recRc.initialVirtualBufferSizeInMs = 500;
+}
+
+static bool CreateImages() {
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.pNext = &s_recProfileList;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = { s_recCodedExtent.width, s_recCodedExtent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+
+    // DPB: one layer per slot, encode queue only
+    imageInfo.format = s_recDpbFormat;
+    imageInfo.arrayLayers = 2;
+    imageInfo.usage = VK_IMAGE_USAGE_VIDEO_ENCODE_DPB_BIT_KHR;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateImage(s_recDevice, &imageInfo, nullptr, &s_recDpbImage) != VK_SUCCESS ||
+        !VkMemAllocImage(s_recDpbImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s_recDpbMemory)) return false;
+    viewInfo.image = s_recDpbImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = s_recDpbFormat;
+    viewInfo.subresourceRange.layerCount = 2;
+    if (vkCreateImageView(s_recDevice, &viewInfo, nullptr, &s_recDpbView) != VK_SUCCESS) return false;
+
+    // Encode input: written by graphics-queue uploads, read by the encoder
+    uint32_t families[2] = { s_recGraphicsFamily, s_recEncodeFamily };
+    imageInfo.format = VK_FORMAT_G8_B8R8_2PLANE_420_UNORM;
+    imageInfo.arrayLayers = 1;
+    imageInfo.usage = VK_IMAGE_USAGE_VIDEO_ENCODE_SRC_BIT_KHR | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    if (s_recGraphicsFamily != s_recEncodeFamily) {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = 2;
+        imageInfo.pQueueFamilyIndices = families;
+    }
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_G8_B8R8_2PLANE_420_UNORM;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkDeviceSize nv12Size = (VkDeviceSize)s_recCodedExtent.width * s_recCodedExtent.height * 3 / 2;
+
+    for (uint32_t i = 0; i < VK_RECORD_SLOTS; i++) {
+        RecordSlot& slot = s_recSlots[i];
+        if (vkCreateImage(s_recDevice, &imageInfo, nullptr, &slot.image) != VK_SUCCESS ||
+            !VkMemAllocImage(slot.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, slot.imageMemory)) return false;
+        viewInfo.image = slot.image;
+        if (vkCreateImageView(s_recDevice, &viewInfo, nullptr, &slot.view) != VK_SUCCESS) return false;
+
+        bufferInfo.pNext = nullptr;
+        bufferInfo.size = (VkDeviceSize)s_recExtent.width * s_recExtent.height * 4;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        if (vkCreateBuffer(s_recDevice, &bufferInfo, nullptr, &slot.readback) != VK_SUCCESS ||
+            !VkMemAllocBuffer(slot.readback, RecordReadbackFlags(slot.readback), slot.readbackMemory) ||
+            !slot.readbackMemory.mapped) return false;
+
+        bufferInfo.size = nv12Size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        if (vkCreateBuffer(s_recDevice, &bufferInfo, nullptr, &slot.nv12Buffer) != VK_SUCCESS ||
+            !VkMemAllocBuffer(slot.nv12Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                              slot.nv12Memory) ||
+            !slot.nv12Memory.mapped) return false;
+
+        bufferInfo.pNext = &s_recProfileList;
+        bufferInfo.size = s_recBitstreamSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_VIDEO_ENCODE_DST_BIT_KHR;
+        if (vkCreateBuffer(s_recDevice, &bufferInfo, nullptr, &slot.bitstream) != VK_SUCCESS ||
+            !VkMemAllocBuffer(slot.bitstream, RecordReadbackFlags(slot.bitstream), slot.bitstreamMemory) ||
+            !slot.bitstreamMemory.mapped) return false;
+    }
+    return true;
+}
+
+static bool CreateSession(VkExtent2D extent) {
+    s_recExtent = extent;
+    uint32_t alignW = max((uint32_t)VK_RECORD_MB, s_recCaps.pictureAccessGranularity.width);
+    uint32_t alignH = max((uint32_t)VK_RECORD_MB, s_recCaps.pictureAccessGranularity.height);
+    s_recCodedExtent.width = max(AlignUp32(extent.width & ~1u, alignW), s_recCaps.minCodedExtent.width);
+    s_recCodedExtent.height = max(AlignUp32(extent.height & ~1u, alignH), s_recCaps.minCodedExtent.height);
+    if (s_recCodedExtent.width > s_recCaps.maxCodedExtent.width || s_recCodedExtent.height > s_recCaps.maxCodedExtent.height) {
+        Log("[WARN] Record: %ux%u exceeds the encoder's %ux%u, --record disabled\n", extent.width, extent.height,
+            s_recCaps.maxCodedExtent.width, s_recCaps.maxCodedExtent.height);
+        return false;
+    }
+    // Raw NV12 size: more than any intra picture at a sane bitrate needs
+    VkDeviceSize align = max(s_recCaps.minBitstreamBufferSizeAlignment, (VkDeviceSize)1);
+    s_recBitstreamSize = ((VkDeviceSize)s_recCodedExtent.width * s_recCodedExtent.height * 3 / 2 + align - 1) / align * align;
+
+    VkQueryPoolVideoEncodeFeedbackCreateInfoKHR feedbackInfo = {};
+    feedbackInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_VIDEO_ENCODE_FEEDBACK_CREATE_INFO_KHR;
+    feedbackInfo.pNext = &s_recProfile;
+    feedbackInfo.encodeFeedbackFlags = VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BUFFER_OFFSET_BIT_KHR |
+                                       VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BYTES_WRITTEN_BIT_KHR;
+    VkQueryPoolCreateInfo queryInfo = {};
+    queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryInfo.pNext = &feedbackInfo;
+    queryInfo.queryType = VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR;
+    queryInfo.queryCount = VK_RECORD_SLOTS;
+
+    SetupRateControl();
+    if (!CreateVideoSession() || !CreateSessionParameters()) return false;
+    if (!CreateImages()) {
+        Log("[ERROR] Record: encode images or buffers failed\n");
+        return false;
+    }
+    if (vkCreateQueryPool(s_recDevice, &queryInfo, nullptr, &s_recQueryPool) != VK_SUCCESS) {
+        Log("[ERROR] Record: encode feedback query pool failed\n");
+        return false;
+    }
+    if (!StartWriter()) return false;
+
+    if (!s_recFile) fopen_s(&s_recFile, g_recordPath, s_recFileStarted ? "ab" : "wb");
+    if (!s_recFile) {
+        Log("[ERROR] Record: cannot open %s\n", g_recordPath);
+        return false;
+    }
+    s_recFileStarted = true;
+
+    s_recNeedsReset = true;
+    s_recGopFrame = 0;
+    s_recDpbLast = -1;
+    s_recReadbackSeq = s_recUploadSeq = 0;
+    Log("[INFO] Record: %ux%u H.264 Main (%s, %u Mbps, %s), %u fps to %s\n", s_recExtent.width & ~1u, s_recExtent.height & ~1u,
+        s_recRcMode == VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DEFAULT_KHR ? "default rate" : RateControlName(s_recRcMode),
+        (UINT)(s_recRcLayer.averageBitrate / 1000000), (s_recH264Caps.stdSyntaxFlags &
+        VK_VIDEO_ENCODE_H264_STD_ENTROPY_CODING_MODE_FLAG_SET_BIT_KHR) ? "CABAC" : "CAVLC", VK_RECORD_FPS, g_recordPath);
+    return true;
+}
+
+static void DestroySession() {
+    // Wait for the writer (the GPU is idle, so every fence has passed); slots
+    // read back but not yet encoded are dropped
+    for (int i = 0; i < VK_RECORD_SLOTS; i++)
+        while (s_recSlots[i].state == RECORD_ENCODING || s_recSlots[i].state == RECORD_CONVERTING) Sleep(1);
+    s_recPendingSlot = -1;
+    if (s_recFile) { fclose(s_recFile); s_recFile = nullptr; }
+
+    for (uint32_t i = 0; i < VK_RECORD_SLOTS; i++) {
+        RecordSlot& slot = s_recSlots[i];
+        slot.state = RECORD_FREE;
+        if (slot.view) { vkDestroyImageView(s_recDevice, slot.view, nullptr); slot.view = VK_NULL_HANDLE; }
+        if (slot.image) { vkDestroyImage(s_recDevice, slot.image, nullptr); slot.image = VK_NULL_HANDLE; }
+        VkMemFree(slot.imageMemory);
+        if (slot.readback) { vkDestroyBuffer(s_recDevice, slot.readback, nullptr); slot.readback = VK_NULL_HANDLE; }
+        VkMemFree(slot.readbackMemory);
+        if (slot.nv12Buffer) { vkDestroyBuffer(s_recDevice, slot.nv12Buffer, nullptr); slot.nv12Buffer = VK_NULL_HANDLE; }
+        VkMemFree(slot.nv12Memory);
+        if (slot.bitstream) { vkDestroyBuffer(s_recDevice, slot.bitstream, nullptr); slot.bitstream = VK_NULL_HANDLE; }
+        VkMemFree(slot.bitstreamMemory);
+    }
+    if (s_recQueryPool) { vkDestroyQueryPool(s_recDevice, s_recQueryPool, nullptr); s_recQueryPool = VK_NULL_HANDLE; }
+    if (s_recDpbView) { vkDestroyImageView(s_recDevice, s_recDpbView, nullptr); s_recDpbView = VK_NULL_HANDLE; }
+    if (s_recDpbImage) { vkDestroyImage(s_recDevice, s_recDpbImage, nullptr); s_recDpbImage = VK_NULL_HANDLE; }
+    VkMemFree(s_recDpbMemory);
+    if (s_recParams) { pvkDestroyVideoSessionParametersKHR(s_recDevice, s_recParams, nullptr); s_recParams = VK_NULL_HANDLE; }
+    if (s_recSession) { pvkDestroyVideoSessionKHR(s_recDevice, s_recSession, nullptr); s_recSession = VK_NULL_HANDLE; }
+    for (VkDeviceMemory memory : s_recSessionMemory) vkFreeMemory(s_recDevice, memory, nullptr);
+    s_recSessionMemory.clear();
+    s_recHeader.clear();
+    s_recExtent = {};
+}
+
+// ============== PER FRAME ==============
+// Source image (GENERAL, written at srcStage) -> the slot's readback buffer
+static void RecordReadback(VkCommandBuffer cmd, RecordSlot& slot, VkImage srcImage, VkPipelineStageFlags srcStage) {
+    VkMemoryBarrier before = {};
+    before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    before.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    before.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, srcStage | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         1, &before, 0, nullptr, 0, nullptr);
+
+    VkBufferImageCopy region = {};
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageExtent = { s_recExtent.width, s_recExtent.height, 1 };
+    vkCmdCopyImageToBuffer(cmd, srcImage, VK_IMAGE_LAYOUT_GENERAL, slot.readback, 1, &region);
+
+    // Host read after the fence; ALL_COMMANDS also keeps later writes to the
+    // source image (overlay, layout transitions, next frame) behind the copy
+    VkMemoryBarrier after = {};
+    after.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    after.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    after.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 1, &after, 0, nullptr, 0, nullptr);
+}
+
+// Converted NV12 (host writes, made visible by the submission) -> encode input image
+static void RecordUpload(VkCommandBuffer cmd, RecordSlot& slot) {
+    VkImageMemoryBarrier imageBarrier = {};
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = slot.image;
+    imageBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+    VkBufferImageCopy planes[2] = {};
+    planes[0].bufferRowLength = s_recCodedExtent.width;
+    planes[0].bufferImageHeight = s_recCodedExtent.height;
+    planes[0].imageSubresource = { VK_IMAGE_ASPECT_PLANE_0_BIT, 0, 0, 1 };
+    planes[0].imageExtent = { s_recCodedExtent.width, s_recCodedExtent.height, 1 };
+    planes[1].bufferOffset = (VkDeviceSize)s_recCodedExtent.width * s_recCodedExtent.height;
+    planes[1].bufferRowLength = s_recCodedExtent.width / 2;
+    planes[1].bufferImageHeight = s_recCodedExtent.height / 2;
+    planes[1].imageSubresource = { VK_IMAGE_ASPECT_PLANE_1_BIT, 0, 0, 1 };
+    planes[1].imageExtent = { s_recCodedExtent.width / 2, s_recCodedExtent.height / 2, 1 };
+    vkCmdCopyBufferToImage(cmd, slot.nv12Buffer, slot.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 2, planes);
+
+    // The slot semaphore makes the copy visible to the encode queue
+    imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imageBarrier.newLayout = VK_IMAGE_LAYOUT_VIDEO_ENCODE_SRC_KHR;
+    imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    imageBarrier.dstAccessMask = 0;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &imageBarrier);
+}
+
+static bool RecordEncode(int index) {
+    RecordSlot& slot = s_recSlots[index];
+    VkCommandBuffer ec = slot.encodeCmd;
+    vkResetCommandBuffer(ec, 0);
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(ec, &beginInfo) != VK_SUCCESS) return false;
+
+    vkCmdResetQueryPool(ec, s_recQueryPool, index, 1);
+
+    // Earlier encodes' reconstructed pictures before this one reads / overwrites them
+    VkImageMemoryBarrier dpbBarrier = {};
+    dpbBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    dpbBarrier.oldLayout = s_recNeedsReset ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_VIDEO_ENCODE_DPB_KHR;
+    dpbBarrier.newLayout = VK_IMAGE_LAYOUT_VIDEO_ENCODE_DPB_KHR;
+    dpbBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    dpbBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    dpbBarrier.image = s_recDpbImage;
+    dpbBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 2 };
+    dpbBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    dpbBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    vkCmdPipelineBarrier(ec, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &dpbBarrier);
+
+    bool idr = s_recGopFrame == 0 || s_recDpbLast < 0;
+    if (idr) s_recGopFrame = 0;
+    int setup = s_recDpbLast < 0 ? 0 : 1 - s_recDpbLast;
+    int ref = s_recDpbLast;
+
+    StdVideoEncodeH264ReferenceInfo& setupInfo = s_recDpbInfo[setup];
+    setupInfo = {};
+    setupInfo.primary_pic_type = idr ? STD_VIDEO_H264_PICTURE_TYPE_IDR : STD_VIDEO_H264_PICTURE_TYPE_P;
+    setupInfo.FrameNum = s_recGopFrame;
+    setupInfo.PicOrderCnt = (int32_t)s_recGopFrame * 2;
+
+    VkVideoPictureResourceInfoKHR dpbPictures[2] = {};
+    for (int i = 0; i < 2; i++) {
+        dpbPictures[i].sType = VK_STRUCTURE_TYPE_VIDEO_PICTURE_RESOURCE_INFO_KHR;
+        dpbPictures[i].codedExtent = s_recCodedExtent;
+        dpbPictures[i].baseArrayLayer = i;
+        dpbPictures[i].imageViewBinding = s_recDpbView;
+    }
+    VkVideoEncodeH264DpbSlotInfoKHR setupDpb = {};
+    setupDpb.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_DPB_SLOT_INFO_KHR;
+    setupDpb.pStdReferenceInfo = &setupInfo;
+    VkVideoReferenceSlotInfoKHR setupSlot = {};
+    setupSlot.sType = VK_STRUCTURE_TYPE_VIDEO_REFERENCE_SLOT_INFO_KHR;
+    setupSlot.pNext = &setupDpb;
+    setupSlot.slotIndex = setup;
+    setupSlot.pPictureResource = &dpbPictures[setup];
+
+    VkVideoEncodeH264DpbSlotInfoKHR refDpb = {};
+    refDpb.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_DPB_SLOT_INFO_KHR;
+    refDpb.pStdReferenceInfo = ref >= 0 ? &s_recDpbInfo[ref] : nullptr;
+    VkVideoReferenceSlotInfoKHR refSlot = {};
+    refSlot.sType = VK_STRUCTURE_TYPE_VIDEO_REFERENCE_SLOT_INFO_KHR;
+    refSlot.pNext = &refDpb;
+    refSlot.slotIndex = ref;
+    refSlot.pPictureResource = ref >= 0 ? &dpbPictures[ref] : nullptr;
+
+    // Bound for this scope: the reconstructed picture (activated by the encode) and the reference
+    VkVideoReferenceSlotInfoKHR boundSlots[2] = { setupSlot, refSlot };
+    boundSlots[0].pNext = nullptr;
+    boundSlots[0].slotIndex = -1;
+    boundSlots[1].pNext = nullptr;
+    VkVideoBeginCodingInfoKHR codingInfo = {};
+    codingInfo.sType = VK_STRUCTURE_TYPE_VIDEO_BEGIN_CODING_INFO_KHR;
+    codingInfo.pNext = !s_recNeedsReset && s_recRcMode != VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DEFAULT_KHR ? &s_recRc : nullptr;
+    codingInfo.videoSession = s_recSession;
+    codingInfo.videoSessionParameters = s_recParams;
+    codingInfo.referenceSlotCount = idr ? 1 : 2;
+    codingInfo.pReferenceSlots = boundSlots;
+    pvkCmdBeginVideoCodingKHR(ec, &codingInfo);
+
+    if (s_recNeedsReset) {
+        VkVideoCodingControlInfoKHR control = {};
+        control.sType = VK_STRUCTURE_TYPE_VIDEO_CODING_CONTROL_INFO_KHR;
+        control.flags = VK_VIDEO_CODING_CONTROL_RESET_BIT_KHR;
+        if (s_recRcMode != VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DEFAULT_KHR) {
+            control.pNext = &s_recRc;
+            control.flags |= VK_VIDEO_CODING_CONTROL_ENCODE_RATE_CONTROL_BIT_KHR;
+        }
+        pvkCmdControlVideoCodingKHR(ec, &control);
+        s_recNeedsReset = false;
+    }
+
+    StdVideoEncodeH264SliceHeader sliceHeader = {};
+    sliceHeader.slice_type = idr ? STD_VIDEO_H264_SLICE_TYPE_I : STD_VIDEO_H264_SLICE_TYPE_P;
+    sliceHeader.cabac_init_idc = STD_VIDEO_H264_CABAC_INIT_IDC_0;
+    sliceHeader.disable_deblocking_filter_idc = STD_VIDEO_H264_DISABLE_DEBLOCKING_FILTER_IDC_DISABLED;  // idc 0 = deblocking on
+    VkVideoEncodeH264NaluSliceInfoKHR slice = {};
+    slice.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_NALU_SLICE_INFO_KHR;
+    slice.pStdSliceHeader = &sliceHeader;
+
+    StdVideoEncodeH264ReferenceListsInfo refLists = {};
+    memset(refLists.RefPicList0, STD_VIDEO_H264_NO_REFERENCE_PICTURE, sizeof(refLists.RefPicList0));
+    memset(refLists.RefPicList1, STD_VIDEO_H264_NO_REFERENCE_PICTURE, sizeof(refLists.RefPicList1));
+    if (!idr) refLists.RefPicList0[0] = (uint8_t)ref;
+
+    StdVideoEncodeH264PictureInfo stdPicture = {};
+    stdPicture.flags.IdrPicFlag = idr ? 1 : 0;
+    stdPicture.flags.is_reference = 1;
+    stdPicture.idr_pic_id = s_recIdrId;
+    stdPicture.primary_pic_type = setupInfo.primary_pic_type;
+    stdPicture.frame_num = s_recGopFrame;
+    stdPicture.PicOrderCnt = setupInfo.PicOrderCnt;
+    stdPicture.pRefLists = &refLists;
+    VkVideoEncodeH264PictureInfoKHR h264Picture = {};
+    h264Picture.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_PICTURE_INFO_KHR;
+    h264Picture.naluSliceEntryCount = 1;
+    h264Picture.pNaluSliceEntries = &slice;
+    h264Picture.pStdPictureInfo = &stdPicture;
+
+    VkVideoEncodeInfoKHR encodeInfo = {};
+    encodeInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_INFO_KHR;
+    encodeInfo.pNext = &h264Picture;
+    encodeInfo.dstBuffer = slot.bitstream;
+    encodeInfo.dstBufferRange = s_recBitstreamSize;
+    encodeInfo.srcPictureResource.sType = VK_STRUCTURE_TYPE_VIDEO_PICTURE_RESOURCE_INFO_KHR;
+    encodeInfo.srcPictureResource.codedExtent = s_recCodedExtent;
+    encodeInfo.srcPictureResource.imageViewBinding = slot.view;
+    encodeInfo.pSetupReferenceSlot = &setupSlot;
+    encodeInfo.referenceSlotCount = idr ? 0 : 1;
+    encodeInfo.pReferenceSlots = idr ? nullptr : &refSlot;
+
+    vkCmdBeginQuery(ec, s_recQueryPool, index, 0);
+    pvkCmdEncodeVideoKHR(ec, &encodeInfo);
+    vkCmdEndQuery(ec, s_recQueryPool, index);
+
+    VkVideoEndCodingInfoKHR endInfo = {};
+    endInfo.sType = VK_STRUCTURE_TYPE_VIDEO_END_CODING_INFO_KHR;
+    pvkCmdEndVideoCodingKHR(ec, &endInfo);
+    if (vkEndCommandBuffer(ec) != VK_SUCCESS) return false;
+
+    slot.idr = idr;
+    if (idr) s_recIdrId++;
+    s_recDpbLast = setup;
+    s_recGopFrame = (s_recGopFrame + 1) % VK_RECORD_GOP;
+    return true;
+}
+
+VkSemaphore VkRecordFrame(VkCommandBuffer cmd, VkImage srcImage, VkExtent2D extent, bool bgra,
+                          VkPipelineStageFlags srcStage, uint32_t frame) {
+    if (!s_recDevice || s_recFailed || s_recEncodeFamily == UINT32_MAX) return VK_NULL_HANDLE;
+
+    // Every frame: upload + encode the next slot in readback order once it's converted
+    VkSemaphore ready = VK_NULL_HANDLE;
+    for (int i = 0; i < VK_RECORD_SLOTS; i++) {
+        RecordSlot& slot = s_recSlots[i];
+        if (slot.state != RECORD_CONVERTED || slot.sequence != s_recUploadSeq) continue;
+        if (!RecordEncode(i)) {
+            Log("[ERROR] Record: encode command buffer failed, --record disabled\n");
+            s_recFailed = true;
+            return VK_NULL_HANDLE;
+        }
+        RecordUpload(cmd, slot);
+        slot.state = RECORD_PENDING;
+        s_recPendingSlot = i;
+        s_recUploadSeq++;
+        ready = slot.ready;
+        break;
+    }
+    if (!srcImage) return ready;
+
+    // Wall-clock pacing: one frame per 1/VK_RECORD_FPS s, catching up at most one period
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    LONGLONG period = g_perfFreq.QuadPart / VK_RECORD_FPS;
+    if (s_recNextQpc && now.QuadPart < s_recNextQpc) return ready;
+    s_recNextQpc = (s_recNextQpc && now.QuadPart - s_recNextQpc < period) ? s_recNextQpc + period : now.QuadPart + period;
+
+    if (!s_recSession && !CreateSession(extent)) {
+        DestroySession();
+        s_recFailed = true;
+        return ready;
+    }
+
+    int index = -1;
+    for (int i = 0; i < VK_RECORD_SLOTS && index < 0; i++)
+        if (s_recSlots[i].state == RECORD_FREE) index = i;
+    if (index < 0) {
+        InterlockedIncrement(&s_recDropped);
+        return ready;
+    }
+
+    RecordSlot& slot = s_recSlots[index];
+    RecordReadback(cmd, slot, srcImage, srcStage);
+    slot.frameSlot = frame;
+    slot.sequence = s_recReadbackSeq++;
+    slot.bgra = bgra;
+    slot.state = RECORD_READBACK;
+    return ready;
+}
+
+void VkRecordCollect(uint32_t frame) {
+    for (int i = 0; i < VK_RECORD_SLOTS; i++)
+        if (s_recSlots[i].state == RECORD_READBACK && s_recSlots[i].frameSlot == frame) EnqueueSlot(i, RECORD_CONVERTING);
+}
+
+void VkRecordSubmit() {
+    if (s_recPendingSlot < 0) return;
+    RecordSlot& slot = s_recSlots[s_recPendingSlot];
+
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &slot.ready;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &slot.encodeCmd;
+    vkResetFences(s_recDevice, 1, &slot.done);
+    if (vkQueueSubmit(s_recEncodeQueue, 1, &submitInfo, slot.done) != VK_SUCCESS) {
+        // The graphics submission still signals the semaphore; wait it off with the device
+        Log("[ERROR] Record: encode submit failed, --record disabled\n");
+        vkDeviceWaitIdle(s_recDevice);
+        vkDestroySemaphore(s_recDevice, slot.ready, nullptr);
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        vkCreateSemaphore(s_recDevice, &semaphoreInfo, nullptr, &slot.ready);
+        slot.state = RECORD_FREE;
+        s_recPendingSlot = -1;
+        s_recFailed = true;
+        return;
+    }
+
+    EnqueueSlot(s_recPendingSlot, RECORD_ENCODING);
+    s_recPendingSlot = -1;
+}
+
+// ============== CLEANUP ==============
+void VkRecordCleanup() {
+    if (!s_recDevice) return;
+    DestroySession();
+    s_recNextQpc = 0;
+    if (s_recFailed && s_recEncodePool) s_recFailed = false;  // Session errors are retried with the next size
+}
+
+void VkRecordShutdown() {
+    if (!s_recDevice) return;
+    DestroySession();
+    for (uint32_t i = 0; i < VK_RECORD_SLOTS; i++) {
+        RecordSlot& slot = s_recSlots[i];
+        if (slot.ready) { vkDestroySemaphore(s_recDevice, slot.ready, nullptr); slot.ready = VK_NULL_HANDLE; }
+        if (slot.done) { vkDestroyFence(s_recDevice, slot.done, nullptr); slot.done = VK_NULL_HANDLE; }
+        slot.encodeCmd = VK_NULL_HANDLE;
+    }
+    if (s_recEncodePool) { vkDestroyCommandPool(s_recDevice, s_recEncodePool, nullptr); s_recEncodePool = VK_NULL_HANDLE; }
+    s_recEncodeQueue = VK_NULL_HANDLE;
+    s_recEncodeFamily = UINT32_MAX;
+    s_recDevice = VK_NULL_HANDLE;
+    s_recFailed = false;
+}
+
+void VkRecordStats(UINT& frames, UINT& dropped, UINT64& bytes) {
+    frames = (UINT)s_recFrames;
+    dropped = (UINT)s_recDropped;
+    bytes = (UINT64)s_recBytes;
+}
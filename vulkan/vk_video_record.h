@@ -0,0 +1,59 @@
+#pragma once
+// ============== VULKAN VIDEO RECORDING ==============
+// --record=<file.h264>: Vulkan RT encodes what it renders into an H.264
+// Annex B elementary stream on the GPU's video encode engine
+// (VK_KHR_video_encode_h264).
+//
+// The traced image (before the overlay) is copied into one of VK_RECORD_SLOTS
+// host-visible readback buffers. Once that frame slot's fence has passed the
+// writer thread converts it to NV12 (BT.709 limited range), and a later frame
+// uploads it into the slot's encode input image. The encode queue waits for
+// that submission on a semaphore, encodes into the slot's host-visible
+// bitstream buffer, and the writer thread appends the bytes to the file once
+// the slot's fence has passed; a recorded frame lands in the file about
+// FRAME_COUNT + 1 frames after it was rendered. Frames are taken at most
+// VK_RECORD_FPS times per second; when every slot is still in flight the
+// frame is dropped and counted, the render loop never waits on the encoder.
+//
+// The device must be created with the encode queue from VkRecordEnable; on
+// any missing capability --record is ignored with a warning.
+
+#include "vulkan.h"
+
+#define VK_RECORD_FPS 60            // Wall-clock frame rate of the video
+
+// Before vkCreateDevice: with --record, when the device can encode H.264
+// 4:2:0 8-bit, adds the video extensions (and the synchronization2 feature,
+// prepended to *pNextChain) and returns the encode queue family the device
+// must create one queue on. UINT32_MAX = no recording.
+uint32_t VkRecordEnable(VkInstance instance, VkPhysicalDevice physicalDevice, std::vector<const char*>& extensions,
+                        void** pNextChain, const char* tag);
+
+// After vkCreateDevice (only if VkRecordEnable returned a family): entry
+// points and encode queue objects.
+bool VkRecordInit(VkDevice device, uint32_t graphicsFamily);
+
+// While recording the frame in frame slot `frame`, after the pass that wrote
+// srcImage at srcStage. srcImage is 4 bytes per pixel in GENERAL layout with
+// TRANSFER_SRC usage (VK_NULL_HANDLE = nothing to read back this frame, still
+// uploads what's converted); bgra = its bytes are B, G, R, A. The image may be
+// written again right after. When an upload is recorded, returns the
+// semaphore the frame's vkQueueSubmit must signal, followed by VkRecordSubmit;
+// otherwise VK_NULL_HANDLE.
+VkSemaphore VkRecordFrame(VkCommandBuffer cmd, VkImage srcImage, VkExtent2D extent, bool bgra,
+                          VkPipelineStageFlags srcStage, uint32_t frame);
+void VkRecordSubmit();
+
+// After the in-flight fence wait of frame slot `frame`: hands its readbacks to
+// the writer thread for conversion.
+void VkRecordCollect(uint32_t frame);
+
+// After vkDeviceWaitIdle. Cleanup ends the session and closes the file (resize;
+// the next frame starts a new session at the new size and appends, beginning
+// with an IDR). Shutdown also releases the queue objects, before
+// VkMemShutdown.
+void VkRecordCleanup();
+void VkRecordShutdown();
+
+// Report
+void VkRecordStats(UINT& frames, UINT& dropped, UINT64& bytes);
@@ -36,6 +36,10 @@ layout(set = 0, binding = 2) uniform SceneCB {
 #define FEATURE_REFLECTIONS     (1u << 4)
 #define FEATURE_GLASS           (1u << 5)
 
+// Feature set of this pipeline (VkSpecializationInfo, see vk_specialize.h) -
+// disabled effects are compiled out. scene.features only feeds the overlay.
+layout(constant_id = 0) const uint FEATURES = 0x3Fu;
+
 // Camera
 const vec3 CameraPos = vec3(0.0, 0.0, -2.2);
 
@@ -285,7 +289,7 @@ void main() {
             finalColor = vec3(1.0, 0.98, 0.9);
         }
         // Mirror reflection
-        else if ((scene.features & FEATURE_REFLECTIONS) != 0u && materialType == MAT_MIRROR) {
+        else if ((FEATURES & FEATURE_REFLECTIONS) != 0u && materialType == MAT_MIRROR) {
             vec3 reflectDir = reflect(rayDir, hitNormal);
             vec3 reflOrigin = hitPos + hitNormal * 0.002;
 
@@ -307,7 +311,7 @@ void main() {
                 } else {
                     vec3 toLight = normalize(lightPos - reflHitPos);
                     float NdotL = max(dot(reflNormal, toLight), 0.0);
-                    if ((scene.features & FEATURE_SPOTLIGHT) != 0u) {
+                    if ((FEATURES & FEATURE_SPOTLIGHT) != 0u) {
                         float reflSpot = SpotlightAttenuation(reflHitPos - lightPos);
                         reflColor *= (0.15 + NdotL * reflSpot * 0.85);
                     } else {
@@ -320,7 +324,7 @@ void main() {
             }
         }
         // Glass transparency
-        else if ((scene.features & FEATURE_GLASS) != 0u && materialType == MAT_GLASS) {
+        else if ((FEATURES & FEATURE_GLASS) != 0u && materialType == MAT_GLASS) {
             vec3 throughOrigin = hitPos + rayDir * 0.01;
 
             if (TraceRay(throughOrigin, rayDir, 0.001, 100.0, hitT, primID, instID, bary)) {
@@ -339,7 +343,7 @@ void main() {
                 if (behindObjID != OBJ_LIGHT) {
                     vec3 toLight = normalize(lightPos - behindPos);
                     float NdotL = max(dot(behindNormal, toLight), 0.0);
-                    if ((scene.features & FEATURE_SPOTLIGHT) != 0u) {
+                    if ((FEATURES & FEATURE_SPOTLIGHT) != 0u) {
                         float glassSpot = SpotlightAttenuation(behindPos - lightPos);
                         behindColor *= (0.2 + NdotL * glassSpot * 0.8);
                     } else {
@@ -370,7 +374,7 @@ void main() {
             }
 
             // Soft shadows
-            if ((scene.features & FEATURE_SOFT_SHADOWS) != 0u && scene.shadowSamples > 1) {
+            if ((FEATURES & FEATURE_SOFT_SHADOWS) != 0u && scene.shadowSamples > 1) {
                 float softShadow = 0.0;
                 for (int i = 0; i < scene.shadowSamples; i++) {
                     vec3 jitter = RandomInDisk(seed) * scene.lightRadius;
@@ -387,7 +391,7 @@ void main() {
 
             // Ambient occlusion
             float ao = 1.0;
-            if ((scene.features & FEATURE_AO) != 0u && scene.aoSamples > 0) {
+            if ((FEATURES & FEATURE_AO) != 0u && scene.aoSamples > 0) {
                 float occlusion = 0.0;
                 for (int i = 0; i < scene.aoSamples; i++) {
                     vec3 aoDir = RandomInHemisphere(hitNormal, seed);
@@ -402,7 +406,7 @@ void main() {
             float distAtten = 2.5 / (1.0 + lightDist * lightDist * 0.08);
             float totalAtten = distAtten;
 
-            if ((scene.features & FEATURE_SPOTLIGHT) != 0u) {
+            if ((FEATURES & FEATURE_SPOTLIGHT) != 0u) {
                 float spotAtten = SpotlightAttenuation(hitPos - lightPos);
                 totalAtten *= spotAtten;
             }
@@ -45,6 +45,10 @@ layout(set = 0, binding = 2) uniform SceneCB {
 #define FEATURE_REFLECTIONS     (1u << 4)
 #define FEATURE_GLASS           (1u << 5)
 
+// Feature set of this pipeline (VkSpecializationInfo, see vk_specialize.h) -
+// disabled effects are compiled out. scene.features only feeds the overlay.
+layout(constant_id = 0) const uint FEATURES = 0x3Fu;
+
 // Hardcoded camera (same as DXR 1.0)
 const vec3 CameraPos = vec3(0.0, 0.0, -2.2);
 
@@ -184,7 +188,7 @@ void main() {
             finalColor = vec3(1.0, 0.98, 0.9);
         }
         // Mirror reflection
-        else if ((scene.features & FEATURE_REFLECTIONS) != 0u && materialType == MAT_MIRROR) {
+        else if ((FEATURES & FEATURE_REFLECTIONS) != 0u && materialType == MAT_MIRROR) {
             vec3 reflectDir = reflect(rayDir, hitNormal);
             hitValue = vec3(0.0);
             didHit = false;
@@ -197,7 +201,7 @@ void main() {
                 } else {
                     vec3 toLight = normalize(LIGHT_POS - hitPos);
                     float NdotL = max(dot(hitNormal, toLight), 0.0);
-                    if ((scene.features & FEATURE_SPOTLIGHT) != 0u) {
+                    if ((FEATURES & FEATURE_SPOTLIGHT) != 0u) {
                         float reflSpot = SpotlightAttenuation(hitPos - LIGHT_POS);
                         reflColor *= (0.15 + NdotL * reflSpot * 0.85);
                     } else {
@@ -210,7 +214,7 @@ void main() {
             }
         }
         // Glass transparency
-        else if ((scene.features & FEATURE_GLASS) != 0u && materialType == MAT_GLASS) {
+        else if ((FEATURES & FEATURE_GLASS) != 0u && materialType == MAT_GLASS) {
             vec3 throughOrigin = hitPos + rayDir * 0.01;
             hitValue = vec3(0.0);
             didHit = false;
@@ -222,7 +226,7 @@ void main() {
                 if (objectID != OBJ_LIGHT) {
                     vec3 toLight = normalize(LIGHT_POS - hitPos);
                     float NdotL = max(dot(hitNormal, toLight), 0.0);
-                    if ((scene.features & FEATURE_SPOTLIGHT) != 0u) {
+                    if ((FEATURES & FEATURE_SPOTLIGHT) != 0u) {
                         float glassSpot = SpotlightAttenuation(hitPos - LIGHT_POS);
                         behindColor *= (0.2 + NdotL * glassSpot * 0.8);
                     } else {
@@ -255,7 +259,7 @@ void main() {
             }
 
             // Soft shadows (multiple samples)
-            if ((scene.features & FEATURE_SOFT_SHADOWS) != 0u && scene.shadowSamples > 1) {
+            if ((FEATURES & FEATURE_SOFT_SHADOWS) != 0u && scene.shadowSamples > 1) {
                 float softShadow = 0.0;
                 for (int i = 0; i < scene.shadowSamples; i++) {
                     vec3 jitter = RandomInDisk(seed) * scene.lightRadius;
@@ -275,7 +279,7 @@ void main() {
 
             // Ambient occlusion
             float ao = 1.0;
-            if ((scene.features & FEATURE_AO) != 0u && scene.aoSamples > 0) {
+            if ((FEATURES & FEATURE_AO) != 0u && scene.aoSamples > 0) {
                 float occlusion = 0.0;
                 for (int i = 0; i < scene.aoSamples; i++) {
                     vec3 aoDir = RandomInHemisphere(hitNormal, seed);
@@ -293,7 +297,7 @@ void main() {
             float distAtten = 2.5 / (1.0 + lightDist * lightDist * 0.08);
             float totalAtten = distAtten;
 
-            if ((scene.features & FEATURE_SPOTLIGHT) != 0u) {
+            if ((FEATURES & FEATURE_SPOTLIGHT) != 0u) {
                 float spotAtten = SpotlightAttenuation(hitPos - LIGHT_POS);
                 totalAtten *= spotAtten;
             }
@@ -56,6 +56,68 @@ static const uint32_t g_vkVertShaderCode[] = {
     0x00010038
 };
 
+// Instanced vertex shader (--cubes=N): same as above plus a per-instance
+// attribute, aInstance (location 3) = xyz offset, w uniform scale.
+// aColor (location 2) is fed from the per-instance binding.
+//   vec3 p = aPos * aInstance.w + aInstance.xyz;
+//   gl_Position = pc.mvp * vec4(p, 1.0);
+static const uint32_t g_vkVertInstShaderCode[] = {
+    0x07230203,0x00010000,0x0008000b,0x00000033,0x00000000,0x00020011,0x00000001,0x0006000b,
+    0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
+    0x000c000f,0x00000000,0x00000004,0x6e69616d,0x00000000,0x0000000d,0x0000001b,0x00000026,
+    0x00000027,0x00000029,0x0000002a,0x0000002d,0x00030003,0x00000002,0x000001c2,0x00040005,
+    0x00000004,0x6e69616d,0x00000000,0x00060005,0x0000000b,0x505f6c67,0x65567265,0x78657472,
+    0x00000000,0x00060006,0x0000000b,0x00000000,0x505f6c67,0x7469736f,0x006e6f69,0x00070006,
+    0x0000000b,0x00000001,0x505f6c67,0x746e696f,0x657a6953,0x00000000,0x00070006,0x0000000b,
+    0x00000002,0x435f6c67,0x4470696c,0x61747369,0x0065636e,0x00070006,0x0000000b,0x00000003,
+    0x435f6c67,0x446c6c75,0x61747369,0x0065636e,0x00030005,0x0000000d,0x00000000,0x00060005,
+    0x00000013,0x68737550,0x736e6f43,0x746e6174,0x00000073,0x00040006,0x00000013,0x00000000,
+    0x0070766d,0x00060006,0x00000013,0x00000001,0x6867696c,0x72694474,0x00000000,0x00050006,
+    0x00000013,0x00000002,0x656d6974,0x00000000,0x00050006,0x00000013,0x00000003,0x64646170,
+    0x00676e69,0x00030005,0x00000015,0x00006370,0x00040005,0x0000001b,0x736f5061,0x00000000,
+    0x00040005,0x00000026,0x726f4e76,0x006c616d,0x00040005,0x00000027,0x726f4e61,0x006c616d,
+    0x00040005,0x00000029,0x6c6f4376,0x0000726f,0x00040005,0x0000002a,0x6c6f4361,0x0000726f,
+    0x00050005,0x0000002d,0x736e4961,0x636e6174,0x00000065,0x00030047,0x0000000b,0x00000002,
+    0x00050048,0x0000000b,0x00000000,0x0000000b,0x00000000,0x00050048,0x0000000b,0x00000001,
+    0x0000000b,0x00000001,0x00050048,0x0000000b,0x00000002,0x0000000b,0x00000003,0x00050048,
+    0x0000000b,0x00000003,0x0000000b,0x00000004,0x00040047,0x00000012,0x00000006,0x00000004,
+    0x00030047,0x00000013,0x00000002,0x00040048,0x00000013,0x00000000,0x00000005,0x00050048,
+    0x00000013,0x00000000,0x00000007,0x00000010,0x00050048,0x00000013,0x00000000,0x00000023,
+    0x00000000,0x00050048,0x00000013,0x00000001,0x00000023,0x00000040,0x00050048,0x00000013,
+    0x00000002,0x00000023,0x00000050,0x00050048,0x00000013,0x00000003,0x00000023,0x00000054,
+    0x00040047,0x0000001b,0x0000001e,0x00000000,0x00040047,0x00000026,0x0000001e,0x00000000,
+    0x00040047,0x00000027,0x0000001e,0x00000001,0x00040047,0x00000029,0x0000001e,0x00000001,
+    0x00040047,0x0000002a,0x0000001e,0x00000002,0x00040047,0x0000002d,0x0000001e,0x00000003,
+    0x00020013,0x00000002,0x00030021,0x00000003,0x00000002,0x00030016,0x00000006,0x00000020,
+    0x00040017,0x00000007,0x00000006,0x00000004,0x00040015,0x00000008,0x00000020,0x00000000,
+    0x0004002b,0x00000008,0x00000009,0x00000001,0x0004001c,0x0000000a,0x00000006,0x00000009,
+    0x0006001e,0x0000000b,0x00000007,0x00000006,0x0000000a,0x0000000a,0x00040020,0x0000000c,
+    0x00000003,0x0000000b,0x0004003b,0x0000000c,0x0000000d,0x00000003,0x00040015,0x0000000e,
+    0x00000020,0x00000001,0x0004002b,0x0000000e,0x0000000f,0x00000000,0x00040018,0x00000010,
+    0x00000007,0x00000004,0x0004002b,0x00000008,0x00000011,0x00000003,0x0004001c,0x00000012,
+    0x00000006,0x00000011,0x0006001e,0x00000013,0x00000010,0x00000007,0x00000006,0x00000012,
+    0x00040020,0x00000014,0x00000009,0x00000013,0x0004003b,0x00000014,0x00000015,0x00000009,
+    0x00040020,0x00000016,0x00000009,0x00000010,0x00040017,0x00000019,0x00000006,0x00000003,
+    0x00040020,0x0000001a,0x00000001,0x00000019,0x0004003b,0x0000001a,0x0000001b,0x00000001,
+    0x0004002b,0x00000006,0x0000001d,0x3f800000,0x00040020,0x00000023,0x00000003,0x00000007,
+    0x00040020,0x00000025,0x00000003,0x00000019,0x0004003b,0x00000025,0x00000026,0x00000003,
+    0x0004003b,0x0000001a,0x00000027,0x00000001,0x0004003b,0x00000025,0x00000029,0x00000003,
+    0x0004003b,0x0000001a,0x0000002a,0x00000001,0x00040020,0x0000002c,0x00000001,0x00000007,
+    0x0004003b,0x0000002c,0x0000002d,0x00000001,0x00050036,0x00000002,0x00000004,0x00000000,
+    0x00000003,0x000200f8,0x00000005,0x00050041,0x00000016,0x00000017,0x00000015,0x0000000f,
+    0x0004003d,0x00000010,0x00000018,0x00000017,0x0004003d,0x00000019,0x0000001c,0x0000001b,
+    0x0004003d,0x00000007,0x0000002e,0x0000002d,0x0008004f,0x00000019,0x0000002f,0x0000002e,
+    0x0000002e,0x00000000,0x00000001,0x00000002,0x00050051,0x00000006,0x00000030,0x0000002e,
+    0x00000003,0x0005008e,0x00000019,0x00000031,0x0000001c,0x00000030,0x00050081,0x00000019,
+    0x00000032,0x00000031,0x0000002f,0x00050051,0x00000006,0x0000001e,0x00000032,0x00000000,
+    0x00050051,0x00000006,0x0000001f,0x00000032,0x00000001,0x00050051,0x00000006,0x00000020,
+    0x00000032,0x00000002,0x00070050,0x00000007,0x00000021,0x0000001e,0x0000001f,0x00000020,
+    0x0000001d,0x00050091,0x00000007,0x00000022,0x00000018,0x00000021,0x00050041,0x00000023,
+    0x00000024,0x0000000d,0x0000000f,0x0003003e,0x00000024,0x00000022,0x0004003d,0x00000019,
+    0x00000028,0x00000027,0x0003003e,0x00000026,0x00000028,0x0004003d,0x00000019,0x0000002b,
+    0x0000002a,0x0003003e,0x00000029,0x0000002b,0x000100fd,0x00010038
+};
+
 // Fragment shader: calculates lighting and outputs color
 static const uint32_t g_vkFragShaderCode[] = {
     0x07230203,0x00010000,0x0008000b,0x00000035,0x00000000,0x00020011,0x00000001,0x0006000b,